@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/thread_pool.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+// 10000 markers around Manhattan, seen at a zoom level where they're spread over a few dozen tiles.
+class AnnotationBenchmark {
+public:
+    AnnotationBenchmark() {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+
+        map.setStyleJSON(R"STYLE({ "version": 8, "sources": {}, "layers": [] })STYLE");
+        map.setLatLngZoom({ 40.726989, -73.992857 }, 10);
+
+        auto decoded = decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png"));
+        map.addAnnotationIcon("default_marker", std::make_shared<SpriteImage>(std::move(decoded), 1.0));
+
+        ids = map.addAnnotations(markers(10000));
+
+        view.resize(1000, 1000);
+
+        mbgl::benchmark::render(map);
+    }
+
+    Point<double> randomPoint() {
+        std::uniform_real_distribution<double> longitude(-74.5, -73.5);
+        std::uniform_real_distribution<double> latitude(40.4, 41.1);
+        return { longitude(random), latitude(random) };
+    }
+
+    std::vector<Annotation> markers(std::size_t count) {
+        std::vector<Annotation> result;
+        for (std::size_t i = 0; i < count; i++) {
+            result.push_back(SymbolAnnotation { randomPoint(), "default_marker" });
+        }
+        return result;
+    }
+
+    // Moves some of the markers a little, and renders them.
+    void move(std::size_t count) {
+        std::uniform_int_distribution<std::size_t> index(0, ids.size() - 1);
+        for (std::size_t i = 0; i < count; i++) {
+            map.updateAnnotation(ids[index(random)], SymbolAnnotation { randomPoint(), "default_marker" });
+        }
+        mbgl::benchmark::render(map);
+    }
+
+    util::RunLoop loop;
+    std::shared_ptr<HeadlessDisplay> display{ std::make_shared<HeadlessDisplay>() };
+    HeadlessView view{ display, 1 };
+    DefaultFileSource fileSource{ "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool{ 4 };
+    Map map{ view, fileSource, threadPool, MapMode::Still };
+    std::mt19937 random { 0 };
+    AnnotationIDs ids;
+};
+
+} // end namespace
+
+static void API_moveOneAnnotation(::benchmark::State& state) {
+    AnnotationBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.move(1);
+    }
+}
+
+static void API_moveHundredAnnotations(::benchmark::State& state) {
+    AnnotationBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.move(100);
+    }
+}
+
+static void API_addAndRemoveAnnotationsInBulk(::benchmark::State& state) {
+    AnnotationBenchmark bench;
+    const std::vector<Annotation> markers = bench.markers(10000);
+
+    while (state.KeepRunning()) {
+        bench.map.removeAnnotations(bench.map.addAnnotations(markers));
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+BENCHMARK(API_moveOneAnnotation);
+BENCHMARK(API_moveHundredAnnotations);
+BENCHMARK(API_addAndRemoveAnnotationsInBulk);
@@ -0,0 +1,224 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/thread_pool.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// The streets style whose sources, sprite, glyphs and tiles around lower Manhattan at zoom
+// level 15 are in the fixture cache, so that every run renders the same data, offline.
+const char* stylePath = "benchmark/fixtures/api/query_style.json";
+const LatLng center { 40.726989, -73.992857 };
+const double zoom = 15;
+
+// Circles of the points of the streets tiles, which the streets style has none of.
+const char* circleLayers = R"JSON([
+    { "id": "poi-circles", "type": "circle", "source": "composite", "source-layer": "poi_label",
+      "paint": { "circle-radius": 4, "circle-color": "#e55e5e" } },
+    { "id": "housenum-circles", "type": "circle", "source": "composite", "source-layer": "housenum_label",
+      "paint": { "circle-radius": 2, "circle-color": "#3bb2d0" } }
+])JSON";
+
+// The style with only its background and the layers of the given type, so that what it costs to
+// lay them out is measured on its own.
+std::string styleWithLayersOfType(const std::string& type) {
+    JSDocument document;
+    document.Parse<0>(util::read_file(stylePath).c_str());
+    auto& allocator = document.GetAllocator();
+
+    JSDocument circles;
+    circles.Parse<0>(circleLayers);
+
+    const JSValue& layers = document["layers"];
+    JSValue kept(rapidjson::kArrayType);
+    for (rapidjson::SizeType i = 0; i < layers.Size(); ++i) {
+        const JSValue& layer = layers[i];
+
+        // Layers that share the properties of another through "ref" have its type.
+        std::string layerType;
+        if (layer.HasMember("type")) {
+            layerType = layer["type"].GetString();
+        } else {
+            for (rapidjson::SizeType j = 0; j < layers.Size(); ++j) {
+                if (layers[j]["id"] == layer["ref"] && layers[j].HasMember("type")) {
+                    layerType = layers[j]["type"].GetString();
+                }
+            }
+        }
+
+        if (layerType == "background" || layerType == type) {
+            kept.PushBack(JSValue(layer, allocator), allocator);
+        }
+    }
+    if (type == "circle") {
+        for (rapidjson::SizeType i = 0; i < circles.Size(); ++i) {
+            kept.PushBack(JSValue(circles[i], allocator), allocator);
+        }
+    }
+    document["layers"] = kept;
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    document.Accept(writer);
+    return { buffer.GetString(), buffer.GetSize() };
+}
+
+class RenderBenchmark {
+public:
+    RenderBenchmark(std::string styleJSON_ = util::read_file(stylePath))
+        : styleJSON(std::move(styleJSON_)) {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        fileSource.setAccessToken("foobar");
+
+        map.setLatLngZoom(center, zoom);
+
+        view.resize(1000, 1000);
+    }
+
+    // Loads the style from scratch. Setting the same JSON again is a no-op, so every other load
+    // is of the JSON with a trailing space.
+    void loadStyle() {
+        map.setStyleJSON(reload++ % 2 ? styleJSON + " " : styleJSON);
+
+        auto decoded = decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png"));
+        auto image = std::make_unique<SpriteImage>(std::move(decoded), 1.0);
+        map.addImage("test-icon", std::move(image));
+    }
+
+    const std::string styleJSON;
+    std::size_t reload = 0;
+
+    util::RunLoop loop;
+    std::shared_ptr<HeadlessDisplay> display{ std::make_shared<HeadlessDisplay>() };
+    HeadlessView view{ display, 1 };
+    DefaultFileSource fileSource{ "benchmark/fixtures/api/cache.db", "." };
+    ThreadPool threadPool{ 4 };
+    Map map{ view, fileSource, threadPool, MapMode::Still };
+};
+
+// A scripted camera path over the tiles of the fixtures: a pan, a zoom in and back out within the
+// same zoom level, and a rotation, each in a few steps.
+std::vector<CameraOptions> cameraScript() {
+    std::vector<CameraOptions> script;
+    const auto camera = [&](double dLatitude, double dLongitude, double dZoom, double angle) {
+        CameraOptions options;
+        options.center = LatLng { center.latitude + dLatitude, center.longitude + dLongitude };
+        options.zoom = zoom + dZoom;
+        options.angle = angle;
+        script.push_back(options);
+    };
+    for (int i = 0; i < 4; ++i) {
+        camera(0.0005 * i, 0.001 * i, 0, 0);
+    }
+    for (int i = 0; i < 4; ++i) {
+        camera(0.0015, 0.003, 0.2 * i, 0);
+    }
+    for (int i = 0; i < 4; ++i) {
+        camera(0.0015, 0.003, 0.6, M_PI / 8 * i);
+    }
+    return script;
+}
+
+void layout(::benchmark::State& state, const std::string& type) {
+    RenderBenchmark bench(styleWithLayersOfType(type));
+
+    while (state.KeepRunning()) {
+        bench.loadStyle();
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+} // end namespace
+
+// Parsing the style, and creating its layers and sources.
+static void API_renderStyleLoad(::benchmark::State& state) {
+    RenderBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.loadStyle();
+    }
+}
+
+// Everything from loading the style to the first frame: reading the tiles, sprite and glyphs out
+// of the cache, parsing the tiles, laying out and placing their features, and rendering.
+static void API_renderFirstFrame(::benchmark::State& state) {
+    RenderBenchmark bench;
+
+    while (state.KeepRunning()) {
+        bench.loadStyle();
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+// The first frame of a style with only the layers of one type, which is mostly laying them out.
+static void API_renderLayoutFill(::benchmark::State& state) {
+    layout(state, "fill");
+}
+
+static void API_renderLayoutLine(::benchmark::State& state) {
+    layout(state, "line");
+}
+
+static void API_renderLayoutSymbol(::benchmark::State& state) {
+    layout(state, "symbol");
+}
+
+static void API_renderLayoutCircle(::benchmark::State& state) {
+    layout(state, "circle");
+}
+
+// Rotating a map of laid out symbols, which places them again for every frame.
+static void API_renderPlacement(::benchmark::State& state) {
+    RenderBenchmark bench(styleWithLayersOfType("symbol"));
+    bench.loadStyle();
+    mbgl::benchmark::render(bench.map);
+
+    std::size_t frame = 0;
+    while (state.KeepRunning()) {
+        bench.map.setBearing(double(++frame % 8) * 45);
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+// Frames along a scripted pan, zoom and rotation of a loaded map.
+static void API_renderSteadyFrame(::benchmark::State& state) {
+    RenderBenchmark bench;
+    bench.loadStyle();
+    mbgl::benchmark::render(bench.map);
+
+    const std::vector<CameraOptions> script = cameraScript();
+    std::size_t frame = 0;
+    while (state.KeepRunning()) {
+        bench.map.jumpTo(script[frame++ % script.size()]);
+        mbgl::benchmark::render(bench.map);
+    }
+}
+
+BENCHMARK(API_renderStyleLoad)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderFirstFrame)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderLayoutFill)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderLayoutLine)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderLayoutSymbol)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderLayoutCircle)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderPlacement)->Unit(::benchmark::kMillisecond);
+BENCHMARK(API_renderSteadyFrame)->Unit(::benchmark::kMillisecond);
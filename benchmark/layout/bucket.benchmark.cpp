@@ -0,0 +1,237 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/circle_bucket.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/line_bucket.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/tile/flat_tile_data.hpp>
+#include <mbgl/tile/vector_tile.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+namespace {
+
+// A streets tile of the fixtures, with the land cover, water, roads and labels of a whole bay area.
+const CanonicalTileID tileID { 10, 163, 395 };
+const char* tilePath = "test/fixtures/api/assets/streets/10-163-395.vector.pbf";
+
+// The decoded layers of the tile, which the worker of a tile would have before laying it out.
+class TileLayers {
+public:
+    TileLayers()
+        : data(std::make_shared<const std::string>(util::read_file(tilePath))) {
+    }
+
+    const GeometryTileLayer& get(const std::string& name) {
+        layers.push_back(cache.getLayer(tileID, data, name));
+        return *layers.back()->getLayer(name);
+    }
+
+    // The geometries of all features of the layers, and how many vertices they have in all.
+    std::vector<GeometryCollection> geometries(const std::vector<std::string>& names) {
+        std::vector<GeometryCollection> result;
+        vertices = 0;
+        for (const auto& name : names) {
+            const GeometryTileLayer& layer = get(name);
+            for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+                result.push_back(layer.getFeature(i)->getGeometries());
+                for (const auto& ring : result.back()) {
+                    vertices += ring.size();
+                }
+            }
+        }
+        return result;
+    }
+
+    std::size_t vertices = 0;
+
+private:
+    VectorTileDataCache cache;
+    const std::shared_ptr<const std::string> data;
+    std::vector<std::shared_ptr<const FlatTileData>> layers;
+};
+
+std::string memoryLabel(const Bucket& bucket) {
+    return util::toString(bucket.getMemoryUsage().cpu) + " bytes allocated";
+}
+
+// Lays out a bucket of the geometries in every iteration, and reports the vertices of the
+// geometries laid out per second, and the memory the bucket ends up holding.
+template <class Bucket, class... Args>
+void layoutBucket(::benchmark::State& state, const std::vector<std::string>& layerNames, Args&&... args) {
+    TileLayers tile;
+    const std::vector<GeometryCollection> geometries = tile.geometries(layerNames);
+
+    std::string label;
+    while (state.KeepRunning()) {
+        Bucket bucket(args...);
+        for (const auto& geometry : geometries) {
+            bucket.addGeometry(geometry);
+        }
+        ::benchmark::DoNotOptimize(bucket.hasData());
+
+        if (label.empty()) {
+            label = memoryLabel(bucket);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * tile.vertices);
+    state.SetLabel(label);
+}
+
+// Draws every glyph as a box, so that the labels can be shaped without downloading glyphs.
+class BoxGlyphRasterizer : public LocalGlyphRasterizer {
+public:
+    bool canRasterize(const FontStack&, uint32_t, uint32_t) const override {
+        return true;
+    }
+
+    optional<RasterizedGlyph> rasterize(const FontStack&, uint32_t) override {
+        RasterizedGlyph glyph;
+        glyph.width = 12;
+        glyph.height = 16;
+        glyph.top = -4;
+        glyph.advance = 14;
+        glyph.coverage.assign(glyph.width * glyph.height, 255);
+        return glyph;
+    }
+};
+
+// The glyph atlas only asks it for glyphs that aren't drawn locally, i.e. none.
+class NoFileSource : public FileSource {
+public:
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override {
+        return nullptr;
+    }
+};
+
+class SymbolLayoutBenchmark {
+public:
+    SymbolLayoutBenchmark(std::string layerName_, style::SymbolPlacementType placement)
+        : layerName(std::move(layerName_)), layer(tile.get(layerName)) {
+        glyphAtlas.setLocalGlyphRasterizer(std::make_shared<BoxGlyphRasterizer>());
+
+        layout.symbolPlacement.value = placement;
+        layout.textField.value = "{name}";
+        layout.textFont.value = { "Open Sans Regular" };
+
+        // What SymbolLayer::Impl::createLayout() resolves the automatic alignments to.
+        const style::AlignmentType alignment = placement == style::SymbolPlacementType::Line
+            ? style::AlignmentType::Map
+            : style::AlignmentType::Viewport;
+        layout.textRotationAlignment.value = alignment;
+        layout.textPitchAlignment.value = alignment;
+        layout.iconRotationAlignment.value = alignment;
+    }
+
+    std::unique_ptr<SymbolLayout> createLayout() {
+        return std::make_unique<SymbolLayout>(layerName, layerName, 1, tileID.z, MapMode::Continuous,
+                                              layer, style::Filter(), layout, layout.textSize,
+                                              spriteAtlas);
+    }
+
+    // Creates a layout of the labels of the layer, and shapes and anchors them.
+    std::unique_ptr<SymbolLayout> prepare() {
+        auto symbolLayout = createLayout();
+        if (!symbolLayout->canPrepare(glyphAtlas)) {
+            throw std::runtime_error("The glyphs of the labels aren't drawn locally");
+        }
+        symbolLayout->prepare(tileUID, glyphAtlas);
+        return symbolLayout;
+    }
+
+    const std::string layerName;
+    const uintptr_t tileUID = 1;
+
+    util::RunLoop loop;
+    NoFileSource fileSource;
+    GlyphAtlas glyphAtlas { 2048, 2048, fileSource };
+    SpriteAtlas spriteAtlas { 1024, 1024, 1 };
+    style::SymbolLayoutProperties layout;
+
+    TileLayers tile;
+    const GeometryTileLayer& layer;
+};
+
+// Reading the labels of the features, shaping them and finding their anchors. The shapings are
+// cached across iterations as they would be across the tiles of a map.
+void prepareSymbols(::benchmark::State& state, const std::string& layerName, style::SymbolPlacementType placement) {
+    SymbolLayoutBenchmark bench(layerName, placement);
+
+    while (state.KeepRunning()) {
+        auto symbolLayout = bench.prepare();
+        ::benchmark::DoNotOptimize(symbolLayout->hasSymbolInstances());
+    }
+
+    state.SetItemsProcessed(state.iterations() * bench.layer.featureCount());
+}
+
+// Placing the prepared labels in an empty collision tile, and building the bucket of those placed.
+void placeSymbols(::benchmark::State& state, const std::string& layerName, style::SymbolPlacementType placement) {
+    SymbolLayoutBenchmark bench(layerName, placement);
+    auto symbolLayout = bench.prepare();
+
+    std::string label;
+    while (state.KeepRunning()) {
+        CollisionTile collisionTile(PlacementConfig {});
+        auto bucket = symbolLayout->place(collisionTile);
+        ::benchmark::DoNotOptimize(bucket->hasData());
+
+        if (label.empty()) {
+            label = memoryLabel(*bucket);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * bench.layer.featureCount());
+    state.SetLabel(label);
+}
+
+} // end namespace
+
+// Triangulating the polygons of the tile with earcut.
+static void Layout_FillBucket(::benchmark::State& state) {
+    layoutBucket<FillBucket>(state, { "landcover", "landuse", "water" });
+}
+
+static void Layout_LineBucket(::benchmark::State& state) {
+    layoutBucket<LineBucket>(state, { "road", "waterway" }, 1);
+}
+
+static void Layout_CircleBucket(::benchmark::State& state) {
+    layoutBucket<CircleBucket>(state, { "poi_label", "place_label" }, MapMode::Continuous);
+}
+
+static void Layout_SymbolPreparePoint(::benchmark::State& state) {
+    prepareSymbols(state, "poi_label", style::SymbolPlacementType::Point);
+}
+
+static void Layout_SymbolPrepareLine(::benchmark::State& state) {
+    prepareSymbols(state, "road_label", style::SymbolPlacementType::Line);
+}
+
+static void Layout_SymbolPlacePoint(::benchmark::State& state) {
+    placeSymbols(state, "poi_label", style::SymbolPlacementType::Point);
+}
+
+static void Layout_SymbolPlaceLine(::benchmark::State& state) {
+    placeSymbols(state, "road_label", style::SymbolPlacementType::Line);
+}
+
+BENCHMARK(Layout_FillBucket);
+BENCHMARK(Layout_LineBucket);
+BENCHMARK(Layout_CircleBucket);
+BENCHMARK(Layout_SymbolPreparePoint);
+BENCHMARK(Layout_SymbolPrepareLine);
+BENCHMARK(Layout_SymbolPlacePoint);
+BENCHMARK(Layout_SymbolPlaceLine);
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/transform.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Evaluates frames spread over the first 59 of the 60 frames of a one second animation, so that
+// it never finishes, which is what a map pays for the camera on each frame of an animation.
+template <class Animate>
+void transitionFrames(::benchmark::State& state, Animate animate) {
+    Transform transform;
+    transform.resize({{ 1000, 1000 }});
+
+    CameraOptions camera;
+    camera.center = LatLng { 38.9, -77.0 };
+    camera.zoom = 14;
+    camera.angle = 1;
+    camera.pitch = 0.5;
+    camera.padding = EdgeInsets { 100, 0, 0, 0 };
+    animate(transform, camera, AnimationOptions(Seconds(1)));
+
+    std::size_t frame = 0;
+    while (state.KeepRunning()) {
+        const TimePoint now = transform.getTransitionStart() + Milliseconds(16 * (frame++ % 59));
+        ::benchmark::DoNotOptimize(transform.updateTransitions(now));
+    }
+}
+
+} // end namespace
+
+static void Transform_easeToFrame(::benchmark::State& state) {
+    transitionFrames(state, [](Transform& transform, const CameraOptions& camera, const AnimationOptions& animation) {
+        transform.easeTo(camera, animation);
+    });
+}
+
+static void Transform_flyToFrame(::benchmark::State& state) {
+    transitionFrames(state, [](Transform& transform, const CameraOptions& camera, const AnimationOptions& animation) {
+        transform.flyTo(camera, animation);
+    });
+}
+
+BENCHMARK(Transform_easeToFrame);
+BENCHMARK(Transform_flyToFrame);
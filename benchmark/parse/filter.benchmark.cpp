@@ -2,6 +2,7 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -37,5 +38,62 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+static void Parse_EvaluateCompiledFilter(benchmark::State& state) {
+    const style::CompiledFilter filter(parse(R"FILTER(["==", "foo", "bar"])FILTER"));
+    const PropertyMap properties = { { "foo", std::string("bar") } };
+
+    while (state.KeepRunning()) {
+        filter(FeatureType::Unknown, {}, [&] (std::size_t key) -> optional<Value> {
+            auto it = properties.find(filter.getKeys()[key]);
+            if (it == properties.end())
+                return {};
+            return it->second;
+        });
+    }
+}
+
+// A filter like the ones of road layers in common styles.
+static const char* roadFilter = R"FILTER(["all",
+    ["==", "$type", "LineString"],
+    ["!in", "structure", "bridge", "tunnel"],
+    ["in", "class", "motorway_link", "street", "street_limited", "service", "track", "pedestrian", "path", "link"],
+    ["any", ["<", "admin_level", 3], ["!has", "admin_level"]]
+])FILTER";
+
+static const PropertyMap roadProperties = {
+    { "class", std::string("path") },
+    { "structure", std::string("none") },
+    { "admin_level", int64_t(4) },
+};
+
+static void Parse_EvaluateRoadFilter(benchmark::State& state) {
+    const style::Filter filter = parse(roadFilter);
+
+    while (state.KeepRunning()) {
+        filter(FeatureType::LineString, {}, [&] (const std::string& key) -> optional<Value> {
+            auto it = roadProperties.find(key);
+            if (it == roadProperties.end())
+                return {};
+            return it->second;
+        });
+    }
+}
+
+static void Parse_EvaluateCompiledRoadFilter(benchmark::State& state) {
+    const style::CompiledFilter filter(parse(roadFilter));
+
+    while (state.KeepRunning()) {
+        filter(FeatureType::LineString, {}, [&] (std::size_t key) -> optional<Value> {
+            auto it = roadProperties.find(filter.getKeys()[key]);
+            if (it == roadProperties.end())
+                return {};
+            return it->second;
+        });
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateCompiledFilter);
+BENCHMARK(Parse_EvaluateRoadFilter);
+BENCHMARK(Parse_EvaluateCompiledRoadFilter);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/varint.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+// A packed field that looks like the geometry of a building-heavy tile: a command every few
+// values, and zigzag-encoded coordinate deltas that mostly fit into one byte.
+static std::string geometryField() {
+    std::mt19937 random(0);
+    std::vector<uint32_t> values;
+    for (std::size_t i = 0; i < 100000; i++) {
+        if (i % 10 == 0) {
+            values.push_back((4 << 3) | 2); // lineTo, 4 times
+        } else {
+            const int32_t delta = (random() % 16 == 0) ? int32_t(random() % 4096) - 2048 : int32_t(random() % 64) - 32;
+            values.push_back(protozero::encode_zigzag32(delta));
+        }
+    }
+
+    std::string message;
+    protozero::pbf_writer writer(message);
+    writer.add_packed_uint32(4, values.begin(), values.end());
+    return message;
+}
+
+static void Parse_VarintProtozero(benchmark::State& state) {
+    const std::string message = geometryField();
+
+    while (state.KeepRunning()) {
+        protozero::pbf_reader reader(message);
+        reader.next();
+        uint32_t sum = 0;
+        for (auto value : reader.get_packed_uint32()) {
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void Parse_VarintPackedReader(benchmark::State& state) {
+    const std::string message = geometryField();
+
+    while (state.KeepRunning()) {
+        protozero::pbf_reader reader(message);
+        reader.next();
+        const auto field = reader.get_data();
+        util::PackedVarintReader values(field.first, field.first + field.second);
+        uint32_t sum = 0;
+        while (!values.empty()) {
+            sum += values.next();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(Parse_VarintProtozero);
+BENCHMARK(Parse_VarintPackedReader);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/line_bucket.hpp>
+#include <mbgl/shader/fill_vertex.hpp>
+#include <mbgl/shader/line_vertex.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+// The size of a vertex type next to the size it would have with a float per attribute component.
+template <class Vertex>
+static std::string vertexSizeLabel(std::size_t components) {
+    const std::size_t packed = sizeof(Vertex);
+    const std::size_t unpacked = components * sizeof(float);
+    return util::toString(packed) + " bytes/vertex, " + util::toString(unpacked) +
+           " unpacked (-" + util::toString(100 - packed * 100 / unpacked) + "%)";
+}
+
+static GeometryCollection randomLines() {
+    std::mt19937 random(0);
+    GeometryCollection lines;
+    for (std::size_t i = 0; i < 100; i++) {
+        GeometryCoordinates line;
+        for (std::size_t j = 0; j < 50; j++) {
+            line.emplace_back(int16_t(random() % util::EXTENT), int16_t(random() % util::EXTENT));
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+static GeometryCollection gridPolygon() {
+    GeometryCollection polygon;
+    polygon.push_back({ { 0, 0 }, { util::EXTENT, 0 }, { util::EXTENT, util::EXTENT }, { 0, util::EXTENT }, { 0, 0 } });
+    for (int16_t x = 256; x < util::EXTENT; x += 512) {
+        for (int16_t y = 256; y < util::EXTENT; y += 512) {
+            polygon.push_back({ { x, y }, { x, int16_t(y + 128) }, { int16_t(x + 128), int16_t(y + 128) }, { int16_t(x + 128), y }, { x, y } });
+        }
+    }
+    return polygon;
+}
+
+static void Vertex_LineBucket(benchmark::State& state) {
+    const GeometryCollection lines = randomLines();
+
+    while (state.KeepRunning()) {
+        LineBucket bucket(1);
+        bucket.addGeometry(lines);
+        benchmark::DoNotOptimize(bucket.hasData());
+    }
+
+    // a_pos (2) and a_data (4).
+    state.SetLabel(vertexSizeLabel<LineVertex>(6));
+}
+
+static void Vertex_FillBucket(benchmark::State& state) {
+    const GeometryCollection polygon = gridPolygon();
+
+    while (state.KeepRunning()) {
+        FillBucket bucket;
+        bucket.addGeometry(polygon);
+        benchmark::DoNotOptimize(bucket.hasData());
+    }
+
+    // a_pos (2).
+    state.SetLabel(vertexSizeLabel<FillVertex>(2));
+}
+
+BENCHMARK(Vertex_LineBucket);
+BENCHMARK(Vertex_FillBucket);
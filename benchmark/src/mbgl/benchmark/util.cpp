@@ -2,8 +2,13 @@
 
 #include <mbgl/map/map.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <algorithm>
+
+#include <unistd.h>
+
 namespace mbgl {
 namespace benchmark {
 
@@ -18,5 +23,23 @@ void render(Map& map) {
     }
 }
 
+std::shared_ptr<const std::string> tileData(std::size_t index) {
+    static const std::string tile = util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf");
+
+    // Prefixes of a real tile, so that the data compresses as well as that of tiles does.
+    static const std::size_t sizes[] = { 2, 6, 12, 20, 32, 48, 64, 80 };
+    const std::size_t size = std::min(sizes[index % 8] * 1024, tile.size());
+
+    auto data = std::make_shared<std::string>(tile, 0, size);
+    data->append(reinterpret_cast<const char*>(&index), sizeof(index));
+    return data;
+}
+
+void deleteDatabase(const std::string& path) {
+    for (const char* suffix : { "", "-wal", "-shm" }) {
+        unlink((path + suffix).c_str());
+    }
+}
+
 } // namespace benchmark
 } // namespace mbgl
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <string>
+
 namespace mbgl {
 
 class Map;
@@ -8,5 +12,12 @@ namespace benchmark {
 
 void render(Map&);
 
+// The data of a vector tile, of one of the sizes that the tiles of a streets source range over,
+// from a few kilobytes to some eighty. No two indexes give the same data.
+std::shared_ptr<const std::string> tileData(std::size_t index);
+
+// Deletes a database file and its write-ahead log, if there are any.
+void deleteDatabase(const std::string& path);
+
 } // namespace benchmark
 } // namespace mbgl
@@ -0,0 +1,301 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/offline.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/timer.hpp>
+
+#include <algorithm>
+#include <future>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string databasePath = "default_file_source.benchmark.db";
+
+// As many requests as OnlineFileSource has in flight at a time.
+const std::size_t connections = 20;
+
+// Stands in for the network: answers each request after a fixed latency, with at most a number of
+// requests in flight at a time, like the connections of a host, and the others waiting for one.
+class StubOnlineFileSource : public FileSource {
+public:
+    using Respond = std::function<Response (const Resource&)>;
+
+    StubOnlineFileSource(Duration latency_, std::size_t connections_, Respond respond_)
+        : latency(latency_), maximumActive(connections_), respond(std::move(respond_)) {
+    }
+
+    std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback callback) override {
+        auto req = std::make_unique<Request>(*this, resource, std::move(callback));
+        waiting.push_back(req.get());
+        startWaiting();
+        return std::move(req);
+    }
+
+private:
+    class Request : public AsyncRequest {
+    public:
+        Request(StubOnlineFileSource& fileSource_, Resource resource_, Callback callback_)
+            : fileSource(fileSource_), resource(std::move(resource_)), callback(std::move(callback_)) {
+        }
+
+        ~Request() override {
+            fileSource.remove(this);
+        }
+
+        StubOnlineFileSource& fileSource;
+        const Resource resource;
+        const Callback callback;
+        util::Timer timer;
+        bool active = false;
+    };
+
+    void startWaiting() {
+        while (active < maximumActive && !waiting.empty()) {
+            Request* req = waiting.front();
+            waiting.pop_front();
+            req->active = true;
+            active++;
+            req->timer.start(latency, Duration::zero(), [this, req] {
+                const Response response = respond(req->resource);
+                // Frees the connection first, as the callback may cancel the request.
+                release(*req);
+                req->callback(response);
+            });
+        }
+    }
+
+    void release(Request& req) {
+        if (req.active) {
+            req.active = false;
+            active--;
+            startWaiting();
+        }
+    }
+
+    void remove(Request* req) {
+        release(*req);
+        waiting.remove(req);
+    }
+
+    const Duration latency;
+    const std::size_t maximumActive;
+    const Respond respond;
+    std::list<Request*> waiting;
+    std::size_t active = 0;
+};
+
+Resource tile(std::size_t index) {
+    return Resource::tile("http://example.com/{z}/{x}/{y}.vector.pbf", 1.0,
+                          index % 16384, index / 16384, 14, Tileset::Scheme::XYZ);
+}
+
+Response tileResponse(const Resource& resource) {
+    Response response;
+    response.data = mbgl::benchmark::tileData(resource.tileData->x + resource.tileData->y * 16384);
+    response.expires = util::now() + Seconds(3600);
+    return response;
+}
+
+// A file source on a fresh database, whose network answers tiles after the given latency.
+class FileSourceBenchmark {
+public:
+    FileSourceBenchmark(Duration latency) {
+        mbgl::benchmark::deleteDatabase(databasePath);
+        fileSource = std::make_unique<DefaultFileSource>(databasePath, ".");
+        fileSource->setOnlineFileSource(
+            std::make_unique<StubOnlineFileSource>(latency, connections, tileResponse));
+    }
+
+    ~FileSourceBenchmark() {
+        fileSource.reset();
+        mbgl::benchmark::deleteDatabase(databasePath);
+    }
+
+    // Requests the given tiles at the same time, and runs the loop until all of them are answered.
+    // Returns how long each of them took.
+    std::vector<Duration> request(const std::vector<Resource>& resources) {
+        std::vector<Duration> latencies(resources.size());
+        std::vector<std::unique_ptr<AsyncRequest>> requests;
+        std::size_t remaining = resources.size();
+        for (std::size_t i = 0; i < resources.size(); ++i) {
+            const TimePoint start = Clock::now();
+            requests.push_back(fileSource->request(resources[i], [&, i, start] (Response) {
+                latencies[i] = Clock::now() - start;
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            }));
+        }
+        loop.run();
+        return latencies;
+    }
+
+    util::RunLoop loop;
+    std::unique_ptr<DefaultFileSource> fileSource;
+};
+
+std::string latencyLabel(std::vector<Duration>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    Duration sum = Duration::zero();
+    for (const auto& latency : latencies) {
+        sum += latency;
+    }
+    auto ms = [] (Duration duration) {
+        return util::toString(std::chrono::duration<double, std::milli>(duration).count());
+    };
+    return "mean " + ms(sum / latencies.size()) + " ms, p99 " +
+           ms(latencies[latencies.size() * 99 / 100]) + " ms";
+}
+
+} // namespace
+
+// Requests of tiles that aren't cached, the given number of them at a time, to a network of the
+// given latency in milliseconds, until all of them are answered.
+static void DefaultFileSource_Request(::benchmark::State& state) {
+    FileSourceBenchmark bench(Milliseconds(state.range_x()));
+    const std::size_t concurrent = state.range_y();
+
+    std::size_t next = 0;
+    std::vector<Duration> latencies;
+    while (state.KeepRunning()) {
+        std::vector<Resource> resources;
+        for (std::size_t i = 0; i < concurrent; ++i) {
+            resources.push_back(tile(next++));
+        }
+        for (const auto& latency : bench.request(resources)) {
+            latencies.push_back(latency);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * concurrent);
+    state.SetLabel(latencyLabel(latencies));
+}
+
+// Optional requests of tiles that are in the cache, answered by reading it, without the memory
+// cache in front of it.
+static void DefaultFileSource_CachedRequest(::benchmark::State& state) {
+    const std::size_t count = 2000;
+    mbgl::benchmark::deleteDatabase(databasePath);
+    {
+        OfflineDatabase db(databasePath);
+        std::vector<std::pair<Resource, Response>> batch;
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.emplace_back(tile(i), tileResponse(tile(i)));
+        }
+        db.putBatch(batch, {});
+    }
+
+    util::RunLoop loop;
+    DefaultFileSource fileSource(databasePath, ".");
+    fileSource.setMaximumMemoryCacheSize(0);
+    const std::size_t concurrent = state.range_x();
+
+    std::size_t next = 0;
+    std::vector<Duration> latencies;
+    while (state.KeepRunning()) {
+        std::vector<std::unique_ptr<AsyncRequest>> requests;
+        std::size_t remaining = concurrent;
+        for (std::size_t i = 0; i < concurrent; ++i) {
+            Resource resource = tile((next++ * 7919) % count);
+            resource.necessity = Resource::Optional;
+            const TimePoint start = Clock::now();
+            requests.push_back(fileSource.request(resource, [&, start] (Response) {
+                latencies.push_back(Clock::now() - start);
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            }));
+        }
+        loop.run();
+    }
+    state.SetItemsProcessed(state.iterations() * concurrent);
+    state.SetLabel(latencyLabel(latencies));
+
+    mbgl::benchmark::deleteDatabase(databasePath);
+}
+
+// Downloading an offline region of a vector source, from z0 to z14 over San Francisco, from a
+// network of the given latency in milliseconds. Each iteration downloads a region of a style of
+// its own, so that none of its tiles are in the database yet.
+static void DefaultFileSource_OfflineDownload(::benchmark::State& state) {
+    mbgl::benchmark::deleteDatabase(databasePath);
+    util::RunLoop loop;
+    DefaultFileSource fileSource(databasePath, ".");
+    fileSource.setOnlineFileSource(std::make_unique<StubOnlineFileSource>(
+        Milliseconds(state.range_x()), connections, [] (const Resource& resource) {
+            if (resource.kind != Resource::Kind::Style) {
+                return tileResponse(resource);
+            }
+            // The styles of the iterations differ in the URLs of their tiles.
+            const std::string prefix = "http://example.com/style-";
+            const std::string style = resource.url.substr(prefix.size());
+            Response response;
+            response.data = std::make_shared<std::string>(
+                R"JSON({ "version": 8, "layers": [], "sources": { "streets": { "type": "vector", "maxzoom": 14, "tiles": [ "http://example.com/)JSON" +
+                style + R"JSON(/{z}/{x}/{y}.vector.pbf" ] } } })JSON");
+            return response;
+        }));
+
+    class Observer : public OfflineRegionObserver {
+    public:
+        void statusChanged(OfflineRegionStatus status) override {
+            if (status.complete() && status.requiredResourceCountIsPrecise && !done) {
+                done = true;
+                tiles = status.completedTileCount;
+                complete.set_value();
+            }
+        }
+
+        std::promise<void> complete;
+        bool done = false;
+        uint64_t tiles = 0;
+    };
+
+    std::size_t iteration = 0;
+    uint64_t tiles = 0;
+    while (state.KeepRunning()) {
+        OfflineTilePyramidRegionDefinition definition {
+            "http://example.com/style-" + util::toString(iteration++),
+            LatLngBounds::hull({ 37.70, -122.52 }, { 37.82, -122.35 }), 0, 14, 1.0 };
+
+        std::promise<OfflineRegion> created;
+        fileSource.createOfflineRegion(definition, {}, [&] (std::exception_ptr error, optional<OfflineRegion> region) {
+            if (error) {
+                created.set_exception(error);
+            } else {
+                created.set_value(std::move(*region));
+            }
+        });
+        OfflineRegion region = created.get_future().get();
+
+        auto observer = std::make_unique<Observer>();
+        Observer& current = *observer;
+        std::future<void> complete = current.complete.get_future();
+        fileSource.setOfflineRegionObserver(region, std::move(observer));
+        fileSource.setOfflineRegionDownloadState(region, OfflineRegionDownloadState::Active);
+        complete.wait();
+        tiles = current.tiles;
+        fileSource.setOfflineRegionDownloadState(region, OfflineRegionDownloadState::Inactive);
+    }
+    state.SetItemsProcessed(state.iterations() * tiles);
+    state.SetLabel(util::toString(tiles) + " tiles");
+
+    mbgl::benchmark::deleteDatabase(databasePath);
+}
+
+BENCHMARK(DefaultFileSource_Request)
+    ->ArgPair(0, 1)->ArgPair(0, 64)
+    ->ArgPair(20, 1)->ArgPair(20, 64)
+    ->ArgPair(100, 64)
+    ->Unit(::benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(DefaultFileSource_CachedRequest)->Arg(1)->Arg(64)->Unit(::benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(DefaultFileSource_OfflineDownload)->Arg(0)->Arg(20)->Unit(::benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,196 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/util.hpp>
+#include <mbgl/storage/offline.hpp>
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// A database file rather than an in-memory one, so that the writes and syncs of the write-ahead
+// log are part of what's measured.
+const std::string databasePath = "offline_database.benchmark.db";
+const std::string urlTemplate = "mapbox://tiles/mapbox.streets/{z}/{x}/{y}.vector.pbf";
+
+// A maximum cache size that none of the databases get to, for benchmarks that read all of their
+// tiles back.
+const uint64_t unlimited = std::numeric_limits<uint64_t>::max();
+
+// The tiles of a database are numbered along the rows of zoom level 14.
+Resource tile(std::size_t index) {
+    return Resource::tile(urlTemplate, 1.0, index % 16384, index / 16384, 14, Tileset::Scheme::XYZ);
+}
+
+Response response(std::size_t index) {
+    Response result;
+    result.data = mbgl::benchmark::tileData(index);
+    return result;
+}
+
+// A fresh database with the given number of tiles in the ambient cache, or as many of them as
+// fit into its maximum size.
+class Database {
+public:
+    Database(std::size_t count, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE) {
+        mbgl::benchmark::deleteDatabase(databasePath);
+        db = std::make_unique<OfflineDatabase>(databasePath, maximumCacheSize);
+        std::vector<std::pair<Resource, Response>> batch;
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.emplace_back(tile(i), response(i));
+            if (batch.size() == 64 || i + 1 == count) {
+                db->putBatch(batch, {});
+                batch.clear();
+            }
+        }
+        while (db->evictIncrementally(Milliseconds(100))) {
+        }
+    }
+
+    ~Database() {
+        db.reset();
+        mbgl::benchmark::deleteDatabase(databasePath);
+    }
+
+    std::unique_ptr<OfflineDatabase> db;
+};
+
+} // namespace
+
+// Adding tiles to the ambient cache one at a time, with a transaction each.
+static void OfflineDatabase_Put(::benchmark::State& state) {
+    Database database(0);
+    std::size_t i = 0;
+    int64_t bytes = 0;
+    while (state.KeepRunning()) {
+        const Response data = response(i);
+        database.db->put(tile(i++), data);
+        bytes += data.data->size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+
+// Adding them in transactions of 64, as DefaultFileSource writes them.
+static void OfflineDatabase_PutBatch(::benchmark::State& state) {
+    Database database(0);
+    std::size_t i = 0;
+    int64_t bytes = 0;
+    std::vector<std::pair<Resource, Response>> batch;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        batch.clear();
+        for (std::size_t j = 0; j < 64; ++j, ++i) {
+            batch.emplace_back(tile(i), response(i));
+            bytes += batch.back().second.data->size();
+        }
+        state.ResumeTiming();
+        database.db->putBatch(batch, {});
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+    state.SetBytesProcessed(bytes);
+}
+
+// Reading tiles of a cache of the given number of them on the writing connection, which marks
+// them as used, and on a read-only one, which leaves that to its caller.
+static void OfflineDatabase_Get(::benchmark::State& state) {
+    const std::size_t count = state.range_x();
+    Database database(count, unlimited);
+    std::size_t i = 0;
+    int64_t bytes = 0;
+    while (state.KeepRunning()) {
+        // Steps through the tiles in an order that isn't the one they were written in.
+        auto result = database.db->get(tile((i++ * 7919) % count));
+        bytes += result->data->size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+
+static void OfflineDatabase_Read(::benchmark::State& state) {
+    const std::size_t count = state.range_x();
+    Database database(count, unlimited);
+    OfflineDatabase reader(databasePath, OfflineDatabase::ReadOnly());
+    std::size_t i = 0;
+    int64_t bytes = 0;
+    while (state.KeepRunning()) {
+        auto result = reader.read(tile((i++ * 7919) % count));
+        bytes += result->data->size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(bytes);
+}
+
+// Adding tiles to a full cache, so that every put evicts the least recently used tiles.
+static void OfflineDatabase_PutEvicting(::benchmark::State& state) {
+    const std::size_t count = 2000;
+    Database database(count, 20 * 1024 * 1024);
+    std::size_t i = count;
+    while (state.KeepRunning()) {
+        database.db->put(tile(i), response(i));
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Evicting what a batch of 64 puts to a full cache took beyond its size, in the steps that
+// DefaultFileSource runs between requests.
+static void OfflineDatabase_EvictIncrementally(::benchmark::State& state) {
+    const std::size_t count = 2000;
+    Database database(count, 20 * 1024 * 1024);
+    std::size_t i = count;
+    std::vector<std::pair<Resource, Response>> batch;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        batch.clear();
+        for (std::size_t j = 0; j < 64; ++j, ++i) {
+            batch.emplace_back(tile(i), response(i));
+        }
+        database.db->putBatch(batch, {});
+        state.ResumeTiming();
+        while (database.db->evictIncrementally(Milliseconds(10))) {
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+// The status of a region of the given number of tiles, as an offline region's observer asks for
+// it while the region downloads.
+static void OfflineDatabase_RegionStatus(::benchmark::State& state) {
+    const std::size_t count = state.range_x();
+    Database database(0);
+    OfflineTilePyramidRegionDefinition definition { "mapbox://styles/mapbox/streets-v9",
+                                                    LatLngBounds::world(), 0, 14, 1.0 };
+    OfflineRegion region = database.db->createRegion(definition, {});
+
+    std::vector<std::pair<Resource, Response>> batch;
+    for (std::size_t i = 0; i < count; ++i) {
+        batch.emplace_back(tile(i), response(i));
+        if (batch.size() == 64 || i + 1 == count) {
+            database.db->putRegionResources(region.getID(), batch);
+            batch.clear();
+        }
+    }
+
+    uint64_t tiles = 0;
+    while (state.KeepRunning()) {
+        tiles = database.db->getRegionCompletedStatus(region.getID()).completedTileCount;
+    }
+    state.SetLabel(util::toString(tiles) + " tiles");
+}
+
+BENCHMARK(OfflineDatabase_Put)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(OfflineDatabase_PutBatch)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(OfflineDatabase_Get)->Arg(500)->Arg(5000)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(OfflineDatabase_Read)->Arg(500)->Arg(5000)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(OfflineDatabase_PutEvicting)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(OfflineDatabase_EvictIncrementally)->Unit(::benchmark::kMicrosecond);
+BENCHMARK(OfflineDatabase_RegionStatus)->Arg(1000)->Arg(10000)->Unit(::benchmark::kMicrosecond);
@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wshadow"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#pragma GCC diagnostic pop
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+// Labels of a dense tile: point labels, and line labels that are covered by a row of boxes.
+std::vector<CollisionFeature> randomFeatures() {
+    std::mt19937 random(0);
+    std::vector<CollisionFeature> features;
+    for (std::size_t i = 0; i < 4000; i++) {
+        const float x = random() % util::EXTENT;
+        const float y = random() % util::EXTENT;
+        const float width = 200 + random() % 1000;
+        const IndexedSubfeature indexedFeature { i, "source layer", "bucket", i };
+        features.emplace_back(GeometryCoordinates(), Anchor(x, y, 0, 0.5f, 0),
+                              -80, 80, -width / 2, width / 2, 1, 0, style::SymbolPlacementType::Point,
+                              indexedFeature, false);
+        if (i % 4 == 0) {
+            auto& boxes = features.back().boxes;
+            const CollisionBox box = boxes.front();
+            boxes.clear();
+            for (int16_t j = -3; j <= 3; j++) {
+                boxes.emplace_back(Point<float>(x + j * 160, y), -80, -80, 80, 80, box.maxScale);
+            }
+        }
+    }
+    return features;
+}
+
+// The boost rtree that CollisionTile used before its grid, with the same queries.
+class RTreeCollisionTile {
+public:
+    using CollisionPoint = boost::geometry::model::point<float, 2, boost::geometry::cs::cartesian>;
+    using Box = boost::geometry::model::box<CollisionPoint>;
+    using TreeBox = std::tuple<Box, CollisionBox, IndexedSubfeature>;
+
+    float placeFeature(const CollisionFeature& feature) {
+        float minPlacementScale = tile.minScale;
+        for (auto& box : feature.boxes) {
+            for (auto it = tree.qbegin(boost::geometry::index::intersects(getTreeBox(box.anchor, box))); it != tree.qend(); ++it) {
+                const CollisionBox& blocking = std::get<1>(*it);
+                minPlacementScale = findPlacementScale(minPlacementScale, box.anchor, box, blocking.anchor, blocking);
+                if (minPlacementScale >= tile.maxScale) return minPlacementScale;
+            }
+        }
+        return minPlacementScale;
+    }
+
+    void insertFeature(CollisionFeature& feature, float minPlacementScale) {
+        for (auto& box : feature.boxes) {
+            box.placementScale = minPlacementScale;
+        }
+        if (minPlacementScale < tile.maxScale) {
+            std::vector<TreeBox> treeBoxes;
+            for (const auto& box : feature.boxes) {
+                treeBoxes.emplace_back(getTreeBox(box.anchor, box), box, feature.indexedFeature);
+            }
+            tree.insert(treeBoxes.begin(), treeBoxes.end());
+        }
+    }
+
+private:
+    Box getTreeBox(const Point<float>& anchor, const CollisionBox& box) {
+        return Box { CollisionPoint { anchor.x + box.x1, anchor.y + box.y1 },
+                     CollisionPoint { anchor.x + box.x2, anchor.y + box.y2 } };
+    }
+
+    float findPlacementScale(float minPlacementScale, const Point<float>& anchor, const CollisionBox& box,
+                             const Point<float>& blockingAnchor, const CollisionBox& blocking) {
+        float s1 = (blocking.x1 - box.x2) / (anchor.x - blockingAnchor.x);
+        float s2 = (blocking.x2 - box.x1) / (anchor.x - blockingAnchor.x);
+        float s3 = (blocking.y1 - box.y2) / (anchor.y - blockingAnchor.y);
+        float s4 = (blocking.y2 - box.y1) / (anchor.y - blockingAnchor.y);
+        if (std::isnan(s1) || std::isnan(s2)) s1 = s2 = 1;
+        if (std::isnan(s3) || std::isnan(s4)) s3 = s4 = 1;
+        float collisionFreeScale = std::min(std::max(s1, s2), std::max(s3, s4));
+        collisionFreeScale = std::min({ collisionFreeScale, blocking.maxScale, box.maxScale });
+        if (collisionFreeScale > minPlacementScale && collisionFreeScale >= blocking.placementScale) {
+            minPlacementScale = collisionFreeScale;
+        }
+        return minPlacementScale;
+    }
+
+    const CollisionTile tile { PlacementConfig {} };
+    boost::geometry::index::rtree<TreeBox, boost::geometry::index::linear<16, 4>> tree;
+};
+
+} // namespace
+
+static void CollisionTile_Place(benchmark::State& state) {
+    // Inserting a feature sets its placement scales, which are all set again by the next run.
+    std::vector<CollisionFeature> features = randomFeatures();
+    std::size_t placed = 0;
+    std::size_t bytes = 0;
+
+    while (state.KeepRunning()) {
+        CollisionTile tile { PlacementConfig {} };
+        placed = 0;
+        for (auto& feature : features) {
+            const float scale = tile.placeFeature(feature, false, false);
+            tile.insertFeature(feature, scale, false);
+            placed += scale < tile.maxScale;
+        }
+        bytes = tile.getMemoryUsage();
+    }
+
+    state.SetLabel(util::toString(placed) + " placed, " + util::toString(bytes / 1024) + " kB");
+}
+
+static void CollisionTile_PlaceRTree(benchmark::State& state) {
+    // Inserting a feature sets its placement scales, which are all set again by the next run.
+    std::vector<CollisionFeature> features = randomFeatures();
+    std::size_t placed = 0;
+
+    while (state.KeepRunning()) {
+        RTreeCollisionTile tile;
+        placed = 0;
+        for (auto& feature : features) {
+            const float scale = tile.placeFeature(feature);
+            tile.insertFeature(feature, scale);
+            placed += scale < 2.0f;
+        }
+    }
+
+    state.SetLabel(util::toString(placed) + " placed");
+}
+
+BENCHMARK(CollisionTile_Place);
+BENCHMARK(CollisionTile_PlaceRTree);
@@ -4,6 +4,7 @@
 #include <mbgl/platform/platform.hpp>
 #include <mbgl/platform/default/settings_json.hpp>
 #include <mbgl/platform/default/glfw_view.hpp>
+#include <mbgl/platform/default/session.hpp>
 #include <mbgl/platform/default/thread_pool.hpp>
 #include <mbgl/storage/default_file_source.hpp>
 
@@ -36,6 +37,7 @@ int main(int argc, char *argv[]) {
     double latitude = 0, longitude = 0;
     double bearing = 0, zoom = 1, pitch = 0;
     bool skipConfig = false;
+    std::string recordPath;
 
     const struct option long_options[] = {
         {"fullscreen", no_argument, 0, 'f'},
@@ -46,6 +48,7 @@ int main(int argc, char *argv[]) {
         {"zoom", required_argument, 0, 'z'},
         {"bearing", required_argument, 0, 'r'},
         {"pitch", required_argument, 0, 'p'},
+        {"record", required_argument, 0, 'o'},
         {0, 0, 0, 0}
     };
 
@@ -87,6 +90,9 @@ int main(int argc, char *argv[]) {
             pitch = atof(optarg);
             skipConfig = true;
             break;
+        case 'o':
+            recordPath = optarg;
+            break;
         default:
             break;
         }
@@ -106,6 +112,14 @@ int main(int argc, char *argv[]) {
 
     view = std::make_unique<GLFWView>(fullscreen, benchmark);
 
+    // Records the session for mbgl-replay, including the annotation icon GLFWView adds up front.
+    std::unique_ptr<mbgl::SessionRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder = std::make_unique<mbgl::SessionRecorder>(recordPath);
+        view->setRecorder(recorder.get());
+        mbgl::Log::Info(mbgl::Event::Setup, "Recording session to: %s", recordPath.c_str());
+    }
+
     mbgl::DefaultFileSource fileSource("/tmp/mbgl-cache.db", ".");
 
     // Set access token if present
@@ -119,6 +133,8 @@ int main(int argc, char *argv[]) {
     mbgl::ThreadPool threadPool(4);
 
     mbgl::Map map(*view, fileSource, threadPool);
+    map.setProgramCachePath("/tmp/mbgl-cache.db");
+    map.setGlyphHistoryPath("/tmp/mbgl-cache.db");
 
     // Load settings
     mbgl::Settings_JSON settings;
@@ -165,6 +181,7 @@ int main(int argc, char *argv[]) {
     map.setStyleURL(style);
 
     view->run();
+    view->setRecorder(nullptr);
 
     // Save settings
     mbgl::LatLng latLng = map.getLatLng();
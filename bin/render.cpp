@@ -1,4 +1,7 @@
 #include <mbgl/map/map.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -17,8 +20,203 @@
 
 namespace po = boost::program_options;
 
+#include <algorithm>
 #include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+// In batch mode, Map renders the next image while the previous ones are read from the
+// framebuffer: reading an image only starts a transfer, which is finished a few images later.
+class BatchView : public HeadlessView {
+public:
+    using HeadlessView::HeadlessView;
+
+    PremultipliedImage readStillImage(std::array<uint16_t, 2> size) override {
+        if (!pipelined) {
+            return HeadlessView::readStillImage(size);
+        }
+        startStillImageRead(size);
+        return {};
+    }
+
+    bool pipelined = false;
+};
+
+struct Spec {
+    std::string output;
+    CameraOptions camera;
+    std::array<uint16_t, 2> size;
+};
+
+// Parses "<output> <lat> <lon> <zoom> [<bearing> [<pitch> [<width> <height>]]]"; the fields left
+// out have the values of the command line options.
+bool parseSpec(const std::string& line, const Spec& defaults, Spec& spec) {
+    std::istringstream fields(line);
+    spec = defaults;
+    double lat, lon, zoom;
+    if (!(fields >> spec.output >> lat >> lon >> zoom)) {
+        return false;
+    }
+    spec.camera.center = LatLng(lat, lon);
+    spec.camera.zoom = zoom;
+
+    double bearing, pitch;
+    if (fields >> bearing) {
+        spec.camera.angle = -bearing * util::DEG2RAD;
+        if (fields >> pitch) {
+            spec.camera.pitch = pitch * util::DEG2RAD;
+            int width, height;
+            if (fields >> width) {
+                if (!(fields >> height) || width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF) {
+                    return false;
+                }
+                spec.size = {{ static_cast<uint16_t>(width), static_cast<uint16_t>(height) }};
+            }
+        }
+    }
+    fields >> std::ws;
+    return fields.eof();
+}
+
+// Renders an image for each line of the input, keeping the map, its caches and its shaders from
+// one image to the next, and encodes and writes the images on threads of their own. Lines are
+// read in batches, whose images are rendered in an order that shares their tiles.
+int renderBatch(std::istream& input, std::size_t batchSize, const Spec& defaults,
+                util::RunLoop& loop, BatchView& view, Map& map) {
+    // The reads in flight while the next image renders; more of them only add memory.
+    const std::size_t readDepth = 2;
+    const std::size_t writers = std::max(1u, std::thread::hardware_concurrency());
+
+    std::deque<std::string> reading;
+    std::deque<std::pair<std::string, std::future<void>>> writing;
+    std::size_t written = 0;
+    std::size_t failed = 0;
+
+    auto finishWrite = [&] {
+        try {
+            writing.front().second.get();
+            written++;
+        } catch (std::exception& e) {
+            std::cout << "Error: " << writing.front().first << ": " << e.what() << std::endl;
+            failed++;
+        }
+        writing.pop_front();
+    };
+
+    auto finishRead = [&] {
+        std::string output = std::move(reading.front());
+        reading.pop_front();
+        std::promise<void> failure;
+        try {
+            PremultipliedImage image = view.finishStillImageRead();
+            writing.emplace_back(output, std::async(std::launch::async, [output, image = std::move(image)] {
+                util::write_file(output, encodePNG(image));
+            }));
+        } catch (...) {
+            failure.set_exception(std::current_exception());
+            writing.emplace_back(output, failure.get_future());
+        }
+        while (writing.size() > writers) {
+            finishWrite();
+        }
+    };
+
+    std::vector<Spec> specs;
+    auto renderSpecs = [&] {
+        // The view is resized between images of different sizes only.
+        std::stable_sort(specs.begin(), specs.end(), [] (const Spec& a, const Spec& b) {
+            return a.size < b.size;
+        });
+
+        for (auto first = specs.begin(); first != specs.end();) {
+            const auto last = std::find_if(first, specs.end(), [&] (const Spec& spec) {
+                return spec.size != first->size;
+            });
+            view.resize(first->size[0], first->size[1]);
+            map.update(Update::Dimensions);
+
+            std::vector<CameraOptions> cameras;
+            for (auto it = first; it != last; ++it) {
+                cameras.push_back(it->camera);
+            }
+
+            std::size_t remaining = cameras.size();
+            view.pipelined = true;
+            map.renderStills(cameras, [&] (std::size_t index, std::exception_ptr error, PremultipliedImage&&) {
+                const std::string& output = first[index].output;
+                if (error) {
+                    try {
+                        std::rethrow_exception(error);
+                    } catch (std::exception& e) {
+                        std::cout << "Error: " << output << ": " << e.what() << std::endl;
+                    }
+                    failed++;
+                } else {
+                    // Called while the view is active, right after the image was rendered.
+                    reading.push_back(output);
+                    while (reading.size() > readDepth || (!reading.empty() && view.isStillImageReadFinished())) {
+                        finishRead();
+                    }
+                }
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            });
+            loop.run();
+            view.pipelined = false;
+
+            view.activate();
+            while (!reading.empty()) {
+                finishRead();
+            }
+            view.deactivate();
+
+            first = last;
+        }
+        specs.clear();
+    };
+
+    const TimePoint start = Clock::now();
+    std::string line;
+    for (std::size_t number = 1; std::getline(input, line); ++number) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        Spec spec;
+        if (!parseSpec(line, defaults, spec)) {
+            std::cout << "Error: malformed line " << number << ": " << line << std::endl;
+            failed++;
+            continue;
+        }
+        specs.push_back(std::move(spec));
+        if (specs.size() == batchSize) {
+            renderSpecs();
+        }
+    }
+    renderSpecs();
+    while (!writing.empty()) {
+        finishWrite();
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << written << " images in " << seconds << " s, " << written / seconds << " images/s";
+    if (failed) {
+        std::cout << ", " << failed << " failed";
+    }
+    std::cout << std::endl;
+
+    return failed ? 1 : 0;
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
     std::string style_path;
@@ -36,6 +234,10 @@ int main(int argc, char *argv[]) {
     std::vector<std::string> classes;
     std::string token;
     bool debug = false;
+    bool numa = false;
+    bool startup_report = false;
+    std::string batch;
+    std::size_t batch_size = 256;
 
     po::options_description desc("Allowed options");
     desc.add_options()
@@ -50,9 +252,13 @@ int main(int argc, char *argv[]) {
         ("class,c", po::value(&classes)->value_name("name"), "Class name")
         ("token,t", po::value(&token)->value_name("key")->default_value(token), "Mapbox access token")
         ("debug", po::bool_switch(&debug)->default_value(debug), "Debug mode")
+        ("numa", po::bool_switch(&numa)->default_value(numa), "Pin worker threads to NUMA nodes")
+        ("startup-report", po::bool_switch(&startup_report)->default_value(startup_report), "Print what the first image waited for, and its critical path")
         ("output,o", po::value(&output)->value_name("file")->default_value(output), "Output file name")
         ("cache,d", po::value(&cache_file)->value_name("file")->default_value(cache_file), "Cache database file name")
         ("assets,d", po::value(&asset_root)->value_name("file")->default_value(asset_root), "Directory to which asset:// URLs will resolve")
+        ("batch", po::value(&batch)->value_name("file"), "Render an image for each line of a file, or of the standard input for -: <output> <lat> <lon> <zoom> [<bearing> [<pitch> [<width> <height>]]]")
+        ("batch-size", po::value(&batch_size)->value_name("number")->default_value(batch_size), "Lines of the batch file rendered together, in an order that shares their tiles")
     ;
 
     try {
@@ -66,7 +272,10 @@ int main(int argc, char *argv[]) {
 
     std::string style = mbgl::util::read_file(style_path);
 
-    using namespace mbgl;
+    // Before the file source opens its database, which is traced too.
+    if (startup_report) {
+        Map::setStartupTracingEnabled(true);
+    }
 
     util::RunLoop loop;
     DefaultFileSource fileSource(cache_file, asset_root);
@@ -84,9 +293,13 @@ int main(int argc, char *argv[]) {
         fileSource.setAccessToken(std::string(token));
     }
 
-    HeadlessView view(pixelRatio, width, height);
-    ThreadPool threadPool(4);
+    BatchView view(pixelRatio, width, height);
+    ThreadPool threadPool(4, numa ? ThreadAffinity::NUMA : ThreadAffinity::None);
     Map map(view, fileSource, threadPool, MapMode::Still);
+    if (cache_file != ":memory:") {
+        map.setProgramCachePath(cache_file);
+        map.setGlyphHistoryPath(cache_file);
+    }
 
     map.setStyleJSON(style);
     map.setClasses(classes);
@@ -99,6 +312,26 @@ int main(int argc, char *argv[]) {
         map.setDebug(debug ? mbgl::MapDebugOptions::TileBorders | mbgl::MapDebugOptions::ParseStatus : mbgl::MapDebugOptions::NoDebug);
     }
 
+    if (!batch.empty()) {
+        Spec defaults;
+        defaults.camera = map.getCameraOptions({});
+        defaults.size = {{ static_cast<uint16_t>(width), static_cast<uint16_t>(height) }};
+        std::ifstream file;
+        if (batch != "-") {
+            file.open(batch);
+            if (!file) {
+                std::cout << "Error: can't read " << batch << std::endl;
+                exit(1);
+            }
+        }
+        const int result = renderBatch(batch == "-" ? std::cin : file, std::max<std::size_t>(batch_size, 1),
+                                       defaults, loop, view, map);
+        if (startup_report) {
+            std::cout << Map::getStartupReport();
+        }
+        return result;
+    }
+
     map.renderStill([&](std::exception_ptr error, PremultipliedImage&& image) {
         try {
             if (error) {
@@ -115,5 +348,9 @@ int main(int argc, char *argv[]) {
 
     loop.run();
 
+    if (startup_report) {
+        std::cout << Map::getStartupReport();
+    }
+
     return 0;
 }
@@ -0,0 +1,224 @@
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/timer.hpp>
+
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/session.hpp>
+#include <mbgl/platform/default/thread_pool.hpp>
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/network_status.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunknown-pragmas"
+#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
+#pragma GCC diagnostic ignored "-Wshadow"
+#include <boost/program_options.hpp>
+#pragma GCC diagnostic pop
+
+namespace po = boost::program_options;
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace mbgl;
+
+namespace {
+
+// HeadlessView asserts that it's never invalidated, as still images are rendered on updates; in
+// continuous mode, invalidating only asks for the next frame.
+class ReplayView : public HeadlessView {
+public:
+    using HeadlessView::HeadlessView;
+
+    void invalidate() override {
+        dirty = true;
+    }
+
+    bool dirty = false;
+};
+
+double milliseconds(Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void report(const char* name, std::vector<Duration> times) {
+    if (times.empty()) {
+        return;
+    }
+    std::sort(times.begin(), times.end());
+    auto percentile = [&] (std::size_t p) {
+        return milliseconds(times[std::min(times.size() - 1, times.size() * p / 100)]);
+    };
+    std::printf("%-8s p50 %8.3f ms   p90 %8.3f ms   p99 %8.3f ms   max %8.3f ms\n", name,
+                percentile(50), percentile(90), percentile(99), milliseconds(times.back()));
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string session_path;
+    std::string style_url;
+    double pixelRatio = 1.0;
+    std::string cache_file = "cache.sqlite";
+    std::string asset_root = ".";
+    std::string token;
+    std::string csv_file;
+    bool online = false;
+    bool realtime = false;
+    bool stats = false;
+    int load_timeout = 10000;
+
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("session,i", po::value(&session_path)->required()->value_name("file"), "Session recorded with mbgl-glfw --record")
+        ("style,s", po::value(&style_url)->value_name("url"), "Style URL to use instead of the recorded ones")
+        ("pixel-ratio,r", po::value(&pixelRatio)->value_name("number")->default_value(pixelRatio), "Pixel ratio")
+        ("cache,d", po::value(&cache_file)->value_name("file")->default_value(cache_file), "Cache database file name")
+        ("assets,a", po::value(&asset_root)->value_name("file")->default_value(asset_root), "Directory to which asset:// URLs will resolve")
+        ("token,t", po::value(&token)->value_name("key")->default_value(token), "Mapbox access token")
+        ("online", po::bool_switch(&online)->default_value(online), "Request what isn't in the cache from the network")
+        ("realtime", po::bool_switch(&realtime)->default_value(realtime), "Render frames at the times they were recorded at, rather than once everything they show has loaded")
+        ("load-timeout", po::value(&load_timeout)->value_name("ms")->default_value(load_timeout), "How long to wait for a frame to load before rendering it anyway")
+        ("stats", po::bool_switch(&stats)->default_value(stats), "Also report the GPU times of the frames")
+        ("csv,o", po::value(&csv_file)->value_name("file"), "Write the times of each frame to a CSV file")
+    ;
+
+    try {
+        po::variables_map vm;
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+    } catch(std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl << desc;
+        exit(1);
+    }
+
+    std::vector<Session::Frame> frames;
+    try {
+        frames = Session(session_path).frames;
+    } catch (std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        exit(1);
+    }
+    if (frames.empty()) {
+        std::cout << "Error: " << session_path << " has no frames" << std::endl;
+        exit(1);
+    }
+
+    // Replays against what's in the cache, so that the network doesn't make runs differ.
+    if (!online) {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+    }
+
+    util::RunLoop loop;
+    DefaultFileSource fileSource(cache_file, asset_root);
+
+    if (!token.size()) {
+        const char *token_ptr = getenv("MAPBOX_ACCESS_TOKEN");
+        if (token_ptr) {
+            token = token_ptr;
+        }
+    }
+    if (token.size()) {
+        fileSource.setAccessToken(std::string(token));
+    }
+
+    ReplayView view(pixelRatio, frames.front().size[0], frames.front().size[1]);
+    ThreadPool threadPool(4);
+    Map map(view, fileSource, threadPool, MapMode::Continuous);
+    if (cache_file != ":memory:") {
+        map.setProgramCachePath(cache_file);
+        map.setGlyphHistoryPath(cache_file);
+    }
+    map.setFrameStatsEnabled(stats);
+    if (!style_url.empty()) {
+        map.setStyleURL(style_url);
+    }
+
+    // Keeps the loop from blocking, so that it can be run until a condition holds.
+    util::Timer tick;
+    tick.start(Duration::zero(), Milliseconds(1), [] {});
+    auto runUntil = [&] (auto condition, TimePoint deadline) {
+        while (!condition() && Clock::now() < deadline) {
+            loop.runOnce();
+        }
+    };
+
+    std::vector<Duration> cpuTimes;
+    std::vector<Duration> gpuTimes;
+    std::size_t incomplete = 0;
+    std::ofstream csv;
+    if (!csv_file.empty()) {
+        csv.open(csv_file);
+        csv << "frame,time,cpu,gpu,loaded\n";
+    }
+
+    view.activate();
+    const TimePoint start = Clock::now();
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        Session::Frame& frame = frames[i];
+        if (realtime) {
+            runUntil([] { return false; }, start + frame.time);
+        }
+
+        if (frame.styleURL && style_url.empty()) {
+            map.setStyleURL(*frame.styleURL);
+        }
+        for (const auto& change : frame.changes) {
+            change(map);
+        }
+        if (frame.size != view.getSize()) {
+            view.resize(frame.size[0], frame.size[1]);
+            map.update(Update::Dimensions);
+        }
+        map.jumpTo(frame.camera);
+
+        // Waits for the update of the changes, and in the default mode for everything the frame
+        // shows to load, so that every run renders the same frames.
+        view.dirty = false;
+        const TimePoint deadline = Clock::now() + Milliseconds(load_timeout);
+        runUntil([&] { return view.dirty; }, deadline);
+        if (!realtime) {
+            runUntil([&] { return map.isFullyLoaded(); }, deadline);
+        }
+        const bool loaded = map.isFullyLoaded();
+        if (!loaded) {
+            incomplete++;
+        }
+
+        const TimePoint begin = Clock::now();
+        map.render();
+        const Duration cpu = Clock::now() - begin;
+        cpuTimes.push_back(cpu);
+
+        optional<Duration> gpu;
+        if (stats) {
+            gpu = map.getFrameStats().total.gpu;
+            if (gpu) {
+                gpuTimes.push_back(*gpu);
+            }
+        }
+
+        if (csv.is_open()) {
+            csv << i << ',' << milliseconds(frame.time) << ',' << milliseconds(cpu) << ','
+                << (gpu ? std::to_string(milliseconds(*gpu)) : std::string()) << ','
+                << (loaded ? 1 : 0) << '\n';
+        }
+
+        // Frees the captured annotations and images of the frame.
+        frame.changes.clear();
+    }
+    view.deactivate();
+
+    std::printf("%zu frames in %.3f s, %zu of them rendered before they had loaded\n",
+                frames.size(), milliseconds(Clock::now() - start) / 1000, incomplete);
+    report("cpu", cpuTimes);
+    report("gpu", gpuTimes);
+
+    return 0;
+}
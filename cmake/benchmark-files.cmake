@@ -2,13 +2,25 @@
 
 set(MBGL_BENCHMARK_FILES
     # api
+    benchmark/api/annotations.benchmark.cpp
     benchmark/api/query.benchmark.cpp
+    benchmark/api/render.benchmark.cpp
 
     # include/mbgl
     benchmark/include/mbgl/benchmark.hpp
 
+    # layout
+    benchmark/layout/bucket.benchmark.cpp
+
+    # map
+    benchmark/map/transform.benchmark.cpp
+
     # parse
     benchmark/parse/filter.benchmark.cpp
+    benchmark/parse/varint.benchmark.cpp
+
+    # renderer
+    benchmark/renderer/vertex.benchmark.cpp
 
     # src
     benchmark/src/main.cpp
@@ -17,4 +29,11 @@ set(MBGL_BENCHMARK_FILES
     benchmark/src/mbgl/benchmark/benchmark.cpp
     benchmark/src/mbgl/benchmark/util.cpp
     benchmark/src/mbgl/benchmark/util.hpp
+
+    # storage
+    benchmark/storage/default_file_source.benchmark.cpp
+    benchmark/storage/offline_database.benchmark.cpp
+
+    # text
+    benchmark/text/collision_tile.benchmark.cpp
 )
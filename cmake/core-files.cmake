@@ -7,7 +7,15 @@ set(MBGL_CORE_FILES
     src/mbgl/actor/mailbox.cpp
     src/mbgl/actor/mailbox.hpp
     src/mbgl/actor/message.hpp
+    src/mbgl/actor/message_pool.cpp
+    src/mbgl/actor/message_pool.hpp
+    src/mbgl/actor/message_queue.cpp
+    src/mbgl/actor/message_queue.hpp
+    src/mbgl/actor/parallel_for.cpp
+    src/mbgl/actor/parallel_for.hpp
     src/mbgl/actor/scheduler.hpp
+    src/mbgl/actor/statistics.cpp
+    src/mbgl/actor/statistics.hpp
 
     # algorithm
     src/mbgl/algorithm/covered_by_children.hpp
@@ -46,38 +54,52 @@ set(MBGL_CORE_FILES
     # geometry
     src/mbgl/geometry/anchor.hpp
     src/mbgl/geometry/binpack.hpp
+    src/mbgl/geometry/dem_data.cpp
+    src/mbgl/geometry/dem_data.hpp
     src/mbgl/geometry/debug_font_data.hpp
     src/mbgl/geometry/feature_index.cpp
     src/mbgl/geometry/feature_index.hpp
     src/mbgl/geometry/line_atlas.cpp
     src/mbgl/geometry/line_atlas.hpp
+    src/mbgl/geometry/shelf_pack.hpp
 
     # gl
     include/mbgl/gl/gl.hpp
     src/mbgl/gl/attribute.hpp
+    src/mbgl/gl/buffer_arena.cpp
+    src/mbgl/gl/buffer_arena.hpp
     src/mbgl/gl/context.cpp
     src/mbgl/gl/context.hpp
     src/mbgl/gl/debugging.cpp
     src/mbgl/gl/debugging.hpp
+    src/mbgl/gl/dirty_regions.cpp
+    src/mbgl/gl/dirty_regions.hpp
     src/mbgl/gl/extension.cpp
     src/mbgl/gl/extension.hpp
     src/mbgl/gl/gl.cpp
     src/mbgl/gl/index_buffer.hpp
+    src/mbgl/gl/instancing.cpp
+    src/mbgl/gl/instancing.hpp
     src/mbgl/gl/object.cpp
     src/mbgl/gl/object.hpp
+    src/mbgl/gl/program_binary.cpp
+    src/mbgl/gl/program_binary.hpp
     src/mbgl/gl/shader.cpp
     src/mbgl/gl/shader.hpp
     src/mbgl/gl/state.hpp
+    src/mbgl/gl/texture.cpp
     src/mbgl/gl/texture.hpp
+    src/mbgl/gl/timer_query.cpp
+    src/mbgl/gl/timer_query.hpp
     src/mbgl/gl/types.hpp
     src/mbgl/gl/uniform.cpp
     src/mbgl/gl/uniform.hpp
     src/mbgl/gl/value.cpp
     src/mbgl/gl/value.hpp
-    src/mbgl/gl/vao.cpp
-    src/mbgl/gl/vao.hpp
     src/mbgl/gl/vertex_array.cpp
     src/mbgl/gl/vertex_array.hpp
+    src/mbgl/gl/vertex_array_cache.cpp
+    src/mbgl/gl/vertex_array_cache.hpp
     src/mbgl/gl/vertex_buffer.hpp
 
     # layout
@@ -92,9 +114,13 @@ set(MBGL_CORE_FILES
     src/mbgl/layout/symbol_layout.hpp
 
     # map
+    include/mbgl/map/actor_stats.hpp
     include/mbgl/map/camera.hpp
+    include/mbgl/map/frame_stats.hpp
     include/mbgl/map/map.hpp
+    include/mbgl/map/memory_report.hpp
     include/mbgl/map/mode.hpp
+    include/mbgl/map/query.hpp
     include/mbgl/map/update.hpp
     include/mbgl/map/view.hpp
     src/mbgl/map/change.hpp
@@ -133,6 +159,9 @@ set(MBGL_CORE_FILES
     include/mbgl/platform/default/headless_display.hpp
     include/mbgl/platform/default/headless_view.hpp
     include/mbgl/platform/default/settings_json.hpp
+    include/mbgl/platform/default/shared_thread_pool.hpp
+    include/mbgl/platform/default/thread_pool.hpp
+    include/mbgl/platform/default/work_stealing_thread_pool.hpp
 
     # renderer
     src/mbgl/renderer/bucket.hpp
@@ -145,6 +174,8 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/fill_bucket.hpp
     src/mbgl/renderer/frame_history.cpp
     src/mbgl/renderer/frame_history.hpp
+    src/mbgl/renderer/frame_timer.cpp
+    src/mbgl/renderer/frame_timer.hpp
     src/mbgl/renderer/line_bucket.cpp
     src/mbgl/renderer/line_bucket.hpp
     src/mbgl/renderer/paint_parameters.hpp
@@ -154,10 +185,13 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/painter_circle.cpp
     src/mbgl/renderer/painter_clipping.cpp
     src/mbgl/renderer/painter_debug.cpp
+    src/mbgl/renderer/painter_dynamic_point.cpp
     src/mbgl/renderer/painter_fill.cpp
     src/mbgl/renderer/painter_line.cpp
+    src/mbgl/renderer/painter_picking.cpp
     src/mbgl/renderer/painter_raster.cpp
     src/mbgl/renderer/painter_symbol.cpp
+    src/mbgl/renderer/painter_tile_textures.cpp
     src/mbgl/renderer/raster_bucket.cpp
     src/mbgl/renderer/raster_bucket.hpp
     src/mbgl/renderer/render_item.hpp
@@ -168,6 +202,12 @@ set(MBGL_CORE_FILES
     src/mbgl/renderer/symbol_bucket.hpp
 
     # shader
+    src/mbgl/shader/category_vertex.cpp
+    src/mbgl/shader/category_vertex.hpp
+    src/mbgl/shader/circle_data_driven_shader.cpp
+    src/mbgl/shader/circle_data_driven_shader.hpp
+    src/mbgl/shader/circle_instanced_shader.cpp
+    src/mbgl/shader/circle_instanced_shader.hpp
     src/mbgl/shader/circle_shader.cpp
     src/mbgl/shader/circle_shader.hpp
     src/mbgl/shader/circle_vertex.cpp
@@ -176,16 +216,34 @@ set(MBGL_CORE_FILES
     src/mbgl/shader/collision_box_shader.hpp
     src/mbgl/shader/collision_box_vertex.cpp
     src/mbgl/shader/collision_box_vertex.hpp
+    src/mbgl/shader/color_vertex.cpp
+    src/mbgl/shader/color_vertex.hpp
+    src/mbgl/shader/dynamic_point_shader.cpp
+    src/mbgl/shader/dynamic_point_shader.hpp
+    src/mbgl/shader/dynamic_point_vertex.cpp
+    src/mbgl/shader/dynamic_point_vertex.hpp
+    src/mbgl/shader/feature_state_vertex.cpp
+    src/mbgl/shader/feature_state_vertex.hpp
+    src/mbgl/shader/fill_category_shader.cpp
+    src/mbgl/shader/fill_category_shader.hpp
+    src/mbgl/shader/fill_data_driven_shader.cpp
+    src/mbgl/shader/fill_data_driven_shader.hpp
+    src/mbgl/shader/fill_feature_state_shader.cpp
+    src/mbgl/shader/fill_feature_state_shader.hpp
     src/mbgl/shader/fill_outline_pattern_shader.cpp
     src/mbgl/shader/fill_outline_pattern_shader.hpp
     src/mbgl/shader/fill_outline_shader.cpp
     src/mbgl/shader/fill_outline_shader.hpp
     src/mbgl/shader/fill_pattern_shader.cpp
     src/mbgl/shader/fill_pattern_shader.hpp
+    src/mbgl/shader/fill_picking_shader.cpp
+    src/mbgl/shader/fill_picking_shader.hpp
     src/mbgl/shader/fill_shader.cpp
     src/mbgl/shader/fill_shader.hpp
     src/mbgl/shader/fill_vertex.cpp
     src/mbgl/shader/fill_vertex.hpp
+    src/mbgl/shader/hillshade_shader.cpp
+    src/mbgl/shader/hillshade_shader.hpp
     src/mbgl/shader/line_pattern_shader.cpp
     src/mbgl/shader/line_pattern_shader.hpp
     src/mbgl/shader/line_sdf_shader.cpp
@@ -194,6 +252,8 @@ set(MBGL_CORE_FILES
     src/mbgl/shader/line_shader.hpp
     src/mbgl/shader/line_vertex.cpp
     src/mbgl/shader/line_vertex.hpp
+    src/mbgl/shader/picking_vertex.cpp
+    src/mbgl/shader/picking_vertex.hpp
     src/mbgl/shader/raster_shader.cpp
     src/mbgl/shader/raster_shader.hpp
     src/mbgl/shader/raster_vertex.cpp
@@ -211,6 +271,8 @@ set(MBGL_CORE_FILES
     src/mbgl/sprite/sprite_atlas.cpp
     src/mbgl/sprite/sprite_atlas.hpp
     src/mbgl/sprite/sprite_atlas_observer.hpp
+    src/mbgl/sprite/sprite_atlas_worker.cpp
+    src/mbgl/sprite/sprite_atlas_worker.hpp
     src/mbgl/sprite/sprite_image.cpp
     src/mbgl/sprite/sprite_parser.cpp
     src/mbgl/sprite/sprite_parser.hpp
@@ -229,6 +291,7 @@ set(MBGL_CORE_FILES
     src/mbgl/storage/network_status.cpp
     src/mbgl/storage/resource.cpp
     src/mbgl/storage/response.cpp
+    src/mbgl/storage/tile_archive_file_source.hpp
 
     # style
     include/mbgl/style/conversion.hpp
@@ -240,17 +303,26 @@ set(MBGL_CORE_FILES
     include/mbgl/style/source.hpp
     include/mbgl/style/transition_options.hpp
     include/mbgl/style/types.hpp
+    src/mbgl/style/binary_property_codec.hpp
+    src/mbgl/style/binary_style.cpp
+    src/mbgl/style/binary_style.hpp
     src/mbgl/style/bucket_parameters.cpp
     src/mbgl/style/bucket_parameters.hpp
     src/mbgl/style/calculation_parameters.hpp
     src/mbgl/style/cascade_parameters.hpp
     src/mbgl/style/class_dictionary.cpp
     src/mbgl/style/class_dictionary.hpp
+    src/mbgl/style/compiled_filter.cpp
+    src/mbgl/style/compiled_filter.hpp
+    src/mbgl/style/feature_states.cpp
+    src/mbgl/style/feature_states.hpp
+    src/mbgl/style/filter.cpp
     src/mbgl/style/layer.cpp
     src/mbgl/style/layer_impl.cpp
     src/mbgl/style/layer_impl.hpp
     src/mbgl/style/layer_observer.hpp
     src/mbgl/style/layout_property.hpp
+    src/mbgl/style/make_property_codecs.hpp
     src/mbgl/style/observer.hpp
     src/mbgl/style/paint_property.hpp
     src/mbgl/style/parser.cpp
@@ -290,6 +362,7 @@ set(MBGL_CORE_FILES
     include/mbgl/style/layers/background_layer.hpp
     include/mbgl/style/layers/circle_layer.hpp
     include/mbgl/style/layers/custom_layer.hpp
+    include/mbgl/style/layers/dynamic_point_layer.hpp
     include/mbgl/style/layers/fill_layer.hpp
     include/mbgl/style/layers/line_layer.hpp
     include/mbgl/style/layers/raster_layer.hpp
@@ -307,6 +380,9 @@ set(MBGL_CORE_FILES
     src/mbgl/style/layers/custom_layer.cpp
     src/mbgl/style/layers/custom_layer_impl.cpp
     src/mbgl/style/layers/custom_layer_impl.hpp
+    src/mbgl/style/layers/dynamic_point_layer.cpp
+    src/mbgl/style/layers/dynamic_point_layer_impl.cpp
+    src/mbgl/style/layers/dynamic_point_layer_impl.hpp
     src/mbgl/style/layers/fill_layer.cpp
     src/mbgl/style/layers/fill_layer_impl.cpp
     src/mbgl/style/layers/fill_layer_impl.hpp
@@ -332,9 +408,15 @@ set(MBGL_CORE_FILES
     include/mbgl/style/sources/geojson_source.hpp
     include/mbgl/style/sources/raster_source.hpp
     include/mbgl/style/sources/vector_source.hpp
+    src/mbgl/style/sources/geojson_index.cpp
+    src/mbgl/style/sources/geojson_index.hpp
+    src/mbgl/style/sources/geojson_reader.cpp
+    src/mbgl/style/sources/geojson_reader.hpp
     src/mbgl/style/sources/geojson_source.cpp
     src/mbgl/style/sources/geojson_source_impl.cpp
     src/mbgl/style/sources/geojson_source_impl.hpp
+    src/mbgl/style/sources/geojson_source_worker.cpp
+    src/mbgl/style/sources/geojson_source_worker.hpp
     src/mbgl/style/sources/raster_source.cpp
     src/mbgl/style/sources/raster_source_impl.cpp
     src/mbgl/style/sources/raster_source_impl.hpp
@@ -343,10 +425,13 @@ set(MBGL_CORE_FILES
     src/mbgl/style/sources/vector_source_impl.hpp
 
     # text
+    include/mbgl/text/local_glyph_rasterizer.hpp
     src/mbgl/text/check_max_angle.cpp
     src/mbgl/text/check_max_angle.hpp
     src/mbgl/text/collision_feature.cpp
     src/mbgl/text/collision_feature.hpp
+    src/mbgl/text/collision_grid.cpp
+    src/mbgl/text/collision_grid.hpp
     src/mbgl/text/collision_tile.cpp
     src/mbgl/text/collision_tile.hpp
     src/mbgl/text/get_anchors.cpp
@@ -359,15 +444,27 @@ set(MBGL_CORE_FILES
     src/mbgl/text/glyph_pbf.cpp
     src/mbgl/text/glyph_pbf.hpp
     src/mbgl/text/glyph_range.hpp
+    src/mbgl/text/glyph_range_history.cpp
+    src/mbgl/text/glyph_range_history.hpp
+    src/mbgl/text/glyph_sdf.cpp
+    src/mbgl/text/glyph_sdf.hpp
     src/mbgl/text/glyph_set.cpp
     src/mbgl/text/glyph_set.hpp
+    src/mbgl/text/line_metrics.cpp
+    src/mbgl/text/line_metrics.hpp
     src/mbgl/text/placement_config.hpp
     src/mbgl/text/quads.cpp
     src/mbgl/text/quads.hpp
     src/mbgl/text/shaping.cpp
     src/mbgl/text/shaping.hpp
+    src/mbgl/text/shaping_cache.cpp
+    src/mbgl/text/shaping_cache.hpp
 
     # tile
+    src/mbgl/tile/cross_tile_placement_worker.cpp
+    src/mbgl/tile/cross_tile_placement_worker.hpp
+    src/mbgl/tile/flat_tile_data.cpp
+    src/mbgl/tile/flat_tile_data.hpp
     src/mbgl/tile/geojson_tile.cpp
     src/mbgl/tile/geojson_tile.hpp
     src/mbgl/tile/geometry_tile.cpp
@@ -376,10 +473,14 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/geometry_tile_data.hpp
     src/mbgl/tile/geometry_tile_worker.cpp
     src/mbgl/tile/geometry_tile_worker.hpp
+    src/mbgl/tile/metatile_file_source.cpp
+    src/mbgl/tile/metatile_file_source.hpp
     src/mbgl/tile/raster_tile.cpp
     src/mbgl/tile/raster_tile.hpp
     src/mbgl/tile/raster_tile_worker.cpp
     src/mbgl/tile/raster_tile_worker.hpp
+    src/mbgl/tile/symbol_placement_worker.cpp
+    src/mbgl/tile/symbol_placement_worker.hpp
     src/mbgl/tile/tile.cpp
     src/mbgl/tile/tile.hpp
     src/mbgl/tile/tile_cache.cpp
@@ -389,6 +490,8 @@ set(MBGL_CORE_FILES
     src/mbgl/tile/tile_loader.hpp
     src/mbgl/tile/tile_loader_impl.hpp
     src/mbgl/tile/tile_observer.hpp
+    src/mbgl/tile/tile_trace.cpp
+    src/mbgl/tile/tile_trace.hpp
     src/mbgl/tile/vector_tile.cpp
     src/mbgl/tile/vector_tile.hpp
 
@@ -409,6 +512,7 @@ set(MBGL_CORE_FILES
     include/mbgl/util/geojson.hpp
     include/mbgl/util/geometry.hpp
     include/mbgl/util/image.hpp
+    include/mbgl/util/instrumentation.hpp
     include/mbgl/util/noncopyable.hpp
     include/mbgl/util/optional.hpp
     include/mbgl/util/projection.hpp
@@ -445,11 +549,14 @@ set(MBGL_CORE_FILES
     src/mbgl/util/http_header.hpp
     src/mbgl/util/http_timeout.cpp
     src/mbgl/util/http_timeout.hpp
+    src/mbgl/util/instrumentation.cpp
     src/mbgl/util/interpolate.hpp
     src/mbgl/util/intersection_tests.cpp
     src/mbgl/util/intersection_tests.hpp
     src/mbgl/util/io.cpp
     src/mbgl/util/io.hpp
+    src/mbgl/util/ktx.cpp
+    src/mbgl/util/ktx.hpp
     src/mbgl/util/mapbox.cpp
     src/mbgl/util/mapbox.hpp
     src/mbgl/util/mat2.cpp
@@ -460,12 +567,17 @@ set(MBGL_CORE_FILES
     src/mbgl/util/mat4.hpp
     src/mbgl/util/math.cpp
     src/mbgl/util/math.hpp
+    src/mbgl/util/memory_usage.hpp
+    src/mbgl/util/monotonic_arena.cpp
+    src/mbgl/util/monotonic_arena.hpp
     src/mbgl/util/offscreen_texture.cpp
     src/mbgl/util/offscreen_texture.hpp
     src/mbgl/util/premultiply.cpp
     src/mbgl/util/premultiply.hpp
     src/mbgl/util/rapidjson.hpp
     src/mbgl/util/rect.hpp
+    src/mbgl/util/startup_trace.cpp
+    src/mbgl/util/startup_trace.hpp
     src/mbgl/util/std.hpp
     src/mbgl/util/stopwatch.cpp
     src/mbgl/util/stopwatch.hpp
@@ -480,6 +592,8 @@ set(MBGL_CORE_FILES
     src/mbgl/util/url.cpp
     src/mbgl/util/url.hpp
     src/mbgl/util/utf.hpp
+    src/mbgl/util/varint.cpp
+    src/mbgl/util/varint.hpp
     src/mbgl/util/version_info.cpp
     src/mbgl/util/work_queue.cpp
     src/mbgl/util/work_queue.hpp
@@ -7,6 +7,8 @@ target_sources(mbgl-glfw
     PRIVATE platform/default/glfw_view.cpp
     PRIVATE include/mbgl/platform/default/settings_json.hpp
     PRIVATE platform/default/settings_json.cpp
+    PRIVATE include/mbgl/platform/default/session.hpp
+    PRIVATE platform/default/session.cpp
 )
 
 target_compile_options(mbgl-glfw
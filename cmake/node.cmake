@@ -7,6 +7,8 @@ target_sources(mbgl-node
     PRIVATE platform/node/src/node_log.cpp
     PRIVATE platform/node/src/node_map.hpp
     PRIVATE platform/node/src/node_map.cpp
+    PRIVATE platform/node/src/node_map_pool.hpp
+    PRIVATE platform/node/src/node_map_pool.cpp
     PRIVATE platform/node/src/node_request.hpp
     PRIVATE platform/node/src/node_request.cpp
     PRIVATE platform/node/src/node_feature.hpp
@@ -0,0 +1,28 @@
+add_executable(mbgl-replay
+    bin/replay.cpp
+)
+
+target_sources(mbgl-replay
+    PRIVATE include/mbgl/platform/default/session.hpp
+    PRIVATE platform/default/session.cpp
+)
+
+target_compile_options(mbgl-replay
+    PRIVATE -fvisibility-inlines-hidden
+)
+
+target_include_directories(mbgl-replay
+    PRIVATE include
+    PRIVATE src # TODO: eliminate
+)
+
+target_link_libraries(mbgl-replay
+    PRIVATE mbgl-core
+)
+
+target_add_mason_package(mbgl-replay PRIVATE boost)
+target_add_mason_package(mbgl-replay PRIVATE boost_libprogram_options)
+
+mbgl_platform_replay()
+
+create_source_groups(mbgl-replay)
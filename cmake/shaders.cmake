@@ -25,5 +25,3 @@ add_shader(MBGL_SHADER_FILES line)
 add_shader(MBGL_SHADER_FILES line_pattern)
 add_shader(MBGL_SHADER_FILES line_sdf)
 add_shader(MBGL_SHADER_FILES raster)
-add_shader(MBGL_SHADER_FILES symbol_icon)
-add_shader(MBGL_SHADER_FILES symbol_sdf)
@@ -4,6 +4,9 @@ set(MBGL_TEST_FILES
     # actor
     test/actor/actor.test.cpp
     test/actor/actor_ref.test.cpp
+    test/actor/parallel_for.test.cpp
+    test/actor/shared_thread_pool.test.cpp
+    test/actor/work_stealing_thread_pool.test.cpp
 
     # algorithm
     test/algorithm/covered_by_children.test.cpp
@@ -21,9 +24,15 @@ set(MBGL_TEST_FILES
 
     # geometry
     test/geometry/binpack.test.cpp
+    test/geometry/dem_data.test.cpp
+    test/geometry/line_atlas.test.cpp
+    test/geometry/shelf_pack.test.cpp
 
     # gl
+    test/gl/dirty_regions.test.cpp
+    test/gl/headless_view.test.cpp
     test/gl/object.test.cpp
+    test/gl/program_binary.test.cpp
 
     # include/mbgl
     test/include/mbgl/test.hpp
@@ -37,6 +46,9 @@ set(MBGL_TEST_FILES
     test/math/minmax.test.cpp
     test/math/wrap.test.cpp
 
+    # renderer
+    test/renderer/frame_timer.test.cpp
+
     # sprite
     test/sprite/sprite_atlas.test.cpp
     test/sprite/sprite_image.test.cpp
@@ -50,6 +62,7 @@ set(MBGL_TEST_FILES
     test/src/mbgl/test/fake_file_source.hpp
     test/src/mbgl/test/fixture_log_observer.cpp
     test/src/mbgl/test/fixture_log_observer.hpp
+    test/src/mbgl/test/rect.hpp
     test/src/mbgl/test/stub_file_source.cpp
     test/src/mbgl/test/stub_file_source.hpp
     test/src/mbgl/test/stub_layer_observer.hpp
@@ -67,15 +80,22 @@ set(MBGL_TEST_FILES
     test/storage/offline.test.cpp
     test/storage/offline_database.test.cpp
     test/storage/offline_download.test.cpp
+    test/storage/offline_pack.test.cpp
     test/storage/online_file_source.test.cpp
     test/storage/resource.test.cpp
+    test/storage/tile_archive_file_source.test.cpp
 
     # style/conversion
     test/style/conversion/geojson_options.test.cpp
 
     # style
+    test/style/binary_style.test.cpp
+    test/style/feature_states.test.cpp
     test/style/filter.test.cpp
     test/style/functions.test.cpp
+    test/style/geojson_index.test.cpp
+    test/style/geojson_reader.test.cpp
+    test/style/paint_property.test.cpp
     test/style/source.test.cpp
     test/style/style.test.cpp
     test/style/style_layer.test.cpp
@@ -83,33 +103,50 @@ set(MBGL_TEST_FILES
     test/style/tile_source.test.cpp
 
     # text
+    test/text/collision_grid.test.cpp
+    test/text/collision_tile.test.cpp
     test/text/glyph_atlas.test.cpp
+    test/text/glyph_range_history.test.cpp
+    test/text/glyph_sdf.test.cpp
+    test/text/line_metrics.test.cpp
     test/text/quads.test.cpp
+    test/text/shaping_cache.test.cpp
 
     # tile
+    test/tile/flat_tile_data.test.cpp
     test/tile/geometry_tile_data.test.cpp
+    test/tile/metatile_file_source.test.cpp
     test/tile/raster_tile.test.cpp
+    test/tile/tile_cache.test.cpp
     test/tile/tile_coordinate.test.cpp
     test/tile/tile_id.test.cpp
+    test/tile/tile_trace.test.cpp
     test/tile/vector_tile.test.cpp
 
     # util
     test/util/async_task.test.cpp
+    test/util/compression.test.cpp
     test/util/geo.test.cpp
+    test/util/grid_index.test.cpp
     test/util/http_timeout.test.cpp
     test/util/image.test.cpp
+    test/util/instrumentation.test.cpp
+    test/util/ktx.test.cpp
     test/util/mapbox.test.cpp
     test/util/memory.test.cpp
     test/util/merge_lines.test.cpp
+    test/util/monotonic_arena.test.cpp
     test/util/number_conversions.test.cpp
     test/util/offscreen_texture.test.cpp
     test/util/projection.test.cpp
     test/util/run_loop.test.cpp
+    test/util/startup_trace.test.cpp
     test/util/text_conversions.test.cpp
     test/util/thread.test.cpp
     test/util/thread_local.test.cpp
     test/util/tile_cover.test.cpp
     test/util/timer.test.cpp
     test/util/token.test.cpp
+    test/util/varint.test.cpp
     test/util/work_queue.test.cpp
 )
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mbgl {
+
+// The statistics of all mailboxes of one actor type, e.g. of the tile workers; see
+// Map::getActorStats(). Counters are cumulative and never reset; pollers compute rates from
+// successive snapshots.
+//
+// Times are recorded in histograms with power-of-two microsecond buckets: bucket 0 counts samples
+// shorter than 1µs, bucket `i` counts samples in [2^(i-1), 2^i) µs, and the last bucket also
+// counts everything longer than that.
+struct ActorStats {
+    static constexpr std::size_t BucketCount = 24;
+    using Histogram = std::array<uint64_t, BucketCount>;
+
+    std::string tag;
+
+    // Messages pushed but neither processed, dropped nor discarded with their mailbox yet.
+    std::size_t queueDepth = 0;
+
+    // Messages processed, and messages dropped because they were superseded or cancelled.
+    uint64_t processed = 0;
+    uint64_t dropped = 0;
+
+    // Time from a message being pushed until it started executing.
+    Histogram waitTime {};
+
+    // Time spent executing a message.
+    Histogram runTime {};
+};
+
+} // namespace mbgl
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// How long rendering a frame took, in total, by phase and by layer; see Map::setFrameStats().
+// CPU times are those of the render thread. GPU times are measured with timer queries, and are
+// absent where the driver doesn't support them or the GPU couldn't measure the frame reliably.
+class FrameStats {
+public:
+    enum class Phase : uint8_t {
+        Upload,       // Uploading tiles and atlases.
+        Prepare,      // Rendering the slope and aspect of DEM tiles.
+        Clear,        // Clearing the framebuffer.
+        Clip,         // Drawing the clipping masks, and culling the render tiles.
+        TileTextures, // Rendering the layers of sources that cache them into textures per tile.
+        BaseLayers,   // Rendering the layers below the symbols into a texture, or drawing it.
+        Opaque,       // The opaque pass over the layers.
+        Translucent,  // The translucent pass over the layers.
+        Debug,        // Debug overlays.
+        Picking,      // The picking pass for pickable layers.
+        Finish,       // Scaling up a frame of a reduced render scale, and cleaning up.
+    };
+    static constexpr std::size_t PhaseCount = 11;
+
+    struct Timing {
+        Duration cpu = Duration::zero();
+        optional<Duration> gpu;
+    };
+
+    struct LayerTiming {
+        std::string layerID;
+        Duration cpu = Duration::zero();
+        optional<Duration> gpu;
+    };
+
+    // When the frame was rendered; TimePoint::min() for the stats of no frame.
+    TimePoint timePoint = TimePoint::min();
+
+    Timing total;
+    std::array<Timing, PhaseCount> phases;
+
+    // The layers that were drawn, in the order they were first drawn in, over all passes. Their
+    // times are part of the times of the phases they were drawn in.
+    std::vector<LayerTiming> layers;
+
+    const Timing& phase(Phase phase_) const {
+        return phases[static_cast<std::size_t>(phase_)];
+    }
+};
+
+} // namespace mbgl
@@ -5,11 +5,16 @@
 #include <mbgl/util/image.hpp>
 #include <mbgl/map/update.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/query.hpp>
+#include <mbgl/map/actor_stats.hpp>
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/map/memory_report.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/style/transition_options.hpp>
+#include <mbgl/style/filter.hpp>
 
 #include <cstdint>
 #include <string>
@@ -23,6 +28,7 @@ class View;
 class FileSource;
 class Scheduler;
 class SpriteImage;
+class LocalGlyphRasterizer;
 struct CameraOptions;
 struct AnimationOptions;
 
@@ -45,6 +51,21 @@ public:
     using StillImageCallback = std::function<void (std::exception_ptr, PremultipliedImage&&)>;
     void renderStill(StillImageCallback callback);
 
+    // Renders a still image for each of the cameras, at the size of the view, and calls the
+    // callback with the camera's index as each image is done. The cameras are rendered in an order
+    // that keeps the tiles they share loaded from one image to the next, rather than in the order
+    // given; an error only fails the image it occurred for.
+    using StillImageBatchCallback = std::function<void (std::size_t, std::exception_ptr, PremultipliedImage&&)>;
+    void renderStills(const std::vector<CameraOptions>&, StillImageBatchCallback);
+
+    // Renders a still image of the given size, which may be larger than the view, in parts of the
+    // view's size that share the same tiles, and calls the callback with each band of rows of the
+    // image as its parts are done, from the top; the band that ends at the bottom of the image is
+    // the last. This keeps the size of the framebuffer, and of the images read from it, bounded.
+    // An error is reported once, with no rows.
+    using StillImageRowsCallback = std::function<void (std::exception_ptr, std::size_t top, PremultipliedImage&& rows)>;
+    void renderStillTiled(std::array<uint16_t, 2> size, StillImageRowsCallback);
+
     // Main render function.
     void render();
 
@@ -152,6 +173,10 @@ public:
     void updateAnnotation(AnnotationID, const Annotation&);
     void removeAnnotation(AnnotationID);
 
+    // Adds or removes many annotations at once, which is quicker than one at a time.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&);
+    void removeAnnotations(const AnnotationIDs&);
+
     // Sources
     style::Source* getSource(const std::string& sourceID);
     void addSource(std::unique_ptr<style::Source>);
@@ -178,8 +203,137 @@ public:
     std::vector<Feature> queryRenderedFeatures(const ScreenBox&,        const optional<std::vector<std::string>>& layerIDs = {});
     AnnotationIDs queryPointAnnotations(const ScreenBox&);
 
+    // Streaming feature queries: visit the same features, in the same order, decoding each only
+    // when the visitor converts it into a Feature, and stop once the visitor returns false or the
+    // limit is reached.
+    void queryRenderedFeatures(const ScreenCoordinate&, const RenderedQueryOptions&, const RenderedFeatureVisitor&);
+    void queryRenderedFeatures(const ScreenBox&,        const RenderedQueryOptions&, const RenderedFeatureVisitor&);
+    std::vector<RenderedFeatureID> queryRenderedFeatureIDs(const ScreenBox&, const RenderedQueryOptions& = {});
+
+    // The features of a layer of a source's loaded tiles that pass the filter, whether they're
+    // rendered or not, e.g. for aggregating their properties. The tiles are scanned in parallel,
+    // without their geometries being rendered or indexed. Features with an ID are returned once,
+    // even if they're split across tiles.
+    std::vector<Feature> querySourceFeatures(const std::string& sourceID,
+                                             const std::string& sourceLayer,
+                                             const style::Filter& = {});
+
+    // The topmost feature of a pickable fill layer at the point, as of the last frame, found by
+    // reading back a single pixel of the picking pass rather than searching the tiles; see
+    // FillLayer::setPickable(). Other layers don't hide the features of pickable layers.
+    optional<Feature> queryPickedFeature(const ScreenCoordinate&);
+
+    // Feature state: sets the color that fill layers with feature state colors draw a feature of
+    // the source in, by the feature's ID. The states live on the GPU, so that updating them, even
+    // for thousands of features per second, only repaints the map and never lays out its tiles
+    // again. Unsetting the color draws the feature in the layer's fill color again.
+    void setFeatureState(const std::string& sourceID, const FeatureIdentifier&, const optional<Color>&);
+    optional<Color> getFeatureState(const std::string& sourceID, const FeatureIdentifier&) const;
+
+    // Symbol placement: by default, each tile places its labels on its own. With cross-tile
+    // placement, all tiles of a source use one collision index, which removes duplicate labels at
+    // tile boundaries.
+    void setCrossTilePlacement(bool);
+    bool getCrossTilePlacement() const;
+
+    // Tile selection: by default, the viewport is covered with tiles of a single zoom level. With
+    // level of detail, tiles of a pitched map that are far from the camera are replaced by their
+    // parents, so that fewer tiles are loaded, laid out and rendered near the horizon.
+    void setTileLevelOfDetail(bool);
+    bool getTileLevelOfDetail() const;
+
+    // Tile selection: by default, tiles are loaded once the camera gets to them. With predictive
+    // prefetch, easeTo() and flyTo() also load the tiles of the zoom levels they pass through and
+    // of where they land, and panning loads the tiles ahead of it at its current velocity. They're
+    // loaded at a lower priority than the tiles that are needed now.
+    void setPredictiveTilePrefetch(bool);
+    bool getPredictiveTilePrefetch() const;
+
+    // Tile selection: by default, tiles that aren't loaded yet are replaced by their parents or
+    // children only if those are loaded already. With parent prefetch, the parents two and four
+    // zoom levels up are always loaded too, right after the tiles on screen, so that there's a
+    // coarse fallback for every tile.
+    void setParentTilePrefetch(bool);
+    bool getParentTilePrefetch() const;
+
+    // Rendering: how long uploading new tiles to the GPU may take per frame. Tiles that don't fit
+    // are uploaded in later frames, closest to the center first; their parent or child tiles are
+    // rendered in their place meanwhile.
+    void setFrameUploadBudget(Duration);
+    Duration getFrameUploadBudget() const;
+
+    // Rendering: with adaptive quality, frames of fast camera motion, e.g. of a fling, are
+    // rendered at a lower resolution, with fewer uploads and without placing the symbols again,
+    // once rendering them takes longer than the display allows. Full quality returns as soon as
+    // the camera stops.
+    void setAdaptiveQuality(bool);
+    bool getAdaptiveQuality() const;
+
+    // Rendering: with frame stats, how long each phase of rendering a frame and each layer drawn
+    // in it take is measured, on the CPU and, with timer queries where the driver has them, on
+    // the GPU. That costs a few clock reads and a query per layer and phase. Off by default.
+    void setFrameStatsEnabled(bool);
+    bool getFrameStatsEnabled() const;
+    // The stats of a recent frame: the latest one whose GPU times are in, usually one or two
+    // frames before the last one. Empty if no frame was measured.
+    FrameStats getFrameStats() const;
+
+    // Rendering: with tile tracing, when each tile is requested, answered, laid out, placed,
+    // uploaded and first rendered is recorded, for all maps of the process. Off by default.
+    static void setTileTracingEnabled(bool);
+    static bool getTileTracingEnabled();
+    // Returns the events recorded since the last call in the Chrome trace event format, as read by
+    // chrome://tracing, and discards them.
+    static std::string takeTileTrace();
+
+    // Startup tracing: records, process-wide, how long opening the cache database, loading the
+    // style, the TileJSON of its sources, its sprite and its glyphs, and compiling the shader
+    // programs took until the first complete frame, and which of them it waited for. Enabling it
+    // discards what was recorded before, so it's meant to be enabled before the file source and
+    // the map are created.
+    static void setStartupTracingEnabled(bool);
+    static bool getStartupTracingEnabled();
+    // Returns the spans recorded, and the critical path to the first complete frame, as a table.
+    static std::string getStartupReport();
+
+    // Rendering: where compiled shader programs are cached across launches, e.g. the path of the
+    // DefaultFileSource cache database. Each program is stored in a file named by appending its
+    // name to this path; binaries of another driver version are ignored. Must be set before the
+    // first frame is rendered. Empty, the default, compiles the programs on every launch.
+    void setProgramCachePath(const std::string&);
+
+    // Loading: where the glyph ranges that labels needed are recorded across launches, e.g. the
+    // path of the DefaultFileSource cache database, in a file named by appending ".glyphs" to it.
+    // They're requested as soon as a style that uses their font stacks is loaded. Takes effect
+    // with the next style. Empty, the default, only requests basic Latin up front.
+    void setGlyphHistoryPath(const std::string&);
+
+    // Loading: draws the glyph ranges it covers, e.g. CJK ideographs, with local fonts instead of
+    // downloading them. Takes effect with the next style. None by default.
+    void setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer>);
+
     // Memory
     void setSourceTileCacheSize(size_t);
+    // The most memory, in bytes, that each source's cached tiles may hold, in addition to the
+    // limit on their number. Unlimited by default.
+    void setSourceTileCacheBytes(size_t);
+    // The memory, in bytes, held by the tiles of all sources, loaded or cached, including their
+    // buffers and textures on the GPU.
+    size_t getTileMemoryUsage() const;
+    // Where the memory of the map goes: the tiles of each source by what holds their memory, the
+    // atlases, the annotations and the file source's caches. Asks the file source, which may
+    // wait for its thread.
+    MemoryReport getMemoryReport() const;
+    // The most memory, in bytes, that the tiles of all sources together may hold. When they hold
+    // more, the cached tiles are evicted first, oldest first; then the fallback and prefetched
+    // tiles that aren't rendered, farthest from the center first; then the buckets of layers that
+    // aren't rendered at the current zoom level. Unlimited by default.
+    void setTileMemoryBudget(size_t);
+    size_t getTileMemoryBudget() const;
+    // How much tile memory, in bytes, onLowMemory() evicts down to, in the same order. Zero, the
+    // default, evicts everything that isn't rendered.
+    void setLowMemoryTileTarget(size_t);
+    size_t getLowMemoryTileTarget() const;
     void onLowMemory();
 
     // Debug
@@ -190,6 +344,10 @@ public:
     bool isFullyLoaded() const;
     void dumpDebugLogs() const;
 
+    // The statistics of the actors of all maps of the process, by actor type, ordered by it; see
+    // ActorStats. Can be called from any thread, e.g. by monitoring that polls them.
+    static std::vector<ActorStats> getActorStats();
+
 private:
     class Impl;
     const std::unique_ptr<Impl> impl;
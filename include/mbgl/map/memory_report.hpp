@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+// Where the memory of a map goes, in bytes, on the heap and in the GPU's buffers and textures; see
+// Map::getMemoryReport(). The numbers are those of the containers and buffers that hold the data,
+// not of every allocation, so they're estimates that leave out allocator overhead and small
+// objects.
+class MemoryReport {
+public:
+    struct Usage {
+        std::size_t cpu = 0;
+        std::size_t gpu = 0;
+
+        std::size_t total() const {
+            return cpu + gpu;
+        }
+
+        Usage& operator+=(const Usage& other) {
+            cpu += other.cpu;
+            gpu += other.gpu;
+            return *this;
+        }
+
+        Usage& operator-=(const Usage& other) {
+            cpu -= other.cpu;
+            gpu -= other.gpu;
+            return *this;
+        }
+    };
+
+    // The memory held by a number of tiles, by what holds it.
+    struct Tiles {
+        std::size_t count = 0;
+
+        Usage data;           // The tiles' data, as received and as decoded.
+        Usage featureIndex;   // The indexes of their features for queries, without collision tiles.
+        Usage buckets;        // The vertex and index arrays of the buckets, their buffers and textures.
+        Usage collisionTiles; // The collision boxes of the placed symbols.
+
+        Usage total() const {
+            Usage result = data;
+            result += featureIndex;
+            result += buckets;
+            result += collisionTiles;
+            return result;
+        }
+    };
+
+    struct Source {
+        std::string sourceID;
+        Tiles tiles;  // The tiles the source holds, whether they're rendered or not.
+        Tiles cached; // The tiles in the source's cache.
+        Usage index;  // The source's own index of its features, e.g. of a GeoJSON source.
+
+        Usage total() const {
+            Usage result = tiles.total();
+            result += cached.total();
+            result += index;
+            return result;
+        }
+    };
+
+    std::vector<Source> sources;
+
+    Usage glyphAtlas;  // The glyphs that were loaded, and their atlas texture.
+    Usage spriteAtlas; // The sprite images of the style and their atlas texture.
+    Usage lineAtlas;   // The line dash patterns.
+
+    // The shapes and points of the annotations, and the atlas of their icons. The tiles of the
+    // annotations are included with those of their source in `sources`.
+    Usage annotations;
+
+    // What the file source keeps in memory, e.g. the recently loaded tiles and the page cache of
+    // the database of a DefaultFileSource. Shared with any other map using the same file source.
+    Usage fileSource;
+
+    Usage total() const {
+        Usage result;
+        for (const auto& source : sources) {
+            result += source.total();
+        }
+        result += glyphAtlas;
+        result += spriteAtlas;
+        result += lineAtlas;
+        result += annotations;
+        result += fileSource;
+        return result;
+    }
+};
+
+} // namespace mbgl
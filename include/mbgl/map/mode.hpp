@@ -44,6 +44,8 @@ enum class MapDebugOptions : EnumType {
     Timestamps  = 1 << 3,
     Collision   = 1 << 4,
     Overdraw    = 1 << 5,
+    // Groups the opaque render items by shader and tile instead of drawing them front-to-back.
+    SortOpaquePass = 1 << 8,
 // FIXME: https://github.com/mapbox/mapbox-gl-native/issues/5117
 #if not MBGL_USE_GLES2
     StencilClip = 1 << 6,
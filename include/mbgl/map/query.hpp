@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A feature that a query of the rendered features found, in one of the layers that render it.
+    Its geometry and properties are decoded only once it's converted into a Feature, so that
+    queries that only need to tell which features are there don't pay for them. It's valid for
+    the duration of the call of the visitor it's passed to.
+*/
+class RenderedFeature {
+public:
+    virtual ~RenderedFeature() = default;
+
+    virtual const std::string& getLayerID() const = 0;
+    virtual optional<FeatureIdentifier> getID() const = 0;
+    virtual Feature toFeature() const = 0;
+};
+
+// Returns false to stop the query.
+using RenderedFeatureVisitor = std::function<bool (const RenderedFeature&)>;
+
+class RenderedQueryOptions {
+public:
+    // The layers to query, or all of them.
+    optional<std::vector<std::string>> layerIDs;
+
+    // The most features to visit, after which the query stops.
+    optional<std::size_t> limit;
+};
+
+class RenderedFeatureID {
+public:
+    std::string layerID;
+    optional<FeatureIdentifier> id;
+};
+
+} // namespace mbgl
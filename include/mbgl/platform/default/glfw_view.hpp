@@ -11,6 +11,10 @@
 #define GL_GLEXT_PROTOTYPES
 #include <GLFW/glfw3.h>
 
+namespace mbgl {
+class SessionRecorder;
+} // namespace mbgl
+
 class GLFWView : public mbgl::View {
 public:
     GLFWView(bool fullscreen = false, bool benchmark = false);
@@ -40,6 +44,9 @@ public:
 
     void setWindowTitle(const std::string&);
 
+    // Records the frames rendered and the annotations added from now on, until it's unset.
+    void setRecorder(mbgl::SessionRecorder*);
+
     void run();
     void report(float duration);
     
@@ -62,6 +69,9 @@ private:
     void clearAnnotations();
     void popAnnotation();
 
+    void addAnnotationIcon(const std::string&, std::shared_ptr<const mbgl::SpriteImage>);
+    void addAnnotation(const mbgl::Annotation&);
+
     mbgl::AnnotationIDs annotationIDs;
     std::vector<std::string> spriteIDs;
 
@@ -91,6 +101,8 @@ private:
 
     std::function<void()> changeStyleCallback;
 
+    mbgl::SessionRecorder* recorder = nullptr;
+
     mbgl::util::RunLoop runLoop;
     mbgl::util::Timer frameTick;
 
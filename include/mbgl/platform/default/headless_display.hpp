@@ -13,6 +13,15 @@ public:
     CGLPixelFormatObj pixelFormat = nullptr;
 #endif
 
+#if MBGL_USE_EGL
+    // A display of the first GPU that EGL_EXT_device_enumeration reports, or the default
+    // display. Contexts are made current without a surface where EGL_KHR_surfaceless_context
+    // is supported, and with a small pbuffer otherwise.
+    void *eglDisplay = nullptr;
+    void *eglConfig = nullptr;
+    bool surfaceless = false;
+#endif
+
 #if MBGL_USE_GLX
     Display *xDisplay = nullptr;
     GLXFBConfig *fbConfigs = nullptr;
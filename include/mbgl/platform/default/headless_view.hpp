@@ -10,6 +10,8 @@ class QGLWidget;
 #else
 #define MBGL_USE_CGL 1
 #endif
+#elif MBGL_USE_EGL
+#define GL_GLEXT_PROTOTYPES
 #else
 #define GL_GLEXT_PROTOTYPES
 #define MBGL_USE_GLX 1
@@ -25,8 +27,10 @@ typedef XID GLXPbuffer;
 #include <mbgl/gl/types.hpp>
 #include <mbgl/gl/extension.hpp>
 
+#include <deque>
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
@@ -49,6 +53,16 @@ public:
 
     PremultipliedImage readStillImage(std::array<uint16_t, 2> size = {{ 0, 0 }}) override;
 
+    // Asynchronous variant of readStillImage(): startStillImageRead() queues a copy of the current
+    // framebuffer into a pixel buffer object and returns without waiting for it, so that the next
+    // frame can be rendered while the pixels are transferred. finishStillImageRead() returns the
+    // oldest queued image, waiting for its transfer if needed. Where pixel buffer objects or fences
+    // aren't supported, the pixels are read synchronously when the read is started.
+    void startStillImageRead(std::array<uint16_t, 2> size = {{ 0, 0 }});
+    PremultipliedImage finishStillImageRead();
+    bool isStillImageReadFinished();
+    std::size_t pendingStillImageReads() const { return stillImageReads.size(); }
+
     void resize(uint16_t width, uint16_t height);
     void setMapChangeCallback(std::function<void(MapChange)>&& cb) { mapChangeCallback = std::move(cb); }
 
@@ -62,6 +76,17 @@ private:
     void activateContext();
     void deactivateContext();
 
+    struct StillImageRead {
+        std::array<uint16_t, 2> size;
+        gl::BufferID buffer = 0;
+        void* fence = nullptr;
+        PremultipliedImage image;
+    };
+
+    std::array<uint16_t, 2> stillImageSize(std::array<uint16_t, 2>) const;
+    PremultipliedImage finishStillImageRead(StillImageRead&);
+    void clearStillImageReads();
+
     std::shared_ptr<HeadlessDisplay> display;
     const float pixelRatio;
     std::array<uint16_t, 2> dimensions;
@@ -82,6 +107,12 @@ private:
     void *glContext = nullptr;
 #endif
 
+#if MBGL_USE_EGL
+    void *eglDisplay = nullptr;
+    void *glContext = nullptr;
+    void *eglSurface = nullptr;
+#endif
+
 #if MBGL_USE_GLX
     Display *xDisplay = nullptr;
     GLXFBConfig *fbConfigs = nullptr;
@@ -94,6 +125,9 @@ private:
     gl::FramebufferID fbo = 0;
     gl::RenderbufferID fboDepthStencil = 0;
     gl::RenderbufferID fboColor = 0;
+
+    std::deque<StillImageRead> stillImageReads;
+    std::vector<gl::BufferID> readbackBuffers;
 };
 
 } // namespace mbgl
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/map/camera.hpp>
+#include <mbgl/map/mode.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <array>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class Map;
+class SpriteImage;
+
+/*
+    Records an interactive session with a map into a text file, one event per line, each starting
+    with the microseconds since the session began:
+
+        <time> frame <width> <height> <latitude> <longitude> <zoom> <angle> <pitch>
+        <time> style <url>
+        <time> classes <transition ms | -> <count> <class>...
+        <time> debug <options>
+        <time> icon <name> <width> <height> <pixel ratio>
+        <time> symbol <id> <icon> <geometry>
+        <time> line <id> <opacity> <width> <color> <geometry>
+        <time> fill <id> <opacity> <color> <outline color | -> <geometry>
+        <time> layer <id> <layer> <geometry>
+        <time> remove <id>
+
+    The camera is that of each frame rendered, rather than the gestures and animations that
+    moved it, so that a replay renders the same frames; names and URLs can't contain whitespace.
+*/
+class SessionRecorder : private util::noncopyable {
+public:
+    SessionRecorder(const std::string& path);
+
+    // Records the frame the map just rendered at the given size, with the camera that animations
+    // moved it to, after what changed about its style, classes or debug options since the previous
+    // one.
+    void frame(const Map&, std::array<uint16_t, 2> size);
+
+    void addAnnotationIcon(const std::string&, const SpriteImage&);
+    void addAnnotation(AnnotationID, const Annotation&);
+    void removeAnnotation(AnnotationID);
+
+private:
+    std::ostream& event(const char* name);
+
+    std::ofstream file;
+    const TimePoint start;
+
+    std::string styleURL;
+    optional<std::vector<std::string>> classes;
+    MapDebugOptions debug = MapDebugOptions::NoDebug;
+};
+
+// A session recorded by SessionRecorder, as the frames to replay it with.
+class Session {
+public:
+    struct Frame {
+        Duration time;
+        std::array<uint16_t, 2> size;
+        CameraOptions camera;
+
+        // The style URL set since the previous frame, if any, which is set before the changes.
+        optional<std::string> styleURL;
+
+        // The other changes made since the previous frame, in the order they were made in.
+        // Annotations are identified by the IDs the replaying map gives them. Icons have the size
+        // of the recorded ones, with a solid color in place of their contents.
+        std::vector<std::function<void (Map&)>> changes;
+    };
+
+    // Throws std::runtime_error if the file can't be read or one of its lines can't be parsed.
+    Session(const std::string& path);
+
+    std::vector<Frame> frames;
+};
+
+} // namespace mbgl
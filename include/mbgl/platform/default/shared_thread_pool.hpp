@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/mailbox.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A `SharedThreadPool` runs the actors of many clients -- typically one per `Map` -- on a single
+    set of threads, so that a process hosting many maps doesn't need a pool per map.
+
+    Each client gets its own `Share`, which is the `Scheduler` passed to the client. When shares
+    compete for threads, they get pool time in proportion to their weights: the pool tracks how
+    much time each share has used, scaled by its weight, and picks the share that has used the
+    least. A share that was idle doesn't accumulate credit, so it can't starve the others once it
+    becomes busy. A share can additionally be capped to a maximum number of threads it may occupy
+    at once.
+
+    Mailbox priorities apply across all shares: more urgent work of any share runs before less
+    urgent work, and fairness decides between shares with work of the same priority.
+*/
+
+class SharedThreadPool {
+private:
+    struct State;
+
+public:
+    SharedThreadPool(std::size_t count);
+    ~SharedThreadPool();
+
+    class Share : public Scheduler {
+    public:
+        ~Share() override;
+
+        void schedule(std::weak_ptr<Mailbox>) override;
+
+    private:
+        friend class SharedThreadPool;
+        Share(SharedThreadPool&, std::shared_ptr<State>);
+
+        SharedThreadPool& pool;
+        const std::shared_ptr<State> state;
+    };
+
+    // `weight` is the share's relative claim on the pool. `maxConcurrency` limits how many
+    // threads may run the share's actors at the same time; 0 means no limit. The share must not
+    // outlive the pool.
+    std::unique_ptr<Share> createShare(double weight = 1.0, std::size_t maxConcurrency = 0);
+
+private:
+    struct State {
+        State(double weight, std::size_t maxConcurrency);
+
+        const double weight;
+        const std::size_t maxConcurrency;
+
+        std::size_t running = 0;
+        std::size_t queued = 0;
+
+        // Pool time used so far, in seconds, divided by the weight.
+        double usage = 0;
+
+        // One FIFO queue per Mailbox::Priority.
+        std::array<std::queue<std::weak_ptr<Mailbox>>, Mailbox::PriorityCount> queues;
+    };
+
+    void schedule(State&, std::weak_ptr<Mailbox>);
+    void remove(const std::shared_ptr<State>&);
+    std::shared_ptr<State> pop(std::weak_ptr<Mailbox>&);
+
+    std::vector<std::shared_ptr<State>> states;
+
+    // Usage of the share that was picked most recently. Shares that start competing again begin
+    // no lower than this.
+    double usageFloor = 0;
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool terminate { false };
+};
+
+} // namespace mbgl
@@ -1,24 +1,59 @@
 #pragma once
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/mailbox.hpp>
 
+#include <array>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <vector>
 
 namespace mbgl {
 
+namespace util {
+template <class> class ThreadLocal;
+} // namespace util
+
+enum class ThreadAffinity : bool {
+    None, // Threads may run on any CPU.
+    NUMA, // Threads are spread over the NUMA nodes and pinned to their node's CPUs.
+};
+
+/*
+    With `ThreadAffinity::NUMA`, every node has its own queues, and a mailbox sticks to the node
+    it was first scheduled on (that of the scheduling thread, if it's a pool thread; otherwise
+    nodes are assigned round-robin). Threads prefer work queued on their own node, so that data
+    produced by an actor stays in memory local to the node, but will take work from other nodes
+    rather than go idle.
+*/
+
 class ThreadPool : public Scheduler {
 public:
-    ThreadPool(std::size_t count);
+    ThreadPool(std::size_t count, ThreadAffinity = ThreadAffinity::None);
     ~ThreadPool() override;
 
     void schedule(std::weak_ptr<Mailbox>) override;
 
 private:
+    struct Node {
+        std::size_t index;
+        std::vector<std::size_t> cpus;
+        // One FIFO queue per Mailbox::Priority; more urgent queues are drained first.
+        std::array<std::queue<std::weak_ptr<Mailbox>>, Mailbox::PriorityCount> queues;
+    };
+
+    bool empty() const;
+    std::weak_ptr<Mailbox> pop(std::size_t node);
+    std::size_t nodeFor(const std::weak_ptr<Mailbox>&);
+
+    std::vector<Node> nodes;
+    std::unique_ptr<util::ThreadLocal<Node>> current;
+    std::size_t nextNode = 0;
+
     std::vector<std::thread> threads;
-    std::queue<std::weak_ptr<Mailbox>> queue;
     std::mutex mutex;
     std::condition_variable cv;
     bool terminate { false };
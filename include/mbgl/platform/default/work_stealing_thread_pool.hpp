@@ -0,0 +1,84 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/mailbox.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mbgl {
+
+namespace util {
+template <class> class ThreadLocal;
+} // namespace util
+
+/*
+    A `WorkStealingThreadPool` is a drop-in replacement for `ThreadPool` that avoids funneling
+    every worker through a single lock:
+
+    * Mailboxes scheduled from outside the pool go into a lock-free, bounded injection queue
+      shared by all workers. If that queue is full, an overflow queue takes the excess.
+    * Mailboxes scheduled from a worker thread (e.g. when `Mailbox::receive()` reschedules
+      itself because more messages are queued) go into that worker's own deque.
+    * A worker that runs out of local work takes from the injection queue, and then steals from
+      the back of other workers' deques.
+
+    Each queue exists once per `Mailbox::Priority`. Workers look for the most urgent work first:
+    local, shared and stolen work of a given priority all come before less urgent work.
+
+    Per-mailbox ordering is preserved because a `Mailbox` is only ever scheduled once at a time:
+    it schedules itself when its first message arrives, and reschedules itself after processing a
+    message only if its queue is still non-empty.
+*/
+
+class WorkStealingThreadPool : public Scheduler {
+public:
+    WorkStealingThreadPool(std::size_t count);
+    ~WorkStealingThreadPool() override;
+
+    void schedule(std::weak_ptr<Mailbox>) override;
+
+private:
+    class InjectionQueue;
+
+    template <class T>
+    using PerPriority = std::array<T, Mailbox::PriorityCount>;
+
+    class Worker {
+    public:
+        std::mutex mutex;
+        PerPriority<std::deque<std::weak_ptr<Mailbox>>> queues;
+        std::thread thread;
+    };
+
+    void run(std::size_t index);
+    bool pop(std::size_t index, std::size_t tick, std::weak_ptr<Mailbox>&);
+    bool popLocal(Worker&, std::size_t priority, std::weak_ptr<Mailbox>&);
+    bool popGlobal(std::size_t priority, std::weak_ptr<Mailbox>&);
+    bool steal(std::size_t index, std::size_t priority, std::weak_ptr<Mailbox>&);
+    bool hasPending() const;
+
+    PerPriority<std::unique_ptr<InjectionQueue>> injection;
+    std::unique_ptr<util::ThreadLocal<Worker>> current;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex overflowMutex;
+    PerPriority<std::deque<std::weak_ptr<Mailbox>>> overflow;
+    PerPriority<std::atomic<std::size_t>> overflowed;
+
+    // Number of mailboxes currently queued anywhere in the pool, per priority.
+    PerPriority<std::atomic<std::size_t>> pending;
+
+    std::mutex sleepMutex;
+    std::condition_variable cv;
+    std::atomic<std::size_t> sleeping { 0 };
+    std::atomic<bool> terminate { false };
+};
+
+} // namespace mbgl
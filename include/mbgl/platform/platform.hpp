@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace platform {
@@ -23,6 +25,14 @@ void setCurrentThreadName(const std::string& name);
 // Makes the current thread low priority.
 void makeThreadLowPriority();
 
+// Returns the CPUs of each NUMA node. Platforms without topology information report a single
+// node containing all CPUs.
+std::vector<std::vector<std::size_t>> getNUMANodes();
+
+// Restricts the current thread to run on the given CPUs. Returns false if this isn't
+// supported or failed.
+bool setCurrentThreadAffinity(const std::vector<std::size_t>& cpus);
+
 // Shows an alpha image with the specified dimensions in a named window.
 void showDebugImage(std::string name, const char *data, size_t width, size_t height);
 
@@ -36,7 +36,30 @@ public:
     void setAccessToken(const std::string&);
     std::string getAccessToken() const;
 
+    // See HTTPFileSource::setMaximumConnectionsPerHost().
+    void setMaximumConnectionsPerHost(uint32_t);
+
+    /*
+     * Tiles that were loaded recently are also kept in memory, in front of the database,
+     * up to this many bytes. All maps that share the file source share them.
+     */
+    void setMaximumMemoryCacheSize(uint64_t);
+
+    /*
+     * Replaces the file source that resources missing from the cache are requested from, by
+     * default an OnlineFileSource, e.g. with a stub for tests and benchmarks. Must be called
+     * before the first request. From then on, it's used and destroyed on the file source's thread.
+     */
+    void setOnlineFileSource(std::unique_ptr<FileSource>);
+
+    /*
+     * The memory held by the tiles kept in memory and by the page cache of the database. Waits
+     * for the file source's thread to answer.
+     */
+    std::size_t getMemoryUsage() const override;
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void setPriority(AsyncRequest&, Resource::Priority) override;
 
     /*
      * Retrieve all regions in the offline database.
@@ -81,6 +104,13 @@ public:
      */
     void setOfflineRegionDownloadState(OfflineRegion&, OfflineRegionDownloadState);
 
+    /*
+     * Whether downloading the region also revalidates its expired resources, once the missing
+     * ones are downloaded. They're requested a few at a time, behind the requests of maps, the
+     * most recently used of them first.
+     */
+    void setOfflineRegionRefreshExpiredResources(OfflineRegion&, bool);
+
     /*
      * Retrieve the current status of the region. The query will be executed
      * asynchronously and the results passed to the given callback, which will be
@@ -107,12 +137,35 @@ public:
      */
     void deleteOfflineRegion(OfflineRegion&&, std::function<void (std::exception_ptr)>);
 
+    /*
+     * Write the resources and tiles of the region, as they're stored, into a read-only pack
+     * at the path, which other file sources can serve the region from with addOfflinePack().
+     * The callback is executed on the database thread once the pack is written, or with the
+     * error that stopped it.
+     */
+    void exportOfflineRegion(OfflineRegion&, const std::string& path, std::function<void (std::exception_ptr)>);
+
+    /*
+     * Serve the resources in the pack at the path, which exportOfflineRegion() wrote, before
+     * looking them up in the cache. The pack is memory-mapped and never written to; expired
+     * resources are still revalidated, but the newer responses only go to the cache. Packs are
+     * searched in the order they were added in.
+     */
+    void addOfflinePack(const std::string& path, std::function<void (std::exception_ptr)>);
+
     /*
      * Changing or bypassing this limit without permission from Mapbox is prohibited
      * by the Mapbox Terms of Service.
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * The number of resources that each offline region download requests at a time. They
+     * wait in the file source's queue behind the ones in flight, so that the network doesn't
+     * wait for the responses to be stored.
+     */
+    void setMaximumConcurrentOfflineRequests(uint32_t);
+
     // For testing only.
     void put(const Resource&, const Response&);
 
@@ -122,6 +175,7 @@ private:
     const std::unique_ptr<util::Thread<Impl>> thread;
     const std::unique_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    const std::unique_ptr<FileSource> tileArchiveFileSource;
 };
 
 } // namespace mbgl
@@ -6,6 +6,7 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/async_request.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 
@@ -24,6 +25,11 @@ public:
     // not be executed.
     virtual std::unique_ptr<AsyncRequest> request(const Resource&, Callback) = 0;
 
+    // Changes the priority of a request that this file source returned, e.g. for a tile that came
+    // into view or went out of it. File sources that queue their requests move it in the queue;
+    // others ignore it.
+    virtual void setPriority(AsyncRequest&, Resource::Priority) {}
+
     // When a file source supports optional requests, it must return true.
     // Optional requests are requests that aren't as urgent, but could be useful, e.g.
     // to cover part of the map while loading. The FileSource should only do cheap actions to
@@ -31,6 +37,12 @@ public:
     virtual bool supportsOptionalRequests() const {
         return false;
     }
+
+    // The memory the file source holds, in bytes, e.g. in caches of responses. Used for
+    // Map::getMemoryReport(); file sources that don't keep anything in memory return 0.
+    virtual std::size_t getMemoryUsage() const {
+        return 0;
+    }
 };
 
 } // namespace mbgl
@@ -16,7 +16,11 @@ public:
     void setAccessToken(const std::string& t) { accessToken = t; }
     std::string getAccessToken() const { return accessToken; }
 
+    // See HTTPFileSource::setMaximumConnectionsPerHost().
+    void setMaximumConnectionsPerHost(uint32_t);
+
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void setPriority(AsyncRequest&, Resource::Priority) override;
 
 private:
     friend class OnlineFileRequest;
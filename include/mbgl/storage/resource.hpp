@@ -34,6 +34,15 @@ public:
         Required = true,
     };
 
+    // File sources that queue their requests start them in this order. Resources other than
+    // tiles go ahead of all tiles.
+    enum Priority : uint8_t {
+        Regular = 0, // e.g. tiles on screen
+        Fallback,    // shown while the regular ones load, e.g. parent tiles
+        Low,         // e.g. prefetched tiles
+        Background,  // e.g. offline downloads
+    };
+
     Resource(Kind kind_, std::string url_, optional<TileData> tileData_ = {}, Necessity necessity_ = Required)
         : kind(kind_),
           necessity(necessity_),
@@ -58,6 +67,7 @@ public:
 
     Kind kind;
     Necessity necessity;
+    Priority priority = Regular;
     std::string url;
 
     // Includes auxiliary data if this is a tile request.
@@ -28,6 +28,7 @@ public:
     bool notModified = false;
 
     // The actual data of the response. Present only for non-error, non-notModified responses.
+    // It's immutable, so the cache, the file sources and the tiles share it rather than copy it.
     std::shared_ptr<const std::string> data;
 
     optional<Timestamp> modified;
@@ -127,7 +127,8 @@ private:
             values.push_back(*filterValue);
         }
 
-        return FilterType { *key, std::move(values) };
+        auto valueSet = std::make_shared<const FilterValueSet>(values);
+        return FilterType { *key, std::move(values), std::move(valueSet) };
     }
 
     template <class FilterType, class V>
@@ -64,6 +64,77 @@ struct Converter<Function<T>> {
     }
 };
 
+template <class T>
+struct Converter<PropertyFunction<T>> {
+    template <class V>
+    Result<PropertyFunction<T>> operator()(const V& value) const {
+        if (!isObject(value)) {
+            return Error { "function must be an object" };
+        }
+
+        auto propertyValue = objectMember(value, "property");
+        if (!propertyValue) {
+            return Error { "property function must specify a property" };
+        }
+
+        optional<std::string> property = toString(*propertyValue);
+        if (!property) {
+            return Error { "property function property must be a string" };
+        }
+
+        auto typeValue = objectMember(value, "type");
+        if (!typeValue || toString(*typeValue) != std::string("categorical")) {
+            return Error { "property function type must be categorical" };
+        }
+
+        auto stopsValue = objectMember(value, "stops");
+        if (!stopsValue) {
+            return Error { "function value must specify stops" };
+        }
+
+        if (!isArray(*stopsValue)) {
+            return Error { "function stops must be an array" };
+        }
+
+        typename PropertyFunction<T>::Stops stops;
+        for (std::size_t i = 0; i < arrayLength(*stopsValue); ++i) {
+            const auto& stopValue = arrayMember(*stopsValue, i);
+
+            if (!isArray(stopValue)) {
+                return Error { "function stop must be an array" };
+            }
+
+            if (arrayLength(stopValue) != 2) {
+                return Error { "function stop must have two elements" };
+            }
+
+            optional<Value> domainValue = toValue(arrayMember(stopValue, 0));
+            if (!domainValue) {
+                return Error { "property function stop domain value must be a boolean, number, or string" };
+            }
+
+            Result<T> v = convert<T>(arrayMember(stopValue, 1));
+            if (!v) {
+                return v.error();
+            }
+
+            stops.emplace_back(*domainValue, *v);
+        }
+
+        auto defaultValue = objectMember(value, "default");
+        if (!defaultValue) {
+            return PropertyFunction<T>(*property, stops);
+        }
+
+        Result<T> v = convert<T>(*defaultValue);
+        if (!v) {
+            return v.error();
+        }
+
+        return PropertyFunction<T>(*property, stops, *v);
+    }
+};
+
 } // namespace conversion
 } // namespace style
 } // namespace mbgl
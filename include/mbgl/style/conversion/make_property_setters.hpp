@@ -76,7 +76,7 @@ auto makePaintPropertySetters() {
 
     result["fill-antialias"] = makePropertySetter<V>(&FillLayer::setFillAntialias);
     result["fill-opacity"] = makePropertySetter<V>(&FillLayer::setFillOpacity);
-    result["fill-color"] = makePropertySetter<V>(&FillLayer::setFillColor);
+    result["fill-color"] = makeDataDrivenPropertySetter<V>(&FillLayer::setFillColor);
     result["fill-outline-color"] = makePropertySetter<V>(&FillLayer::setFillOutlineColor);
     result["fill-translate"] = makePropertySetter<V>(&FillLayer::setFillTranslate);
     result["fill-translate-anchor"] = makePropertySetter<V>(&FillLayer::setFillTranslateAnchor);
@@ -109,7 +109,7 @@ auto makePaintPropertySetters() {
     result["text-translate-anchor"] = makePropertySetter<V>(&SymbolLayer::setTextTranslateAnchor);
 
     result["circle-radius"] = makePropertySetter<V>(&CircleLayer::setCircleRadius);
-    result["circle-color"] = makePropertySetter<V>(&CircleLayer::setCircleColor);
+    result["circle-color"] = makeDataDrivenPropertySetter<V>(&CircleLayer::setCircleColor);
     result["circle-blur"] = makePropertySetter<V>(&CircleLayer::setCircleBlur);
     result["circle-opacity"] = makePropertySetter<V>(&CircleLayer::setCircleOpacity);
     result["circle-translate"] = makePropertySetter<V>(&CircleLayer::setCircleTranslate);
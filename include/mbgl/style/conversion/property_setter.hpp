@@ -18,9 +18,11 @@ using LayoutPropertySetter = std::function<optional<Error> (Layer&, const V&)>;
 template <class V>
 using PaintPropertySetter = std::function<optional<Error> (Layer&, const V&, const optional<std::string>&)>;
 
+namespace detail {
+
 template <class V, class L, class T, class...Args>
-auto makePropertySetter(void (L::*setter)(PropertyValue<T>, const Args&...args)) {
-    return [setter] (Layer& layer, const V& value, const Args&...args) -> optional<Error> {
+auto makePropertySetter(void (L::*setter)(PropertyValue<T>, const Args&...args), bool dataDriven) {
+    return [setter, dataDriven] (Layer& layer, const V& value, const Args&...args) -> optional<Error> {
         L* typedLayer = layer.as<L>();
         if (!typedLayer) {
             return Error { "layer doesn't support this property" };
@@ -31,11 +33,28 @@ auto makePropertySetter(void (L::*setter)(PropertyValue<T>, const Args&...args))
             return typedValue.error();
         }
 
+        if (!dataDriven && (*typedValue).isPropertyFunction()) {
+            return Error { "property doesn't support property functions" };
+        }
+
         (typedLayer->*setter)(*typedValue, args...);
         return {};
     };
 }
 
+} // namespace detail
+
+template <class V, class L, class T, class...Args>
+auto makePropertySetter(void (L::*setter)(PropertyValue<T>, const Args&...args)) {
+    return detail::makePropertySetter<V>(setter, false);
+}
+
+// For the properties whose property functions the renderer supports.
+template <class V, class L, class T, class...Args>
+auto makeDataDrivenPropertySetter(void (L::*setter)(PropertyValue<T>, const Args&...args)) {
+    return detail::makePropertySetter<V>(setter, true);
+}
+
 template <class V>
 optional<Error> setVisibility(Layer& layer, const V& value) {
     if (isUndefined(value)) {
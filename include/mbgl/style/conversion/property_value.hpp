@@ -15,6 +15,12 @@ struct Converter<PropertyValue<T>> {
     Result<PropertyValue<T>> operator()(const V& value) const {
         if (isUndefined(value)) {
             return {};
+        } else if (isObject(value) && objectMember(value, "property")) {
+            Result<PropertyFunction<T>> function = convert<PropertyFunction<T>>(value);
+            if (!function) {
+                return function.error();
+            }
+            return *function;
         } else if (isObject(value)) {
             Result<Function<T>> function = convert<Function<T>>(value);
             if (!function) {
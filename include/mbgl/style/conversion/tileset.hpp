@@ -3,6 +3,9 @@
 #include <mbgl/util/tileset.hpp>
 #include <mbgl/style/conversion.hpp>
 
+#include <cmath>
+#include <limits>
+
 namespace mbgl {
 namespace style {
 namespace conversion {
@@ -39,6 +42,41 @@ public:
             }
         }
 
+        auto encodingValue = objectMember(value, "encoding");
+        if (encodingValue) {
+            optional<std::string> encoding = toString(*encodingValue);
+            if (encoding && *encoding == "mapbox") {
+                result.encoding = Tileset::DEMEncoding::Mapbox;
+            } else if (encoding && *encoding == "terrarium") {
+                result.encoding = Tileset::DEMEncoding::Terrarium;
+            } else {
+                return Error { "source encoding must be \"mapbox\" or \"terrarium\"" };
+            }
+        }
+
+        auto metatilesValue = objectMember(value, "metatiles");
+        if (metatilesValue) {
+            if (!isArray(*metatilesValue)) {
+                return Error { "source metatiles must be an array" };
+            }
+            for (std::size_t i = 0; i < arrayLength(*metatilesValue); i++) {
+                optional<std::string> urlTemplate = toString(arrayMember(*metatilesValue, i));
+                if (!urlTemplate) {
+                    return Error { "source metatiles member must be a string" };
+                }
+                result.metatiles.push_back(std::move(*urlTemplate));
+            }
+        }
+
+        auto metatileSizeValue = objectMember(value, "metatileSize");
+        if (metatileSizeValue) {
+            optional<float> metatileSize = toNumber(*metatileSizeValue);
+            if (!metatileSize || *metatileSize < 1 || *metatileSize > 16 || *metatileSize != std::floor(*metatileSize)) {
+                return Error { "invalid metatileSize" };
+            }
+            result.metatileSize = *metatileSize;
+        }
+
         auto minzoomValue = objectMember(value, "minzoom");
         if (minzoomValue) {
             optional<float> minzoom = toNumber(*minzoomValue);
@@ -4,6 +4,7 @@
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/geometry.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -50,16 +51,46 @@ public:
     Value value;
 };
 
+/*
+   The values of an `in` or `!in` filter, sorted by type so that they're looked up with binary
+   searches rather than compared one by one. Numbers are compared as doubles, which is exact
+   unless some of them have a magnitude of 2^53 or more, or aren't numbers; then `isExact()` is
+   false, and the values need to be compared one by one after all.
+*/
+class FilterValueSet {
+public:
+    explicit FilterValueSet(const std::vector<Value>&);
+
+    bool isExact() const { return exact; }
+
+    // Whether the set has a value equal to the given one. Requires `isExact()`.
+    bool contains(const Value&) const;
+
+private:
+    std::vector<std::string> strings;
+    std::vector<double> numbers;
+    bool hasTrue = false;
+    bool hasFalse = false;
+    bool exact = true;
+};
+
 class InFilter {
 public:
     std::string key;
     std::vector<Value> values;
+
+    // The lookup structure for `values`, built when parsing the filter. Filters that are built
+    // otherwise, or whose values are changed afterwards, leave it empty.
+    std::shared_ptr<const FilterValueSet> valueSet;
 };
 
 class NotInFilter {
 public:
     std::string key;
     std::vector<Value> values;
+
+    // See InFilter::valueSet.
+    std::shared_ptr<const FilterValueSet> valueSet;
 };
 
 class AnyFilter {
@@ -113,5 +144,56 @@ public:
     bool operator()(FeatureType type, optional<FeatureIdentifier> id, PropertyAccessor accessor) const;
 };
 
+// Filters are equal if they're structurally identical.
+inline bool operator==(const Filter&, const Filter&);
+
+inline bool operator==(const NullFilter&, const NullFilter&) {
+    return true;
+}
+
+#define MBGL_DEFINE_FILTER_EQUALITY(Type, member) \
+    inline bool operator==(const Type& lhs, const Type& rhs) { \
+        return lhs.key == rhs.key && lhs.member == rhs.member; \
+    }
+
+MBGL_DEFINE_FILTER_EQUALITY(EqualsFilter, value)
+MBGL_DEFINE_FILTER_EQUALITY(NotEqualsFilter, value)
+MBGL_DEFINE_FILTER_EQUALITY(LessThanFilter, value)
+MBGL_DEFINE_FILTER_EQUALITY(LessThanEqualsFilter, value)
+MBGL_DEFINE_FILTER_EQUALITY(GreaterThanFilter, value)
+MBGL_DEFINE_FILTER_EQUALITY(GreaterThanEqualsFilter, value)
+MBGL_DEFINE_FILTER_EQUALITY(InFilter, values)
+MBGL_DEFINE_FILTER_EQUALITY(NotInFilter, values)
+
+#undef MBGL_DEFINE_FILTER_EQUALITY
+
+inline bool operator==(const HasFilter& lhs, const HasFilter& rhs) {
+    return lhs.key == rhs.key;
+}
+
+inline bool operator==(const NotHasFilter& lhs, const NotHasFilter& rhs) {
+    return lhs.key == rhs.key;
+}
+
+inline bool operator==(const AnyFilter& lhs, const AnyFilter& rhs) {
+    return lhs.filters == rhs.filters;
+}
+
+inline bool operator==(const AllFilter& lhs, const AllFilter& rhs) {
+    return lhs.filters == rhs.filters;
+}
+
+inline bool operator==(const NoneFilter& lhs, const NoneFilter& rhs) {
+    return lhs.filters == rhs.filters;
+}
+
+inline bool operator==(const Filter& lhs, const Filter& rhs) {
+    return static_cast<const FilterBase&>(lhs) == static_cast<const FilterBase&>(rhs);
+}
+
+inline bool operator!=(const Filter& lhs, const Filter& rhs) {
+    return !(lhs == rhs);
+}
+
 } // namespace style
 } // namespace mbgl
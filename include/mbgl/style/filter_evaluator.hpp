@@ -62,26 +62,12 @@ public:
 
     bool operator()(const InFilter& filter) const {
         optional<Value> actual = getValue(filter.key);
-        if (!actual)
-            return false;
-        for (const auto& v: filter.values) {
-            if (equal(*actual, v)) {
-                return true;
-            }
-        }
-        return false;
+        return actual && contains(filter, *actual);
     }
 
     bool operator()(const NotInFilter& filter) const {
         optional<Value> actual = getValue(filter.key);
-        if (!actual)
-            return true;
-        for (const auto& v: filter.values) {
-            if (equal(*actual, v)) {
-                return false;
-            }
-        }
-        return true;
+        return !actual || !contains(filter, *actual);
     }
 
     bool operator()(const AnyFilter& filter) const {
@@ -189,6 +175,19 @@ private:
     bool equal(const Value& lhs, const Value& rhs) const {
         return compare(lhs, rhs, [] (const auto& lhs_, const auto& rhs_) { return lhs_ == rhs_; });
     }
+
+    template <class SetFilter>
+    bool contains(const SetFilter& filter, const Value& actual) const {
+        if (filter.valueSet && filter.valueSet->isExact()) {
+            return filter.valueSet->contains(actual);
+        }
+        for (const auto& v: filter.values) {
+            if (equal(actual, v)) {
+                return true;
+            }
+        }
+        return false;
+    }
 };
 
 inline bool Filter::operator()(const Feature& feature) const {
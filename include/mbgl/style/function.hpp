@@ -1,5 +1,9 @@
 #pragma once
 
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
 #include <vector>
 #include <utility>
 
@@ -35,5 +39,72 @@ bool operator!=(const Function<T>& lhs, const Function<T>& rhs) {
     return !(lhs == rhs);
 }
 
+// A function of a feature's property rather than of the zoom level, i.e. a data-driven value, of
+// the "categorical" type: features whose property equals the domain value of a stop take the
+// stop's value, and all others the default value. Numbers are equal regardless of their type,
+// as in filters. Only some paint properties support these; see makeDataDrivenPropertySetter().
+template <typename T>
+class PropertyFunction {
+public:
+    using Stop = std::pair<Value, T>;
+    using Stops = std::vector<Stop>;
+
+    explicit PropertyFunction(std::string property_, Stops stops_, optional<T> defaultValue_ = {})
+        : property(std::move(property_)), stops(std::move(stops_)), defaultValue(std::move(defaultValue_)) {}
+
+    const std::string& getProperty() const { return property; }
+    const Stops& getStops() const { return stops; }
+    const optional<T>& getDefaultValue() const { return defaultValue; }
+
+    // The value for a feature with the given value of the property.
+    optional<T> evaluate(const optional<Value>& value) const {
+        if (value) {
+            for (const auto& stop : stops) {
+                if (equal(*value, stop.first)) {
+                    return stop.second;
+                }
+            }
+        }
+        return defaultValue;
+    }
+
+private:
+    static optional<double> number(const Value& value) {
+        if (value.is<uint64_t>()) {
+            return double(value.get<uint64_t>());
+        } else if (value.is<int64_t>()) {
+            return double(value.get<int64_t>());
+        } else if (value.is<double>()) {
+            return value.get<double>();
+        }
+        return {};
+    }
+
+    static bool equal(const Value& lhs, const Value& rhs) {
+        if (lhs == rhs) {
+            return true;
+        }
+        const optional<double> lhsNumber = number(lhs);
+        const optional<double> rhsNumber = number(rhs);
+        return lhsNumber && rhsNumber && *lhsNumber == *rhsNumber;
+    }
+
+    std::string property;
+    Stops stops;
+    optional<T> defaultValue;
+
+    template <class S> friend bool operator==(const PropertyFunction<S>&, const PropertyFunction<S>&);
+};
+
+template <class T>
+bool operator==(const PropertyFunction<T>& lhs, const PropertyFunction<T>& rhs) {
+    return lhs.property == rhs.property && lhs.stops == rhs.stops && lhs.defaultValue == rhs.defaultValue;
+}
+
+template <class T>
+bool operator!=(const PropertyFunction<T>& lhs, const PropertyFunction<T>& rhs) {
+    return !(lhs == rhs);
+}
+
 } // namespace style
 } // namespace mbgl
@@ -15,6 +15,7 @@ class SymbolLayer;
 class RasterLayer;
 class BackgroundLayer;
 class CustomLayer;
+class DynamicPointLayer;
 
 /**
  * The runtime representation of a [layer](https://www.mapbox.com/mapbox-gl-style-spec/#layers) from the Mapbox Style
@@ -42,6 +43,7 @@ protected:
         Raster,
         Background,
         Custom,
+        DynamicPoint,
     };
 
     class Impl;
@@ -72,6 +74,7 @@ public:
     //
     //     struct Visitor {
     //         void operator()(CustomLayer&) { ... }
+    //         void operator()(DynamicPointLayer&) { ... }
     //         void operator()(RasterLayer&) { ... }
     //         void operator()(BackgroundLayer&) { ... }
     //         template <class VectorLayer>
@@ -95,6 +98,8 @@ public:
             return visitor(*as<BackgroundLayer>());
         case Type::Custom:
             return visitor(*as<CustomLayer>());
+        case Type::DynamicPoint:
+            return visitor(*as<DynamicPointLayer>());
         }
     }
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mbgl/style/layer.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/geo.hpp>
+
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/**
+ * A layer of circles at points that may move in every frame, e.g. to track vehicles. Unlike
+ * annotations or a GeoJSON source, the points aren't laid out into tiles: they're kept in a vertex
+ * buffer of their own, and moving a point only uploads that point again the next time the map is
+ * rendered. The circles aren't placed with the symbols, and don't avoid each other.
+ *
+ * The layer's properties aren't style properties: they have no classes, transitions or functions.
+ */
+class DynamicPointLayer : public Layer {
+public:
+    DynamicPointLayer(const std::string& layerID);
+    ~DynamicPointLayer() final;
+
+    // Replaces all points. A point is identified by its index in the vector from then on.
+    void setPoints(const std::vector<LatLng>&);
+    std::size_t getPointCount() const;
+
+    // Moves one of the points. Throws std::out_of_range for an index past the last point.
+    void setPoint(std::size_t index, const LatLng&);
+    LatLng getPoint(std::size_t index) const;
+
+    // In pixels.
+    void setCircleRadius(float);
+    float getCircleRadius() const;
+
+    void setCircleColor(Color);
+    Color getCircleColor() const;
+
+    void setCircleOpacity(float);
+    float getCircleOpacity() const;
+
+    // Private implementation
+
+    class Impl;
+    Impl* const impl;
+
+    DynamicPointLayer(const Impl&);
+    DynamicPointLayer(const DynamicPointLayer&) = delete;
+};
+
+template <>
+inline bool Layer::is<DynamicPointLayer>() const {
+    return type == Type::DynamicPoint;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -8,6 +8,10 @@
 
 #include <mbgl/util/color.hpp>
 
+#include <mbgl/util/feature.hpp>
+
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
@@ -24,6 +28,39 @@ public:
     void setFilter(const Filter&);
     const Filter& getFilter() const;
 
+    // Feature categories
+
+    // Assigns each feature to a category at layout time: category i holds the features whose
+    // value of the property equals the i-th of the values. Up to 32 values are used, and features
+    // with other values are in none. Changing these lays the layer out again; an empty property
+    // turns categories off. Layers with a data-driven fill color ignore them.
+    void setFeatureCategories(const std::string& property, const std::vector<Value>& values);
+    const std::string& getFeatureCategoryProperty() const;
+    const std::vector<Value>& getFeatureCategoryValues() const;
+
+    // Bit i of these stands for category i. Features of hidden categories aren't drawn, and those
+    // of highlighted ones are drawn in the highlight color instead of the fill color. Changing
+    // them doesn't touch the tiles; features in no category are always drawn as they are.
+    void setVisibleFeatureCategories(uint32_t);
+    uint32_t getVisibleFeatureCategories() const;
+    void setHighlightedFeatureCategories(uint32_t);
+    uint32_t getHighlightedFeatureCategories() const;
+    void setFeatureHighlightColor(const Color&);
+    Color getFeatureHighlightColor() const;
+
+    // Feature state colors: draws the features that have a state color, set with
+    // Map::setFeatureState() for the layer's source, in that color instead of the fill color.
+    // Turning them on or off lays the layer out again; changing the states only repaints it.
+    // Layers with a data-driven fill color or with feature categories ignore them.
+    void setFeatureStateColors(bool);
+    bool getFeatureStateColors() const;
+
+    // Picking: draws the layer's features into the map's picking framebuffer as well, for
+    // Map::queryPickedFeature() to tell which of them is at a point without querying the tiles.
+    // Turning it on or off lays the layer out again.
+    void setPickable(bool);
+    bool getPickable() const;
+
     // Paint properties
 
     static PropertyValue<bool> getDefaultFillAntialias();
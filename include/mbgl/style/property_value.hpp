@@ -14,7 +14,7 @@ inline bool operator!=(const Undefined&, const Undefined&) { return false; }
 template <class T>
 class PropertyValue {
 private:
-    using Value = variant<Undefined, T, Function<T>>;
+    using Value = variant<Undefined, T, Function<T>, PropertyFunction<T>>;
     Value value;
 
     template <class S> friend bool operator==(const PropertyValue<S>&, const PropertyValue<S>&);
@@ -23,13 +23,16 @@ public:
     PropertyValue()                     : value()         {}
     PropertyValue(         T  constant) : value(constant) {}
     PropertyValue(Function<T> function) : value(function) {}
+    PropertyValue(PropertyFunction<T> function) : value(function) {}
 
     bool isUndefined() const { return value.which() == 0; }
     bool isConstant()  const { return value.which() == 1; }
     bool isFunction()  const { return value.which() == 2; }
+    bool isPropertyFunction() const { return value.which() == 3; }
 
     const          T & asConstant() const { return value.template get<         T >(); }
     const Function<T>& asFunction() const { return value.template get<Function<T>>(); }
+    const PropertyFunction<T>& asPropertyFunction() const { return value.template get<PropertyFunction<T>>(); }
 
     explicit operator bool() const { return !isUndefined(); };
 
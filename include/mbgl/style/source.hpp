@@ -53,6 +53,14 @@ public:
 
     optional<std::string> getAttribution() const;
 
+    // While enabled, the painter renders the fill, line, circle and raster layers of each tile of
+    // this source into a texture of its own, and draws those textures instead of the layers for
+    // as long as the zoom level, the bearing and the style stay the same, e.g. while panning.
+    // Only applies to consecutive layers of this source, and only while the map isn't pitched.
+    // Costs a texture of the tile's size on screen per tile; disabled by default.
+    void setTileTextureCaching(bool);
+    bool getTileTextureCaching() const;
+
     // Private implementation
     class Impl;
     const std::unique_ptr<Impl> baseImpl;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/style/source.hpp>
+#include <mbgl/util/feature.hpp>
 #include <mbgl/util/geojson.hpp>
 #include <mbgl/util/optional.hpp>
 
@@ -19,9 +20,12 @@ class Supercluster;
 } // namespace mapbox
 
 namespace mbgl {
+
+class Scheduler;
+
 namespace style {
 
-using GeoJSONVTPointer = std::unique_ptr<mapbox::geojsonvt::GeoJSONVT>;
+using GeoJSONVTPointer = std::shared_ptr<mapbox::geojsonvt::GeoJSONVT>;
 using SuperclusterPointer = std::unique_ptr<mapbox::supercluster::Supercluster>;
 
 struct GeoJSONOptions {
@@ -30,6 +34,13 @@ struct GeoJSONOptions {
     uint16_t buffer = 128;
     double tolerance = 0.375;
 
+    // When non-zero, the tiles of unclustered sources are only kept up to `lazyZoom`. Deeper
+    // tiles are sliced on demand from the features of their ancestor at that zoom, and those
+    // slices are kept, most recently used first, up to this many bytes. This bounds the memory
+    // held for tiles that are viewed once, or never, when `maxzoom` is high.
+    std::size_t lazyMemoryLimit = 0;
+    uint8_t lazyZoom = 5;
+
     // Supercluster options
     bool cluster = false;
     uint16_t clusterRadius = 50;
@@ -43,8 +54,26 @@ public:
     void setURL(const std::string& url);
     void setGeoJSON(const GeoJSON&);
 
+    // Like the above, but the data is parsed and indexed on the scheduler, and the tiles keep
+    // showing the previous data until the new index is ready. Data set or changed later
+    // supersedes data still being indexed. The scheduler must outlive the source.
+    void setURL(const std::string& url, Scheduler&);
+    void setGeoJSON(const GeoJSON&, Scheduler&);
+
+    // Adds the features, replacing those that have the same ids; features without an id can't
+    // be updated or removed afterwards. Unlike setGeoJSON(), this only reloads the tiles that the
+    // changed features touch, and for unclustered sources, only slices those features again,
+    // along with the others indexed with them. Clustered sources with a scheduler are clustered
+    // again on it, once for all of the changes made in a row, and keep showing the previous
+    // clusters until then.
+    void updateFeatures(const FeatureCollection&);
+    void removeFeatures(const std::vector<FeatureIdentifier>&);
+
     optional<std::string> getURL();
 
+    // An estimate of the memory held by the features and the index, in bytes.
+    std::size_t getIndexMemoryUsage() const;
+
     // Private implementation
 
     class Impl;
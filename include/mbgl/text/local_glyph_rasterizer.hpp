@@ -0,0 +1,37 @@
+#pragma once
+
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// A glyph drawn by a LocalGlyphRasterizer at a font size of 24 pixels: its coverage, one byte per
+// pixel from 0 (outside) to 255 (inside), row by row, and its metrics in pixels.
+struct RasterizedGlyph {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    int32_t left = 0;
+    int32_t top = 0;
+    uint32_t advance = 0;
+    std::vector<uint8_t> coverage;
+};
+
+// Draws glyphs with the fonts of the device or of the app, so that the ranges it covers, e.g. CJK
+// ideographs, don't need to be downloaded. The glyph atlas turns the glyphs into signed distance
+// fields itself. Both methods are called from worker threads, possibly concurrently.
+class LocalGlyphRasterizer {
+public:
+    virtual ~LocalGlyphRasterizer() = default;
+
+    // Whether the glyphs from `first` to `last` are drawn locally rather than downloaded for the
+    // font stack. The answer for a font stack and range must not change.
+    virtual bool canRasterize(const FontStack&, uint32_t first, uint32_t last) const = 0;
+
+    // Draws the glyph, or returns an empty optional if the fonts lack it.
+    virtual optional<RasterizedGlyph> rasterize(const FontStack&, uint32_t glyphID) = 0;
+};
+
+} // namespace mbgl
@@ -1,12 +1,28 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 namespace util {
         
 std::string compress(const std::string& raw);
 std::string decompress(const std::string& raw);
+std::string decompress(const char* raw, std::size_t size);
+
+// Decompresses zlib or gzip data into `result`, replacing its contents but reusing its buffer,
+// for callers that decompress many buffers in a row.
+void decompress(const char* raw, std::size_t size, std::string& result);
+
+// Like the above, with a preset dictionary: data that's likely to occur in the raw data. Data
+// that was compressed with a dictionary can only be decompressed with the same one.
+std::string compressWithDictionary(const std::string& raw, const std::string& dictionary);
+std::string decompressWithDictionary(const char* raw, std::size_t size, const std::string& dictionary);
+
+// Builds a dictionary for data like the samples, e.g. tiles of the same source, out of the
+// parts they have in common with each other.
+std::string trainDictionary(const std::vector<std::string>& samples);
     
 } // namespace util
 } // namespace mbgl
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+/*
+    Process-wide counters and timers of the hot paths, cheap enough to leave on in production.
+    Each one counts how often something happened and, for timers, how long it took in total; the
+    set of them is fixed at compile time, by `Counter`.
+
+    Instrumentation is off by default, and costs one relaxed atomic load per call site while it
+    is. Once on, every thread adds to counters of its own without locking or read-modify-write
+    instructions; `snapshot()` sums those of all threads, and of the threads that have exited.
+
+    Counters are cumulative and never reset; pollers compute rates from successive snapshots.
+*/
+class Instrumentation {
+public:
+    enum class Counter : uint8_t {
+        Layout,           // Laying out the buckets of a tile.
+        Placement,        // Placing the symbols of a tile.
+        FilterEvaluation, // The features a layer's filter is evaluated on; a count, without times.
+        Decompression,    // Inflating compressed data, e.g. of a vector tile.
+        SQLiteStatement,  // Stepping an SQLite statement, e.g. of the cache database.
+        HTTPRequest,      // An HTTP request, from starting it until its response is in.
+        HTTPBytes,        // The bytes received in responses to HTTP requests; a count, without times.
+    };
+
+    static constexpr std::size_t CounterCount = 7;
+
+    static const char* name(Counter);
+
+    struct Value {
+        Counter counter;
+        const char* name;
+        uint64_t count = 0;
+        Duration time = Duration::zero();
+    };
+
+    static void setEnabled(bool);
+
+    static bool isEnabled() {
+        return enabled().load(std::memory_order_relaxed);
+    }
+
+    static void add(Counter counter, uint64_t count = 1) {
+        if (isEnabled()) {
+            accumulate(counter, count, Duration::zero());
+        }
+    }
+
+    static void add(Counter counter, uint64_t count, Duration time) {
+        if (isEnabled()) {
+            accumulate(counter, count, time);
+        }
+    }
+
+    // Adds the time from its construction to its destruction to a counter, if instrumentation was
+    // enabled when it was constructed.
+    class Timer : private noncopyable {
+    public:
+        Timer(Counter counter_)
+            : counter(counter_),
+              active(isEnabled()),
+              begin(active ? Clock::now() : TimePoint()) {
+        }
+
+        ~Timer() {
+            if (active) {
+                accumulate(counter, 1, Clock::now() - begin);
+            }
+        }
+
+    private:
+        const Counter counter;
+        const bool active;
+        const TimePoint begin;
+    };
+
+    // Returns the values of all counters, in the order of `Counter`. Can be called from any thread.
+    static std::vector<Value> snapshot();
+
+private:
+    static std::atomic<bool>& enabled();
+    static void accumulate(Counter, uint64_t count, Duration);
+};
+
+} // namespace util
+} // namespace mbgl
@@ -10,8 +10,8 @@
 #include <atomic>
 #include <functional>
 #include <utility>
-#include <queue>
 #include <mutex>
+#include <vector>
 
 namespace mbgl {
 namespace util {
@@ -77,14 +77,26 @@ public:
 private:
     MBGL_STORE_THREAD(tid)
 
-    using Queue = std::queue<std::shared_ptr<WorkTask>>;
+    // Either a task, or a mailbox to receive from. Mailboxes are queued directly rather than
+    // wrapped in a task, so that scheduling one doesn't allocate.
+    struct Entry {
+        std::shared_ptr<WorkTask> task;
+        std::weak_ptr<Mailbox> mailbox;
+    };
+
+    using Queue = std::vector<Entry>;
 
-    void push(std::shared_ptr<WorkTask>);
+    // Wakes up the loop so that it calls process(). Implemented per platform.
+    void wake();
+
+    void push(std::shared_ptr<WorkTask> task) {
+        withMutex([&] { queue.push_back({ std::move(task), {} }); });
+        wake();
+    }
 
     void schedule(std::weak_ptr<Mailbox> mailbox) override {
-        invoke([mailbox] () {
-            Mailbox::maybeReceive(mailbox);
-        });
+        withMutex([&] { queue.push_back({ nullptr, std::move(mailbox) }); });
+        wake();
     }
 
     void withMutex(std::function<void()>&& fn) {
@@ -93,16 +105,27 @@ private:
     }
 
     void process() {
+        // Swap in the buffer of the previous call to reuse its capacity. If process() is entered
+        // recursively, the inner call starts with an empty buffer instead.
         Queue queue_;
+        queue_.swap(spare);
         withMutex([&] { queue_.swap(queue); });
 
-        while (!queue_.empty()) {
-            (*(queue_.front()))();
-            queue_.pop();
+        for (auto& entry : queue_) {
+            if (entry.task) {
+                (*entry.task)();
+                entry.task.reset();
+            } else {
+                Mailbox::maybeReceive(std::move(entry.mailbox));
+            }
         }
+
+        queue_.clear();
+        spare.swap(queue_);
     }
 
     Queue queue;
+    Queue spare;
     std::mutex mutex;
 
     std::unique_ptr<Impl> impl;
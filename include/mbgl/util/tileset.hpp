@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/util/range.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <vector>
 #include <string>
@@ -12,11 +13,24 @@ class Tileset {
 public:
     enum class Scheme : bool { XYZ, TMS };
 
+    // How the elevations of DEM raster tiles are encoded in their RGB channels.
+    enum class DEMEncoding : bool { Mapbox, Terrarium };
+
     std::vector<std::string> tiles;
     Range<uint8_t> zoomRange { 0, 22 };
     std::string attribution;
     Scheme scheme = Scheme::XYZ;
 
+    // Set for raster sources whose tiles are elevation models, which are rendered hillshaded
+    // rather than shown as they are.
+    optional<DEMEncoding> encoding = {};
+
+    // When set, tiles are requested in metatiles of `metatileSize` × `metatileSize` tiles of the
+    // same zoom level, packed into one response, and split after they're loaded. The {x} and {y}
+    // of a metatile are those of its tiles divided by `metatileSize`, in the tileset's scheme.
+    std::vector<std::string> metatiles = {};
+    uint8_t metatileSize = 2;
+
     // TileJSON also includes center, zoom, and bounds, but they are not used by mbgl.
 };
 
@@ -1,7 +1,6 @@
 package com.mapbox.mapboxsdk.annotations;
 
 import android.content.Context;
-import android.graphics.PointF;
 import android.graphics.RectF;
 import android.os.SystemClock;
 import android.support.annotation.NonNull;
@@ -13,6 +12,7 @@ import android.widget.ImageView;
 
 import com.mapbox.mapboxsdk.R;
 import com.mapbox.mapboxsdk.constants.MapboxConstants;
+import com.mapbox.mapboxsdk.geometry.LatLng;
 import com.mapbox.mapboxsdk.maps.MapView;
 import com.mapbox.mapboxsdk.maps.MapboxMap;
 import com.mapbox.mapboxsdk.utils.AnimatorUtils;
@@ -124,10 +124,22 @@ public class MarkerViewManager {
      * </p>
      */
     public void update() {
-        for (final MarkerView marker : markerViewMap.keySet()) {
+        // Projects every marker with a single call into the map.
+        List<MarkerView> markers = new ArrayList<>(markerViewMap.keySet());
+        double[] points = new double[markers.size() * 2];
+        for (int i = 0; i < markers.size(); i++) {
+            LatLng position = markers.get(i).getPosition();
+            points[i * 2] = position.getLatitude();
+            points[i * 2 + 1] = position.getLongitude();
+        }
+        points = mapboxMap.getProjection().toScreenLocations(points);
+
+        for (int i = 0; i < markers.size(); i++) {
+            final MarkerView marker = markers.get(i);
             final View convertView = markerViewMap.get(marker);
             if (convertView != null) {
-                PointF point = mapboxMap.getProjection().toScreenLocation(marker.getPosition());
+                float pointX = (float) points[i * 2];
+                float pointY = (float) points[i * 2 + 1];
                 if (marker.getOffsetX() == MapboxConstants.UNMEASURED) {
                     // ensure view is measured first
                     if (convertView.getWidth() == 0) {
@@ -140,8 +152,8 @@ public class MarkerViewManager {
                     }
                 }
 
-                convertView.setX(point.x - marker.getOffsetX());
-                convertView.setY(point.y - marker.getOffsetY());
+                convertView.setX(pointX - marker.getOffsetX());
+                convertView.setY(pointY - marker.getOffsetY());
 
                 // animate visibility
                 if (marker.isVisible() && convertView.getVisibility() == View.GONE) {
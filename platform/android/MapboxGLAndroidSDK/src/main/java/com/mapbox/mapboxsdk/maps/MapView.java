@@ -998,6 +998,16 @@ public class MapView extends FrameLayout {
         return nativeMapView.pixelForLatLng(location);
     }
 
+    /*
+     * Internal use only, use Projection#toScreenLocations instead.
+     */
+    double[] toNativeScreenLocations(@NonNull double[] latLngs) {
+        if (destroyed) {
+            return new double[latLngs.length];
+        }
+        return nativeMapView.pixelsForLatLngs(latLngs);
+    }
+
     //
     // Annotations
     //
@@ -1087,6 +1097,27 @@ public class MapView extends FrameLayout {
         nativeMapView.updateMarker(updatedMarker);
     }
 
+    void updateMarkers(@NonNull List<Marker> updatedMarkers) {
+        if (destroyed) {
+            return;
+        }
+
+        List<Marker> markers = new ArrayList<>(updatedMarkers.size());
+        for (Marker marker : updatedMarkers) {
+            if (marker == null || marker.getId() == -1) {
+                continue;
+            }
+            if (!(marker instanceof MarkerView)) {
+                ensureIconLoaded(marker);
+            }
+            markers.add(marker);
+        }
+
+        if (!markers.isEmpty()) {
+            nativeMapView.updateMarkers(markers);
+        }
+    }
+
 
     void updatePolygon(Polygon polygon) {
         if (destroyed) {
@@ -1323,6 +1354,28 @@ public class MapView extends FrameLayout {
         nativeMapView.jumpTo(bearing, center, pitch, zoom);
     }
 
+    void jumpTo(double bearing, LatLng center, double pitch, double zoom, int[] padding) {
+        if (destroyed) {
+            return;
+        }
+
+        contentPaddingLeft = padding[0];
+        contentPaddingTop = padding[1];
+        contentPaddingRight = padding[2];
+        contentPaddingBottom = padding[3];
+
+        int[] userLocationViewPadding = mapboxMap.getMyLocationViewSettings().getPadding();
+        double[] insets = {
+            (padding[1] + userLocationViewPadding[1]) / screenDensity,
+            (padding[0] + userLocationViewPadding[0]) / screenDensity,
+            (padding[3] + userLocationViewPadding[3]) / screenDensity,
+            (padding[2] + userLocationViewPadding[2]) / screenDensity
+        };
+
+        nativeMapView.cancelTransitions();
+        nativeMapView.jumpTo(bearing, center, pitch, zoom, insets);
+    }
+
     void easeTo(double bearing, LatLng center, long duration, double pitch, double zoom, boolean easingInterpolator, @Nullable final MapboxMap.CancelableCallback cancelableCallback) {
         if (destroyed) {
             return;
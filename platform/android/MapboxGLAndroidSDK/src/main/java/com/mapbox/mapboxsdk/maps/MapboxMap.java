@@ -930,6 +930,25 @@ public class MapboxMap {
         }
     }
 
+    /**
+     * <p>
+     * Updates many markers on this map at once, which is much cheaper than updating them one by one.
+     * </p>
+     *
+     * @param updatedMarkers Updated marker objects.
+     */
+    @UiThread
+    public void updateMarkers(@NonNull List<Marker> updatedMarkers) {
+        mapView.updateMarkers(updatedMarkers);
+
+        for (Marker updatedMarker : updatedMarkers) {
+            int index = annotations.indexOfKey(updatedMarker.getId());
+            if (index > -1) {
+                annotations.setValueAt(index, updatedMarker);
+            }
+        }
+    }
+
     /**
      * Update a polygon on this map.
      *
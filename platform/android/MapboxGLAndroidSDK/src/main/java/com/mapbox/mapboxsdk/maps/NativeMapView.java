@@ -389,6 +389,22 @@ final class NativeMapView {
         nativeUpdateMarker(nativeMapViewPtr, marker.getId(), position.getLatitude(), position.getLongitude(), icon.getId());
     }
 
+    public void updateMarkers(List<Marker> markers) {
+        int count = markers.size();
+        long[] ids = new long[count];
+        double[] latLngs = new double[count * 2];
+        String[] iconIds = new String[count];
+        for (int i = 0; i < count; i++) {
+            Marker marker = markers.get(i);
+            LatLng position = marker.getPosition();
+            ids[i] = marker.getId();
+            latLngs[i * 2] = position.getLatitude();
+            latLngs[i * 2 + 1] = position.getLongitude();
+            iconIds[i] = marker.getIcon().getId();
+        }
+        nativeUpdateMarkers(nativeMapViewPtr, ids, latLngs, iconIds);
+    }
+
     public void updatePolygon(Polygon polygon) {
         nativeUpdatePolygon(nativeMapViewPtr, polygon.getId(), polygon);
     }
@@ -462,6 +478,13 @@ final class NativeMapView {
         return nativeLatLngForPixel(nativeMapViewPtr, pixel.x, pixel.y);
     }
 
+    /**
+     * Projects latitude, longitude pairs into x, y pairs of the same array.
+     */
+    public double[] pixelsForLatLngs(double[] latLngs) {
+        return nativePixelsForLatLngs(nativeMapViewPtr, latLngs);
+    }
+
     public double getTopOffsetPixelsForAnnotationSymbol(String symbolName) {
         return nativeGetTopOffsetPixelsForAnnotationSymbol(nativeMapViewPtr, symbolName);
     }
@@ -470,6 +493,11 @@ final class NativeMapView {
         nativeJumpTo(nativeMapViewPtr, angle, center.getLatitude(), center.getLongitude(), pitch, zoom);
     }
 
+    public void jumpTo(double angle, LatLng center, double pitch, double zoom, double[] padding) {
+        nativeJumpToWithPadding(nativeMapViewPtr, angle, center.getLatitude(), center.getLongitude(), pitch, zoom,
+                padding[0], padding[1], padding[2], padding[3]);
+    }
+
     public void easeTo(double angle, LatLng center, long duration, double pitch, double zoom, boolean easingInterpolator) {
         nativeEaseTo(nativeMapViewPtr, angle, center.getLatitude(), center.getLongitude(), duration, pitch, zoom, easingInterpolator);
     }
@@ -686,6 +714,8 @@ final class NativeMapView {
 
     private native void nativeUpdateMarker(long nativeMapViewPtr, long markerId, double lat, double lon, String iconId);
 
+    private native void nativeUpdateMarkers(long nativeMapViewPtr, long[] markerIds, double[] latLngs, String[] iconIds);
+
     private native long[] nativeAddMarkers(long nativeMapViewPtr, Marker[] markers);
 
     private native long[] nativeAddPolylines(long nativeMapViewPtr, Polyline[] polylines);
@@ -724,10 +754,15 @@ final class NativeMapView {
 
     private native LatLng nativeLatLngForPixel(long nativeMapViewPtr, float x, float y);
 
+    private native double[] nativePixelsForLatLngs(long nativeMapViewPtr, double[] latLngs);
+
     private native double nativeGetTopOffsetPixelsForAnnotationSymbol(long nativeMapViewPtr, String symbolName);
 
     private native void nativeJumpTo(long nativeMapViewPtr, double angle, double latitude, double longitude, double pitch, double zoom);
 
+    private native void nativeJumpToWithPadding(long nativeMapViewPtr, double angle, double latitude, double longitude, double pitch, double zoom,
+                                                double top, double left, double bottom, double right);
+
     private native void nativeEaseTo(long nativeMapViewPtr, double angle, double latitude, double longitude, long duration, double pitch, double zoom, boolean easingInterpolator);
 
     private native void nativeFlyTo(long nativeMapViewPtr, double angle, double latitude, double longitude, long duration, double pitch, double zoom);
@@ -95,6 +95,21 @@ public class Projection {
         return pointF;
     }
 
+    /**
+     * Returns the screen locations that correspond to many geographical coordinates at once,
+     * without allocating a PointF for each of them.
+     *
+     * @param latLngs Latitude, longitude pairs of the coordinates.
+     * @return The x, y pairs of the screen locations in screen pixels.
+     */
+    public double[] toScreenLocations(double[] latLngs) {
+        double[] points = mapView.toNativeScreenLocations(latLngs);
+        for (int i = 0; i < points.length; i++) {
+            points[i] *= screenDensity;
+        }
+        return points;
+    }
+
     /**
      * Calculates a zoom level based on minimum scale and current scale from MapView
      *
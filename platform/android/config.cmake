@@ -26,6 +26,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/default_file_source.cpp
         PRIVATE platform/default/local_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
+        PRIVATE platform/default/tile_archive_file_source.cpp
 
         # Offline
         # PRIVATE include/mbgl/storage/offline.hpp
@@ -34,6 +35,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/storage/offline_database.hpp
         PRIVATE platform/default/mbgl/storage/offline_download.cpp
         PRIVATE platform/default/mbgl/storage/offline_download.hpp
+        PRIVATE platform/default/mbgl/storage/offline_pack.cpp
+        PRIVATE platform/default/mbgl/storage/offline_pack.hpp
         PRIVATE platform/default/sqlite3.cpp
         PRIVATE platform/default/sqlite3.hpp
 
@@ -51,6 +54,8 @@ macro(mbgl_platform_core)
 
         # Thread pool
         PRIVATE platform/default/thread_pool.cpp
+        PRIVATE platform/default/work_stealing_thread_pool.cpp
+        PRIVATE platform/default/shared_thread_pool.cpp
     )
 
     target_include_directories(mbgl-core
@@ -190,4 +190,8 @@ uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
 
+void HTTPFileSource::setMaximumConnectionsPerHost(uint32_t) {
+    // The connections are pooled by OkHttp, on the Java side.
+}
+
 } // namespace mbgl
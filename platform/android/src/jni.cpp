@@ -642,6 +642,38 @@ void nativeUpdateMarker(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr,
     nativeMapView->getMap().updateAnnotation(markerId, mbgl::SymbolAnnotation { mbgl::Point<double>(lon, lat), iconId });
 }
 
+// Updates many markers with a single JNI transition. Their positions are packed as latitude,
+// longitude pairs, so that no LatLng objects have to be read field by field.
+void nativeUpdateMarkers(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jni::jarray<jlong>* jids, jni::jarray<jdouble>* jlatLngs, jni::jarray<jni::jobject>* jiconIds) {
+    assert(nativeMapViewPtr != 0);
+    NativeMapView *nativeMapView = reinterpret_cast<NativeMapView *>(nativeMapViewPtr);
+
+    NullCheck(*env, jids);
+    NullCheck(*env, jlatLngs);
+    NullCheck(*env, jiconIds);
+    std::size_t len = jni::GetArrayLength(*env, *jids);
+    if (jni::GetArrayLength(*env, *jlatLngs) != len * 2 || jni::GetArrayLength(*env, *jiconIds) != len) {
+        mbgl::Log::Error(mbgl::Event::JNI, "nativeUpdateMarkers: mismatched array lengths");
+        return;
+    }
+
+    std::vector<jlong> ids(len);
+    std::vector<jdouble> latLngs(len * 2);
+    jni::GetArrayRegion(*env, *jids, 0, len, ids.data());
+    jni::GetArrayRegion(*env, *jlatLngs, 0, len * 2, latLngs.data());
+
+    for (std::size_t i = 0; i < len; i++) {
+        jni::jstring* jid = reinterpret_cast<jni::jstring*>(jni::GetObjectArrayElement(*env, *jiconIds, i));
+        if (ids[i] != -1) {
+            nativeMapView->getMap().updateAnnotation(ids[i], mbgl::SymbolAnnotation {
+                mbgl::Point<double>(latLngs[i * 2 + 1], latLngs[i * 2]),
+                std_string_from_jstring(env, jid)
+            });
+        }
+        jni::DeleteLocalRef(*env, jid);
+    }
+}
+
 jni::jarray<jlong>* nativeAddMarkers(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jni::jarray<jni::jobject>* jarray) {
     assert(nativeMapViewPtr != 0);
     NativeMapView *nativeMapView = reinterpret_cast<NativeMapView *>(nativeMapViewPtr);
@@ -988,6 +1020,28 @@ jni::jobject* nativePixelForLatLng(JNIEnv *env, jni::jobject* obj, jlong nativeM
     return &jni::NewObject(*env, *pointFClass, *pointFConstructorId, static_cast<jfloat>(pixel.x), static_cast<jfloat>(pixel.y));
 }
 
+// Projects latitude, longitude pairs into x, y pairs, so that views that follow many markers
+// are placed with one JNI transition and without allocating a PointF for each of them.
+jni::jarray<jdouble>* nativePixelsForLatLngs(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jni::jarray<jdouble>* jlatLngs) {
+    assert(nativeMapViewPtr != 0);
+    NativeMapView *nativeMapView = reinterpret_cast<NativeMapView *>(nativeMapViewPtr);
+
+    NullCheck(*env, jlatLngs);
+    std::size_t len = jni::GetArrayLength(*env, *jlatLngs);
+    std::vector<jdouble> values(len);
+    jni::GetArrayRegion(*env, *jlatLngs, 0, len, values.data());
+
+    for (std::size_t i = 0; i + 1 < len; i += 2) {
+        mbgl::ScreenCoordinate pixel = nativeMapView->getMap().pixelForLatLng(mbgl::LatLng(values[i], values[i + 1]));
+        values[i] = pixel.x;
+        values[i + 1] = pixel.y;
+    }
+
+    jni::jarray<jdouble>& jpixels = jni::NewArray<jdouble>(*env, len);
+    jni::SetArrayRegion(*env, jpixels, 0, values);
+    return &jpixels;
+}
+
 jni::jobject* nativeLatLngForPixel(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jfloat x, jfloat y) {
     assert(nativeMapViewPtr != 0);
     NativeMapView *nativeMapView = reinterpret_cast<NativeMapView *>(nativeMapViewPtr);
@@ -1021,6 +1075,16 @@ void nativeJumpTo(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jdoubl
     nativeMapView->getMap().jumpTo(options);
 }
 
+// Sets the content padding and jumps to a camera in one call, so that a camera update that
+// changes the padding too doesn't take two JNI transitions and two transforms.
+void nativeJumpToWithPadding(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jdouble angle, jdouble latitude, jdouble longitude, jdouble pitch, jdouble zoom,
+                             jdouble top, jdouble left, jdouble bottom, jdouble right) {
+    assert(nativeMapViewPtr != 0);
+    NativeMapView *nativeMapView = reinterpret_cast<NativeMapView *>(nativeMapViewPtr);
+    nativeMapView->setInsets({top, left, bottom, right});
+    nativeJumpTo(env, obj, nativeMapViewPtr, angle, latitude, longitude, pitch, zoom);
+}
+
 void nativeEaseTo(JNIEnv *env, jni::jobject* obj, jlong nativeMapViewPtr, jdouble angle, jdouble latitude, jdouble longitude, jlong duration, jdouble pitch, jdouble zoom, jboolean easing) {
     assert(nativeMapViewPtr != 0);
     NativeMapView *nativeMapView = reinterpret_cast<NativeMapView *>(nativeMapViewPtr);
@@ -1808,6 +1872,7 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *reserved) {
         MAKE_NATIVE_METHOD(nativeAddPolylines, "(J[Lcom/mapbox/mapboxsdk/annotations/Polyline;)[J"),
         MAKE_NATIVE_METHOD(nativeAddPolygons, "(J[Lcom/mapbox/mapboxsdk/annotations/Polygon;)[J"),
         MAKE_NATIVE_METHOD(nativeUpdateMarker, "(JJDDLjava/lang/String;)V"),
+        MAKE_NATIVE_METHOD(nativeUpdateMarkers, "(J[J[D[Ljava/lang/String;)V"),
         MAKE_NATIVE_METHOD(nativeUpdatePolygon, "(JJLcom/mapbox/mapboxsdk/annotations/Polygon;)V"),
         MAKE_NATIVE_METHOD(nativeUpdatePolyline, "(JJLcom/mapbox/mapboxsdk/annotations/Polyline;)V"),
         MAKE_NATIVE_METHOD(nativeRemoveAnnotations, "(J[J)V"),
@@ -1825,8 +1890,10 @@ extern "C" JNIEXPORT jint JNI_OnLoad(JavaVM *vm, void *reserved) {
         MAKE_NATIVE_METHOD(nativeLatLngForProjectedMeters, "(JDD)Lcom/mapbox/mapboxsdk/geometry/LatLng;"),
         MAKE_NATIVE_METHOD(nativePixelForLatLng, "(JDD)Landroid/graphics/PointF;"),
         MAKE_NATIVE_METHOD(nativeLatLngForPixel, "(JFF)Lcom/mapbox/mapboxsdk/geometry/LatLng;"),
+        MAKE_NATIVE_METHOD(nativePixelsForLatLngs, "(J[D)[D"),
         MAKE_NATIVE_METHOD(nativeGetTopOffsetPixelsForAnnotationSymbol, "(JLjava/lang/String;)D"),
         MAKE_NATIVE_METHOD(nativeJumpTo, "(JDDDDD)V"),
+        MAKE_NATIVE_METHOD(nativeJumpToWithPadding, "(JDDDDDDDDD)V"),
         MAKE_NATIVE_METHOD(nativeEaseTo, "(JDDDJDDZ)V"),
         MAKE_NATIVE_METHOD(nativeFlyTo, "(JDDDJDD)V"),
         MAKE_NATIVE_METHOD(nativeGetLayer, "(JLjava/lang/String;)Lcom/mapbox/mapboxsdk/style/layers/Layer;"),
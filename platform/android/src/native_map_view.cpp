@@ -83,6 +83,8 @@ NativeMapView::NativeMapView(JNIEnv *env_, jobject obj_, float pixelRatio_, int
         mbgl::android::apkPath);
 
     map = std::make_unique<mbgl::Map>(*this, *fileSource, threadPool, MapMode::Continuous);
+    map->setProgramCachePath(mbgl::android::cachePath + "/mbgl-offline.db");
+    map->setGlyphHistoryPath(mbgl::android::cachePath + "/mbgl-offline.db");
 
     float zoomFactor   = map->getMaxZoom() - map->getMinZoom() + 1;
     float cpuFactor    = availableProcessors;
@@ -211,8 +211,7 @@ LOOP_HANDLE RunLoop::getLoopHandle() {
     return current.get()->impl.get();
 }
 
-void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+void RunLoop::wake() {
     impl->wake();
 }
 
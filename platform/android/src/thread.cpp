@@ -1,6 +1,10 @@
 #include <mbgl/platform/log.hpp>
 #include <mbgl/platform/platform.hpp>
 
+#include <algorithm>
+#include <thread>
+
+#include <sched.h>
 #include <sys/prctl.h>
 #include <sys/resource.h>
 
@@ -33,5 +37,32 @@ void makeThreadLowPriority() {
     setpriority(PRIO_PROCESS, 0, 19);
 }
 
+std::vector<std::vector<std::size_t>> getNUMANodes() {
+    // Android devices are single-node.
+    std::vector<std::vector<std::size_t>> nodes(1);
+    const std::size_t count = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t cpu = 0; cpu < count; ++cpu) {
+        nodes.back().push_back(cpu);
+    }
+    return nodes;
+}
+
+bool setCurrentThreadAffinity(const std::vector<std::size_t>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace platform
 } // namespace mbgl
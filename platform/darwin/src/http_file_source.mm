@@ -197,6 +197,17 @@ uint32_t HTTPFileSource::maximumConcurrentRequests() {
     return 20;
 }
 
+void HTTPFileSource::setMaximumConnectionsPerHost(uint32_t maximum) {
+    @autoreleasepool {
+        // The configuration of a session can't be changed, so the requests from now on go through
+        // a new one, and the old one is invalidated once its requests finished.
+        NSURLSessionConfiguration* sessionConfig = [impl->session.configuration copy];
+        sessionConfig.HTTPMaximumConnectionsPerHost = maximum ? maximum : 8; // The default, see above.
+        [impl->session finishTasksAndInvalidate];
+        impl->session = [NSURLSession sessionWithConfiguration:sessionConfig];
+    }
+}
+
 std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource, Callback callback) {
     auto request = std::make_unique<HTTPRequest>(callback);
     auto shared = request->shared; // Explicit copy so that it also gets copied into the completion handler block below.
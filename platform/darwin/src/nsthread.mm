@@ -2,6 +2,9 @@
 
 #include <mbgl/platform/platform.hpp>
 
+#include <algorithm>
+#include <thread>
+
 #include <pthread.h>
 
 namespace mbgl {
@@ -22,5 +25,19 @@ void makeThreadLowPriority() {
     [[NSThread currentThread] setThreadPriority:0.0];
 }
 
+std::vector<std::vector<std::size_t>> getNUMANodes() {
+    std::vector<std::vector<std::size_t>> nodes(1);
+    const std::size_t count = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t cpu = 0; cpu < count; ++cpu) {
+        nodes.back().push_back(cpu);
+    }
+    return nodes;
+}
+
+bool setCurrentThreadAffinity(const std::vector<std::size_t>&) {
+    // Darwin only supports affinity hints between threads, not pinning to CPUs.
+    return false;
+}
+
 }
 }
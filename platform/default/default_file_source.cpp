@@ -4,13 +4,24 @@
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/offline_pack.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
 
+#include <mbgl/platform/log.hpp>
 #include <mbgl/platform/platform.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/url.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 #include <mbgl/util/work_request.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <list>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace {
 
@@ -20,16 +31,138 @@ bool isAssetURL(const std::string& url) {
     return std::equal(assetProtocol.begin(), assetProtocol.end(), url.begin());
 }
 
+// Responses from the network, and reads from the cache, are written to it in transactions of
+// up to this many, or of the ones made within this long.
+const std::size_t maximumPendingWrites = 64;
+const mbgl::Duration writeDelay = std::chrono::milliseconds(250);
+
+// Eviction runs in steps of about this long, between which requests are handled.
+const mbgl::Duration evictionStep = std::chrono::milliseconds(10);
+
 } // namespace
 
 namespace mbgl {
 
+// Reads the cache on a read-only connection of its own, so that reads don't queue up behind
+// the writes of DefaultFileSource::Impl.
+class CacheReader {
+public:
+    CacheReader(std::string path_) : path(std::move(path_)) {
+    }
+
+    void read(Resource resource, std::function<void (std::exception_ptr, optional<Response>)> callback) {
+        try {
+            if (!database) {
+                database = std::make_unique<OfflineDatabase>(path, OfflineDatabase::ReadOnly());
+            }
+            callback({}, database->read(resource));
+        } catch (...) {
+            // Reconnects for the next read.
+            database.reset();
+            callback(std::current_exception(), {});
+        }
+    }
+
+private:
+    const std::string path;
+    std::unique_ptr<OfflineDatabase> database;
+};
+
+// Keeps the tiles that were loaded recently in memory, so that revisiting them doesn't read the
+// database again. The least recently used are evicted once they take up more than the
+// maximum size.
+class MemoryCache {
+public:
+    void setMaximumSize(uint64_t maximumSize_) {
+        maximumSize = maximumSize_;
+        evict();
+    }
+
+    uint64_t getSize() const {
+        return size;
+    }
+
+    optional<Response> get(const Resource& resource) {
+        auto it = index.find(resource.url);
+        if (it == index.end()) {
+            return {};
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->response;
+    }
+
+    void add(const Resource& resource, const Response& response) {
+        if (resource.kind != Resource::Kind::Tile || response.error) {
+            return;
+        }
+
+        auto it = index.find(resource.url);
+        if (response.notModified) {
+            if (it != index.end()) {
+                it->second->response.expires = response.expires;
+            }
+            return;
+        }
+
+        if (it != index.end()) {
+            size -= it->second->size;
+            entries.erase(it->second);
+            index.erase(it);
+        }
+
+        const uint64_t entrySize = sizeof(Entry) + resource.url.size() + (response.data ? response.data->size() : 0);
+        if (entrySize <= maximumSize) {
+            entries.push_front({ resource.url, response, entrySize });
+            index.emplace(resource.url, entries.begin());
+            size += entrySize;
+            evict();
+        }
+    }
+
+private:
+    void evict() {
+        while (size > maximumSize) {
+            size -= entries.back().size;
+            index.erase(entries.back().url);
+            entries.pop_back();
+        }
+    }
+
+    struct Entry {
+        std::string url;
+        Response response;
+        uint64_t size;
+    };
+
+    // From the most to the least recently used.
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    uint64_t size = 0;
+    uint64_t maximumSize = util::DEFAULT_MAX_MEMORY_CACHE_SIZE;
+};
+
 class DefaultFileSource::Impl {
 public:
     Impl(const std::string& cachePath, uint64_t maximumCacheSize)
         : offlineDatabase(cachePath, maximumCacheSize) {
+        // Connections to in-memory databases don't share them.
+        if (cachePath != ":memory:" && !cachePath.empty()) {
+            const unsigned count = std::min(4u, std::max(2u, std::thread::hardware_concurrency()));
+            for (unsigned i = 0; i < count; ++i) {
+                readers.push_back(std::make_unique<util::Thread<CacheReader>>(
+                    util::ThreadContext{"CacheReader", util::ThreadPriority::Low}, cachePath));
+            }
+        }
     }
     
+    ~Impl() {
+        try {
+            writePending();
+        } catch (const std::exception& ex) {
+            Log::Error(Event::Database, "Can't write to the cache: %s", ex.what());
+        }
+    }
+
     void setAPIBaseURL(const std::string& url) {
         onlineFileSource.setAPIBaseURL(url);
     }
@@ -46,6 +179,10 @@ public:
         return onlineFileSource.getAccessToken();
     }
 
+    void setMaximumConnectionsPerHost(uint32_t maximum) {
+        onlineFileSource.setMaximumConnectionsPerHost(maximum);
+    }
+
     void listRegions(std::function<void (std::exception_ptr, optional<std::vector<OfflineRegion>>)> callback) {
         try {
             callback({}, offlineDatabase.listRegions());
@@ -92,6 +229,24 @@ public:
         }
     }
 
+    void exportRegion(int64_t regionID, const std::string& path, std::function<void (std::exception_ptr)> callback) {
+        try {
+            offlineDatabase.exportRegion(regionID, path);
+            callback({});
+        } catch (...) {
+            callback(std::current_exception());
+        }
+    }
+
+    void addPack(const std::string& path, std::function<void (std::exception_ptr)> callback) {
+        try {
+            packs.push_back(std::make_unique<OfflinePack>(path));
+            callback({});
+        } catch (...) {
+            callback(std::current_exception());
+        }
+    }
+
     void setRegionObserver(int64_t regionID, std::unique_ptr<OfflineRegionObserver> observer) {
         getDownload(regionID).setObserver(std::move(observer));
     }
@@ -100,64 +255,440 @@ public:
         getDownload(regionID).setState(state);
     }
 
+    void setRegionRefreshExpiredResources(int64_t regionID, bool refresh) {
+        getDownload(regionID).setRefreshExpiredResources(refresh);
+    }
+
     void request(AsyncRequest* req, Resource resource, Callback callback) {
-        Resource revalidation = resource;
+        if (resource.necessity == Resource::Required && joinOnlineRequest(req, resource, callback, false)) {
+            return;
+        }
 
         const bool hasPrior = resource.priorEtag || resource.priorModified || resource.priorExpires;
-        if (!hasPrior || resource.necessity == Resource::Optional) {
-            auto offlineResponse = offlineDatabase.get(resource);
-
-            if (resource.necessity == Resource::Optional && !offlineResponse) {
-                // Ensure there's always a response that we can send, so the caller knows that
-                // there's no optional data available in the cache.
-                offlineResponse.emplace();
-                offlineResponse->noContent = true;
-                offlineResponse->error = std::make_unique<Response::Error>(
-                    Response::Error::Reason::NotFound, "Not found in offline database");
-            }
-
+        if (hasPrior && resource.necessity == Resource::Required) {
+            requestOnline(req, resource, resource, callback, priorResponse(resource));
+        } else if (optional<Response> packResponse = readPacks(resource)) {
+            readOffline(req, std::move(resource), std::move(callback), std::move(packResponse));
+        } else if (optional<Response> memoryResponse = memoryCache.get(resource)) {
+            queueTouch(resource);
+            readOffline(req, std::move(resource), std::move(callback), std::move(memoryResponse));
+        } else if (optional<Response> pendingResponse = pendingWrite(resource)) {
+            readOffline(req, std::move(resource), std::move(callback), std::move(pendingResponse));
+        } else if (readers.empty()) {
+            optional<Response> offlineResponse = offlineDatabase.read(resource);
             if (offlineResponse) {
-                revalidation.priorModified = offlineResponse->modified;
-                revalidation.priorExpires = offlineResponse->expires;
-                revalidation.priorEtag = offlineResponse->etag;
-                callback(*offlineResponse);
+                queueTouch(resource);
+                memoryCache.add(resource, *offlineResponse);
             }
+            readOffline(req, std::move(resource), std::move(callback), std::move(offlineResponse));
+        } else {
+            PendingRead& pending = reads[req];
+            pending.resource = resource;
+            pending.request = readers[nextReader++ % readers.size()]->invokeWithCallback(
+                &CacheReader::read, resource,
+                [this, req, callback] (std::exception_ptr error, optional<Response> offlineResponse) {
+                    auto it = reads.find(req);
+                    assert(it != reads.end());
+                    Resource pendingResource = std::move(it->second.resource);
+                    reads.erase(it);
+
+                    if (error) {
+                        Log::Error(Event::Database, "Can't read from the cache: %s", util::toString(error).c_str());
+                        offlineResponse = offlineDatabase.read(pendingResource);
+                    }
+                    if (offlineResponse) {
+                        queueTouch(pendingResource);
+                        memoryCache.add(pendingResource, *offlineResponse);
+                    }
+                    readOffline(req, std::move(pendingResource), callback, std::move(offlineResponse));
+                });
         }
+    }
 
-        if (resource.necessity == Resource::Required) {
-            tasks[req] = onlineFileSource.request(revalidation, [=] (Response onlineResponse) {
-                this->offlineDatabase.put(revalidation, onlineResponse);
-                callback(onlineResponse);
-            });
+    void cancel(AsyncRequest* req) {
+        reads.erase(req);
+
+        auto task = tasks.find(req);
+        if (task == tasks.end()) {
+            return;
+        }
+
+        // The online request is cancelled along with the last of the requests that share it.
+        auto it = task->second;
+        tasks.erase(task);
+        auto& requesters = it->second.requesters;
+        requesters.erase(std::remove_if(requesters.begin(), requesters.end(), [&] (const auto& requester) {
+            return requester.req == req;
+        }), requesters.end());
+        if (requesters.empty()) {
+            onlineRequests.erase(it);
+        } else {
+            updatePriority(it->second);
         }
     }
 
-    void cancel(AsyncRequest* req) {
-        tasks.erase(req);
+    void setPriority(AsyncRequest* req, Resource::Priority priority) {
+        auto read = reads.find(req);
+        if (read != reads.end()) {
+            read->second.resource.priority = priority;
+            return;
+        }
+
+        // Requests for assets, local files and tile archives aren't queued.
+        auto task = tasks.find(req);
+        if (task == tasks.end()) {
+            return;
+        }
+
+        OnlineRequest& onlineRequest = task->second->second;
+        for (auto& requester : onlineRequest.requesters) {
+            if (requester.req == req) {
+                requester.priority = priority;
+            }
+        }
+        updatePriority(onlineRequest);
     }
 
     void setOfflineMapboxTileCountLimit(uint64_t limit) {
         offlineDatabase.setOfflineMapboxTileCountLimit(limit);
     }
 
+    void setMaximumConcurrentOfflineRequests(uint32_t maximum) {
+        maximumConcurrentOfflineRequests = maximum;
+        for (auto& download : downloads) {
+            download.second->setMaximumConcurrentRequests(maximum);
+        }
+    }
+
+    void setMaximumMemoryCacheSize(uint64_t size) {
+        memoryCache.setMaximumSize(size);
+    }
+
+    void setOnlineFileSource(std::unique_ptr<FileSource> fileSource) {
+        assert(onlineRequests.empty() && downloads.empty());
+        replacementOnlineFileSource = std::move(fileSource);
+    }
+
+    std::size_t getMemoryUsage() const {
+        return memoryCache.getSize() + offlineDatabase.getMemoryUsage();
+    }
+
     void put(const Resource& resource, const Response& response) {
-        offlineDatabase.put(resource, response);
+        queueWrite(resource, response);
     }
 
 private:
+    struct Requester;
+    struct OnlineRequest;
+
+    // Adds the request to a pending identical one, if there is one, and sends it the latest
+    // response of the latter right away. Requests that got a response from the cache already
+    // don't get the latest response unless it came from the network.
+    bool joinOnlineRequest(AsyncRequest* req, const Resource& resource, const Callback& callback, bool cached) {
+        auto it = onlineRequests.find(requestKey(resource));
+        if (it == onlineRequests.end()) {
+            return false;
+        }
+
+        const optional<Response>& latest = it->second.response;
+        const bool sent = latest && (!cached || it->second.online);
+        it->second.requesters.push_back({ req, callback, resource.priority,
+                                          cached || hasPriorData(resource) || (sent && latest->data) });
+        tasks.emplace(req, it);
+        updatePriority(it->second);
+        if (sent) {
+            callback(*latest);
+        }
+        return true;
+    }
+
+    // Whether the request revalidates data that its requester has already. TileLoader marks the
+    // requests that follow optional ones that found nothing with a prior expiration of 0.
+    static bool hasPriorData(const Resource& resource) {
+        return resource.priorEtag || resource.priorModified ||
+               (resource.priorExpires && *resource.priorExpires != Timestamp{ Seconds::zero() });
+    }
+
+    // The cached response that a request revalidates, if the cache still has the version of it
+    // that the requester has.
+    optional<Response> priorResponse(const Resource& resource) {
+        optional<Response> response = memoryCache.get(resource);
+        if (!response) {
+            response = pendingWrite(resource);
+        }
+        if (response && !response->error && response->data && response->etag == resource.priorEtag &&
+            response->modified == resource.priorModified && response->expires == resource.priorExpires) {
+            return response;
+        }
+        return {};
+    }
+
+    optional<Response> readPacks(const Resource& resource) const {
+        for (const auto& pack : packs) {
+            if (optional<Response> response = pack->get(resource)) {
+                return response;
+            }
+        }
+        return {};
+    }
+
+    // Sends the response from the cache, if any, and then requests the resource from the
+    // network when it's required.
+    void readOffline(AsyncRequest* req, Resource resource, Callback callback, optional<Response> offlineResponse) {
+        if (resource.necessity == Resource::Optional && !offlineResponse) {
+            // Ensure there's always a response that we can send, so the caller knows that
+            // there's no optional data available in the cache.
+            offlineResponse.emplace();
+            offlineResponse->noContent = true;
+            offlineResponse->error = std::make_unique<Response::Error>(
+                Response::Error::Reason::NotFound, "Not found in offline database");
+        }
+
+        Resource revalidation = resource;
+        if (offlineResponse) {
+            revalidation.priorModified = offlineResponse->modified;
+            revalidation.priorExpires = offlineResponse->expires;
+            revalidation.priorEtag = offlineResponse->etag;
+            callback(*offlineResponse);
+        }
+
+        // An identical request may have gone online while the cache was read.
+        if (resource.necessity == Resource::Required &&
+            !joinOnlineRequest(req, resource, callback, bool(offlineResponse))) {
+            requestOnline(req, resource, revalidation, callback, std::move(offlineResponse));
+        }
+    }
+
+    void requestOnline(AsyncRequest* req, const Resource& resource, Resource revalidation,
+                       Callback callback, optional<Response> offlineResponse) {
+        auto it = onlineRequests.emplace(requestKey(resource), OnlineRequest()).first;
+        OnlineRequest& onlineRequest = it->second;
+        const bool stale = hasPriorData(resource) || (offlineResponse && offlineResponse->data);
+        onlineRequest.requesters.push_back({ req, callback, resource.priority, stale });
+        onlineRequest.priority = requesterPriority(onlineRequest.requesters.back());
+        onlineRequest.response = std::move(offlineResponse);
+        tasks.emplace(req, it);
+
+        revalidation.priority = onlineRequest.priority;
+        onlineRequest.request = online().request(revalidation, [=, &onlineRequest] (Response onlineResponse) {
+            this->queueWrite(revalidation, onlineResponse);
+
+            // The requests have the data that's sent before the online response already. When
+            // it comes back the same, without a Not Modified response, they're told it hasn't
+            // been modified all the same, so that they don't parse and lay it out again.
+            optional<Response>& latest = onlineRequest.response;
+            Response sent = onlineResponse;
+            if (latest && latest->data && !latest->error && !latest->notModified &&
+                !onlineResponse.error && !onlineResponse.notModified && !onlineResponse.noContent &&
+                onlineResponse.data && (onlineResponse.data == latest->data || *onlineResponse.data == *latest->data)) {
+                sent.notModified = true;
+                sent.data.reset();
+            }
+
+            // Errors and Not Modified responses don't replace the data that requests joining
+            // later get, but the latter tell when it expires.
+            if (latest && !latest->error && !latest->notModified &&
+                (onlineResponse.error || onlineResponse.notModified)) {
+                if (onlineResponse.notModified) {
+                    latest->expires = onlineResponse.expires;
+                }
+            } else {
+                latest = onlineResponse;
+            }
+            onlineRequest.online = true;
+
+            // The callbacks post the response to the threads of the requests, and can't cancel
+            // them from here.
+            for (const auto& requester : onlineRequest.requesters) {
+                requester.callback(sent);
+            }
+        });
+    }
+
+    // Requests whose requesters render the stale data they have in the meantime revalidate it
+    // in the background of the ones that wait for theirs.
+    static Resource::Priority requesterPriority(const Requester& requester) {
+        return requester.stale ? std::max(requester.priority, Resource::Low) : requester.priority;
+    }
+
+    // A shared request goes at the highest priority of the requests that share it.
+    void updatePriority(OnlineRequest& onlineRequest) {
+        Resource::Priority priority = Resource::Background;
+        for (const auto& requester : onlineRequest.requesters) {
+            priority = std::min(priority, requesterPriority(requester));
+        }
+        if (priority != onlineRequest.priority) {
+            onlineRequest.priority = priority;
+            online().setPriority(*onlineRequest.request, priority);
+        }
+    }
+
+    // The response that's waiting to be written for the resource, if it's one that reads of
+    // the cache would get.
+    optional<Response> pendingWrite(const Resource& resource) const {
+        auto it = pendingWrites.find(resource.url);
+        if (it == pendingWrites.end() || it->second.second.notModified) {
+            return {};
+        }
+        return it->second.second;
+    }
+
+    void queueWrite(const Resource& resource, const Response& response) {
+        // The cache doesn't store errors.
+        if (response.error) {
+            return;
+        }
+        memoryCache.add(resource, response);
+
+        auto it = pendingWrites.find(resource.url);
+        if (it == pendingWrites.end()) {
+            pendingWrites.emplace(resource.url, std::make_pair(resource, response));
+        } else if (response.notModified && !it->second.second.notModified) {
+            it->second.second.expires = response.expires;
+        } else {
+            it->second = std::make_pair(resource, response);
+        }
+
+        // Writing a resource marks it as used already.
+        pendingTouches.erase(resource.url);
+        scheduleWrite();
+    }
+
+    void queueTouch(const Resource& resource) {
+        if (!pendingWrites.count(resource.url)) {
+            pendingTouches.emplace(resource.url, resource);
+            scheduleWrite();
+        }
+    }
+
+    void scheduleWrite() {
+        if (pendingWrites.size() + pendingTouches.size() >= maximumPendingWrites) {
+            writeTimer.stop();
+            writePending();
+        } else if (!writeScheduled) {
+            writeScheduled = true;
+            writeTimer.start(writeDelay, Duration::zero(), [this] {
+                writePending();
+            });
+        }
+    }
+
+    void writePending() {
+        writeScheduled = false;
+
+        std::vector<std::pair<Resource, Response>> writes;
+        writes.reserve(pendingWrites.size());
+        for (auto& write : pendingWrites) {
+            writes.push_back(std::move(write.second));
+        }
+        std::vector<Resource> touches;
+        touches.reserve(pendingTouches.size());
+        for (auto& touch : pendingTouches) {
+            touches.push_back(std::move(touch.second));
+        }
+        pendingWrites.clear();
+        pendingTouches.clear();
+
+        if (!writes.empty() || !touches.empty()) {
+            offlineDatabase.putBatch(writes, touches);
+            scheduleEviction();
+            scheduleCheckpoint();
+        }
+    }
+
+    // Makes space for the writes after the fact, so that they don't wait for it.
+    void scheduleEviction() {
+        if (!evictionScheduled) {
+            evictionScheduled = true;
+            evictionTimer.start(Duration::zero(), Duration::zero(), [this] {
+                evictionScheduled = false;
+                if (offlineDatabase.evictIncrementally(evictionStep)) {
+                    scheduleEviction();
+                }
+            });
+        }
+    }
+
+    // Checkpoints the write-ahead log a while after the cache was written to, between the bursts
+    // of writes, instead of leaving it to whichever put fills the log.
+    void scheduleCheckpoint() {
+        if (!checkpointScheduled) {
+            checkpointScheduled = true;
+            checkpointTimer.start(std::chrono::seconds(10), Duration::zero(), [this] {
+                checkpointScheduled = false;
+                offlineDatabase.checkpoint();
+            });
+        }
+    }
+
     OfflineDownload& getDownload(int64_t regionID) {
         auto it = downloads.find(regionID);
         if (it != downloads.end()) {
             return *it->second;
         }
-        return *downloads.emplace(regionID,
-            std::make_unique<OfflineDownload>(regionID, offlineDatabase.getRegionDefinition(regionID), offlineDatabase, onlineFileSource)).first->second;
+        OfflineDownload& download = *downloads.emplace(regionID,
+            std::make_unique<OfflineDownload>(regionID, offlineDatabase.getRegionDefinition(regionID), offlineDatabase, online())).first->second;
+        if (maximumConcurrentOfflineRequests) {
+            download.setMaximumConcurrentRequests(*maximumConcurrentOfflineRequests);
+        }
+        return download;
+    }
+
+    FileSource& online() {
+        return replacementOnlineFileSource ? *replacementOnlineFileSource : onlineFileSource;
+    }
+
+    // Identical required requests that are made while one is pending, e.g. by maps that share the
+    // file source, share its cache read and network request.
+    using RequestKey = std::tuple<Resource::Kind, std::string, optional<std::string>, optional<Timestamp>, optional<Timestamp>>;
+    static RequestKey requestKey(const Resource& resource) {
+        return RequestKey { resource.kind, resource.url, resource.priorEtag, resource.priorModified, resource.priorExpires };
     }
+    struct Requester {
+        AsyncRequest* req;
+        Callback callback;
+        Resource::Priority priority;
+        // Whether it has data to show while the request revalidates it.
+        bool stale;
+    };
+    struct OnlineRequest {
+        std::vector<Requester> requesters;
+        Resource::Priority priority = Resource::Regular;
+        // The latest response, for requests that join, and whether it came from the network.
+        optional<Response> response;
+        bool online = false;
+        std::unique_ptr<AsyncRequest> request;
+    };
+
+    // Requests whose cache read is pending on one of the readers, at their current priority.
+    struct PendingRead {
+        Resource resource { Resource::Unknown, "" };
+        std::unique_ptr<AsyncRequest> request;
+    };
 
     OfflineDatabase offlineDatabase;
+    MemoryCache memoryCache;
+    // The readers are stopped after the pending reads are cancelled.
+    std::vector<std::unique_ptr<util::Thread<CacheReader>>> readers;
+    std::size_t nextReader = 0;
+    std::unordered_map<AsyncRequest*, PendingRead> reads;
+    // Ambient cache writes, and marks of resources as used, that wait to be written together,
+    // by URL.
+    std::unordered_map<std::string, std::pair<Resource, Response>> pendingWrites;
+    std::unordered_map<std::string, Resource> pendingTouches;
+    util::Timer writeTimer;
+    bool writeScheduled = false;
+    util::Timer evictionTimer;
+    bool evictionScheduled = false;
+    util::Timer checkpointTimer;
+    bool checkpointScheduled = false;
     OnlineFileSource onlineFileSource;
-    std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
+    std::unique_ptr<FileSource> replacementOnlineFileSource;
+    std::map<RequestKey, OnlineRequest> onlineRequests;
+    std::unordered_map<AsyncRequest*, std::map<RequestKey, OnlineRequest>::iterator> tasks;
+    optional<uint32_t> maximumConcurrentOfflineRequests;
     std::unordered_map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
+    std::vector<std::unique_ptr<OfflinePack>> packs;
 };
 
 DefaultFileSource::DefaultFileSource(const std::string& cachePath,
@@ -166,7 +697,8 @@ DefaultFileSource::DefaultFileSource(const std::string& cachePath,
     : thread(std::make_unique<util::Thread<Impl>>(util::ThreadContext{"DefaultFileSource", util::ThreadPriority::Low},
             cachePath, maximumCacheSize)),
       assetFileSource(std::make_unique<AssetFileSource>(assetRoot)),
-      localFileSource(std::make_unique<LocalFileSource>()) {
+      localFileSource(std::make_unique<LocalFileSource>()),
+      tileArchiveFileSource(std::make_unique<TileArchiveFileSource>()) {
 }
 
 DefaultFileSource::~DefaultFileSource() = default;
@@ -187,6 +719,26 @@ std::string DefaultFileSource::getAccessToken() const {
     return thread->invokeSync(&Impl::getAccessToken);
 }
 
+void DefaultFileSource::setMaximumConnectionsPerHost(uint32_t maximum) {
+    thread->invoke(&Impl::setMaximumConnectionsPerHost, maximum);
+}
+
+void DefaultFileSource::setMaximumMemoryCacheSize(uint64_t size) {
+    thread->invoke(&Impl::setMaximumMemoryCacheSize, size);
+}
+
+void DefaultFileSource::setOnlineFileSource(std::unique_ptr<FileSource> fileSource) {
+    thread->invoke(&Impl::setOnlineFileSource, std::move(fileSource));
+}
+
+std::size_t DefaultFileSource::getMemoryUsage() const {
+    return thread->invokeSync(&Impl::getMemoryUsage);
+}
+
+void DefaultFileSource::setPriority(AsyncRequest& req, Resource::Priority priority) {
+    thread->invoke(&Impl::setPriority, &req, priority);
+}
+
 std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resource, Callback callback) {
     class DefaultFileRequest : public AsyncRequest {
     public:
@@ -207,6 +759,8 @@ std::unique_ptr<AsyncRequest> DefaultFileSource::request(const Resource& resourc
         return assetFileSource->request(resource, callback);
     } else if (LocalFileSource::acceptsURL(resource.url)) {
         return localFileSource->request(resource, callback);
+    } else if (TileArchiveFileSource::acceptsURL(resource.url)) {
+        return tileArchiveFileSource->request(resource, callback);
     } else {
         return std::make_unique<DefaultFileRequest>(resource, callback, *thread);
     }
@@ -240,14 +794,30 @@ void DefaultFileSource::setOfflineRegionDownloadState(OfflineRegion& region, Off
     thread->invoke(&Impl::setRegionDownloadState, region.getID(), state);
 }
 
+void DefaultFileSource::setOfflineRegionRefreshExpiredResources(OfflineRegion& region, bool refresh) {
+    thread->invoke(&Impl::setRegionRefreshExpiredResources, region.getID(), refresh);
+}
+
 void DefaultFileSource::getOfflineRegionStatus(OfflineRegion& region, std::function<void (std::exception_ptr, optional<OfflineRegionStatus>)> callback) const {
     thread->invoke(&Impl::getRegionStatus, region.getID(), callback);
 }
 
+void DefaultFileSource::exportOfflineRegion(OfflineRegion& region, const std::string& path, std::function<void (std::exception_ptr)> callback) {
+    thread->invoke(&Impl::exportRegion, region.getID(), path, callback);
+}
+
+void DefaultFileSource::addOfflinePack(const std::string& path, std::function<void (std::exception_ptr)> callback) {
+    thread->invoke(&Impl::addPack, path, callback);
+}
+
 void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     thread->invokeSync(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setMaximumConcurrentOfflineRequests(uint32_t maximum) {
+    thread->invoke(&Impl::setMaximumConcurrentOfflineRequests, maximum);
+}
+
 // For testing only:
 
 void DefaultFileSource::put(const Resource& resource, const Response& response) {
@@ -1,4 +1,5 @@
 #include <mbgl/platform/default/glfw_view.hpp>
+#include <mbgl/platform/default/session.hpp>
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/sprite/sprite_image.hpp>
 #include <mbgl/style/transition_options.hpp>
@@ -126,7 +127,7 @@ GLFWView::~GLFWView() {
 
 void GLFWView::initialize(mbgl::Map *map_) {
     View::initialize(map_);
-    map->addAnnotationIcon("default_marker", makeSpriteImage(22, 22, 1));
+    addAnnotationIcon("default_marker", makeSpriteImage(22, 22, 1));
 }
 
 void GLFWView::onKey(GLFWwindow *window, int key, int /*scancode*/, int action, int mods) {
@@ -284,15 +285,15 @@ void GLFWView::addRandomCustomPointAnnotations(int count) {
     for (int i = 0; i < count; i++) {
         static int spriteID = 1;
         const auto name = std::string{ "marker-" } + mbgl::util::toString(spriteID++);
-        map->addAnnotationIcon(name, makeSpriteImage(22, 22, 1));
+        addAnnotationIcon(name, makeSpriteImage(22, 22, 1));
         spriteIDs.push_back(name);
-        annotationIDs.push_back(map->addAnnotation(mbgl::SymbolAnnotation { makeRandomPoint(), name }));
+        addAnnotation(mbgl::SymbolAnnotation { makeRandomPoint(), name });
     }
 }
 
 void GLFWView::addRandomPointAnnotations(int count) {
     for (int i = 0; i < count; ++i) {
-        annotationIDs.push_back(map->addAnnotation(mbgl::SymbolAnnotation { makeRandomPoint(), "default_marker" }));
+        addAnnotation(mbgl::SymbolAnnotation { makeRandomPoint(), "default_marker" });
     }
 }
 
@@ -302,7 +303,7 @@ void GLFWView::addRandomLineAnnotations(int count) {
         for (int j = 0; j < 3; ++j) {
             lineString.push_back(makeRandomPoint());
         }
-        annotationIDs.push_back(map->addAnnotation(mbgl::LineAnnotation { lineString, 1.0f, 2.0f, { makeRandomColor() } }));
+        addAnnotation(mbgl::LineAnnotation { lineString, 1.0f, 2.0f, { makeRandomColor() } });
     }
 }
 
@@ -310,13 +311,16 @@ void GLFWView::addRandomShapeAnnotations(int count) {
     for (int i = 0; i < count; ++i) {
         mbgl::Polygon<double> triangle;
         triangle.push_back({ makeRandomPoint(), makeRandomPoint(), makeRandomPoint() });
-        annotationIDs.push_back(map->addAnnotation(mbgl::FillAnnotation { triangle, 0.5f, { makeRandomColor() }, { makeRandomColor() } }));
+        addAnnotation(mbgl::FillAnnotation { triangle, 0.5f, { makeRandomColor() }, { makeRandomColor() } });
     }
 }
 
 void GLFWView::clearAnnotations() {
     for (const auto& id : annotationIDs) {
         map->removeAnnotation(id);
+        if (recorder) {
+            recorder->removeAnnotation(id);
+        }
     }
 
     annotationIDs.clear();
@@ -328,9 +332,26 @@ void GLFWView::popAnnotation() {
     }
 
     map->removeAnnotation(annotationIDs.back());
+    if (recorder) {
+        recorder->removeAnnotation(annotationIDs.back());
+    }
     annotationIDs.pop_back();
 }
 
+void GLFWView::addAnnotationIcon(const std::string& name, std::shared_ptr<const mbgl::SpriteImage> image) {
+    if (recorder) {
+        recorder->addAnnotationIcon(name, *image);
+    }
+    map->addAnnotationIcon(name, std::move(image));
+}
+
+void GLFWView::addAnnotation(const mbgl::Annotation& annotation) {
+    annotationIDs.push_back(map->addAnnotation(annotation));
+    if (recorder) {
+        recorder->addAnnotation(annotationIDs.back(), annotation);
+    }
+}
+
 void GLFWView::onScroll(GLFWwindow *window, double /*xOffset*/, double yOffset) {
     GLFWView *view = reinterpret_cast<GLFWView *>(glfwGetWindowUserPointer(window));
     double delta = yOffset * 40;
@@ -435,6 +456,9 @@ void GLFWView::run() {
             glViewport(0, 0, fbWidth, fbHeight);
 
             map->render();
+            if (recorder) {
+                recorder->frame(*map, getSize());
+            }
 
             glfwSwapBuffers(window);
 
@@ -508,6 +532,10 @@ void GLFWView::setWindowTitle(const std::string& title) {
     glfwSetWindowTitle(window, (std::string { "Mapbox GL: " } + title).c_str());
 }
 
+void GLFWView::setRecorder(mbgl::SessionRecorder* recorder_) {
+    recorder = recorder_;
+}
+
 void GLFWView::setMapChangeCallback(std::function<void(mbgl::MapChange)> callback) {
     this->mapChangeCallback = callback;
 }
@@ -7,8 +7,67 @@
 #include <GL/glx.h>
 #endif
 
+#if MBGL_USE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <map>
+#include <mutex>
+#endif
+
 namespace mbgl {
 
+#if MBGL_USE_EGL
+namespace {
+
+bool hasExtension(const char* extensions, const char* name) {
+    // Names can be prefixes of others, e.g. EGL_EXT_platform_device of EGL_EXT_platform_device_x.
+    const std::size_t length = std::strlen(name);
+    for (const char* found = extensions ? std::strstr(extensions, name) : nullptr; found;
+         found = std::strstr(found + length, name)) {
+        if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// There is only one EGLDisplay per device in a process, and terminating it would pull it out
+// from under every HeadlessDisplay that uses it.
+std::mutex displaysMutex;
+std::map<EGLDisplay, std::size_t> displayUsers;
+
+EGLDisplay deviceDisplay() {
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (!hasExtension(clientExtensions, "EGL_EXT_device_enumeration") ||
+        !hasExtension(clientExtensions, "EGL_EXT_platform_device")) {
+        return EGL_NO_DISPLAY;
+    }
+
+    auto queryDevices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!queryDevices || !getPlatformDisplay) {
+        return EGL_NO_DISPLAY;
+    }
+
+    EGLDeviceEXT devices[16];
+    EGLint count = 0;
+    if (!queryDevices(16, devices, &count)) {
+        return EGL_NO_DISPLAY;
+    }
+
+    for (EGLint i = 0; i < count; i++) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) {
+            return display;
+        }
+    }
+    return EGL_NO_DISPLAY;
+}
+
+} // namespace
+#endif
+
 HeadlessDisplay::HeadlessDisplay() {
 #if MBGL_USE_CGL
     // TODO: test if OpenGL 4.1 with GL_ARB_ES2_compatibility is supported
@@ -65,6 +124,49 @@ HeadlessDisplay::HeadlessDisplay() {
         throw std::runtime_error("No Framebuffer configurations.");
     }
 #endif
+
+#if MBGL_USE_EGL
+    std::lock_guard<std::mutex> lock(displaysMutex);
+
+    eglDisplay = deviceDisplay();
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (eglDisplay == EGL_NO_DISPLAY) {
+            throw std::runtime_error("Failed to get an EGL display.");
+        }
+        if (!eglInitialize(eglDisplay, nullptr, nullptr)) {
+            throw std::runtime_error("Failed to initialize the EGL display.");
+        }
+    }
+    displayUsers[eglDisplay]++;
+
+    try {
+        surfaceless = hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+        // The renderer uses desktop OpenGL, as with GLX.
+        const EGLint attributes[] = {
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+            EGL_NONE
+        };
+
+        EGLConfig config = nullptr;
+        EGLint configs = 0;
+        if (!eglChooseConfig(eglDisplay, attributes, &config, 1, &configs)) {
+            throw std::runtime_error("Failed to eglChooseConfig.");
+        }
+        if (configs <= 0) {
+            throw std::runtime_error("No EGL framebuffer configurations.");
+        }
+        eglConfig = config;
+    } catch (...) {
+        if (--displayUsers[eglDisplay] == 0) {
+            displayUsers.erase(eglDisplay);
+            eglTerminate(eglDisplay);
+        }
+        throw;
+    }
+#endif
 }
 
 HeadlessDisplay::~HeadlessDisplay() {
@@ -76,6 +178,14 @@ HeadlessDisplay::~HeadlessDisplay() {
     XFree(fbConfigs);
     XCloseDisplay(xDisplay);
 #endif
+
+#if MBGL_USE_EGL
+    std::lock_guard<std::mutex> lock(displaysMutex);
+    if (--displayUsers[eglDisplay] == 0) {
+        displayUsers.erase(eglDisplay);
+        eglTerminate(eglDisplay);
+    }
+#endif
 }
 
 } // namespace mbgl
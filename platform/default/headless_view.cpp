@@ -3,9 +3,62 @@
 
 #include <cassert>
 #include <cstring>
+#include <stdexcept>
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D
+#endif
 
 namespace mbgl {
 
+namespace {
+
+// Fences are passed around as `void*` instead of `GLsync`, which OpenGL ES 2 headers lack.
+gl::ExtensionFunction<void*(GLenum condition, GLbitfield flags)>
+    FenceSync({ { "OpenGL ES 3", "glFenceSync" },
+                { "GL_ARB_sync", "glFenceSync" } });
+
+gl::ExtensionFunction<GLenum(void* sync, GLbitfield flags, uint64_t timeout)>
+    ClientWaitSync({ { "OpenGL ES 3", "glClientWaitSync" },
+                     { "GL_ARB_sync", "glClientWaitSync" } });
+
+gl::ExtensionFunction<void(void* sync)>
+    DeleteSync({ { "OpenGL ES 3", "glDeleteSync" },
+                 { "GL_ARB_sync", "glDeleteSync" } });
+
+// Both imply pixel buffer objects: ARB_map_buffer_range requires OpenGL 2.1.
+gl::ExtensionFunction<void*(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)>
+    MapBufferRange({ { "OpenGL ES 3", "glMapBufferRange" },
+                     { "GL_ARB_map_buffer_range", "glMapBufferRange" } });
+
+gl::ExtensionFunction<GLboolean(GLenum target)>
+    UnmapBuffer({ { "OpenGL ES 3", "glUnmapBuffer" },
+                  { "GL_ARB_map_buffer_range", "glUnmapBuffer" } });
+
+bool asyncReadbackSupported() {
+    return FenceSync && ClientWaitSync && DeleteSync && MapBufferRange && UnmapBuffer;
+}
+
+} // namespace
+
 HeadlessView::HeadlessView(float pixelRatio_, uint16_t width, uint16_t height)
     : display(std::make_shared<HeadlessDisplay>())
     , pixelRatio(pixelRatio_)
@@ -25,6 +78,7 @@ HeadlessView::HeadlessView(std::shared_ptr<HeadlessDisplay> display_,
 
 HeadlessView::~HeadlessView() {
     activate();
+    clearStillImageReads();
     clearBuffers();
     deactivate();
 
@@ -40,13 +94,27 @@ void HeadlessView::resize(const uint16_t width, const uint16_t height) {
     needsResize = true;
 }
 
-PremultipliedImage HeadlessView::readStillImage(std::array<uint16_t, 2> size) {
-    assert(active);
-
+std::array<uint16_t, 2> HeadlessView::stillImageSize(std::array<uint16_t, 2> size) const {
     if (!size[0] || !size[1]) {
         size[0] = dimensions[0] * pixelRatio;
         size[1] = dimensions[1] * pixelRatio;
     }
+    return size;
+}
+
+PremultipliedImage HeadlessView::readStillImage(std::array<uint16_t, 2> size) {
+    assert(active);
+
+    size = stillImageSize(size);
+
+    if (asyncReadbackSupported()) {
+        // Reading through a pixel buffer object lets the rows be flipped while they're copied out
+        // of it, instead of in a separate pass over the image.
+        startStillImageRead(size);
+        StillImageRead read = std::move(stillImageReads.back());
+        stillImageReads.pop_back();
+        return finishStillImageRead(read);
+    }
 
     PremultipliedImage image { size[0], size[1] };
     MBGL_CHECK_ERROR(glReadPixels(0, 0, size[0], size[1], GL_RGBA, GL_UNSIGNED_BYTE, image.data.get()));
@@ -63,6 +131,119 @@ PremultipliedImage HeadlessView::readStillImage(std::array<uint16_t, 2> size) {
     return image;
 }
 
+void HeadlessView::startStillImageRead(std::array<uint16_t, 2> size) {
+    assert(active);
+
+    StillImageRead read;
+    read.size = stillImageSize(size);
+
+    if (!asyncReadbackSupported()) {
+        // Not the virtual call, which subclasses may implement with this one.
+        read.image = HeadlessView::readStillImage(read.size);
+        stillImageReads.push_back(std::move(read));
+        return;
+    }
+
+    if (readbackBuffers.empty()) {
+        MBGL_CHECK_ERROR(glGenBuffers(1, &read.buffer));
+    } else {
+        read.buffer = readbackBuffers.back();
+        readbackBuffers.pop_back();
+    }
+
+    const GLsizeiptr length = read.size[0] * read.size[1] * 4;
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, read.buffer));
+    MBGL_CHECK_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, length, nullptr, GL_STREAM_READ));
+    MBGL_CHECK_ERROR(glReadPixels(0, 0, read.size[0], read.size[1], GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    read.fence = MBGL_CHECK_ERROR(FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    stillImageReads.push_back(std::move(read));
+}
+
+bool HeadlessView::isStillImageReadFinished() {
+    assert(active);
+
+    if (stillImageReads.empty()) {
+        return false;
+    }
+
+    void* fence = stillImageReads.front().fence;
+    return !fence || MBGL_CHECK_ERROR(ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0)) != GL_TIMEOUT_EXPIRED;
+}
+
+PremultipliedImage HeadlessView::finishStillImageRead() {
+    assert(active);
+
+    if (stillImageReads.empty()) {
+        throw std::logic_error("No still image read is pending");
+    }
+
+    StillImageRead read = std::move(stillImageReads.front());
+    stillImageReads.pop_front();
+    return finishStillImageRead(read);
+}
+
+PremultipliedImage HeadlessView::finishStillImageRead(StillImageRead& read) {
+    if (!read.buffer) {
+        return std::move(read.image);
+    }
+
+    GLenum status;
+    do {
+        status = MBGL_CHECK_ERROR(ClientWaitSync(read.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+    } while (status == GL_TIMEOUT_EXPIRED);
+    MBGL_CHECK_ERROR(DeleteSync(read.fence));
+    read.fence = nullptr;
+
+    if (status == GL_WAIT_FAILED) {
+        readbackBuffers.push_back(read.buffer);
+        throw std::runtime_error("Waiting for the still image read failed");
+    }
+
+    PremultipliedImage image { read.size[0], read.size[1] };
+    const auto stride = image.stride();
+    const GLsizeiptr length = stride * read.size[1];
+
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, read.buffer));
+    auto pixels = reinterpret_cast<const uint8_t*>(
+        MBGL_CHECK_ERROR(MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, length, GL_MAP_READ_BIT)));
+    if (pixels) {
+        // OpenGL returns the bottom row first.
+        uint8_t* rgba = image.data.get();
+        for (std::size_t i = 0, j = read.size[1] - 1; i < read.size[1]; i++, j--) {
+            std::memcpy(rgba + i * stride, pixels + j * stride, stride);
+        }
+        MBGL_CHECK_ERROR(UnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+    MBGL_CHECK_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    readbackBuffers.push_back(read.buffer);
+
+    if (!pixels) {
+        throw std::runtime_error("Mapping the still image read failed");
+    }
+
+    return image;
+}
+
+void HeadlessView::clearStillImageReads() {
+    for (auto& read : stillImageReads) {
+        if (read.fence) {
+            MBGL_CHECK_ERROR(DeleteSync(read.fence));
+        }
+        if (read.buffer) {
+            readbackBuffers.push_back(read.buffer);
+        }
+    }
+    stillImageReads.clear();
+
+    if (!readbackBuffers.empty()) {
+        MBGL_CHECK_ERROR(glDeleteBuffers(static_cast<GLsizei>(readbackBuffers.size()), readbackBuffers.data()));
+        readbackBuffers.clear();
+    }
+}
+
 float HeadlessView::getPixelRatio() const {
     return pixelRatio;
 }
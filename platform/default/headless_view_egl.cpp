@@ -0,0 +1,139 @@
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+
+#include <cassert>
+
+#include <EGL/egl.h>
+
+namespace mbgl {
+
+namespace {
+
+// The API that contexts are created and made current for is a property of the thread.
+void bindAPI() {
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        throw std::runtime_error("EGL doesn't support OpenGL.");
+    }
+}
+
+} // namespace
+
+gl::glProc HeadlessView::initializeExtension(const char* name) {
+    return eglGetProcAddress(name);
+}
+
+void HeadlessView::createContext() {
+    eglDisplay = display->eglDisplay;
+
+    // Each view has its own context, so that maps can render on as many threads as they like.
+    bindAPI();
+    glContext = eglCreateContext(eglDisplay, display->eglConfig, EGL_NO_CONTEXT, nullptr);
+    if (glContext == EGL_NO_CONTEXT) {
+        glContext = nullptr;
+        throw std::runtime_error("Error creating GL context object.");
+    }
+
+    if (!display->surfaceless) {
+        // We render to framebuffers anyway, but without EGL_KHR_surfaceless_context we need a
+        // surface to activate the context.
+        const EGLint pbufferAttributes[] = {
+            EGL_WIDTH, 8,
+            EGL_HEIGHT, 8,
+            EGL_NONE
+        };
+        eglSurface = eglCreatePbufferSurface(eglDisplay, display->eglConfig, pbufferAttributes);
+        if (eglSurface == EGL_NO_SURFACE) {
+            eglDestroyContext(eglDisplay, glContext);
+            glContext = nullptr;
+            eglSurface = nullptr;
+            throw std::runtime_error("Error creating EGL pbuffer surface.");
+        }
+    }
+}
+
+void HeadlessView::destroyContext() {
+    if (eglSurface) {
+        eglDestroySurface(eglDisplay, eglSurface);
+        eglSurface = nullptr;
+    }
+
+    eglDestroyContext(eglDisplay, glContext);
+}
+
+void HeadlessView::resizeFramebuffer() {
+    const unsigned int w = dimensions[0] * pixelRatio;
+    const unsigned int h = dimensions[1] * pixelRatio;
+
+    // Create depth/stencil buffer
+    MBGL_CHECK_ERROR(glGenRenderbuffersEXT(1, &fboDepthStencil));
+    MBGL_CHECK_ERROR(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, fboDepthStencil));
+    MBGL_CHECK_ERROR(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_DEPTH24_STENCIL8_EXT, w, h));
+    MBGL_CHECK_ERROR(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, 0));
+
+    MBGL_CHECK_ERROR(glGenRenderbuffersEXT(1, &fboColor));
+    MBGL_CHECK_ERROR(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, fboColor));
+    MBGL_CHECK_ERROR(glRenderbufferStorageEXT(GL_RENDERBUFFER_EXT, GL_RGBA8, w, h));
+    MBGL_CHECK_ERROR(glBindRenderbufferEXT(GL_RENDERBUFFER_EXT, 0));
+
+    MBGL_CHECK_ERROR(glGenFramebuffersEXT(1, &fbo));
+    MBGL_CHECK_ERROR(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fbo));
+
+    MBGL_CHECK_ERROR(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_RENDERBUFFER_EXT, fboColor));
+    MBGL_CHECK_ERROR(glFramebufferRenderbufferEXT(GL_FRAMEBUFFER_EXT, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER_EXT, fboDepthStencil));
+
+    GLenum status = MBGL_CHECK_ERROR(glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT));
+
+    if (status != GL_FRAMEBUFFER_COMPLETE_EXT) {
+        std::string error("Couldn't create framebuffer: ");
+        switch (status) {
+            case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT_EXT: (error += "incomplete attachment"); break;
+            case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT_EXT: error += "incomplete missing attachment"; break;
+            case GL_FRAMEBUFFER_INCOMPLETE_DIMENSIONS_EXT: error += "incomplete dimensions"; break;
+            case GL_FRAMEBUFFER_INCOMPLETE_FORMATS_EXT: error += "incomplete formats"; break;
+            case GL_FRAMEBUFFER_INCOMPLETE_DRAW_BUFFER_EXT: error += "incomplete draw buffer"; break;
+            case GL_FRAMEBUFFER_INCOMPLETE_READ_BUFFER_EXT: error += "incomplete read buffer"; break;
+            case GL_FRAMEBUFFER_UNSUPPORTED: error += "unsupported"; break;
+            default: error += "other"; break;
+        }
+        throw std::runtime_error(error);
+    }
+
+    MBGL_CHECK_ERROR(glViewport(0, 0, w, h));
+}
+
+void HeadlessView::clearBuffers() {
+    assert(active);
+
+    MBGL_CHECK_ERROR(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0));
+
+    if (fbo) {
+        MBGL_CHECK_ERROR(glDeleteFramebuffersEXT(1, &fbo));
+        fbo = 0;
+    }
+
+    if (fboColor) {
+        MBGL_CHECK_ERROR(glDeleteRenderbuffersEXT(1, &fboColor));
+        fboColor = 0;
+    }
+
+    if (fboDepthStencil) {
+        MBGL_CHECK_ERROR(glDeleteRenderbuffersEXT(1, &fboDepthStencil));
+        fboDepthStencil = 0;
+    }
+}
+
+void HeadlessView::activateContext() {
+    bindAPI();
+    EGLSurface surface = eglSurface ? eglSurface : EGL_NO_SURFACE;
+    if (!eglMakeCurrent(eglDisplay, surface, surface, glContext)) {
+        throw std::runtime_error("Switching OpenGL context failed.\n");
+    }
+}
+
+void HeadlessView::deactivateContext() {
+    if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT)) {
+        throw std::runtime_error("Removing OpenGL context failed.\n");
+    }
+}
+
+} // namespace mbgl
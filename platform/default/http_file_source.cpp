@@ -10,6 +10,7 @@
 #include <mbgl/util/timer.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/http_header.hpp>
+#include <mbgl/util/instrumentation.hpp>
 
 #include <curl/curl.h>
 
@@ -18,6 +19,10 @@
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
+
+// Bodies that claim to be longer than this are appended to a buffer that grows as they arrive.
+static const unsigned long long maximumReservedLength = 64 * 1024 * 1024;
 
 static void handleError(CURLMcode code) {
     if (code != CURLM_OK) {
@@ -31,6 +36,12 @@ static void handleError(CURLcode code) {
     }
 }
 
+static void handleError(CURLSHcode code) {
+    if (code != CURLSHE_OK) {
+        throw std::runtime_error(std::string("CURL share error: ") + curl_share_strerror(code));
+    }
+}
+
 namespace mbgl {
 
 class HTTPFileSource::Impl {
@@ -54,7 +65,8 @@ public:
     // block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state, here the resolved hosts and the TLS
+    // sessions, so that new connections to a host skip the lookup and the full handshake.
     CURLSH *share = nullptr;
 
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
@@ -76,6 +88,7 @@ private:
     HTTPFileSource::Impl* context = nullptr;
     Resource resource;
     FileSource::Callback callback;
+    const TimePoint start = Clock::now();
 
     // Will store the current response.
     std::shared_ptr<std::string> data;
@@ -96,12 +109,18 @@ HTTPFileSource::Impl::Impl() {
     }
 
     share = curl_share_init();
+    handleError(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS));
+    handleError(curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION));
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    // Requests to the same host share an HTTP/2 connection, where the server supports it.
+    handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+#endif
 }
 
 HTTPFileSource::Impl::~Impl() {
@@ -260,6 +279,14 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl* context_, Resource resource_, Fil
 #endif
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
+    handleError(curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L));
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // Added in 7.47.0
+    // Negotiates HTTP/2 for HTTPS. Builds of libcurl without HTTP/2 refuse the option, and keep
+    // using HTTP/1.1.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    // Waits for a connection that the request can be multiplexed on, rather than opening another.
+    handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+#endif
 
     // Start requesting the information.
     handleError(curl_multi_add_handle(context->multi, handle));
@@ -333,12 +360,28 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
         baton->retryAfter = std::string(buffer + begin, length - begin - 2); // remove \r\n
     } else if ((begin = headerMatches("x-rate-limit-reset: ", buffer, length)) != std::string::npos) {
         baton->xRateLimitReset = std::string(buffer + begin, length - begin - 2); // remove \r\n
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        // Sizes the buffer up front, so that appending the body doesn't copy it as it grows. This
+        // is the length of the encoded body, which curl may inflate into more.
+        const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
+        const unsigned long long contentLength = std::strtoull(value.c_str(), nullptr, 10);
+        if (contentLength > 0 && contentLength <= maximumReservedLength) {
+            if (!baton->data) {
+                baton->data = std::make_shared<std::string>();
+            }
+            baton->data->reserve(contentLength);
+        }
     }
 
     return length;
 }
 
 void HTTPRequest::handleResult(CURLcode code) {
+    util::Instrumentation::add(util::Instrumentation::Counter::HTTPRequest, 1, Clock::now() - start);
+    if (data) {
+        util::Instrumentation::add(util::Instrumentation::Counter::HTTPBytes, data->size());
+    }
+
     // Make sure a response object exists in case we haven't got any headers or content.
     if (!response) {
         response = std::make_unique<Response>();
@@ -412,7 +455,21 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
 }
 
 uint32_t HTTPFileSource::maximumConcurrentRequests() {
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0)
+    // Multiplexed requests don't need connections of their own, so more of them can be in flight.
+    static const bool multiplexing = curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2;
+    return multiplexing ? 64 : 20;
+#else
     return 20;
+#endif
+}
+
+void HTTPFileSource::setMaximumConnectionsPerHost(uint32_t maximum) {
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (30) << 8 | 0) // Added in 7.30.0
+    handleError(curl_multi_setopt(impl->multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(maximum)));
+#else
+    (void)maximum;
+#endif
 }
 
 } // namespace mbgl
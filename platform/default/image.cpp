@@ -24,12 +24,7 @@ const static bool png_version_check __attribute__((unused)) = []() {
 
 namespace mbgl {
 
-std::string encodePNG(const PremultipliedImage& pre) {
-    PremultipliedImage copy { pre.width, pre.height };
-    std::copy(pre.data.get(), pre.data.get() + pre.size(), copy.data.get());
-
-    UnassociatedImage src = util::unpremultiply(std::move(copy));
-
+std::string encodePNG(const PremultipliedImage& src) {
     png_voidp error_ptr = nullptr;
     png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, error_ptr, nullptr, nullptr);
     if (!png_ptr) {
@@ -57,18 +52,18 @@ std::string encodePNG(const PremultipliedImage& pre) {
         out->append(reinterpret_cast<char *>(data), length);
     }, nullptr);
 
-    struct ptrs {
-        ptrs(size_t count) : rows(new png_bytep[count]) {}
-        ~ptrs() { delete[] rows; }
-        png_bytep *rows = nullptr;
-    } pointers(src.height);
+    // The rows are unpremultiplied one at a time as they're written, rather than in a copy of
+    // the whole image.
+    const size_t stride = src.stride();
+    auto row = std::make_unique<uint8_t[]>(stride);
 
+    png_write_info(png_ptr, info_ptr);
     for (size_t i = 0; i < src.height; i++) {
-        pointers.rows[i] = src.data.get() + src.stride() * i;
+        std::copy(src.data.get() + stride * i, src.data.get() + stride * (i + 1), row.get());
+        util::unpremultiply(row.get(), src.width);
+        png_write_row(png_ptr, row.get());
     }
-
-    png_set_rows(png_ptr, info_ptr, pointers.rows);
-    png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, nullptr);
+    png_write_end(png_ptr, nullptr);
     png_destroy_write_struct(&png_ptr, &info_ptr);
 
     return result;
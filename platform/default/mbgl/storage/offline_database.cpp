@@ -1,16 +1,53 @@
 #include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/offline_pack.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/compression.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/chrono.hpp>
+#include <mbgl/util/startup_trace.hpp>
 #include <mbgl/platform/log.hpp>
 
 #include "sqlite3.hpp"
 #include <sqlite3.h>
 
+#include <algorithm>
+#include <map>
+#include <tuple>
+
 namespace mbgl {
 
+namespace {
+
+// Reads only mark resources as used again once they were last marked longer ago than this.
+// Eviction doesn't need to tell apart uses that are closer together, and most cache hits then
+// don't rewrite the row and the index on the time of use.
+const Seconds accessedGranularity = std::chrono::hours(1);
+
+// The number of tiles of a URL template that its dictionary is trained on, and how much of each.
+// Tiles of the same source share most of their layer names, keys and values, which are about
+// all that a dictionary can save on vector tiles.
+const std::size_t dictionarySampleCount = 8;
+const std::size_t maximumDictionarySampleSize = 64 * 1024;
+
+// Tiles up to this size, like those of oceans and of empty land, keep their data in a blob
+// that's shared with the identical tiles, instead of a copy each. They aren't compressed with a
+// dictionary, which belongs to one URL template. Bigger tiles are hardly ever identical.
+const std::size_t maximumSharedTileSize = 8 * 1024;
+
+// FNV-1a, which finds the blobs that may be identical to a tile's data. It has to stay the same
+// for the blobs in existing databases to be found.
+int64_t blobHash(const std::string& data) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : data) {
+        hash ^= uint8_t(c);
+        hash *= 1099511628211ull;
+    }
+    return int64_t(hash);
+}
+
+} // namespace
+
 OfflineDatabase::Statement::~Statement() {
     stmt.reset();
     stmt.clearBindings();
@@ -19,9 +56,18 @@ OfflineDatabase::Statement::~Statement() {
 OfflineDatabase::OfflineDatabase(std::string path_, uint64_t maximumCacheSize_)
     : path(std::move(path_)),
       maximumCacheSize(maximumCacheSize_) {
+    // Opening the database, and checking, migrating or creating its schema.
+    StartupTrace::Scope trace("database");
     ensureSchema();
 }
 
+OfflineDatabase::OfflineDatabase(std::string path_, ReadOnly)
+    : path(std::move(path_)),
+      maximumCacheSize(0) {
+    connect(mapbox::sqlite::ReadWrite);
+    db->exec("PRAGMA query_only = ON");
+}
+
 OfflineDatabase::~OfflineDatabase() {
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
@@ -37,6 +83,22 @@ void OfflineDatabase::connect(int flags) {
     db = std::make_unique<mapbox::sqlite::Database>(path.c_str(), flags);
     db->setBusyTimeout(Milliseconds::max());
     db->exec("PRAGMA foreign_keys = ON");
+    synchronous = true;
+}
+
+void OfflineDatabase::setSynchronous(bool synchronous_) {
+    if (synchronous != synchronous_) {
+        db->exec(synchronous_ ? "PRAGMA synchronous = FULL" : "PRAGMA synchronous = NORMAL");
+        synchronous = synchronous_;
+    }
+}
+
+void OfflineDatabase::checkpoint() {
+    try {
+        db->exec("PRAGMA wal_checkpoint(PASSIVE)");
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+    }
 }
 
 void OfflineDatabase::ensureSchema() {
@@ -49,8 +111,12 @@ void OfflineDatabase::ensureSchema() {
             case 1: break; // cache-only database; ok to delete
             case 2: migrateToVersion3(); // fall through
             case 3: // no-op and fall through
-            case 4: migrateToVersion5(); // fall through
-            case 5: return;
+            case 4: // no-op and fall through
+            case 5: migrateToVersion6(); // fall through
+            case 6: migrateToVersion7(); // fall through
+            case 7: migrateToVersion8(); // fall through
+            case 8: migrateToVersion9(); // fall through
+            case 9: return;
             default: throw std::runtime_error("unknown schema version");
             }
 
@@ -81,10 +147,10 @@ void OfflineDatabase::ensureSchema() {
 
         // If you change the schema you must write a migration from the previous version.
         db->exec("PRAGMA auto_vacuum = INCREMENTAL");
-        db->exec("PRAGMA journal_mode = DELETE");
+        db->exec("PRAGMA journal_mode = WAL");
         db->exec("PRAGMA synchronous = FULL");
         db->exec(schema);
-        db->exec("PRAGMA user_version = 5");
+        db->exec("PRAGMA user_version = 9");
     } catch (...) {
         Log::Error(Event::Database, "Unexpected error creating database schema: %s", util::toString(std::current_exception()).c_str());
         throw;
@@ -116,15 +182,140 @@ void OfflineDatabase::migrateToVersion3() {
 }
 
 // Schema version 4 was WAL journal + NORMAL sync. It was reverted during pre-
-// release development and the migration was removed entirely to avoid potential
-// conflicts from quickly (and needlessly) switching journal and sync modes.
+// release development, and version 5 went back to DELETE journal + FULL sync.
 //
 // See: https://github.com/mapbox/mapbox-gl-native/pull/6320
+//
+// Version 6 returns to a WAL journal, so that reads on connections of their own don't wait
+// for writes. Sync is set per connection, and only relaxed for ambient caching. Databases of
+// all the earlier versions migrate to it directly, so that the journal mode doesn't switch
+// back and forth.
+
+void OfflineDatabase::migrateToVersion6() {
+    db->exec("PRAGMA journal_mode = WAL");
+    db->exec("PRAGMA user_version = 6");
+}
 
-void OfflineDatabase::migrateToVersion5() {
-    db->exec("PRAGMA journal_mode = DELETE");
-    db->exec("PRAGMA synchronous = FULL");
-    db->exec("PRAGMA user_version = 5");
+// Version 7 adds the dictionaries that tiles are compressed with.
+
+void OfflineDatabase::migrateToVersion7() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("CREATE TABLE IF NOT EXISTS tile_dictionaries ("
+             "  url_template TEXT NOT NULL PRIMARY KEY,"
+             "  data BLOB NOT NULL"
+             ")");
+    db->exec("PRAGMA user_version = 7");
+    transaction.commit();
+}
+
+// Version 8 adds the blobs that identical tiles share.
+
+void OfflineDatabase::migrateToVersion8() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("ALTER TABLE tiles ADD COLUMN blob_id INTEGER REFERENCES tile_blobs(id)");
+    db->exec("CREATE TABLE tile_blobs ("
+             "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+             "  hash INTEGER NOT NULL,"
+             "  data BLOB NOT NULL,"
+             "  compressed INTEGER NOT NULL DEFAULT 0"
+             ")");
+    db->exec("CREATE INDEX tiles_blob_id ON tiles (blob_id)");
+    db->exec("CREATE INDEX tile_blobs_hash ON tile_blobs (hash)");
+    db->exec("CREATE TRIGGER tile_blobs_delete "
+             "AFTER DELETE ON tiles "
+             "WHEN OLD.blob_id IS NOT NULL "
+             "BEGIN "
+             "  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id); "
+             "END");
+    db->exec("CREATE TRIGGER tile_blobs_update "
+             "AFTER UPDATE OF blob_id ON tiles "
+             "WHEN OLD.blob_id IS NOT NULL AND OLD.blob_id IS NOT NEW.blob_id "
+             "BEGIN "
+             "  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id); "
+             "END");
+    db->exec("PRAGMA user_version = 8");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion9() {
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    db->exec("CREATE TABLE region_status ( "
+             "  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE, "
+             "  resource_count INTEGER NOT NULL DEFAULT 0, "
+             "  resource_size INTEGER NOT NULL DEFAULT 0, "
+             "  tile_count INTEGER NOT NULL DEFAULT 0, "
+             "  tile_size INTEGER NOT NULL DEFAULT 0 "
+             ")");
+    db->exec("CREATE TRIGGER region_status_insert "
+             "AFTER INSERT ON regions "
+             "BEGIN "
+             "  INSERT INTO region_status (region_id) VALUES (NEW.id); "
+             "END");
+    db->exec("CREATE TRIGGER region_resources_insert "
+             "AFTER INSERT ON region_resources "
+             "BEGIN "
+             "  UPDATE region_status "
+             "  SET resource_count = resource_count + 1, "
+             "  resource_size  = resource_size + IFNULL((SELECT length(data) FROM resources WHERE id = NEW.resource_id), 0) "
+             "  WHERE region_id = NEW.region_id; "
+             "END");
+    db->exec("CREATE TRIGGER region_resources_delete "
+             "AFTER DELETE ON region_resources "
+             "BEGIN "
+             "  UPDATE region_status "
+             "  SET resource_count = resource_count - 1, "
+             "  resource_size  = resource_size - IFNULL((SELECT length(data) FROM resources WHERE id = OLD.resource_id), 0) "
+             "  WHERE region_id = OLD.region_id; "
+             "END");
+    db->exec("CREATE TRIGGER region_resources_update "
+             "AFTER UPDATE OF data ON resources "
+             "WHEN length(OLD.data) IS NOT length(NEW.data) "
+             "BEGIN "
+             "  UPDATE region_status "
+             "  SET resource_size = resource_size - IFNULL(length(OLD.data), 0) + IFNULL(length(NEW.data), 0) "
+             "  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id); "
+             "END");
+    db->exec("CREATE TRIGGER region_tiles_insert "
+             "AFTER INSERT ON region_tiles "
+             "BEGIN "
+             "  UPDATE region_status "
+             "  SET tile_count = tile_count + 1, "
+             "  tile_size  = tile_size + IFNULL((SELECT length(COALESCE(tiles.data, tile_blobs.data)) "
+             "  FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id "
+             "  WHERE tiles.id = NEW.tile_id), 0) "
+             "  WHERE region_id = NEW.region_id; "
+             "END");
+    db->exec("CREATE TRIGGER region_tiles_delete "
+             "AFTER DELETE ON region_tiles "
+             "BEGIN "
+             "  UPDATE region_status "
+             "  SET tile_count = tile_count - 1, "
+             "  tile_size  = tile_size - IFNULL((SELECT length(COALESCE(tiles.data, tile_blobs.data)) "
+             "  FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id "
+             "  WHERE tiles.id = OLD.tile_id), 0) "
+             "  WHERE region_id = OLD.region_id; "
+             "END");
+    db->exec("CREATE TRIGGER region_tiles_update "
+             "BEFORE UPDATE OF data, blob_id ON tiles "
+             "BEGIN "
+             "  UPDATE region_status "
+             "  SET tile_size = tile_size "
+             "  - IFNULL(length(COALESCE(OLD.data, (SELECT data FROM tile_blobs WHERE id = OLD.blob_id))), 0) "
+             "  + IFNULL(length(COALESCE(NEW.data, (SELECT data FROM tile_blobs WHERE id = NEW.blob_id))), 0) "
+             "  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = OLD.id); "
+             "END");
+    db->exec("INSERT INTO region_status "
+             "SELECT id, "
+             "       (SELECT COUNT(*) FROM region_resources WHERE region_id = regions.id), "
+             "       (SELECT IFNULL(SUM(length(data)), 0) FROM region_resources, resources "
+             "        WHERE region_id = regions.id AND resource_id = resources.id), "
+             "       (SELECT COUNT(*) FROM region_tiles WHERE region_id = regions.id), "
+             "       (SELECT IFNULL(SUM(length(COALESCE(tiles.data, tile_blobs.data))), 0) "
+             "        FROM region_tiles, tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id "
+             "        WHERE region_id = regions.id AND tile_id = tiles.id) "
+             "FROM regions");
+    db->exec("PRAGMA user_version = 9");
+    transaction.commit();
 }
 
 OfflineDatabase::Statement OfflineDatabase::getStatement(const char * sql) {
@@ -142,7 +333,26 @@ optional<Response> OfflineDatabase::get(const Resource& resource) {
     return result ? result->first : optional<Response>();
 }
 
+optional<Response> OfflineDatabase::read(const Resource& resource) {
+    auto result = readInternal(resource);
+    return result ? result->first : optional<Response>();
+}
+
+void OfflineDatabase::touch(const Resource& resource) {
+    if (resource.kind == Resource::Kind::Tile) {
+        assert(resource.tileData);
+        touchTile(*resource.tileData);
+    } else {
+        touchResource(resource);
+    }
+}
+
 optional<std::pair<Response, uint64_t>> OfflineDatabase::getInternal(const Resource& resource) {
+    touch(resource);
+    return readInternal(resource);
+}
+
+optional<std::pair<Response, uint64_t>> OfflineDatabase::readInternal(const Resource& resource) {
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         return getTile(*resource.tileData);
@@ -161,22 +371,63 @@ optional<int64_t> OfflineDatabase::hasInternal(const Resource& resource) {
 }
 
 std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const Response& response) {
+    setSynchronous(false);
     return putInternal(resource, response, true);
 }
 
+void OfflineDatabase::putBatch(const std::vector<std::pair<Resource, Response>>& responses,
+                               const std::vector<Resource>& used) {
+    setSynchronous(false);
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    batching = true;
+    try {
+        for (const auto& response : responses) {
+            putInternal(response.first, response.second, false);
+        }
+        for (const auto& resource : used) {
+            touch(resource);
+        }
+    } catch (...) {
+        batching = false;
+        throw;
+    }
+    batching = false;
+    transaction.commit();
+}
+
 std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource, const Response& response, bool evict_) {
     if (response.error) {
         return { false, 0 };
     }
 
     std::string compressedData;
-    bool compressed = false;
+    Compression compression = Compression::None;
     uint64_t size = 0;
 
     if (response.data) {
-        compressedData = util::compress(*response.data);
-        compressed = compressedData.size() < response.data->size();
-        size = compressed ? compressedData.size() : response.data->size();
+        const std::string* dictionary = nullptr;
+        if (resource.kind == Resource::Kind::Tile && response.data->size() > maximumSharedTileSize) {
+            assert(resource.tileData);
+            dictionary = getDictionary(resource.tileData->urlTemplate);
+            if (!dictionary) {
+                sampleDictionary(resource.tileData->urlTemplate, *response.data);
+            }
+        }
+
+        // Tiles of sources that don't have much in common get an empty dictionary.
+        if (dictionary && !dictionary->empty()) {
+            compressedData = util::compressWithDictionary(*response.data, *dictionary);
+            compression = Compression::DeflateWithDictionary;
+        } else {
+            compressedData = util::compress(*response.data);
+            compression = Compression::Deflate;
+        }
+
+        if (compressedData.size() >= response.data->size()) {
+            compression = Compression::None;
+        }
+        size = compression != Compression::None ? compressedData.size() : response.data->size();
     }
 
     if (evict_ && !evict(size)) {
@@ -189,27 +440,31 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
         inserted = putTile(*resource.tileData, response,
-                compressed ? compressedData : *response.data,
-                compressed);
+                compression != Compression::None ? compressedData : *response.data,
+                compression);
     } else {
         inserted = putResource(resource, response,
-                compressed ? compressedData : *response.data,
-                compressed);
+                compression != Compression::None ? compressedData : *response.data,
+                compression);
     }
 
     return { inserted, size };
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
+void OfflineDatabase::touchResource(const Resource& resource) {
     // clang-format off
     Statement accessedStmt = getStatement(
-        "UPDATE resources SET accessed = ?1 WHERE url = ?2");
+        "UPDATE resources SET accessed = ?1 WHERE url = ?2 AND accessed < ?3");
     // clang-format on
 
-    accessedStmt->bind(1, util::now());
+    const Timestamp now = util::now();
+    accessedStmt->bind(1, now);
     accessedStmt->bind(2, resource.url);
+    accessedStmt->bind(3, now - accessedGranularity);
     accessedStmt->run();
+}
 
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
     // clang-format off
     Statement stmt = getStatement(
         //        0      1        2       3        4
@@ -231,15 +486,16 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resou
     response.expires  = stmt->get<optional<Timestamp>>(1);
     response.modified = stmt->get<optional<Timestamp>>(2);
 
-    optional<std::string> data = stmt->get<optional<std::string>>(3);
+    // Read straight out of SQLite's buffer, so the blob is only copied once, into the response.
+    auto data = stmt->get<optional<std::pair<const char*, std::size_t>>>(3);
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
+    } else if (stmt->get<int>(4) != int(Compression::None)) {
+        response.data = std::make_shared<std::string>(util::decompress(data->first, data->second));
+        size = data->second;
     } else {
-        response.data = std::make_shared<std::string>(*data);
-        size = data->length();
+        response.data = std::make_shared<std::string>(data->first, data->second);
+        size = data->second;
     }
 
     return std::make_pair(response, size);
@@ -261,7 +517,7 @@ optional<int64_t> OfflineDatabase::hasResource(const Resource& resource) {
 bool OfflineDatabase::putResource(const Resource& resource,
                                   const Response& response,
                                   const std::string& data,
-                                  bool compressed) {
+                                  Compression compression) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -281,8 +537,11 @@ bool OfflineDatabase::putResource(const Resource& resource,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment, unless the batch began one already.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!batching) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -306,15 +565,17 @@ bool OfflineDatabase::putResource(const Resource& resource,
 
     if (response.noContent) {
         update->bind(6, nullptr);
-        update->bind(7, false);
+        update->bind(7, int(Compression::None));
     } else {
         update->bindBlob(6, data.data(), data.size(), false);
-        update->bind(7, compressed);
+        update->bind(7, int(compression));
     }
 
     update->run();
     if (db->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
@@ -333,19 +594,21 @@ bool OfflineDatabase::putResource(const Resource& resource,
 
     if (response.noContent) {
         insert->bind(7, nullptr);
-        insert->bind(8, false);
+        insert->bind(8, int(Compression::None));
     } else {
         insert->bindBlob(7, data.data(), data.size(), false);
-        insert->bind(8, compressed);
+        insert->bind(8, int(compression));
     }
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
 
-optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
+void OfflineDatabase::touchTile(const Resource::TileData& tile) {
     // clang-format off
     Statement accessedStmt = getStatement(
         "UPDATE tiles "
@@ -354,22 +617,27 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         "  AND pixel_ratio  = ?3 "
         "  AND x            = ?4 "
         "  AND y            = ?5 "
-        "  AND z            = ?6 ");
+        "  AND z            = ?6 "
+        "  AND accessed     < ?7 ");
     // clang-format on
 
-    accessedStmt->bind(1, util::now());
+    const Timestamp now = util::now();
+    accessedStmt->bind(1, now);
     accessedStmt->bind(2, tile.urlTemplate);
     accessedStmt->bind(3, tile.pixelRatio);
     accessedStmt->bind(4, tile.x);
     accessedStmt->bind(5, tile.y);
     accessedStmt->bind(6, tile.z);
+    accessedStmt->bind(7, now - accessedGranularity);
     accessedStmt->run();
+}
 
+optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
     // clang-format off
     Statement stmt = getStatement(
-        //        0      1        2       3        4
-        "SELECT etag, expires, modified, data, compressed "
-        "FROM tiles "
+        //        0      1        2                    3                        4
+        "SELECT etag, expires, modified, COALESCE(tiles.data, tile_blobs.data), tiles.compressed "
+        "FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id "
         "WHERE url_template = ?1 "
         "  AND pixel_ratio  = ?2 "
         "  AND x            = ?3 "
@@ -394,25 +662,77 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     response.expires  = stmt->get<optional<Timestamp>>(1);
     response.modified = stmt->get<optional<Timestamp>>(2);
 
-    optional<std::string> data = stmt->get<optional<std::string>>(3);
+    // Read straight out of SQLite's buffer, so the blob is only copied once, into the response.
+    auto data = stmt->get<optional<std::pair<const char*, std::size_t>>>(3);
+    const auto compression = Compression(stmt->get<int>(4));
     if (!data) {
         response.noContent = true;
-    } else if (stmt->get<int>(4)) {
-        response.data = std::make_shared<std::string>(util::decompress(*data));
-        size = data->length();
+    } else if (compression == Compression::DeflateWithDictionary) {
+        // The dictionary is read with a statement of its own, so the data stays valid.
+        const std::string* dictionary = getDictionary(tile.urlTemplate);
+        if (!dictionary) {
+            throw std::runtime_error("missing tile compression dictionary");
+        }
+        response.data = std::make_shared<std::string>(
+            util::decompressWithDictionary(data->first, data->second, *dictionary));
+        size = data->second;
+    } else if (compression != Compression::None) {
+        response.data = std::make_shared<std::string>(util::decompress(data->first, data->second));
+        size = data->second;
     } else {
-        response.data = std::make_shared<std::string>(*data);
-        size = data->length();
+        response.data = std::make_shared<std::string>(data->first, data->second);
+        size = data->second;
     }
 
     return std::make_pair(response, size);
 }
 
+const std::string* OfflineDatabase::getDictionary(const std::string& urlTemplate) {
+    auto it = dictionaries.find(urlTemplate);
+    if (it != dictionaries.end()) {
+        return &it->second;
+    }
+
+    // clang-format off
+    Statement stmt = getStatement(
+        "SELECT data FROM tile_dictionaries WHERE url_template = ?1");
+    // clang-format on
+
+    stmt->bind(1, urlTemplate);
+    if (!stmt->run()) {
+        return nullptr;
+    }
+
+    return &dictionaries.emplace(urlTemplate, stmt->get<std::string>(0)).first->second;
+}
+
+void OfflineDatabase::sampleDictionary(const std::string& urlTemplate, const std::string& data) {
+    std::vector<std::string>& samples = dictionarySamples[urlTemplate];
+    samples.push_back(data.substr(0, maximumDictionarySampleSize));
+    if (samples.size() < dictionarySampleCount) {
+        return;
+    }
+
+    const std::string dictionary = util::trainDictionary(samples);
+    dictionarySamples.erase(urlTemplate);
+
+    // Another connection may have stored a dictionary for the template in the meantime, which
+    // the tiles it wrote are compressed with already. The next put reads back whichever one won.
+    // clang-format off
+    Statement insert = getStatement(
+        "INSERT OR IGNORE INTO tile_dictionaries (url_template, data) VALUES (?1, ?2)");
+    // clang-format on
+
+    insert->bind(1, urlTemplate);
+    insert->bindBlob(2, dictionary.data(), dictionary.size(), false);
+    insert->run();
+}
+
 optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
     // clang-format off
     Statement stmt = getStatement(
-        "SELECT length(data) "
-        "FROM tiles "
+        "SELECT length(COALESCE(tiles.data, tile_blobs.data)) "
+        "FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id "
         "WHERE url_template = ?1 "
         "  AND pixel_ratio  = ?2 "
         "  AND x            = ?3 "
@@ -436,7 +756,7 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              Compression compression) {
     if (response.notModified) {
         // clang-format off
         Statement update = getStatement(
@@ -464,8 +784,17 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     // We can't use REPLACE because it would change the id value.
 
     // Begin an immediate-mode transaction to ensure that two writers do not attempt
-    // to INSERT a resource at the same moment.
-    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    // to INSERT a resource at the same moment, unless the batch began one already.
+    optional<mapbox::sqlite::Transaction> transaction;
+    if (!batching) {
+        transaction.emplace(*db, mapbox::sqlite::Transaction::Immediate);
+    }
+
+    optional<int64_t> blobID;
+    if (!response.noContent && compression != Compression::DeflateWithDictionary &&
+        data.size() <= maximumSharedTileSize) {
+        blobID = putBlob(data, compression);
+    }
 
     // clang-format off
     Statement update = getStatement(
@@ -475,7 +804,8 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         "    expires        = ?3, "
         "    accessed       = ?4, "
         "    data           = ?5, "
-        "    compressed     = ?6 "
+        "    compressed     = ?6, "
+        "    blob_id        = ?12 "
         "WHERE url_template = ?7 "
         "  AND pixel_ratio  = ?8 "
         "  AND x            = ?9 "
@@ -495,22 +825,30 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
     if (response.noContent) {
         update->bind(5, nullptr);
-        update->bind(6, false);
+        update->bind(6, int(Compression::None));
+        update->bind(12, nullptr);
+    } else if (blobID) {
+        update->bind(5, nullptr);
+        update->bind(6, int(compression));
+        update->bind(12, *blobID);
     } else {
         update->bindBlob(5, data.data(), data.size(), false);
-        update->bind(6, compressed);
+        update->bind(6, int(compression));
+        update->bind(12, nullptr);
     }
 
     update->run();
     if (db->changes() != 0) {
-        transaction.commit();
+        if (transaction) {
+            transaction->commit();
+        }
         return false;
     }
 
     // clang-format off
     Statement insert = getStatement(
-        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified,  etag,  expires,  accessed,  data, compressed) "
-        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,        ?7,    ?8,       ?9,        ?10,  ?11) ");
+        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified,  etag,  expires,  accessed,  data, compressed, blob_id) "
+        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,        ?7,    ?8,       ?9,        ?10,  ?11,        ?12) ");
     // clang-format on
 
     insert->bind(1, tile.urlTemplate);
@@ -525,18 +863,56 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
     if (response.noContent) {
         insert->bind(10, nullptr);
-        insert->bind(11, false);
+        insert->bind(11, int(Compression::None));
+        insert->bind(12, nullptr);
+    } else if (blobID) {
+        insert->bind(10, nullptr);
+        insert->bind(11, int(compression));
+        insert->bind(12, *blobID);
     } else {
         insert->bindBlob(10, data.data(), data.size(), false);
-        insert->bind(11, compressed);
+        insert->bind(11, int(compression));
+        insert->bind(12, nullptr);
     }
 
     insert->run();
-    transaction.commit();
+    if (transaction) {
+        transaction->commit();
+    }
 
     return true;
 }
 
+int64_t OfflineDatabase::putBlob(const std::string& data, Compression compression) {
+    const int64_t hash = blobHash(data);
+
+    // clang-format off
+    Statement select = getStatement(
+        "SELECT id, data FROM tile_blobs WHERE hash = ?1 AND compressed = ?2");
+    // clang-format on
+
+    select->bind(1, hash);
+    select->bind(2, int(compression));
+    while (select->run()) {
+        auto blob = select->get<optional<std::pair<const char*, std::size_t>>>(1);
+        if (blob && blob->second == data.size() && std::equal(data.begin(), data.end(), blob->first)) {
+            return select->get<int64_t>(0);
+        }
+    }
+
+    // clang-format off
+    Statement insert = getStatement(
+        "INSERT INTO tile_blobs (hash, data, compressed) VALUES (?1, ?2, ?3)");
+    // clang-format on
+
+    insert->bind(1, hash);
+    insert->bindBlob(2, data.data(), data.size(), false);
+    insert->bind(3, int(compression));
+    insert->run();
+
+    return db->lastInsertRowid();
+}
+
 std::vector<OfflineRegion> OfflineDatabase::listRegions() {
     // clang-format off
     Statement stmt = getStatement(
@@ -557,6 +933,8 @@ std::vector<OfflineRegion> OfflineDatabase::listRegions() {
 
 OfflineRegion OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
                                             const OfflineRegionMetadata& metadata) {
+    setSynchronous(true);
+
     // clang-format off
     Statement stmt = getStatement(
         "INSERT INTO regions (definition, description) "
@@ -571,6 +949,8 @@ OfflineRegion OfflineDatabase::createRegion(const OfflineRegionDefinition& defin
 }
 
 OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, const OfflineRegionMetadata& metadata) {
+    setSynchronous(true);
+
     // clang-format off
     Statement stmt = getStatement(
                                   "UPDATE regions SET description = ?1"
@@ -584,6 +964,8 @@ OfflineRegionMetadata OfflineDatabase::updateMetadata(const int64_t regionID, co
 }
 
 void OfflineDatabase::deleteRegion(OfflineRegion&& region) {
+    setSynchronous(true);
+
     // clang-format off
     Statement stmt = getStatement(
         "DELETE FROM regions WHERE id = ?");
@@ -619,7 +1001,135 @@ optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Res
     return response;
 }
 
+std::vector<optional<int64_t>> OfflineDatabase::hasRegionResources(int64_t regionID,
+                                                                    const std::vector<Resource>& resources) {
+    setSynchronous(true);
+
+    std::vector<optional<int64_t>> result;
+    result.reserve(resources.size());
+
+    // Tiles are looked up together, with a query for each zoom level of each source, so that
+    // resuming the download of a large region doesn't look them up one by one.
+    std::map<std::tuple<std::string, uint8_t, int8_t>, std::vector<std::size_t>> tiles;
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    for (std::size_t i = 0; i < resources.size(); i++) {
+        const Resource& resource = resources[i];
+        if (resource.kind == Resource::Kind::Tile) {
+            assert(resource.tileData);
+            const Resource::TileData& tile = *resource.tileData;
+            tiles[std::make_tuple(tile.urlTemplate, tile.pixelRatio, tile.z)].push_back(i);
+            result.emplace_back();
+        } else {
+            result.push_back(hasRegionResource(regionID, resource));
+        }
+    }
+    for (const auto& zoom : tiles) {
+        hasRegionTiles(regionID, resources, zoom.second, result);
+    }
+    transaction.commit();
+
+    return result;
+}
+
+void OfflineDatabase::hasRegionTiles(int64_t regionID,
+                                     const std::vector<Resource>& resources,
+                                     const std::vector<std::size_t>& indices,
+                                     std::vector<optional<int64_t>>& result) {
+    const Resource::TileData& first = *resources[indices.front()].tileData;
+    int32_t minX = first.x;
+    int32_t maxX = first.x;
+    int32_t minY = first.y;
+    int32_t maxY = first.y;
+    for (std::size_t i : indices) {
+        const Resource::TileData& tile = *resources[i].tileData;
+        minX = std::min(minX, tile.x);
+        maxX = std::max(maxX, tile.x);
+        minY = std::min(minY, tile.y);
+        maxY = std::max(maxY, tile.y);
+    }
+
+    // clang-format off
+    Statement select = getStatement(
+        "SELECT tiles.id, x, y, length(COALESCE(tiles.data, tile_blobs.data)) "
+        "FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id "
+        "WHERE url_template = ?1 "
+        "  AND pixel_ratio  = ?2 "
+        "  AND z            = ?3 "
+        "  AND x BETWEEN ?4 AND ?5 "
+        "  AND y BETWEEN ?6 AND ?7 ");
+    // clang-format on
+
+    select->bind(1, first.urlTemplate);
+    select->bind(2, first.pixelRatio);
+    select->bind(3, first.z);
+    select->bind(4, minX);
+    select->bind(5, maxX);
+    select->bind(6, minY);
+    select->bind(7, maxY);
+
+    // The stored tiles in the range, by column and row, with their IDs. Tiles without content
+    // are requested again, like hasRegionResource() has them.
+    std::map<std::pair<int32_t, int32_t>, std::pair<int64_t, int64_t>> stored;
+    while (select->run()) {
+        optional<int64_t> size = select->get<optional<int64_t>>(3);
+        if (size) {
+            stored.emplace(std::make_pair(select->get<int>(1), select->get<int>(2)),
+                           std::make_pair(select->get<int64_t>(0), *size));
+        }
+    }
+
+    // clang-format off
+    Statement insert = getStatement(
+        "INSERT OR IGNORE INTO region_tiles (region_id, tile_id) VALUES (?1, ?2)");
+    // clang-format on
+
+    for (std::size_t i : indices) {
+        const Resource::TileData& tile = *resources[i].tileData;
+        auto it = stored.find({ tile.x, tile.y });
+        if (it == stored.end()) {
+            continue;
+        }
+        result[i] = it->second.second;
+
+        insert->bind(1, regionID);
+        insert->bind(2, it->second.first);
+        insert->run();
+        insert->reset();
+    }
+}
+
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) {
+    setSynchronous(true);
+    return putRegionResourceInternal(regionID, resource, response);
+}
+
+std::vector<uint64_t> OfflineDatabase::putRegionResources(int64_t regionID,
+                                                          const std::vector<std::pair<Resource, Response>>& responses) {
+    setSynchronous(true);
+
+    std::vector<uint64_t> result;
+    result.reserve(responses.size());
+
+    mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+    batching = true;
+    try {
+        for (const auto& response : responses) {
+            result.push_back(putRegionResourceInternal(regionID, response.first, response.second));
+        }
+    } catch (...) {
+        batching = false;
+        // The count of the region's tiles may have been raised for tiles that were rolled back.
+        offlineMapboxTileCount = {};
+        throw;
+    }
+    batching = false;
+    transaction.commit();
+
+    return result;
+}
+
+uint64_t OfflineDatabase::putRegionResourceInternal(int64_t regionID, const Resource& resource, const Response& response) {
     uint64_t size = putInternal(resource, response, false).second;
     bool previouslyUnused = markUsed(regionID, resource);
 
@@ -664,7 +1174,8 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
         Statement select = getStatement(
             "SELECT region_id "
             "FROM region_tiles, tiles "
-            "WHERE region_id   != ?1 "
+            "WHERE tile_id      = tiles.id "
+            "  AND region_id   != ?1 "
             "  AND url_template = ?2 "
             "  AND pixel_ratio  = ?3 "
             "  AND x            = ?4 "
@@ -701,7 +1212,8 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
         Statement select = getStatement(
             "SELECT region_id "
             "FROM region_resources, resources "
-            "WHERE region_id    != ?1 "
+            "WHERE resource_id   = resources.id "
+            "  AND region_id    != ?1 "
             "  AND resources.url = ?2 "
             "LIMIT 1 ");
         // clang-format on
@@ -724,44 +1236,130 @@ OfflineRegionDefinition OfflineDatabase::getRegionDefinition(int64_t regionID) {
     return decodeOfflineRegionDefinition(stmt->get<std::string>(0));
 }
 
-OfflineRegionStatus OfflineDatabase::getRegionCompletedStatus(int64_t regionID) {
-    OfflineRegionStatus result;
+void OfflineDatabase::exportRegion(int64_t regionID, const std::string& packPath) {
+    OfflinePackWriter pack(packPath);
+
+    // clang-format off
+    Statement resources = getStatement(
+        "SELECT kind, url "
+        "FROM region_resources, resources "
+        "WHERE region_id   = ?1 "
+        "  AND resource_id = resources.id ");
+    // clang-format on
+
+    resources->bind(1, regionID);
+    while (resources->run()) {
+        const Resource resource { Resource::Kind(resources->get<int>(0)), resources->get<std::string>(1) };
+        if (auto response = readInternal(resource)) {
+            pack.add(resource, response->first);
+        }
+    }
 
-    std::tie(result.completedResourceCount, result.completedResourceSize)
-        = getCompletedResourceCountAndSize(regionID);
-    std::tie(result.completedTileCount, result.completedTileSize)
-        = getCompletedTileCountAndSize(regionID);
+    // clang-format off
+    Statement tiles = getStatement(
+        "SELECT url_template, pixel_ratio, x, y, z "
+        "FROM region_tiles, tiles "
+        "WHERE region_id = ?1 "
+        "  AND tile_id   = tiles.id ");
+    // clang-format on
 
-    result.completedResourceCount += result.completedTileCount;
-    result.completedResourceSize += result.completedTileSize;
+    tiles->bind(1, regionID);
+    while (tiles->run()) {
+        const Resource resource = Resource::tile(tiles->get<std::string>(0),
+                                                 tiles->get<int>(1),
+                                                 tiles->get<int>(2),
+                                                 tiles->get<int>(3),
+                                                 tiles->get<int>(4),
+                                                 Tileset::Scheme::XYZ);
+        if (auto response = readInternal(resource)) {
+            pack.add(resource, response->first);
+        }
+    }
 
-    return result;
+    pack.finish();
 }
 
-std::pair<int64_t, int64_t> OfflineDatabase::getCompletedResourceCountAndSize(int64_t regionID) {
+OfflineRegionStatus OfflineDatabase::getRegionCompletedStatus(int64_t regionID) {
     // clang-format off
     Statement stmt = getStatement(
-        "SELECT COUNT(*), SUM(LENGTH(data)) "
-        "FROM region_resources, resources "
-        "WHERE region_id = ?1 "
-        "AND resource_id = resources.id ");
+        "SELECT resource_count, resource_size, tile_count, tile_size "
+        "FROM region_status "
+        "WHERE region_id = ?1 ");
     // clang-format on
+
     stmt->bind(1, regionID);
-    stmt->run();
-    return { stmt->get<int64_t>(0), stmt->get<int64_t>(1) };
+
+    OfflineRegionStatus result;
+    if (stmt->run()) {
+        result.completedTileCount = stmt->get<int64_t>(2);
+        result.completedTileSize = stmt->get<int64_t>(3);
+        result.completedResourceCount = stmt->get<int64_t>(0) + result.completedTileCount;
+        result.completedResourceSize = stmt->get<int64_t>(1) + result.completedTileSize;
+    }
+
+    return result;
 }
 
-std::pair<int64_t, int64_t> OfflineDatabase::getCompletedTileCountAndSize(int64_t regionID) {
+std::vector<Resource> OfflineDatabase::getRegionExpiredResources(int64_t regionID,
+                                                                 ExpiredResourcesCursor& cursor,
+                                                                 std::size_t limit) {
+    // Resources and tiles are listed together, by the time they were used, and then by table
+    // and ID, so that the cursor moves past them even if they were used at the same time.
     // clang-format off
     Statement stmt = getStatement(
-        "SELECT COUNT(*), SUM(LENGTH(data)) "
-        "FROM region_tiles, tiles "
-        "WHERE region_id = ?1 "
-        "AND tile_id = tiles.id ");
+        "SELECT * FROM ( "
+        "    SELECT accessed, 0 AS source, resources.id AS id, kind, url, "
+        "           NULL, NULL, NULL, NULL, etag, expires, modified "
+        "    FROM region_resources, resources "
+        "    WHERE region_id   = ?1 "
+        "      AND resource_id = resources.id "
+        "      AND expires     < ?2 "
+        "    UNION ALL "
+        "    SELECT accessed, 1 AS source, tiles.id AS id, NULL, url_template, "
+        "           pixel_ratio, x, y, z, etag, expires, modified "
+        "    FROM region_tiles, tiles "
+        "    WHERE region_id = ?1 "
+        "      AND tile_id   = tiles.id "
+        "      AND expires   < ?2 "
+        ") "
+        "WHERE accessed < ?3 "
+        "   OR (accessed = ?3 AND (source < ?4 OR (source = ?4 AND id < ?5))) "
+        "ORDER BY accessed DESC, source DESC, id DESC "
+        "LIMIT ?6 ");
     // clang-format on
+
     stmt->bind(1, regionID);
-    stmt->run();
-    return { stmt->get<int64_t>(0), stmt->get<int64_t>(1) };
+    stmt->bind(2, util::now());
+    stmt->bind(3, cursor.accessed);
+    stmt->bind(4, cursor.source);
+    stmt->bind(5, cursor.id);
+    stmt->bind(6, int64_t(limit));
+
+    std::vector<Resource> result;
+    while (stmt->run()) {
+        cursor.accessed = stmt->get<Timestamp>(0);
+        cursor.source = stmt->get<int>(1);
+        cursor.id = stmt->get<int64_t>(2);
+
+        optional<Resource> resource;
+        if (cursor.source == 0) {
+            resource = Resource(Resource::Kind(stmt->get<int>(3)), stmt->get<std::string>(4));
+        } else {
+            // The stored row is the one in the URL already, so the tile is rebuilt as an XYZ tile.
+            resource = Resource::tile(stmt->get<std::string>(4),
+                                      stmt->get<int>(5),
+                                      stmt->get<int>(6),
+                                      stmt->get<int>(7),
+                                      stmt->get<int>(8),
+                                      Tileset::Scheme::XYZ);
+        }
+        resource->priorEtag = stmt->get<optional<std::string>>(9);
+        resource->priorExpires = stmt->get<optional<Timestamp>>(10);
+        resource->priorModified = stmt->get<optional<Timestamp>>(11);
+        result.push_back(std::move(*resource));
+    }
+
+    return result;
 }
 
 template <class T>
@@ -781,51 +1379,19 @@ T OfflineDatabase::getPragma(const char * sql) {
 // and as it approaches to the hard limit (i.e. the actual file size) we
 // delete an arbitrary number of old cache entries. The free pages approach saves
 // us from calling VACCUM or keeping a running total, which can be costly.
+uint64_t OfflineDatabase::usedSize() {
+    // Pages on the free list are reused before the database grows.
+    return getPragma<int64_t>("PRAGMA page_size") *
+           (getPragma<int64_t>("PRAGMA page_count") - getPragma<int64_t>("PRAGMA freelist_count"));
+}
+
 bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
-    uint64_t pageCount = getPragma<int64_t>("PRAGMA page_count");
-
-    auto usedSize = [&] {
-        return pageSize * (pageCount - getPragma<int64_t>("PRAGMA freelist_count"));
-    };
 
     // The addition of pageSize is a fudge factor to account for non `data` column
     // size, and because pages can get fragmented on the database.
     while (usedSize() + neededFreeSize + pageSize > maximumCacheSize) {
-        // clang-format off
-        Statement stmt1 = getStatement(
-            "DELETE FROM resources "
-            "WHERE id IN ( "
-            "  SELECT id FROM resources "
-            "  LEFT JOIN region_resources "
-            "  ON resource_id = resources.id "
-            "  WHERE resource_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") ");
-        // clang-format on
-        stmt1->bind(1, 50);
-        stmt1->run();
-        uint64_t changes1 = db->changes();
-
-        // clang-format off
-        Statement stmt2 = getStatement(
-            "DELETE FROM tiles "
-            "WHERE id IN ( "
-            "  SELECT id FROM tiles "
-            "  LEFT JOIN region_tiles "
-            "  ON tile_id = tiles.id "
-            "  WHERE tile_id IS NULL "
-            "  ORDER BY accessed ASC LIMIT ?1 "
-            ") ");
-        // clang-format on
-        stmt2->bind(1, 50);
-        stmt2->run();
-        uint64_t changes2 = db->changes();
-
-        // The cached value of offlineTileCount does not need to be updated
-        // here because only non-offline tiles can be removed by eviction.
-
-        if (changes1 == 0 && changes2 == 0) {
+        if (!evictLeastRecentlyUsed()) {
             return false;
         }
     }
@@ -833,40 +1399,86 @@ bool OfflineDatabase::evict(uint64_t neededFreeSize) {
     return true;
 }
 
-void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
-    offlineMapboxTileCountLimit = limit;
-}
+bool OfflineDatabase::evictIncrementally(Duration timeLimit) {
+    const TimePoint start = Clock::now();
+    setSynchronous(false);
 
-uint64_t OfflineDatabase::getOfflineMapboxTileCountLimit() {
-    return offlineMapboxTileCountLimit;
-}
+    uint64_t pageSize = getPragma<int64_t>("PRAGMA page_size");
+    while (usedSize() + pageSize > maximumCacheSize) {
+        if (Clock::now() - start >= timeLimit) {
+            return true;
+        }
 
-bool OfflineDatabase::offlineMapboxTileCountLimitExceeded() {
-    return getOfflineMapboxTileCount() >= offlineMapboxTileCountLimit;
-}
+        // Each batch commits on its own, so that the other connections don't wait for
+        // the whole eviction.
+        mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
+        const bool evicted = evictLeastRecentlyUsed();
+        transaction.commit();
+        if (!evicted) {
+            break;
+        }
+        vacuumPending = true;
+    }
 
-uint64_t OfflineDatabase::getOfflineMapboxTileCount() {
-    // Calculating this on every call would be much simpler than caching and
-    // manually updating the value, but it would make offline downloads an O(n²)
-    // operation, because the database query below involves an index scan of
-    // region_tiles.
+    // Then gives the space that was freed back to the file system, a few pages at a time.
+    int64_t freePages = getPragma<int64_t>("PRAGMA freelist_count");
+    while (vacuumPending && freePages > 0) {
+        if (Clock::now() - start >= timeLimit) {
+            return true;
+        }
+        db->exec("PRAGMA incremental_vacuum(64)");
 
-    if (offlineMapboxTileCount) {
-        return *offlineMapboxTileCount;
+        // Vacuuming does nothing on databases without auto vacuum.
+        const int64_t remaining = getPragma<int64_t>("PRAGMA freelist_count");
+        if (remaining >= freePages) {
+            break;
+        }
+        freePages = remaining;
     }
+    vacuumPending = false;
 
+    return false;
+}
+
+bool OfflineDatabase::evictLeastRecentlyUsed() {
     // clang-format off
-    Statement stmt = getStatement(
-        "SELECT COUNT(DISTINCT id) "
-        "FROM region_tiles, tiles "
-        "WHERE tile_id = tiles.id "
-        "AND url_template LIKE 'mapbox://%' ");
+    Statement stmt1 = getStatement(
+        "DELETE FROM resources "
+        "WHERE id IN ( "
+        "  SELECT id FROM resources "
+        "  LEFT JOIN region_resources "
+        "  ON resource_id = resources.id "
+        "  WHERE resource_id IS NULL "
+        "  ORDER BY accessed ASC LIMIT ?1 "
+        ") ");
     // clang-format on
+    stmt1->bind(1, 50);
+    stmt1->run();
+    uint64_t changes1 = db->changes();
 
-    stmt->run();
+    // clang-format off
+    Statement stmt2 = getStatement(
+        "DELETE FROM tiles "
+        "WHERE id IN ( "
+        "  SELECT id FROM tiles "
+        "  LEFT JOIN region_tiles "
+        "  ON tile_id = tiles.id "
+        "  WHERE tile_id IS NULL "
+        "  ORDER BY accessed ASC LIMIT ?1 "
+        ") ");
+    // clang-format on
+    stmt2->bind(1, 50);
+    stmt2->run();
+    uint64_t changes2 = db->changes();
+
+    // The cached value of offlineTileCount does not need to be updated
+    // here because only non-offline tiles can be removed by eviction.
+
+    return changes1 != 0 || changes2 != 0;
+}
 
-    offlineMapboxTileCount = stmt->get<int64_t>(0);
-    return *offlineMapboxTileCount;
+std::size_t OfflineDatabase::getMemoryUsage() const {
+    return db ? db->cacheMemoryUsed() : 0;
 }
 
 } // namespace mbgl
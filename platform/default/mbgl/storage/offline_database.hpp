@@ -4,12 +4,16 @@
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 
+#include <limits>
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -28,13 +32,41 @@ public:
     // Limits affect ambient caching (put) only; resources required by offline
     // regions are exempt.
     OfflineDatabase(std::string path, uint64_t maximumCacheSize = util::DEFAULT_MAX_CACHE_SIZE);
+
+    // Opens another connection to an existing database that only reads from it. In WAL mode,
+    // reads on it don't wait for the writes of other connections.
+    struct ReadOnly {};
+    OfflineDatabase(std::string path, ReadOnly);
+
     ~OfflineDatabase();
 
     optional<Response> get(const Resource&);
 
+    // Like get(), but leaves marking the resource as recently used to touch(), so that it
+    // works on read-only connections. Resources that were marked recently aren't marked again.
+    optional<Response> read(const Resource&);
+    void touch(const Resource&);
+
     // Return value is (inserted, stored size)
+    //
+    // Ambient caching trades durability for throughput: it commits without syncing the
+    // write-ahead log, so a crash may lose the latest puts, but doesn't corrupt the database.
+    // Writes to offline regions are synced.
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // Like put() and touch() for each of them, but in one transaction, which saves committing
+    // each write on its own. Leaves making space for the puts to evictIncrementally().
+    void putBatch(const std::vector<std::pair<Resource, Response>>&, const std::vector<Resource>& used);
+
+    // Evicts the least recently used ambient resources, in batches, until the cache fits in its
+    // maximum size, and then vacuums the space they took up. Stops once it took about as long
+    // as the limit, and returns whether there's more to do.
+    bool evictIncrementally(Duration timeLimit);
+
+    // Applies the changes in the write-ahead log to the database without waiting for readers,
+    // so that the log doesn't keep growing between the bursts of puts.
+    void checkpoint();
+
     std::vector<OfflineRegion> listRegions();
 
     OfflineRegion createRegion(const OfflineRegionDefinition&,
@@ -49,6 +81,33 @@ public:
     optional<int64_t> hasRegionResource(int64_t regionID, const Resource&);
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
 
+    // Like hasRegionResource() and putRegionResource() for each of them, but in one transaction,
+    // which saves committing the marks of use and the writes of a region one by one.
+    std::vector<optional<int64_t>> hasRegionResources(int64_t regionID, const std::vector<Resource>&);
+    std::vector<uint64_t> putRegionResources(int64_t regionID, const std::vector<std::pair<Resource, Response>>&);
+
+    // Where a walk through the expired resources of a region is up to. It goes from the most
+    // recently used resources to the least, starting at the ones used by the given time.
+    class ExpiredResourcesCursor {
+    public:
+        explicit ExpiredResourcesCursor(Timestamp since) : accessed(since) {}
+
+    private:
+        friend class OfflineDatabase;
+        Timestamp accessed;
+        int source = 2;
+        int64_t id = std::numeric_limits<int64_t>::max();
+    };
+
+    // The next `limit` expired resources of the region, with the etag, modification and expiry
+    // time they were stored with. Resources that are used or revalidated during the walk move
+    // behind the cursor, so they aren't listed twice.
+    std::vector<Resource> getRegionExpiredResources(int64_t regionID, ExpiredResourcesCursor&, std::size_t limit);
+
+    // Writes the resources and tiles of the region into a pack at the path, for OfflinePack to
+    // read. Throws std::runtime_error if the pack can't be written.
+    void exportRegion(int64_t regionID, const std::string& packPath);
+
     OfflineRegionDefinition getRegionDefinition(int64_t regionID);
     OfflineRegionStatus getRegionCompletedStatus(int64_t regionID);
 
@@ -57,13 +116,20 @@ public:
     bool offlineMapboxTileCountLimitExceeded();
     uint64_t getOfflineMapboxTileCount();
 
+    // The memory held by the page cache of the database connection, in bytes.
+    std::size_t getMemoryUsage() const;
+
 private:
     void connect(int flags);
+    void setSynchronous(bool);
     int userVersion();
     void ensureSchema();
     void removeExisting();
     void migrateToVersion3();
-    void migrateToVersion5();
+    void migrateToVersion6();
+    void migrateToVersion7();
+    void migrateToVersion8();
+    void migrateToVersion9();
 
     class Statement {
     public:
@@ -80,25 +146,48 @@ private:
 
     Statement getStatement(const char *);
 
+    // The values of the `compressed` column of tiles and resources.
+    enum class Compression : int {
+        None = 0,
+        Deflate = 1,
+        // Deflated with the dictionary of the tile's URL template.
+        DeflateWithDictionary = 2,
+    };
+
+    // The dictionary that the tiles of the URL template are compressed with, if it was trained
+    // already. It's trained on the first tiles of the template that are stored, which are kept
+    // as samples in the meantime.
+    const std::string* getDictionary(const std::string& urlTemplate);
+    void sampleDictionary(const std::string& urlTemplate, const std::string& data);
+
     optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
+    void touchTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, Compression);
+    // The ID of the blob with the data, which is stored if there's none yet.
+    int64_t putBlob(const std::string& data, Compression);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
+    void touchResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
     bool putResource(const Resource&, const Response&,
-                     const std::string&, bool compressed);
+                     const std::string&, Compression);
 
     optional<std::pair<Response, uint64_t>> getInternal(const Resource&);
+    optional<std::pair<Response, uint64_t>> readInternal(const Resource&);
     optional<int64_t> hasInternal(const Resource&);
     std::pair<bool, uint64_t> putInternal(const Resource&, const Response&, bool evict);
 
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
+    uint64_t putRegionResourceInternal(int64_t regionID, const Resource&, const Response&);
+
+    // Fills in the stored sizes of the tiles at the indices, of the same zoom level of the same
+    // source, and marks them as used by the region.
+    void hasRegionTiles(int64_t regionID, const std::vector<Resource>&,
+                        const std::vector<std::size_t>& indices, std::vector<optional<int64_t>>&);
 
-    std::pair<int64_t, int64_t> getCompletedResourceCountAndSize(int64_t regionID);
-    std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
     const std::string path;
     std::unique_ptr<::mapbox::sqlite::Database> db;
@@ -109,10 +198,26 @@ private:
 
     uint64_t maximumCacheSize;
 
+    // Whether the connection syncs on every commit.
+    bool synchronous = true;
+
+    // Whether the puts are part of a batch, which is in a transaction already.
+    bool batching = false;
+
+    // The dictionaries of URL templates, once they're read, and the samples of those that don't
+    // have one yet. Dictionaries don't change once they're stored, so they're safe to keep.
+    std::unordered_map<std::string, std::string> dictionaries;
+    std::unordered_map<std::string, std::vector<std::string>> dictionarySamples;
+
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
     optional<uint64_t> offlineMapboxTileCount;
 
+    uint64_t usedSize();
     bool evict(uint64_t neededFreeSize);
+    bool evictLeastRecentlyUsed();
+
+    // Whether eviction freed pages that weren't vacuumed yet.
+    bool vacuumPending = false;
 };
 
 } // namespace mbgl
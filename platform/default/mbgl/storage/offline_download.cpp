@@ -4,10 +4,12 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/http_file_source.hpp>
+#include <mbgl/platform/log.hpp>
 #include <mbgl/style/parser.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
 #include <mbgl/style/tile_source_impl.hpp>
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/tile_cover.hpp>
@@ -17,6 +19,26 @@
 
 namespace mbgl {
 
+namespace {
+
+// Downloaded responses are written once this many of them wait, or after the delay, so that
+// each write doesn't commit, and sync, on its own.
+const std::size_t maximumPendingResponses = 64;
+const Duration writeDelay = std::chrono::seconds(1);
+
+// The number of resources that are checked against the database at a time.
+const std::size_t checkBatchSize = 1024;
+
+// Full batches of refreshed resources are followed by a pause, so that revalidating a large
+// region doesn't take up the network, and the database, the way a download does.
+const Duration refreshDelay = std::chrono::seconds(1);
+
+bool isMapboxTile(const Resource& resource) {
+    return resource.kind == Resource::Kind::Tile && util::mapbox::isMapboxURL(resource.url);
+}
+
+} // namespace
+
 OfflineDownload::OfflineDownload(int64_t id_,
                                  OfflineRegionDefinition&& definition_,
                                  OfflineDatabase& offlineDatabase_,
@@ -24,11 +46,30 @@ OfflineDownload::OfflineDownload(int64_t id_,
     : id(id_),
       definition(definition_),
       offlineDatabase(offlineDatabase_),
-      onlineFileSource(onlineFileSource_) {
+      onlineFileSource(onlineFileSource_),
+      maximumConcurrentRequests(HTTPFileSource::maximumConcurrentRequests() * 2) {
     setObserver(nullptr);
 }
 
-OfflineDownload::~OfflineDownload() = default;
+OfflineDownload::~OfflineDownload() {
+    try {
+        storeResponses();
+        storeRefreshedResponses();
+    } catch (const std::exception& ex) {
+        Log::Error(Event::Database, "Can't write the downloaded resources: %s", ex.what());
+    }
+}
+
+void OfflineDownload::setMaximumConcurrentRequests(uint32_t maximumConcurrentRequests_) {
+    maximumConcurrentRequests = std::max<uint32_t>(maximumConcurrentRequests_, 1);
+    if (status.downloadState == OfflineRegionDownloadState::Active) {
+        continueDownload();
+    }
+}
+
+void OfflineDownload::setRefreshExpiredResources(bool refreshExpiredResources_) {
+    refreshExpiredResources = refreshExpiredResources_;
+}
 
 void OfflineDownload::setObserver(std::unique_ptr<OfflineRegionObserver> observer_) {
     observer = observer_ ? std::move(observer_) : std::make_unique<OfflineRegionObserver>();
@@ -40,6 +81,7 @@ void OfflineDownload::setState(OfflineRegionDownloadState state) {
     }
 
     status.downloadState = state;
+    requiredResourceCount = {};
 
     if (status.downloadState == OfflineRegionDownloadState::Active) {
         activateDownload();
@@ -56,6 +98,11 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
     }
 
     OfflineRegionStatus result = offlineDatabase.getRegionCompletedStatus(id);
+    if (requiredResourceCount) {
+        result.requiredResourceCount = *requiredResourceCount;
+        result.requiredResourceCountIsPrecise = true;
+        return result;
+    }
 
     result.requiredResourceCount++;
     optional<Response> styleResponse = offlineDatabase.get(Resource::style(definition.styleURL));
@@ -121,11 +168,16 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
         result.requiredResourceCount += 2;
     }
 
+    if (result.requiredResourceCountIsPrecise) {
+        requiredResourceCount = result.requiredResourceCount;
+    }
+
     return result;
 }
 
 void OfflineDownload::activateDownload() {
     status = OfflineRegionStatus();
+    refreshCursor = {};
     status.downloadState = OfflineRegionDownloadState::Active;
     status.requiredResourceCount++;
     ensureResource(Resource::style(definition.styleURL), [&](Response styleResponse) {
@@ -218,19 +270,125 @@ void OfflineDownload::activateDownload() {
 */
 void OfflineDownload::continueDownload() {
     if (resourcesRemaining.empty() && status.complete()) {
-        setState(OfflineRegionDownloadState::Inactive);
+        if (!refreshExpiredResources) {
+            setState(OfflineRegionDownloadState::Inactive);
+        } else if (!refreshCursor) {
+            refreshCursor.emplace(util::now());
+            refreshResources();
+        }
         return;
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < HTTPFileSource::maximumConcurrentRequests()) {
-        ensureResource(resourcesRemaining.front());
+    while (!resourcesToDownload.empty() && requests.size() < maximumConcurrentRequests) {
+        const Resource resource = std::move(resourcesToDownload.front());
+        resourcesToDownload.pop_front();
+        if (checkTileCountLimit(resource)) {
+            return;
+        }
+        downloadResource(resource);
+    }
+
+    // The next resources are checked before the ones that wait for a request run out.
+    if (!checkRequest && !resourcesRemaining.empty() && resourcesToDownload.size() < maximumConcurrentRequests) {
+        checkRequest = util::RunLoop::Get()->invokeCancellable([this] {
+            checkResources();
+        });
+    }
+}
+
+void OfflineDownload::checkResources() {
+    checkRequest.reset();
+
+    std::vector<Resource> resources;
+    while (!resourcesRemaining.empty() && resources.size() < checkBatchSize) {
+        resources.push_back(std::move(resourcesRemaining.front()));
         resourcesRemaining.pop_front();
     }
+
+    const std::vector<optional<int64_t>> sizes = offlineDatabase.hasRegionResources(id, resources);
+
+    bool found = false;
+    for (std::size_t i = 0; i < resources.size(); i++) {
+        if (!sizes[i]) {
+            resourcesToDownload.push_back(std::move(resources[i]));
+            continue;
+        }
+        found = true;
+        status.completedResourceCount++;
+        status.completedResourceSize += *sizes[i];
+        if (resources[i].kind == Resource::Kind::Tile) {
+            status.completedTileCount += 1;
+            status.completedTileSize += *sizes[i];
+        }
+    }
+
+    if (found) {
+        observer->statusChanged(status);
+    }
+
+    continueDownload();
+}
+
+void OfflineDownload::refreshResources() {
+    const std::vector<Resource> resources =
+        offlineDatabase.getRegionExpiredResources(id, *refreshCursor, maximumConcurrentRequests);
+    if (resources.empty()) {
+        setState(OfflineRegionDownloadState::Inactive);
+        return;
+    }
+
+    const bool full = resources.size() >= maximumConcurrentRequests;
+    for (const Resource& resource : resources) {
+        Resource refresh = resource;
+        refresh.priority = Resource::Background;
+
+        auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
+        *fileRequestsIt = onlineFileSource.request(refresh, [=](Response onlineResponse) {
+            if (onlineResponse.error) {
+                observer->responseError(*onlineResponse.error);
+                return;
+            }
+
+            requests.erase(fileRequestsIt);
+            refreshedResponses.emplace_back(resource, std::move(onlineResponse));
+            if (!requests.empty()) {
+                return;
+            }
+
+            storeRefreshedResponses();
+            if (full) {
+                refreshTimer.start(refreshDelay, Duration::zero(), [this] {
+                    refreshResources();
+                });
+            } else {
+                refreshResources();
+            }
+        });
+    }
+}
+
+void OfflineDownload::storeRefreshedResponses() {
+    if (refreshedResponses.empty()) {
+        return;
+    }
+
+    const std::vector<std::pair<Resource, Response>> responses = std::move(refreshedResponses);
+    refreshedResponses.clear();
+
+    // Revalidated resources were counted as completed by the download already.
+    offlineDatabase.putRegionResources(id, responses);
 }
 
 void OfflineDownload::deactivateDownload() {
+    // The responses that were downloaded already are kept.
+    storeResponses();
+    storeRefreshedResponses();
+    refreshTimer.stop();
+
     requiredSourceURLs.clear();
     resourcesRemaining.clear();
+    resourcesToDownload.clear();
+    checkRequest.reset();
     requests.clear();
 }
 
@@ -253,25 +411,15 @@ void OfflineDownload::ensureResource(const Resource& resource,
     *workRequestsIt = util::RunLoop::Get()->invokeCancellable([=]() {
         requests.erase(workRequestsIt);
         
-        auto getResourceSizeInDatabase = [&] () -> optional<int64_t> {
-            if (!callback) {
-                return offlineDatabase.hasRegionResource(id, resource);
-            }
-            optional<std::pair<Response, uint64_t>> response = offlineDatabase.getRegionResource(id, resource);
-            if (!response) {
-                return {};
-            }
-            callback(response->first);
-            return response->second;
-        };
-        
-        optional<int64_t> offlineResponse = getResourceSizeInDatabase();
+        optional<std::pair<Response, uint64_t>> offlineResponse = offlineDatabase.getRegionResource(id, resource);
         if (offlineResponse) {
+            callback(offlineResponse->first);
+
             status.completedResourceCount++;
-            status.completedResourceSize += *offlineResponse;
+            status.completedResourceSize += offlineResponse->second;
             if (resource.kind == Resource::Kind::Tile) {
                 status.completedTileCount += 1;
-                status.completedTileSize += *offlineResponse;
+                status.completedTileSize += offlineResponse->second;
             }
 
             observer->statusChanged(status);
@@ -283,18 +431,27 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return;
         }
 
-        auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
-            if (onlineResponse.error) {
-                observer->responseError(*onlineResponse.error);
-                return;
-            }
+        downloadResource(resource, callback);
+    });
+}
 
-            requests.erase(fileRequestsIt);
+void OfflineDownload::downloadResource(const Resource& resource, std::function<void(Response)> callback) {
+    // Downloads go behind the requests of maps that share the file source.
+    Resource download = resource;
+    download.priority = Resource::Background;
 
-            if (callback) {
-                callback(onlineResponse);
-            }
+    auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
+    *fileRequestsIt = onlineFileSource.request(download, [=](Response onlineResponse) {
+        if (onlineResponse.error) {
+            observer->responseError(*onlineResponse.error);
+            return;
+        }
+
+        requests.erase(fileRequestsIt);
+
+        // The style and the sources are needed right away, to find the rest of the resources.
+        if (callback) {
+            callback(onlineResponse);
 
             status.completedResourceCount++;
             uint64_t resourceSize = offlineDatabase.putRegionResource(id, resource, onlineResponse);
@@ -311,13 +468,84 @@ void OfflineDownload::ensureResource(const Resource& resource,
             }
 
             continueDownload();
-        });
+            return;
+        }
+
+        if (isMapboxTile(resource)) {
+            pendingMapboxTileCount++;
+        }
+        pendingResponses.emplace_back(resource, std::move(onlineResponse));
+
+        // The next requests start before the responses are written.
+        continueDownload();
+
+        if (pendingResponses.size() >= maximumPendingResponses || requests.empty()) {
+            writeResponses();
+        } else if (pendingResponses.size() == 1) {
+            writeTimer.start(writeDelay, Duration::zero(), [this] {
+                writeResponses();
+            });
+        }
     });
 }
 
+void OfflineDownload::storeResponses() {
+    writeTimer.stop();
+    if (pendingResponses.empty()) {
+        return;
+    }
+
+    const std::vector<std::pair<Resource, Response>> responses = std::move(pendingResponses);
+    pendingResponses.clear();
+    pendingMapboxTileCount = 0;
+
+    const std::vector<uint64_t> sizes = offlineDatabase.putRegionResources(id, responses);
+    for (std::size_t i = 0; i < responses.size(); i++) {
+        status.completedResourceCount++;
+        status.completedResourceSize += sizes[i];
+        if (responses[i].first.kind == Resource::Kind::Tile) {
+            status.completedTileCount += 1;
+            status.completedTileSize += sizes[i];
+        }
+    }
+}
+
+void OfflineDownload::writeResponses() {
+    const bool mapboxTiles = pendingMapboxTileCount > 0;
+    storeResponses();
+
+    observer->statusChanged(status);
+
+    if (mapboxTiles && tileCountLimitExceeded()) {
+        return;
+    }
+
+    continueDownload();
+}
+
 bool OfflineDownload::checkTileCountLimit(const Resource& resource) {
-    if (resource.kind == Resource::Kind::Tile && util::mapbox::isMapboxURL(resource.url) &&
-        offlineDatabase.offlineMapboxTileCountLimitExceeded()) {
+    if (!isMapboxTile(resource)) {
+        return false;
+    }
+
+    // Tiles that wait to be written may take up what's left of the limit.
+    if (pendingMapboxTileCount > 0 &&
+        offlineDatabase.getOfflineMapboxTileCount() + pendingMapboxTileCount >=
+            offlineDatabase.getOfflineMapboxTileCountLimit()) {
+        storeResponses();
+        observer->statusChanged(status);
+
+        // The observer may have deactivated the download.
+        if (status.downloadState != OfflineRegionDownloadState::Active) {
+            return true;
+        }
+    }
+
+    return tileCountLimitExceeded();
+}
+
+bool OfflineDownload::tileCountLimitExceeded() {
+    if (offlineDatabase.offlineMapboxTileCountLimitExceeded()) {
         observer->mapboxTileCountLimitExceeded(offlineDatabase.getOfflineMapboxTileCountLimit());
         setState(OfflineRegionDownloadState::Inactive);
         return true;
@@ -1,19 +1,22 @@
 #pragma once
 
 #include <mbgl/storage/offline.hpp>
+#include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/timer.hpp>
 
 #include <list>
 #include <unordered_set>
 #include <memory>
 #include <deque>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
-class OfflineDatabase;
 class FileSource;
 class AsyncRequest;
-class Response;
 class Tileset;
 
 namespace style {
@@ -35,18 +38,61 @@ public:
 
     OfflineRegionStatus getStatus() const;
 
+    /*
+     * The number of resources that are requested from the file source at a time. It's more
+     * than the file source has in flight, so that the next requests wait in its queue while
+     * the responses are handled.
+     */
+    void setMaximumConcurrentRequests(uint32_t);
+
+    /*
+     * Whether the download goes on to revalidate the expired resources of the region once the
+     * missing ones are stored, before it becomes inactive. They're requested with the etags and
+     * modification times they were stored with, the most recently used first, a batch at a time.
+     */
+    void setRefreshExpiredResources(bool);
+
 private:
     void activateDownload();
     void continueDownload();
     void deactivateDownload();
 
     /*
-     * Ensure that the resource is stored in the database, requesting it if necessary.
+     * Check the next resources against the database in bulk, and queue those that aren't
+     * stored yet for download.
+     */
+    void checkResources();
+
+    /*
+     * Request the resource. Responses of resources without a callback wait in
+     * `pendingResponses`, to be written together.
+     */
+    void downloadResource(const Resource&, std::function<void (Response)> = {});
+
+    /*
+     * Store the pending responses in one transaction, and count them as completed.
+     * writeResponses() also reports the status and continues the download.
+     */
+    void storeResponses();
+    void writeResponses();
+
+    /*
+     * Ensure that the resource is stored in the database, requesting it if necessary, and
+     * pass it to the callback.
      * While the request is in progress, it is recorded in `requests`. If the download
      * is deactivated, all in progress requests are cancelled.
      */
-    void ensureResource(const Resource&, std::function<void (Response)> = {});
+    void ensureResource(const Resource&, std::function<void (Response)>);
+    /*
+     * Request the next batch of expired resources, and write their responses together once
+     * they all arrived. Resources that were used or revalidated since the refresh started,
+     * e.g. by maps that share the database, aren't requested again.
+     */
+    void refreshResources();
+    void storeRefreshedResponses();
+
     bool checkTileCountLimit(const Resource& resource);
+    bool tileCountLimitExceeded();
     
     int64_t id;
     OfflineRegionDefinition definition;
@@ -55,10 +101,31 @@ private:
     OfflineRegionStatus status;
     std::unique_ptr<OfflineRegionObserver> observer;
 
+    uint32_t maximumConcurrentRequests;
+
+    // The number of resources that the inactive region requires, once it's known precisely. It
+    // only changes with the style and the sources, so it's kept until the state changes.
+    mutable optional<uint64_t> requiredResourceCount;
+
     std::list<std::unique_ptr<AsyncRequest>> requests;
     std::unordered_set<std::string> requiredSourceURLs;
     std::deque<Resource> resourcesRemaining;
 
+    // Resources that weren't found in the database, and wait for a request.
+    std::deque<Resource> resourcesToDownload;
+    std::unique_ptr<AsyncRequest> checkRequest;
+
+    // Responses that wait to be written together, and the number of them that are tiles served
+    // by Mapbox, which count towards the limit.
+    std::vector<std::pair<Resource, Response>> pendingResponses;
+    uint64_t pendingMapboxTileCount = 0;
+    util::Timer writeTimer;
+
+    bool refreshExpiredResources = false;
+    optional<OfflineDatabase::ExpiredResourcesCursor> refreshCursor;
+    std::vector<std::pair<Resource, Response>> refreshedResponses;
+    util::Timer refreshTimer;
+
     void queueResource(Resource);
     void queueTiles(SourceType, uint16_t tileSize, const Tileset&);
 };
@@ -0,0 +1,310 @@
+#include <mbgl/storage/offline_pack.hpp>
+#include <mbgl/util/compression.hpp>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+namespace mbgl {
+
+namespace {
+
+const char magic[8] = { 'M', 'B', 'G', 'L', 'P', 'A', 'C', 'K' };
+
+static_assert(sizeof(OfflinePack::Span) == 16, "spans must not be padded");
+static_assert(sizeof(OfflinePack::Header) == 32, "the header must not be padded");
+static_assert(sizeof(OfflinePack::TileEntry) == 64, "tile entries must not be padded");
+static_assert(sizeof(OfflinePack::ResourceEntry) == 72, "resource entries must not be padded");
+
+auto tileKey(const OfflinePack::TileEntry& tile) {
+    return std::make_tuple(tile.templateIndex, tile.pixelRatio, tile.z, tile.x, tile.y);
+}
+
+int64_t seconds(const optional<Timestamp>& time) {
+    return time ? time->time_since_epoch().count() : 0;
+}
+
+} // namespace
+
+OfflinePack::OfflinePack(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("can't open offline pack " + path);
+    }
+
+    struct stat info;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        size = info.st_size;
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("can't map offline pack " + path);
+    }
+    data = static_cast<const char*>(mapping);
+
+    header = reinterpret_cast<const Header*>(data);
+    bool valid = size >= sizeof(Header) &&
+                 std::memcmp(header->magic, magic, sizeof(magic)) == 0 &&
+                 header->version == version &&
+                 header->directoryOffset % 8 == 0 &&
+                 header->directoryOffset +
+                     uint64_t(header->templateCount) * sizeof(Span) +
+                     uint64_t(header->tileCount) * sizeof(TileEntry) +
+                     uint64_t(header->resourceCount) * sizeof(ResourceEntry) <= size;
+
+    if (valid) {
+        templates = reinterpret_cast<const Span*>(data + header->directoryOffset);
+        tiles = reinterpret_cast<const TileEntry*>(templates + header->templateCount);
+        resources = reinterpret_cast<const ResourceEntry*>(tiles + header->tileCount);
+
+        // The names that lookups compare are checked once, and the data as it's read.
+        valid = std::all_of(templates, templates + header->templateCount, [&] (const Span& span) {
+            return contains(span);
+        }) && std::all_of(resources, resources + header->resourceCount, [&] (const ResourceEntry& entry) {
+            return contains(entry.url);
+        });
+    }
+
+    if (!valid) {
+        munmap(mapping, size);
+        throw std::runtime_error(path + " isn't an offline pack");
+    }
+}
+
+OfflinePack::~OfflinePack() {
+    munmap(const_cast<char*>(data), size);
+}
+
+bool OfflinePack::contains(const Span& span) const {
+    return span.offset <= size && span.size <= size - span.offset;
+}
+
+int OfflinePack::compare(const Span& span, const std::string& string) const {
+    const int result = std::memcmp(data + span.offset, string.data(), std::min<std::size_t>(span.size, string.size()));
+    if (result != 0) {
+        return result;
+    }
+    return span.size < string.size() ? -1 : span.size > string.size() ? 1 : 0;
+}
+
+optional<Response> OfflinePack::get(const Resource& resource) const {
+    if (resource.kind == Resource::Kind::Tile && resource.tileData) {
+        const Resource::TileData& tile = *resource.tileData;
+
+        const Span* templatesEnd = templates + header->templateCount;
+        const Span* urlTemplate = std::lower_bound(templates, templatesEnd, tile.urlTemplate,
+            [&] (const Span& span, const std::string& name) { return compare(span, name) < 0; });
+        if (urlTemplate == templatesEnd || compare(*urlTemplate, tile.urlTemplate) != 0) {
+            return {};
+        }
+
+        TileEntry key {};
+        key.templateIndex = uint32_t(urlTemplate - templates);
+        key.pixelRatio = tile.pixelRatio;
+        key.z = tile.z;
+        key.x = tile.x;
+        key.y = tile.y;
+
+        const TileEntry* entry = findTile(key);
+        if (!entry) {
+            return {};
+        }
+        return response(entry->data, entry->etag, entry->expires, entry->modified);
+    }
+
+    const ResourceEntry* resourcesEnd = resources + header->resourceCount;
+    const ResourceEntry* entry = std::lower_bound(resources, resourcesEnd, resource.url,
+        [&] (const ResourceEntry& a, const std::string& url) { return compare(a.url, url) < 0; });
+    if (entry == resourcesEnd || compare(entry->url, resource.url) != 0 ||
+        entry->kind != uint32_t(resource.kind)) {
+        return {};
+    }
+    return response(entry->data, entry->etag, entry->expires, entry->modified);
+}
+
+optional<Response> OfflinePack::getTile(uint8_t pixelRatio, int8_t z, int32_t x, int32_t y) const {
+    TileEntry key {};
+    key.pixelRatio = pixelRatio;
+    key.z = z;
+    key.x = x;
+    key.y = y;
+
+    for (key.templateIndex = 0; key.templateIndex < header->templateCount; ++key.templateIndex) {
+        if (const TileEntry* entry = findTile(key)) {
+            return response(entry->data, entry->etag, entry->expires, entry->modified);
+        }
+    }
+    return {};
+}
+
+const OfflinePack::TileEntry* OfflinePack::findTile(const TileEntry& key) const {
+    const TileEntry* tilesEnd = tiles + header->tileCount;
+    const TileEntry* entry = std::lower_bound(tiles, tilesEnd, key,
+        [] (const TileEntry& a, const TileEntry& b) { return tileKey(a) < tileKey(b); });
+    if (entry == tilesEnd || tileKey(*entry) != tileKey(key)) {
+        return nullptr;
+    }
+    return entry;
+}
+
+Response OfflinePack::response(const Span& bytes, const Span& etag, int64_t expires, int64_t modified) const {
+    Response result;
+
+    if (!contains(bytes) || !contains(etag)) {
+        result.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, "offline pack is corrupt");
+        return result;
+    }
+
+    if (!(bytes.flags & present)) {
+        result.noContent = true;
+    } else if (bytes.flags & deflated) {
+        result.data = std::make_shared<std::string>(util::decompress(data + bytes.offset, bytes.size));
+    } else {
+        result.data = std::make_shared<std::string>(data + bytes.offset, bytes.size);
+    }
+
+    if (etag.flags & present) {
+        result.etag = std::string(data + etag.offset, etag.size);
+    }
+    if (expires) {
+        result.expires = Timestamp(Seconds(expires));
+    }
+    if (modified) {
+        result.modified = Timestamp(Seconds(modified));
+    }
+
+    return result;
+}
+
+OfflinePackWriter::OfflinePackWriter(const std::string& path)
+    : file(path, std::ios::binary | std::ios::trunc) {
+    if (!file) {
+        throw std::runtime_error("can't write offline pack " + path);
+    }
+
+    // The header is written once the directory is.
+    const OfflinePack::Header header {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    offset = sizeof(header);
+}
+
+OfflinePack::Span OfflinePackWriter::write(const std::string& bytes, uint32_t flags) {
+    OfflinePack::Span span { offset, uint32_t(bytes.size()), flags };
+    file.write(bytes.data(), bytes.size());
+    offset += bytes.size();
+    return span;
+}
+
+void OfflinePackWriter::align() {
+    const char padding[8] = {};
+    const std::size_t count = (8 - offset % 8) % 8;
+    file.write(padding, count);
+    offset += count;
+}
+
+void OfflinePackWriter::add(const Resource& resource, const Response& response) {
+    if (response.error) {
+        return;
+    }
+
+    OfflinePack::Span data {};
+    if (!response.noContent && response.data) {
+        std::string compressed = util::compress(*response.data);
+        if (compressed.size() < response.data->size()) {
+            data = write(compressed, OfflinePack::present | OfflinePack::deflated);
+        } else {
+            data = write(*response.data, OfflinePack::present);
+        }
+    }
+
+    OfflinePack::Span etag {};
+    if (response.etag) {
+        etag = write(*response.etag, OfflinePack::present);
+    }
+
+    if (resource.kind == Resource::Kind::Tile && resource.tileData) {
+        const Resource::TileData& tileData = *resource.tileData;
+        OfflinePack::TileEntry tile {};
+        tile.data = data;
+        tile.etag = etag;
+        tile.expires = seconds(response.expires);
+        tile.modified = seconds(response.modified);
+        tile.templateIndex = templates.emplace(tileData.urlTemplate, uint32_t(templates.size())).first->second;
+        tile.pixelRatio = tileData.pixelRatio;
+        tile.z = tileData.z;
+        tile.x = tileData.x;
+        tile.y = tileData.y;
+        tiles.push_back(tile);
+    } else {
+        OfflinePack::ResourceEntry entry {};
+        entry.url = write(resource.url, OfflinePack::present);
+        entry.data = data;
+        entry.etag = etag;
+        entry.expires = seconds(response.expires);
+        entry.modified = seconds(response.modified);
+        entry.kind = uint32_t(resource.kind);
+        resources.emplace_back(resource.url, entry);
+    }
+}
+
+void OfflinePackWriter::finish() {
+    align();
+
+    OfflinePack::Header header {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = OfflinePack::version;
+    header.templateCount = uint32_t(templates.size());
+    header.tileCount = uint32_t(tiles.size());
+    header.resourceCount = uint32_t(resources.size());
+    header.directoryOffset = offset;
+
+    // The templates are named after the directory, in the order they're sorted in.
+    uint64_t nameOffset = offset +
+                          templates.size() * sizeof(OfflinePack::Span) +
+                          tiles.size() * sizeof(OfflinePack::TileEntry) +
+                          resources.size() * sizeof(OfflinePack::ResourceEntry);
+    std::vector<uint32_t> sortedIndex(templates.size());
+    uint32_t index = 0;
+    for (const auto& urlTemplate : templates) {
+        const OfflinePack::Span span { nameOffset, uint32_t(urlTemplate.first.size()), OfflinePack::present };
+        file.write(reinterpret_cast<const char*>(&span), sizeof(span));
+        nameOffset += urlTemplate.first.size();
+        sortedIndex[urlTemplate.second] = index++;
+    }
+
+    for (auto& tile : tiles) {
+        tile.templateIndex = sortedIndex[tile.templateIndex];
+    }
+    std::sort(tiles.begin(), tiles.end(), [] (const auto& a, const auto& b) {
+        return tileKey(a) < tileKey(b);
+    });
+    file.write(reinterpret_cast<const char*>(tiles.data()), tiles.size() * sizeof(OfflinePack::TileEntry));
+
+    std::sort(resources.begin(), resources.end(), [] (const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    for (const auto& resource : resources) {
+        file.write(reinterpret_cast<const char*>(&resource.second), sizeof(resource.second));
+    }
+
+    for (const auto& urlTemplate : templates) {
+        file.write(urlTemplate.first.data(), urlTemplate.first.size());
+    }
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.flush();
+    if (!file) {
+        throw std::runtime_error("can't write offline pack");
+    }
+}
+
+} // namespace mbgl
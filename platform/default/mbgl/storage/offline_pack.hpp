@@ -0,0 +1,130 @@
+#pragma once
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    A read-only pack of the resources and tiles of an offline region, which is memory-mapped
+    and looked up with binary searches instead of SQL. Packs are written by OfflinePackWriter,
+    in the byte order of the platform that writes them:
+
+        Header
+        The data, etags and URLs of the entries, in the order they were added
+        Span[templateCount]             The URL templates of the tiles, sorted
+        TileEntry[tileCount]            Sorted by template, pixel ratio, zoom level, column and row
+        ResourceEntry[resourceCount]    Sorted by URL
+        The URL templates
+
+    The directory that starts at `directoryOffset` is 8-byte aligned, so that it's read in
+    place. Offsets are from the start of the file.
+*/
+class OfflinePack : private util::noncopyable {
+public:
+    // Throws std::runtime_error if the file can't be mapped or isn't a pack.
+    explicit OfflinePack(const std::string& path);
+    ~OfflinePack();
+
+    optional<Response> get(const Resource&) const;
+
+    // The tile at the given coordinates, of whichever URL template has it first, for packs
+    // that are served as tile archives rather than in place of the URLs they were exported from.
+    optional<Response> getTile(uint8_t pixelRatio, int8_t z, int32_t x, int32_t y) const;
+
+    static const uint32_t version = 1;
+
+    // Bytes of the file. Data spans have the `present` flag unless the response had no content.
+    struct Span {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t flags;
+    };
+    static const uint32_t present = 1;
+    static const uint32_t deflated = 2;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t templateCount;
+        uint32_t tileCount;
+        uint32_t resourceCount;
+        uint64_t directoryOffset;
+    };
+
+    // Times are in seconds since the epoch, and 0 if the response had none.
+    struct TileEntry {
+        Span data;
+        Span etag;
+        int64_t expires;
+        int64_t modified;
+        uint32_t templateIndex;
+        int32_t x;
+        int32_t y;
+        int8_t z;
+        uint8_t pixelRatio;
+        uint16_t reserved;
+    };
+
+    struct ResourceEntry {
+        Span url;
+        Span data;
+        Span etag;
+        int64_t expires;
+        int64_t modified;
+        uint32_t kind;
+        uint32_t reserved;
+    };
+
+private:
+    bool contains(const Span&) const;
+    int compare(const Span&, const std::string&) const;
+    const TileEntry* findTile(const TileEntry& key) const;
+    Response response(const Span& data, const Span& etag, int64_t expires, int64_t modified) const;
+
+    const char* data = nullptr;
+    std::size_t size = 0;
+
+    const Header* header = nullptr;
+    const Span* templates = nullptr;
+    const TileEntry* tiles = nullptr;
+    const ResourceEntry* resources = nullptr;
+};
+
+/*
+    Writes the responses of resources into a pack, deflating their data where that makes it
+    smaller. Throws std::runtime_error if the file can't be written.
+*/
+class OfflinePackWriter : private util::noncopyable {
+public:
+    explicit OfflinePackWriter(const std::string& path);
+
+    void add(const Resource&, const Response&);
+
+    // Writes the directory, after which the pack can be opened.
+    void finish();
+
+private:
+    OfflinePack::Span write(const std::string&, uint32_t flags);
+    void align();
+
+    std::ofstream file;
+    uint64_t offset = 0;
+
+    // The tiles refer to the templates by the order they were first added in, until the
+    // templates are sorted.
+    std::map<std::string, uint32_t> templates;
+    std::vector<OfflinePack::TileEntry> tiles;
+    std::vector<std::pair<std::string, OfflinePack::ResourceEntry>> resources;
+};
+
+} // namespace mbgl
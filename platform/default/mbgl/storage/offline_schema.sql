@@ -24,9 +24,22 @@ CREATE TABLE tiles (
   data BLOB,
   compressed INTEGER NOT NULL DEFAULT 0,
   accessed INTEGER NOT NULL,
+  blob_id INTEGER REFERENCES tile_blobs(id),  -- The data of small tiles, which is shared with the identical ones.
   UNIQUE (url_template, pixel_ratio, z, x, y)
 );
 
+CREATE TABLE tile_blobs (
+  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+  hash INTEGER NOT NULL,
+  data BLOB NOT NULL,
+  compressed INTEGER NOT NULL DEFAULT 0
+);
+
+CREATE TABLE tile_dictionaries (          -- Dictionaries that tiles with compressed = 2 are deflated with.
+  url_template TEXT NOT NULL PRIMARY KEY,
+  data BLOB NOT NULL
+);
+
 CREATE TABLE regions (
   id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
   definition TEXT NOT NULL,   -- JSON formatted definition of region. Regions may be of variant types:
@@ -47,6 +60,14 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE region_status (      -- The count and size of the resources and tiles of each region, kept by the triggers below.
+  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE,
+  resource_count INTEGER NOT NULL DEFAULT 0,
+  resource_size INTEGER NOT NULL DEFAULT 0,
+  tile_count INTEGER NOT NULL DEFAULT 0,
+  tile_size INTEGER NOT NULL DEFAULT 0
+);
+
 -- Indexes for efficient eviction queries
 
 CREATE INDEX resources_accessed
@@ -60,3 +81,91 @@ ON region_resources (resource_id);
 
 CREATE INDEX region_tiles_tile_id
 ON region_tiles (tile_id);
+
+CREATE INDEX tiles_blob_id
+ON tiles (blob_id);
+
+CREATE INDEX tile_blobs_hash
+ON tile_blobs (hash);
+
+-- Blobs go away with the last of the tiles that share them.
+CREATE TRIGGER tile_blobs_delete
+AFTER DELETE ON tiles
+WHEN OLD.blob_id IS NOT NULL
+BEGIN
+  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);
+END;
+
+CREATE TRIGGER tile_blobs_update
+AFTER UPDATE OF blob_id ON tiles
+WHEN OLD.blob_id IS NOT NULL AND OLD.blob_id IS NOT NEW.blob_id
+BEGIN
+  DELETE FROM tile_blobs WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);
+END;
+
+-- The status of regions follows the resources and tiles they use, and the size of their data.
+CREATE TRIGGER region_status_insert
+AFTER INSERT ON regions
+BEGIN
+  INSERT INTO region_status (region_id) VALUES (NEW.id);
+END;
+
+CREATE TRIGGER region_resources_insert
+AFTER INSERT ON region_resources
+BEGIN
+  UPDATE region_status
+  SET resource_count = resource_count + 1,
+      resource_size  = resource_size + IFNULL((SELECT length(data) FROM resources WHERE id = NEW.resource_id), 0)
+  WHERE region_id = NEW.region_id;
+END;
+
+CREATE TRIGGER region_resources_delete
+AFTER DELETE ON region_resources
+BEGIN
+  UPDATE region_status
+  SET resource_count = resource_count - 1,
+      resource_size  = resource_size - IFNULL((SELECT length(data) FROM resources WHERE id = OLD.resource_id), 0)
+  WHERE region_id = OLD.region_id;
+END;
+
+CREATE TRIGGER region_resources_update
+AFTER UPDATE OF data ON resources
+WHEN length(OLD.data) IS NOT length(NEW.data)
+BEGIN
+  UPDATE region_status
+  SET resource_size = resource_size - IFNULL(length(OLD.data), 0) + IFNULL(length(NEW.data), 0)
+  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id);
+END;
+
+CREATE TRIGGER region_tiles_insert
+AFTER INSERT ON region_tiles
+BEGIN
+  UPDATE region_status
+  SET tile_count = tile_count + 1,
+      tile_size  = tile_size + IFNULL((SELECT length(COALESCE(tiles.data, tile_blobs.data))
+                                       FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id
+                                       WHERE tiles.id = NEW.tile_id), 0)
+  WHERE region_id = NEW.region_id;
+END;
+
+CREATE TRIGGER region_tiles_delete
+AFTER DELETE ON region_tiles
+BEGIN
+  UPDATE region_status
+  SET tile_count = tile_count - 1,
+      tile_size  = tile_size - IFNULL((SELECT length(COALESCE(tiles.data, tile_blobs.data))
+                                       FROM tiles LEFT JOIN tile_blobs ON blob_id = tile_blobs.id
+                                       WHERE tiles.id = OLD.tile_id), 0)
+  WHERE region_id = OLD.region_id;
+END;
+
+-- Before the update, as the old blob may go away with it.
+CREATE TRIGGER region_tiles_update
+BEFORE UPDATE OF data, blob_id ON tiles
+BEGIN
+  UPDATE region_status
+  SET tile_size = tile_size
+                - IFNULL(length(COALESCE(OLD.data, (SELECT data FROM tile_blobs WHERE id = OLD.blob_id))), 0)
+                + IFNULL(length(COALESCE(NEW.data, (SELECT data FROM tile_blobs WHERE id = NEW.blob_id))), 0)
+  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = OLD.id);
+END;
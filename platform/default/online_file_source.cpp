@@ -85,19 +85,75 @@ public:
         assert(activeRequests.find(request) == activeRequests.end());
         assert(!request->request);
 
-        if (activeRequests.size() >= HTTPFileSource::maximumConcurrentRequests()) {
-            queueRequest(request);
-        } else {
+        if (activeRequests.size() < HTTPFileSource::maximumConcurrentRequests() || preemptFor(request)) {
             activateRequest(request);
+        } else {
+            queueRequest(request);
+        }
+    }
+
+    // Resources other than tiles, e.g. the style, sprites and glyphs, go ahead of all tiles, which
+    // go in the order of their priorities. Background requests go last either way.
+    static uint32_t rank(const OnlineFileRequest* request) {
+        const Resource& resource = request->resource;
+        if (resource.kind != Resource::Kind::Tile && resource.priority != Resource::Background) {
+            return 0;
         }
+        return 1 + resource.priority;
     }
 
-    void queueRequest(OnlineFileRequest* request) {
-        auto it = pendingRequestsList.insert(pendingRequestsList.end(), request);
+    // Requests go behind the pending ones of the same rank, unless they're resumed after they
+    // were preempted.
+    void queueRequest(OnlineFileRequest* request, bool resumed = false) {
+        const uint32_t requestRank = rank(request);
+        auto position = std::find_if(pendingRequestsList.begin(), pendingRequestsList.end(), [&] (const auto* pending) {
+            return resumed ? rank(pending) >= requestRank : rank(pending) > requestRank;
+        });
+        auto it = pendingRequestsList.insert(position, request);
         pendingRequestsMap.emplace(request, std::move(it));
         assert(pendingRequestsMap.size() == pendingRequestsList.size());
     }
 
+    // Makes room among the active requests for one that's needed for what's on screen, by putting
+    // back the least urgent prefetch or background request, e.g. for a tile that went out of view.
+    // It's resumed from the start once there's room again.
+    bool preemptFor(OnlineFileRequest* request) {
+        const uint32_t lowRank = 1 + Resource::Low;
+        if (rank(request) >= lowRank) {
+            return false;
+        }
+
+        OnlineFileRequest* preempted = nullptr;
+        for (auto* active : activeRequests) {
+            if (rank(active) >= lowRank && (!preempted || rank(active) > rank(preempted))) {
+                preempted = active;
+            }
+        }
+        if (!preempted) {
+            return false;
+        }
+
+        activeRequests.erase(preempted);
+        preempted->request.reset();
+        queueRequest(preempted, true);
+        return true;
+    }
+
+    void setPriority(OnlineFileRequest* request, Resource::Priority priority) {
+        if (request->resource.priority == priority) {
+            return;
+        }
+        request->resource.priority = priority;
+
+        // Pending requests move in the queue, and may preempt others. Active ones keep going.
+        auto it = pendingRequestsMap.find(request);
+        if (it != pendingRequestsMap.end()) {
+            pendingRequestsList.erase(it->second);
+            pendingRequestsMap.erase(it);
+            activateOrQueueRequest(request);
+        }
+    }
+
     void activateRequest(OnlineFileRequest* request) {
         activeRequests.insert(request);
         request->request = httpFileSource.request(request->resource, [=] (Response response) {
@@ -131,6 +187,10 @@ public:
         return activeRequests.find(request) != activeRequests.end();
     }
 
+    void setMaximumConnectionsPerHost(uint32_t maximum) {
+        httpFileSource.setMaximumConnectionsPerHost(maximum);
+    }
+
 private:
     void networkIsReachableAgain() {
         for (auto& request : allRequests) {
@@ -164,6 +224,15 @@ OnlineFileSource::OnlineFileSource()
 
 OnlineFileSource::~OnlineFileSource() = default;
 
+void OnlineFileSource::setPriority(AsyncRequest& request, Resource::Priority priority) {
+    // All of its requests are OnlineFileRequests.
+    impl->setPriority(static_cast<OnlineFileRequest*>(&request), priority);
+}
+
+void OnlineFileSource::setMaximumConnectionsPerHost(uint32_t maximum) {
+    impl->setMaximumConnectionsPerHost(maximum);
+}
+
 std::unique_ptr<AsyncRequest> OnlineFileSource::request(const Resource& resource, Callback callback) {
     Resource res = resource;
 
@@ -80,7 +80,10 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
     int color_type = 0;
     png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
 
-    UnassociatedImage image { static_cast<uint16_t>(width), static_cast<uint16_t>(height) };
+    // Decode straight into the premultiplied image. Only images with an alpha channel or a
+    // transparent color need premultiplying: the others are opaque.
+    PremultipliedImage image { static_cast<uint16_t>(width), static_cast<uint16_t>(height) };
+    const bool opaque = !(color_type & PNG_COLOR_MASK_ALPHA) && !png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
 
     if (color_type == PNG_COLOR_TYPE_PALETTE)
         png_set_expand(png_ptr);
@@ -100,7 +103,8 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_set_add_alpha(png_ptr, 0xff, PNG_FILLER_AFTER);
 
-    if (png_get_interlace_type(png_ptr,info_ptr) == PNG_INTERLACE_ADAM7) {
+    const bool interlaced = png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_ADAM7;
+    if (interlaced) {
         png_set_interlace_handling(png_ptr); // FIXME: libpng bug?
         // according to docs png_read_image
         // "..automatically handles interlacing,
@@ -109,16 +113,30 @@ PremultipliedImage decodePNG(const uint8_t* data, size_t size) {
 
     png_read_update_info(png_ptr, info_ptr);
 
-    // we can read whole image at once
-    // alloc row pointers
-    const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
-    for (unsigned row = 0; row < height; ++row)
-        rows[row] = image.data.get() + row * width * 4;
-    png_read_image(png_ptr, rows.get());
+    if (interlaced) {
+        // The rows are only complete after the last pass, so read the whole image at once.
+        const std::unique_ptr<png_bytep[]> rows(new png_bytep[height]);
+        for (unsigned row = 0; row < height; ++row)
+            rows[row] = image.data.get() + row * width * 4;
+        png_read_image(png_ptr, rows.get());
+
+        if (!opaque) {
+            util::premultiply(image.data.get(), image.size() / 4);
+        }
+    } else {
+        // Premultiply each row while it's still in the cache.
+        for (unsigned row = 0; row < height; ++row) {
+            png_bytep pixels = image.data.get() + row * width * 4;
+            png_read_row(png_ptr, pixels, nullptr);
+            if (!opaque) {
+                util::premultiply(pixels, width);
+            }
+        }
+    }
 
     png_read_end(png_ptr, nullptr);
 
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
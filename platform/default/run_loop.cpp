@@ -143,8 +143,7 @@ LOOP_HANDLE RunLoop::getLoopHandle() {
     return current.get()->impl->loop;
 }
 
-void RunLoop::push(std::shared_ptr<WorkTask> task) {
-    withMutex([&] { queue.push(std::move(task)); });
+void RunLoop::wake() {
     impl->async->send();
 }
 
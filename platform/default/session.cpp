@@ -0,0 +1,353 @@
+#include <mbgl/platform/default/session.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/sprite/sprite_image.hpp>
+#include <mbgl/style/transition_options.hpp>
+#include <mbgl/util/image.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace mbgl {
+
+namespace {
+
+template <class T>
+T constant(const style::PropertyValue<T>& value, T fallback) {
+    return value.isConstant() ? value.asConstant() : fallback;
+}
+
+std::ostream& operator<<(std::ostream& os, const Color& color) {
+    return os << color.r << ' ' << color.g << ' ' << color.b << ' ' << color.a;
+}
+
+template <class Points>
+void writePoints(std::ostream& os, const Points& points) {
+    os << ' ' << points.size();
+    for (const auto& point : points) {
+        os << ' ' << point.x << ' ' << point.y;
+    }
+}
+
+template <class Polygon>
+void writePolygon(std::ostream& os, const Polygon& polygon) {
+    os << ' ' << polygon.size();
+    for (const auto& ring : polygon) {
+        writePoints(os, ring);
+    }
+}
+
+void writeGeometry(std::ostream& os, const ShapeAnnotationGeometry& geometry) {
+    geometry.match(
+        [&] (const LineString<double>& lineString) {
+            os << " linestring";
+            writePoints(os, lineString);
+        },
+        [&] (const Polygon<double>& polygon) {
+            os << " polygon";
+            writePolygon(os, polygon);
+        },
+        [&] (const MultiLineString<double>& lineStrings) {
+            os << " multilinestring " << lineStrings.size();
+            for (const auto& lineString : lineStrings) {
+                writePoints(os, lineString);
+            }
+        },
+        [&] (const MultiPolygon<double>& polygons) {
+            os << " multipolygon " << polygons.size();
+            for (const auto& polygon : polygons) {
+                writePolygon(os, polygon);
+            }
+        });
+}
+
+// Reads the fields of one line, throwing if one is missing or malformed.
+class Fields {
+public:
+    Fields(const std::string& line_, std::size_t number_)
+        : stream(line_), number(number_) {
+    }
+
+    template <class T>
+    T read() {
+        T value;
+        if (!(stream >> value)) {
+            throw std::runtime_error("malformed session line " + std::to_string(number));
+        }
+        return value;
+    }
+
+    Color color() {
+        Color result;
+        result.r = read<float>();
+        result.g = read<float>();
+        result.b = read<float>();
+        result.a = read<float>();
+        return result;
+    }
+
+    template <class Points>
+    Points points() {
+        Points result;
+        const auto count = read<std::size_t>();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto x = read<double>();
+            result.emplace_back(x, read<double>());
+        }
+        return result;
+    }
+
+    Polygon<double> polygon() {
+        Polygon<double> result;
+        const auto count = read<std::size_t>();
+        for (std::size_t i = 0; i < count; ++i) {
+            result.push_back(points<LinearRing<double>>());
+        }
+        return result;
+    }
+
+    ShapeAnnotationGeometry geometry() {
+        const auto type = read<std::string>();
+        if (type == "linestring") {
+            return points<LineString<double>>();
+        } else if (type == "polygon") {
+            return polygon();
+        } else if (type == "multilinestring") {
+            MultiLineString<double> result;
+            const auto count = read<std::size_t>();
+            for (std::size_t i = 0; i < count; ++i) {
+                result.push_back(points<LineString<double>>());
+            }
+            return result;
+        } else if (type == "multipolygon") {
+            MultiPolygon<double> result;
+            const auto count = read<std::size_t>();
+            for (std::size_t i = 0; i < count; ++i) {
+                result.push_back(polygon());
+            }
+            return result;
+        }
+        throw std::runtime_error("unknown geometry type on session line " + std::to_string(number));
+    }
+
+private:
+    std::istringstream stream;
+    const std::size_t number;
+};
+
+std::shared_ptr<const SpriteImage> solidImage(float width, float height, float pixelRatio) {
+    PremultipliedImage image(std::ceil(width * pixelRatio), std::ceil(height * pixelRatio));
+    std::fill(image.data.get(), image.data.get() + image.size(), 0x80);
+    return std::make_shared<SpriteImage>(std::move(image), pixelRatio);
+}
+
+} // namespace
+
+SessionRecorder::SessionRecorder(const std::string& path)
+    : file(path), start(Clock::now()) {
+    if (!file) {
+        throw std::runtime_error("can't write session to " + path);
+    }
+    file.precision(std::numeric_limits<double>::max_digits10);
+}
+
+std::ostream& SessionRecorder::event(const char* name) {
+    const auto time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    return file << time.count() << ' ' << name;
+}
+
+void SessionRecorder::frame(const Map& map, std::array<uint16_t, 2> size) {
+    const std::string url = map.getStyleURL();
+    if (url != styleURL) {
+        styleURL = url;
+        if (!url.empty()) {
+            event("style") << ' ' << url << '\n';
+        }
+    }
+
+    const std::vector<std::string> current = map.getClasses();
+    if (!classes || *classes != current) {
+        classes = current;
+        const optional<Duration> transition = map.getTransitionOptions().duration;
+        auto& os = event("classes");
+        if (transition) {
+            os << ' ' << std::chrono::duration_cast<Milliseconds>(*transition).count();
+        } else {
+            os << " -";
+        }
+        os << ' ' << current.size();
+        for (const auto& name : current) {
+            os << ' ' << name;
+        }
+        os << '\n';
+    }
+
+    if (map.getDebug() != debug) {
+        debug = map.getDebug();
+        event("debug") << ' ' << EnumType(debug) << '\n';
+    }
+
+    const CameraOptions camera = map.getCameraOptions({});
+    event("frame") << ' ' << size[0] << ' ' << size[1]
+                   << ' ' << camera.center->latitude << ' ' << camera.center->longitude
+                   << ' ' << *camera.zoom << ' ' << *camera.angle << ' ' << *camera.pitch << '\n';
+}
+
+void SessionRecorder::addAnnotationIcon(const std::string& name, const SpriteImage& image) {
+    event("icon") << ' ' << name << ' ' << image.getWidth() << ' ' << image.getHeight()
+                  << ' ' << image.pixelRatio << '\n';
+}
+
+void SessionRecorder::addAnnotation(AnnotationID id, const Annotation& annotation) {
+    annotation.match(
+        [&] (const SymbolAnnotation& symbol) {
+            event("symbol") << ' ' << id << ' ' << symbol.icon
+                            << " point " << symbol.geometry.x << ' ' << symbol.geometry.y;
+        },
+        [&] (const LineAnnotation& line) {
+            event("line") << ' ' << id << ' ' << constant(line.opacity, 1.0f)
+                          << ' ' << constant(line.width, 1.0f)
+                          << ' ' << constant(line.color, Color::black());
+            writeGeometry(file, line.geometry);
+        },
+        [&] (const FillAnnotation& fill) {
+            auto& os = event("fill") << ' ' << id << ' ' << constant(fill.opacity, 1.0f)
+                                     << ' ' << constant(fill.color, Color::black());
+            if (fill.outlineColor.isConstant()) {
+                os << ' ' << fill.outlineColor.asConstant();
+            } else {
+                os << " -";
+            }
+            writeGeometry(file, fill.geometry);
+        },
+        [&] (const StyleSourcedAnnotation& annotation_) {
+            event("layer") << ' ' << id << ' ' << annotation_.layerID;
+            writeGeometry(file, annotation_.geometry);
+        });
+    file << '\n';
+}
+
+void SessionRecorder::removeAnnotation(AnnotationID id) {
+    event("remove") << ' ' << id << '\n';
+}
+
+Session::Session(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("can't read session from " + path);
+    }
+
+    // From the IDs of the recorded annotations to those of the replayed ones.
+    auto ids = std::make_shared<std::unordered_map<AnnotationID, AnnotationID>>();
+    auto add = [ids] (AnnotationID id, Annotation annotation) {
+        return [ids, id, annotation] (Map& map) {
+            (*ids)[id] = map.addAnnotation(annotation);
+        };
+    };
+
+    Frame next;
+    std::string line;
+    for (std::size_t number = 1; std::getline(file, line); ++number) {
+        if (line.empty()) {
+            continue;
+        }
+        Fields fields(line, number);
+        const auto time = fields.read<int64_t>();
+        const auto type = fields.read<std::string>();
+
+        if (type == "frame") {
+            next.time = std::chrono::duration_cast<Duration>(std::chrono::microseconds(time));
+            next.size[0] = fields.read<uint16_t>();
+            next.size[1] = fields.read<uint16_t>();
+            const auto latitude = fields.read<double>();
+            next.camera.center = LatLng(latitude, fields.read<double>());
+            next.camera.zoom = fields.read<double>();
+            next.camera.angle = fields.read<double>();
+            next.camera.pitch = fields.read<double>();
+            frames.push_back(std::move(next));
+            next = Frame();
+        } else if (type == "style") {
+            next.styleURL = fields.read<std::string>();
+        } else if (type == "classes") {
+            style::TransitionOptions transition;
+            const auto duration = fields.read<std::string>();
+            if (duration != "-") {
+                transition.duration = Milliseconds(std::stoll(duration));
+            }
+            std::vector<std::string> classes(fields.read<std::size_t>());
+            for (auto& name : classes) {
+                name = fields.read<std::string>();
+            }
+            next.changes.push_back([transition, classes] (Map& map) {
+                map.setTransitionOptions(transition);
+                map.setClasses(classes);
+            });
+        } else if (type == "debug") {
+            const auto debug = MapDebugOptions(fields.read<EnumType>());
+            next.changes.push_back([debug] (Map& map) {
+                map.setDebug(debug);
+            });
+        } else if (type == "icon") {
+            const auto name = fields.read<std::string>();
+            const auto width = fields.read<float>();
+            const auto height = fields.read<float>();
+            const auto image = solidImage(width, height, fields.read<float>());
+            next.changes.push_back([name, image] (Map& map) {
+                map.addAnnotationIcon(name, image);
+            });
+        } else if (type == "symbol") {
+            const auto id = fields.read<AnnotationID>();
+            SymbolAnnotation symbol;
+            symbol.icon = fields.read<std::string>();
+            fields.read<std::string>(); // point
+            symbol.geometry.x = fields.read<double>();
+            symbol.geometry.y = fields.read<double>();
+            next.changes.push_back(add(id, symbol));
+        } else if (type == "line") {
+            const auto id = fields.read<AnnotationID>();
+            LineAnnotation annotation { LineString<double>() };
+            annotation.opacity = fields.read<float>();
+            annotation.width = fields.read<float>();
+            annotation.color = fields.color();
+            annotation.geometry = fields.geometry();
+            next.changes.push_back(add(id, annotation));
+        } else if (type == "fill") {
+            const auto id = fields.read<AnnotationID>();
+            FillAnnotation annotation { LineString<double>() };
+            annotation.opacity = fields.read<float>();
+            annotation.color = fields.color();
+            const auto outline = fields.read<std::string>();
+            if (outline != "-") {
+                Color color;
+                color.r = std::stof(outline);
+                color.g = fields.read<float>();
+                color.b = fields.read<float>();
+                color.a = fields.read<float>();
+                annotation.outlineColor = color;
+            }
+            annotation.geometry = fields.geometry();
+            next.changes.push_back(add(id, annotation));
+        } else if (type == "layer") {
+            const auto id = fields.read<AnnotationID>();
+            const auto layerID = fields.read<std::string>();
+            next.changes.push_back(add(id, StyleSourcedAnnotation { fields.geometry(), layerID }));
+        } else if (type == "remove") {
+            const auto id = fields.read<AnnotationID>();
+            next.changes.push_back([ids, id] (Map& map) {
+                auto it = ids->find(id);
+                if (it != ids->end()) {
+                    map.removeAnnotation(it->second);
+                    ids->erase(it);
+                }
+            });
+        } else {
+            throw std::runtime_error("unknown event '" + type + "' on session line " + std::to_string(number));
+        }
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,143 @@
+#include <mbgl/platform/default/shared_thread_pool.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+
+SharedThreadPool::State::State(double weight_, std::size_t maxConcurrency_)
+    : weight(weight_),
+      maxConcurrency(maxConcurrency_) {
+    assert(weight > 0);
+}
+
+SharedThreadPool::SharedThreadPool(std::size_t count) {
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([this] () {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            while (true) {
+                std::weak_ptr<Mailbox> mailbox;
+                std::shared_ptr<State> state;
+
+                cv.wait(lock, [&] {
+                    return terminate || (state = pop(mailbox));
+                });
+
+                if (terminate) {
+                    return;
+                }
+
+                lock.unlock();
+
+                const TimePoint start = Clock::now();
+                Mailbox::maybeReceive(mailbox);
+                const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+                lock.lock();
+
+                state->usage += elapsed.count() / state->weight;
+
+                // If this share was at its concurrency limit, its queued work can run now.
+                if (state->running-- == state->maxConcurrency && state->queued > 0) {
+                    cv.notify_one();
+                }
+            }
+        });
+    }
+}
+
+SharedThreadPool::~SharedThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        terminate = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::unique_ptr<SharedThreadPool::Share> SharedThreadPool::createShare(double weight, std::size_t maxConcurrency) {
+    auto state = std::make_shared<State>(weight, maxConcurrency);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.push_back(state);
+    }
+
+    return std::unique_ptr<Share>(new Share(*this, std::move(state)));
+}
+
+void SharedThreadPool::remove(const std::shared_ptr<State>& state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    states.erase(std::remove(states.begin(), states.end(), state), states.end());
+}
+
+void SharedThreadPool::schedule(State& state, std::weak_ptr<Mailbox> mailbox) {
+    const auto priority = static_cast<std::size_t>(Mailbox::getPriority(mailbox));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // Don't let a share bank credit while it had nothing to do.
+        if (state.queued == 0 && state.running == 0) {
+            state.usage = std::max(state.usage, usageFloor);
+        }
+
+        state.queues[priority].push(std::move(mailbox));
+        ++state.queued;
+    }
+
+    cv.notify_one();
+}
+
+std::shared_ptr<SharedThreadPool::State> SharedThreadPool::pop(std::weak_ptr<Mailbox>& mailbox) {
+    for (std::size_t priority = 0; priority < Mailbox::PriorityCount; ++priority) {
+        std::shared_ptr<State>* best = nullptr;
+
+        for (auto& state : states) {
+            if (state->queues[priority].empty() ||
+                (state->maxConcurrency && state->running >= state->maxConcurrency)) {
+                continue;
+            }
+            if (!best || state->usage < (*best)->usage) {
+                best = &state;
+            }
+        }
+
+        if (best) {
+            State& state = **best;
+            mailbox = std::move(state.queues[priority].front());
+            state.queues[priority].pop();
+            --state.queued;
+            ++state.running;
+            usageFloor = state.usage;
+            return *best;
+        }
+    }
+
+    return nullptr;
+}
+
+SharedThreadPool::Share::Share(SharedThreadPool& pool_, std::shared_ptr<State> state_)
+    : pool(pool_),
+      state(std::move(state_)) {
+}
+
+SharedThreadPool::Share::~Share() {
+    // Mailboxes that are still queued are dropped. Those that are running keep the state alive
+    // until they're done.
+    pool.remove(state);
+}
+
+void SharedThreadPool::Share::schedule(std::weak_ptr<Mailbox> mailbox) {
+    pool.schedule(*state, std::move(mailbox));
+}
+
+} // namespace mbgl
@@ -5,9 +5,11 @@
 #include <cstring>
 #include <cstdio>
 #include <chrono>
+#include <utility>
 #include <experimental/optional>
 
 #include <mbgl/platform/log.hpp>
+#include <mbgl/util/instrumentation.hpp>
 
 namespace mapbox {
 namespace sqlite {
@@ -107,6 +109,14 @@ uint64_t Database::changes() const {
     return sqlite3_changes(db);
 }
 
+std::size_t Database::cacheMemoryUsed() const {
+    assert(db);
+    int current = 0;
+    int highwater = 0;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0);
+    return current;
+}
+
 Statement::Statement(sqlite3 *db, const char *sql) {
     const int err = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (err != SQLITE_OK) {
@@ -261,6 +271,7 @@ void Statement::bind(
 
 bool Statement::run() {
     assert(stmt);
+    mbgl::util::Instrumentation::Timer timer(mbgl::util::Instrumentation::Counter::SQLiteStatement);
     const int err = sqlite3_step(stmt);
     if (err == SQLITE_DONE) {
         return false;
@@ -329,6 +340,16 @@ template <> optional<double> Statement::get(int offset) {
     }
 }
 
+template <> optional<std::pair<const char*, std::size_t>> Statement::get(int offset) {
+    assert(stmt);
+    if (sqlite3_column_type(stmt, offset) == SQLITE_NULL) {
+        return optional<std::pair<const char*, std::size_t>>();
+    } else {
+        return std::make_pair(reinterpret_cast<const char *>(sqlite3_column_blob(stmt, offset)),
+                              size_t(sqlite3_column_bytes(stmt, offset)));
+    }
+}
+
 template <> optional<std::string> Statement::get(int offset) {
     assert(stmt);
     if (sqlite3_column_type(stmt, offset) == SQLITE_NULL) {
@@ -50,6 +50,9 @@ public:
     int64_t lastInsertRowid() const;
     uint64_t changes() const;
 
+    // The memory held by the connection's page cache, in bytes.
+    std::size_t cacheMemoryUsed() const;
+
 private:
     sqlite3 *db = nullptr;
 };
@@ -79,6 +82,8 @@ public:
     void bindBlob(int offset, const void *, std::size_t length, bool retain = true);
     void bindBlob(int offset, const std::vector<uint8_t>&, bool retain = true);
 
+    // get<optional<std::pair<const char*, std::size_t>>>() returns a view of a blob column
+    // rather than a copy. It's valid until the statement is run again, reset or destroyed.
     template <typename T> T get(int offset);
 
     bool run();
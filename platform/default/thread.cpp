@@ -1,7 +1,11 @@
 #include <mbgl/platform/platform.hpp>
 #include <mbgl/platform/log.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <thread>
 
 #include <pthread.h>
 #include <sched.h>
@@ -33,5 +37,69 @@ void makeThreadLowPriority() {
     }
 }
 
+// Parses a kernel CPU list such as "0-3,8-11".
+static std::vector<std::size_t> parseCPUList(const std::string& list) {
+    std::vector<std::size_t> cpus;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        const auto dash = range.find('-');
+        try {
+            const std::size_t first = std::stoul(range.substr(0, dash));
+            const std::size_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (std::size_t cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Ignore malformed ranges.
+        }
+    }
+    return cpus;
+}
+
+std::vector<std::vector<std::size_t>> getNUMANodes() {
+    std::vector<std::vector<std::size_t>> nodes;
+
+    for (std::size_t node = 0;; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (!file || !std::getline(file, list)) {
+            break;
+        }
+
+        auto cpus = parseCPUList(list);
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+
+    if (nodes.empty()) {
+        nodes.emplace_back();
+        const std::size_t count = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t cpu = 0; cpu < count; ++cpu) {
+            nodes.back().push_back(cpu);
+        }
+    }
+
+    return nodes;
+}
+
+bool setCurrentThreadAffinity(const std::vector<std::size_t>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (CPU_COUNT(&set) == 0 || pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        Log::Warning(Event::General, "Couldn't set thread affinity");
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace platform
 } // namespace mbgl
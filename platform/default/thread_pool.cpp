@@ -1,29 +1,53 @@
 #include <mbgl/platform/default/thread_pool.hpp>
+#include <mbgl/platform/platform.hpp>
 #include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
-ThreadPool::ThreadPool(std::size_t count) {
+ThreadPool::ThreadPool(std::size_t count, ThreadAffinity affinity)
+    : current(std::make_unique<util::ThreadLocal<Node>>()) {
+    if (affinity == ThreadAffinity::NUMA) {
+        auto cpus = platform::getNUMANodes();
+        // Every node needs at least one thread.
+        cpus.resize(std::max<std::size_t>(1, std::min(cpus.size(), count)));
+        for (auto& nodeCPUs : cpus) {
+            nodes.push_back({ nodes.size(), std::move(nodeCPUs), {} });
+        }
+    } else {
+        nodes.push_back({ 0, {}, {} });
+    }
+
     threads.reserve(count);
     for (std::size_t i = 0; i < count; ++i) {
-        threads.emplace_back([this] () {
+        Node& node = nodes[i % nodes.size()];
+        threads.emplace_back([this, &node] () {
+            if (!node.cpus.empty()) {
+                platform::setCurrentThreadAffinity(node.cpus);
+            }
+            current->set(&node);
+
             while (true) {
                 std::unique_lock<std::mutex> lock(mutex);
 
                 cv.wait(lock, [this] {
-                    return !queue.empty() || terminate;
+                    return !empty() || terminate;
                 });
 
                 if (terminate) {
-                    return;
+                    break;
                 }
 
-                auto mailbox = queue.front();
-                queue.pop();
+                std::weak_ptr<Mailbox> mailbox = pop(node.index);
                 lock.unlock();
 
                 Mailbox::maybeReceive(mailbox);
             }
+
+            // util::ThreadLocal deletes non-null values on thread exit; nodes are owned by the pool.
+            current->set(nullptr);
         });
     }
 }
@@ -41,10 +65,53 @@ ThreadPool::~ThreadPool() {
     }
 }
 
+bool ThreadPool::empty() const {
+    for (const auto& node : nodes) {
+        for (const auto& queue : node.queues) {
+            if (!queue.empty()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::weak_ptr<Mailbox> ThreadPool::pop(std::size_t index) {
+    std::weak_ptr<Mailbox> mailbox;
+    for (std::size_t priority = 0; priority < Mailbox::PriorityCount; ++priority) {
+        // Prefer this thread's own node, then take from the others.
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            auto& queue = nodes[(index + i) % nodes.size()].queues[priority];
+            if (!queue.empty()) {
+                mailbox = std::move(queue.front());
+                queue.pop();
+                return mailbox;
+            }
+        }
+    }
+    return mailbox;
+}
+
+std::size_t ThreadPool::nodeFor(const std::weak_ptr<Mailbox>& weak) {
+    if (nodes.size() == 1) {
+        return 0;
+    }
+
+    Node* here = current->get();
+    const std::size_t preferred = here ? here->index : nextNode++ % nodes.size();
+
+    if (auto mailbox = weak.lock()) {
+        return mailbox->assignAffinity(preferred) % nodes.size();
+    }
+    return preferred;
+}
+
 void ThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    const auto priority = static_cast<std::size_t>(Mailbox::getPriority(mailbox));
+
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(mailbox);
+        nodes[nodeFor(mailbox)].queues[priority].push(std::move(mailbox));
     }
 
     cv.notify_one();
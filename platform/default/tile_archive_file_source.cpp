@@ -0,0 +1,268 @@
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/storage/offline_pack.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include "sqlite3.hpp"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+
+namespace mbgl {
+
+namespace {
+
+const std::string mbtilesProtocol = "mbtiles://";
+const std::string packProtocol = "pack://";
+
+bool hasProtocol(const std::string& url, const std::string& protocol) {
+    return url.compare(0, protocol.size(), protocol) == 0;
+}
+
+struct TileAddress {
+    int8_t z;
+    int32_t x;
+    int32_t y;
+};
+
+bool parseCoordinate(const std::string& path, std::size_t begin, std::size_t end, int64_t& result) {
+    if (begin == end || end - begin > 10 ||
+        !std::all_of(path.begin() + begin, path.begin() + end, [] (char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    result = std::strtoll(path.c_str() + begin, nullptr, 10);
+    return true;
+}
+
+// Removes the trailing /{z}/{x}/{y} of a path to a tile, with any extension after {y}, so
+// that only the path to the archive remains.
+optional<TileAddress> splitTilePath(std::string& path) {
+    const std::size_t ySlash = path.rfind('/');
+    const std::size_t xSlash = ySlash == std::string::npos || ySlash == 0 ? std::string::npos : path.rfind('/', ySlash - 1);
+    const std::size_t zSlash = xSlash == std::string::npos || xSlash == 0 ? std::string::npos : path.rfind('/', xSlash - 1);
+    if (zSlash == std::string::npos) {
+        return {};
+    }
+
+    const std::size_t yEnd = std::min(path.find('.', ySlash), path.size());
+    int64_t z, x, y;
+    if (!parseCoordinate(path, zSlash + 1, xSlash, z) ||
+        !parseCoordinate(path, xSlash + 1, ySlash, x) ||
+        !parseCoordinate(path, ySlash + 1, yEnd, y) ||
+        z > 30 || x >= (int64_t(1) << z) || y >= (int64_t(1) << z)) {
+        return {};
+    }
+
+    path.erase(zSlash);
+    return TileAddress { int8_t(z), int32_t(x), int32_t(y) };
+}
+
+bool isFile(const std::string& path) {
+    struct stat buf;
+    return stat(path.c_str(), &buf) == 0 && S_ISREG(buf.st_mode);
+}
+
+Response notFound(const std::string& message) {
+    Response response;
+    response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound, message);
+    return response;
+}
+
+// A read-only connection to an MBTiles file, whose rows are numbered from the south, as in TMS.
+class MBTiles {
+public:
+    explicit MBTiles(const std::string& path)
+        : db(path, mapbox::sqlite::ReadOnly),
+          tileStatement(db.prepare(
+              "SELECT tile_data FROM tiles WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3")) {
+    }
+
+    Response tile(const TileAddress& id) {
+        tileStatement.reset();
+        tileStatement.bind(1, int64_t(id.z));
+        tileStatement.bind(2, int64_t(id.x));
+        tileStatement.bind(3, (int64_t(1) << id.z) - 1 - id.y);
+
+        Response response;
+        optional<std::pair<const char*, std::size_t>> data;
+        if (tileStatement.run()) {
+            data = tileStatement.get<optional<std::pair<const char*, std::size_t>>>(0);
+        }
+
+        // Vector tiles are usually gzipped, and are inflated straight out of SQLite's buffer.
+        if (!data) {
+            response.noContent = true;
+        } else if (data->second >= 2 && uint8_t(data->first[0]) == 0x1F && uint8_t(data->first[1]) == 0x8B) {
+            response.data = std::make_shared<std::string>(util::decompress(data->first, data->second));
+        } else {
+            response.data = std::make_shared<std::string>(data->first, data->second);
+        }
+
+        tileStatement.reset();
+        return response;
+    }
+
+    Response tileJSON(const std::string& url) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        writer.StartObject();
+        writer.Key("tilejson");
+        writer.String("2.0.0");
+        writer.Key("scheme");
+        writer.String("xyz");
+        writer.Key("tiles");
+        writer.StartArray();
+        const std::string tiles = url + "/{z}/{x}/{y}";
+        writer.String(tiles.c_str(), tiles.size());
+        writer.EndArray();
+
+        mapbox::sqlite::Statement metadata = db.prepare("SELECT name, value FROM metadata");
+        while (metadata.run()) {
+            const std::string name = metadata.get<std::string>(0);
+            const std::string value = metadata.get<std::string>(1);
+            if (name == "minzoom" || name == "maxzoom") {
+                char* end = nullptr;
+                const double zoom = std::strtod(value.c_str(), &end);
+                if (end != value.c_str()) {
+                    writer.Key(name.c_str(), name.size());
+                    writer.Double(zoom);
+                }
+            } else if (name == "bounds") {
+                // West, south, east, north.
+                double bounds[4];
+                const char* next = value.c_str();
+                std::size_t count = 0;
+                for (char* end = nullptr; count < 4; ++count, next = end + (*end == ',' ? 1 : 0)) {
+                    bounds[count] = std::strtod(next, &end);
+                    if (end == next) {
+                        break;
+                    }
+                }
+                if (count == 4) {
+                    writer.Key(name.c_str(), name.size());
+                    writer.StartArray();
+                    for (double bound : bounds) {
+                        writer.Double(bound);
+                    }
+                    writer.EndArray();
+                }
+            } else if (name == "name" || name == "description" || name == "version" || name == "attribution") {
+                writer.Key(name.c_str(), name.size());
+                writer.String(value.c_str(), value.size());
+            }
+        }
+
+        writer.EndObject();
+
+        Response response;
+        response.data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+        return response;
+    }
+
+private:
+    mapbox::sqlite::Database db;
+    mapbox::sqlite::Statement tileStatement;
+};
+
+} // namespace
+
+// Keeps each archive it reads open until it's destroyed. Offline packs are mapped by every
+// thread that reads them, but share the pages of the file.
+class TileArchiveFileSource::Impl {
+public:
+    void request(const std::string& url, uint8_t pixelRatio, FileSource::Callback callback) {
+        Response response;
+        try {
+            response = read(url, pixelRatio);
+        } catch (...) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other,
+                util::toString(std::current_exception()));
+        }
+        callback(response);
+    }
+
+private:
+    Response read(const std::string& url, uint8_t pixelRatio) {
+        const bool isPack = hasProtocol(url, packProtocol);
+        std::string path = util::percentDecode(url.substr(isPack ? packProtocol.size() : mbtilesProtocol.size()));
+        const optional<TileAddress> tile = splitTilePath(path);
+
+        if (isPack) {
+            if (!tile) {
+                return notFound("offline packs are read a tile at a time");
+            }
+            const OfflinePack* pack = open(packs, path);
+            if (!pack) {
+                return notFound(path + " doesn't exist");
+            }
+            optional<Response> response = pack->getTile(pixelRatio, tile->z, tile->x, tile->y);
+            if (!response) {
+                response = Response();
+                response->noContent = true;
+            }
+            return *response;
+        }
+
+        MBTiles* mbtiles = open(databases, path);
+        if (!mbtiles) {
+            return notFound(path + " doesn't exist");
+        }
+        try {
+            return tile ? mbtiles->tile(*tile) : mbtiles->tileJSON(url);
+        } catch (const mapbox::sqlite::Exception&) {
+            // Reconnects for the next read.
+            databases.erase(path);
+            throw;
+        }
+    }
+
+    template <class Archive>
+    Archive* open(std::unordered_map<std::string, std::unique_ptr<Archive>>& archives, const std::string& path) {
+        auto it = archives.find(path);
+        if (it == archives.end()) {
+            if (!isFile(path)) {
+                return nullptr;
+            }
+            it = archives.emplace(path, std::make_unique<Archive>(path)).first;
+        }
+        return it->second.get();
+    }
+
+    std::unordered_map<std::string, std::unique_ptr<MBTiles>> databases;
+    std::unordered_map<std::string, std::unique_ptr<OfflinePack>> packs;
+};
+
+TileArchiveFileSource::TileArchiveFileSource() = default;
+
+TileArchiveFileSource::~TileArchiveFileSource() = default;
+
+std::unique_ptr<AsyncRequest> TileArchiveFileSource::request(const Resource& resource, Callback callback) {
+    std::call_once(started, [&] {
+        const unsigned count = std::min(4u, std::max(2u, std::thread::hardware_concurrency()));
+        for (unsigned i = 0; i < count; ++i) {
+            threads.push_back(std::make_unique<util::Thread<Impl>>(
+                util::ThreadContext{"TileArchiveFileSource", util::ThreadPriority::Low}));
+        }
+    });
+
+    const uint8_t pixelRatio = resource.tileData ? resource.tileData->pixelRatio : 1;
+    return threads[nextThread++ % threads.size()]->invokeWithCallback(&Impl::request, resource.url, pixelRatio, callback);
+}
+
+bool TileArchiveFileSource::acceptsURL(const std::string& url) {
+    return hasProtocol(url, mbtilesProtocol) || hasProtocol(url, packProtocol);
+}
+
+} // namespace mbgl
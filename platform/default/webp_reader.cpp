@@ -1,5 +1,4 @@
 #include <mbgl/util/image.hpp>
-#include <mbgl/util/premultiply.hpp>
 #include <mbgl/platform/log.hpp>
 
 extern "C"
@@ -10,22 +9,32 @@ extern "C"
 namespace mbgl {
 
 PremultipliedImage decodeWebP(const uint8_t* data, size_t size) {
-    int width = 0, height = 0;
-    if (WebPGetInfo(data, size, &width, &height) == 0) {
+    WebPDecoderConfig config;
+    if (!WebPInitDecoderConfig(&config)) {
+        throw std::runtime_error("failed to initialize WebP decoder");
+    }
+
+    if (WebPGetFeatures(data, size, &config.input) != VP8_STATUS_OK) {
         throw std::runtime_error("failed to retrieve WebP basic header information");
     }
 
-    int stride = width * 4;
-    size_t webpSize = stride * height;
-    auto webp = std::make_unique<uint8_t[]>(webpSize);
+    PremultipliedImage image { static_cast<uint16_t>(config.input.width),
+                               static_cast<uint16_t>(config.input.height) };
+
+    // Let libwebp premultiply the pixels while it decodes them into the image.
+    config.output.colorspace = MODE_rgbA;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba = image.data.get();
+    config.output.u.RGBA.stride = image.width * 4;
+    config.output.u.RGBA.size = image.size();
 
-    if (!WebPDecodeRGBAInto(data, size, webp.get(), webpSize, stride)) {
+    const VP8StatusCode status = WebPDecode(data, size, &config);
+    WebPFreeDecBuffer(&config.output);
+    if (status != VP8_STATUS_OK) {
         throw std::runtime_error("failed to decode WebP data");
     }
 
-    UnassociatedImage image{ static_cast<uint16_t>(width), static_cast<uint16_t>(height),
-                             std::move(webp) };
-    return util::premultiply(std::move(image));
+    return image;
 }
 
 } // namespace mbgl
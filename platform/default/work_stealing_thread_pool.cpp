@@ -0,0 +1,248 @@
+#include <mbgl/platform/default/work_stealing_thread_pool.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace mbgl {
+
+// Bounded multi-producer/multi-consumer queue after Dmitry Vyukov's design. Every cell carries a
+// sequence number that tells producers and consumers whether it is free, filled, or still being
+// written, so the only shared writes are the two position counters.
+// Source: http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+class WorkStealingThreadPool::InjectionQueue {
+public:
+    InjectionQueue(std::size_t capacity)
+        : cells(new Cell[capacity]),
+          mask(capacity - 1) {
+        assert(capacity >= 2 && (capacity & mask) == 0);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(std::weak_ptr<Mailbox>& mailbox) {
+        Cell* cell;
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Full.
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->mailbox = std::move(mailbox);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(std::weak_ptr<Mailbox>& mailbox) {
+        Cell* cell;
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Empty.
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        mailbox = std::move(cell->mailbox);
+        cell->mailbox.reset();
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        std::weak_ptr<Mailbox> mailbox;
+    };
+
+    const std::unique_ptr<Cell[]> cells;
+    const std::size_t mask;
+
+    // Keep the producer and consumer positions on separate cache lines.
+    alignas(64) std::atomic<std::size_t> enqueuePos { 0 };
+    alignas(64) std::atomic<std::size_t> dequeuePos { 0 };
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::size_t count)
+    : current(std::make_unique<util::ThreadLocal<Worker>>()) {
+    for (std::size_t priority = 0; priority < Mailbox::PriorityCount; ++priority) {
+        injection[priority] = std::make_unique<InjectionQueue>(1024);
+        overflowed[priority] = 0;
+        pending[priority] = 0;
+    }
+
+    // All workers need to exist before the first thread starts stealing from them.
+    workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+        workers[i]->thread = std::thread([this, i] () {
+            run(i);
+        });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        terminate = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+void WorkStealingThreadPool::schedule(std::weak_ptr<Mailbox> mailbox) {
+    const auto priority = static_cast<std::size_t>(Mailbox::getPriority(mailbox));
+
+    ++pending[priority];
+
+    if (Worker* worker = current->get()) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->queues[priority].push_back(std::move(mailbox));
+    } else if (!injection[priority]->push(mailbox)) {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflow[priority].push_back(std::move(mailbox));
+        ++overflowed[priority];
+    }
+
+    if (sleeping > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        cv.notify_one();
+    }
+}
+
+bool WorkStealingThreadPool::hasPending() const {
+    for (const auto& count : pending) {
+        if (count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::run(std::size_t index) {
+    current->set(workers[index].get());
+
+    for (std::size_t tick = 0; !terminate; ++tick) {
+        std::weak_ptr<Mailbox> mailbox;
+        if (pop(index, tick, mailbox)) {
+            Mailbox::maybeReceive(mailbox);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        ++sleeping;
+        cv.wait(lock, [this] {
+            return hasPending() || terminate;
+        });
+        --sleeping;
+    }
+
+    // util::ThreadLocal deletes non-null values on thread exit; the worker is owned by the pool.
+    current->set(nullptr);
+}
+
+bool WorkStealingThreadPool::pop(std::size_t index, std::size_t tick, std::weak_ptr<Mailbox>& mailbox) {
+    Worker& worker = *workers[index];
+
+    for (std::size_t priority = 0; priority < Mailbox::PriorityCount; ++priority) {
+        if (pending[priority] == 0) {
+            continue;
+        }
+
+        // Look at the shared queue first every once in a while, so that mailboxes which keep
+        // rescheduling themselves locally can't starve work scheduled from outside the pool.
+        if (tick % 61 == 0 && popGlobal(priority, mailbox)) {
+            return true;
+        }
+
+        if (popLocal(worker, priority, mailbox) ||
+            popGlobal(priority, mailbox) ||
+            steal(index, priority, mailbox)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WorkStealingThreadPool::popLocal(Worker& worker, std::size_t priority, std::weak_ptr<Mailbox>& mailbox) {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    auto& queue = worker.queues[priority];
+    if (queue.empty()) {
+        return false;
+    }
+
+    mailbox = std::move(queue.front());
+    queue.pop_front();
+    --pending[priority];
+    return true;
+}
+
+bool WorkStealingThreadPool::popGlobal(std::size_t priority, std::weak_ptr<Mailbox>& mailbox) {
+    if (injection[priority]->pop(mailbox)) {
+        --pending[priority];
+        return true;
+    }
+
+    if (overflowed[priority] == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    auto& queue = overflow[priority];
+    if (queue.empty()) {
+        return false;
+    }
+
+    mailbox = std::move(queue.front());
+    queue.pop_front();
+    --overflowed[priority];
+    --pending[priority];
+    return true;
+}
+
+bool WorkStealingThreadPool::steal(std::size_t index, std::size_t priority, std::weak_ptr<Mailbox>& mailbox) {
+    for (std::size_t i = 1; i < workers.size(); ++i) {
+        Worker& victim = *workers[(index + i) % workers.size()];
+
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        auto& queue = victim.queues[priority];
+        if (!queue.empty()) {
+            mailbox = std::move(queue.back());
+            queue.pop_back();
+            --pending[priority];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace mbgl
@@ -11,6 +11,9 @@ mason_use(benchmark VERSION 1.0.0)
 
 include(cmake/loop-uv.cmake)
 
+# EGL renders on GPUs, or with Mesa's software renderer, without an X server.
+option(WITH_EGL "Use EGL instead of GLX for headless rendering" OFF)
+
 macro(mbgl_platform_core)
     target_sources(mbgl-core
         # File source
@@ -19,6 +22,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/local_file_source.cpp
         PRIVATE platform/default/http_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
+        PRIVATE platform/default/tile_archive_file_source.cpp
 
         # Offline
         PRIVATE platform/default/mbgl/storage/offline.cpp
@@ -26,6 +30,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/storage/offline_database.hpp
         PRIVATE platform/default/mbgl/storage/offline_download.cpp
         PRIVATE platform/default/mbgl/storage/offline_download.hpp
+        PRIVATE platform/default/mbgl/storage/offline_pack.cpp
+        PRIVATE platform/default/mbgl/storage/offline_pack.hpp
         PRIVATE platform/default/sqlite3.cpp
         PRIVATE platform/default/sqlite3.hpp
 
@@ -43,16 +49,25 @@ macro(mbgl_platform_core)
         # Headless view
         PRIVATE platform/default/headless_display.cpp
         PRIVATE platform/default/headless_view.cpp
-        PRIVATE platform/default/headless_view_glx.cpp
 
         # Thread pool
         PRIVATE platform/default/thread_pool.cpp
+        PRIVATE platform/default/work_stealing_thread_pool.cpp
+        PRIVATE platform/default/shared_thread_pool.cpp
     )
 
     target_include_directories(mbgl-core
         PRIVATE platform/default
     )
 
+    if(WITH_EGL)
+        target_sources(mbgl-core PRIVATE platform/default/headless_view_egl.cpp)
+        target_compile_definitions(mbgl-core PUBLIC MBGL_USE_EGL=1)
+        target_link_libraries(mbgl-core PUBLIC -lEGL)
+    else()
+        target_sources(mbgl-core PRIVATE platform/default/headless_view_glx.cpp)
+    endif()
+
     target_add_mason_package(mbgl-core PUBLIC sqlite)
     target_add_mason_package(mbgl-core PUBLIC nunicode)
     target_add_mason_package(mbgl-core PUBLIC libpng)
@@ -82,6 +97,13 @@ macro(mbgl_platform_render)
 endmacro()
 
 
+macro(mbgl_platform_replay)
+    target_link_libraries(mbgl-replay
+        PRIVATE mbgl-loop
+    )
+endmacro()
+
+
 macro(mbgl_platform_offline)
     target_link_libraries(mbgl-offline
         PRIVATE mbgl-loop
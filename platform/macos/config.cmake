@@ -15,6 +15,7 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/default_file_source.cpp
         PRIVATE platform/default/local_file_source.cpp
         PRIVATE platform/default/online_file_source.cpp
+        PRIVATE platform/default/tile_archive_file_source.cpp
 
         # Offline
         PRIVATE platform/default/mbgl/storage/offline.cpp
@@ -22,6 +23,8 @@ macro(mbgl_platform_core)
         PRIVATE platform/default/mbgl/storage/offline_database.hpp
         PRIVATE platform/default/mbgl/storage/offline_download.cpp
         PRIVATE platform/default/mbgl/storage/offline_download.hpp
+        PRIVATE platform/default/mbgl/storage/offline_pack.cpp
+        PRIVATE platform/default/mbgl/storage/offline_pack.hpp
         PRIVATE platform/default/sqlite3.cpp
         PRIVATE platform/default/sqlite3.hpp
 
@@ -41,6 +44,8 @@ macro(mbgl_platform_core)
 
         # Thread pool
         PRIVATE platform/default/thread_pool.cpp
+        PRIVATE platform/default/work_stealing_thread_pool.cpp
+        PRIVATE platform/default/shared_thread_pool.cpp
     )
 
     target_add_mason_package(mbgl-core PUBLIC geojson)
@@ -81,6 +86,19 @@ macro(mbgl_platform_render)
 endmacro()
 
 
+macro(mbgl_platform_replay)
+    target_link_libraries(mbgl-replay
+        PRIVATE mbgl-loop
+        PRIVATE "-framework Foundation"
+        PRIVATE "-framework CoreGraphics"
+        PRIVATE "-framework OpenGL"
+        PRIVATE "-framework ImageIO"
+        PRIVATE "-framework CoreServices"
+        PRIVATE "-lsqlite3"
+    )
+endmacro()
+
+
 macro(mbgl_platform_offline)
     target_link_libraries(mbgl-offline
         PRIVATE mbgl-loop
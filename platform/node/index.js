@@ -3,29 +3,42 @@
 // Shim to wrap req.respond while preserving callback-passing API
 
 var mbgl = require('../../lib/mapbox-gl-native.node');
-var constructor = mbgl.Map.prototype.constructor;
 
-var Map = function(options) {
-    if (!(options instanceof Object)) {
-        throw TypeError("Requires an options object as first argument");
-    }
+function wrap(constructor) {
+    var wrapped = function(options) {
+        if (!(options instanceof Object)) {
+            throw TypeError("Requires an options object as first argument");
+        }
 
-    if (!options.hasOwnProperty('request') || !(options.request instanceof Function)) {
-        throw TypeError("Options object must have a 'request' method");
-    }
+        if (!options.hasOwnProperty('request') || !(options.request instanceof Function)) {
+            throw TypeError("Options object must have a 'request' method");
+        }
 
-    var request = options.request;
+        var request = options.request;
 
-    return new constructor(Object.assign(options, {
-        request: function(req) {
+        function wrappedRequest(req) {
             request(req, function() {
                 req.respond.apply(req, arguments);
             });
         }
-    }));
-};
-
-Map.prototype = mbgl.Map.prototype;
-Map.prototype.constructor = Map;
 
-module.exports = Object.assign(mbgl, { Map: Map });
+        // The requests made in one turn of the event loop arrive together.
+        return new constructor(Object.assign(options, {
+            request: wrappedRequest,
+            requests: function(reqs) {
+                for (var i = 0; i < reqs.length; i++) {
+                    wrappedRequest(reqs[i]);
+                }
+            }
+        }));
+    };
+
+    wrapped.prototype = constructor.prototype;
+    wrapped.prototype.constructor = wrapped;
+    return wrapped;
+}
+
+module.exports = Object.assign(mbgl, {
+    Map: wrap(mbgl.Map.prototype.constructor),
+    MapPool: wrap(mbgl.MapPool.prototype.constructor)
+});
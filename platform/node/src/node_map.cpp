@@ -9,6 +9,7 @@
 #include <mbgl/style/conversion/source.hpp>
 #include <mbgl/style/conversion/layer.hpp>
 #include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
 
 #include <unistd.h>
 
@@ -20,21 +21,9 @@
 
 namespace node_mbgl {
 
-struct NodeMap::RenderOptions {
-    double zoom = 0;
-    double bearing = 0;
-    double pitch = 0;
-    double latitude = 0;
-    double longitude = 0;
-    unsigned int width = 512;
-    unsigned int height = 512;
-    std::vector<std::string> classes;
-    mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
-};
-
 Nan::Persistent<v8::Function> NodeMap::constructor;
 
-static std::shared_ptr<mbgl::HeadlessDisplay> sharedDisplay() {
+std::shared_ptr<mbgl::HeadlessDisplay> NodeMap::sharedDisplay() {
     static auto display = std::make_shared<mbgl::HeadlessDisplay>();
     return display;
 }
@@ -43,6 +32,50 @@ static const char* releasedMessage() {
     return "Map resources have already been released";
 }
 
+namespace {
+
+// Encodes a rendered image as a PNG off the main thread, and hands the PNG's memory over to the
+// Buffer it's called back with.
+class EncodeWorker : public Nan::AsyncWorker {
+public:
+    EncodeWorker(Nan::Callback* callback_, mbgl::PremultipliedImage&& image_)
+        : AsyncWorker(callback_),
+          image(std::move(image_)) {
+    }
+
+    void Execute() override {
+        try {
+            png = std::make_unique<std::string>(mbgl::encodePNG(image));
+        } catch (const std::exception& ex) {
+            SetErrorMessage(ex.what());
+        }
+        image.data.reset();
+    }
+
+    void HandleOKCallback() override {
+        Nan::HandleScope scope;
+
+        std::string* data = png.release();
+        v8::Local<v8::Value> argv[] = {
+            Nan::Null(),
+            Nan::NewBuffer(&(*data)[0], data->size(),
+                // Retain the data until the buffer is deleted.
+                [](char *, void * hint) {
+                    delete reinterpret_cast<std::string*>(hint);
+                },
+                data
+            ).ToLocalChecked()
+        };
+        callback->Call(2, argv);
+    }
+
+private:
+    mbgl::PremultipliedImage image;
+    std::unique_ptr<std::string> png;
+};
+
+} // namespace
+
 void NodeMap::Init(v8::Local<v8::Object> target) {
     v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
 
@@ -272,6 +305,15 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
         }
     }
 
+    if (Nan::Has(obj, Nan::New("format").ToLocalChecked()).FromJust()) {
+        const std::string format = *Nan::Utf8String(Nan::Get(obj, Nan::New("format").ToLocalChecked()).ToLocalChecked());
+        if (format == "png") {
+            options.format = RenderOptions::Format::PNG;
+        } else if (format != "raw") {
+            throw mbgl::util::Exception("Options object 'format' property must be 'raw' or 'png'");
+        }
+    }
+
     if (Nan::Has(obj, Nan::New("debug").ToLocalChecked()).FromJust()) {
         auto debug = Nan::To<v8::Object>(Nan::Get(obj, Nan::New("debug").ToLocalChecked()).ToLocalChecked()).ToLocalChecked();
         if (Nan::Has(debug, Nan::New("tileBorders").ToLocalChecked()).FromJust()) {
@@ -316,6 +358,8 @@ NodeMap::RenderOptions NodeMap::ParseOptions(v8::Local<v8::Object> obj) {
  * of the map
  * @param {number} [options.bearing=0] rotation
  * @param {Array<string>} [options.classes=[]] style classes
+ * @param {string} [options.format='raw'] 'raw' for premultiplied RGBA pixels, or 'png' for a
+ * PNG encoded off the main thread
  * @param {Function} callback
  * @returns {undefined} calls callback
  * @throws {Error} if stylesheet is not loaded or if map is already rendering
@@ -340,7 +384,12 @@ void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
         return Nan::ThrowError("Map is currently rendering an image");
     }
 
-    auto options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    RenderOptions options;
+    try {
+        options = ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    } catch (const mbgl::util::Exception &ex) {
+        return Nan::ThrowTypeError(ex.what());
+    }
 
     assert(!nodeMap->callback);
     assert(!nodeMap->image.data);
@@ -355,14 +404,19 @@ void NodeMap::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
     info.GetReturnValue().SetUndefined();
 }
 
-void NodeMap::startRender(NodeMap::RenderOptions options) {
+void NodeMap::applyOptions(mbgl::Map& map, mbgl::HeadlessView& view, const RenderOptions& options) {
     view.resize(options.width, options.height);
-    map->update(mbgl::Update::Dimensions);
-    map->setClasses(options.classes);
-    map->setLatLngZoom(mbgl::LatLng(options.latitude, options.longitude), options.zoom);
-    map->setBearing(options.bearing);
-    map->setPitch(options.pitch);
-    map->setDebug(options.debugOptions);
+    map.update(mbgl::Update::Dimensions);
+    map.setClasses(options.classes);
+    map.setLatLngZoom(mbgl::LatLng(options.latitude, options.longitude), options.zoom);
+    map.setBearing(options.bearing);
+    map.setPitch(options.pitch);
+    map.setDebug(options.debugOptions);
+}
+
+void NodeMap::startRender(NodeMap::RenderOptions options) {
+    applyOptions(*map, view, options);
+    format = options.format;
 
     map->renderStill([this](const std::exception_ptr eptr, mbgl::PremultipliedImage&& result) {
         if (eptr) {
@@ -404,16 +458,8 @@ void NodeMap::renderFinished() {
     assert(!image.data);
 
     if (error) {
-        std::string errorMessage;
-
-        try {
-            std::rethrow_exception(error);
-        } catch (const std::exception& ex) {
-            errorMessage = ex.what();
-        }
-
         v8::Local<v8::Value> argv[] = {
-            Nan::Error(errorMessage.c_str())
+            renderError(std::move(error))
         };
 
         // This must be empty to be prepared for the next render call.
@@ -422,21 +468,7 @@ void NodeMap::renderFinished() {
 
         cb->Call(1, argv);
     } else if (img.data) {
-        v8::Local<v8::Object> pixels = Nan::NewBuffer(
-            reinterpret_cast<char *>(img.data.get()), img.size(),
-            // Retain the data until the buffer is deleted.
-            [](char *, void * hint) {
-                delete [] reinterpret_cast<uint8_t*>(hint);
-            },
-            img.data.get()
-        ).ToLocalChecked();
-        img.data.release();
-
-        v8::Local<v8::Value> argv[] = {
-            Nan::Null(),
-            pixels
-        };
-        cb->Call(2, argv);
+        deliverImage(std::move(cb), std::move(img), format);
     } else {
         v8::Local<v8::Value> argv[] = {
             Nan::Error("Didn't get an image")
@@ -445,6 +477,45 @@ void NodeMap::renderFinished() {
     }
 }
 
+v8::Local<v8::Value> NodeMap::renderError(std::exception_ptr eptr) {
+    std::string errorMessage;
+
+    try {
+        std::rethrow_exception(eptr);
+    } catch (const std::exception& ex) {
+        errorMessage = ex.what();
+    }
+
+    return Nan::Error(errorMessage.c_str());
+}
+
+v8::Local<v8::Object> NodeMap::toBuffer(mbgl::PremultipliedImage&& img) {
+    v8::Local<v8::Object> pixels = Nan::NewBuffer(
+        reinterpret_cast<char *>(img.data.get()), img.size(),
+        // Retain the data until the buffer is deleted.
+        [](char *, void * hint) {
+            delete [] reinterpret_cast<uint8_t*>(hint);
+        },
+        img.data.get()
+    ).ToLocalChecked();
+    img.data.release();
+    return pixels;
+}
+
+void NodeMap::deliverImage(std::unique_ptr<Nan::Callback> cb, mbgl::PremultipliedImage&& img, RenderOptions::Format format) {
+    if (format == RenderOptions::Format::PNG) {
+        // The worker owns the callback from here on.
+        Nan::AsyncQueueWorker(new EncodeWorker(cb.release(), std::move(img)));
+        return;
+    }
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        toBuffer(std::move(img))
+    };
+    cb->Call(2, argv);
+}
+
 /**
  * Clean up any resources used by a map instance.options
  * @name release
@@ -632,6 +703,10 @@ struct SetFilterVisitor {
         Nan::ThrowTypeError("layer doesn't support filters");
     }
 
+    void operator()(mbgl::style::DynamicPointLayer&) {
+        Nan::ThrowTypeError("layer doesn't support filters");
+    }
+
     void operator()(mbgl::style::BackgroundLayer&) {
         Nan::ThrowTypeError("layer doesn't support filters");
     }
@@ -773,12 +848,13 @@ void NodeMap::QueryRenderedFeatures(const Nan::FunctionCallbackInfo<v8::Value>&
 }
 
 NodeMap::NodeMap(v8::Local<v8::Object> options) :
+    fileSource(*this, options),
     view(sharedDisplay(), [&] {
         Nan::HandleScope scope;
         return Nan::Has(options, Nan::New("ratio").ToLocalChecked()).FromJust() ? Nan::Get(options, Nan::New("ratio").ToLocalChecked()).ToLocalChecked()->NumberValue() : 1.0;
     }()),
     threadpool(),
-    map(std::make_unique<mbgl::Map>(view, *this, threadpool, mbgl::MapMode::Still)),
+    map(std::make_unique<mbgl::Map>(view, fileSource, threadpool, mbgl::MapMode::Still)),
     async(new uv_async_t) {
 
     view.setMapChangeCallback([&](mbgl::MapChange change) {
@@ -800,23 +876,4 @@ NodeMap::~NodeMap() {
     if (map) release();
 }
 
-std::unique_ptr<mbgl::AsyncRequest> NodeMap::request(const mbgl::Resource& resource, mbgl::FileSource::Callback callback_) {
-    Nan::HandleScope scope;
-
-    v8::Local<v8::Value> argv[] = {
-        Nan::New<v8::External>(this),
-        Nan::New<v8::External>(&callback_)
-    };
-
-    auto instance = Nan::New(NodeRequest::constructor)->NewInstance(2, argv);
-
-    Nan::Set(instance, Nan::New("url").ToLocalChecked(), Nan::New(resource.url).ToLocalChecked());
-    Nan::Set(instance, Nan::New("kind").ToLocalChecked(), Nan::New<v8::Integer>(resource.kind));
-
-    auto request = Nan::ObjectWrap::Unwrap<NodeRequest>(instance);
-    request->Execute();
-
-    return std::make_unique<NodeRequest::NodeAsyncRequest>(request);
-}
-
 } // namespace node_mbgl
@@ -1,9 +1,9 @@
 #pragma once
 
 #include "node_thread_pool.hpp"
+#include "node_request.hpp"
 
 #include <mbgl/map/map.hpp>
-#include <mbgl/storage/file_source.hpp>
 #include <mbgl/platform/default/headless_view.hpp>
 
 #pragma GCC diagnostic push
@@ -14,10 +14,25 @@
 
 namespace node_mbgl {
 
-class NodeMap : public Nan::ObjectWrap,
-                public mbgl::FileSource {
+class NodeMap : public Nan::ObjectWrap {
 public:
-    struct RenderOptions;
+    struct RenderOptions {
+        // Raw images are handed over as they're read back from the GPU. PNGs are encoded on the
+        // libuv thread pool, so that neither the map nor JavaScript has to wait for them.
+        enum class Format { Raw, PNG };
+
+        double zoom = 0;
+        double bearing = 0;
+        double pitch = 0;
+        double latitude = 0;
+        double longitude = 0;
+        unsigned int width = 512;
+        unsigned int height = 512;
+        std::vector<std::string> classes;
+        mbgl::MapDebugOptions debugOptions = mbgl::MapDebugOptions::NoDebug;
+        Format format = Format::Raw;
+    };
+
     class RenderWorker;
 
     NodeMap(v8::Local<v8::Object>);
@@ -51,14 +66,21 @@ public:
 
     static RenderOptions ParseOptions(v8::Local<v8::Object>);
 
-    std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource&, mbgl::FileSource::Callback);
+    // Shared with NodeMapPool, whose maps render the same way.
+    static std::shared_ptr<mbgl::HeadlessDisplay> sharedDisplay();
+    static void applyOptions(mbgl::Map&, mbgl::HeadlessView&, const RenderOptions&);
+    static v8::Local<v8::Value> renderError(std::exception_ptr);
+    static v8::Local<v8::Object> toBuffer(mbgl::PremultipliedImage&&);
+    static void deliverImage(std::unique_ptr<Nan::Callback>, mbgl::PremultipliedImage&&, RenderOptions::Format);
 
+    NodeFileSource fileSource;
     mbgl::HeadlessView view;
     NodeThreadPool threadpool;
     std::unique_ptr<mbgl::Map> map;
 
     std::exception_ptr error;
     mbgl::PremultipliedImage image;
+    RenderOptions::Format format = RenderOptions::Format::Raw;
     std::unique_ptr<Nan::Callback> callback;
 
     // Async for delivering the notifications of render completion.
@@ -0,0 +1,391 @@
+#include "node_map_pool.hpp"
+#include "node_request.hpp"
+
+#include <mbgl/util/exception.hpp>
+
+#include <algorithm>
+
+#if UV_VERSION_MAJOR == 0 && UV_VERSION_MINOR <= 10
+#define UV_ASYNC_PARAMS(handle) uv_async_t *handle, int
+#else
+#define UV_ASYNC_PARAMS(handle) uv_async_t *handle
+#endif
+
+namespace node_mbgl {
+
+class NodeMapPool::Slot {
+public:
+    Slot(NodeMapPool& pool_, float pixelRatio)
+        : pool(pool_),
+          view(NodeMap::sharedDisplay(), pixelRatio),
+          map(std::make_unique<mbgl::Map>(view, pool.fileSource, pool.threadpool, mbgl::MapMode::Still)),
+          async(new uv_async_t) {
+        view.setMapChangeCallback([&](mbgl::MapChange change) {
+            if (change == mbgl::MapChangeDidFailLoadingMap) {
+                throw std::runtime_error("Requires a map style to be a valid style JSON");
+            }
+        });
+
+        async->data = this;
+        uv_async_init(uv_default_loop(), async, [](UV_ASYNC_PARAMS(h)) {
+            auto slot = reinterpret_cast<Slot *>(h->data);
+            slot->pool.renderFinished(*slot);
+        });
+
+        // Make sure the async handle doesn't keep the loop alive.
+        uv_unref(reinterpret_cast<uv_handle_t *>(async));
+    }
+
+    ~Slot() {
+        uv_close(reinterpret_cast<uv_handle_t *>(async), [] (uv_handle_t *h) {
+            delete reinterpret_cast<uv_async_t *>(h);
+        });
+    }
+
+    bool idle() const {
+        return !callback;
+    }
+
+    // Takes the job's callback only if the render starts.
+    void start(Job& job) {
+        assert(idle());
+        NodeMap::applyOptions(*map, view, job.options);
+        format = job.options.format;
+
+        map->renderStill([this](const std::exception_ptr eptr, mbgl::PremultipliedImage&& result) {
+            if (eptr) {
+                error = std::move(eptr);
+            } else {
+                assert(!image.data);
+                image = std::move(result);
+            }
+            uv_async_send(async);
+        });
+        callback = std::move(job.callback);
+
+        // The async keeps the loop alive until the render is finished.
+        uv_ref(reinterpret_cast<uv_handle_t *>(async));
+    }
+
+    NodeMapPool& pool;
+    mbgl::HeadlessView view;
+    std::unique_ptr<mbgl::Map> map;
+
+    std::unique_ptr<Nan::Callback> callback;
+    std::exception_ptr error;
+    mbgl::PremultipliedImage image;
+    NodeMap::RenderOptions::Format format = NodeMap::RenderOptions::Format::Raw;
+
+    uv_async_t *async;
+};
+
+Nan::Persistent<v8::Function> NodeMapPool::constructor;
+
+static const char* releasedMessage() {
+    return "Map pool resources have already been released";
+}
+
+void NodeMapPool::Init(v8::Local<v8::Object> target) {
+    v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+
+    tpl->SetClassName(Nan::New("MapPool").ToLocalChecked());
+    tpl->InstanceTemplate()->SetInternalFieldCount(2);
+
+    Nan::SetPrototypeMethod(tpl, "load", Load);
+    Nan::SetPrototypeMethod(tpl, "render", Render);
+    Nan::SetPrototypeMethod(tpl, "queued", Queued);
+    Nan::SetPrototypeMethod(tpl, "release", Release);
+
+    constructor.Reset(tpl->GetFunction());
+    Nan::Set(target, Nan::New("MapPool").ToLocalChecked(), tpl->GetFunction());
+}
+
+/**
+ * A pool of maps that render the same style, for rendering many images at once without
+ * orchestrating maps in JavaScript. The maps share one thread pool and one `request` method.
+ *
+ * @class
+ * @name MapPool
+ * @param {Object} options
+ * @param {Function} options.request a method used to request resources, as for `Map`
+ * @param {number} [options.ratio=1] pixel ratio
+ * @param {number} [options.size=4] number of maps, and so of renders at a time
+ * @param {number} [options.maxQueued=64] number of renders that may wait for a map, past which
+ * `render` throws
+ * @example
+ * var pool = new mbgl.MapPool({ request: function() {}, size: 8 });
+ * pool.load(require('./test/fixtures/style.json'));
+ * pool.render({ zoom: 2, center: [10, 50] }, function(err, image) {
+ *     if (err) throw err;
+ *     fs.writeFileSync('image.png', image);
+ * });
+ */
+void NodeMapPool::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    if (!info.IsConstructCall()) {
+        return Nan::ThrowTypeError("Use the new operator to create new MapPool objects");
+    }
+
+    if (info.Length() < 1 || !info[0]->IsObject()) {
+        return Nan::ThrowTypeError("Requires an options object as first argument");
+    }
+
+    auto options = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+
+    if (!Nan::Has(options, Nan::New("request").ToLocalChecked()).FromJust()
+     || !Nan::Get(options, Nan::New("request").ToLocalChecked()).ToLocalChecked()->IsFunction()) {
+        return Nan::ThrowError("Options object must have a 'request' method");
+    }
+
+    for (const char* name : { "ratio", "size", "maxQueued" }) {
+        if (Nan::Has(options, Nan::New(name).ToLocalChecked()).FromJust()
+         && !Nan::Get(options, Nan::New(name).ToLocalChecked()).ToLocalChecked()->IsNumber()) {
+            return Nan::ThrowError((std::string("Options object '") + name + "' property must be a number").c_str());
+        }
+    }
+
+    int64_t size = 4;
+    if (Nan::Has(options, Nan::New("size").ToLocalChecked()).FromJust()) {
+        size = Nan::Get(options, Nan::New("size").ToLocalChecked()).ToLocalChecked()->IntegerValue();
+    }
+    if (size < 1) {
+        return Nan::ThrowError("Options object 'size' property must be at least 1");
+    }
+
+    int64_t maxQueued = 64;
+    if (Nan::Has(options, Nan::New("maxQueued").ToLocalChecked()).FromJust()) {
+        maxQueued = Nan::Get(options, Nan::New("maxQueued").ToLocalChecked()).ToLocalChecked()->IntegerValue();
+    }
+    if (maxQueued < 0) {
+        return Nan::ThrowError("Options object 'maxQueued' property must not be negative");
+    }
+
+    info.This()->SetInternalField(1, options);
+
+    try {
+        auto nodeMapPool = new NodeMapPool(options, std::size_t(size), std::size_t(maxQueued));
+        nodeMapPool->Wrap(info.This());
+    } catch(std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    info.GetReturnValue().Set(info.This());
+}
+
+/**
+ * Load a stylesheet into all maps of the pool, which must not be rendering.
+ *
+ * @function
+ * @name load
+ * @param {string|Object} stylesheet either an object or a JSON representation
+ * @returns {undefined}
+ * @throws {Error} if stylesheet is missing or invalid
+ */
+void NodeMapPool::Load(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    if (pool->released) return Nan::ThrowError(releasedMessage());
+
+    if (info.Length() < 1) {
+        return Nan::ThrowError("Requires a map style as first argument");
+    }
+
+    for (const auto& slot : pool->slots) {
+        if (!slot->idle()) {
+            return Nan::ThrowError("Map pool is currently rendering an image");
+        }
+    }
+
+    std::string style;
+
+    if (info[0]->IsObject()) {
+        v8::Local<v8::Object> JSON = Nan::To<v8::Object>(
+            Nan::Get(Nan::GetCurrentContext()->Global(), Nan::New("JSON").ToLocalChecked()).ToLocalChecked()
+        ).ToLocalChecked();
+        v8::Local<v8::Value> styleHandle = info[0];
+        style = *Nan::Utf8String(Nan::MakeCallback(JSON, "stringify", 1, &styleHandle));
+    } else if (info[0]->IsString()) {
+        style = *Nan::Utf8String(info[0]);
+    } else {
+        return Nan::ThrowTypeError("First argument must be a string or object");
+    }
+
+    pool->loaded = false;
+
+    try {
+        for (const auto& slot : pool->slots) {
+            slot->map->setStyleJSON(style);
+        }
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    pool->loaded = true;
+
+    info.GetReturnValue().SetUndefined();
+}
+
+/**
+ * Render an image from the loaded style on the next map that is idle, with the same options as
+ * `Map#render`. Renders are started in the order they're queued.
+ *
+ * @name render
+ * @param {Object} options
+ * @param {Function} callback
+ * @returns {undefined} calls callback
+ * @throws {Error} if the stylesheet is not loaded or the queue is full
+ */
+void NodeMapPool::Render(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    if (pool->released) return Nan::ThrowError(releasedMessage());
+
+    if (info.Length() <= 0 || !info[0]->IsObject()) {
+        return Nan::ThrowTypeError("First argument must be an options object");
+    }
+
+    if (info.Length() <= 1 || !info[1]->IsFunction()) {
+        return Nan::ThrowTypeError("Second argument must be a callback function");
+    }
+
+    if (!pool->loaded) {
+        return Nan::ThrowTypeError("Style is not loaded");
+    }
+
+    // Renders only wait in the queue when all of the maps are busy.
+    if (pool->queue.size() >= pool->maxQueued &&
+        std::none_of(pool->slots.begin(), pool->slots.end(), [] (const auto& slot) { return slot->idle(); })) {
+        return Nan::ThrowError("Map pool render queue is full");
+    }
+
+    NodeMap::RenderOptions options;
+    try {
+        options = NodeMap::ParseOptions(Nan::To<v8::Object>(info[0]).ToLocalChecked());
+    } catch (const mbgl::util::Exception &ex) {
+        return Nan::ThrowTypeError(ex.what());
+    }
+
+    pool->queue.push_back({
+        std::move(options),
+        std::make_unique<Nan::Callback>(info[1].As<v8::Function>())
+    });
+
+    pool->dispatch();
+
+    info.GetReturnValue().SetUndefined();
+}
+
+/**
+ * The number of renders that are waiting for a map.
+ *
+ * @name queued
+ * @returns {number}
+ */
+void NodeMapPool::Queued(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    info.GetReturnValue().Set(Nan::New<v8::Number>(pool->queue.size()));
+}
+
+/**
+ * Clean up the resources of all maps of the pool, which must not be rendering.
+ *
+ * @name release
+ * @returns {undefined}
+ */
+void NodeMapPool::Release(const Nan::FunctionCallbackInfo<v8::Value>& info) {
+    auto pool = Nan::ObjectWrap::Unwrap<NodeMapPool>(info.Holder());
+    if (pool->released) return Nan::ThrowError(releasedMessage());
+
+    for (const auto& slot : pool->slots) {
+        if (!slot->idle()) {
+            return Nan::ThrowError("Map pool is currently rendering an image");
+        }
+    }
+
+    try {
+        pool->release();
+    } catch (const std::exception &ex) {
+        return Nan::ThrowError(ex.what());
+    }
+
+    info.GetReturnValue().SetUndefined();
+}
+
+void NodeMapPool::dispatch() {
+    for (const auto& slot : slots) {
+        while (slot->idle() && !queue.empty()) {
+            Job job = std::move(queue.front());
+            queue.pop_front();
+            try {
+                slot->start(job);
+            } catch (const std::exception& ex) {
+                v8::Local<v8::Value> argv[] = {
+                    Nan::Error(ex.what())
+                };
+                job.callback->Call(1, argv);
+
+                // The callback may have released the pool.
+                if (released) return;
+                continue;
+            }
+
+            // Retain this object for every render, so that it isn't destructed before they finish.
+            Ref();
+        }
+    }
+}
+
+void NodeMapPool::renderFinished(Slot& slot) {
+    Nan::HandleScope scope;
+
+    uv_unref(reinterpret_cast<uv_handle_t *>(slot.async));
+    Unref();
+
+    // Move the results out of the slot, so that it can start the next render before the callback
+    // is called, which may queue more.
+    auto cb = std::move(slot.callback);
+    auto img = std::move(slot.image);
+    auto err = std::move(slot.error);
+    const auto format = slot.format;
+    slot.error = nullptr;
+    assert(cb);
+
+    dispatch();
+
+    if (err) {
+        v8::Local<v8::Value> argv[] = {
+            NodeMap::renderError(std::move(err))
+        };
+        cb->Call(1, argv);
+    } else if (img.data) {
+        NodeMap::deliverImage(std::move(cb), std::move(img), format);
+    } else {
+        v8::Local<v8::Value> argv[] = {
+            Nan::Error("Didn't get an image")
+        };
+        cb->Call(1, argv);
+    }
+}
+
+void NodeMapPool::release() {
+    if (released) throw mbgl::util::Exception(releasedMessage());
+    released = true;
+    slots.clear();
+}
+
+NodeMapPool::NodeMapPool(v8::Local<v8::Object> options, std::size_t size, std::size_t maxQueued_)
+    : fileSource(*this, options),
+      maxQueued(maxQueued_) {
+    const float pixelRatio = [&] {
+        Nan::HandleScope scope;
+        return Nan::Has(options, Nan::New("ratio").ToLocalChecked()).FromJust() ? Nan::Get(options, Nan::New("ratio").ToLocalChecked()).ToLocalChecked()->NumberValue() : 1.0;
+    }();
+
+    slots.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+        slots.push_back(std::make_unique<Slot>(*this, pixelRatio));
+    }
+}
+
+NodeMapPool::~NodeMapPool() {
+    if (!released) release();
+}
+
+} // namespace node_mbgl
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "node_map.hpp"
+#include "node_thread_pool.hpp"
+
+#include <mbgl/map/map.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wshadow"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace node_mbgl {
+
+// A fixed number of maps that load the same style and share one thread pool and one `request`
+// method, and take renders from a queue of bounded length as they become idle. Unlike NodeMap,
+// renders can be issued without waiting for the previous ones to finish.
+class NodeMapPool : public Nan::ObjectWrap {
+public:
+    NodeMapPool(v8::Local<v8::Object>, std::size_t size, std::size_t maxQueued);
+    ~NodeMapPool();
+
+    static Nan::Persistent<v8::Function> constructor;
+
+    static void Init(v8::Local<v8::Object>);
+
+    static void New(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Load(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Render(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Queued(const Nan::FunctionCallbackInfo<v8::Value>&);
+    static void Release(const Nan::FunctionCallbackInfo<v8::Value>&);
+
+private:
+    struct Job {
+        NodeMap::RenderOptions options;
+        std::unique_ptr<Nan::Callback> callback;
+    };
+
+    // One of the maps, and the render it's doing, if any.
+    class Slot;
+
+    // Starts the queued renders on the maps that are idle.
+    void dispatch();
+    void renderFinished(Slot&);
+
+    void release();
+
+    NodeFileSource fileSource;
+    NodeThreadPool threadpool;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::deque<Job> queue;
+    const std::size_t maxQueued;
+
+    bool loaded = false;
+    bool released = false;
+};
+
+} // namespace node_mbgl
@@ -8,6 +8,7 @@
 #include <mbgl/util/run_loop.hpp>
 
 #include "node_map.hpp"
+#include "node_map_pool.hpp"
 #include "node_log.hpp"
 #include "node_request.hpp"
 
@@ -19,6 +20,7 @@ void RegisterModule(v8::Local<v8::Object> target, v8::Local<v8::Object> module)
     nodeRunLoop.stop();
 
     node_mbgl::NodeMap::Init(target);
+    node_mbgl::NodeMapPool::Init(target);
     node_mbgl::NodeRequest::Init();
 
     // Exports Resource constants.
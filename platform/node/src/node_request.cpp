@@ -1,18 +1,20 @@
 #include "node_request.hpp"
-#include "node_map.hpp"
 #include <mbgl/storage/response.hpp>
+#include <mbgl/storage/tile_archive_file_source.hpp>
 #include <mbgl/util/chrono.hpp>
 
 #include <cmath>
 
+#if UV_VERSION_MAJOR == 0 && UV_VERSION_MINOR <= 10
+#define UV_ASYNC_PARAMS(handle) uv_async_t *handle, int
+#else
+#define UV_ASYNC_PARAMS(handle) uv_async_t *handle
+#endif
+
 namespace node_mbgl {
 
-NodeRequest::NodeRequest(
-    NodeMap* target_,
-    mbgl::FileSource::Callback callback_)
-    : AsyncWorker(nullptr),
-    target(target_),
-    callback(std::move(callback_)) {
+NodeRequest::NodeRequest(mbgl::FileSource::Callback callback_)
+    : callback(std::move(callback_)) {
 }
 
 NodeRequest::~NodeRequest() {
@@ -38,10 +40,9 @@ void NodeRequest::Init() {
 }
 
 void NodeRequest::New(const Nan::FunctionCallbackInfo<v8::Value>& info) {
-    auto target = reinterpret_cast<NodeMap*>(info[0].As<v8::External>()->Value());
-    auto callback = reinterpret_cast<mbgl::FileSource::Callback*>(info[1].As<v8::External>()->Value());
+    auto callback = reinterpret_cast<mbgl::FileSource::Callback*>(info[0].As<v8::External>()->Value());
 
-    auto request = new NodeRequest(target, *callback);
+    auto request = new NodeRequest(std::move(*callback));
 
     request->Wrap(info.This());
     info.GetReturnValue().Set(info.This());
@@ -57,6 +58,7 @@ void NodeRequest::HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>& inf
     }
 
     mbgl::Response response;
+    std::string errorMessage;
 
     if (info.Length() < 1) {
         response.noContent = true;
@@ -65,11 +67,10 @@ void NodeRequest::HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>& inf
         auto msg = Nan::New("message").ToLocalChecked();
 
         if (Nan::Has(err, msg).FromJust()) {
-            request->SetErrorMessage(*Nan::Utf8String(
-                Nan::Get(err, msg).ToLocalChecked()));
+            errorMessage = *Nan::Utf8String(Nan::Get(err, msg).ToLocalChecked());
         }
     } else if (info[0]->IsString()) {
-        request->SetErrorMessage(*Nan::Utf8String(info[0]));
+        errorMessage = *Nan::Utf8String(info[0]);
     } else if (info.Length() < 2 || !info[1]->IsObject()) {
         return Nan::ThrowTypeError("Second argument must be a response object");
     } else {
@@ -109,10 +110,10 @@ void NodeRequest::HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>& inf
         }
     }
 
-    if (request->ErrorMessage()) {
+    if (!errorMessage.empty()) {
         response.error = std::make_unique<mbgl::Response::Error>(
             mbgl::Response::Error::Reason::Other,
-            request->ErrorMessage()
+            errorMessage
         );
     }
 
@@ -121,12 +122,6 @@ void NodeRequest::HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>& inf
     info.GetReturnValue().SetUndefined();
 }
 
-void NodeRequest::Execute() {
-    v8::Local<v8::Value> argv[] = { handle() };
-
-    Nan::MakeCallback(Nan::To<v8::Object>(target->handle()->GetInternalField(1)).ToLocalChecked(), "request", 1, argv);
-}
-
 NodeRequest::NodeAsyncRequest::NodeAsyncRequest(NodeRequest* request_) : request(request_) {
     assert(request);
 
@@ -144,4 +139,96 @@ NodeRequest::NodeAsyncRequest::~NodeAsyncRequest() {
     }
 }
 
+NodeFileSource::NodeFileSource(Nan::ObjectWrap& target_, v8::Local<v8::Object> options)
+    : target(target_),
+      async(new uv_async_t) {
+    Nan::HandleScope scope;
+    if (Nan::Has(options, Nan::New("nativeArchives").ToLocalChecked()).FromJust() &&
+        Nan::Get(options, Nan::New("nativeArchives").ToLocalChecked()).ToLocalChecked()->BooleanValue()) {
+        archives = std::make_unique<mbgl::TileArchiveFileSource>();
+    }
+
+    async->data = this;
+    uv_async_init(uv_default_loop(), async, [](UV_ASYNC_PARAMS(h)) {
+        reinterpret_cast<NodeFileSource *>(h->data)->flush();
+    });
+
+    // The async only keeps the loop alive while there are requests to flush.
+    uv_unref(reinterpret_cast<uv_handle_t *>(async));
+}
+
+NodeFileSource::~NodeFileSource() {
+    for (auto request : pending) {
+        request->unretain();
+    }
+
+    uv_close(reinterpret_cast<uv_handle_t *>(async), [] (uv_handle_t *h) {
+        delete reinterpret_cast<uv_async_t *>(h);
+    });
+}
+
+std::unique_ptr<mbgl::AsyncRequest> NodeFileSource::request(const mbgl::Resource& resource, mbgl::FileSource::Callback callback_) {
+    if (archives && mbgl::TileArchiveFileSource::acceptsURL(resource.url)) {
+        return archives->request(resource, std::move(callback_));
+    }
+
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::New<v8::External>(&callback_)
+    };
+
+    auto instance = Nan::New(NodeRequest::constructor)->NewInstance(1, argv);
+
+    Nan::Set(instance, Nan::New("url").ToLocalChecked(), Nan::New(resource.url).ToLocalChecked());
+    Nan::Set(instance, Nan::New("kind").ToLocalChecked(), Nan::New<v8::Integer>(resource.kind));
+
+    auto request = Nan::ObjectWrap::Unwrap<NodeRequest>(instance);
+    request->retain();
+
+    if (pending.empty()) {
+        uv_ref(reinterpret_cast<uv_handle_t *>(async));
+        uv_async_send(async);
+    }
+    pending.push_back(request);
+
+    return std::make_unique<NodeRequest::NodeAsyncRequest>(request);
+}
+
+void NodeFileSource::flush() {
+    Nan::HandleScope scope;
+
+    uv_unref(reinterpret_cast<uv_handle_t *>(async));
+
+    // Requests made while JavaScript handles these go into the next batch.
+    std::vector<NodeRequest*> requests;
+    std::swap(requests, pending);
+
+    auto array = Nan::New<v8::Array>();
+    uint32_t length = 0;
+    for (auto request : requests) {
+        if (!request->done()) {
+            Nan::Set(array, length++, request->handle());
+        }
+    }
+
+    auto options = Nan::To<v8::Object>(target.handle()->GetInternalField(1)).ToLocalChecked();
+    auto batch = Nan::Get(options, Nan::New("requests").ToLocalChecked()).ToLocalChecked();
+    if (length == 0) {
+        // All of them were canceled.
+    } else if (batch->IsFunction()) {
+        v8::Local<v8::Value> argv[] = { array };
+        Nan::MakeCallback(options, batch.As<v8::Function>(), 1, argv);
+    } else {
+        for (uint32_t i = 0; i < length; i++) {
+            v8::Local<v8::Value> argv[] = { Nan::Get(array, i).ToLocalChecked() };
+            Nan::MakeCallback(options, "request", 1, argv);
+        }
+    }
+
+    for (auto request : requests) {
+        request->unretain();
+    }
+}
+
 } // namespace node_mbgl
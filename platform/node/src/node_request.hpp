@@ -9,12 +9,17 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/file_source.hpp>
 
-namespace node_mbgl {
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+class TileArchiveFileSource;
+} // namespace mbgl
 
-class NodeMap;
+namespace node_mbgl {
 
-class NodeRequest : public Nan::ObjectWrap,
-                    public Nan::AsyncWorker {
+class NodeRequest : public Nan::ObjectWrap {
 public:
     struct NodeAsyncRequest : public mbgl::AsyncRequest {
         NodeAsyncRequest(NodeRequest*);
@@ -22,7 +27,7 @@ public:
         NodeRequest* request;
     };
 
-    NodeRequest(NodeMap*, mbgl::FileSource::Callback);
+    NodeRequest(mbgl::FileSource::Callback);
     ~NodeRequest();
 
     static Nan::Persistent<v8::Function> constructor;
@@ -32,12 +37,44 @@ public:
     static void New(const Nan::FunctionCallbackInfo<v8::Value>&);
     static void HandleCallback(const Nan::FunctionCallbackInfo<v8::Value>&);
 
-    void Execute();
+    // Whether the request was canceled, or already responded to.
+    bool done() const { return !callback; }
+
+    // Keeps the JavaScript object alive while the request waits to be handed over to JavaScript.
+    void retain() { Ref(); }
+    void unretain() { Unref(); }
 
 private:
-    NodeMap* target;
     mbgl::FileSource::Callback callback;
     NodeAsyncRequest* asyncRequest = nullptr;
 };
 
+/*
+    The file source of a NodeMap or NodeMapPool. The requests that are made in one turn of the event
+    loop are handed over to JavaScript together, with a single call of the `requests` method of
+    the target's options object, which the index.js shim sets up, or otherwise with a call of its
+    `request` method for each. Requests that are canceled before then never reach JavaScript.
+
+    With the `nativeArchives` option, mbtiles:// and pack:// URLs are read natively, without
+    entering JavaScript at all; see TileArchiveFileSource.
+*/
+class NodeFileSource : public mbgl::FileSource {
+public:
+    // The target's options object is in its second internal field.
+    NodeFileSource(Nan::ObjectWrap& target, v8::Local<v8::Object> options);
+    ~NodeFileSource() override;
+
+    std::unique_ptr<mbgl::AsyncRequest> request(const mbgl::Resource&, mbgl::FileSource::Callback) override;
+
+private:
+    void flush();
+
+    Nan::ObjectWrap& target;
+    std::vector<NodeRequest*> pending;
+    std::unique_ptr<mbgl::TileArchiveFileSource> archives;
+
+    // Flushes the pending requests once the event loop gets to it.
+    uv_async_t *async;
+};
+
 }
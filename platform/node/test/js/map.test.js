@@ -332,6 +332,30 @@ test('Map', function(t) {
             });
         });
 
+        t.test('returns a PNG', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+            map.render({ format: 'png' }, function(err, png) {
+                t.error(err);
+                map.release();
+                t.ok(png instanceof Buffer);
+                t.equal(png.toString('hex', 0, 8), '89504e470d0a1a0a');
+                t.end();
+            });
+        });
+
+        t.test('requires a known format', function(t) {
+            var map = new mbgl.Map(options);
+            map.load(style);
+
+            t.throws(function() {
+                map.render({ format: 'gif' }, function() {});
+            }, /Options object 'format' property must be 'raw' or 'png'/);
+
+            map.release();
+            t.end();
+        });
+
         t.test('can be called several times in serial', function(t) {
             var completed = 0;
             var remaining = 10;
@@ -0,0 +1,103 @@
+'use strict';
+
+var test = require('tape');
+var mbgl = require('../../index');
+var fs = require('fs');
+var path = require('path');
+var style = require('../fixtures/style.json');
+
+test('MapPool', function(t) {
+    var options = {
+        request: function(req, callback) {
+            fs.readFile(path.join(__dirname, '..', req.url), function(err, data) {
+                callback(err, { data: data });
+            });
+        },
+        ratio: 1,
+        size: 2,
+        maxQueued: 2
+    };
+
+    t.test('validates its options', function(t) {
+        t.throws(function() {
+            new mbgl.MapPool({ request: function() {}, size: 'invalid' });
+        }, /Options object 'size' property must be a number/);
+
+        t.throws(function() {
+            new mbgl.MapPool({ request: function() {}, size: 0 });
+        }, /Options object 'size' property must be at least 1/);
+
+        t.end();
+    });
+
+    t.test('requires a style to be set', function(t) {
+        var pool = new mbgl.MapPool(options);
+
+        t.throws(function() {
+            pool.render({}, function() {});
+        }, /Style is not loaded/);
+
+        pool.release();
+        t.end();
+    });
+
+    t.test('renders in parallel', function(t) {
+        var pool = new mbgl.MapPool(options);
+        pool.load(style);
+
+        var remaining = 4;
+        function rendered(err, pixels) {
+            t.error(err);
+            t.ok(pixels instanceof Buffer);
+            t.equal(pixels.length, 512 * 512 * 4);
+            if (--remaining === 0) {
+                t.equal(pool.queued(), 0);
+                pool.release();
+                t.end();
+            }
+        }
+
+        for (var i = 0; i < 4; i++) {
+            pool.render({}, rendered);
+        }
+
+        // Two renders wait for the two maps.
+        t.equal(pool.queued(), 2);
+    });
+
+    t.test('throws if the queue is full', function(t) {
+        var pool = new mbgl.MapPool(options);
+        pool.load(style);
+
+        var remaining = 4;
+        function rendered() {
+            if (--remaining === 0) {
+                pool.release();
+                t.end();
+            }
+        }
+
+        for (var i = 0; i < 4; i++) {
+            pool.render({}, rendered);
+        }
+
+        t.throws(function() {
+            pool.render({}, function() {});
+        }, /Map pool render queue is full/);
+
+        t.throws(function() {
+            pool.release();
+        }, /Map pool is currently rendering an image/);
+    });
+
+    t.test('double release', function(t) {
+        var pool = new mbgl.MapPool(options);
+        pool.release();
+
+        t.throws(function() {
+            pool.release();
+        }, /Map pool resources have already been released/);
+
+        t.end();
+    });
+});
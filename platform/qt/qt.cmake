@@ -17,6 +17,7 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/default_file_source.cpp
     PRIVATE platform/default/local_file_source.cpp
     PRIVATE platform/default/online_file_source.cpp
+    PRIVATE platform/default/tile_archive_file_source.cpp
 
     # Offline
     PRIVATE platform/default/mbgl/storage/offline.cpp
@@ -24,6 +25,8 @@ set(MBGL_QT_FILES
     PRIVATE platform/default/mbgl/storage/offline_database.hpp
     PRIVATE platform/default/mbgl/storage/offline_download.cpp
     PRIVATE platform/default/mbgl/storage/offline_download.hpp
+    PRIVATE platform/default/mbgl/storage/offline_pack.cpp
+    PRIVATE platform/default/mbgl/storage/offline_pack.hpp
     PRIVATE platform/default/sqlite3.cpp
     PRIVATE platform/default/sqlite3.hpp
 
@@ -32,6 +35,8 @@ set(MBGL_QT_FILES
 
     # Thread pool
     PRIVATE platform/default/thread_pool.cpp
+    PRIVATE platform/default/work_stealing_thread_pool.cpp
+    PRIVATE platform/default/shared_thread_pool.cpp
 
     # Platform integration
     PRIVATE platform/qt/src/async_task.cpp
@@ -79,7 +79,11 @@ void HTTPFileSource::Impl::cancel(HTTPRequest* req)
     if (requestsVector.empty()) {
         m_pending.erase(it);
 #if QT_VERSION >= 0x050000
+        // Aborting closes the connection of the reply, or takes the reply out of the queue for one,
+        // right away. Nothing is waiting for its signals anymore.
+        reply->disconnect(this);
         reply->abort();
+        reply->deleteLater();
 #else
         // XXX: We should be aborting the reply here
         // but a bug on Qt4 causes the connection of
@@ -122,11 +126,19 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
 }
 
 uint32_t HTTPFileSource::maximumConcurrentRequests() {
-#if QT_VERSION >= 0x050000
+#if QT_VERSION >= 0x050800
+    // Multiplexed requests don't need connections of their own, so more of them can be in flight;
+    // see HTTPRequest::networkRequest().
+    return 64;
+#elif QT_VERSION >= 0x050000
     return 20;
 #else
     return 10;
 #endif
 }
 
+void HTTPFileSource::setMaximumConnectionsPerHost(uint32_t) {
+    // QNetworkAccessManager opens up to six connections per host, and can't be configured.
+}
+
 } // mbgl
@@ -39,6 +39,22 @@ QNetworkRequest HTTPRequest::networkRequest() const
     req.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferCache);
     req.setRawHeader("User-Agent", "MapboxGL/1.0 [Qt]");
 
+#if QT_VERSION >= 0x050800
+    // Requests to servers that negotiate HTTP/2 share a single connection instead of queuing for
+    // one of the six that QNetworkAccessManager opens per host.
+    req.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#endif
+
+    // Mirrors the order that OnlineFileSource starts requests in: everything else goes ahead of
+    // tiles, and tiles that are needed on screen ahead of the ones that may be needed later.
+    if (m_resource.kind != Resource::Kind::Tile) {
+        req.setPriority(QNetworkRequest::HighPriority);
+    } else if (m_resource.priority == Resource::Low || m_resource.priority == Resource::Background) {
+        req.setPriority(QNetworkRequest::LowPriority);
+    } else {
+        req.setPriority(QNetworkRequest::NormalPriority);
+    }
+
     if (m_resource.priorEtag) {
         const auto etag = m_resource.priorEtag;
         req.setRawHeader("If-None-Match", QByteArray(etag->data(), etag->size()));
@@ -38,6 +38,7 @@ QOpenGLFramebufferObject* QQuickMapboxGLRenderer::createFramebufferObject(const
 
 void QQuickMapboxGLRenderer::render()
 {
+    applyChanges();
     m_map->render();
 }
 
@@ -51,62 +52,106 @@ void QQuickMapboxGLRenderer::synchronize(QQuickFramebufferObject *item)
         m_initialized = true;
     }
 
-    auto syncStatus = quickMap->m_syncState;
+    // The GUI thread is blocked until this returns, so nothing but copying happens here.
+    const auto syncStatus = quickMap->m_syncState;
     quickMap->m_syncState = QQuickMapboxGL::NothingNeedsSync;
+    m_syncState |= syncStatus;
 
     if (syncStatus & QQuickMapboxGL::CenterNeedsSync || syncStatus & QQuickMapboxGL::ZoomNeedsSync) {
-        const auto& center = quickMap->center();
-        m_map->setCoordinateZoom({ center.latitude(), center.longitude() }, quickMap->zoomLevel());
+        m_center = quickMap->center();
+        m_zoomLevel = quickMap->zoomLevel();
     }
 
-    if (syncStatus & QQuickMapboxGL::StyleNeedsSync && !quickMap->m_styleUrl.isEmpty()) {
-        m_map->setStyleUrl(quickMap->m_styleUrl);
+    if (syncStatus & QQuickMapboxGL::StyleNeedsSync) {
+        m_styleUrl = quickMap->m_styleUrl;
     }
 
     if (syncStatus & QQuickMapboxGL::PanNeedsSync) {
-        m_map->moveBy(quickMap->m_pan);
+        m_pan += quickMap->m_pan;
         quickMap->m_pan = QPointF();
-        emit centerChanged(QGeoCoordinate(m_map->latitude(), m_map->longitude()));
     }
 
     if (syncStatus & QQuickMapboxGL::BearingNeedsSync) {
-        m_map->setBearing(quickMap->m_bearing);
+        m_bearing = quickMap->m_bearing;
     }
 
     if (syncStatus & QQuickMapboxGL::PitchNeedsSync) {
-        m_map->setPitch(quickMap->m_pitch);
+        m_pitch = quickMap->m_pitch;
     }
 
     if (!quickMap->m_styleLoaded) {
         return;
     }
 
-    for (const auto& change : quickMap->m_sourceChanges) {
+    m_sourceChanges += quickMap->m_sourceChanges;
+    quickMap->m_sourceChanges.clear();
+
+    m_layerChanges += quickMap->m_layerChanges;
+    quickMap->m_layerChanges.clear();
+
+    m_filterChanges += quickMap->m_filterChanges;
+    quickMap->m_filterChanges.clear();
+
+    m_imageChanges += quickMap->m_imageChanges;
+    quickMap->m_imageChanges.clear();
+
+    m_stylePropertyChanges += quickMap->m_stylePropertyChanges;
+    quickMap->m_stylePropertyChanges.clear();
+}
+
+void QQuickMapboxGLRenderer::applyChanges()
+{
+    const auto syncStatus = m_syncState;
+    m_syncState = QQuickMapboxGL::NothingNeedsSync;
+
+    if (syncStatus & QQuickMapboxGL::CenterNeedsSync || syncStatus & QQuickMapboxGL::ZoomNeedsSync) {
+        m_map->setCoordinateZoom({ m_center.latitude(), m_center.longitude() }, m_zoomLevel);
+    }
+
+    if (syncStatus & QQuickMapboxGL::StyleNeedsSync && !m_styleUrl.isEmpty()) {
+        m_map->setStyleUrl(m_styleUrl);
+    }
+
+    if (syncStatus & QQuickMapboxGL::PanNeedsSync) {
+        m_map->moveBy(m_pan);
+        m_pan = QPointF();
+        emit centerChanged(QGeoCoordinate(m_map->latitude(), m_map->longitude()));
+    }
+
+    if (syncStatus & QQuickMapboxGL::BearingNeedsSync) {
+        m_map->setBearing(m_bearing);
+    }
+
+    if (syncStatus & QQuickMapboxGL::PitchNeedsSync) {
+        m_map->setPitch(m_pitch);
+    }
+
+    for (const auto& change : m_sourceChanges) {
         m_map->addSource(change.value("id").toString(), change);
     }
-    quickMap->m_sourceChanges.clear();
+    m_sourceChanges.clear();
 
-    for (const auto& change : quickMap->m_layerChanges) {
+    for (const auto& change : m_layerChanges) {
         m_map->addLayer(change);
     }
-    quickMap->m_layerChanges.clear();
+    m_layerChanges.clear();
 
-    for (const auto& change : quickMap->m_filterChanges) {
+    for (const auto& change : m_filterChanges) {
         m_map->setFilter(change.value("layer").toString(), change.value("filter"));
     }
-    quickMap->m_filterChanges.clear();
+    m_filterChanges.clear();
 
-    for (const auto& change : quickMap->m_imageChanges) {
+    for (const auto& change : m_imageChanges) {
         m_map->addImage(change.name, change.sprite);
     }
-    quickMap->m_imageChanges.clear();
+    m_imageChanges.clear();
 
-    for (const auto& change : quickMap->m_stylePropertyChanges) {
+    for (const auto& change : m_stylePropertyChanges) {
         if (change.type == QQuickMapboxGL::StyleProperty::Paint) {
             m_map->setPaintProperty(change.layer, change.property, change.value, change.klass);
         } else {
             m_map->setLayoutProperty(change.layer, change.property, change.value);
         }
     }
-    quickMap->m_stylePropertyChanges.clear();
+    m_stylePropertyChanges.clear();
 }
@@ -2,15 +2,24 @@
 
 #include "qmapbox.hpp"
 #include "qmapboxgl.hpp"
+#include "qquickmapboxgl.hpp"
 
+#include <QGeoCoordinate>
+#include <QList>
 #include <QObject>
+#include <QPointF>
 #include <QQuickFramebufferObject>
 #include <QScopedPointer>
+#include <QVariantMap>
 
 class QGeoCoordinate;
 class QOpenGLFramebufferObject;
 class QSize;
 
+// Lives on the scene graph's render thread, as does its map, which is updated and rendered there.
+// synchronize() only takes the changes of the item over, while the GUI thread is blocked, and
+// render() applies them to the map, so that the GUI thread doesn't wait for styles to be parsed
+// or sources to be converted.
 class QQuickMapboxGLRenderer : public QObject, public QQuickFramebufferObject::Renderer
 {
     Q_OBJECT
@@ -28,7 +37,23 @@ signals:
     void centerChanged(const QGeoCoordinate &);
 
 private:
+    void applyChanges();
+
     bool m_initialized = false;
 
     QScopedPointer<QMapboxGL> m_map;
+
+    // The changes of the item that are yet to be applied to the map.
+    int m_syncState = QQuickMapboxGL::NothingNeedsSync;
+    QGeoCoordinate m_center;
+    qreal m_zoomLevel = 0;
+    QString m_styleUrl;
+    QPointF m_pan;
+    qreal m_bearing = 0;
+    qreal m_pitch = 0;
+    QList<QVariantMap> m_sourceChanges;
+    QList<QVariantMap> m_layerChanges;
+    QList<QVariantMap> m_filterChanges;
+    QList<QQuickMapboxGL::Image> m_imageChanges;
+    QList<QQuickMapboxGL::StyleProperty> m_stylePropertyChanges;
 };
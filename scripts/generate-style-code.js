@@ -97,6 +97,14 @@ global.defaultValue = function (property) {
   }
 }
 
+// The paint properties whose property functions buckets evaluate for each feature. Not yet
+// line-color: that needs a per-vertex color buffer in LineBucket, and in-tree line shaders that
+// read the color from an attribute, like those of fill_data_driven_shader.cpp, as the line shader
+// sources come from the external shaders package.
+global.supportsPropertyFunctions = function (property) {
+  return property.name === 'fill-color' || property.name === 'circle-color';
+}
+
 const layerHpp = ejs.compile(fs.readFileSync('include/mbgl/style/layers/layer.hpp.ejs', 'utf8'), {strict: true});
 const layerCpp = ejs.compile(fs.readFileSync('src/mbgl/style/layers/layer.cpp.ejs', 'utf8'), {strict: true});
 const propertiesHpp = ejs.compile(fs.readFileSync('src/mbgl/style/layers/layer_properties.hpp.ejs', 'utf8'), {strict: true});
@@ -134,3 +142,6 @@ for (const layer of layers) {
 
 const propertySettersHpp = ejs.compile(fs.readFileSync('include/mbgl/style/conversion/make_property_setters.hpp.ejs', 'utf8'), {strict: true});
 fs.writeFileSync('include/mbgl/style/conversion/make_property_setters.hpp', propertySettersHpp({layers: layers}));
+
+const propertyCodecsHpp = ejs.compile(fs.readFileSync('src/mbgl/style/make_property_codecs.hpp.ejs', 'utf8'), {strict: true});
+fs.writeFileSync('src/mbgl/style/make_property_codecs.hpp', propertyCodecsHpp({layers: layers}));
@@ -6,6 +6,7 @@
 #include <mbgl/util/noncopyable.hpp>
 
 #include <memory>
+#include <string>
 
 namespace mbgl {
 
@@ -61,6 +62,30 @@ public:
         mailbox->push(actor::makeMessage(object, fn, std::forward<Args>(args)...));
     }
 
+    // See ActorRef::invokeCoalesced().
+    template <typename Fn, class... Args>
+    void invokeCoalesced(Fn fn, Args&&... args) {
+        mailbox->pushCoalesced(actor::coalescingKey(fn), actor::makeMessage(object, fn, std::forward<Args>(args)...));
+    }
+
+    // See ActorRef::cancel().
+    template <typename Fn>
+    void cancel(Fn fn) {
+        mailbox->cancel(actor::coalescingKey(fn));
+    }
+
+    void setPriority(Mailbox::Priority priority) {
+        mailbox->setPriority(priority);
+    }
+
+    void setTag(const std::string& tag) {
+        mailbox->setTag(tag);
+    }
+
+    void setBatchSize(std::size_t batchSize) {
+        mailbox->setBatchSize(batchSize);
+    }
+
     ActorRef<std::decay_t<Object>> self() {
         return ActorRef<std::decay_t<Object>>(object, mailbox);
     }
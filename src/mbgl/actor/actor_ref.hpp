@@ -35,6 +35,23 @@ public:
         }
     }
 
+    // Like `invoke`, but supersedes any earlier `invokeCoalesced` of the same member function
+    // that hasn't been delivered yet.
+    template <typename Fn, class... Args>
+    void invokeCoalesced(Fn fn, Args&&... args) {
+        if (auto mailbox = weakMailbox.lock()) {
+            mailbox->pushCoalesced(actor::coalescingKey(fn), actor::makeMessage(object, fn, std::forward<Args>(args)...));
+        }
+    }
+
+    // Drops any `invokeCoalesced` of the given member function that hasn't been delivered yet.
+    template <typename Fn>
+    void cancel(Fn fn) {
+        if (auto mailbox = weakMailbox.lock()) {
+            mailbox->cancel(actor::coalescingKey(fn));
+        }
+    }
+
 private:
     Object& object;
     std::weak_ptr<Mailbox> weakMailbox;
@@ -3,53 +3,164 @@
 #include <mbgl/actor/scheduler.hpp>
 
 #include <cassert>
+#include <thread>
+#include <tuple>
 
 namespace mbgl {
 
+constexpr std::size_t Mailbox::NoAffinity;
+
 Mailbox::Mailbox(Scheduler& scheduler_)
     : scheduler(scheduler_) {
 }
 
+Mailbox::~Mailbox() {
+    // Messages still queued are never delivered; take those that were counted out of the queue
+    // depth. Nothing can push anymore, so an empty pop means an empty queue.
+    if (auto counters = statistics.load()) {
+        std::size_t undelivered = 0;
+        while (auto message = queue.pop()) {
+            if (message->queued != TimePoint()) {
+                ++undelivered;
+            }
+        }
+        counters->discarded(undelivered);
+    }
+}
+
+void Mailbox::setPriority(Priority priority_) {
+    priority = priority_;
+}
+
+Mailbox::Priority Mailbox::getPriority() const {
+    return priority;
+}
+
+Mailbox::Priority Mailbox::getPriority(const std::weak_ptr<Mailbox>& mailbox) {
+    if (auto locked = mailbox.lock()) {
+        return locked->getPriority();
+    }
+    return Priority::Visible;
+}
+
+std::size_t Mailbox::getAffinity() const {
+    return affinity;
+}
+
+std::size_t Mailbox::assignAffinity(std::size_t affinity_) {
+    std::size_t expected = NoAffinity;
+    return affinity.compare_exchange_strong(expected, affinity_) ? affinity_ : expected;
+}
+
+void Mailbox::setBatchSize(std::size_t batchSize_) {
+    assert(batchSize_ > 0);
+    batchSize = batchSize_;
+}
+
+void Mailbox::setTag(const std::string& tag) {
+    statistics = &actor::Statistics::get(tag);
+}
+
 void Mailbox::push(std::unique_ptr<Message> message) {
     assert(!closing);
 
-    std::lock_guard<std::mutex> queueLock(queueMutex);
-    bool wasEmpty = queue.empty();
+    if (auto counters = statistics.load()) {
+        message->queued = Clock::now();
+        counters->pushed();
+    }
+
     queue.push(std::move(message));
-    if (wasEmpty) {
+    if (size.fetch_add(1) == 0) {
         scheduler.schedule(shared_from_this());
     }
 }
 
+void Mailbox::pushCoalesced(const actor::CoalescingKey& key, std::unique_ptr<Message> message) {
+    // Push while holding the lock, so that queue order matches sequence order.
+    std::lock_guard<std::mutex> lock(coalescingMutex);
+    std::atomic<uint64_t>& latest = generation(key);
+    message->generation = &latest;
+    message->sequence = ++latest;
+    push(std::move(message));
+}
+
+void Mailbox::cancel(const actor::CoalescingKey& key) {
+    std::lock_guard<std::mutex> lock(coalescingMutex);
+    ++generation(key);
+}
+
+std::atomic<uint64_t>& Mailbox::generation(const actor::CoalescingKey& key) {
+    auto it = generations.find(key);
+    if (it == generations.end()) {
+        it = generations.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(0)).first;
+    }
+    return it->second;
+}
+
 void Mailbox::close() {
-    // Block until the scheduler is guaranteed not to be executing receive().
-    std::lock_guard<std::mutex> closingLock(closingMutex);
     closing = true;
+
+    // Block until the scheduler is guaranteed not to be executing receive().
+    if (receiving > 0) {
+        std::unique_lock<std::mutex> closingLock(closingMutex);
+        closingCV.wait(closingLock, [this] { return receiving == 0; });
+    }
 }
 
 void Mailbox::receive() {
-    std::lock_guard<std::mutex> closingLock(closingMutex);
+    ++receiving;
 
     if (closing) {
+        finishReceiving();
         return;
     }
 
-    std::unique_ptr<Message> message;
-    bool wasEmpty;
+    // Process up to `batchSize` messages, then yield to other mailboxes on the same scheduler.
+    const std::size_t limit = batchSize;
+    std::size_t remaining = 1;
 
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex);
-        assert(!queue.empty());
-        message = std::move(queue.front());
-        queue.pop();
-        wasEmpty = queue.empty();
-    }
+    for (std::size_t i = 0; i < limit && remaining > 0 && !closing; ++i) {
+        std::unique_ptr<Message> message;
+
+        // We've been told about this message; it may just not be linked in yet.
+        while (!(message = queue.pop())) {
+            std::this_thread::yield();
+        }
+
+        const bool superseded = message->generation && *message->generation != message->sequence;
+        auto counters = message->queued != TimePoint() ? statistics.load() : nullptr;
 
-    (*message)();
+        if (!counters) {
+            if (!superseded) {
+                (*message)();
+            }
+        } else if (superseded) {
+            counters->dropped();
+        } else {
+            const TimePoint start = Clock::now();
+            (*message)();
+            counters->processed(start - message->queued, Clock::now() - start);
+        }
 
-    if (!wasEmpty) {
+        remaining = size.fetch_sub(1) - 1;
+    }
+
+    // Reschedule before announcing that receive() is done, so that close() can't return,
+    // and the scheduler be destroyed, while it's still being called into.
+    if (remaining > 0 && !closing) {
         scheduler.schedule(shared_from_this());
     }
+
+    finishReceiving();
+}
+
+void Mailbox::finishReceiving() {
+    --receiving;
+
+    if (closing) {
+        std::lock_guard<std::mutex> closingLock(closingMutex);
+        closingCV.notify_all();
+    }
 }
 
 void Mailbox::maybeReceive(std::weak_ptr<Mailbox> mailbox) {
@@ -1,20 +1,68 @@
 #pragma once
 
+#include <mbgl/actor/message_queue.hpp>
+#include <mbgl/actor/statistics.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 namespace mbgl {
 
 class Scheduler;
-class Message;
 
 class Mailbox : public std::enable_shared_from_this<Mailbox> {
 public:
+    // Schedulers that support priorities (`ThreadPool`, `WorkStealingThreadPool`) process
+    // mailboxes with a more urgent priority first. Ordered from most to least urgent.
+    enum class Priority : uint8_t {
+        Visible,  // Needed for what's on screen, e.g. tiles at the ideal zoom level.
+        Fallback, // Displayed while visible work is pending, e.g. parent or child tiles.
+        Prefetch, // Likely to be needed soon.
+        Cached,   // Not currently needed.
+    };
+
+    static constexpr std::size_t PriorityCount = 4;
+
     Mailbox(Scheduler&);
+    ~Mailbox();
+
+    // Takes effect the next time the mailbox is scheduled.
+    void setPriority(Priority);
+    Priority getPriority() const;
+
+    // Returns the priority of the mailbox, or the most urgent priority if it's gone.
+    static Priority getPriority(const std::weak_ptr<Mailbox>&);
+
+    // Schedulers with several queues, e.g. `ThreadPool` with one per NUMA node, use the affinity
+    // to keep scheduling a mailbox onto the same queue. `assignAffinity()` only takes effect if no
+    // affinity has been assigned yet; either way, it returns the mailbox's affinity.
+    static constexpr std::size_t NoAffinity = std::numeric_limits<std::size_t>::max();
+    std::size_t getAffinity() const;
+    std::size_t assignAffinity(std::size_t);
+
+    // Maximum number of queued messages processed per call to `receive()` before the mailbox
+    // yields and reschedules itself. Defaults to 1.
+    void setBatchSize(std::size_t);
+
+    // Records statistics for this mailbox under the given tag, typically the name of the actor
+    // type; see actor::Statistics. Messages pushed before the mailbox was tagged aren't counted.
+    void setTag(const std::string&);
 
     void push(std::unique_ptr<Message>);
 
+    // Like `push()`, but any message previously pushed with the same key that hasn't been
+    // processed yet is dropped: of a burst of coalesced messages, only the last one is delivered,
+    // at its own position in the queue.
+    void pushCoalesced(const actor::CoalescingKey&, std::unique_ptr<Message>);
+
+    // Drops any message pushed with the given key that hasn't been processed yet.
+    void cancel(const actor::CoalescingKey&);
+
     void close();
     void receive();
 
@@ -23,11 +71,35 @@ public:
 private:
     Scheduler& scheduler;
 
+    std::atomic<Priority> priority { Priority::Visible };
+    std::atomic<std::size_t> batchSize { 1 };
+    std::atomic<std::size_t> affinity { NoAffinity };
+    std::atomic<actor::Statistics::Counters*> statistics { nullptr };
+
+    void finishReceiving();
+
+    // Requires `coalescingMutex`.
+    std::atomic<uint64_t>& generation(const actor::CoalescingKey&);
+
+    // Latest sequence number per coalescing key. std::map, because messages hold on to pointers
+    // into it. Declared before `queue` so that it outlives any queued message.
+    std::mutex coalescingMutex;
+    std::map<actor::CoalescingKey, std::atomic<uint64_t>> generations;
+
+    // `closing` and `receiving` form a Dekker-style handshake: `close()` announces itself and
+    // then checks whether a `receive()` is in progress; `receive()` announces itself and then
+    // checks whether the mailbox is closing. Only when `close()` actually has to wait for a
+    // running `receive()` do the mutex and condition variable come into play. `receiving` is a
+    // count because a rescheduled `receive()` may start before the previous one has returned.
+    std::atomic<bool> closing { false };
+    std::atomic<std::size_t> receiving { 0 };
     std::mutex closingMutex;
-    bool closing { false };
+    std::condition_variable closingCV;
 
-    std::mutex queueMutex;
-    std::queue<std::unique_ptr<Message>> queue;
+    // Number of messages pushed but not yet processed. The mailbox is scheduled whenever this
+    // goes from zero to one, and reschedules itself as long as it is non-zero.
+    std::atomic<std::size_t> size { 0 };
+    MessageQueue queue;
 };
 
 } // namespace mbgl
@@ -1,9 +1,22 @@
 #pragma once
 
+#include <mbgl/actor/message_pool.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
 #include <utility>
 
 namespace mbgl {
 
+class Mailbox;
+class MessageQueue;
+
 // A movable type-erasing function wrapper. This allows to store arbitrary invokable
 // things (like std::function<>, or the result of a movable-only std::bind()) in the queue.
 // Source: http://stackoverflow.com/a/29642072/331379
@@ -11,6 +24,29 @@ class Message {
 public:
     virtual ~Message() = default;
     virtual void operator()() = 0;
+
+    // Messages are allocated from actor::MessagePool rather than directly from the heap.
+    static void* operator new(std::size_t size) {
+        return actor::MessagePool::allocate(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size) {
+        actor::MessagePool::deallocate(ptr, size);
+    }
+
+private:
+    // Intrusive link used by MessageQueue, so that queueing a message doesn't allocate.
+    friend class MessageQueue;
+    std::atomic<Message*> next { nullptr };
+
+    // Set by Mailbox::pushCoalesced(). The message is dropped instead of delivered if the
+    // generation has moved past its sequence number by the time it's received.
+    friend class Mailbox;
+    const std::atomic<uint64_t>* generation = nullptr;
+    uint64_t sequence = 0;
+
+    // Set by Mailbox::push() if the mailbox is instrumented; see actor::Statistics.
+    TimePoint queued;
 };
 
 template <class Object, class MemberFn, class ArgsTuple>
@@ -38,6 +74,17 @@ public:
 
 namespace actor {
 
+// Identifies the member function targeted by a coalesced message.
+using CoalescingKey = std::array<unsigned char, 2 * sizeof(void*)>;
+
+template <class MemberFn>
+CoalescingKey coalescingKey(MemberFn memberFn) {
+    static_assert(sizeof(MemberFn) <= sizeof(CoalescingKey), "unexpected member function pointer size");
+    CoalescingKey key {};
+    std::memcpy(key.data(), &memberFn, sizeof(MemberFn));
+    return key;
+}
+
 template <class Object, class MemberFn, class... Args>
 std::unique_ptr<Message> makeMessage(Object& object, MemberFn memberFn, Args&&... args) {
     auto tuple = std::make_tuple(std::forward<Args>(args)...);
@@ -0,0 +1,178 @@
+#include <mbgl/actor/message_pool.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace actor {
+
+namespace {
+
+constexpr std::size_t classCount = 4;
+constexpr std::size_t classSizes[classCount] = { 32, 64, 128, 256 };
+
+// Number of blocks moved between a thread's cache and the depot at once.
+constexpr std::size_t batchSize = 32;
+
+// Number of blocks carved out of each heap allocation.
+constexpr std::size_t slabSize = 64;
+
+std::atomic<uint64_t> allocations { 0 };
+std::atomic<uint64_t> heapAllocations { 0 };
+
+struct Block {
+    Block* next;
+};
+
+struct FreeList {
+    Block* head = nullptr;
+    std::size_t size = 0;
+
+    void push(Block* block) {
+        block->next = head;
+        head = block;
+        ++size;
+    }
+
+    Block* pop() {
+        Block* block = head;
+        head = block->next;
+        --size;
+        return block;
+    }
+
+    // Detaches up to `count` blocks from the front of the list.
+    FreeList split(std::size_t count) {
+        FreeList result;
+        while (head && result.size < count) {
+            result.push(pop());
+        }
+        return result;
+    }
+};
+
+class Depot {
+public:
+    void put(std::size_t sizeClass, FreeList list) {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches[sizeClass].push_back(list);
+    }
+
+    bool take(std::size_t sizeClass, FreeList& list) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (batches[sizeClass].empty()) {
+            return false;
+        }
+        list = batches[sizeClass].back();
+        batches[sizeClass].pop_back();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<FreeList> batches[classCount];
+};
+
+// Intentionally leaked: threads may exit, and return their blocks, after static destruction.
+Depot& depot() {
+    static Depot& instance = *new Depot;
+    return instance;
+}
+
+class Cache {
+public:
+    ~Cache() {
+        for (std::size_t i = 0; i < classCount; ++i) {
+            while (lists[i].head) {
+                depot().put(i, lists[i].split(batchSize));
+            }
+        }
+    }
+
+    void* allocate(std::size_t sizeClass) {
+        FreeList& list = lists[sizeClass];
+        if (!list.head && !depot().take(sizeClass, list)) {
+            refill(sizeClass);
+        }
+        return list.pop();
+    }
+
+    void deallocate(std::size_t sizeClass, void* ptr) {
+        FreeList& list = lists[sizeClass];
+        list.push(reinterpret_cast<Block*>(ptr));
+        if (list.size >= 2 * batchSize) {
+            depot().put(sizeClass, list.split(batchSize));
+        }
+    }
+
+private:
+    void refill(std::size_t sizeClass) {
+        ++heapAllocations;
+        const std::size_t blockSize = classSizes[sizeClass];
+        auto slab = reinterpret_cast<char*>(::operator new(blockSize * slabSize));
+        for (std::size_t i = 0; i < slabSize; ++i) {
+            lists[sizeClass].push(reinterpret_cast<Block*>(slab + i * blockSize));
+        }
+    }
+
+    FreeList lists[classCount];
+};
+
+Cache& currentCache() {
+    // Deletes each thread's cache when the thread exits.
+    static util::ThreadLocal<Cache>& caches = *new util::ThreadLocal<Cache>;
+
+    Cache* cache = caches.get();
+    if (!cache) {
+        cache = new Cache;
+        caches.set(cache);
+    }
+    return *cache;
+}
+
+std::size_t sizeClassFor(std::size_t size) {
+    for (std::size_t i = 0; i < classCount; ++i) {
+        if (size <= classSizes[i]) {
+            return i;
+        }
+    }
+    return classCount;
+}
+
+} // namespace
+
+void* MessagePool::allocate(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == classCount) {
+        heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    return currentCache().allocate(sizeClass);
+}
+
+void MessagePool::deallocate(void* ptr, std::size_t size) {
+    const std::size_t sizeClass = sizeClassFor(size);
+    if (sizeClass == classCount) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    currentCache().deallocate(sizeClass, ptr);
+}
+
+MessagePool::Statistics MessagePool::getStatistics() {
+    Statistics statistics;
+    statistics.allocations = allocations.load(std::memory_order_relaxed);
+    statistics.heapAllocations = heapAllocations.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+} // namespace actor
+} // namespace mbgl
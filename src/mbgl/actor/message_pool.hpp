@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+namespace actor {
+
+/*
+    Allocator backing `Message::operator new`. Messages are small and short-lived, and a busy
+    actor system creates and destroys a great many of them, so going to the heap every time is
+    wasteful.
+
+    Each thread keeps free lists of fixed-size blocks, one per size class. Since messages are
+    usually created on one thread and destroyed on another, blocks are moved between threads
+    through a shared depot, a whole batch at a time, so that the depot's lock is taken once per
+    batch rather than once per message. Messages larger than the largest size class are allocated
+    directly from the heap. Pooled memory is retained for reuse and never returned to the heap.
+*/
+
+class MessagePool {
+public:
+    static void* allocate(std::size_t);
+    static void deallocate(void*, std::size_t);
+
+    struct Statistics {
+        // Number of messages allocated.
+        uint64_t allocations = 0;
+        // Number of allocations that had to go to the heap: either to get a new slab of blocks,
+        // or because the message was too large to be pooled.
+        uint64_t heapAllocations = 0;
+    };
+
+    static Statistics getStatistics();
+};
+
+} // namespace actor
+} // namespace mbgl
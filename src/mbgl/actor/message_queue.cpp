@@ -0,0 +1,58 @@
+#include <mbgl/actor/message_queue.hpp>
+
+namespace mbgl {
+
+MessageQueue::MessageQueue()
+    : head(&stub),
+      tail(&stub) {
+}
+
+MessageQueue::~MessageQueue() {
+    while (pop()) {}
+}
+
+void MessageQueue::push(std::unique_ptr<Message> message) {
+    push(message.release());
+}
+
+void MessageQueue::push(Message* message) {
+    message->next.store(nullptr, std::memory_order_relaxed);
+    Message* prev = head.exchange(message, std::memory_order_acq_rel);
+    prev->next.store(message, std::memory_order_release);
+}
+
+std::unique_ptr<Message> MessageQueue::pop() {
+    Message* first = tail;
+    Message* next = first->next.load(std::memory_order_acquire);
+
+    if (first == &stub) {
+        if (!next) {
+            return nullptr; // Empty.
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        tail = next;
+        return std::unique_ptr<Message>(first);
+    }
+
+    if (first != head.load(std::memory_order_acquire)) {
+        return nullptr; // A producer is in the middle of linking a message.
+    }
+
+    // `first` is the last message. Put the stub behind it so that it can be unlinked.
+    push(&stub);
+
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return std::unique_ptr<Message>(first);
+    }
+
+    return nullptr;
+}
+
+} // namespace mbgl
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/actor/message.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <memory>
+
+namespace mbgl {
+
+/*
+    An unbounded, intrusive multi-producer/single-consumer queue of messages, after Dmitry
+    Vyukov's design. Any number of threads may `push` concurrently; `pop` must only be called by
+    one thread at a time -- for a `Mailbox`, that is whichever thread is currently executing
+    `Mailbox::receive()`.
+
+    `push` never blocks and never allocates: messages are linked through `Message::next`. `pop`
+    may briefly return null while a concurrent `push` is between its two steps, even though the
+    queue isn't logically empty; callers that know a message is there can simply retry.
+
+    Source: http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+*/
+
+class MessageQueue : private util::noncopyable {
+public:
+    MessageQueue();
+    ~MessageQueue();
+
+    void push(std::unique_ptr<Message>);
+    std::unique_ptr<Message> pop();
+
+private:
+    void push(Message*);
+
+    class Stub : public Message {
+    public:
+        void operator()() override {}
+    };
+
+    Stub stub;
+    std::atomic<Message*> head;
+    Message* tail;
+};
+
+} // namespace mbgl
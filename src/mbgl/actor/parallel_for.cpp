@@ -0,0 +1,97 @@
+#include <mbgl/actor/parallel_for.hpp>
+#include <mbgl/actor/actor.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace mbgl {
+namespace actor {
+
+namespace {
+
+class Loop {
+public:
+    Loop(std::size_t count_, const std::function<void (std::size_t)>& fn_)
+        : count(count_), fn(fn_) {
+    }
+
+    // Runs iterations until there are none left to claim. Once all of them are claimed, `fn`
+    // isn't touched anymore, so helpers that only start after the loop returned are harmless.
+    void work() {
+        for (std::size_t i = next++; i < count; i = next++) {
+            fn(i);
+            if (++done == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                cv.notify_all();
+            }
+        }
+    }
+
+    // Waits for iterations that other threads are still running.
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return done == count; });
+    }
+
+private:
+    const std::size_t count;
+    const std::function<void (std::size_t)>& fn;
+
+    std::atomic<std::size_t> next { 0 };
+    std::atomic<std::size_t> done { 0 };
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+} // namespace
+
+class ParallelFor::Helper {
+public:
+    Helper(ActorRef<Helper>) {
+    }
+
+    // Shares ownership of the loop, as it may only get to run after the loop has returned.
+    void run(std::shared_ptr<Loop> loop) {
+        loop->work();
+    }
+};
+
+ParallelFor::ParallelFor(Scheduler& scheduler_)
+    : scheduler(scheduler_) {
+}
+
+// Destroying a helper closes its mailbox, which waits for it to return if it's running, and
+// otherwise keeps it from starting.
+ParallelFor::~ParallelFor() = default;
+
+void ParallelFor::operator()(std::size_t count, const std::function<void (std::size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    auto loop = std::make_shared<Loop>(count, fn);
+
+    const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t helperCount = std::min(count, cores) - 1;
+
+    while (helpers.size() < helperCount) {
+        helpers.push_back(std::make_unique<Actor<Helper>>(scheduler));
+    }
+    for (std::size_t i = 0; i < helperCount; ++i) {
+        helpers[i]->invoke(&Helper::run, loop);
+    }
+
+    loop->work();
+    loop->wait();
+}
+
+void parallelFor(Scheduler& scheduler, std::size_t count, const std::function<void (std::size_t)>& fn) {
+    ParallelFor helpers(scheduler);
+    helpers(count, fn);
+}
+
+} // namespace actor
+} // namespace mbgl
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+
+class Scheduler;
+template <class> class Actor;
+
+namespace actor {
+
+/*
+    Calls `fn(i)` for every `i` in [0, count), spreading the calls over `scheduler`, and returns
+    once all of them have returned. `fn` must not throw, and calls for different `i` may run
+    concurrently.
+
+    The calling thread takes part in the work. This makes it safe to call from an actor running
+    on `scheduler` itself: even if no other thread is free, the loop still completes.
+
+    The work is spread over helper actors on `scheduler`. This function creates them for the one
+    loop; callers that run loops over and over, e.g. one per tile layout, keep a `ParallelFor`
+    instead, which reuses its helpers.
+*/
+void parallelFor(Scheduler& scheduler, std::size_t count, const std::function<void (std::size_t)>& fn);
+
+class ParallelFor : private util::noncopyable {
+public:
+    ParallelFor(Scheduler&);
+    ~ParallelFor();
+
+    // Like `parallelFor()`. Runs one loop at a time: not to be called again until it returns.
+    void operator()(std::size_t count, const std::function<void (std::size_t)>& fn);
+
+private:
+    class Helper;
+
+    Scheduler& scheduler;
+
+    // Created as loops need them, up to one fewer than there are cores.
+    std::vector<std::unique_ptr<Actor<Helper>>> helpers;
+};
+
+} // namespace actor
+} // namespace mbgl
@@ -21,6 +21,13 @@ class Mailbox;
       Subject to these constraints, processing can happen on whatever thread in the
       pool is available.
 
+    * `WorkStealingThreadPool` provides the same guarantees as `ThreadPool`, but gives each
+      thread its own queue and lets idle threads steal work, instead of having all threads
+      contend on one shared queue.
+
+    * `SharedThreadPool` lets many clients, e.g. one per `Map`, share one set of threads, with a
+      `SharedThreadPool::Share` scheduler per client that gets a weighted fair share of the pool.
+
     * `RunLoop` is a `Scheduler` that is typically used to create a mailbox and
       `ActorRef` for an object that lives on the main thread and is not itself wrapped
       as an `Actor`:
@@ -0,0 +1,97 @@
+#include <mbgl/actor/statistics.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace mbgl {
+
+constexpr std::size_t ActorStats::BucketCount;
+
+namespace actor {
+
+namespace {
+
+std::size_t bucket(Duration duration) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    std::size_t index = 0;
+    while (us > 0 && index + 1 < Statistics::BucketCount) {
+        us >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+struct Registry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<Statistics::Counters>> counters;
+};
+
+Registry& registry() {
+    // Leaked, so that counters outlive any mailbox, including those destroyed during exit.
+    static Registry& instance = *new Registry;
+    return instance;
+}
+
+} // namespace
+
+constexpr std::size_t Statistics::BucketCount;
+
+void Statistics::Counters::pushed() {
+    queueDepth.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Statistics::Counters::processed(Duration wait, Duration run) {
+    waitTime[bucket(wait)].fetch_add(1, std::memory_order_relaxed);
+    runTime[bucket(run)].fetch_add(1, std::memory_order_relaxed);
+    processedCount.fetch_add(1, std::memory_order_relaxed);
+    queueDepth.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Statistics::Counters::dropped() {
+    droppedCount.fetch_add(1, std::memory_order_relaxed);
+    queueDepth.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Statistics::Counters::discarded(std::size_t count) {
+    queueDepth.fetch_sub(count, std::memory_order_relaxed);
+}
+
+Statistics::Counters& Statistics::get(const std::string& tag) {
+    Registry& instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    auto& counters = instance.counters[tag];
+    if (!counters) {
+        counters = std::make_unique<Counters>();
+    }
+    return *counters;
+}
+
+std::vector<Statistics::Snapshot> Statistics::snapshot() {
+    Registry& instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+
+    std::vector<Snapshot> result;
+    result.reserve(instance.counters.size());
+
+    for (const auto& entry : instance.counters) {
+        const Counters& counters = *entry.second;
+
+        Snapshot snapshot;
+        snapshot.tag = entry.first;
+        snapshot.queueDepth = counters.queueDepth.load(std::memory_order_relaxed);
+        snapshot.processed = counters.processedCount.load(std::memory_order_relaxed);
+        snapshot.dropped = counters.droppedCount.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < BucketCount; ++i) {
+            snapshot.waitTime[i] = counters.waitTime[i].load(std::memory_order_relaxed);
+            snapshot.runTime[i] = counters.runTime[i].load(std::memory_order_relaxed);
+        }
+
+        result.push_back(std::move(snapshot));
+    }
+
+    return result;
+}
+
+} // namespace actor
+} // namespace mbgl
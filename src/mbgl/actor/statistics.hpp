@@ -0,0 +1,57 @@
+#pragma once
+
+#include <mbgl/map/actor_stats.hpp>
+#include <mbgl/util/chrono.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace actor {
+
+/*
+    Per-actor-type instrumentation of the actor system. A mailbox is tagged with the name of the
+    actor type it delivers to (see `Mailbox::setTag()`), and all mailboxes with the same tag share
+    one set of counters. Untagged mailboxes aren't instrumented.
+
+    Snapshots are published through Map::getActorStats(); see ActorStats for what's recorded.
+*/
+
+class Statistics {
+public:
+    static constexpr std::size_t BucketCount = ActorStats::BucketCount;
+    using Histogram = ActorStats::Histogram;
+
+    using Snapshot = ActorStats;
+
+    // Returns the current statistics of every tag, ordered by tag. Can be called from any thread.
+    static std::vector<Snapshot> snapshot();
+
+    class Counters {
+    public:
+        void pushed();
+        void processed(Duration wait, Duration run);
+        void dropped();
+        // Messages that will never be delivered, because their mailbox was destroyed.
+        void discarded(std::size_t count);
+
+    private:
+        friend class Statistics;
+
+        std::atomic<std::size_t> queueDepth { 0 };
+        std::atomic<uint64_t> processedCount { 0 };
+        std::atomic<uint64_t> droppedCount { 0 };
+        std::array<std::atomic<uint64_t>, BucketCount> waitTime {};
+        std::array<std::atomic<uint64_t>, BucketCount> runTime {};
+    };
+
+    // Returns the counters shared by all mailboxes with this tag. They are never destroyed.
+    static Counters& get(const std::string& tag);
+};
+
+} // namespace actor
+} // namespace mbgl
@@ -9,9 +9,17 @@
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geometry/envelope.hpp>
 
 #include <boost/function_output_iterator.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -54,38 +62,165 @@ Update AnnotationManager::updateAnnotation(const AnnotationID& id, const Annotat
 
 void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
+        markDirty(*symbolAnnotations.at(id));
         symbolTree.remove(symbolAnnotations.at(id));
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
+        markDirty(*shapeAnnotations.at(id));
         obsoleteShapeAnnotationLayers.insert(shapeAnnotations.at(id)->layerID);
         shapeAnnotations.erase(id);
     } else {
         assert(false); // Should never happen
     }
+
+    if (symbolAnnotations.empty() && shapeAnnotations.empty()) {
+        allDirty = true;
+    }
+}
+
+AnnotationIDs AnnotationManager::addAnnotations(const std::vector<Annotation>& annotations, const uint8_t maxZoom) {
+    AnnotationIDs ids;
+    ids.reserve(annotations.size());
+
+    std::vector<std::shared_ptr<const SymbolAnnotationImpl>> symbols;
+    for (const auto& annotation : annotations) {
+        const AnnotationID id = nextID++;
+        ids.push_back(id);
+        if (annotation.is<SymbolAnnotation>()) {
+            symbols.push_back(addSymbol(id, annotation.get<SymbolAnnotation>()));
+        } else {
+            Annotation::visit(annotation, [&] (const auto& annotation_) {
+                this->add(id, annotation_, maxZoom);
+            });
+        }
+    }
+
+    // Packing the tree is quicker than inserting more symbols than it held one at a time, and
+    // yields a tree that's quicker to query.
+    if (symbols.size() >= symbolTree.size()) {
+        packSymbolTree();
+    } else {
+        symbolTree.insert(symbols.begin(), symbols.end());
+    }
+
+    return ids;
+}
+
+void AnnotationManager::removeAnnotations(const AnnotationIDs& ids) {
+    std::vector<std::shared_ptr<const SymbolAnnotationImpl>> symbols;
+    for (const auto& id : ids) {
+        auto it = symbolAnnotations.find(id);
+        if (it == symbolAnnotations.end()) {
+            removeAnnotation(id);
+            continue;
+        }
+        markDirty(*it->second);
+        symbols.push_back(it->second);
+        symbolAnnotations.erase(it);
+    }
+
+    if (symbols.size() >= symbolAnnotations.size()) {
+        packSymbolTree();
+    } else {
+        for (const auto& symbol : symbols) {
+            symbolTree.remove(symbol);
+        }
+    }
+
+    if (symbolAnnotations.empty() && shapeAnnotations.empty()) {
+        allDirty = true;
+    }
+}
+
+void AnnotationManager::packSymbolTree() {
+    std::vector<std::shared_ptr<const SymbolAnnotationImpl>> symbols;
+    symbols.reserve(symbolAnnotations.size());
+    for (const auto& symbol : symbolAnnotations) {
+        symbols.push_back(symbol.second);
+    }
+    // The range constructor packs the tree rather than inserting each value.
+    symbolTree = SymbolAnnotationTree(symbols.begin(), symbols.end());
 }
 
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t) {
+    symbolTree.insert(addSymbol(id, annotation));
+}
+
+std::shared_ptr<SymbolAnnotationImpl> AnnotationManager::addSymbol(const AnnotationID& id, const SymbolAnnotation& annotation) {
+    allDirty |= symbolAnnotations.empty() && shapeAnnotations.empty();
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
-    symbolTree.insert(impl);
     symbolAnnotations.emplace(id, impl);
+    markDirty(*impl);
+    return impl;
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation, const uint8_t maxZoom) {
+    allDirty |= symbolAnnotations.empty() && shapeAnnotations.empty();
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<LineAnnotationImpl>(id, annotation, maxZoom)).first->second;
     obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    markDirty(impl);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation, const uint8_t maxZoom) {
+    allDirty |= symbolAnnotations.empty() && shapeAnnotations.empty();
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<FillAnnotationImpl>(id, annotation, maxZoom)).first->second;
     obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    markDirty(impl);
 }
 
 void AnnotationManager::add(const AnnotationID& id, const StyleSourcedAnnotation& annotation, const uint8_t maxZoom) {
+    allDirty |= symbolAnnotations.empty() && shapeAnnotations.empty();
     ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
         std::make_unique<StyleSourcedAnnotationImpl>(id, annotation, maxZoom)).first->second;
     obsoleteShapeAnnotationLayers.erase(impl.layerID);
+    markDirty(impl);
+}
+
+namespace {
+
+mapbox::geometry::box<double> projectBox(double west, double south, double east, double north) {
+    const Point<double> nw = Projection::project(
+        LatLng(util::clamp(north, -util::LATITUDE_MAX, util::LATITUDE_MAX), west), 1.0 / util::tileSize);
+    const Point<double> se = Projection::project(
+        LatLng(util::clamp(south, -util::LATITUDE_MAX, util::LATITUDE_MAX), east), 1.0 / util::tileSize);
+    return { { nw.x, nw.y }, { se.x, se.y } };
+}
+
+} // namespace
+
+void AnnotationManager::markDirty(const SymbolAnnotationImpl& impl) {
+    const Point<double>& point = impl.annotation.geometry;
+    dirtyBoxes.push_back(projectBox(point.x, point.y, point.x, point.y));
+}
+
+void AnnotationManager::markDirty(const ShapeAnnotationImpl& impl) {
+    const auto envelope = ShapeAnnotationGeometry::visit(impl.geometry(), [] (const auto& geometry) {
+        return mapbox::geometry::envelope(geometry);
+    });
+    dirtyBoxes.push_back(projectBox(envelope.min.x, envelope.min.y, envelope.max.x, envelope.max.y));
+}
+
+bool AnnotationManager::isDirty(const CanonicalTileID& tileID) const {
+    // Shapes reach into the buffer of neighbouring tiles, and symbols are only in the tiles that
+    // hold them, but the tiles next to a symbol are regenerated too, which is cheaper than telling
+    // them apart.
+    const double scale = std::pow(2.0, tileID.z);
+    const double buffer = ShapeAnnotationImpl::Buffer / double(util::EXTENT);
+    const Box tile { { (tileID.x - buffer) / scale, (tileID.y - buffer) / scale },
+                     { (tileID.x + 1 + buffer) / scale, (tileID.y + 1 + buffer) / scale } };
+
+    // Annotations may lie across the antimeridian, beyond the longitudes of the world.
+    return std::any_of(dirtyBoxes.begin(), dirtyBoxes.end(), [&] (const Box& box) {
+        for (double wrap = -1; wrap <= 1; wrap++) {
+            if (box.min.x + wrap <= tile.max.x && tile.min.x <= box.max.x + wrap &&
+                box.min.y <= tile.max.y && tile.min.y <= box.max.y) {
+                return true;
+            }
+        }
+        return false;
+    });
 }
 
 Update AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation, const uint8_t maxZoom) {
@@ -207,8 +342,24 @@ void AnnotationManager::updateStyle(Style& style) {
 
 void AnnotationManager::updateData() {
     for (auto& tile : tiles) {
-        tile->setData(getTileData(tile->id.canonical));
+        if (allDirty || isDirty(tile->id.canonical)) {
+            tile->setData(getTileData(tile->id.canonical));
+        }
+    }
+    dirtyBoxes.clear();
+    allDirty = false;
+}
+
+MemoryUsage AnnotationManager::getMemoryUsage() {
+    MemoryUsage usage = spriteAtlas.getMemoryUsage();
+    for (const auto& entry : symbolAnnotations) {
+        usage.cpu += sizeof(SymbolAnnotationImpl) + entry.second->annotation.icon.capacity();
+    }
+    usage.cpu += symbolTree.size() * sizeof(SymbolAnnotationTree::value_type);
+    for (const auto& entry : shapeAnnotations) {
+        usage.cpu += entry.second->getMemoryUsage();
     }
+    return usage;
 }
 
 void AnnotationManager::addTile(AnnotationTile& tile) {
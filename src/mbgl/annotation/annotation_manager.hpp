@@ -6,6 +6,8 @@
 #include <mbgl/map/update.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
+#include <mapbox/geometry/box.hpp>
+
 #include <string>
 #include <vector>
 #include <unordered_set>
@@ -32,6 +34,10 @@ public:
     Update updateAnnotation(const AnnotationID&, const Annotation&, const uint8_t maxZoom);
     void removeAnnotation(const AnnotationID&);
 
+    // Like the above for each annotation, but the symbols are indexed in bulk.
+    AnnotationIDs addAnnotations(const std::vector<Annotation>&, const uint8_t maxZoom);
+    void removeAnnotations(const AnnotationIDs&);
+
     void addIcon(const std::string& name, std::shared_ptr<const SpriteImage>);
     void removeIcon(const std::string& name);
     double getTopOffsetPixelsForIcon(const std::string& name);
@@ -43,11 +49,19 @@ public:
     void addTile(AnnotationTile&);
     void removeTile(AnnotationTile&);
 
+    // An estimate of the memory held by the annotations and the atlas of their icons. Their tiles
+    // are those of the annotation source.
+    MemoryUsage getMemoryUsage();
+
     static const std::string SourceID;
     static const std::string PointLayerID;
 
 private:
     void add(const AnnotationID&, const SymbolAnnotation&, const uint8_t);
+    // Adds the symbol without indexing it.
+    std::shared_ptr<SymbolAnnotationImpl> addSymbol(const AnnotationID&, const SymbolAnnotation&);
+    // Packs the index of the symbols anew.
+    void packSymbolTree();
     void add(const AnnotationID&, const LineAnnotation&, const uint8_t);
     void add(const AnnotationID&, const FillAnnotation&, const uint8_t);
     void add(const AnnotationID&, const StyleSourcedAnnotation&, const uint8_t);
@@ -61,6 +75,12 @@ private:
 
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
 
+    // Records the extent of an annotation that was added or removed, so that updateData() only
+    // regenerates the tiles that may show it.
+    void markDirty(const SymbolAnnotationImpl&);
+    void markDirty(const ShapeAnnotationImpl&);
+    bool isDirty(const CanonicalTileID&) const;
+
     AnnotationID nextID = 0;
 
     using SymbolAnnotationTree = boost::geometry::index::rtree<std::shared_ptr<const SymbolAnnotationImpl>, boost::geometry::index::rstar<16, 4>>;
@@ -74,6 +94,13 @@ private:
     ShapeAnnotationMap shapeAnnotations;
     std::unordered_set<std::string> obsoleteShapeAnnotationLayers;
     std::unordered_set<AnnotationTile*> tiles;
+
+    // In world coordinates, from 0 to 1.
+    using Box = mapbox::geometry::box<double>;
+    std::vector<Box> dirtyBoxes;
+    // Whether annotations were added while there weren't any, or all were removed, which
+    // changes whether tiles have data at all.
+    bool allDirty = false;
     SpriteAtlas spriteAtlas;
 };
 
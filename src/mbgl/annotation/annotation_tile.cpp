@@ -27,6 +27,13 @@ AnnotationTileFeature::AnnotationTileFeature(const AnnotationID id_,
     : id(id_),
       type(type_),
       properties(std::move(properties_)),
+      geometries(std::make_shared<const GeometryCollection>(std::move(geometries_))) {}
+
+AnnotationTileFeature::AnnotationTileFeature(const AnnotationID id_,
+                                             FeatureType type_,
+                                             std::shared_ptr<const GeometryCollection> geometries_)
+    : id(id_),
+      type(type_),
       geometries(std::move(geometries_)) {}
 
 optional<Value> AnnotationTileFeature::getValue(const std::string& key) const {
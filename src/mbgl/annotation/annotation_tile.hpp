@@ -29,15 +29,19 @@ public:
     AnnotationTileFeature(AnnotationID, FeatureType, GeometryCollection,
                           std::unordered_map<std::string, std::string> properties = {{}});
 
+    // Shares the geometries, e.g. with the cache of a shape annotation.
+    AnnotationTileFeature(AnnotationID, FeatureType, std::shared_ptr<const GeometryCollection>);
+
     FeatureType getType() const override { return type; }
     optional<Value> getValue(const std::string&) const override;
     optional<FeatureIdentifier> getID() const override { return { id }; }
-    GeometryCollection getGeometries() const override { return geometries; }
+    GeometryCollection getGeometries() const override { return *geometries; }
 
     const AnnotationID id;
     const FeatureType type;
     const std::unordered_map<std::string, std::string> properties;
-    const GeometryCollection geometries;
+    // Shared by the copies of the feature, which the tile's layer makes for every feature read.
+    const std::shared_ptr<const GeometryCollection> geometries;
 };
 
 class AnnotationTileLayer : public GeometryTileLayer {
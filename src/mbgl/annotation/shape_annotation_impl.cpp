@@ -6,12 +6,18 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/memory_usage.hpp>
+
+#include <mapbox/geometry/for_each_point.hpp>
 
 namespace mbgl {
 
 using namespace style;
 namespace geojsonvt = mapbox::geojsonvt;
 
+const constexpr uint16_t ShapeAnnotationImpl::Buffer;
+const constexpr std::size_t ShapeAnnotationImpl::TileCacheSize;
+
 ShapeAnnotationImpl::ShapeAnnotationImpl(const AnnotationID id_, const uint8_t maxZoom_)
     : id(id_),
       maxZoom(maxZoom_),
@@ -19,8 +25,45 @@ ShapeAnnotationImpl::ShapeAnnotationImpl(const AnnotationID id_, const uint8_t m
 }
 
 void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, AnnotationTileData& data) {
+    const std::vector<AnnotationTileFeature>& shapeFeatures = getTileFeatures(tileID);
+    if (shapeFeatures.empty())
+        return;
+
+    AnnotationTileLayer& layer = data.layers.emplace(layerID, layerID).first->second;
+    layer.features.insert(layer.features.end(), shapeFeatures.begin(), shapeFeatures.end());
+}
+
+std::size_t ShapeAnnotationImpl::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    ShapeAnnotationGeometry::visit(geometry(), [&] (const auto& geom) {
+        mapbox::geometry::for_each_point(geom, [&] (const auto&) {
+            bytes += sizeof(Point<double>);
+        });
+    });
+    for (const auto& tile : tileFeatures) {
+        for (const auto& feature : tile.second) {
+            bytes += sizeof(AnnotationTileFeature);
+            for (const auto& ring : *feature.geometries) {
+                bytes += util::memoryUsage(ring);
+            }
+        }
+    }
+    return bytes;
+}
+
+const std::vector<AnnotationTileFeature>& ShapeAnnotationImpl::getTileFeatures(const CanonicalTileID& tileID) {
     static const double baseTolerance = 4;
 
+    auto it = tileFeatures.find(tileID);
+    if (it != tileFeatures.end()) {
+        return it->second;
+    }
+
+    if (tileFeatures.size() >= TileCacheSize) {
+        tileFeatures.clear();
+    }
+    std::vector<AnnotationTileFeature>& result = tileFeatures[tileID];
+
     if (!shapeTiler) {
         mapbox::geometry::feature_collection<double> features;
         features.emplace_back(ShapeAnnotationGeometry::visit(geometry(), [] (auto&& geom) {
@@ -28,17 +71,13 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
         }));
         mapbox::geojsonvt::Options options;
         options.maxZoom = maxZoom;
-        options.buffer = 255u;
+        options.buffer = Buffer;
         options.extent = util::EXTENT;
         options.tolerance = baseTolerance;
         shapeTiler = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(features, options);
     }
 
     const auto& shapeTile = shapeTiler->getTile(tileID.z, tileID.x, tileID.y);
-    if (shapeTile.features.empty())
-        return;
-
-    AnnotationTileLayer& layer = data.layers.emplace(layerID, layerID).first->second;
 
     ToGeometryCollection toGeometryCollection;
     ToFeatureType toFeatureType;
@@ -53,8 +92,10 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
             renderGeometry = fixupPolygons(renderGeometry);
         }
 
-        layer.features.emplace_back(id, featureType, renderGeometry);
+        result.emplace_back(id, featureType, std::make_shared<const GeometryCollection>(std::move(renderGeometry)));
     }
+
+    return result;
 }
 
 } // namespace mbgl
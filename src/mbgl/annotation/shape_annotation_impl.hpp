@@ -3,16 +3,17 @@
 #include <mapbox/geojsonvt.hpp>
 
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/geometry.hpp>
 
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
-class AnnotationTileData;
-class CanonicalTileID;
-
 namespace style {
 class Style;
 } // namespace style
@@ -27,10 +28,28 @@ public:
 
     void updateTileData(const CanonicalTileID&, AnnotationTileData&);
 
+    // An estimate of the memory held by the shape's geometry and the features of its tiles, in
+    // bytes. The slices of the shape that `shapeTiler` keeps aren't counted.
+    std::size_t getMemoryUsage() const;
+
+    // How far the shapes reach into neighbouring tiles, in tile units.
+    static constexpr uint16_t Buffer = 255;
+
+    // The number of tiles whose features are kept, beyond which the cache starts over.
+    static constexpr std::size_t TileCacheSize = 512;
+
     const AnnotationID id;
     const uint8_t maxZoom;
     const std::string layerID;
     std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> shapeTiler;
+
+private:
+    const std::vector<AnnotationTileFeature>& getTileFeatures(const CanonicalTileID&);
+
+    // The simplified features of the tiles that were generated so far, also where there are none,
+    // so that an unchanged shape is neither sliced nor converted again when its tiles are
+    // regenerated for other annotations, or for another style. The tiles share their geometries.
+    std::unordered_map<CanonicalTileID, std::vector<AnnotationTileFeature>> tileFeatures;
 };
 
 struct CloseShapeAnnotation {
@@ -0,0 +1,90 @@
+#include <mbgl/geometry/dem_data.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace mbgl {
+
+DEMData::DEMData(const PremultipliedImage& source, Tileset::DEMEncoding encoding_)
+    : encoding(encoding_),
+      dim(source.width),
+      image(source.width + 2, source.height + 2) {
+    if (source.width != source.height || !source.width) {
+        throw std::runtime_error("DEM tiles must be square");
+    }
+
+    const std::size_t stride = source.stride();
+    for (int32_t y = 0; y < dim; y++) {
+        std::memcpy(texel(0, y), source.data.get() + y * stride, stride);
+    }
+
+    // The edges of the tile stand in for its neighbours until they're backfilled. DEM tiles are
+    // opaque, so they're the same premultiplied and not.
+    for (int32_t x = 0; x < dim; x++) {
+        std::memcpy(texel(x, -1), texel(x, 0), 4);
+        std::memcpy(texel(x, dim), texel(x, dim - 1), 4);
+    }
+    for (int32_t y = -1; y <= dim; y++) {
+        std::memcpy(texel(-1, y), texel(0, y), 4);
+        std::memcpy(texel(dim, y), texel(dim - 1, y), 4);
+    }
+}
+
+Rect<uint16_t> DEMData::backfillBorder(const DEMData& other, int8_t dx, int8_t dy) {
+    assert(other.dim == dim);
+    assert(dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1 && (dx || dy));
+
+    // The texels of the border that the other tile covers, in this tile's coordinates.
+    int32_t xMin = dx * dim;
+    int32_t xMax = dx * dim + dim;
+    int32_t yMin = dy * dim;
+    int32_t yMax = dy * dim + dim;
+
+    if (dx == -1) {
+        xMin = xMax - 1;
+    } else if (dx == 1) {
+        xMax = xMin + 1;
+    }
+
+    if (dy == -1) {
+        yMin = yMax - 1;
+    } else if (dy == 1) {
+        yMax = yMin + 1;
+    }
+
+    const int32_t ox = -dx * dim;
+    const int32_t oy = -dy * dim;
+    for (int32_t y = yMin; y < yMax; y++) {
+        std::memcpy(texel(xMin, y), other.texel(xMin + ox, y + oy), (xMax - xMin) * 4);
+    }
+
+    return { uint16_t(xMin + 1), uint16_t(yMin + 1), uint16_t(xMax - xMin), uint16_t(yMax - yMin) };
+}
+
+float DEMData::get(int32_t x, int32_t y) const {
+    const uint8_t* value = texel(x, y);
+    const std::array<float, 4> unpack = getUnpackVector();
+    return value[0] * unpack[0] + value[1] * unpack[1] + value[2] * unpack[2] - unpack[3];
+}
+
+std::array<float, 4> DEMData::getUnpackVector() const {
+    if (encoding == Tileset::DEMEncoding::Terrarium) {
+        // (r * 256 + g + b / 256) - 32768
+        return {{ 256.0f, 1.0f, 1.0f / 256.0f, 32768.0f }};
+    }
+    // (r * 256 * 256 + g * 256 + b) / 10 - 10000
+    return {{ 6553.6f, 25.6f, 0.1f, 10000.0f }};
+}
+
+const uint8_t* DEMData::texel(int32_t x, int32_t y) const {
+    assert(x >= -1 && x <= dim && y >= -1 && y <= dim);
+    return image.data.get() + ((y + 1) * image.width + (x + 1)) * 4;
+}
+
+uint8_t* DEMData::texel(int32_t x, int32_t y) {
+    assert(x >= -1 && x <= dim && y >= -1 && y <= dim);
+    return image.data.get() + ((y + 1) * image.width + (x + 1)) * 4;
+}
+
+} // namespace mbgl
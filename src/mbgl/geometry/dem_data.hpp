@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/rect.hpp>
+#include <mbgl/util/tileset.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace mbgl {
+
+// The elevations of a DEM raster tile, kept in the RGB texels that encode them, with a border of
+// one texel around the tile, so that the slopes along the edges can be computed like those inside.
+// The border starts out as a copy of the tile's edges, and is backfilled from the neighbouring
+// tiles as they load, so that the shading is seamless across tiles.
+class DEMData {
+public:
+    // Throws if the image isn't square.
+    DEMData(const PremultipliedImage&, Tileset::DEMEncoding);
+
+    // Copies the edge of `other`, the tile `dx`, `dy` (each -1, 0 or 1) from this one, into the
+    // side of the border that it touches. Returns the texels of the image that changed.
+    Rect<uint16_t> backfillBorder(const DEMData& other, int8_t dx, int8_t dy);
+
+    // The elevation in meters at a texel of the tile, from -1 to `dim` for the border.
+    float get(int32_t x, int32_t y) const;
+
+    // Weights that decode an elevation from a texel's channels scaled to 0-255, and an offset
+    // in the last component, the way the preparation shader does: dot(rgb, xyz) - w.
+    std::array<float, 4> getUnpackVector() const;
+
+    const Tileset::DEMEncoding encoding;
+
+    // The width and height of the tile, without the border.
+    const int32_t dim;
+
+    // The tile and its border, `dim + 2` texels wide.
+    PremultipliedImage image;
+
+private:
+    const uint8_t* texel(int32_t x, int32_t y) const;
+    uint8_t* texel(int32_t x, int32_t y);
+};
+
+} // namespace mbgl
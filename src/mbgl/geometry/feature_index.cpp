@@ -6,6 +6,7 @@
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/memory_usage.hpp>
 #include <mbgl/math/minmax.hpp>
 
 #include <mapbox/geometry/envelope.hpp>
@@ -15,6 +16,56 @@
 
 namespace mbgl {
 
+// The most decoded features an index keeps for later queries.
+static const std::size_t maxDecodedFeatures = 1024;
+
+// A feature of the tile's data that keeps its geometries once they're decoded, which happens when
+// they're first tested against a style layer of the feature's bucket, or converted by
+// IndexedRenderedFeature::toFeature(). Symbols are never tested, so that just finding them
+// doesn't decode them.
+class FeatureIndex::DecodedFeature : public GeometryTileFeature {
+public:
+    DecodedFeature(std::unique_ptr<GeometryTileFeature> feature_)
+        : feature(std::move(feature_)) {
+    }
+
+    FeatureType getType() const override { return feature->getType(); }
+    optional<Value> getValue(const std::string& key) const override { return feature->getValue(key); }
+    optional<Value> getValueByKeyIndex(std::size_t index) const override { return feature->getValueByKeyIndex(index); }
+    PropertyMap getProperties() const override { return feature->getProperties(); }
+    optional<FeatureIdentifier> getID() const override { return feature->getID(); }
+    GeometryCollection getGeometries() const override { return getDecodedGeometries(); }
+    optional<GeometryBox> getBoundingBox() const override { return feature->getBoundingBox(); }
+
+    void eachGeometry(const std::function<void (const GeometryCoordinates&)>& fn) const override {
+        for (const auto& ring : getDecodedGeometries()) {
+            fn(ring);
+        }
+    }
+
+    const GeometryCollection& getDecodedGeometries() const {
+        if (!geometries) {
+            geometries = feature->getGeometries();
+        }
+        return *geometries;
+    }
+
+    std::size_t getMemoryUsage() const {
+        std::size_t bytes = sizeof(*this);
+        if (geometries) {
+            bytes += util::memoryUsage(*geometries);
+            for (const auto& ring : *geometries) {
+                bytes += util::memoryUsage(ring);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    const std::unique_ptr<GeometryTileFeature> feature;
+    mutable optional<GeometryCollection> geometries;
+};
+
 FeatureIndex::FeatureIndex()
     : grid(util::EXTENT, 16, 0) {
 }
@@ -24,11 +75,22 @@ void FeatureIndex::insert(const GeometryCollection& geometries,
                           const std::string& sourceLayerName,
                           const std::string& bucketName) {
     for (const auto& ring : geometries) {
-        grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
-                    mapbox::geometry::envelope(ring));
+        insert(ring, index, sourceLayerName, bucketName);
     }
 }
 
+void FeatureIndex::insert(const GeometryCoordinates& ring,
+                          std::size_t index,
+                          const std::string& sourceLayerName,
+                          const std::string& bucketName) {
+    grid.insert(IndexedSubfeature { index, sourceLayerName, bucketName, sortIndex++ },
+                mapbox::geometry::envelope(ring));
+}
+
+void FeatureIndex::finish() {
+    grid.finish();
+}
+
 static bool vectorContains(const std::vector<std::string>& vector, const std::string& s) {
     return std::find(vector.begin(), vector.end(), s) != vector.end();
 }
@@ -50,8 +112,15 @@ static bool topDownSymbols(const IndexedSubfeature& a, const IndexedSubfeature&
     return a.sortIndex < b.sortIndex;
 }
 
+// Groups the hits of each source layer, which keeps them in order within every style layer, since
+// each bucket reads a single source layer.
+static bool bySourceLayerTopDown(const IndexedSubfeature& a, const IndexedSubfeature& b) {
+    const int compared = a.sourceLayerName.compare(b.sourceLayerName);
+    return compared != 0 ? compared < 0 : topDown(a, b);
+}
+
 void FeatureIndex::query(
-        std::unordered_map<std::string, std::vector<Feature>>& result,
+        IndexedRenderedFeatures& result,
         const GeometryCoordinates& queryGeometry,
         const float bearing,
         const double tileSize,
@@ -67,7 +136,10 @@ void FeatureIndex::query(
     const int16_t additionalRadius = std::min<int16_t>(util::EXTENT, std::ceil(style.getQueryRadius() * pixelsToTileUnits));
     std::vector<IndexedSubfeature> features = grid.query({ box.min - additionalRadius, box.max + additionalRadius });
 
-    std::sort(features.begin(), features.end(), topDown);
+    setDecodedData(geometryTileData);
+    SourceLayerCursor cursor;
+
+    std::sort(features.begin(), features.end(), bySourceLayerTopDown);
     size_t previousSortIndex = std::numeric_limits<size_t>::max();
     for (const auto& indexedFeature : features) {
 
@@ -75,7 +147,7 @@ void FeatureIndex::query(
         if (indexedFeature.sortIndex == previousSortIndex) continue;
         previousSortIndex = indexedFeature.sortIndex;
 
-        addFeature(result, indexedFeature, queryGeometry, filterLayerIDs, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        addFeature(result, cursor, indexedFeature, queryGeometry, filterLayerIDs, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
     }
 
     // Query symbol features, if they've been placed.
@@ -86,12 +158,63 @@ void FeatureIndex::query(
     std::vector<IndexedSubfeature> symbolFeatures = collisionTile->queryRenderedSymbols(queryGeometry, scale);
     std::sort(symbolFeatures.begin(), symbolFeatures.end(), topDownSymbols);
     for (const auto& symbolFeature : symbolFeatures) {
-        addFeature(result, symbolFeature, queryGeometry, filterLayerIDs, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
+        addFeature(result, cursor, symbolFeature, queryGeometry, filterLayerIDs, geometryTileData, tileID, style, bearing, pixelsToTileUnits);
     }
 }
 
+std::shared_ptr<const GeometryTileFeature> FeatureIndex::getFeature(const std::string& sourceLayerName,
+                                                                    std::size_t index,
+                                                                    const GeometryTileData& geometryTileData) const {
+    setDecodedData(geometryTileData);
+    const GeometryTileLayer* layer = geometryTileData.getLayer(sourceLayerName);
+    if (!layer || index >= layer->featureCount()) {
+        return nullptr;
+    }
+
+    SourceLayerCursor cursor;
+    return decodeFeature(cursor, sourceLayerName, index, geometryTileData);
+}
+
+void FeatureIndex::setDecodedData(const GeometryTileData& geometryTileData) const {
+    if (decodedData != &geometryTileData) {
+        decodedFeatures.clear();
+        decodedFeatureCount = 0;
+        decodedData = &geometryTileData;
+    }
+}
+
+std::shared_ptr<const FeatureIndex::DecodedFeature> FeatureIndex::decodeFeature(SourceLayerCursor& cursor,
+                                                                              const std::string& sourceLayerName,
+                                                                              std::size_t index,
+                                                                              const GeometryTileData& geometryTileData) const {
+    if (!cursor.name || *cursor.name != sourceLayerName) {
+        cursor.name = &sourceLayerName;
+        cursor.layer = geometryTileData.getLayer(sourceLayerName);
+        cursor.decoded = &decodedFeatures[sourceLayerName];
+    }
+    assert(cursor.layer);
+
+    auto it = cursor.decoded->find(index);
+    if (it != cursor.decoded->end()) {
+        return it->second;
+    }
+
+    if (decodedFeatureCount >= maxDecodedFeatures) {
+        for (auto& entry : decodedFeatures) {
+            entry.second.clear();
+        }
+        decodedFeatureCount = 0;
+    }
+
+    auto feature = std::make_shared<const DecodedFeature>(cursor.layer->getFeature(index));
+    cursor.decoded->emplace(index, feature);
+    decodedFeatureCount++;
+    return feature;
+}
+
 void FeatureIndex::addFeature(
-    std::unordered_map<std::string, std::vector<Feature>>& result,
+    IndexedRenderedFeatures& result,
+    SourceLayerCursor& cursor,
     const IndexedSubfeature& indexedFeature,
     const GeometryCoordinates& queryGeometry,
     const optional<std::vector<std::string>>& filterLayerIDs,
@@ -106,11 +229,7 @@ void FeatureIndex::addFeature(
         return;
     }
 
-    auto sourceLayer = geometryTileData.getLayer(indexedFeature.sourceLayerName);
-    assert(sourceLayer);
-
-    auto geometryTileFeature = sourceLayer->getFeature(indexedFeature.index);
-    assert(geometryTileFeature);
+    std::shared_ptr<const DecodedFeature> decodedFeature = decodeFeature(cursor, indexedFeature.sourceLayerName, indexedFeature.index, geometryTileData);
 
     for (const auto& layerID : layerIDs) {
         if (filterLayerIDs && !vectorContains(*filterLayerIDs, layerID)) {
@@ -120,11 +239,11 @@ void FeatureIndex::addFeature(
         auto styleLayer = style.getLayer(layerID);
         if (!styleLayer ||
             (!styleLayer->is<style::SymbolLayer>() &&
-             !styleLayer->baseImpl->queryIntersectsGeometry(queryGeometry, geometryTileFeature->getGeometries(), bearing, pixelsToTileUnits))) {
+             !styleLayer->baseImpl->queryIntersectsGeometry(queryGeometry, decodedFeature->getDecodedGeometries(), bearing, pixelsToTileUnits))) {
             continue;
         }
 
-        result[layerID].push_back(convertFeature(*geometryTileFeature, tileID));
+        result[layerID].emplace_back(layerID, decodedFeature, tileID);
     }
 }
 
@@ -154,8 +273,45 @@ void FeatureIndex::addBucketLayerName(const std::string& bucketName, const std::
     bucketLayerIDs[bucketName].push_back(layerID);
 }
 
+void FeatureIndex::append(const FeatureIndex& other) {
+    const unsigned int offset = sortIndex;
+    grid.append(other.grid, [&] (IndexedSubfeature& feature) {
+        feature.sortIndex += offset;
+    });
+    sortIndex += other.sortIndex;
+
+    for (const auto& entry : other.bucketLayerIDs) {
+        auto& layerIDs = bucketLayerIDs[entry.first];
+        layerIDs.insert(layerIDs.end(), entry.second.begin(), entry.second.end());
+    }
+}
+
 void FeatureIndex::setCollisionTile(std::unique_ptr<CollisionTile> collisionTile_) {
     collisionTile = std::move(collisionTile_);
 }
 
+std::unique_ptr<CollisionTile> FeatureIndex::releaseCollisionTile() {
+    return std::move(collisionTile);
+}
+
+std::size_t FeatureIndex::getCollisionTileMemoryUsage() const {
+    return collisionTile ? collisionTile->getMemoryUsage() : 0;
+}
+
+std::size_t FeatureIndex::getMemoryUsage() const {
+    std::size_t bytes = grid.getMemoryUsage();
+    if (collisionTile) {
+        bytes += collisionTile->getMemoryUsage();
+    }
+    for (const auto& pair : bucketLayerIDs) {
+        bytes += pair.first.capacity() + util::memoryUsage(pair.second);
+    }
+    for (const auto& pair : decodedFeatures) {
+        for (const auto& feature : pair.second) {
+            bytes += feature.second->getMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
 } // namespace mbgl
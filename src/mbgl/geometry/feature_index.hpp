@@ -1,7 +1,9 @@
 #pragma once
 
+#include <mbgl/map/query.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/feature.hpp>
 
@@ -16,7 +18,6 @@ class Style;
 } // namespace style
 
 class CollisionTile;
-class CanonicalTileID;
 
 class IndexedSubfeature {
 public:
@@ -27,14 +28,50 @@ public:
     size_t sortIndex;
 };
 
+// A feature that a query of an index found. It holds on to the feature of the tile's data, which
+// it's converted from only if it's asked to be.
+class IndexedRenderedFeature : public RenderedFeature {
+public:
+    IndexedRenderedFeature(const std::string& layerID_,
+                           std::shared_ptr<const GeometryTileFeature> feature_,
+                           const CanonicalTileID& tileID_)
+        : layerID(layerID_), feature(std::move(feature_)), tileID(tileID_) {
+    }
+
+    const std::string& getLayerID() const override {
+        return layerID;
+    }
+
+    optional<FeatureIdentifier> getID() const override {
+        return feature->getID();
+    }
+
+    Feature toFeature() const override {
+        return convertFeature(*feature, tileID);
+    }
+
+private:
+    // Owned by the index, which outlives the query.
+    const std::string& layerID;
+    std::shared_ptr<const GeometryTileFeature> feature;
+    CanonicalTileID tileID;
+};
+
+// The features that a query found, by the layers they were found in.
+using IndexedRenderedFeatures = std::unordered_map<std::string, std::vector<IndexedRenderedFeature>>;
+
 class FeatureIndex {
 public:
     FeatureIndex();
 
     void insert(const GeometryCollection&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
+    void insert(const GeometryCoordinates&, std::size_t index, const std::string& sourceLayerName, const std::string& bucketName);
+
+    // Must be called once all features are inserted, before the index is queried.
+    void finish();
 
     void query(
-            std::unordered_map<std::string, std::vector<Feature>>& result,
+            IndexedRenderedFeatures& result,
             const GeometryCoordinates& queryGeometry,
             const float bearing,
             const double tileSize,
@@ -51,13 +88,45 @@ public:
             const float bearing,
             const float pixelsToTileUnits);
 
+    // The feature of a source layer of the tile's data at the index it was inserted with, which
+    // shares the decoded features that queries keep. Null if the data has no such feature.
+    std::shared_ptr<const GeometryTileFeature> getFeature(const std::string& sourceLayerName,
+                                                          std::size_t index,
+                                                          const GeometryTileData&) const;
+
     void addBucketLayerName(const std::string& bucketName, const std::string& layerName);
 
+    // Copies the contents of another index into this one, as if they had been inserted here after
+    // the existing features.
+    void append(const FeatureIndex&);
+
     void setCollisionTile(std::unique_ptr<CollisionTile>);
+    std::unique_ptr<CollisionTile> releaseCollisionTile();
+
+    // An estimate of the memory held by the index and its collision tile, in bytes.
+    std::size_t getMemoryUsage() const;
+    // The part of it that the collision tile holds.
+    std::size_t getCollisionTileMemoryUsage() const;
 
 private:
+    class DecodedFeature;
+    using DecodedFeatures = std::unordered_map<std::size_t, std::shared_ptr<const DecodedFeature>>;
+
+    // The decoded features of the source layer that the previous hit of a query was in. Hits are
+    // sorted by their source layer, so that it changes rarely.
+    struct SourceLayerCursor {
+        const std::string* name = nullptr;
+        const GeometryTileLayer* layer = nullptr;
+        DecodedFeatures* decoded = nullptr;
+    };
+
+    // Drops the decoded features if they were decoded from other data.
+    void setDecodedData(const GeometryTileData&) const;
+    std::shared_ptr<const DecodedFeature> decodeFeature(SourceLayerCursor&, const std::string& sourceLayerName, std::size_t index, const GeometryTileData&) const;
+
     void addFeature(
-            std::unordered_map<std::string, std::vector<Feature>>& result,
+            IndexedRenderedFeatures& result,
+            SourceLayerCursor&,
             const IndexedSubfeature&,
             const GeometryCoordinates& queryGeometry,
             const optional<std::vector<std::string>>& filterLayerIDs,
@@ -72,5 +141,12 @@ private:
     unsigned int sortIndex = 0;
 
     std::unordered_map<std::string, std::vector<std::string>> bucketLayerIDs;
+
+    // The features that queries found, with their geometries decoded, by source layer and index,
+    // so that queries of the same area, e.g. on every move of the mouse, don't decode them again.
+    // Only used by the thread that queries the index, and cleared when it grows too large.
+    mutable const GeometryTileData* decodedData = nullptr;
+    mutable std::unordered_map<std::string, DecodedFeatures> decodedFeatures;
+    mutable std::size_t decodedFeatureCount = 0;
 };
 } // namespace mbgl
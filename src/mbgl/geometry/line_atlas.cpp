@@ -6,8 +6,9 @@
 
 #include <boost/functional/hash.hpp>
 
-#include <sstream>
+#include <algorithm>
 #include <cmath>
+#include <sstream>
 
 namespace mbgl {
 
@@ -15,40 +16,124 @@ LineAtlas::LineAtlas(uint16_t w, uint16_t h)
     : width(w),
       height(h),
       data(std::make_unique<char[]>(w * h)),
-      dirty(true) {
+      dirty(true),
+      freeRows({ Rows { 0, h } }) {
 }
 
 LineAtlas::~LineAtlas() = default;
 
+std::size_t LineAtlas::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = key.cap == LinePatternCap::Round;
+    for (const float part : key.dasharray) {
+        boost::hash_combine<float>(seed, part);
+    }
+    return seed;
+}
+
 LinePatternPos LineAtlas::getDashPosition(const std::vector<float>& dasharray,
                                           LinePatternCap patternCap) {
-    size_t key = patternCap == LinePatternCap::Round ? std::numeric_limits<size_t>::min()
-                                                     : std::numeric_limits<size_t>::max();
+    float length = 0;
     for (const float part : dasharray) {
-        boost::hash_combine<float>(key, part);
+        length += part;
+    }
+
+    // Round caps are as long as the line is wide, i.e. one unit of the pattern, so only the
+    // distance fields of square ones are the same at any scale.
+    Key key { patternCap, dasharray };
+    if (patternCap == LinePatternCap::Square && length > 0) {
+        for (float& part : key.dasharray) {
+            part /= length;
+        }
+    }
+
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        const uint16_t rows = patternCap == LinePatternCap::Round ? 15 : 1;
+        optional<uint16_t> row = allocateRows(rows);
+        if (!row && evictUnused(rows)) {
+            row = allocateRows(rows);
+        }
+        if (!row) {
+            Log::Warning(Event::OpenGL, "line atlas bitmap overflow");
+            return LinePatternPos();
+        }
+
+        const LinePatternPos position = addDash(key.dasharray, patternCap, *row);
+        it = entries.emplace(std::move(key), Entry { *row, rows, frame, position }).first;
+    }
+
+    it->second.lastUsed = frame;
+    LinePatternPos position = it->second.position;
+    position.width = length;
+    return position;
+}
+
+void LineAtlas::nextFrame() {
+    frame++;
+}
+
+optional<uint16_t> LineAtlas::allocateRows(uint16_t rows) {
+    for (auto it = freeRows.begin(); it != freeRows.end(); ++it) {
+        if (it->rows >= rows) {
+            const uint16_t row = it->row;
+            it->row += rows;
+            it->rows -= rows;
+            if (!it->rows) {
+                freeRows.erase(it);
+            }
+            return row;
+        }
+    }
+    return {};
+}
+
+void LineAtlas::releaseRows(uint16_t row, uint16_t rows) {
+    auto it = std::find_if(freeRows.begin(), freeRows.end(),
+                           [&](const Rows& free) { return free.row > row; });
+    it = freeRows.insert(it, Rows { row, rows });
+    if (it + 1 != freeRows.end() && it->row + it->rows == (it + 1)->row) {
+        it->rows += (it + 1)->rows;
+        freeRows.erase(it + 1);
+    }
+    if (it != freeRows.begin() && (it - 1)->row + (it - 1)->rows == it->row) {
+        (it - 1)->rows += it->rows;
+        freeRows.erase(it);
     }
+}
 
-    // Note: We're not handling hash collisions here.
-    const auto it = positions.find(key);
-    if (it == positions.end()) {
-        auto inserted = positions.emplace(key, addDash(dasharray, patternCap));
-        assert(inserted.second);
-        return inserted.first->second;
-    } else {
-        return it->second;
+bool LineAtlas::evictUnused(uint16_t rows) {
+    // The least recently used patterns go first, until there's a run of rows that fits.
+    std::vector<std::unordered_map<Key, Entry, KeyHash>::iterator> unused;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->second.lastUsed < frame) {
+            unused.push_back(it);
+        }
+    }
+    std::sort(unused.begin(), unused.end(), [](const auto& a, const auto& b) {
+        return a->second.lastUsed < b->second.lastUsed;
+    });
+
+    const auto fits = [&] {
+        return std::any_of(freeRows.begin(), freeRows.end(),
+                           [&](const Rows& free) { return free.rows >= rows; });
+    };
+
+    for (const auto& it : unused) {
+        if (fits()) {
+            break;
+        }
+        releaseRows(it->second.row, it->second.rows);
+        entries.erase(it);
     }
+    return fits();
 }
 
-LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatternCap patternCap) {
+LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatternCap patternCap,
+                                  uint16_t top) {
     int n = patternCap == LinePatternCap::Round ? 7 : 0;
     int dashheight = 2 * n + 1;
     const uint8_t offset = 128;
 
-    if (nextRow + dashheight > height) {
-        Log::Warning(Event::OpenGL, "line atlas bitmap overflow");
-        return LinePatternPos();
-    }
-
     float length = 0;
     for (const float part : dasharray) {
         length += part;
@@ -61,7 +146,7 @@ LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatte
     bool oddLength = dasharray.size() % 2 == 1;
 
     for (int y = -n; y <= n; y++) {
-        int row = nextRow + n + y;
+        int row = top + n + y;
         int index = width * row;
 
         float left = 0;
@@ -109,17 +194,26 @@ LinePatternPos LineAtlas::addDash(const std::vector<float>& dasharray, LinePatte
     }
 
     LinePatternPos position;
-    position.y = (0.5 + nextRow + n) / height;
+    position.y = (0.5 + top + n) / height;
     position.height = (2.0 * n) / height;
     position.width = length;
 
-    nextRow += dashheight;
+    dirtyRegions.add({ 0, top, width, uint16_t(dashheight) });
 
     dirty = true;
 
     return position;
 }
 
+MemoryUsage LineAtlas::getMemoryUsage() const {
+    const std::size_t atlasBytes = std::size_t(width) * height;
+
+    MemoryUsage usage;
+    usage.cpu = atlasBytes;
+    usage.gpu = texture ? atlasBytes : 0;
+    return usage;
+}
+
 void LineAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (dirty) {
         bind(context, unit);
@@ -157,20 +251,10 @@ void LineAtlas::bind(gl::Context& context, gl::TextureUnit unit) {
                 data.get() // const GLvoid * data
             ));
         } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width, // GLsizei width
-                height, // GLsizei height
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid *pixels
-            ));
+            dirtyRegions.upload(data.get(), width, 1, GL_ALPHA);
         }
 
-
+        dirtyRegions.clear();
         dirty = false;
     }
 }
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <mbgl/gl/object.hpp>
+#include <mbgl/gl/dirty_regions.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/memory_usage.hpp>
 
-#include <vector>
-#include <unordered_map>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
@@ -33,21 +36,66 @@ public:
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty), and only the dashes that
+    // were added since the last upload are written.
     void upload(gl::Context&, gl::TextureUnit unit);
 
+    // Patterns with square caps that only differ in scale share their rows, since their distance
+    // fields are the same; the returned width is that of the requested pattern.
     LinePatternPos getDashPosition(const std::vector<float>&, LinePatternCap);
-    LinePatternPos addDash(const std::vector<float>& dasharray, LinePatternCap);
+
+    // Called once per frame, before the patterns are requested: the rows of patterns that haven't
+    // been requested since the last call may be reused for new ones once the atlas is full.
+    void nextFrame();
+
+    // The number of patterns in the atlas, as opposed to the number requested.
+    std::size_t size() const { return entries.size(); }
+
+    // The memory held by the atlas and its texture.
+    MemoryUsage getMemoryUsage() const;
 
     const uint16_t width;
     const uint16_t height;
 
 private:
+    struct Key {
+        LinePatternCap cap;
+        std::vector<float> dasharray;
+
+        bool operator==(const Key& other) const {
+            return cap == other.cap && dasharray == other.dasharray;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct Entry {
+        uint16_t row;
+        uint16_t rows;
+        uint64_t lastUsed;
+        LinePatternPos position;
+    };
+
+    // A run of free rows.
+    struct Rows {
+        uint16_t row;
+        uint16_t rows;
+    };
+
+    optional<uint16_t> allocateRows(uint16_t rows);
+    void releaseRows(uint16_t row, uint16_t rows);
+    bool evictUnused(uint16_t rows);
+    LinePatternPos addDash(const std::vector<float>& dasharray, LinePatternCap, uint16_t row);
+
     const std::unique_ptr<char[]> data;
     bool dirty;
+    gl::DirtyRegions dirtyRegions;
     mbgl::optional<gl::UniqueTexture> texture;
-    int nextRow = 0;
-    std::unordered_map<size_t, LinePatternPos> positions;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::vector<Rows> freeRows;
+    uint64_t frame = 0;
 };
 
 } // namespace mbgl
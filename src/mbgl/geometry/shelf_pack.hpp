@@ -0,0 +1,148 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/rect.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace mbgl {
+
+// Packs rectangles into rows, or shelves, each as tall as the first rectangle put into it. Unlike
+// BinPack, released rectangles are always reclaimed: their room is merged back into the free spans
+// of their shelf, and a shelf that becomes empty is merged with its empty neighbours, so that the
+// room can be split again for rectangles of any height. Allocated rectangles never move.
+template <typename T>
+class ShelfPack : private util::noncopyable {
+public:
+    ShelfPack(T width_, T height_)
+        : width(width_),
+          shelves(1, Shelf { 0, height_, { Span { 0, width_ } }, 0 }) {}
+
+    // Returns an empty rectangle when there's no room left.
+    Rect<T> allocate(T w, T h) {
+        if (w == 0 || h == 0 || w > width) {
+            return Rect<T>{ 0, 0, 0, 0 };
+        }
+
+        // The shortest used shelf that is tall enough and has room, unless it would waste more
+        // than it holds; then an empty shelf is split for the rectangle instead, if there's one.
+        auto best = shelves.end();
+        for (auto it = shelves.begin(); it != shelves.end(); ++it) {
+            if (it->count && it->h >= h && (best == shelves.end() || it->h < best->h) &&
+                fits(*it, w)) {
+                best = it;
+            }
+        }
+
+        if (best == shelves.end() || best->h - h > h) {
+            for (auto it = shelves.begin(); it != shelves.end(); ++it) {
+                if (!it->count && it->h >= h) {
+                    if (it->h > h) {
+                        const Shelf rest { T(it->y + h), T(it->h - h), { Span { 0, width } }, 0 };
+                        it->h = h;
+                        it = shelves.insert(it + 1, rest) - 1;
+                    }
+                    best = it;
+                    break;
+                }
+            }
+        }
+
+        if (best == shelves.end()) {
+            return Rect<T>{ 0, 0, 0, 0 };
+        }
+
+        return take(*best, w, h);
+    }
+
+    // Releases a rectangle returned by allocate().
+    void release(const Rect<T>& rect) {
+        auto it = shelves.begin();
+        while (it != shelves.end() && it->y != rect.y) {
+            ++it;
+        }
+        if (it == shelves.end() || !it->count) {
+            return;
+        }
+
+        // Merge the room with the free spans next to it.
+        auto span = it->free.begin();
+        while (span != it->free.end() && span->x < rect.x) {
+            ++span;
+        }
+        span = it->free.insert(span, Span { rect.x, rect.w });
+        if (span + 1 != it->free.end() && span->x + span->w == (span + 1)->x) {
+            span->w += (span + 1)->w;
+            it->free.erase(span + 1);
+        }
+        if (span != it->free.begin() && (span - 1)->x + (span - 1)->w == span->x) {
+            (span - 1)->w += span->w;
+            span = it->free.erase(span);
+        }
+
+        if (--it->count) {
+            return;
+        }
+
+        // Compact an empty shelf with its empty neighbours, so that they can be split anew.
+        if (it + 1 != shelves.end() && !(it + 1)->count) {
+            it->h += (it + 1)->h;
+            shelves.erase(it + 1);
+        }
+        if (it != shelves.begin() && !(it - 1)->count) {
+            (it - 1)->h += it->h;
+            shelves.erase(it);
+        }
+    }
+
+    // The number of shelves, including the empty ones.
+    std::size_t shelfCount() const {
+        return shelves.size();
+    }
+
+private:
+    struct Span {
+        T x;
+        T w;
+    };
+
+    struct Shelf {
+        T y;
+        T h;
+        std::vector<Span> free;
+        std::size_t count;
+    };
+
+    bool fits(const Shelf& shelf, T w) const {
+        for (const auto& span : shelf.free) {
+            if (span.w >= w) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Rect<T> take(Shelf& shelf, T w, T h) {
+        for (auto span = shelf.free.begin(); span != shelf.free.end(); ++span) {
+            if (span->w >= w) {
+                const Rect<T> rect { span->x, shelf.y, w, h };
+                span->x += w;
+                span->w -= w;
+                if (span->w == 0) {
+                    shelf.free.erase(span);
+                }
+                ++shelf.count;
+                return rect;
+            }
+        }
+        return Rect<T>{ 0, 0, 0, 0 };
+    }
+
+    const T width;
+
+    // Ordered from top to bottom, covering the whole height.
+    std::vector<Shelf> shelves;
+};
+
+} // namespace mbgl
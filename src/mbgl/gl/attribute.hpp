@@ -46,5 +46,17 @@ public:
 
 template <class Shader, class Vertex> struct AttributeBindings;
 
+// The combined size of the given attributes of a vertex type. Vertex types assert that it matches
+// their size, so that none of their bytes are padding that is uploaded along with them.
+template <class Vertex>
+constexpr std::size_t attributeSize() {
+    return 0;
+}
+
+template <class Vertex, class T, std::size_t N, class... Rest>
+constexpr std::size_t attributeSize(const T (Vertex::*)[N], Rest... rest) {
+    return sizeof(T) * N + attributeSize<Vertex>(rest...);
+}
+
 } // namespace gl
 } // namespace mbgl
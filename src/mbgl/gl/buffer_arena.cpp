@@ -0,0 +1,140 @@
+#include <mbgl/gl/buffer_arena.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace mbgl {
+namespace gl {
+
+BufferRange::BufferRange(BufferArena& arena_, BufferID buffer_, std::size_t offset_, std::size_t size_)
+    : arena(&arena_), buffer(buffer_), offset(offset_), size(size_) {
+}
+
+BufferRange::BufferRange(BufferRange&& other)
+    : arena(other.arena), buffer(other.buffer), offset(other.offset), size(other.size) {
+    other.arena = nullptr;
+}
+
+BufferRange& BufferRange::operator=(BufferRange&& other) {
+    if (this != &other) {
+        release();
+        arena = other.arena;
+        buffer = other.buffer;
+        offset = other.offset;
+        size = other.size;
+        other.arena = nullptr;
+    }
+    return *this;
+}
+
+BufferRange::~BufferRange() {
+    release();
+}
+
+void BufferRange::release() {
+    if (arena) {
+        arena->release(buffer, offset, size);
+        arena = nullptr;
+    }
+}
+
+BufferArena::BufferArena(Context& context_, BufferType type_, std::size_t bufferSize_)
+    : context(context_), type(type_), bufferSize(bufferSize_) {
+}
+
+BufferArena::~BufferArena() = default;
+
+void BufferArena::bind(BufferID id) {
+    if (type == BufferType::Vertex) {
+        context.vertexBuffer = id;
+    } else {
+        // The element buffer binding is part of the vertex array object that's bound.
+        context.vertexArrayObject = 0;
+        context.elementBuffer = id;
+    }
+}
+
+BufferRange BufferArena::upload(const void* data, std::size_t size) {
+    // Keep every range aligned, so that it can hold any vertex or index type.
+    const std::size_t alignedSize = std::max<std::size_t>((size + 3) & ~std::size_t(3), 4);
+
+    for (auto& buffer : buffers) {
+        if (buffer->size - buffer->used < alignedSize) {
+            continue;
+        }
+
+        // First fit.
+        for (auto it = buffer->free.begin(); it != buffer->free.end(); ++it) {
+            if (it->second < alignedSize) {
+                continue;
+            }
+
+            const std::size_t offset = it->first;
+            const std::size_t remaining = it->second - alignedSize;
+            buffer->free.erase(it);
+            if (remaining) {
+                buffer->free.emplace(offset + alignedSize, remaining);
+            }
+            buffer->used += alignedSize;
+
+            bind(buffer->buffer);
+            MBGL_CHECK_ERROR(glBufferSubData(static_cast<GLenum>(type), offset, size, data));
+            return { *this, buffer->buffer, offset, alignedSize };
+        }
+    }
+
+    auto buffer = std::make_unique<Buffer>(Buffer {
+        context.createBuffer(), std::max(alignedSize, bufferSize), alignedSize, {}
+    });
+    if (buffer->size > alignedSize) {
+        buffer->free.emplace(alignedSize, buffer->size - alignedSize);
+    }
+
+    bind(buffer->buffer);
+    MBGL_CHECK_ERROR(glBufferData(static_cast<GLenum>(type), buffer->size, nullptr, GL_STATIC_DRAW));
+    MBGL_CHECK_ERROR(glBufferSubData(static_cast<GLenum>(type), 0, size, data));
+
+    BufferRange range { *this, buffer->buffer, 0, alignedSize };
+    buffers.push_back(std::move(buffer));
+    return range;
+}
+
+void BufferArena::release(BufferID id, std::size_t offset, std::size_t size) {
+    auto it = std::find_if(buffers.begin(), buffers.end(), [&] (const auto& buffer) {
+        return buffer->buffer.get() == id;
+    });
+    assert(it != buffers.end());
+    Buffer& buffer = **it;
+
+    buffer.used -= size;
+
+    // Merge with the free ranges on either side.
+    auto next = buffer.free.lower_bound(offset);
+    if (next != buffer.free.end() && next->first == offset + size) {
+        size += next->second;
+        next = buffer.free.erase(next);
+    }
+    if (next != buffer.free.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            buffer.free.erase(previous);
+        }
+    }
+    buffer.free.emplace(offset, size);
+
+    if (buffer.used == 0) {
+        const bool otherEmptyBuffer = std::any_of(buffers.begin(), buffers.end(), [&] (const auto& other) {
+            return other.get() != &buffer && other->used == 0;
+        });
+        if (otherEmptyBuffer || buffer.size > bufferSize) {
+            buffers.erase(it);
+        }
+    }
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+class BufferArena;
+
+// A range of one of the buffer objects of a BufferArena, which it's returned to when destroyed.
+class BufferRange : private util::noncopyable {
+public:
+    BufferRange() = default;
+    BufferRange(BufferArena&, BufferID, std::size_t offset, std::size_t size);
+    BufferRange(BufferRange&&);
+    BufferRange& operator=(BufferRange&&);
+    ~BufferRange();
+
+    BufferID getID() const {
+        return buffer;
+    }
+
+    // The byte offset of the range in the buffer object.
+    std::size_t getOffset() const {
+        return offset;
+    }
+
+    std::size_t getSize() const {
+        return size;
+    }
+
+private:
+    void release();
+
+    BufferArena* arena = nullptr;
+    BufferID buffer = 0;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+};
+
+/*
+    A `BufferArena` suballocates the vertex or index data of many buckets from a few large buffer
+    objects, rather than creating one buffer object per bucket and deleting it again when the
+    bucket's tile goes away.
+
+    Released ranges are merged with free neighbours and reused for later uploads. A buffer object
+    is only deleted once none of it is in use anymore, and one empty buffer object is kept for
+    the next uploads. Data that's bigger than a buffer object gets one of its own.
+
+    Like the rest of `Context`, it must only be used on the thread that renders.
+*/
+class BufferArena : private util::noncopyable {
+public:
+    BufferArena(Context&, BufferType, std::size_t bufferSize = 1024 * 1024);
+    ~BufferArena();
+
+    BufferRange upload(const void* data, std::size_t size);
+
+    std::size_t bufferCount() const {
+        return buffers.size();
+    }
+
+private:
+    friend class BufferRange;
+
+    struct Buffer {
+        UniqueBuffer buffer;
+        std::size_t size;
+        std::size_t used;
+
+        // Free ranges by offset.
+        std::map<std::size_t, std::size_t> free;
+    };
+
+    void release(BufferID, std::size_t offset, std::size_t size);
+    void bind(BufferID);
+
+    Context& context;
+    const BufferType type;
+    const std::size_t bufferSize;
+
+    std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -1,7 +1,12 @@
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/timer_query.hpp>
 #include <mbgl/gl/vertex_array.hpp>
 #include <mbgl/util/traits.hpp>
+#include <mbgl/util/ktx.hpp>
+
+#include <algorithm>
+#include <cassert>
 
 namespace mbgl {
 namespace gl {
@@ -13,6 +18,7 @@ static_assert(std::is_same<TextureID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<VertexArrayID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<FramebufferID, GLuint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<RenderbufferID, GLuint>::value, "OpenGL type mismatch");
+static_assert(std::is_same<QueryID, GLuint>::value, "OpenGL type mismatch");
 
 static_assert(std::is_same<StencilValue, GLint>::value, "OpenGL type mismatch");
 static_assert(std::is_same<StencilMaskValue, GLuint>::value, "OpenGL type mismatch");
@@ -75,7 +81,18 @@ static_assert(underlying_type(BlendDestinationFactor::OneMinusConstantColor) ==
 static_assert(underlying_type(BlendDestinationFactor::ConstantAlpha) == GL_CONSTANT_ALPHA, "OpenGL enum mismatch");
 static_assert(underlying_type(BlendDestinationFactor::OneMinusConstantAlpha) == GL_ONE_MINUS_CONSTANT_ALPHA, "OpenGL enum mismatch");
 
+Context::Context()
+    : vertexBufferArena(std::make_unique<BufferArena>(*this, BufferType::Vertex)),
+      indexBufferArena(std::make_unique<BufferArena>(*this, BufferType::Element)),
+      vertexArrays(std::make_unique<VertexArrayCache>(*this)) {
+}
+
 Context::~Context() {
+    // Abandon the arenas' buffer objects and the cached vertex array objects before they're
+    // deleted along with everything else.
+    vertexArrays.reset();
+    vertexBufferArena.reset();
+    indexBufferArena.reset();
     reset();
 }
 
@@ -91,22 +108,23 @@ UniqueShader Context::createFragmentShader() {
     return UniqueShader{ MBGL_CHECK_ERROR(glCreateShader(GL_FRAGMENT_SHADER)), { this } };
 }
 
-UniqueBuffer Context::createVertexBuffer(const void* data, std::size_t size) {
+UniqueBuffer Context::createBuffer() {
     BufferID id = 0;
     MBGL_CHECK_ERROR(glGenBuffers(1, &id));
-    UniqueBuffer result { std::move(id), { this } };
-    vertexBuffer = result;
-    MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
-    return result;
+    return UniqueBuffer{ std::move(id), { this } };
 }
 
-UniqueBuffer Context::createIndexBuffer(const void* data, std::size_t size) {
-    BufferID id = 0;
-    MBGL_CHECK_ERROR(glGenBuffers(1, &id));
-    UniqueBuffer result { std::move(id), { this } };
-    elementBuffer = result;
-    MBGL_CHECK_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
-    return result;
+BufferRange Context::createVertexBuffer(const void* data, std::size_t size) {
+    return vertexBufferArena->upload(data, size);
+}
+
+BufferRange Context::createIndexBuffer(const void* data, std::size_t size) {
+    return indexBufferArena->upload(data, size);
+}
+
+void Context::updateVertexBuffer(const BufferRange& range, std::size_t offset, const void* data, std::size_t size) {
+    vertexBuffer = range.getID();
+    MBGL_CHECK_ERROR(glBufferSubData(GL_ARRAY_BUFFER, range.getOffset() + offset, size, data));
 }
 
 void Context::bindAttribute(const AttributeBinding& binding, std::size_t stride, const int8_t* offset) {
@@ -119,6 +137,10 @@ void Context::bindAttribute(const AttributeBinding& binding, std::size_t stride,
                                            offset + binding.offset));
 }
 
+void Context::unbindAttribute(const AttributeBinding& binding) {
+    MBGL_CHECK_ERROR(glDisableVertexAttribArray(binding.location));
+}
+
 UniqueTexture Context::createTexture() {
     if (pooledTextures.empty()) {
         pooledTextures.resize(TextureMax);
@@ -142,8 +164,47 @@ UniqueFramebuffer Context::createFramebuffer() {
     return UniqueFramebuffer{ std::move(id), { this } };
 }
 
+UniqueRenderbuffer Context::createRenderbuffer(RenderbufferType type,
+                                               const std::array<uint16_t, 2>& size) {
+    RenderbufferID id = 0;
+    MBGL_CHECK_ERROR(glGenRenderbuffers(1, &id));
+    MBGL_CHECK_ERROR(glBindRenderbuffer(GL_RENDERBUFFER, id));
+    MBGL_CHECK_ERROR(
+        glRenderbufferStorage(GL_RENDERBUFFER, static_cast<GLenum>(type), size[0], size[1]));
+    MBGL_CHECK_ERROR(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    return UniqueRenderbuffer{ std::move(id), { this } };
+}
+
+UniqueQuery Context::createQuery() {
+    QueryID id = 0;
+    MBGL_CHECK_ERROR(gl::GenQueries(1, &id));
+    return UniqueQuery{ std::move(id), { this } };
+}
+
 UniqueTexture
 Context::createTexture(uint16_t width, uint16_t height, const void* data, TextureUnit unit) {
+    const std::array<uint16_t, 2> size {{ width, height }};
+    const auto pooled = std::find_if(pooledImageTextures.begin(), pooledImageTextures.end(),
+                                     [&](const auto& entry) { return entry.first == size; });
+
+    if (pooled != pooledImageTextures.end()) {
+        // Upload into the storage of a released texture of the same size, instead of having the
+        // driver allocate another.
+        UniqueTexture obj { std::move(pooled->second), { this } };
+        *pooled = pooledImageTextures.back();
+        pooledImageTextures.pop_back();
+
+        activeTexture = unit;
+        texture[unit] = obj;
+        MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        if (data) {
+            MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA,
+                                             GL_UNSIGNED_BYTE, data));
+        }
+        return obj;
+    }
+
     auto obj = createTexture();
     activeTexture = unit;
     texture[unit] = obj;
@@ -153,9 +214,53 @@ Context::createTexture(uint16_t width, uint16_t height, const void* data, Textur
     MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
     MBGL_CHECK_ERROR(
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+    imageTextureSizes[obj.get()] = size;
     return obj;
 }
 
+void Context::generateMipmaps(Texture& obj, TextureUnit unit) {
+    const auto powerOfTwo = [](uint16_t n) { return n && !(n & (n - 1)); };
+    if (!GenerateMipmap || !powerOfTwo(obj.size[0]) || !powerOfTwo(obj.size[1])) {
+        return;
+    }
+
+    activeTexture = unit;
+    texture[unit] = obj.texture;
+#if not MBGL_USE_GLES2
+    // Textures whose name was used by the atlases before may have been limited to the base level.
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000));
+#endif
+    MBGL_CHECK_ERROR(GenerateMipmap(GL_TEXTURE_2D));
+    obj.mipmaps = true;
+}
+
+bool Context::compressedTextureFormatSupported(uint32_t format) {
+    if (!compressedTextureFormats) {
+        GLint count = 0;
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+        compressedTextureFormats.emplace(count);
+        if (count > 0) {
+            MBGL_CHECK_ERROR(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, compressedTextureFormats->data()));
+        }
+    }
+    return std::find(compressedTextureFormats->begin(), compressedTextureFormats->end(),
+                     static_cast<int32_t>(format)) != compressedTextureFormats->end();
+}
+
+Texture Context::createTexture(const CompressedImage& image, TextureUnit unit) {
+    assert(compressedTextureFormatSupported(image.format));
+    auto obj = createTexture();
+    activeTexture = unit;
+    texture[unit] = obj;
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    MBGL_CHECK_ERROR(glCompressedTexImage2D(GL_TEXTURE_2D, 0, image.format, image.width, image.height, 0,
+                                            static_cast<GLsizei>(image.size()), image.data.data()));
+    return { {{ image.width, image.height }}, std::move(obj) };
+}
+
 void Context::bindTexture(Texture& obj,
                           TextureUnit unit,
                           TextureFilter filter,
@@ -183,6 +288,11 @@ void Context::bindTexture(Texture& obj,
 void Context::reset() {
     std::copy(pooledTextures.begin(), pooledTextures.end(), std::back_inserter(abandonedTextures));
     pooledTextures.resize(0);
+    for (const auto& entry : pooledImageTextures) {
+        imageTextureSizes.erase(entry.second);
+        abandonedTextures.push_back(entry.second);
+    }
+    pooledImageTextures.clear();
     performCleanup();
 }
 
@@ -232,7 +342,30 @@ void Context::setDirtyState() {
     applyStateFunction(*this, [](auto& state) { state.setDirty(); });
 }
 
+Context::Statistics Context::takeStatistics() {
+    Statistics current;
+    current.programSwitches = program.getChangeCount();
+    for (const auto& tex : texture) {
+        current.textureBinds += tex.getChangeCount();
+    }
+    applyStateFunction(*this, [&](const auto& state) { current.stateChanges += state.getChangeCount(); });
+
+    Statistics result;
+    result.programSwitches = current.programSwitches - totals.programSwitches;
+    result.textureBinds = current.textureBinds - totals.textureBinds;
+    result.stateChanges = current.stateChanges - totals.stateChanges;
+    totals = current;
+    return result;
+}
+
 void Context::performCleanup() {
+    // Drop the vertex array objects that refer to the objects about to be deleted, since their
+    // names may be reused. This abandons them in turn, so they're deleted further down.
+    if (vertexArrays) {
+        vertexArrays->abandonPrograms(abandonedPrograms);
+        vertexArrays->abandonBuffers(abandonedBuffers);
+    }
+
     for (auto id : abandonedPrograms) {
         if (program == id) {
             program.setDirty();
@@ -289,6 +422,17 @@ void Context::performCleanup() {
             glDeleteFramebuffers(int(abandonedFramebuffers.size()), abandonedFramebuffers.data()));
         abandonedFramebuffers.clear();
     }
+
+    if (!abandonedRenderbuffers.empty()) {
+        MBGL_CHECK_ERROR(glDeleteRenderbuffers(int(abandonedRenderbuffers.size()),
+                                               abandonedRenderbuffers.data()));
+        abandonedRenderbuffers.clear();
+    }
+
+    if (!abandonedQueries.empty()) {
+        MBGL_CHECK_ERROR(gl::DeleteQueries(int(abandonedQueries.size()), abandonedQueries.data()));
+        abandonedQueries.clear();
+    }
 }
 
 } // namespace gl
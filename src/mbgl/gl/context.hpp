@@ -7,48 +7,97 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
+#include <mbgl/gl/vertex_array_cache.hpp>
+#include <mbgl/gl/instancing.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
 
+#include <cassert>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <array>
 
 namespace mbgl {
+
+class CompressedImage;
+
 namespace gl {
 
 constexpr size_t TextureMax = 64;
 
+// The number of released RGBA textures that are kept with their storage, for new images of the
+// same size.
+constexpr size_t ImageTextureMax = 16;
+
 class Context : private util::noncopyable {
 public:
+    Context();
     ~Context();
 
     UniqueProgram createProgram();
+    UniqueBuffer createBuffer();
     UniqueShader createVertexShader();
     UniqueShader createFragmentShader();
     UniqueTexture createTexture();
     UniqueVertexArray createVertexArray();
     UniqueFramebuffer createFramebuffer();
+    UniqueRenderbuffer createRenderbuffer(RenderbufferType, const std::array<uint16_t, 2>& size);
+    // Only with timer queries; see timerQuerySupported().
+    UniqueQuery createQuery();
 
+    // These take ownership of the CPU-side data, and free it as soon as it has been uploaded;
+    // moving a vector into an rvalue reference parameter alone would leave it with its caller.
+    // The data is uploaded to a range of one of the shared buffer objects of a BufferArena.
     template <class V>
     VertexBuffer<V> createVertexBuffer(std::vector<V>&& v) {
+        const std::vector<V> vertices = std::move(v);
         return VertexBuffer<V> {
-            v.size(),
-            createVertexBuffer(v.data(), v.size() * sizeof(V))
+            vertices.size(),
+            createVertexBuffer(vertices.data(), vertices.size() * sizeof(V))
         };
     }
 
     template <class P>
     IndexBuffer<P> createIndexBuffer(std::vector<P>&& v) {
+        const std::vector<P> primitives = std::move(v);
+        return IndexBuffer<P> {
+            createIndexBuffer(primitives.data(), primitives.size() * sizeof(P))
+        };
+    }
+
+    // The indices address the whole vertex buffer; see IndexBuffer::uintIndices.
+    template <class P>
+    IndexBuffer<P> createUintIndexBuffer(std::vector<uint32_t>&& v) {
+        const std::vector<uint32_t> indices = std::move(v);
         return IndexBuffer<P> {
-            createIndexBuffer(v.data(), v.size() * sizeof(P))
+            createIndexBuffer(indices.data(), indices.size() * sizeof(uint32_t)),
+            true
         };
     }
 
-    // Create a texture from an image with data.
+    // Replaces the vertices of a buffer from `first` on in place, e.g. ones that moved, instead of
+    // uploading all of them to a new buffer.
+    template <class V>
+    void updateVertexBuffer(VertexBuffer<V>& buffer, std::size_t first, const std::vector<V>& v) {
+        assert(first + v.size() <= buffer.vertexCount);
+        updateVertexBuffer(buffer.buffer, first * sizeof(V), v.data(), v.size() * sizeof(V));
+    }
+
+    // Create a texture from an image with data. The storage of a released texture of the same
+    // size is reused where there is one. Mipmaps are generated if asked for and supported; see
+    // Texture::mipmaps.
     template <typename Image>
-    Texture createTexture(const Image& image, TextureUnit unit = 0) {
-        return { {{ image.width, image.height }},
-                 createTexture(image.width, image.height, image.data.get(), unit) };
+    Texture createTexture(const Image& image, TextureUnit unit = 0,
+                          TextureMipMap mipmap = TextureMipMap::No) {
+        Texture result { {{ image.width, image.height }},
+                         createTexture(image.width, image.height, image.data.get(), unit) };
+        if (mipmap == TextureMipMap::Yes) {
+            generateMipmaps(result, unit);
+        }
+        return result;
     }
 
     // Creates an empty texture with the specified dimensions.
@@ -56,16 +105,78 @@ public:
         return { size, createTexture(size[0], size[1], nullptr, unit) };
     }
 
+    // Generates the levels below the base one from its current contents, where GenerateMipmap is
+    // available and the sides are powers of two, as OpenGL ES 2 requires; sets Texture::mipmaps.
+    void generateMipmaps(Texture&, TextureUnit unit = 0);
+
+    // Whether the driver can sample textures with this compressed internal format.
+    bool compressedTextureFormatSupported(uint32_t format);
+
+    // Creates a texture from a compressed image of a format that the driver supports.
+    Texture createTexture(const CompressedImage&, TextureUnit unit = 0);
+
     void bindTexture(Texture&,
                      TextureUnit = 0,
                      TextureFilter = TextureFilter::Nearest,
                      TextureMipMap = TextureMipMap::No);
 
     template <class Shader, class Vertex>
-    void bindAttributes(const Shader& shader, const VertexBuffer<Vertex>&, const int8_t* offset) {
+    void bindAttributes(const Shader& shader, const VertexBuffer<Vertex>& buffer, const int8_t* offset) {
         static_assert(std::is_same<typename Shader::VertexType, Vertex>::value, "vertex type mismatch");
         for (const auto& binding : AttributeBindings<Shader, Vertex>()(shader)) {
-            bindAttribute(binding, sizeof(Vertex), offset);
+            bindAttribute(binding, sizeof(Vertex), offset + buffer.buffer.getOffset());
+        }
+    }
+
+    // Binds a vertex array object that sources the shader's attributes from the vertex buffer,
+    // starting at `offset` bytes into it, creating it if the cache doesn't have one yet.
+    template <class Shader, class Vertex>
+    void bindVertexArray(const Shader& shader, const VertexBuffer<Vertex>& buffer, const int8_t* offset) {
+        bindVertexArray(shader, buffer, 0, offset);
+    }
+
+    template <class Shader, class Vertex, class Primitive>
+    void bindVertexArray(const Shader& shader,
+                         const VertexBuffer<Vertex>& buffer,
+                         const IndexBuffer<Primitive>& indexBuffer,
+                         const int8_t* offset) {
+        bindVertexArray(shader, buffer, indexBuffer.buffer.getID(), offset);
+    }
+
+    // Binds the attributes of a vertex buffer that holds one element per instance of an instanced
+    // draw call rather than one per vertex. Requires instancedArraysSupported(). Without a vertex
+    // array object, the divisors are global state that has to be reset after drawing.
+    template <class Shader, class Vertex>
+    void bindInstanceAttributes(const Shader& shader, const VertexBuffer<Vertex>& buffer, const int8_t* offset) {
+        for (const auto& binding : AttributeBindings<Shader, Vertex>()(shader)) {
+            bindAttribute(binding, sizeof(Vertex), offset + buffer.buffer.getOffset());
+            MBGL_CHECK_ERROR(VertexAttribDivisor(binding.location, 1));
+        }
+    }
+
+    template <class Shader, class Vertex>
+    void unbindInstanceAttributes(const Shader& shader, const VertexBuffer<Vertex>&) {
+        for (const auto& binding : AttributeBindings<Shader, Vertex>()(shader)) {
+            MBGL_CHECK_ERROR(VertexAttribDivisor(binding.location, 0));
+        }
+    }
+
+    // Binds the attributes of a vertex buffer that holds more attributes of the same vertices as
+    // a buffer of the shader's VertexType, e.g. their data-driven colors. Vertex array objects
+    // only record the binding of a single vertex buffer, so these are for drawing with the
+    // default vertex array, where the attributes have to be unbound again after drawing.
+    template <class Shader, class Vertex>
+    void bindExtraAttributes(const Shader& shader, const VertexBuffer<Vertex>& buffer, const int8_t* offset) {
+        vertexBuffer = buffer.buffer.getID();
+        for (const auto& binding : AttributeBindings<Shader, Vertex>()(shader)) {
+            bindAttribute(binding, sizeof(Vertex), offset + buffer.buffer.getOffset());
+        }
+    }
+
+    template <class Shader, class Vertex>
+    void unbindExtraAttributes(const Shader& shader, const VertexBuffer<Vertex>&) {
+        for (const auto& binding : AttributeBindings<Shader, Vertex>()(shader)) {
+            unbindAttribute(binding);
         }
     }
 
@@ -79,18 +190,41 @@ public:
 
     bool empty() const {
         return pooledTextures.empty()
+            && pooledImageTextures.empty()
             && abandonedPrograms.empty()
             && abandonedShaders.empty()
             && abandonedBuffers.empty()
             && abandonedTextures.empty()
             && abandonedVertexArrays.empty()
-            && abandonedFramebuffers.empty();
+            && abandonedFramebuffers.empty()
+            && abandonedRenderbuffers.empty()
+            && abandonedQueries.empty();
+    }
+
+    // Where Shader caches the binaries of linked programs: each in a file named by appending the
+    // program's name to this path. Empty, the default, disables the cache.
+    void setProgramCachePath(const std::string& path) {
+        programCachePath = path;
+    }
+
+    const std::string& getProgramCachePath() const {
+        return programCachePath;
     }
 
     void resetState();
 
     void setDirtyState();
 
+    // The number of state changes, i.e. of actual OpenGL calls, made through the State members.
+    struct Statistics {
+        std::size_t programSwitches = 0;
+        std::size_t textureBinds = 0;
+        std::size_t stateChanges = 0;
+    };
+
+    // The changes made since the last call, e.g. during the last frame.
+    Statistics takeStatistics();
+
     State<value::StencilFunc> stencilFunc;
     State<value::StencilMask> stencilMask;
     State<value::StencilTest> stencilTest;
@@ -121,10 +255,29 @@ public:
     State<value::BindVertexArray> vertexArrayObject;
 
 private:
-    UniqueBuffer createVertexBuffer(const void* data, std::size_t size);
-    UniqueBuffer createIndexBuffer(const void* data, std::size_t size);
+    BufferRange createVertexBuffer(const void* data, std::size_t size);
+    BufferRange createIndexBuffer(const void* data, std::size_t size);
+    void updateVertexBuffer(const BufferRange&, std::size_t offset, const void* data, std::size_t size);
     UniqueTexture createTexture(uint16_t width, uint16_t height, const void* data, TextureUnit);
     void bindAttribute(const AttributeBinding&, std::size_t stride, const int8_t* offset);
+    void unbindAttribute(const AttributeBinding&);
+
+    template <class Shader, class Vertex>
+    void bindVertexArray(const Shader& shader,
+                         const VertexBuffer<Vertex>& buffer,
+                         BufferID elements,
+                         const int8_t* offset) {
+        const VertexArrayKey key { shader.getID(), buffer.buffer.getID(), elements,
+                                   buffer.buffer.getOffset() + reinterpret_cast<std::size_t>(offset),
+                                   sizeof(Vertex) };
+        if (!vertexArrays->bind(key)) {
+            vertexBuffer = buffer.buffer.getID();
+            if (elements) {
+                elementBuffer = elements;
+            }
+            bindAttributes(shader, buffer, offset);
+        }
+    }
 
     friend detail::ProgramDeleter;
     friend detail::ShaderDeleter;
@@ -132,15 +285,36 @@ private:
     friend detail::TextureDeleter;
     friend detail::VertexArrayDeleter;
     friend detail::FramebufferDeleter;
+    friend detail::RenderbufferDeleter;
+    friend detail::QueryDeleter;
 
     std::vector<TextureID> pooledTextures;
 
+    // The sizes of the RGBA storage of the textures made by createTexture(width, height, ...), and
+    // those of them that have been released, to be reused by the next image of their size.
+    std::unordered_map<TextureID, std::array<uint16_t, 2>> imageTextureSizes;
+    std::vector<std::pair<std::array<uint16_t, 2>, TextureID>> pooledImageTextures;
+
     std::vector<ProgramID> abandonedPrograms;
     std::vector<ShaderID> abandonedShaders;
     std::vector<BufferID> abandonedBuffers;
     std::vector<TextureID> abandonedTextures;
     std::vector<VertexArrayID> abandonedVertexArrays;
     std::vector<FramebufferID> abandonedFramebuffers;
+    std::vector<RenderbufferID> abandonedRenderbuffers;
+    std::vector<QueryID> abandonedQueries;
+
+    Statistics totals;
+
+    std::string programCachePath;
+
+    // The compressed texture formats of the driver, once they've been asked for.
+    optional<std::vector<int32_t>> compressedTextureFormats;
+
+    // Destroyed first in ~Context(), so that the objects they abandon are still deleted.
+    std::unique_ptr<BufferArena> vertexBufferArena;
+    std::unique_ptr<BufferArena> indexBufferArena;
+    std::unique_ptr<VertexArrayCache> vertexArrays;
 };
 
 } // namespace gl
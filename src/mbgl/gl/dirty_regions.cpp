@@ -0,0 +1,100 @@
+#include <mbgl/gl/dirty_regions.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace mbgl {
+namespace gl {
+
+const constexpr std::size_t DirtyRegions::MaxRegions;
+
+namespace {
+
+bool contains(const Rect<uint16_t>& outer, const Rect<uint16_t>& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+Rect<uint16_t> bounds(const Rect<uint16_t>& a, const Rect<uint16_t>& b) {
+    const uint16_t left = std::min(a.x, b.x);
+    const uint16_t top = std::min(a.y, b.y);
+    const uint16_t right = std::max(a.x + a.w, b.x + b.w);
+    const uint16_t bottom = std::max(a.y + a.h, b.y + b.h);
+    return { left, top, uint16_t(right - left), uint16_t(bottom - top) };
+}
+
+} // namespace
+
+void DirtyRegions::add(const Rect<uint16_t>& region) {
+    if (!region.hasArea()) {
+        return;
+    }
+
+    for (const auto& existing : regions) {
+        if (contains(existing, region)) {
+            return;
+        }
+    }
+
+    regions.erase(std::remove_if(regions.begin(), regions.end(), [&] (const Rect<uint16_t>& existing) {
+        return contains(region, existing);
+    }), regions.end());
+
+    if (regions.size() < MaxRegions) {
+        regions.push_back(region);
+        return;
+    }
+
+    Rect<uint16_t> merged = region;
+    for (const auto& existing : regions) {
+        merged = bounds(merged, existing);
+    }
+    regions = { merged };
+}
+
+std::size_t DirtyRegions::area() const {
+    std::size_t result = 0;
+    for (const auto& region : regions) {
+        result += std::size_t(region.w) * region.h;
+    }
+    return result;
+}
+
+void DirtyRegions::upload(const void* data, uint16_t width, std::size_t pixelSize, uint32_t format) {
+    const auto source = reinterpret_cast<const uint8_t*>(data);
+    const std::size_t sourceStride = width * pixelSize;
+
+    for (const auto& region : regions) {
+        const uint8_t* pixels = source + region.y * sourceStride + region.x * pixelSize;
+
+        // Rows are unpacked at the default alignment of 4 bytes.
+        const std::size_t rowLength = region.w * pixelSize;
+        const std::size_t stride = (rowLength + 3) & ~std::size_t(3);
+        if (region.w != width || stride != sourceStride) {
+            staging.resize(stride * region.h);
+            for (uint16_t y = 0; y < region.h; ++y) {
+                std::memcpy(staging.data() + y * stride, pixels + y * sourceStride, rowLength);
+            }
+            pixels = staging.data();
+        }
+
+        MBGL_CHECK_ERROR(glTexSubImage2D(
+            GL_TEXTURE_2D, // GLenum target
+            0, // GLint level
+            region.x, // GLint xoffset
+            region.y, // GLint yoffset
+            region.w, // GLsizei width
+            region.h, // GLsizei height
+            format, // GLenum format
+            GL_UNSIGNED_BYTE, // GLenum type
+            pixels // const GLvoid* pixels
+        ));
+    }
+
+    regions.clear();
+}
+
+} // namespace gl
+} // namespace mbgl
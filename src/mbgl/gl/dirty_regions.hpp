@@ -0,0 +1,39 @@
+#pragma once
+
+#include <mbgl/util/rect.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+// The rectangles of a texture's data that changed since it was last uploaded, so that uploading
+// only writes those instead of the whole texture.
+class DirtyRegions {
+public:
+    // Beyond this many regions, they're merged into their bounding box.
+    static constexpr std::size_t MaxRegions = 16;
+
+    void add(const Rect<uint16_t>&);
+    bool empty() const { return regions.empty(); }
+    void clear() { regions.clear(); }
+
+    const std::vector<Rect<uint16_t>>& getRegions() const { return regions; }
+
+    // The number of pixels that upload() writes.
+    std::size_t area() const;
+
+    // Uploads the regions of the data, which is `width` pixels wide, into the texture that's bound
+    // to the active unit, and clears them. Regions that aren't as wide as the data are copied into
+    // contiguous memory first, because GLES 2 can't unpack a rectangle of a larger image.
+    void upload(const void* data, uint16_t width, std::size_t pixelSize, uint32_t format);
+
+private:
+    std::vector<Rect<uint16_t>> regions;
+    std::vector<uint8_t> staging;
+};
+
+} // namespace gl
+} // namespace mbgl
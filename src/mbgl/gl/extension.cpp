@@ -23,9 +23,17 @@ ExtensionFunctionBase::ExtensionFunctionBase(std::initializer_list<Probe> probes
 } // namespace detail
 
 static std::once_flag initializeExtensionsOnce;
+static bool elementIndexUint = false;
 
 void InitializeExtensions(glProc (*getProcAddress)(const char*)) {
     std::call_once(initializeExtensionsOnce, [getProcAddress] {
+        const char* versionPtr =
+            reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(GL_VERSION)));
+        const std::string version = versionPtr ? versionPtr : "";
+        if (version.find("OpenGL ES 3") == 0) {
+            elementIndexUint = true;
+        }
+
         const char* extensionsPtr =
             reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(GL_EXTENSIONS)));
 
@@ -33,9 +41,15 @@ void InitializeExtensions(glProc (*getProcAddress)(const char*)) {
             return;
 
         const std::string extensions = extensionsPtr;
+        if (extensions.find("OES_element_index_uint") != std::string::npos) {
+            elementIndexUint = true;
+        }
+
         for (auto fn : detail::extensionFunctions()) {
             for (auto probe : fn.second) {
-                if (extensions.find(probe.first) != std::string::npos) {
+                // A probe may also name a version prefix, for functions that became core there.
+                if (extensions.find(probe.first) != std::string::npos ||
+                    version.find(probe.first) == 0) {
                     *fn.first = getProcAddress(probe.second);
                     break;
                 }
@@ -44,5 +58,13 @@ void InitializeExtensions(glProc (*getProcAddress)(const char*)) {
     });
 }
 
+bool elementIndexUintSupported() {
+#if MBGL_USE_GLES2
+    return elementIndexUint;
+#else
+    return true;
+#endif
+}
+
 } // namespace gl
 } // namespace mbgl
@@ -9,6 +9,10 @@ namespace gl {
 using glProc = void (*)();
 void InitializeExtensions(glProc (*getProcAddress)(const char*));
 
+// Whether GL_UNSIGNED_INT element indices can be drawn: always on desktop OpenGL, and on OpenGL ES
+// with version 3 or OES_element_index_uint. Only known once InitializeExtensions() has run.
+bool elementIndexUintSupported();
+
 namespace detail {
 
 class ExtensionFunctionBase {
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <mbgl/gl/object.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 
 namespace mbgl {
 namespace gl {
@@ -34,7 +34,11 @@ public:
     static_assert(std::is_same<Primitive, Line>::value || std::is_same<Primitive, Triangle>::value,
                   "primitive must be Line or Triangle");
     static constexpr std::size_t primitiveSize = sizeof(Primitive);
-    UniqueBuffer buffer;
+    BufferRange buffer;
+
+    // Set if the buffer holds 32-bit indices that address the whole vertex buffer, instead of
+    // Primitives whose indices are relative to the start of their element group.
+    bool uintIndices = false;
 };
 
 } // namespace gl
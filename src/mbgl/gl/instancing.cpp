@@ -0,0 +1,19 @@
+#include <mbgl/gl/instancing.hpp>
+
+namespace mbgl {
+namespace gl {
+
+ExtensionFunction<void(GLuint index, GLuint divisor)>
+    VertexAttribDivisor({ { "OpenGL ES 3", "glVertexAttribDivisor" },
+                          { "GL_ARB_instanced_arrays", "glVertexAttribDivisorARB" },
+                          { "GL_EXT_instanced_arrays", "glVertexAttribDivisorEXT" },
+                          { "GL_ANGLE_instanced_arrays", "glVertexAttribDivisorANGLE" } });
+
+ExtensionFunction<void(GLenum mode, GLint first, GLsizei count, GLsizei primcount)>
+    DrawArraysInstanced({ { "OpenGL ES 3", "glDrawArraysInstanced" },
+                          { "GL_ARB_instanced_arrays", "glDrawArraysInstancedARB" },
+                          { "GL_EXT_instanced_arrays", "glDrawArraysInstancedEXT" },
+                          { "GL_ANGLE_instanced_arrays", "glDrawArraysInstancedANGLE" } });
+
+} // namespace gl
+} // namespace mbgl
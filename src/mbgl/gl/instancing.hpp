@@ -0,0 +1,19 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+namespace gl {
+
+extern ExtensionFunction<void(GLuint index, GLuint divisor)> VertexAttribDivisor;
+extern ExtensionFunction<void(GLenum mode, GLint first, GLsizei count, GLsizei primcount)> DrawArraysInstanced;
+
+// Whether attributes can advance per instance and instanced draw calls can be made: with OpenGL ES
+// 3, or with one of the instanced arrays extensions. Only known once InitializeExtensions() has run.
+inline bool instancedArraysSupported() {
+    return VertexAttribDivisor && DrawArraysInstanced;
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -24,6 +24,15 @@ void BufferDeleter::operator()(BufferID id) const {
 
 void TextureDeleter::operator()(TextureID id) const {
     assert(context);
+    const auto it = context->imageTextureSizes.find(id);
+    if (it != context->imageTextureSizes.end()) {
+        if (context->pooledImageTextures.size() < ImageTextureMax) {
+            context->pooledImageTextures.emplace_back(it->second, id);
+            return;
+        }
+        context->imageTextureSizes.erase(it);
+    }
+
     if (context->pooledTextures.size() >= TextureMax) {
         context->abandonedTextures.push_back(id);
     } else {
@@ -41,6 +50,16 @@ void FramebufferDeleter::operator()(FramebufferID id) const {
     context->abandonedFramebuffers.push_back(id);
 }
 
+void RenderbufferDeleter::operator()(RenderbufferID id) const {
+    assert(context);
+    context->abandonedRenderbuffers.push_back(id);
+}
+
+void QueryDeleter::operator()(QueryID id) const {
+    assert(context);
+    context->abandonedQueries.push_back(id);
+}
+
 } // namespace detail
 } // namespace gl
 } // namespace mbgl
@@ -41,6 +41,16 @@ struct FramebufferDeleter {
     void operator()(FramebufferID) const;
 };
 
+struct RenderbufferDeleter {
+    Context* context;
+    void operator()(RenderbufferID) const;
+};
+
+struct QueryDeleter {
+    Context* context;
+    void operator()(QueryID) const;
+};
+
 } // namespace detail
 
 using UniqueProgram = std_experimental::unique_resource<ProgramID, detail::ProgramDeleter>;
@@ -49,6 +59,8 @@ using UniqueBuffer = std_experimental::unique_resource<BufferID, detail::BufferD
 using UniqueTexture = std_experimental::unique_resource<TextureID, detail::TextureDeleter>;
 using UniqueVertexArray = std_experimental::unique_resource<VertexArrayID, detail::VertexArrayDeleter>;
 using UniqueFramebuffer = std_experimental::unique_resource<FramebufferID, detail::FramebufferDeleter>;
+using UniqueRenderbuffer = std_experimental::unique_resource<RenderbufferID, detail::RenderbufferDeleter>;
+using UniqueQuery = std_experimental::unique_resource<QueryID, detail::QueryDeleter>;
 
 } // namespace gl
 } // namespace mbgl
@@ -0,0 +1,190 @@
+#include <mbgl/gl/program_binary.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace mbgl {
+namespace gl {
+
+ExtensionFunction<void(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, GLvoid* binary)>
+    GetProgramBinary({ { "OpenGL ES 3", "glGetProgramBinary" },
+                       { "GL_OES_get_program_binary", "glGetProgramBinaryOES" },
+                       { "GL_ARB_get_program_binary", "glGetProgramBinary" } });
+
+ExtensionFunction<void(GLuint program, GLenum binaryFormat, const GLvoid* binary, GLint length)>
+    ProgramBinary({ { "OpenGL ES 3", "glProgramBinary" },
+                    { "GL_OES_get_program_binary", "glProgramBinaryOES" },
+                    { "GL_ARB_get_program_binary", "glProgramBinary" } });
+
+ExtensionFunction<void(GLuint program, GLenum pname, GLint value)>
+    ProgramParameteri({ { "OpenGL ES 3", "glProgramParameteri" },
+                        { "GL_ARB_get_program_binary", "glProgramParameteri" } });
+
+bool programBinarySupported() {
+    if (!GetProgramBinary || !ProgramBinary) {
+        return false;
+    }
+    GLint formats = 0;
+    MBGL_CHECK_ERROR(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+    return formats > 0;
+}
+
+void setProgramBinaryRetrievable(ProgramID program) {
+    // OES_get_program_binary has no hint; binaries are always retrievable there.
+    if (ProgramParameteri) {
+        MBGL_CHECK_ERROR(ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+}
+
+namespace {
+
+/*
+    A cached program is stored as:
+
+        "MBGLPROG", format version (uint32)
+        driver, vertex source, fragment source (uint32 length + bytes each)
+        binary format (uint32), binary (up to the end)
+
+    in the native byte order. The driver is identified by the vendor, renderer and version
+    strings; binaries saved by another driver, or for other sources, aren't loaded.
+*/
+
+const char magic[] = "MBGLPROG";
+const uint32_t formatVersion = 1;
+
+std::string driverIdentifier() {
+    std::string identifier;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const auto* value = reinterpret_cast<const char*>(MBGL_CHECK_ERROR(glGetString(name)));
+        identifier += value ? value : "";
+        identifier += '\n';
+    }
+    return identifier;
+}
+
+void writeUint32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::string& out, const std::string& value) {
+    writeUint32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+class Reader {
+public:
+    Reader(const std::string& data_) : data(data_) {}
+
+    bool readUint32(uint32_t& value) {
+        if (data.size() - pos < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+
+    // Whether the next string equals `expected`.
+    bool matchString(const std::string& expected) {
+        uint32_t length;
+        if (!readUint32(length) || length != expected.size() || data.size() - pos < length ||
+            data.compare(pos, length, expected) != 0) {
+            return false;
+        }
+        pos += length;
+        return true;
+    }
+
+    bool matchMagic() {
+        const std::size_t length = sizeof(magic) - 1;
+        if (data.size() < length || data.compare(0, length, magic) != 0) {
+            return false;
+        }
+        pos = length;
+        return true;
+    }
+
+    const char* remaining() const { return data.data() + pos; }
+    std::size_t remainingSize() const { return data.size() - pos; }
+
+private:
+    const std::string& data;
+    std::size_t pos = 0;
+};
+
+} // namespace
+
+bool loadProgramBinary(ProgramID program,
+                       const std::string& path,
+                       const std::string& vertexSource,
+                       const std::string& fragmentSource) {
+    std::string data;
+    try {
+        data = util::read_file(path);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    Reader reader(data);
+    uint32_t version;
+    uint32_t binaryFormat;
+    if (!reader.matchMagic() || !reader.readUint32(version) || version != formatVersion ||
+        !reader.matchString(driverIdentifier()) || !reader.matchString(vertexSource) ||
+        !reader.matchString(fragmentSource) || !reader.readUint32(binaryFormat) ||
+        !reader.remainingSize()) {
+        return false;
+    }
+
+    MBGL_CHECK_ERROR(ProgramBinary(program, binaryFormat, reader.remaining(),
+                                   static_cast<GLint>(reader.remainingSize())));
+
+    GLint status = 0;
+    MBGL_CHECK_ERROR(glGetProgramiv(program, GL_LINK_STATUS, &status));
+    return status != 0;
+}
+
+void saveProgramBinary(ProgramID program,
+                       const std::string& path,
+                       const std::string& vertexSource,
+                       const std::string& fragmentSource) {
+    GLint length = 0;
+    MBGL_CHECK_ERROR(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) {
+        return;
+    }
+
+    std::string binary(static_cast<std::size_t>(length), '\0');
+    GLenum binaryFormat = 0;
+    MBGL_CHECK_ERROR(GetProgramBinary(program, length, &length, &binaryFormat, &binary[0]));
+    binary.resize(static_cast<std::size_t>(length));
+
+    std::string data(magic, sizeof(magic) - 1);
+    writeUint32(data, formatVersion);
+    writeString(data, driverIdentifier());
+    writeString(data, vertexSource);
+    writeString(data, fragmentSource);
+    writeUint32(data, binaryFormat);
+    data += binary;
+
+    try {
+        util::write_file(path, data);
+    } catch (const std::exception& e) {
+        Log::Warning(Event::Shader, "Failed to cache program binary: %s", e.what());
+    }
+}
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/types.hpp>
+
+#include <string>
+
+namespace mbgl {
+namespace gl {
+
+extern ExtensionFunction<void(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, GLvoid* binary)> GetProgramBinary;
+extern ExtensionFunction<void(GLuint program, GLenum binaryFormat, const GLvoid* binary, GLint length)> ProgramBinary;
+extern ExtensionFunction<void(GLuint program, GLenum pname, GLint value)> ProgramParameteri;
+
+// Whether linked programs can be retrieved and loaded again: with OpenGL ES 3, or with one of the
+// get_program_binary extensions, and a driver that supports at least one binary format.
+bool programBinarySupported();
+
+// Asks the driver to keep the binary of `program` retrievable. Call before linking it.
+void setProgramBinaryRetrievable(ProgramID program);
+
+// Links `program` from the binary that saveProgramBinary() stored in the file at `path`, provided
+// it was saved for the same sources by the same driver. Returns false if there is no such binary,
+// or the driver rejects it; the program must then be compiled and linked from source.
+bool loadProgramBinary(ProgramID program,
+                       const std::string& path,
+                       const std::string& vertexSource,
+                       const std::string& fragmentSource);
+
+// Stores the binary of the linked `program` in the file at `path`, replacing what it held.
+void saveProgramBinary(ProgramID program,
+                       const std::string& path,
+                       const std::string& vertexSource,
+                       const std::string& fragmentSource);
+
+} // namespace gl
+} // namespace mbgl
@@ -1,6 +1,7 @@
 #include <mbgl/gl/shader.hpp>
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/gl/program_binary.hpp>
 #include <mbgl/util/stopwatch.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/platform/log.hpp>
@@ -23,30 +24,49 @@ Shader::Shader(const char* name_,
                Context& context,
                Defines defines)
     : name(name_),
-      program(context.createProgram()),
-      vertexShader(context.createVertexShader()),
-      fragmentShader(context.createFragmentShader()) {
+      program(context.createProgram()) {
     util::stopwatch stopwatch("shader compilation", Event::Shader);
 
-    if (!compileShader(vertexShader, vertexSource)) {
-        Log::Error(Event::Shader, "Vertex shader %s failed to compile: %s", name, vertexSource);
-        throw util::ShaderException(std::string { "Vertex shader " } + name + " failed to compile");
-    }
-
     std::string fragment(fragmentSource);
     if (defines & Defines::Overdraw) {
         assert(fragment.find("#ifdef OVERDRAW_INSPECTOR") != std::string::npos);
         fragment.replace(fragment.find_first_of('\n'), 1, "\n#define OVERDRAW_INSPECTOR\n");
     }
 
-    if (!compileShader(fragmentShader, fragment.c_str())) {
-        Log::Error(Event::Shader, "Fragment shader %s failed to compile: %s", name, fragmentSource);
+    std::string binaryPath;
+    if (!context.getProgramCachePath().empty() && programBinarySupported()) {
+        binaryPath = context.getProgramCachePath() + "." + name +
+                     (defines & Defines::Overdraw ? ".overdraw" : "") + ".program";
+        if (loadProgramBinary(program.get(), binaryPath, vertexSource, fragment)) {
+            return;
+        }
+        setProgramBinaryRetrievable(program.get());
+    }
+
+    compileAndLink(context, vertexSource, fragment);
+
+    if (!binaryPath.empty()) {
+        saveProgramBinary(program.get(), binaryPath, vertexSource, fragment);
+    }
+}
+
+void Shader::compileAndLink(Context& context, const char* vertexSource, const std::string& fragment) {
+    vertexShader = context.createVertexShader();
+    fragmentShader = context.createFragmentShader();
+
+    if (!compileShader(*vertexShader, vertexSource)) {
+        Log::Error(Event::Shader, "Vertex shader %s failed to compile: %s", name, vertexSource);
+        throw util::ShaderException(std::string { "Vertex shader " } + name + " failed to compile");
+    }
+
+    if (!compileShader(*fragmentShader, fragment.c_str())) {
+        Log::Error(Event::Shader, "Fragment shader %s failed to compile: %s", name, fragment.c_str());
         throw util::ShaderException(std::string { "Fragment shader " } + name + " failed to compile");
     }
 
     // Attach shaders
-    MBGL_CHECK_ERROR(glAttachShader(program.get(), vertexShader.get()));
-    MBGL_CHECK_ERROR(glAttachShader(program.get(), fragmentShader.get()));
+    MBGL_CHECK_ERROR(glAttachShader(program.get(), vertexShader->get()));
+    MBGL_CHECK_ERROR(glAttachShader(program.get(), fragmentShader->get()));
 
     // Link program
     GLint status;
@@ -95,9 +115,9 @@ bool Shader::compileShader(UniqueShader& shader, const GLchar *source) {
 }
 
 Shader::~Shader() {
-    if (program.get()) {
-        MBGL_CHECK_ERROR(glDetachShader(program.get(), vertexShader.get()));
-        MBGL_CHECK_ERROR(glDetachShader(program.get(), fragmentShader.get()));
+    if (program.get() && vertexShader && fragmentShader) {
+        MBGL_CHECK_ERROR(glDetachShader(program.get(), vertexShader->get()));
+        MBGL_CHECK_ERROR(glDetachShader(program.get(), fragmentShader->get()));
     }
 }
 
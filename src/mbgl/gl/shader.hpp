@@ -3,6 +3,9 @@
 #include <mbgl/gl/types.hpp>
 #include <mbgl/gl/object.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <string>
 
 namespace mbgl {
 namespace gl {
@@ -35,10 +38,13 @@ protected:
 
 private:
     bool compileShader(UniqueShader&, const char *source);
+    void compileAndLink(Context&, const char* vertexSource, const std::string& fragmentSource);
 
     UniqueProgram program;
-    UniqueShader vertexShader;
-    UniqueShader fragmentShader;
+
+    // Not created when the program was linked from a cached binary.
+    optional<UniqueShader> vertexShader;
+    optional<UniqueShader> fragmentShader;
 };
 
 } // namespace gl
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace mbgl {
 namespace gl {
 
@@ -38,6 +40,7 @@ public:
             dirty = false;
             currentValue = value;
             T::Set(currentValue);
+            changes++;
         }
     }
 
@@ -72,10 +75,16 @@ public:
         defaultValue = value;
     }
 
+    // The number of actual OpenGL calls that assignments resulted in.
+    std::size_t getChangeCount() const {
+        return changes;
+    }
+
 private:
     typename T::Type defaultValue = DefaultValue<T>::Get();
     typename T::Type currentValue = defaultValue;
     bool dirty = false;
+    std::size_t changes = 0;
 };
 
 // Helper struct that stores the current state and restores it upon destruction. You should not use
@@ -0,0 +1,12 @@
+#include <mbgl/gl/texture.hpp>
+
+namespace mbgl {
+namespace gl {
+
+ExtensionFunction<void(GLenum target)>
+    GenerateMipmap({ { "OpenGL ES", "glGenerateMipmap" },
+                     { "GL_ARB_framebuffer_object", "glGenerateMipmap" },
+                     { "GL_EXT_framebuffer_object", "glGenerateMipmapEXT" } });
+
+} // namespace gl
+} // namespace mbgl
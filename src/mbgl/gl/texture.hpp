@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/object.hpp>
 
 #include <array>
@@ -13,7 +15,14 @@ public:
     UniqueTexture texture;
     TextureFilter filter = TextureFilter::Nearest;
     TextureMipMap mipmap = TextureMipMap::No;
+
+    // Whether the levels below the base one have been generated, so that the texture can be
+    // bound with TextureMipMap::Yes.
+    bool mipmaps = false;
 };
 
+// With OpenGL ES 2 or 3, or with one of the framebuffer object extensions.
+extern ExtensionFunction<void(GLenum target)> GenerateMipmap;
+
 } // namespace gl
 } // namespace mbgl
@@ -0,0 +1,81 @@
+#include <mbgl/gl/timer_query.hpp>
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
+namespace mbgl {
+namespace gl {
+
+// OpenGL ES 3 has queries, but not of the time elapsed; only the extensions add that.
+ExtensionFunction<void(GLsizei n, GLuint* ids)>
+    GenQueries({ { "GL_ARB_timer_query", "glGenQueries" },
+                 { "GL_EXT_timer_query", "glGenQueries" },
+                 { "GL_EXT_disjoint_timer_query", "glGenQueriesEXT" } });
+
+ExtensionFunction<void(GLsizei n, const GLuint* ids)>
+    DeleteQueries({ { "GL_ARB_timer_query", "glDeleteQueries" },
+                    { "GL_EXT_timer_query", "glDeleteQueries" },
+                    { "GL_EXT_disjoint_timer_query", "glDeleteQueriesEXT" } });
+
+ExtensionFunction<void(GLenum target, GLuint id)>
+    BeginQuery({ { "GL_ARB_timer_query", "glBeginQuery" },
+                 { "GL_EXT_timer_query", "glBeginQuery" },
+                 { "GL_EXT_disjoint_timer_query", "glBeginQueryEXT" } });
+
+ExtensionFunction<void(GLenum target)>
+    EndQuery({ { "GL_ARB_timer_query", "glEndQuery" },
+               { "GL_EXT_timer_query", "glEndQuery" },
+               { "GL_EXT_disjoint_timer_query", "glEndQueryEXT" } });
+
+ExtensionFunction<void(GLuint id, GLenum pname, GLint* params)>
+    GetQueryObjectiv({ { "GL_ARB_timer_query", "glGetQueryObjectiv" },
+                       { "GL_EXT_timer_query", "glGetQueryObjectiv" },
+                       { "GL_EXT_disjoint_timer_query", "glGetQueryObjectivEXT" } });
+
+ExtensionFunction<void(GLuint id, GLenum pname, uint64_t* params)>
+    GetQueryObjectui64v({ { "GL_ARB_timer_query", "glGetQueryObjectui64v" },
+                          { "GL_EXT_timer_query", "glGetQueryObjectui64vEXT" },
+                          { "GL_EXT_disjoint_timer_query", "glGetQueryObjectui64vEXT" } });
+
+void beginTimerQuery(QueryID id) {
+    MBGL_CHECK_ERROR(BeginQuery(GL_TIME_ELAPSED, id));
+}
+
+void endTimerQuery() {
+    MBGL_CHECK_ERROR(EndQuery(GL_TIME_ELAPSED));
+}
+
+bool timerQueryAvailable(QueryID id) {
+    GLint available = GL_FALSE;
+    MBGL_CHECK_ERROR(GetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &available));
+    return available == GL_TRUE;
+}
+
+uint64_t timerQueryResult(QueryID id) {
+    uint64_t result = 0;
+    MBGL_CHECK_ERROR(GetQueryObjectui64v(id, GL_QUERY_RESULT, &result));
+    return result;
+}
+
+bool timerQueriesDisjoint() {
+#if MBGL_USE_GLES2
+    GLint disjoint = GL_FALSE;
+    MBGL_CHECK_ERROR(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+    return disjoint == GL_TRUE;
+#else
+    return false;
+#endif
+}
+
+} // namespace gl
+} // namespace mbgl
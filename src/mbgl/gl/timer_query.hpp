@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/types.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+namespace gl {
+
+extern ExtensionFunction<void(GLsizei n, GLuint* ids)> GenQueries;
+extern ExtensionFunction<void(GLsizei n, const GLuint* ids)> DeleteQueries;
+extern ExtensionFunction<void(GLenum target, GLuint id)> BeginQuery;
+extern ExtensionFunction<void(GLenum target)> EndQuery;
+extern ExtensionFunction<void(GLuint id, GLenum pname, GLint* params)> GetQueryObjectiv;
+extern ExtensionFunction<void(GLuint id, GLenum pname, uint64_t* params)> GetQueryObjectui64v;
+
+// Whether the GPU time that commands take can be measured with GL_TIME_ELAPSED queries: with
+// ARB_timer_query or EXT_timer_query on desktop OpenGL, or EXT_disjoint_timer_query on OpenGL ES.
+// Only known once InitializeExtensions() has run.
+inline bool timerQuerySupported() {
+    return GenQueries && DeleteQueries && BeginQuery && EndQuery && GetQueryObjectiv && GetQueryObjectui64v;
+}
+
+// Starts measuring the GPU time of the commands that follow, until endTimerQuery(). Only one
+// query may be measuring at a time.
+void beginTimerQuery(QueryID);
+void endTimerQuery();
+
+// Whether the result of the query is in, without waiting for the GPU.
+bool timerQueryAvailable(QueryID);
+
+// The GPU time that the commands measured by the query took, in nanoseconds. Only call once the
+// query is available.
+uint64_t timerQueryResult(QueryID);
+
+// Whether the GPU did something since the last call, e.g. changed its clock, that makes the
+// measurements of the queries that ended meanwhile meaningless. Only OpenGL ES reports it.
+bool timerQueriesDisjoint();
+
+} // namespace gl
+} // namespace mbgl
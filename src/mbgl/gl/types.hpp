@@ -14,6 +14,7 @@ using TextureID = uint32_t;
 using VertexArrayID = uint32_t;
 using FramebufferID = uint32_t;
 using RenderbufferID = uint32_t;
+using QueryID = uint32_t;
 
 using AttributeLocation = int32_t;
 using UniformLocation = int32_t;
@@ -48,6 +49,10 @@ enum class BufferType : uint32_t {
     Element = 0x8893
 };
 
+enum class RenderbufferType : uint32_t {
+    DepthStencil = 0x88F0 // GL_DEPTH24_STENCIL8(_OES)
+};
+
 enum class TextureMipMap : bool { No = false, Yes = true };
 enum class TextureFilter : bool { Nearest = false, Linear = true };
 
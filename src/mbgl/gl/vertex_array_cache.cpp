@@ -0,0 +1,98 @@
+#include <mbgl/gl/vertex_array_cache.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/vertex_array.hpp>
+#include <mbgl/platform/log.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+
+namespace mbgl {
+namespace gl {
+
+std::size_t VertexArrayCache::Hash::operator()(const VertexArrayKey& key) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, key.program);
+    boost::hash_combine(seed, key.vertexBuffer);
+    boost::hash_combine(seed, key.elementBuffer);
+    boost::hash_combine(seed, key.offset);
+    boost::hash_combine(seed, key.stride);
+    return seed;
+}
+
+VertexArrayCache::VertexArrayCache(Context& context_, std::size_t capacity_)
+    : context(context_), capacity(std::max<std::size_t>(capacity_, 1)) {
+}
+
+bool VertexArrayCache::bind(const VertexArrayKey& key) {
+    if (!GenVertexArrays || !BindVertexArray) {
+        static bool reported = false;
+        if (!reported) {
+            Log::Warning(Event::OpenGL, "Not using Vertex Array Objects");
+            reported = true;
+        }
+        return false;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        context.vertexArrayObject = entries.front().second;
+        // The element buffer binding is part of the vertex array object's state.
+        context.elementBuffer.setDirty();
+        return true;
+    }
+
+    if (entries.size() >= capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+
+    entries.emplace_front(key, context.createVertexArray());
+    index.emplace(key, entries.begin());
+
+    context.vertexArrayObject = entries.front().second;
+    context.vertexBuffer.setDirty();
+    context.elementBuffer.setDirty();
+    return false;
+}
+
+template <class Predicate>
+void VertexArrayCache::eraseIf(Predicate&& predicate) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (predicate(it->first)) {
+            index.erase(it->first);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void VertexArrayCache::abandonPrograms(const std::vector<ProgramID>& programs) {
+    if (programs.empty()) {
+        return;
+    }
+    eraseIf([&](const VertexArrayKey& key) {
+        return std::find(programs.begin(), programs.end(), key.program) != programs.end();
+    });
+}
+
+void VertexArrayCache::abandonBuffers(const std::vector<BufferID>& buffers) {
+    if (buffers.empty()) {
+        return;
+    }
+    eraseIf([&](const VertexArrayKey& key) {
+        return std::find(buffers.begin(), buffers.end(), key.vertexBuffer) != buffers.end() ||
+               (key.elementBuffer &&
+                std::find(buffers.begin(), buffers.end(), key.elementBuffer) != buffers.end());
+    });
+}
+
+void VertexArrayCache::clear() {
+    index.clear();
+    entries.clear();
+}
+
+} // namespace gl
+} // namespace mbgl
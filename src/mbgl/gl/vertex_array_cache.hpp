@@ -0,0 +1,81 @@
+#pragma once
+
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+
+class Context;
+
+// Everything a vertex array object records for our draw calls: the attribute layout, which
+// follows from the program and the vertex stride, and the buffer objects and the byte offset of
+// the first vertex that the attributes point into.
+struct VertexArrayKey {
+    ProgramID program;
+    BufferID vertexBuffer;
+    BufferID elementBuffer;
+    std::size_t offset;
+    std::size_t stride;
+
+    bool operator==(const VertexArrayKey& rhs) const {
+        return program == rhs.program && vertexBuffer == rhs.vertexBuffer &&
+               elementBuffer == rhs.elementBuffer && offset == rhs.offset && stride == rhs.stride;
+    }
+};
+
+/*
+    A `VertexArrayCache` keeps one vertex array object per distinct binding, rather than one per
+    bucket and shader. Buckets whose data lives at the same place of the same BufferArena buffer,
+    e.g. one that reuses the range of a bucket that went away, share the vertex array object.
+
+    It holds at most `capacity` of them, and evicts the least recently used one to make room for
+    a new one. Entries that refer to a deleted program or buffer object are dropped before the
+    name can be reused.
+
+    Like the rest of `Context`, it must only be used on the thread that renders.
+*/
+class VertexArrayCache : private util::noncopyable {
+public:
+    VertexArrayCache(Context&, std::size_t capacity = 1024);
+
+    // Binds the vertex array object for the key. Returns true if it already records the binding.
+    // Otherwise, the caller has to bind the buffers and attributes: either a new vertex array
+    // object was created and bound, or the context doesn't support them and none is bound.
+    bool bind(const VertexArrayKey&);
+
+    // Drops the entries that refer to any of these program or buffer objects.
+    void abandonPrograms(const std::vector<ProgramID>&);
+    void abandonBuffers(const std::vector<BufferID>&);
+
+    void clear();
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+private:
+    struct Hash {
+        std::size_t operator()(const VertexArrayKey&) const;
+    };
+
+    template <class Predicate>
+    void eraseIf(Predicate&&);
+
+    Context& context;
+    const std::size_t capacity;
+
+    // Most recently used first.
+    using Entries = std::list<std::pair<VertexArrayKey, UniqueVertexArray>>;
+    Entries entries;
+    std::unordered_map<VertexArrayKey, Entries::iterator, Hash> index;
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <mbgl/gl/object.hpp>
+#include <mbgl/gl/buffer_arena.hpp>
 
 namespace mbgl {
 namespace gl {
@@ -10,7 +10,7 @@ class VertexBuffer {
 public:
     static constexpr std::size_t vertexSize = sizeof(Vertex);
     std::size_t vertexCount;
-    UniqueBuffer buffer;
+    BufferRange buffer;
 };
 
 } // namespace gl
@@ -3,74 +3,71 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <limits>
+#include <unordered_map>
+
 namespace mbgl {
 namespace util {
 
-using Index = std::unordered_map<size_t, unsigned int>;
-
-unsigned int mergeFromRight(std::vector<SymbolFeature> &features,
-                            Index &rightIndex,
-                            Index::iterator left,
-                            size_t rightKey,
-                            GeometryCollection &geom) {
-
-    unsigned int index = left->second;
-    rightIndex.erase(left);
-    rightIndex[rightKey] = index;
-    features[index].geometry[0].pop_back();
-    features[index].geometry[0].insert(
-        features[index].geometry[0].end(), geom[0].begin(), geom[0].end());
-    geom[0].clear();
-    return index;
-}
+namespace {
 
-unsigned int mergeFromLeft(std::vector<SymbolFeature> &features,
-                           Index &leftIndex,
-                           size_t leftKey,
-                           Index::iterator right,
-                           GeometryCollection &geom) {
-
-    unsigned int index = right->second;
-    leftIndex.erase(right);
-    leftIndex[leftKey] = index;
-    geom[0].pop_back();
-    geom[0].insert(
-        geom[0].end(), features[index].geometry[0].begin(), features[index].geometry[0].end());
-    features[index].geometry[0].clear();
-    std::swap(features[index].geometry[0], geom[0]);
-    return index;
-}
+// An end of a line, with the line's text. Tile coordinates are integers, so ends that meet have
+// equal keys.
+struct EndKey {
+    const std::u32string* text;
+    std::size_t textHash;
+    GeometryCoordinate coord;
+
+    bool operator==(const EndKey& other) const {
+        return coord == other.coord && textHash == other.textHash && *text == *other.text;
+    }
+};
 
-enum class Side {
-    Left = false,
-    Right = true,
+struct EndKeyHash {
+    std::size_t operator()(const EndKey& key) const {
+        std::size_t hash = key.textHash;
+        boost::hash_combine(hash, key.coord.x);
+        boost::hash_combine(hash, key.coord.y);
+        return hash;
+    }
 };
 
-size_t
-getKey(const std::u32string& text, const GeometryCollection& geom, Side side) {
-    const GeometryCoordinate& coord = side == Side::Right ? geom[0].back() : geom[0].front();
+// Maps the free ends of the merged lines found so far to the feature that will hold each line.
+using Index = std::unordered_map<EndKey, unsigned int, EndKeyHash>;
 
-    auto hash = std::hash<std::u32string>()(text);
-    boost::hash_combine(hash, coord.x);
-    boost::hash_combine(hash, coord.y);
-    return hash;
-}
+constexpr unsigned int None = std::numeric_limits<unsigned int>::max();
+
+// A merged line, as a list of the features whose lines it's made of, linked through `next`. It's
+// kept by the feature that will hold the line.
+struct Chain {
+    unsigned int first = None;
+    unsigned int last = None;
+};
+
+} // namespace
 
 void mergeLines(std::vector<SymbolFeature> &features) {
+    // The lines are only linked while looking for the ends that meet, and then each merged line is
+    // concatenated once, so that merging a long road from many pieces takes linear time.
+    std::vector<unsigned int> next(features.size(), None);
+    std::vector<Chain> chains(features.size());
 
     Index leftIndex;
     Index rightIndex;
+    leftIndex.reserve(features.size());
+    rightIndex.reserve(features.size());
 
     for (unsigned int k = 0; k < features.size(); k++) {
         SymbolFeature &feature = features[k];
-        GeometryCollection &geometry = feature.geometry;
+        const GeometryCoordinates &line = feature.geometry[0];
 
         if (!feature.text) {
             continue;
         }
 
-        const auto leftKey = getKey(*feature.text, geometry, Side::Left);
-        const auto rightKey = getKey(*feature.text, geometry, Side::Right);
+        const std::size_t textHash = std::hash<std::u32string>()(*feature.text);
+        const EndKey leftKey { &*feature.text, textHash, line.front() };
+        const EndKey rightKey { &*feature.text, textHash, line.back() };
 
         const auto left = rightIndex.find(leftKey);
         const auto right = leftIndex.find(rightKey);
@@ -78,29 +75,75 @@ void mergeLines(std::vector<SymbolFeature> &features) {
         if ((left != rightIndex.end()) && (right != leftIndex.end()) &&
             (left->second != right->second)) {
             // found lines with the same text adjacent to both ends of the current line, merge all
-            // three
-            unsigned int j = mergeFromLeft(features, leftIndex, leftKey, right, geometry);
-            unsigned int i =
-                mergeFromRight(features, rightIndex, left, rightKey, features[j].geometry);
-
+            // three into the line on the left
+            const unsigned int i = left->second;
+            const unsigned int j = right->second;
+            Chain &leftChain = chains[i];
+            const Chain rightChain = chains[j];
+
+            next[leftChain.last] = k;
+            next[k] = rightChain.first;
+            leftChain.last = rightChain.last;
+            chains[j] = Chain();
+
+            rightIndex.erase(left);
+            leftIndex.erase(right);
+            // Where a line on either side is a loop, its other end is at the current line too,
+            // and isn't free anymore.
             leftIndex.erase(leftKey);
             rightIndex.erase(rightKey);
-            rightIndex[getKey(*feature.text, features[i].geometry, Side::Right)] = i;
+            rightIndex[EndKey { &*feature.text, textHash, features[rightChain.last].geometry[0].back() }] = i;
 
         } else if (left != rightIndex.end()) {
             // found mergeable line adjacent to the start of the current line, merge
-            mergeFromRight(features, rightIndex, left, rightKey, geometry);
+            const unsigned int i = left->second;
+            Chain &chain = chains[i];
+            next[chain.last] = k;
+            chain.last = k;
+
+            rightIndex.erase(left);
+            rightIndex[rightKey] = i;
 
         } else if (right != leftIndex.end()) {
             // found mergeable line adjacent to the end of the current line, merge
-            mergeFromLeft(features, leftIndex, leftKey, right, geometry);
+            const unsigned int j = right->second;
+            Chain &chain = chains[j];
+            next[k] = chain.first;
+            chain.first = k;
+
+            leftIndex.erase(right);
+            leftIndex[leftKey] = j;
 
         } else {
             // no adjacent lines, add as a new item
+            chains[k] = Chain { k, k };
             leftIndex[leftKey] = k;
             rightIndex[rightKey] = k;
         }
     }
+
+    for (unsigned int i = 0; i < features.size(); i++) {
+        const Chain &chain = chains[i];
+        if (chain.first == chain.last) {
+            continue;
+        }
+
+        std::size_t size = 1;
+        for (unsigned int k = chain.first; k != None; k = next[k]) {
+            size += features[k].geometry[0].size() - 1;
+        }
+
+        // Each line starts where the previous one ends.
+        GeometryCoordinates merged;
+        merged.reserve(size);
+        for (unsigned int k = chain.first; k != None; k = next[k]) {
+            GeometryCoordinates &line = features[k].geometry[0];
+            merged.insert(merged.end(), line.begin() + (k == chain.first ? 0 : 1), line.end());
+            line.clear();
+        }
+
+        features[i].geometry[0] = std::move(merged);
+    }
 }
 
 } // end namespace util
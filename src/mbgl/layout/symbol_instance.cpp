@@ -5,7 +5,7 @@ namespace mbgl {
 
 using namespace style;
 
-SymbolInstance::SymbolInstance(Anchor& anchor, const GeometryCoordinates& line,
+SymbolInstance::SymbolInstance(Anchor& anchor, const GeometryCoordinates& line, const LineMetrics& lineMetrics,
         const Shaping& shapedText, const PositionedIcon& shapedIcon,
         const SymbolLayoutProperties& layout, const bool addToBuffers, const uint32_t index_,
         const float textBoxScale, const float textPadding, const SymbolPlacementType textPlacement,
@@ -18,7 +18,7 @@ SymbolInstance::SymbolInstance(Anchor& anchor, const GeometryCoordinates& line,
 
     // Create the quads used for rendering the glyphs.
     glyphQuads(addToBuffers && shapedText ?
-            getGlyphQuads(anchor, shapedText, textBoxScale, line, layout, textPlacement, face) :
+            getGlyphQuads(anchor, shapedText, textBoxScale, line, lineMetrics, layout, textPlacement, face) :
             SymbolQuads()),
 
     // Create the quad used for rendering the icon.
@@ -7,14 +7,25 @@ namespace mbgl {
 
 struct Anchor;
 class IndexedSubfeature;
+class LineMetrics;
 
 namespace style {
 class SymbolLayoutProperties;
 } // namespace style
 
+// How far the text or icon of a symbol had faded in or out when its layout was last placed.
+class SymbolOpacity {
+public:
+    float opacity = 0;
+    bool placed = false;
+
+    // The scale at which it was last placed, which it's shown with while it fades out.
+    float placementScale = 0;
+};
+
 class SymbolInstance {
 public:
-    explicit SymbolInstance(Anchor& anchor, const GeometryCoordinates& line,
+    explicit SymbolInstance(Anchor& anchor, const GeometryCoordinates& line, const LineMetrics& lineMetrics,
             const Shaping& shapedText, const PositionedIcon& shapedIcon,
             const style::SymbolLayoutProperties&, const bool inside, const uint32_t index,
             const float textBoxScale, const float textPadding, style::SymbolPlacementType textPlacement,
@@ -29,6 +40,8 @@ public:
     SymbolQuads iconQuads;
     CollisionFeature textCollisionFeature;
     CollisionFeature iconCollisionFeature;
+    SymbolOpacity textOpacity;
+    SymbolOpacity iconOpacity;
 };
 
 } // namespace mbgl
@@ -2,13 +2,16 @@
 #include <mbgl/layout/merge_lines.hpp>
 #include <mbgl/layout/clip_lines.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/text/get_anchors.hpp>
+#include <mbgl/text/line_metrics.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/instrumentation.hpp>
 #include <mbgl/util/utf.hpp>
 #include <mbgl/util/token.hpp>
 #include <mbgl/util/math.hpp>
@@ -55,10 +58,13 @@ SymbolLayout::SymbolLayout(std::string bucketName_,
     auto layerName = layer.getName();
 
     // Determine and load glyph ranges
+    const CompiledFilter compiledFilter(filter);
+    const std::vector<std::string>& filterKeys = compiledFilter.getKeys();
     const size_t featureCount = layer.featureCount();
+    util::Instrumentation::add(util::Instrumentation::Counter::FilterEvaluation, featureCount);
     for (size_t i = 0; i < featureCount; ++i) {
         auto feature = layer.getFeature(i);
-        if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        if (!compiledFilter(feature->getType(), feature->getID(), [&] (std::size_t key) { return feature->getValue(filterKeys[key]); }))
             continue;
 
         SymbolFeature ft;
@@ -181,7 +187,22 @@ void SymbolLayout::prepare(uintptr_t tileUID,
         layout.textJustify == TextJustifyType::Left ? 0 :
         0.5;
 
-    auto glyphSet = glyphAtlas.getGlyphSet(layout.textFont);
+    auto glyphSet = glyphAtlas.readGlyphSet(layout.textFont);
+    ShapingCache& shapingCache = glyphAtlas.getShapingCache();
+
+    // The parameters all labels of the layer are shaped with.
+    ShapingKey key {
+        layout.textFont,
+        {},
+        /* maxWidth: ems */ layout.symbolPlacement != SymbolPlacementType::Line ?
+            layout.textMaxWidth * 24 : 0,
+        /* lineHeight: ems */ layout.textLineHeight * 24,
+        horizontalAlign,
+        verticalAlign,
+        justify,
+        /* spacing: ems */ layout.textLetterSpacing * 24,
+        /* translate */ Point<float>(layout.textOffset.value[0], layout.textOffset.value[1])
+    };
 
     for (const auto& feature : features) {
         if (feature.geometry.empty()) continue;
@@ -192,16 +213,17 @@ void SymbolLayout::prepare(uintptr_t tileUID,
 
         // if feature has text, shape the text
         if (feature.text) {
-            shapedText = glyphSet->getShaping(
-                /* string */ *feature.text,
-                /* maxWidth: ems */ layout.symbolPlacement != SymbolPlacementType::Line ?
-                    layout.textMaxWidth * 24 : 0,
-                /* lineHeight: ems */ layout.textLineHeight * 24,
-                /* horizontalAlign */ horizontalAlign,
-                /* verticalAlign */ verticalAlign,
-                /* justify */ justify,
-                /* spacing: ems */ layout.textLetterSpacing * 24,
-                /* translate */ Point<float>(layout.textOffset.value[0], layout.textOffset.value[1]));
+            key.text = *feature.text;
+
+            // The same labels recur in neighboring tiles and at other zoom levels.
+            if (optional<Shaping> cached = shapingCache.get(key)) {
+                shapedText = std::move(*cached);
+            } else {
+                shapedText = glyphSet->getShaping(key.text, key.maxWidth, key.lineHeight,
+                                                  key.horizontalAlign, key.verticalAlign,
+                                                  key.justify, key.spacing, key.translate);
+                shapingCache.add(key, shapedText);
+            }
 
             // Add the glyphs we need for this label to the glyph atlas.
             if (shapedText) {
@@ -271,9 +293,12 @@ void SymbolLayout::addFeature(const GeometryCollection &lines,
     for (const auto& line : clippedLines) {
         if (line.empty()) continue;
 
+        // Measured once for all the labels along the line.
+        const LineMetrics lineMetrics = isLine ? LineMetrics(line) : LineMetrics();
+
         // Calculate the anchor points around which you want to place labels
         Anchors anchors = isLine ?
-            getAnchors(line, symbolSpacing, textMaxAngle, shapedText.left, shapedText.right, shapedIcon.left, shapedIcon.right, glyphSize, textMaxBoxScale, overscaling) :
+            getAnchors(line, lineMetrics, symbolSpacing, textMaxAngle, shapedText.left, shapedText.right, shapedIcon.left, shapedIcon.right, glyphSize, textMaxBoxScale, overscaling) :
             Anchors({ Anchor(float(line[0].x), float(line[0].y), 0, minScale) });
 
         // For each potential label, create the placement features used to check for collisions, and the quads use for rendering.
@@ -301,7 +326,7 @@ void SymbolLayout::addFeature(const GeometryCollection &lines,
             // TODO remove the `&& false` when is #1673 implemented
             const bool addToBuffers = (mode == MapMode::Still) || inside || (mayOverlap && false);
 
-            symbolInstances.emplace_back(anchor, line, shapedText, shapedIcon, layout, addToBuffers, symbolInstances.size(),
+            symbolInstances.emplace_back(anchor, line, lineMetrics, shapedText, shapedIcon, layout, addToBuffers, symbolInstances.size(),
                     textBoxScale, textPadding, textPlacement,
                     iconBoxScale, iconPadding, iconPlacement,
                     face, indexedFeature);
@@ -325,6 +350,8 @@ bool SymbolLayout::anchorIsTooClose(const std::u32string &text, const float repe
 }
 
 std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile) {
+    std::lock_guard<std::mutex> lock(placementMutex);
+
     auto bucket = std::make_unique<SymbolBucket>(mode, layout, sdfIcons, iconsNeedLinear);
 
     // Calculate which labels can be shown and when they can be shown and
@@ -344,7 +371,14 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
     // are drawn on top of higher symbols.
     // Don't sort symbols that won't overlap because it isn't necessary and
     // because it causes more labels to pop in and out when rotating.
+    //
+    // The quads of all symbols, placed or not, are laid out in the order they're drawn in. Where
+    // that order doesn't change, each placement shares the quads of the first, along with the
+    // buffers that they're uploaded to, and only adds the zoom levels at which each is shown.
     if (mayOverlap) {
+        textQuads.reset();
+        iconQuads.reset();
+
         const float sin = std::sin(collisionTile.config.angle);
         const float cos = std::cos(collisionTile.config.angle);
 
@@ -357,6 +391,52 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
         });
     }
 
+    if (!textQuads || !iconQuads) {
+        auto text = std::make_shared<SymbolBucket::Quads>();
+        auto icon = std::make_shared<SymbolBucket::Quads>();
+        for (const SymbolInstance &symbolInstance : symbolInstances) {
+            if (symbolInstance.hasText) {
+                addQuads(*text, symbolInstance.glyphQuads);
+            }
+            if (symbolInstance.hasIcon) {
+                addQuads(*icon, symbolInstance.iconQuads);
+            }
+        }
+        textQuads = std::move(text);
+        iconQuads = std::move(icon);
+    }
+
+    // Each symbol fades from its opacity as of the last placement towards whether this placement
+    // shows it. Those of the first placement are shown or hidden at once.
+    const TimePoint placementTime = Clock::now();
+    const Duration fadeDuration = mode == MapMode::Continuous ? util::DEFAULT_FADE_DURATION : Duration::zero();
+    const float fadeChange = lastPlacementTime && fadeDuration != Duration::zero()
+        ? std::chrono::duration<float>(placementTime - *lastPlacementTime) / fadeDuration
+        : 1;
+    const bool firstPlacement = !lastPlacementTime;
+    lastPlacementTime = placementTime;
+    bucket->placementTime = placementTime;
+
+    const auto updateOpacity = [&] (SymbolOpacity& opacity, const bool placed, const float scale) {
+        if (firstPlacement) {
+            opacity.opacity = placed ? 1 : 0;
+        } else {
+            opacity.opacity = util::clamp(opacity.opacity + (opacity.placed ? fadeChange : -fadeChange), 0.0f, 1.0f);
+        }
+        opacity.placed = placed;
+        if (placed) {
+            opacity.placementScale = scale;
+        }
+        if (opacity.opacity != (placed ? 1 : 0)) {
+            bucket->fading = true;
+        }
+    };
+
+    bucket->text.quads = textQuads;
+    bucket->text.placementVertices.reserve(textQuads->vertices.size());
+    bucket->icon.quads = iconQuads;
+    bucket->icon.placementVertices.reserve(iconQuads->vertices.size());
+
     for (SymbolInstance &symbolInstance : symbolInstances) {
 
         const bool hasText = symbolInstance.hasText;
@@ -388,24 +468,22 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
         }
 
 
-        // Insert final placement into collision tree and add glyphs/icons to buffers
+        // Insert final placement into collision tree and add the placement of glyphs/icons to buffers
 
         if (hasText) {
             collisionTile.insertFeature(symbolInstance.textCollisionFeature, glyphScale, layout.textIgnorePlacement);
-            if (glyphScale < collisionTile.maxScale) {
-                addSymbols(
-                    bucket->text, symbolInstance.glyphQuads, glyphScale,
-                    layout.textKeepUpright, textPlacement, collisionTile.config.angle);
-            }
+            updateOpacity(symbolInstance.textOpacity, glyphScale < collisionTile.maxScale, glyphScale);
+            addSymbols(
+                bucket->text, symbolInstance.glyphQuads, symbolInstance.textOpacity,
+                layout.textKeepUpright, textPlacement, collisionTile.config.angle);
         }
 
         if (hasIcon) {
             collisionTile.insertFeature(symbolInstance.iconCollisionFeature, iconScale, layout.iconIgnorePlacement);
-            if (iconScale < collisionTile.maxScale) {
-                addSymbols(
-                    bucket->icon, symbolInstance.iconQuads, iconScale,
-                    layout.iconKeepUpright, iconPlacement, collisionTile.config.angle);
-            }
+            updateOpacity(symbolInstance.iconOpacity, iconScale < collisionTile.maxScale, iconScale);
+            addSymbols(
+                bucket->icon, symbolInstance.iconQuads, symbolInstance.iconOpacity,
+                layout.iconKeepUpright, iconPlacement, collisionTile.config.angle);
         }
     }
 
@@ -416,77 +494,88 @@ std::unique_ptr<SymbolBucket> SymbolLayout::place(CollisionTile& collisionTile)
     return bucket;
 }
 
-template <typename Buffer>
-void SymbolLayout::addSymbols(Buffer &buffer, const SymbolQuads &symbols, float scale, const bool keepUpright, const style::SymbolPlacementType placement, const float placementAngle) {
-
-    const float placementZoom = ::fmax(std::log(scale) / std::log(2) + zoom, 0);
-
+void SymbolLayout::addQuads(SymbolBucket::Quads &quads, const SymbolQuads &symbols) {
     for (const auto& symbol : symbols) {
         const auto &tl = symbol.tl;
         const auto &tr = symbol.tr;
         const auto &bl = symbol.bl;
         const auto &br = symbol.br;
         const auto &tex = symbol.tex;
-
-        float minZoom =
-            util::max(static_cast<float>(zoom + log(symbol.minScale) / log(2)), placementZoom);
-        float maxZoom = util::min(static_cast<float>(zoom + log(symbol.maxScale) / log(2)), 25.0f);
         const auto &anchorPoint = symbol.anchorPoint;
 
-        // drop upside down versions of glyphs
-        const float a = std::fmod(symbol.anchorAngle + placementAngle + M_PI, M_PI * 2);
-        if (keepUpright && placement == style::SymbolPlacementType::Line &&
-            (a <= M_PI / 2 || a > M_PI * 3 / 2)) {
-            continue;
-        }
-
-        if (maxZoom <= minZoom)
-            continue;
-
-        // Lower min zoom so that while fading out the label
-        // it can be shown outside of collision-free zoom levels
-        if (minZoom == placementZoom) {
-            minZoom = 0;
-        }
-
         const int glyph_vertex_length = 4;
 
-        if (buffer.groups.empty() || buffer.groups.back().vertexLength + glyph_vertex_length > 65535) {
+        if (quads.groups.empty() || quads.groups.back().vertexLength + glyph_vertex_length > 65535) {
             // Move to a new group because the old one can't hold the geometry.
-            buffer.groups.emplace_back();
+            quads.groups.emplace_back();
         }
 
         // We're generating triangle fans, so we always start with the first
         // coordinate in this polygon.
-        auto& group = buffer.groups.back();
+        auto& group = quads.groups.back();
         size_t index = group.vertexLength;
 
-        // Encode angle of glyph
-        uint8_t glyphAngle = std::round((symbol.glyphAngle / (M_PI * 2)) * 256);
-
         // coordinates (2 triangles)
-        buffer.vertices.emplace_back(anchorPoint.x, anchorPoint.y, tl.x, tl.y, tex.x, tex.y, minZoom,
-                            maxZoom, placementZoom, glyphAngle);
-        buffer.vertices.emplace_back(anchorPoint.x, anchorPoint.y, tr.x, tr.y, tex.x + tex.w, tex.y,
-                            minZoom, maxZoom, placementZoom, glyphAngle);
-        buffer.vertices.emplace_back(anchorPoint.x, anchorPoint.y, bl.x, bl.y, tex.x, tex.y + tex.h,
-                            minZoom, maxZoom, placementZoom, glyphAngle);
-        buffer.vertices.emplace_back(anchorPoint.x, anchorPoint.y, br.x, br.y, tex.x + tex.w, tex.y + tex.h,
-                            minZoom, maxZoom, placementZoom, glyphAngle);
+        quads.vertices.emplace_back(anchorPoint.x, anchorPoint.y, tl.x, tl.y, tex.x, tex.y);
+        quads.vertices.emplace_back(anchorPoint.x, anchorPoint.y, tr.x, tr.y, tex.x + tex.w, tex.y);
+        quads.vertices.emplace_back(anchorPoint.x, anchorPoint.y, bl.x, bl.y, tex.x, tex.y + tex.h);
+        quads.vertices.emplace_back(anchorPoint.x, anchorPoint.y, br.x, br.y, tex.x + tex.w, tex.y + tex.h);
 
         // add the two triangles, referencing the four coordinates we just inserted.
-        buffer.triangles.emplace_back(static_cast<uint16_t>(index + 0),
-                                      static_cast<uint16_t>(index + 1),
-                                      static_cast<uint16_t>(index + 2));
-        buffer.triangles.emplace_back(static_cast<uint16_t>(index + 1),
-                                      static_cast<uint16_t>(index + 2),
-                                      static_cast<uint16_t>(index + 3));
+        quads.triangles.emplace_back(static_cast<uint16_t>(index + 0),
+                                     static_cast<uint16_t>(index + 1),
+                                     static_cast<uint16_t>(index + 2));
+        quads.triangles.emplace_back(static_cast<uint16_t>(index + 1),
+                                     static_cast<uint16_t>(index + 2),
+                                     static_cast<uint16_t>(index + 3));
 
         group.vertexLength += glyph_vertex_length;
         group.indexLength += 2;
     }
 }
 
+template <typename Buffer>
+void SymbolLayout::addSymbols(Buffer &buffer, const SymbolQuads &symbols, const SymbolOpacity &opacity, const bool keepUpright, const style::SymbolPlacementType placement, const float placementAngle) {
+
+    // Symbols that aren't placed anymore are shown as they were until they've faded out.
+    const bool shown = opacity.placed || opacity.opacity > 0;
+    const float placementZoom = ::fmax(std::log(opacity.placementScale) / std::log(2) + zoom, 0);
+
+    for (const auto& symbol : symbols) {
+        float minZoom =
+            util::max(static_cast<float>(zoom + log(symbol.minScale) / log(2)), placementZoom);
+        float maxZoom = util::min(static_cast<float>(zoom + log(symbol.maxScale) / log(2)), 25.0f);
+
+        // Encode angle of glyph
+        uint8_t glyphAngle = std::round((symbol.glyphAngle / (M_PI * 2)) * 256);
+
+        // hide upside down versions of glyphs
+        const float a = std::fmod(symbol.anchorAngle + placementAngle + M_PI, M_PI * 2);
+        const bool upsideDown = keepUpright && placement == style::SymbolPlacementType::Line &&
+            (a <= M_PI / 2 || a > M_PI * 3 / 2);
+
+        if (!shown || upsideDown || maxZoom <= minZoom) {
+            for (int i = 0; i < 4; i++) {
+                buffer.placementVertices.push_back(SymbolPlacementVertex::hidden(glyphAngle));
+            }
+            continue;
+        }
+
+        // Lower min zoom so that while fading out the label
+        // it can be shown outside of collision-free zoom levels
+        if (minZoom == placementZoom) {
+            minZoom = 0;
+        }
+
+        // one for each corner
+        for (int i = 0; i < 4; i++) {
+            buffer.placementVertices.emplace_back(minZoom, maxZoom, placementZoom, glyphAngle,
+                                                  opacity.opacity, opacity.placed);
+        }
+        buffer.placed = true;
+    }
+}
+
 void SymbolLayout::addToDebugBuffers(CollisionTile& collisionTile, SymbolBucket& bucket) {
 
     if (!hasSymbolInstances()) {
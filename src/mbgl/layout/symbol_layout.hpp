@@ -4,9 +4,13 @@
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/layout/symbol_feature.hpp>
 #include <mbgl/layout/symbol_instance.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <memory>
 #include <map>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -16,7 +20,6 @@ class GeometryTileLayer;
 class CollisionTile;
 class SpriteAtlas;
 class GlyphAtlas;
-class SymbolBucket;
 
 namespace style {
 class Filter;
@@ -48,8 +51,7 @@ public:
 
     enum State {
         Pending,  // Waiting for the necessary glyphs or icons to be available.
-        Prepared, // The potential positions of text and icons have been determined.
-        Placed    // The final positions have been determined, taking into account prior layers.
+        Prepared  // The potential positions of text and icons have been determined.
     };
 
     State state = Pending;
@@ -69,9 +71,12 @@ private:
 
     void addToDebugBuffers(CollisionTile&, SymbolBucket&);
 
-    // Adds placed items to the buffer.
+    static void addQuads(SymbolBucket::Quads&, const SymbolQuads&);
+
+    // Adds the zoom levels at which each of the quads is shown to the buffer, along with the
+    // opacity of its item, which hides those of items that aren't placed and have faded out.
     template <typename Buffer>
-    void addSymbols(Buffer&, const SymbolQuads&, float scale,
+    void addSymbols(Buffer&, const SymbolQuads&, const SymbolOpacity&,
                     const bool keepUpright, const style::SymbolPlacementType, const float placementAngle);
 
     const float overscaling;
@@ -90,6 +95,13 @@ private:
 
     GlyphRangeSet ranges;
     std::vector<SymbolInstance> symbolInstances;
+
+    // Placement modifies the symbol instances. A layout is normally placed by one actor at a time,
+    // but may briefly be shared while its tile joins or leaves cross-tile placement.
+    std::mutex placementMutex;
+    std::shared_ptr<const SymbolBucket::Quads> textQuads;
+    std::shared_ptr<const SymbolBucket::Quads> iconQuads;
+    optional<TimePoint> lastPlacementTime;
     std::vector<SymbolFeature> features;
 };
 
@@ -12,18 +12,28 @@
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/style/query_parameters.hpp>
 #include <mbgl/renderer/painter.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/tile/tile_trace.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/projection.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/math/wrap.hpp>
 #include <mbgl/util/exception.hpp>
 #include <mbgl/util/async_task.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/startup_trace.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/actor/statistics.hpp>
 #include <mbgl/platform/log.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <limits>
+
 namespace mbgl {
 
 using namespace style;
@@ -34,6 +44,33 @@ enum class RenderState : uint8_t {
     Fully,
 };
 
+namespace {
+
+// Camera motion that adaptive quality considers fast: screen pixels, zoom levels and radians per
+// second. See Map::setAdaptiveQuality().
+constexpr double ADAPTIVE_QUALITY_PAN_SPEED = 1000;
+constexpr double ADAPTIVE_QUALITY_ZOOM_SPEED = 2;
+constexpr double ADAPTIVE_QUALITY_ROTATION_SPEED = M_PI;
+
+// Rendering a frame for longer than this drops frames on a 60 Hz display.
+constexpr Duration ADAPTIVE_QUALITY_FRAME_DURATION = std::chrono::microseconds(16667);
+
+// The lowest render scale, which is also kept from rendering fewer pixels than the map has points.
+constexpr float ADAPTIVE_QUALITY_RENDER_SCALE = 0.5f;
+
+// Interleaves the bits of both coordinates, so that points near each other mostly sort near each
+// other.
+uint64_t mortonCode(uint32_t x, uint32_t y) {
+    uint64_t code = 0;
+    for (uint32_t bit = 0; bit < 32; ++bit) {
+        code |= uint64_t((x >> bit) & 1) << (2 * bit);
+        code |= uint64_t((y >> bit) & 1) << (2 * bit + 1);
+    }
+    return code;
+}
+
+} // namespace
+
 class Map::Impl : public style::Observer {
 public:
     Impl(View&, FileSource&, Scheduler&, MapMode, GLContextMode, ConstrainMode, ViewportMode);
@@ -46,8 +83,12 @@ public:
 
     void update();
     void render();
+    void updateAdaptiveQuality();
 
     void loadStyleJSON(const std::string&);
+    void queryRenderedFeatures(const ScreenLineString&, const RenderedQueryOptions&, const RenderedFeatureVisitor&);
+    void renderNextStill();
+    void renderStillRows(FrameData);
 
     View& view;
     FileSource& fileSource;
@@ -61,6 +102,26 @@ public:
     const float pixelRatio;
 
     MapDebugOptions debugOptions { MapDebugOptions::NoDebug };
+    bool crossTilePlacement = false;
+    bool tileLevelOfDetail = false;
+    bool predictiveTilePrefetch = false;
+    bool parentTilePrefetch = false;
+    Duration uploadBudget = Milliseconds(4);
+    bool adaptiveQuality = false;
+    bool frameStats = false;
+    std::string programCachePath;
+    std::string glyphHistoryPath;
+    std::shared_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+
+    // While adaptive quality is enabled, whether frames are rendered at reduced quality, and the
+    // camera and the painter's frame duration it is decided on.
+    bool reducedQuality = false;
+    Duration averageFrameDuration = Duration::zero();
+    optional<TimePoint> lastFrameTime;
+    LatLng lastCenter;
+    double lastZoom = 0;
+    double lastAngle = 0;
+    double lastPitch = 0;
 
     Update updateFlags = Update::Nothing;
     util::AsyncTask asyncUpdate;
@@ -76,7 +137,20 @@ public:
     std::unique_ptr<AsyncRequest> styleRequest;
 
     Map::StillImageCallback callback;
+
+    // The cameras of the batch that are yet to be rendered, with their index; see renderStills().
+    std::deque<std::pair<std::size_t, CameraOptions>> stillCameras;
+    Map::StillImageBatchCallback stillBatchCallback;
+
+    // The size of the still image that's rendered in parts, in framebuffer pixels, and the callback
+    // that takes its rows; see renderStillTiled().
+    std::array<uint16_t, 2> stillRowsSize = {{ 0, 0 }};
+    Map::StillImageRowsCallback stillRowsCallback;
+
     size_t sourceCacheSize;
+    size_t sourceCacheBytes = std::numeric_limits<size_t>::max();
+    size_t tileMemoryBudget = std::numeric_limits<size_t>::max();
+    size_t lowMemoryTileTarget = 0;
     TimePoint timePoint;
     bool loading = false;
 };
@@ -132,7 +206,7 @@ void Map::renderStill(StillImageCallback callback) {
         return;
     }
 
-    if (impl->callback) {
+    if (impl->callback || impl->stillBatchCallback || impl->stillRowsCallback) {
         callback(std::make_exception_ptr(util::MisuseException("Map is currently rendering an image")), {});
         return;
     }
@@ -152,6 +226,169 @@ void Map::renderStill(StillImageCallback callback) {
     impl->asyncUpdate.send();
 }
 
+void Map::renderStills(const std::vector<CameraOptions>& cameras, StillImageBatchCallback callback) {
+    if (!callback) {
+        Log::Error(Event::General, "StillImageBatchCallback not set");
+        return;
+    }
+
+    auto fail = [&](std::exception_ptr error) {
+        for (std::size_t i = 0; i < cameras.size(); ++i) {
+            callback(i, error, {});
+        }
+    };
+
+    if (impl->mode != MapMode::Still) {
+        fail(std::make_exception_ptr(util::MisuseException("Map is not in still image render mode")));
+        return;
+    }
+
+    if (impl->callback || impl->stillBatchCallback || impl->stillRowsCallback) {
+        fail(std::make_exception_ptr(util::MisuseException("Map is currently rendering an image")));
+        return;
+    }
+
+    if (!impl->style) {
+        fail(std::make_exception_ptr(util::MisuseException("Map doesn't have a style")));
+        return;
+    }
+
+    if (impl->style->getLastError()) {
+        fail(impl->style->getLastError());
+        return;
+    }
+
+    if (cameras.empty()) {
+        return;
+    }
+
+    // Cameras at the same zoom level that are near each other need mostly the same tiles, which
+    // stay loaded while they're rendered one after the other.
+    const uint32_t size = 1u << 16;
+    std::vector<std::pair<std::pair<int32_t, uint64_t>, std::size_t>> order;
+    order.reserve(cameras.size());
+    for (std::size_t i = 0; i < cameras.size(); ++i) {
+        const CameraOptions& camera = cameras[i];
+        const LatLng center = camera.center ? camera.center->wrapped() : impl->transform.getLatLng();
+        const double zoom = camera.zoom ? *camera.zoom : impl->transform.getZoom();
+        const TileCoordinatePoint point = TileCoordinate::fromLatLng(16, center).p;
+        const uint32_t x = static_cast<uint32_t>(util::clamp<double>(point.x, 0, size - 1));
+        const uint32_t y = static_cast<uint32_t>(util::clamp<double>(point.y, 0, size - 1));
+        order.push_back({ { static_cast<int32_t>(std::floor(zoom)), mortonCode(x, y) }, i });
+    }
+    std::sort(order.begin(), order.end());
+
+    for (const auto& entry : order) {
+        impl->stillCameras.emplace_back(entry.second, cameras[entry.second]);
+    }
+    impl->stillBatchCallback = std::move(callback);
+    impl->renderNextStill();
+}
+
+void Map::renderStillTiled(std::array<uint16_t, 2> size, StillImageRowsCallback callback) {
+    if (!callback) {
+        Log::Error(Event::General, "StillImageRowsCallback not set");
+        return;
+    }
+
+    if (impl->mode != MapMode::Still) {
+        callback(std::make_exception_ptr(util::MisuseException("Map is not in still image render mode")), 0, {});
+        return;
+    }
+
+    if (impl->callback || impl->stillBatchCallback || impl->stillRowsCallback) {
+        callback(std::make_exception_ptr(util::MisuseException("Map is currently rendering an image")), 0, {});
+        return;
+    }
+
+    if (!impl->style) {
+        callback(std::make_exception_ptr(util::MisuseException("Map doesn't have a style")), 0, {});
+        return;
+    }
+
+    if (impl->style->getLastError()) {
+        callback(impl->style->getLastError(), 0, {});
+        return;
+    }
+
+    const double maxSize = std::numeric_limits<uint16_t>::max();
+    if (!size[0] || !size[1] || size[0] * impl->pixelRatio > maxSize || size[1] * impl->pixelRatio > maxSize) {
+        callback(std::make_exception_ptr(util::MisuseException("Still image size is out of range")), 0, {});
+        return;
+    }
+
+    // The tiles are loaded for the whole image, and the parts of it are rendered one after the
+    // other once they are; see Impl::renderStillRows().
+    impl->transform.resize(size);
+    impl->stillRowsSize = {{ static_cast<uint16_t>(size[0] * impl->pixelRatio),
+                             static_cast<uint16_t>(size[1] * impl->pixelRatio) }};
+    impl->stillRowsCallback = std::move(callback);
+
+    // Only reports the errors that occur before the image is rendered.
+    impl->callback = [this] (std::exception_ptr error, PremultipliedImage&&) {
+        Map::StillImageRowsCallback done = std::move(impl->stillRowsCallback);
+        impl->stillRowsCallback = nullptr;
+        impl->transform.resize(impl->view.getSize());
+        done(error, 0, {});
+    };
+    impl->updateFlags |= Update::RecalculateStyle | Update::RenderStill;
+    impl->asyncUpdate.send();
+}
+
+void Map::Impl::renderStillRows(FrameData frameData) {
+    const std::array<uint16_t, 2> size = stillRowsSize;
+    frameData.imageSize = size;
+
+    for (uint32_t top = 0; top < size[1]; top += frameData.framebufferSize[1]) {
+        const uint16_t height = std::min<uint32_t>(frameData.framebufferSize[1], size[1] - top);
+        PremultipliedImage rows { size[0], height };
+
+        for (uint32_t left = 0; left < size[0]; left += frameData.framebufferSize[0]) {
+            const uint16_t width = std::min<uint32_t>(frameData.framebufferSize[0], size[0] - left);
+            frameData.imageOffset = {{ static_cast<uint16_t>(left), static_cast<uint16_t>(top) }};
+
+            painter->render(*style, frameData, annotationManager->getSpriteAtlas());
+
+            // The parts at the right and bottom edges overhang the image.
+            const PremultipliedImage part = view.readStillImage();
+            for (uint16_t row = 0; row < height; ++row) {
+                std::memcpy(rows.data.get() + row * rows.stride() + left * 4,
+                            part.data.get() + row * part.stride(),
+                            width * 4);
+            }
+        }
+
+        if (top + height < size[1]) {
+            stillRowsCallback(nullptr, top, std::move(rows));
+        } else {
+            // The callback may start rendering another image once this one is done.
+            Map::StillImageRowsCallback done = std::move(stillRowsCallback);
+            stillRowsCallback = nullptr;
+            transform.resize(view.getSize());
+            done(nullptr, top, std::move(rows));
+        }
+    }
+}
+
+void Map::Impl::renderNextStill() {
+    const std::size_t index = stillCameras.front().first;
+    transform.jumpTo(stillCameras.front().second);
+    stillCameras.pop_front();
+
+    callback = [this, index] (std::exception_ptr error, PremultipliedImage&& image) {
+        // The batch's callback may start another batch once this one is done.
+        Map::StillImageBatchCallback batchCallback = stillBatchCallback;
+        if (stillCameras.empty()) {
+            stillBatchCallback = nullptr;
+        } else {
+            renderNextStill();
+        }
+        batchCallback(index, error, std::move(image));
+    };
+    updateFlags |= Update::RecalculateStyle | Update::RenderStill;
+    asyncUpdate.send();
+}
+
 void Map::update(Update flags) {
     impl->onUpdate(flags);
 }
@@ -236,8 +473,22 @@ void Map::Impl::update() {
                                        mode,
                                        *annotationManager,
                                        *style);
+    parameters.crossTilePlacement = crossTilePlacement;
+    parameters.tileLevelOfDetail = tileLevelOfDetail;
+    parameters.prefetchParents = parentTilePrefetch;
+    if (predictiveTilePrefetch) {
+        parameters.prefetchStates = transform.getUpcomingStates();
+    }
+    parameters.deferPlacement = reducedQuality;
+    parameters.cameraMoving = transform.inTransition() || transform.isGestureInProgress();
 
     style->updateTiles(parameters);
+    if (tileMemoryBudget != std::numeric_limits<size_t>::max()) {
+        style->reduceTileMemoryUsage(tileMemoryBudget, transform.getState());
+    }
+
+    // Cleared before rendering a still image, whose callback may request the next one.
+    updateFlags = Update::Nothing;
 
     if (mode == MapMode::Continuous) {
         view.invalidate();
@@ -246,29 +497,54 @@ void Map::Impl::update() {
         render();
         view.deactivate();
     }
-
-    updateFlags = Update::Nothing;
 }
 
 void Map::Impl::render() {
+    const TimePoint begin = Clock::now();
     if (!painter) {
-        painter = std::make_unique<Painter>(transform.getState());
+        // Compiles the shader programs, or loads them from the program cache.
+        StartupTrace::Scope trace("programs");
+        painter = std::make_unique<Painter>(transform.getState(), programCachePath);
     }
 
+    updateAdaptiveQuality();
+
     FrameData frameData { view.getFramebufferSize(),
                           timePoint,
                           pixelRatio,
                           mode,
                           contextMode,
-                          debugOptions };
+                          debugOptions,
+                          reducedQuality ? Duration::zero() : uploadBudget };
+    if (reducedQuality) {
+        frameData.renderScale = std::max(ADAPTIVE_QUALITY_RENDER_SCALE, 1.0f / pixelRatio);
+    }
+    frameData.frameStats = frameStats;
+
+    // Decided before rendering, since the callbacks of the image may start rendering another one.
+    const bool stillRows = mode == MapMode::Still && stillRowsCallback;
+    if (stillRows) {
+        callback = nullptr;
+        renderStillRows(frameData);
+    } else {
+        painter->render(*style,
+                        frameData,
+                        annotationManager->getSpriteAtlas());
+    }
 
-    painter->render(*style,
-                    frameData,
-                    annotationManager->getSpriteAtlas());
+    if (StartupTrace::isEnabled() && style->isLoaded()) {
+        StartupTrace::frame(begin, Clock::now());
+    }
 
-    if (mode == MapMode::Still) {
-        callback(nullptr, view.readStillImage());
+    const Duration frameDuration = painter->getFrameDuration();
+    averageFrameDuration = averageFrameDuration == Duration::zero()
+        ? frameDuration
+        : (averageFrameDuration * 3 + frameDuration) / 4;
+
+    if (mode == MapMode::Still && !stillRows) {
+        Map::StillImageCallback done = std::move(callback);
         callback = nullptr;
+        done(nullptr, view.readStillImage());
     }
 
     painter->cleanup();
@@ -276,7 +552,48 @@ void Map::Impl::render() {
     if (style->hasTransitions()) {
         updateFlags |= Update::RecalculateStyle;
         asyncUpdate.send();
-    } else if (painter->needsAnimation()) {
+    } else if (painter->needsAnimation() || reducedQuality) {
+        // At reduced quality, another frame tells whether the camera stopped.
+        updateFlags |= Update::Repaint;
+        asyncUpdate.send();
+    }
+}
+
+void Map::Impl::updateAdaptiveQuality() {
+    const TransformState& state = transform.getState();
+    const TimePoint now = Clock::now();
+
+    bool moving = false;
+    bool fast = false;
+    if (lastFrameTime) {
+        const double pan = util::dist<double>(Projection::project(lastCenter, state.getScale()),
+                                              Projection::project(state.getLatLng(), state.getScale()));
+        const double zoom = std::abs(state.getZoom() - lastZoom);
+        const double rotation = std::abs(util::wrap(state.getAngle() - lastAngle, -M_PI, M_PI)) +
+                                std::abs(state.getPitch() - lastPitch);
+        const double seconds = std::chrono::duration<double>(now - *lastFrameTime).count();
+
+        moving = pan > 0 || zoom > 0 || rotation > 0;
+        fast = seconds > 0 && (pan / seconds > ADAPTIVE_QUALITY_PAN_SPEED ||
+                               zoom / seconds > ADAPTIVE_QUALITY_ZOOM_SPEED ||
+                               rotation / seconds > ADAPTIVE_QUALITY_ROTATION_SPEED);
+    }
+
+    lastFrameTime = now;
+    lastCenter = state.getLatLng();
+    lastZoom = state.getZoom();
+    lastAngle = state.getAngle();
+    lastPitch = state.getPitch();
+
+    if (!adaptiveQuality || mode != MapMode::Continuous) {
+        reducedQuality = false;
+    } else if (!reducedQuality) {
+        // Frames at reduced quality render faster, so only the camera decides when to return.
+        reducedQuality = fast && averageFrameDuration > ADAPTIVE_QUALITY_FRAME_DURATION;
+    } else if (!moving) {
+        // This frame is rendered at full quality already; the next update places the symbols for
+        // where the camera stopped.
+        reducedQuality = false;
         updateFlags |= Update::Repaint;
         asyncUpdate.send();
     }
@@ -300,7 +617,8 @@ void Map::setStyleURL(const std::string& url) {
 
     impl->style = std::make_unique<Style>(impl->fileSource, impl->pixelRatio);
 
-    impl->styleRequest = impl->fileSource.request(Resource::style(impl->styleURL), [this](Response res) {
+    const TimePoint begin = Clock::now();
+    impl->styleRequest = impl->fileSource.request(Resource::style(impl->styleURL), [this, begin](Response res) {
         // Once we get a fresh style, or the style is mutated, stop revalidating.
         if (res.isFresh() || impl->styleMutated) {
             impl->styleRequest.reset();
@@ -323,6 +641,8 @@ void Map::setStyleURL(const std::string& url) {
         } else if (res.notModified || res.noContent) {
             return;
         } else {
+            // The cache database is opened before the file source answers its first request.
+            StartupTrace::record("style request", begin, Clock::now(), { "database" });
             impl->loadStyleJSON(*res.data);
         }
     });
@@ -337,6 +657,20 @@ void Map::setStyleJSON(const std::string& json) {
 
     impl->view.notifyMapChange(MapChangeWillStartLoadingMap);
 
+    // A style that was loaded from JSON and wasn't mutated since is updated in place, keeping the
+    // tiles of the sources that stay the same, e.g. when switching between day and night themes.
+    if (impl->style && impl->style->loaded && !impl->styleMutated && !impl->styleJSON.empty()) {
+        if (impl->style->updateJSON(json, &impl->scheduler)) {
+            impl->styleRequest = nullptr;
+            impl->styleURL.clear();
+            impl->styleJSON = json;
+
+            impl->updateFlags |= Update::Classes | Update::RecalculateStyle | Update::Layout | Update::AnnotationStyle;
+            impl->asyncUpdate.send();
+            return;
+        }
+    }
+
     impl->styleURL.clear();
     impl->styleJSON.clear();
     impl->styleMutated = false;
@@ -348,7 +682,14 @@ void Map::setStyleJSON(const std::string& json) {
 
 void Map::Impl::loadStyleJSON(const std::string& json) {
     style->setObserver(this);
-    style->setJSON(json);
+    if (!glyphHistoryPath.empty()) {
+        style->glyphAtlas->setHistoryPath(glyphHistoryPath + ".glyphs");
+    }
+    style->glyphAtlas->setLocalGlyphRasterizer(localGlyphRasterizer);
+    {
+        StartupTrace::Scope trace("style parse", { "style request" });
+        style->setJSON(json, &scheduler);
+    }
     styleJSON = json;
 
     // force style cascade, causing all pending transitions to complete.
@@ -721,13 +1062,42 @@ void Map::removeAnnotation(AnnotationID annotation) {
     update(Update::AnnotationStyle | Update::AnnotationData);
 }
 
+AnnotationIDs Map::addAnnotations(const std::vector<Annotation>& annotations) {
+    auto result = impl->annotationManager->addAnnotations(annotations, getMaxZoom());
+    update(Update::AnnotationStyle | Update::AnnotationData);
+    return result;
+}
+
+void Map::removeAnnotations(const AnnotationIDs& annotations) {
+    impl->annotationManager->removeAnnotations(annotations);
+    update(Update::AnnotationStyle | Update::AnnotationData);
+}
+
 #pragma mark - Feature query api
 
+namespace {
+
+ScreenLineString toLineString(const ScreenCoordinate& point) {
+    return { point };
+}
+
+ScreenLineString toLineString(const ScreenBox& box) {
+    return {
+        box.min,
+        { box.max.x, box.min.y },
+        box.max,
+        { box.min.x, box.max.y },
+        box.min
+    };
+}
+
+} // namespace
+
 std::vector<Feature> Map::queryRenderedFeatures(const ScreenCoordinate& point, const optional<std::vector<std::string>>& layerIDs) {
     if (!impl->style) return {};
 
     return impl->style->queryRenderedFeatures({
-        { point },
+        toLineString(point),
         impl->transform.getState(),
         layerIDs
     });
@@ -737,22 +1107,61 @@ std::vector<Feature> Map::queryRenderedFeatures(const ScreenBox& box, const opti
     if (!impl->style) return {};
 
     return impl->style->queryRenderedFeatures({
-        {
-            box.min,
-            { box.max.x, box.min.y },
-            box.max,
-            { box.min.x, box.max.y },
-            box.min
-        },
+        toLineString(box),
         impl->transform.getState(),
         layerIDs
     });
 }
 
+void Map::queryRenderedFeatures(const ScreenCoordinate& point, const RenderedQueryOptions& options, const RenderedFeatureVisitor& visitor) {
+    impl->queryRenderedFeatures(toLineString(point), options, visitor);
+}
+
+void Map::queryRenderedFeatures(const ScreenBox& box, const RenderedQueryOptions& options, const RenderedFeatureVisitor& visitor) {
+    impl->queryRenderedFeatures(toLineString(box), options, visitor);
+}
+
+std::vector<RenderedFeatureID> Map::queryRenderedFeatureIDs(const ScreenBox& box, const RenderedQueryOptions& options) {
+    std::vector<RenderedFeatureID> result;
+    queryRenderedFeatures(box, options, [&] (const RenderedFeature& feature) {
+        result.push_back({ feature.getLayerID(), feature.getID() });
+        return true;
+    });
+    return result;
+}
+
+void Map::Impl::queryRenderedFeatures(const ScreenLineString& geometry, const RenderedQueryOptions& options, const RenderedFeatureVisitor& visitor) {
+    if (!style || (options.limit && *options.limit == 0)) return;
+
+    std::size_t visited = 0;
+    style->queryRenderedFeatures({ geometry, transform.getState(), options.layerIDs }, [&] (const RenderedFeature& feature) {
+        return visitor(feature) && (!options.limit || ++visited < *options.limit);
+    });
+}
+
+std::vector<Feature> Map::querySourceFeatures(const std::string& sourceID,
+                                              const std::string& sourceLayer,
+                                              const style::Filter& filter) {
+    if (!impl->style) return {};
+    return impl->style->querySourceFeatures(sourceID, sourceLayer, filter, impl->scheduler);
+}
+
+optional<Feature> Map::queryPickedFeature(const ScreenCoordinate& point) {
+    if (!impl->style || !impl->painter) return {};
+
+    impl->view.activate();
+    const auto picked = impl->painter->readPickedFeature(point);
+    impl->view.deactivate();
+
+    if (!picked) return {};
+    return impl->style->queryPickedFeature(picked->layerID, picked->tileID, picked->id);
+}
+
 AnnotationIDs Map::queryPointAnnotations(const ScreenBox& box) {
-    auto features = queryRenderedFeatures(box, {{ AnnotationManager::PointLayerID }});
+    RenderedQueryOptions options;
+    options.layerIDs = {{ AnnotationManager::PointLayerID }};
     std::set<AnnotationID> set;
-    for (auto &feature : features) {
+    for (auto& feature : queryRenderedFeatureIDs(box, options)) {
         assert(feature.id);
         assert(*feature.id <= std::numeric_limits<AnnotationID>::max());
         set.insert(static_cast<AnnotationID>(feature.id->get<uint64_t>()));
@@ -765,6 +1174,16 @@ AnnotationIDs Map::queryPointAnnotations(const ScreenBox& box) {
 
 #pragma mark - Style API
 
+void Map::setFeatureState(const std::string& sourceID, const FeatureIdentifier& id, const optional<Color>& color) {
+    if (impl->style && impl->style->setFeatureState(sourceID, id, color)) {
+        update(Update::Repaint);
+    }
+}
+
+optional<Color> Map::getFeatureState(const std::string& sourceID, const FeatureIdentifier& id) const {
+    return impl->style ? impl->style->getFeatureState(sourceID, id) : optional<Color>();
+}
+
 style::Source* Map::getSource(const std::string& sourceID) {
     if (impl->style) {
         impl->styleMutated = true;
@@ -919,6 +1338,117 @@ MapDebugOptions Map::getDebug() const {
     return impl->debugOptions;
 }
 
+void Map::setCrossTilePlacement(bool enabled) {
+    if (enabled != impl->crossTilePlacement) {
+        impl->crossTilePlacement = enabled;
+        update(Update::Repaint);
+    }
+}
+
+bool Map::getCrossTilePlacement() const {
+    return impl->crossTilePlacement;
+}
+
+void Map::setTileLevelOfDetail(bool enabled) {
+    if (enabled != impl->tileLevelOfDetail) {
+        impl->tileLevelOfDetail = enabled;
+        update(Update::Repaint);
+    }
+}
+
+bool Map::getTileLevelOfDetail() const {
+    return impl->tileLevelOfDetail;
+}
+
+void Map::setPredictiveTilePrefetch(bool enabled) {
+    if (enabled != impl->predictiveTilePrefetch) {
+        impl->predictiveTilePrefetch = enabled;
+        update(Update::Repaint);
+    }
+}
+
+bool Map::getPredictiveTilePrefetch() const {
+    return impl->predictiveTilePrefetch;
+}
+
+void Map::setParentTilePrefetch(bool enabled) {
+    if (enabled != impl->parentTilePrefetch) {
+        impl->parentTilePrefetch = enabled;
+        update(Update::Repaint);
+    }
+}
+
+bool Map::getParentTilePrefetch() const {
+    return impl->parentTilePrefetch;
+}
+
+void Map::setFrameUploadBudget(Duration budget) {
+    impl->uploadBudget = budget;
+}
+
+Duration Map::getFrameUploadBudget() const {
+    return impl->uploadBudget;
+}
+
+void Map::setAdaptiveQuality(bool enabled) {
+    if (enabled != impl->adaptiveQuality) {
+        impl->adaptiveQuality = enabled;
+        update(Update::Repaint);
+    }
+}
+
+bool Map::getAdaptiveQuality() const {
+    return impl->adaptiveQuality;
+}
+
+void Map::setFrameStatsEnabled(bool enabled) {
+    impl->frameStats = enabled;
+}
+
+bool Map::getFrameStatsEnabled() const {
+    return impl->frameStats;
+}
+
+FrameStats Map::getFrameStats() const {
+    return impl->painter ? impl->painter->getFrameStats() : FrameStats();
+}
+
+void Map::setTileTracingEnabled(bool enabled) {
+    TileTrace::setEnabled(enabled);
+}
+
+bool Map::getTileTracingEnabled() {
+    return TileTrace::isEnabled();
+}
+
+std::string Map::takeTileTrace() {
+    return TileTrace::take();
+}
+
+void Map::setStartupTracingEnabled(bool enabled) {
+    StartupTrace::setEnabled(enabled);
+}
+
+bool Map::getStartupTracingEnabled() {
+    return StartupTrace::isEnabled();
+}
+
+std::string Map::getStartupReport() {
+    return StartupTrace::report();
+}
+
+void Map::setProgramCachePath(const std::string& path) {
+    impl->programCachePath = path;
+}
+
+void Map::setGlyphHistoryPath(const std::string& path) {
+    impl->glyphHistoryPath = path;
+}
+
+void Map::setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer> rasterizer) {
+    impl->localGlyphRasterizer = std::move(rasterizer);
+}
+
 bool Map::isFullyLoaded() const {
     return impl->style ? impl->style->isLoaded() : false;
 }
@@ -975,12 +1505,54 @@ void Map::setSourceTileCacheSize(size_t size) {
     }
 }
 
+void Map::setSourceTileCacheBytes(size_t bytes) {
+    if (bytes != impl->sourceCacheBytes) {
+        impl->sourceCacheBytes = bytes;
+        if (!impl->style) return;
+        impl->style->setSourceTileCacheBytes(bytes);
+        impl->view.invalidate();
+    }
+}
+
+size_t Map::getTileMemoryUsage() const {
+    return impl->style ? impl->style->getTileMemoryUsage().total() : 0;
+}
+
+MemoryReport Map::getMemoryReport() const {
+    MemoryReport report;
+    if (impl->style) {
+        impl->style->reportMemoryUsage(report);
+    }
+    report.annotations = impl->annotationManager->getMemoryUsage();
+    report.fileSource.cpu = impl->fileSource.getMemoryUsage();
+    return report;
+}
+
+void Map::setTileMemoryBudget(size_t bytes) {
+    if (bytes != impl->tileMemoryBudget) {
+        impl->tileMemoryBudget = bytes;
+        update(Update::Repaint);
+    }
+}
+
+size_t Map::getTileMemoryBudget() const {
+    return impl->tileMemoryBudget;
+}
+
+void Map::setLowMemoryTileTarget(size_t bytes) {
+    impl->lowMemoryTileTarget = bytes;
+}
+
+size_t Map::getLowMemoryTileTarget() const {
+    return impl->lowMemoryTileTarget;
+}
+
 void Map::onLowMemory() {
     if (impl->painter) {
         impl->painter->cleanup();
     }
     if (impl->style) {
-        impl->style->onLowMemory();
+        impl->style->reduceTileMemoryUsage(impl->lowMemoryTileTarget, impl->transform.getState());
         impl->view.invalidate();
     }
 }
@@ -1008,8 +1580,9 @@ void Map::Impl::onStyleError() {
 
 void Map::Impl::onResourceError(std::exception_ptr error) {
     if (mode == MapMode::Still && callback) {
-        callback(error, {});
+        Map::StillImageCallback done = std::move(callback);
         callback = nullptr;
+        done(error, {});
     }
 }
 
@@ -1021,7 +1594,23 @@ void Map::dumpDebugLogs() const {
     } else {
         Log::Info(Event::General, "no style loaded");
     }
+    if (impl->painter) {
+        const auto& statistics = impl->painter->getStatistics();
+        Log::Info(Event::General, "Painter::statistics: %zu program switches, %zu texture binds, %zu state changes",
+                  statistics.programSwitches, statistics.textureBinds, statistics.stateChanges);
+        Log::Info(Event::General, "Painter::culledTiles: %zu", impl->painter->getCulledTileCount());
+        Log::Info(Event::General, "Painter::reusedBaseLayers: %s",
+                  impl->painter->getReusedBaseLayers() ? "yes" : "no");
+        Log::Info(Event::General, "Painter::frameDuration: %lld us",
+                  static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                      impl->painter->getFrameDuration()).count()));
+        Log::Info(Event::General, "Map::reducedQuality: %s", impl->reducedQuality ? "yes" : "no");
+    }
     Log::Info(Event::General, "--------------------------------------------------------------------------------");
 }
 
+std::vector<ActorStats> Map::getActorStats() {
+    return actor::Statistics::snapshot();
+}
+
 } // namespace mbgl
@@ -17,6 +17,14 @@
 
 namespace mbgl {
 
+/** The number of samples along an animation's path that tiles are prefetched for, evenly spaced
+    and ending where it lands. */
+static const std::size_t TRANSITION_PATH_SAMPLES = 4;
+
+/** How far ahead a pan is extrapolated at its current velocity, at most one screenful. Pans whose
+    most recent move is older than this have stopped. */
+static const Duration PAN_LOOKAHEAD = Seconds(1);
+
 /** Converts the given angle (in radians) to be numerically close to the anchor angle, allowing it to be interpolated properly without sudden jumps. */
 static double _normalizeAngle(double angle, double anchorAngle)
 {
@@ -139,24 +147,20 @@ void Transform::easeTo(const CameraOptions& camera, const AnimationOptions& anim
     state.scaling = scale != startScale;
     state.rotating = angle != startAngle;
 
-    startTransition(camera, animation, [=](double t) {
-        Point<double> framePoint = util::interpolate(startPoint, endPoint, t);
-        LatLng frameLatLng = Projection::unproject(framePoint, startScale);
-        double frameScale = util::interpolate(startScale, scale, t);
-        state.setLatLngZoom(frameLatLng, state.scaleZoom(frameScale));
-
-        if (angle != startAngle) {
-            state.angle = util::wrap(util::interpolate(startAngle, angle, t), -M_PI, M_PI);
-        }
-        if (pitch != startPitch) {
-            state.pitch = util::interpolate(startPitch, pitch, t);
-        }
-
-        if (padding) {
-            state.moveLatLng(frameLatLng, center);
-        }
-        return update;
-    }, duration);
+    Transition transition_;
+    transition_.curve = Transition::Curve::Ease;
+    transition_.update = update;
+    transition_.startPoint = startPoint;
+    transition_.endPoint = endPoint;
+    transition_.startScale = startScale;
+    transition_.scale = scale;
+    transition_.startAngle = startAngle;
+    transition_.angle = angle;
+    transition_.startPitch = startPitch;
+    transition_.pitch = pitch;
+    transition_.padded = bool(padding);
+    transition_.center = center;
+    startTransition(std::move(transition_), camera, animation, duration);
 }
 
 /** This method implements an “optimal path” animation, as detailed in:
@@ -236,7 +240,7 @@ void Transform::flyTo(const CameraOptions &camera, const AnimationOptions &anima
     /** rᵢ: Returns the zoom-out factor at one end of the animation.
 
         @param i 0 for the ascent or 1 for the descent. */
-    auto r = [=](double i) {
+    auto r = [&](double i) {
         /// bᵢ
         double b = (w1 * w1 - w0 * w0 + (i ? -1 : 1) * rho2 * rho2 * u1 * u1) / (2 * (i ? w1 : w0) * rho2 * u1);
         return std::log(std::sqrt(b * b + 1) - b);
@@ -252,21 +256,6 @@ void Transform::flyTo(const CameraOptions &camera, const AnimationOptions &anima
 
     /// r₀: Zoom-out factor during ascent.
     double r0 = r(0);
-    /** w(s): Returns the visible span on the ground, measured in pixels with
-        respect to the initial scale.
-
-        Assumes an angular field of view of 2 arctan ½ ≈ 53°. */
-    auto w = [=](double s) {
-        return (isClose ? std::exp((w1 < w0 ? -1 : 1) * rho * s)
-                : (std::cosh(r0) / std::cosh(r0 + rho * s)));
-    };
-    /// u(s): Returns the distance along the flight path as projected onto the
-    /// ground plane, measured in pixels from the world image origin at the
-    /// initial scale.
-    auto u = [=](double s) {
-        return (isClose ? 0.
-                : (w0 * (std::cosh(r0) * std::tanh(r0 + rho * s) - std::sinh(r0)) / rho2 / u1));
-    };
     /// S: Total length of the flight path, measured in ρ-screenfuls.
     double S = (isClose ? (std::abs(std::log(w1 / w0)) / rho)
                 : ((r(1) - r0) / rho));
@@ -293,32 +282,28 @@ void Transform::flyTo(const CameraOptions &camera, const AnimationOptions &anima
     state.scaling = true;
     state.rotating = angle != startAngle;
 
-    startTransition(camera, animation, [=](double k) {
-        /// s: The distance traveled along the flight path, measured in
-        /// ρ-screenfuls.
-        double s = k * S;
-        double us = u(s);
-
-        // Calculate the current point and zoom level along the flight path.
-        Point<double> framePoint = util::interpolate(startPoint, endPoint, us);
-        double frameZoom = startZoom + state.scaleZoom(1 / w(s));
-
-        // Convert to geographic coordinates and set the new viewpoint.
-        LatLng frameLatLng = Projection::unproject(framePoint, startScale);
-        state.setLatLngZoom(frameLatLng, frameZoom);
-
-        if (angle != startAngle) {
-            state.angle = util::wrap(util::interpolate(startAngle, angle, k), -M_PI, M_PI);
-        }
-        if (pitch != startPitch) {
-            state.pitch = util::interpolate(startPitch, pitch, k);
-        }
-
-        if (padding) {
-            state.moveLatLng(frameLatLng, center);
-        }
-        return Update::RecalculateStyle;
-    }, duration);
+    Transition transition_;
+    transition_.curve = Transition::Curve::Fly;
+    transition_.update = Update::RecalculateStyle;
+    transition_.startPoint = startPoint;
+    transition_.endPoint = endPoint;
+    transition_.startScale = startScale;
+    transition_.startZoom = startZoom;
+    transition_.startAngle = startAngle;
+    transition_.angle = angle;
+    transition_.startPitch = startPitch;
+    transition_.pitch = pitch;
+    transition_.padded = bool(padding);
+    transition_.center = center;
+    transition_.isClose = isClose;
+    transition_.w0 = w0;
+    transition_.w1 = w1;
+    transition_.u1 = u1;
+    transition_.rho = rho;
+    transition_.rho2 = rho2;
+    transition_.r0 = r0;
+    transition_.S = S;
+    startTransition(std::move(transition_), camera, animation, duration);
 }
 
 #pragma mark - Position
@@ -332,6 +317,7 @@ void Transform::moveBy(const ScreenCoordinate& offset, const Duration& duration)
 
     CameraOptions camera;
     camera.center = state.screenCoordinateToLatLng(centerPoint);
+    updatePanVelocity(*camera.center);
     easeTo(camera, duration);
 }
 
@@ -341,6 +327,7 @@ void Transform::setLatLng(const LatLng& latLng, const Duration& duration) {
 
 void Transform::setLatLng(const LatLng& latLng, optional<EdgeInsets> padding, const Duration& duration) {
     if (!latLng) return;
+    updatePanVelocity(latLng);
     CameraOptions camera;
     camera.center = latLng;
     camera.padding = padding;
@@ -349,6 +336,7 @@ void Transform::setLatLng(const LatLng& latLng, optional<EdgeInsets> padding, co
 
 void Transform::setLatLng(const LatLng& latLng, optional<ScreenCoordinate> anchor, const Duration& duration) {
     if (!latLng) return;
+    updatePanVelocity(latLng);
     CameraOptions camera;
     camera.center = latLng;
     if (anchor) {
@@ -548,93 +536,207 @@ ViewportMode Transform::getViewportMode() const {
 
 #pragma mark - Transition
 
-void Transform::startTransition(const CameraOptions& camera,
+void Transform::startTransition(Transition&& transition_,
+                                const CameraOptions& camera,
                                 const AnimationOptions& animation,
-                                std::function<Update(double)> frame,
                                 const Duration& duration) {
-    if (transitionFinishFn) {
-        transitionFinishFn();
+    if (transition) {
+        finishTransition();
     }
 
-    bool isAnimated = duration != Duration::zero();
+    transition_.isAnimated = duration != Duration::zero();
     if (callback) {
-        callback(isAnimated ? MapChangeRegionWillChangeAnimated : MapChangeRegionWillChange);
+        callback(transition_.isAnimated ? MapChangeRegionWillChangeAnimated : MapChangeRegionWillChange);
     }
 
     // Associate the anchor, if given, with a coordinate.
-    optional<ScreenCoordinate> anchor = camera.anchor;
-    LatLng anchorLatLng;
-    if (anchor) {
-        anchor->y = state.getHeight() - anchor->y;
-        anchorLatLng = state.screenCoordinateToLatLng(*anchor);
+    transition_.anchor = camera.anchor;
+    if (transition_.anchor) {
+        transition_.anchor->y = state.getHeight() - transition_.anchor->y;
+        transition_.anchorLatLng = state.screenCoordinateToLatLng(*transition_.anchor);
+    }
+
+    if (animation.easing) {
+        transition_.easing.emplace(*animation.easing);
     }
+    transition_.frameFn = animation.transitionFrameFn;
+    transition_.finishFn = animation.transitionFinishFn;
 
     transitionStart = Clock::now();
     transitionDuration = duration;
 
-    transitionFrameFn = [isAnimated, animation, frame, anchor, anchorLatLng, this](const TimePoint now) {
-        float t = isAnimated ? (std::chrono::duration<float>(now - transitionStart) / transitionDuration) : 1.0;
-        Update result;
-        if (t >= 1.0) {
-            result = frame(1.0);
-        } else {
-            util::UnitBezier ease = animation.easing ? *animation.easing : util::DEFAULT_TRANSITION_EASE;
-            result = frame(ease.solve(t, 0.001));
+    // Sample the path ahead of time by moving the camera along it, and restoring it afterwards.
+    transitionPath.clear();
+    transitionProgress = 0;
+    if (transition_.isAnimated) {
+        transitionPath.reserve(TRANSITION_PATH_SAMPLES);
+        const TransformState startState = state;
+        for (std::size_t i = 1; i <= TRANSITION_PATH_SAMPLES; ++i) {
+            const double k = double(i) / TRANSITION_PATH_SAMPLES;
+            applyTransition(transition_, k);
+            transitionPath.emplace_back(k, state);
+            state = startState;
         }
+    }
 
-        if (anchor) state.moveLatLng(anchorLatLng, *anchor);
+    transition = std::make_unique<Transition>(std::move(transition_));
 
-        // At t = 1.0, a DidChangeAnimated notification should be sent from finish().
-        if (t < 1.0) {
-            if (animation.transitionFrameFn) {
-                animation.transitionFrameFn(t);
-            }
-            if (callback) {
-                callback(MapChangeRegionIsChanging);
-            }
-        } else {
-            transitionFinishFn();
-            transitionFinishFn = nullptr;
+    if (!transition->isAnimated) {
+        updateTransitions(Clock::now());
+    }
+}
 
-            // This callback gets destroyed here,
-            // we can only return after this point.
-            transitionFrameFn = nullptr;
-        }
-        return result;
-    };
+Update Transform::applyTransition(const Transition& t, double k) {
+    LatLng frameLatLng;
+    if (t.curve == Transition::Curve::Ease) {
+        Point<double> framePoint = util::interpolate(t.startPoint, t.endPoint, k);
+        frameLatLng = Projection::unproject(framePoint, t.startScale);
+        double frameScale = util::interpolate(t.startScale, t.scale, k);
+        state.setLatLngZoom(frameLatLng, state.scaleZoom(frameScale));
+    } else {
+        /// s: The distance traveled along the flight path, measured in
+        /// ρ-screenfuls.
+        double s = k * t.S;
+        /// w(s): The visible span on the ground, measured in pixels with
+        /// respect to the initial scale. Assumes an angular field of view of
+        /// 2 arctan ½ ≈ 53°.
+        double ws = t.isClose ? std::exp((t.w1 < t.w0 ? -1 : 1) * t.rho * s)
+                              : (std::cosh(t.r0) / std::cosh(t.r0 + t.rho * s));
+        /// u(s): The distance along the flight path as projected onto the
+        /// ground plane, measured in pixels from the world image origin at the
+        /// initial scale.
+        double us = t.isClose ? 0.
+                              : (t.w0 * (std::cosh(t.r0) * std::tanh(t.r0 + t.rho * s) - std::sinh(t.r0)) / t.rho2 / t.u1);
 
-    transitionFinishFn = [isAnimated, animation, this] {
-        state.panning = false;
-        state.scaling = false;
-        state.rotating = false;
-        if (animation.transitionFinishFn) {
-            animation.transitionFinishFn();
-        }
-        if (callback) {
-            callback(isAnimated ? MapChangeRegionDidChangeAnimated : MapChangeRegionDidChange);
-        }
-    };
+        // Calculate the current point and zoom level along the flight path.
+        Point<double> framePoint = util::interpolate(t.startPoint, t.endPoint, us);
+        double frameZoom = t.startZoom + state.scaleZoom(1 / ws);
+
+        // Convert to geographic coordinates and set the new viewpoint.
+        frameLatLng = Projection::unproject(framePoint, t.startScale);
+        state.setLatLngZoom(frameLatLng, frameZoom);
+    }
 
-    if (!isAnimated) {
-        transitionFrameFn(Clock::now());
+    if (t.angle != t.startAngle) {
+        state.angle = util::wrap(util::interpolate(t.startAngle, t.angle, k), -M_PI, M_PI);
+    }
+    if (t.pitch != t.startPitch) {
+        state.pitch = util::interpolate(t.startPitch, t.pitch, k);
+    }
+
+    if (t.padded) {
+        state.moveLatLng(frameLatLng, t.center);
+    }
+    if (t.anchor) {
+        state.moveLatLng(t.anchorLatLng, *t.anchor);
+    }
+    return t.update;
+}
+
+void Transform::finishTransition() {
+    // Moved out first, because the callbacks may start another transition.
+    std::unique_ptr<Transition> finished = std::move(transition);
+    transitionPath.clear();
+
+    state.panning = false;
+    state.scaling = false;
+    state.rotating = false;
+    if (finished->finishFn) {
+        finished->finishFn();
+    }
+    if (callback) {
+        callback(finished->isAnimated ? MapChangeRegionDidChangeAnimated : MapChangeRegionDidChange);
     }
 }
 
 bool Transform::inTransition() const {
-    return transitionFrameFn != nullptr;
+    return bool(transition);
 }
 
 Update Transform::updateTransitions(const TimePoint& now) {
-    return transitionFrameFn ? transitionFrameFn(now) : Update::Nothing;
+    if (!transition) {
+        return Update::Nothing;
+    }
+
+    float t = transition->isAnimated ? (std::chrono::duration<float>(now - transitionStart) / transitionDuration) : 1.0;
+    if (t >= 1.0) {
+        transitionProgress = 1.0;
+    } else {
+        const util::UnitBezier& ease = transition->easing ? *transition->easing : util::DEFAULT_TRANSITION_EASE;
+        transitionProgress = ease.solve(t, 0.001);
+    }
+    const Update result = applyTransition(*transition, transitionProgress);
+
+    // At t = 1.0, a DidChangeAnimated notification should be sent from finishTransition().
+    if (t < 1.0) {
+        if (transition->frameFn) {
+            transition->frameFn(t);
+        }
+        if (callback) {
+            callback(MapChangeRegionIsChanging);
+        }
+    } else {
+        finishTransition();
+    }
+    return result;
 }
 
 void Transform::cancelTransitions() {
-    if (transitionFinishFn) {
-        transitionFinishFn();
+    if (transition) {
+        finishTransition();
+    }
+    transitionPath.clear();
+}
+
+std::vector<TransformState> Transform::getUpcomingStates() const {
+    std::vector<TransformState> result;
+    for (const auto& sample : transitionPath) {
+        if (sample.first > transitionProgress) {
+            result.push_back(sample.second);
+        }
+    }
+
+    if (transitionPath.empty() && lastPanTime && Clock::now() - *lastPanTime < PAN_LOOKAHEAD &&
+        (panVelocity.x || panVelocity.y)) {
+        const double seconds = std::chrono::duration<double>(PAN_LOOKAHEAD).count();
+        Point<double> offset = panVelocity * (seconds * state.scale);
+        const double distance = ::hypot(offset.x, offset.y);
+        const double maxDistance = std::max(state.width, state.height);
+        if (distance > maxDistance) {
+            offset *= maxDistance / distance;
+        }
+
+        const LatLng latLng = state.getLatLng();
+        TransformState ahead = state;
+        ahead.setLatLngZoom(Projection::unproject(Projection::project(latLng, state.scale) + offset, state.scale),
+                            state.getZoom());
+        result.push_back(ahead);
+    }
+
+    return result;
+}
+
+void Transform::updatePanVelocity(const LatLng& destination) {
+    const TimePoint now = Clock::now();
+    LatLng unwrapped = destination;
+    unwrapped.unwrapForShortestPath(state.getLatLng());
+    const Point<double> point = Projection::project(unwrapped, 1);
+
+    if (lastPanTime && now - *lastPanTime < PAN_LOOKAHEAD && now > *lastPanTime) {
+        const double seconds = std::chrono::duration<double>(now - *lastPanTime).count();
+        const Point<double> velocity = (point - lastPanPoint) / seconds;
+        if (velocity.x * panVelocity.x + velocity.y * panVelocity.y < 0) {
+            // The direction changed; the tiles ahead of the old one are no longer needed.
+            panVelocity = {};
+        } else {
+            panVelocity = (panVelocity + velocity) / 2.0;
+        }
+    } else {
+        panVelocity = {};
     }
 
-    transitionFrameFn = nullptr;
-    transitionFinishFn = nullptr;
+    lastPanPoint = point;
+    lastPanTime = now;
 }
 
 void Transform::setGestureInProgress(bool inProgress) {
@@ -9,10 +9,14 @@
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/unitbezier.hpp>
 
 #include <cstdint>
 #include <cmath>
 #include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace mbgl {
 
@@ -148,6 +152,11 @@ public:
     Duration getTransitionDuration() const { return transitionDuration; }
     void cancelTransitions();
 
+    // Samples of the camera along the path of the current animation that it hasn't reached yet,
+    // ending with where it lands. Without an animation, where panning is headed at its current
+    // velocity, if the camera is panning. Empty otherwise.
+    std::vector<TransformState> getUpcomingStates() const;
+
     // Gesture
     void setGestureInProgress(bool);
     bool isGestureInProgress() const { return state.isGestureInProgress(); }
@@ -167,15 +176,64 @@ private:
 
     TransformState state;
 
-    void startTransition(const CameraOptions&,
-                         const AnimationOptions&,
-                         std::function<Update(double)>,
-                         const Duration&);
-
+    // The camera animation in progress. Everything that doesn't change from one frame to the
+    // next is computed once when it starts, so that frames are evaluated without allocating or
+    // calling through type-erased functions.
+    struct Transition {
+        enum class Curve : bool { Ease, Fly };
+        Curve curve = Curve::Ease;
+        Update update = Update::Repaint;
+
+        Point<double> startPoint;
+        Point<double> endPoint;
+        double startScale = 0;
+        double scale = 0;
+        double startZoom = 0;
+        double startAngle = 0;
+        double angle = 0;
+        double startPitch = 0;
+        double pitch = 0;
+
+        // Where the center is kept when the camera has padding.
+        bool padded = false;
+        ScreenCoordinate center;
+
+        // The optimal path of flyTo(). See there for what each parameter means.
+        bool isClose = false;
+        double w0 = 0;
+        double w1 = 0;
+        double u1 = 0;
+        double rho = 0;
+        double rho2 = 0;
+        double r0 = 0;
+        double S = 0;
+
+        optional<ScreenCoordinate> anchor;
+        LatLng anchorLatLng;
+
+        bool isAnimated = false;
+        optional<util::UnitBezier> easing;
+        std::function<void(double)> frameFn;
+        std::function<void()> finishFn;
+    };
+
+    void startTransition(Transition&&, const CameraOptions&, const AnimationOptions&, const Duration&);
+    // Moves the camera to the given progress along the path of the transition.
+    Update applyTransition(const Transition&, double k);
+    void finishTransition();
+
+    std::unique_ptr<Transition> transition;
     TimePoint transitionStart;
     Duration transitionDuration;
-    std::function<Update(const TimePoint)> transitionFrameFn;
-    std::function<void()> transitionFinishFn;
+    // The progress along the path at which each sample was taken, from 0 to 1.
+    std::vector<std::pair<double, TransformState>> transitionPath;
+    double transitionProgress = 0;
+
+    // Tracks the velocity of moveBy() and setLatLng(), in pixels per second at zoom level 0.
+    void updatePanVelocity(const LatLng& destination);
+    Point<double> panVelocity;
+    Point<double> lastPanPoint;
+    optional<TimePoint> lastPanTime;
 };
 
 } // namespace mbgl
@@ -19,11 +19,15 @@ void TransformState::matrixFor(mat4& matrix, const UnwrappedTileID& tileID) cons
     const uint64_t tileScale = 1ull << tileID.canonical.z;
     const double s = Projection::worldSize(scale) / tileScale;
 
-    matrix::identity(matrix);
-    matrix::translate(matrix, matrix,
-                      int64_t(tileID.canonical.x + tileID.wrap * tileScale) * s,
-                      int64_t(tileID.canonical.y) * s, 0);
-    matrix::scale(matrix, matrix, s / util::EXTENT, s / util::EXTENT, 1);
+    const double tileX = int64_t(tileID.canonical.x + tileID.wrap * tileScale) * s;
+    const double tileY = int64_t(tileID.canonical.y) * s;
+    const double extentScale = s / util::EXTENT;
+
+    // The same as translating an identity matrix, then scaling it, without multiplying by 0 and 1.
+    matrix = {{ extentScale, 0, 0, 0,
+                0, extentScale, 0, 0,
+                0, 0, 1, 0,
+                tileX, tileY, 0, 1 }};
 }
 
 void TransformState::getProjMatrix(mat4& projMatrix) const {
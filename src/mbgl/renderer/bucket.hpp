@@ -2,6 +2,7 @@
 
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/memory_usage.hpp>
 
 #include <atomic>
 
@@ -40,6 +41,14 @@ public:
 
     virtual bool needsClipping() const = 0;
 
+    // The vertices and indices, or image, that haven't been uploaded yet, and the buffers, or
+    // texture, they were uploaded to.
+    virtual MemoryUsage getMemoryUsage() const = 0;
+
+    // Called with the bucket that this bucket replaces, e.g. with a new placement of the same
+    // layout, so that it can keep the buffers of the other that it would upload again.
+    virtual void adoptBuffers(Bucket&) {}
+
     bool needsUpload() const {
         return !uploaded;
     }
@@ -3,6 +3,8 @@
 #include <mbgl/gl/gl.hpp>
 
 #include <mbgl/shader/circle_shader.hpp>
+#include <mbgl/shader/circle_instanced_shader.hpp>
+#include <mbgl/shader/circle_data_driven_shader.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/util/constants.hpp>
 
@@ -18,8 +20,75 @@ CircleBucket::~CircleBucket() {
 }
 
 void CircleBucket::upload(gl::Context& context) {
+    if (gl::instancedArraysSupported()) {
+        instanceBuffer = context.createVertexBuffer(std::move(instances));
+        if (!colors.empty()) {
+            colorBuffer = context.createVertexBuffer(std::move(colors));
+        }
+        uploaded = true;
+        return;
+    }
+
+    std::vector<CircleVertex> vertices;
+    std::vector<gl::Triangle> triangles;
+    vertices.reserve(instances.size() * 4);
+    triangles.reserve(instances.size() * 2);
+
+    if (!colors.empty()) {
+        std::vector<ColorVertex> vertexColors;
+        vertexColors.reserve(colors.size() * 4);
+        for (const auto& color : colors) {
+            for (int i = 0; i < 4; ++i) {
+                vertexColors.push_back(color);
+            }
+        }
+        colors = std::vector<ColorVertex>();
+        colorBuffer = context.createVertexBuffer(std::move(vertexColors));
+    }
+
+    for (const auto& instance : instances) {
+        const int16_t x = instance.a_pos[0];
+        const int16_t y = instance.a_pos[1];
+
+        // this geometry will be of the Point type, and we'll derive
+        // two triangles from it.
+        //
+        // ┌─────────┐
+        // │ 4     3 │
+        // │         │
+        // │ 1     2 │
+        // └─────────┘
+        //
+        vertices.emplace_back(x, y, -1, -1); // 1
+        vertices.emplace_back(x, y, 1, -1); // 2
+        vertices.emplace_back(x, y, 1, 1); // 3
+        vertices.emplace_back(x, y, -1, 1); // 4
+
+        if (!groups.size() || groups.back().vertexLength + 4 > 65535) {
+            // Move to a new group because the old one can't hold the geometry.
+            groups.emplace_back();
+        }
+
+        auto& group = groups.back();
+        uint16_t index = group.vertexLength;
+
+        // 1, 2, 3
+        // 1, 4, 3
+        triangles.emplace_back(index,
+                               static_cast<uint16_t>(index + 1),
+                               static_cast<uint16_t>(index + 2));
+        triangles.emplace_back(index,
+                               static_cast<uint16_t>(index + 3),
+                               static_cast<uint16_t>(index + 2));
+
+        group.vertexLength += 4;
+        group.indexLength += 2;
+    }
+
+    instances = std::vector<CircleInstance>();
+
     vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    indexBuffer = uploadElementGroups(context, std::move(triangles), groups);
     uploaded = true;
 }
 
@@ -31,76 +100,112 @@ void CircleBucket::render(Painter& painter,
 }
 
 bool CircleBucket::hasData() const {
-    return !groups.empty();
+    return !instances.empty() || !groups.empty() || isInstanced();
+}
+
+bool CircleBucket::hasFeatureColors() const {
+    return !colors.empty() || colorBuffer;
+}
+
+bool CircleBucket::isInstanced() const {
+    return bool(instanceBuffer);
 }
 
 bool CircleBucket::needsClipping() const {
     return true;
 }
 
+MemoryUsage CircleBucket::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.cpu = util::memoryUsage(instances) + util::memoryUsage(colors) + util::memoryUsage(groups);
+    usage.gpu = util::bufferMemoryUsage(instanceBuffer) + util::bufferMemoryUsage(vertexBuffer) +
+                util::bufferMemoryUsage(colorBuffer) + util::bufferMemoryUsage(indexBuffer);
+    return usage;
+}
+
 void CircleBucket::addGeometry(const GeometryCollection& geometryCollection) {
     for (auto& circle : geometryCollection) {
-        for(auto & geometry : circle) {
-            auto x = geometry.x;
-            auto y = geometry.y;
-
-            // Do not include points that are outside the tile boundaries.
-            // Include all points in Still mode. You need to include points from
-            // neighbouring tiles so that they are not clipped at tile boundaries.
-            if ((mode != MapMode::Still) &&
-                (x < 0 || x >= util::EXTENT || y < 0 || y >= util::EXTENT)) continue;
-
-            // this geometry will be of the Point type, and we'll derive
-            // two triangles from it.
-            //
-            // ┌─────────┐
-            // │ 4     3 │
-            // │         │
-            // │ 1     2 │
-            // └─────────┘
-            //
-            vertices.emplace_back(x, y, -1, -1); // 1
-            vertices.emplace_back(x, y, 1, -1); // 2
-            vertices.emplace_back(x, y, 1, 1); // 3
-            vertices.emplace_back(x, y, -1, 1); // 4
-
-            if (!groups.size() || groups.back().vertexLength + 4 > 65535) {
-                // Move to a new group because the old one can't hold the geometry.
-                groups.emplace_back();
-            }
+        addGeometry(circle);
+    }
+}
 
-            auto& group = groups.back();
-            uint16_t index = group.vertexLength;
+void CircleBucket::addGeometry(const GeometryCoordinates& circle) {
+    for(auto & geometry : circle) {
+        auto x = geometry.x;
+        auto y = geometry.y;
 
-            // 1, 2, 3
-            // 1, 4, 3
-            triangles.emplace_back(index,
-                                   static_cast<uint16_t>(index + 1),
-                                   static_cast<uint16_t>(index + 2));
-            triangles.emplace_back(index,
-                                   static_cast<uint16_t>(index + 3),
-                                   static_cast<uint16_t>(index + 2));
+        // Do not include points that are outside the tile boundaries.
+        // Include all points in Still mode. You need to include points from
+        // neighbouring tiles so that they are not clipped at tile boundaries.
+        if ((mode != MapMode::Still) &&
+            (x < 0 || x >= util::EXTENT || y < 0 || y >= util::EXTENT)) continue;
 
-            group.vertexLength += 4;
-            group.indexLength += 2;
-        }
+        instances.emplace_back(x, y);
     }
 }
 
-void CircleBucket::drawCircles(CircleShader& shader, gl::Context& context, PaintMode paintMode) {
-    GLbyte* vertexIndex = BUFFER_OFFSET(0);
-    GLbyte* elementsIndex = BUFFER_OFFSET(0);
+void CircleBucket::addGeometry(const GeometryCoordinates& circle, const Color& color) {
+    addGeometry(circle);
+    while (colors.size() < instances.size()) {
+        colors.emplace_back(color);
+    }
+}
 
-    for (auto& group : groups) {
-        if (!group.indexLength) continue;
+void CircleBucket::drawCircles(CircleShader& shader, gl::Context& context) {
+    drawElementGroups(shader, groups, *vertexBuffer, *indexBuffer, context);
+}
 
-        group.getVAO(shader, paintMode).bind(shader, *vertexBuffer, *indexBuffer, vertexIndex, context);
+void CircleBucket::drawCircles(CircleDataDrivenShader& shader, gl::Context& context) {
+    drawElementGroups(shader, groups, *vertexBuffer, *colorBuffer, *indexBuffer, context);
+}
 
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT, elementsIndex));
+void CircleBucket::drawCircleInstances(CircleInstancedShader& shader,
+                                       const gl::VertexBuffer<CircleCornerVertex>& corners,
+                                       gl::Context& context) {
+    if (!instanceBuffer->vertexCount) {
+        return;
+    }
 
-        vertexIndex += group.vertexLength * vertexBuffer->vertexSize;
-        elementsIndex += group.indexLength * indexBuffer->primitiveSize;
+    // gl::VertexArrayObject only records the binding of a single vertex buffer. Draw with the
+    // default vertex array instead, where the divisors are global state that has to be reset.
+    context.vertexArrayObject = 0;
+
+    context.vertexBuffer = corners.buffer.getID();
+    context.bindAttributes(shader, corners, BUFFER_OFFSET_0);
+    context.vertexBuffer = instanceBuffer->buffer.getID();
+    context.bindInstanceAttributes(shader, *instanceBuffer, BUFFER_OFFSET_0);
+
+    MBGL_CHECK_ERROR(gl::DrawArraysInstanced(GL_TRIANGLE_STRIP, 0,
+                                             static_cast<GLsizei>(corners.vertexCount),
+                                             static_cast<GLsizei>(instanceBuffer->vertexCount)));
+
+    context.unbindInstanceAttributes(shader, *instanceBuffer);
+}
+
+void CircleBucket::drawCircleInstances(CircleInstancedDataDrivenShader& shader,
+                                       const gl::VertexBuffer<CircleCornerVertex>& corners,
+                                       gl::Context& context) {
+    if (!instanceBuffer->vertexCount) {
+        return;
     }
+
+    context.vertexArrayObject = 0;
+
+    context.vertexBuffer = corners.buffer.getID();
+    context.bindAttributes(shader, corners, BUFFER_OFFSET_0);
+    context.vertexBuffer = instanceBuffer->buffer.getID();
+    context.bindInstanceAttributes(shader, *instanceBuffer, BUFFER_OFFSET_0);
+    context.vertexBuffer = colorBuffer->buffer.getID();
+    context.bindInstanceAttributes(shader, *colorBuffer, BUFFER_OFFSET_0);
+
+    MBGL_CHECK_ERROR(gl::DrawArraysInstanced(GL_TRIANGLE_STRIP, 0,
+                                             static_cast<GLsizei>(corners.vertexCount),
+                                             static_cast<GLsizei>(instanceBuffer->vertexCount)));
+
+    context.unbindInstanceAttributes(shader, *instanceBuffer);
+    // The other shaders don't read the color attribute, so it has to be disabled again.
+    context.unbindInstanceAttributes(shader, *colorBuffer);
+    context.unbindExtraAttributes(shader, *colorBuffer);
 }
 
 } // namespace mbgl
@@ -7,10 +7,14 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/shader/circle_vertex.hpp>
+#include <mbgl/shader/color_vertex.hpp>
 
 namespace mbgl {
 
 class CircleShader;
+class CircleInstancedShader;
+class CircleDataDrivenShader;
+class CircleInstancedDataDrivenShader;
 
 class CircleBucket : public Bucket {
 public:
@@ -22,17 +26,42 @@ public:
 
     bool hasData() const override;
     bool needsClipping() const override;
+    MemoryUsage getMemoryUsage() const override;
     void addGeometry(const GeometryCollection&);
+    void addGeometry(const GeometryCoordinates&);
+    // Adds the circles of a feature whose circle color is data-driven, i.e. the value of a
+    // property function for it. A bucket's features either all have colors or none does.
+    void addGeometry(const GeometryCoordinates&, const Color&);
 
-    void drawCircles(CircleShader&, gl::Context&, PaintMode);
+    // Whether the circles have colors of their own, to be drawn with the data-driven shaders.
+    bool hasFeatureColors() const;
+
+    // Whether upload() stored one instance per circle, to be drawn with drawCircleInstances(),
+    // rather than a quad of four vertices per circle for drawCircles().
+    bool isInstanced() const;
+
+    void drawCircles(CircleShader&, gl::Context&);
+    void drawCircleInstances(CircleInstancedShader&,
+                             const gl::VertexBuffer<CircleCornerVertex>& corners,
+                             gl::Context&);
+    void drawCircles(CircleDataDrivenShader&, gl::Context&);
+    void drawCircleInstances(CircleInstancedDataDrivenShader&,
+                             const gl::VertexBuffer<CircleCornerVertex>& corners,
+                             gl::Context&);
 
 private:
-    std::vector<CircleVertex> vertices;
-    std::vector<gl::Triangle> triangles;
+    // The circles are collected as centers, and expanded into quads on upload only where the
+    // context can't draw them instanced.
+    std::vector<CircleInstance> instances;
+    // The colors of the circles, if they have colors. They're expanded along with the circles.
+    std::vector<ColorVertex> colors;
 
-    std::vector<ElementGroup<CircleShader>> groups;
+    std::vector<ElementGroup> groups;
 
+    optional<gl::VertexBuffer<CircleInstance>> instanceBuffer;
     optional<gl::VertexBuffer<CircleVertex>> vertexBuffer;
+    // One color per instance, or per vertex of the quads.
+    optional<gl::VertexBuffer<ColorVertex>> colorBuffer;
     optional<gl::IndexBuffer<gl::Triangle>> indexBuffer;
 
     const MapMode mode;
@@ -87,14 +87,14 @@ DebugBucket::DebugBucket(const OverscaledTileID& id,
 
 void DebugBucket::drawLines(FillShader& shader, gl::Context& context) {
     if (vertexBuffer.vertexCount != 0) {
-        array.bind(shader, vertexBuffer, BUFFER_OFFSET_0, context);
+        context.bindVertexArray(shader, vertexBuffer, BUFFER_OFFSET_0);
         MBGL_CHECK_ERROR(glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertexBuffer.vertexCount)));
     }
 }
 
 void DebugBucket::drawPoints(FillShader& shader, gl::Context& context) {
     if (vertexBuffer.vertexCount != 0) {
-        array.bind(shader, vertexBuffer, BUFFER_OFFSET_0, context);
+        context.bindVertexArray(shader, vertexBuffer, BUFFER_OFFSET_0);
         MBGL_CHECK_ERROR(glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(vertexBuffer.vertexCount)));
     }
 }
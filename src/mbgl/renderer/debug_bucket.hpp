@@ -6,7 +6,6 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/gl/vertex_buffer.hpp>
-#include <mbgl/gl/vao.hpp>
 #include <mbgl/shader/fill_vertex.hpp>
 
 namespace mbgl {
@@ -39,7 +38,6 @@ public:
 
 private:
     gl::VertexBuffer<FillVertex> vertexBuffer;
-    gl::VertexArrayObject array;
 };
 
 } // namespace mbgl
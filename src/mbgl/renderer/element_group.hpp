@@ -1,28 +1,153 @@
 #pragma once
 
-#include <mbgl/gl/vao.hpp>
-#include <mbgl/renderer/render_pass.hpp>
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/extension.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/renderer/bucket.hpp>
+
+#include <vector>
 
 namespace mbgl {
 
-template <class... Shaders>
+// A run of vertices of a bucket and the primitives that connect them. The vertex array objects
+// that draw it come from the context's cache.
 struct ElementGroup {
-    template <class Shader>
-    struct VAOs {
-        gl::VertexArrayObject normalVAO;
-        gl::VertexArrayObject overdrawVAO;
-    };
+    std::size_t vertexLength = 0;
+    std::size_t indexLength = 0;
+};
+
+namespace detail {
+
+inline void appendIndices(std::vector<uint32_t>& indices, const gl::Line& line, uint32_t offset) {
+    indices.push_back(offset + line.a);
+    indices.push_back(offset + line.b);
+}
 
-    std::tuple<VAOs<Shaders>...> vaos;
+inline void appendIndices(std::vector<uint32_t>& indices, const gl::Triangle& triangle, uint32_t offset) {
+    indices.push_back(offset + triangle.a);
+    indices.push_back(offset + triangle.b);
+    indices.push_back(offset + triangle.c);
+}
 
-    template <class Shader>
-    gl::VertexArrayObject& getVAO(const Shader&, PaintMode paintMode) {
-        auto& vao = std::get<VAOs<Shader>>(vaos);
-        return paintMode == PaintMode::Overdraw ? vao.overdrawVAO : vao.normalVAO;
+} // namespace detail
+
+// Uploads the primitives of a bucket's element groups. Their 16-bit indices are relative to the
+// first vertex of their group, so that each group needs a draw call of its own. Where the context
+// supports 32-bit indices, they're rebased onto the start of the vertex buffer instead, so that
+// drawElementGroups() draws all groups at once.
+template <class Primitive, class Group>
+gl::IndexBuffer<Primitive> uploadElementGroups(gl::Context& context,
+                                               std::vector<Primitive>&& primitives,
+                                               const std::vector<Group>& groups) {
+    if (groups.size() <= 1 || !gl::elementIndexUintSupported()) {
+        return context.createIndexBuffer(std::move(primitives));
     }
 
-    std::size_t vertexLength = 0;
-    std::size_t indexLength = 0;
-};
+    std::vector<uint32_t> indices;
+    indices.reserve(primitives.size() * Primitive::IndexCount);
+
+    auto primitive = primitives.begin();
+    uint32_t offset = 0;
+    for (const auto& group : groups) {
+        for (std::size_t i = 0; i < group.indexLength; ++i, ++primitive) {
+            detail::appendIndices(indices, *primitive, offset);
+        }
+        offset += group.vertexLength;
+    }
+
+    primitives = {};
+    return context.createUintIndexBuffer<Primitive>(std::move(indices));
+}
+
+// Draws the element groups of a bucket, with one call per group, or with a single call if their
+// indices were merged by uploadElementGroups().
+template <class Shader, class Group, class Vertex, class Primitive>
+void drawElementGroups(Shader& shader,
+                       const std::vector<Group>& groups,
+                       const gl::VertexBuffer<Vertex>& vertexBuffer,
+                       const gl::IndexBuffer<Primitive>& indexBuffer,
+                       gl::Context& context) {
+    const GLenum mode = Primitive::IndexCount == 3 ? GL_TRIANGLES : GL_LINES;
+
+    if (indexBuffer.uintIndices) {
+        std::size_t indexLength = 0;
+        for (const auto& group : groups) {
+            indexLength += group.indexLength;
+        }
+        if (groups.empty() || !indexLength) {
+            return;
+        }
+
+        context.bindVertexArray(shader, vertexBuffer, indexBuffer, BUFFER_OFFSET_0);
+        MBGL_CHECK_ERROR(glDrawElements(mode, static_cast<GLsizei>(indexLength * Primitive::IndexCount),
+                                        GL_UNSIGNED_INT, BUFFER_OFFSET(indexBuffer.buffer.getOffset())));
+        return;
+    }
+
+    GLbyte* vertexIndex = BUFFER_OFFSET_0;
+    GLbyte* elementsIndex = BUFFER_OFFSET(indexBuffer.buffer.getOffset());
+    for (auto& group : groups) {
+        if (group.indexLength) {
+            context.bindVertexArray(shader, vertexBuffer, indexBuffer, vertexIndex);
+            MBGL_CHECK_ERROR(glDrawElements(mode, static_cast<GLsizei>(group.indexLength * Primitive::IndexCount),
+                                            GL_UNSIGNED_SHORT, elementsIndex));
+        }
+        vertexIndex += group.vertexLength * vertexBuffer.vertexSize;
+        elementsIndex += group.indexLength * indexBuffer.primitiveSize;
+    }
+}
+
+// Draws the element groups like drawElementGroups(), with more attributes of the vertices read
+// from a second vertex buffer that holds as many vertices as the first, e.g. their data-driven
+// colors. Vertex array objects only record a single vertex buffer, so this draws with the
+// default vertex array.
+template <class Shader, class Group, class Vertex, class ExtraVertex, class Primitive>
+void drawElementGroups(Shader& shader,
+                       const std::vector<Group>& groups,
+                       const gl::VertexBuffer<Vertex>& vertexBuffer,
+                       const gl::VertexBuffer<ExtraVertex>& extraBuffer,
+                       const gl::IndexBuffer<Primitive>& indexBuffer,
+                       gl::Context& context) {
+    const GLenum mode = Primitive::IndexCount == 3 ? GL_TRIANGLES : GL_LINES;
+
+    context.vertexArrayObject = 0;
+    // The element buffer binding is part of the vertex array's state.
+    context.elementBuffer.setDirty();
+    context.elementBuffer = indexBuffer.buffer.getID();
+
+    const auto draw = [&] (GLbyte* vertexIndex, GLbyte* extraIndex, GLenum type,
+                           std::size_t indexLength, GLbyte* elementsIndex) {
+        context.vertexBuffer = vertexBuffer.buffer.getID();
+        context.bindAttributes(shader, vertexBuffer, vertexIndex);
+        context.bindExtraAttributes(shader, extraBuffer, extraIndex);
+        MBGL_CHECK_ERROR(glDrawElements(mode, static_cast<GLsizei>(indexLength * Primitive::IndexCount),
+                                        type, elementsIndex));
+    };
+
+    if (indexBuffer.uintIndices) {
+        std::size_t indexLength = 0;
+        for (const auto& group : groups) {
+            indexLength += group.indexLength;
+        }
+        if (indexLength) {
+            draw(BUFFER_OFFSET_0, BUFFER_OFFSET_0, GL_UNSIGNED_INT, indexLength,
+                 BUFFER_OFFSET(indexBuffer.buffer.getOffset()));
+        }
+    } else {
+        GLbyte* vertexIndex = BUFFER_OFFSET_0;
+        GLbyte* extraIndex = BUFFER_OFFSET_0;
+        GLbyte* elementsIndex = BUFFER_OFFSET(indexBuffer.buffer.getOffset());
+        for (auto& group : groups) {
+            if (group.indexLength) {
+                draw(vertexIndex, extraIndex, GL_UNSIGNED_SHORT, group.indexLength, elementsIndex);
+            }
+            vertexIndex += group.vertexLength * vertexBuffer.vertexSize;
+            extraIndex += group.vertexLength * extraBuffer.vertexSize;
+            elementsIndex += group.indexLength * indexBuffer.primitiveSize;
+        }
+    }
+
+    context.unbindExtraAttributes(shader, extraBuffer);
+}
 
 } // namespace mbgl
@@ -5,11 +5,17 @@
 #include <mbgl/shader/fill_pattern_shader.hpp>
 #include <mbgl/shader/fill_outline_shader.hpp>
 #include <mbgl/shader/fill_outline_pattern_shader.hpp>
+#include <mbgl/shader/fill_data_driven_shader.hpp>
+#include <mbgl/shader/fill_category_shader.hpp>
+#include <mbgl/shader/fill_feature_state_shader.hpp>
+#include <mbgl/shader/fill_picking_shader.hpp>
+#include <mbgl/style/feature_states.hpp>
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/platform/log.hpp>
 
 #include <mapbox/earcut.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 namespace mapbox {
@@ -97,10 +103,119 @@ void FillBucket::addGeometry(const GeometryCollection& geometry) {
     }
 }
 
+void FillBucket::addGeometry(const GeometryCollection& geometry, const Color& color) {
+    addGeometry(geometry);
+    while (colors.size() < vertices.size()) {
+        colors.emplace_back(color);
+    }
+}
+
+void FillBucket::addGeometry(const GeometryCollection& geometry, uint8_t category) {
+    addGeometry(geometry);
+    while (categories.size() < vertices.size()) {
+        categories.emplace_back(category);
+    }
+}
+
+void FillBucket::addGeometry(const GeometryCollection& geometry, const optional<FeatureIdentifier>& id) {
+    addGeometry(geometry);
+
+    // Features without an ID can't have a state, and share texel 0 with those that don't fit.
+    uint16_t texel = 0;
+    if (id && featureIDs.size() < MaxFeatureStates) {
+        featureIDs.push_back(*id);
+        texel = static_cast<uint16_t>(featureIDs.size());
+    }
+    while (featureTexels.size() < vertices.size()) {
+        featureTexels.emplace_back(texel);
+    }
+}
+
+void FillBucket::addPickingFeature(std::size_t index, const std::string& sourceLayer) {
+    uint16_t id = 0;
+    if (pickingFeatures.size() < MaxPickingFeatures) {
+        pickingFeatures.push_back(static_cast<uint32_t>(index));
+        id = static_cast<uint16_t>(pickingFeatures.size());
+    }
+    while (pickingVertices.size() < vertices.size()) {
+        pickingVertices.emplace_back(id);
+    }
+    if (pickingSourceLayer.empty()) {
+        pickingSourceLayer = sourceLayer;
+    }
+}
+
+bool FillBucket::hasFeatureColors() const {
+    return !colors.empty() || colorBuffer;
+}
+
+bool FillBucket::hasFeatureCategories() const {
+    return !categories.empty() || categoryBuffer;
+}
+
+bool FillBucket::hasFeatureStates() const {
+    return !featureTexels.empty() || featureTexelBuffer;
+}
+
+bool FillBucket::hasPickingFeatures() const {
+    return !pickingVertices.empty() || pickingBuffer;
+}
+
+optional<std::pair<std::string, std::size_t>> FillBucket::getPickedFeature(uint16_t id) const {
+    if (id == 0 || id > pickingFeatures.size()) {
+        return {};
+    }
+    return std::make_pair(pickingSourceLayer, std::size_t(pickingFeatures[id - 1]));
+}
+
+float FillBucket::getFeatureStatesHeight() const {
+    return (featureIDs.size() + 1 + FeatureStateTextureWidth - 1) / FeatureStateTextureWidth;
+}
+
+void FillBucket::bindFeatureStates(gl::Context& context, const style::FeatureStates* states, gl::TextureUnit unit) {
+    const uint64_t version = states ? states->getVersion() : 0;
+    if (!featureStateTexture || version != featureStatesVersion) {
+        const std::array<uint16_t, 2> size {{ FeatureStateTextureWidth, static_cast<uint16_t>(getFeatureStatesHeight()) }};
+
+        // Texel 0 and those of the features without a state stay transparent.
+        std::vector<uint8_t> texels(size[0] * size[1] * 4, 0);
+        if (states && !states->empty()) {
+            for (std::size_t i = 0; i < featureIDs.size(); ++i) {
+                if (optional<Color> color = states->get(featureIDs[i])) {
+                    const ColorVertex texel(*color);
+                    std::copy(texel.a_color, texel.a_color + 4, texels.begin() + (i + 1) * 4);
+                }
+            }
+        }
+
+        if (!featureStateTexture) {
+            featureStateTexture = context.createTexture(size, unit);
+        }
+        context.bindTexture(*featureStateTexture, unit);
+        MBGL_CHECK_ERROR(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size[0], size[1],
+                                         GL_RGBA, GL_UNSIGNED_BYTE, texels.data()));
+        featureStatesVersion = version;
+    } else {
+        context.bindTexture(*featureStateTexture, unit);
+    }
+}
+
 void FillBucket::upload(gl::Context& context) {
+    if (!colors.empty()) {
+        colorBuffer = context.createVertexBuffer(std::move(colors));
+    }
+    if (!categories.empty()) {
+        categoryBuffer = context.createVertexBuffer(std::move(categories));
+    }
+    if (!featureTexels.empty()) {
+        featureTexelBuffer = context.createVertexBuffer(std::move(featureTexels));
+    }
+    if (!pickingVertices.empty()) {
+        pickingBuffer = context.createVertexBuffer(std::move(pickingVertices));
+    }
     vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    lineIndexBuffer = context.createIndexBuffer(std::move(lines));
-    triangleIndexBuffer = context.createIndexBuffer(std::move(triangles));
+    lineIndexBuffer = uploadElementGroups(context, std::move(lines), lineGroups);
+    triangleIndexBuffer = uploadElementGroups(context, std::move(triangles), triangleGroups);
 
     // From now on, we're going to render during the opaque and translucent pass.
     uploaded = true;
@@ -121,64 +236,74 @@ bool FillBucket::needsClipping() const {
     return true;
 }
 
-void FillBucket::drawElements(FillShader& shader,
-                              gl::Context& context,
-                              PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : triangleGroups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *triangleIndexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * triangleIndexBuffer->primitiveSize;
+MemoryUsage FillBucket::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.cpu = util::memoryUsage(vertices) + util::memoryUsage(colors) + util::memoryUsage(categories) +
+                util::memoryUsage(featureTexels) + util::memoryUsage(featureIDs) +
+                util::memoryUsage(pickingVertices) + util::memoryUsage(pickingFeatures) + util::memoryUsage(lines) +
+                util::memoryUsage(triangles) + util::memoryUsage(lineGroups) + util::memoryUsage(triangleGroups);
+    usage.gpu = util::bufferMemoryUsage(vertexBuffer) + util::bufferMemoryUsage(colorBuffer) + util::bufferMemoryUsage(categoryBuffer) +
+                util::bufferMemoryUsage(featureTexelBuffer) + util::bufferMemoryUsage(pickingBuffer) +
+                util::bufferMemoryUsage(lineIndexBuffer) + util::bufferMemoryUsage(triangleIndexBuffer);
+    if (featureStateTexture) {
+        usage.gpu += std::size_t(featureStateTexture->size[0]) * featureStateTexture->size[1] * 4;
     }
+    return usage;
+}
+
+void FillBucket::drawElements(FillShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, triangleGroups, *vertexBuffer, *triangleIndexBuffer, context);
 }
 
 void FillBucket::drawElements(FillPatternShader& shader,
-                              gl::Context& context,
-                              PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : triangleGroups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *triangleIndexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * triangleIndexBuffer->primitiveSize;
-    }
+                              gl::Context& context) {
+    drawElementGroups(shader, triangleGroups, *vertexBuffer, *triangleIndexBuffer, context);
 }
 
 void FillBucket::drawVertices(FillOutlineShader& shader,
-                              gl::Context& context,
-                              PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : lineGroups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *lineIndexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_LINES, static_cast<GLsizei>(group.indexLength * 2), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * lineIndexBuffer->primitiveSize;
-    }
+                              gl::Context& context) {
+    drawElementGroups(shader, lineGroups, *vertexBuffer, *lineIndexBuffer, context);
 }
 
 void FillBucket::drawVertices(FillOutlinePatternShader& shader,
-                              gl::Context& context,
-                              PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : lineGroups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *lineIndexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_LINES, static_cast<GLsizei>(group.indexLength * 2), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * lineIndexBuffer->primitiveSize;
-    }
+                              gl::Context& context) {
+    drawElementGroups(shader, lineGroups, *vertexBuffer, *lineIndexBuffer, context);
+}
+
+void FillBucket::drawElements(FillDataDrivenShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, triangleGroups, *vertexBuffer, *colorBuffer, *triangleIndexBuffer, context);
+}
+
+void FillBucket::drawVertices(FillOutlineDataDrivenShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, lineGroups, *vertexBuffer, *colorBuffer, *lineIndexBuffer, context);
+}
+
+void FillBucket::drawElements(FillCategoryShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, triangleGroups, *vertexBuffer, *categoryBuffer, *triangleIndexBuffer, context);
+}
+
+void FillBucket::drawVertices(FillOutlineCategoryShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, lineGroups, *vertexBuffer, *categoryBuffer, *lineIndexBuffer, context);
+}
+
+void FillBucket::drawElements(FillFeatureStateShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, triangleGroups, *vertexBuffer, *featureTexelBuffer, *triangleIndexBuffer, context);
+}
+
+void FillBucket::drawVertices(FillOutlineFeatureStateShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, lineGroups, *vertexBuffer, *featureTexelBuffer, *lineIndexBuffer, context);
+}
+
+void FillBucket::drawElements(FillPickingShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, triangleGroups, *vertexBuffer, *pickingBuffer, *triangleIndexBuffer, context);
 }
 
 } // namespace mbgl
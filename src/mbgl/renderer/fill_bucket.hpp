@@ -6,6 +6,12 @@
 #include <mbgl/gl/vertex_buffer.hpp>
 #include <mbgl/gl/index_buffer.hpp>
 #include <mbgl/shader/fill_vertex.hpp>
+#include <mbgl/shader/color_vertex.hpp>
+#include <mbgl/shader/category_vertex.hpp>
+#include <mbgl/shader/feature_state_vertex.hpp>
+#include <mbgl/shader/picking_vertex.hpp>
+#include <mbgl/gl/texture.hpp>
+#include <mbgl/util/feature.hpp>
 
 #include <vector>
 #include <memory>
@@ -16,6 +22,17 @@ class FillShader;
 class FillPatternShader;
 class FillOutlineShader;
 class FillOutlinePatternShader;
+class FillDataDrivenShader;
+class FillOutlineDataDrivenShader;
+class FillCategoryShader;
+class FillOutlineCategoryShader;
+class FillFeatureStateShader;
+class FillOutlineFeatureStateShader;
+class FillPickingShader;
+
+namespace style {
+class FeatureStates;
+} // namespace style
 
 class FillBucket : public Bucket {
 public:
@@ -26,23 +43,85 @@ public:
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
     bool needsClipping() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void addGeometry(const GeometryCollection&);
+    // Adds a feature whose fill color is data-driven, i.e. the value of a property function for
+    // it. A bucket's features either all have colors or none does.
+    void addGeometry(const GeometryCollection&, const Color&);
+
+    // Adds a feature in the given category, or in none with NoFeatureCategory. A bucket's features
+    // either all have categories or none does.
+    void addGeometry(const GeometryCollection&, uint8_t category);
+
+    // Adds a feature whose color may be set with its state, by its ID. A bucket's features either
+    // all have feature states or none does.
+    void addGeometry(const GeometryCollection&, const optional<FeatureIdentifier>&);
+
+    // Gives the vertices of the feature that was added last a picking ID, for the picking pass to
+    // draw it with; see FillLayer::setPickable(). A bucket's features either all have picking IDs
+    // or none does.
+    void addPickingFeature(std::size_t index, const std::string& sourceLayer);
+
+    // Whether the features have colors of their own, to be drawn with the data-driven shaders.
+    bool hasFeatureColors() const;
+    // Whether the features have categories, to be drawn with the category shaders.
+    bool hasFeatureCategories() const;
+    // Whether the features have states, to be drawn with the feature state shaders.
+    bool hasFeatureStates() const;
+    // Whether the features have picking IDs, to be drawn in the picking pass.
+    bool hasPickingFeatures() const;
+
+    // The source layer and index of the feature with the picking ID, if any.
+    optional<std::pair<std::string, std::size_t>> getPickedFeature(uint16_t id) const;
+
+    // Brings the texture with the colors of the features up to date with their states, if they
+    // changed since the last call, and binds it to the unit.
+    void bindFeatureStates(gl::Context&, const style::FeatureStates*, gl::TextureUnit);
+    // The height of the feature state texture, for the shaders to find the texels in.
+    float getFeatureStatesHeight() const;
 
-    void drawElements(FillShader&, gl::Context&, PaintMode);
-    void drawElements(FillPatternShader&, gl::Context&, PaintMode);
-    void drawVertices(FillOutlineShader&, gl::Context&, PaintMode);
-    void drawVertices(FillOutlinePatternShader&, gl::Context&, PaintMode);
+    void drawElements(FillShader&, gl::Context&);
+    void drawElements(FillPatternShader&, gl::Context&);
+    void drawVertices(FillOutlineShader&, gl::Context&);
+    void drawVertices(FillOutlinePatternShader&, gl::Context&);
+    void drawElements(FillDataDrivenShader&, gl::Context&);
+    void drawVertices(FillOutlineDataDrivenShader&, gl::Context&);
+    void drawElements(FillCategoryShader&, gl::Context&);
+    void drawVertices(FillOutlineCategoryShader&, gl::Context&);
+    void drawElements(FillFeatureStateShader&, gl::Context&);
+    void drawVertices(FillOutlineFeatureStateShader&, gl::Context&);
+    void drawElements(FillPickingShader&, gl::Context&);
 
 private:
     std::vector<FillVertex> vertices;
+    // The colors of the vertices, if the features have colors.
+    std::vector<ColorVertex> colors;
+    // The categories of the vertices, if the features have categories.
+    std::vector<CategoryVertex> categories;
+    // The feature state texels of the vertices and the IDs of the features that have texels, the
+    // first of which is texel 1.
+    std::vector<FeatureStateVertex> featureTexels;
+    std::vector<FeatureIdentifier> featureIDs;
+    // The picking IDs of the vertices, and the indices of the features in their source layer that
+    // have IDs, the first of which is ID 1. Those stay on the CPU for looking up picked features.
+    std::vector<PickingVertex> pickingVertices;
+    std::vector<uint32_t> pickingFeatures;
+    std::string pickingSourceLayer;
     std::vector<gl::Line> lines;
     std::vector<gl::Triangle> triangles;
 
-    std::vector<ElementGroup<FillOutlineShader, FillOutlinePatternShader>> lineGroups;
-    std::vector<ElementGroup<FillShader, FillPatternShader>> triangleGroups;
+    std::vector<ElementGroup> lineGroups;
+    std::vector<ElementGroup> triangleGroups;
 
     optional<gl::VertexBuffer<FillVertex>> vertexBuffer;
+    optional<gl::VertexBuffer<ColorVertex>> colorBuffer;
+    optional<gl::VertexBuffer<CategoryVertex>> categoryBuffer;
+    optional<gl::VertexBuffer<FeatureStateVertex>> featureTexelBuffer;
+    optional<gl::VertexBuffer<PickingVertex>> pickingBuffer;
+    optional<gl::Texture> featureStateTexture;
+    // The version of the feature states that the texture holds the colors of.
+    uint64_t featureStatesVersion = 0;
     optional<gl::IndexBuffer<gl::Line>> lineIndexBuffer;
     optional<gl::IndexBuffer<gl::Triangle>> triangleIndexBuffer;
 };
@@ -0,0 +1,177 @@
+#include <mbgl/renderer/frame_timer.hpp>
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/timer_query.hpp>
+
+#include <chrono>
+
+namespace mbgl {
+
+namespace {
+
+// How many frames may be waiting for their GPU times. Drivers usually have their results one or
+// two frames later; if they haven't after this many, the oldest frame is given up on.
+const std::size_t maxPendingFrames = 4;
+
+std::size_t index(FrameStats::Phase phase) {
+    return static_cast<std::size_t>(phase);
+}
+
+} // namespace
+
+void FrameTimer::beginFrame(gl::Context& context_, TimePoint timePoint, bool enabled_) {
+    context = &context_;
+    enabled = enabled_;
+    gpu = enabled && gl::timerQuerySupported();
+
+    collect();
+
+    if (!enabled) {
+        queries.clear();
+        return;
+    }
+
+    frame = Frame();
+    frame.stats.timePoint = timePoint;
+    layerIndices.clear();
+    measuring = false;
+    layer = NoLayer;
+    frameStart = Clock::now();
+}
+
+void FrameTimer::endFrame() {
+    if (!enabled) {
+        return;
+    }
+
+    if (measuring) {
+        const Duration elapsed = Clock::now() - start;
+        frame.stats.phases[index(phase)].cpu += elapsed;
+        if (layer != NoLayer) {
+            frame.stats.layers[layer].cpu += elapsed;
+        }
+        if (gpu) {
+            gl::endTimerQuery();
+        }
+        measuring = false;
+    }
+    frame.stats.total.cpu = Clock::now() - frameStart;
+
+    if (!gpu) {
+        stats = std::move(frame.stats);
+        return;
+    }
+
+    pending.push_back(std::move(frame));
+    if (pending.size() > maxPendingFrames) {
+        for (auto& query : pending.front().queries) {
+            queries.push_back(std::move(query.query));
+        }
+        pending.pop_front();
+    }
+}
+
+void FrameTimer::beginPhase(FrameStats::Phase phase_) {
+    if (!enabled) {
+        return;
+    }
+    switchTo(phase_, NoLayer);
+}
+
+void FrameTimer::beginLayer(const std::string& layerID) {
+    if (!enabled) {
+        return;
+    }
+
+    auto it = layerIndices.find(layerID);
+    if (it == layerIndices.end()) {
+        it = layerIndices.emplace(layerID, frame.stats.layers.size()).first;
+        frame.stats.layers.push_back({ layerID, Duration::zero(), {} });
+    }
+    if (it->second != layer) {
+        switchTo(phase, it->second);
+    }
+}
+
+void FrameTimer::endLayer() {
+    if (!enabled || layer == NoLayer) {
+        return;
+    }
+    switchTo(phase, NoLayer);
+}
+
+void FrameTimer::switchTo(FrameStats::Phase phase_, std::size_t layer_) {
+    const TimePoint now = Clock::now();
+    if (measuring) {
+        const Duration elapsed = now - start;
+        frame.stats.phases[index(phase)].cpu += elapsed;
+        if (layer != NoLayer) {
+            frame.stats.layers[layer].cpu += elapsed;
+        }
+        if (gpu) {
+            gl::endTimerQuery();
+        }
+    }
+
+    measuring = true;
+    phase = phase_;
+    layer = layer_;
+    start = now;
+
+    if (gpu) {
+        if (queries.empty()) {
+            queries.push_back(context->createQuery());
+        }
+        gl::beginTimerQuery(queries.back());
+        frame.queries.push_back({ std::move(queries.back()), phase, layer });
+        queries.pop_back();
+    }
+}
+
+void FrameTimer::collect() {
+    if (pending.empty()) {
+        return;
+    }
+
+    // A disjoint GPU taints the results of all queries that ended since the last frame.
+    const bool disjoint = gl::timerQueriesDisjoint();
+
+    while (!pending.empty()) {
+        Frame& oldest = pending.front();
+
+        // The results of a frame's queries come in in the order they ended.
+        if (!disjoint && enabled && !oldest.queries.empty() &&
+            !gl::timerQueryAvailable(oldest.queries.back().query)) {
+            break;
+        }
+
+        // The stats of frames that can't be measured, or won't be since the timer was disabled,
+        // are published without GPU times.
+        if (!disjoint && enabled) {
+            FrameStats& frameStats = oldest.stats;
+            frameStats.total.gpu = Duration::zero();
+            for (auto& timing : frameStats.phases) {
+                timing.gpu = Duration::zero();
+            }
+            for (auto& timing : frameStats.layers) {
+                timing.gpu = Duration::zero();
+            }
+            for (const auto& query : oldest.queries) {
+                const Duration elapsed = std::chrono::duration_cast<Duration>(
+                    std::chrono::nanoseconds(gl::timerQueryResult(query.query)));
+                *frameStats.total.gpu += elapsed;
+                *frameStats.phases[index(query.phase)].gpu += elapsed;
+                if (query.layer != NoLayer) {
+                    *frameStats.layers[query.layer].gpu += elapsed;
+                }
+            }
+        }
+
+        stats = std::move(oldest.stats);
+        for (auto& query : oldest.queries) {
+            queries.push_back(std::move(query.query));
+        }
+        pending.pop_front();
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <mbgl/map/frame_stats.hpp>
+#include <mbgl/gl/object.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+namespace gl {
+class Context;
+} // namespace gl
+
+/*
+    Measures how long the phases of rendering a frame, and the layers drawn in them, take. The
+    render thread's time is read off the clock whenever the phase or layer changes. The GPU's is
+    measured with a GL_TIME_ELAPSED query per stretch of commands of the same phase and layer,
+    since they can't nest; their results come in a few frames later, and are collected at the
+    beginning of later frames without waiting for them.
+
+    While it isn't enabled for a frame, its methods do nothing but return.
+*/
+class FrameTimer : private util::noncopyable {
+public:
+    // Collects the GPU times of earlier frames that are in, and starts measuring a frame if it's
+    // `enabled`. Only call while the OpenGL context is current.
+    void beginFrame(gl::Context&, TimePoint, bool enabled);
+    void endFrame();
+
+    // Measures what follows as part of the phase, until the next phase begins.
+    void beginPhase(FrameStats::Phase);
+
+    // Measures what follows as part of the layer too, until endLayer() or the next layer.
+    void beginLayer(const std::string& layerID);
+    void endLayer();
+
+    // The stats of the latest frame whose GPU times are in, or that was rendered last if there
+    // are none to wait for.
+    const FrameStats& getStats() const { return stats; }
+
+private:
+    static constexpr std::size_t NoLayer = std::size_t(-1);
+
+    // Ends the current stretch and starts the next one.
+    void switchTo(FrameStats::Phase, std::size_t layer);
+    void collect();
+
+    struct Query {
+        gl::UniqueQuery query;
+        FrameStats::Phase phase;
+        std::size_t layer;
+    };
+
+    struct Frame {
+        FrameStats stats;
+        std::vector<Query> queries;
+    };
+
+    FrameStats stats;
+
+    gl::Context* context = nullptr;
+    bool enabled = false;
+    bool gpu = false;
+
+    Frame frame;
+    TimePoint frameStart;
+    std::unordered_map<std::string, std::size_t> layerIndices;
+
+    // The current stretch.
+    bool measuring = false;
+    FrameStats::Phase phase = FrameStats::Phase::Upload;
+    std::size_t layer = NoLayer;
+    TimePoint start;
+
+    // The frames whose GPU times are still being measured, oldest first, and the queries that
+    // are done with.
+    std::deque<Frame> pending;
+    std::vector<gl::UniqueQuery> queries;
+};
+
+} // namespace mbgl
@@ -436,7 +436,7 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
 
 void LineBucket::upload(gl::Context& context) {
     vertexBuffer = context.createVertexBuffer(std::move(vertices));
-    indexBuffer = context.createIndexBuffer(std::move(triangles));
+    indexBuffer = uploadElementGroups(context, std::move(triangles), groups);
 
     // From now on, we're only going to render during the translucent pass.
     uploaded = true;
@@ -457,58 +457,26 @@ bool LineBucket::needsClipping() const {
     return true;
 }
 
+MemoryUsage LineBucket::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.cpu = util::memoryUsage(vertices) + util::memoryUsage(triangles) + util::memoryUsage(groups);
+    usage.gpu = util::bufferMemoryUsage(vertexBuffer) + util::bufferMemoryUsage(indexBuffer);
+    return usage;
+}
+
 void LineBucket::drawLines(LineShader& shader,
-                           gl::Context& context,
-                           PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : groups) {
-        if (!group.indexLength) {
-            continue;
-        }
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *indexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * indexBuffer->primitiveSize;
-    }
+                           gl::Context& context) {
+    drawElementGroups(shader, groups, *vertexBuffer, *indexBuffer, context);
 }
 
 void LineBucket::drawLineSDF(LineSDFShader& shader,
-                             gl::Context& context,
-                             PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : groups) {
-        if (!group.indexLength) {
-            continue;
-        }
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *indexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * indexBuffer->primitiveSize;
-    }
+                             gl::Context& context) {
+    drawElementGroups(shader, groups, *vertexBuffer, *indexBuffer, context);
 }
 
 void LineBucket::drawLinePatterns(LinePatternShader& shader,
-                                  gl::Context& context,
-                                  PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET(0);
-    GLbyte* elements_index = BUFFER_OFFSET(0);
-    for (auto& group : groups) {
-        if (!group.indexLength) {
-            continue;
-        }
-        group.getVAO(shader, paintMode).bind(
-            shader, *vertexBuffer, *indexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * vertexBuffer->vertexSize;
-        elements_index += group.indexLength * indexBuffer->primitiveSize;
-    }
+                                  gl::Context& context) {
+    drawElementGroups(shader, groups, *vertexBuffer, *indexBuffer, context);
 }
 
 } // namespace mbgl
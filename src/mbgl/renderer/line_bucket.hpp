@@ -26,13 +26,14 @@ public:
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
     bool needsClipping() const override;
+    MemoryUsage getMemoryUsage() const override;
 
     void addGeometry(const GeometryCollection&);
     void addGeometry(const GeometryCoordinates& line);
 
-    void drawLines(LineShader&, gl::Context&, PaintMode);
-    void drawLineSDF(LineSDFShader&, gl::Context&, PaintMode);
-    void drawLinePatterns(LinePatternShader&, gl::Context&, PaintMode);
+    void drawLines(LineShader&, gl::Context&);
+    void drawLineSDF(LineSDFShader&, gl::Context&);
+    void drawLinePatterns(LinePatternShader&, gl::Context&);
 
 private:
     struct TriangleElement {
@@ -53,7 +54,7 @@ private:
     std::vector<LineVertex> vertices;
     std::vector<gl::Triangle> triangles;
 
-    std::vector<ElementGroup<LineShader, LineSDFShader, LinePatternShader>> groups;
+    std::vector<ElementGroup> groups;
 
     optional<gl::VertexBuffer<LineVertex>> vertexBuffer;
     optional<gl::IndexBuffer<gl::Triangle>> indexBuffer;
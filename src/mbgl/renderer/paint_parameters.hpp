@@ -4,9 +4,14 @@ namespace mbgl {
 
 class Shaders;
 
+namespace style {
+class Style;
+} // namespace style
+
 class PaintParameters {
 public:
     Shaders& shaders;
+    const style::Style& style;
 };
 
 } // namespace mbgl
@@ -1,6 +1,7 @@
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/renderer/paint_parameters.hpp>
 #include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/raster_bucket.hpp>
 
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/source_impl.hpp>
@@ -15,6 +16,9 @@
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/style/layers/custom_layer_impl.hpp>
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
 
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
@@ -27,18 +31,23 @@
 
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mat3.hpp>
+#include <mbgl/util/mat4.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <tuple>
+#include <typeindex>
 #include <unordered_set>
 
 namespace mbgl {
 
 using namespace style;
 
-Painter::Painter(const TransformState& state_)
+Painter::Painter(const TransformState& state_, const std::string& programCachePath)
     : state(state_),
       tileTriangleVertexBuffer(context.createVertexBuffer(std::vector<FillVertex> {{
             { 0,            0 },
@@ -60,11 +69,19 @@ Painter::Painter(const TransformState& state_)
             { util::EXTENT, 0, 32767, 0 },
             { 0, util::EXTENT, 0, 32767 },
             { util::EXTENT, util::EXTENT, 32767, 32767 }
+      }})),
+      circleCornerVertexBuffer(context.createVertexBuffer(std::vector<CircleCornerVertex> {{
+            { -1, -1 },
+            { 1, -1 },
+            { -1, 1 },
+            { 1, 1 }
       }})) {
 #ifndef NDEBUG
     gl::debugging::enable();
 #endif
 
+    context.setProgramCachePath(programCachePath);
+
     shaders = std::make_unique<Shaders>(context);
 #ifndef NDEBUG
     overdrawShaders = std::make_unique<Shaders>(context, gl::Shader::Overdraw);
@@ -77,7 +94,8 @@ Painter::Painter(const TransformState& state_)
 Painter::~Painter() = default;
 
 bool Painter::needsAnimation() const {
-    return frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION);
+    return pendingUploads || frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION) ||
+           frame.timePoint < symbolFadeEnd;
 }
 
 void Painter::setClipping(const ClipID& clip) {
@@ -91,25 +109,57 @@ void Painter::cleanup() {
 }
 
 void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& annotationSpriteAtlas) {
-    if (frame.framebufferSize != frame_.framebufferSize) {
-        context.viewport.setDefaultValue(
-            { 0, 0, frame_.framebufferSize[0], frame_.framebufferSize[1] });
+    const TimePoint renderStart = Clock::now();
+    frameTimer.beginFrame(context, frame_.timePoint, frame_.frameStats);
+
+    // The view's framebuffer isn't necessarily the default one, e.g. for views that render into
+    // a framebuffer object of their own. Offscreen passes bind it again by resetting the state.
+    if (viewFramebufferSize != frame_.framebufferSize) {
+        viewFramebufferSize = frame_.framebufferSize;
+        viewFramebuffer = gl::value::BindFramebuffer::Get();
     }
     frame = frame_;
 
+    // - RENDER SCALE ------------------------------------------------------------------------------
+    // Renders the frame into a texture of a fraction of the view's size, which is scaled up into
+    // the view at the end. Everything that depends on the framebuffer's size or pixel ratio is
+    // given the texture's instead.
+    bool scaled = frame.renderScale < 1 && frame.mapMode == MapMode::Continuous &&
+                  frame.debugOptions == MapDebugOptions::NoDebug && !scaledFramebufferUnsupported;
+    if (scaled) {
+        frame.framebufferSize = {{
+            static_cast<uint16_t>(std::max(1.0f, std::round(viewFramebufferSize[0] * frame.renderScale))),
+            static_cast<uint16_t>(std::max(1.0f, std::round(viewFramebufferSize[1] * frame.renderScale)))
+        }};
+        frame.pixelRatio *= frame.renderScale;
+        try {
+            scaledFramebuffer.bind(context, frame.framebufferSize, true);
+        } catch (const std::runtime_error& ex) {
+            Log::Warning(Event::OpenGL, "Not rendering at a reduced scale: %s", ex.what());
+            scaledFramebufferUnsupported = true;
+            scaled = false;
+            frame.framebufferSize = viewFramebufferSize;
+            frame.pixelRatio = frame_.pixelRatio;
+        }
+    }
+    context.bindFramebuffer.setDefaultValue(scaled ? context.bindFramebuffer.getCurrentValue()
+                                                   : viewFramebuffer);
+    context.viewport.setDefaultValue({ 0, 0, frame.framebufferSize[0], frame.framebufferSize[1] });
+
     PaintParameters parameters {
 #ifndef NDEBUG
-        paintMode() == PaintMode::Overdraw ? *overdrawShaders : *shaders
+        paintMode() == PaintMode::Overdraw ? *overdrawShaders : *shaders,
 #else
-        *shaders
+        *shaders,
 #endif
+        style
     };
 
     glyphAtlas = style.glyphAtlas.get();
     spriteAtlas = style.spriteAtlas.get();
     lineAtlas = style.lineAtlas.get();
 
-    RenderData renderData = style.getRenderData(frame.debugOptions);
+    const RenderData& renderData = style.getRenderData(frame.debugOptions);
     const std::vector<RenderItem>& order = renderData.order;
     const std::unordered_set<Source*>& sources = renderData.sources;
     const Color& background = renderData.backgroundColor;
@@ -122,23 +172,136 @@ void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& a
         pixelsToGLUnits[1] *= -1;
     }
 
+    if (frame.imageSize[0] && frame.imageSize[1]) {
+        // Stretches the part of the image that the frame renders over the whole framebuffer.
+        const double scaleX = double(frame.imageSize[0]) / frame.framebufferSize[0];
+        const double scaleY = double(frame.imageSize[1]) / frame.framebufferSize[1];
+        const double centerX = (frame.imageOffset[0] + frame.framebufferSize[0] / 2.0) / frame.imageSize[0] * 2 - 1;
+        const double centerY = 1 - (frame.imageOffset[1] + frame.framebufferSize[1] / 2.0) / frame.imageSize[1] * 2;
+
+        mat4 part;
+        matrix::identity(part);
+        matrix::scale(part, part, scaleX, scaleY, 1);
+        matrix::translate(part, part, -centerX, -centerY, 0);
+        matrix::multiply(projMatrix, part, projMatrix);
+
+        pixelsToGLUnits[0] *= scaleX;
+        pixelsToGLUnits[1] *= scaleY;
+    }
+
     frameHistory.record(frame.timePoint, state.getZoom(),
         frame.mapMode == MapMode::Continuous ? util::DEFAULT_FADE_DURATION : Milliseconds(0));
 
+    // Whether any tile or bucket was uploaded in this frame, and may look different than before.
+    bool uploadedData = false;
+
     // - UPLOAD PASS -------------------------------------------------------------------------------
     // Uploads all required buffers and images before we do any actual rendering.
+    frameTimer.beginPhase(FrameStats::Phase::Upload);
     {
         MBGL_DEBUG_GROUP("upload");
 
         spriteAtlas->upload(context, 0);
+        lineAtlas->nextFrame();
         lineAtlas->upload(context, 0);
         glyphAtlas->upload(context, 0);
         frameHistory.upload(context, 0);
         annotationSpriteAtlas.upload(context, 0);
 
+        // In continuous mode, tiles are uploaded closest to the center of the map first, until the
+        // frame's upload budget is spent; the rest are deferred to later frames. Buckets that
+        // haven't been uploaded aren't rendered, and tiles whose first data hasn't been uploaded
+        // aren't renderable, so their parent or child tiles are rendered in their place meanwhile.
+        const TimePoint uploadStart = Clock::now();
+        auto budgetSpent = [&] {
+            return frame.mapMode == MapMode::Continuous &&
+                   Clock::now() - uploadStart > frame.uploadBudget;
+        };
+
+        const LatLng center = state.getLatLng();
+        std::vector<std::pair<double, Tile*>> pendingTiles;
+        for (const auto& source : sources) {
+            for (Tile* tile : source->baseImpl->getTilesNeedingUpload()) {
+                // Distance from the center at zoom level 0, so that tiles of all zoom levels compare.
+                const CanonicalTileID& id = tile->id.canonical;
+                const double scale = std::pow(2.0, id.z);
+                const TileCoordinatePoint point = TileCoordinate::fromLatLng(id.z, center).p;
+                const double dx = (id.x + 0.5 - point.x) / scale;
+                const double dy = (id.y + 0.5 - point.y) / scale;
+                pendingTiles.emplace_back(dx * dx + dy * dy, tile);
+            }
+        }
+
+        std::sort(pendingTiles.begin(), pendingTiles.end(), [] (const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        bool uploaded = false;
+        pendingUploads = false;
+
+        for (const auto& pending : pendingTiles) {
+            // Uploads always make progress, however small the budget. Tiles that upload in parts,
+            // like large raster images, upload as many of them as the budget allows.
+            if (uploaded && budgetSpent()) {
+                pendingUploads = true;
+                break;
+            }
+            do {
+                pending.second->upload(context);
+                uploaded = true;
+            } while (pending.second->needsUpload() && !budgetSpent());
+        }
+        uploadedData = uploaded;
+
+        // Buckets that their tile doesn't upload itself, e.g. raster buckets.
         for (const auto& item : order) {
             if (item.bucket && item.bucket->needsUpload()) {
+                if (budgetSpent()) {
+                    pendingUploads = true;
+                    break;
+                }
                 item.bucket->upload(context);
+                uploadedData = true;
+            }
+        }
+
+        // Moved dynamic points are uploaded regardless of the budget; they're small, and moving
+        // them is the point of these layers.
+        for (auto& pair : dynamicPointBuffers) {
+            pair.second.used = false;
+        }
+        for (const auto& item : order) {
+            if (const DynamicPointLayer* layer = item.layer.as<DynamicPointLayer>()) {
+                uploadDynamicPoints(*layer);
+            }
+        }
+        for (auto it = dynamicPointBuffers.begin(); it != dynamicPointBuffers.end();) {
+            if (!it->second.used) {
+                it = dynamicPointBuffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // Tiles that were uploaded for the first time become renderable with the next update.
+        if (uploaded) {
+            pendingUploads = true;
+        }
+    }
+
+    // - PREPARE -----------------------------------------------------------------------------------
+    // Renders the slope and aspect of the DEM tiles that were uploaded or backfilled into textures,
+    // which are hillshaded in the translucent pass. Binds framebuffers of their own.
+    frameTimer.beginPhase(FrameStats::Phase::Prepare);
+    {
+        MBGL_DEBUG_GROUP("prepare");
+
+        for (const auto& item : order) {
+            if (item.tile && item.bucket && item.layer.is<RasterLayer>()) {
+                auto& bucket = static_cast<RasterBucket&>(*item.bucket);
+                if (bucket.needsPreparation()) {
+                    prepareDEM(parameters, bucket, *item.tile);
+                }
             }
         }
     }
@@ -146,6 +309,7 @@ void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& a
     // - CLEAR -------------------------------------------------------------------------------------
     // Renders the backdrop of the OpenGL view. This also paints in areas where we don't have any
     // tiles whatsoever.
+    frameTimer.beginPhase(FrameStats::Phase::Clear);
     {
         MBGL_DEBUG_GROUP("clear");
         context.bindFramebuffer.reset();
@@ -174,21 +338,46 @@ void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& a
 
     // - CLIPPING MASKS ----------------------------------------------------------------------------
     // Draws the clipping masks to the stencil buffer.
+    frameTimer.beginPhase(FrameStats::Phase::Clip);
     {
         MBGL_DEBUG_GROUP("clip");
 
-        // Update all clipping IDs.
-        algorithm::ClipIDGenerator generator;
+        // Update all clipping IDs, unless the render tiles are the same as in the last frame, and
+        // still have theirs.
+        if (renderData.serial != clipIDsRenderData) {
+            algorithm::ClipIDGenerator generator;
+            for (const auto& source : sources) {
+                source->baseImpl->updateClipIDs(generator);
+            }
+            clipStencils = generator.getStencils();
+            clipIDsRenderData = renderData.serial;
+        }
+
         for (const auto& source : sources) {
-            source->baseImpl->startRender(generator, projMatrix, state);
+            source->baseImpl->startRender(projMatrix, state);
         }
 
-        drawClippingMasks(parameters, generator.getStencils());
+        // The masks themselves are drawn in every frame; the stencil buffer doesn't necessarily
+        // survive swapping the buffers.
+        drawClippingMasks(parameters, clipStencils);
+    }
+
+    // - CULLING -----------------------------------------------------------------------------------
+    // Skips render tiles that are outside of the viewport, e.g. ones that the tile cover of a
+    // pitched map includes, and, under pitch, ones near the horizon that cover only a few pixels.
+    // Since the tiles are clipped to their bounds, nothing of them would be visible otherwise.
+    {
+        const double minArea = state.getPitch() != 0 ? util::MIN_TILE_SCREEN_AREA : 0;
+        culledTiles = 0;
+        for (const auto& source : sources) {
+            culledTiles += source->baseImpl->cullRenderTiles(state, minArea);
+        }
     }
 
 #if not MBGL_USE_GLES2 and not defined(NDEBUG)
     if (frame.debugOptions & MapDebugOptions::StencilClip) {
         renderClipMasks();
+        frameTimer.endFrame();
         return;
     }
 #endif
@@ -199,24 +388,91 @@ void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& a
     // TODO: Correctly compute the number of layers recursively beforehand.
     depthRangeSize = 1 - (order.size() + 2) * numSublayers * depthEpsilon;
 
-    // - OPAQUE PASS -------------------------------------------------------------------------------
-    // Render everything top-to-bottom by using reverse iterators. Render opaque objects first.
-    renderPass(parameters,
-               RenderPass::Opaque,
-               order.rbegin(), order.rend(),
-               0, 1);
+    // - TILE TEXTURES -----------------------------------------------------------------------------
+    // Renders the layers of sources that cache them into a texture per tile, where the textures
+    // of the last frame can't be reused; see Source::setTileTextureCaching().
+    frameTimer.beginPhase(FrameStats::Phase::TileTextures);
+    updateTileTextures(parameters, renderData);
+
+    // - BASE LAYERS -------------------------------------------------------------------------------
+    // While symbols fade in and out after the map stopped moving, only the symbol layers and the
+    // layers above them look different from one frame to the next. The render items below the
+    // first symbol layer are then rendered once into a texture, and drawn from it instead for the
+    // rest of the fade.
+    const std::size_t baseItems = countBaseItems(order);
+    const std::size_t upperItems = order.size() - baseItems;
+    frameTimer.beginPhase(FrameStats::Phase::BaseLayers);
+    {
+        if (!baseItems) {
+            baseLayers.texture = {};
+            baseLayers.renderData = 0;
+        } else if (uploadedData) {
+            // The texture may lack what was just uploaded.
+            baseLayers.renderData = 0;
+        }
 
-    // - TRANSLUCENT PASS --------------------------------------------------------------------------
-    // Make a second pass, rendering translucent objects. This time, we render bottom-to-top.
-    renderPass(parameters,
-               RenderPass::Translucent,
-               order.begin(), order.end(),
-               static_cast<GLsizei>(order.size()) - 1, -1);
+        reusedBaseLayers = baseItems &&
+            baseLayers.renderData == renderData.serial &&
+            baseLayers.items == baseItems &&
+            baseLayers.projMatrix == projMatrix &&
+            baseLayers.pixelsToGLUnits == pixelsToGLUnits &&
+            baseLayers.pixelRatio == frame.pixelRatio &&
+            baseLayers.framebufferSize == frame.framebufferSize;
+
+        // Rendering them offscreen only pays off once the map stands still; while it moves, it's
+        // a wasted pass every frame.
+        if (baseItems && !reusedBaseLayers && !uploadedData && projMatrix == previousProjMatrix) {
+            reusedBaseLayers = renderBaseLayers(parameters, order, baseItems);
+            if (reusedBaseLayers) {
+                baseLayers.renderData = renderData.serial;
+                baseLayers.items = baseItems;
+                baseLayers.projMatrix = projMatrix;
+                baseLayers.pixelsToGLUnits = pixelsToGLUnits;
+                baseLayers.pixelRatio = frame.pixelRatio;
+                baseLayers.framebufferSize = frame.framebufferSize;
+            }
+        }
+
+        previousProjMatrix = projMatrix;
+    }
+
+    if (reusedBaseLayers) {
+        drawBaseLayers(parameters);
+
+        frameTimer.beginPhase(FrameStats::Phase::Opaque);
+        renderPass(parameters,
+                   RenderPass::Opaque,
+                   order.rbegin(), order.rbegin() + upperItems,
+                   0, 1);
+
+        frameTimer.beginPhase(FrameStats::Phase::Translucent);
+        renderPass(parameters,
+                   RenderPass::Translucent,
+                   order.begin() + baseItems, order.end(),
+                   static_cast<GLsizei>(upperItems) - 1, -1);
+    } else {
+        // - OPAQUE PASS ---------------------------------------------------------------------------
+        // Render everything top-to-bottom by using reverse iterators. Render opaque objects first.
+        frameTimer.beginPhase(FrameStats::Phase::Opaque);
+        renderPass(parameters,
+                   RenderPass::Opaque,
+                   order.rbegin(), order.rend(),
+                   0, 1);
+
+        // - TRANSLUCENT PASS ----------------------------------------------------------------------
+        // Make a second pass, rendering translucent objects. This time, we render bottom-to-top.
+        frameTimer.beginPhase(FrameStats::Phase::Translucent);
+        renderPass(parameters,
+                   RenderPass::Translucent,
+                   order.begin(), order.end(),
+                   static_cast<GLsizei>(order.size()) - 1, -1);
+    }
 
     if (debug::renderTree) { Log::Info(Event::Render, "}"); indent--; }
 
     // - DEBUG PASS --------------------------------------------------------------------------------
     // Renders debug overlays.
+    frameTimer.beginPhase(FrameStats::Phase::Debug);
     {
         MBGL_DEBUG_GROUP("debug");
 
@@ -235,6 +491,33 @@ void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& a
     }
 #endif
 
+    // - PICKING PASS ------------------------------------------------------------------------------
+    // Renders the features of pickable layers, in colors that tell them apart, into a framebuffer
+    // of their own, for point queries to read a pixel of.
+    frameTimer.beginPhase(FrameStats::Phase::Picking);
+    renderPicking(parameters, order);
+
+    frameTimer.beginPhase(FrameStats::Phase::Finish);
+    if (scaled) {
+        MBGL_DEBUG_GROUP("scale");
+
+        context.bindFramebuffer.setDefaultValue(viewFramebuffer);
+        context.viewport.setDefaultValue({ 0, 0, viewFramebufferSize[0], viewFramebufferSize[1] });
+        context.bindFramebuffer.reset();
+        context.viewport.reset();
+
+        // The texture covers the whole framebuffer, with the same orientation.
+        mat4 matrix;
+        matrix::ortho(matrix, 0, util::EXTENT, 0, util::EXTENT, -1, 1);
+
+        context.blend = false;
+        context.depthTest = false;
+        context.stencilTest = false;
+        context.colorMask = { true, true, true, true };
+
+        drawTexture(parameters, scaledFramebuffer.getTexture(), matrix, gl::TextureFilter::Linear);
+    }
+
     // TODO: Find a better way to unbind VAOs after we're done with them without introducing
     // unnecessary bind(0)/bind(N) sequences.
     {
@@ -251,6 +534,10 @@ void Painter::render(const Style& style, const FrameData& frame_, SpriteAtlas& a
     if (frame.contextMode == GLContextMode::Shared) {
         context.setDirtyState();
     }
+
+    frameTimer.endFrame();
+    statistics = context.takeStatistics();
+    frameDuration = Clock::now() - renderStart;
 }
 
 template <class Iterator>
@@ -267,14 +554,180 @@ void Painter::renderPass(PaintParameters& parameters,
                   pass == RenderPass::Opaque ? "opaque" : "translucent");
     }
 
-    for (; it != end; ++it, i += increment) {
-        currentLayer = i;
+    if (pass == RenderPass::Opaque && (frame.debugOptions & MapDebugOptions::SortOpaquePass)) {
+        // Opaque items are drawn with depth testing and without blending, so the order in which
+        // they are drawn doesn't change the result as long as each keeps its own depth range. Group
+        // them by layer type, i.e. by shader, and by tile, i.e. by stencil clip. Within a group,
+        // the stable sort keeps the items in front-to-back order.
+        std::vector<std::pair<const RenderItem*, uint32_t>> items;
+        for (; it != end; ++it, i += increment) {
+            items.emplace_back(&*it, i);
+        }
+        std::stable_sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+            return std::make_tuple(std::type_index(typeid(*a.first->layer.baseImpl)), a.first->tile) <
+                   std::make_tuple(std::type_index(typeid(*b.first->layer.baseImpl)), b.first->tile);
+        });
+        for (const auto& item : items) {
+            currentLayer = item.second;
+            renderItem(parameters, *item.first);
+        }
+    } else {
+        for (; it != end; ++it, i += increment) {
+            currentLayer = i;
+            renderItem(parameters, *it);
+        }
+    }
+
+    batch = LayerBatch();
+    frameTimer.endLayer();
+
+    if (debug::renderTree) {
+        Log::Info(Event::Render, "%*s%s", --indent * 4, "", "}");
+    }
+}
+
+// The passes over render items are also made by painter_tile_textures.cpp.
+template void Painter::renderPass(PaintParameters&, RenderPass,
+                                  std::vector<RenderItem>::const_iterator,
+                                  std::vector<RenderItem>::const_iterator,
+                                  uint32_t, int8_t);
+template void Painter::renderPass(PaintParameters&, RenderPass,
+                                  std::vector<RenderItem>::const_reverse_iterator,
+                                  std::vector<RenderItem>::const_reverse_iterator,
+                                  uint32_t, int8_t);
+
+std::size_t Painter::countBaseItems(const std::vector<RenderItem>& order) const {
+    if (frame.mapMode != MapMode::Continuous || frame.debugOptions != MapDebugOptions::NoDebug ||
+        paintMode() != PaintMode::Regular || baseLayersUnsupported ||
+        (!frameHistory.needsAnimation(util::DEFAULT_FADE_DURATION) && frame.timePoint >= symbolFadeEnd)) {
+        return 0;
+    }
+
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const Layer& layer = order[i].layer;
+        if (layer.is<SymbolLayer>()) {
+            return i;
+        } else if (layer.is<CustomLayer>() || layer.is<DynamicPointLayer>()) {
+            // Custom layers may change on their own accord, and dynamic points move in between.
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+bool Painter::renderBaseLayers(PaintParameters& parameters,
+                               const std::vector<RenderItem>& order,
+                               std::size_t baseItems) {
+    MBGL_DEBUG_GROUP("base layers");
+
+    // The texture can't have the view's multisampling, so the layers would look different.
+    GLint sampleBuffers = 0;
+    MBGL_CHECK_ERROR(glGetIntegerv(GL_SAMPLE_BUFFERS, &sampleBuffers));
+    if (sampleBuffers > 0) {
+        baseLayersUnsupported = true;
+        return false;
+    }
+
+    try {
+        if (!baseLayers.texture) {
+            baseLayers.texture.emplace();
+        }
+        baseLayers.texture->bind(context, frame.framebufferSize, true);
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::OpenGL, "Not reusing layers while symbols fade: %s", ex.what());
+        baseLayersUnsupported = true;
+        baseLayers.texture = {};
+        context.bindFramebuffer.reset();
+        context.viewport.reset();
+        return false;
+    }
+
+    // Start out the same way as the view's framebuffer; see render().
+    context.stencilMask = 0xFF;
+    context.depthMask = true;
+    context.colorMask = { true, true, true, true };
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    drawClippingMasks(parameters, clipStencils);
 
-        const auto& item = *it;
-        const Layer& layer = item.layer;
+    const std::size_t upperItems = order.size() - baseItems;
+    renderPass(parameters,
+               RenderPass::Opaque,
+               order.rbegin() + upperItems, order.rend(),
+               static_cast<uint32_t>(upperItems), 1);
+    renderPass(parameters,
+               RenderPass::Translucent,
+               order.begin(), order.begin() + baseItems,
+               static_cast<GLsizei>(order.size()) - 1, -1);
+
+    context.bindFramebuffer.reset();
+    context.viewport.reset();
+    return true;
+}
+
+void Painter::drawBaseLayers(PaintParameters& parameters) {
+    MBGL_DEBUG_GROUP("base layers");
+
+    // The texture covers the whole framebuffer, with the same orientation.
+    mat4 matrix;
+    matrix::ortho(matrix, 0, util::EXTENT, 0, util::EXTENT, -1, 1);
+
+    // The texture replaces what the cleared framebuffer holds, and leaves its depth buffer alone,
+    // so that the layers above are rendered as usual.
+    context.blend = false;
+    context.depthTest = false;
+    context.stencilTest = false;
+    context.colorMask = { true, true, true, true };
+
+    drawTexture(parameters, baseLayers.texture->getTexture(), matrix, gl::TextureFilter::Nearest);
+}
+
+void Painter::drawTexture(PaintParameters& parameters,
+                          gl::Texture& texture,
+                          const mat4& matrix,
+                          gl::TextureFilter filter) {
+    auto& rasterShader = parameters.shaders.raster();
+
+    context.program = rasterShader.getID();
+    rasterShader.u_matrix = matrix;
+    rasterShader.u_buffer_scale = 1.0f;
+    rasterShader.u_opacity0 = 1.0f;
+    rasterShader.u_opacity1 = 0;
+    rasterShader.u_brightness_low = 0.0f;
+    rasterShader.u_brightness_high = 1.0f;
+    rasterShader.u_saturation_factor = saturationFactor(0);
+    rasterShader.u_contrast_factor = contrastFactor(0);
+    rasterShader.u_spin_weights = spinWeights(0);
+    rasterShader.u_image0 = 0; // GL_TEXTURE0
+    rasterShader.u_image1 = 1; // GL_TEXTURE1
+    rasterShader.u_tl_parent = {{ 0.0f, 0.0f }};
+    rasterShader.u_scale_parent = 1.0f;
+
+    context.bindTexture(texture, 0, filter);
+    context.bindTexture(texture, 1, filter);
+    context.bindVertexArray(rasterShader, rasterVertexBuffer, BUFFER_OFFSET_0);
+    MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(rasterVertexBuffer.vertexCount)));
+}
+
+void Painter::renderItem(PaintParameters& parameters, const RenderItem& item) {
+    const Layer& layer = item.layer;
 
-        if (!layer.baseImpl->hasRenderPass(pass))
-            continue;
+    if (!layer.baseImpl->hasRenderPass(pass))
+        return;
+
+    if (item.bucket && item.bucket->needsUpload())
+        return;
+
+    // Symbols aren't clipped to their tile, so they may still show up on screen.
+    if (item.tile && item.tile->culled && !layer.is<SymbolLayer>())
+        return;
+
+    // The render items of a layer are consecutive, one per tile, unless the opaque pass is sorted.
+    // Set up what they have in common once for the whole run; only the tile's matrix and clipping differ in between.
+    if (batch.layer != &layer) {
+        batch = LayerBatch();
+        batch.layer = &layer;
+        frameTimer.beginLayer(layer.baseImpl->id);
 
         if (paintMode() == PaintMode::Overdraw) {
             context.blend = true;
@@ -288,33 +741,48 @@ void Painter::renderPass(PaintParameters& parameters,
 
         context.colorMask = { true, true, true, true };
         context.stencilMask = 0x0;
+    }
 
-        if (layer.is<BackgroundLayer>()) {
-            MBGL_DEBUG_GROUP("background");
-            renderBackground(parameters, *layer.as<BackgroundLayer>());
-        } else if (layer.is<CustomLayer>()) {
-            MBGL_DEBUG_GROUP(layer.baseImpl->id + " - custom");
-            context.vertexArrayObject = 0;
-            context.depthFunc = gl::DepthTestFunction::LessEqual;
-            context.depthTest = true;
-            context.depthMask = false;
-            context.stencilTest = false;
-            setDepthSublayer(0);
-            layer.as<CustomLayer>()->impl->render(state);
-            context.setDirtyState();
-            context.bindFramebuffer.reset();
-            context.viewport.reset();
-        } else {
-            MBGL_DEBUG_GROUP(layer.baseImpl->id + " - " + util::toString(item.tile->id));
-            if (item.bucket->needsClipping()) {
-                setClipping(item.tile->clip);
+    // The items of a run of layers whose tile texture is current are all drawn at once, in the
+    // place of the bottommost one.
+    if (!renderingTileTexture && item.tile) {
+        auto run = tileTextureLayers.find(&layer);
+        if (run != tileTextureLayers.end()) {
+            auto it = tileTextures.find({ run->second, item.tile->id });
+            if (it != tileTextures.end() && it->second.current) {
+                if (pass == RenderPass::Translucent && !it->second.drawn) {
+                    drawTileTexture(parameters, it->second, *item.tile);
+                    it->second.drawn = true;
+                }
+                return;
             }
-            item.bucket->render(*this, parameters, layer, *item.tile);
         }
     }
 
-    if (debug::renderTree) {
-        Log::Info(Event::Render, "%*s%s", --indent * 4, "", "}");
+    if (layer.is<BackgroundLayer>()) {
+        MBGL_DEBUG_GROUP("background");
+        renderBackground(parameters, *layer.as<BackgroundLayer>());
+    } else if (layer.is<CustomLayer>()) {
+        MBGL_DEBUG_GROUP(layer.baseImpl->id + " - custom");
+        context.vertexArrayObject = 0;
+        context.depthFunc = gl::DepthTestFunction::LessEqual;
+        context.depthTest = true;
+        context.depthMask = false;
+        context.stencilTest = false;
+        setDepthSublayer(0);
+        layer.as<CustomLayer>()->impl->render(state);
+        context.setDirtyState();
+        context.bindFramebuffer.reset();
+        context.viewport.reset();
+    } else if (layer.is<DynamicPointLayer>()) {
+        MBGL_DEBUG_GROUP(layer.baseImpl->id + " - dynamic points");
+        renderDynamicPoints(parameters, *layer.as<DynamicPointLayer>());
+    } else {
+        MBGL_DEBUG_GROUP(layer.baseImpl->id + " - " + util::toString(item.tile->id));
+        if (item.bucket->needsClipping()) {
+            setClipping(item.tile->clip);
+        }
+        item.bucket->render(*this, parameters, layer, *item.tile);
     }
 }
 
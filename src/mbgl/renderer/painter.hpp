@@ -5,31 +5,37 @@
 #include <mbgl/tile/tile_id.hpp>
 
 #include <mbgl/renderer/frame_history.hpp>
+#include <mbgl/renderer/frame_timer.hpp>
 #include <mbgl/renderer/render_item.hpp>
 #include <mbgl/renderer/bucket.hpp>
 
-#include <mbgl/gl/vao.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/shader/fill_vertex.hpp>
 #include <mbgl/shader/raster_vertex.hpp>
+#include <mbgl/shader/circle_vertex.hpp>
+#include <mbgl/shader/dynamic_point_vertex.hpp>
+
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/geometry/line_atlas.hpp>
 
 #include <mbgl/style/style.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+#include <mbgl/util/clip_id.hpp>
 
 #include <array>
 #include <vector>
 #include <set>
 #include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
 class RenderTile;
-class SpriteAtlas;
 class GlyphAtlas;
-class LineAtlas;
 struct FrameData;
 class Tile;
 
@@ -44,8 +50,6 @@ class Shaders;
 class SymbolSDFShader;
 class PaintParameters;
 
-struct ClipID;
-
 namespace style {
 class Style;
 class Source;
@@ -55,6 +59,7 @@ class CircleLayer;
 class SymbolLayer;
 class RasterLayer;
 class BackgroundLayer;
+class DynamicPointLayer;
 } // namespace style
 
 struct FrameData {
@@ -64,11 +69,28 @@ struct FrameData {
     MapMode mapMode;
     GLContextMode contextMode;
     MapDebugOptions debugOptions;
+
+    // How long uploads may take per frame in continuous mode; see Map::setFrameUploadBudget().
+    Duration uploadBudget;
+
+    // The size of the framebuffer that the frame is rendered into, relative to the view's, which
+    // it's scaled up to fill; see Map::setAdaptiveQuality().
+    float renderScale = 1;
+
+    // When a still image that's larger than the framebuffer is rendered in parts, the size of the
+    // whole image and the position of the part the frame renders in it, in framebuffer pixels from
+    // the top left; see Map::renderStillTiled(). The image is the framebuffer otherwise.
+    std::array<uint16_t, 2> imageSize = {{ 0, 0 }};
+    std::array<uint16_t, 2> imageOffset = {{ 0, 0 }};
+
+    // Whether to measure how long the phases and layers of the frame take; see
+    // Map::setFrameStatsEnabled().
+    bool frameStats = false;
 };
 
 class Painter : private util::noncopyable {
 public:
-    Painter(const TransformState&);
+    Painter(const TransformState&, const std::string& programCachePath = {});
     ~Painter();
 
     void render(const style::Style&,
@@ -96,7 +118,9 @@ public:
     void renderCircle(PaintParameters&, CircleBucket&, const style::CircleLayer&, const RenderTile&);
     void renderSymbol(PaintParameters&, SymbolBucket&, const style::SymbolLayer&, const RenderTile&);
     void renderRaster(PaintParameters&, RasterBucket&, const style::RasterLayer&, const RenderTile&);
+    void prepareDEM(PaintParameters&, RasterBucket&, const RenderTile&);
     void renderBackground(PaintParameters&, const style::BackgroundLayer&);
+    void renderDynamicPoints(PaintParameters&, const style::DynamicPointLayer&);
 
     float saturationFactor(float saturation);
     float contrastFactor(float contrast);
@@ -106,6 +130,33 @@ public:
 
     bool needsAnimation() const;
 
+    // The OpenGL state changes made while rendering the last frame.
+    const gl::Context::Statistics& getStatistics() const { return statistics; }
+
+    // The number of render tiles that were skipped in the last frame for covering (almost)
+    // nothing of the viewport.
+    std::size_t getCulledTileCount() const { return culledTiles; }
+
+    // Whether the last frame drew the layers below the symbols from a texture rendered in an
+    // earlier frame, while only the symbols faded.
+    bool getReusedBaseLayers() const { return reusedBaseLayers; }
+
+    // How long rendering the last frame took, not counting the time the GPU takes after that.
+    Duration getFrameDuration() const { return frameDuration; }
+
+    // How long the phases and layers of a recent frame took, if it was measured; see FrameTimer.
+    const FrameStats& getFrameStats() const { return frameTimer.getStats(); }
+
+    // The feature of a pickable layer that the picking pass of the last frame drew at the point
+    // of the view, by its layer, the render tile it was drawn for, and its picking ID in the
+    // tile's bucket for the layer. Reads a pixel back from the GPU, so the view must be active.
+    struct PickedFeature {
+        std::string layerID;
+        UnwrappedTileID tileID;
+        uint16_t id;
+    };
+    optional<PickedFeature> readPickedFeature(const ScreenCoordinate&);
+
 private:
     std::vector<RenderItem> determineRenderOrder(const style::Style&);
 
@@ -114,6 +165,36 @@ private:
                     RenderPass,
                     Iterator it, Iterator end,
                     uint32_t i, int8_t increment);
+    void renderItem(PaintParameters&, const RenderItem&);
+
+    // The number of render items below the first symbol layer if they may be rendered into a
+    // texture and reused for later frames, or 0.
+    std::size_t countBaseItems(const std::vector<RenderItem>&) const;
+    bool renderBaseLayers(PaintParameters&, const std::vector<RenderItem>&, std::size_t baseItems);
+    void drawBaseLayers(PaintParameters&);
+
+    // Renders the fill layers that are pickable into the picking framebuffer, at a fraction of the
+    // frame's size; see FillLayer::setPickable() and readPickedFeature().
+    void renderPicking(PaintParameters&, const std::vector<RenderItem>&);
+
+    // Draws a texture with the raster shader; the caller sets up blending, depth and stencil.
+    void drawTexture(PaintParameters&, gl::Texture&, const mat4&, gl::TextureFilter);
+
+    struct TileTexture;
+
+    // Renders the tile textures of sources that cache them; see Source::setTileTextureCaching().
+    void updateTileTextures(PaintParameters&, const RenderData&);
+    bool renderTileTexture(PaintParameters&,
+                           TileTexture&,
+                           const RenderTile&,
+                           const std::vector<RenderItem>&,
+                           const std::array<double, 2>& origin,
+                           const std::array<uint16_t, 2>& size);
+    void drawTileTexture(PaintParameters&, TileTexture&, const RenderTile&);
+
+    // Uploads the points of the layer that moved since the last frame, or all of them to a new
+    // buffer if there are more or fewer.
+    void uploadDynamicPoints(const style::DynamicPointLayer&);
 
     void setClipping(const ClipID&);
 
@@ -122,7 +203,7 @@ private:
                    float scaleDivisor,
                    std::array<float, 2> texsize,
                    SymbolSDFShader& sdfShader,
-                   void (SymbolBucket::*drawSDF)(SymbolSDFShader&, gl::Context&, PaintMode),
+                   void (SymbolBucket::*drawSDF)(SymbolSDFShader&, gl::Context&),
 
                    // Layout
                    style::AlignmentType rotationAlignment,
@@ -139,6 +220,9 @@ private:
                    style::TranslateAnchorType translateAnchor,
                    float paintSize);
 
+    // How far the symbols of the bucket have faded since their placement, for their shaders.
+    float getSymbolFadeChange(const SymbolBucket&);
+
     void setDepthSublayer(int n);
 
 #ifndef NDEBUG
@@ -174,6 +258,21 @@ private:
 
     int numSublayers = 3;
     uint32_t currentLayer;
+
+    // Values that are the same for all tiles of a layer, looked up once for each run of render
+    // items of the same layer rather than for every tile. renderPass() resets it when the layer
+    // changes.
+    struct LayerBatch {
+        const style::Layer* layer = nullptr;
+
+        bool patternResolved = false;
+        optional<SpriteAtlasPosition> patternPosA;
+        optional<SpriteAtlasPosition> patternPosB;
+
+        optional<LinePatternCap> dashCap;
+        LinePatternPos dashPosA;
+        LinePatternPos dashPosB;
+    } batch;
     float depthRangeSize;
     const float depthEpsilon = 1.0f / (1 << 16);
 
@@ -183,6 +282,101 @@ private:
 
     FrameHistory frameHistory;
 
+    // Until when the symbols rendered so far fade in or out after their placement.
+    TimePoint symbolFadeEnd = TimePoint::min();
+
+    gl::Context::Statistics statistics;
+    std::size_t culledTiles = 0;
+
+    // The clipping masks of the render tiles, and the render data they were generated for.
+    std::map<UnwrappedTileID, ClipID> clipStencils;
+    uint64_t clipIDsRenderData = 0;
+
+    // The layers below the symbols, and what they were rendered with; see render().
+    struct BaseLayers {
+        optional<OffscreenTexture> texture;
+        uint64_t renderData = 0;
+        std::size_t items = 0;
+        mat4 projMatrix {};
+        std::array<float, 2> pixelsToGLUnits = {{ 0, 0 }};
+        float pixelRatio = 0;
+        std::array<uint16_t, 2> framebufferSize = {{ 0, 0 }};
+    } baseLayers;
+    mat4 previousProjMatrix {};
+    bool reusedBaseLayers = false;
+    bool baseLayersUnsupported = false;
+
+    // The layers of a run of consecutive layers of a source, rendered for one of its tiles.
+    struct TileTexture {
+        optional<gl::Texture> texture;
+
+        // What the texture was rendered with.
+        uint64_t styleSerial = 0;
+        double zoom = 0;
+        double angle = 0;
+        float pixelRatio = 0;
+        std::vector<const Bucket*> buckets;
+
+        // From the texture's lower left corner to the tile's origin, in window coordinates.
+        std::array<double, 2> offset = {{ 0, 0 }};
+
+        // Whether the texture may be drawn in place of the layers in this frame.
+        bool current = false;
+        bool used = false;
+        bool drawn = false;
+    };
+
+    // Keyed by the bottom layer of the run, and the tile.
+    using TileTextureKey = std::pair<const style::Layer*, UnwrappedTileID>;
+    std::map<TileTextureKey, TileTexture> tileTextures;
+
+    // The bottom layer of the run that each layer belongs to, in this frame.
+    std::unordered_map<const style::Layer*, const style::Layer*> tileTextureLayers;
+
+    // Where the tile textures are rendered before they're copied into their own textures. Only
+    // ever grows, so that it needn't be recreated for tiles of different sizes.
+    OffscreenTexture tileTextureFramebuffer;
+    std::array<uint16_t, 2> tileTextureFramebufferSize = {{ 0, 0 }};
+    int32_t maxTextureSize = 0;
+    bool renderingTileTexture = false;
+    bool tileTexturesUnsupported = false;
+
+    // The framebuffer of the view, which frames with a render scale below 1 are drawn into at
+    // the end, from the texture they're rendered into.
+    gl::FramebufferID viewFramebuffer = 0;
+    std::array<uint16_t, 2> viewFramebufferSize = {{ 0, 0 }};
+    OffscreenTexture scaledFramebuffer;
+    bool scaledFramebufferUnsupported = false;
+
+    Duration frameDuration = Duration::zero();
+    FrameTimer frameTimer;
+
+    // The render items that the picking framebuffer was drawn with in the last frame, by their
+    // number minus 1. Without pickable layers, there are none and the framebuffer isn't drawn.
+    struct PickingItem {
+        std::string layerID;
+        UnwrappedTileID tileID;
+    };
+    std::vector<PickingItem> pickingItems;
+    OffscreenTexture pickingFramebuffer;
+    bool pickingUnsupported = false;
+
+    // The points of the dynamic point layers, by the serial of the layer. Those of layers that
+    // aren't rendered in a frame are released.
+    struct DynamicPointBuffer {
+        optional<gl::VertexBuffer<DynamicPointVertex>> buffer;
+        uint64_t generation = 0;
+        bool used = false;
+    };
+    std::unordered_map<uint64_t, DynamicPointBuffer> dynamicPointBuffers;
+
+    // The largest point size that the driver supports, once it's been asked for.
+    optional<float> maxPointSize;
+
+    // Set when the upload budget ran out before every bucket was uploaded, so that another frame
+    // is rendered to upload the rest.
+    bool pendingUploads = false;
+
     std::unique_ptr<Shaders> shaders;
 #ifndef NDEBUG
     std::unique_ptr<Shaders> overdrawShaders;
@@ -191,8 +385,7 @@ private:
     gl::VertexBuffer<FillVertex> tileTriangleVertexBuffer;
     gl::VertexBuffer<FillVertex> tileLineStripVertexBuffer;
     gl::VertexBuffer<RasterVertex> rasterVertexBuffer;
-
-    gl::VertexArrayObject tileBorderArray;
+    gl::VertexBuffer<CircleCornerVertex> circleCornerVertexBuffer;
 };
 
 } // namespace mbgl
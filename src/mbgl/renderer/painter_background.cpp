@@ -22,11 +22,6 @@ void Painter::renderBackground(PaintParameters& parameters, const BackgroundLaye
     optional<SpriteAtlasPosition> imagePosA;
     optional<SpriteAtlasPosition> imagePosB;
 
-    auto& patternShader = parameters.shaders.fillPattern;
-    auto& plainShader = parameters.shaders.fill;
-    auto& arrayBackgroundPattern = parameters.shaders.backgroundPatternArray;
-    auto& arrayBackground = parameters.shaders.backgroundArray;
-
     if (isPatterned) {
         imagePosA = spriteAtlas->getPosition(properties.backgroundPattern.value.from,
                                              SpritePatternMode::Repeating);
@@ -36,6 +31,7 @@ void Painter::renderBackground(PaintParameters& parameters, const BackgroundLaye
         if (!imagePosA || !imagePosB)
             return;
 
+        auto& patternShader = parameters.shaders.fillPattern();
         context.program = patternShader.getID();
         patternShader.u_matrix = identityMatrix;
         patternShader.u_pattern_tl_a = imagePosA->tl;
@@ -46,14 +42,15 @@ void Painter::renderBackground(PaintParameters& parameters, const BackgroundLaye
         patternShader.u_opacity = properties.backgroundOpacity;
 
         spriteAtlas->bind(true, context, 0);
-        arrayBackgroundPattern.bind(patternShader, tileTriangleVertexBuffer, BUFFER_OFFSET(0), context);
+        context.bindVertexArray(patternShader, tileTriangleVertexBuffer, BUFFER_OFFSET(0));
 
     } else {
+        auto& plainShader = parameters.shaders.fill();
         context.program = plainShader.getID();
         plainShader.u_color = properties.backgroundColor;
         plainShader.u_opacity = properties.backgroundOpacity;
 
-        arrayBackground.bind(plainShader, tileTriangleVertexBuffer, BUFFER_OFFSET(0), context);
+        context.bindVertexArray(plainShader, tileTriangleVertexBuffer, BUFFER_OFFSET(0));
     }
 
     context.stencilTest = false;
@@ -68,6 +65,7 @@ void Painter::renderBackground(PaintParameters& parameters, const BackgroundLaye
         matrix::multiply(vertexMatrix, projMatrix, vertexMatrix);
 
         if (isPatterned) {
+            auto& patternShader = parameters.shaders.fillPattern();
             patternShader.u_matrix = vertexMatrix;
             patternShader.u_pattern_size_a = imagePosA->size;
             patternShader.u_pattern_size_b = imagePosB->size;
@@ -81,7 +79,7 @@ void Painter::renderBackground(PaintParameters& parameters, const BackgroundLaye
             patternShader.u_pixel_coord_upper = {{ float(pixelX >> 16), float(pixelY >> 16) }};
             patternShader.u_pixel_coord_lower = {{ float(pixelX & 0xFFFF), float(pixelY & 0xFFFF) }};
         } else {
-            plainShader.u_matrix = vertexMatrix;
+            parameters.shaders.fill().u_matrix = vertexMatrix;
         }
 
         MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(tileTriangleVertexBuffer.vertexCount)));
@@ -26,32 +26,51 @@ void Painter::renderCircle(PaintParameters& parameters,
     setDepthSublayer(0);
 
     const CirclePaintProperties& properties = layer.impl->paint;
-    auto& circleShader = parameters.shaders.circle;
 
-    context.program = circleShader.getID();
+    auto setUniforms = [&] (auto& shader) {
+        context.program = shader.getID();
 
-    circleShader.u_matrix = tile.translatedMatrix(properties.circleTranslate,
-                                                  properties.circleTranslateAnchor,
-                                                  state);
+        shader.u_matrix = tile.translatedMatrix(properties.circleTranslate,
+                                                properties.circleTranslateAnchor,
+                                                state);
 
-    if (properties.circlePitchScale == CirclePitchScaleType::Map) {
-        circleShader.u_extrude_scale = {{
-            pixelsToGLUnits[0] * state.getAltitude(),
-            pixelsToGLUnits[1] * state.getAltitude()
-        }};
-        circleShader.u_scale_with_map = true;
-    } else {
-        circleShader.u_extrude_scale = pixelsToGLUnits;
-        circleShader.u_scale_with_map = false;
-    }
+        if (properties.circlePitchScale == CirclePitchScaleType::Map) {
+            shader.u_extrude_scale = {{
+                pixelsToGLUnits[0] * state.getAltitude(),
+                pixelsToGLUnits[1] * state.getAltitude()
+            }};
+            shader.u_scale_with_map = true;
+        } else {
+            shader.u_extrude_scale = pixelsToGLUnits;
+            shader.u_scale_with_map = false;
+        }
 
-    circleShader.u_devicepixelratio = frame.pixelRatio;
-    circleShader.u_color = properties.circleColor;
-    circleShader.u_radius = properties.circleRadius;
-    circleShader.u_blur = properties.circleBlur;
-    circleShader.u_opacity = properties.circleOpacity;
+        shader.u_devicepixelratio = frame.pixelRatio;
+        shader.u_radius = properties.circleRadius;
+        shader.u_blur = properties.circleBlur;
+        shader.u_opacity = properties.circleOpacity;
+    };
 
-    bucket.drawCircles(circleShader, context, paintMode());
+    // The data-driven shaders take the colors of the circles from the bucket instead.
+    if (bucket.hasFeatureColors() && bucket.isInstanced()) {
+        auto& circleShader = parameters.shaders.circleInstancedDataDriven();
+        setUniforms(circleShader);
+        bucket.drawCircleInstances(circleShader, circleCornerVertexBuffer, context);
+    } else if (bucket.hasFeatureColors()) {
+        auto& circleShader = parameters.shaders.circleDataDriven();
+        setUniforms(circleShader);
+        bucket.drawCircles(circleShader, context);
+    } else if (bucket.isInstanced()) {
+        auto& circleShader = parameters.shaders.circleInstanced();
+        setUniforms(circleShader);
+        circleShader.u_color = properties.circleColor;
+        bucket.drawCircleInstances(circleShader, circleCornerVertexBuffer, context);
+    } else {
+        auto& circleShader = parameters.shaders.circle();
+        setUniforms(circleShader);
+        circleShader.u_color = properties.circleColor;
+        bucket.drawCircles(circleShader, context);
+    }
 }
 
 } // namespace mbgl
@@ -14,8 +14,7 @@ namespace mbgl {
 void Painter::drawClippingMasks(PaintParameters& parameters, const std::map<UnwrappedTileID, ClipID>& stencils) {
     MBGL_DEBUG_GROUP("clipping masks");
 
-    auto& plainShader = parameters.shaders.fill;
-    auto& arrayCoveringPlain = parameters.shaders.coveringPlainArray;
+    auto& plainShader = parameters.shaders.fill();
 
     mat4 matrix;
     const GLuint mask = 0b11111111;
@@ -29,7 +28,7 @@ void Painter::drawClippingMasks(PaintParameters& parameters, const std::map<Unwr
     context.colorMask = { false, false, false, false };
     context.stencilMask = mask;
 
-    arrayCoveringPlain.bind(plainShader, tileTriangleVertexBuffer, BUFFER_OFFSET_0, context);
+    context.bindVertexArray(plainShader, tileTriangleVertexBuffer, BUFFER_OFFSET_0);
 
     for (const auto& stencil : stencils) {
         const auto& id = stencil.first;
@@ -38,7 +38,7 @@ void Painter::renderDebugText(Tile& tile, const mat4 &matrix) {
             tile.expires, frame.debugOptions, context);
     }
 
-    auto& plainShader = shaders->fill;
+    auto& plainShader = shaders->fill();
     context.program = plainShader.getID();
     plainShader.u_matrix = matrix;
     plainShader.u_opacity = 1.0f;
@@ -74,13 +74,13 @@ void Painter::renderDebugFrame(const mat4 &matrix) {
                           gl::StencilTestOperation::Replace };
     context.stencilTest = true;
 
-    auto& plainShader = shaders->fill;
+    auto& plainShader = shaders->fill();
     context.program = plainShader.getID();
     plainShader.u_matrix = matrix;
     plainShader.u_opacity = 1.0f;
 
     // draw tile outline
-    tileBorderArray.bind(plainShader, tileLineStripVertexBuffer, BUFFER_OFFSET_0, context);
+    context.bindVertexArray(plainShader, tileLineStripVertexBuffer, BUFFER_OFFSET_0);
     plainShader.u_color = { 1.0f, 0.0f, 0.0f, 1.0f };
     context.lineWidth = 4.0f * frame.pixelRatio;
     MBGL_CHECK_ERROR(glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(tileLineStripVertexBuffer.vertexCount)));
@@ -0,0 +1,114 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/bucket.hpp>
+
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
+#include <mbgl/style/layers/dynamic_point_layer_impl.hpp>
+
+#include <mbgl/shader/shaders.hpp>
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+using namespace style;
+
+void Painter::uploadDynamicPoints(const DynamicPointLayer& layer) {
+    const DynamicPointLayer::Impl& impl = *layer.impl;
+    DynamicPointBuffer& points = dynamicPointBuffers[impl.serial];
+    points.used = true;
+
+    auto vertices = [&] (std::size_t begin, std::size_t end) {
+        std::vector<DynamicPointVertex> result;
+        result.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+            result.emplace_back(impl.points[i].x, impl.points[i].y);
+        }
+        return result;
+    };
+
+    if (!points.buffer || points.generation != impl.generation) {
+        points.buffer = {};
+        if (!impl.points.empty()) {
+            points.buffer = context.createVertexBuffer(vertices(0, impl.points.size()));
+        }
+        points.generation = impl.generation;
+    } else if (impl.movedBegin < impl.movedEnd) {
+        context.updateVertexBuffer(*points.buffer, impl.movedBegin,
+                                   vertices(impl.movedBegin, impl.movedEnd));
+    }
+
+    impl.movedBegin = 0;
+    impl.movedEnd = 0;
+}
+
+void Painter::renderDynamicPoints(PaintParameters& parameters, const DynamicPointLayer& layer) {
+    const DynamicPointLayer::Impl& impl = *layer.impl;
+    auto it = dynamicPointBuffers.find(impl.serial);
+    if (it == dynamicPointBuffers.end() || !it->second.buffer) {
+        return;
+    }
+    const gl::VertexBuffer<DynamicPointVertex>& buffer = *it->second.buffer;
+
+    if (!maxPointSize) {
+        GLfloat range[2] = { 1, 1 };
+        MBGL_CHECK_ERROR(glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, range));
+        maxPointSize = range[1];
+    }
+
+    context.stencilTest = false;
+    context.depthFunc = gl::DepthTestFunction::LessEqual;
+    context.depthTest = true;
+    context.depthMask = false;
+    setDepthSublayer(0);
+
+    auto& shader = parameters.shaders.dynamicPoint();
+    context.program = shader.getID();
+
+    // Points are drawn as squares of a whole number of pixels, which the circle fills.
+    const float size = std::min(std::round(2 * impl.circleRadius * frame.pixelRatio), *maxPointSize);
+    shader.u_size = size;
+    shader.u_antialiasblur = 2.0f / size;
+    shader.u_color = impl.circleColor;
+    shader.u_opacity = impl.circleOpacity;
+
+    // From world coordinates relative to the center, which the shader subtracts from the points,
+    // to clip space.
+    const double worldSize = Projection::worldSize(state.getScale());
+    const Point<double> center = Projection::project(state.getLatLng(), state.getScale());
+    mat4 matrix = projMatrix;
+    matrix::translate(matrix, matrix, center.x, center.y, 0);
+    matrix::scale(matrix, matrix, worldSize, worldSize, 1);
+    shader.u_matrix = matrix;
+
+#if not MBGL_USE_GLES2
+    // Desktop OpenGL ignores gl_PointSize and gl_PointCoord unless they're enabled.
+    MBGL_CHECK_ERROR(glEnable(GL_VERTEX_PROGRAM_POINT_SIZE));
+    MBGL_CHECK_ERROR(glEnable(GL_POINT_SPRITE));
+#endif
+
+    context.bindVertexArray(shader, buffer, BUFFER_OFFSET_0);
+
+    // The points are in the world from 0 to 1, the center of an unwrapped map may be in a copy of
+    // it on either side.
+    const double x = center.x / worldSize;
+    const double y = center.y / worldSize;
+    const double wrap = std::floor(x);
+    for (double copy = wrap - 1; copy <= wrap + 1; ++copy) {
+        const double cx = x - copy;
+        shader.u_center = {{ static_cast<float>(cx), static_cast<float>(y) }};
+        shader.u_center_low = {{ static_cast<float>(cx - static_cast<float>(cx)),
+                                 static_cast<float>(y - static_cast<float>(y)) }};
+        MBGL_CHECK_ERROR(glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(buffer.vertexCount)));
+    }
+
+#if not MBGL_USE_GLES2
+    MBGL_CHECK_ERROR(glDisable(GL_POINT_SPRITE));
+    MBGL_CHECK_ERROR(glDisable(GL_VERTEX_PROGRAM_POINT_SIZE));
+#endif
+}
+
+} // namespace mbgl
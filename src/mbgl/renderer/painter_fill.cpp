@@ -6,6 +6,7 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/style/style.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/shader/shaders.hpp>
 #include <mbgl/util/convert.hpp>
@@ -14,6 +15,31 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// The bytes of a category mask, as the components of the vec4 that the category shaders test.
+std::array<float, 4> categoryMask(uint32_t categories) {
+    return {{ float(categories & 0xFF), float((categories >> 8) & 0xFF),
+              float((categories >> 16) & 0xFF), float((categories >> 24) & 0xFF) }};
+}
+
+template <class Shader>
+void setCategoryUniforms(Shader& shader, const FillLayer::Impl& layer) {
+    shader.u_visible_categories = categoryMask(layer.visibleFeatureCategories);
+    shader.u_highlighted_categories = categoryMask(layer.highlightedFeatureCategories);
+    shader.u_highlight_color = layer.featureHighlightColor;
+}
+
+template <class Shader>
+void bindFeatureStates(Shader& shader, FillBucket& bucket, const FillLayer::Impl& layer,
+                       PaintParameters& parameters, gl::Context& context) {
+    bucket.bindFeatureStates(context, parameters.style.getFeatureStates(layer.source), 0);
+    shader.u_feature_states = 0;
+    shader.u_feature_states_height = bucket.getFeatureStatesHeight();
+}
+
+} // namespace
+
 void Painter::renderFill(PaintParameters& parameters,
                          FillBucket& bucket,
                          const FillLayer& layer,
@@ -43,14 +69,21 @@ void Painter::renderFill(PaintParameters& parameters,
     context.depthMask = true;
     context.lineWidth = 2.0f; // This is always fixed and does not depend on the pixelRatio!
 
-    auto& outlineShader = parameters.shaders.fillOutline;
-    auto& patternShader = parameters.shaders.fillPattern;
-    auto& outlinePatternShader = parameters.shaders.fillOutlinePattern;
-    auto& plainShader = parameters.shaders.fill;
-
     // Because we're drawing top-to-bottom, and we update the stencil mask
     // befrom, we have to draw the outline first (!)
-    if (outline && pass == RenderPass::Translucent) {
+    if (outline && pass == RenderPass::Translucent && bucket.hasFeatureCategories()) {
+        auto& outlineShader = parameters.shaders.fillOutlineCategory();
+        context.program = outlineShader.getID();
+        outlineShader.u_matrix = vertexMatrix;
+        outlineShader.u_outline_color = strokeColor;
+        outlineShader.u_opacity = opacity;
+        outlineShader.u_world = worldSize;
+        setCategoryUniforms(outlineShader, *layer.impl);
+
+        setDepthSublayer(2);
+        bucket.drawVertices(outlineShader, context);
+    } else if (outline && pass == RenderPass::Translucent) {
+        auto& outlineShader = parameters.shaders.fillOutline();
         context.program = outlineShader.getID();
         outlineShader.u_matrix = vertexMatrix;
 
@@ -72,17 +105,23 @@ void Painter::renderFill(PaintParameters& parameters,
             // the (non-antialiased) fill.
             setDepthSublayer(0); // OK
         }
-        bucket.drawVertices(outlineShader, context, paintMode());
+        bucket.drawVertices(outlineShader, context);
     }
 
     if (pattern) {
-        optional<SpriteAtlasPosition> imagePosA = spriteAtlas->getPosition(
-            properties.fillPattern.value.from, SpritePatternMode::Repeating);
-        optional<SpriteAtlasPosition> imagePosB =
-            spriteAtlas->getPosition(properties.fillPattern.value.to, SpritePatternMode::Repeating);
+        if (!batch.patternResolved) {
+            batch.patternPosA = spriteAtlas->getPosition(
+                properties.fillPattern.value.from, SpritePatternMode::Repeating);
+            batch.patternPosB =
+                spriteAtlas->getPosition(properties.fillPattern.value.to, SpritePatternMode::Repeating);
+            batch.patternResolved = true;
+        }
+        const optional<SpriteAtlasPosition>& imagePosA = batch.patternPosA;
+        const optional<SpriteAtlasPosition>& imagePosB = batch.patternPosB;
 
         // Image fill.
         if (pass == RenderPass::Translucent && imagePosA && imagePosB) {
+            auto& patternShader = parameters.shaders.fillPattern();
             context.program = patternShader.getID();
             patternShader.u_matrix = vertexMatrix;
             patternShader.u_pattern_tl_a = imagePosA->tl;
@@ -108,9 +147,10 @@ void Painter::renderFill(PaintParameters& parameters,
 
             // Draw the actual triangles into the color & stencil buffer.
             setDepthSublayer(0);
-            bucket.drawElements(patternShader, context, paintMode());
+            bucket.drawElements(patternShader, context);
 
             if (properties.fillAntialias && !isOutlineColorDefined) {
+                auto& outlinePatternShader = parameters.shaders.fillOutlinePattern();
                 context.program = outlinePatternShader.getID();
                 outlinePatternShader.u_matrix = vertexMatrix;
 
@@ -135,9 +175,48 @@ void Painter::renderFill(PaintParameters& parameters,
                 spriteAtlas->bind(true, context, 0);
 
                 setDepthSublayer(2);
-                bucket.drawVertices(outlinePatternShader, context, paintMode());
+                bucket.drawVertices(outlinePatternShader, context);
             }
         }
+    } else if (bucket.hasFeatureColors()) {
+        // The features have data-driven colors, any of which may be translucent.
+        if (pass == RenderPass::Translucent) {
+            auto& dataDrivenShader = parameters.shaders.fillDataDriven();
+            context.program = dataDrivenShader.getID();
+            dataDrivenShader.u_matrix = vertexMatrix;
+            dataDrivenShader.u_opacity = opacity;
+
+            setDepthSublayer(1);
+            bucket.drawElements(dataDrivenShader, context);
+        }
+    } else if (bucket.hasFeatureStates()) {
+        // The colors of the features are read from a texture, which is only updated when their
+        // states change. Any of them may be translucent.
+        if (pass == RenderPass::Translucent) {
+            auto& featureStateShader = parameters.shaders.fillFeatureState();
+            context.program = featureStateShader.getID();
+            featureStateShader.u_matrix = vertexMatrix;
+            featureStateShader.u_color = fillColor;
+            featureStateShader.u_opacity = opacity;
+            bindFeatureStates(featureStateShader, bucket, *layer.impl, parameters, context);
+
+            setDepthSublayer(1);
+            bucket.drawElements(featureStateShader, context);
+        }
+    } else if (bucket.hasFeatureCategories()) {
+        // Hidden categories are filtered out by the shader, so that toggling them doesn't need
+        // a new layout. Features may be hidden or highlighted, so this is always translucent.
+        if (pass == RenderPass::Translucent) {
+            auto& categoryShader = parameters.shaders.fillCategory();
+            context.program = categoryShader.getID();
+            categoryShader.u_matrix = vertexMatrix;
+            categoryShader.u_color = fillColor;
+            categoryShader.u_opacity = opacity;
+            setCategoryUniforms(categoryShader, *layer.impl);
+
+            setDepthSublayer(1);
+            bucket.drawElements(categoryShader, context);
+        }
     } else {
         // No image fill.
         if ((fillColor.a >= 1.0f && opacity >= 1.0f) == (pass == RenderPass::Opaque)) {
@@ -145,6 +224,7 @@ void Painter::renderFill(PaintParameters& parameters,
             // fragments or when it's translucent and we're drawing translucent
             // fragments
             // Draw filling rectangle.
+            auto& plainShader = parameters.shaders.fill();
             context.program = plainShader.getID();
             plainShader.u_matrix = vertexMatrix;
             plainShader.u_color = fillColor;
@@ -152,13 +232,45 @@ void Painter::renderFill(PaintParameters& parameters,
 
             // Draw the actual triangles into the color & stencil buffer.
             setDepthSublayer(1);
-            bucket.drawElements(plainShader, context, paintMode());
+            bucket.drawElements(plainShader, context);
         }
     }
 
     // Because we're drawing top-to-bottom, and we update the stencil mask
     // below, we have to draw the outline first (!)
-    if (fringeline && pass == RenderPass::Translucent) {
+    if (fringeline && pass == RenderPass::Translucent && bucket.hasFeatureColors()) {
+        auto& outlineShader = parameters.shaders.fillOutlineDataDriven();
+        context.program = outlineShader.getID();
+        outlineShader.u_matrix = vertexMatrix;
+        outlineShader.u_opacity = opacity;
+        outlineShader.u_world = worldSize;
+
+        setDepthSublayer(2);
+        bucket.drawVertices(outlineShader, context);
+    } else if (fringeline && pass == RenderPass::Translucent && bucket.hasFeatureStates()) {
+        auto& outlineShader = parameters.shaders.fillOutlineFeatureState();
+        context.program = outlineShader.getID();
+        outlineShader.u_matrix = vertexMatrix;
+        outlineShader.u_outline_color = fillColor;
+        outlineShader.u_opacity = opacity;
+        outlineShader.u_world = worldSize;
+        bindFeatureStates(outlineShader, bucket, *layer.impl, parameters, context);
+
+        setDepthSublayer(2);
+        bucket.drawVertices(outlineShader, context);
+    } else if (fringeline && pass == RenderPass::Translucent && bucket.hasFeatureCategories()) {
+        auto& outlineShader = parameters.shaders.fillOutlineCategory();
+        context.program = outlineShader.getID();
+        outlineShader.u_matrix = vertexMatrix;
+        outlineShader.u_outline_color = fillColor;
+        outlineShader.u_opacity = opacity;
+        outlineShader.u_world = worldSize;
+        setCategoryUniforms(outlineShader, *layer.impl);
+
+        setDepthSublayer(2);
+        bucket.drawVertices(outlineShader, context);
+    } else if (fringeline && pass == RenderPass::Translucent) {
+        auto& outlineShader = parameters.shaders.fillOutline();
         context.program = outlineShader.getID();
         outlineShader.u_matrix = vertexMatrix;
 
@@ -169,7 +281,7 @@ void Painter::renderFill(PaintParameters& parameters,
         outlineShader.u_world = worldSize;
 
         setDepthSublayer(2);
-        bucket.drawVertices(outlineShader, context, paintMode());
+        bucket.drawVertices(outlineShader, context);
     }
 }
 
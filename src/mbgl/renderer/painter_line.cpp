@@ -57,11 +57,8 @@ void Painter::renderLine(PaintParameters& parameters,
 
     setDepthSublayer(0);
 
-    auto& linesdfShader = parameters.shaders.lineSDF;
-    auto& linepatternShader = parameters.shaders.linePattern;
-    auto& lineShader = parameters.shaders.line;
-
     if (!properties.lineDasharray.value.from.empty()) {
+        auto& linesdfShader = parameters.shaders.lineSDF();
         context.program = linesdfShader.getID();
 
         linesdfShader.u_matrix = vtxMatrix;
@@ -75,8 +72,14 @@ void Painter::renderLine(PaintParameters& parameters,
 
         const LinePatternCap cap =
             layout.lineCap == LineCapType::Round ? LinePatternCap::Round : LinePatternCap::Square;
-        LinePatternPos posA = lineAtlas->getDashPosition(properties.lineDasharray.value.from, cap);
-        LinePatternPos posB = lineAtlas->getDashPosition(properties.lineDasharray.value.to, cap);
+        // The cap is a layout property and may differ between tiles of different zoom levels.
+        if (batch.dashCap != cap) {
+            batch.dashPosA = lineAtlas->getDashPosition(properties.lineDasharray.value.from, cap);
+            batch.dashPosB = lineAtlas->getDashPosition(properties.lineDasharray.value.to, cap);
+            batch.dashCap = cap;
+        }
+        const LinePatternPos& posA = batch.dashPosA;
+        const LinePatternPos& posB = batch.dashPosB;
 
         const float widthA = posA.width * properties.lineDasharray.value.fromScale * layer.impl->dashLineWidth;
         const float widthB = posB.width * properties.lineDasharray.value.toScale * layer.impl->dashLineWidth;
@@ -99,17 +102,23 @@ void Painter::renderLine(PaintParameters& parameters,
         linesdfShader.u_image = 0;
         lineAtlas->bind(context, 0);
 
-        bucket.drawLineSDF(linesdfShader, context, paintMode());
+        bucket.drawLineSDF(linesdfShader, context);
 
     } else if (!properties.linePattern.value.from.empty()) {
-        optional<SpriteAtlasPosition> imagePosA = spriteAtlas->getPosition(
-            properties.linePattern.value.from, SpritePatternMode::Repeating);
-        optional<SpriteAtlasPosition> imagePosB =
-            spriteAtlas->getPosition(properties.linePattern.value.to, SpritePatternMode::Repeating);
+        if (!batch.patternResolved) {
+            batch.patternPosA = spriteAtlas->getPosition(
+                properties.linePattern.value.from, SpritePatternMode::Repeating);
+            batch.patternPosB =
+                spriteAtlas->getPosition(properties.linePattern.value.to, SpritePatternMode::Repeating);
+            batch.patternResolved = true;
+        }
+        const optional<SpriteAtlasPosition>& imagePosA = batch.patternPosA;
+        const optional<SpriteAtlasPosition>& imagePosB = batch.patternPosB;
 
         if (!imagePosA || !imagePosB)
             return;
 
+        auto& linepatternShader = parameters.shaders.linePattern();
         context.program = linepatternShader.getID();
 
         linepatternShader.u_matrix = vtxMatrix;
@@ -142,9 +151,10 @@ void Painter::renderLine(PaintParameters& parameters,
         linepatternShader.u_image = 0;
         spriteAtlas->bind(true, context, 0);
 
-        bucket.drawLinePatterns(linepatternShader, context, paintMode());
+        bucket.drawLinePatterns(linepatternShader, context);
 
     } else {
+        auto& lineShader = parameters.shaders.line();
         context.program = lineShader.getID();
 
         lineShader.u_matrix = vtxMatrix;
@@ -160,7 +170,7 @@ void Painter::renderLine(PaintParameters& parameters,
         lineShader.u_color = color;
         lineShader.u_opacity = opacity;
 
-        bucket.drawLines(lineShader, context, paintMode());
+        bucket.drawLines(lineShader, context);
     }
 }
 
@@ -0,0 +1,148 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/gl/gl.hpp>
+
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/fill_layer_impl.hpp>
+#include <mbgl/shader/shaders.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/gl/debugging.hpp>
+
+namespace mbgl {
+
+using namespace style;
+
+namespace {
+
+// The picking framebuffer is this many times smaller than the frame in each dimension, which is
+// plenty for telling apart the features under the mouse.
+const uint16_t pickingDownscale = 4;
+
+// The render item numbers have two bytes, and 0 is left for where nothing is drawn.
+const std::size_t maxPickingItems = 65535;
+
+} // namespace
+
+void Painter::renderPicking(PaintParameters& parameters, const std::vector<RenderItem>& order) {
+    pickingItems.clear();
+    if (pickingUnsupported) {
+        return;
+    }
+
+    std::vector<const RenderItem*> items;
+    for (const auto& item : order) {
+        const FillLayer* layer = item.layer.as<FillLayer>();
+        if (layer && layer->getPickable() && item.tile && !item.tile->culled &&
+            item.bucket && !item.bucket->needsUpload() &&
+            static_cast<const FillBucket&>(*item.bucket).hasPickingFeatures()) {
+            items.push_back(&item);
+        }
+    }
+    if (items.empty()) {
+        return;
+    }
+
+    // The topmost items are the ones that can be seen.
+    if (items.size() > maxPickingItems) {
+        items.erase(items.begin(), items.end() - maxPickingItems);
+    }
+
+    MBGL_DEBUG_GROUP("picking");
+
+    const std::array<uint16_t, 2> size {{
+        static_cast<uint16_t>((frame.framebufferSize[0] + pickingDownscale - 1) / pickingDownscale),
+        static_cast<uint16_t>((frame.framebufferSize[1] + pickingDownscale - 1) / pickingDownscale)
+    }};
+
+    try {
+        pickingFramebuffer.bind(context, size, true);
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::OpenGL, "Not rendering the picking pass: %s", ex.what());
+        pickingUnsupported = true;
+        context.bindFramebuffer.reset();
+        context.viewport.reset();
+        return;
+    }
+
+    context.stencilMask = 0xFF;
+    context.colorMask = { true, true, true, true };
+    context.clearColor = { 0.0f, 0.0f, 0.0f, 0.0f };
+    context.clearStencil = 0;
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
+    drawClippingMasks(parameters, clipStencils);
+
+    // Drawn bottom to top, without blending, so that every pixel ends up with the topmost feature.
+    context.blend = false;
+    context.depthTest = false;
+    context.stencilTest = true;
+    context.stencilMask = 0x0;
+    context.colorMask = { true, true, true, true };
+
+    auto& shader = parameters.shaders.fillPicking();
+    context.program = shader.getID();
+
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const RenderItem& item = *items[i];
+        const FillLayer& layer = *item.layer.as<FillLayer>();
+        const FillPaintProperties& properties = layer.impl->paint;
+
+        const uint16_t number = static_cast<uint16_t>(i + 1);
+        shader.u_matrix = item.tile->translatedMatrix(properties.fillTranslate,
+                                                      properties.fillTranslateAnchor,
+                                                      state);
+        shader.u_item = {{ float(number & 0xFF), float(number >> 8) }};
+        setClipping(item.tile->clip);
+
+        static_cast<FillBucket&>(*item.bucket).drawElements(shader, context);
+        pickingItems.push_back({ layer.getID(), item.tile->id });
+    }
+
+    context.bindFramebuffer.reset();
+    context.viewport.reset();
+}
+
+optional<Painter::PickedFeature> Painter::readPickedFeature(const ScreenCoordinate& point) {
+    const std::array<uint16_t, 2> size = pickingFramebuffer.getSize();
+    if (pickingItems.empty() || !size[0] || !size[1] || !state.getWidth() || !state.getHeight()) {
+        return {};
+    }
+
+    // The rows of the framebuffer start at the bottom, unless the viewport is flipped.
+    const double x = point.x / state.getWidth() * size[0];
+    double y = point.y / state.getHeight() * size[1];
+    if (state.getViewportMode() != ViewportMode::FlippedY) {
+        y = size[1] - y;
+    }
+    if (x < 0 || y < 0 || x >= size[0] || y >= size[1]) {
+        return {};
+    }
+
+    // Other users of a shared context may have changed the state since the last frame.
+    if (frame.contextMode == GLContextMode::Shared) {
+        context.setDirtyState();
+    }
+
+    uint8_t pixel[4] = { 0, 0, 0, 0 };
+    pickingFramebuffer.bind(context, size, true);
+    MBGL_CHECK_ERROR(glReadPixels(static_cast<GLint>(x), static_cast<GLint>(y), 1, 1,
+                                  GL_RGBA, GL_UNSIGNED_BYTE, pixel));
+    context.bindFramebuffer.reset();
+    context.viewport.reset();
+
+    if (frame.contextMode == GLContextMode::Shared) {
+        context.setDirtyState();
+    }
+
+    const uint16_t id = pixel[0] | (pixel[1] << 8);
+    const uint16_t number = pixel[2] | (pixel[3] << 8);
+    if (!id || !number || number > pickingItems.size()) {
+        return {};
+    }
+
+    const PickingItem& item = pickingItems[number - 1];
+    return PickedFeature { item.layerID, item.tileID, id };
+}
+
+} // namespace mbgl
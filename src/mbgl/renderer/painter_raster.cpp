@@ -6,11 +6,51 @@
 #include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/style/layers/raster_layer_impl.hpp>
 #include <mbgl/shader/shaders.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/mat4.hpp>
 
 namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// DEM tiles are shaded with the defaults of the hillshade style properties: a light of half
+// intensity from the north-northwest of the viewport, that casts black shadows and white
+// highlights.
+constexpr float HillshadeIntensity = 0.5f;
+constexpr float HillshadeIlluminationDirection = 335.0f;
+
+} // namespace
+
+void Painter::prepareDEM(PaintParameters& parameters, RasterBucket& bucket, const RenderTile& tile) {
+    const DEMData& dem = *bucket.getDEM();
+    auto& shader = parameters.shaders.hillshadePrepare();
+
+    // The tile covers the whole texture, with the same orientation.
+    mat4 matrix;
+    matrix::ortho(matrix, 0, util::EXTENT, 0, util::EXTENT, 0, 1);
+
+    const LatLngBounds bounds(tile.id.canonical);
+    const float stride = dem.image.width;
+
+    context.program = shader.getID();
+    shader.u_matrix = matrix;
+    shader.u_image = 0; // GL_TEXTURE0
+    shader.u_dimension = {{ stride, stride }};
+    shader.u_zoom = tile.id.canonical.z;
+    shader.u_latrange = {{ float(bounds.north()), float(bounds.south()) }};
+    shader.u_unpack = dem.getUnpackVector();
+
+    context.blend = false;
+    context.depthTest = false;
+    context.stencilTest = false;
+    context.colorMask = { true, true, true, true };
+
+    bucket.prepareDEM(shader, rasterVertexBuffer, context);
+}
+
 void Painter::renderRaster(PaintParameters& parameters,
                            RasterBucket& bucket,
                            const RasterLayer& layer,
@@ -19,9 +59,31 @@ void Painter::renderRaster(PaintParameters& parameters,
 
     const RasterPaintProperties& properties = layer.impl->paint;
 
-    if (bucket.hasData()) {
-        auto& rasterShader = parameters.shaders.raster;
-        auto& rasterVAO = parameters.shaders.coveringRasterArray;
+    if (bucket.getDEM()) {
+        auto& hillshadeShader = parameters.shaders.hillshade();
+
+        // The light is anchored to the viewport, so it turns with the map.
+        const float azimuth = HillshadeIlluminationDirection * util::DEG2RAD - state.getAngle() + M_PI;
+
+        context.program = hillshadeShader.getID();
+        hillshadeShader.u_matrix = tile.matrix;
+        hillshadeShader.u_image = 0; // GL_TEXTURE0
+        hillshadeShader.u_intensity = HillshadeIntensity;
+        hillshadeShader.u_azimuth = {{ std::cos(azimuth), std::sin(azimuth) }};
+        hillshadeShader.u_shadow = Color::black();
+        hillshadeShader.u_highlight = Color::white();
+        hillshadeShader.u_accent = Color::black();
+        hillshadeShader.u_opacity = properties.rasterOpacity;
+
+        context.stencilTest = false;
+        context.depthFunc = gl::DepthTestFunction::LessEqual;
+        context.depthTest = true;
+        context.depthMask = false;
+        setDepthSublayer(0);
+
+        bucket.drawHillshade(hillshadeShader, rasterVertexBuffer, context);
+    } else if (bucket.hasData()) {
+        auto& rasterShader = parameters.shaders.raster();
 
         context.program = rasterShader.getID();
         rasterShader.u_matrix = tile.matrix;
@@ -47,7 +109,7 @@ void Painter::renderRaster(PaintParameters& parameters,
         context.depthMask = false;
         setDepthSublayer(0);
 
-        bucket.drawRaster(rasterShader, rasterVertexBuffer, rasterVAO, context);
+        bucket.drawRaster(rasterShader, rasterVertexBuffer, context);
     }
 }
 
@@ -20,7 +20,7 @@ void Painter::renderSDF(SymbolBucket& bucket,
                         float sdfFontSize,
                         std::array<float, 2> texsize,
                         SymbolSDFShader& sdfShader,
-                        void (SymbolBucket::*drawSDF)(SymbolSDFShader&, gl::Context&, PaintMode),
+                        void (SymbolBucket::*drawSDF)(SymbolSDFShader&, gl::Context&),
 
                         // Layout
                         AlignmentType rotationAlignment,
@@ -69,7 +69,7 @@ void Painter::renderSDF(SymbolBucket& bucket,
     sdfShader.u_texture = 0;
     sdfShader.u_pitch = state.getPitch();
     sdfShader.u_bearing = -1.0f * state.getAngle();
-    sdfShader.u_aspect_ratio = (state.getWidth() * 1.0f) / (state.getHeight() * 1.0f);
+    sdfShader.u_aspect_ratio = std::abs(pixelsToGLUnits[1] / pixelsToGLUnits[0]);
 
     // adjust min/max zooms for variable font sies
     float zoomAdjust = std::log(fontSize / layoutSize) / std::log(2);
@@ -78,6 +78,7 @@ void Painter::renderSDF(SymbolBucket& bucket,
 
     frameHistory.bind(context, 1);
     sdfShader.u_fadetexture = 1;
+    sdfShader.u_fade_change = getSymbolFadeChange(bucket);
 
     // The default gamma value has to be adjust for the current pixelratio so that we're not
     // drawing blurry font on retina screens.
@@ -94,7 +95,7 @@ void Painter::renderSDF(SymbolBucket& bucket,
         sdfShader.u_color = haloColor;
         sdfShader.u_opacity = opacity;
         sdfShader.u_buffer = (haloOffset - haloWidth / fontScale) / sdfPx;
-        (bucket.*drawSDF)(sdfShader, context, paintMode());
+        (bucket.*drawSDF)(sdfShader, context);
     }
 
     // Then, we draw the text/icon over the halo
@@ -103,10 +104,17 @@ void Painter::renderSDF(SymbolBucket& bucket,
         sdfShader.u_color = color;
         sdfShader.u_opacity = opacity;
         sdfShader.u_buffer = (256.0f - 64.0f) / 256.0f;
-        (bucket.*drawSDF)(sdfShader, context, paintMode());
+        (bucket.*drawSDF)(sdfShader, context);
     }
 }
 
+float Painter::getSymbolFadeChange(const SymbolBucket& bucket) {
+    const Duration fadeDuration =
+        frame.mapMode == MapMode::Continuous ? util::DEFAULT_FADE_DURATION : Duration::zero();
+    symbolFadeEnd = std::max(symbolFadeEnd, bucket.getFadeEnd(fadeDuration));
+    return bucket.getFadeChange(frame.timePoint, fadeDuration);
+}
+
 void Painter::renderSymbol(PaintParameters& parameters,
                            SymbolBucket& bucket,
                            const SymbolLayer& layer,
@@ -168,7 +176,7 @@ void Painter::renderSymbol(PaintParameters& parameters,
                       tile,
                       1.0f,
                       {{ float(activeSpriteAtlas->getWidth()) / 4.0f, float(activeSpriteAtlas->getHeight()) / 4.0f }},
-                      parameters.shaders.symbolIconSDF,
+                      parameters.shaders.symbolIconSDF(),
                       &SymbolBucket::drawIcons,
                       layout.iconRotationAlignment,
                       // icon-pitch-alignment is not yet implemented
@@ -200,7 +208,7 @@ void Painter::renderSymbol(PaintParameters& parameters,
                 }};
             }
 
-            auto& iconShader = parameters.shaders.symbolIcon;
+            auto& iconShader = parameters.shaders.symbolIcon();
 
             context.program = iconShader.getID();
             iconShader.u_matrix = vtxMatrix;
@@ -216,8 +224,9 @@ void Painter::renderSymbol(PaintParameters& parameters,
 
             frameHistory.bind(context, 1);
             iconShader.u_fadetexture = 1;
+            iconShader.u_fade_change = getSymbolFadeChange(bucket);
 
-            bucket.drawIcons(iconShader, context, paintMode());
+            bucket.drawIcons(iconShader, context);
         }
     }
 
@@ -234,8 +243,8 @@ void Painter::renderSymbol(PaintParameters& parameters,
         renderSDF(bucket,
                   tile,
                   24.0f,
-                  {{ float(glyphAtlas->width) / 4, float(glyphAtlas->height) / 4 }},
-                  parameters.shaders.symbolGlyph,
+                  {{ float(glyphAtlas->width) / 4, float(glyphAtlas->getTextureHeight()) / 4 }},
+                  parameters.shaders.symbolGlyph(),
                   &SymbolBucket::drawGlyphs,
                   layout.textRotationAlignment,
                   layout.textPitchAlignment,
@@ -253,7 +262,7 @@ void Painter::renderSymbol(PaintParameters& parameters,
     if (bucket.hasCollisionBoxData()) {
         context.stencilTest = false;
 
-        auto& collisionBoxShader = shaders->collisionBox;
+        auto& collisionBoxShader = shaders->collisionBox();
         context.program = collisionBoxShader.getID();
         collisionBoxShader.u_matrix = tile.matrix;
         // TODO: This was the overscaled z instead of the canonical z.
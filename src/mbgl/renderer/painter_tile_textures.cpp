@@ -0,0 +1,284 @@
+#include <mbgl/renderer/painter.hpp>
+#include <mbgl/renderer/paint_parameters.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+
+#include <mbgl/style/source.hpp>
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
+
+#include <mbgl/platform/log.hpp>
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/debugging.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace mbgl {
+
+using namespace style;
+
+namespace {
+
+// Layers whose render items are clipped to their tile, and don't change from one frame to the
+// next on their own.
+bool isTileTextureLayer(const Layer& layer) {
+    return layer.is<FillLayer>() || layer.is<LineLayer>() ||
+           layer.is<CircleLayer>() || layer.is<RasterLayer>();
+}
+
+std::array<double, 2> windowCoordinate(const mat4& matrix,
+                                       double x, double y,
+                                       const std::array<uint16_t, 2>& framebufferSize) {
+    vec4 point = {{ x, y, 0, 1 }};
+    matrix::transformMat4(point, point, matrix);
+    return {{ (point[0] / point[3] + 1) / 2 * framebufferSize[0],
+              (point[1] / point[3] + 1) / 2 * framebufferSize[1] }};
+}
+
+} // namespace
+
+void Painter::updateTileTextures(PaintParameters& parameters, const RenderData& renderData) {
+    tileTextureLayers.clear();
+    for (auto& pair : tileTextures) {
+        pair.second.used = false;
+        pair.second.drawn = false;
+    }
+
+    // Under pitch, the tiles change their shape on screen while panning.
+    const bool enabled = frame.mapMode == MapMode::Continuous &&
+                         paintMode() == PaintMode::Regular &&
+                         state.getPitch() == 0 && !tileTexturesUnsupported;
+
+    std::unordered_set<std::string> sourceIDs;
+    if (enabled) {
+        for (Source* source : renderData.sources) {
+            if (source->baseImpl->tileTextureCaching) {
+                sourceIDs.insert(source->getID());
+            }
+        }
+    }
+
+    // Find the runs of consecutive layers of the same source that can be rendered into tile
+    // textures. The render items of a layer are consecutive.
+    const Layer* previousLayer = nullptr;
+    const Layer* runLayer = nullptr;
+    for (const auto& item : renderData.order) {
+        const Layer& layer = item.layer;
+        if (&layer == previousLayer) {
+            continue;
+        }
+        previousLayer = &layer;
+
+        if (!item.tile || !isTileTextureLayer(layer) || !sourceIDs.count(layer.baseImpl->source)) {
+            runLayer = nullptr;
+            continue;
+        }
+        if (!runLayer || runLayer->baseImpl->source != layer.baseImpl->source) {
+            runLayer = &layer;
+        }
+        tileTextureLayers.emplace(&layer, runLayer);
+    }
+
+    // The render items of each run and tile, bottom to top.
+    std::map<TileTextureKey, std::pair<const RenderTile*, std::vector<RenderItem>>> runs;
+    for (const auto& item : renderData.order) {
+        auto it = tileTextureLayers.find(&item.layer);
+        if (it != tileTextureLayers.end() && !item.tile->culled) {
+            auto& run = runs[{ it->second, item.tile->id }];
+            run.first = item.tile;
+            run.second.push_back(item);
+        }
+    }
+
+    if (!runs.empty() && !maxTextureSize) {
+        MBGL_CHECK_ERROR(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize));
+    }
+
+    bool rendered = false;
+
+    for (const auto& run : runs) {
+        const RenderTile& tile = *run.second.first;
+        const std::vector<RenderItem>& items = run.second.second;
+
+        TileTexture& texture = tileTextures[run.first];
+        texture.used = true;
+
+        // The bounding box of the tile on screen. Its size stays the same while panning.
+        double minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+        for (const auto& corner : { std::make_pair(0, 0), std::make_pair(util::EXTENT, 0),
+                                    std::make_pair(0, util::EXTENT), std::make_pair(util::EXTENT, util::EXTENT) }) {
+            const auto point = windowCoordinate(tile.matrix, corner.first, corner.second, frame.framebufferSize);
+            minX = std::min(minX, point[0]);
+            minY = std::min(minY, point[1]);
+            maxX = std::max(maxX, point[0]);
+            maxY = std::max(maxY, point[1]);
+        }
+
+        const double width = std::ceil(maxX - minX) + 1;
+        const double height = std::ceil(maxY - minY) + 1;
+        if (width > maxTextureSize || height > maxTextureSize) {
+            texture.current = false;
+            continue;
+        }
+        const std::array<uint16_t, 2> size = {{ static_cast<uint16_t>(width),
+                                                static_cast<uint16_t>(height) }};
+
+        std::vector<const Bucket*> buckets;
+        bool uploaded = true;
+        for (const auto& item : items) {
+            buckets.push_back(item.bucket);
+            uploaded = uploaded && !item.bucket->needsUpload();
+        }
+
+        if (texture.current &&
+            texture.styleSerial == renderData.styleSerial &&
+            texture.zoom == state.getZoom() &&
+            texture.angle == state.getAngle() &&
+            texture.pixelRatio == frame.pixelRatio &&
+            texture.buckets == buckets &&
+            texture.texture->size == size) {
+            continue;
+        }
+
+        const std::array<double, 2> origin = {{ std::floor(minX), std::floor(minY) }};
+        rendered = true;
+        if (!renderTileTexture(parameters, texture, tile, items, origin, size)) {
+            break;
+        }
+
+        const auto tileOrigin = windowCoordinate(tile.matrix, 0, 0, frame.framebufferSize);
+        texture.styleSerial = renderData.styleSerial;
+        texture.zoom = state.getZoom();
+        texture.angle = state.getAngle();
+        texture.pixelRatio = frame.pixelRatio;
+        texture.buckets = std::move(buckets);
+        texture.offset = {{ tileOrigin[0] - origin[0], tileOrigin[1] - origin[1] }};
+
+        // Buckets that aren't uploaded yet aren't rendered, so the texture lacks them.
+        texture.current = uploaded;
+    }
+
+    if (rendered) {
+        context.bindFramebuffer.reset();
+        context.viewport.reset();
+    }
+
+    for (auto it = tileTextures.begin(); it != tileTextures.end();) {
+        if (!it->second.used || tileTexturesUnsupported) {
+            it = tileTextures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool Painter::renderTileTexture(PaintParameters& parameters,
+                                TileTexture& texture,
+                                const RenderTile& tile,
+                                const std::vector<RenderItem>& items,
+                                const std::array<double, 2>& origin,
+                                const std::array<uint16_t, 2>& size) {
+    MBGL_DEBUG_GROUP("tile texture " + util::toString(tile.id));
+
+    tileTextureFramebufferSize = {{ std::max(tileTextureFramebufferSize[0], size[0]),
+                                    std::max(tileTextureFramebufferSize[1], size[1]) }};
+    try {
+        tileTextureFramebuffer.bind(context, tileTextureFramebufferSize, true);
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::OpenGL, "Not caching tile textures: %s", ex.what());
+        tileTexturesUnsupported = true;
+        return false;
+    }
+    context.viewport = { 0, 0, size[0], size[1] };
+
+    // The tile's items are only ever clipped to the tile itself, i.e. to the whole texture.
+    context.clearColor = { 0.0f, 0.0f, 0.0f, 0.0f };
+    context.clearStencil = static_cast<gl::StencilValue>(tile.clip.reference.to_ulong());
+    context.clearDepth = 1;
+    context.stencilMask = 0xFF;
+    context.depthMask = true;
+    context.colorMask = { true, true, true, true };
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+    // Map the part of the view's clip space that the texture covers onto the texture's. The
+    // items are rendered as they would be onto the view, with the same size in pixels, so that
+    // everything that depends on the size of the framebuffer is given the texture's size instead.
+    const std::array<uint16_t, 2> framebufferSize = frame.framebufferSize;
+    const std::array<float, 2> viewPixelsToGLUnits = pixelsToGLUnits;
+
+    mat4 remap;
+    matrix::identity(remap);
+    remap[0] = double(framebufferSize[0]) / size[0];
+    remap[5] = double(framebufferSize[1]) / size[1];
+    remap[12] = (framebufferSize[0] - 2 * origin[0]) / size[0] - 1;
+    remap[13] = (framebufferSize[1] - 2 * origin[1]) / size[1] - 1;
+
+    RenderTile textureTile(tile.id, tile.tile);
+    textureTile.clip = tile.clip;
+    matrix::multiply(textureTile.matrix, remap, tile.matrix);
+
+    std::vector<RenderItem> renderItems;
+    for (const auto& item : items) {
+        renderItems.emplace_back(item.layer, &textureTile, item.bucket);
+    }
+    const std::vector<RenderItem>& textureItems = renderItems;
+
+    frame.framebufferSize = size;
+    pixelsToGLUnits = {{ float(viewPixelsToGLUnits[0] * remap[0]),
+                         float(viewPixelsToGLUnits[1] * remap[5]) }};
+    renderingTileTexture = true;
+
+    renderPass(parameters,
+               RenderPass::Opaque,
+               textureItems.rbegin(), textureItems.rend(),
+               0, 1);
+    renderPass(parameters,
+               RenderPass::Translucent,
+               textureItems.begin(), textureItems.end(),
+               static_cast<GLsizei>(textureItems.size()) - 1, -1);
+
+    renderingTileTexture = false;
+    pixelsToGLUnits = viewPixelsToGLUnits;
+    frame.framebufferSize = framebufferSize;
+
+    if (!texture.texture || texture.texture->size != size) {
+        texture.texture = context.createTexture(size);
+    }
+    context.bindTexture(*texture.texture, 0);
+    MBGL_CHECK_ERROR(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, size[0], size[1]));
+
+    return true;
+}
+
+void Painter::drawTileTexture(PaintParameters& parameters,
+                              TileTexture& texture,
+                              const RenderTile& tile) {
+    MBGL_DEBUG_GROUP("tile texture " + util::toString(tile.id));
+
+    // Where the texture is on screen now, in window coordinates, and then in clip space.
+    const auto tileOrigin = windowCoordinate(tile.matrix, 0, 0, frame.framebufferSize);
+    const auto& size = texture.texture->size;
+
+    mat4 matrix;
+    matrix::ortho(matrix, 0, frame.framebufferSize[0], 0, frame.framebufferSize[1], -1, 1);
+    matrix::translate(matrix, matrix,
+                      tileOrigin[0] - texture.offset[0], tileOrigin[1] - texture.offset[1], 0);
+    matrix::scale(matrix, matrix, double(size[0]) / util::EXTENT, double(size[1]) / util::EXTENT, 1);
+
+    context.stencilTest = true;
+    setClipping(tile.clip);
+    context.depthFunc = gl::DepthTestFunction::LessEqual;
+    context.depthTest = true;
+    context.depthMask = false;
+    setDepthSublayer(0);
+
+    drawTexture(parameters, *texture.texture, matrix, gl::TextureFilter::Linear);
+}
+
+} // namespace mbgl
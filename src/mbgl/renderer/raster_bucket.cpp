@@ -1,21 +1,83 @@
 #include <mbgl/renderer/raster_bucket.hpp>
 #include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/shader/raster_shader.hpp>
+#include <mbgl/shader/hillshade_shader.hpp>
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/gl/dirty_regions.hpp>
+#include <mbgl/platform/log.hpp>
+
+#include <cassert>
 
 namespace mbgl {
 
 using namespace style;
 
+const constexpr std::size_t RasterBucket::UploadStripSize;
+
 RasterBucket::RasterBucket(PremultipliedImage&& image_) : image(std::move(image_)) {
 }
 
+RasterBucket::RasterBucket(CompressedImage&& image_) : compressedImage(std::move(image_)) {
+}
+
+RasterBucket::RasterBucket(DEMData&& dem_) : dem(std::move(dem_)) {
+}
+
 void RasterBucket::upload(gl::Context& context) {
-    texture = context.createTexture(image);
-    image = {};
-    uploaded = true;
+    if (dem) {
+        // The DEM stays in memory, so that its border can be backfilled and uploaded again.
+        texture = context.createTexture(dem->image);
+        textureSize = dem->image.size() + std::size_t(dem->dim) * dem->dim * 4;
+        backfilledBorder.clear();
+        prepared = false;
+        uploaded = true;
+        return;
+    }
+
+    if (!compressedImage.data.empty()) {
+        // Tiles of formats that the GPU can't sample stay empty.
+        if (context.compressedTextureFormatSupported(compressedImage.format)) {
+            texture = context.createTexture(compressedImage);
+            textureSize = compressedImage.size();
+        } else {
+            Log::Warning(Event::OpenGL, "Compressed texture format 0x%04X isn't supported",
+                         compressedImage.format);
+        }
+        compressedImage = {};
+        uploaded = true;
+        return;
+    }
+
+    if (!image.size()) {
+        image = {};
+        uploaded = true;
+        return;
+    }
+
+    if (!texture) {
+        // Tiles of the same size share the storage of the textures released as others go.
+        texture = context.createTexture({{ image.width, image.height }});
+        textureSize = image.size();
+        uploadedRows = 0;
+    }
+
+    const std::size_t stripRows = std::max<std::size_t>(1, UploadStripSize / (image.width * 4));
+    const uint16_t rows = std::min<std::size_t>(stripRows, image.height - uploadedRows);
+    context.bindTexture(*texture, 0);
+    gl::DirtyRegions strip;
+    strip.add({ 0, uploadedRows, image.width, rows });
+    strip.upload(image.data.get(), image.width, 4, GL_RGBA);
+    uploadedRows += rows;
+
+    if (uploadedRows == image.height) {
+        // Mipmaps keep overzoomed out tiles from aliasing.
+        context.generateMipmaps(*texture);
+        textureSize = image.size() * (texture->mipmaps ? 4 : 3) / 3;
+        image = {};
+        uploaded = true;
+    }
 }
 
 void RasterBucket::render(Painter& painter,
@@ -27,12 +89,49 @@ void RasterBucket::render(Painter& painter,
 
 void RasterBucket::drawRaster(RasterShader& shader,
                               gl::VertexBuffer<RasterVertex>& vertices,
-                              gl::VertexArrayObject& array,
                               gl::Context& context) {
-    assert(texture);
-    context.bindTexture(*texture, 0, gl::TextureFilter::Linear);
-    context.bindTexture(*texture, 1, gl::TextureFilter::Linear);
-    array.bind(shader, vertices, BUFFER_OFFSET_0, context);
+    if (!texture || needsUpload()) {
+        return;
+    }
+    const gl::TextureMipMap mipmap = texture->mipmaps ? gl::TextureMipMap::Yes : gl::TextureMipMap::No;
+    context.bindTexture(*texture, 0, gl::TextureFilter::Linear, mipmap);
+    context.bindTexture(*texture, 1, gl::TextureFilter::Linear, mipmap);
+    context.bindVertexArray(shader, vertices, BUFFER_OFFSET_0);
+    MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(vertices.vertexCount)));
+}
+
+void RasterBucket::backfillBorder(const RasterBucket& other, int8_t dx, int8_t dy) {
+    if (!dem || !other.dem || dem->dim != other.dem->dim) {
+        return;
+    }
+    backfilledBorder.add(dem->backfillBorder(*other.dem, dx, dy));
+    prepared = false;
+}
+
+void RasterBucket::prepareDEM(HillshadePrepareShader& shader,
+                              gl::VertexBuffer<RasterVertex>& vertices,
+                              gl::Context& context) {
+    assert(needsPreparation());
+    context.bindTexture(*texture, 0);
+    if (!backfilledBorder.empty()) {
+        backfilledBorder.upload(dem->image.data.get(), dem->image.width, 4, GL_RGBA);
+    }
+
+    preparedTexture.bind(context, {{ uint16_t(dem->dim), uint16_t(dem->dim) }});
+    context.bindVertexArray(shader, vertices, BUFFER_OFFSET_0);
+    MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(vertices.vertexCount)));
+    prepared = true;
+}
+
+void RasterBucket::drawHillshade(HillshadeShader& shader,
+                                 gl::VertexBuffer<RasterVertex>& vertices,
+                                 gl::Context& context) {
+    // Until the first preparation; after a backfill, the last one is drawn until the next.
+    if (!preparedTexture.getSize()[0]) {
+        return;
+    }
+    context.bindTexture(preparedTexture.getTexture(), 0, gl::TextureFilter::Linear);
+    context.bindVertexArray(shader, vertices, BUFFER_OFFSET_0);
     MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast<GLsizei>(vertices.vertexCount)));
 }
 
@@ -44,4 +143,11 @@ bool RasterBucket::needsClipping() const {
     return false;
 }
 
+MemoryUsage RasterBucket::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.cpu = image.size() + compressedImage.size() + (dem ? dem->image.size() : 0);
+    usage.gpu = textureSize;
+    return usage;
+}
+
 } // namespace mbgl
@@ -1,35 +1,69 @@
 #pragma once
 
 #include <mbgl/renderer/bucket.hpp>
+#include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/util/image.hpp>
+#include <mbgl/util/ktx.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/offscreen_texture.hpp>
+#include <mbgl/gl/dirty_regions.hpp>
 #include <mbgl/gl/texture.hpp>
 
 namespace mbgl {
 
 class RasterShader;
 class RasterVertex;
+class HillshadeShader;
+class HillshadePrepareShader;
 
 namespace gl {
 class Context;
 template <class> class VertexBuffer;
-class VertexArrayObject;
 } // namespace gl
 
 class RasterBucket : public Bucket {
 public:
     RasterBucket(PremultipliedImage&&);
+    RasterBucket(CompressedImage&&);
+    RasterBucket(DEMData&&);
+
+    // Images are uploaded in strips of about this many bytes, one per call to upload(), so that
+    // the upload of a large tile can be spread over several frames. The bucket needs uploading
+    // until the last strip is in.
+    static constexpr std::size_t UploadStripSize = 256 * 1024;
 
     void upload(gl::Context&) override;
     void render(Painter&, PaintParameters&, const style::Layer&, const RenderTile&) override;
     bool hasData() const override;
     bool needsClipping() const override;
+    MemoryUsage getMemoryUsage() const override;
+
+    void drawRaster(RasterShader&, gl::VertexBuffer<RasterVertex>&, gl::Context&);
 
-    void drawRaster(RasterShader&, gl::VertexBuffer<RasterVertex>&, gl::VertexArrayObject&, gl::Context&);
+    // Elevation models are hillshaded from their slope and aspect, which are rendered into a
+    // texture of the tile's size once they're uploaded, and again only when their border is
+    // backfilled, so that each frame only looks them up. DEM tiles are uploaded in one go.
+    const DEMData* getDEM() const { return dem ? &*dem : nullptr; }
+    bool needsPreparation() const { return dem && !needsUpload() && !prepared; }
+    void backfillBorder(const RasterBucket& other, int8_t dx, int8_t dy);
+
+    // Renders the slope and aspect with the shader, whose uniforms are set, into the bucket's
+    // texture of them. Binds the texture's framebuffer.
+    void prepareDEM(HillshadePrepareShader&, gl::VertexBuffer<RasterVertex>&, gl::Context&);
+    void drawHillshade(HillshadeShader&, gl::VertexBuffer<RasterVertex>&, gl::Context&);
 
 private:
     PremultipliedImage image;
+    CompressedImage compressedImage;
     optional<gl::Texture> texture;
+    std::size_t textureSize = 0;
+    uint16_t uploadedRows = 0;
+
+    optional<DEMData> dem;
+    // The texels of the DEM's border that were backfilled since it was uploaded.
+    gl::DirtyRegions backfilledBorder;
+    OffscreenTexture preparedTexture;
+    bool prepared = false;
 };
 
 } // namespace mbgl
@@ -33,6 +33,13 @@ public:
     Color backgroundColor;
     std::unordered_set<style::Source*> sources;
     std::vector<RenderItem> order;
+
+    // Differs between all render data that a style builds, so that the painter can tell whether
+    // it still renders the same items as in an earlier frame.
+    uint64_t serial = 0;
+
+    // Stays the same for as long as the style does, while the render tiles may change.
+    uint64_t styleSerial = 0;
 };
 
 } // namespace mbgl
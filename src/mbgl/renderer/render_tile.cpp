@@ -1,34 +1,53 @@
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/map/transform_state.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 using namespace style;
 
-mat4 RenderTile::translatedMatrix(const std::array<float, 2>& translation,
-                                  TranslateAnchorType anchor,
-                                  const TransformState& state) const {
+void RenderTile::calculateMatrix(const mat4& projMatrix, const TransformState& state) {
+    state.matrixFor(matrix, id);
+    matrix::multiply(matrix, projMatrix, matrix);
+    translatedMatrixCount = 0;
+}
+
+const mat4& RenderTile::translatedMatrix(const std::array<float, 2>& translation,
+                                         TranslateAnchorType anchor,
+                                         const TransformState& state) const {
     if (translation[0] == 0 && translation[1] == 0) {
         return matrix;
     }
 
-    mat4 vtxMatrix;
+    const std::size_t cached = std::min(translatedMatrixCount, translatedMatrices.size());
+    for (std::size_t i = 0; i < cached; ++i) {
+        const TranslatedMatrix& entry = translatedMatrices[i];
+        if (entry.translate == translation && entry.anchor == anchor) {
+            return entry.matrix;
+        }
+    }
+
+    // Once every slot is taken, the oldest one is reused.
+    TranslatedMatrix& entry = translatedMatrices[translatedMatrixCount++ % translatedMatrices.size()];
+    entry.translate = translation;
+    entry.anchor = anchor;
 
     if (anchor == TranslateAnchorType::Viewport) {
         const double sin_a = std::sin(-state.getAngle());
         const double cos_a = std::cos(-state.getAngle());
-        matrix::translate(vtxMatrix, matrix,
+        matrix::translate(entry.matrix, matrix,
                 id.pixelsToTileUnits(translation[0] * cos_a - translation[1] * sin_a, state.getZoom()),
                 id.pixelsToTileUnits(translation[0] * sin_a + translation[1] * cos_a, state.getZoom()),
                 0);
     } else {
-        matrix::translate(vtxMatrix, matrix,
+        matrix::translate(entry.matrix, matrix,
                 id.pixelsToTileUnits(translation[0], state.getZoom()),
                 id.pixelsToTileUnits(translation[1], state.getZoom()),
                 0);
     }
 
-    return vtxMatrix;
+    return entry.matrix;
 }
 
 } // namespace mbgl
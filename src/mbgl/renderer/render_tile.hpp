@@ -23,11 +23,29 @@ public:
     const UnwrappedTileID id;
     Tile& tile;
     ClipID clip;
+    // The projection of the tile for the current frame; see calculateMatrix().
     mat4 matrix;
 
-    mat4 translatedMatrix(const std::array<float, 2>& translate,
-                          style::TranslateAnchorType anchor,
-                          const TransformState&) const;
+    // Set by the painter for tiles that cover too little of the screen to be worth rendering.
+    bool culled = false;
+
+    // Projects the tile for a frame, and forgets the translated matrices of the last one.
+    void calculateMatrix(const mat4& projMatrix, const TransformState&);
+
+    // The matrix of the tile translated as a layer asks for. Layers with the same translation
+    // share it for the rest of the frame; the reference is valid until the next call.
+    const mat4& translatedMatrix(const std::array<float, 2>& translate,
+                                 style::TranslateAnchorType anchor,
+                                 const TransformState&) const;
+
+private:
+    struct TranslatedMatrix {
+        std::array<float, 2> translate;
+        style::TranslateAnchorType anchor;
+        mat4 matrix;
+    };
+    mutable std::array<TranslatedMatrix, 4> translatedMatrices;
+    mutable std::size_t translatedMatrixCount = 0;
 };
 
 } // namespace mbgl
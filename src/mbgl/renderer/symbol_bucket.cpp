@@ -5,6 +5,7 @@
 #include <mbgl/shader/symbol_icon_shader.hpp>
 #include <mbgl/shader/collision_box_shader.hpp>
 #include <mbgl/gl/gl.hpp>
+#include <mbgl/math/minmax.hpp>
 
 namespace mbgl {
 
@@ -21,15 +22,8 @@ SymbolBucket::SymbolBucket(const MapMode mode_,
 }
 
 void SymbolBucket::upload(gl::Context& context) {
-    if (hasTextData()) {
-        text.vertexBuffer = context.createVertexBuffer(std::move(text.vertices));
-        text.indexBuffer = context.createIndexBuffer(std::move(text.triangles));
-    }
-
-    if (hasIconData()) {
-        icon.vertexBuffer = context.createVertexBuffer(std::move(icon.vertices));
-        icon.indexBuffer = context.createIndexBuffer(std::move(icon.triangles));
-    }
+    upload(context, text);
+    upload(context, icon);
 
     if (hasCollisionBoxData()) {
         collisionBox.vertexBuffer = context.createVertexBuffer(std::move(collisionBox.vertices));
@@ -38,6 +32,38 @@ void SymbolBucket::upload(gl::Context& context) {
     uploaded = true;
 }
 
+void SymbolBucket::upload(gl::Context& context, SymbolBuffer& buffer) {
+    if (!buffer.placed) {
+        return;
+    }
+
+    // The quads are copied, since they may be shared with the next placement, which uploads them
+    // again only if it doesn't replace this bucket.
+    if (!buffer.vertexBuffer) {
+        buffer.vertexBuffer = context.createVertexBuffer(std::vector<SymbolVertex>(buffer.quads->vertices));
+        buffer.indexBuffer = uploadElementGroups(context, std::vector<gl::Triangle>(buffer.quads->triangles),
+                                                 buffer.quads->groups);
+    }
+    buffer.placementBuffer = context.createVertexBuffer(std::move(buffer.placementVertices));
+}
+
+void SymbolBucket::adoptBuffers(Bucket& previous) {
+    if (auto symbolBucket = dynamic_cast<SymbolBucket*>(&previous)) {
+        adoptBuffers(text, symbolBucket->text);
+        adoptBuffers(icon, symbolBucket->icon);
+    }
+}
+
+void SymbolBucket::adoptBuffers(SymbolBuffer& buffer, SymbolBuffer& previous) {
+    if (buffer.vertexBuffer || !previous.vertexBuffer || buffer.quads != previous.quads) {
+        return;
+    }
+    buffer.vertexBuffer = std::move(previous.vertexBuffer);
+    buffer.indexBuffer = std::move(previous.indexBuffer);
+    previous.vertexBuffer = {};
+    previous.indexBuffer = {};
+}
+
 void SymbolBucket::render(Painter& painter,
                           PaintParameters& parameters,
                           const Layer& layer,
@@ -51,11 +77,11 @@ bool SymbolBucket::hasData() const {
 }
 
 bool SymbolBucket::hasTextData() const {
-    return !text.groups.empty();
+    return text.placed;
 }
 
 bool SymbolBucket::hasIconData() const {
-    return !icon.groups.empty();
+    return icon.placed;
 }
 
 bool SymbolBucket::hasCollisionBoxData() const {
@@ -66,57 +92,63 @@ bool SymbolBucket::needsClipping() const {
     return mode == MapMode::Still;
 }
 
-void SymbolBucket::drawGlyphs(SymbolSDFShader& shader,
-                              gl::Context& context,
-                              PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET_0;
-    GLbyte* elements_index = BUFFER_OFFSET_0;
-    for (auto& group : text.groups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *text.vertexBuffer, *text.indexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * text.vertexBuffer->vertexSize;
-        elements_index += group.indexLength * text.indexBuffer->primitiveSize;
+MemoryUsage SymbolBucket::getMemoryUsage() const {
+    const auto quadsMemoryUsage = [] (const SymbolBuffer& buffer) -> std::size_t {
+        if (!buffer.quads) {
+            return 0;
+        }
+        return util::memoryUsage(buffer.quads->vertices) + util::memoryUsage(buffer.quads->triangles) +
+               util::memoryUsage(buffer.quads->groups);
+    };
+
+    MemoryUsage usage;
+    usage.cpu = quadsMemoryUsage(text) + util::memoryUsage(text.placementVertices) +
+                quadsMemoryUsage(icon) + util::memoryUsage(icon.placementVertices) +
+                util::memoryUsage(collisionBox.vertices) + util::memoryUsage(collisionBox.lines) +
+                util::memoryUsage(collisionBox.groups);
+    usage.gpu = util::bufferMemoryUsage(text.vertexBuffer) + util::bufferMemoryUsage(text.indexBuffer) +
+                util::bufferMemoryUsage(text.placementBuffer) +
+                util::bufferMemoryUsage(icon.vertexBuffer) + util::bufferMemoryUsage(icon.indexBuffer) +
+                util::bufferMemoryUsage(icon.placementBuffer) +
+                util::bufferMemoryUsage(collisionBox.vertexBuffer) +
+                util::bufferMemoryUsage(collisionBox.indexBuffer);
+    return usage;
+}
+
+float SymbolBucket::getFadeChange(TimePoint now, Duration fadeDuration) const {
+    if (!fading || fadeDuration == Duration::zero()) {
+        return 1;
     }
+    return util::max(0.0f, std::chrono::duration<float>(now - placementTime) / fadeDuration);
+}
+
+TimePoint SymbolBucket::getFadeEnd(Duration fadeDuration) const {
+    return fading ? placementTime + fadeDuration : TimePoint::min();
+}
+
+void SymbolBucket::drawGlyphs(SymbolSDFShader& shader,
+                              gl::Context& context) {
+    drawElementGroups(shader, text.quads->groups, *text.vertexBuffer, *text.placementBuffer,
+                      *text.indexBuffer, context);
 }
 
 void SymbolBucket::drawIcons(SymbolSDFShader& shader,
-                             gl::Context& context,
-                             PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET_0;
-    GLbyte* elements_index = BUFFER_OFFSET_0;
-    for (auto& group : icon.groups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *icon.vertexBuffer, *icon.indexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * icon.vertexBuffer->vertexSize;
-        elements_index += group.indexLength * icon.indexBuffer->primitiveSize;
-    }
+                             gl::Context& context) {
+    drawElementGroups(shader, icon.quads->groups, *icon.vertexBuffer, *icon.placementBuffer,
+                      *icon.indexBuffer, context);
 }
 
 void SymbolBucket::drawIcons(SymbolIconShader& shader,
-                             gl::Context& context,
-                             PaintMode paintMode) {
-    GLbyte* vertex_index = BUFFER_OFFSET_0;
-    GLbyte* elements_index = BUFFER_OFFSET_0;
-    for (auto& group : icon.groups) {
-        group.getVAO(shader, paintMode).bind(
-            shader, *icon.vertexBuffer, *icon.indexBuffer, vertex_index, context);
-        MBGL_CHECK_ERROR(glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(group.indexLength * 3), GL_UNSIGNED_SHORT,
-                                        elements_index));
-        vertex_index += group.vertexLength * icon.vertexBuffer->vertexSize;
-        elements_index += group.indexLength * icon.indexBuffer->primitiveSize;
-    }
+                             gl::Context& context) {
+    drawElementGroups(shader, icon.quads->groups, *icon.vertexBuffer, *icon.placementBuffer,
+                      *icon.indexBuffer, context);
 }
 
 void SymbolBucket::drawCollisionBoxes(CollisionBoxShader& shader,
                                       gl::Context& context) {
     GLbyte* vertex_index = BUFFER_OFFSET_0;
     for (auto& group : collisionBox.groups) {
-        group.getVAO(shader, PaintMode::Regular).bind(
-            shader, *collisionBox.vertexBuffer, vertex_index, context);
+        context.bindVertexArray(shader, *collisionBox.vertexBuffer, vertex_index);
         MBGL_CHECK_ERROR(glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(group.vertexLength)));
     }
 }
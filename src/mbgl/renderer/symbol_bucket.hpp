@@ -9,6 +9,7 @@
 #include <mbgl/shader/collision_box_vertex.hpp>
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/util/chrono.hpp>
 
 #include <memory>
 #include <vector>
@@ -33,10 +34,17 @@ public:
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
     bool needsClipping() const override;
+    MemoryUsage getMemoryUsage() const override;
+    void adoptBuffers(Bucket&) override;
 
-    void drawGlyphs(SymbolSDFShader&, gl::Context&, PaintMode);
-    void drawIcons(SymbolSDFShader&, gl::Context&, PaintMode);
-    void drawIcons(SymbolIconShader&, gl::Context&, PaintMode);
+    // How far the symbols have faded since the placement, from 0 to 1 over `fadeDuration`.
+    float getFadeChange(TimePoint, Duration fadeDuration) const;
+    // The time at which all symbols have faded in or out, or TimePoint::min() if none fade.
+    TimePoint getFadeEnd(Duration fadeDuration) const;
+
+    void drawGlyphs(SymbolSDFShader&, gl::Context&);
+    void drawIcons(SymbolSDFShader&, gl::Context&);
+    void drawIcons(SymbolIconShader&, gl::Context&);
     void drawCollisionBoxes(CollisionBoxShader&, gl::Context&);
 
     const MapMode mode;
@@ -47,28 +55,38 @@ public:
 private:
     friend class SymbolLayout;
 
-    struct TextBuffer {
+    // The quads of a layout's text or icons, including those that aren't placed. Whole placement
+    // passes can share them, see SymbolLayout::place().
+    struct Quads {
         std::vector<SymbolVertex> vertices;
         std::vector<gl::Triangle> triangles;
-        std::vector<ElementGroup<SymbolSDFShader>> groups;
+        std::vector<ElementGroup> groups;
+    };
+
+    struct SymbolBuffer {
+        std::shared_ptr<const Quads> quads;
+        std::vector<SymbolPlacementVertex> placementVertices;
+        bool placed = false;
 
         optional<gl::VertexBuffer<SymbolVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Triangle>> indexBuffer;
-    } text;
+        optional<gl::VertexBuffer<SymbolPlacementVertex>> placementBuffer;
+    };
 
-    struct IconBuffer {
-        std::vector<SymbolVertex> vertices;
-        std::vector<gl::Triangle> triangles;
-        std::vector<ElementGroup<SymbolSDFShader, SymbolIconShader>> groups;
+    static void upload(gl::Context&, SymbolBuffer&);
+    static void adoptBuffers(SymbolBuffer&, SymbolBuffer&);
 
-        optional<gl::VertexBuffer<SymbolVertex>> vertexBuffer;
-        optional<gl::IndexBuffer<gl::Triangle>> indexBuffer;
-    } icon;
+    SymbolBuffer text;
+    SymbolBuffer icon;
+
+    // When the symbols were placed, and whether any of them were still fading in or out then.
+    TimePoint placementTime = TimePoint::min();
+    bool fading = false;
 
     struct CollisionBoxBuffer {
         std::vector<CollisionBoxVertex> vertices;
         std::vector<gl::Line> lines;
-        std::vector<ElementGroup<CollisionBoxShader>> groups;
+        std::vector<ElementGroup> groups;
 
         optional<gl::VertexBuffer<CollisionBoxVertex>> vertexBuffer;
         optional<gl::IndexBuffer<gl::Line>> indexBuffer;
@@ -0,0 +1,10 @@
+#include <mbgl/shader/category_vertex.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(CategoryVertex) == 4, "expected CategoryVertex size");
+static_assert(sizeof(CategoryVertex) == gl::attributeSize<CategoryVertex>(
+                  &CategoryVertex::a_category),
+              "CategoryVertex has padding");
+
+} // namespace mbgl
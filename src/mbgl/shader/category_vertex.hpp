@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/gl/attribute.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace mbgl {
+
+// Features are in one of up to this many categories, which shaders show, hide or highlight
+// according to the bit masks in their uniforms.
+constexpr std::size_t MaxFeatureCategories = 32;
+
+// The category of the features that aren't in any, which are always drawn as they are.
+constexpr uint8_t NoFeatureCategory = 255;
+
+// The category of a vertex, i.e. of its feature. Buckets keep these in a vertex buffer of their
+// own, next to the one with the positions of the vertices; the other bytes keep the attribute
+// aligned.
+class CategoryVertex {
+public:
+    explicit CategoryVertex(uint8_t category)
+        : a_category { category, 0, 0, 0 } {}
+
+    const uint8_t a_category[4];
+};
+
+namespace gl {
+
+template <class Shader>
+struct AttributeBindings<Shader, CategoryVertex> {
+    std::array<AttributeBinding, 1> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(CategoryVertex, shader, a_category)
+        }};
+    };
+};
+
+} // namespace gl
+} // namespace mbgl
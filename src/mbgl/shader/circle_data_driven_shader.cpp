@@ -0,0 +1,156 @@
+#include <mbgl/shader/circle_data_driven_shader.hpp>
+#include <mbgl/shader/circle_vertex.hpp>
+#include <mbgl/shader/color_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// The circle shaders, with the color passed on from an attribute. The colors are premultiplied
+// bytes.
+
+constexpr const char* vertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform bool u_scale_with_map;
+uniform vec2 u_extrude_scale;
+uniform float u_devicepixelratio;
+uniform mediump float u_radius;
+
+attribute vec2 a_pos;
+attribute vec4 a_color;
+
+varying vec2 v_extrude;
+varying lowp float v_antialiasblur;
+varying lowp vec4 v_color;
+
+void main(void) {
+    v_color = a_color / 255.0;
+
+    // unencode the extrusion vector that we snuck into the a_pos vector
+    v_extrude = vec2(mod(a_pos, 2.0) * 2.0 - 1.0);
+
+    vec2 extrude = v_extrude * u_radius * u_extrude_scale;
+    // multiply a_pos by 0.5, since we had it * 2 in order to sneak
+    // in extrusion data
+    gl_Position = u_matrix * vec4(floor(a_pos * 0.5), 0, 1);
+
+    if (u_scale_with_map) {
+        gl_Position.xy += extrude;
+    } else {
+        gl_Position.xy += extrude * gl_Position.w;
+    }
+
+    v_antialiasblur = 1.0 / u_devicepixelratio / u_radius;
+}
+)MBGL_SHADER";
+
+constexpr const char* instancedVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform bool u_scale_with_map;
+uniform vec2 u_extrude_scale;
+uniform float u_devicepixelratio;
+uniform mediump float u_radius;
+
+attribute vec2 a_pos;
+attribute vec2 a_extrude;
+attribute vec4 a_color;
+
+varying vec2 v_extrude;
+varying lowp float v_antialiasblur;
+varying lowp vec4 v_color;
+
+void main(void) {
+    v_color = a_color / 255.0;
+    v_extrude = a_extrude;
+
+    vec2 extrude = v_extrude * u_radius * u_extrude_scale;
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+
+    if (u_scale_with_map) {
+        gl_Position.xy += extrude;
+    } else {
+        gl_Position.xy += extrude * gl_Position.w;
+    }
+
+    v_antialiasblur = 1.0 / u_devicepixelratio / u_radius;
+}
+)MBGL_SHADER";
+
+constexpr const char* fragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp float u_blur;
+uniform lowp float u_opacity;
+
+varying vec2 v_extrude;
+varying lowp float v_antialiasblur;
+varying lowp vec4 v_color;
+
+void main() {
+    float t = smoothstep(1.0 - max(u_blur, v_antialiasblur), 1.0, length(v_extrude));
+    gl_FragColor = v_color * (1.0 - t) * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
+CircleDataDrivenShader::CircleDataDrivenShader(gl::Context& context, Defines defines)
+    : Shader("circle_data_driven",
+             vertexSource,
+             fragmentSource,
+             context, defines) {
+}
+
+CircleInstancedDataDrivenShader::CircleInstancedDataDrivenShader(gl::Context& context, Defines defines)
+    : Shader("circle_instanced_data_driven",
+             instancedVertexSource,
+             fragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+
+class CircleVertex;
+class CircleCornerVertex;
+
+// Draws circles like CircleShader, but with the data-driven color of each circle read from a
+// ColorVertex attribute instead of a uniform.
+class CircleDataDrivenShader : public gl::Shader {
+public:
+    CircleDataDrivenShader(gl::Context&, Defines defines = None);
+
+    using VertexType = CircleVertex;
+
+    gl::Attribute<int16_t, 2> a_pos   = {"a_pos",   *this};
+    gl::Attribute<uint8_t, 4> a_color = {"a_color", *this};
+
+    gl::UniformMatrix<4>              u_matrix           = {"u_matrix",           *this};
+    gl::Uniform<std::array<float, 2>> u_extrude_scale    = {"u_extrude_scale",    *this};
+    gl::Uniform<float>                u_devicepixelratio = {"u_devicepixelratio", *this};
+    gl::Uniform<float>                u_radius           = {"u_radius",           *this};
+    gl::Uniform<float>                u_blur             = {"u_blur",             *this};
+    gl::Uniform<float>                u_opacity          = {"u_opacity",          *this};
+    gl::Uniform<int32_t>              u_scale_with_map   = {"u_scale_with_map",   *this};
+};
+
+// Draws circles like CircleInstancedShader, with the data-driven colors advancing once per
+// instance like the centers.
+class CircleInstancedDataDrivenShader : public gl::Shader {
+public:
+    CircleInstancedDataDrivenShader(gl::Context&, Defines defines = None);
+
+    using VertexType = CircleCornerVertex;
+
+    gl::Attribute<int16_t, 2> a_pos     = {"a_pos",     *this};
+    gl::Attribute<int16_t, 2> a_extrude = {"a_extrude", *this};
+    gl::Attribute<uint8_t, 4> a_color   = {"a_color",   *this};
+
+    gl::UniformMatrix<4>              u_matrix           = {"u_matrix",           *this};
+    gl::Uniform<std::array<float, 2>> u_extrude_scale    = {"u_extrude_scale",    *this};
+    gl::Uniform<float>                u_devicepixelratio = {"u_devicepixelratio", *this};
+    gl::Uniform<float>                u_radius           = {"u_radius",           *this};
+    gl::Uniform<float>                u_blur             = {"u_blur",             *this};
+    gl::Uniform<float>                u_opacity          = {"u_opacity",          *this};
+    gl::Uniform<int32_t>              u_scale_with_map   = {"u_scale_with_map",   *this};
+};
+
+} // namespace mbgl
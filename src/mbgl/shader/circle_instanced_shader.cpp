@@ -0,0 +1,68 @@
+#include <mbgl/shader/circle_instanced_shader.hpp>
+#include <mbgl/shader/circle.fragment.hpp>
+#include <mbgl/shader/circle_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// The vertex shader of the circle shader, with the center and the extrusion read from separate
+// attributes instead of both being packed into a_pos. It pairs with the regular circle fragment
+// shader, so the varyings have to match it.
+constexpr const char* vertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform bool u_scale_with_map;
+uniform vec2 u_extrude_scale;
+uniform float u_devicepixelratio;
+uniform mediump float u_radius;
+
+attribute vec2 a_pos;
+attribute vec2 a_extrude;
+
+varying vec2 v_extrude;
+varying lowp float v_antialiasblur;
+
+void main(void) {
+    v_extrude = a_extrude;
+
+    vec2 extrude = v_extrude * u_radius * u_extrude_scale;
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+
+    if (u_scale_with_map) {
+        gl_Position.xy += extrude;
+    } else {
+        gl_Position.xy += extrude * gl_Position.w;
+    }
+
+    // This is a minimum blur distance that serves as a faux-antialiasing for
+    // the circle. since blur is a ratio of the circle's size and the intent is
+    // to keep the blur at roughly 1px, the two are inversely related.
+    v_antialiasblur = 1.0 / u_devicepixelratio / u_radius;
+}
+)MBGL_SHADER";
+
+} // namespace
+
+CircleInstancedShader::CircleInstancedShader(gl::Context& context, Defines defines)
+    : Shader("circle_instanced",
+             vertexSource,
+             shaders::circle::fragment,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -3,5 +3,16 @@
 namespace mbgl {
 
 static_assert(sizeof(CircleVertex) == 4, "expected CircleVertex size");
+static_assert(sizeof(CircleVertex) == gl::attributeSize<CircleVertex>(
+                  &CircleVertex::a_pos),
+              "CircleVertex has padding");
+static_assert(sizeof(CircleInstance) == 4, "expected CircleInstance size");
+static_assert(sizeof(CircleInstance) == gl::attributeSize<CircleInstance>(
+                  &CircleInstance::a_pos),
+              "CircleInstance has padding");
+static_assert(sizeof(CircleCornerVertex) == 4, "expected CircleCornerVertex size");
+static_assert(sizeof(CircleCornerVertex) == gl::attributeSize<CircleCornerVertex>(
+                  &CircleCornerVertex::a_extrude),
+              "CircleCornerVertex has padding");
 
 } // namespace mbgl
@@ -24,6 +24,25 @@ public:
     const int16_t a_pos[2];
 };
 
+// The center of a circle drawn with instancing, which takes one of these per circle instead of
+// four CircleVertex.
+class CircleInstance {
+public:
+    CircleInstance(int16_t x, int16_t y)
+        : a_pos { x, y } {}
+
+    const int16_t a_pos[2];
+};
+
+// A corner of the quad that each circle instance is drawn with.
+class CircleCornerVertex {
+public:
+    CircleCornerVertex(int16_t ex, int16_t ey)
+        : a_extrude { ex, ey } {}
+
+    const int16_t a_extrude[2];
+};
+
 namespace gl {
 
 template <class Shader>
@@ -35,5 +54,23 @@ struct AttributeBindings<Shader, CircleVertex> {
     };
 };
 
+template <class Shader>
+struct AttributeBindings<Shader, CircleInstance> {
+    std::array<AttributeBinding, 1> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(CircleInstance, shader, a_pos)
+        }};
+    };
+};
+
+template <class Shader>
+struct AttributeBindings<Shader, CircleCornerVertex> {
+    std::array<AttributeBinding, 1> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(CircleCornerVertex, shader, a_extrude)
+        }};
+    };
+};
+
 } // namespace gl
 } // namespace mbgl
@@ -3,5 +3,8 @@
 namespace mbgl {
 
 static_assert(sizeof(CollisionBoxVertex) == 10, "expected CollisionBoxVertex size");
+static_assert(sizeof(CollisionBoxVertex) == gl::attributeSize<CollisionBoxVertex>(
+                  &CollisionBoxVertex::a_pos, &CollisionBoxVertex::a_extrude, &CollisionBoxVertex::a_data),
+              "CollisionBoxVertex has padding");
 
 } // namespace mbgl
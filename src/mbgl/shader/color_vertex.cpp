@@ -0,0 +1,10 @@
+#include <mbgl/shader/color_vertex.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(ColorVertex) == 4, "expected ColorVertex size");
+static_assert(sizeof(ColorVertex) == gl::attributeSize<ColorVertex>(
+                  &ColorVertex::a_color),
+              "ColorVertex has padding");
+
+} // namespace mbgl
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/util/color.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace mbgl {
+
+// The data-driven color of a vertex, i.e. of its feature, as premultiplied bytes. Buckets keep
+// these in a vertex buffer of their own, next to the one with the positions of the vertices.
+class ColorVertex {
+public:
+    explicit ColorVertex(const Color& color)
+        : a_color {
+            component(color.r),
+            component(color.g),
+            component(color.b),
+            component(color.a)
+        } {}
+
+    const uint8_t a_color[4];
+
+private:
+    static uint8_t component(float value) {
+        return static_cast<uint8_t>(std::round(std::fmin(std::fmax(value, 0.0f), 1.0f) * 255));
+    }
+};
+
+namespace gl {
+
+template <class Shader>
+struct AttributeBindings<Shader, ColorVertex> {
+    std::array<AttributeBinding, 1> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(ColorVertex, shader, a_color)
+        }};
+    };
+};
+
+} // namespace gl
+} // namespace mbgl
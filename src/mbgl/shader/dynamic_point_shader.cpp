@@ -0,0 +1,79 @@
+#include <mbgl/shader/dynamic_point_shader.hpp>
+#include <mbgl/shader/dynamic_point_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+constexpr const char* vertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform vec2 u_center;
+uniform vec2 u_center_low;
+uniform float u_size;
+
+attribute vec2 a_pos;
+attribute vec2 a_pos_low;
+
+void main(void) {
+    // Subtracting the parts separately keeps the precision that a single float lacks.
+    vec2 pos = (a_pos - u_center) + (a_pos_low - u_center_low);
+    gl_Position = u_matrix * vec4(pos, 0, 1);
+    gl_PointSize = u_size;
+}
+)MBGL_SHADER";
+
+// gl_PointCoord needs GLSL 1.20 on desktop OpenGL.
+constexpr const char* fragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision mediump float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp vec4 u_color;
+uniform lowp float u_opacity;
+uniform lowp float u_antialiasblur;
+
+void main() {
+    float t = smoothstep(1.0 - u_antialiasblur, 1.0, length(gl_PointCoord * 2.0 - 1.0));
+    gl_FragColor = u_color * (1.0 - t) * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
+DynamicPointShader::DynamicPointShader(gl::Context& context, Defines defines)
+    : Shader("dynamic_point",
+             vertexSource,
+             fragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+
+class DynamicPointVertex;
+
+// Draws the points of a dynamic point layer as circles, one GL_POINTS vertex each, so that a
+// point that moves only changes its own vertex.
+class DynamicPointShader : public gl::Shader {
+public:
+    DynamicPointShader(gl::Context&, Defines defines = None);
+
+    using VertexType = DynamicPointVertex;
+
+    gl::Attribute<float, 2> a_pos     = {"a_pos",     *this};
+    gl::Attribute<float, 2> a_pos_low = {"a_pos_low", *this};
+
+    // Maps world coordinates relative to the center to clip space.
+    gl::UniformMatrix<4>              u_matrix          = {"u_matrix",          *this};
+    gl::Uniform<std::array<float, 2>> u_center          = {"u_center",          *this};
+    gl::Uniform<std::array<float, 2>> u_center_low      = {"u_center_low",      *this};
+    // The diameter of the circles, in framebuffer pixels.
+    gl::Uniform<float>                u_size            = {"u_size",            *this};
+    gl::Uniform<float>                u_antialiasblur   = {"u_antialiasblur",   *this};
+    gl::Uniform<Color>                u_color           = {"u_color",           *this};
+    gl::Uniform<float>                u_opacity         = {"u_opacity",         *this};
+};
+
+} // namespace mbgl
@@ -0,0 +1,11 @@
+#include <mbgl/shader/dynamic_point_vertex.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(DynamicPointVertex) == 16, "expected DynamicPointVertex size");
+static_assert(sizeof(DynamicPointVertex) == gl::attributeSize<DynamicPointVertex>(
+                  &DynamicPointVertex::a_pos,
+                  &DynamicPointVertex::a_pos_low),
+              "DynamicPointVertex has padding");
+
+} // namespace mbgl
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <mbgl/gl/attribute.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace mbgl {
+
+// A point of a dynamic point layer, in world coordinates from 0 to 1. Floats alone would place
+// points several pixels off at high zoom levels, so the position is split into the float nearest
+// to it, and the rest; the shader subtracts the center of the map from both separately.
+class DynamicPointVertex {
+public:
+    DynamicPointVertex(double x, double y)
+        : a_pos {
+              static_cast<float>(x),
+              static_cast<float>(y)
+          },
+          a_pos_low {
+              static_cast<float>(x - static_cast<float>(x)),
+              static_cast<float>(y - static_cast<float>(y))
+          } {}
+
+    const float a_pos[2];
+    const float a_pos_low[2];
+};
+
+namespace gl {
+
+template <class Shader>
+struct AttributeBindings<Shader, DynamicPointVertex> {
+    std::array<AttributeBinding, 2> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(DynamicPointVertex, shader, a_pos),
+            MBGL_MAKE_ATTRIBUTE_BINDING(DynamicPointVertex, shader, a_pos_low)
+        }};
+    };
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -0,0 +1,10 @@
+#include <mbgl/shader/feature_state_vertex.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(FeatureStateVertex) == 4, "expected FeatureStateVertex size");
+static_assert(sizeof(FeatureStateVertex) == gl::attributeSize<FeatureStateVertex>(
+                  &FeatureStateVertex::a_feature),
+              "FeatureStateVertex has padding");
+
+} // namespace mbgl
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/gl/attribute.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace mbgl {
+
+// The texel of a vertex's feature in its bucket's feature state texture, which is this many
+// texels wide. Texel 0 is never set, for the features that have no ID or don't fit into the
+// texture.
+constexpr uint16_t FeatureStateTextureWidth = 256;
+constexpr std::size_t MaxFeatureStates = 65535;
+
+// Buckets keep these in a vertex buffer of their own, next to the one with the positions of the
+// vertices; the other bytes keep the attribute aligned.
+class FeatureStateVertex {
+public:
+    explicit FeatureStateVertex(uint16_t texel)
+        : a_feature {
+            static_cast<uint8_t>(texel % FeatureStateTextureWidth),
+            static_cast<uint8_t>(texel / FeatureStateTextureWidth),
+            0,
+            0
+        } {}
+
+    const uint8_t a_feature[4];
+};
+
+namespace gl {
+
+template <class Shader>
+struct AttributeBindings<Shader, FeatureStateVertex> {
+    std::array<AttributeBinding, 1> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(FeatureStateVertex, shader, a_feature)
+        }};
+    };
+};
+
+} // namespace gl
+} // namespace mbgl
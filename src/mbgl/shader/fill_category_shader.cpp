@@ -0,0 +1,192 @@
+#include <mbgl/shader/fill_category_shader.hpp>
+#include <mbgl/shader/fill_vertex.hpp>
+#include <mbgl/shader/category_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// The fill and fill outline shaders, with the features filtered by their category. GLSL ES 1.0
+// has no integer bit operations, so the bit of a category is picked out of its mask byte with
+// floating-point arithmetic, which is exact for these small integers. Categories past the masks
+// are always visible and never highlighted.
+
+constexpr const char* fillVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform lowp vec4 u_color;
+uniform lowp vec4 u_highlight_color;
+uniform vec4 u_visible_categories;
+uniform vec4 u_highlighted_categories;
+
+float category_bit(vec4 mask, float category) {
+    float bits = dot(mask, vec4(equal(vec4(floor(category / 8.0)), vec4(0.0, 1.0, 2.0, 3.0))));
+    return mod(floor((bits + 0.5) / exp2(mod(category, 8.0))), 2.0);
+}
+
+bool category_visible(float category) {
+    return category >= 32.0 || category_bit(u_visible_categories, category) > 0.5;
+}
+
+float category_highlight(float category) {
+    return category >= 32.0 ? 0.0 : category_bit(u_highlighted_categories, category);
+}
+
+attribute vec2 a_pos;
+attribute vec4 a_category;
+
+varying lowp vec4 v_color;
+
+void main() {
+    v_color = mix(u_color, u_highlight_color, category_highlight(a_category.x));
+    if (category_visible(a_category.x)) {
+        gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    } else {
+        // Outside of the clip volume, so that the triangles of the feature are culled.
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+    }
+}
+)MBGL_SHADER";
+
+constexpr const char* fillFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp float u_opacity;
+
+varying lowp vec4 v_color;
+
+void main() {
+    gl_FragColor = v_color * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+constexpr const char* outlineVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform vec2 u_world;
+uniform lowp vec4 u_outline_color;
+uniform lowp vec4 u_highlight_color;
+uniform vec4 u_visible_categories;
+uniform vec4 u_highlighted_categories;
+
+float category_bit(vec4 mask, float category) {
+    float bits = dot(mask, vec4(equal(vec4(floor(category / 8.0)), vec4(0.0, 1.0, 2.0, 3.0))));
+    return mod(floor((bits + 0.5) / exp2(mod(category, 8.0))), 2.0);
+}
+
+bool category_visible(float category) {
+    return category >= 32.0 || category_bit(u_visible_categories, category) > 0.5;
+}
+
+float category_highlight(float category) {
+    return category >= 32.0 ? 0.0 : category_bit(u_highlighted_categories, category);
+}
+
+attribute vec2 a_pos;
+attribute vec4 a_category;
+
+varying vec2 v_pos;
+varying lowp vec4 v_color;
+
+void main() {
+    v_color = mix(u_outline_color, u_highlight_color, category_highlight(a_category.x));
+    if (category_visible(a_category.x)) {
+        gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    } else {
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+    }
+    v_pos = (gl_Position.xy / gl_Position.w + 1.0) / 2.0 * u_world;
+}
+)MBGL_SHADER";
+
+constexpr const char* outlineFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp float u_opacity;
+
+varying vec2 v_pos;
+varying lowp vec4 v_color;
+
+void main() {
+    float dist = length(v_pos - gl_FragCoord.xy);
+    float alpha = smoothstep(1.0, 0.0, dist);
+    gl_FragColor = v_color * (alpha * u_opacity);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
+FillCategoryShader::FillCategoryShader(gl::Context& context, Defines defines)
+    : Shader("fill_category",
+             fillVertexSource,
+             fillFragmentSource,
+             context, defines) {
+}
+
+FillOutlineCategoryShader::FillOutlineCategoryShader(gl::Context& context, Defines defines)
+    : Shader("fill_outline_category",
+             outlineVertexSource,
+             outlineFragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+
+class FillVertex;
+
+// Draws fills like FillShader, with the category of each vertex read from a CategoryVertex
+// attribute. The masks hold a byte of category bits in each component; the vertices of hidden
+// categories are moved out of the clip volume, and those of highlighted ones take the
+// highlight color.
+class FillCategoryShader : public gl::Shader {
+public:
+    FillCategoryShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos      = {"a_pos",      *this};
+    gl::Attribute<uint8_t, 4> a_category = {"a_category", *this};
+
+    gl::UniformMatrix<4>              u_matrix                 = {"u_matrix",                 *this};
+    gl::Uniform<Color>                u_color                  = {"u_color",                  *this};
+    gl::Uniform<Color>                u_highlight_color        = {"u_highlight_color",        *this};
+    gl::Uniform<float>                u_opacity                = {"u_opacity",                *this};
+    gl::Uniform<std::array<float, 4>> u_visible_categories     = {"u_visible_categories",     *this};
+    gl::Uniform<std::array<float, 4>> u_highlighted_categories = {"u_highlighted_categories", *this};
+};
+
+// Draws the antialiased outlines of fills like FillOutlineShader, filtered by category.
+class FillOutlineCategoryShader : public gl::Shader {
+public:
+    FillOutlineCategoryShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos      = {"a_pos",      *this};
+    gl::Attribute<uint8_t, 4> a_category = {"a_category", *this};
+
+    gl::UniformMatrix<4>              u_matrix                 = {"u_matrix",                 *this};
+    gl::Uniform<Color>                u_outline_color          = {"u_outline_color",          *this};
+    gl::Uniform<Color>                u_highlight_color        = {"u_highlight_color",        *this};
+    gl::Uniform<float>                u_opacity                = {"u_opacity",                *this};
+    gl::Uniform<std::array<float, 2>> u_world                  = {"u_world",                  *this};
+    gl::Uniform<std::array<float, 4>> u_visible_categories     = {"u_visible_categories",     *this};
+    gl::Uniform<std::array<float, 4>> u_highlighted_categories = {"u_highlighted_categories", *this};
+};
+
+} // namespace mbgl
@@ -0,0 +1,147 @@
+#include <mbgl/shader/fill_data_driven_shader.hpp>
+#include <mbgl/shader/fill_vertex.hpp>
+#include <mbgl/shader/color_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// The fill and fill outline shaders, with the color passed on from an attribute. The colors are
+// premultiplied bytes.
+
+constexpr const char* fillVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+
+attribute vec2 a_pos;
+attribute vec4 a_color;
+
+varying lowp vec4 v_color;
+
+void main() {
+    v_color = a_color / 255.0;
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+}
+)MBGL_SHADER";
+
+constexpr const char* fillFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp float u_opacity;
+
+varying lowp vec4 v_color;
+
+void main() {
+    gl_FragColor = v_color * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+constexpr const char* outlineVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform vec2 u_world;
+
+attribute vec2 a_pos;
+attribute vec4 a_color;
+
+varying vec2 v_pos;
+varying lowp vec4 v_color;
+
+void main() {
+    v_color = a_color / 255.0;
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    v_pos = (gl_Position.xy / gl_Position.w + 1.0) / 2.0 * u_world;
+}
+)MBGL_SHADER";
+
+constexpr const char* outlineFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp float u_opacity;
+
+varying vec2 v_pos;
+varying lowp vec4 v_color;
+
+void main() {
+    float dist = length(v_pos - gl_FragCoord.xy);
+    float alpha = smoothstep(1.0, 0.0, dist);
+    gl_FragColor = v_color * (alpha * u_opacity);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
+FillDataDrivenShader::FillDataDrivenShader(gl::Context& context, Defines defines)
+    : Shader("fill_data_driven",
+             fillVertexSource,
+             fillFragmentSource,
+             context, defines) {
+}
+
+FillOutlineDataDrivenShader::FillOutlineDataDrivenShader(gl::Context& context, Defines defines)
+    : Shader("fill_outline_data_driven",
+             outlineVertexSource,
+             outlineFragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+
+class FillVertex;
+
+// Draws fills like FillShader, but with the data-driven color of each vertex read from a
+// ColorVertex attribute instead of a uniform.
+class FillDataDrivenShader : public gl::Shader {
+public:
+    FillDataDrivenShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos   = {"a_pos",   *this};
+    gl::Attribute<uint8_t, 4> a_color = {"a_color", *this};
+
+    gl::UniformMatrix<4> u_matrix   = {"u_matrix",  *this};
+    gl::Uniform<float>   u_opacity  = {"u_opacity", *this};
+};
+
+// Draws the antialiased outlines of fills like FillOutlineShader, with data-driven colors.
+class FillOutlineDataDrivenShader : public gl::Shader {
+public:
+    FillOutlineDataDrivenShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos   = {"a_pos",   *this};
+    gl::Attribute<uint8_t, 4> a_color = {"a_color", *this};
+
+    gl::UniformMatrix<4>              u_matrix   = {"u_matrix",  *this};
+    gl::Uniform<float>                u_opacity  = {"u_opacity", *this};
+    gl::Uniform<std::array<float, 2>> u_world    = {"u_world",   *this};
+};
+
+} // namespace mbgl
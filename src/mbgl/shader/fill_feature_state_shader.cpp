@@ -0,0 +1,157 @@
+#include <mbgl/shader/fill_feature_state_shader.hpp>
+#include <mbgl/shader/fill_vertex.hpp>
+#include <mbgl/shader/feature_state_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// The fill and fill outline shaders, with the color of each feature looked up in a texture. Not
+// all devices can read textures in vertex shaders, so the fragment shaders do. All vertices of a
+// feature have the same texel, which interpolation keeps the fragments on. The colors of the
+// texture are premultiplied, like those of the uniforms.
+
+constexpr const char* fillVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform float u_feature_states_height;
+
+attribute vec2 a_pos;
+attribute vec4 a_feature;
+
+varying vec2 v_feature;
+
+void main() {
+    v_feature = vec2((a_feature.x + 0.5) / 256.0, (a_feature.y + 0.5) / u_feature_states_height);
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+}
+)MBGL_SHADER";
+
+constexpr const char* fillFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp vec4 u_color;
+uniform lowp float u_opacity;
+uniform sampler2D u_feature_states;
+
+varying vec2 v_feature;
+
+void main() {
+    lowp vec4 state = texture2D(u_feature_states, v_feature);
+    gl_FragColor = mix(u_color, state, step(0.5 / 255.0, state.a)) * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+constexpr const char* outlineVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform vec2 u_world;
+uniform float u_feature_states_height;
+
+attribute vec2 a_pos;
+attribute vec4 a_feature;
+
+varying vec2 v_pos;
+varying vec2 v_feature;
+
+void main() {
+    v_feature = vec2((a_feature.x + 0.5) / 256.0, (a_feature.y + 0.5) / u_feature_states_height);
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    v_pos = (gl_Position.xy / gl_Position.w + 1.0) / 2.0 * u_world;
+}
+)MBGL_SHADER";
+
+constexpr const char* outlineFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform lowp vec4 u_outline_color;
+uniform lowp float u_opacity;
+uniform sampler2D u_feature_states;
+
+varying vec2 v_pos;
+varying vec2 v_feature;
+
+void main() {
+    lowp vec4 state = texture2D(u_feature_states, v_feature);
+    float dist = length(v_pos - gl_FragCoord.xy);
+    float alpha = smoothstep(1.0, 0.0, dist);
+    gl_FragColor = mix(u_outline_color, state, step(0.5 / 255.0, state.a)) * (alpha * u_opacity);
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
+FillFeatureStateShader::FillFeatureStateShader(gl::Context& context, Defines defines)
+    : Shader("fill_feature_state",
+             fillVertexSource,
+             fillFragmentSource,
+             context, defines) {
+}
+
+FillOutlineFeatureStateShader::FillOutlineFeatureStateShader(gl::Context& context, Defines defines)
+    : Shader("fill_outline_feature_state",
+             outlineVertexSource,
+             outlineFragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
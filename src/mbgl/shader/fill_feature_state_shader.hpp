@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+
+class FillVertex;
+
+// Draws fills like FillShader, with the color of each feature read from its texel in the
+// bucket's feature state texture. Features whose texel is transparent, i.e. that have no state,
+// take the fill color.
+class FillFeatureStateShader : public gl::Shader {
+public:
+    FillFeatureStateShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos     = {"a_pos",     *this};
+    gl::Attribute<uint8_t, 4> a_feature = {"a_feature", *this};
+
+    gl::UniformMatrix<4> u_matrix                = {"u_matrix",                *this};
+    gl::Uniform<Color>   u_color                 = {"u_color",                 *this};
+    gl::Uniform<float>   u_opacity               = {"u_opacity",               *this};
+    gl::Uniform<int32_t> u_feature_states        = {"u_feature_states",        *this};
+    gl::Uniform<float>   u_feature_states_height = {"u_feature_states_height", *this};
+};
+
+// Draws the antialiased outlines of fills like FillOutlineShader, with feature state colors.
+class FillOutlineFeatureStateShader : public gl::Shader {
+public:
+    FillOutlineFeatureStateShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos     = {"a_pos",     *this};
+    gl::Attribute<uint8_t, 4> a_feature = {"a_feature", *this};
+
+    gl::UniformMatrix<4>              u_matrix                = {"u_matrix",                *this};
+    gl::Uniform<Color>                u_outline_color         = {"u_outline_color",         *this};
+    gl::Uniform<float>                u_opacity               = {"u_opacity",               *this};
+    gl::Uniform<std::array<float, 2>> u_world                 = {"u_world",                 *this};
+    gl::Uniform<int32_t>              u_feature_states        = {"u_feature_states",        *this};
+    gl::Uniform<float>                u_feature_states_height = {"u_feature_states_height", *this};
+};
+
+} // namespace mbgl
@@ -0,0 +1,75 @@
+#include <mbgl/shader/fill_picking_shader.hpp>
+#include <mbgl/shader/fill_vertex.hpp>
+#include <mbgl/shader/picking_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// All vertices of a feature have the same picking ID, which interpolation keeps the fragments on.
+// The bytes are written as they are, and read back exactly, since the picking framebuffer has
+// eight bits per component and isn't blended.
+
+constexpr const char* vertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+
+attribute vec2 a_pos;
+attribute vec4 a_pick;
+
+varying vec2 v_pick;
+
+void main() {
+    v_pick = a_pick.xy;
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+}
+)MBGL_SHADER";
+
+constexpr const char* fragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform vec2 u_item;
+
+varying vec2 v_pick;
+
+void main() {
+    gl_FragColor = vec4(floor(v_pick + 0.5), u_item) / 255.0;
+}
+)MBGL_SHADER";
+
+} // namespace
+
+FillPickingShader::FillPickingShader(gl::Context& context, Defines defines)
+    : Shader("fill_picking",
+             vertexSource,
+             fragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+
+#include <array>
+
+namespace mbgl {
+
+class FillVertex;
+
+// Draws the interiors of fills into the picking framebuffer, in a color whose red and green
+// bytes are the picking ID of each vertex's feature, and whose blue and alpha bytes are the
+// number of the render item that's drawn.
+class FillPickingShader : public gl::Shader {
+public:
+    FillPickingShader(gl::Context&, Defines defines = None);
+
+    using VertexType = FillVertex;
+
+    gl::Attribute<int16_t, 2> a_pos  = {"a_pos",  *this};
+    gl::Attribute<uint8_t, 4> a_pick = {"a_pick", *this};
+
+    gl::UniformMatrix<4>              u_matrix = {"u_matrix", *this};
+    gl::Uniform<std::array<float, 2>> u_item   = {"u_item",   *this};
+};
+
+} // namespace mbgl
@@ -3,5 +3,8 @@
 namespace mbgl {
 
 static_assert(sizeof(FillVertex) == 4, "expected FillVertex size");
+static_assert(sizeof(FillVertex) == gl::attributeSize<FillVertex>(
+                  &FillVertex::a_pos),
+              "FillVertex has padding");
 
 } // namespace mbgl
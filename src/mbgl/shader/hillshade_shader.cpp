@@ -0,0 +1,210 @@
+#include <mbgl/shader/hillshade_shader.hpp>
+#include <mbgl/shader/raster_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
+
+namespace mbgl {
+
+namespace {
+
+// Texture positions go from 0 to 32767 across the tile, like those of the raster shader.
+
+constexpr const char* prepareVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+uniform vec2 u_dimension;
+
+attribute vec2 a_pos;
+attribute vec2 a_texture_pos;
+
+varying vec2 v_pos;
+varying float v_tile_y;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+
+    // The tile is inset in the DEM texture by its one texel border.
+    vec2 tile = a_texture_pos / 32767.0;
+    v_pos = tile * ((u_dimension - 2.0) / u_dimension) + 1.0 / u_dimension;
+    v_tile_y = tile.y;
+}
+)MBGL_SHADER";
+
+// Elevations need more than mediump precision.
+constexpr const char* prepareFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+#define PI 3.141592653589793
+
+uniform sampler2D u_image;
+uniform vec2 u_dimension;
+uniform float u_zoom;
+uniform vec2 u_latrange;
+uniform vec4 u_unpack;
+
+varying vec2 v_pos;
+varying float v_tile_y;
+
+float getElevation(vec2 coord) {
+    vec4 data = texture2D(u_image, coord) * 255.0;
+    data.a = -1.0;
+    return dot(data, u_unpack) / 4.0;
+}
+
+void main() {
+    vec2 epsilon = 1.0 / u_dimension;
+
+    // The elevations around the texel:
+    // a b c
+    // d e f
+    // g h i
+    float a = getElevation(v_pos + vec2(-epsilon.x, -epsilon.y));
+    float b = getElevation(v_pos + vec2(0, -epsilon.y));
+    float c = getElevation(v_pos + vec2(epsilon.x, -epsilon.y));
+    float d = getElevation(v_pos + vec2(-epsilon.x, 0));
+    float f = getElevation(v_pos + vec2(epsilon.x, 0));
+    float g = getElevation(v_pos + vec2(-epsilon.x, epsilon.y));
+    float h = getElevation(v_pos + vec2(0, epsilon.y));
+    float i = getElevation(v_pos + vec2(epsilon.x, epsilon.y));
+
+    // Low zoom levels are exaggerated, or their relief would be too flat to make out.
+    float exaggerationFactor = u_zoom < 2.0 ? 0.4 : u_zoom < 4.5 ? 0.35 : 0.3;
+    float exaggeration = u_zoom < 15.0 ? (u_zoom - 15.0) * exaggerationFactor : 0.0;
+
+    vec2 deriv = vec2(
+        (c + f + f + i) - (a + d + d + g),
+        (g + h + h + i) - (a + b + b + c)
+    ) / pow(2.0, exaggeration + (19.2562 - u_zoom));
+
+    // Texels span fewer meters away from the equator.
+    float scaleFactor = cos(radians((u_latrange[0] - u_latrange[1]) * (1.0 - v_tile_y) + u_latrange[1]));
+    float slope = atan(1.25 * length(deriv) / scaleFactor);
+    vec2 aspect = length(deriv) > 0.0 ? normalize(vec2(-deriv.x, deriv.y)) : vec2(0.0, 1.0);
+
+    gl_FragColor = vec4(slope / (0.5 * PI), aspect * 0.5 + 0.5, 1.0);
+}
+)MBGL_SHADER";
+
+constexpr const char* hillshadeVertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform mat4 u_matrix;
+
+attribute vec2 a_pos;
+attribute vec2 a_texture_pos;
+
+varying vec2 v_pos;
+
+void main() {
+    gl_Position = u_matrix * vec4(a_pos, 0, 1);
+    v_pos = a_texture_pos / 32767.0;
+}
+)MBGL_SHADER";
+
+constexpr const char* hillshadeFragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+#define PI 3.141592653589793
+
+uniform sampler2D u_image;
+uniform float u_intensity;
+uniform vec2 u_azimuth;
+uniform lowp vec4 u_shadow;
+uniform lowp vec4 u_highlight;
+uniform lowp vec4 u_accent;
+uniform lowp float u_opacity;
+
+varying vec2 v_pos;
+
+void main() {
+    vec4 pixel = texture2D(u_image, v_pos);
+    float slope = pixel.r * 0.5 * PI;
+    vec2 aspect = pixel.gb * 2.0 - 1.0;
+    float len = length(aspect);
+    aspect = len > 0.0 ? aspect / len : vec2(0.0, 1.0);
+
+    // Steeper slopes are shaded more strongly with a higher intensity.
+    float base = 1.875 - u_intensity * 1.75;
+    float maxValue = 0.5 * PI;
+    float scaledSlope = u_intensity != 0.5 ? ((pow(base, slope) - 1.0) / (pow(base, maxValue) - 1.0)) * maxValue : slope;
+
+    // From 0 for slopes that face away from the light to 1 for those that face it, given the
+    // cosine and sine of the light's azimuth turned by pi.
+    float shade = acos(clamp(aspect.y * u_azimuth.x + aspect.x * u_azimuth.y, -1.0, 1.0)) / PI;
+
+    float strength = clamp(u_intensity * 2.0, 0.0, 1.0);
+    vec4 accent_color = (1.0 - cos(scaledSlope)) * u_accent * strength;
+    vec4 shade_color = mix(u_shadow, u_highlight, shade) * sin(scaledSlope) * strength;
+    gl_FragColor = (accent_color * (1.0 - shade_color.a) + shade_color) * u_opacity;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
+HillshadePrepareShader::HillshadePrepareShader(gl::Context& context, Defines defines)
+    : Shader("hillshade_prepare",
+             prepareVertexSource,
+             prepareFragmentSource,
+             context, defines) {
+}
+
+HillshadeShader::HillshadeShader(gl::Context& context, Defines defines)
+    : Shader("hillshade",
+             hillshadeVertexSource,
+             hillshadeFragmentSource,
+             context, defines) {
+}
+
+} // namespace mbgl
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/gl/attribute.hpp>
+#include <mbgl/gl/uniform.hpp>
+#include <mbgl/util/color.hpp>
+
+namespace mbgl {
+
+class RasterVertex;
+
+// Renders the slope and aspect of a DEM tile into a texture of the tile's size, once for each
+// time the tile or its border changes: the slope in the red channel, as a fraction of a right
+// angle, and the direction of the aspect in the green and blue ones, which unlike the angle
+// interpolates smoothly.
+class HillshadePrepareShader : public gl::Shader {
+public:
+    HillshadePrepareShader(gl::Context&, Defines defines = None);
+
+    using VertexType = RasterVertex;
+
+    gl::Attribute<int16_t, 2>  a_pos         = {"a_pos",         *this};
+    gl::Attribute<uint16_t, 2> a_texture_pos = {"a_texture_pos", *this};
+
+    gl::UniformMatrix<4>              u_matrix    = {"u_matrix",    *this};
+    gl::Uniform<int32_t>              u_image     = {"u_image",     *this};
+    gl::Uniform<std::array<float, 2>> u_dimension = {"u_dimension", *this};
+    gl::Uniform<float>                u_zoom      = {"u_zoom",      *this};
+    gl::Uniform<std::array<float, 2>> u_latrange  = {"u_latrange",  *this};
+    gl::Uniform<std::array<float, 4>> u_unpack    = {"u_unpack",    *this};
+};
+
+// Shades a tile from its prepared slope and aspect, which only takes a texture lookup and the
+// light's direction per fragment.
+class HillshadeShader : public gl::Shader {
+public:
+    HillshadeShader(gl::Context&, Defines defines = None);
+
+    using VertexType = RasterVertex;
+
+    gl::Attribute<int16_t, 2>  a_pos         = {"a_pos",         *this};
+    gl::Attribute<uint16_t, 2> a_texture_pos = {"a_texture_pos", *this};
+
+    gl::UniformMatrix<4>              u_matrix    = {"u_matrix",    *this};
+    gl::Uniform<int32_t>              u_image     = {"u_image",     *this};
+    gl::Uniform<float>                u_intensity = {"u_intensity", *this};
+    gl::Uniform<std::array<float, 2>> u_azimuth   = {"u_azimuth",   *this};
+    gl::Uniform<Color>                u_shadow    = {"u_shadow",    *this};
+    gl::Uniform<Color>                u_highlight = {"u_highlight", *this};
+    gl::Uniform<Color>                u_accent    = {"u_accent",    *this};
+    gl::Uniform<float>                u_opacity   = {"u_opacity",   *this};
+};
+
+} // namespace mbgl
@@ -3,5 +3,8 @@
 namespace mbgl {
 
 static_assert(sizeof(LineVertex) == 8, "expected LineVertex size");
+static_assert(sizeof(LineVertex) == gl::attributeSize<LineVertex>(
+                  &LineVertex::a_pos, &LineVertex::a_data),
+              "LineVertex has padding");
 
 } // namespace mbgl
@@ -0,0 +1,10 @@
+#include <mbgl/shader/picking_vertex.hpp>
+
+namespace mbgl {
+
+static_assert(sizeof(PickingVertex) == 4, "expected PickingVertex size");
+static_assert(sizeof(PickingVertex) == gl::attributeSize<PickingVertex>(
+                  &PickingVertex::a_pick),
+              "PickingVertex has padding");
+
+} // namespace mbgl
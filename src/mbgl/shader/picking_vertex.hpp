@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/gl/attribute.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace mbgl {
+
+// The picking ID of a vertex's feature within its bucket, 1 for the first feature and 0 for the
+// features that don't fit, which can't be picked.
+constexpr std::size_t MaxPickingFeatures = 65535;
+
+// Buckets keep these in a vertex buffer of their own, next to the one with the positions of the
+// vertices; the other bytes keep the attribute aligned.
+class PickingVertex {
+public:
+    explicit PickingVertex(uint16_t id)
+        : a_pick {
+            static_cast<uint8_t>(id & 0xFF),
+            static_cast<uint8_t>(id >> 8),
+            0,
+            0
+        } {}
+
+    const uint8_t a_pick[4];
+};
+
+namespace gl {
+
+template <class Shader>
+struct AttributeBindings<Shader, PickingVertex> {
+    std::array<AttributeBinding, 1> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(PickingVertex, shader, a_pick)
+        }};
+    };
+};
+
+} // namespace gl
+} // namespace mbgl
@@ -3,5 +3,8 @@
 namespace mbgl {
 
 static_assert(sizeof(RasterVertex) == 8, "expected RasterVertex size");
+static_assert(sizeof(RasterVertex) == gl::attributeSize<RasterVertex>(
+                  &RasterVertex::a_pos, &RasterVertex::a_texture_pos),
+              "RasterVertex has padding");
 
 } // namespace mbgl
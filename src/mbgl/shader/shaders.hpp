@@ -1,58 +1,110 @@
 #pragma once
 
 #include <mbgl/shader/circle_shader.hpp>
+#include <mbgl/shader/circle_instanced_shader.hpp>
+#include <mbgl/shader/circle_data_driven_shader.hpp>
+#include <mbgl/shader/dynamic_point_shader.hpp>
 #include <mbgl/shader/fill_shader.hpp>
 #include <mbgl/shader/fill_pattern_shader.hpp>
 #include <mbgl/shader/fill_outline_shader.hpp>
 #include <mbgl/shader/fill_outline_pattern_shader.hpp>
+#include <mbgl/shader/fill_data_driven_shader.hpp>
+#include <mbgl/shader/fill_category_shader.hpp>
+#include <mbgl/shader/fill_feature_state_shader.hpp>
+#include <mbgl/shader/fill_picking_shader.hpp>
 #include <mbgl/shader/line_shader.hpp>
 #include <mbgl/shader/line_sdf_shader.hpp>
 #include <mbgl/shader/line_pattern_shader.hpp>
 #include <mbgl/shader/raster_shader.hpp>
+#include <mbgl/shader/hillshade_shader.hpp>
 #include <mbgl/shader/symbol_icon_shader.hpp>
 #include <mbgl/shader/symbol_sdf_shader.hpp>
 
 #include <mbgl/shader/collision_box_shader.hpp>
 
+#include <memory>
+
 namespace mbgl {
 
+// The shaders of a painter. Each is compiled the first time it's used, so that only the programs
+// for the layer types that a style actually has are built.
 class Shaders {
 public:
-    Shaders(gl::Context& context, gl::Shader::Defines defines = gl::Shader::None)
-        : circle(context, defines),
-          fill(context, defines),
-          fillPattern(context, defines),
-          fillOutline(context, defines),
-          fillOutlinePattern(context, defines),
-          line(context, defines),
-          lineSDF(context, defines),
-          linePattern(context, defines),
-          raster(context, defines),
-          symbolIcon(context, defines),
-          symbolIconSDF(context, defines),
-          symbolGlyph(context, defines),
-          collisionBox(context) {
+    Shaders(gl::Context& context_, gl::Shader::Defines defines_ = gl::Shader::None)
+        : context(context_), defines(defines_) {
+    }
+
+    CircleShader& circle() { return get(circleShader); }
+    CircleInstancedShader& circleInstanced() { return get(circleInstancedShader); }
+    CircleDataDrivenShader& circleDataDriven() { return get(circleDataDrivenShader); }
+    CircleInstancedDataDrivenShader& circleInstancedDataDriven() { return get(circleInstancedDataDrivenShader); }
+    DynamicPointShader& dynamicPoint() { return get(dynamicPointShader); }
+    FillShader& fill() { return get(fillShader); }
+    FillPatternShader& fillPattern() { return get(fillPatternShader); }
+    FillOutlineShader& fillOutline() { return get(fillOutlineShader); }
+    FillOutlinePatternShader& fillOutlinePattern() { return get(fillOutlinePatternShader); }
+    FillDataDrivenShader& fillDataDriven() { return get(fillDataDrivenShader); }
+    FillOutlineDataDrivenShader& fillOutlineDataDriven() { return get(fillOutlineDataDrivenShader); }
+    FillCategoryShader& fillCategory() { return get(fillCategoryShader); }
+    FillOutlineCategoryShader& fillOutlineCategory() { return get(fillOutlineCategoryShader); }
+    FillFeatureStateShader& fillFeatureState() { return get(fillFeatureStateShader); }
+    FillOutlineFeatureStateShader& fillOutlineFeatureState() { return get(fillOutlineFeatureStateShader); }
+    FillPickingShader& fillPicking() { return get(fillPickingShader); }
+    LineShader& line() { return get(lineShader); }
+    LineSDFShader& lineSDF() { return get(lineSDFShader); }
+    LinePatternShader& linePattern() { return get(linePatternShader); }
+    RasterShader& raster() { return get(rasterShader); }
+    HillshadePrepareShader& hillshadePrepare() { return get(hillshadePrepareShader); }
+    HillshadeShader& hillshade() { return get(hillshadeShader); }
+    SymbolIconShader& symbolIcon() { return get(symbolIconShader); }
+    SymbolSDFShader& symbolIconSDF() { return get(symbolIconSDFShader); }
+    SymbolSDFShader& symbolGlyph() { return get(symbolGlyphShader); }
+
+    CollisionBoxShader& collisionBox() {
+        if (!collisionBoxShader) {
+            collisionBoxShader = std::make_unique<CollisionBoxShader>(context);
+        }
+        return *collisionBoxShader;
     }
 
-    CircleShader circle;
-    FillShader fill;
-    FillPatternShader fillPattern;
-    FillOutlineShader fillOutline;
-    FillOutlinePatternShader fillOutlinePattern;
-    LineShader line;
-    LineSDFShader lineSDF;
-    LinePatternShader linePattern;
-    RasterShader raster;
-    SymbolIconShader symbolIcon;
-    SymbolSDFShader symbolIconSDF;
-    SymbolSDFShader symbolGlyph;
-
-    CollisionBoxShader collisionBox;
-
-    gl::VertexArrayObject coveringPlainArray;
-    gl::VertexArrayObject coveringRasterArray;
-    gl::VertexArrayObject backgroundPatternArray;
-    gl::VertexArrayObject backgroundArray;
+private:
+    template <class Shader>
+    Shader& get(std::unique_ptr<Shader>& shader) {
+        if (!shader) {
+            shader = std::make_unique<Shader>(context, defines);
+        }
+        return *shader;
+    }
+
+    gl::Context& context;
+    const gl::Shader::Defines defines;
+
+    std::unique_ptr<CircleShader> circleShader;
+    std::unique_ptr<CircleInstancedShader> circleInstancedShader;
+    std::unique_ptr<CircleDataDrivenShader> circleDataDrivenShader;
+    std::unique_ptr<CircleInstancedDataDrivenShader> circleInstancedDataDrivenShader;
+    std::unique_ptr<DynamicPointShader> dynamicPointShader;
+    std::unique_ptr<FillShader> fillShader;
+    std::unique_ptr<FillPatternShader> fillPatternShader;
+    std::unique_ptr<FillOutlineShader> fillOutlineShader;
+    std::unique_ptr<FillOutlinePatternShader> fillOutlinePatternShader;
+    std::unique_ptr<FillDataDrivenShader> fillDataDrivenShader;
+    std::unique_ptr<FillOutlineDataDrivenShader> fillOutlineDataDrivenShader;
+    std::unique_ptr<FillCategoryShader> fillCategoryShader;
+    std::unique_ptr<FillOutlineCategoryShader> fillOutlineCategoryShader;
+    std::unique_ptr<FillFeatureStateShader> fillFeatureStateShader;
+    std::unique_ptr<FillOutlineFeatureStateShader> fillOutlineFeatureStateShader;
+    std::unique_ptr<FillPickingShader> fillPickingShader;
+    std::unique_ptr<LineShader> lineShader;
+    std::unique_ptr<LineSDFShader> lineSDFShader;
+    std::unique_ptr<LinePatternShader> linePatternShader;
+    std::unique_ptr<RasterShader> rasterShader;
+    std::unique_ptr<HillshadePrepareShader> hillshadePrepareShader;
+    std::unique_ptr<HillshadeShader> hillshadeShader;
+    std::unique_ptr<SymbolIconShader> symbolIconShader;
+    std::unique_ptr<SymbolSDFShader> symbolIconSDFShader;
+    std::unique_ptr<SymbolSDFShader> symbolGlyphShader;
+    std::unique_ptr<CollisionBoxShader> collisionBoxShader;
 };
 
 } // namespace mbgl
@@ -1,14 +1,115 @@
 #include <mbgl/shader/symbol_icon_shader.hpp>
-#include <mbgl/shader/symbol_icon.vertex.hpp>
-#include <mbgl/shader/symbol_icon.fragment.hpp>
 #include <mbgl/shader/symbol_vertex.hpp>
+#include <mbgl/gl/gl.hpp>
 
 namespace mbgl {
 
+namespace {
+
+// The symbol icon shader, with the opacity of each symbol faded in or out since its placement;
+// see SymbolPlacementVertex.
+
+constexpr const char* vertexSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+attribute vec2 a_pos;
+attribute vec2 a_offset;
+attribute vec2 a_texture_pos;
+attribute vec4 a_data;
+attribute vec4 a_fade_opacity;
+
+// matrix is for the vertex position.
+uniform mat4 u_matrix;
+
+uniform mediump float u_zoom;
+uniform bool u_rotate_with_map;
+uniform vec2 u_extrude_scale;
+uniform lowp float u_fade_change;
+
+uniform vec2 u_texsize;
+
+varying vec2 v_tex;
+varying vec2 v_fade_tex;
+varying lowp float v_fade_opacity;
+
+void main() {
+    vec2 a_tex = a_texture_pos.xy;
+    mediump float a_labelminzoom = a_data[0];
+    mediump vec2 a_zoom = a_data.pq;
+    mediump float a_minzoom = a_zoom[0];
+    mediump float a_maxzoom = a_zoom[1];
+
+    // u_zoom is the current zoom level adjusted for the change in font size
+    mediump float z = 2.0 - step(a_minzoom, u_zoom) - (1.0 - step(a_maxzoom, u_zoom));
+
+    vec2 extrude = u_extrude_scale * (a_offset / 64.0);
+    if (u_rotate_with_map) {
+        gl_Position = u_matrix * vec4(a_pos + extrude, 0, 1);
+    } else {
+        gl_Position = u_matrix * vec4(a_pos, 0, 1) + vec4(extrude, 0, 0);
+    }
+    gl_Position.z += z * gl_Position.w;
+
+    v_tex = a_tex / u_texsize;
+    v_fade_tex = vec2(a_labelminzoom / 255.0, 0.0);
+
+    // a_fade_opacity holds the opacity as of the placement, and whether it's fading in.
+    lowp float fade_change = a_fade_opacity[1] > 0.5 ? u_fade_change : -u_fade_change;
+    v_fade_opacity = clamp(a_fade_opacity[0] / 255.0 + fade_change, 0.0, 1.0);
+}
+)MBGL_SHADER";
+
+constexpr const char* fragmentSource =
+#ifdef GL_ES_VERSION_2_0
+    "precision highp float;"
+#else
+    "#version 120"
+#endif
+    R"MBGL_SHADER(
+#ifdef GL_ES
+precision mediump float;
+#else
+#define lowp
+#define mediump
+#define highp
+#endif
+
+uniform sampler2D u_texture;
+uniform sampler2D u_fadetexture;
+uniform lowp float u_opacity;
+
+varying vec2 v_tex;
+varying vec2 v_fade_tex;
+varying lowp float v_fade_opacity;
+
+void main() {
+    lowp float alpha = texture2D(u_fadetexture, v_fade_tex).a * v_fade_opacity * u_opacity;
+    gl_FragColor = texture2D(u_texture, v_tex) * alpha;
+
+#ifdef OVERDRAW_INSPECTOR
+    gl_FragColor = vec4(1.0);
+#endif
+}
+)MBGL_SHADER";
+
+} // namespace
+
 SymbolIconShader::SymbolIconShader(gl::Context& context, Defines defines)
-    : Shader(shaders::symbol_icon::name,
-             shaders::symbol_icon::vertex,
-             shaders::symbol_icon::fragment,
+    : Shader("symbol_icon",
+             vertexSource,
+             fragmentSource,
              context, defines) {
 }
 
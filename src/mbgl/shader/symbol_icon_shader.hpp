@@ -14,10 +14,11 @@ public:
 
     using VertexType = SymbolVertex;
 
-    gl::Attribute<int16_t, 2>  a_pos         = { "a_pos",         *this };
-    gl::Attribute<int16_t, 2>  a_offset      = { "a_offset",      *this };
-    gl::Attribute<uint16_t, 2> a_texture_pos = { "a_texture_pos", *this };
-    gl::Attribute<uint8_t, 4>  a_data        = { "a_data",        *this };
+    gl::Attribute<int16_t, 2>  a_pos          = { "a_pos",          *this };
+    gl::Attribute<int16_t, 2>  a_offset       = { "a_offset",       *this };
+    gl::Attribute<uint16_t, 2> a_texture_pos  = { "a_texture_pos",  *this };
+    gl::Attribute<uint8_t, 4>  a_data         = { "a_data",         *this };
+    gl::Attribute<uint8_t, 4>  a_fade_opacity = { "a_fade_opacity", *this };
 
     gl::UniformMatrix<4>              u_matrix          = {"u_matrix",          *this};
     gl::Uniform<std::array<float, 2>> u_extrude_scale   = {"u_extrude_scale",   *this};
@@ -27,6 +28,7 @@ public:
     gl::Uniform<int32_t>              u_rotate_with_map = {"u_rotate_with_map", *this};
     gl::Uniform<int32_t>              u_texture         = {"u_texture",         *this};
     gl::Uniform<int32_t>              u_fadetexture     = {"u_fadetexture",     *this};
+    gl::Uniform<float>                u_fade_change     = {"u_fade_change",     *this};
 };
 
 } // namespace mbgl
@@ -4,6 +4,14 @@
 
 namespace mbgl {
 
-static_assert(sizeof(SymbolVertex) == 16, "expected SymbolVertex size");
+static_assert(sizeof(SymbolVertex) == 12, "expected SymbolVertex size");
+static_assert(sizeof(SymbolVertex) == gl::attributeSize<SymbolVertex>(
+                  &SymbolVertex::a_pos, &SymbolVertex::a_offset, &SymbolVertex::a_texture_pos),
+              "SymbolVertex has padding");
+
+static_assert(sizeof(SymbolPlacementVertex) == 8, "expected SymbolPlacementVertex size");
+static_assert(sizeof(SymbolPlacementVertex) == gl::attributeSize<SymbolPlacementVertex>(
+                  &SymbolPlacementVertex::a_data, &SymbolPlacementVertex::a_fade_opacity),
+              "SymbolPlacementVertex has padding");
 
 } // namespace mbgl
@@ -8,9 +8,10 @@
 
 namespace mbgl {
 
+// The corner of a glyph or icon quad, which is the same for each placement of its label.
 class SymbolVertex {
 public:
-    SymbolVertex(int16_t x, int16_t y, float ox, float oy, uint16_t tx, uint16_t ty, float minzoom, float maxzoom, float labelminzoom, uint8_t labelangle)
+    SymbolVertex(int16_t x, int16_t y, float ox, float oy, uint16_t tx, uint16_t ty)
         : a_pos {
               x,
               y
@@ -22,30 +23,63 @@ public:
           a_texture_pos {
               static_cast<uint16_t>(tx / 4),
               static_cast<uint16_t>(ty / 4)
-          },
-          a_data {
+          } {}
+
+    const int16_t a_pos[2];
+    const int16_t a_offset[2];
+    const uint16_t a_texture_pos[2];
+};
+
+// The zoom range in which a placement shows the quad of a SymbolVertex, and the opacity of its
+// symbol as of the placement, which the shaders fade towards 1 if the placement shows it, or
+// towards 0 otherwise. Buckets keep these in a vertex buffer of their own, so that placing the
+// labels again only uploads this buffer.
+class SymbolPlacementVertex {
+public:
+    SymbolPlacementVertex(float minzoom, float maxzoom, float labelminzoom, uint8_t labelangle,
+                          float opacity, bool placed)
+        : a_data {
               static_cast<uint8_t>(labelminzoom * 10), // 1/10 zoom levels: z16 == 160
               static_cast<uint8_t>(labelangle),
               static_cast<uint8_t>(minzoom * 10),
               static_cast<uint8_t>(::fmin(maxzoom, 25) * 10)
+          },
+          a_fade_opacity {
+              static_cast<uint8_t>(::round(opacity * 255)),
+              static_cast<uint8_t>(placed),
+              0,
+              0
           } {}
 
-    const int16_t a_pos[2];
-    const int16_t a_offset[2];
-    const uint16_t a_texture_pos[2];
+    // A quad that isn't shown at any zoom level, e.g. one whose label wasn't placed and has faded
+    // out.
+    static SymbolPlacementVertex hidden(uint8_t labelangle) {
+        return { 25.5f, 0, 25.5f, labelangle, 0, false };
+    }
+
     const uint8_t a_data[4];
+    const uint8_t a_fade_opacity[4];
 };
 
 namespace gl {
 
 template <class Shader>
 struct AttributeBindings<Shader, SymbolVertex> {
-    std::array<AttributeBinding, 4> operator()(const Shader& shader) {
+    std::array<AttributeBinding, 3> operator()(const Shader& shader) {
         return {{
             MBGL_MAKE_ATTRIBUTE_BINDING(SymbolVertex, shader, a_pos),
             MBGL_MAKE_ATTRIBUTE_BINDING(SymbolVertex, shader, a_offset),
-            MBGL_MAKE_ATTRIBUTE_BINDING(SymbolVertex, shader, a_texture_pos),
-            MBGL_MAKE_ATTRIBUTE_BINDING(SymbolVertex, shader, a_data)
+            MBGL_MAKE_ATTRIBUTE_BINDING(SymbolVertex, shader, a_texture_pos)
+        }};
+    };
+};
+
+template <class Shader>
+struct AttributeBindings<Shader, SymbolPlacementVertex> {
+    std::array<AttributeBinding, 2> operator()(const Shader& shader) {
+        return {{
+            MBGL_MAKE_ATTRIBUTE_BINDING(SymbolPlacementVertex, shader, a_data),
+            MBGL_MAKE_ATTRIBUTE_BINDING(SymbolPlacementVertex, shader, a_fade_opacity)
         }};
     };
 };
@@ -1,6 +1,8 @@
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/sprite/sprite_atlas_observer.hpp>
+#include <mbgl/sprite/sprite_atlas_worker.hpp>
 #include <mbgl/sprite/sprite_parser.hpp>
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/platform/log.hpp>
@@ -12,6 +14,8 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/startup_trace.hpp>
 
 #include <cassert>
 #include <cmath>
@@ -26,6 +30,12 @@ struct SpriteAtlas::Loader {
     std::shared_ptr<const std::string> json;
     std::unique_ptr<AsyncRequest> jsonRequest;
     std::unique_ptr<AsyncRequest> spriteRequest;
+    const TimePoint begin = Clock::now();
+
+    // Where the sheet is parsed on a worker. The results of an earlier load, which this loader
+    // replaced, are dropped along with its mailbox.
+    std::shared_ptr<Mailbox> mailbox;
+    std::unique_ptr<Actor<SpriteAtlasWorker>> worker;
 };
 
 SpriteAtlas::SpriteAtlas(dimension width_, dimension height_, float pixelRatio_)
@@ -41,7 +51,7 @@ SpriteAtlas::SpriteAtlas(dimension width_, dimension height_, float pixelRatio_)
 
 SpriteAtlas::~SpriteAtlas() = default;
 
-void SpriteAtlas::load(const std::string& url, FileSource& fileSource) {
+void SpriteAtlas::load(const std::string& url, FileSource& fileSource, Scheduler* scheduler) {
     if (url.empty()) {
         // Treat a non-existent sprite as a successfully loaded empty sprite.
         loaded = true;
@@ -49,6 +59,11 @@ void SpriteAtlas::load(const std::string& url, FileSource& fileSource) {
     }
 
     loader = std::make_unique<Loader>();
+    if (scheduler) {
+        loader->mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+        loader->worker = std::make_unique<Actor<SpriteAtlasWorker>>(
+            *scheduler, ActorRef<SpriteAtlas>(*this, loader->mailbox));
+    }
 
     loader->jsonRequest = fileSource.request(Resource::spriteJSON(url, pixelRatio), [this](Response res) {
         if (res.error) {
@@ -87,16 +102,32 @@ void SpriteAtlas::emitSpriteLoadedIfComplete() {
         return;
     }
 
+    if (loader->worker) {
+        loader->worker->invokeCoalesced(&SpriteAtlasWorker::parse, loader->image, loader->json);
+        return;
+    }
+
     auto result = parseSprite(*loader->image, *loader->json);
     if (result.is<Sprites>()) {
-        loaded = true;
-        setSprites(result.get<Sprites>());
-        observer->onSpriteLoaded();
+        onParsed(std::move(result.get<Sprites>()));
     } else {
-        observer->onSpriteError(result.get<std::exception_ptr>());
+        onError(result.get<std::exception_ptr>());
     }
 }
 
+void SpriteAtlas::onParsed(Sprites result) {
+    loaded = true;
+    setSprites(result);
+    if (loader) {
+        StartupTrace::record("sprite", loader->begin, Clock::now(), { "style parse" });
+    }
+    observer->onSpriteLoaded();
+}
+
+void SpriteAtlas::onError(std::exception_ptr error) {
+    observer->onSpriteError(error);
+}
+
 void SpriteAtlas::setObserver(SpriteAtlasObserver* observer_) {
     observer = observer_;
 }
@@ -145,7 +176,8 @@ void SpriteAtlas::_setSprite(const std::string& name,
             dirtySprites.emplace(name, sprite);
         }
     } else if (sprites.erase(name) > 0) {
-        dirtySprites.emplace(name, nullptr);
+        // Also replaces a pending addition, so that the image's room is released.
+        dirtySprites[name] = nullptr;
     }
 }
 
@@ -279,9 +311,54 @@ void SpriteAtlas::copy(const Holder& holder, const SpritePatternMode mode) {
             dstData, pixelWidth, (holder.pos.x + padding) * pixelRatio, (holder.pos.y + padding) * pixelRatio, pixelWidth * pixelHeight,
             uint32_t(holder.spriteImage->image.width), uint32_t(holder.spriteImage->image.height), mode);
 
+    dirtyRegions.add(textureRect(holder.pos));
+
+    dirtyFlag = true;
+}
+
+Rect<SpriteAtlas::dimension> SpriteAtlas::textureRect(const Rect<dimension>& pos) const {
+    const dimension left = std::floor(pos.x * pixelRatio);
+    const dimension top = std::floor(pos.y * pixelRatio);
+    const dimension right = std::min<dimension>(std::ceil((pos.x + pos.w) * pixelRatio), pixelWidth);
+    const dimension bottom = std::min<dimension>(std::ceil((pos.y + pos.h) * pixelRatio), pixelHeight);
+    return { left, top, dimension(right - left), dimension(bottom - top) };
+}
+
+void SpriteAtlas::release(const Holder& holder) {
+    bin.release(holder.pos);
+
+    if (!data) {
+        return;
+    }
+
+    const Rect<dimension> rect = textureRect(holder.pos);
+    for (dimension y = rect.y; y < rect.y + rect.h; ++y) {
+        uint32_t* row = data.get() + y * pixelWidth + rect.x;
+        std::fill(row, row + rect.w, 0);
+    }
+    dirtyRegions.add(rect);
+
     dirtyFlag = true;
 }
 
+MemoryUsage SpriteAtlas::getMemoryUsage() {
+    const std::size_t atlasBytes = std::size_t(pixelWidth) * pixelHeight * sizeof(uint32_t);
+
+    MemoryUsage usage;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& sprite : sprites) {
+            usage.cpu += sprite.second->image.size();
+        }
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(mtx);
+        usage.cpu += data ? atlasBytes : 0;
+        usage.gpu = texture && !fullUploadRequired ? atlasBytes : 0;
+    }
+    return usage;
+}
+
 void SpriteAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (dirtyFlag) {
         bind(false, context, unit);
@@ -306,6 +383,7 @@ void SpriteAtlas::updateDirty() {
                 copy(holder, imageIterator->first.second);
                 ++imageIterator;
             } else {
+                release(holder);
                 images.erase(imageIterator++);
             }
             // Don't advance the spriteIterator because there might be another sprite with the same
@@ -364,19 +442,10 @@ void SpriteAtlas::bind(bool linear, gl::Context& context, gl::TextureUnit unit)
             ));
             fullUploadRequired = false;
         } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                pixelWidth, // GLsizei width
-                pixelHeight, // GLsizei height
-                GL_RGBA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid *pixels
-            ));
+            dirtyRegions.upload(data.get(), pixelWidth, sizeof(uint32_t), GL_RGBA);
         }
 
+        dirtyRegions.clear();
         dirtyFlag = false;
 
 #if not MBGL_USE_GLES2
@@ -1,12 +1,15 @@
 #pragma once
 
-#include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/shelf_pack.hpp>
 #include <mbgl/gl/object.hpp>
+#include <mbgl/gl/dirty_regions.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
+#include <mbgl/util/memory_usage.hpp>
 #include <mbgl/sprite/sprite_image.hpp>
 
 #include <atomic>
+#include <exception>
 #include <string>
 #include <map>
 #include <mutex>
@@ -17,6 +20,7 @@
 namespace mbgl {
 
 class FileSource;
+class Scheduler;
 class SpriteAtlasObserver;
 
 namespace gl {
@@ -51,7 +55,9 @@ public:
     SpriteAtlas(dimension width, dimension height, float pixelRatio);
     ~SpriteAtlas();
 
-    void load(const std::string& url, FileSource&);
+    // Requests the sprite sheet. It's decoded and sliced on the threads of the scheduler, if one
+    // is given, and on this one otherwise.
+    void load(const std::string& url, FileSource&, Scheduler* = nullptr);
 
     bool isLoaded() const {
         return loaded;
@@ -70,6 +76,10 @@ public:
     // Removes a Sprite.
     void removeSprite(const std::string&);
 
+    // The results of parsing the sprite sheet.
+    void onParsed(Sprites);
+    void onError(std::exception_ptr);
+
     // Obtains a Sprite image.
     std::shared_ptr<const SpriteImage> getSprite(const std::string&);
 
@@ -88,7 +98,8 @@ public:
     void updateDirty();
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty), and only the images that
+    // were copied into the atlas since the last upload are written.
     void upload(gl::Context&, gl::TextureUnit unit);
 
     dimension getWidth() const { return width; }
@@ -97,6 +108,9 @@ public:
     dimension getTextureHeight() const { return pixelHeight; }
     float getPixelRatio() const { return pixelRatio; }
 
+    // The memory held by the sprite images and the atlas, and by its texture.
+    MemoryUsage getMemoryUsage();
+
     // Only for use in tests.
     const uint32_t* getData() const { return data.get(); }
 
@@ -136,13 +150,21 @@ private:
     Rect<SpriteAtlas::dimension> allocateImage(const SpriteImage&);
     void copy(const Holder& holder, SpritePatternMode mode);
 
+    // Returns the room of a removed image to the allocator, and clears its pixels so that they
+    // don't bleed into the padding of the next image put there.
+    void release(const Holder& holder);
+
+    // The room of an image in the atlas, including its padding, in pixels of the texture.
+    Rect<dimension> textureRect(const Rect<dimension>& pos) const;
+
     std::recursive_mutex mtx;
-    BinPack<dimension> bin;
+    ShelfPack<dimension> bin;
     std::map<Key, Holder> images;
     std::unordered_set<std::string> uninitialized;
     std::unique_ptr<uint32_t[]> data;
     std::atomic<bool> dirtyFlag;
     bool fullUploadRequired = true;
+    gl::DirtyRegions dirtyRegions;
     mbgl::optional<gl::UniqueTexture> texture;
     uint32_t filter = 0;
     static const int buffer = 1;
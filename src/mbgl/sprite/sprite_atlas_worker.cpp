@@ -0,0 +1,21 @@
+#include <mbgl/sprite/sprite_atlas_worker.hpp>
+#include <mbgl/sprite/sprite_atlas.hpp>
+#include <mbgl/sprite/sprite_parser.hpp>
+
+namespace mbgl {
+
+SpriteAtlasWorker::SpriteAtlasWorker(ActorRef<SpriteAtlasWorker>, ActorRef<SpriteAtlas> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void SpriteAtlasWorker::parse(std::shared_ptr<const std::string> image,
+                              std::shared_ptr<const std::string> json) {
+    auto result = parseSprite(*image, *json);
+    if (result.is<Sprites>()) {
+        parent.invoke(&SpriteAtlas::onParsed, std::move(result.get<Sprites>()));
+    } else {
+        parent.invoke(&SpriteAtlas::onError, result.get<std::exception_ptr>());
+    }
+}
+
+} // namespace mbgl
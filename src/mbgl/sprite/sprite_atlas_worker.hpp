@@ -0,0 +1,24 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class SpriteAtlas;
+
+// Decodes a sprite sheet and slices it into images off the thread that owns the atlas, which
+// large sheets would otherwise stall.
+class SpriteAtlasWorker {
+public:
+    SpriteAtlasWorker(ActorRef<SpriteAtlasWorker>, ActorRef<SpriteAtlas>);
+
+    void parse(std::shared_ptr<const std::string> image, std::shared_ptr<const std::string> json);
+
+private:
+    ActorRef<SpriteAtlas> parent;
+};
+
+} // namespace mbgl
@@ -13,6 +13,11 @@ public:
 
     static uint32_t maximumConcurrentRequests();
 
+    // Limits the connections opened to each host, or restores the platform's default with 0. Requests
+    // beyond it wait for a connection, unless they're multiplexed on an HTTP/2 connection. With
+    // curl, the default is no limit.
+    void setMaximumConnectionsPerHost(uint32_t);
+
     class Impl;
 
 private:
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+/*
+    Serves tiles out of single-file archives on disk, so that they can be used without a tile
+    server:
+
+        mbtiles:///path/to/file.mbtiles             TileJSON made from the metadata of the file
+        mbtiles:///path/to/file.mbtiles/{z}/{x}/{y} A tile of an MBTiles file
+        pack:///path/to/file.pack/{z}/{x}/{y}       A tile of an offline pack
+
+    The tile coordinates may be followed by an extension, e.g. {y}.pbf. Archives are read by a
+    few threads, which are started by the first request, each of which keeps the archives it has
+    opened open. Requests are handed out to them in turn.
+*/
+class TileArchiveFileSource : public FileSource {
+public:
+    TileArchiveFileSource();
+    ~TileArchiveFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+    std::once_flag started;
+    std::vector<std::unique_ptr<util::Thread<Impl>>> threads;
+    std::atomic<std::size_t> nextThread { 0 };
+};
+
+} // namespace mbgl
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/conversion/constant.hpp>
+#include <mbgl/style/conversion/property_value.hpp>
+
+#include <functional>
+#include <string>
+
+namespace mbgl {
+namespace style {
+namespace binary {
+
+// Converts the JSON value of a property and writes it with the given tag.
+using PropertyWriter = std::function<optional<conversion::Error> (protozero::pbf_writer&, protozero::pbf_tag_type, const JSValue&)>;
+
+struct LayoutPropertyCodec {
+    PropertyWriter write;
+    std::function<void (Layer&, protozero::pbf_reader)> read;
+};
+
+struct PaintPropertyCodec {
+    PropertyWriter write;
+    std::function<void (Layer&, protozero::pbf_reader, const optional<std::string>&)> read;
+};
+
+namespace detail {
+
+template <class T>
+PropertyWriter makePropertyWriter() {
+    return [] (protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const JSValue& value) -> optional<conversion::Error> {
+        conversion::Result<PropertyValue<T>> typedValue = conversion::convert<PropertyValue<T>>(value);
+        if (!typedValue) {
+            return typedValue.error();
+        }
+        writePropertyValue(writer, tag, *typedValue);
+        return {};
+    };
+}
+
+} // namespace detail
+
+template <class L, class T>
+LayoutPropertyCodec makePropertyCodec(void (L::*setter)(PropertyValue<T>)) {
+    return {
+        detail::makePropertyWriter<T>(),
+        [setter] (Layer& layer, protozero::pbf_reader reader) {
+            if (L* typedLayer = layer.as<L>()) {
+                (typedLayer->*setter)(readPropertyValue<T>(reader));
+            }
+        }
+    };
+}
+
+template <class L, class T>
+PaintPropertyCodec makePropertyCodec(void (L::*setter)(PropertyValue<T>, const optional<std::string>&)) {
+    return {
+        detail::makePropertyWriter<T>(),
+        [setter] (Layer& layer, protozero::pbf_reader reader, const optional<std::string>& klass) {
+            if (L* typedLayer = layer.as<L>()) {
+                (typedLayer->*setter)(readPropertyValue<T>(reader), klass);
+            }
+        }
+    };
+}
+
+// Visibility is written like a constant property value.
+inline LayoutPropertyCodec makeVisibilityCodec() {
+    return {
+        [] (protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const JSValue& value) -> optional<conversion::Error> {
+            conversion::Result<VisibilityType> visibility = conversion::convert<VisibilityType>(value);
+            if (!visibility) {
+                return visibility.error();
+            }
+            writePropertyValue(writer, tag, PropertyValue<VisibilityType>(*visibility));
+            return {};
+        },
+        [] (Layer& layer, protozero::pbf_reader reader) {
+            PropertyValue<VisibilityType> visibility = readPropertyValue<VisibilityType>(reader);
+            layer.setVisibility(visibility.isConstant() ? visibility.asConstant() : VisibilityType::Visible);
+        }
+    };
+}
+
+} // namespace binary
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,789 @@
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/make_property_codecs.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/conversion.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/layer.hpp>
+#include <mbgl/style/conversion/source.hpp>
+#include <mbgl/style/conversion/tileset.hpp>
+#include <mbgl/style/sources/raster_source.hpp>
+#include <mbgl/style/sources/vector_source.hpp>
+
+#include <mbgl/platform/log.hpp>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+
+const std::string BinaryStyleMagic = "\x89" "MBS\r\n\x1a\n";
+
+bool isBinaryStyle(const std::string& data) {
+    return data.compare(0, BinaryStyleMagic.size(), BinaryStyleMagic) == 0;
+}
+
+namespace binary {
+
+namespace {
+
+enum class FilterType : uint32_t {
+    Null,
+    Equals,
+    NotEquals,
+    LessThan,
+    LessThanEquals,
+    GreaterThan,
+    GreaterThanEquals,
+    In,
+    NotIn,
+    Any,
+    All,
+    None,
+    Has,
+    NotHas,
+};
+
+namespace FilterField {
+enum : protozero::pbf_tag_type { Type = 1, Key, Values, Filters };
+} // namespace FilterField
+
+class FilterWriter {
+public:
+    protozero::pbf_writer& writer;
+
+    void operator()(const NullFilter&) { type(FilterType::Null); }
+
+    void operator()(const EqualsFilter& filter) { compare(FilterType::Equals, filter); }
+    void operator()(const NotEqualsFilter& filter) { compare(FilterType::NotEquals, filter); }
+    void operator()(const LessThanFilter& filter) { compare(FilterType::LessThan, filter); }
+    void operator()(const LessThanEqualsFilter& filter) { compare(FilterType::LessThanEquals, filter); }
+    void operator()(const GreaterThanFilter& filter) { compare(FilterType::GreaterThan, filter); }
+    void operator()(const GreaterThanEqualsFilter& filter) { compare(FilterType::GreaterThanEquals, filter); }
+
+    void operator()(const InFilter& filter) { contains(FilterType::In, filter); }
+    void operator()(const NotInFilter& filter) { contains(FilterType::NotIn, filter); }
+
+    void operator()(const AnyFilter& filter) { combine(FilterType::Any, filter.filters); }
+    void operator()(const AllFilter& filter) { combine(FilterType::All, filter.filters); }
+    void operator()(const NoneFilter& filter) { combine(FilterType::None, filter.filters); }
+
+    void operator()(const HasFilter& filter) {
+        type(FilterType::Has);
+        writer.add_string(FilterField::Key, filter.key);
+    }
+
+    void operator()(const NotHasFilter& filter) {
+        type(FilterType::NotHas);
+        writer.add_string(FilterField::Key, filter.key);
+    }
+
+private:
+    void type(FilterType filterType) {
+        writer.add_uint32(FilterField::Type, static_cast<uint32_t>(filterType));
+    }
+
+    template <class T>
+    void compare(FilterType filterType, const T& filter) {
+        type(filterType);
+        writer.add_string(FilterField::Key, filter.key);
+        writeValue(writer, FilterField::Values, filter.value);
+    }
+
+    template <class T>
+    void contains(FilterType filterType, const T& filter) {
+        type(filterType);
+        writer.add_string(FilterField::Key, filter.key);
+        for (const auto& value : filter.values) {
+            writeValue(writer, FilterField::Values, value);
+        }
+    }
+
+    void combine(FilterType filterType, const std::vector<Filter>& filters) {
+        type(filterType);
+        for (const auto& filter : filters) {
+            writeFilter(writer, FilterField::Filters, filter);
+        }
+    }
+};
+
+} // namespace
+
+void writeValue(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const Value& value) {
+    writeMessage(writer, tag, [&] (protozero::pbf_writer& message) {
+        if (value.is<bool>()) {
+            message.add_bool(1, value.get<bool>());
+        } else if (value.is<uint64_t>()) {
+            message.add_uint64(2, value.get<uint64_t>());
+        } else if (value.is<int64_t>()) {
+            message.add_sint64(3, value.get<int64_t>());
+        } else if (value.is<double>()) {
+            message.add_double(4, value.get<double>());
+        } else if (value.is<std::string>()) {
+            message.add_string(5, value.get<std::string>());
+        } else if (value.is<std::vector<Value>>()) {
+            writeMessage(message, 6, [&] (protozero::pbf_writer& array) {
+                for (const auto& element : value.get<std::vector<Value>>()) {
+                    writeValue(array, 1, element);
+                }
+            });
+        } else if (value.is<PropertyMap>()) {
+            writeMessage(message, 7, [&] (protozero::pbf_writer& object) {
+                for (const auto& member : value.get<PropertyMap>()) {
+                    writeMessage(object, 1, [&] (protozero::pbf_writer& memberMessage) {
+                        memberMessage.add_string(1, member.first);
+                        writeValue(memberMessage, 2, member.second);
+                    });
+                }
+            });
+        }
+    });
+}
+
+Value readValue(protozero::pbf_reader message) {
+    Value result = NullValue();
+
+    while (message.next()) {
+        switch (message.tag()) {
+        case 1:
+            result = Value(message.get_bool());
+            break;
+        case 2:
+            result = Value(message.get_uint64());
+            break;
+        case 3:
+            result = Value(message.get_sint64());
+            break;
+        case 4:
+            result = Value(message.get_double());
+            break;
+        case 5:
+            result = Value(message.get_string());
+            break;
+        case 6: {
+            std::vector<Value> array;
+            protozero::pbf_reader arrayMessage = message.get_message();
+            while (arrayMessage.next(1)) {
+                array.push_back(readValue(arrayMessage.get_message()));
+            }
+            result = Value(std::move(array));
+            break;
+        }
+        case 7: {
+            PropertyMap object;
+            protozero::pbf_reader objectMessage = message.get_message();
+            while (objectMessage.next(1)) {
+                protozero::pbf_reader memberMessage = objectMessage.get_message();
+                std::string key;
+                Value memberValue = NullValue();
+                while (memberMessage.next()) {
+                    if (memberMessage.tag() == 1) {
+                        key = memberMessage.get_string();
+                    } else if (memberMessage.tag() == 2) {
+                        memberValue = readValue(memberMessage.get_message());
+                    } else {
+                        memberMessage.skip();
+                    }
+                }
+                object.emplace(std::move(key), std::move(memberValue));
+            }
+            result = Value(std::move(object));
+            break;
+        }
+        default:
+            message.skip();
+        }
+    }
+
+    return result;
+}
+
+void writeFilter(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const Filter& filter) {
+    writeMessage(writer, tag, [&] (protozero::pbf_writer& message) {
+        Filter::visit(filter, FilterWriter { message });
+    });
+}
+
+Filter readFilter(protozero::pbf_reader message) {
+    FilterType type = FilterType::Null;
+    std::string key;
+    std::vector<Value> values;
+    std::vector<Filter> filters;
+
+    while (message.next()) {
+        switch (message.tag()) {
+        case FilterField::Type:
+            type = static_cast<FilterType>(message.get_uint32());
+            break;
+        case FilterField::Key:
+            key = message.get_string();
+            break;
+        case FilterField::Values:
+            values.push_back(readValue(message.get_message()));
+            break;
+        case FilterField::Filters:
+            filters.push_back(readFilter(message.get_message()));
+            break;
+        default:
+            message.skip();
+        }
+    }
+
+    const auto value = [&] {
+        return values.empty() ? Value(NullValue()) : values.front();
+    };
+
+    const auto valueSet = [&] {
+        return std::make_shared<const FilterValueSet>(values);
+    };
+
+    switch (type) {
+    case FilterType::Null:
+        return NullFilter {};
+    case FilterType::Equals:
+        return EqualsFilter { std::move(key), value() };
+    case FilterType::NotEquals:
+        return NotEqualsFilter { std::move(key), value() };
+    case FilterType::LessThan:
+        return LessThanFilter { std::move(key), value() };
+    case FilterType::LessThanEquals:
+        return LessThanEqualsFilter { std::move(key), value() };
+    case FilterType::GreaterThan:
+        return GreaterThanFilter { std::move(key), value() };
+    case FilterType::GreaterThanEquals:
+        return GreaterThanEqualsFilter { std::move(key), value() };
+    case FilterType::In: {
+        auto set = valueSet();
+        return InFilter { std::move(key), std::move(values), std::move(set) };
+    }
+    case FilterType::NotIn: {
+        auto set = valueSet();
+        return NotInFilter { std::move(key), std::move(values), std::move(set) };
+    }
+    case FilterType::Any:
+        return AnyFilter { std::move(filters) };
+    case FilterType::All:
+        return AllFilter { std::move(filters) };
+    case FilterType::None:
+        return NoneFilter { std::move(filters) };
+    case FilterType::Has:
+        return HasFilter { std::move(key) };
+    case FilterType::NotHas:
+        return NotHasFilter { std::move(key) };
+    }
+
+    throw std::runtime_error("invalid filter type");
+}
+
+namespace {
+
+const std::unordered_map<std::string, LayoutPropertyCodec>& layoutPropertyCodecs() {
+    static const auto codecs = makeLayoutPropertyCodecs();
+    return codecs;
+}
+
+const std::unordered_map<std::string, PaintPropertyCodec>& paintPropertyCodecs() {
+    static const auto codecs = makePaintPropertyCodecs();
+    return codecs;
+}
+
+bool isVectorLayerType(const std::string& type) {
+    return type == "fill" || type == "line" || type == "circle" || type == "symbol";
+}
+
+std::string stringify(const JSValue& value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return { buffer.GetString(), buffer.GetSize() };
+}
+
+void writeProperty(protozero::pbf_writer& writer,
+                   protozero::pbf_tag_type tag,
+                   const std::string& name,
+                   const PropertyWriter& write,
+                   const JSValue& value,
+                   const optional<std::string>& klass) {
+    std::string data;
+    {
+        protozero::pbf_writer message(data);
+        message.add_string(PropertyField::Name, name);
+        if (write(message, PropertyField::Value, value)) {
+            return;
+        }
+        if (klass) {
+            message.add_string(PropertyField::Class, *klass);
+        }
+    }
+    writer.add_message(tag, data);
+}
+
+// Calls the function for the paint properties of the layer's JSON, like
+// conversion::setPaintProperties(), until it returns false.
+template <class Fn>
+void eachPaintProperty(const JSValue& layer, Fn&& fn) {
+    for (const auto& paint : layer.GetObject()) {
+        const std::string paintName = *conversion::toString(paint.name);
+        if (paintName.compare(0, 5, "paint") != 0 || !paint.value.IsObject()) {
+            continue;
+        }
+
+        optional<std::string> klass;
+        if (paintName.compare(0, 6, "paint.") == 0) {
+            klass = paintName.substr(6);
+        }
+
+        for (const auto& property : paint.value.GetObject()) {
+            if (!fn(*conversion::toString(property.name), property.value, klass)) {
+                return;
+            }
+        }
+    }
+}
+
+void writeSource(protozero::pbf_writer& writer, const std::string& id, const JSValue& value) {
+    writeMessage(writer, StyleField::Sources, [&] (protozero::pbf_writer& message) {
+        message.add_string(SourceField::ID, id);
+
+        const std::string type = *conversion::toString(*conversion::objectMember(value, "type"));
+        message.add_string(SourceField::Type, type);
+
+        if (type == "geojson") {
+            message.add_string(SourceField::JSON, stringify(value));
+            return;
+        }
+
+        if (auto url = conversion::objectMember(value, "url")) {
+            message.add_string(SourceField::URL, *conversion::toString(*url));
+        } else {
+            const Tileset tileset = *conversion::convert<Tileset>(value);
+            writeMessage(message, SourceField::Tileset, [&] (protozero::pbf_writer& tilesetMessage) {
+                for (const auto& tiles : tileset.tiles) {
+                    tilesetMessage.add_string(TilesetField::Tiles, tiles);
+                }
+                tilesetMessage.add_uint32(TilesetField::MinZoom, tileset.zoomRange.min);
+                tilesetMessage.add_uint32(TilesetField::MaxZoom, tileset.zoomRange.max);
+                if (!tileset.attribution.empty()) {
+                    tilesetMessage.add_string(TilesetField::Attribution, tileset.attribution);
+                }
+                tilesetMessage.add_bool(TilesetField::TMS, tileset.scheme == Tileset::Scheme::TMS);
+                for (const auto& metatiles : tileset.metatiles) {
+                    tilesetMessage.add_string(TilesetField::Metatiles, metatiles);
+                }
+                if (!tileset.metatiles.empty()) {
+                    tilesetMessage.add_uint32(TilesetField::MetatileSize, tileset.metatileSize);
+                }
+            });
+        }
+
+        if (type == "raster") {
+            if (auto tileSize = conversion::objectMember(value, "tileSize")) {
+                message.add_uint32(SourceField::TileSize, static_cast<uint16_t>(*conversion::toNumber(*tileSize)));
+            }
+        }
+    });
+}
+
+// Writes a layer that converted without errors.
+void writeLayer(protozero::pbf_writer& writer, const Layer& layer, const JSValue& value) {
+    writeMessage(writer, StyleField::Layers, [&] (protozero::pbf_writer& message) {
+        message.add_string(LayerField::ID, layer.getID());
+
+        if (!layer.baseImpl->ref.empty()) {
+            message.add_string(LayerField::Ref, layer.baseImpl->ref);
+
+            // The parser stops at the first paint property of a layer with a ref that fails to
+            // convert, keeping the ones before.
+            std::unique_ptr<Layer> scratch = layer.baseImpl->cloneRef(layer.getID());
+            eachPaintProperty(value, [&] (const std::string& name, const JSValue& propertyValue, const optional<std::string>& klass) {
+                if (conversion::setPaintProperty(*scratch, name, propertyValue, klass)) {
+                    return false;
+                }
+                writeProperty(message, LayerField::Paint, name, paintPropertyCodecs().at(name).write, propertyValue, klass);
+                return true;
+            });
+            return;
+        }
+
+        const std::string type = *conversion::toString(*conversion::objectMember(value, "type"));
+        message.add_string(LayerField::Type, type);
+
+        if (type != "background") {
+            message.add_string(LayerField::Source, *conversion::toString(*conversion::objectMember(value, "source")));
+        }
+
+        if (isVectorLayerType(type)) {
+            if (auto sourceLayer = conversion::objectMember(value, "source-layer")) {
+                message.add_string(LayerField::SourceLayer, *conversion::toString(*sourceLayer));
+            }
+            if (auto filter = conversion::objectMember(value, "filter")) {
+                writeFilter(message, LayerField::Filter, *conversion::convert<Filter>(*filter));
+            }
+        }
+
+        if (auto minzoom = conversion::objectMember(value, "minzoom")) {
+            message.add_float(LayerField::MinZoom, *conversion::toNumber(*minzoom));
+        }
+
+        if (auto maxzoom = conversion::objectMember(value, "maxzoom")) {
+            message.add_float(LayerField::MaxZoom, *conversion::toNumber(*maxzoom));
+        }
+
+        if (auto layout = conversion::objectMember(value, "layout")) {
+            for (const auto& property : layout->GetObject()) {
+                const std::string name = *conversion::toString(property.name);
+                writeProperty(message, LayerField::Layout, name, layoutPropertyCodecs().at(name).write, property.value, {});
+            }
+        }
+
+        eachPaintProperty(value, [&] (const std::string& name, const JSValue& propertyValue, const optional<std::string>& klass) {
+            writeProperty(message, LayerField::Paint, name, paintPropertyCodecs().at(name).write, propertyValue, klass);
+            return true;
+        });
+    });
+}
+
+template <class LayerType>
+std::unique_ptr<Layer> makeVectorLayer(const std::string& id,
+                                       const std::string& source,
+                                       const optional<std::string>& sourceLayer,
+                                       const optional<Filter>& filter) {
+    auto layer = std::make_unique<LayerType>(id, source);
+    if (sourceLayer) {
+        layer->setSourceLayer(*sourceLayer);
+    }
+    if (filter) {
+        layer->setFilter(*filter);
+    }
+    return std::move(layer);
+}
+
+} // namespace
+
+LayerHeader readLayerHeader(protozero::pbf_reader message) {
+    LayerHeader header;
+
+    while (message.next()) {
+        switch (message.tag()) {
+        case LayerField::ID:
+            header.id = message.get_string();
+            break;
+        case LayerField::Ref:
+            header.ref = message.get_string();
+            break;
+        case LayerField::Source:
+            header.source = message.get_string();
+            break;
+        case LayerField::Layout: {
+            protozero::pbf_reader property = message.get_message();
+            std::string name;
+            protozero::pbf_reader value;
+            while (property.next()) {
+                if (property.tag() == PropertyField::Name) {
+                    name = property.get_string();
+                } else if (property.tag() == PropertyField::Value) {
+                    value = property.get_message();
+                } else {
+                    property.skip();
+                }
+            }
+            if (name == "visibility") {
+                PropertyValue<VisibilityType> visibility = readPropertyValue<VisibilityType>(value);
+                header.visible = !visibility.isConstant() || visibility.asConstant() == VisibilityType::Visible;
+            }
+            break;
+        }
+        default:
+            message.skip();
+        }
+    }
+
+    return header;
+}
+
+std::unique_ptr<Source> readSource(protozero::pbf_reader message) {
+    std::string id;
+    std::string type;
+    optional<variant<std::string, Tileset>> urlOrTileset;
+    uint16_t tileSize = util::tileSize;
+    std::string json;
+
+    while (message.next()) {
+        switch (message.tag()) {
+        case SourceField::ID:
+            id = message.get_string();
+            break;
+        case SourceField::Type:
+            type = message.get_string();
+            break;
+        case SourceField::URL:
+            urlOrTileset = variant<std::string, Tileset>(message.get_string());
+            break;
+        case SourceField::Tileset: {
+            Tileset tileset;
+            protozero::pbf_reader tilesetMessage = message.get_message();
+            while (tilesetMessage.next()) {
+                switch (tilesetMessage.tag()) {
+                case TilesetField::Tiles:
+                    tileset.tiles.push_back(tilesetMessage.get_string());
+                    break;
+                case TilesetField::MinZoom:
+                    tileset.zoomRange.min = tilesetMessage.get_uint32();
+                    break;
+                case TilesetField::MaxZoom:
+                    tileset.zoomRange.max = tilesetMessage.get_uint32();
+                    break;
+                case TilesetField::Attribution:
+                    tileset.attribution = tilesetMessage.get_string();
+                    break;
+                case TilesetField::TMS:
+                    tileset.scheme = tilesetMessage.get_bool() ? Tileset::Scheme::TMS : Tileset::Scheme::XYZ;
+                    break;
+                case TilesetField::Metatiles:
+                    tileset.metatiles.push_back(tilesetMessage.get_string());
+                    break;
+                case TilesetField::MetatileSize:
+                    tileset.metatileSize = tilesetMessage.get_uint32();
+                    break;
+                default:
+                    tilesetMessage.skip();
+                }
+            }
+            urlOrTileset = variant<std::string, Tileset>(std::move(tileset));
+            break;
+        }
+        case SourceField::TileSize:
+            tileSize = message.get_uint32();
+            break;
+        case SourceField::JSON:
+            json = message.get_string();
+            break;
+        default:
+            message.skip();
+        }
+    }
+
+    if (type == "geojson") {
+        JSDocument document;
+        document.Parse<0>(json.c_str());
+        if (document.HasParseError()) {
+            Log::Warning(Event::ParseStyle, "invalid GeoJSON source %s", id.c_str());
+            return nullptr;
+        }
+
+        conversion::Result<std::unique_ptr<Source>> source =
+            conversion::convert<std::unique_ptr<Source>>(static_cast<const JSValue&>(document), id);
+        if (!source) {
+            Log::Warning(Event::ParseStyle, source.error().message);
+            return nullptr;
+        }
+        return std::move(*source);
+    }
+
+    if (!urlOrTileset) {
+        Log::Warning(Event::ParseStyle, "source %s must have a url or tiles", id.c_str());
+        return nullptr;
+    }
+
+    if (type == "vector") {
+        return std::make_unique<VectorSource>(std::move(id), std::move(*urlOrTileset));
+    } else if (type == "raster") {
+        return std::make_unique<RasterSource>(std::move(id), std::move(*urlOrTileset), tileSize);
+    }
+
+    Log::Warning(Event::ParseStyle, "invalid source type");
+    return nullptr;
+}
+
+std::unique_ptr<Layer> readLayer(protozero::pbf_reader message) {
+    std::string id;
+    std::string type;
+    std::string source;
+    optional<std::string> sourceLayer;
+    optional<Filter> filter;
+    optional<float> minzoom;
+    optional<float> maxzoom;
+    std::vector<protozero::pbf_reader> layout;
+
+    protozero::pbf_reader layerMessage = message;
+    while (message.next()) {
+        switch (message.tag()) {
+        case LayerField::ID:
+            id = message.get_string();
+            break;
+        case LayerField::Type:
+            type = message.get_string();
+            break;
+        case LayerField::Source:
+            source = message.get_string();
+            break;
+        case LayerField::SourceLayer:
+            sourceLayer = message.get_string();
+            break;
+        case LayerField::Filter:
+            filter = readFilter(message.get_message());
+            break;
+        case LayerField::MinZoom:
+            minzoom = message.get_float();
+            break;
+        case LayerField::MaxZoom:
+            maxzoom = message.get_float();
+            break;
+        case LayerField::Layout:
+            layout.push_back(message.get_message());
+            break;
+        default:
+            message.skip();
+        }
+    }
+
+    std::unique_ptr<Layer> layer;
+    if (type == "fill") {
+        layer = makeVectorLayer<FillLayer>(id, source, sourceLayer, filter);
+    } else if (type == "line") {
+        layer = makeVectorLayer<LineLayer>(id, source, sourceLayer, filter);
+    } else if (type == "circle") {
+        layer = makeVectorLayer<CircleLayer>(id, source, sourceLayer, filter);
+    } else if (type == "symbol") {
+        layer = makeVectorLayer<SymbolLayer>(id, source, sourceLayer, filter);
+    } else if (type == "raster") {
+        layer = std::make_unique<RasterLayer>(id, source);
+    } else if (type == "background") {
+        layer = std::make_unique<BackgroundLayer>(id);
+    } else {
+        Log::Warning(Event::ParseStyle, "invalid layer type");
+        return nullptr;
+    }
+
+    if (minzoom) {
+        layer->setMinZoom(*minzoom);
+    }
+
+    if (maxzoom) {
+        layer->setMaxZoom(*maxzoom);
+    }
+
+    for (auto& property : layout) {
+        std::string name;
+        protozero::pbf_reader value;
+        while (property.next()) {
+            if (property.tag() == PropertyField::Name) {
+                name = property.get_string();
+            } else if (property.tag() == PropertyField::Value) {
+                value = property.get_message();
+            } else {
+                property.skip();
+            }
+        }
+
+        auto it = layoutPropertyCodecs().find(name);
+        if (it != layoutPropertyCodecs().end()) {
+            it->second.read(*layer, value);
+        }
+    }
+
+    readPaintProperties(*layer, layerMessage);
+
+    return layer;
+}
+
+void readPaintProperties(Layer& layer, protozero::pbf_reader message) {
+    while (message.next(LayerField::Paint)) {
+        protozero::pbf_reader property = message.get_message();
+        std::string name;
+        protozero::pbf_reader value;
+        optional<std::string> klass;
+        while (property.next()) {
+            switch (property.tag()) {
+            case PropertyField::Name:
+                name = property.get_string();
+                break;
+            case PropertyField::Value:
+                value = property.get_message();
+                break;
+            case PropertyField::Class:
+                klass = property.get_string();
+                break;
+            default:
+                property.skip();
+            }
+        }
+
+        auto it = paintPropertyCodecs().find(name);
+        if (it != paintPropertyCodecs().end()) {
+            it->second.read(layer, value, klass);
+        }
+    }
+}
+
+} // namespace binary
+
+std::string compileStyle(const std::string& json) {
+    using namespace binary;
+
+    if (isBinaryStyle(json)) {
+        throw std::runtime_error("style is already compiled");
+    }
+
+    // Converting the style validates it; only what the parser keeps is compiled.
+    Parser parser;
+    StyleParseResult error = parser.parse(json);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+
+    std::string result = BinaryStyleMagic;
+    protozero::pbf_writer writer(result);
+
+    writer.add_uint32(StyleField::Version, BinaryStyleVersion);
+
+    if (!parser.name.empty()) {
+        writer.add_string(StyleField::Name, parser.name);
+    }
+
+    const std::array<double, 2> center = {{ parser.latLng.longitude, parser.latLng.latitude }};
+    writer.add_packed_double(StyleField::Center, center.begin(), center.end());
+    writer.add_double(StyleField::Zoom, parser.zoom);
+    writer.add_double(StyleField::Bearing, parser.bearing);
+    writer.add_double(StyleField::Pitch, parser.pitch);
+
+    if (!parser.spriteURL.empty()) {
+        writer.add_string(StyleField::Sprite, parser.spriteURL);
+    }
+
+    if (!parser.glyphURL.empty()) {
+        writer.add_string(StyleField::Glyphs, parser.glyphURL);
+    }
+
+    for (const auto& source : parser.sources) {
+        writeSource(writer, source->getID(), *conversion::objectMember(document["sources"], source->getID().c_str()));
+    }
+
+    // The parser keeps the first of the layers with the same ID.
+    std::unordered_map<std::string, const JSValue*> layerValues;
+    if (!parser.layers.empty()) {
+        for (const auto& layerValue : document["layers"].GetArray()) {
+            if (layerValue.IsObject() && layerValue.HasMember("id") && layerValue["id"].IsString()) {
+                layerValues.emplace(*conversion::toString(layerValue["id"]), &layerValue);
+            }
+        }
+    }
+
+    for (const auto& layer : parser.layers) {
+        writeLayer(writer, *layer, *layerValues.at(layer->getID()));
+    }
+
+    return result;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/property_value.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <protozero/pbf_reader.hpp>
+#include <protozero/pbf_writer.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+class Layer;
+class Source;
+
+/*
+   A style compiled ahead of time into a binary form that loads without parsing JSON or converting
+   the layers, their filters and their property values. Parser::parse() takes a binary style
+   anywhere it takes a style JSON, so that it can be loaded from a URL or with setStyleJSON().
+
+   A binary style is the `BinaryStyleMagic` prefix followed by a protocol buffer message:
+
+       message Style {
+           uint32 version = 1;                  // BinaryStyleVersion
+           string name = 2;
+           repeated double center = 3 [packed]; // longitude, latitude
+           double zoom = 4;
+           double bearing = 5;
+           double pitch = 6;
+           string sprite = 7;
+           string glyphs = 8;
+           repeated Source sources = 9;
+           repeated Layer layers = 10;
+       }
+
+       message Source {
+           string id = 1;
+           string type = 2;
+           string url = 3;
+           Tileset tileset = 4;
+           uint32 tile_size = 5;
+           string json = 6;                     // GeoJSON sources stay JSON
+       }
+
+       message Tileset {
+           repeated string tiles = 1;
+           uint32 minzoom = 2;
+           uint32 maxzoom = 3;
+           string attribution = 4;
+           bool tms = 5;
+       }
+
+       message Layer {
+           string id = 1;
+           string type = 2;
+           string ref = 3;
+           string source = 4;
+           string source_layer = 5;
+           Filter filter = 6;
+           float minzoom = 7;
+           float maxzoom = 8;
+           repeated Property layout = 9;
+           repeated Property paint = 10;
+       }
+
+       message Property {
+           string name = 1;
+           PropertyValue value = 2;
+           string class = 3;                    // of paint properties
+       }
+
+   See below for the messages of property values, filters and feature property values. Layers with
+   a `ref` only have an id, the ref and their paint properties, as in the JSON. Only the layers and
+   sources that convert without errors are compiled.
+*/
+
+extern const std::string BinaryStyleMagic;
+constexpr uint32_t BinaryStyleVersion = 1;
+
+// Whether the data is a binary style rather than a style JSON.
+bool isBinaryStyle(const std::string&);
+
+// Compiles a style JSON into a binary style. Throws std::runtime_error if the JSON doesn't parse.
+// Sources and layers that don't convert are left out, with the warnings that loading the JSON
+// would log.
+std::string compileStyle(const std::string& json);
+
+namespace binary {
+
+namespace StyleField {
+enum : protozero::pbf_tag_type { Version = 1, Name, Center, Zoom, Bearing, Pitch, Sprite, Glyphs, Sources, Layers };
+} // namespace StyleField
+
+namespace SourceField {
+enum : protozero::pbf_tag_type { ID = 1, Type, URL, Tileset, TileSize, JSON };
+} // namespace SourceField
+
+namespace TilesetField {
+enum : protozero::pbf_tag_type { Tiles = 1, MinZoom, MaxZoom, Attribution, TMS, Metatiles, MetatileSize };
+} // namespace TilesetField
+
+namespace LayerField {
+enum : protozero::pbf_tag_type { ID = 1, Type, Ref, Source, SourceLayer, Filter, MinZoom, MaxZoom, Layout, Paint };
+} // namespace LayerField
+
+namespace PropertyField {
+enum : protozero::pbf_tag_type { Name = 1, Value, Class };
+} // namespace PropertyField
+
+// Writes a nested message with the given tag.
+template <class Fn>
+void writeMessage(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, Fn&& fn) {
+    std::string data;
+    {
+        protozero::pbf_writer message(data);
+        fn(message);
+    }
+    writer.add_message(tag, data);
+}
+
+/*
+   Feature property values, e.g. the ones filters compare with. Null values are empty messages.
+
+       message Value {
+           bool bool = 1;
+           uint64 uint = 2;
+           sint64 int = 3;
+           double double = 4;
+           string string = 5;
+           Array array = 6;                     // message Array { repeated Value values = 1; }
+           Object object = 7;                   // message Object { repeated Member members = 1; }
+       }                                        // message Member { string key = 1; Value value = 2; }
+*/
+void writeValue(protozero::pbf_writer&, protozero::pbf_tag_type, const Value&);
+Value readValue(protozero::pbf_reader);
+
+/*
+       message Filter {
+           uint32 type = 1;                     // FilterType
+           string key = 2;
+           repeated Value values = 3;           // one for comparisons, any number for `in`
+           repeated Filter filters = 4;         // of `any`, `all` and `none`
+       }
+*/
+void writeFilter(protozero::pbf_writer&, protozero::pbf_tag_type, const Filter&);
+Filter readFilter(protozero::pbf_reader);
+
+// The fields of a Layer message that are needed before the layers are read, e.g. to resolve refs.
+struct LayerHeader {
+    std::string id;
+    std::string ref;
+    std::string source;
+    bool visible = true;
+};
+
+LayerHeader readLayerHeader(protozero::pbf_reader);
+
+// Log the warnings of the conversion, and return null, for invalid sources and layers. Layers with
+// a ref are read by cloning the layer they refer to and reading their paint properties into it.
+std::unique_ptr<Source> readSource(protozero::pbf_reader);
+std::unique_ptr<Layer> readLayer(protozero::pbf_reader);
+void readPaintProperties(Layer&, protozero::pbf_reader);
+
+// The values of properties, each written as a single field of the given tag: numbers as floats,
+// enumerations as their underlying value, colors and arrays of numbers as packed floats, and
+// arrays of strings as a message of repeated strings with tag 1.
+template <class T, class Enable = void>
+struct ConstantCodec;
+
+template <>
+struct ConstantCodec<bool> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, bool value) {
+        writer.add_bool(tag, value);
+    }
+    static bool read(protozero::pbf_reader& reader) {
+        return reader.get_bool();
+    }
+};
+
+template <>
+struct ConstantCodec<float> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, float value) {
+        writer.add_float(tag, value);
+    }
+    static float read(protozero::pbf_reader& reader) {
+        return reader.get_float();
+    }
+};
+
+template <>
+struct ConstantCodec<std::string> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const std::string& value) {
+        writer.add_string(tag, value);
+    }
+    static std::string read(protozero::pbf_reader& reader) {
+        return reader.get_string();
+    }
+};
+
+template <class T>
+struct ConstantCodec<T, std::enable_if_t<std::is_enum<T>::value>> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, T value) {
+        writer.add_uint32(tag, static_cast<uint32_t>(value));
+    }
+    static T read(protozero::pbf_reader& reader) {
+        return static_cast<T>(reader.get_uint32());
+    }
+};
+
+template <>
+struct ConstantCodec<Color> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const Color& value) {
+        const std::array<float, 4> components = {{ value.r, value.g, value.b, value.a }};
+        writer.add_packed_float(tag, components.begin(), components.end());
+    }
+    static Color read(protozero::pbf_reader& reader) {
+        std::array<float, 4> components = {{ 0, 0, 0, 0 }};
+        std::size_t i = 0;
+        for (float component : reader.get_packed_float()) {
+            if (i < components.size()) {
+                components[i++] = component;
+            }
+        }
+        return { components[0], components[1], components[2], components[3] };
+    }
+};
+
+template <std::size_t N>
+struct ConstantCodec<std::array<float, N>> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const std::array<float, N>& value) {
+        writer.add_packed_float(tag, value.begin(), value.end());
+    }
+    static std::array<float, N> read(protozero::pbf_reader& reader) {
+        std::array<float, N> result {};
+        std::size_t i = 0;
+        for (float element : reader.get_packed_float()) {
+            if (i < N) {
+                result[i++] = element;
+            }
+        }
+        return result;
+    }
+};
+
+template <>
+struct ConstantCodec<std::vector<float>> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const std::vector<float>& value) {
+        writer.add_packed_float(tag, value.begin(), value.end());
+    }
+    static std::vector<float> read(protozero::pbf_reader& reader) {
+        std::vector<float> result;
+        for (float element : reader.get_packed_float()) {
+            result.push_back(element);
+        }
+        return result;
+    }
+};
+
+template <>
+struct ConstantCodec<std::vector<std::string>> {
+    static void write(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const std::vector<std::string>& value) {
+        writeMessage(writer, tag, [&] (protozero::pbf_writer& message) {
+            for (const auto& element : value) {
+                message.add_string(1, element);
+            }
+        });
+    }
+    static std::vector<std::string> read(protozero::pbf_reader& reader) {
+        std::vector<std::string> result;
+        protozero::pbf_reader message = reader.get_message();
+        while (message.next(1)) {
+            result.push_back(message.get_string());
+        }
+        return result;
+    }
+};
+
+/*
+       message PropertyValue {                  // undefined if empty
+           T constant = 1;
+           Function function = 2;
+           PropertyFunction property_function = 3;
+       }
+
+       message Function {
+           float base = 1;
+           repeated Stop stops = 2;             // message Stop { float zoom = 1; T value = 2; }
+       }
+
+       message PropertyFunction {
+           string property = 1;
+           repeated Stop stops = 2;             // message Stop { Value domain = 1; T value = 2; }
+           T default = 3;
+       }
+*/
+template <class T>
+void writePropertyValue(protozero::pbf_writer& writer, protozero::pbf_tag_type tag, const PropertyValue<T>& value) {
+    using Codec = ConstantCodec<T>;
+
+    writeMessage(writer, tag, [&] (protozero::pbf_writer& message) {
+        if (value.isConstant()) {
+            Codec::write(message, 1, value.asConstant());
+        } else if (value.isFunction()) {
+            const Function<T>& function = value.asFunction();
+            writeMessage(message, 2, [&] (protozero::pbf_writer& functionMessage) {
+                functionMessage.add_float(1, function.getBase());
+                for (const auto& stop : function.getStops()) {
+                    writeMessage(functionMessage, 2, [&] (protozero::pbf_writer& stopMessage) {
+                        stopMessage.add_float(1, stop.first);
+                        Codec::write(stopMessage, 2, stop.second);
+                    });
+                }
+            });
+        } else if (value.isPropertyFunction()) {
+            const PropertyFunction<T>& function = value.asPropertyFunction();
+            writeMessage(message, 3, [&] (protozero::pbf_writer& functionMessage) {
+                functionMessage.add_string(1, function.getProperty());
+                for (const auto& stop : function.getStops()) {
+                    writeMessage(functionMessage, 2, [&] (protozero::pbf_writer& stopMessage) {
+                        writeValue(stopMessage, 1, stop.first);
+                        Codec::write(stopMessage, 2, stop.second);
+                    });
+                }
+                if (function.getDefaultValue()) {
+                    Codec::write(functionMessage, 3, *function.getDefaultValue());
+                }
+            });
+        }
+    });
+}
+
+template <class T>
+PropertyValue<T> readPropertyValue(protozero::pbf_reader message) {
+    using Codec = ConstantCodec<T>;
+
+    while (message.next()) {
+        switch (message.tag()) {
+        case 1:
+            return Codec::read(message);
+        case 2: {
+            protozero::pbf_reader functionMessage = message.get_message();
+            float base = 1;
+            typename Function<T>::Stops stops;
+            while (functionMessage.next()) {
+                if (functionMessage.tag() == 1) {
+                    base = functionMessage.get_float();
+                } else if (functionMessage.tag() == 2) {
+                    protozero::pbf_reader stopMessage = functionMessage.get_message();
+                    float zoom = 0;
+                    T stopValue {};
+                    while (stopMessage.next()) {
+                        if (stopMessage.tag() == 1) {
+                            zoom = stopMessage.get_float();
+                        } else if (stopMessage.tag() == 2) {
+                            stopValue = Codec::read(stopMessage);
+                        } else {
+                            stopMessage.skip();
+                        }
+                    }
+                    stops.emplace_back(zoom, std::move(stopValue));
+                } else {
+                    functionMessage.skip();
+                }
+            }
+            return Function<T>(std::move(stops), base);
+        }
+        case 3: {
+            protozero::pbf_reader functionMessage = message.get_message();
+            std::string property;
+            typename PropertyFunction<T>::Stops stops;
+            optional<T> defaultValue;
+            while (functionMessage.next()) {
+                if (functionMessage.tag() == 1) {
+                    property = functionMessage.get_string();
+                } else if (functionMessage.tag() == 2) {
+                    protozero::pbf_reader stopMessage = functionMessage.get_message();
+                    Value domain;
+                    T stopValue {};
+                    while (stopMessage.next()) {
+                        if (stopMessage.tag() == 1) {
+                            domain = readValue(stopMessage.get_message());
+                        } else if (stopMessage.tag() == 2) {
+                            stopValue = Codec::read(stopMessage);
+                        } else {
+                            stopMessage.skip();
+                        }
+                    }
+                    stops.emplace_back(std::move(domain), std::move(stopValue));
+                } else if (functionMessage.tag() == 3) {
+                    defaultValue = Codec::read(functionMessage);
+                } else {
+                    functionMessage.skip();
+                }
+            }
+            return PropertyFunction<T>(std::move(property), std::move(stops), std::move(defaultValue));
+        }
+        default:
+            message.skip();
+        }
+    }
+
+    return {};
+}
+
+} // namespace binary
+} // namespace style
+} // namespace mbgl
@@ -1,16 +1,144 @@
 #include <mbgl/style/bucket_parameters.hpp>
-#include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/instrumentation.hpp>
+
+#include <algorithm>
+#include <utility>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+// Wraps a feature so that its geometries are only decoded once. The feature and its decoded
+// geometries live in the arena of the FilteredFeatures they belong to.
+class DecodedFeature : public GeometryTileFeature {
+public:
+    DecodedFeature(std::unique_ptr<GeometryTileFeature> feature_, util::MonotonicArena& arena)
+        : feature(std::move(feature_)) {
+        const GeometryCollection geometries = feature->getGeometries();
+
+        ringCount = geometries.size();
+        ringSizes = arena.allocateArray<std::size_t>(ringCount);
+
+        std::size_t pointCount = 0;
+        for (std::size_t r = 0; r < ringCount; r++) {
+            ringSizes[r] = geometries[r].size();
+            pointCount += ringSizes[r];
+        }
+
+        points = arena.allocateArray<GeometryCoordinate>(pointCount);
+
+        GeometryCoordinate* point = points;
+        for (const auto& ring : geometries) {
+            point = std::copy(ring.begin(), ring.end(), point);
+        }
+    }
+
+    FeatureType getType() const override { return feature->getType(); }
+    optional<Value> getValue(const std::string& key) const override { return feature->getValue(key); }
+    optional<Value> getValueByKeyIndex(std::size_t index) const override { return feature->getValueByKeyIndex(index); }
+    PropertyMap getProperties() const override { return feature->getProperties(); }
+    optional<FeatureIdentifier> getID() const override { return feature->getID(); }
+    optional<GeometryBox> getBoundingBox() const override { return feature->getBoundingBox(); }
+
+    GeometryCollection getGeometries() const override {
+        GeometryCollection geometries;
+        geometries.reserve(ringCount);
+
+        const GeometryCoordinate* point = points;
+        for (std::size_t r = 0; r < ringCount; r++) {
+            geometries.emplace_back(point, point + ringSizes[r]);
+            point += ringSizes[r];
+        }
+
+        return geometries;
+    }
+
+    void eachGeometry(const std::function<void (const GeometryCoordinates&)>& function) const override {
+        GeometryCoordinates line;
+
+        const GeometryCoordinate* point = points;
+        for (std::size_t r = 0; r < ringCount; r++) {
+            line.assign(point, point + ringSizes[r]);
+            function(line);
+            point += ringSizes[r];
+        }
+    }
+
+private:
+    const std::unique_ptr<GeometryTileFeature> feature;
+    std::size_t ringCount;
+    std::size_t* ringSizes;
+    GeometryCoordinate* points;
+};
+
+bool intersects(const GeometryTileFeature& feature, const optional<GeometryBox>& bounds) {
+    if (!bounds) {
+        return true;
+    }
+    const optional<GeometryBox> box = feature.getBoundingBox();
+    return box &&
+        box->min.x <= bounds->max.x && box->max.x >= bounds->min.x &&
+        box->min.y <= bounds->max.y && box->max.y >= bounds->min.y;
+}
+
+} // namespace
+
+optional<GeometryBox> visibleBounds(const OverscaledTileID& tileID) {
+    const uint32_t overscaleFactor = tileID.overscaleFactor();
+    if (overscaleFactor == 1) {
+        return {};
+    }
+
+    const auto margin = int16_t(128 * util::EXTENT / (util::tileSize * overscaleFactor));
+    return GeometryBox({ int16_t(-margin), int16_t(-margin) },
+                       { int16_t(util::EXTENT + margin), int16_t(util::EXTENT + margin) });
+}
+
+FilteredFeatures::FilteredFeatures(const GeometryTileLayer& layer,
+                                   const Filter& filter,
+                                   const optional<GeometryBox>& bounds,
+                                   const std::atomic<bool>& obsolete) {
+    util::Instrumentation::add(util::Instrumentation::Counter::FilterEvaluation, layer.featureCount());
+
+    const CompiledFilter compiled(filter);
+    const FilterKeys keys(layer, compiled);
+    for (std::size_t i = 0; !obsolete && i < layer.featureCount(); i++) {
+        auto feature = layer.getFeature(i);
+        if (!compiled(feature->getType(), feature->getID(), [&] (std::size_t key) { return keys.getValue(*feature, key); }))
+            continue;
+        if (!intersects(*feature, bounds))
+            continue;
+        entries.push_back({ i, arena.make<DecodedFeature>(std::move(feature), arena) });
+    }
+}
+
 void BucketParameters::eachFilteredFeature(const Filter& filter,
                                                 std::function<void (const GeometryTileFeature&, std::size_t index, const std::string& layerName)> function) {
     auto name = layer.getName();
+
+    if (filteredFeatures) {
+        for (const auto& entry : filteredFeatures->entries) {
+            if (cancelled()) {
+                return;
+            }
+            function(*entry.feature, entry.index, name);
+        }
+        return;
+    }
+
+    util::Instrumentation::add(util::Instrumentation::Counter::FilterEvaluation, layer.featureCount());
+
+    const CompiledFilter compiled(filter);
+    const FilterKeys keys(layer, compiled);
     for (std::size_t i = 0; !cancelled() && i < layer.featureCount(); i++) {
         auto feature = layer.getFeature(i);
-        if (!filter(feature->getType(), feature->getID(), [&] (const auto& key) { return feature->getValue(key); }))
+        if (!compiled(feature->getType(), feature->getID(), [&] (std::size_t key) { return keys.getValue(*feature, key); }))
+            continue;
+        if (!intersects(*feature, bounds))
             continue;
         function(*feature, i, name);
     }
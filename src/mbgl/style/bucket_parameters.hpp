@@ -3,21 +3,84 @@
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/monotonic_arena.hpp>
+#include <mbgl/util/optional.hpp>
 
 #include <atomic>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace mbgl {
 
 class TileID;
-class GeometryTileLayer;
-class GeometryTileFeature;
 class GlyphAtlas;
 class CollisionTile;
 class FeatureIndex;
 
 namespace style {
 
+// Looks up the values of a compiled filter's keys, by their index in the layer for layers that
+// support it. The keys are resolved up front, for all features of the layer.
+class FilterKeys {
+public:
+    FilterKeys(const GeometryTileLayer& layer, const CompiledFilter& filter_)
+        : filter(filter_),
+          indexed(layer.hasKeyIndices()) {
+        if (indexed) {
+            for (const auto& key : filter.getKeys()) {
+                indices.push_back(layer.getKeyIndex(key));
+            }
+        }
+    }
+
+    optional<Value> getValue(const GeometryTileFeature& feature, std::size_t key) const {
+        if (!indexed) {
+            return feature.getValue(filter.getKeys()[key]);
+        }
+        return indices[key] ? feature.getValueByKeyIndex(*indices[key]) : optional<Value>();
+    }
+
+private:
+    const CompiledFilter& filter;
+    const bool indexed;
+    std::vector<optional<std::size_t>> indices;
+};
+
+// The region features of a tile need to intersect to be visible, or nothing if all of them are
+// laid out. Overscaled tiles show all of their source tile, with its buffer scaled up along with
+// it; features that only lie in that buffer are too far outside of the tile to be seen. A margin
+// of 128 pixels around the tile leaves room for line widths, translations and the like.
+optional<GeometryBox> visibleBounds(const OverscaledTileID&);
+
+// The features of a source layer that pass a filter, with their geometries already decoded.
+// Layers that read the same source layer with the same filter share one of these, so that each
+// feature is only decoded and filtered once. Immutable once constructed; safe to share between
+// threads. The decoded features are allocated from an arena of their own, so that they're all
+// released at once when the layout that uses them is done.
+class FilteredFeatures {
+public:
+    // Only features that intersect `bounds`, if given, are kept.
+    FilteredFeatures(const GeometryTileLayer&,
+                     const Filter&,
+                     const optional<GeometryBox>& bounds,
+                     const std::atomic<bool>& obsolete);
+
+    struct Entry {
+        std::size_t index;
+        util::ArenaPtr<const GeometryTileFeature> feature;
+    };
+
+private:
+    // Declared before the entries, so that they're destroyed first.
+    util::MonotonicArena arena;
+
+public:
+    std::vector<Entry> entries;
+};
+
 class BucketParameters {
 public:
     BucketParameters(const OverscaledTileID& tileID_,
@@ -33,7 +96,8 @@ public:
           tileUID(tileUID_),
           glyphAtlas(glyphAtlas_),
           featureIndex(featureIndex_),
-          mode(mode_) {}
+          mode(mode_),
+          bounds(visibleBounds(tileID_)) {}
 
     bool cancelled() const {
         return obsolete;
@@ -48,6 +112,13 @@ public:
     GlyphAtlas& glyphAtlas;
     FeatureIndex& featureIndex;
     const MapMode mode;
+
+    // eachFilteredFeature() skips features that don't intersect these.
+    const optional<GeometryBox> bounds;
+
+    // If set, eachFilteredFeature() iterates over these instead of the layer's features. Only
+    // valid for the filter they were created with.
+    const FilteredFeatures* filteredFeatures = nullptr;
 };
 
 } // namespace style
@@ -11,7 +11,16 @@ namespace style {
 
 class CascadeParameters {
 public:
+    CascadeParameters(std::vector<ClassID> classes_, TimePoint now_, TransitionOptions transition_)
+        : classes(std::move(classes_)), now(now_), transition(std::move(transition_)) {
+        for (const auto id : classes) {
+            classMask |= style::classMask(id);
+        }
+    }
+
+    // The classes in the order they take precedence in, and the set of them.
     std::vector<ClassID> classes;
+    ClassMask classMask = 0;
     TimePoint now;
     TransitionOptions transition;
 };
@@ -14,6 +14,16 @@ enum class ClassID : uint32_t {
     Named = 2 // These values (and all subsequent IDs) are from a named style from the layer
 };
 
+// A set of classes, with a bit for each of the first 63 IDs. All later IDs share the last bit,
+// so that a set with it may hold any of them.
+using ClassMask = uint64_t;
+
+constexpr ClassMask OverflowClassMask = ClassMask(1) << 63;
+
+constexpr ClassMask classMask(ClassID id) {
+    return uint32_t(id) < 63 ? ClassMask(1) << uint32_t(id) : OverflowClassMask;
+}
+
 class ClassDictionary {
 private:
     ClassDictionary();
@@ -0,0 +1,178 @@
+#include <mbgl/style/compiled_filter.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace mbgl {
+namespace style {
+
+CompiledFilter::Operand::Operand(const Value& value_)
+    : value(value_) {
+    if (value.is<std::string>()) {
+        kind = Kind::String;
+    } else if (value.is<bool>()) {
+        kind = Kind::Bool;
+    } else if (value.is<uint64_t>()) {
+        kind = Kind::Number;
+        number = double(value.get<uint64_t>());
+    } else if (value.is<int64_t>()) {
+        kind = Kind::Number;
+        number = double(value.get<int64_t>());
+    } else if (value.is<double>()) {
+        kind = Kind::Number;
+        number = value.get<double>();
+    } else {
+        // Null and nested values never compare equal; they aren't allowed by the style specification.
+        kind = Kind::Other;
+    }
+}
+
+CompiledFilter::Set::Set(const std::vector<Value>& values, std::shared_ptr<const FilterValueSet> lookup_)
+    : lookup(lookup_ ? std::move(lookup_) : std::make_shared<const FilterValueSet>(values)) {
+    if (!lookup->isExact()) {
+        for (const auto& value : values) {
+            operands.emplace_back(value);
+        }
+    }
+}
+
+class CompiledFilter::Compiler {
+public:
+    CompiledFilter& compiled;
+
+    void operator()(const NullFilter&) {
+        emit(Op::True, 0, 0);
+    }
+
+    void operator()(const EqualsFilter& filter) { compare(Op::Equals, filter); }
+    void operator()(const NotEqualsFilter& filter) { compare(Op::NotEquals, filter); }
+    void operator()(const LessThanFilter& filter) { compare(Op::LessThan, filter); }
+    void operator()(const LessThanEqualsFilter& filter) { compare(Op::LessThanEquals, filter); }
+    void operator()(const GreaterThanFilter& filter) { compare(Op::GreaterThan, filter); }
+    void operator()(const GreaterThanEqualsFilter& filter) { compare(Op::GreaterThanEquals, filter); }
+
+    void operator()(const InFilter& filter) { contains(Op::In, filter); }
+    void operator()(const NotInFilter& filter) { contains(Op::NotIn, filter); }
+
+    void operator()(const AnyFilter& filter) { combine(Op::Any, filter.filters); }
+    void operator()(const AllFilter& filter) { combine(Op::All, filter.filters); }
+    void operator()(const NoneFilter& filter) { combine(Op::None, filter.filters); }
+
+    void operator()(const HasFilter& filter) {
+        emit(Op::Has, key(filter.key), 0);
+    }
+
+    void operator()(const NotHasFilter& filter) {
+        emit(Op::NotHas, key(filter.key), 0);
+    }
+
+private:
+    std::size_t emit(Op op, uint32_t key_, uint32_t operand) {
+        compiled.program.push_back({ op, key_, operand, 1 });
+        return compiled.program.size() - 1;
+    }
+
+    uint32_t key(const std::string& name) {
+        if (name == "$type") {
+            return TypeKey;
+        } else if (name == "$id") {
+            return IDKey;
+        }
+        auto& keys = compiled.keys;
+        auto it = std::find(keys.begin(), keys.end(), name);
+        if (it == keys.end()) {
+            it = keys.insert(keys.end(), name);
+        }
+        return uint32_t(it - keys.begin());
+    }
+
+    template <class T>
+    void compare(Op op, const T& filter) {
+        compiled.operands.emplace_back(filter.value);
+        emit(op, key(filter.key), uint32_t(compiled.operands.size() - 1));
+    }
+
+    template <class T>
+    void contains(Op op, const T& filter) {
+        compiled.sets.emplace_back(filter.values, filter.valueSet);
+        emit(op, key(filter.key), uint32_t(compiled.sets.size() - 1));
+    }
+
+    void combine(Op op, const std::vector<Filter>& filters) {
+        const std::size_t index = emit(op, uint32_t(filters.size()), 0);
+        for (const auto& filter : filters) {
+            Filter::visit(filter, *this);
+        }
+        compiled.program[index].length = uint32_t(compiled.program.size() - index);
+    }
+};
+
+CompiledFilter::CompiledFilter(const Filter& filter) {
+    Filter::visit(filter, Compiler { *this });
+}
+
+template <class Compare>
+bool CompiledFilter::compare(const Value& actual, const Operand& operand, const Compare& op) {
+    switch (operand.kind) {
+    case Operand::Kind::String:
+        return actual.is<std::string>() && op(actual.get<std::string>(), operand.value.get<std::string>());
+    case Operand::Kind::Bool:
+        return actual.is<bool>() && op(actual.get<bool>(), operand.value.get<bool>());
+    case Operand::Kind::Number:
+        // Numbers of the same type compare as that type, and as doubles otherwise.
+        if (actual.is<uint64_t>()) {
+            return operand.value.is<uint64_t>()
+                ? op(actual.get<uint64_t>(), operand.value.get<uint64_t>())
+                : op(double(actual.get<uint64_t>()), operand.number);
+        } else if (actual.is<int64_t>()) {
+            return operand.value.is<int64_t>()
+                ? op(actual.get<int64_t>(), operand.value.get<int64_t>())
+                : op(double(actual.get<int64_t>()), operand.number);
+        } else if (actual.is<double>()) {
+            return op(actual.get<double>(), operand.number);
+        }
+        return false;
+    case Operand::Kind::Other:
+        return false;
+    }
+    return false;
+}
+
+bool CompiledFilter::contains(const Value& actual, const Set& set) {
+    if (set.lookup->isExact()) {
+        return set.lookup->contains(actual);
+    }
+    return std::any_of(set.operands.begin(), set.operands.end(), [&] (const Operand& operand) {
+        return compare(actual, operand, std::equal_to<>());
+    });
+}
+
+bool CompiledFilter::test(const Instruction& instruction, const optional<Value>& actual) const {
+    switch (instruction.op) {
+    case Op::Equals:
+        return actual && compare(*actual, operands[instruction.operand], std::equal_to<>());
+    case Op::NotEquals:
+        return !actual || !compare(*actual, operands[instruction.operand], std::equal_to<>());
+    case Op::LessThan:
+        return actual && compare(*actual, operands[instruction.operand], std::less<>());
+    case Op::LessThanEquals:
+        return actual && compare(*actual, operands[instruction.operand], std::less_equal<>());
+    case Op::GreaterThan:
+        return actual && compare(*actual, operands[instruction.operand], std::greater<>());
+    case Op::GreaterThanEquals:
+        return actual && compare(*actual, operands[instruction.operand], std::greater_equal<>());
+    case Op::In:
+        return actual && contains(*actual, sets[instruction.operand]);
+    case Op::NotIn:
+        return !actual || !contains(*actual, sets[instruction.operand]);
+    case Op::Has:
+        return bool(actual);
+    case Op::NotHas:
+        return !actual;
+    default:
+        return true;
+    }
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+   A `Filter` compiled for evaluating it for many features, e.g. all features of a tile's layer.
+   It's a flat program rather than a tree of variants. The property keys are numbered, so that
+   callers can resolve them once instead of for every feature. The values compared with are typed
+   up front, and the values of `in` filters are sorted for binary searches.
+
+       CompiledFilter compiled(filter);
+       for (const auto& feature : features) {
+           if (compiled(feature.getType(), feature.getID(), [&] (std::size_t key) {
+                   return feature.getValue(compiled.getKeys()[key]);
+               })) {
+               // matches the filter
+           }
+       }
+
+   It matches the same features as `Filter::operator()`.
+*/
+class CompiledFilter {
+public:
+    explicit CompiledFilter(const Filter&);
+
+    // The property keys that the filter looks up; the property accessor is given their index.
+    const std::vector<std::string>& getKeys() const { return keys; }
+
+    template <class PropertyAccessor>
+    bool operator()(FeatureType type,
+                    const optional<FeatureIdentifier>& id,
+                    const PropertyAccessor& accessor) const {
+        std::size_t pc = 0;
+        return evaluate(pc, type, id, accessor);
+    }
+
+private:
+    enum class Op : uint8_t {
+        True,
+        Equals,
+        NotEquals,
+        LessThan,
+        LessThanEquals,
+        GreaterThan,
+        GreaterThanEquals,
+        In,
+        NotIn,
+        Has,
+        NotHas,
+        Any,
+        All,
+        None,
+    };
+
+    // A value to compare with, and the type it's compared as.
+    struct Operand {
+        enum class Kind : uint8_t { String, Bool, Number, Other };
+
+        explicit Operand(const Value&);
+
+        Kind kind;
+        Value value;
+        double number = 0;
+    };
+
+    // The values of an `in` filter, and the values one by one where its lookup isn't exact.
+    struct Set {
+        explicit Set(const std::vector<Value>&, std::shared_ptr<const FilterValueSet>);
+
+        std::shared_ptr<const FilterValueSet> lookup;
+        std::vector<Operand> operands;
+    };
+
+    struct Instruction {
+        Op op;
+        // The index of the key for comparisons, or the number of operands for Any, All and None.
+        uint32_t key;
+        // The index of the operand or set.
+        uint32_t operand;
+        // The number of instructions this one spans, including the ones of its operands.
+        uint32_t length;
+    };
+
+    static constexpr uint32_t TypeKey = UINT32_MAX;
+    static constexpr uint32_t IDKey = UINT32_MAX - 1;
+
+    class Compiler;
+
+    template <class PropertyAccessor>
+    bool evaluate(std::size_t& pc,
+                  FeatureType type,
+                  const optional<FeatureIdentifier>& id,
+                  const PropertyAccessor& accessor) const {
+        const Instruction& instruction = program[pc];
+        const std::size_t end = pc + instruction.length;
+        bool result = true;
+
+        switch (instruction.op) {
+        case Op::True:
+            break;
+        case Op::Equals:
+        case Op::NotEquals:
+        case Op::LessThan:
+        case Op::LessThanEquals:
+        case Op::GreaterThan:
+        case Op::GreaterThanEquals:
+        case Op::In:
+        case Op::NotIn:
+        case Op::Has:
+        case Op::NotHas:
+            result = test(instruction, getValue(instruction.key, type, id, accessor));
+            break;
+        case Op::Any:
+        case Op::All:
+        case Op::None: {
+            // Any is true once an operand is, All false once an operand isn't; None is !Any.
+            const bool stop = instruction.op != Op::All;
+            result = !stop;
+            ++pc;
+            for (uint32_t i = 0; i < instruction.key; ++i) {
+                if (evaluate(pc, type, id, accessor) == stop) {
+                    result = stop;
+                    break;
+                }
+            }
+            if (instruction.op == Op::None) {
+                result = !result;
+            }
+            break;
+        }
+        }
+
+        pc = end;
+        return result;
+    }
+
+    template <class PropertyAccessor>
+    static optional<Value> getValue(uint32_t key,
+                                    FeatureType type,
+                                    const optional<FeatureIdentifier>& id,
+                                    const PropertyAccessor& accessor) {
+        if (key == TypeKey) {
+            return optional<Value>(uint64_t(type));
+        } else if (key == IDKey) {
+            if (!id) {
+                return {};
+            }
+            return FeatureIdentifier::visit(*id, [] (auto value) {
+                return Value(std::move(value));
+            });
+        } else {
+            return accessor(std::size_t(key));
+        }
+    }
+
+    bool test(const Instruction&, const optional<Value>&) const;
+
+    template <class Compare>
+    static bool compare(const Value&, const Operand&, const Compare&);
+    static bool contains(const Value&, const Set&);
+
+    std::vector<Instruction> program;
+    std::vector<std::string> keys;
+    std::vector<Operand> operands;
+    std::vector<Set> sets;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,57 @@
+#include <mbgl/style/feature_states.hpp>
+
+#include <functional>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+struct ToNumber {
+    double operator()(uint64_t value) const { return double(value); }
+    double operator()(int64_t value) const { return double(value); }
+    double operator()(double value) const { return value; }
+    double operator()(const std::string&) const { return 0.0; }
+};
+
+} // namespace
+
+FeatureStates::Key::Key(const FeatureIdentifier& id)
+    : isString(id.is<std::string>()),
+      number(FeatureIdentifier::visit(id, ToNumber())),
+      string(isString ? id.get<std::string>() : std::string()) {
+}
+
+std::size_t FeatureStates::KeyHash::operator()(const Key& key) const {
+    return key.isString ? std::hash<std::string>()(key.string) : std::hash<double>()(key.number);
+}
+
+bool FeatureStates::set(const FeatureIdentifier& id, const optional<Color>& color) {
+    const Key key(id);
+    auto it = states.find(key);
+    if (!color) {
+        if (it == states.end()) {
+            return false;
+        }
+        states.erase(it);
+    } else if (it == states.end()) {
+        states.emplace(key, *color);
+    } else if (it->second == *color) {
+        return false;
+    } else {
+        it->second = *color;
+    }
+    version++;
+    return true;
+}
+
+optional<Color> FeatureStates::get(const FeatureIdentifier& id) const {
+    auto it = states.find(Key(id));
+    if (it == states.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+} // namespace style
+} // namespace mbgl
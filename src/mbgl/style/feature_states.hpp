@@ -0,0 +1,49 @@
+#pragma once
+
+#include <mbgl/util/feature.hpp>
+#include <mbgl/util/color.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+
+// The states of the features of a source, set with Map::setFeatureState(). A feature's state is
+// a color that fill layers with feature state colors draw it in. Every change bumps the version,
+// so that buckets know when to update the textures that their shaders read the states from.
+class FeatureStates {
+public:
+    // Returns whether the state of the feature changed. Unsetting the color resets the state.
+    bool set(const FeatureIdentifier&, const optional<Color>&);
+    optional<Color> get(const FeatureIdentifier&) const;
+
+    bool empty() const { return states.empty(); }
+    uint64_t getVersion() const { return version; }
+
+private:
+    // Identifiers are compared by value, so that 5, 5u and 5.0 name the same feature.
+    struct Key {
+        explicit Key(const FeatureIdentifier&);
+
+        bool isString;
+        double number;
+        std::string string;
+
+        bool operator==(const Key& other) const {
+            return isString == other.isString && number == other.number && string == other.string;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    std::unordered_map<Key, Color, KeyHash> states;
+    uint64_t version = 1;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,57 @@
+#include <mbgl/style/filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+// Doubles represent all integers of a smaller magnitude exactly.
+constexpr double EXACT_INTEGER_LIMIT = 9007199254740992.0; // 2^53
+
+} // namespace
+
+FilterValueSet::FilterValueSet(const std::vector<Value>& values) {
+    const auto addNumber = [&] (double number) {
+        exact = exact && std::abs(number) < EXACT_INTEGER_LIMIT;
+        numbers.push_back(number);
+    };
+
+    for (const auto& value : values) {
+        if (value.is<std::string>()) {
+            strings.push_back(value.get<std::string>());
+        } else if (value.is<bool>()) {
+            (value.get<bool>() ? hasTrue : hasFalse) = true;
+        } else if (value.is<uint64_t>()) {
+            addNumber(double(value.get<uint64_t>()));
+        } else if (value.is<int64_t>()) {
+            addNumber(double(value.get<int64_t>()));
+        } else if (value.is<double>()) {
+            addNumber(value.get<double>());
+        }
+        // Null and nested values never compare equal; they aren't allowed by the style specification.
+    }
+
+    std::sort(strings.begin(), strings.end());
+    std::sort(numbers.begin(), numbers.end());
+}
+
+bool FilterValueSet::contains(const Value& value) const {
+    if (value.is<std::string>()) {
+        return std::binary_search(strings.begin(), strings.end(), value.get<std::string>());
+    } else if (value.is<bool>()) {
+        return value.get<bool>() ? hasTrue : hasFalse;
+    } else if (value.is<uint64_t>()) {
+        return std::binary_search(numbers.begin(), numbers.end(), double(value.get<uint64_t>()));
+    } else if (value.is<int64_t>()) {
+        return std::binary_search(numbers.begin(), numbers.end(), double(value.get<int64_t>()));
+    } else if (value.is<double>()) {
+        return std::binary_search(numbers.begin(), numbers.end(), value.get<double>());
+    }
+    return false;
+}
+
+} // namespace style
+} // namespace mbgl
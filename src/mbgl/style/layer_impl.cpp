@@ -17,6 +17,10 @@ const std::string& Layer::Impl::bucketName() const {
     return ref.empty() ? id : ref;
 }
 
+bool Layer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
+    return sourceLayer != other.sourceLayer || filter != other.filter;
+}
+
 bool Layer::Impl::hasRenderPass(RenderPass pass) const {
     return bool(passes & pass);
 }
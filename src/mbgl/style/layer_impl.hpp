@@ -59,8 +59,16 @@ public:
     // Returns true if any paint properties have active transitions.
     virtual bool recalculate(const CalculationParameters&) = 0;
 
+    // Whether recalculating would yield the same paint properties as the last time, at any zoom
+    // level and time, so that it can be skipped until the layer is cascaded again.
+    virtual bool hasConstantProperties() const { return false; }
+
     virtual std::unique_ptr<Bucket> createBucket(BucketParameters&) const = 0;
 
+    // Checks whether the bucket created from this layer could differ from the one created from
+    // `other`, a layer of the same type, for the same tile. Paint properties never make a difference.
+    virtual bool hasLayoutDifference(const Layer::Impl& other) const;
+
     // Checks whether this layer needs to be rendered in the given render pass.
     bool hasRenderPass(RenderPass) const;
 
@@ -13,6 +13,8 @@ public:
     virtual void onLayerVisibilityChanged(Layer&) {}
     virtual void onLayerPaintPropertyChanged(Layer&) {}
     virtual void onLayerLayoutPropertyChanged(Layer&) {}
+    // Data of the layer itself changed, which is rendered as is, e.g. a dynamic point moved.
+    virtual void onLayerDataChanged(Layer&) {}
 };
 
 } // namespace style
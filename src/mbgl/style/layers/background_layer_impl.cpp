@@ -16,6 +16,10 @@ bool BackgroundLayer::Impl::recalculate(const CalculationParameters& parameters)
     return hasTransitions;
 }
 
+bool BackgroundLayer::Impl::hasConstantProperties() const {
+    return paint.isConstant();
+}
+
 std::unique_ptr<Bucket> BackgroundLayer::Impl::createBucket(BucketParameters&) const {
     return nullptr;
 }
@@ -21,5 +21,11 @@ bool BackgroundPaintProperties::recalculate(const CalculationParameters& paramet
     return hasTransitions;
 }
 
+bool BackgroundPaintProperties::isConstant() const {
+    return backgroundColor.isConstant()
+        && backgroundPattern.isConstant()
+        && backgroundOpacity.isConstant();
+}
+
 } // namespace style
 } // namespace mbgl
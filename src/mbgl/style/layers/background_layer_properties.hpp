@@ -17,6 +17,9 @@ public:
     void cascade(const CascadeParameters&);
     bool recalculate(const CalculationParameters&);
 
+    // Whether recalculating would yield the same values again; see PaintProperty::isConstant().
+    bool isConstant() const;
+
     PaintProperty<Color> backgroundColor { Color::black() };
     PaintProperty<std::string, CrossFadedPropertyEvaluator> backgroundPattern { "" };
     PaintProperty<float> backgroundOpacity { 1 };
@@ -88,7 +88,11 @@ PropertyValue<Color> CircleLayer::getCircleColor(const optional<std::string>& kl
 void CircleLayer::setCircleColor(PropertyValue<Color> value, const optional<std::string>& klass) {
     if (value == getCircleColor(klass))
         return;
+    // Buckets evaluate property functions, so they need to be laid out again.
+    const bool relayout = value.isPropertyFunction() || getCircleColor(klass).isPropertyFunction();
     impl->paint.circleColor.set(value, klass);
+    if (relayout)
+        impl->observer->onLayerLayoutPropertyChanged(*this);
     impl->observer->onLayerPaintPropertyChanged(*this);
 }
 
@@ -15,20 +15,49 @@ void CircleLayer::Impl::cascade(const CascadeParameters& parameters) {
 bool CircleLayer::Impl::recalculate(const CalculationParameters& parameters) {
     bool hasTransitions = paint.recalculate(parameters);
 
-    passes = (paint.circleRadius > 0 && paint.circleColor.value.a > 0 && paint.circleOpacity > 0)
+    passes = (paint.circleRadius > 0 && (paint.circleColor.isDataDriven() || paint.circleColor.value.a > 0) &&
+              paint.circleOpacity > 0)
         ? RenderPass::Translucent : RenderPass::None;
 
     return hasTransitions;
 }
 
+bool CircleLayer::Impl::hasConstantProperties() const {
+    return paint.isConstant();
+}
+
+bool CircleLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
+    // Buckets hold the values of a data-driven color.
+    const auto& color = paint.circleColor.get({});
+    const auto& otherColor = static_cast<const CircleLayer::Impl&>(other).paint.circleColor.get({});
+    return Layer::Impl::hasLayoutDifference(other)
+        || ((color.isPropertyFunction() || otherColor.isPropertyFunction()) && color != otherColor);
+}
+
 std::unique_ptr<Bucket> CircleLayer::Impl::createBucket(BucketParameters& parameters) const {
     auto bucket = std::make_unique<CircleBucket>(parameters.mode);
 
+    // A data-driven color is evaluated once for each feature here, rather than for each circle.
+    const PropertyValue<Color>& circleColor = paint.circleColor.get({});
+    const Color defaultColor = circleColor.isPropertyFunction()
+        ? circleColor.asPropertyFunction().getDefaultValue().value_or(CircleLayer::getDefaultCircleColor().asConstant())
+        : Color();
+
     auto& name = bucketName();
     parameters.eachFilteredFeature(filter, [&] (const auto& feature, std::size_t index, const std::string& layerName) {
-        auto geometries = feature.getGeometries();
-        bucket->addGeometry(geometries);
-        parameters.featureIndex.insert(geometries, index, layerName, name);
+        optional<Color> color;
+        if (circleColor.isPropertyFunction()) {
+            const auto& function = circleColor.asPropertyFunction();
+            color = function.evaluate(feature.getValue(function.getProperty())).value_or(defaultColor);
+        }
+        feature.eachGeometry([&] (const GeometryCoordinates& line) {
+            if (color) {
+                bucket->addGeometry(line, *color);
+            } else {
+                bucket->addGeometry(line);
+            }
+            parameters.featureIndex.insert(line, index, layerName, name);
+        });
     });
 
     return std::move(bucket);
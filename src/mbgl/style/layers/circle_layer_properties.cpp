@@ -29,5 +29,15 @@ bool CirclePaintProperties::recalculate(const CalculationParameters& parameters)
     return hasTransitions;
 }
 
+bool CirclePaintProperties::isConstant() const {
+    return circleRadius.isConstant()
+        && circleColor.isConstant()
+        && circleBlur.isConstant()
+        && circleOpacity.isConstant()
+        && circleTranslate.isConstant()
+        && circleTranslateAnchor.isConstant()
+        && circlePitchScale.isConstant();
+}
+
 } // namespace style
 } // namespace mbgl
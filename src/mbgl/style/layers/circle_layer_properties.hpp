@@ -17,6 +17,9 @@ public:
     void cascade(const CascadeParameters&);
     bool recalculate(const CalculationParameters&);
 
+    // Whether recalculating would yield the same values again; see PaintProperty::isConstant().
+    bool isConstant() const;
+
     PaintProperty<float> circleRadius { 5 };
     PaintProperty<Color> circleColor { Color::black() };
     PaintProperty<float> circleBlur { 0 };
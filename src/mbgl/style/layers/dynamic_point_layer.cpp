@@ -0,0 +1,95 @@
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
+#include <mbgl/style/layers/dynamic_point_layer_impl.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+Point<double> project(const LatLng& latLng) {
+    return Projection::project(latLng, 1) / double(util::tileSize);
+}
+
+} // namespace
+
+DynamicPointLayer::DynamicPointLayer(const std::string& layerID)
+    : Layer(Type::DynamicPoint, std::make_unique<Impl>())
+    , impl(static_cast<Impl*>(baseImpl.get())) {
+    impl->id = layerID;
+}
+
+DynamicPointLayer::DynamicPointLayer(const Impl& other)
+    : Layer(Type::DynamicPoint, std::make_unique<Impl>(other))
+    , impl(static_cast<Impl*>(baseImpl.get())) {
+}
+
+DynamicPointLayer::~DynamicPointLayer() = default;
+
+void DynamicPointLayer::setPoints(const std::vector<LatLng>& points) {
+    const bool resized = points.size() != impl->points.size();
+
+    impl->points.clear();
+    impl->points.reserve(points.size());
+    for (const auto& point : points) {
+        impl->points.push_back(project(point));
+    }
+
+    if (resized) {
+        impl->generation++;
+    } else {
+        impl->markMoved(0, points.size());
+    }
+    impl->observer->onLayerDataChanged(*this);
+}
+
+std::size_t DynamicPointLayer::getPointCount() const {
+    return impl->points.size();
+}
+
+void DynamicPointLayer::setPoint(std::size_t index, const LatLng& point) {
+    impl->points.at(index) = project(point);
+    impl->markMoved(index, index + 1);
+    impl->observer->onLayerDataChanged(*this);
+}
+
+LatLng DynamicPointLayer::getPoint(std::size_t index) const {
+    return Projection::unproject(impl->points.at(index) * double(util::tileSize), 1);
+}
+
+void DynamicPointLayer::setCircleRadius(float radius) {
+    if (radius == impl->circleRadius)
+        return;
+    impl->circleRadius = radius;
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+float DynamicPointLayer::getCircleRadius() const {
+    return impl->circleRadius;
+}
+
+void DynamicPointLayer::setCircleColor(Color color) {
+    if (color == impl->circleColor)
+        return;
+    impl->circleColor = color;
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+Color DynamicPointLayer::getCircleColor() const {
+    return impl->circleColor;
+}
+
+void DynamicPointLayer::setCircleOpacity(float opacity) {
+    if (opacity == impl->circleOpacity)
+        return;
+    impl->circleOpacity = opacity;
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+float DynamicPointLayer::getCircleOpacity() const {
+    return impl->circleOpacity;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,55 @@
+#include <mbgl/style/layers/dynamic_point_layer_impl.hpp>
+#include <mbgl/renderer/bucket.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace mbgl {
+namespace style {
+
+static std::atomic<uint64_t> nextSerial { 0 };
+
+DynamicPointLayer::Impl::Impl()
+    : serial(++nextSerial) {
+}
+
+DynamicPointLayer::Impl::Impl(const Impl& other)
+    : Layer::Impl(other),
+      points(other.points),
+      circleRadius(other.circleRadius),
+      circleColor(other.circleColor),
+      circleOpacity(other.circleOpacity),
+      serial(++nextSerial) {
+}
+
+void DynamicPointLayer::Impl::markMoved(std::size_t begin, std::size_t end) {
+    if (movedBegin == movedEnd) {
+        movedBegin = begin;
+        movedEnd = end;
+    } else {
+        movedBegin = std::min(movedBegin, begin);
+        movedEnd = std::max(movedEnd, end);
+    }
+}
+
+std::unique_ptr<Layer> DynamicPointLayer::Impl::clone() const {
+    return std::make_unique<DynamicPointLayer>(*this);
+}
+
+std::unique_ptr<Layer> DynamicPointLayer::Impl::cloneRef(const std::string&) const {
+    assert(false);
+    return std::make_unique<DynamicPointLayer>(*this);
+}
+
+bool DynamicPointLayer::Impl::recalculate(const CalculationParameters&) {
+    passes = circleOpacity > 0 && circleRadius > 0 ? RenderPass::Translucent : RenderPass::None;
+    return false;
+}
+
+std::unique_ptr<Bucket> DynamicPointLayer::Impl::createBucket(BucketParameters&) const {
+    return nullptr;
+}
+
+} // namespace style
+} // namespace mbgl
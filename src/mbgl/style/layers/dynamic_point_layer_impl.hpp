@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+class DynamicPointLayer::Impl : public Layer::Impl {
+public:
+    Impl();
+    Impl(const Impl&);
+
+    // Marks the points from `begin` up to `end` as moved.
+    void markMoved(std::size_t begin, std::size_t end);
+
+    // In world coordinates, from 0 to 1.
+    std::vector<Point<double>> points;
+
+    float circleRadius = 5;
+    Color circleColor = Color::black();
+    float circleOpacity = 1;
+
+    // Identifies the layer's vertex buffer in the painter, which outlives neither the layer nor
+    // its copies.
+    const uint64_t serial;
+
+    // Changes whenever the number of points does, so that the painter uploads all of them to a
+    // new buffer.
+    uint64_t generation = 0;
+
+    // The points that moved since the painter last uploaded them, which it resets.
+    mutable std::size_t movedBegin = 0;
+    mutable std::size_t movedEnd = 0;
+
+private:
+    std::unique_ptr<Layer> clone() const override;
+    std::unique_ptr<Layer> cloneRef(const std::string& id) const override;
+
+    void cascade(const CascadeParameters&) final {}
+    bool recalculate(const CalculationParameters&) final;
+
+    std::unique_ptr<Bucket> createBucket(BucketParameters&) const final;
+};
+
+} // namespace style
+} // namespace mbgl
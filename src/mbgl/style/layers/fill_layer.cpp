@@ -57,6 +57,79 @@ const Filter& FillLayer::getFilter() const {
     return impl->filter;
 }
 
+// Feature categories
+
+void FillLayer::setFeatureCategories(const std::string& property, const std::vector<Value>& values) {
+    if (property == impl->featureCategoryProperty && values == impl->featureCategoryValues)
+        return;
+    impl->featureCategoryProperty = property;
+    impl->featureCategoryValues = values;
+    impl->observer->onLayerLayoutPropertyChanged(*this);
+}
+
+const std::string& FillLayer::getFeatureCategoryProperty() const {
+    return impl->featureCategoryProperty;
+}
+
+const std::vector<Value>& FillLayer::getFeatureCategoryValues() const {
+    return impl->featureCategoryValues;
+}
+
+void FillLayer::setVisibleFeatureCategories(uint32_t categories) {
+    if (categories == impl->visibleFeatureCategories)
+        return;
+    impl->visibleFeatureCategories = categories;
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+uint32_t FillLayer::getVisibleFeatureCategories() const {
+    return impl->visibleFeatureCategories;
+}
+
+void FillLayer::setHighlightedFeatureCategories(uint32_t categories) {
+    if (categories == impl->highlightedFeatureCategories)
+        return;
+    impl->highlightedFeatureCategories = categories;
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+uint32_t FillLayer::getHighlightedFeatureCategories() const {
+    return impl->highlightedFeatureCategories;
+}
+
+void FillLayer::setFeatureHighlightColor(const Color& color) {
+    if (color == impl->featureHighlightColor)
+        return;
+    impl->featureHighlightColor = color;
+    impl->observer->onLayerPaintPropertyChanged(*this);
+}
+
+Color FillLayer::getFeatureHighlightColor() const {
+    return impl->featureHighlightColor;
+}
+
+void FillLayer::setFeatureStateColors(bool enabled) {
+    if (enabled == impl->featureStateColors)
+        return;
+    impl->featureStateColors = enabled;
+    impl->observer->onLayerLayoutPropertyChanged(*this);
+}
+
+bool FillLayer::getFeatureStateColors() const {
+    return impl->featureStateColors;
+}
+
+void FillLayer::setPickable(bool pickable) {
+    if (pickable == impl->pickable)
+        return;
+    impl->pickable = pickable;
+    impl->observer->onLayerLayoutPropertyChanged(*this);
+}
+
+bool FillLayer::getPickable() const {
+    return impl->pickable;
+}
+
 // Layout properties
 
 
@@ -103,7 +176,11 @@ PropertyValue<Color> FillLayer::getFillColor(const optional<std::string>& klass)
 void FillLayer::setFillColor(PropertyValue<Color> value, const optional<std::string>& klass) {
     if (value == getFillColor(klass))
         return;
+    // Buckets evaluate property functions, so they need to be laid out again.
+    const bool relayout = value.isPropertyFunction() || getFillColor(klass).isPropertyFunction();
     impl->paint.fillColor.set(value, klass);
+    if (relayout)
+        impl->observer->onLayerLayoutPropertyChanged(*this);
     impl->observer->onLayerPaintPropertyChanged(*this);
 }
 
@@ -1,6 +1,7 @@
 #include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/shader/category_vertex.hpp>
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/intersection_tests.hpp>
@@ -21,7 +22,11 @@ bool FillLayer::Impl::recalculate(const CalculationParameters& parameters) {
         passes |= RenderPass::Translucent;
     }
 
-    if (!paint.fillPattern.value.from.empty() || (paint.fillColor.value.a * paint.fillOpacity) < 1.0f) {
+    // Data-driven colors and feature states may be translucent for any of the features, and
+    // categories are only filtered by the translucent pass.
+    if (!paint.fillPattern.value.from.empty() || paint.fillColor.isDataDriven() || hasFeatureCategories() ||
+        hasFeatureStateColors() ||
+        (paint.fillColor.value.a * paint.fillOpacity) < 1.0f) {
         passes |= RenderPass::Translucent;
     } else {
         passes |= RenderPass::Opaque;
@@ -30,13 +35,83 @@ bool FillLayer::Impl::recalculate(const CalculationParameters& parameters) {
     return hasTransitions;
 }
 
+bool FillLayer::Impl::hasConstantProperties() const {
+    return paint.isConstant();
+}
+
+bool FillLayer::Impl::hasFeatureCategories() const {
+    return !featureCategoryProperty.empty() && !featureCategoryValues.empty()
+        && paint.fillPattern.value.from.empty() && !paint.fillColor.get({}).isPropertyFunction();
+}
+
+bool FillLayer::Impl::hasFeatureStateColors() const {
+    return featureStateColors && paint.fillPattern.value.from.empty()
+        && !paint.fillColor.get({}).isPropertyFunction() && !hasFeatureCategories();
+}
+
+bool FillLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
+    // Buckets hold the values of a data-driven color and the categories of the features.
+    const auto& otherFill = static_cast<const FillLayer::Impl&>(other);
+    const auto& color = paint.fillColor.get({});
+    const auto& otherColor = otherFill.paint.fillColor.get({});
+    return Layer::Impl::hasLayoutDifference(other)
+        || ((color.isPropertyFunction() || otherColor.isPropertyFunction()) && color != otherColor)
+        || hasFeatureCategories() != otherFill.hasFeatureCategories()
+        || featureCategoryProperty != otherFill.featureCategoryProperty
+        || featureCategoryValues != otherFill.featureCategoryValues
+        || hasFeatureStateColors() != otherFill.hasFeatureStateColors()
+        || pickable != otherFill.pickable;
+}
+
 std::unique_ptr<Bucket> FillLayer::Impl::createBucket(BucketParameters& parameters) const {
     auto bucket = std::make_unique<FillBucket>();
 
+    // A data-driven color is evaluated once for each feature here, rather than for each vertex.
+    const PropertyValue<Color>& fillColor = paint.fillColor.get({});
+    const Color defaultColor = fillColor.isPropertyFunction()
+        ? fillColor.asPropertyFunction().getDefaultValue().value_or(FillLayer::getDefaultFillColor().asConstant())
+        : Color();
+
+    // The category of a feature is the index of its value, looked up like a categorical function.
+    optional<PropertyFunction<uint8_t>> categories;
+    if (hasFeatureCategories()) {
+        std::vector<std::pair<Value, uint8_t>> stops;
+        for (std::size_t i = 0; i < featureCategoryValues.size() && i < MaxFeatureCategories; ++i) {
+            stops.emplace_back(featureCategoryValues[i], static_cast<uint8_t>(i));
+        }
+        categories = PropertyFunction<uint8_t>(featureCategoryProperty, std::move(stops), NoFeatureCategory);
+    }
+
+    const bool stateColors = hasFeatureStateColors();
+
+    // Streamed into one collection that's reused for every feature, so that shared decoded
+    // features aren't copied into a new collection each, and its rings keep their capacity.
+    GeometryCollection geometries;
+
     auto& name = bucketName();
     parameters.eachFilteredFeature(filter, [&] (const auto& feature, std::size_t index, const std::string& layerName) {
-        auto geometries = feature.getGeometries();
-        bucket->addGeometry(geometries);
+        std::size_t ringCount = 0;
+        feature.eachGeometry([&] (const GeometryCoordinates& ring) {
+            if (ringCount == geometries.size()) {
+                geometries.emplace_back();
+            }
+            geometries[ringCount++].assign(ring.begin(), ring.end());
+        });
+        geometries.resize(ringCount);
+
+        if (fillColor.isPropertyFunction()) {
+            const auto& function = fillColor.asPropertyFunction();
+            bucket->addGeometry(geometries, function.evaluate(feature.getValue(function.getProperty())).value_or(defaultColor));
+        } else if (categories) {
+            bucket->addGeometry(geometries, categories->evaluate(feature.getValue(featureCategoryProperty)).value_or(NoFeatureCategory));
+        } else if (stateColors) {
+            bucket->addGeometry(geometries, feature.getID());
+        } else {
+            bucket->addGeometry(geometries);
+        }
+        if (pickable) {
+            bucket->addPickingFeature(index, layerName);
+        }
         parameters.featureIndex.insert(geometries, index, layerName, name);
     });
 
@@ -14,8 +14,10 @@ public:
 
     void cascade(const CascadeParameters&) override;
     bool recalculate(const CalculationParameters&) override;
+    bool hasConstantProperties() const override;
 
     std::unique_ptr<Bucket> createBucket(BucketParameters&) const override;
+    bool hasLayoutDifference(const Layer::Impl&) const override;
 
     float getQueryRadius() const override;
     bool queryIntersectsGeometry(
@@ -25,6 +27,23 @@ public:
             const float pixelsToTileUnits) const override;
 
     FillPaintProperties paint;
+
+    // Feature categories are assigned at layout time and filtered by the fill shaders.
+    std::string featureCategoryProperty;
+    std::vector<Value> featureCategoryValues;
+    uint32_t visibleFeatureCategories = 0xFFFFFFFF;
+    uint32_t highlightedFeatureCategories = 0;
+    Color featureHighlightColor = { 1.0f, 0.0f, 0.0f, 1.0f };
+
+    bool hasFeatureCategories() const;
+
+    // Whether buckets record the features' IDs, for the fill shaders to read their states.
+    bool featureStateColors = false;
+
+    bool hasFeatureStateColors() const;
+
+    // Whether buckets give the features picking IDs, for the picking pass to draw them with.
+    bool pickable = false;
 };
 
 } // namespace style
@@ -29,5 +29,15 @@ bool FillPaintProperties::recalculate(const CalculationParameters& parameters) {
     return hasTransitions;
 }
 
+bool FillPaintProperties::isConstant() const {
+    return fillAntialias.isConstant()
+        && fillOpacity.isConstant()
+        && fillColor.isConstant()
+        && fillOutlineColor.isConstant()
+        && fillTranslate.isConstant()
+        && fillTranslateAnchor.isConstant()
+        && fillPattern.isConstant();
+}
+
 } // namespace style
 } // namespace mbgl
@@ -17,6 +17,9 @@ public:
     void cascade(const CascadeParameters&);
     bool recalculate(const CalculationParameters&);
 
+    // Whether recalculating would yield the same values again; see PaintProperty::isConstant().
+    bool isConstant() const;
+
     PaintProperty<bool> fillAntialias { true };
     PaintProperty<float> fillOpacity { 1 };
     PaintProperty<Color> fillColor { Color::black() };
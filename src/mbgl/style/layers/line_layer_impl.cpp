@@ -27,6 +27,16 @@ bool LineLayer::Impl::recalculate(const CalculationParameters& parameters) {
     return hasTransitions;
 }
 
+bool LineLayer::Impl::hasConstantProperties() const {
+    return paint.isConstant();
+}
+
+bool LineLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
+    const auto& impl = static_cast<const LineLayer::Impl&>(other);
+    return Layer::Impl::hasLayoutDifference(other)
+        || layout != impl.layout;
+}
+
 std::unique_ptr<Bucket> LineLayer::Impl::createBucket(BucketParameters& parameters) const {
     auto bucket = std::make_unique<LineBucket>(parameters.tileID.overscaleFactor());
 
@@ -35,9 +45,10 @@ std::unique_ptr<Bucket> LineLayer::Impl::createBucket(BucketParameters& paramete
 
     auto& name = bucketName();
     parameters.eachFilteredFeature(filter, [&] (const auto& feature, std::size_t index, const std::string& layerName) {
-        auto geometries = feature.getGeometries();
-        bucket->addGeometry(geometries);
-        parameters.featureIndex.insert(geometries, index, layerName, name);
+        feature.eachGeometry([&] (const GeometryCoordinates& line) {
+            bucket->addGeometry(line);
+            parameters.featureIndex.insert(line, index, layerName, name);
+        });
     });
 
     return std::move(bucket);
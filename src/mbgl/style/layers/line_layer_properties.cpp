@@ -12,6 +12,13 @@ void LineLayoutProperties::recalculate(const CalculationParameters& parameters)
     lineRoundLimit.calculate(parameters);
 }
 
+bool LineLayoutProperties::operator==(const LineLayoutProperties& other) const {
+    return lineCap.get() == other.lineCap.get()
+        && lineJoin.get() == other.lineJoin.get()
+        && lineMiterLimit.get() == other.lineMiterLimit.get()
+        && lineRoundLimit.get() == other.lineRoundLimit.get();
+}
+
 void LinePaintProperties::cascade(const CascadeParameters& parameters) {
     lineOpacity.cascade(parameters);
     lineColor.cascade(parameters);
@@ -42,5 +49,18 @@ bool LinePaintProperties::recalculate(const CalculationParameters& parameters) {
     return hasTransitions;
 }
 
+bool LinePaintProperties::isConstant() const {
+    return lineOpacity.isConstant()
+        && lineColor.isConstant()
+        && lineTranslate.isConstant()
+        && lineTranslateAnchor.isConstant()
+        && lineWidth.isConstant()
+        && lineGapWidth.isConstant()
+        && lineOffset.isConstant()
+        && lineBlur.isConstant()
+        && lineDasharray.isConstant()
+        && linePattern.isConstant();
+}
+
 } // namespace style
 } // namespace mbgl
@@ -16,6 +16,10 @@ class LineLayoutProperties {
 public:
     void recalculate(const CalculationParameters&);
 
+    // Compares the specified values of all properties, not what they evaluate to.
+    bool operator==(const LineLayoutProperties&) const;
+    bool operator!=(const LineLayoutProperties& other) const { return !(*this == other); }
+
     LayoutProperty<LineCapType> lineCap { LineCapType::Butt };
     LayoutProperty<LineJoinType> lineJoin { LineJoinType::Miter };
     LayoutProperty<float> lineMiterLimit { 2 };
@@ -27,6 +31,9 @@ public:
     void cascade(const CascadeParameters&);
     bool recalculate(const CalculationParameters&);
 
+    // Whether recalculating would yield the same values again; see PaintProperty::isConstant().
+    bool isConstant() const;
+
     PaintProperty<float> lineOpacity { 1 };
     PaintProperty<Color> lineColor { Color::black() };
     PaintProperty<std::array<float, 2>> lineTranslate { {{ 0, 0 }} };
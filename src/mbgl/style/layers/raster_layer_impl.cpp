@@ -16,6 +16,10 @@ bool RasterLayer::Impl::recalculate(const CalculationParameters& parameters) {
     return hasTransitions;
 }
 
+bool RasterLayer::Impl::hasConstantProperties() const {
+    return paint.isConstant();
+}
+
 std::unique_ptr<Bucket> RasterLayer::Impl::createBucket(BucketParameters&) const {
     return nullptr;
 }
@@ -14,6 +14,7 @@ public:
 
     void cascade(const CascadeParameters&) override;
     bool recalculate(const CalculationParameters&) override;
+    bool hasConstantProperties() const override;
 
     std::unique_ptr<Bucket> createBucket(BucketParameters&) const override;
 
@@ -29,5 +29,15 @@ bool RasterPaintProperties::recalculate(const CalculationParameters& parameters)
     return hasTransitions;
 }
 
+bool RasterPaintProperties::isConstant() const {
+    return rasterOpacity.isConstant()
+        && rasterHueRotate.isConstant()
+        && rasterBrightnessMin.isConstant()
+        && rasterBrightnessMax.isConstant()
+        && rasterSaturation.isConstant()
+        && rasterContrast.isConstant()
+        && rasterFadeDuration.isConstant();
+}
+
 } // namespace style
 } // namespace mbgl
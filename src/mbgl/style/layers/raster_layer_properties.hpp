@@ -17,6 +17,9 @@ public:
     void cascade(const CascadeParameters&);
     bool recalculate(const CalculationParameters&);
 
+    // Whether recalculating would yield the same values again; see PaintProperty::isConstant().
+    bool isConstant() const;
+
     PaintProperty<float> rasterOpacity { 1 };
     PaintProperty<float> rasterHueRotate { 0 };
     PaintProperty<float> rasterBrightnessMin { 0 };
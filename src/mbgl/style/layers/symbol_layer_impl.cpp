@@ -26,6 +26,17 @@ bool SymbolLayer::Impl::recalculate(const CalculationParameters& parameters) {
     return hasTransitions;
 }
 
+bool SymbolLayer::Impl::hasConstantProperties() const {
+    return paint.isConstant() && layout.iconSize.isConstant() && layout.textSize.isConstant();
+}
+
+bool SymbolLayer::Impl::hasLayoutDifference(const Layer::Impl& other) const {
+    const auto& impl = static_cast<const SymbolLayer::Impl&>(other);
+    return Layer::Impl::hasLayoutDifference(other)
+        || layout != impl.layout
+        || spriteAtlas != impl.spriteAtlas;
+}
+
 std::unique_ptr<Bucket> SymbolLayer::Impl::createBucket(BucketParameters&) const {
     assert(false); // Should be calling createLayout() instead.
     return nullptr;
@@ -18,8 +18,10 @@ public:
 
     void cascade(const CascadeParameters&) override;
     bool recalculate(const CalculationParameters&) override;
+    bool hasConstantProperties() const override;
 
     std::unique_ptr<Bucket> createBucket(BucketParameters&) const override;
+    bool hasLayoutDifference(const Layer::Impl&) const override;
     std::unique_ptr<SymbolLayout> createLayout(BucketParameters&) const;
 
     SymbolLayoutProperties layout;
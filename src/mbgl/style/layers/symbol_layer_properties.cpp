@@ -42,6 +42,43 @@ void SymbolLayoutProperties::recalculate(const CalculationParameters& parameters
     textOptional.calculate(parameters);
 }
 
+bool SymbolLayoutProperties::operator==(const SymbolLayoutProperties& other) const {
+    return symbolPlacement.get() == other.symbolPlacement.get()
+        && symbolSpacing.get() == other.symbolSpacing.get()
+        && symbolAvoidEdges.get() == other.symbolAvoidEdges.get()
+        && iconAllowOverlap.get() == other.iconAllowOverlap.get()
+        && iconIgnorePlacement.get() == other.iconIgnorePlacement.get()
+        && iconOptional.get() == other.iconOptional.get()
+        && iconRotationAlignment.get() == other.iconRotationAlignment.get()
+        && iconSize.get() == other.iconSize.get()
+        && iconTextFit.get() == other.iconTextFit.get()
+        && iconTextFitPadding.get() == other.iconTextFitPadding.get()
+        && iconImage.get() == other.iconImage.get()
+        && iconRotate.get() == other.iconRotate.get()
+        && iconPadding.get() == other.iconPadding.get()
+        && iconKeepUpright.get() == other.iconKeepUpright.get()
+        && iconOffset.get() == other.iconOffset.get()
+        && textPitchAlignment.get() == other.textPitchAlignment.get()
+        && textRotationAlignment.get() == other.textRotationAlignment.get()
+        && textField.get() == other.textField.get()
+        && textFont.get() == other.textFont.get()
+        && textSize.get() == other.textSize.get()
+        && textMaxWidth.get() == other.textMaxWidth.get()
+        && textLineHeight.get() == other.textLineHeight.get()
+        && textLetterSpacing.get() == other.textLetterSpacing.get()
+        && textJustify.get() == other.textJustify.get()
+        && textAnchor.get() == other.textAnchor.get()
+        && textMaxAngle.get() == other.textMaxAngle.get()
+        && textRotate.get() == other.textRotate.get()
+        && textPadding.get() == other.textPadding.get()
+        && textKeepUpright.get() == other.textKeepUpright.get()
+        && textTransform.get() == other.textTransform.get()
+        && textOffset.get() == other.textOffset.get()
+        && textAllowOverlap.get() == other.textAllowOverlap.get()
+        && textIgnorePlacement.get() == other.textIgnorePlacement.get()
+        && textOptional.get() == other.textOptional.get();
+}
+
 void SymbolPaintProperties::cascade(const CascadeParameters& parameters) {
     iconOpacity.cascade(parameters);
     iconColor.cascade(parameters);
@@ -80,5 +117,22 @@ bool SymbolPaintProperties::recalculate(const CalculationParameters& parameters)
     return hasTransitions;
 }
 
+bool SymbolPaintProperties::isConstant() const {
+    return iconOpacity.isConstant()
+        && iconColor.isConstant()
+        && iconHaloColor.isConstant()
+        && iconHaloWidth.isConstant()
+        && iconHaloBlur.isConstant()
+        && iconTranslate.isConstant()
+        && iconTranslateAnchor.isConstant()
+        && textOpacity.isConstant()
+        && textColor.isConstant()
+        && textHaloColor.isConstant()
+        && textHaloWidth.isConstant()
+        && textHaloBlur.isConstant()
+        && textTranslate.isConstant()
+        && textTranslateAnchor.isConstant();
+}
+
 } // namespace style
 } // namespace mbgl
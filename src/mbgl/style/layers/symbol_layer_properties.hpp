@@ -16,6 +16,10 @@ class SymbolLayoutProperties {
 public:
     void recalculate(const CalculationParameters&);
 
+    // Compares the specified values of all properties, not what they evaluate to.
+    bool operator==(const SymbolLayoutProperties&) const;
+    bool operator!=(const SymbolLayoutProperties& other) const { return !(*this == other); }
+
     LayoutProperty<SymbolPlacementType> symbolPlacement { SymbolPlacementType::Point };
     LayoutProperty<float> symbolSpacing { 250 };
     LayoutProperty<bool> symbolAvoidEdges { false };
@@ -57,6 +61,9 @@ public:
     void cascade(const CascadeParameters&);
     bool recalculate(const CalculationParameters&);
 
+    // Whether recalculating would yield the same values again; see PaintProperty::isConstant().
+    bool isConstant() const;
+
     PaintProperty<float> iconOpacity { 1 };
     PaintProperty<Color> iconColor { Color::black() };
     PaintProperty<Color> iconHaloColor { {} };
@@ -22,6 +22,7 @@ public:
 
     void set(const PropertyValue<T>& value_) {
         currentValue = value_;
+        calculated = false;
     }
 
     void calculate(const CalculationParameters& parameters) {
@@ -29,6 +30,12 @@ public:
             PropertyEvaluator<T> evaluator(parameters, defaultValue);
             value = PropertyValue<T>::visit(currentValue, evaluator);
         }
+        calculated = true;
+    }
+
+    // Whether calculating the value again would yield the same result, at any zoom level.
+    bool isConstant() const {
+        return calculated && !currentValue.isFunction();
     }
 
     // TODO: remove / privatize
@@ -38,6 +45,7 @@ public:
 private:
     T defaultValue;
     PropertyValue<T> currentValue;
+    bool calculated = false;
 };
 
 } // namespace style
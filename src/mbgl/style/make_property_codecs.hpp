@@ -0,0 +1,134 @@
+#pragma once
+
+// This file is generated. Edit make_property_codecs.hpp.ejs, then run `make style-code`.
+
+#include <mbgl/style/binary_property_codec.hpp>
+
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
+#include <mbgl/style/layers/background_layer.hpp>
+
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+namespace binary {
+
+inline auto makeLayoutPropertyCodecs() {
+    std::unordered_map<std::string, LayoutPropertyCodec> result;
+
+    result["visibility"] = makeVisibilityCodec();
+
+
+    result["line-cap"] = makePropertyCodec(&LineLayer::setLineCap);
+    result["line-join"] = makePropertyCodec(&LineLayer::setLineJoin);
+    result["line-miter-limit"] = makePropertyCodec(&LineLayer::setLineMiterLimit);
+    result["line-round-limit"] = makePropertyCodec(&LineLayer::setLineRoundLimit);
+
+    result["symbol-placement"] = makePropertyCodec(&SymbolLayer::setSymbolPlacement);
+    result["symbol-spacing"] = makePropertyCodec(&SymbolLayer::setSymbolSpacing);
+    result["symbol-avoid-edges"] = makePropertyCodec(&SymbolLayer::setSymbolAvoidEdges);
+    result["icon-allow-overlap"] = makePropertyCodec(&SymbolLayer::setIconAllowOverlap);
+    result["icon-ignore-placement"] = makePropertyCodec(&SymbolLayer::setIconIgnorePlacement);
+    result["icon-optional"] = makePropertyCodec(&SymbolLayer::setIconOptional);
+    result["icon-rotation-alignment"] = makePropertyCodec(&SymbolLayer::setIconRotationAlignment);
+    result["icon-size"] = makePropertyCodec(&SymbolLayer::setIconSize);
+    result["icon-text-fit"] = makePropertyCodec(&SymbolLayer::setIconTextFit);
+    result["icon-text-fit-padding"] = makePropertyCodec(&SymbolLayer::setIconTextFitPadding);
+    result["icon-image"] = makePropertyCodec(&SymbolLayer::setIconImage);
+    result["icon-rotate"] = makePropertyCodec(&SymbolLayer::setIconRotate);
+    result["icon-padding"] = makePropertyCodec(&SymbolLayer::setIconPadding);
+    result["icon-keep-upright"] = makePropertyCodec(&SymbolLayer::setIconKeepUpright);
+    result["icon-offset"] = makePropertyCodec(&SymbolLayer::setIconOffset);
+    result["text-pitch-alignment"] = makePropertyCodec(&SymbolLayer::setTextPitchAlignment);
+    result["text-rotation-alignment"] = makePropertyCodec(&SymbolLayer::setTextRotationAlignment);
+    result["text-field"] = makePropertyCodec(&SymbolLayer::setTextField);
+    result["text-font"] = makePropertyCodec(&SymbolLayer::setTextFont);
+    result["text-size"] = makePropertyCodec(&SymbolLayer::setTextSize);
+    result["text-max-width"] = makePropertyCodec(&SymbolLayer::setTextMaxWidth);
+    result["text-line-height"] = makePropertyCodec(&SymbolLayer::setTextLineHeight);
+    result["text-letter-spacing"] = makePropertyCodec(&SymbolLayer::setTextLetterSpacing);
+    result["text-justify"] = makePropertyCodec(&SymbolLayer::setTextJustify);
+    result["text-anchor"] = makePropertyCodec(&SymbolLayer::setTextAnchor);
+    result["text-max-angle"] = makePropertyCodec(&SymbolLayer::setTextMaxAngle);
+    result["text-rotate"] = makePropertyCodec(&SymbolLayer::setTextRotate);
+    result["text-padding"] = makePropertyCodec(&SymbolLayer::setTextPadding);
+    result["text-keep-upright"] = makePropertyCodec(&SymbolLayer::setTextKeepUpright);
+    result["text-transform"] = makePropertyCodec(&SymbolLayer::setTextTransform);
+    result["text-offset"] = makePropertyCodec(&SymbolLayer::setTextOffset);
+    result["text-allow-overlap"] = makePropertyCodec(&SymbolLayer::setTextAllowOverlap);
+    result["text-ignore-placement"] = makePropertyCodec(&SymbolLayer::setTextIgnorePlacement);
+    result["text-optional"] = makePropertyCodec(&SymbolLayer::setTextOptional);
+
+
+
+
+    return result;
+}
+
+inline auto makePaintPropertyCodecs() {
+    std::unordered_map<std::string, PaintPropertyCodec> result;
+
+    result["fill-antialias"] = makePropertyCodec(&FillLayer::setFillAntialias);
+    result["fill-opacity"] = makePropertyCodec(&FillLayer::setFillOpacity);
+    result["fill-color"] = makePropertyCodec(&FillLayer::setFillColor);
+    result["fill-outline-color"] = makePropertyCodec(&FillLayer::setFillOutlineColor);
+    result["fill-translate"] = makePropertyCodec(&FillLayer::setFillTranslate);
+    result["fill-translate-anchor"] = makePropertyCodec(&FillLayer::setFillTranslateAnchor);
+    result["fill-pattern"] = makePropertyCodec(&FillLayer::setFillPattern);
+
+    result["line-opacity"] = makePropertyCodec(&LineLayer::setLineOpacity);
+    result["line-color"] = makePropertyCodec(&LineLayer::setLineColor);
+    result["line-translate"] = makePropertyCodec(&LineLayer::setLineTranslate);
+    result["line-translate-anchor"] = makePropertyCodec(&LineLayer::setLineTranslateAnchor);
+    result["line-width"] = makePropertyCodec(&LineLayer::setLineWidth);
+    result["line-gap-width"] = makePropertyCodec(&LineLayer::setLineGapWidth);
+    result["line-offset"] = makePropertyCodec(&LineLayer::setLineOffset);
+    result["line-blur"] = makePropertyCodec(&LineLayer::setLineBlur);
+    result["line-dasharray"] = makePropertyCodec(&LineLayer::setLineDasharray);
+    result["line-pattern"] = makePropertyCodec(&LineLayer::setLinePattern);
+
+    result["icon-opacity"] = makePropertyCodec(&SymbolLayer::setIconOpacity);
+    result["icon-color"] = makePropertyCodec(&SymbolLayer::setIconColor);
+    result["icon-halo-color"] = makePropertyCodec(&SymbolLayer::setIconHaloColor);
+    result["icon-halo-width"] = makePropertyCodec(&SymbolLayer::setIconHaloWidth);
+    result["icon-halo-blur"] = makePropertyCodec(&SymbolLayer::setIconHaloBlur);
+    result["icon-translate"] = makePropertyCodec(&SymbolLayer::setIconTranslate);
+    result["icon-translate-anchor"] = makePropertyCodec(&SymbolLayer::setIconTranslateAnchor);
+    result["text-opacity"] = makePropertyCodec(&SymbolLayer::setTextOpacity);
+    result["text-color"] = makePropertyCodec(&SymbolLayer::setTextColor);
+    result["text-halo-color"] = makePropertyCodec(&SymbolLayer::setTextHaloColor);
+    result["text-halo-width"] = makePropertyCodec(&SymbolLayer::setTextHaloWidth);
+    result["text-halo-blur"] = makePropertyCodec(&SymbolLayer::setTextHaloBlur);
+    result["text-translate"] = makePropertyCodec(&SymbolLayer::setTextTranslate);
+    result["text-translate-anchor"] = makePropertyCodec(&SymbolLayer::setTextTranslateAnchor);
+
+    result["circle-radius"] = makePropertyCodec(&CircleLayer::setCircleRadius);
+    result["circle-color"] = makePropertyCodec(&CircleLayer::setCircleColor);
+    result["circle-blur"] = makePropertyCodec(&CircleLayer::setCircleBlur);
+    result["circle-opacity"] = makePropertyCodec(&CircleLayer::setCircleOpacity);
+    result["circle-translate"] = makePropertyCodec(&CircleLayer::setCircleTranslate);
+    result["circle-translate-anchor"] = makePropertyCodec(&CircleLayer::setCircleTranslateAnchor);
+    result["circle-pitch-scale"] = makePropertyCodec(&CircleLayer::setCirclePitchScale);
+
+    result["raster-opacity"] = makePropertyCodec(&RasterLayer::setRasterOpacity);
+    result["raster-hue-rotate"] = makePropertyCodec(&RasterLayer::setRasterHueRotate);
+    result["raster-brightness-min"] = makePropertyCodec(&RasterLayer::setRasterBrightnessMin);
+    result["raster-brightness-max"] = makePropertyCodec(&RasterLayer::setRasterBrightnessMax);
+    result["raster-saturation"] = makePropertyCodec(&RasterLayer::setRasterSaturation);
+    result["raster-contrast"] = makePropertyCodec(&RasterLayer::setRasterContrast);
+    result["raster-fade-duration"] = makePropertyCodec(&RasterLayer::setRasterFadeDuration);
+
+    result["background-color"] = makePropertyCodec(&BackgroundLayer::setBackgroundColor);
+    result["background-pattern"] = makePropertyCodec(&BackgroundLayer::setBackgroundPattern);
+    result["background-opacity"] = makePropertyCodec(&BackgroundLayer::setBackgroundOpacity);
+
+    return result;
+}
+
+} // namespace binary
+} // namespace style
+} // namespace mbgl
@@ -10,8 +10,10 @@
 #include <mbgl/util/interpolate.hpp>
 #include <mbgl/util/rapidjson.hpp>
 
-#include <unordered_map>
+#include <algorithm>
+#include <array>
 #include <utility>
+#include <vector>
 
 namespace mbgl {
 namespace style {
@@ -21,73 +23,141 @@ class PaintProperty {
 public:
     using Result = typename Evaluator<T>::ResultType;
 
+    // The number of cascaded values that a property transitions between at most: the current
+    // one, and the ones it's still transitioning from. Cascading more during a transition drops
+    // the oldest one, whose share of the interpolated value is negligible by then.
+    static constexpr std::size_t MaxCascadedValues = 3;
+
     explicit PaintProperty(T defaultValue_)
         : defaultValue(defaultValue_) {
-        values.emplace(ClassID::Fallback, defaultValue_);
+        values.emplace_back(ClassID::Fallback, defaultValue_);
+        valueClasses = classMask(ClassID::Fallback);
     }
 
     PaintProperty(const PaintProperty& other)
         : defaultValue(other.defaultValue),
           values(other.values),
-          transitions(other.transitions) {
+          transitions(other.transitions),
+          valueClasses(other.valueClasses) {
     }
 
     PaintProperty& operator=(const PaintProperty& other) {
         defaultValue = other.defaultValue;
         values = other.values;
         transitions = other.transitions;
+        valueClasses = other.valueClasses;
+        changed = true;
         return *this;
     }
 
     bool isUndefined() const {
-        return values.find(ClassID::Default) == values.end();
+        return !find(values, ClassID::Default);
     }
 
     const PropertyValue<T>& get(const optional<std::string>& klass) const {
         static const PropertyValue<T> staticValue;
-        const auto it = values.find(klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default);
-        return it == values.end() ? staticValue : it->second;
+        const PropertyValue<T>* classValue = find(values, classID(klass));
+        return classValue ? *classValue : staticValue;
     }
 
     void set(const PropertyValue<T>& value_, const optional<std::string>& klass) {
-        values[klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default] = value_;
+        const ClassID id = classID(klass);
+        insert(values, id, value_);
+        valueClasses |= classMask(id);
+        changed = true;
     }
 
     void setTransition(const TransitionOptions& transition, const optional<std::string>& klass) {
-        transitions[klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default] = transition;
+        insert(transitions, classID(klass), transition);
     }
 
     void cascade(const CascadeParameters& params) {
+        // The value of a property is that of the first of the classes that has one. If the set of
+        // those is the same as the last time, and at most one named class is among them so that
+        // their order doesn't matter, cascading would pick the same value again.
+        const ClassMask activeClasses = valueClasses & params.classMask;
+        const ClassMask namedClasses = activeClasses & ~(classMask(ClassID::Fallback) | classMask(ClassID::Default));
+        if (!changed && cascadedCount && activeClasses == cascadedClasses &&
+            !(activeClasses & OverflowClassMask) && !(namedClasses & (namedClasses - 1))) {
+            return;
+        }
+        changed = false;
+        cascadedClasses = activeClasses;
+
         const bool overrideTransition = !params.transition.delay && !params.transition.duration;
         Duration delay = params.transition.delay.value_or(Duration::zero());
         Duration duration = params.transition.duration.value_or(Duration::zero());
 
-        for (const auto classID : params.classes) {
-            if (values.find(classID) == values.end())
+        for (const auto classID_ : params.classes) {
+            // Most classes don't have a value for a property, which the mask tells without
+            // searching the values.
+            if (!(valueClasses & classMask(classID_)))
+                continue;
+            const PropertyValue<T>* classValue = find(values, classID_);
+            if (!classValue)
                 continue;
 
-            if (overrideTransition && transitions.find(classID) != transitions.end()) {
-                const TransitionOptions& transition = transitions[classID];
-                if (transition.delay) delay = *transition.delay;
-                if (transition.duration) duration = *transition.duration;
+            // Cascading the same value again leaves its transition as it is.
+            if (cascadedCount && cascaded[cascadedCount - 1].value == *classValue)
+                break;
+
+            const TransitionOptions* transition = find(transitions, classID_);
+            if (overrideTransition && transition) {
+                if (transition->delay) delay = *transition->delay;
+                if (transition->duration) duration = *transition->duration;
+            }
+
+            if (cascadedCount == MaxCascadedValues) {
+                drop(1);
             }
 
-            cascaded = std::make_unique<CascadedValue>(std::move(cascaded),
-                                                       params.now + delay,
-                                                       params.now + delay + duration,
-                                                       values.at(classID));
+            CascadedValue& next = cascaded[cascadedCount++];
+            next.begin = params.now + delay;
+            next.end = params.now + delay + duration;
+            next.value = *classValue;
+            next.table = Evaluator<T>::createTable(next.value);
 
             break;
         }
 
-        assert(cascaded);
+        assert(cascadedCount);
+        calculated = false;
     }
 
     bool calculate(const CalculationParameters& parameters) {
-        assert(cascaded);
+        assert(cascadedCount);
         Evaluator<T> evaluator(parameters, defaultValue);
-        value = cascaded->calculate(evaluator, parameters.now);
-        return cascaded->prior.operator bool();
+
+        // Interpolate from the oldest value to the newest. Once a transition is complete, the
+        // values before it no longer matter.
+        std::size_t completed = 0;
+        Result result = evaluator(cascaded[0].value, cascaded[0].table.get());
+        for (std::size_t i = 1; i < cascadedCount; ++i) {
+            const CascadedValue& next = cascaded[i];
+            Result finalValue = evaluator(next.value, next.table.get());
+            if (parameters.now >= next.end) {
+                result = std::move(finalValue);
+                completed = i;
+            } else {
+                float t = std::chrono::duration<float>(parameters.now - next.begin) / (next.end - next.begin);
+                result = util::interpolate(result, finalValue, util::DEFAULT_TRANSITION_EASE.solve(t, 0.001));
+            }
+        }
+        drop(completed);
+
+        value = std::move(result);
+        calculated = true;
+        return cascadedCount > 1;
+    }
+
+    // Whether calculating the value again would yield the same result, at any zoom level and time.
+    bool isConstant() const {
+        return calculated && cascadedCount == 1 && Evaluator<T>::isZoomConstant(cascaded[0].value, defaultValue);
+    }
+
+    // Whether the value is a property function, which buckets evaluate for each feature instead.
+    bool isDataDriven() const {
+        return cascadedCount && cascaded[cascadedCount - 1].value.isPropertyFunction();
     }
 
     // TODO: remove / privatize
@@ -95,44 +165,69 @@ public:
     Result value;
 
 private:
-    T defaultValue;
-    std::unordered_map<ClassID, PropertyValue<T>> values;
-    std::unordered_map<ClassID, TransitionOptions> transitions;
+    // Values by class, in the order they were set. Layers only have a few classes, so that
+    // searching these is faster than hashing.
+    template <class V>
+    using ClassValues = std::vector<std::pair<ClassID, V>>;
 
-    struct CascadedValue {
-        CascadedValue(std::unique_ptr<CascadedValue> prior_,
-                      TimePoint begin_,
-                      TimePoint end_,
-                      PropertyValue<T> value_)
-            : prior(std::move(prior_)),
-              begin(std::move(begin_)),
-              end(std::move(end_)),
-              value(std::move(value_)) {
+    static ClassID classID(const optional<std::string>& klass) {
+        return klass ? ClassDictionary::Get().lookup(*klass) : ClassID::Default;
+    }
+
+    template <class V>
+    static const V* find(const ClassValues<V>& classValues, ClassID id) {
+        for (const auto& classValue : classValues) {
+            if (classValue.first == id) {
+                return &classValue.second;
+            }
         }
+        return nullptr;
+    }
 
-        Result calculate(const Evaluator<T>& evaluator, const TimePoint& now) {
-            Result finalValue = PropertyValue<T>::visit(value, evaluator);
-            if (!prior) {
-                // No prior value.
-                return finalValue;
-            } else if (now >= end) {
-                // Transition from prior value is now complete.
-                prior.reset();
-                return finalValue;
-            } else {
-                // Interpolate between recursively-calculated prior value and final.
-                float t = std::chrono::duration<float>(now - begin) / (end - begin);
-                return util::interpolate(prior->calculate(evaluator, now), finalValue, util::DEFAULT_TRANSITION_EASE.solve(t, 0.001));
+    template <class V>
+    static void insert(ClassValues<V>& classValues, ClassID id, const V& v) {
+        for (auto& classValue : classValues) {
+            if (classValue.first == id) {
+                classValue.second = v;
+                return;
             }
         }
+        classValues.emplace_back(id, v);
+    }
+
+    // Drops the oldest cascaded values.
+    void drop(std::size_t count) {
+        if (!count) {
+            return;
+        }
+        std::move(cascaded.begin() + count, cascaded.begin() + cascadedCount, cascaded.begin());
+        for (std::size_t i = cascadedCount - count; i < cascadedCount; ++i) {
+            cascaded[i] = {};
+        }
+        cascadedCount -= count;
+    }
 
-        std::unique_ptr<CascadedValue> prior;
+    T defaultValue;
+    ClassValues<PropertyValue<T>> values;
+    ClassValues<TransitionOptions> transitions;
+
+    // The classes that have values, and those of them that the last cascade was for. Values set
+    // since then have to be cascaded again.
+    ClassMask valueClasses = 0;
+    ClassMask cascadedClasses = 0;
+    bool changed = true;
+
+    struct CascadedValue {
         TimePoint begin;
         TimePoint end;
         PropertyValue<T> value;
+        std::unique_ptr<const FunctionTable<T>> table;
     };
 
-    std::unique_ptr<CascadedValue> cascaded;
+    // The cascaded values, oldest first.
+    std::array<CascadedValue, MaxCascadedValues> cascaded;
+    std::size_t cascadedCount = 0;
+    bool calculated = false;
 };
 
 } // namespace style
@@ -1,4 +1,5 @@
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/binary_style.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
@@ -6,6 +7,7 @@
 #include <mbgl/style/conversion/layer.hpp>
 
 #include <mbgl/platform/log.hpp>
+#include <mbgl/actor/parallel_for.hpp>
 
 #include <mapbox/geojsonvt.hpp>
 
@@ -13,16 +15,45 @@
 #include <rapidjson/error/en.h>
 
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 
 namespace mbgl {
 namespace style {
 
+namespace {
+
+bool hasPaintClasses(const JSValue& value) {
+    for (const auto& member : value.GetObject()) {
+        if (member.name.GetStringLength() > 6 && std::strncmp(member.name.GetString(), "paint.", 6) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 Parser::~Parser() = default;
 
-StyleParseResult Parser::parse(const std::string& json) {
-    rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> document;
+StyleParseResult Parser::parse(const std::string& json, Scheduler* scheduler) {
+    StyleParseResult error = parseWithoutLayers(json);
+    if (error) {
+        return error;
+    }
+    parseLayers(scheduler);
+    return nullptr;
+}
+
+StyleParseResult Parser::parseWithoutLayers(const std::string& json) {
+    if (isBinaryStyle(json)) {
+        binaryStyle = json;
+        return parseBinaryWithoutLayers();
+    }
+
     document.Parse<0>(json.c_str());
 
     if (document.HasParseError()) {
@@ -87,7 +118,7 @@ StyleParseResult Parser::parse(const std::string& json) {
     }
 
     if (document.HasMember("layers")) {
-        parseLayers(document["layers"]);
+        parseVisibleLayerSources(document["layers"]);
     }
 
     if (document.HasMember("sprite")) {
@@ -107,6 +138,45 @@ StyleParseResult Parser::parse(const std::string& json) {
     return nullptr;
 }
 
+void Parser::parseLayers(Scheduler* scheduler) {
+    if (!binaryStyle.empty()) {
+        parseBinaryLayers();
+    } else if (document.IsObject() && document.HasMember("layers")) {
+        parseLayers(document["layers"], scheduler);
+    }
+}
+
+void Parser::parseVisibleLayerSources(const JSValue& value) {
+    if (!value.IsArray()) {
+        return;
+    }
+
+    // Only looks at the raw JSON; errors are reported once the layers are converted. Layers
+    // with a `ref` share the source of the layer they refer to.
+    for (auto& layerValue : value.GetArray()) {
+        if (!layerValue.IsObject() || !layerValue.HasMember("source")) {
+            continue;
+        }
+
+        const JSValue& source = layerValue["source"];
+        if (!source.IsString()) {
+            continue;
+        }
+
+        if (layerValue.HasMember("layout")) {
+            const JSValue& layout = layerValue["layout"];
+            if (layout.IsObject() && layout.HasMember("visibility")) {
+                const JSValue& visibility = layout["visibility"];
+                if (visibility.IsString() && std::strcmp(visibility.GetString(), "none") == 0) {
+                    continue;
+                }
+            }
+        }
+
+        visibleLayerSources.emplace(source.GetString(), source.GetStringLength());
+    }
+}
+
 void Parser::parseSources(const JSValue& value) {
     if (!value.IsObject()) {
         Log::Warning(Event::ParseStyle, "sources must be an object");
@@ -128,7 +198,7 @@ void Parser::parseSources(const JSValue& value) {
     }
 }
 
-void Parser::parseLayers(const JSValue& value) {
+void Parser::parseLayers(const JSValue& value, Scheduler* scheduler) {
     std::vector<std::string> ids;
 
     if (!value.IsArray()) {
@@ -163,7 +233,46 @@ void Parser::parseLayers(const JSValue& value) {
         ids.push_back(layerID);
     }
 
+    // Layers that don't reference others convert independently of each other, and so in
+    // parallel. Only those without paint classes do, because class names are numbered per thread;
+    // see ClassDictionary.
+    std::vector<std::pair<const JSValue*, std::unique_ptr<Layer>*>> independent;
+    std::vector<std::string> dependent;
     for (const auto& id : ids) {
+        auto& entry = layersMap.find(id)->second;
+        if (!entry.first.HasMember("ref") && !hasPaintClasses(entry.first)) {
+            independent.emplace_back(&entry.first, &entry.second);
+        } else {
+            dependent.push_back(id);
+        }
+    }
+
+    std::vector<std::string> errors(independent.size());
+    const auto convert = [&] (std::size_t i) {
+        conversion::Result<std::unique_ptr<Layer>> converted =
+            conversion::convert<std::unique_ptr<Layer>>(*independent[i].first);
+        if (converted) {
+            *independent[i].second = std::move(*converted);
+        } else {
+            errors[i] = converted.error().message;
+        }
+    };
+
+    if (scheduler && independent.size() > 1) {
+        actor::parallelFor(*scheduler, independent.size(), convert);
+    } else {
+        for (std::size_t i = 0; i < independent.size(); ++i) {
+            convert(i);
+        }
+    }
+
+    for (const auto& error : errors) {
+        if (!error.empty()) {
+            Log::Warning(Event::ParseStyle, error);
+        }
+    }
+
+    for (const auto& id : dependent) {
         auto it = layersMap.find(id);
 
         parseLayer(it->first,
@@ -231,6 +340,130 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
     }
 }
 
+StyleParseResult Parser::parseBinaryWithoutLayers() {
+    try {
+        protozero::pbf_reader style(binaryStyle.data() + BinaryStyleMagic.size(),
+                                    binaryStyle.size() - BinaryStyleMagic.size());
+
+        if (!style.next(binary::StyleField::Version) || style.get_uint32() != BinaryStyleVersion) {
+            return std::make_exception_ptr(std::runtime_error("unsupported binary style version"));
+        }
+
+        while (style.next()) {
+            switch (style.tag()) {
+            case binary::StyleField::Name:
+                name = style.get_string();
+                break;
+            case binary::StyleField::Center: {
+                std::vector<double> center;
+                for (double coordinate : style.get_packed_double()) {
+                    center.push_back(coordinate);
+                }
+                if (center.size() >= 2) {
+                    latLng.longitude = center[0];
+                    latLng.latitude = center[1];
+                }
+                break;
+            }
+            case binary::StyleField::Zoom:
+                zoom = style.get_double();
+                break;
+            case binary::StyleField::Bearing:
+                bearing = style.get_double();
+                break;
+            case binary::StyleField::Pitch:
+                pitch = style.get_double();
+                break;
+            case binary::StyleField::Sprite:
+                spriteURL = style.get_string();
+                break;
+            case binary::StyleField::Glyphs:
+                glyphURL = style.get_string();
+                break;
+            case binary::StyleField::Sources:
+                if (std::unique_ptr<Source> source = binary::readSource(style.get_message())) {
+                    sourcesMap.emplace(source->getID(), source.get());
+                    sources.emplace_back(std::move(source));
+                }
+                break;
+            case binary::StyleField::Layers: {
+                const binary::LayerHeader header = binary::readLayerHeader(style.get_message());
+                if (!header.source.empty() && header.visible) {
+                    visibleLayerSources.insert(header.source);
+                }
+                break;
+            }
+            default:
+                style.skip();
+            }
+        }
+    } catch (const protozero::exception&) {
+        return std::make_exception_ptr(std::runtime_error("invalid binary style"));
+    }
+
+    return nullptr;
+}
+
+void Parser::parseBinaryLayers() {
+    struct BinaryLayer {
+        binary::LayerHeader header;
+        protozero::pbf_reader message;
+        std::unique_ptr<Layer> layer;
+        bool visited = false;
+    };
+
+    std::vector<BinaryLayer> entries;
+    std::unordered_map<std::string, std::size_t> indices;
+
+    try {
+        protozero::pbf_reader style(binaryStyle.data() + BinaryStyleMagic.size(),
+                                    binaryStyle.size() - BinaryStyleMagic.size());
+        while (style.next(binary::StyleField::Layers)) {
+            protozero::pbf_reader message = style.get_message();
+            binary::LayerHeader header = binary::readLayerHeader(message);
+            if (indices.emplace(header.id, entries.size()).second) {
+                entries.push_back({ std::move(header), message, nullptr });
+            }
+        }
+
+        for (auto& entry : entries) {
+            if (entry.header.ref.empty()) {
+                entry.layer = binary::readLayer(entry.message);
+            }
+        }
+
+        // Layers with a ref are cloned from the layer they refer to, which may come later.
+        std::function<Layer* (BinaryLayer&)> resolve = [&] (BinaryLayer& entry) -> Layer* {
+            if (entry.layer || entry.visited) {
+                return entry.layer.get();
+            }
+            entry.visited = true;
+
+            auto it = indices.find(entry.header.ref);
+            Layer* reference = it != indices.end() ? resolve(entries[it->second]) : nullptr;
+            if (!reference) {
+                return nullptr;
+            }
+
+            entry.layer = reference->baseImpl->cloneRef(entry.header.id);
+            binary::readPaintProperties(*entry.layer, entry.message);
+            return entry.layer.get();
+        };
+
+        for (auto& entry : entries) {
+            resolve(entry);
+        }
+    } catch (const protozero::exception&) {
+        Log::Warning(Event::ParseStyle, "invalid binary style layers");
+    }
+
+    for (auto& entry : entries) {
+        if (entry.layer) {
+            layers.emplace_back(std::move(entry.layer));
+        }
+    }
+}
+
 std::vector<FontStack> Parser::fontStacks() const {
     std::set<FontStack> result;
 
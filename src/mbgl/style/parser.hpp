@@ -12,9 +12,13 @@
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <set>
 #include <forward_list>
 
 namespace mbgl {
+
+class Scheduler;
+
 namespace style {
 
 using StyleParseResult = std::exception_ptr;
@@ -23,7 +27,14 @@ class Parser {
 public:
     ~Parser();
 
-    StyleParseResult parse(const std::string&);
+    // Parses the style, given as JSON or as a binary style; see compileStyle(). The layers of a
+    // style JSON are converted on the threads of the scheduler, if one is given.
+    StyleParseResult parse(const std::string&, Scheduler* = nullptr);
+
+    // Parse the style in two steps, so that callers can request the sprite and the sources while
+    // the layers, which take the longest for big styles, are converted.
+    StyleParseResult parseWithoutLayers(const std::string&);
+    void parseLayers(Scheduler* = nullptr);
 
     std::string spriteURL;
     std::string glyphURL;
@@ -31,6 +42,10 @@ public:
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<std::unique_ptr<Layer>> layers;
 
+    // The IDs of the sources of the layers that aren't hidden, known before the layers are
+    // converted, so that their descriptions can be requested early.
+    std::set<std::string> visibleLayerSources;
+
     std::string name;
     LatLng latLng;
     double zoom = 0;
@@ -42,9 +57,18 @@ public:
 
 private:
     void parseSources(const JSValue&);
-    void parseLayers(const JSValue&);
+    void parseVisibleLayerSources(const JSValue&);
+    void parseLayers(const JSValue&, Scheduler*);
     void parseLayer(const std::string& id, const JSValue&, std::unique_ptr<Layer>&);
 
+    StyleParseResult parseBinaryWithoutLayers();
+    void parseBinaryLayers();
+
+    JSDocument document;
+
+    // The binary style being parsed, if any.
+    std::string binaryStyle;
+
     std::unordered_map<std::string, const Source*> sourcesMap;
     std::unordered_map<std::string, std::pair<const JSValue&, std::unique_ptr<Layer>>> layersMap;
 
@@ -5,6 +5,7 @@
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/color.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace mbgl {
@@ -84,6 +85,56 @@ T PropertyEvaluator<T>::operator()(const Function<T>& fn) const {
     }
 }
 
+template <typename T>
+T PropertyEvaluator<T>::operator()(const PropertyValue<T>& value, const FunctionTable<T>* table) const {
+    return table ? table->evaluate(parameters.z) : PropertyValue<T>::visit(value, *this);
+}
+
+namespace {
+
+// The types whose functions interpolate between their stops, rather than stepping.
+template <typename T> struct Tabulated : std::false_type {};
+template <> struct Tabulated<float> : std::true_type {};
+template <> struct Tabulated<Color> : std::true_type {};
+template <> struct Tabulated<std::array<float, 2>> : std::true_type {};
+template <> struct Tabulated<std::array<float, 4>> : std::true_type {};
+
+} // namespace
+
+template <typename T>
+std::unique_ptr<const FunctionTable<T>> PropertyEvaluator<T>::createTable(const PropertyValue<T>& value) {
+    using Table = FunctionTable<T>;
+
+    if (!Tabulated<T>::value || !value.isFunction() || value.asFunction().getStops().size() < 2) {
+        return {};
+    }
+
+    float minZoom = INFINITY;
+    float maxZoom = -INFINITY;
+    for (const auto& stop : value.asFunction().getStops()) {
+        const float step = stop.first * Table::StepsPerZoom;
+        if (step != std::floor(step)) {
+            return {};
+        }
+        minZoom = std::min(minZoom, stop.first);
+        maxZoom = std::max(maxZoom, stop.first);
+    }
+
+    const auto size = static_cast<std::size_t>((maxZoom - minZoom) * Table::StepsPerZoom) + 1;
+    if (size > Table::MaxSamples) {
+        return {};
+    }
+
+    std::vector<T> samples;
+    samples.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        const CalculationParameters parameters(minZoom + i / Table::StepsPerZoom);
+        samples.push_back(PropertyEvaluator<T>(parameters, T())(value.asFunction()));
+    }
+
+    return std::make_unique<const Table>(minZoom, std::move(samples));
+}
+
 template class PropertyEvaluator<bool>;
 template class PropertyEvaluator<float>;
 template class PropertyEvaluator<Color>;
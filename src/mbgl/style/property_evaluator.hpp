@@ -3,11 +3,51 @@
 #include <mbgl/style/property_value.hpp>
 #include <mbgl/util/interpolate.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace mbgl {
 namespace style {
 
 class CalculationParameters;
 
+/*
+   A zoom function sampled at fixed steps between its first and last stop. Evaluating it is a
+   lookup and a linear interpolation between two samples, rather than a search of the stops and,
+   for exponential functions, two calls to std::pow().
+
+   Tables are only built for functions whose stops lie on the steps. Those that interpolate
+   linearly between their stops evaluate the same with a table, up to rounding. Exponential ones
+   are off by less than a thousandth of the difference between two stops, for bases up to 3 and
+   stops a zoom level or more apart.
+*/
+template <typename T>
+class FunctionTable {
+public:
+    static constexpr float StepsPerZoom = 16;
+    static constexpr std::size_t MaxSamples = 32 * StepsPerZoom + 1;
+
+    FunctionTable(float minZoom_, std::vector<T> samples_)
+        : minZoom(minZoom_),
+          samples(std::move(samples_)) {}
+
+    T evaluate(float z) const {
+        const float position = (z - minZoom) * StepsPerZoom;
+        if (!(position > 0)) {
+            return samples.front();
+        }
+        const auto index = static_cast<std::size_t>(position);
+        if (index + 1 >= samples.size()) {
+            return samples.back();
+        }
+        return util::interpolate(samples[index], samples[index + 1], position - index);
+    }
+
+private:
+    float minZoom;
+    std::vector<T> samples;
+};
+
 template <typename T>
 class PropertyEvaluator {
 public:
@@ -21,6 +61,23 @@ public:
     T operator()(const T& constant) const { return constant; }
     T operator()(const Function<T>&) const;
 
+    // Buckets evaluate property functions for each feature; anything else takes the default.
+    T operator()(const PropertyFunction<T>& function) const {
+        return function.getDefaultValue() ? *function.getDefaultValue() : defaultValue;
+    }
+
+    // Evaluates the value with its table, if it has one.
+    T operator()(const PropertyValue<T>& value, const FunctionTable<T>* table) const;
+
+    // Whether the value evaluates to the same result at every zoom level.
+    static bool isZoomConstant(const PropertyValue<T>& value, const T&) {
+        return !value.isFunction();
+    }
+
+    // A table for evaluating the value, if it's a function of a numeric or color type that one
+    // represents; see FunctionTable.
+    static std::unique_ptr<const FunctionTable<T>> createTable(const PropertyValue<T>&);
+
 private:
     const CalculationParameters& parameters;
     T defaultValue;
@@ -48,6 +105,24 @@ public:
     Faded<T> operator()(const T& constant) const;
     Faded<T> operator()(const Function<T>&) const;
 
+    Faded<T> operator()(const PropertyFunction<T>&) const {
+        return operator()(Undefined());
+    }
+
+    Faded<T> operator()(const PropertyValue<T>& value, const FunctionTable<T>*) const {
+        return PropertyValue<T>::visit(value, *this);
+    }
+
+    // Cross-faded values are scaled by the zoom level unless they're empty, i.e. no pattern.
+    static bool isZoomConstant(const PropertyValue<T>& value, const T& defaultValue) {
+        return value.isUndefined() ? defaultValue == T() : value.isConstant() && value.asConstant() == T();
+    }
+
+    // Cross-faded functions are step functions, which tables don't represent.
+    static std::unique_ptr<const FunctionTable<T>> createTable(const PropertyValue<T>&) {
+        return {};
+    }
+
 private:
     Faded<T> calculate(const T& min, const T& mid, const T& max) const;
 
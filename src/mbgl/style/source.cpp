@@ -18,5 +18,13 @@ optional<std::string> Source::getAttribution() const {
     return baseImpl->getAttribution();
 }
 
+void Source::setTileTextureCaching(bool enabled) {
+    baseImpl->tileTextureCaching = enabled;
+}
+
+bool Source::getTileTextureCaching() const {
+    return baseImpl->tileTextureCaching;
+}
+
 } // namespace style
 } // namespace mbgl
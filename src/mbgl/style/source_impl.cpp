@@ -1,11 +1,18 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/map/transform.hpp>
+#include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/renderer/painter.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/style/query_parameters.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/style.hpp>
 #include <mbgl/text/placement_config.hpp>
+#include <mbgl/tile/cross_tile_placement_worker.hpp>
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/actor/parallel_for.hpp>
 #include <mbgl/platform/log.hpp>
 #include <mbgl/math/clamp.hpp>
 #include <mbgl/util/tile_cover.hpp>
@@ -18,12 +25,44 @@
 #include <mapbox/geometry/envelope.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 namespace mbgl {
 namespace style {
 
 static SourceObserver nullObserver;
 
+// How many zoom levels above the ideal tiles their first prefetched parents are; the second ones
+// are twice as many above.
+static const int32_t PARENT_PREFETCH_ZOOM_DELTA = 2;
+
+// The names of the buckets of the source's layers that are, or aren't, rendered at the given zoom
+// level. Layers that share a bucket are rendered if any of them is.
+static std::set<std::string> bucketNames(const std::vector<const Layer*>& layers,
+                                         const std::string& sourceID,
+                                         float zoom,
+                                         bool rendered) {
+    std::set<std::string> renderedNames;
+    std::set<std::string> hiddenNames;
+    for (const Layer* layer : layers) {
+        if (layer->baseImpl->source != sourceID) {
+            continue;
+        }
+        if (layer->baseImpl->needsRendering(zoom)) {
+            renderedNames.insert(layer->baseImpl->bucketName());
+        } else {
+            hiddenNames.insert(layer->baseImpl->bucketName());
+        }
+    }
+    if (rendered) {
+        return renderedNames;
+    }
+    for (const auto& name : renderedNames) {
+        hiddenNames.erase(name);
+    }
+    return hiddenNames;
+}
+
 Source::Impl::Impl(SourceType type_, std::string id_, Source& base_)
     : type(type_),
       id(std::move(id_)),
@@ -48,29 +87,48 @@ bool Source::Impl::isLoaded() const {
 void Source::Impl::invalidateTiles() {
     tiles.clear();
     renderTiles.clear();
+    renderTilesGeneration++;
     cache.clear();
+    requiredTiles.clear();
+    removedTiles.clear();
+    retainedTiles.clear();
+    bucketsReleased = false;
+    tilesChanged = true;
 }
 
-void Source::Impl::startRender(algorithm::ClipIDGenerator& generator,
-                         const mat4& projMatrix,
-                         const TransformState& transform) {
+void Source::Impl::updateClipIDs(algorithm::ClipIDGenerator& generator) {
     if (type == SourceType::Vector ||
         type == SourceType::GeoJSON ||
         type == SourceType::Annotations) {
         generator.update(renderTiles);
     }
+}
+
+void Source::Impl::startRender(const mat4& projMatrix, const TransformState& transform) {
+    for (auto& pair : renderTiles) {
+        pair.second.calculateMatrix(projMatrix, transform);
+    }
+}
 
+std::size_t Source::Impl::cullRenderTiles(const TransformState& transform, double minArea) {
+    std::size_t culled = 0;
     for (auto& pair : renderTiles) {
         auto& tile = pair.second;
-        transform.matrixFor(tile.matrix, tile.id);
-        matrix::multiply(tile.matrix, projMatrix, tile.matrix);
+        tile.culled = util::tileScreenArea(tile.matrix, transform) <= minArea;
+        culled += tile.culled;
     }
+    return culled;
 }
 
 void Source::Impl::finishRender(Painter& painter) {
     for (auto& pair : renderTiles) {
         auto& tile = pair.second;
         painter.renderTileDebug(tile);
+
+        if (!tile.tile.rendered && !tile.culled) {
+            tile.tile.rendered = true;
+            TileTrace::instant(TileTrace::Event::FirstRender, base.getID(), tile.tile.id);
+        }
     }
 }
 
@@ -78,6 +136,16 @@ const std::map<UnwrappedTileID, RenderTile>& Source::Impl::getRenderTiles() cons
     return renderTiles;
 }
 
+std::vector<Tile*> Source::Impl::getTilesNeedingUpload() const {
+    std::vector<Tile*> result;
+    for (const auto& pair : tiles) {
+        if (pair.second->needsUpload()) {
+            result.push_back(pair.second.get());
+        }
+    }
+    return result;
+}
+
 void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     if (!loaded) {
         return;
@@ -89,27 +157,153 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     // Determine the overzooming/underzooming amounts and required tiles.
     int32_t overscaledZoom = util::coveringZoomLevel(parameters.transformState.getZoom(), type, tileSize);
     int32_t tileZoom = overscaledZoom;
-
-    std::vector<UnwrappedTileID> idealTiles;
-    if (overscaledZoom >= zoomRange.min) {
-        int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
-
+    const int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
+
+    bool idealTilesChanged = false;
+    if (overscaledZoom < zoomRange.min) {
+        idealTilesChanged = !idealTileIDs.empty() || !idealCover.getTiles().empty();
+        idealTileIDs.clear();
+        idealCover.clear();
+    } else {
         // Make sure we're not reparsing overzoomed raster tiles.
         if (type == SourceType::Raster) {
             tileZoom = idealZoom;
         }
 
-        idealTiles = util::tileCover(parameters.transformState, idealZoom);
+        if (parameters.tileLevelOfDetail) {
+            std::vector<UnwrappedTileID> lodTiles =
+                util::tileCoverWithLOD(parameters.transformState, idealZoom, zoomRange.min);
+            idealTilesChanged = lodTiles != idealTileIDs || !idealCover.getTiles().empty();
+            idealTileIDs = std::move(lodTiles);
+            idealCover.clear();
+        } else {
+            idealTilesChanged = !idealCover.update(parameters.transformState, idealZoom).empty() ||
+                                !idealTileIDs.empty();
+            idealTileIDs.clear();
+        }
+    }
+    const std::vector<UnwrappedTileID>& idealTiles =
+        parameters.tileLevelOfDetail ? idealTileIDs : idealCover.getTiles();
+
+    if (idealTilesChanged) {
+        removedTiles.clear();
+    }
+
+    // Selecting the tiles again would yield the same ones, e.g. while panning within the same
+    // tiles, unless the ideal tiles, the state of the tiles themselves, or what else the selection
+    // depends on have changed since.
+    const bool selectionChanged = idealTilesChanged || tilesChanged ||
+                                  tileZoom != selectedTileZoom ||
+                                  parameters.prefetchParents != selectedParentTiles ||
+                                  !parameters.prefetchStates.empty() || selectedPrefetchTiles;
+    if (selectionChanged) {
+        selectTiles(parameters, idealTiles, tileZoom, idealZoom);
+    }
+
+    if (type != SourceType::Raster && type != SourceType::Annotations && cache.getSize() == 0) {
+        size_t conservativeCacheSize =
+            ((float)parameters.transformState.getWidth() / util::tileSize) *
+            ((float)parameters.transformState.getHeight() / util::tileSize) *
+            (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) *
+            0.5;
+        cache.setSize(conservativeCacheSize);
+    }
+
+    const PlacementConfig currentConfig { parameters.transformState.getAngle(),
+                                          parameters.transformState.getPitch(),
+                                          parameters.debugOptions & MapDebugOptions::Collision };
+    if (!placementConfig) {
+        placementConfig = currentConfig;
+    } else if (!parameters.deferPlacement &&
+               !(parameters.cameraMoving && placementConfig->isCloseTo(currentConfig))) {
+        // A small rotation while the camera moves keeps the placement; the update made once it
+        // stops places the symbols for the final angle and pitch.
+        placementConfig = currentConfig;
+    }
+    const PlacementConfig& config = *placementConfig;
+
+    if (parameters.crossTilePlacement && !placementGroup) {
+        placementGroup = std::make_unique<Actor<CrossTilePlacementWorker>>(parameters.workerScheduler);
+        placementGroup->setTag("CrossTilePlacementWorker");
+    }
+
+    // Once created, the group lives as long as the source, so that tiles can compare it by address.
+    Actor<CrossTilePlacementWorker>* group = parameters.crossTilePlacement ? placementGroup.get() : nullptr;
+
+    if (group) {
+        if (retainedTiles != placementGroupTiles) {
+            placementGroupTiles = retainedTiles;
+            group->invoke(&CrossTilePlacementWorker::setTiles, retainedTiles);
+        }
+        group->invokeCoalesced(&CrossTilePlacementWorker::setPlacementConfig, config);
+    } else if (!placementGroupTiles.empty()) {
+        placementGroupTiles.clear();
+        placementGroup->invoke(&CrossTilePlacementWorker::setTiles, placementGroupTiles);
+    }
+
+    for (auto& pair : tiles) {
+        pair.second->setPlacementGroup(group);
+        pair.second->setPlacementConfig(config);
+    }
+
+    if (bucketsReleased) {
+        const std::set<std::string> rendered = bucketNames(parameters.style.getLayers(), base.getID(),
+                                                           parameters.transformState.getZoom(), true);
+        bucketsReleased = false;
+        for (auto& pair : tiles) {
+            bucketsReleased |= pair.second->restoreBuckets(rendered);
+        }
     }
+}
+
+void Source::Impl::selectTiles(const UpdateParameters& parameters,
+                               const std::vector<UnwrappedTileID>& idealTiles,
+                               int32_t tileZoom,
+                               int32_t idealZoom) {
+    const uint16_t tileSize = getTileSize();
+    const Range<uint8_t> zoomRange = getZoomRange();
+
+    // Tiles that change from now on are taken into account by the next selection.
+    tilesChanged = false;
+    selectedTileZoom = tileZoom;
+    selectedParentTiles = parameters.prefetchParents;
+    selectedPrefetchTiles = !parameters.prefetchStates.empty();
 
     // Stores a list of all the tiles that we're definitely going to retain. There are two
     // kinds of tiles we need: the ideal tiles determined by the tile cover. They may not yet be in
     // use because they're still loading. In addition to that, we also need to retain all tiles that
     // we're actively using, e.g. as a replacement for tile that aren't loaded yet.
-    std::set<OverscaledTileID> retain;
+    std::set<OverscaledTileID>& retain = retainedTiles;
+    retain.clear();
+    requiredTiles.clear();
+
+    // The parents of the ideal tiles that are loaded up front, so that there's a coarse fallback
+    // for them; see Map::setParentTilePrefetch().
+    std::set<OverscaledTileID> parentTiles;
+    if (parameters.prefetchParents) {
+        for (const auto& tileID : idealTiles) {
+            for (const int32_t delta : { PARENT_PREFETCH_ZOOM_DELTA, 2 * PARENT_PREFETCH_ZOOM_DELTA }) {
+                const int32_t parentZoom = tileID.canonical.z - delta;
+                if (parentZoom >= zoomRange.min) {
+                    parentTiles.emplace(parentZoom, tileID.canonical.scaledTo(parentZoom));
+                }
+            }
+        }
+    }
 
-    auto retainTileFn = [&retain](Tile& tile, Resource::Necessity necessity) -> void {
+    auto retainTileFn = [this, &retain, &parentTiles](Tile& tile, Resource::Necessity necessity) -> void {
         retain.emplace(tile.id);
+        // Ideal tiles are required; the optional ones fill in while ideal tiles are loading.
+        if (necessity == Resource::Necessity::Required) {
+            requiredTiles.emplace(tile.id);
+            tile.setPriority(Tile::Priority::Visible);
+        } else {
+            tile.setPriority(Tile::Priority::Fallback);
+            // Parents that are loaded up front stay required when they fill in for their children.
+            if (parentTiles.count(tile.id)) {
+                necessity = Resource::Necessity::Required;
+            }
+        }
         tile.setNecessity(necessity);
     };
     auto getTileFn = [this](const OverscaledTileID& tileID) -> Tile* {
@@ -117,8 +311,15 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         return it == tiles.end() ? nullptr : it->second.get();
     };
     auto createTileFn = [this, &parameters](const OverscaledTileID& tileID) -> Tile* {
+        // Only fallback and prefetched tiles are removed, and the ideal tiles haven't changed since.
+        if (removedTiles.count(tileID)) {
+            return nullptr;
+        }
         std::unique_ptr<Tile> tile = cache.get(tileID);
-        if (!tile) {
+        if (tile) {
+            // It may have been cached with released buckets.
+            bucketsReleased = true;
+        } else {
             tile = createTile(tileID, parameters);
             if (tile) {
                 tile->setObserver(this);
@@ -129,21 +330,85 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
         }
         return tiles.emplace(tileID, std::move(tile)).first->second.get();
     };
-    auto renderTileFn = [this](const UnwrappedTileID& tileID, Tile& tile) {
-        renderTiles.emplace(tileID, RenderTile{ tileID, tile });
+    std::map<UnwrappedTileID, RenderTile> newRenderTiles;
+    auto renderTileFn = [&newRenderTiles](const UnwrappedTileID& tileID, Tile& tile) {
+        newRenderTiles.emplace(tileID, RenderTile{ tileID, tile });
     };
 
-    renderTiles.clear();
-    algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
-                                 idealTiles, zoomRange, tileZoom);
+    // The parents need to exist for updateRenderables() to fall back to them.
+    for (const auto& tileID : parentTiles) {
+        if (!getTileFn(tileID)) {
+            createTileFn(tileID);
+        }
+    }
 
-    if (type != SourceType::Raster && type != SourceType::Annotations && cache.getSize() == 0) {
-        size_t conservativeCacheSize =
-            ((float)parameters.transformState.getWidth() / util::tileSize) *
-            ((float)parameters.transformState.getHeight() / util::tileSize) *
-            (parameters.transformState.getMaxZoom() - parameters.transformState.getMinZoom() + 1) *
-            0.5;
-        cache.setSize(conservativeCacheSize);
+    if (parameters.tileLevelOfDetail) {
+        // Ideal tiles at lower zoom levels are overscaled as much as the ones at the ideal zoom.
+        std::map<uint8_t, std::vector<UnwrappedTileID>> idealTilesByZoom;
+        for (const auto& tileID : idealTiles) {
+            idealTilesByZoom[tileID.canonical.z].push_back(tileID);
+        }
+        for (const auto& pair : idealTilesByZoom) {
+            algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
+                                         pair.second, zoomRange, tileZoom - (idealZoom - pair.first));
+        }
+    } else {
+        algorithm::updateRenderables(getTileFn, createTileFn, retainTileFn, renderTileFn,
+                                     idealTiles, zoomRange, tileZoom);
+    }
+
+    // The parents that no ideal tile falls back to are loaded all the same, soon after the ideal
+    // tiles themselves.
+    for (const auto& tileID : parentTiles) {
+        Tile* tile = getTileFn(tileID);
+        if (tile && !retain.count(tileID)) {
+            retainTileFn(*tile, Resource::Necessity::Optional);
+        }
+    }
+
+    // The tiles that the camera's animation passes over and lands on, or that panning is headed
+    // for, are loaded at a low priority after the ones needed now: at most about two screenfuls,
+    // nearest to the camera's current position first.
+    std::size_t prefetchBudget = 2 * idealTiles.size();
+    for (const auto& state : parameters.prefetchStates) {
+        const int32_t stateOverscaledZoom = util::coveringZoomLevel(state.getZoom(), type, tileSize);
+        const int32_t stateIdealZoom = std::min<int32_t>(zoomRange.max, stateOverscaledZoom);
+        if (stateOverscaledZoom < zoomRange.min) {
+            continue;
+        }
+        const int32_t stateTileZoom = type == SourceType::Raster ? stateIdealZoom : stateOverscaledZoom;
+
+        for (const auto& tileID : util::tileCover(state, stateIdealZoom)) {
+            const OverscaledTileID dataTileID(stateTileZoom, tileID.canonical);
+            if (!prefetchBudget) {
+                break;
+            }
+            if (retain.count(dataTileID)) {
+                continue;
+            }
+            Tile* tile = getTileFn(dataTileID);
+            if (!tile) {
+                tile = createTileFn(dataTileID);
+            }
+            if (tile) {
+                retain.emplace(dataTileID);
+                tile->setPriority(Tile::Priority::Prefetch);
+                tile->setNecessity(Resource::Necessity::Required);
+                prefetchBudget--;
+            }
+        }
+    }
+
+    // Keep the existing render tiles if the same tiles are rendered again, e.g. while panning
+    // within them, so that render data referring to them stays valid.
+    const bool renderTilesChanged = !std::equal(
+        renderTiles.begin(), renderTiles.end(), newRenderTiles.begin(), newRenderTiles.end(),
+        [] (const auto& a, const auto& b) {
+            return a.first == b.first && &a.second.tile == &b.second.tile;
+        });
+    if (renderTilesChanged) {
+        renderTiles = std::move(newRenderTiles);
+        renderTilesGeneration++;
     }
 
     // Remove stale tiles. This goes through the (sorted!) tiles map and retain set in lockstep
@@ -152,8 +417,14 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
     auto retainIt = retain.begin();
     while (tilesIt != tiles.end()) {
         if (retainIt == retain.end() || tilesIt->first < *retainIt) {
-            tilesIt->second->setNecessity(Tile::Necessity::Optional);
-            cache.add(tilesIt->first, std::move(tilesIt->second));
+            // Tiles whose data hasn't loaded yet are no use in the cache. Dropping them cancels
+            // their requests right away, freeing connections for the tiles in view.
+            if (!tilesIt->second->isLoading()) {
+                tilesIt->second->setNecessity(Tile::Necessity::Optional);
+                tilesIt->second->setPriority(Tile::Priority::Cached);
+                tilesIt->second->setPlacementGroup(nullptr);
+                cache.add(tilesIt->first, std::move(tilesIt->second));
+            }
             tiles.erase(tilesIt++);
         } else {
             if (!(*retainIt < tilesIt->first)) {
@@ -162,26 +433,18 @@ void Source::Impl::updateTiles(const UpdateParameters& parameters) {
             ++retainIt;
         }
     }
-
-    const PlacementConfig config { parameters.transformState.getAngle(),
-                                   parameters.transformState.getPitch(),
-                                   parameters.debugOptions & MapDebugOptions::Collision };
-
-    for (auto& pair : tiles) {
-        pair.second->setPlacementConfig(config);
-    }
 }
 
-void Source::Impl::reloadTiles() {
+void Source::Impl::reloadTiles(const std::unordered_set<std::string>& layerIDs) {
     cache.clear();
 
     for (auto& pair : tiles) {
-        pair.second->redoLayout();
+        pair.second->redoLayout(layerIDs);
     }
 }
 
-std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRenderedFeatures(const QueryParameters& parameters) const {
-    std::unordered_map<std::string, std::vector<Feature>> result;
+IndexedRenderedFeatures Source::Impl::queryRenderedFeatures(const QueryParameters& parameters) const {
+    IndexedRenderedFeatures result;
     if (renderTiles.empty() || parameters.geometry.empty()) {
         return result;
     }
@@ -222,12 +485,118 @@ std::unordered_map<std::string, std::vector<Feature>> Source::Impl::queryRendere
     return result;
 }
 
+std::vector<Feature> Source::Impl::querySourceFeatures(const std::string& sourceLayer,
+                                                      const Filter& filter,
+                                                      Scheduler& scheduler) const {
+    std::vector<Tile*> scanned;
+    std::set<CanonicalTileID> canonical;
+    for (const auto& pair : tiles) {
+        if (pair.second->isRenderable() && canonical.insert(pair.first.canonical).second) {
+            scanned.push_back(pair.second.get());
+        }
+    }
+
+    const CompiledFilter compiled(filter);
+    std::vector<std::vector<Feature>> results(scanned.size());
+    actor::parallelFor(scheduler, scanned.size(), [&] (std::size_t i) {
+        scanned[i]->querySourceFeatures(results[i], sourceLayer, compiled);
+    });
+
+    std::vector<Feature> result;
+    std::set<FeatureIdentifier> ids;
+    for (auto& features : results) {
+        for (auto& feature : features) {
+            if (!feature.id || ids.insert(*feature.id).second) {
+                result.push_back(std::move(feature));
+            }
+        }
+    }
+    return result;
+}
+
 void Source::Impl::setCacheSize(size_t size) {
     cache.setSize(size);
 }
 
-void Source::Impl::onLowMemory() {
-    cache.clear();
+void Source::Impl::setCacheBytes(size_t bytes) {
+    cache.setMaxBytes(bytes);
+}
+
+MemoryUsage Source::Impl::getMemoryUsage() const {
+    MemoryUsage usage = cache.getMemoryUsage();
+    for (const auto& pair : tiles) {
+        usage += pair.second->getMemoryUsage();
+    }
+    return usage;
+}
+
+MemoryReport::Source Source::Impl::getMemoryReport() const {
+    MemoryReport::Source report;
+    report.sourceID = id;
+    for (const auto& pair : tiles) {
+        pair.second->reportMemoryUsage(report.tiles);
+    }
+    cache.reportMemoryUsage(report.cached);
+    report.index.cpu = getIndexMemoryUsage();
+    return report;
+}
+
+optional<TimePoint> Source::Impl::getOldestCachedTileTime() const {
+    return cache.getOldestTime();
+}
+
+MemoryUsage Source::Impl::evictOldestCachedTile() {
+    return cache.evictOldest();
+}
+
+std::vector<std::pair<double, const Tile*>>
+Source::Impl::getUnrenderedTiles(const TransformState& state) const {
+    std::set<const Tile*> rendered;
+    for (const auto& pair : renderTiles) {
+        rendered.insert(&pair.second.tile);
+    }
+
+    const LatLng center = state.getLatLng();
+    std::vector<std::pair<double, const Tile*>> result;
+    for (const auto& pair : tiles) {
+        if (requiredTiles.count(pair.first) || rendered.count(pair.second.get())) {
+            continue;
+        }
+        const CanonicalTileID& canonical = pair.first.canonical;
+        const double scale = std::pow(2.0, canonical.z);
+        const TileCoordinatePoint point = TileCoordinate::fromLatLng(canonical.z, center).p;
+        const double dx = (canonical.x + 0.5 - point.x) / scale;
+        const double dy = (canonical.y + 0.5 - point.y) / scale;
+        result.emplace_back(dx * dx + dy * dy, pair.second.get());
+    }
+    return result;
+}
+
+MemoryUsage Source::Impl::removeUnrenderedTile(const Tile& tile) {
+    auto it = tiles.find(tile.id);
+    if (it == tiles.end() || it->second.get() != &tile) {
+        return {};
+    }
+    const MemoryUsage usage = tile.getMemoryUsage();
+    removedTiles.insert(tile.id);
+    retainedTiles.erase(tile.id);
+    tiles.erase(it);
+    tilesChanged = true;
+    return usage;
+}
+
+MemoryUsage Source::Impl::releaseHiddenBuckets(const std::vector<const Layer*>& layers, float zoom) {
+    const std::set<std::string> hidden = bucketNames(layers, base.getID(), zoom, false);
+    MemoryUsage usage;
+    if (hidden.empty()) {
+        return usage;
+    }
+    for (auto& pair : tiles) {
+        const MemoryUsage released = pair.second->releaseBuckets(hidden);
+        bucketsReleased |= released.total() > 0;
+        usage += released;
+    }
+    return usage;
 }
 
 void Source::Impl::setObserver(SourceObserver* observer_) {
@@ -235,10 +604,14 @@ void Source::Impl::setObserver(SourceObserver* observer_) {
 }
 
 void Source::Impl::onTileChanged(Tile& tile) {
+    renderTilesGeneration++;
+    tilesChanged = true;
     observer->onTileChanged(base, tile.id);
 }
 
 void Source::Impl::onTileError(Tile& tile, std::exception_ptr error) {
+    renderTilesGeneration++;
+    tilesChanged = true;
     observer->onTileError(base, tile.id, error);
 }
 
@@ -246,6 +619,11 @@ void Source::Impl::dumpDebugLogs() const {
     Log::Info(Event::General, "Source::id: %s", base.getID().c_str());
     Log::Info(Event::General, "Source::loaded: %d", loaded);
 
+    const MemoryUsage usage = getMemoryUsage();
+    const MemoryUsage cached = cache.getMemoryUsage();
+    Log::Info(Event::General, "Source::memoryUsage: %zu bytes (%zu GPU), %zu bytes cached",
+              usage.total(), usage.gpu, cached.total());
+
     for (const auto& pair : tiles) {
         pair.second->dumpDebugLogs();
     }
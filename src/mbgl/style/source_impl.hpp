@@ -6,17 +6,23 @@
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/tile_cache.hpp>
+#include <mbgl/text/placement_config.hpp>
 #include <mbgl/style/types.hpp>
+#include <mbgl/style/filter.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/mat4.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/range.hpp>
+#include <mbgl/util/tile_cover.hpp>
+#include <mbgl/actor/actor.hpp>
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <map>
+#include <set>
 
 namespace mbgl {
 
@@ -24,6 +30,7 @@ class Painter;
 class FileSource;
 class TransformState;
 class RenderTile;
+class CrossTilePlacementWorker;
 
 namespace algorithm {
 class ClipIDGenerator;
@@ -41,6 +48,10 @@ public:
     ~Impl() override;
 
     virtual void loadDescription(FileSource&) = 0;
+
+    // Starts the request for a description that's given by URL ahead of the first layout.
+    // Descriptions given inline are only loaded once a layer that uses them is rendered.
+    virtual void prefetchDescription(FileSource&) {}
     bool isLoaded() const;
 
     // Called when the camera has changed or icons or glyphs are loaded. May load new
@@ -48,22 +59,67 @@ public:
     // re-placement of existing complete tiles.
     void updateTiles(const UpdateParameters&);
 
-    // Request that all loaded tiles re-run the layout operation on the existing source
-    // data with fresh style information.
-    void reloadTiles();
+    // Request that the loaded tiles that any of the given layers apply to re-run the layout
+    // operation on the existing source data with fresh style information.
+    void reloadTiles(const std::unordered_set<std::string>& layerIDs);
+
+    // Assigns the clip IDs of the render tiles. They stay valid for as long as the render tiles
+    // of all sources that the generator is used for stay the same.
+    void updateClipIDs(algorithm::ClipIDGenerator&);
 
-    void startRender(algorithm::ClipIDGenerator&,
-                     const mat4& projMatrix,
-                     const TransformState&);
+    void startRender(const mat4& projMatrix, const TransformState&);
     void finishRender(Painter&);
 
+    // Marks the render tiles that cover at most `minArea` square pixels of the viewport as culled,
+    // using the matrices computed by startRender(). Returns their number.
+    std::size_t cullRenderTiles(const TransformState&, double minArea);
+
     const std::map<UnwrappedTileID, RenderTile>& getRenderTiles() const;
 
-    std::unordered_map<std::string, std::vector<Feature>>
+    // Changes whenever the render tiles, or the buckets of their tiles, change. The render tiles
+    // themselves stay at the same addresses for as long as it doesn't.
+    uint64_t getRenderTilesGeneration() const { return renderTilesGeneration; }
+
+    // Tiles whose buckets still need to be uploaded, including ones that aren't renderable yet
+    // for that reason.
+    std::vector<Tile*> getTilesNeedingUpload() const;
+
+    std::unordered_map<std::string, std::vector<IndexedRenderedFeature>>
     queryRenderedFeatures(const QueryParameters&) const;
 
+    // The features of a layer of the source's loaded tiles that pass the filter, scanned on the
+    // threads of the scheduler, a tile at a time. Each tile of the source's data is only scanned
+    // once, however many zoom levels it's overscaled to, and features with an ID are only
+    // returned once, whichever tiles they're split across.
+    std::vector<Feature> querySourceFeatures(const std::string& sourceLayer, const Filter&, Scheduler&) const;
+
     void setCacheSize(size_t);
-    void onLowMemory();
+    void setCacheBytes(size_t);
+
+    // The memory held by the source's tiles, including the cached ones.
+    MemoryUsage getMemoryUsage() const;
+
+    // The tiles of the source and its cache, and the memory they and the source's index hold; see
+    // Map::getMemoryReport().
+    MemoryReport::Source getMemoryReport() const;
+
+    // An estimate of the memory held by the source's own index of its features, if it has one.
+    virtual std::size_t getIndexMemoryUsage() const { return 0; }
+
+    // Used by Style::reduceTileMemoryUsage(), in order of preference. Each returns the memory it
+    // released.
+    optional<TimePoint> getOldestCachedTileTime() const;
+    MemoryUsage evictOldestCachedTile();
+
+    // The tiles that are only retained as fallbacks while the ideal tiles load, or prefetched for
+    // the camera's animation, and aren't rendered, with their squared distance from the center of the map at zoom level 0. A removed
+    // one isn't loaded again until the ideal tiles change.
+    std::vector<std::pair<double, const Tile*>> getUnrenderedTiles(const TransformState&) const;
+    MemoryUsage removeUnrenderedTile(const Tile&);
+
+    // Releases the buckets of the source's layers that aren't rendered at the given zoom level.
+    // They're laid out again once the layers are rendered.
+    MemoryUsage releaseHiddenBuckets(const std::vector<const Layer*>&, float zoom);
 
     void setObserver(SourceObserver*);
     void dumpDebugLogs() const;
@@ -80,24 +136,64 @@ public:
     // called before Style::recalculate().
     bool enabled = true;
 
+    // See Source::setTileTextureCaching().
+    bool tileTextureCaching = false;
+
 protected:
     void invalidateTiles();
 
     Source& base;
     SourceObserver* observer = nullptr;
+
+    // Created when cross-tile placement is first enabled; declared before the tiles that refer to it.
+    std::unique_ptr<Actor<CrossTilePlacementWorker>> placementGroup;
+    std::set<OverscaledTileID> placementGroupTiles;
+
+    // The placement config the tiles were last given; see UpdateParameters::deferPlacement
+    // and UpdateParameters::cameraMoving.
+    optional<PlacementConfig> placementConfig;
+
     std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
 
-private:
+    // Drops the cached tiles for whose ids `fn` returns true, e.g. because their data changed.
+    template <class Fn>
+    void removeCachedTiles(Fn&& fn) {
+        cache.removeIf(std::forward<Fn>(fn));
+    }
+
     // TileObserver implementation.
     void onTileChanged(Tile&) override;
+
+private:
     void onTileError(Tile&, std::exception_ptr) override;
 
     virtual uint16_t getTileSize() const = 0;
     virtual Range<uint8_t> getZoomRange() = 0;
     virtual std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) = 0;
 
+    // Retains the tiles needed to render the ideal tiles, and the ones to prefetch, updates the
+    // render tiles, and moves all other tiles to the cache.
+    void selectTiles(const UpdateParameters&, const std::vector<UnwrappedTileID>& idealTiles,
+                     int32_t tileZoom, int32_t idealZoom);
+
     std::map<UnwrappedTileID, RenderTile> renderTiles;
+    uint64_t renderTilesGeneration = 0;
     TileCache cache;
+
+    // The ideal tiles are kept in the cover, which is updated incrementally, or, with tile level of
+    // detail, in idealTileIDs.
+    util::TileCover idealCover;
+    std::vector<UnwrappedTileID> idealTileIDs;
+    std::set<OverscaledTileID> retainedTiles;
+    std::set<OverscaledTileID> requiredTiles;
+    std::set<OverscaledTileID> removedTiles;
+    bool bucketsReleased = false;
+
+    // What the last selection of tiles depended on besides the ideal tiles.
+    bool tilesChanged = true;
+    int32_t selectedTileZoom = -1;
+    bool selectedParentTiles = false;
+    bool selectedPrefetchTiles = false;
 };
 
 } // namespace style
@@ -0,0 +1,407 @@
+#include <mbgl/style/sources/geojson_index.hpp>
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/memory_usage.hpp>
+#include <mbgl/util/projection.hpp>
+
+#include <mapbox/geojsonvt/convert.hpp>
+#include <mapbox/geometry/envelope.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
+#include <supercluster.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+using Box = GeoJSONIndex::Box;
+
+Point<double> project(double latitude, double longitude) {
+    const double clamped = util::clamp(latitude, -util::LATITUDE_MAX, util::LATITUDE_MAX);
+    return Projection::project(LatLng(clamped, longitude), 1.0 / util::tileSize);
+}
+
+// The extent of a feature in world coordinates. Features without points have an empty extent,
+// which intersects nothing.
+Box featureBox(const Feature& feature) {
+    const mapbox::geometry::box<double> envelope = mapbox::geometry::envelope(feature.geometry);
+    if (envelope.min.x > envelope.max.x) {
+        return Box { { 1, 1 }, { 0, 0 } };
+    }
+    const Point<double> nw = project(envelope.max.y, envelope.min.x);
+    const Point<double> se = project(envelope.min.y, envelope.max.x);
+    return Box { { nw.x, nw.y }, { se.x, se.y } };
+}
+
+void extend(optional<Box>& bounds, const Box& box) {
+    if (box.min.x > box.max.x) {
+        return;
+    }
+    if (!bounds) {
+        bounds = box;
+        return;
+    }
+    bounds->min.x = std::min(bounds->min.x, box.min.x);
+    bounds->min.y = std::min(bounds->min.y, box.min.y);
+    bounds->max.x = std::max(bounds->max.x, box.max.x);
+    bounds->max.y = std::max(bounds->max.y, box.max.y);
+}
+
+// Besides the feature itself, which is counted with the vector it's in.
+template <class T>
+std::size_t featureBytes(const mapbox::geometry::feature<T>& feature) {
+    std::size_t bytes = feature.properties.size() * sizeof(PropertyMap::value_type);
+    mapbox::geometry::for_each_point(feature.geometry, [&] (const auto& point) {
+        bytes += sizeof(point);
+    });
+    return bytes;
+}
+
+// Tiles near the antimeridian hold the features across it in their buffer.
+bool intersects(const Box& a, const Box& b) {
+    for (double wrap = -1; wrap <= 1; wrap++) {
+        if (a.min.x + wrap <= b.max.x && b.min.x <= a.max.x + wrap &&
+            a.min.y <= b.max.y && b.min.y <= a.max.y) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+const constexpr std::size_t GeoJSONIndex::PartitionSize;
+
+GeoJSONIndex::GeoJSONIndex(const GeoJSONOptions& options_)
+    : options(options_) {
+}
+
+GeoJSONIndex::GeoJSONIndex(const GeoJSONOptions& options_, const GeoJSON& geoJSON)
+    : options(options_) {
+    // A geometry or a feature on its own is a collection of one feature.
+    geoJSON.match(
+        [&] (const mapbox::geometry::geometry<double>& geometry) {
+            add(Feature { geometry, {}, {} });
+        },
+        [&] (const Feature& feature) {
+            add(Feature(feature));
+        },
+        [&] (const FeatureCollection& features) {
+            for (const auto& feature : features) {
+                add(Feature(feature));
+            }
+        });
+    finish();
+}
+
+void GeoJSONIndex::add(Feature&& feature) {
+    const std::size_t partition = addFeature(std::move(feature));
+    if (!options.cluster && partitions[partition].features.size() == PartitionSize) {
+        indexPartitions({ partition });
+    }
+}
+
+void GeoJSONIndex::finish() {
+    // Clusters are only indexed as a whole.
+    std::vector<std::size_t> rest;
+    for (std::size_t i = 0; i < partitions.size(); i++) {
+        if (options.cluster || !partitions[i].index) {
+            rest.push_back(i);
+        }
+    }
+    indexPartitions(std::move(rest));
+}
+
+GeoJSONIndex::~GeoJSONIndex() = default;
+
+std::vector<Box> GeoJSONIndex::updateFeatures(const FeatureCollection& features) {
+    std::vector<std::size_t> changed;
+    std::vector<Box> boxes;
+    boxes.reserve(features.size());
+
+    for (const auto& feature : features) {
+        boxes.push_back(featureBox(feature));
+
+        auto it = feature.id ? featurePartitions.find(*feature.id) : featurePartitions.end();
+        if (it == featurePartitions.end()) {
+            changed.push_back(addFeature(feature));
+            continue;
+        }
+
+        // The feature replaces the one with its id, where it was.
+        FeatureCollection& partitionFeatures = partitions[it->second].features;
+        auto existing = std::find_if(partitionFeatures.begin(), partitionFeatures.end(),
+                                     [&] (const Feature& other) { return other.id == feature.id; });
+        assert(existing != partitionFeatures.end());
+        boxes.push_back(featureBox(*existing));
+        *existing = feature;
+        changed.push_back(it->second);
+    }
+
+    indexPartitions(std::move(changed));
+    removeSlices(boxes);
+    return boxes;
+}
+
+std::vector<Box> GeoJSONIndex::removeFeatures(const std::vector<FeatureIdentifier>& ids) {
+    std::vector<std::size_t> changed;
+    std::vector<Box> boxes;
+
+    for (const auto& featureID : ids) {
+        auto it = featurePartitions.find(featureID);
+        if (it == featurePartitions.end()) {
+            continue;
+        }
+
+        // The other features keep their order, and so the order they're drawn in.
+        FeatureCollection& partitionFeatures = partitions[it->second].features;
+        auto existing = std::find_if(partitionFeatures.begin(), partitionFeatures.end(),
+                                     [&] (const Feature& other) { return other.id && *other.id == featureID; });
+        assert(existing != partitionFeatures.end());
+        boxes.push_back(featureBox(*existing));
+        partitionFeatures.erase(existing);
+
+        changed.push_back(it->second);
+        partitionWithRoom = std::min(partitionWithRoom, it->second);
+        featurePartitions.erase(it);
+    }
+
+    indexPartitions(std::move(changed));
+    removeSlices(boxes);
+    return boxes;
+}
+
+std::size_t GeoJSONIndex::addFeature(Feature feature) {
+    while (partitionWithRoom < partitions.size() &&
+           partitions[partitionWithRoom].features.size() >= PartitionSize) {
+        partitionWithRoom++;
+    }
+    if (partitionWithRoom == partitions.size()) {
+        partitions.emplace_back();
+        partitions.back().features.reserve(PartitionSize);
+    }
+
+    if (feature.id) {
+        featurePartitions[*feature.id] = partitionWithRoom;
+    }
+    partitions[partitionWithRoom].features.push_back(std::move(feature));
+    return partitionWithRoom;
+}
+
+mapbox::geojsonvt::Options GeoJSONIndex::vtOptions(uint8_t maxZoom) const {
+    const double scale = util::EXTENT / util::tileSize;
+
+    mapbox::geojsonvt::Options vtOptions;
+    vtOptions.maxZoom = maxZoom;
+    vtOptions.extent = util::EXTENT;
+    vtOptions.buffer = std::round(scale * options.buffer);
+    vtOptions.tolerance = scale * options.tolerance;
+    return vtOptions;
+}
+
+void GeoJSONIndex::indexPartitions(std::vector<std::size_t> changed) {
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    for (std::size_t index : changed) {
+        Partition& partition = partitions[index];
+        partition.bytes = util::memoryUsage(partition.features);
+        for (const auto& feature : partition.features) {
+            partition.bytes += featureBytes(feature);
+        }
+    }
+
+    if (options.cluster) {
+        // Clusters depend on all of the features, so they're indexed as a whole.
+        if (!clusteringDeferred) {
+            supercluster = cluster(options, getFeatures());
+        }
+        return;
+    }
+
+    // A lazy index only slices the partitions down to the zoom of the slices.
+    const mapbox::geojsonvt::Options partitionOptions =
+        vtOptions(lazy() ? options.lazyZoom : options.maxzoom);
+
+    for (std::size_t index : changed) {
+        Partition& partition = partitions[index];
+        partition.bounds = {};
+        for (const auto& feature : partition.features) {
+            extend(partition.bounds, featureBox(feature));
+        }
+        partition.index = partition.features.empty()
+            ? nullptr
+            : std::make_shared<mapbox::geojsonvt::GeoJSONVT>(partition.features, partitionOptions);
+    }
+}
+
+SuperclusterPointer GeoJSONIndex::cluster(const GeoJSONOptions& options, const FeatureCollection& features) {
+    mapbox::supercluster::Options clusterOptions;
+    clusterOptions.maxZoom = options.clusterMaxZoom;
+    clusterOptions.extent = util::EXTENT;
+    clusterOptions.radius = std::round(util::EXTENT / util::tileSize * options.clusterRadius);
+
+    return std::make_unique<mapbox::supercluster::Supercluster>(features, clusterOptions);
+}
+
+void GeoJSONIndex::deferClustering() {
+    assert(options.cluster);
+    clusteringDeferred = true;
+}
+
+FeatureCollection GeoJSONIndex::getFeatures() const {
+    FeatureCollection features;
+    std::size_t count = 0;
+    for (const auto& partition : partitions) {
+        count += partition.features.size();
+    }
+    features.reserve(count);
+    for (const auto& partition : partitions) {
+        features.insert(features.end(), partition.features.begin(), partition.features.end());
+    }
+    return features;
+}
+
+void GeoJSONIndex::setClusters(SuperclusterPointer supercluster_) {
+    assert(options.cluster);
+    supercluster = std::move(supercluster_);
+}
+
+bool GeoJSONIndex::affects(const CanonicalTileID& tileID, const std::vector<Box>& boxes) const {
+    // Clusters may change anywhere.
+    if (options.cluster) {
+        return true;
+    }
+    const Box box = tileBox(tileID);
+    return std::any_of(boxes.begin(), boxes.end(),
+                       [&] (const Box& other) { return intersects(box, other); });
+}
+
+Box GeoJSONIndex::tileBox(const CanonicalTileID& tileID) const {
+    // Tiles hold the features in their buffer too.
+    const double scale = std::pow(2.0, tileID.z);
+    const double buffer = double(options.buffer) / util::tileSize;
+    return Box { { (tileID.x - buffer) / scale, (tileID.y - buffer) / scale },
+                 { (tileID.x + 1 + buffer) / scale, (tileID.y + 1 + buffer) / scale } };
+}
+
+bool GeoJSONIndex::lazy() const {
+    return !options.cluster && options.lazyMemoryLimit && options.lazyZoom < options.maxzoom;
+}
+
+GeoJSONTileFeatures GeoJSONIndex::getTile(const CanonicalTileID& tileID) {
+    if (options.cluster) {
+        if (!supercluster) {
+            return {};
+        }
+        return { std::make_shared<const mapbox::geometry::feature_collection<int16_t>>(
+            supercluster->getTile(tileID.z, tileID.x, tileID.y)) };
+    }
+
+    if (lazy() && tileID.z > options.lazyZoom) {
+        return getLazyTile(tileID);
+    }
+
+    // The features of the partitions that reach into the tile, in the order of the partitions.
+    // Each part keeps the index of its partition, which holds the features, alive. Geojson-vt
+    // doesn't change a tile once it's made, so workers can read it while others are sliced here.
+    const Box box = tileBox(tileID);
+    GeoJSONTileFeatures parts;
+    for (const auto& partition : partitions) {
+        if (partition.index && intersects(*partition.bounds, box)) {
+            const auto& features = partition.index->getTile(tileID.z, tileID.x, tileID.y).features;
+            if (!features.empty()) {
+                parts.emplace_back(partition.index, &features);
+            }
+        }
+    }
+    return parts;
+}
+
+GeoJSONTileFeatures GeoJSONIndex::getLazyTile(const CanonicalTileID& tileID) {
+    const uint8_t dz = tileID.z - options.lazyZoom;
+    const CanonicalTileID ancestor { options.lazyZoom, tileID.x >> dz, tileID.y >> dz };
+
+    auto it = sliceIndex.find(ancestor);
+    if (it != sliceIndex.end()) {
+        slices.splice(slices.begin(), slices, it->second);
+    } else {
+        // The features that reach into the ancestor, which are all that its descendants hold.
+        const Box box = tileBox(ancestor);
+        FeatureCollection features;
+        std::size_t bytes = 0;
+        for (const auto& partition : partitions) {
+            if (!partition.bounds || !intersects(*partition.bounds, box)) {
+                continue;
+            }
+            for (const auto& feature : partition.features) {
+                if (intersects(featureBox(feature), box)) {
+                    features.push_back(feature);
+                    bytes += featureBytes(feature);
+                }
+            }
+        }
+
+        slices.push_front(Slice {
+            ancestor,
+            features.empty() ? nullptr
+                             : std::make_shared<mapbox::geojsonvt::GeoJSONVT>(features, vtOptions(options.maxzoom)),
+            bytes,
+            {}
+        });
+        sliceIndex.emplace(ancestor, slices.begin());
+        sliceBytes += bytes;
+    }
+
+    Slice& slice = slices.front();
+    if (!slice.index) {
+        return {};
+    }
+
+    // The tile keeps the slice alive, even once it's dropped from the cache.
+    const auto& features = slice.index->getTile(tileID.z, tileID.x, tileID.y).features;
+    GeoJSONTileFeatures parts { { slice.index, &features } };
+    if (slice.tiles.insert(tileID).second) {
+        std::size_t bytes = util::memoryUsage(features);
+        for (const auto& feature : features) {
+            bytes += featureBytes(feature);
+        }
+        slice.bytes += bytes;
+        sliceBytes += bytes;
+    }
+
+    // The slice in use is kept even if it's over the limit on its own.
+    while (sliceBytes > options.lazyMemoryLimit && slices.size() > 1) {
+        sliceBytes -= slices.back().bytes;
+        sliceIndex.erase(slices.back().id);
+        slices.pop_back();
+    }
+
+    return parts;
+}
+
+void GeoJSONIndex::removeSlices(const std::vector<Box>& boxes) {
+    for (auto it = slices.begin(); it != slices.end();) {
+        if (affects(it->id, boxes)) {
+            sliceBytes -= it->bytes;
+            sliceIndex.erase(it->id);
+            it = slices.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::size_t GeoJSONIndex::getMemoryUsage() const {
+    std::size_t bytes = sliceBytes;
+    for (const auto& partition : partitions) {
+        bytes += partition.bytes;
+    }
+    return bytes;
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/box.hpp>
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+// The features of a GeoJSON source, sliced into tiles by geojson-vt, or clustered by supercluster.
+// It doesn't refer to the source, so that it can be built on a worker and then handed over.
+class GeoJSONIndex : private util::noncopyable {
+public:
+    // In world coordinates, from 0 to 1.
+    using Box = mapbox::geometry::box<double>;
+
+    // The features are kept in partitions of up to this many, each with an index of its own for
+    // unclustered sources, so that updating features only slices the partitions that they are
+    // in again. Partitions keep their place, so that they can be refilled.
+    static constexpr std::size_t PartitionSize = 1024;
+
+    GeoJSONIndex(const GeoJSONOptions&, const GeoJSON&);
+    ~GeoJSONIndex();
+
+    // An empty index, to be built from features as they're read: each partition of an unclustered
+    // source is indexed as soon as it's full, and the rest once the index is finished.
+    explicit GeoJSONIndex(const GeoJSONOptions&);
+    void add(Feature&&);
+    void finish();
+
+    // See GeoJSONSource::updateFeatures(). Both return the extents of the features that changed,
+    // before and after.
+    std::vector<Box> updateFeatures(const FeatureCollection&);
+    std::vector<Box> removeFeatures(const std::vector<FeatureIdentifier>&);
+
+    // The parts share the features with the index, and keep them alive while they're used, even
+    // after the index changed.
+    GeoJSONTileFeatures getTile(const CanonicalTileID&);
+
+    // Whether the tile may hold any of the features with these extents.
+    bool affects(const CanonicalTileID&, const std::vector<Box>&) const;
+
+    // An estimate of the memory held by the features, and by the slices of a lazy index, in bytes.
+    std::size_t getMemoryUsage() const;
+
+    // Clusters all of the features at once, as supercluster can't add or remove points.
+    static SuperclusterPointer cluster(const GeoJSONOptions&, const FeatureCollection&);
+
+    // For clustered sources: from now on, updating features leaves the clusters as they are, for
+    // them to be clustered again elsewhere, from getFeatures(), and handed over with
+    // setClusters().
+    void deferClustering();
+    FeatureCollection getFeatures() const;
+    void setClusters(SuperclusterPointer);
+
+private:
+    struct Partition {
+        FeatureCollection features;
+        GeoJSONVTPointer index;
+        optional<Box> bounds;
+        std::size_t bytes = 0;
+    };
+
+    // The features of a tile at `lazyZoom`, indexed to slice its descendants.
+    struct Slice {
+        CanonicalTileID id;
+        GeoJSONVTPointer index;
+        std::size_t bytes;
+        // The tiles sliced so far.
+        std::set<CanonicalTileID> tiles;
+    };
+
+    bool lazy() const;
+    mapbox::geojsonvt::Options vtOptions(uint8_t maxZoom) const;
+    GeoJSONTileFeatures getLazyTile(const CanonicalTileID&);
+    void removeSlices(const std::vector<Box>&);
+
+    std::size_t addFeature(Feature);
+    // Indexes the partitions again after their features changed.
+    void indexPartitions(std::vector<std::size_t>);
+    Box tileBox(const CanonicalTileID&) const;
+
+    const GeoJSONOptions options;
+
+    std::vector<Partition> partitions;
+    // The partitions of the features that have ids.
+    std::map<FeatureIdentifier, std::size_t> featurePartitions;
+    // The partitions before this one are full.
+    std::size_t partitionWithRoom = 0;
+    // Indexes all features, for clustered sources.
+    SuperclusterPointer supercluster;
+    bool clusteringDeferred = false;
+
+    // Most recently used first.
+    std::list<Slice> slices;
+    std::map<CanonicalTileID, std::list<Slice>::iterator> sliceIndex;
+    std::size_t sliceBytes = 0;
+};
+
+} // namespace style
+} // namespace mbgl
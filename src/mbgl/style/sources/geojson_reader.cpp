@@ -0,0 +1,294 @@
+#include <mbgl/style/sources/geojson_reader.hpp>
+
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+#include <exception>
+#include <sstream>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+namespace {
+
+using Array = std::vector<Value>;
+
+double toNumber(const Value& value) {
+    if (value.is<double>()) {
+        return value.get<double>();
+    } else if (value.is<uint64_t>()) {
+        return value.get<uint64_t>();
+    } else if (value.is<int64_t>()) {
+        return value.get<int64_t>();
+    }
+    throw util::Exception("coordinates must be numbers");
+}
+
+const Array& toArray(const Value& value, const char* name) {
+    if (!value.is<Array>()) {
+        throw util::Exception(std::string(name) + " must be an array");
+    }
+    return value.get<Array>();
+}
+
+const Value& member(const PropertyMap& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end()) {
+        throw util::Exception(std::string("GeoJSON object must have \"") + key + "\"");
+    }
+    return it->second;
+}
+
+const std::string& type(const PropertyMap& object) {
+    const Value& value = member(object, "type");
+    if (!value.is<std::string>()) {
+        throw util::Exception("GeoJSON type must be a string");
+    }
+    return value.get<std::string>();
+}
+
+mapbox::geometry::point<double> toPoint(const Value& value) {
+    const Array& position = toArray(value, "position");
+    if (position.size() < 2) {
+        throw util::Exception("position must have two or more elements");
+    }
+    return { toNumber(position[0]), toNumber(position[1]) };
+}
+
+// Converts each element of an array of coordinates.
+template <class T, class Fn>
+T toList(const Value& value, Fn fn) {
+    const Array& array = toArray(value, "coordinates");
+    T result;
+    result.reserve(array.size());
+    for (const auto& element : array) {
+        result.push_back(fn(element));
+    }
+    return result;
+}
+
+template <class T>
+T toPoints(const Value& value) {
+    return toList<T>(value, toPoint);
+}
+
+mapbox::geometry::polygon<double> toPolygon(const Value& value) {
+    return toList<mapbox::geometry::polygon<double>>(value, toPoints<mapbox::geometry::linear_ring<double>>);
+}
+
+mapbox::geometry::geometry<double> toGeometry(const Value& value) {
+    if (!value.is<PropertyMap>()) {
+        throw util::Exception("geometry must be an object");
+    }
+    const PropertyMap& object = value.get<PropertyMap>();
+    const std::string& geometryType = type(object);
+
+    if (geometryType == "GeometryCollection") {
+        mapbox::geometry::geometry_collection<double> geometries;
+        for (const auto& geometry : toArray(member(object, "geometries"), "geometries")) {
+            geometries.push_back(toGeometry(geometry));
+        }
+        return geometries;
+    }
+
+    const Value& coordinates = member(object, "coordinates");
+    if (geometryType == "Point") {
+        return toPoint(coordinates);
+    } else if (geometryType == "MultiPoint") {
+        return toPoints<mapbox::geometry::multi_point<double>>(coordinates);
+    } else if (geometryType == "LineString") {
+        return toPoints<mapbox::geometry::line_string<double>>(coordinates);
+    } else if (geometryType == "MultiLineString") {
+        return toList<mapbox::geometry::multi_line_string<double>>(
+            coordinates, toPoints<mapbox::geometry::line_string<double>>);
+    } else if (geometryType == "Polygon") {
+        return toPolygon(coordinates);
+    } else if (geometryType == "MultiPolygon") {
+        return toList<mapbox::geometry::multi_polygon<double>>(coordinates, toPolygon);
+    }
+    throw util::Exception("unknown geometry type \"" + geometryType + "\"");
+}
+
+// Takes the properties of the feature rather than copying them.
+Feature toFeature(Value&& value) {
+    if (!value.is<PropertyMap>()) {
+        throw util::Exception("feature must be an object");
+    }
+    PropertyMap& object = value.get<PropertyMap>();
+    if (type(object) != "Feature") {
+        throw util::Exception("feature must have type \"Feature\"");
+    }
+
+    Feature feature;
+
+    // Features may have no geometry.
+    auto geometry = object.find("geometry");
+    if (geometry != object.end() && !geometry->second.is<NullValue>()) {
+        feature.geometry = toGeometry(geometry->second);
+    } else {
+        feature.geometry = mapbox::geometry::geometry_collection<double>();
+    }
+
+    auto properties = object.find("properties");
+    if (properties != object.end() && properties->second.is<PropertyMap>()) {
+        feature.properties = std::move(properties->second.get<PropertyMap>());
+    } else if (properties != object.end() && !properties->second.is<NullValue>()) {
+        throw util::Exception("feature properties must be an object");
+    }
+
+    auto id = object.find("id");
+    if (id != object.end()) {
+        if (id->second.is<uint64_t>()) {
+            feature.id = FeatureIdentifier(id->second.get<uint64_t>());
+        } else if (id->second.is<int64_t>()) {
+            feature.id = FeatureIdentifier(id->second.get<int64_t>());
+        } else if (id->second.is<double>()) {
+            feature.id = FeatureIdentifier(id->second.get<double>());
+        } else if (id->second.is<std::string>()) {
+            feature.id = FeatureIdentifier(std::move(id->second.get<std::string>()));
+        }
+    }
+
+    return feature;
+}
+
+// Builds values for the JSON that's read, except for the elements of the "features" of the
+// top-level object, which are each converted to a feature and handed over as soon as they're read.
+class Handler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+public:
+    Handler(const std::function<void (Feature&&)>& fn_) : fn(fn_) {}
+
+    bool Null() { return add(NullValue()); }
+    bool Bool(bool b) { return add(b); }
+    bool Int(int i) { return Int64(i); }
+    bool Uint(unsigned u) { return add(uint64_t(u)); }
+    bool Int64(int64_t i) { return i < 0 ? add(i) : add(uint64_t(i)); }
+    bool Uint64(uint64_t u) { return add(u); }
+    bool Double(double d) { return add(d); }
+
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        return add(std::string(str, length));
+    }
+
+    bool StartObject() {
+        stack.emplace_back(false);
+        return true;
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        stack.back().key.assign(str, length);
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        PropertyMap object = std::move(stack.back().object);
+        stack.pop_back();
+        return add(std::move(object));
+    }
+
+    bool StartArray() {
+        if (stack.size() == 1 && !stack.back().isArray && stack.back().key == "features") {
+            featuresDepth = 2;
+        }
+        stack.emplace_back(true);
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        const bool features = stack.size() == featuresDepth;
+        Array array = std::move(stack.back().array);
+        stack.pop_back();
+        if (features) {
+            featuresDepth = 0;
+            streamed = true;
+        }
+        return add(std::move(array));
+    }
+
+    // Hands over the document once it's read, unless it's a collection, whose features were
+    // handed over while it was read.
+    void finish() {
+        if (!result.is<PropertyMap>()) {
+            throw util::Exception("GeoJSON must be an object");
+        }
+        const std::string& documentType = type(result.get<PropertyMap>());
+        if (documentType == "FeatureCollection") {
+            if (!streamed) {
+                throw util::Exception("FeatureCollection must have an array of features");
+            }
+        } else if (documentType == "Feature") {
+            fn(toFeature(std::move(result)));
+        } else {
+            fn(Feature { toGeometry(result), {}, {} });
+        }
+    }
+
+    std::exception_ptr error;
+
+private:
+    struct Frame {
+        Frame(bool isArray_) : isArray(isArray_) {}
+
+        bool isArray;
+        Array array;
+        PropertyMap object;
+        std::string key;
+    };
+
+    bool add(Value value) {
+        if (stack.empty()) {
+            result = std::move(value);
+            return true;
+        }
+
+        Frame& top = stack.back();
+        if (!top.isArray) {
+            top.object[top.key] = std::move(value);
+        } else if (stack.size() == featuresDepth) {
+            try {
+                fn(toFeature(std::move(value)));
+            } catch (...) {
+                // Stops reading.
+                error = std::current_exception();
+                return false;
+            }
+        } else {
+            top.array.push_back(std::move(value));
+        }
+        return true;
+    }
+
+    const std::function<void (Feature&&)>& fn;
+    std::vector<Frame> stack;
+    Value result;
+
+    // The depth of the frame of the features while they're read, or 0.
+    std::size_t featuresDepth = 0;
+    bool streamed = false;
+};
+
+} // namespace
+
+void readGeoJSON(const std::string& data, const std::function<void (Feature&&)>& fn) {
+    Handler handler(fn);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(data.c_str());
+
+    // Iterative parsing doesn't recurse for nested arrays, so deep coordinates can't overflow the
+    // stack.
+    const rapidjson::ParseResult result = reader.Parse<rapidjson::kParseIterativeFlag>(stream, handler);
+    if (handler.error) {
+        std::rethrow_exception(handler.error);
+    }
+    if (result.IsError()) {
+        std::stringstream message;
+        message << result.Offset() << " - " << rapidjson::GetParseError_En(result.Code());
+        throw GeoJSONSyntaxException(message.str());
+    }
+
+    handler.finish();
+}
+
+} // namespace style
+} // namespace mbgl
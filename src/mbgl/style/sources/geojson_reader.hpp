@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mbgl/util/exception.hpp>
+#include <mbgl/util/feature.hpp>
+
+#include <functional>
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+// The text isn't JSON; the message holds the offset of the error and its description.
+struct GeoJSONSyntaxException : util::Exception {
+    GeoJSONSyntaxException(const std::string& msg) : util::Exception(msg) {}
+};
+
+// Reads GeoJSON with a SAX parser, building each of the features straight from the text, and calling
+// `fn` with it as soon as it's complete, instead of building a document first. Only the feature
+// being read is held in between, so the memory needed on top of the text is about that of the
+// features themselves. A geometry or a feature on its own is read as a collection of one feature.
+//
+// Throws GeoJSONSyntaxException for text that isn't JSON, and util::Exception for JSON that isn't
+// GeoJSON. Either may be thrown after some of the features were read.
+void readGeoJSON(const std::string&, const std::function<void (Feature&&)>& fn);
+
+} // namespace style
+} // namespace mbgl
@@ -18,9 +18,29 @@ void GeoJSONSource::setGeoJSON(const mapbox::geojson::geojson& geoJSON) {
     impl->setGeoJSON(geoJSON);
 }
 
+void GeoJSONSource::setURL(const std::string& url, Scheduler& scheduler) {
+    impl->setURL(url, &scheduler);
+}
+
+void GeoJSONSource::setGeoJSON(const mapbox::geojson::geojson& geoJSON, Scheduler& scheduler) {
+    impl->setGeoJSON(geoJSON, scheduler);
+}
+
+void GeoJSONSource::updateFeatures(const FeatureCollection& features) {
+    impl->updateFeatures(features);
+}
+
+void GeoJSONSource::removeFeatures(const std::vector<FeatureIdentifier>& ids) {
+    impl->removeFeatures(ids);
+}
+
 optional<std::string> GeoJSONSource::getURL() {
     return impl->getURL();
 }
 
+std::size_t GeoJSONSource::getIndexMemoryUsage() const {
+    return impl->getIndexMemoryUsage();
+}
+
 } // namespace style
 } // namespace mbgl
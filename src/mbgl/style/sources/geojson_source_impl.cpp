@@ -1,21 +1,18 @@
-#include <mbgl/platform/log.hpp>
+#include <mbgl/actor/actor.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/style/conversion/geojson.hpp>
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/sources/geojson_source_worker.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/startup_trace.hpp>
 
 #include <mapbox/geojson.hpp>
 #include <mapbox/geojson/rapidjson.hpp>
-#include <mapbox/geojsonvt.hpp>
-#include <mapbox/geojsonvt/convert.hpp>
 #include <supercluster.hpp>
 
-#include <rapidjson/error/en.h>
-
-#include <sstream>
-
 namespace mbgl {
 namespace style {
 namespace conversion {
@@ -36,8 +33,11 @@ GeoJSONSource::Impl::Impl(std::string id_, Source& base_, const GeoJSONOptions o
 
 GeoJSONSource::Impl::~Impl() = default;
 
-void GeoJSONSource::Impl::setURL(std::string url_) {
+void GeoJSONSource::Impl::setURL(std::string url_, Scheduler* scheduler) {
     url = std::move(url_);
+    if (scheduler) {
+        startWorker(*scheduler);
+    }
 
     //Signal that the source description needs a reload
     if (loaded) {
@@ -51,43 +51,167 @@ optional<std::string> GeoJSONSource::Impl::getURL() {
 }
 
 void GeoJSONSource::Impl::setGeoJSON(const GeoJSON& geoJSON) {
-    double scale = util::EXTENT / util::tileSize;
-
-    if (!options.cluster) {
-        mapbox::geojsonvt::Options vtOptions;
-        vtOptions.maxZoom = options.maxzoom;
-        vtOptions.extent = util::EXTENT;
-        vtOptions.buffer = std::round(scale * options.buffer);
-        vtOptions.tolerance = scale * options.tolerance;
-        geoJSONOrSupercluster = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(geoJSON, vtOptions);
-
-    } else {
-        mapbox::supercluster::Options clusterOptions;
-        clusterOptions.maxZoom = options.clusterMaxZoom;
-        clusterOptions.extent = util::EXTENT;
-        clusterOptions.radius = std::round(scale * options.clusterRadius);
-
-        const auto& features = geoJSON.get<mapbox::geometry::feature_collection<double>>();
-        geoJSONOrSupercluster =
-            std::make_unique<mapbox::supercluster::Supercluster>(features, clusterOptions);
-    }
-    
+    // Supersedes the data that the worker may be indexing.
+    correlationID++;
+    setIndex(std::make_unique<GeoJSONIndex>(options, geoJSON));
+}
+
+void GeoJSONSource::Impl::setGeoJSON(const GeoJSON& geoJSON, Scheduler& scheduler) {
+    startWorker(scheduler);
+    indexing = true;
+    pendingChanges.clear();
+    worker->invokeCoalesced(&GeoJSONSourceWorker::index, geoJSON, ++correlationID);
+}
+
+void GeoJSONSource::Impl::startWorker(Scheduler& scheduler) {
+    if (worker && workerScheduler == &scheduler) {
+        return;
+    }
+    workerScheduler = &scheduler;
+    mailbox = std::make_shared<Mailbox>(*util::RunLoop::Get());
+    worker = std::make_unique<Actor<GeoJSONSourceWorker>>(
+        scheduler, ActorRef<GeoJSONSource::Impl>(*this, mailbox), options);
+}
+
+bool GeoJSONSource::Impl::clustersOnWorker() const {
+    return options.cluster && worker;
+}
+
+void GeoJSONSource::Impl::onIndexed(std::unique_ptr<GeoJSONIndex> result, uint64_t resultID) {
+    if (resultID != correlationID) {
+        return;
+    }
+
+    // The features changed since the data was set are changed in the new index as well.
+    if (clustersOnWorker()) {
+        result->deferClustering();
+        if (!pendingChanges.empty()) {
+            scheduleClustering();
+        }
+    }
+    for (const auto& change : pendingChanges) {
+        change.match(
+            [&] (const FeatureCollection& features) { result->updateFeatures(features); },
+            [&] (const std::vector<FeatureIdentifier>& ids) { result->removeFeatures(ids); });
+    }
+    setIndex(std::move(result));
+
+    if (url && !loaded) {
+        loaded = true;
+        observer->onSourceLoaded(base);
+    }
+}
+
+void GeoJSONSource::Impl::onError(std::exception_ptr error, uint64_t resultID) {
+    if (resultID != correlationID) {
+        return;
+    }
+    indexing = false;
+    pendingChanges.clear();
+    observer->onSourceError(base, error);
+}
+
+void GeoJSONSource::Impl::onClustered(SuperclusterPointer clusters, uint64_t resultID, uint64_t resultClusterID) {
+    if (resultID != correlationID || resultClusterID <= shownClusterID || !index) {
+        return;
+    }
+    shownClusterID = resultClusterID;
+    index->setClusters(std::move(clusters));
+    reloadTiles({});
+}
+
+void GeoJSONSource::Impl::scheduleClustering() {
+    if (clusteringScheduled) {
+        return;
+    }
+    clusteringScheduled = true;
+    ActorRef<GeoJSONSource::Impl>(*this, mailbox).invoke(&GeoJSONSource::Impl::startClustering);
+}
+
+void GeoJSONSource::Impl::startClustering() {
+    clusteringScheduled = false;
+    if (!index || !worker) {
+        return;
+    }
+    // Only the latest features that the worker hasn't started on yet are clustered.
+    worker->invokeCoalesced(&GeoJSONSourceWorker::cluster, index->getFeatures(), correlationID, ++clusterID);
+}
+
+void GeoJSONSource::Impl::setIndex(std::unique_ptr<GeoJSONIndex> index_) {
+    index = std::move(index_);
+    indexing = false;
+    pendingChanges.clear();
+    // Clusters of the previous index are dropped by their correlation ID.
+    shownClusterID = clusterID;
+    if (clustersOnWorker()) {
+        index->deferClustering();
+    }
+
+    // The tiles keep the previous data until now.
     for (auto const &item : tiles) {
         GeoJSONTile* geoJSONTile = static_cast<GeoJSONTile*>(item.second.get());
         setTileData(*geoJSONTile, geoJSONTile->id);
     }
 }
 
+void GeoJSONSource::Impl::updateFeatures(const FeatureCollection& features) {
+    if (!index) {
+        index = std::make_unique<GeoJSONIndex>(options, GeoJSON{ FeatureCollection{} });
+    }
+    if (indexing) {
+        pendingChanges.emplace_back(features);
+    }
+    if (clustersOnWorker()) {
+        // The tiles keep the clusters they have until the new ones are ready.
+        index->deferClustering();
+        index->updateFeatures(features);
+        scheduleClustering();
+        return;
+    }
+    reloadTiles(index->updateFeatures(features));
+}
+
+void GeoJSONSource::Impl::removeFeatures(const std::vector<FeatureIdentifier>& ids) {
+    if (!index) {
+        return;
+    }
+    if (indexing) {
+        pendingChanges.emplace_back(ids);
+    }
+    if (clustersOnWorker()) {
+        index->deferClustering();
+        index->removeFeatures(ids);
+        scheduleClustering();
+        return;
+    }
+    reloadTiles(index->removeFeatures(ids));
+}
+
+void GeoJSONSource::Impl::reloadTiles(const std::vector<GeoJSONIndex::Box>& boxes) {
+    auto changed = [&] (const OverscaledTileID& tileID) {
+        return index->affects(tileID.canonical, boxes);
+    };
+
+    for (auto const &item : tiles) {
+        if (changed(item.first)) {
+            GeoJSONTile* geoJSONTile = static_cast<GeoJSONTile*>(item.second.get());
+            setTileData(*geoJSONTile, geoJSONTile->id);
+        }
+    }
+    removeCachedTiles(changed);
+}
+
 void GeoJSONSource::Impl::setTileData(GeoJSONTile& tile, const OverscaledTileID& tileID) {
-    if (geoJSONOrSupercluster.is<GeoJSONVTPointer>()) {
-        tile.updateData(geoJSONOrSupercluster.get<GeoJSONVTPointer>()->getTile(tileID.canonical.z,
-                                                                               tileID.canonical.x,
-                                                                               tileID.canonical.y).features);
-    } else {
-        assert(geoJSONOrSupercluster.is<SuperclusterPointer>());
-        tile.updateData(geoJSONOrSupercluster.get<SuperclusterPointer>()->getTile(tileID.canonical.z,
-                                                                                  tileID.canonical.x,
-                                                                                  tileID.canonical.y));
+    tile.updateData(index ? index->getTile(tileID.canonical) : GeoJSONTileFeatures());
+}
+
+std::size_t GeoJSONSource::Impl::getIndexMemoryUsage() const {
+    return index ? index->getMemoryUsage() : 0;
+}
+
+void GeoJSONSource::Impl::prefetchDescription(FileSource& fileSource) {
+    if (url) {
+        loadDescription(fileSource);
     }
 }
 
@@ -101,7 +225,13 @@ void GeoJSONSource::Impl::loadDescription(FileSource& fileSource) {
         return;
     }
 
-    req = fileSource.request(Resource::source(*url), [this](Response res) {
+    const TimePoint begin = Clock::now();
+    req = fileSource.request(Resource::source(*url), [this, begin](Response res) {
+        // Only the request; the data may be indexed on a worker.
+        if (!res.error && !res.notModified && !res.noContent) {
+            StartupTrace::record("source " + id, begin, Clock::now(), { "style parse" });
+        }
+
         if (res.error) {
             observer->onSourceError(
                 base, std::make_exception_ptr(std::runtime_error(res.error->message)));
@@ -110,31 +240,23 @@ void GeoJSONSource::Impl::loadDescription(FileSource& fileSource) {
         } else if (res.noContent) {
             observer->onSourceError(
                 base, std::make_exception_ptr(std::runtime_error("unexpectedly empty GeoJSON")));
+        } else if (worker) {
+            // The source is loaded once the worker has indexed the data; the tiles keep the
+            // data of the previous URL until then.
+            indexing = true;
+            pendingChanges.clear();
+            worker->invokeCoalesced(&GeoJSONSourceWorker::parse, res.data, ++correlationID);
+            req.reset();
         } else {
-            rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> d;
-            d.Parse<0>(res.data->c_str());
-
-            if (d.HasParseError()) {
-                std::stringstream message;
-                message << d.GetErrorOffset() << " - "
-                        << rapidjson::GetParseError_En(d.GetParseError());
-                observer->onSourceError(base,
-                                        std::make_exception_ptr(std::runtime_error(message.str())));
+            auto result = indexGeoJSON(options, *res.data);
+            if (result.is<std::exception_ptr>()) {
+                observer->onSourceError(base, result.get<std::exception_ptr>());
                 return;
             }
 
             invalidateTiles();
-
-            conversion::Result<GeoJSON> geoJSON = conversion::convertGeoJSON<JSValue>(d);
-            if (!geoJSON) {
-                Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s",
-                           geoJSON.error().message.c_str());
-                // Create an empty GeoJSON VT object to make sure we're not infinitely waiting for
-                // tiles to load.
-                setGeoJSON(GeoJSON{ FeatureCollection{} });
-            } else {
-                setGeoJSON(*geoJSON);
-            }
+            correlationID++;
+            setIndex(std::move(result.get<std::unique_ptr<GeoJSONIndex>>()));
 
             loaded = true;
             observer->onSourceLoaded(base);
@@ -1,28 +1,49 @@
 #pragma once
 
 #include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/sources/geojson_index.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
-#include <mbgl/util/variant.hpp>
 #include <mbgl/tile/geojson_tile.hpp>
+#include <mbgl/util/variant.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
 
 namespace mbgl {
 
 class AsyncRequest;
+class Mailbox;
+class Scheduler;
+template <class> class Actor;
 
 namespace style {
 
+class GeoJSONSourceWorker;
+
 class GeoJSONSource::Impl : public Source::Impl {
 public:
     Impl(std::string id, Source&, const GeoJSONOptions);
     ~Impl() final;
 
-    void setURL(std::string);
+    void setURL(std::string, Scheduler* = nullptr);
     optional<std::string> getURL();
 
     void setGeoJSON(const GeoJSON&);
+    void setGeoJSON(const GeoJSON&, Scheduler&);
+    void updateFeatures(const FeatureCollection&);
+    void removeFeatures(const std::vector<FeatureIdentifier>&);
     void setTileData(GeoJSONTile&, const OverscaledTileID& tileID);
+    std::size_t getIndexMemoryUsage() const override;
+
+    // The results of the worker.
+    void onIndexed(std::unique_ptr<GeoJSONIndex>, uint64_t correlationID);
+    void onError(std::exception_ptr, uint64_t correlationID);
+    void onClustered(SuperclusterPointer, uint64_t correlationID, uint64_t clusterID);
 
     void loadDescription(FileSource&) final;
+    void prefetchDescription(FileSource&) final;
 
     uint16_t getTileSize() const final {
         return util::tileSize;
@@ -32,10 +53,41 @@ private:
     Range<uint8_t> getZoomRange() final;
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
 
+    void reloadTiles(const std::vector<GeoJSONIndex::Box>&);
+    void setIndex(std::unique_ptr<GeoJSONIndex>);
+    // Starts the worker on the scheduler, unless it runs there already.
+    void startWorker(Scheduler&);
+
+    // Whether the clusters are rebuilt on the worker when features change.
+    bool clustersOnWorker() const;
+    // Has the worker cluster the features once the changes of this turn of the run loop are made.
+    void scheduleClustering();
+    void startClustering();
+
     GeoJSONOptions options;
     optional<std::string> url;
     std::unique_ptr<AsyncRequest> req;
-    variant<GeoJSONVTPointer, SuperclusterPointer> geoJSONOrSupercluster;
+
+    std::unique_ptr<GeoJSONIndex> index;
+
+    // Where the data is parsed and indexed off this thread; see setGeoJSON(const GeoJSON&,
+    // Scheduler&). Results are only used if they answer the latest request; the data set or
+    // loaded since then replaces them otherwise.
+    Scheduler* workerScheduler = nullptr;
+    std::shared_ptr<Mailbox> mailbox;
+    std::unique_ptr<Actor<GeoJSONSourceWorker>> worker;
+    uint64_t correlationID = 0;
+
+    // The changes made to the features while the worker builds the index, which are made to
+    // the new index again once it's ready.
+    bool indexing = false;
+    std::vector<variant<FeatureCollection, std::vector<FeatureIdentifier>>> pendingChanges;
+
+    // Clusters that the worker builds while features keep changing are still newer than the
+    // ones shown, so a result is used unless a later one was; see onClustered().
+    bool clusteringScheduled = false;
+    uint64_t clusterID = 0;
+    uint64_t shownClusterID = 0;
 };
 
 } // namespace style
@@ -0,0 +1,58 @@
+#include <mbgl/style/sources/geojson_source_worker.hpp>
+#include <mbgl/style/sources/geojson_index.hpp>
+#include <mbgl/style/sources/geojson_reader.hpp>
+#include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/platform/log.hpp>
+
+#include <supercluster.hpp>
+
+namespace mbgl {
+namespace style {
+
+variant<std::unique_ptr<GeoJSONIndex>, std::exception_ptr> indexGeoJSON(const GeoJSONOptions& options,
+                                                                        const std::string& data) {
+    auto index = std::make_unique<GeoJSONIndex>(options);
+    try {
+        readGeoJSON(data, [&] (Feature&& feature) {
+            index->add(std::move(feature));
+        });
+    } catch (const GeoJSONSyntaxException&) {
+        return std::current_exception();
+    } catch (const std::exception& ex) {
+        Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: %s", ex.what());
+        index = std::make_unique<GeoJSONIndex>(options);
+    }
+
+    index->finish();
+    return std::move(index);
+}
+
+GeoJSONSourceWorker::GeoJSONSourceWorker(ActorRef<GeoJSONSourceWorker>,
+                                         ActorRef<GeoJSONSource::Impl> parent_,
+                                         GeoJSONOptions options_)
+    : parent(std::move(parent_)),
+      options(std::move(options_)) {
+}
+
+void GeoJSONSourceWorker::index(GeoJSON geoJSON, uint64_t correlationID) {
+    parent.invoke(&GeoJSONSource::Impl::onIndexed,
+                  std::make_unique<GeoJSONIndex>(options, geoJSON), correlationID);
+}
+
+void GeoJSONSourceWorker::parse(std::shared_ptr<const std::string> data, uint64_t correlationID) {
+    auto result = indexGeoJSON(options, *data);
+    if (result.is<std::exception_ptr>()) {
+        parent.invoke(&GeoJSONSource::Impl::onError, result.get<std::exception_ptr>(), correlationID);
+        return;
+    }
+    parent.invoke(&GeoJSONSource::Impl::onIndexed,
+                  std::move(result.get<std::unique_ptr<GeoJSONIndex>>()), correlationID);
+}
+
+void GeoJSONSourceWorker::cluster(FeatureCollection features, uint64_t correlationID, uint64_t clusterID) {
+    parent.invoke(&GeoJSONSource::Impl::onClustered,
+                  GeoJSONIndex::cluster(options, features), correlationID, clusterID);
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/util/variant.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+class GeoJSONIndex;
+
+// Reads GeoJSON text, and indexes the features as they're read. Fails for text that isn't JSON.
+// JSON that isn't GeoJSON is logged, and yields an empty index, so that the tiles of the source
+// don't wait for data forever.
+variant<std::unique_ptr<GeoJSONIndex>, std::exception_ptr> indexGeoJSON(const GeoJSONOptions&, const std::string&);
+
+// Parses and indexes the data of a GeoJSON source off the thread that owns the source, which large
+// data would otherwise stall. Each result carries the number of the request it answers, so that
+// the source can tell the results of data that was replaced in the meantime.
+class GeoJSONSourceWorker {
+public:
+    GeoJSONSourceWorker(ActorRef<GeoJSONSourceWorker>, ActorRef<GeoJSONSource::Impl>, GeoJSONOptions);
+
+    void index(GeoJSON, uint64_t correlationID);
+    void parse(std::shared_ptr<const std::string> data, uint64_t correlationID);
+
+    // Clusters the features of a clustered source again after they changed.
+    void cluster(FeatureCollection, uint64_t correlationID, uint64_t clusterID);
+
+private:
+    ActorRef<GeoJSONSource::Impl> parent;
+    const GeoJSONOptions options;
+};
+
+} // namespace style
+} // namespace mbgl
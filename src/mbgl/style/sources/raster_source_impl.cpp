@@ -10,9 +10,40 @@ RasterSource::Impl::Impl(std::string id_, Source& base_,
     : TileSourceImpl(SourceType::Raster, std::move(id_), base_, std::move(urlOrTileset_), tileSize_) {
 }
 
+void RasterSource::Impl::onTileChanged(Tile& tile) {
+    // The borders of DEM tiles are backfilled from the neighbours that are loaded when they are,
+    // and the borders of those from them. Raster tiles aren't cached, so the neighbours of a tile
+    // are all in `tiles` when they change.
+    if (tileset.encoding) {
+        auto& demTile = static_cast<RasterTile&>(tile);
+        const CanonicalTileID& canonical = tile.id.canonical;
+        const int64_t dim = int64_t(1) << canonical.z;
+
+        for (int8_t dy = -1; dy <= 1; dy++) {
+            const int64_t y = int64_t(canonical.y) + dy;
+            if (y < 0 || y >= dim) {
+                continue;
+            }
+            for (int8_t dx = -1; dx <= 1; dx++) {
+                // Tiles wrap around the antimeridian.
+                const int64_t x = (int64_t(canonical.x) + dx + dim) % dim;
+                auto it = tiles.find(OverscaledTileID(tile.id.overscaledZ, canonical.z, x, y));
+                if ((!dx && !dy) || it == tiles.end()) {
+                    continue;
+                }
+                auto& neighbor = static_cast<RasterTile&>(*it->second);
+                demTile.backfillBorder(neighbor, dx, dy);
+                neighbor.backfillBorder(demTile, -dx, -dy);
+            }
+        }
+    }
+
+    TileSourceImpl::onTileChanged(tile);
+}
+
 std::unique_ptr<Tile> RasterSource::Impl::createTile(const OverscaledTileID& tileID,
                                                const UpdateParameters& parameters) {
-    return std::make_unique<RasterTile>(tileID, parameters, tileset);
+    return std::make_unique<RasterTile>(tileID, base.getID(), parameters, tileset);
 }
 
 } // namespace style
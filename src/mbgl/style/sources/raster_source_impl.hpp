@@ -11,6 +11,8 @@ public:
     Impl(std::string id, Source&, variant<std::string, Tileset>, uint16_t tileSize);
 
 private:
+    void onTileChanged(Tile&) final;
+
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
 };
 
@@ -1,16 +1,25 @@
 #include <mbgl/style/sources/vector_source_impl.hpp>
 #include <mbgl/tile/vector_tile.hpp>
+#include <mbgl/tile/metatile_file_source.hpp>
+#include <mbgl/style/update_parameters.hpp>
 
 namespace mbgl {
 namespace style {
 
 VectorSource::Impl::Impl(std::string id_, Source& base_, variant<std::string, Tileset> urlOrTileset_)
-    : TileSourceImpl(SourceType::Vector, std::move(id_), base_, std::move(urlOrTileset_), util::tileSize) {
+    : TileSourceImpl(SourceType::Vector, std::move(id_), base_, std::move(urlOrTileset_), util::tileSize),
+      dataCache(std::make_shared<VectorTileDataCache>()) {
 }
 
 std::unique_ptr<Tile> VectorSource::Impl::createTile(const OverscaledTileID& tileID,
                                                      const UpdateParameters& parameters) {
-    return std::make_unique<VectorTile>(tileID, base.getID(), parameters, tileset);
+    if (tileset.metatiles.empty()) {
+        metatileSource.reset();
+    } else if (!metatileSource || !metatileSource->isFor(parameters.fileSource, tileset)) {
+        // Tiles created before keep the previous one until they're gone.
+        metatileSource = std::make_shared<MetatileFileSource>(parameters.fileSource, tileset);
+    }
+    return std::make_unique<VectorTile>(tileID, base.getID(), parameters, tileset, dataCache, metatileSource);
 }
 
 } // namespace style
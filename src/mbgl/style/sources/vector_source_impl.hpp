@@ -3,7 +3,13 @@
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/tile_source_impl.hpp>
 
+#include <memory>
+
 namespace mbgl {
+
+class VectorTileDataCache;
+class MetatileFileSource;
+
 namespace style {
 
 class VectorSource::Impl : public TileSourceImpl {
@@ -12,6 +18,12 @@ public:
 
 private:
     std::unique_ptr<Tile> createTile(const OverscaledTileID&, const UpdateParameters&) final;
+
+    // Shared by the tiles at and beyond the source's maximum zoom.
+    const std::shared_ptr<VectorTileDataCache> dataCache;
+
+    // Shared by the tiles of tilesets with metatiles, so that neighbouring tiles share requests.
+    std::shared_ptr<MetatileFileSource> metatileSource;
 };
 
 } // namespace style
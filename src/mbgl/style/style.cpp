@@ -5,6 +5,7 @@
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/style/layers/custom_layer_impl.hpp>
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/background_layer_impl.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
@@ -13,6 +14,9 @@
 #include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/style/conversion/layer.hpp>
 #include <mbgl/style/query_parameters.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/style/class_dictionary.hpp>
@@ -22,26 +26,128 @@
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
+#include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/renderer/render_item.hpp>
 #include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/map/transform_state.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/platform/log.hpp>
 #include <mbgl/math/minmax.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 
 namespace mbgl {
 namespace style {
 
 static Observer nullObserver;
 
+// Shared by all styles, so that serials stay distinguishable when a map replaces its style.
+static std::atomic<uint64_t> nextSerial { 0 };
+
+struct QueueSourceReloadVisitor {
+    UpdateBatch& updateBatch;
+
+    // No need to reload sources for these types; their visibility can change but
+    // they don't participate in layout.
+    void operator()(CustomLayer&) {}
+    void operator()(DynamicPointLayer&) {}
+    void operator()(RasterLayer&) {}
+    void operator()(BackgroundLayer&) {}
+
+    template <class VectorLayer>
+    void operator()(VectorLayer& layer) {
+        updateBatch.sourceIDs.insert(layer.getSourceID());
+        updateBatch.layerIDs.insert(layer.getID());
+    }
+};
+
+namespace {
+
+const JSValue* findMember(const JSValue* object, const char* name) {
+    if (!object || !object->IsObject() || !object->HasMember(name)) {
+        return nullptr;
+    }
+    return &(*object)[name];
+}
+
+bool sameMember(const JSValue* a, const JSValue* b, const char* name) {
+    const JSValue* aMember = findMember(a, name);
+    const JSValue* bMember = findMember(b, name);
+    return aMember && bMember ? *aMember == *bMember : aMember == bMember;
+}
+
+using LayerDocuments = std::unordered_map<std::string, const JSValue*>;
+
+// The layers of a style document by ID. Of layers with the same ID, the first one counts, like in
+// Parser.
+LayerDocuments findLayers(const JSValue& document) {
+    LayerDocuments result;
+    const JSValue* layers = findMember(&document, "layers");
+    if (!layers || !layers->IsArray()) {
+        return result;
+    }
+    for (rapidjson::SizeType i = 0; i < layers->Size(); ++i) {
+        const JSValue* id = findMember(&(*layers)[i], "id");
+        if (id && id->IsString()) {
+            result.emplace(std::string { id->GetString(), id->GetStringLength() }, &(*layers)[i]);
+        }
+    }
+    return result;
+}
+
+// Follows the refs of a layer to the layer that holds its type, source, filter and layout, or
+// returns nullptr if there is none.
+const JSValue* resolveRef(const LayerDocuments& layers, const JSValue* layer) {
+    for (std::size_t i = 0; layer && i <= layers.size(); ++i) {
+        const JSValue* ref = findMember(layer, "ref");
+        if (!ref) {
+            return layer;
+        }
+        if (!ref->IsString()) {
+            return nullptr;
+        }
+        auto it = layers.find({ ref->GetString(), ref->GetStringLength() });
+        layer = it != layers.end() ? it->second : nullptr;
+    }
+    return nullptr;
+}
+
+// Calls the setter for the properties whose values differ between the old and the new object of
+// layout or paint properties, with null for the ones that the new object lacks.
+template <class Setter>
+void setChangedProperties(const JSValue* oldProperties, const JSValue* newProperties, Setter setProperty) {
+    if (newProperties && newProperties->IsObject()) {
+        for (const auto& property : newProperties->GetObject()) {
+            const JSValue* oldValue = findMember(oldProperties, property.name.GetString());
+            if (!oldValue || *oldValue != property.value) {
+                setProperty(property.name.GetString(), property.value);
+            }
+        }
+    }
+
+    if (oldProperties && oldProperties->IsObject()) {
+        JSValue null;
+        for (const auto& property : oldProperties->GetObject()) {
+            if (!findMember(newProperties, property.name.GetString())) {
+                setProperty(property.name.GetString(), null);
+            }
+        }
+    }
+}
+
+} // namespace
 Style::Style(FileSource& fileSource_, float pixelRatio)
     : fileSource(fileSource_),
       glyphAtlas(std::make_unique<GlyphAtlas>(2048, 2048, fileSource)),
       spriteAtlas(std::make_unique<SpriteAtlas>(1024, 1024, pixelRatio)),
       lineAtlas(std::make_unique<LineAtlas>(256, 512)),
-      observer(&nullObserver) {
+      observer(&nullObserver),
+      styleSerial(++nextSerial) {
     glyphAtlas->setObserver(this);
     spriteAtlas->setObserver(this);
 }
@@ -90,15 +196,18 @@ TransitionOptions Style::getTransitionOptions() const {
     return transitionOptions;
 }
 
-void Style::setJSON(const std::string& json) {
+void Style::setJSON(const std::string& json, Scheduler* scheduler) {
+    invalidateRenderData();
+    recalculateAllLayers = true;
     sources.clear();
     layers.clear();
     classes.clear();
     transitionOptions = {};
     updateBatch = {};
+    loadedJSON.clear();
 
     Parser parser;
-    auto error = parser.parse(json);
+    auto error = parser.parseWithoutLayers(json);
 
     if (error) {
         Log::Error(Event::ParseStyle, "Failed to parse style: %s", util::toString(error).c_str());
@@ -107,10 +216,32 @@ void Style::setJSON(const std::string& json) {
         return;
     }
 
+    // Request the sprite before converting the layers, which takes the longest for big styles.
+    glyphAtlas->setURL(parser.glyphURL);
+    spriteAtlas->load(parser.spriteURL, fileSource, scheduler);
+
     for (auto& source : parser.sources) {
         addSource(std::move(source));
     }
 
+    // Request the TileJSON and GeoJSON of the sources that visible layers use, too, so that
+    // their tiles can be requested as soon as the layers are there.
+    for (const auto& sourceID : parser.visibleLayerSources) {
+        if (Source* source = getSource(sourceID)) {
+            source->baseImpl->prefetchDescription(fileSource);
+        }
+    }
+
+    parser.parseLayers(scheduler);
+
+    // Request the glyphs that the labels of the font stacks will likely need, i.e. basic Latin and
+    // what they needed before, instead of waiting for the first tiles to be laid out.
+    if (!parser.glyphURL.empty()) {
+        for (const auto& fontStack : parser.fontStacks()) {
+            glyphAtlas->prefetchGlyphRanges(fontStack);
+        }
+    }
+
     for (auto& layer : parser.layers) {
         addLayer(std::move(layer));
     }
@@ -121,17 +252,163 @@ void Style::setJSON(const std::string& json) {
     defaultBearing = parser.bearing;
     defaultPitch = parser.pitch;
 
-    glyphAtlas->setURL(parser.glyphURL);
-    spriteAtlas->load(parser.spriteURL, fileSource);
-
+    loadedJSON = json;
     loaded = true;
     
     observer->onStyleLoaded();
 }
 
+bool Style::updateJSON(const std::string& json, Scheduler* scheduler) {
+    if (!loaded || loadedJSON.empty() || isBinaryStyle(loadedJSON) || isBinaryStyle(json)) {
+        return false;
+    }
+
+    JSDocument oldDocument;
+    oldDocument.Parse<0>(loadedJSON.c_str());
+    JSDocument newDocument;
+    newDocument.Parse<0>(json.c_str());
+
+    if (oldDocument.HasParseError() || newDocument.HasParseError() ||
+        !sameMember(&oldDocument, &newDocument, "sprite") ||
+        !sameMember(&oldDocument, &newDocument, "glyphs")) {
+        return false;
+    }
+
+    Parser parser;
+    if (parser.parse(json, scheduler)) {
+        return false;
+    }
+
+    invalidateRenderData();
+    recalculateAllLayers = true;
+    classes.clear();
+    transitionOptions = {};
+
+    // Replace the sources whose description changed, and remove the ones that are gone from the
+    // style. Sources that weren't loaded from its JSON, e.g. the annotations', stay.
+    const JSValue* oldSources = findMember(&oldDocument, "sources");
+    const JSValue* newSources = findMember(&newDocument, "sources");
+    std::set<std::string> sourceIDs;
+    for (auto& source : parser.sources) {
+        const std::string id = source->getID();
+        sourceIDs.insert(id);
+
+        if (findMember(oldSources, id.c_str()) && sameMember(oldSources, newSources, id.c_str()) && getSource(id)) {
+            continue;
+        }
+        if (getSource(id)) {
+            removeSource(id);
+        }
+        addSource(std::move(source));
+    }
+    if (oldSources && oldSources->IsObject()) {
+        for (const auto& source : oldSources->GetObject()) {
+            const std::string id = source.name.GetString();
+            if (!sourceIDs.count(id) && getSource(id)) {
+                removeSource(id);
+            }
+        }
+    }
+
+    const LayerDocuments oldLayerDocuments = findLayers(oldDocument);
+    const LayerDocuments newLayerDocuments = findLayers(newDocument);
+
+    // Take out the layers that were loaded from the JSON, keeping the others, e.g. the
+    // annotations', in their order on top.
+    std::unordered_map<std::string, std::unique_ptr<Layer>> oldLayers;
+    std::vector<std::unique_ptr<Layer>> otherLayers;
+    for (auto& layer : layers) {
+        if (oldLayerDocuments.count(layer->getID()) && !oldLayers.count(layer->getID())) {
+            oldLayers.emplace(layer->getID(), std::move(layer));
+        } else {
+            otherLayers.push_back(std::move(layer));
+        }
+    }
+    layers.clear();
+
+    for (auto& newLayer : parser.layers) {
+        const std::string id = newLayer->getID();
+        const JSValue* oldLayerDocument = oldLayerDocuments.count(id) ? oldLayerDocuments.at(id) : nullptr;
+        const JSValue* newLayerDocument = newLayerDocuments.at(id);
+        const JSValue* oldBase = resolveRef(oldLayerDocuments, oldLayerDocument);
+        const JSValue* newBase = resolveRef(newLayerDocuments, newLayerDocument);
+
+        auto it = oldLayers.find(id);
+        if (it == oldLayers.end() || !oldBase || !newBase ||
+            !sameMember(oldLayerDocument, newLayerDocument, "ref") ||
+            !sameMember(oldBase, newBase, "type") ||
+            !sameMember(oldBase, newBase, "source") ||
+            !sameMember(oldBase, newBase, "source-layer")) {
+            // Layers with a new type or source have to be laid out anew.
+            prepareLayer(*newLayer);
+            newLayer->accept(QueueSourceReloadVisitor { updateBatch });
+            layers.push_back(std::move(newLayer));
+            continue;
+        }
+
+        Layer& layer = *it->second;
+        if (!sameMember(oldBase, newBase, "filter") ||
+            !sameMember(oldBase, newBase, "minzoom") ||
+            !sameMember(oldBase, newBase, "maxzoom")) {
+            layer.baseImpl->filter = newLayer->baseImpl->filter;
+            layer.baseImpl->minZoom = newLayer->baseImpl->minZoom;
+            layer.baseImpl->maxZoom = newLayer->baseImpl->maxZoom;
+            layer.accept(QueueSourceReloadVisitor { updateBatch });
+        }
+
+        setChangedProperties(findMember(oldBase, "layout"), findMember(newBase, "layout"),
+                             [&] (const std::string& propertyName, const JSValue& value) {
+            conversion::setLayoutProperty(layer, propertyName, value);
+        });
+
+        std::set<std::string> paintNames;
+        for (const JSValue* layerDocument : { oldLayerDocument, newLayerDocument }) {
+            for (const auto& member : layerDocument->GetObject()) {
+                const std::string memberName = member.name.GetString();
+                if (memberName.compare(0, 5, "paint") == 0) {
+                    paintNames.insert(memberName);
+                }
+            }
+        }
+        for (const auto& paintName : paintNames) {
+            optional<std::string> klass;
+            if (paintName.compare(0, 6, "paint.") == 0) {
+                klass = paintName.substr(6);
+            }
+            setChangedProperties(findMember(oldLayerDocument, paintName.c_str()),
+                                 findMember(newLayerDocument, paintName.c_str()),
+                                 [&] (const std::string& propertyName, const JSValue& value) {
+                conversion::setPaintProperty(layer, propertyName, value, klass);
+            });
+        }
+
+        layers.push_back(std::move(it->second));
+        oldLayers.erase(it);
+    }
+
+    for (auto& layer : otherLayers) {
+        if (!newLayerDocuments.count(layer->getID())) {
+            layers.push_back(std::move(layer));
+        }
+    }
+
+    name = parser.name;
+    defaultLatLng = parser.latLng;
+    defaultZoom = parser.zoom;
+    defaultBearing = parser.bearing;
+    defaultPitch = parser.pitch;
+
+    loadedJSON = json;
+
+    observer->onStyleLoaded();
+    return true;
+}
+
 void Style::addSource(std::unique_ptr<Source> source) {
     source->baseImpl->setObserver(this);
     sources.emplace_back(std::move(source));
+    invalidateRenderData();
+    recalculateAllLayers = true;
 }
 
 void Style::removeSource(const std::string& id) {
@@ -143,6 +420,8 @@ void Style::removeSource(const std::string& id) {
         throw std::runtime_error("no such source");
     }
 
+    invalidateRenderData();
+    recalculateAllLayers = true;
     sources.erase(it);
     updateBatch.sourceIDs.erase(id);
 }
@@ -170,25 +449,33 @@ Layer* Style::getLayer(const std::string& id) const {
 Layer* Style::addLayer(std::unique_ptr<Layer> layer, optional<std::string> before) {
     // TODO: verify source
 
-    if (SymbolLayer* symbolLayer = layer->as<SymbolLayer>()) {
+    prepareLayer(*layer);
+    invalidateRenderData();
+    recalculateAllLayers = true;
+
+    return layers.emplace(before ? findLayer(*before) : layers.end(), std::move(layer))->get();
+}
+
+void Style::prepareLayer(Layer& layer) {
+    if (SymbolLayer* symbolLayer = layer.as<SymbolLayer>()) {
         if (!symbolLayer->impl->spriteAtlas) {
             symbolLayer->impl->spriteAtlas = spriteAtlas.get();
         }
     }
 
-    if (CustomLayer* customLayer = layer->as<CustomLayer>()) {
+    if (CustomLayer* customLayer = layer.as<CustomLayer>()) {
         customLayer->impl->initialize();
     }
 
-    layer->baseImpl->setObserver(this);
-
-    return layers.emplace(before ? findLayer(*before) : layers.end(), std::move(layer))->get();
+    layer.baseImpl->setObserver(this);
 }
 
 void Style::removeLayer(const std::string& id) {
     auto it = findLayer(id);
     if (it == layers.end())
         throw std::runtime_error("no such layer");
+    invalidateRenderData();
+    recalculateAllLayers = true;
     layers.erase(it);
 }
 
@@ -222,9 +509,10 @@ void Style::relayout() {
     for (const auto& sourceID : updateBatch.sourceIDs) {
         Source* source = getSource(sourceID);
         if (!source) continue;
-        source->baseImpl->reloadTiles();
+        source->baseImpl->reloadTiles(updateBatch.layerIDs);
     }
     updateBatch.sourceIDs.clear();
+    updateBatch.layerIDs.clear();
 }
 
 void Style::cascade(const TimePoint& timePoint, MapMode mode) {
@@ -248,9 +536,43 @@ void Style::cascade(const TimePoint& timePoint, MapMode mode) {
     for (const auto& layer : layers) {
         layer->baseImpl->cascade(parameters);
     }
+    recalculateAllLayers = true;
 }
 
 void Style::recalculate(float z, const TimePoint& timePoint, MapMode mode) {
+    // While the zoom level, the classes and the layers stay the same, and cross-faded properties
+    // are done fading, only the values of transitioning properties change. Other layers keep
+    // theirs, and which layers need rendering and which sources are enabled stay as they are.
+    const bool steady = !recalculateAllLayers && !zoomHistory.first && z == zoomHistory.lastZoom &&
+        (mode != MapMode::Continuous || timePoint >= zoomHistory.lastIntegerZoomTime + util::DEFAULT_FADE_DURATION);
+    if (steady) {
+        if (transitioningLayers.empty()) {
+            return;
+        }
+
+        // The background color may change.
+        invalidateRenderData();
+        zoomHistory.update(z, timePoint);
+
+        const CalculationParameters parameters {
+            z,
+            mode == MapMode::Continuous ? timePoint : Clock::time_point::max(),
+            zoomHistory,
+            mode == MapMode::Continuous ? util::DEFAULT_FADE_DURATION : Duration::zero()
+        };
+
+        transitioningLayers.erase(std::remove_if(transitioningLayers.begin(), transitioningLayers.end(), [&] (Layer* layer) {
+            return !layer->baseImpl->recalculate(parameters);
+        }), transitioningLayers.end());
+        hasPendingTransitions = !transitioningLayers.empty();
+        return;
+    }
+
+    // Which layers need rendering, and the background color, may change.
+    invalidateRenderData();
+    recalculateAllLayers = false;
+    transitioningLayers.clear();
+
     for (const auto& source : sources) {
         source->baseImpl->enabled = false;
     }
@@ -266,7 +588,9 @@ void Style::recalculate(float z, const TimePoint& timePoint, MapMode mode) {
 
     hasPendingTransitions = false;
     for (const auto& layer : layers) {
-        const bool hasTransitions = layer->baseImpl->recalculate(parameters);
+        // Layers whose properties are all constant keep the values they were last calculated.
+        const bool hasTransitions = !layer->baseImpl->hasConstantProperties() &&
+                                    layer->baseImpl->recalculate(parameters);
 
         // Disable this layer if it doesn't need to be rendered.
         const bool needsRendering = layer->baseImpl->needsRendering(zoomHistory.lastZoom);
@@ -275,6 +599,9 @@ void Style::recalculate(float z, const TimePoint& timePoint, MapMode mode) {
         }
 
         hasPendingTransitions |= hasTransitions;
+        if (hasTransitions) {
+            transitioningLayers.push_back(layer.get());
+        }
 
         // If this layer has a source, make sure that it gets loaded.
         if (Source* source = getSource(layer->baseImpl->source)) {
@@ -316,8 +643,44 @@ bool Style::isLoaded() const {
     return true;
 }
 
-RenderData Style::getRenderData(MapDebugOptions debugOptions) const {
-    RenderData result;
+void Style::invalidateRenderData() {
+    renderData.reset();
+    styleSerial = ++nextSerial;
+}
+
+bool Style::isRenderDataCurrent(MapDebugOptions debugOptions) const {
+    if (!renderData || debugOptions != renderDataDebugOptions ||
+        renderDataGenerations.size() != sources.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        if (sources[i]->baseImpl->getRenderTilesGeneration() != renderDataGenerations[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const RenderData& Style::getRenderData(MapDebugOptions debugOptions) const {
+    if (isRenderDataCurrent(debugOptions)) {
+        return *renderData;
+    }
+
+    renderData = std::make_unique<RenderData>();
+    buildRenderData(*renderData, debugOptions);
+    renderData->serial = ++nextSerial;
+    renderData->styleSerial = styleSerial;
+
+    renderDataDebugOptions = debugOptions;
+    renderDataGenerations.clear();
+    for (const auto& source : sources) {
+        renderDataGenerations.push_back(source->baseImpl->getRenderTilesGeneration());
+    }
+
+    return *renderData;
+}
+
+void Style::buildRenderData(RenderData& result, MapDebugOptions debugOptions) const {
 
     for (const auto& source : sources) {
         if (source->baseImpl->enabled) {
@@ -347,7 +710,7 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions) const {
             continue;
         }
 
-        if (layer->is<CustomLayer>()) {
+        if (layer->is<CustomLayer>() || layer->is<DynamicPointLayer>()) {
             result.order.emplace_back(*layer);
             continue;
         }
@@ -389,11 +752,18 @@ RenderData Style::getRenderData(MapDebugOptions debugOptions) const {
             }
         }
     }
+}
 
+std::vector<Feature> Style::queryRenderedFeatures(const QueryParameters& parameters) const {
+    std::vector<Feature> result;
+    queryRenderedFeatures(parameters, [&] (const RenderedFeature& feature) {
+        result.push_back(feature.toFeature());
+        return true;
+    });
     return result;
 }
 
-std::vector<Feature> Style::queryRenderedFeatures(const QueryParameters& parameters) const {
+void Style::queryRenderedFeatures(const QueryParameters& parameters, const RenderedFeatureVisitor& visitor) const {
     std::unordered_set<std::string> sourceFilter;
 
     if (parameters.layerIDs) {
@@ -403,8 +773,7 @@ std::vector<Feature> Style::queryRenderedFeatures(const QueryParameters& paramet
         }
     }
 
-    std::vector<Feature> result;
-    std::unordered_map<std::string, std::vector<Feature>> resultsByLayer;
+    IndexedRenderedFeatures resultsByLayer;
 
     for (const auto& source : sources) {
         if (!sourceFilter.empty() && sourceFilter.find(source->getID()) == sourceFilter.end()) {
@@ -416,21 +785,54 @@ std::vector<Feature> Style::queryRenderedFeatures(const QueryParameters& paramet
     }
 
     if (resultsByLayer.empty()) {
-        return result;
+        return;
     }
 
-    // Combine all results based on the style layer order.
+    // Visit all results based on the style layer order.
     for (const auto& layer : layers) {
         if (!layer->baseImpl->needsRendering(zoomHistory.lastZoom)) {
             continue;
         }
         auto it = resultsByLayer.find(layer->baseImpl->id);
         if (it != resultsByLayer.end()) {
-            std::move(it->second.begin(), it->second.end(), std::back_inserter(result));
+            for (const auto& feature : it->second) {
+                if (!visitor(feature)) {
+                    return;
+                }
+            }
         }
     }
+}
 
-    return result;
+std::vector<Feature> Style::querySourceFeatures(const std::string& sourceID,
+                                                const std::string& sourceLayer,
+                                                const Filter& filter,
+                                                Scheduler& scheduler) const {
+    const Source* source = getSource(sourceID);
+    if (!source) {
+        return {};
+    }
+    return source->baseImpl->querySourceFeatures(sourceLayer, filter, scheduler);
+}
+
+optional<Feature> Style::queryPickedFeature(const std::string& layerID, const UnwrappedTileID& tileID, uint16_t id) const {
+    const Layer* layer = getLayer(layerID);
+    if (!layer) {
+        return {};
+    }
+
+    const Source* source = getSource(layer->baseImpl->source);
+    if (!source) {
+        return {};
+    }
+
+    const auto& renderTiles = source->baseImpl->getRenderTiles();
+    const auto it = renderTiles.find(tileID);
+    if (it == renderTiles.end()) {
+        return {};
+    }
+
+    return it->second.tile.queryPickedFeature(*layer, id);
 }
 
 float Style::getQueryRadius() const {
@@ -444,6 +846,23 @@ float Style::getQueryRadius() const {
     return additionalRadius;
 }
 
+bool Style::setFeatureState(const std::string& sourceID, const FeatureIdentifier& id, const optional<Color>& color) {
+    if (!color && !featureStates.count(sourceID)) {
+        return false;
+    }
+    return featureStates[sourceID].set(id, color);
+}
+
+optional<Color> Style::getFeatureState(const std::string& sourceID, const FeatureIdentifier& id) const {
+    const FeatureStates* states = getFeatureStates(sourceID);
+    return states ? states->get(id) : optional<Color>();
+}
+
+const FeatureStates* Style::getFeatureStates(const std::string& sourceID) const {
+    auto it = featureStates.find(sourceID);
+    return it != featureStates.end() ? &it->second : nullptr;
+}
+
 
 void Style::setSourceTileCacheSize(size_t size) {
     for (const auto& source : sources) {
@@ -451,9 +870,74 @@ void Style::setSourceTileCacheSize(size_t size) {
     }
 }
 
-void Style::onLowMemory() {
+void Style::setSourceTileCacheBytes(size_t bytes) {
     for (const auto& source : sources) {
-        source->baseImpl->onLowMemory();
+        source->baseImpl->setCacheBytes(bytes);
+    }
+}
+
+MemoryUsage Style::getTileMemoryUsage() const {
+    MemoryUsage usage;
+    for (const auto& source : sources) {
+        usage += source->baseImpl->getMemoryUsage();
+    }
+    return usage;
+}
+
+void Style::reportMemoryUsage(MemoryReport& report) const {
+    for (const auto& source : sources) {
+        report.sources.push_back(source->baseImpl->getMemoryReport());
+    }
+    report.glyphAtlas = glyphAtlas->getMemoryUsage();
+    report.spriteAtlas = spriteAtlas->getMemoryUsage();
+    report.lineAtlas = lineAtlas->getMemoryUsage();
+}
+
+void Style::reduceTileMemoryUsage(size_t targetBytes, const TransformState& state) {
+    MemoryUsage usage = getTileMemoryUsage();
+
+    while (usage.total() > targetBytes) {
+        Source::Impl* oldest = nullptr;
+        optional<TimePoint> oldestTime;
+        for (const auto& source : sources) {
+            const auto time = source->baseImpl->getOldestCachedTileTime();
+            if (time && (!oldestTime || *time < *oldestTime)) {
+                oldest = source->baseImpl.get();
+                oldestTime = time;
+            }
+        }
+        if (!oldest) {
+            break;
+        }
+        usage -= oldest->evictOldestCachedTile();
+    }
+
+    if (usage.total() > targetBytes) {
+        std::vector<std::tuple<double, Source::Impl*, const Tile*>> unrendered;
+        for (const auto& source : sources) {
+            for (const auto& pair : source->baseImpl->getUnrenderedTiles(state)) {
+                unrendered.emplace_back(pair.first, source->baseImpl.get(), pair.second);
+            }
+        }
+        std::sort(unrendered.begin(), unrendered.end(), [] (const auto& a, const auto& b) {
+            return std::get<0>(a) > std::get<0>(b);
+        });
+        for (const auto& tile : unrendered) {
+            if (usage.total() <= targetBytes) {
+                break;
+            }
+            usage -= std::get<1>(tile)->removeUnrenderedTile(*std::get<2>(tile));
+        }
+    }
+
+    if (usage.total() > targetBytes) {
+        const std::vector<const Layer*> layerList = getLayers();
+        for (const auto& source : sources) {
+            if (usage.total() <= targetBytes) {
+                break;
+            }
+            usage -= source->baseImpl->releaseHiddenBuckets(layerList, state.getZoom());
+        }
     }
 }
 
@@ -523,21 +1007,6 @@ void Style::onSpriteError(std::exception_ptr error) {
     observer->onResourceError(error);
 }
 
-struct QueueSourceReloadVisitor {
-    UpdateBatch& updateBatch;
-
-    // No need to reload sources for these types; their visibility can change but
-    // they don't participate in layout.
-    void operator()(CustomLayer&) {}
-    void operator()(RasterLayer&) {}
-    void operator()(BackgroundLayer&) {}
-
-    template <class VectorLayer>
-    void operator()(VectorLayer& layer) {
-        updateBatch.sourceIDs.insert(layer.getSourceID());
-    }
-};
-
 void Style::onLayerFilterChanged(Layer& layer) {
     layer.accept(QueueSourceReloadVisitor { updateBatch });
     observer->onUpdate(Update::Layout);
@@ -545,6 +1014,7 @@ void Style::onLayerFilterChanged(Layer& layer) {
 
 void Style::onLayerVisibilityChanged(Layer& layer) {
     layer.accept(QueueSourceReloadVisitor { updateBatch });
+    recalculateAllLayers = true;
     observer->onUpdate(Update::RecalculateStyle | Update::Layout);
 }
 
@@ -557,6 +1027,10 @@ void Style::onLayerLayoutPropertyChanged(Layer& layer) {
     observer->onUpdate(Update::Layout);
 }
 
+void Style::onLayerDataChanged(Layer&) {
+    observer->onUpdate(Update::Repaint);
+}
+
 void Style::dumpDebugLogs() const {
     for (const auto& source : sources) {
         source->baseImpl->dumpDebugLogs();
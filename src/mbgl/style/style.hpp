@@ -5,9 +5,12 @@
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/style/layer_observer.hpp>
 #include <mbgl/style/update_batch.hpp>
+#include <mbgl/style/feature_states.hpp>
+#include <mbgl/style/filter.hpp>
 #include <mbgl/text/glyph_atlas_observer.hpp>
 #include <mbgl/sprite/sprite_atlas_observer.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/query.hpp>
 #include <mbgl/map/zoom_history.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
@@ -15,19 +18,23 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/memory_usage.hpp>
 
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace mbgl {
 
 class FileSource;
+class Scheduler;
 class GlyphAtlas;
 class SpriteAtlas;
 class LineAtlas;
 class RenderData;
+class TransformState;
 
 namespace style {
 
@@ -44,7 +51,14 @@ public:
     Style(FileSource&, float pixelRatio);
     ~Style() override;
 
-    void setJSON(const std::string&);
+    // Loads the style. Its layers are converted on the threads of the scheduler, if one is given.
+    void setJSON(const std::string&, Scheduler* = nullptr);
+
+    // Updates the loaded style to the given JSON with as few changes as possible: sources whose
+    // description didn't change are kept along with their tiles, and layers that keep their type
+    // and source have their changed properties set. Returns false, leaving the style as it is, if
+    // the styles can't be compared or differ in their sprite or glyphs; setJSON() is needed then.
+    bool updateJSON(const std::string&, Scheduler* = nullptr);
 
     void setObserver(Observer*);
 
@@ -90,14 +104,45 @@ public:
     bool hasClass(const std::string&) const;
     std::vector<std::string> getClasses() const;
 
-    RenderData getRenderData(MapDebugOptions) const;
+    // The returned render data stays valid until the next call, or until the style changes.
+    const RenderData& getRenderData(MapDebugOptions) const;
 
     std::vector<Feature> queryRenderedFeatures(const QueryParameters&) const;
 
+    // Visits the features that the above returns, in the same order, until the visitor returns
+    // false.
+    void queryRenderedFeatures(const QueryParameters&, const RenderedFeatureVisitor&) const;
+
+    // The features of a layer of a source's loaded tiles that pass the filter, whether or not any
+    // style layer renders them; see Source::Impl::querySourceFeatures().
+    std::vector<Feature> querySourceFeatures(const std::string& sourceID,
+                                             const std::string& sourceLayer,
+                                             const Filter&,
+                                             Scheduler&) const;
+
+    // The feature that the picking pass drew with the given ID for a layer and render tile.
+    optional<Feature> queryPickedFeature(const std::string& layerID, const UnwrappedTileID&, uint16_t id) const;
+
     float getQueryRadius() const;
 
+    // The states of the features of a source. They're kept by source ID, and survive the source
+    // being removed and added again. Setting them only needs a repaint, never a new layout.
+    bool setFeatureState(const std::string& sourceID, const FeatureIdentifier&, const optional<Color>&);
+    optional<Color> getFeatureState(const std::string& sourceID, const FeatureIdentifier&) const;
+    const FeatureStates* getFeatureStates(const std::string& sourceID) const;
+
     void setSourceTileCacheSize(size_t);
-    void onLowMemory();
+    void setSourceTileCacheBytes(size_t);
+    MemoryUsage getTileMemoryUsage() const;
+
+    // Fills in the sources and atlases of a report; see Map::getMemoryReport().
+    void reportMemoryUsage(MemoryReport&) const;
+
+    // Releases tile memory across all sources until at most `targetBytes` are held: the cached
+    // tiles first, oldest first; then the fallback and prefetched tiles that aren't rendered,
+    // farthest from the center first; then the buckets of layers that aren't rendered at the
+    // current zoom level.
+    void reduceTileMemoryUsage(size_t targetBytes, const TransformState&);
 
     void dumpDebugLogs() const;
 
@@ -110,6 +155,7 @@ private:
     std::vector<std::unique_ptr<Source>> sources;
     std::vector<std::unique_ptr<Layer>> layers;
     std::vector<std::string> classes;
+    std::unordered_map<std::string, FeatureStates> featureStates;
     TransitionOptions transitionOptions;
 
     // Defaults
@@ -119,8 +165,12 @@ private:
     double defaultBearing;
     double defaultPitch;
 
+    // The JSON the style was last loaded from; see updateJSON().
+    std::string loadedJSON;
+
     std::vector<std::unique_ptr<Layer>>::const_iterator findLayer(const std::string& layerID) const;
     void reloadLayerSource(Layer&);
+    void prepareLayer(Layer&);
 
     // GlyphStoreObserver implementation.
     void onGlyphsLoaded(const FontStack&, const GlyphRange&) override;
@@ -143,6 +193,7 @@ private:
     void onLayerVisibilityChanged(Layer&) override;
     void onLayerPaintPropertyChanged(Layer&) override;
     void onLayerLayoutPropertyChanged(Layer&) override;
+    void onLayerDataChanged(Layer&) override;
 
     Observer nullObserver;
     Observer* observer = &nullObserver;
@@ -153,6 +204,24 @@ private:
     ZoomHistory zoomHistory;
     bool hasPendingTransitions = false;
 
+    // The rendered layers whose properties are transitioning, which are the only ones that
+    // recalculate() evaluates again until the zoom level, the classes or the layers change.
+    std::vector<Layer*> transitioningLayers;
+    bool recalculateAllLayers = true;
+
+    // The render data of the last frame, reused for as long as the layers, their properties and
+    // the render tiles of all sources stay the same, e.g. while panning or rotating.
+    mutable std::unique_ptr<RenderData> renderData;
+    mutable MapDebugOptions renderDataDebugOptions = MapDebugOptions::NoDebug;
+    mutable std::vector<uint64_t> renderDataGenerations;
+
+    // Changes along with the sources, the layers and their properties; see RenderData::styleSerial.
+    uint64_t styleSerial;
+
+    void invalidateRenderData();
+    bool isRenderDataCurrent(MapDebugOptions) const;
+    void buildRenderData(RenderData&, MapDebugOptions) const;
+
 public:
     bool loaded = false;
 };
@@ -4,6 +4,7 @@
 #include <mbgl/style/conversion/tileset.hpp>
 #include <mbgl/util/tileset.hpp>
 #include <mbgl/util/mapbox.hpp>
+#include <mbgl/util/startup_trace.hpp>
 #include <mbgl/storage/file_source.hpp>
 
 #include <rapidjson/document.h>
@@ -49,6 +50,12 @@ TileSourceImpl::TileSourceImpl(SourceType type_, std::string id_, Source& base_,
 
 TileSourceImpl::~TileSourceImpl() = default;
 
+void TileSourceImpl::prefetchDescription(FileSource& fileSource) {
+    if (urlOrTileset.is<std::string>()) {
+        loadDescription(fileSource);
+    }
+}
+
 void TileSourceImpl::loadDescription(FileSource& fileSource) {
     if (urlOrTileset.is<Tileset>()) {
         tileset = urlOrTileset.get<Tileset>();
@@ -61,7 +68,8 @@ void TileSourceImpl::loadDescription(FileSource& fileSource) {
     }
 
     const std::string& url = urlOrTileset.get<std::string>();
-    req = fileSource.request(Resource::source(url), [this, url](Response res) {
+    const TimePoint begin = Clock::now();
+    req = fileSource.request(Resource::source(url), [this, url, begin](Response res) {
         if (res.error) {
             observer->onSourceError(base, std::make_exception_ptr(std::runtime_error(res.error->message)));
         } else if (res.notModified) {
@@ -80,11 +88,13 @@ void TileSourceImpl::loadDescription(FileSource& fileSource) {
                 observer->onSourceError(base, std::current_exception());
                 return;
             }
+            StartupTrace::record("source " + id, begin, Clock::now(), { "style parse" });
 
             // Check whether previous information specifies different tile
             bool attributionChanged = false;
-            if (tileset.tiles != newTileset.tiles) {
-                // Tile URLs changed: force tiles to be reloaded.
+            if (tileset.tiles != newTileset.tiles || tileset.encoding != newTileset.encoding ||
+                tileset.metatiles != newTileset.metatiles || tileset.metatileSize != newTileset.metatileSize) {
+                // Tile URLs or their encoding changed: force tiles to be reloaded.
                 invalidateTiles();
 
                 // Tile size changed: We need to recalculate the tiles we need to load because we
@@ -25,6 +25,7 @@ public:
     ~TileSourceImpl() override;
 
     void loadDescription(FileSource&) final;
+    void prefetchDescription(FileSource&) final;
 
     uint16_t getTileSize() const final {
         return tileSize;
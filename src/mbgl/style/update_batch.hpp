@@ -9,6 +9,10 @@ namespace style {
 class UpdateBatch {
 public:
     std::unordered_set<std::string> sourceIDs;
+
+    // The layers whose changes need a new layout. Tiles of the sources that none of them apply to
+    // keep theirs.
+    std::unordered_set<std::string> layerIDs;
 };
 
 } // namespace style
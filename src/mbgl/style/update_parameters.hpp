@@ -1,10 +1,12 @@
 #pragma once
 
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/transform_state.hpp>
+
+#include <vector>
 
 namespace mbgl {
 
-class TransformState;
 class Scheduler;
 class FileSource;
 class AnnotationManager;
@@ -40,6 +42,30 @@ public:
     const MapMode mode;
     AnnotationManager& annotationManager;
 
+    // Whether each source places the symbols of all its tiles together; see `CrossTilePlacementWorker`.
+    bool crossTilePlacement = false;
+
+    // Whether tiles of a pitched map that are far from the camera use lower zoom levels; see
+    // `util::tileCoverWithLOD()`.
+    bool tileLevelOfDetail = false;
+
+    // Whether tiles keep the symbol placement of an earlier update rather than being placed for
+    // the current angle and pitch, e.g. while the camera moves fast; see Map::setAdaptiveQuality().
+    bool deferPlacement = false;
+
+    // Whether the camera is animating or following a gesture. Tiles then keep a symbol placement
+    // made for an angle and pitch close to the current ones, until the camera stops; see
+    // PlacementConfig::isCloseTo().
+    bool cameraMoving = false;
+
+    // Whether the parents of the ideal tiles, a few zoom levels up, are loaded up front; see
+    // Map::setParentTilePrefetch().
+    bool prefetchParents = false;
+
+    // Where the camera's animation or panning is headed; the tiles covering these are loaded
+    // ahead of time at a low priority. See Map::setPredictiveTilePrefetch().
+    std::vector<TransformState> prefetchStates;
+
     // TODO: remove
     Style& style;
 };
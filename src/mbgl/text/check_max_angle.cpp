@@ -1,5 +1,6 @@
 #include <mbgl/text/check_max_angle.hpp>
 #include <mbgl/geometry/anchor.hpp>
+#include <mbgl/text/line_metrics.hpp>
 #include <mbgl/util/math.hpp>
 
 #include <queue>
@@ -13,14 +14,13 @@ struct Corner {
     float angleDelta;
 };
 
-bool checkMaxAngle(const GeometryCoordinates &line, Anchor &anchor, const float labelLength,
-        const float windowSize, const float maxAngle) {
+bool checkMaxAngle(const GeometryCoordinates &line, const LineMetrics &metrics, Anchor &anchor,
+        const float labelLength, const float windowSize, const float maxAngle) {
 
     // horizontal labels always pass
     if (anchor.segment < 0) return true;
 
-    GeometryCoordinate anchorPoint = convertPoint<int16_t>(anchor.point);
-    GeometryCoordinate &p = anchorPoint;
+    const GeometryCoordinate anchorPoint = convertPoint<int16_t>(anchor.point);
     int index = anchor.segment + 1;
     float anchorDistance = 0;
 
@@ -31,11 +31,12 @@ bool checkMaxAngle(const GeometryCoordinates &line, Anchor &anchor, const float
         // there isn't enough room for the label after the beginning of the line
         if (index < 0) return false;
 
-        anchorDistance -= util::dist<float>(line[index], p);
-        p = line[index];
+        anchorDistance -= index == anchor.segment ?
+            util::dist<float>(line[index], anchorPoint) :
+            metrics.lengths[index];
     }
 
-    anchorDistance += util::dist<float>(line[index], line[index + 1]);
+    anchorDistance += metrics.lengths[index];
     index++;
 
     // store recent corners and their total angle difference
@@ -48,13 +49,7 @@ bool checkMaxAngle(const GeometryCoordinates &line, Anchor &anchor, const float
         // there isn't enough room for the label before the end of the line
         if (index + 1 >= (int)line.size()) return false;
 
-        auto& prev = line[index - 1];
-        auto& current = line[index];
-        auto& next = line[index + 1];
-
-        float angleDelta = util::angle_to(prev, current) - util::angle_to(current, next);
-        // restrict angle to -pi..pi range
-        angleDelta = std::fabs(std::fmod(angleDelta + 3 * M_PI, M_PI * 2) - M_PI);
+        const float angleDelta = metrics.turns[index];
 
         recentCorners.emplace(anchorDistance, angleDelta);
         recentAngleDelta += angleDelta;
@@ -68,8 +63,8 @@ bool checkMaxAngle(const GeometryCoordinates &line, Anchor &anchor, const float
         // the sum of angles within the window area exceeds the maximum allowed value. check fails.
         if (recentAngleDelta > maxAngle) return false;
 
+        anchorDistance += metrics.lengths[index];
         index++;
-        anchorDistance += util::dist<float>(current, next);
     }
 
     // no part of the line had an angle greater than the maximum allowed. check passes.
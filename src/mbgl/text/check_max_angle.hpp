@@ -5,8 +5,9 @@
 namespace mbgl {
 
 struct Anchor;
+class LineMetrics;
 
-bool checkMaxAngle(const GeometryCoordinates &line, Anchor &anchor, const float labelLength,
-        const float windowSize, const float maxAngle);
+bool checkMaxAngle(const GeometryCoordinates &line, const LineMetrics &metrics, Anchor &anchor,
+        const float labelLength, const float windowSize, const float maxAngle);
 
 } // namespace mbgl
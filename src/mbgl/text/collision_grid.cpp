@@ -0,0 +1,282 @@
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/math/minmax.hpp>
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace mbgl {
+
+const constexpr int32_t CollisionGrid::MaxCells;
+
+CollisionGrid::CollisionGrid(float cellSize_, float yStretch_)
+    : cellSize(cellSize_), yStretch(yStretch_) {
+}
+
+CollisionGrid::Box CollisionGrid::getBox(const Point<float>& anchor, const CollisionBox& box) const {
+    return { anchor.x + box.x1, anchor.y + box.y1 * yStretch, anchor.x + box.x2, anchor.y + box.y2 * yStretch };
+}
+
+CollisionGrid::Box CollisionGrid::getBox(const Block& block, std::size_t i) const {
+    return { block.anchorX[i] + block.x1[i], block.anchorY[i] + block.y1[i] * yStretch,
+             block.anchorX[i] + block.x2[i], block.anchorY[i] + block.y2[i] * yStretch };
+}
+
+int32_t CollisionGrid::toCell(float x) const {
+    // Also maps infinities, and NaNs, into the grid.
+    const float cell = std::floor(x / cellSize);
+    return cell >= -MaxCells ? (cell <= MaxCells ? int32_t(cell) : MaxCells) : -MaxCells;
+}
+
+CollisionGrid::Range CollisionGrid::toCells(const Box& box) const {
+    return { toCell(box.x1), toCell(box.y1), toCell(box.x2), toCell(box.y2) };
+}
+
+void CollisionGrid::insert(uint32_t id, const Point<float>& anchor, const CollisionBox& box) {
+    const Range cover = toCells(getBox(anchor, box));
+    if (cover.x1 < range.x1 || cover.y1 < range.y1 || cover.x2 > range.x2 || cover.y2 > range.y2) {
+        grow(cover);
+    }
+
+    const int32_t columns = range.x2 - range.x1 + 1;
+    for (int32_t y = cover.y1; y <= cover.y2; ++y) {
+        for (int32_t x = cover.x1; x <= cover.x2; ++x) {
+            Cell& cell = cells[(y - range.y1) * columns + (x - range.x1)];
+            if (cell.size % 4 == 0) {
+                cell.blocks.push_back({});
+                std::fill_n(cell.blocks.back().anchorX, 4, std::numeric_limits<float>::quiet_NaN());
+                std::fill_n(cell.blocks.back().anchorY, 4, std::numeric_limits<float>::quiet_NaN());
+            }
+
+            Block& block = cell.blocks.back();
+            const std::size_t i = cell.size++ % 4;
+            block.anchorX[i] = anchor.x;
+            block.anchorY[i] = anchor.y;
+            block.x1[i] = box.x1;
+            block.y1[i] = box.y1;
+            block.x2[i] = box.x2;
+            block.y2[i] = box.y2;
+            block.maxScale[i] = box.maxScale;
+            block.placementScale[i] = box.placementScale;
+            block.ids[i] = id;
+        }
+    }
+    count++;
+}
+
+void CollisionGrid::grow(const Range& cover) {
+    Range grown = cover;
+    if (!cells.empty()) {
+        // Grow by at least the current size, so that a grid that keeps growing is rebuilt only a
+        // logarithmic number of times.
+        const int32_t columns = range.x2 - range.x1 + 1;
+        const int32_t rows = range.y2 - range.y1 + 1;
+        grown.x1 = cover.x1 < range.x1 ? std::max(std::min(cover.x1, range.x1 - columns), -MaxCells) : range.x1;
+        grown.y1 = cover.y1 < range.y1 ? std::max(std::min(cover.y1, range.y1 - rows), -MaxCells) : range.y1;
+        grown.x2 = cover.x2 > range.x2 ? std::min(std::max(cover.x2, range.x2 + columns), MaxCells) : range.x2;
+        grown.y2 = cover.y2 > range.y2 ? std::min(std::max(cover.y2, range.y2 + rows), MaxCells) : range.y2;
+    }
+
+    const int32_t columns = grown.x2 - grown.x1 + 1;
+    const int32_t rows = grown.y2 - grown.y1 + 1;
+    std::vector<Cell> grownCells(std::size_t(columns) * rows);
+
+    // The existing cells are a block of the grown grid.
+    const int32_t oldColumns = range.x2 - range.x1 + 1;
+    for (int32_t y = range.y1; y <= range.y2; ++y) {
+        for (int32_t x = range.x1; x <= range.x2; ++x) {
+            grownCells[(y - grown.y1) * columns + (x - grown.x1)] =
+                std::move(cells[(y - range.y1) * oldColumns + (x - range.x1)]);
+        }
+    }
+
+    range = grown;
+    cells = std::move(grownCells);
+}
+
+float CollisionGrid::findPlacementScale(float minPlacementScale, float maxPlacementScale,
+                                        const Point<float>& anchor, const CollisionBox& box) const {
+    const Box query = getBox(anchor, box);
+    const Range cover = toCells(query);
+    const int32_t columns = range.x2 - range.x1 + 1;
+
+    // The scale at which the box clears a blocking box only counts if the blocking box is shown by
+    // then, so the result is the largest of those scales, and `minPlacementScale`. A box that spans
+    // several cells is tested in each, which doesn't change that.
+#if defined(__SSE2__)
+    const __m128 one = _mm_set1_ps(1);
+    const __m128 anchorX4 = _mm_set1_ps(anchor.x);
+    const __m128 anchorY4 = _mm_set1_ps(anchor.y);
+    const __m128 boxX1 = _mm_set1_ps(box.x1);
+    const __m128 boxY1 = _mm_set1_ps(box.y1);
+    const __m128 boxX2 = _mm_set1_ps(box.x2);
+    const __m128 boxY2 = _mm_set1_ps(box.y2);
+    const __m128 boxMaxScale = _mm_set1_ps(box.maxScale);
+    const __m128 queryX1 = _mm_set1_ps(query.x1);
+    const __m128 queryY1 = _mm_set1_ps(query.y1);
+    const __m128 queryX2 = _mm_set1_ps(query.x2);
+    const __m128 queryY2 = _mm_set1_ps(query.y2);
+    const __m128 stretch = _mm_set1_ps(yStretch);
+    const __m128 maxPlacementScale4 = _mm_set1_ps(maxPlacementScale);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t one = vdupq_n_f32(1);
+    const float32x4_t anchorX4 = vdupq_n_f32(anchor.x);
+    const float32x4_t anchorY4 = vdupq_n_f32(anchor.y);
+    const float32x4_t boxX1 = vdupq_n_f32(box.x1);
+    const float32x4_t boxY1 = vdupq_n_f32(box.y1);
+    const float32x4_t boxX2 = vdupq_n_f32(box.x2);
+    const float32x4_t boxY2 = vdupq_n_f32(box.y2);
+    const float32x4_t boxMaxScale = vdupq_n_f32(box.maxScale);
+    const float32x4_t queryX1 = vdupq_n_f32(query.x1);
+    const float32x4_t queryY1 = vdupq_n_f32(query.y1);
+    const float32x4_t queryX2 = vdupq_n_f32(query.x2);
+    const float32x4_t queryY2 = vdupq_n_f32(query.y2);
+    const float32x4_t stretch = vdupq_n_f32(yStretch);
+#endif
+
+    for (int32_t y = std::max(cover.y1, range.y1); y <= std::min(cover.y2, range.y2); ++y) {
+        for (int32_t x = std::max(cover.x1, range.x1); x <= std::min(cover.x2, range.x2); ++x) {
+            const Cell& cell = cells[(y - range.y1) * columns + (x - range.x1)];
+
+#if defined(__SSE2__)
+            __m128 result = _mm_set1_ps(minPlacementScale);
+            for (const Block& block : cell.blocks) {
+                const __m128 blockingX = _mm_loadu_ps(block.anchorX);
+                const __m128 blockingY = _mm_loadu_ps(block.anchorY);
+                const __m128 x1 = _mm_loadu_ps(block.x1);
+                const __m128 y1 = _mm_loadu_ps(block.y1);
+                const __m128 x2 = _mm_loadu_ps(block.x2);
+                const __m128 y2 = _mm_loadu_ps(block.y2);
+
+                const __m128 intersects = _mm_and_ps(
+                    _mm_and_ps(_mm_cmple_ps(_mm_add_ps(blockingX, x1), queryX2),
+                               _mm_cmpge_ps(_mm_add_ps(blockingX, x2), queryX1)),
+                    _mm_and_ps(_mm_cmple_ps(_mm_add_ps(blockingY, _mm_mul_ps(y1, stretch)), queryY2),
+                               _mm_cmpge_ps(_mm_add_ps(blockingY, _mm_mul_ps(y2, stretch)), queryY1)));
+                if (!_mm_movemask_ps(intersects)) {
+                    continue;
+                }
+
+                const __m128 dx = _mm_sub_ps(anchorX4, blockingX);
+                const __m128 dy = _mm_sub_ps(anchorY4, blockingY);
+                __m128 s1 = _mm_div_ps(_mm_sub_ps(x1, boxX2), dx);
+                __m128 s2 = _mm_div_ps(_mm_sub_ps(x2, boxX1), dx);
+                __m128 s3 = _mm_div_ps(_mm_mul_ps(_mm_sub_ps(y1, boxY2), stretch), dy);
+                __m128 s4 = _mm_div_ps(_mm_mul_ps(_mm_sub_ps(y2, boxY1), stretch), dy);
+
+                // NaNs, where the anchors are level and the edges touch, count as a scale of 1.
+                const __m128 nanX = _mm_or_ps(_mm_cmpunord_ps(s1, s1), _mm_cmpunord_ps(s2, s2));
+                const __m128 nanY = _mm_or_ps(_mm_cmpunord_ps(s3, s3), _mm_cmpunord_ps(s4, s4));
+                s1 = _mm_or_ps(_mm_and_ps(nanX, one), _mm_andnot_ps(nanX, s1));
+                s2 = _mm_or_ps(_mm_and_ps(nanX, one), _mm_andnot_ps(nanX, s2));
+                s3 = _mm_or_ps(_mm_and_ps(nanY, one), _mm_andnot_ps(nanY, s3));
+                s4 = _mm_or_ps(_mm_and_ps(nanY, one), _mm_andnot_ps(nanY, s4));
+
+                __m128 scale = _mm_min_ps(_mm_max_ps(s1, s2), _mm_max_ps(s3, s4));
+                scale = _mm_min_ps(_mm_min_ps(scale, _mm_loadu_ps(block.maxScale)), boxMaxScale);
+
+                const __m128 counts = _mm_and_ps(intersects, _mm_cmpge_ps(scale, _mm_loadu_ps(block.placementScale)));
+                result = _mm_max_ps(result, _mm_or_ps(_mm_and_ps(counts, scale), _mm_andnot_ps(counts, result)));
+                if (_mm_movemask_ps(_mm_cmpge_ps(result, maxPlacementScale4))) {
+                    break;
+                }
+            }
+            result = _mm_max_ps(result, _mm_shuffle_ps(result, result, _MM_SHUFFLE(2, 3, 0, 1)));
+            result = _mm_max_ps(result, _mm_shuffle_ps(result, result, _MM_SHUFFLE(1, 0, 3, 2)));
+            minPlacementScale = _mm_cvtss_f32(result);
+            if (minPlacementScale >= maxPlacementScale) {
+                return minPlacementScale;
+            }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            float32x4_t result = vdupq_n_f32(minPlacementScale);
+            for (const Block& block : cell.blocks) {
+                const float32x4_t blockingX = vld1q_f32(block.anchorX);
+                const float32x4_t blockingY = vld1q_f32(block.anchorY);
+                const float32x4_t x1 = vld1q_f32(block.x1);
+                const float32x4_t y1 = vld1q_f32(block.y1);
+                const float32x4_t x2 = vld1q_f32(block.x2);
+                const float32x4_t y2 = vld1q_f32(block.y2);
+
+                const uint32x4_t intersects = vandq_u32(
+                    vandq_u32(vcleq_f32(vaddq_f32(blockingX, x1), queryX2),
+                              vcgeq_f32(vaddq_f32(blockingX, x2), queryX1)),
+                    vandq_u32(vcleq_f32(vaddq_f32(blockingY, vmulq_f32(y1, stretch)), queryY2),
+                              vcgeq_f32(vaddq_f32(blockingY, vmulq_f32(y2, stretch)), queryY1)));
+                if (!vmaxvq_u32(intersects)) {
+                    continue;
+                }
+
+                const float32x4_t dx = vsubq_f32(anchorX4, blockingX);
+                const float32x4_t dy = vsubq_f32(anchorY4, blockingY);
+                float32x4_t s1 = vdivq_f32(vsubq_f32(x1, boxX2), dx);
+                float32x4_t s2 = vdivq_f32(vsubq_f32(x2, boxX1), dx);
+                float32x4_t s3 = vdivq_f32(vmulq_f32(vsubq_f32(y1, boxY2), stretch), dy);
+                float32x4_t s4 = vdivq_f32(vmulq_f32(vsubq_f32(y2, boxY1), stretch), dy);
+
+                // NaNs, where the anchors are level and the edges touch, count as a scale of 1.
+                const uint32x4_t numberX = vandq_u32(vceqq_f32(s1, s1), vceqq_f32(s2, s2));
+                const uint32x4_t numberY = vandq_u32(vceqq_f32(s3, s3), vceqq_f32(s4, s4));
+                s1 = vbslq_f32(numberX, s1, one);
+                s2 = vbslq_f32(numberX, s2, one);
+                s3 = vbslq_f32(numberY, s3, one);
+                s4 = vbslq_f32(numberY, s4, one);
+
+                float32x4_t scale = vminq_f32(vmaxq_f32(s1, s2), vmaxq_f32(s3, s4));
+                scale = vminq_f32(vminq_f32(scale, vld1q_f32(block.maxScale)), boxMaxScale);
+
+                const uint32x4_t counts = vandq_u32(intersects, vcgeq_f32(scale, vld1q_f32(block.placementScale)));
+                result = vmaxq_f32(result, vbslq_f32(counts, scale, result));
+                if (vmaxvq_f32(result) >= maxPlacementScale) {
+                    break;
+                }
+            }
+            minPlacementScale = vmaxvq_f32(result);
+            if (minPlacementScale >= maxPlacementScale) {
+                return minPlacementScale;
+            }
+#else
+            for (std::size_t i = 0; i < cell.size; ++i) {
+                const Block& block = cell.blocks[i / 4];
+                const std::size_t j = i % 4;
+                const Box other = getBox(block, j);
+                if (other.x1 > query.x2 || other.x2 < query.x1 || other.y1 > query.y2 || other.y2 < query.y1) {
+                    continue;
+                }
+
+                float s1 = (block.x1[j] - box.x2) / (anchor.x - block.anchorX[j]);
+                float s2 = (block.x2[j] - box.x1) / (anchor.x - block.anchorX[j]);
+                float s3 = (block.y1[j] - box.y2) * yStretch / (anchor.y - block.anchorY[j]);
+                float s4 = (block.y2[j] - box.y1) * yStretch / (anchor.y - block.anchorY[j]);
+
+                if (std::isnan(s1) || std::isnan(s2)) s1 = s2 = 1;
+                if (std::isnan(s3) || std::isnan(s4)) s3 = s4 = 1;
+
+                const float scale = util::min(util::max(s1, s2), util::max(s3, s4), block.maxScale[j], box.maxScale);
+                if (scale > minPlacementScale && scale >= block.placementScale[j]) {
+                    minPlacementScale = scale;
+                    if (minPlacementScale >= maxPlacementScale) {
+                        return minPlacementScale;
+                    }
+                }
+            }
+#endif
+        }
+    }
+
+    return minPlacementScale;
+}
+
+std::size_t CollisionGrid::getMemoryUsage() const {
+    std::size_t bytes = cells.capacity() * sizeof(Cell);
+    for (const auto& cell : cells) {
+        bytes += cell.blocks.capacity() * sizeof(Block);
+    }
+    return bytes;
+}
+
+} // namespace mbgl
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <mbgl/text/collision_feature.hpp>
+#include <mbgl/util/geometry.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// A uniform grid of collision boxes. Each cell holds the boxes that overlap it, packed four at a time
+// into blocks with one array per field, along with their ids, which refer to a table kept by the
+// owner, so that a query scans contiguous memory and placement tests four boxes at a time. The grid grows to cover the boxes
+// inserted into it, up to `MaxCells` cells from the origin in each direction; boxes beyond that are
+// kept in the outermost cells.
+class CollisionGrid {
+public:
+    struct Box {
+        float x1;
+        float y1;
+        float x2;
+        float y2;
+    };
+
+    static constexpr int32_t MaxCells = 64;
+
+    // Boxes are stretched vertically by `yStretch`, like CollisionTile does for the pitch.
+    CollisionGrid(float cellSize, float yStretch);
+
+    // Inserts a box, whose anchor is in the space of the grid, i.e. rotated like CollisionTile does.
+    void insert(uint32_t id, const Point<float>& anchor, const CollisionBox&);
+
+    // Calls `fn` once with the id of each box that intersects `box`, edges included, until it
+    // returns false.
+    template <class Fn>
+    void query(const Box& box, Fn&& fn) const;
+
+    // Like CollisionTile::findPlacementScale, applied to each box that the box at `anchor`
+    // intersects: the lowest scale from `minPlacementScale` up at which it overlaps none of those
+    // that are shown by then. Stops once that reaches `maxPlacementScale`.
+    //
+    // Where SSE2 or NEON are available, the four boxes of a block are tested at once.
+    float findPlacementScale(float minPlacementScale, float maxPlacementScale,
+                             const Point<float>& anchor, const CollisionBox&) const;
+
+    std::size_t size() const { return count; }
+
+    // The memory held by the cells, in bytes.
+    std::size_t getMemoryUsage() const;
+
+private:
+    // Unused slots have NaN anchors, which intersect nothing.
+    struct Block {
+        float anchorX[4];
+        float anchorY[4];
+        float x1[4];
+        float y1[4];
+        float x2[4];
+        float y2[4];
+        float maxScale[4];
+        float placementScale[4];
+        uint32_t ids[4];
+    };
+
+    struct Cell {
+        std::vector<Block> blocks;
+        std::size_t size = 0;
+    };
+
+    // An inclusive range of cells.
+    struct Range {
+        int32_t x1;
+        int32_t y1;
+        int32_t x2;
+        int32_t y2;
+    };
+
+    Box getBox(const Point<float>& anchor, const CollisionBox&) const;
+    Box getBox(const Block&, std::size_t) const;
+    int32_t toCell(float) const;
+    Range toCells(const Box&) const;
+    void grow(const Range&);
+
+    const float cellSize;
+    const float yStretch;
+    std::size_t count = 0;
+
+    // The cells covered by the grid, row by row.
+    Range range { 0, 0, -1, -1 };
+    std::vector<Cell> cells;
+};
+
+template <class Fn>
+void CollisionGrid::query(const Box& box, Fn&& fn) const {
+    const Range cover = toCells(box);
+    const int32_t x1 = std::max(cover.x1, range.x1);
+    const int32_t y1 = std::max(cover.y1, range.y1);
+    const int32_t x2 = std::min(cover.x2, range.x2);
+    const int32_t y2 = std::min(cover.y2, range.y2);
+    const int32_t columns = range.x2 - range.x1 + 1;
+
+    for (int32_t y = y1; y <= y2; ++y) {
+        for (int32_t x = x1; x <= x2; ++x) {
+            const Cell& cell = cells[(y - range.y1) * columns + (x - range.x1)];
+            for (std::size_t i = 0; i < cell.size; ++i) {
+                const Block& block = cell.blocks[i / 4];
+                const Box other = getBox(block, i % 4);
+                if (other.x1 > box.x2 || other.x2 < box.x1 || other.y1 > box.y2 || other.y2 < box.y1) {
+                    continue;
+                }
+
+                // A box that spans several of the queried cells is only reported in the first.
+                if (std::max(toCell(other.x1), x1) != x || std::max(toCell(other.y1), y1) != y) {
+                    continue;
+                }
+
+                if (!fn(block.ids[i % 4])) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+} // namespace mbgl
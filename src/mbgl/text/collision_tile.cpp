@@ -7,13 +7,30 @@
 #include <mapbox/geometry/envelope.hpp>
 #include <mapbox/geometry/multi_point.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
 auto infinity = std::numeric_limits<float>::infinity();
 
+// Labels are a few hundred to a few thousand units wide, so most boxes overlap one to four cells.
+const float gridCellSize = util::EXTENT / 16;
+
+float stretchForPitch(float pitch) {
+    // Stretch boxes in y direction to account for the map tilt.
+    const float _yStretch = 1.0f / std::cos(pitch);
+
+    // The amount the map is squished depends on the y position.
+    // Sort of account for this by making all boxes a bit bigger.
+    return std::pow(_yStretch, 1.3);
+}
+
 CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_)),
+    yStretch(stretchForPitch(config.pitch)),
     edges({{
         // left
         CollisionBox(Point<float>(0, 0), 0, -infinity, 0, infinity, infinity),
@@ -23,20 +40,15 @@ CollisionTile::CollisionTile(PlacementConfig config_) : config(std::move(config_
         CollisionBox(Point<float>(0, 0), -infinity, 0, infinity, 0, infinity),
         // bottom
         CollisionBox(Point<float>(0, util::EXTENT), -infinity, 0, infinity, 0, infinity),
-    }}) {
+    }}),
+    grid(gridCellSize, yStretch),
+    ignoredGrid(gridCellSize, yStretch) {
 
     // Compute the transformation matrix.
     const float angle_sin = std::sin(config.angle);
     const float angle_cos = std::cos(config.angle);
     rotationMatrix = { { angle_cos, -angle_sin, angle_sin, angle_cos } };
     reverseRotationMatrix = { { angle_cos, angle_sin, -angle_sin, angle_cos } };
-
-    // Stretch boxes in y direction to account for the map tilt.
-    const float _yStretch = 1.0f / std::cos(config.pitch);
-
-    // The amount the map is squished depends on the y position.
-    // Sort of account for this by making all boxes a bit bigger.
-    yStretch = std::pow(_yStretch, 1.3);
 }
 
 
@@ -85,18 +97,6 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, const bool al
     float minPlacementScale = minScale;
 
     for (auto& box : feature.boxes) {
-        const auto anchor = util::matrixMultiply(rotationMatrix, box.anchor);
-
-        if (!allowOverlap) {
-            for (auto it = tree.qbegin(bgi::intersects(getTreeBox(anchor, box))); it != tree.qend(); ++it) {
-                const CollisionBox& blocking = std::get<1>(*it);
-                Point<float> blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
-
-                minPlacementScale = findPlacementScale(minPlacementScale, anchor, box, blockingAnchor, blocking);
-                if (minPlacementScale >= maxScale) return minPlacementScale;
-            }
-        }
-
         if (avoidEdges) {
             const Point<float> tl = { box.x1, box.y1 };
             const Point<float> tr = { box.x2, box.y1 };
@@ -121,6 +121,24 @@ float CollisionTile::placeFeature(const CollisionFeature& feature, const bool al
         }
     }
 
+    if (!allowOverlap) {
+        minPlacementScale = placeBoxes(feature, { 0, 0 }, minPlacementScale);
+        if (shared && minPlacementScale < maxScale) {
+            minPlacementScale = shared->placeBoxes(feature, sharedOffset, minPlacementScale);
+        }
+    }
+
+    return minPlacementScale;
+}
+
+float CollisionTile::placeBoxes(const CollisionFeature& feature, const Point<float>& offset, float minPlacementScale) {
+    for (auto& box : feature.boxes) {
+        const auto anchor = util::matrixMultiply(rotationMatrix, box.anchor + offset);
+
+        minPlacementScale = grid.findPlacementScale(minPlacementScale, maxScale, anchor, box);
+        if (minPlacementScale >= maxScale) return minPlacementScale;
+    }
+
     return minPlacementScale;
 }
 
@@ -130,29 +148,55 @@ void CollisionTile::insertFeature(CollisionFeature& feature, const float minPlac
     }
 
     if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
-        for (auto& box : feature.boxes) {
-            treeBoxes.emplace_back(getTreeBox(util::matrixMultiply(rotationMatrix, box.anchor), box), box, feature.indexedFeature);
-        }
-        if (ignorePlacement) {
-            ignoredTree.insert(treeBoxes.begin(), treeBoxes.end());
-        } else {
-            tree.insert(treeBoxes.begin(), treeBoxes.end());
+        insertBoxes(feature, { 0, 0 }, ignorePlacement);
+        if (shared) {
+            shared->insertBoxes(feature, sharedOffset, ignorePlacement);
         }
     }
+}
 
+void CollisionTile::insertBoxes(const CollisionFeature& feature, const Point<float>& offset, const bool ignorePlacement) {
+    if (feature.boxes.empty()) {
+        return;
+    }
+
+    const auto featureID = uint32_t(features.size());
+    const IndexedSubfeature& indexedFeature = feature.indexedFeature;
+    features.push_back({ indexedFeature.index, indexedFeature.sortIndex,
+                         intern(indexedFeature.sourceLayerName), intern(indexedFeature.bucketName) });
+
+    CollisionGrid& target = ignorePlacement ? ignoredGrid : grid;
+    for (auto box : feature.boxes) {
+        box.anchor = box.anchor + offset;
+        const auto rotatedAnchor = util::matrixMultiply(rotationMatrix, box.anchor);
+        target.insert(uint32_t(boxes.size()), rotatedAnchor, box);
+        boxes.push_back({ box, rotatedAnchor, featureID });
+    }
 }
 
-Box CollisionTile::getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
-    return Box{
-        CollisionPoint{
-            anchor.x + box.x1 / scale,
-            anchor.y + box.y1 / scale * yStretch
-        },
-        CollisionPoint{
-            anchor.x + box.x2 / scale,
-            anchor.y + box.y2 / scale * yStretch
-        }
+uint32_t CollisionTile::intern(const std::string& name) {
+    // Consecutive features mostly come from the same layer.
+    if (!names.empty() && names.back() == name) {
+        return uint32_t(names.size() - 1);
+    }
+    auto it = nameIDs.find(name);
+    if (it == nameIDs.end()) {
+        it = nameIDs.emplace(name, uint32_t(names.size())).first;
+        names.push_back(name);
+    }
+    return it->second;
+}
+
+IndexedSubfeature CollisionTile::getIndexedSubfeature(const PlacedFeature& feature) const {
+    return { feature.index, names[feature.sourceLayerName], names[feature.bucketName], feature.sortIndex };
+}
+
+CollisionGrid::Box CollisionTile::getGridBox(const Point<float>& anchor, const CollisionBox& box, const float scale) {
+    return CollisionGrid::Box {
+        anchor.x + box.x1 / scale,
+        anchor.y + box.y1 / scale * yStretch,
+        anchor.x + box.x2 / scale,
+        anchor.y + box.y2 / scale * yStretch
     };
 }
 
@@ -161,7 +205,7 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
     std::vector<IndexedSubfeature> result;
     if (queryGeometry.empty()) return result;
 
-    std::unordered_map<std::string, std::unordered_set<std::size_t>> sourceLayerFeatures;
+    std::unordered_map<uint32_t, std::unordered_set<std::size_t>> sourceLayerFeatures;
 
     mapbox::geometry::multi_point<float> rotatedPoints {};
     rotatedPoints.reserve(queryGeometry.size());
@@ -171,36 +215,43 @@ std::vector<IndexedSubfeature> CollisionTile::queryRenderedSymbols(const Geometr
 
     const auto& anchor = box.min;
     CollisionBox queryBox(anchor, 0, 0, box.max.x - box.min.x, box.max.y - box.min.y, scale);
-    auto predicates = bgi::intersects(getTreeBox(anchor, queryBox));
+    const auto gridBox = getGridBox(anchor, queryBox);
 
-    auto fn = [&] (const Tree& tree_, bool ignorePlacement) {
-        for (auto it = tree_.qbegin(predicates); it != tree_.qend(); ++it) {
-            const CollisionBox& blocking = std::get<1>(*it);
-            const IndexedSubfeature& indexedFeature = std::get<2>(*it);
+    auto fn = [&] (const CollisionGrid& grid_, bool ignorePlacement) {
+        grid_.query(gridBox, [&] (uint32_t id) {
+            const PlacedBox& blocking = boxes[id];
+            const PlacedFeature& placedFeature = features[blocking.feature];
 
-            auto& seenFeatures = sourceLayerFeatures[indexedFeature.sourceLayerName];
-            if (seenFeatures.find(indexedFeature.index) == seenFeatures.end()) {
+            auto& seenFeatures = sourceLayerFeatures[placedFeature.sourceLayerName];
+            if (seenFeatures.find(placedFeature.index) == seenFeatures.end()) {
                 if (ignorePlacement) {
-                    seenFeatures.insert(indexedFeature.index);
-                    result.push_back(indexedFeature);
+                    seenFeatures.insert(placedFeature.index);
+                    result.push_back(getIndexedSubfeature(placedFeature));
                 } else {
-                    auto blockingAnchor = util::matrixMultiply(rotationMatrix, blocking.anchor);
-                    float minPlacementScale = findPlacementScale(minScale, anchor, queryBox, blockingAnchor, blocking);
+                    float minPlacementScale = findPlacementScale(minScale, anchor, queryBox, blocking.rotatedAnchor, blocking.box);
                     if (minPlacementScale >= scale) {
-                        seenFeatures.insert(indexedFeature.index);
-                        result.push_back(indexedFeature);
+                        seenFeatures.insert(placedFeature.index);
+                        result.push_back(getIndexedSubfeature(placedFeature));
                     }
                 }
             }
-        }
+            return true;
+        });
     };
 
     bool ignorePlacement = false;
-    fn(tree, ignorePlacement);
+    fn(grid, ignorePlacement);
     ignorePlacement = true;
-    fn(ignoredTree, ignorePlacement);
+    fn(ignoredGrid, ignorePlacement);
 
     return result;
 }
 
+std::size_t CollisionTile::getMemoryUsage() const {
+    return grid.getMemoryUsage() + ignoredGrid.getMemoryUsage() +
+           boxes.capacity() * sizeof(PlacedBox) +
+           features.capacity() * sizeof(PlacedFeature) +
+           names.size() * (2 * sizeof(std::string) + sizeof(uint32_t));
+}
+
 } // namespace mbgl
@@ -1,40 +1,17 @@
 #pragma once
 
 #include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_grid.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-function"
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#pragma GCC diagnostic ignored "-Wunused-variable"
-#pragma GCC diagnostic ignored "-Wshadow"
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wunknown-pragmas"
-#endif
-#pragma GCC diagnostic ignored "-Wpragmas"
-#pragma GCC diagnostic ignored "-Wdeprecated-register"
-#pragma GCC diagnostic ignored "-Wshorten-64-to-32"
-#pragma GCC diagnostic ignored "-Wunused-local-typedefs"
-#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/point.hpp>
-#include <boost/geometry/geometries/box.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#pragma GCC diagnostic pop
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
-namespace bg = boost::geometry;
-namespace bgm = bg::model;
-namespace bgi = bg::index;
-typedef bgm::point<float, 2, bg::cs::cartesian> CollisionPoint;
-typedef bgm::box<CollisionPoint> Box;
-typedef std::tuple<Box, CollisionBox, IndexedSubfeature> CollisionTreeBox;
-typedef bgi::rtree<CollisionTreeBox, bgi::linear<16, 4>> Tree;
-
-class IndexedSubfeature;
-
 class CollisionTile {
 public:
     explicit CollisionTile(PlacementConfig);
@@ -44,24 +21,60 @@ public:
 
     std::vector<IndexedSubfeature> queryRenderedSymbols(const GeometryCoordinates&, const float scale);
 
+    // An estimate of the memory held by the grids and their boxes, in bytes.
+    std::size_t getMemoryUsage() const;
+
     const PlacementConfig config;
 
     const float minScale = 0.5f;
     const float maxScale = 2.0f;
-    float yStretch;
+    const float yStretch;
 
     std::array<float, 4> rotationMatrix;
     std::array<float, 4> reverseRotationMatrix;
     std::array<CollisionBox, 4> edges;
 
+    // While set, features are also placed against, and inserted into, a collision tile shared
+    // with the neighbouring tiles of the same zoom level. It sees this tile's features translated
+    // by `sharedOffset`, in tile units.
+    CollisionTile* shared = nullptr;
+    Point<float> sharedOffset { 0, 0 };
+
 private:
+    float placeBoxes(const CollisionFeature&, const Point<float>& offset, float minPlacementScale);
+    void insertBoxes(const CollisionFeature&, const Point<float>& offset, const bool ignorePlacement);
+
     float findPlacementScale(float minPlacementScale,
             const Point<float>& anchor, const CollisionBox& box,
             const Point<float>& blockingAnchor, const CollisionBox& blocking);
-    Box getTreeBox(const Point<float>& anchor, const CollisionBox& box, const float scale = 1.0);
+    CollisionGrid::Box getGridBox(const Point<float>& anchor, const CollisionBox& box, const float scale = 1.0);
+
+    // A box in a grid, with its anchor in the rotated space of the grids, and the feature it
+    // belongs to.
+    struct PlacedBox {
+        CollisionBox box;
+        Point<float> rotatedAnchor;
+        uint32_t feature;
+    };
+
+    // The feature of a box, with its source layer and bucket names interned in `names`, so that
+    // each entry is a few words rather than two strings.
+    struct PlacedFeature {
+        std::size_t index;
+        std::size_t sortIndex;
+        uint32_t sourceLayerName;
+        uint32_t bucketName;
+    };
+
+    uint32_t intern(const std::string&);
+    IndexedSubfeature getIndexedSubfeature(const PlacedFeature&) const;
 
-    Tree tree;
-    Tree ignoredTree;
+    std::vector<PlacedBox> boxes;
+    std::vector<PlacedFeature> features;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, uint32_t> nameIDs;
+    CollisionGrid grid;
+    CollisionGrid ignoredGrid;
 };
 
 } // namespace mbgl
@@ -1,5 +1,6 @@
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/check_max_angle.hpp>
+#include <mbgl/text/line_metrics.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
 
@@ -8,14 +9,11 @@
 
 namespace mbgl {
 
-Anchors resample(const GeometryCoordinates &line, const float offset, const float spacing,
+Anchors resample(const GeometryCoordinates &line, const LineMetrics &metrics, const float offset, const float spacing,
         const float angleWindowSize, const float maxAngle, const float labelLength, const bool continuedLine, const bool placeAtMiddle) {
 
     const float halfLabelLength = labelLength / 2.0f;
-    float lineLength = 0;
-    for (auto it = line.begin(), end = line.end() - 1; it != end; it++) {
-        lineLength += util::dist<float>(*(it), *(it + 1));
-    }
+    const float lineLength = metrics.length;
 
     float distance = 0;
     float markedDistance = offset - spacing;
@@ -29,8 +27,8 @@ Anchors resample(const GeometryCoordinates &line, const float offset, const floa
         const GeometryCoordinate &a = *(it);
         const GeometryCoordinate &b = *(it + 1);
 
-        const float segmentDist = util::dist<float>(a, b);
-        const float angle = util::angle_to(b, a);
+        const float segmentDist = metrics.lengths[i];
+        const float angle = metrics.angles[i];
 
         while (markedDistance + spacing < distance + segmentDist) {
             markedDistance += spacing;
@@ -47,7 +45,7 @@ Anchors resample(const GeometryCoordinates &line, const float offset, const floa
                     markedDistance + halfLabelLength <= lineLength) {
                 Anchor anchor(::round(x), ::round(y), angle, 0.5f, i);
 
-                if (!angleWindowSize || checkMaxAngle(line, anchor, labelLength, angleWindowSize, maxAngle)) {
+                if (!angleWindowSize || checkMaxAngle(line, metrics, anchor, labelLength, angleWindowSize, maxAngle)) {
                     anchors.push_back(anchor);
                 }
             }
@@ -62,13 +60,13 @@ Anchors resample(const GeometryCoordinates &line, const float offset, const floa
         // This has the most effect for short lines in overscaled tiles, since the
         // initial offset used in overscaled tiles is calculated to align labels with positions in
         // parent tiles instead of placing the label as close to the beginning as possible.
-        anchors = resample(line, distance / 2, spacing, angleWindowSize, maxAngle, labelLength, continuedLine, true);
+        anchors = resample(line, metrics, distance / 2, spacing, angleWindowSize, maxAngle, labelLength, continuedLine, true);
     }
 
     return anchors;
 }
 
-Anchors getAnchors(const GeometryCoordinates &line, float spacing,
+Anchors getAnchors(const GeometryCoordinates &line, const LineMetrics &metrics, float spacing,
         const float maxAngle, const float textLeft, const float textRight,
         const float iconLeft, const float iconRight,
         const float glyphSize, const float boxScale, const float overscaling) {
@@ -103,7 +101,7 @@ Anchors getAnchors(const GeometryCoordinates &line, float spacing,
     std::fmod((labelLength / 2 + fixedExtraOffset) * boxScale * overscaling, spacing) :
     std::fmod(spacing / 2 * overscaling, spacing);
 
-    return resample(line, offset, spacing, angleWindowSize, maxAngle, labelLength * boxScale, continuedLine, false);
+    return resample(line, metrics, offset, spacing, angleWindowSize, maxAngle, labelLength * boxScale, continuedLine, false);
 }
 
 } // namespace mbgl
@@ -6,7 +6,9 @@
 
 namespace mbgl {
 
-Anchors getAnchors(const GeometryCoordinates &line, float spacing,
+class LineMetrics;
+
+Anchors getAnchors(const GeometryCoordinates &line, const LineMetrics &metrics, float spacing,
         const float maxAngle, const float textLeft, const float textRight,
         const float iconLeft, const float iconRight,
         const float glyphSize, const float boxScale, const float overscaling);
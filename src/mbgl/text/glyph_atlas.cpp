@@ -1,6 +1,8 @@
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/text/glyph_atlas_observer.hpp>
 #include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/glyph_sdf.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/platform/log.hpp>
@@ -13,14 +15,15 @@ namespace mbgl {
 
 static GlyphAtlasObserver nullObserver;
 
+const constexpr uint16_t GlyphAtlas::PageHeight;
+
 GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_, FileSource& fileSource_)
     : width(width_),
       height(height_),
       fileSource(fileSource_),
       observer(&nullObserver),
-      bin(width_, height_),
-      data(std::make_unique<uint8_t[]>(width_ * height_)),
       dirty(true) {
+    addPage();
 }
 
 GlyphAtlas::~GlyphAtlas() = default;
@@ -36,6 +39,8 @@ void GlyphAtlas::requestGlyphRange(const FontStack& fontStack, const GlyphRange&
 
     rangeSets.emplace(range,
         std::make_unique<GlyphPBF>(this, fontStack, range, observer, fileSource));
+
+    history.save();
 }
 
 bool GlyphAtlas::hasGlyphRanges(const FontStack& fontStack, const GlyphRangeSet& glyphRanges) {
@@ -43,31 +48,114 @@ bool GlyphAtlas::hasGlyphRanges(const FontStack& fontStack, const GlyphRangeSet&
         return true;
     }
 
-    std::lock_guard<std::mutex> lock(rangesMutex);
-    const auto& rangeSets = ranges[fontStack];
-
     bool hasRanges = true;
-    for (const auto& range : glyphRanges) {
-        const auto& rangeSetsIt = rangeSets.find(range);
-        if (rangeSetsIt == rangeSets.end()) {
-            // Push the request to the MapThread, so we can easly cancel
-            // if it is still pending when we destroy this object.
-            workQueue.push(std::bind(&GlyphAtlas::requestGlyphRange, this, fontStack, range));
-
-            hasRanges = false;
-            continue;
-        }
+    std::vector<GlyphRange> rasterize;
+    {
+        std::lock_guard<std::mutex> lock(rangesMutex);
+        const auto& rangeSets = ranges[fontStack];
+
+        for (const auto& range : glyphRanges) {
+            if (isLocalGlyphRange(fontStack, range)) {
+                auto& local = localRanges[fontStack];
+                auto localIt = local.find(range);
+                if (localIt == local.end()) {
+                    local.emplace(range, false);
+                    rasterize.push_back(range);
+                } else if (!localIt->second) {
+                    // Another thread is drawing them.
+                    hasRanges = false;
+                }
+                continue;
+            }
+
+            const auto& rangeSetsIt = rangeSets.find(range);
+            if (rangeSetsIt == rangeSets.end()) {
+                history.add(fontStack, range);
+
+                // Push the request to the MapThread, so we can easly cancel
+                // if it is still pending when we destroy this object.
+                workQueue.push(std::bind(&GlyphAtlas::requestGlyphRange, this, fontStack, range));
+
+                hasRanges = false;
+                continue;
+            }
 
-        if (!rangeSetsIt->second->isParsed()) {
-            hasRanges = false;
+            if (!rangeSetsIt->second->isParsed()) {
+                hasRanges = false;
+            }
         }
     }
 
+    for (const auto& range : rasterize) {
+        rasterizeGlyphRange(fontStack, range);
+    }
+
     return hasRanges;
 }
 
-util::exclusive<GlyphSet> GlyphAtlas::getGlyphSet(const FontStack& fontStack) {
-    auto lock = std::make_unique<std::lock_guard<std::mutex>>(glyphSetsMutex);
+bool GlyphAtlas::isLocalGlyphRange(const FontStack& fontStack, const GlyphRange& range) const {
+    return localGlyphRasterizer && localGlyphRasterizer->canRasterize(fontStack, range.first, range.second);
+}
+
+void GlyphAtlas::rasterizeGlyphRange(const FontStack& fontStack, const GlyphRange& range) {
+    std::vector<SDFGlyph> glyphs;
+    for (uint32_t id = range.first; id <= range.second; ++id) {
+        if (optional<RasterizedGlyph> glyph = localGlyphRasterizer->rasterize(fontStack, id)) {
+            glyphs.push_back(generateSDFGlyph(id, *glyph));
+        }
+    }
+
+    {
+        auto glyphSet = getGlyphSet(fontStack);
+        for (auto& glyph : glyphs) {
+            const uint32_t id = glyph.id;
+            glyphSet->insert(id, std::move(glyph));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(rangesMutex);
+        localRanges[fontStack][range] = true;
+    }
+
+    // The layouts of other tiles may be waiting for the glyphs.
+    workQueue.push([this, fontStack, range] {
+        observer->onGlyphsLoaded(fontStack, range);
+    });
+}
+
+void GlyphAtlas::prefetchGlyphRanges(const FontStack& fontStack) {
+    GlyphRangeSet glyphRanges;
+    {
+        std::lock_guard<std::mutex> lock(rangesMutex);
+        glyphRanges = history.get(fontStack);
+        glyphRanges.emplace(0, 255);
+
+        // Glyphs drawn locally are only drawn on the worker threads that need them.
+        for (auto it = glyphRanges.begin(); it != glyphRanges.end();) {
+            if (isLocalGlyphRange(fontStack, *it)) {
+                it = glyphRanges.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    hasGlyphRanges(fontStack, glyphRanges);
+}
+
+void GlyphAtlas::setHistoryPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(rangesMutex);
+    history.setPath(path);
+}
+
+void GlyphAtlas::setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer> rasterizer) {
+    std::lock_guard<std::mutex> lock(rangesMutex);
+    localGlyphRasterizer = std::move(rasterizer);
+}
+
+util::exclusive<GlyphSet, std::lock_guard<std::shared_timed_mutex>> GlyphAtlas::getGlyphSet(const FontStack& fontStack) {
+    auto lock = std::make_unique<std::lock_guard<std::shared_timed_mutex>>(glyphSetsMutex);
 
     auto it = glyphSets.find(fontStack);
     if (it == glyphSets.end()) {
@@ -79,6 +167,21 @@ util::exclusive<GlyphSet> GlyphAtlas::getGlyphSet(const FontStack& fontStack) {
     return { it->second.get(), std::move(lock) };
 }
 
+util::exclusive<const GlyphSet, std::shared_lock<std::shared_timed_mutex>> GlyphAtlas::readGlyphSet(const FontStack& fontStack) {
+    auto lock = std::make_unique<std::shared_lock<std::shared_timed_mutex>>(glyphSetsMutex);
+
+    auto it = glyphSets.find(fontStack);
+    if (it == glyphSets.end()) {
+        // Sets are never removed, so the one created here is still there once the lock is shared again.
+        lock->unlock();
+        getGlyphSet(fontStack);
+        lock->lock();
+        it = glyphSets.find(fontStack);
+    }
+
+    return { it->second.get(), std::move(lock) };
+}
+
 void GlyphAtlas::setObserver(GlyphAtlasObserver* observer_) {
     observer = observer_;
 }
@@ -91,18 +194,15 @@ void GlyphAtlas::addGlyphs(uintptr_t tileUID,
 {
     std::lock_guard<std::mutex> lock(mtx);
 
-    const std::map<uint32_t, SDFGlyph>& sdfs = glyphSet.getSDFs();
-
     for (uint32_t chr : text)
     {
-        auto sdf_it = sdfs.find(chr);
-        if (sdf_it == sdfs.end()) {
+        const SDFGlyph* sdf = glyphSet.getSDF(chr);
+        if (!sdf) {
             continue;
         }
 
-        const SDFGlyph& sdf = sdf_it->second;
-        Rect<uint16_t> rect = addGlyph(tileUID, fontStack, sdf);
-        face.emplace(chr, Glyph{rect, sdf.metrics});
+        Rect<uint16_t> rect = addGlyph(tileUID, fontStack, *sdf);
+        face.emplace(chr, Glyph{rect, sdf->metrics});
     }
 }
 
@@ -120,6 +220,10 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
     if (it != face.end()) {
         GlyphValue& value = it->second;
         value.ids.insert(tileUID);
+        if (value.unused) {
+            unused.erase(*value.unused);
+            value.unused = {};
+        }
         return value.rect;
     }
 
@@ -142,7 +246,7 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
     pack_width += (4 - pack_width % 4);
     pack_height += (4 - pack_height % 4);
 
-    Rect<uint16_t> rect = bin.allocate(pack_width, pack_height);
+    Rect<uint16_t> rect = allocate(pack_width, pack_height);
     if (rect.w == 0) {
         Log::Error(Event::OpenGL, "glyph bitmap overflow");
         return rect;
@@ -163,80 +267,126 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
         }
     }
 
-    dirty = true;
+    markDirty(rect);
 
     return rect;
 }
 
+Rect<uint16_t> GlyphAtlas::allocate(uint16_t packWidth, uint16_t packHeight) {
+    while (true) {
+        for (std::size_t i = 0; i < pages.size(); ++i) {
+            Rect<uint16_t> rect = pages[i]->allocate(packWidth, packHeight);
+            if (rect.w != 0) {
+                rect.y += i * PageHeight;
+                return rect;
+            }
+        }
+
+        if (pages.size() * PageHeight < height) {
+            addPage();
+        } else if (!unused.empty()) {
+            // Evict the glyph that has been unused the longest, and try again with its room.
+            UnusedGlyph oldest = unused.front();
+            unused.pop_front();
+            auto it = oldest.face->find(oldest.id);
+            assert(it != oldest.face->end());
+            release(it->second.rect);
+            oldest.face->erase(it);
+        } else {
+            return Rect<uint16_t>{ 0, 0, 0, 0 };
+        }
+    }
+}
+
+void GlyphAtlas::addPage() {
+    const std::size_t top = pages.size() * PageHeight;
+    assert(top < height);
+    const uint16_t pageHeight = std::min<std::size_t>(PageHeight, height - top);
+    pages.push_back(std::make_unique<BinPack<uint16_t>>(width, pageHeight));
+    data.resize(width * (top + pageHeight), 0);
+    dirty = true;
+}
+
+void GlyphAtlas::release(const Rect<uint16_t>& rect) {
+    // Clear out the bitmap.
+    uint8_t *target = data.data();
+    for (uint32_t y = 0; y < rect.h; y++) {
+        uint32_t y1 = width * (rect.y + y) + rect.x;
+        for (uint32_t x = 0; x < rect.w; x++) {
+            target[y1 + x] = 0;
+        }
+    }
+
+    const std::size_t page = rect.y / PageHeight;
+    assert(page < pages.size());
+    Rect<uint16_t> pageRect = rect;
+    pageRect.y -= page * PageHeight;
+    pages[page]->release(pageRect);
+}
+
+void GlyphAtlas::markDirty(const Rect<uint16_t>& rect) {
+    dirtyRegions.add(rect);
+    dirty = true;
+}
+
 void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
     std::lock_guard<std::mutex> lock(mtx);
 
     for (auto& faces : index) {
         std::map<uint32_t, GlyphValue>& face = faces.second;
-        for (auto it = face.begin(); it != face.end(); /* we advance in the body */) {
-            GlyphValue& value = it->second;
-            value.ids.erase(tileUID);
-
-            if (value.ids.empty()) {
-                const Rect<uint16_t>& rect = value.rect;
-
-                // Clear out the bitmap.
-                uint8_t *target = data.get();
-                for (uint32_t y = 0; y < rect.h; y++) {
-                    uint32_t y1 = width * (rect.y + y) + rect.x;
-                    for (uint32_t x = 0; x < rect.w; x++) {
-                        target[y1 + x] = 0;
-                    }
-                }
-
-                bin.release(rect);
-
-                // Make sure to post-increment the iterator: This will return the
-                // current iterator, but will go to the next position before we
-                // erase the element from the map. That way, the iterator stays
-                // valid.
-                face.erase(it++);
-            } else {
-                ++it;
+        for (auto& glyph : face) {
+            GlyphValue& value = glyph.second;
+            if (value.ids.erase(tileUID) && value.ids.empty()) {
+                // Keep the glyph until its room is needed, in case another tile uses it again.
+                value.unused = unused.insert(unused.end(), UnusedGlyph { &face, glyph.first });
             }
         }
     }
 }
 
+MemoryUsage GlyphAtlas::getMemoryUsage() {
+    MemoryUsage usage;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(glyphSetsMutex);
+        for (const auto& glyphSet : glyphSets) {
+            usage.cpu += glyphSet.second->getMemoryUsage();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        usage.cpu += data.capacity();
+    }
+    usage.gpu = texture ? std::size_t(width) * textureHeight : 0;
+    return usage;
+}
+
 void GlyphAtlas::upload(gl::Context& context, gl::TextureUnit unit) {
     if (dirty) {
-        const bool first = !texture;
         bind(context, unit);
 
         std::lock_guard<std::mutex> lock(mtx);
 
         context.activeTexture = unit;
-        if (first) {
+        const uint16_t dataHeight = data.size() / width;
+        if (dataHeight != textureHeight) {
+            // Pages were added, so the texture is allocated again at its new size.
             MBGL_CHECK_ERROR(glTexImage2D(
                 GL_TEXTURE_2D, // GLenum target
                 0, // GLint level
                 GL_ALPHA, // GLint internalformat
                 width, // GLsizei width
-                height, // GLsizei height
+                dataHeight, // GLsizei height
                 0, // GLint border
                 GL_ALPHA, // GLenum format
                 GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
+                data.data() // const GLvoid* data
             ));
+            textureHeight = dataHeight;
         } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width, // GLsizei width
-                height, // GLsizei height
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
+            dirtyRegions.upload(data.data(), width, 1, GL_ALPHA);
         }
 
+        dirtyRegions.clear();
         dirty = false;
     }
 }
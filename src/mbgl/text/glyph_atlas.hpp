@@ -2,19 +2,26 @@
 
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/text/glyph_set.hpp>
+#include <mbgl/text/glyph_range_history.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/geometry/binpack.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/exclusive.hpp>
+#include <mbgl/util/memory_usage.hpp>
 #include <mbgl/util/work_queue.hpp>
 #include <mbgl/gl/object.hpp>
+#include <mbgl/gl/dirty_regions.hpp>
 
 #include <atomic>
+#include <list>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
 #include <exception>
 #include <vector>
 
@@ -22,26 +29,52 @@ namespace mbgl {
 
 class FileSource;
 class GlyphPBF;
+class LocalGlyphRasterizer;
 class GlyphAtlasObserver;
 
 namespace gl {
 class Context;
 } // namespace gl
 
+// Holds the glyphs that the tiles' labels use in a texture. It starts with a single page that's
+// as wide as the atlas, and adds more below it as needed, up to the atlas's height. Glyphs that no
+// tile uses anymore stay in it until their room is needed for other glyphs.
 class GlyphAtlas : public util::noncopyable {
 public:
+    static constexpr uint16_t PageHeight = 512;
+
     GlyphAtlas(uint16_t width, uint16_t height, FileSource&);
     ~GlyphAtlas();
 
-    util::exclusive<GlyphSet> getGlyphSet(const FontStack&);
+    util::exclusive<GlyphSet, std::lock_guard<std::shared_timed_mutex>> getGlyphSet(const FontStack&);
+
+    // Like getGlyphSet(), but for reading only: several threads may hold the same set at once,
+    // e.g. to shape the labels of several layers in parallel.
+    util::exclusive<const GlyphSet, std::shared_lock<std::shared_timed_mutex>> readGlyphSet(const FontStack&);
+
+    // The shapings of the labels laid out with the glyphs of this atlas, shared by all tiles.
+    ShapingCache& getShapingCache() { return shapingCache; }
 
     // Returns true if the set of GlyphRanges are available and parsed or false
     // if they are not. For the missing ranges, a request on the FileSource is
     // made and when the glyph if finally parsed, it gets added to the respective
-    // GlyphSet and a signal is emitted to notify the observers. This method
-    // can be called from any thread.
+    // GlyphSet and a signal is emitted to notify the observers. Missing ranges
+    // that the local glyph rasterizer covers are drawn by the calling thread
+    // instead. This method can be called from any thread.
     bool hasGlyphRanges(const FontStack&, const GlyphRangeSet&);
 
+    // Requests the glyph ranges that labels of the font stack are likely to need: basic Latin, and
+    // the ranges they needed in earlier launches, if there's a history. Call once the URL is set.
+    void prefetchGlyphRanges(const FontStack&);
+
+    // Loads the history of the glyph ranges that labels needed from the file at `path`, and records
+    // the ranges they need from now on in it. See GlyphRangeHistory.
+    void setHistoryPath(const std::string&);
+
+    // Draws the glyphs of the ranges that it covers with local fonts, instead of downloading them.
+    // Must be set before any glyphs are requested.
+    void setLocalGlyphRasterizer(std::shared_ptr<LocalGlyphRasterizer>);
+
     void setURL(const std::string &url) {
         glyphURL = url;
     }
@@ -63,45 +96,82 @@ public:
     void bind(gl::Context&, gl::TextureUnit unit);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty), and only the glyphs that
+    // were added since the last upload are written, unless pages were added.
     void upload(gl::Context&, gl::TextureUnit unit);
 
+    // The height of the uploaded texture, which the glyphs' texture coordinates are relative to.
+    // Only valid on the thread that uploads the texture.
+    uint16_t getTextureHeight() const { return textureHeight; }
+
+    // The memory held by the loaded glyphs and the atlas, and by its texture. The GPU part is
+    // only valid on the thread that uploads the texture.
+    MemoryUsage getMemoryUsage();
+
     const uint16_t width;
+    // The most the atlas grows to.
     const uint16_t height;
 
 private:
     void requestGlyphRange(const FontStack&, const GlyphRange&);
+    bool isLocalGlyphRange(const FontStack&, const GlyphRange&) const;
+    void rasterizeGlyphRange(const FontStack&, const GlyphRange&);
 
     Rect<uint16_t> addGlyph(uintptr_t tileID,
                             const FontStack&,
                             const SDFGlyph&);
 
+    // Finds room for a glyph in the pages, adding a page or evicting the glyphs that have been
+    // unused for longest if there's none. Returns an empty rect if the atlas is full.
+    Rect<uint16_t> allocate(uint16_t packWidth, uint16_t packHeight);
+    void addPage();
+    void release(const Rect<uint16_t>&);
+    void markDirty(const Rect<uint16_t>&);
+
 
     FileSource& fileSource;
     std::string glyphURL;
 
     std::unordered_map<FontStack, std::map<GlyphRange, std::unique_ptr<GlyphPBF>>, FontStackHash> ranges;
+    GlyphRangeHistory history;
+    std::shared_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    // The ranges that are drawn locally, and whether they're done.
+    std::unordered_map<FontStack, std::map<GlyphRange, bool>, FontStackHash> localRanges;
     std::mutex rangesMutex;
 
     std::unordered_map<FontStack, std::unique_ptr<GlyphSet>, FontStackHash> glyphSets;
-    std::mutex glyphSetsMutex;
+    std::shared_timed_mutex glyphSetsMutex;
+
+    ShapingCache shapingCache;
 
     util::WorkQueue workQueue;
 
     GlyphAtlasObserver* observer = nullptr;
 
+    struct GlyphValue;
+    struct UnusedGlyph {
+        std::map<uint32_t, GlyphValue>* face;
+        uint32_t id;
+    };
+
     struct GlyphValue {
         GlyphValue(Rect<uint16_t> rect_, uintptr_t id)
             : rect(std::move(rect_)), ids({ id }) {}
         Rect<uint16_t> rect;
         std::unordered_set<uintptr_t> ids;
+        // The glyph's position in the list of unused glyphs, once no tile uses it.
+        optional<std::list<UnusedGlyph>::iterator> unused;
     };
 
     std::mutex mtx;
-    BinPack<uint16_t> bin;
+    std::vector<std::unique_ptr<BinPack<uint16_t>>> pages;
     std::unordered_map<FontStack, std::map<uint32_t, GlyphValue>, FontStackHash> index;
-    const std::unique_ptr<uint8_t[]> data;
+    // The glyphs that no tile uses anymore, from the one that has been unused the longest.
+    std::list<UnusedGlyph> unused;
+    std::vector<uint8_t> data;
     std::atomic<bool> dirty;
+    gl::DirtyRegions dirtyRegions;
+    uint16_t textureHeight = 0;
     mbgl::optional<gl::UniqueTexture> texture;
 };
 
@@ -6,6 +6,8 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/startup_trace.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/token.hpp>
 #include <mbgl/util/url.hpp>
@@ -69,7 +71,8 @@ GlyphPBF::GlyphPBF(GlyphAtlas* atlas,
                    FileSource& fileSource)
     : parsed(false),
       observer(observer_) {
-    req = fileSource.request(Resource::glyphs(atlas->getURL(), fontStack, glyphRange), [this, atlas, fontStack, glyphRange](Response res) {
+    const TimePoint begin = Clock::now();
+    req = fileSource.request(Resource::glyphs(atlas->getURL(), fontStack, glyphRange), [this, atlas, fontStack, glyphRange, begin](Response res) {
         if (res.error) {
             observer->onGlyphsError(fontStack, glyphRange, std::make_exception_ptr(std::runtime_error(res.error->message)));
         } else if (res.notModified) {
@@ -86,6 +89,11 @@ GlyphPBF::GlyphPBF(GlyphAtlas* atlas,
             }
 
             parsed = true;
+            if (StartupTrace::isEnabled()) {
+                StartupTrace::record("glyphs " + fontStackToString(fontStack) + " " +
+                                     util::toString(glyphRange.first) + "-" + util::toString(glyphRange.second),
+                                     begin, Clock::now(), { "style parse" });
+            }
             observer->onGlyphsLoaded(fontStack, glyphRange);
         }
     });
@@ -0,0 +1,117 @@
+#include <mbgl/text/glyph_range_history.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+#include <vector>
+
+namespace mbgl {
+
+void GlyphRangeHistory::setPath(const std::string& path_) {
+    path = path_;
+    changed = false;
+    ranges.clear();
+
+    if (path.empty()) {
+        return;
+    }
+
+    try {
+        decode(util::read_file(path));
+    } catch (const std::exception&) {
+        // There's no history yet.
+    }
+}
+
+bool GlyphRangeHistory::add(const FontStack& fontStack, const GlyphRange& range) {
+    if (!ranges[fontStack].insert(range).second) {
+        return false;
+    }
+    changed = true;
+    return true;
+}
+
+GlyphRangeSet GlyphRangeHistory::get(const FontStack& fontStack) const {
+    auto it = ranges.find(fontStack);
+    return it != ranges.end() ? it->second : GlyphRangeSet();
+}
+
+void GlyphRangeHistory::save() {
+    if (path.empty() || !changed) {
+        return;
+    }
+
+    try {
+        util::write_file(path, encode());
+        changed = false;
+    } catch (const std::exception& e) {
+        Log::Warning(Event::Glyph, "Failed to save glyph range history: %s", e.what());
+    }
+}
+
+std::string GlyphRangeHistory::encode() const {
+    std::vector<std::string> lines;
+    for (const auto& entry : ranges) {
+        std::vector<uint16_t> starts;
+        for (const auto& range : entry.second) {
+            starts.push_back(range.first);
+        }
+        std::sort(starts.begin(), starts.end());
+
+        std::string line;
+        for (uint16_t start : starts) {
+            if (!line.empty()) {
+                line += ' ';
+            }
+            line += std::to_string(start);
+        }
+        for (const auto& font : entry.first) {
+            line += '\t';
+            line += font;
+        }
+        lines.push_back(std::move(line));
+    }
+
+    // Sorted, so that the same history always saves the same file.
+    std::sort(lines.begin(), lines.end());
+
+    std::string data;
+    for (const auto& line : lines) {
+        data += line;
+        data += '\n';
+    }
+    return data;
+}
+
+void GlyphRangeHistory::decode(const std::string& data) {
+    std::istringstream lines(data);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string starts;
+        FontStack fontStack;
+        std::getline(fields, starts, '\t');
+        for (std::string font; std::getline(fields, font, '\t');) {
+            fontStack.push_back(font);
+        }
+        if (fontStack.empty()) {
+            continue;
+        }
+
+        std::istringstream numbers(starts);
+        for (std::string number; numbers >> number;) {
+            char* end = nullptr;
+            const unsigned long start = std::strtoul(number.c_str(), &end, 10);
+            if (*end != '\0' || start % GLYPHS_PER_GLYPH_RANGE != 0 ||
+                start >= GLYPHS_PER_GLYPH_RANGE * GLYPH_RANGES_PER_FONT_STACK) {
+                continue;
+            }
+            ranges[fontStack].emplace(start, start + GLYPHS_PER_GLYPH_RANGE - 1);
+        }
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/text/glyph_range.hpp>
+#include <mbgl/util/font_stack.hpp>
+
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+// The glyph ranges that the labels of each font stack needed, kept across launches in a file, so
+// that a style's glyphs can be requested as soon as it's loaded, rather than once its first tiles
+// are laid out. Not thread-safe; the glyph atlas guards it.
+class GlyphRangeHistory {
+public:
+    // Loads the history from the file at `path`, which it's saved to from now on. Empty, the
+    // default, keeps the history in memory only.
+    void setPath(const std::string&);
+    const std::string& getPath() const { return path; }
+
+    // Records that labels of the font stack needed the range. Returns whether it's new.
+    bool add(const FontStack&, const GlyphRange&);
+    GlyphRangeSet get(const FontStack&) const;
+
+    // Writes the history to its file, if it has one and recorded new ranges since it was loaded
+    // or last saved.
+    void save();
+
+    // One line per font stack: the first glyphs of its ranges, separated by spaces, then its
+    // fonts, each preceded by a tab.
+    std::string encode() const;
+    void decode(const std::string&);
+
+private:
+    std::string path;
+    bool changed = false;
+    std::unordered_map<FontStack, GlyphRangeSet, FontStackHash> ranges;
+};
+
+} // namespace mbgl
@@ -0,0 +1,139 @@
+#include <mbgl/text/glyph_sdf.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/math/clamp.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+const int32_t buffer = 3;
+const float radius = 8;
+const float cutoff = 0.25;
+const float infinity = 1e20;
+
+// The squared distance transform of an array with a stride, after Felzenszwalb and Huttenlocher,
+// "Distance Transforms of Sampled Functions".
+class DistanceTransform {
+public:
+    explicit DistanceTransform(std::size_t size) : f(size), d(size), v(size), z(size + 1) {}
+
+    void operator()(float* grid, std::size_t offset, std::size_t stride, std::size_t length) {
+        for (std::size_t q = 0; q < length; ++q) {
+            f[q] = grid[offset + q * stride];
+        }
+
+        std::size_t k = 0;
+        v[0] = 0;
+        z[0] = -infinity;
+        z[1] = infinity;
+        for (std::size_t q = 1; q < length; ++q) {
+            float s = intersection(q, v[k]);
+            // z[0] is below any intersection, so k doesn't drop below 0.
+            while (s <= z[k]) {
+                k--;
+                s = intersection(q, v[k]);
+            }
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = infinity;
+        }
+
+        k = 0;
+        for (std::size_t q = 0; q < length; ++q) {
+            while (z[k + 1] < q) {
+                k++;
+            }
+            const float distance = float(q) - float(v[k]);
+            d[q] = distance * distance + f[v[k]];
+        }
+
+        for (std::size_t q = 0; q < length; ++q) {
+            grid[offset + q * stride] = d[q];
+        }
+    }
+
+    // Transforms the rows and then the columns of a grid.
+    void operator()(std::vector<float>& grid, std::size_t width, std::size_t height) {
+        for (std::size_t x = 0; x < width; ++x) {
+            (*this)(grid.data(), x, width, height);
+        }
+        for (std::size_t y = 0; y < height; ++y) {
+            (*this)(grid.data(), y * width, 1, width);
+        }
+    }
+
+private:
+    // Where the parabolas rooted at q and r intersect.
+    float intersection(std::size_t q, std::size_t r) const {
+        return ((f[q] + float(q * q)) - (f[r] + float(r * r))) / (2.0f * q - 2.0f * r);
+    }
+
+    std::vector<float> f;
+    std::vector<float> d;
+    std::vector<std::size_t> v;
+    std::vector<float> z;
+};
+
+} // namespace
+
+SDFGlyph generateSDFGlyph(uint32_t id, const RasterizedGlyph& glyph) {
+    assert(glyph.coverage.size() == glyph.width * glyph.height);
+
+    SDFGlyph sdf;
+    sdf.id = id;
+    sdf.metrics.width = glyph.width;
+    sdf.metrics.height = glyph.height;
+    sdf.metrics.left = glyph.left;
+    sdf.metrics.top = glyph.top;
+    sdf.metrics.advance = glyph.advance;
+
+    if (!glyph.width || !glyph.height) {
+        return sdf;
+    }
+
+    const std::size_t width = glyph.width + 2 * buffer;
+    const std::size_t height = glyph.height + 2 * buffer;
+
+    // The squared distances to the nearest pixel outside and inside the glyph. Partially covered
+    // pixels start at the distance to the edge that their coverage implies.
+    std::vector<float> outer(width * height, infinity);
+    std::vector<float> inner(width * height, 0);
+    for (std::size_t y = 0; y < glyph.height; ++y) {
+        for (std::size_t x = 0; x < glyph.width; ++x) {
+            const float a = glyph.coverage[y * glyph.width + x] / 255.0f;
+            const std::size_t i = (y + buffer) * width + x + buffer;
+            if (a == 1) {
+                outer[i] = 0;
+                inner[i] = infinity;
+            } else if (a > 0) {
+                const float toOutside = std::fmax(0, 0.5f - a);
+                const float toInside = std::fmax(0, a - 0.5f);
+                outer[i] = toOutside * toOutside;
+                inner[i] = toInside * toInside;
+            } else {
+                outer[i] = infinity;
+                inner[i] = 0;
+            }
+        }
+    }
+
+    DistanceTransform transform(std::max(width, height));
+    transform(outer, width, height);
+    transform(inner, width, height);
+
+    sdf.bitmap.resize(width * height);
+    for (std::size_t i = 0; i < width * height; ++i) {
+        const float distance = std::sqrt(outer[i]) - std::sqrt(inner[i]);
+        const float value = std::round(255 - 255 * (distance / radius + cutoff));
+        sdf.bitmap[i] = char(uint8_t(util::clamp(value, 0.0f, 255.0f)));
+    }
+
+    return sdf;
+}
+
+} // namespace mbgl
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+
+namespace mbgl {
+
+struct RasterizedGlyph;
+
+// Turns a glyph drawn locally into a signed distance field like those of glyph PBFs: 3 more pixels
+// on each side, with the glyph's edge at three quarters of the range of values, which spans 8
+// pixels of distance.
+SDFGlyph generateSDFGlyph(uint32_t id, const RasterizedGlyph&);
+
+} // namespace mbgl
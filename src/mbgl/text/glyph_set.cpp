@@ -2,23 +2,36 @@
 #include <mbgl/platform/log.hpp>
 #include <mbgl/math/minmax.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 namespace mbgl {
 
 void GlyphSet::insert(uint32_t id, SDFGlyph&& glyph) {
-    auto it = sdfs.find(id);
-    if (it == sdfs.end()) {
+    if (id >= GLYPHS_PER_GLYPH_RANGE * GLYPH_RANGES_PER_FONT_STACK) {
+        // Glyph ranges only cover the BMP; see getGlyphRange().
+        return;
+    }
+
+    std::unique_ptr<Block>& block = blocks[id / GLYPHS_PER_GLYPH_RANGE];
+    if (!block) {
+        block = std::make_unique<Block>();
+    }
+
+    const uint32_t offset = id % GLYPHS_PER_GLYPH_RANGE;
+    SDFGlyph& existing = block->glyphs[offset];
+    if (!block->loaded[offset]) {
         // Glyph doesn't exist yet.
-        sdfs.emplace(id, std::move(glyph));
-    } else if (it->second.metrics == glyph.metrics) {
-        if (it->second.bitmap != glyph.bitmap) {
+        existing = std::move(glyph);
+        block->loaded[offset] = true;
+    } else if (existing.metrics == glyph.metrics) {
+        if (existing.bitmap != glyph.bitmap) {
             // The actual bitmap was updated; this is unsupported.
             Log::Warning(Event::Glyph, "Modified glyph changed bitmap represenation");
         }
         // At least try to update it in case it's currently unsused.
         // If it is already used; we won't attempt to update the glyph atlas texture.
-        it->second.bitmap = std::move(glyph.bitmap);
+        existing.bitmap = std::move(glyph.bitmap);
     } else {
         // The metrics were updated; this is unsupported.
         Log::Warning(Event::Glyph, "Modified glyph has different metrics");
@@ -26,8 +39,32 @@ void GlyphSet::insert(uint32_t id, SDFGlyph&& glyph) {
     }
 }
 
-const std::map<uint32_t, SDFGlyph> &GlyphSet::getSDFs() const {
-    return sdfs;
+const SDFGlyph* GlyphSet::getSDF(uint32_t id) const {
+    if (id >= GLYPHS_PER_GLYPH_RANGE * GLYPH_RANGES_PER_FONT_STACK) {
+        return nullptr;
+    }
+    const Block* block = blocks[id / GLYPHS_PER_GLYPH_RANGE].get();
+    const uint32_t offset = id % GLYPHS_PER_GLYPH_RANGE;
+    return block && block->loaded[offset] ? &block->glyphs[offset] : nullptr;
+}
+
+bool GlyphSet::empty() const {
+    return std::none_of(blocks.begin(), blocks.end(), [] (const auto& block) {
+        return block && block->loaded.any();
+    });
+}
+
+std::size_t GlyphSet::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    for (const auto& block : blocks) {
+        if (block) {
+            bytes += sizeof(Block);
+            for (const auto& glyph : block->glyphs) {
+                bytes += glyph.bitmap.capacity();
+            }
+        }
+    }
+    return bytes;
 }
 
 const Shaping GlyphSet::getShaping(const std::u32string &string, const float maxWidth,
@@ -44,10 +81,9 @@ const Shaping GlyphSet::getShaping(const std::u32string &string, const float max
 
     // Loop through all characters of this label and shape.
     for (uint32_t chr : string) {
-        auto it = sdfs.find(chr);
-        if (it != sdfs.end()) {
+        if (const SDFGlyph* glyph = getSDF(chr)) {
             shaping.positionedGlyphs.emplace_back(chr, x, y);
-            x += it->second.metrics.advance + spacing;
+            x += glyph->metrics.advance + spacing;
         }
     }
 
@@ -71,12 +107,11 @@ void align(Shaping &shaping, const float justify, const float horizontalAlign,
     }
 }
 
-void justifyLine(std::vector<PositionedGlyph> &positionedGlyphs, const std::map<uint32_t, SDFGlyph> &sdfs, uint32_t start,
-                 uint32_t end, float justify) {
+void GlyphSet::justifyLine(std::vector<PositionedGlyph> &positionedGlyphs, uint32_t start,
+                           uint32_t end, float justify) const {
     PositionedGlyph &glyph = positionedGlyphs[end];
-    auto it = sdfs.find(glyph.glyph);
-    if (it != sdfs.end()) {
-        const uint32_t lastAdvance = it->second.metrics.advance;
+    if (const SDFGlyph* sdf = getSDF(glyph.glyph)) {
+        const uint32_t lastAdvance = sdf->metrics.advance;
         const float lineIndent = float(glyph.x + lastAdvance) * justify;
 
         for (uint32_t j = start; j <= end; j++) {
@@ -124,7 +159,7 @@ void GlyphSet::lineWrap(Shaping &shaping, const float lineHeight, const float ma
                         lineEnd--;
                     }
 
-                    justifyLine(positionedGlyphs, sdfs, lineStartIndex, lineEnd, justify);
+                    justifyLine(positionedGlyphs, lineStartIndex, lineEnd, justify);
                 }
 
                 lineStartIndex = lastSafeBreak + 1;
@@ -150,14 +185,14 @@ void GlyphSet::lineWrap(Shaping &shaping, const float lineHeight, const float ma
     }
 
     const PositionedGlyph& lastPositionedGlyph = positionedGlyphs.back();
-    const auto lastGlyphIt = sdfs.find(lastPositionedGlyph.glyph);
-    assert(lastGlyphIt != sdfs.end());
-    const uint32_t lastLineLength = lastPositionedGlyph.x + lastGlyphIt->second.metrics.advance;
+    const SDFGlyph* lastGlyph = getSDF(lastPositionedGlyph.glyph);
+    assert(lastGlyph);
+    const uint32_t lastLineLength = lastPositionedGlyph.x + lastGlyph->metrics.advance;
     maxLineLength = std::max(maxLineLength, lastLineLength);
 
     const uint32_t height = (line + 1) * lineHeight;
 
-    justifyLine(positionedGlyphs, sdfs, lineStartIndex, uint32_t(positionedGlyphs.size()) - 1, justify);
+    justifyLine(positionedGlyphs, lineStartIndex, uint32_t(positionedGlyphs.size()) - 1, justify);
     align(shaping, justify, horizontalAlign, verticalAlign, maxLineLength, lineHeight, line, translate);
 
     // Calculate the bounding box
@@ -3,12 +3,23 @@
 #include <mbgl/text/glyph.hpp>
 #include <mbgl/util/geometry.hpp>
 
+#include <array>
+#include <bitset>
+#include <memory>
+
 namespace mbgl {
 
 class GlyphSet {
 public:
     void insert(uint32_t id, SDFGlyph&&);
-    const std::map<uint32_t, SDFGlyph> &getSDFs() const;
+
+    // The glyph with the ID, if it was loaded.
+    const SDFGlyph* getSDF(uint32_t id) const;
+    bool empty() const;
+
+    // The memory held by the blocks of glyphs and their bitmaps, in bytes.
+    std::size_t getMemoryUsage() const;
+
     const Shaping getShaping(const std::u32string &string, float maxWidth, float lineHeight,
                              float horizontalAlign, float verticalAlign, float justify,
                              float spacing, const Point<float> &translate) const;
@@ -16,7 +27,17 @@ public:
                   float verticalAlign, float justify, const Point<float> &translate) const;
 
 private:
-    std::map<uint32_t, SDFGlyph> sdfs;
+    void justifyLine(std::vector<PositionedGlyph>&, uint32_t start, uint32_t end, float justify) const;
+
+    // The glyphs of a glyph range, which are loaded together, indexed by their offset in it.
+    struct Block {
+        std::bitset<GLYPHS_PER_GLYPH_RANGE> loaded;
+        std::array<SDFGlyph, GLYPHS_PER_GLYPH_RANGE> glyphs;
+    };
+
+    // Shaping looks up every glyph of every label, so the glyphs are kept in blocks of dense
+    // tables rather than a tree. Blocks are only allocated for the ranges that were loaded.
+    std::array<std::unique_ptr<Block>, GLYPH_RANGES_PER_FONT_STACK> blocks;
 };
 
 } // end namespace mbgl
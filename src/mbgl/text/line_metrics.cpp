@@ -0,0 +1,29 @@
+#include <mbgl/text/line_metrics.hpp>
+#include <mbgl/util/math.hpp>
+
+#include <cmath>
+
+namespace mbgl {
+
+LineMetrics::LineMetrics(const GeometryCoordinates& line) {
+    if (line.size() < 2) {
+        return;
+    }
+
+    lengths.reserve(line.size() - 1);
+    angles.reserve(line.size() - 1);
+    for (std::size_t i = 0; i + 1 < line.size(); ++i) {
+        lengths.push_back(util::dist<float>(line[i], line[i + 1]));
+        angles.push_back(util::angle_to(line[i + 1], line[i]));
+        length += lengths.back();
+    }
+
+    turns.assign(line.size(), 0);
+    for (std::size_t i = 1; i + 1 < line.size(); ++i) {
+        float angleDelta = util::angle_to(line[i - 1], line[i]) - util::angle_to(line[i], line[i + 1]);
+        // restrict angle to -pi..pi range
+        turns[i] = std::fabs(std::fmod(angleDelta + 3 * M_PI, M_PI * 2) - M_PI);
+    }
+}
+
+} // namespace mbgl
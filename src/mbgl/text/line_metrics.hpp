@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <vector>
+
+namespace mbgl {
+
+// The lengths and directions of the segments of a line, and the angles at its vertices. They're
+// computed once per line, and shared by all the labels placed along it.
+class LineMetrics {
+public:
+    LineMetrics() = default;
+    explicit LineMetrics(const GeometryCoordinates&);
+
+    // The length of the segment from vertex `i` to vertex `i + 1`, and its direction.
+    std::vector<float> lengths;
+    std::vector<float> angles;
+
+    // The change of direction at vertex `i`, in [0, pi]; 0 at both ends of the line.
+    std::vector<float> turns;
+
+    // The sum of the segment lengths.
+    float length = 0;
+};
+
+} // namespace mbgl
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <mbgl/math/wrap.hpp>
+
+#include <cmath>
+
 namespace mbgl {
 
 class PlacementConfig {
@@ -16,6 +20,18 @@ public:
         return !operator==(rhs);
     }
 
+    // Whether the symbols placed for `rhs` still look right at this config: the angle and pitch
+    // are within `AngleTolerance` radians of each other. Used to keep a placement while the
+    // camera moves.
+    bool isCloseTo(const PlacementConfig& rhs) const {
+        return debug == rhs.debug &&
+               std::abs(util::wrap<float>(angle - rhs.angle, -M_PI, M_PI)) <= AngleTolerance &&
+               std::abs(pitch - rhs.pitch) <= AngleTolerance;
+    }
+
+    // About three degrees.
+    static constexpr float AngleTolerance = 0.05f;
+
 public:
     float angle;
     float pitch;
@@ -1,5 +1,6 @@
 #include <mbgl/text/quads.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/line_metrics.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/geometry/anchor.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
@@ -109,7 +110,7 @@ struct GlyphInstance {
 typedef std::vector<GlyphInstance> GlyphInstances;
 
 void getSegmentGlyphs(std::back_insert_iterator<GlyphInstances> glyphs, Anchor &anchor,
-        float offset, const GeometryCoordinates &line, int segment, bool forward) {
+        float offset, const GeometryCoordinates &line, const LineMetrics &metrics, int segment, bool forward) {
 
     const bool upsideDown = !forward;
 
@@ -128,12 +129,15 @@ void getSegmentGlyphs(std::back_insert_iterator<GlyphInstances> glyphs, Anchor &
 
     const float placementScale = anchor.scale;
 
+    // Past the anchor's own segment, the glyph moves along whole segments of the line, whose
+    // lengths and directions are known.
+    float dist = util::dist<float>(newAnchorPoint, end);
+    float angle = std::atan2(end.y - newAnchorPoint.y, end.x - newAnchorPoint.x);
+    if (!forward)
+        angle += M_PI;
+
     while (true) {
-        const float dist = util::dist<float>(newAnchorPoint, end);
         const float scale = offset / dist;
-        float angle = std::atan2(end.y - newAnchorPoint.y, end.x - newAnchorPoint.x);
-        if (!forward)
-            angle += M_PI;
 
         glyphs = GlyphInstance{
             /* anchor */ newAnchorPoint,
@@ -148,25 +152,34 @@ void getSegmentGlyphs(std::back_insert_iterator<GlyphInstances> glyphs, Anchor &
         newAnchorPoint = end;
 
         // skip duplicate nodes
-        while (newAnchorPoint == end) {
-            segment += forward ? 1 : -1;
-            if ((int)line.size() <= segment || segment < 0) {
+        float segmentLength = 0;
+        while (segmentLength == 0) {
+            const int next = segment + (forward ? 1 : -1);
+            if ((int)line.size() <= next || next < 0) {
                 anchor.scale = scale;
                 return;
             }
-            end = convertPoint<float>(line[segment]);
+            const int index = forward ? segment : next;
+            segmentLength = metrics.lengths[index];
+            // Both directions of a segment give the same angle here, since walking backwards
+            // adds pi to it.
+            angle = metrics.angles[index];
+            segment = next;
         }
+        end = convertPoint<float>(line[segment]);
 
-        Point<float> normal = util::normal<float>(newAnchorPoint, end) * dist;
+        Point<float> normal = (end - newAnchorPoint) * (dist / segmentLength);
         newAnchorPoint = newAnchorPoint - normal;
+        dist += segmentLength;
 
         prevscale = scale;
     }
 }
 
 SymbolQuads getGlyphQuads(Anchor& anchor, const Shaping& shapedText,
-        const float boxScale, const GeometryCoordinates& line, const SymbolLayoutProperties& layout,
-        const style::SymbolPlacementType placement, const GlyphPositions& face) {
+        const float boxScale, const GeometryCoordinates& line, const LineMetrics& metrics,
+        const SymbolLayoutProperties& layout, const style::SymbolPlacementType placement,
+        const GlyphPositions& face) {
 
     const float textRotate = layout.textRotate * util::DEG2RAD;
     const bool keepUpright = layout.textKeepUpright;
@@ -190,9 +203,9 @@ SymbolQuads getGlyphQuads(Anchor& anchor, const Shaping& shapedText,
 
         GlyphInstances glyphInstances;
         if (placement == style::SymbolPlacementType::Line) {
-            getSegmentGlyphs(std::back_inserter(glyphInstances), anchor, centerX, line, anchor.segment, true);
+            getSegmentGlyphs(std::back_inserter(glyphInstances), anchor, centerX, line, metrics, anchor.segment, true);
             if (keepUpright)
-                getSegmentGlyphs(std::back_inserter(glyphInstances), anchor, centerX, line, anchor.segment, false);
+                getSegmentGlyphs(std::back_inserter(glyphInstances), anchor, centerX, line, metrics, anchor.segment, false);
 
         } else {
             glyphInstances.emplace_back(GlyphInstance{anchor.point});
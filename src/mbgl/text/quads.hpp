@@ -9,6 +9,7 @@
 namespace mbgl {
 
 struct Anchor;
+class LineMetrics;
 class PositionedIcon;
 
 namespace style {
@@ -43,8 +44,10 @@ SymbolQuads getIconQuads(Anchor& anchor, const PositionedIcon& shapedIcon,
         const GeometryCoordinates& line, const style::SymbolLayoutProperties&,
         style::SymbolPlacementType placement, const Shaping& shapedText);
 
+// Along lines, `metrics` are those of `line`.
 SymbolQuads getGlyphQuads(Anchor& anchor, const Shaping& shapedText,
-        const float boxScale, const GeometryCoordinates& line, const style::SymbolLayoutProperties&,
-        style::SymbolPlacementType placement, const GlyphPositions& face);
+        const float boxScale, const GeometryCoordinates& line, const LineMetrics& metrics,
+        const style::SymbolLayoutProperties&, style::SymbolPlacementType placement,
+        const GlyphPositions& face);
 
 } // namespace mbgl
@@ -0,0 +1,134 @@
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+bool ShapingKey::operator==(const ShapingKey& other) const {
+    return text == other.text &&
+           fontStack == other.fontStack &&
+           maxWidth == other.maxWidth &&
+           lineHeight == other.lineHeight &&
+           horizontalAlign == other.horizontalAlign &&
+           verticalAlign == other.verticalAlign &&
+           justify == other.justify &&
+           spacing == other.spacing &&
+           translate == other.translate;
+}
+
+std::size_t ShapingKeyHash::operator()(const ShapingKey& key) const {
+    std::size_t seed = FontStackHash()(key.fontStack);
+    boost::hash_combine(seed, boost::hash_range(key.text.begin(), key.text.end()));
+    boost::hash_combine(seed, key.maxWidth);
+    boost::hash_combine(seed, key.lineHeight);
+    boost::hash_combine(seed, key.horizontalAlign);
+    boost::hash_combine(seed, key.verticalAlign);
+    boost::hash_combine(seed, key.justify);
+    boost::hash_combine(seed, key.spacing);
+    boost::hash_combine(seed, key.translate.x);
+    boost::hash_combine(seed, key.translate.y);
+    return seed;
+}
+
+namespace {
+
+// The memory an entry holds: its map node, and what its key and shaping allocate.
+std::size_t entryBytes(const ShapingKey& key, const Shaping& shaping) {
+    std::size_t bytes = sizeof(std::pair<const ShapingKey, Shaping>) + 2 * sizeof(void*);
+    for (const auto& font : key.fontStack) {
+        bytes += sizeof(std::string) + font.capacity();
+    }
+    bytes += key.text.capacity() * sizeof(char32_t);
+    bytes += shaping.text.capacity() * sizeof(char32_t);
+    bytes += shaping.positionedGlyphs.capacity() * sizeof(PositionedGlyph);
+    return bytes;
+}
+
+} // namespace
+
+void ShapingCache::setMaxBytes(std::size_t maxBytes_) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxBytes = maxBytes_;
+    evict();
+}
+
+std::size_t ShapingCache::getMaxBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maxBytes;
+}
+
+std::size_t ShapingCache::getBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+std::size_t ShapingCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return shapings.size();
+}
+
+optional<Shaping> ShapingCache::get(const ShapingKey& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = shapings.find(key);
+    if (it == shapings.end()) {
+        return {};
+    }
+
+    Entry& entry = it->second;
+    unlink(entry);
+    link(entry);
+    return entry.shaping;
+}
+
+void ShapingCache::add(const ShapingKey& key, const Shaping& shaping) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto result = shapings.emplace(key, Entry { shaping });
+    if (!result.second) {
+        // Another thread shaped the same label in the meantime; the shapings are the same.
+        return;
+    }
+
+    Entry& entry = result.first->second;
+    entry.key = &result.first->first;
+    entry.bytes = entryBytes(key, shaping);
+    bytes += entry.bytes;
+    link(entry);
+
+    evict();
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    shapings.clear();
+    oldest = nullptr;
+    newest = nullptr;
+    bytes = 0;
+}
+
+void ShapingCache::link(Entry& entry) {
+    entry.older = newest;
+    entry.newer = nullptr;
+    (newest ? newest->newer : oldest) = &entry;
+    newest = &entry;
+}
+
+void ShapingCache::unlink(Entry& entry) {
+    (entry.older ? entry.older->newer : oldest) = entry.newer;
+    (entry.newer ? entry.newer->older : newest) = entry.older;
+}
+
+void ShapingCache::evict() {
+    while (oldest && bytes > maxBytes) {
+        Entry& entry = *oldest;
+        assert(bytes >= entry.bytes);
+        bytes -= entry.bytes;
+        unlink(entry);
+        shapings.erase(shapings.find(*entry.key));
+    }
+}
+
+} // namespace mbgl
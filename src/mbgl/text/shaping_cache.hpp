@@ -0,0 +1,82 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+// The parameters of GlyphSet::getShaping() that a label is shaped with.
+struct ShapingKey {
+    FontStack fontStack;
+    std::u32string text;
+    float maxWidth = 0;
+    float lineHeight = 0;
+    float horizontalAlign = 0;
+    float verticalAlign = 0;
+    float justify = 0;
+    float spacing = 0;
+    Point<float> translate;
+
+    bool operator==(const ShapingKey&) const;
+};
+
+struct ShapingKeyHash {
+    std::size_t operator()(const ShapingKey&) const;
+};
+
+// Holds the shapings of the labels that were laid out, so that the same street names and places
+// in neighboring tiles and at other zoom levels are only shaped once. Labels are only shaped once
+// all glyph ranges they need are parsed, and glyphs never change afterwards, so the shaping of a
+// key never goes stale. It's shared by the workers of all tiles, and may be used from any thread.
+class ShapingCache : private util::noncopyable {
+public:
+    static constexpr std::size_t DefaultMaxBytes = 4 * 1024 * 1024;
+
+    explicit ShapingCache(std::size_t maxBytes_ = DefaultMaxBytes) : maxBytes(maxBytes_) {}
+
+    // The most memory the cached shapings may hold. The least recently used ones are evicted once
+    // it's exceeded.
+    void setMaxBytes(std::size_t);
+    std::size_t getMaxBytes() const;
+
+    // The memory held by the cached shapings, and their number.
+    std::size_t getBytes() const;
+    std::size_t size() const;
+
+    // The shaping of the key, if it's cached. It becomes the most recently used.
+    optional<Shaping> get(const ShapingKey&);
+    void add(const ShapingKey&, const Shaping&);
+    void clear();
+
+private:
+    // The entries form a list from the least to the most recently used, through the map's nodes,
+    // like the tile cache's.
+    struct Entry {
+        Shaping shaping;
+        std::size_t bytes = 0;
+        const ShapingKey* key = nullptr;
+        Entry* older = nullptr;
+        Entry* newer = nullptr;
+    };
+
+    void link(Entry&);
+    void unlink(Entry&);
+    void evict();
+
+    mutable std::mutex mutex;
+    std::unordered_map<ShapingKey, Entry, ShapingKeyHash> shapings;
+    Entry* oldest = nullptr;
+    Entry* newest = nullptr;
+
+    std::size_t maxBytes;
+    std::size_t bytes = 0;
+};
+
+} // namespace mbgl
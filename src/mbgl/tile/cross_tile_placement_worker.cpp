@@ -0,0 +1,111 @@
+#include <mbgl/tile/cross_tile_placement_worker.hpp>
+#include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/util/constants.hpp>
+
+namespace mbgl {
+
+CrossTilePlacementWorker::CrossTilePlacementWorker(ActorRef<CrossTilePlacementWorker> self_)
+    : self(std::move(self_)) {
+}
+
+void CrossTilePlacementWorker::setSymbolLayouts(OverscaledTileID id,
+                                                ActorRef<GeometryTile> tile,
+                                                std::vector<std::shared_ptr<SymbolLayout>> symbolLayouts,
+                                                uint64_t correlationID) {
+    auto it = entries.find(id);
+    if (it != entries.end()) {
+        entries.erase(it);
+    }
+    entries.emplace(id, Entry { std::move(tile), std::move(symbolLayouts), correlationID });
+
+    if (tiles.count(id)) {
+        schedulePlacement();
+    }
+}
+
+void CrossTilePlacementWorker::setTiles(std::set<OverscaledTileID> tiles_) {
+    tiles = std::move(tiles_);
+
+    // Tiles that the source no longer uses forward their layouts again once they're used again.
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (tiles.count(it->first)) {
+            ++it;
+        } else {
+            it = entries.erase(it);
+        }
+    }
+
+    schedulePlacement();
+}
+
+void CrossTilePlacementWorker::setPlacementConfig(PlacementConfig placementConfig_) {
+    if (placementConfig == placementConfig_) {
+        return;
+    }
+
+    placementConfig = std::move(placementConfig_);
+    schedulePlacement();
+}
+
+void CrossTilePlacementWorker::schedulePlacement() {
+    if (!placementScheduled) {
+        placementScheduled = true;
+        self.invoke(&CrossTilePlacementWorker::place);
+    }
+}
+
+void CrossTilePlacementWorker::place() {
+    placementScheduled = false;
+
+    if (!placementConfig) {
+        return;
+    }
+
+    // Entries are ordered by zoom level first, so tiles that share a collision index are adjacent.
+    std::unique_ptr<CollisionTile> shared;
+    const OverscaledTileID* origin = nullptr;
+
+    for (auto& pair : entries) {
+        const OverscaledTileID& id = pair.first;
+        Entry& entry = pair.second;
+
+        if (!tiles.count(id)) {
+            continue;
+        }
+
+        if (!origin || origin->overscaledZ != id.overscaledZ || origin->canonical.z != id.canonical.z) {
+            shared = std::make_unique<CollisionTile>(*placementConfig);
+            origin = &id;
+        }
+
+        // Tiles of the same zoom level are one extent apart.
+        auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
+        collisionTile->shared = shared.get();
+        collisionTile->sharedOffset = {
+            float((int64_t(id.canonical.x) - int64_t(origin->canonical.x)) * util::EXTENT),
+            float((int64_t(id.canonical.y) - int64_t(origin->canonical.y)) * util::EXTENT)
+        };
+
+        std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+        for (auto& symbolLayout : entry.symbolLayouts) {
+            if (symbolLayout->hasSymbolInstances()) {
+                buckets.emplace(symbolLayout->bucketName,
+                                symbolLayout->place(*collisionTile));
+            }
+        }
+
+        collisionTile->shared = nullptr;
+
+        entry.tile.invoke(&GeometryTile::onPlacement, GeometryTile::PlacementResult {
+            std::move(buckets),
+            std::move(collisionTile),
+            *placementConfig,
+            entry.correlationID
+        });
+    }
+}
+
+} // namespace mbgl
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/text/placement_config.hpp>
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace mbgl {
+
+class GeometryTile;
+class SymbolLayout;
+
+/*
+    Places the symbols of all tiles of a source in one pass, with one collision index per zoom
+    level, instead of giving each tile its own. Labels of features that straddle a tile boundary
+    then only appear once, and labels near boundaries are checked against their neighbours in the
+    adjacent tile.
+
+    Each tile's `SymbolPlacementWorker` forwards its symbol layouts here while the source has
+    cross-tile placement enabled. The source tells this worker which tiles it currently uses, and
+    only those are placed. Each of them still gets a `CollisionTile` of its own for feature
+    queries, holding just its own symbols.
+*/
+class CrossTilePlacementWorker {
+public:
+    CrossTilePlacementWorker(ActorRef<CrossTilePlacementWorker> self);
+
+    void setSymbolLayouts(OverscaledTileID,
+                          ActorRef<GeometryTile>,
+                          std::vector<std::shared_ptr<SymbolLayout>>,
+                          uint64_t correlationID);
+    void setTiles(std::set<OverscaledTileID>);
+    void setPlacementConfig(PlacementConfig);
+
+private:
+    void schedulePlacement();
+    void place();
+
+    ActorRef<CrossTilePlacementWorker> self;
+
+    struct Entry {
+        ActorRef<GeometryTile> tile;
+        std::vector<std::shared_ptr<SymbolLayout>> symbolLayouts;
+        uint64_t correlationID;
+    };
+
+    std::map<OverscaledTileID, Entry> entries;
+    std::set<OverscaledTileID> tiles;
+    optional<PlacementConfig> placementConfig;
+
+    // Changes tend to arrive in bursts, e.g. as a batch of tiles finishes layout; one placement
+    // pass then covers all of them.
+    bool placementScheduled = false;
+};
+
+} // namespace mbgl
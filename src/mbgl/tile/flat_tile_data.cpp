@@ -0,0 +1,574 @@
+#include <mbgl/tile/flat_tile_data.hpp>
+#include <mbgl/util/memory_usage.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace mbgl {
+
+namespace {
+
+// "MLFT" in little-endian byte order. Reading a serialization that was written with the other
+// byte order fails on the magic number.
+constexpr uint32_t magic = 0x54464C4D;
+constexpr uint32_t version = 1;
+
+// The deepest nesting of array and object values that parse() accepts.
+constexpr std::size_t maxValueDepth = 32;
+
+enum class ValueType : uint8_t {
+    Null, Bool, Uint, Int, Double, String, Array, Object
+};
+
+enum class IdentifierType : uint8_t {
+    None, Uint, Int, Double, String
+};
+
+class Writer {
+public:
+    Writer(std::string& out_) : out(out_) {}
+
+    template <class T>
+    void write(T value) {
+        static_assert(std::is_arithmetic<T>::value, "only arithmetic types are written directly");
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeSize(std::size_t size) {
+        write(static_cast<uint32_t>(size));
+    }
+
+    void write(const std::string& string) {
+        writeSize(string.size());
+        out.append(string);
+    }
+
+    void write(const Value& value) {
+        Value::visit(value, ValueWriter { *this });
+    }
+
+    void write(const optional<FeatureIdentifier>& id) {
+        if (!id) {
+            write(static_cast<uint8_t>(IdentifierType::None));
+            return;
+        }
+        FeatureIdentifier::visit(*id, IdentifierWriter { *this });
+    }
+
+private:
+    struct ValueWriter {
+        Writer& writer;
+
+        void operator()(const NullValue&) const {
+            writer.write(static_cast<uint8_t>(ValueType::Null));
+        }
+        void operator()(bool value) const {
+            writer.write(static_cast<uint8_t>(ValueType::Bool));
+            writer.write(static_cast<uint8_t>(value));
+        }
+        void operator()(uint64_t value) const {
+            writer.write(static_cast<uint8_t>(ValueType::Uint));
+            writer.write(value);
+        }
+        void operator()(int64_t value) const {
+            writer.write(static_cast<uint8_t>(ValueType::Int));
+            writer.write(value);
+        }
+        void operator()(double value) const {
+            writer.write(static_cast<uint8_t>(ValueType::Double));
+            writer.write(value);
+        }
+        void operator()(const std::string& value) const {
+            writer.write(static_cast<uint8_t>(ValueType::String));
+            writer.write(value);
+        }
+        void operator()(const std::vector<Value>& array) const {
+            writer.write(static_cast<uint8_t>(ValueType::Array));
+            writer.writeSize(array.size());
+            for (const auto& value : array) {
+                writer.write(value);
+            }
+        }
+        void operator()(const PropertyMap& object) const {
+            writer.write(static_cast<uint8_t>(ValueType::Object));
+            writer.writeSize(object.size());
+            for (const auto& member : object) {
+                writer.write(member.first);
+                writer.write(member.second);
+            }
+        }
+    };
+
+    struct IdentifierWriter {
+        Writer& writer;
+
+        void operator()(uint64_t id) const {
+            writer.write(static_cast<uint8_t>(IdentifierType::Uint));
+            writer.write(id);
+        }
+        void operator()(int64_t id) const {
+            writer.write(static_cast<uint8_t>(IdentifierType::Int));
+            writer.write(id);
+        }
+        void operator()(double id) const {
+            writer.write(static_cast<uint8_t>(IdentifierType::Double));
+            writer.write(id);
+        }
+        void operator()(const std::string& id) const {
+            writer.write(static_cast<uint8_t>(IdentifierType::String));
+            writer.write(id);
+        }
+    };
+
+    std::string& out;
+};
+
+class Reader {
+public:
+    Reader(const std::string& data)
+        : pos(data.data()), end(data.data() + data.size()) {}
+
+    bool done() const {
+        return pos == end;
+    }
+
+    template <class T>
+    T read() {
+        static_assert(std::is_arithmetic<T>::value, "only arithmetic types are read directly");
+        T value;
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    // Reads an element count, and checks that the data could hold that many elements of at
+    // least `minSize` bytes each, so that a corrupt count can't make us allocate huge arrays.
+    std::size_t readSize(std::size_t minSize) {
+        const auto size = read<uint32_t>();
+        expect(size, minSize);
+        return size;
+    }
+
+    void expect(std::size_t count, std::size_t size) {
+        if (static_cast<std::size_t>(end - pos) / size < count) {
+            throw std::runtime_error("truncated tile data");
+        }
+    }
+
+    std::string readString() {
+        const std::size_t size = readSize(1);
+        std::string string(pos, size);
+        pos += size;
+        return string;
+    }
+
+    Value readValue(std::size_t depth = 0) {
+        if (depth > maxValueDepth) {
+            throw std::runtime_error("tile data values are nested too deeply");
+        }
+
+        switch (static_cast<ValueType>(read<uint8_t>())) {
+        case ValueType::Null:
+            return NullValue();
+        case ValueType::Bool:
+            return read<uint8_t>() != 0;
+        case ValueType::Uint:
+            return read<uint64_t>();
+        case ValueType::Int:
+            return read<int64_t>();
+        case ValueType::Double:
+            return read<double>();
+        case ValueType::String:
+            return readString();
+        case ValueType::Array: {
+            std::vector<Value> array(readSize(1));
+            for (auto& value : array) {
+                value = readValue(depth + 1);
+            }
+            return array;
+        }
+        case ValueType::Object: {
+            PropertyMap object;
+            for (std::size_t count = readSize(5); count > 0; --count) {
+                std::string key = readString();
+                object[std::move(key)] = readValue(depth + 1);
+            }
+            return object;
+        }
+        }
+
+        throw std::runtime_error("invalid tile data value type");
+    }
+
+    optional<FeatureIdentifier> readIdentifier() {
+        switch (static_cast<IdentifierType>(read<uint8_t>())) {
+        case IdentifierType::None:
+            return {};
+        case IdentifierType::Uint:
+            return FeatureIdentifier(read<uint64_t>());
+        case IdentifierType::Int:
+            return FeatureIdentifier(read<int64_t>());
+        case IdentifierType::Double:
+            return FeatureIdentifier(read<double>());
+        case IdentifierType::String:
+            return FeatureIdentifier(readString());
+        }
+
+        throw std::runtime_error("invalid tile data feature identifier type");
+    }
+
+    void readBytes(void* out, std::size_t size) {
+        if (static_cast<std::size_t>(end - pos) < size) {
+            throw std::runtime_error("truncated tile data");
+        }
+        if (size > 0) {
+            std::memcpy(out, pos, size);
+            pos += size;
+        }
+    }
+
+private:
+    const char* pos;
+    const char* const end;
+};
+
+} // namespace
+
+class FlatTileFeature : public GeometryTileFeature {
+public:
+    using Layer = FlatTileData::Layer;
+
+    FlatTileFeature(const Layer& layer_, const Layer::Feature& feature_)
+        : layer(layer_), feature(feature_) {}
+
+    FeatureType getType() const override {
+        return feature.type;
+    }
+
+    optional<Value> getValue(const std::string& key) const override {
+        auto it = layer.keyIndices.find(key);
+        if (it == layer.keyIndices.end()) {
+            return {};
+        }
+        return getValueByKeyIndex(it->second);
+    }
+
+    optional<Value> getValueByKeyIndex(std::size_t key) const override {
+        const auto begin = layer.properties.begin() + feature.firstProperty;
+        for (auto it = begin; it != begin + feature.propertyCount; ++it) {
+            if (it->key == key) {
+                return layer.values[it->value];
+            }
+        }
+        return {};
+    }
+
+    PropertyMap getProperties() const override {
+        PropertyMap result;
+        const auto begin = layer.properties.begin() + feature.firstProperty;
+        for (auto it = begin; it != begin + feature.propertyCount; ++it) {
+            result.emplace(layer.keys[it->key], layer.values[it->value]);
+        }
+        return result;
+    }
+
+    optional<FeatureIdentifier> getID() const override {
+        return feature.id;
+    }
+
+    GeometryCollection getGeometries() const override {
+        GeometryCollection result;
+        result.reserve(feature.ringCount);
+        eachRing([&] (auto begin, auto end) {
+            result.emplace_back(begin, end);
+        });
+        return result;
+    }
+
+    optional<GeometryBox> getBoundingBox() const override {
+        optional<GeometryBox> result;
+        eachRing([&] (auto begin, auto end) {
+            for (auto it = begin; it != end; ++it) {
+                if (!result) {
+                    result = GeometryBox(*it, *it);
+                } else {
+                    result->min.x = std::min(result->min.x, it->x);
+                    result->min.y = std::min(result->min.y, it->y);
+                    result->max.x = std::max(result->max.x, it->x);
+                    result->max.y = std::max(result->max.y, it->y);
+                }
+            }
+        });
+        return result;
+    }
+
+    void eachGeometry(const std::function<void (const GeometryCoordinates&)>& fn) const override {
+        GeometryCoordinates ring;
+        eachRing([&] (auto begin, auto end) {
+            ring.assign(begin, end);
+            fn(ring);
+        });
+    }
+
+private:
+    template <class Fn>
+    void eachRing(Fn&& fn) const {
+        uint32_t start = feature.firstRing == 0 ? 0 : layer.ringEnds[feature.firstRing - 1];
+        for (uint32_t i = feature.firstRing; i < feature.firstRing + feature.ringCount; ++i) {
+            const uint32_t ringEnd = layer.ringEnds[i];
+            fn(layer.vertices.begin() + start, layer.vertices.begin() + ringEnd);
+            start = ringEnd;
+        }
+    }
+
+    const Layer& layer;
+    const Layer::Feature& feature;
+};
+
+std::unique_ptr<GeometryTileFeature> FlatTileData::Layer::getFeature(std::size_t i) const {
+    return std::make_unique<FlatTileFeature>(*this, features.at(i));
+}
+
+optional<std::size_t> FlatTileData::Layer::getKeyIndex(const std::string& key) const {
+    auto it = keyIndices.find(key);
+    if (it == keyIndices.end()) {
+        return {};
+    }
+    return { it->second };
+}
+
+void FlatTileData::Layer::addFeature(const GeometryTileFeature& source,
+                                     std::unordered_map<std::string, uint32_t>& valueIndices) {
+    Feature feature;
+    feature.type = source.getType();
+    feature.id = source.getID();
+    feature.firstRing = static_cast<uint32_t>(ringEnds.size());
+    feature.firstProperty = static_cast<uint32_t>(properties.size());
+
+    source.eachGeometry([&] (const GeometryCoordinates& ring) {
+        vertices.insert(vertices.end(), ring.begin(), ring.end());
+        ringEnds.push_back(static_cast<uint32_t>(vertices.size()));
+    });
+
+    // Values are stored once per layer. They're told apart by their serialization, since Value
+    // doesn't have an ordering or a hash.
+    std::string encoded;
+    for (const auto& property : source.getProperties()) {
+        const auto key = keyIndices.emplace(property.first, static_cast<uint32_t>(keys.size()));
+        if (key.second) {
+            keys.push_back(property.first);
+        }
+
+        encoded.clear();
+        Writer(encoded).write(property.second);
+        const auto value = valueIndices.emplace(encoded, static_cast<uint32_t>(values.size()));
+        if (value.second) {
+            values.push_back(property.second);
+        }
+
+        properties.push_back({ key.first->second, value.first->second });
+    }
+
+    feature.ringCount = static_cast<uint32_t>(ringEnds.size()) - feature.firstRing;
+    feature.propertyCount = static_cast<uint32_t>(properties.size()) - feature.firstProperty;
+    features.push_back(std::move(feature));
+}
+
+FlatTileData::FlatTileData(const GeometryTileData& data, const std::vector<std::string>& layerNames) {
+    auto result = std::make_shared<Layers>();
+
+    for (const auto& layerName : layerNames) {
+        const GeometryTileLayer* source = data.getLayer(layerName);
+        if (!source || result->count(layerName)) {
+            continue;
+        }
+
+        Layer& layer = (*result)[layerName];
+        layer.name = layerName;
+
+        std::unordered_map<std::string, uint32_t> valueIndices;
+        const std::size_t count = source->featureCount();
+        layer.features.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            layer.addFeature(*source->getFeature(i), valueIndices);
+        }
+    }
+
+    layers = std::move(result);
+}
+
+FlatTileData::FlatTileData(std::shared_ptr<const Layers> layers_)
+    : layers(std::move(layers_)) {
+}
+
+std::unique_ptr<GeometryTileData> FlatTileData::clone() const {
+    return std::unique_ptr<GeometryTileData>(new FlatTileData(layers));
+}
+
+const GeometryTileLayer* FlatTileData::getLayer(const std::string& name) const {
+    auto it = layers->find(name);
+    if (it == layers->end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+std::size_t FlatTileData::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    for (const auto& pair : *layers) {
+        const Layer& layer = pair.second;
+        bytes += layer.name.capacity() + util::memoryUsage(layer.keys) +
+                 util::memoryUsage(layer.values) + util::memoryUsage(layer.features) +
+                 util::memoryUsage(layer.properties) + util::memoryUsage(layer.ringEnds) +
+                 util::memoryUsage(layer.vertices) +
+                 layer.keyIndices.size() * sizeof(std::pair<const std::string, uint32_t>);
+        for (const auto& key : layer.keys) {
+            bytes += key.capacity();
+        }
+    }
+    return bytes;
+}
+
+std::string FlatTileData::serialize() const {
+    static_assert(sizeof(GeometryCoordinate) == 2 * sizeof(int16_t), "vertices must be packed");
+
+    std::string out;
+    Writer writer(out);
+    writer.write(magic);
+    writer.write(version);
+    writer.writeSize(layers->size());
+
+    for (const auto& entry : *layers) {
+        const Layer& layer = entry.second;
+        writer.write(layer.name);
+
+        writer.writeSize(layer.keys.size());
+        for (const auto& key : layer.keys) {
+            writer.write(key);
+        }
+
+        writer.writeSize(layer.values.size());
+        for (const auto& value : layer.values) {
+            writer.write(value);
+        }
+
+        writer.writeSize(layer.features.size());
+        for (const auto& feature : layer.features) {
+            writer.write(static_cast<uint8_t>(feature.type));
+            writer.write(feature.id);
+            writer.write(feature.ringCount);
+            writer.write(feature.propertyCount);
+        }
+
+        for (const auto& property : layer.properties) {
+            writer.write(property.key);
+            writer.write(property.value);
+        }
+
+        for (const auto& ringEnd : layer.ringEnds) {
+            writer.write(ringEnd);
+        }
+
+        writer.writeSize(layer.vertices.size());
+        out.append(reinterpret_cast<const char*>(layer.vertices.data()),
+                   layer.vertices.size() * sizeof(GeometryCoordinate));
+    }
+
+    return out;
+}
+
+std::unique_ptr<FlatTileData> FlatTileData::parse(const std::string& data) {
+    Reader reader(data);
+    if (reader.read<uint32_t>() != magic || reader.read<uint32_t>() != version) {
+        throw std::runtime_error("unknown tile data format");
+    }
+
+    auto result = std::make_shared<Layers>();
+
+    for (std::size_t layerCount = reader.readSize(1); layerCount > 0; --layerCount) {
+        std::string name = reader.readString();
+        if (result->count(name)) {
+            throw std::runtime_error("duplicate tile data layer");
+        }
+
+        Layer& layer = (*result)[name];
+        layer.name = std::move(name);
+
+        layer.keys.resize(reader.readSize(4));
+        for (auto& key : layer.keys) {
+            key = reader.readString();
+        }
+        layer.indexKeys();
+
+        layer.values.resize(reader.readSize(1));
+        for (auto& value : layer.values) {
+            value = reader.readValue();
+        }
+
+        uint32_t ringCount = 0;
+        uint32_t propertyCount = 0;
+        layer.features.resize(reader.readSize(10));
+        for (auto& feature : layer.features) {
+            const auto type = reader.read<uint8_t>();
+            if (type > static_cast<uint8_t>(FeatureType::Polygon)) {
+                throw std::runtime_error("invalid tile data feature type");
+            }
+            feature.type = static_cast<FeatureType>(type);
+            feature.id = reader.readIdentifier();
+            feature.firstRing = ringCount;
+            feature.ringCount = reader.read<uint32_t>();
+            feature.firstProperty = propertyCount;
+            feature.propertyCount = reader.read<uint32_t>();
+            if (feature.ringCount > UINT32_MAX - ringCount ||
+                feature.propertyCount > UINT32_MAX - propertyCount) {
+                throw std::runtime_error("invalid tile data feature");
+            }
+            ringCount += feature.ringCount;
+            propertyCount += feature.propertyCount;
+        }
+
+        reader.expect(propertyCount, 8);
+        layer.properties.resize(propertyCount);
+        for (auto& property : layer.properties) {
+            property.key = reader.read<uint32_t>();
+            property.value = reader.read<uint32_t>();
+            if (property.key >= layer.keys.size() || property.value >= layer.values.size()) {
+                throw std::runtime_error("invalid tile data property");
+            }
+        }
+
+        reader.expect(ringCount, 4);
+        layer.ringEnds.resize(ringCount);
+        for (auto& ringEnd : layer.ringEnds) {
+            ringEnd = reader.read<uint32_t>();
+        }
+
+        layer.vertices.resize(reader.readSize(sizeof(GeometryCoordinate)));
+        reader.readBytes(layer.vertices.data(), layer.vertices.size() * sizeof(GeometryCoordinate));
+
+        // Rings must follow each other, and stay within the vertex array.
+        uint32_t previous = 0;
+        for (const auto ringEnd : layer.ringEnds) {
+            if (ringEnd < previous || ringEnd > layer.vertices.size()) {
+                throw std::runtime_error("invalid tile data ring");
+            }
+            previous = ringEnd;
+        }
+    }
+
+    if (!reader.done()) {
+        throw std::runtime_error("trailing bytes after tile data");
+    }
+
+    return std::unique_ptr<FlatTileData>(new FlatTileData(std::move(result)));
+}
+
+void FlatTileData::Layer::indexKeys() {
+    keyIndices.clear();
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keyIndices.emplace(keys[i], static_cast<uint32_t>(i));
+    }
+}
+
+} // namespace mbgl
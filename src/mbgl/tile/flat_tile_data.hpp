@@ -0,0 +1,97 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    `FlatTileData` holds the layers of a tile in a pre-decoded, columnar form: the vertices of all
+    features of a layer in a single array, the ring and property ranges of each feature as
+    offsets into flat arrays, and each layer's keys and values once. It's built from any other
+    `GeometryTileData`, e.g. a parsed vector tile, and can be handed to the bucket builders in its
+    place.
+
+    Reading a feature out of it doesn't involve any decoding, so a tile that's laid out again and
+    again can be converted once and reused. The contents are immutable; `clone()` shares them.
+
+    `serialize()` writes the contents to a compact binary string that `FlatTileData::parse()`
+    reads back, so that converted tiles can also be kept on disk. The format uses the native byte
+    order and is meant as a local cache, not as an interchange format.
+*/
+
+class FlatTileData : public GeometryTileData {
+public:
+    // Converts the named layers of `data`. Layers that `data` doesn't have are skipped.
+    FlatTileData(const GeometryTileData& data, const std::vector<std::string>& layerNames);
+
+    std::unique_ptr<GeometryTileData> clone() const override;
+    const GeometryTileLayer* getLayer(const std::string&) const override;
+
+    std::size_t getMemoryUsage() const override;
+
+    std::string serialize() const;
+
+    // Throws std::runtime_error if `data` isn't a valid serialization.
+    static std::unique_ptr<FlatTileData> parse(const std::string& data);
+
+    class Layer;
+
+private:
+    using Layers = std::unordered_map<std::string, Layer>;
+
+    FlatTileData(std::shared_ptr<const Layers>);
+
+    std::shared_ptr<const Layers> layers;
+};
+
+class FlatTileData::Layer : public GeometryTileLayer {
+public:
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
+    std::string getName() const override { return name; }
+
+    bool hasKeyIndices() const override { return true; }
+    optional<std::size_t> getKeyIndex(const std::string&) const override;
+
+private:
+    friend class FlatTileData;
+    friend class FlatTileFeature;
+
+    struct Feature {
+        FeatureType type;
+        optional<FeatureIdentifier> id;
+
+        // Ranges in `ringEnds` and `properties`.
+        uint32_t firstRing;
+        uint32_t ringCount;
+        uint32_t firstProperty;
+        uint32_t propertyCount;
+    };
+
+    // A key index and an index into `values`.
+    struct Property {
+        uint32_t key;
+        uint32_t value;
+    };
+
+    void addFeature(const GeometryTileFeature&, std::unordered_map<std::string, uint32_t>& valueIndices);
+    void indexKeys();
+
+    std::string name;
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> keyIndices;
+    std::vector<Value> values;
+    std::vector<Feature> features;
+    std::vector<Property> properties;
+
+    // One past the last vertex of each ring; the ring starts where the previous one ended.
+    std::vector<uint32_t> ringEnds;
+    std::vector<GeometryCoordinate> vertices;
+};
+
+} // namespace mbgl
@@ -1,9 +1,13 @@
 #include <mbgl/tile/geojson_tile.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/memory_usage.hpp>
 
 #include <mapbox/geojsonvt.hpp>
+#include <mapbox/geometry/for_each_point.hpp>
 #include <supercluster.hpp>
 
+#include <cassert>
+
 namespace mbgl {
 
 // Implements a simple in-memory Tile type that holds GeoJSON values. A GeoJSON tile can only have
@@ -45,13 +49,15 @@ public:
     }
 };
 
+// The features are those that geojson-vt or supercluster put out, which the tile shares with the
+// index rather than copying; features from several partitions of the index are kept as parts.
 class GeoJSONTileData : public GeometryTileData,
                         public GeometryTileLayer {
 public:
-    mapbox::geometry::feature_collection<int16_t> features;
+    GeoJSONTileFeatures parts;
 
-    GeoJSONTileData(mapbox::geometry::feature_collection<int16_t> features_)
-        : features(std::move(features_)) {
+    GeoJSONTileData(GeoJSONTileFeatures parts_)
+        : parts(std::move(parts_)) {
     }
 
     std::unique_ptr<GeometryTileData> clone() const override {
@@ -67,11 +73,37 @@ public:
     }
 
     std::size_t featureCount() const override {
-        return features.size();
+        std::size_t count = 0;
+        for (const auto& part : parts) {
+            count += part->size();
+        }
+        return count;
     }
 
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
-        return std::make_unique<GeoJSONTileFeature>(features[i]);
+        for (const auto& part : parts) {
+            if (i < part->size()) {
+                return std::make_unique<GeoJSONTileFeature>((*part)[i]);
+            }
+            i -= part->size();
+        }
+        assert(false);
+        return nullptr;
+    }
+
+    // Includes the features shared with the index.
+    std::size_t getMemoryUsage() const override {
+        std::size_t bytes = util::memoryUsage(parts);
+        for (const auto& part : parts) {
+            bytes += util::memoryUsage(*part);
+            for (const auto& feature : *part) {
+                mapbox::geometry::for_each_point(feature.geometry, [&] (const auto& point) {
+                    bytes += sizeof(point);
+                });
+                bytes += feature.properties.size() * sizeof(PropertyMap::value_type);
+            }
+        }
+        return bytes;
     }
 };
 
@@ -81,8 +113,8 @@ GeoJSONTile::GeoJSONTile(const OverscaledTileID& overscaledTileID,
     : GeometryTile(overscaledTileID, sourceID_, parameters) {
 }
     
-void GeoJSONTile::updateData(const mapbox::geometry::feature_collection<int16_t>& features) {
-    setData(std::make_unique<GeoJSONTileData>(features));
+void GeoJSONTile::updateData(GeoJSONTileFeatures parts) {
+    setData(std::make_unique<GeoJSONTileData>(std::move(parts)));
 }
 
 void GeoJSONTile::setNecessity(Necessity) {}
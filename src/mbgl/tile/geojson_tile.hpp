@@ -3,19 +3,25 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/util/feature.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace mbgl {
 
 namespace style {
 class UpdateParameters;
 } // namespace style
 
+// The features of a tile, in parts that are shared with the index they were sliced by.
+using GeoJSONTileFeatures = std::vector<std::shared_ptr<const mapbox::geometry::feature_collection<int16_t>>>;
+
 class GeoJSONTile : public GeometryTile {
 public:
     GeoJSONTile(const OverscaledTileID&,
                 std::string sourceID,
                 const style::UpdateParameters&);
 
-    void updateData(const mapbox::geometry::feature_collection<int16_t>&);
+    void updateData(GeoJSONTileFeatures);
     
     void setNecessity(Necessity) final;
 };
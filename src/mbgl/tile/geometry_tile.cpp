@@ -1,17 +1,26 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/cross_tile_placement_worker.hpp>
 #include <mbgl/tile/tile_observer.hpp>
+#include <mbgl/tile/tile_trace.hpp>
 #include <mbgl/style/update_parameters.hpp>
+#include <mbgl/style/bucket_parameters.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/layers/background_layer.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/map/transform_state.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/platform/log.hpp>
+
+#include <algorithm>
 
 namespace mbgl {
 
@@ -23,13 +32,29 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
     : Tile(id_),
       sourceID(std::move(sourceID_)),
       style(parameters.style),
+      mode(parameters.mode),
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
+      placementWorker(parameters.workerScheduler,
+                      ActorRef<GeometryTile>(*this, mailbox),
+                      sourceID,
+                      id_,
+                      obsolete),
       worker(parameters.workerScheduler,
              ActorRef<GeometryTile>(*this, mailbox),
+             placementWorker.self(),
+             parameters.workerScheduler,
+             sourceID,
              id_,
              *parameters.style.glyphAtlas,
              obsolete,
              parameters.mode) {
+    mailbox->setTag("GeometryTile");
+    worker.setTag("GeometryTileWorker");
+    placementWorker.setTag("SymbolPlacementWorker");
+
+    // set{Data,Layers,PlacementConfig} tend to arrive in bursts, followed by the worker's own
+    // "coalesced" message. Handle such a burst within one scheduling quantum.
+    worker.setBatchSize(4);
 }
 
 GeometryTile::~GeometryTile() {
@@ -37,6 +62,7 @@ GeometryTile::~GeometryTile() {
 }
 
 void GeometryTile::cancel() {
+    cancelled = true;
     obsolete = true;
 }
 
@@ -52,27 +78,62 @@ void GeometryTile::setData(std::unique_ptr<const GeometryTileData> data_) {
     }
 
     ++correlationID;
-    worker.invoke(&GeometryTileWorker::setData, std::move(data_), correlationID);
-    redoLayout();
+    worker.invokeCoalesced(&GeometryTileWorker::setData, std::move(data_), correlationID);
+    setLayers(getLayoutLayers());
+}
+
+void GeometryTile::setPriority(Priority priority) {
+    worker.setPriority(priority);
+    placementWorker.setPriority(priority);
+
+    // A tile that's only cached stops laying out right away, rather than at the end of the layer
+    // or tile it's working on, and picks up again once it's used again.
+    const bool pause = priority == Priority::Cached;
+    if (pause == paused || cancelled) {
+        return;
+    }
+
+    paused = pause;
+    obsolete = pause;
+
+    if (!pause) {
+        worker.invoke(&GeometryTileWorker::resume);
+        if (requestedConfig) {
+            placementWorker.invokeCoalesced(&SymbolPlacementWorker::setPlacementConfig, *requestedConfig);
+        }
+    }
 }
 
 void GeometryTile::setPlacementConfig(const PlacementConfig& desiredConfig) {
+    requestedConfig = desiredConfig;
+
     if (placedConfig == desiredConfig) {
         return;
     }
 
-    ++correlationID;
-    worker.invoke(&GeometryTileWorker::setPlacementConfig, desiredConfig, correlationID);
+    // Placement config changes on every frame of a rotate or pitch gesture; the placement worker
+    // only needs to see the most recent one, and doesn't wait for layout to finish.
+    placementWorker.invokeCoalesced(&SymbolPlacementWorker::setPlacementConfig, desiredConfig);
+
+    // Symbol layouts of the most recent layout may still be waiting for glyphs or icons.
+    if (availableData != DataAvailability::All) {
+        worker.invokeCoalesced(&GeometryTileWorker::retryPreparation);
+    }
 }
 
-void GeometryTile::redoLayout() {
-    // Mark the tile as pending again if it was complete before to prevent signaling a complete
-    // state despite pending parse operations.
-    if (availableData == DataAvailability::All) {
-        availableData = DataAvailability::Some;
+void GeometryTile::setPlacementGroup(Actor<CrossTilePlacementWorker>* group) {
+    if (group == placementGroup) {
+        return;
     }
 
-    std::vector<std::unique_ptr<Layer>> copy;
+    placementGroup = group;
+    placementWorker.invoke(&SymbolPlacementWorker::setPlacementGroup,
+                           group ? optional<ActorRef<CrossTilePlacementWorker>>(group->self())
+                                 : optional<ActorRef<CrossTilePlacementWorker>>());
+}
+
+std::vector<const Layer*> GeometryTile::getLayoutLayers() const {
+    std::vector<const Layer*> result;
 
     for (const Layer* layer : style.getLayers()) {
         // Avoid cloning and including irrelevant layers.
@@ -85,38 +146,208 @@ void GeometryTile::redoLayout() {
             continue;
         }
 
+        result.push_back(layer);
+    }
+
+    return result;
+}
+
+void GeometryTile::setLayers(const std::vector<const Layer*>& layers) {
+    std::vector<std::unique_ptr<Layer>> copy;
+    layoutLayerIDs.clear();
+
+    for (const Layer* layer : layers) {
         copy.push_back(layer->baseImpl->clone());
+        layoutLayerIDs.insert(layer->getID());
     }
 
     ++correlationID;
-    worker.invoke(&GeometryTileWorker::setLayers, std::move(copy), correlationID);
+    worker.invokeCoalesced(&GeometryTileWorker::setLayers, std::move(copy), correlationID);
+}
+
+void GeometryTile::redoLayout(const std::unordered_set<std::string>& layerIDs) {
+    const std::vector<const Layer*> layers = getLayoutLayers();
+
+    // The worker would keep all buckets of a tile that none of the layers apply to, before or
+    // after their change, so there's no need to send it the layers.
+    const bool affected = std::any_of(layerIDs.begin(), layerIDs.end(), [&] (const std::string& layerID) {
+        return layoutLayerIDs.count(layerID) ||
+               std::any_of(layers.begin(), layers.end(), [&] (const Layer* layer) {
+                   return layer->getID() == layerID;
+               });
+    });
+    if (!affected) {
+        return;
+    }
+
+    // Mark the tile as pending again if it was complete before to prevent signaling a complete
+    // state despite pending parse operations.
+    if (availableData == DataAvailability::All) {
+        availableData = DataAvailability::Some;
+    }
+
+    setLayers(layers);
+}
+
+void GeometryTile::dumpDebugLogs() const {
+    Tile::dumpDebugLogs();
+    Log::Info(Event::General, "GeometryTile::polygonFixup: %s of %s checked polygons",
+              util::toString(polygonFixupStats.fixedUp).c_str(),
+              util::toString(polygonFixupStats.checked).c_str());
 }
 
 void GeometryTile::onLayout(LayoutResult result) {
+    TileTrace::instant(TileTrace::Event::LayoutResult, sourceID, id);
+
+    // Still images are rendered in one go, once all tiles are complete.
+    if (availableData == DataAvailability::None && mode == MapMode::Continuous) {
+        awaitingUpload = true;
+    }
     availableData = DataAvailability::Some;
+    layoutCorrelationID = result.correlationID;
+    for (const auto& name : result.keptBuckets) {
+        auto it = buckets.find(name);
+        if (it != buckets.end()) {
+            result.buckets.emplace(name, std::move(it->second));
+        }
+    }
     buckets = std::move(result.buckets);
+    if (result.symbolLayoutsKept) {
+        // The placed symbols stay as they are, and so does the index of their collision boxes.
+        if (featureIndex) {
+            result.featureIndex->setCollisionTile(featureIndex->releaseCollisionTile());
+        }
+    } else {
+        symbolsCorrelationID = result.correlationID;
+    }
     featureIndex = std::move(result.featureIndex);
     data = std::move(result.tileData);
+    polygonFixupStats = result.polygonFixupStats;
+    updateAvailability();
     observer->onTileChanged(*this);
 }
 
 void GeometryTile::onPlacement(PlacementResult result) {
-    if (result.correlationID == correlationID) {
-        availableData = DataAvailability::All;
+    TileTrace::instant(TileTrace::Event::PlacementResult, sourceID, id,
+                       result.correlationID != symbolsCorrelationID ? "superseded" : nullptr);
+
+    if (result.correlationID != symbolsCorrelationID) {
+        return; // These symbols were laid out for buckets that have since been replaced.
     }
     for (auto& bucket : result.buckets) {
-        buckets[bucket.first] = std::move(bucket.second);
+        if (!releasedBuckets.count(bucket.first)) {
+            auto& current = buckets[bucket.first];
+            if (current && bucket.second) {
+                bucket.second->adoptBuffers(*current);
+            }
+            current = std::move(bucket.second);
+        }
     }
     featureIndex->setCollisionTile(std::move(result.collisionTile));
     placedConfig = result.placedConfig;
+    placedCorrelationID = result.correlationID;
+    updateAvailability();
     observer->onTileChanged(*this);
 }
 
+void GeometryTile::updateAvailability() {
+    // Complete once the most recent layout is done and its symbols are placed as requested.
+    if (layoutCorrelationID == correlationID && placedCorrelationID == symbolsCorrelationID &&
+        placedConfig && placedConfig == requestedConfig) {
+        availableData = DataAvailability::All;
+    }
+}
+
 void GeometryTile::onError(std::exception_ptr err) {
     availableData = DataAvailability::All;
     observer->onTileError(*this, err);
 }
 
+bool GeometryTile::needsUpload() const {
+    if (awaitingUpload) {
+        return true;
+    }
+    for (const auto& bucket : buckets) {
+        if (bucket.second->needsUpload()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GeometryTile::upload(gl::Context& context) {
+    TileTrace::Scope trace(TileTrace::Event::Upload, sourceID, id);
+
+    for (auto& bucket : buckets) {
+        if (bucket.second->needsUpload()) {
+            bucket.second->upload(context);
+        }
+    }
+    awaitingUpload = false;
+}
+
+MemoryUsage GeometryTile::getMemoryUsage() const {
+    MemoryUsage usage;
+    for (const auto& bucket : buckets) {
+        usage += bucket.second->getMemoryUsage();
+    }
+    if (featureIndex) {
+        usage.cpu += featureIndex->getMemoryUsage();
+    }
+    if (data) {
+        usage.cpu += data->getMemoryUsage();
+    }
+    return usage;
+}
+
+void GeometryTile::reportMemoryUsage(MemoryReport::Tiles& report) const {
+    report.count++;
+    for (const auto& bucket : buckets) {
+        report.buckets += bucket.second->getMemoryUsage();
+    }
+    if (featureIndex) {
+        const std::size_t collisionTile = featureIndex->getCollisionTileMemoryUsage();
+        report.featureIndex.cpu += featureIndex->getMemoryUsage() - collisionTile;
+        report.collisionTiles.cpu += collisionTile;
+    }
+    if (data) {
+        report.data.cpu += data->getMemoryUsage();
+    }
+}
+
+MemoryUsage GeometryTile::releaseBuckets(const std::set<std::string>& names) {
+    MemoryUsage usage;
+    for (const auto& name : names) {
+        auto it = buckets.find(name);
+        if (it != buckets.end()) {
+            usage += it->second->getMemoryUsage();
+            buckets.erase(it);
+            releasedBuckets.insert(name);
+        }
+    }
+    if (usage.total()) {
+        observer->onTileChanged(*this);
+    }
+    return usage;
+}
+
+bool GeometryTile::restoreBuckets(const std::set<std::string>& names) {
+    if (releasedBuckets.empty()) {
+        return false;
+    }
+    const bool needed = std::any_of(names.begin(), names.end(), [&] (const std::string& name) {
+        return releasedBuckets.count(name);
+    });
+    if (!needed || !data) {
+        return true;
+    }
+
+    // The worker only lays out buckets anew for new data; all others are kept from before.
+    releasedBuckets.clear();
+    setData(data->clone());
+    return false;
+}
+
 Bucket* GeometryTile::getBucket(const Layer& layer) {
     const auto it = buckets.find(layer.baseImpl->bucketName());
     if (it == buckets.end()) {
@@ -128,7 +359,7 @@ Bucket* GeometryTile::getBucket(const Layer& layer) {
 }
 
 void GeometryTile::queryRenderedFeatures(
-    std::unordered_map<std::string, std::vector<Feature>>& result,
+    IndexedRenderedFeatures& result,
     const GeometryCoordinates& queryGeometry,
     const TransformState& transformState,
     const optional<std::vector<std::string>>& layerIDs) {
@@ -146,4 +377,44 @@ void GeometryTile::queryRenderedFeatures(
                         style);
 }
 
+void GeometryTile::querySourceFeatures(std::vector<Feature>& result,
+                                       const std::string& sourceLayer,
+                                       const CompiledFilter& filter) {
+    if (!data) return;
+
+    const GeometryTileLayer* layer = data->getLayer(sourceLayer);
+    if (!layer) return;
+
+    const FilterKeys keys(*layer, filter);
+    for (std::size_t i = 0; i < layer->featureCount(); i++) {
+        auto feature = layer->getFeature(i);
+        if (filter(feature->getType(), feature->getID(), [&] (std::size_t key) { return keys.getValue(*feature, key); })) {
+            result.push_back(convertFeature(*feature, id.canonical));
+        }
+    }
+}
+
+optional<Feature> GeometryTile::queryPickedFeature(const Layer& layer, uint16_t pickingID) {
+    if (!featureIndex || !data || !layer.is<FillLayer>()) {
+        return {};
+    }
+
+    auto bucket = static_cast<FillBucket*>(getBucket(layer));
+    if (!bucket) {
+        return {};
+    }
+
+    const auto picked = bucket->getPickedFeature(pickingID);
+    if (!picked) {
+        return {};
+    }
+
+    auto feature = featureIndex->getFeature(picked->first, picked->second, *data);
+    if (!feature) {
+        return {};
+    }
+
+    return convertFeature(*feature, id.canonical);
+}
+
 } // namespace mbgl
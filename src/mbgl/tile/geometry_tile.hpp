@@ -2,6 +2,8 @@
 
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/tile/geometry_tile_worker.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/symbol_placement_worker.hpp>
 #include <mbgl/text/placement_config.hpp>
 #include <mbgl/util/feature.hpp>
 #include <mbgl/actor/actor.hpp>
@@ -9,11 +11,11 @@
 #include <atomic>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace mbgl {
 
-class GeometryTileData;
 class FeatureIndex;
 class CollisionTile;
 
@@ -34,25 +36,46 @@ public:
     void setError(std::exception_ptr);
     void setData(std::unique_ptr<const GeometryTileData>);
 
+    void setPriority(Priority) override;
     void setPlacementConfig(const PlacementConfig&) override;
-    void redoLayout() override;
+    void setPlacementGroup(Actor<CrossTilePlacementWorker>*) override;
+    void redoLayout(const std::unordered_set<std::string>& layerIDs) override;
 
     Bucket* getBucket(const style::Layer&) override;
+    bool needsUpload() const override;
+    void upload(gl::Context&) override;
+    MemoryUsage getMemoryUsage() const override;
+    void reportMemoryUsage(MemoryReport::Tiles&) const override;
+    MemoryUsage releaseBuckets(const std::set<std::string>&) override;
+    bool restoreBuckets(const std::set<std::string>&) override;
 
     void queryRenderedFeatures(
-            std::unordered_map<std::string, std::vector<Feature>>& result,
+            std::unordered_map<std::string, std::vector<IndexedRenderedFeature>>& result,
             const GeometryCoordinates& queryGeometry,
             const TransformState&,
             const optional<std::vector<std::string>>& layerIDs) override;
 
+    void querySourceFeatures(std::vector<Feature>& result,
+                             const std::string& sourceLayer,
+                             const style::CompiledFilter&) override;
+
+    optional<Feature> queryPickedFeature(const style::Layer&, uint16_t id) override;
+
     void cancel() override;
+    void dumpDebugLogs() const override;
 
     class LayoutResult {
     public:
         std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+        // Buckets of the previous layout that are still current, and aren't in `buckets`.
+        std::vector<std::string> keptBuckets;
         std::unique_ptr<FeatureIndex> featureIndex;
         std::unique_ptr<GeometryTileData> tileData;
+        PolygonFixupStats polygonFixupStats;
         uint64_t correlationID;
+        // Whether the symbol layouts are those of the previous layout, which stay placed as they
+        // are rather than being handed over for placement again.
+        bool symbolLayoutsKept;
     };
     void onLayout(LayoutResult);
 
@@ -67,22 +90,50 @@ public:
 
     void onError(std::exception_ptr);
 
-private:
     const std::string sourceID;
+
+private:
+    // The layers of the style that the tile is laid out with.
+    std::vector<const style::Layer*> getLayoutLayers() const;
+    void setLayers(const std::vector<const style::Layer*>&);
+    void updateAvailability();
+
     style::Style& style;
+    const MapMode mode;
 
-    // Used to signal the worker that it should abandon parsing this tile as soon as possible.
+    // Used to signal the workers that they should abandon their work on this tile as soon as
+    // possible: for good once the tile is cancelled, or until it's used again while it's only
+    // cached. Checked at fine-grained points throughout layout, e.g. between features.
     std::atomic<bool> obsolete { false };
+    bool cancelled = false;
+    bool paused = false;
 
     std::shared_ptr<Mailbox> mailbox;
+    Actor<SymbolPlacementWorker> placementWorker;
     Actor<GeometryTileWorker> worker;
 
+    // Incremented for every change that requires a new layout.
     uint64_t correlationID = 0;
+    // The correlation ID of the most recent layout result.
+    uint64_t layoutCorrelationID = 0;
+    // The correlation IDs of the layout whose symbol layouts are current, and of the layout whose
+    // symbols were placed most recently.
+    uint64_t symbolsCorrelationID = 0;
+    uint64_t placedCorrelationID = 0;
+
+    // The IDs of the layers most recently sent to the worker.
+    std::unordered_set<std::string> layoutLayerIDs;
+
+    optional<PlacementConfig> requestedConfig;
     optional<PlacementConfig> placedConfig;
+    Actor<CrossTilePlacementWorker>* placementGroup = nullptr;
 
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+    // Buckets dropped by releaseBuckets(); later results of the workers may not include them.
+    std::set<std::string> releasedBuckets;
     std::unique_ptr<FeatureIndex> featureIndex;
     std::unique_ptr<const GeometryTileData> data;
+    PolygonFixupStats polygonFixupStats;
 };
 
 } // namespace mbgl
@@ -3,18 +3,25 @@
 
 #include <clipper/clipper.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 static double signedArea(const GeometryCoordinates& ring) {
-    double sum = 0;
+    const std::size_t len = ring.size();
+    if (len == 0) {
+        return 0;
+    }
 
-    for (std::size_t i = 0, len = ring.size(), j = len - 1; i < len; j = i++) {
-        const GeometryCoordinate& p1 = ring[i];
-        const GeometryCoordinate& p2 = ring[j];
-        sum += (p2.x - p1.x) * (p1.y + p2.y);
+    // The closing edge from the last to the first vertex, and then all others in order. Every
+    // term fits into 64-bit integers, and without the wrap-around in the loop, the compiler can
+    // vectorize the accumulation.
+    int64_t sum = int64_t(ring[len - 1].x - ring[0].x) * (ring[0].y + ring[len - 1].y);
+    for (std::size_t i = 1; i < len; ++i) {
+        sum += int64_t(ring[i - 1].x - ring[i].x) * (ring[i].y + ring[i - 1].y);
     }
 
-    return sum;
+    return double(sum);
 }
 
 static ClipperLib::Path toClipperPath(const GeometryCoordinates& ring) {
@@ -85,6 +92,28 @@ GeometryCollection fixupPolygons(const GeometryCollection& rings) {
     return result;
 }
 
+bool isValidPolygonGeometry(const GeometryCollection& rings) {
+    if (rings.empty()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < rings.size(); ++i) {
+        const GeometryCoordinates& ring = rings[i];
+        if (ring.size() < 4 || !(ring.front() == ring.back())) {
+            return false;
+        }
+
+        // The first ring is an exterior ring, which fixupPolygons() winds to a positive area. Any
+        // other ring is either a hole, wound the other way, or the exterior of the next polygon.
+        const double area = signedArea(ring);
+        if (area == 0 || (i == 0 && area < 0)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
     std::vector<GeometryCollection> polygons;
 
@@ -121,6 +150,29 @@ std::vector<GeometryCollection> classifyRings(const GeometryCollection& rings) {
     return polygons;
 }
 
+void GeometryTileFeature::eachGeometry(const std::function<void (const GeometryCoordinates&)>& function) const {
+    for (const auto& line : getGeometries()) {
+        function(line);
+    }
+}
+
+optional<GeometryBox> GeometryTileFeature::getBoundingBox() const {
+    optional<GeometryBox> result;
+    for (const auto& line : getGeometries()) {
+        for (const auto& point : line) {
+            if (!result) {
+                result = GeometryBox(point, point);
+            } else {
+                result->min.x = std::min(result->min.x, point.x);
+                result->min.y = std::min(result->min.y, point.y);
+                result->max.x = std::max(result->max.x, point.x);
+                result->max.y = std::max(result->max.y, point.y);
+            }
+        }
+    }
+    return result;
+}
+
 void limitHoles(GeometryCollection& polygon, uint32_t maxHoles) {
     if (polygon.size() > 1 + maxHoles) {
         std::nth_element(polygon.begin() + 1,
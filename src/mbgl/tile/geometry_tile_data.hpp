@@ -4,7 +4,10 @@
 #include <mbgl/util/feature.hpp>
 #include <mbgl/util/optional.hpp>
 
+#include <mapbox/geometry/box.hpp>
+
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -18,6 +21,8 @@ class CanonicalTileID;
 // varying from -V...0...+V, where V is the maximum extent applicable.
 using GeometryCoordinate = Point<int16_t>;
 
+using GeometryBox = mapbox::geometry::box<int16_t>;
+
 class GeometryCoordinates : public std::vector<GeometryCoordinate> {
 public:
     using coordinate_type = int16_t;
@@ -35,9 +40,23 @@ public:
     virtual ~GeometryTileFeature() = default;
     virtual FeatureType getType() const = 0;
     virtual optional<Value> getValue(const std::string& key) const = 0;
+
+    // Looks up a value by a key index from GeometryTileLayer::getKeyIndex().
+    virtual optional<Value> getValueByKeyIndex(std::size_t) const { return {}; }
     virtual PropertyMap getProperties() const { return PropertyMap(); }
     virtual optional<FeatureIdentifier> getID() const { return {}; }
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Calls the function with each line or ring of getGeometries() in turn, for code that only
+    // iterates over them once. Features that can decode their geometry incrementally do so into
+    // a single reused buffer instead of materializing a GeometryCollection, so the coordinates
+    // are only valid until the function returns.
+    virtual void eachGeometry(const std::function<void (const GeometryCoordinates&)>&) const;
+
+    // A box that contains all of getGeometries(), or nothing if there are none. Features that can
+    // compute it more cheaply than by decoding their geometries do so, and the box may then be
+    // larger than necessary, e.g. when polygons are fixed up.
+    virtual optional<GeometryBox> getBoundingBox() const;
 };
 
 class GeometryTileLayer {
@@ -46,6 +65,20 @@ public:
     virtual std::size_t featureCount() const = 0;
     virtual std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const = 0;
     virtual std::string getName() const = 0;
+
+    // Layers that support it resolve property keys to indices once, so that the values of many
+    // features can be looked up by index rather than by hashing the key each time.
+    virtual bool hasKeyIndices() const { return false; }
+
+    // The index of `key` for getValueByKeyIndex(), or nothing if no feature of the layer has it.
+    virtual optional<std::size_t> getKeyIndex(const std::string& /* key */) const { return {}; }
+};
+
+// How many polygon features a tile decoded that weren't known to be valid, and how many of them
+// had to be repaired with fixupPolygons().
+struct PolygonFixupStats {
+    std::size_t checked = 0;
+    std::size_t fixedUp = 0;
 };
 
 class GeometryTileData {
@@ -53,6 +86,13 @@ public:
     virtual ~GeometryTileData() = default;
     virtual std::unique_ptr<GeometryTileData> clone() const = 0;
     virtual const GeometryTileLayer* getLayer(const std::string&) const = 0;
+
+    // Counted over all features decoded from this object so far.
+    virtual PolygonFixupStats getPolygonFixupStats() const { return {}; }
+
+    // An estimate of the memory held by this object, in bytes, including data it shares with its
+    // clones.
+    virtual std::size_t getMemoryUsage() const { return 0; }
 };
 
 // classifies an array of rings into polygons with outer rings and holes
@@ -64,6 +104,11 @@ void limitHoles(GeometryCollection&, uint32_t maxHoles);
 // convert from GeometryTileFeature to Feature (eventually we should eliminate GeometryTileFeature)
 Feature convertFeature(const GeometryTileFeature&, const CanonicalTileID&);
 
+// Whether polygon geometry is already wound like v2 tiles require: closed rings of at least four
+// points and non-zero area, starting with a positively wound exterior ring. Self-intersections
+// aren't checked for, like they aren't for v2 tiles.
+bool isValidPolygonGeometry(const GeometryCollection&);
+
 // Fix up possibly-non-V2-compliant polygon geometry using angus clipper.
 // The result is guaranteed to have correctly wound, strictly simple rings.
 GeometryCollection fixupPolygons(const GeometryCollection&);
@@ -1,6 +1,10 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/symbol_placement_worker.hpp>
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/actor/parallel_for.hpp>
+#include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/text/collision_tile.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
@@ -12,7 +16,11 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/exception.hpp>
+#include <mbgl/util/instrumentation.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <typeinfo>
 #include <unordered_set>
 
 namespace mbgl {
@@ -21,12 +29,18 @@ using namespace style;
 
 GeometryTileWorker::GeometryTileWorker(ActorRef<GeometryTileWorker> self_,
                                        ActorRef<GeometryTile> parent_,
+                                       ActorRef<SymbolPlacementWorker> placement_,
+                                       Scheduler& scheduler_,
+                                       std::string sourceID_,
                                        OverscaledTileID id_,
                                        GlyphAtlas& glyphAtlas_,
                                        const std::atomic<bool>& obsolete_,
                                        const MapMode mode_)
     : self(std::move(self_)),
       parent(std::move(parent_)),
+      placement(std::move(placement_)),
+      parallelFor(scheduler_),
+      sourceID(std::move(sourceID_)),
       id(std::move(id_)),
       glyphAtlas(glyphAtlas_),
       obsolete(obsolete_),
@@ -44,37 +58,53 @@ GeometryTileWorker::~GeometryTileWorker() {
 
                               [idle] <------------------.
                                  |                      |
-                      set{Data,Layers,Placement}        |
+       set{Data,Layers}, retryPreparation, resume       |
                                  |                      |
-           (do layout/placement; self-send "coalesced") |
+         (do layout/preparation; self-send "coalesced") |
                                  v                      |
                            [coalescing] --- coalesced --.
                                |   |
              .-----------------.   .---------------.
              |                                     |
-   .--- set{Data,Layers}                      setPlacement -----.
+   .--- set{Data,Layers,resume}    retryPreparation, resume ----.
    |         |                                     |            |
    |         v                                     v            |
-   .-- [need layout] <-- set{Data,Layers} -- [need placement] --.
+   .-- [need layout] <- set{Data,Layers,resume} - [need preparation]
              |                                     |
          coalesced                             coalesced
              |                                     |
              v                                     v
-    (do layout or placement; self-send "coalesced"; goto [coalescing])
+    (do layout or preparation; self-send "coalesced"; goto [coalescing])
 
-   The idea is that in the [idle] state, layout or placement happens immediately
-   in response to a "set" message. During this processing, multiple "set" messages
-   might get queued in the mailbox. At the end of processing, we self-send "coalesced",
+   The idea is that in the [idle] state, layout or preparation happens immediately
+   in response to a message. During this processing, multiple messages might get
+   queued in the mailbox. At the end of processing, we self-send "coalesced",
    read all the queued messages until we get to "coalesced", and then redo either
-   layout or placement if there were one or more "set"s (with layout taking priority,
-   since it will trigger placement when complete), or return to the [idle] state if not.
+   layout or preparation if there were one or more messages (with layout taking
+   priority, since it will trigger preparation when complete), or return to the
+   [idle] state if not.
+
+   Preparation determines the positions of the glyphs and icons of the symbol
+   layouts. Once all of them are prepared, they're handed over to the tile's
+   SymbolPlacementWorker, which does the actual placement.
+
+   Layout and preparation are abandoned part way through while the tile is
+   paused (see GeometryTile::setPriority); "resume" starts over whichever of
+   them didn't complete.
 */
 
 void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_, uint64_t correlationID_) {
     try {
+        TileTrace::instant(TileTrace::Event::Data, sourceID, id, data_ ? nullptr : "no data");
+
         data = std::move(data_);
         correlationID = correlationID_;
 
+        // None of the buckets laid out so far apply to the new data.
+        laidOutBuckets.clear();
+        laidOutLayers.clear();
+        laidOutCurrentLayers = false;
+
         switch (state) {
         case Idle:
             redoLayout();
@@ -83,7 +113,7 @@ void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
 
         case Coalescing:
         case NeedLayout:
-        case NeedPlacement:
+        case NeedPreparation:
             state = NeedLayout;
             break;
         }
@@ -94,6 +124,11 @@ void GeometryTileWorker::setData(std::unique_ptr<const GeometryTileData> data_,
 
 void GeometryTileWorker::setLayers(std::vector<std::unique_ptr<Layer>> layers_, uint64_t correlationID_) {
     try {
+        if (laidOutCurrentLayers) {
+            laidOutLayers = std::move(*layers);
+            laidOutCurrentLayers = false;
+        }
+
         layers = std::move(layers_);
         correlationID = correlationID_;
 
@@ -104,7 +139,7 @@ void GeometryTileWorker::setLayers(std::vector<std::unique_ptr<Layer>> layers_,
             break;
 
         case Coalescing:
-        case NeedPlacement:
+        case NeedPreparation:
             state = NeedLayout;
             break;
 
@@ -116,22 +151,50 @@ void GeometryTileWorker::setLayers(std::vector<std::unique_ptr<Layer>> layers_,
     }
 }
 
-void GeometryTileWorker::setPlacementConfig(PlacementConfig placementConfig_, uint64_t correlationID_) {
+void GeometryTileWorker::retryPreparation() {
     try {
-        placementConfig = std::move(placementConfig_);
-        correlationID = correlationID_;
+        switch (state) {
+        case Idle:
+            attemptPreparation();
+            coalesce();
+            break;
+
+        case Coalescing:
+            state = NeedPreparation;
+            break;
+
+        case NeedPreparation:
+        case NeedLayout:
+            break;
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
 
+void GeometryTileWorker::resume() {
+    try {
+        // Picks up whatever was abandoned while the tile was paused.
         switch (state) {
         case Idle:
-            attemptPlacement();
+            if (layoutIncomplete) {
+                redoLayout();
+            } else {
+                attemptPreparation();
+            }
             coalesce();
             break;
 
         case Coalescing:
-            state = NeedPlacement;
+            state = layoutIncomplete ? NeedLayout : NeedPreparation;
+            break;
+
+        case NeedPreparation:
+            if (layoutIncomplete) {
+                state = NeedLayout;
+            }
             break;
 
-        case NeedPlacement:
         case NeedLayout:
             break;
         }
@@ -156,8 +219,8 @@ void GeometryTileWorker::coalesced() {
             coalesce();
             break;
 
-        case NeedPlacement:
-            attemptPlacement();
+        case NeedPreparation:
+            attemptPreparation();
             coalesce();
             break;
         }
@@ -176,17 +239,59 @@ void GeometryTileWorker::redoLayout() {
         return;
     }
 
-    // We're doing a fresh parse of the tile, because the underlying data or style has changed.
+    TileTrace::Scope trace(TileTrace::Event::Layout, sourceID, id);
+    util::Instrumentation::Timer timer(util::Instrumentation::Counter::Layout);
+    layoutIncomplete = true;
+
+    // Buckets whose layers are unchanged since the previous layout of this data are kept as they
+    // are; everything else is laid out afresh. Until this layout completes, nothing is current.
+    auto previousBuckets = std::move(laidOutBuckets);
+    laidOutBuckets.clear();
+
+    // Symbol layouts that are all kept, e.g. when only the filter of a line layer changed, stay
+    // placed as they are.
+    const auto previousSymbolLayouts = std::move(symbolLayouts);
+    const bool previousSymbolLayoutsHandedOver = symbolLayoutsHandedOver;
     symbolLayouts.clear();
+    symbolLayoutsHandedOver = false;
 
     // We're storing a set of bucket names we've parsed to avoid parsing a bucket twice that is
     // referenced from more than one layer
     std::unordered_set<std::string> parsed;
     std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+    std::unordered_map<std::string, LaidOutBucket> nextBuckets;
+    std::vector<std::string> keptBuckets;
     auto featureIndex = std::make_unique<FeatureIndex>();
 
+    // Buckets other than symbol buckets only depend on their own layer, so they're created in
+    // parallel below, each with a feature index of its own. Symbol layouts use the glyph atlas,
+    // and are created right away.
+    struct BucketJob {
+        const Layer* layer;
+        const GeometryTileLayer* geometryLayer;
+        std::size_t group;
+        bool kept;
+        std::unique_ptr<FeatureIndex> featureIndex;
+        std::unique_ptr<Bucket> bucket;
+        std::exception_ptr error;
+    };
+
+    // Jobs that read the same source layer with the same filter share decoded features.
+    struct FeatureGroup {
+        const GeometryTileLayer* geometryLayer;
+        const Filter* filter;
+        std::size_t jobCount;
+        std::unique_ptr<FilteredFeatures> features;
+        std::exception_ptr error;
+    };
+
+    std::vector<BucketJob> jobs;
+    jobs.reserve(layers->size());
+    std::vector<FeatureGroup> groups;
+
     for (auto i = layers->rbegin(); i != layers->rend(); i++) {
         if (obsolete) {
+            trace.setDetail("abandoned");
             return;
         }
 
@@ -205,88 +310,211 @@ void GeometryTileWorker::redoLayout() {
             continue; // Tile has no data.
         }
 
+        // GeometryTileData::getLayer() may parse lazily, so it's only called from this thread.
         auto geometryLayer = (*data)->getLayer(layer->baseImpl->sourceLayer);
         if (!geometryLayer) {
             continue;
         }
 
-        BucketParameters parameters(id,
-                                    *geometryLayer,
-                                    obsolete,
-                                    reinterpret_cast<uintptr_t>(this),
-                                    glyphAtlas,
-                                    *featureIndex,
-                                    mode);
+        auto previous = previousBuckets.find(bucketName);
+        const bool keep = previous != previousBuckets.end() &&
+                          typeid(*previous->second.layer->baseImpl) == typeid(*layer->baseImpl) &&
+                          !layer->baseImpl->hasLayoutDifference(*previous->second.layer->baseImpl);
+
+        if (keep) {
+            keptBuckets.push_back(bucketName);
+        }
 
         if (layer->is<SymbolLayer>()) {
-            symbolLayouts.push_back(layer->as<SymbolLayer>()->impl->createLayout(parameters));
+            std::shared_ptr<SymbolLayout> symbolLayout;
+
+            if (keep) {
+                symbolLayout = previous->second.symbolLayout;
+            } else {
+                BucketParameters parameters(id,
+                                            *geometryLayer,
+                                            obsolete,
+                                            reinterpret_cast<uintptr_t>(this),
+                                            glyphAtlas,
+                                            *featureIndex,
+                                            mode);
+
+                symbolLayout = layer->as<SymbolLayer>()->impl->createLayout(parameters);
+            }
+
+            symbolLayouts.push_back(symbolLayout);
+            nextBuckets.emplace(bucketName, LaidOutBucket { layer, nullptr, std::move(symbolLayout) });
         } else {
-            std::unique_ptr<Bucket> bucket = layer->baseImpl->createBucket(parameters);
-            if (bucket->hasData()) {
-                buckets.emplace(layer->baseImpl->bucketName(), std::move(bucket));
+            jobs.emplace_back();
+            jobs.back().layer = layer;
+            jobs.back().geometryLayer = geometryLayer;
+            jobs.back().kept = keep;
+
+            if (keep) {
+                jobs.back().featureIndex = std::move(previous->second.featureIndex);
+                continue;
+            }
+
+            const Filter& filter = layer->baseImpl->filter;
+            auto group = std::find_if(groups.begin(), groups.end(), [&] (const FeatureGroup& g) {
+                return g.geometryLayer == geometryLayer && *g.filter == filter;
+            });
+            if (group == groups.end()) {
+                group = groups.insert(groups.end(), FeatureGroup { geometryLayer, &filter, 0, nullptr, nullptr });
+            }
+            group->jobCount++;
+
+            jobs.back().group = group - groups.begin();
+            jobs.back().featureIndex = std::make_unique<FeatureIndex>();
+        }
+    }
+
+    // Decoding features only pays off for groups that are used more than once.
+    const optional<GeometryBox> bounds = visibleBounds(id);
+    parallelFor(groups.size(), [&] (std::size_t g) {
+        FeatureGroup& group = groups[g];
+        if (group.jobCount > 1) {
+            // Decoding throws on malformed geometry, which parallelFor() doesn't allow.
+            try {
+                group.features = std::make_unique<FilteredFeatures>(*group.geometryLayer, *group.filter, bounds, obsolete);
+            } catch (...) {
+                group.error = std::current_exception();
             }
         }
+    });
+
+    for (const auto& group : groups) {
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+
+    parallelFor(jobs.size(), [&] (std::size_t j) {
+        BucketJob& job = jobs[j];
+        if (job.kept) {
+            return;
+        }
+
+        try {
+            BucketParameters parameters(id,
+                                        *job.geometryLayer,
+                                        obsolete,
+                                        reinterpret_cast<uintptr_t>(this),
+                                        glyphAtlas,
+                                        *job.featureIndex,
+                                        mode);
+            parameters.filteredFeatures = groups[job.group].features.get();
+
+            job.bucket = job.layer->baseImpl->createBucket(parameters);
+        } catch (...) {
+            job.error = std::current_exception();
+        }
+    });
+
+    if (obsolete) {
+        trace.setDetail("abandoned");
+        return;
     }
 
+    // Collect the results in layer order, so that they don't depend on which job finished first.
+    for (auto& job : jobs) {
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+
+        const std::string& bucketName = job.layer->baseImpl->bucketName();
+
+        featureIndex->append(*job.featureIndex);
+
+        if (job.bucket && job.bucket->hasData()) {
+            buckets.emplace(bucketName, std::move(job.bucket));
+        }
+
+        nextBuckets.emplace(bucketName, LaidOutBucket { job.layer, std::move(job.featureIndex), nullptr });
+    }
+
+    featureIndex->finish();
+
+    laidOutBuckets = std::move(nextBuckets);
+    laidOutLayers.clear();
+    laidOutCurrentLayers = true;
+    layoutIncomplete = false;
+    symbolLayoutsHandedOver = previousSymbolLayoutsHandedOver && symbolLayouts == previousSymbolLayouts;
+
     parent.invoke(&GeometryTile::onLayout, GeometryTile::LayoutResult {
         std::move(buckets),
+        std::move(keptBuckets),
         std::move(featureIndex),
         *data ? (*data)->clone() : nullptr,
-        correlationID
+        *data ? (*data)->getPolygonFixupStats() : PolygonFixupStats(),
+        correlationID,
+        symbolLayoutsHandedOver
     });
 
-    attemptPlacement();
+    attemptPreparation();
 }
 
-void GeometryTileWorker::attemptPlacement() {
-    if (!data || !layers || !placementConfig) {
+void GeometryTileWorker::attemptPreparation() {
+    if (!data || !layers || layoutIncomplete || symbolLayoutsHandedOver) {
         return;
     }
 
+    TileTrace::Scope trace(TileTrace::Event::Preparation, sourceID, id);
     bool canPlace = true;
 
-    // Prepare as many SymbolLayouts as possible.
-    for (auto& symbolLayout : symbolLayouts) {
-        if (obsolete) {
-            return;
-        }
+    // Prepare as many SymbolLayouts as possible. Each one only shapes and anchors its own labels,
+    // so they're prepared in parallel; placement, which puts them all in one collision tile, waits
+    // for all of them.
+    struct PrepareJob {
+        SymbolLayout* layout;
+        std::exception_ptr error;
+    };
+    std::vector<PrepareJob> jobs;
 
+    for (auto& symbolLayout : symbolLayouts) {
         if (symbolLayout->state == SymbolLayout::Pending) {
             if (symbolLayout->canPrepare(glyphAtlas)) {
-                symbolLayout->state = SymbolLayout::Prepared;
-                symbolLayout->prepare(reinterpret_cast<uintptr_t>(this),
-                                      glyphAtlas);
+                jobs.push_back({ symbolLayout.get(), nullptr });
             } else {
                 canPlace = false;
             }
         }
     }
 
-    if (!canPlace) {
-        return; // We'll be notified (via `setPlacementConfig`) when it's time to try again.
-    }
-
-    auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
-    std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
-
-    for (auto& symbolLayout : symbolLayouts) {
+    parallelFor(jobs.size(), [&] (std::size_t j) {
+        PrepareJob& job = jobs[j];
         if (obsolete) {
             return;
         }
 
-        symbolLayout->state = SymbolLayout::Placed;
-        if (symbolLayout->hasSymbolInstances()) {
-            buckets.emplace(symbolLayout->bucketName,
-                            symbolLayout->place(*collisionTile));
+        try {
+            job.layout->prepare(reinterpret_cast<uintptr_t>(this), glyphAtlas);
+            job.layout->state = SymbolLayout::Prepared;
+        } catch (...) {
+            job.error = std::current_exception();
         }
+    });
+
+    if (obsolete) {
+        trace.setDetail("abandoned");
+        return;
     }
 
-    parent.invoke(&GeometryTile::onPlacement, GeometryTile::PlacementResult {
-        std::move(buckets),
-        std::move(collisionTile),
-        *placementConfig,
-        correlationID
-    });
+    for (auto& job : jobs) {
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+    }
+
+    if (!canPlace) {
+        trace.setDetail("waiting for glyphs or icons");
+        return; // We'll be notified (via `retryPreparation`) when it's time to try again.
+    }
+
+    // From here on, only the placement worker touches these layouts; layouts kept for a later
+    // layout are handed over again as they are.
+    symbolLayoutsHandedOver = true;
+    placement.invokeCoalesced(&SymbolPlacementWorker::setSymbolLayouts, symbolLayouts, correlationID);
 }
 
 } // namespace mbgl
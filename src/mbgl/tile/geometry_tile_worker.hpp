@@ -2,20 +2,25 @@
 
 #include <mbgl/map/mode.hpp>
 #include <mbgl/tile/tile_id.hpp>
-#include <mbgl/text/placement_config.hpp>
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/actor/parallel_for.hpp>
 #include <mbgl/util/optional.hpp>
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
 class GeometryTile;
+class SymbolPlacementWorker;
+class Scheduler;
 class GeometryTileData;
 class GlyphAtlas;
 class SymbolLayout;
+class FeatureIndex;
 
 namespace style {
 class Layer;
@@ -25,6 +30,9 @@ class GeometryTileWorker {
 public:
     GeometryTileWorker(ActorRef<GeometryTileWorker> self,
                        ActorRef<GeometryTile> parent,
+                       ActorRef<SymbolPlacementWorker> placement,
+                       Scheduler&,
+                       std::string sourceID,
                        OverscaledTileID,
                        GlyphAtlas&,
                        const std::atomic<bool>&,
@@ -33,17 +41,22 @@ public:
 
     void setLayers(std::vector<std::unique_ptr<style::Layer>>, uint64_t correlationID);
     void setData(std::unique_ptr<const GeometryTileData>, uint64_t correlationID);
-    void setPlacementConfig(PlacementConfig, uint64_t correlationID);
+    void retryPreparation();
+    void resume();
 
 private:
     void coalesce();
     void coalesced();
     void redoLayout();
-    void attemptPlacement();
+    void attemptPreparation();
 
     ActorRef<GeometryTileWorker> self;
     ActorRef<GeometryTile> parent;
+    ActorRef<SymbolPlacementWorker> placement;
+    // Spreads layout work over the worker's scheduler, with helpers reused across layouts.
+    actor::ParallelFor parallelFor;
 
+    const std::string sourceID;
     const OverscaledTileID id;
     GlyphAtlas& glyphAtlas;
     const std::atomic<bool>& obsolete;
@@ -53,7 +66,7 @@ private:
         Idle,
         Coalescing,
         NeedLayout,
-        NeedPlacement
+        NeedPreparation
     };
 
     State state = Idle;
@@ -62,9 +75,27 @@ private:
     // Outer optional indicates whether we've received it or not.
     optional<std::vector<std::unique_ptr<style::Layer>>> layers;
     optional<std::unique_ptr<const GeometryTileData>> data;
-    optional<PlacementConfig> placementConfig;
 
-    std::vector<std::unique_ptr<SymbolLayout>> symbolLayouts;
+    // Set while a layout has been started but not completed, e.g. because it was abandoned when the
+    // tile was paused. Its symbol layouts mustn't be handed over, and `resume` starts it again.
+    bool layoutIncomplete = false;
+
+    // Shared with the placement worker once all of them are prepared; see `SymbolPlacementWorker`.
+    std::vector<std::shared_ptr<SymbolLayout>> symbolLayouts;
+    bool symbolLayoutsHandedOver = false;
+
+    // What the most recent layout produced for each bucket. The next layout of the same data keeps
+    // the buckets whose layers haven't changed in a way that affects them.
+    struct LaidOutBucket {
+        const style::Layer* layer;
+        std::unique_ptr<FeatureIndex> featureIndex; // Non-symbol buckets only.
+        std::shared_ptr<SymbolLayout> symbolLayout; // Symbol buckets only.
+    };
+    std::unordered_map<std::string, LaidOutBucket> laidOutBuckets;
+
+    // Once `layers` is replaced, keeps the layers that `laidOutBuckets` refers to alive.
+    std::vector<std::unique_ptr<style::Layer>> laidOutLayers;
+    bool laidOutCurrentLayers = false;
 };
 
 } // namespace mbgl
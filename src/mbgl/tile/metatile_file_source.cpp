@@ -0,0 +1,237 @@
+#include <mbgl/tile/metatile_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/tileset.hpp>
+
+#include <protozero/pbf_reader.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+namespace mbgl {
+
+std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<const std::string>>
+splitMetatile(const std::string& data, uint8_t size) {
+    std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<const std::string>> tiles;
+
+    try {
+        protozero::pbf_reader metatile(data);
+        while (metatile.next(1)) { // tile
+            protozero::pbf_reader tile = metatile.get_message();
+            optional<uint32_t> x;
+            optional<uint32_t> y;
+            std::shared_ptr<const std::string> tileData;
+            while (tile.next()) {
+                switch (tile.tag()) {
+                case 1: // x
+                    x = tile.get_uint32();
+                    break;
+                case 2: // y
+                    y = tile.get_uint32();
+                    break;
+                case 3: // data
+                    tileData = std::make_shared<const std::string>(tile.get_string());
+                    break;
+                default:
+                    tile.skip();
+                    break;
+                }
+            }
+
+            if (!x || !y || *x >= size || *y >= size) {
+                throw std::runtime_error("metatile holds a tile outside of it");
+            }
+            if (tileData) {
+                tiles[{ *x, *y }] = std::move(tileData);
+            }
+        }
+    } catch (const protozero::exception&) {
+        throw std::runtime_error("invalid metatile");
+    }
+
+    return tiles;
+}
+
+class MetatileFileSource::Metatile : public std::enable_shared_from_this<Metatile> {
+public:
+    Metatile(MetatileFileSource& source_, Key key_)
+        : source(source_), key(std::move(key_)) {
+    }
+
+    ~Metatile() {
+        auto it = source.loading.find(key);
+        if (it != source.loading.end() && it->second.expired()) {
+            source.loading.erase(it);
+        }
+    }
+
+    void load(const Resource& resource) {
+        priority = resource.priority;
+        request = source.fileSource.request(resource, [this] (Response res) {
+            loaded(res);
+        });
+    }
+
+    void updatePriority();
+
+    MetatileFileSource& source;
+    const Key key;
+    std::vector<TileRequest*> tiles;
+    Resource::Priority priority = Resource::Regular;
+
+private:
+    void loaded(const Response&);
+
+    std::unique_ptr<AsyncRequest> request;
+};
+
+class MetatileFileSource::TileRequest : public AsyncRequest {
+public:
+    TileRequest(std::shared_ptr<Metatile> metatile_,
+                std::pair<uint32_t, uint32_t> position_,
+                Resource::Priority priority_,
+                Callback callback_)
+        : metatile(std::move(metatile_)),
+          position(std::move(position_)),
+          priority(priority_),
+          callback(std::move(callback_)) {
+        metatile->tiles.push_back(this);
+    }
+
+    ~TileRequest() override {
+        auto& tiles = metatile->tiles;
+        tiles.erase(std::find(tiles.begin(), tiles.end(), this));
+        if (!tiles.empty()) {
+            metatile->updatePriority();
+        }
+    }
+
+    // Cancels the metatile's request once the last of its tiles is cancelled.
+    const std::shared_ptr<Metatile> metatile;
+    const std::pair<uint32_t, uint32_t> position;
+    Resource::Priority priority;
+    const Callback callback;
+};
+
+void MetatileFileSource::Metatile::updatePriority() {
+    Resource::Priority highest = Resource::Background;
+    for (const TileRequest* tile : tiles) {
+        highest = std::min(highest, tile->priority);
+    }
+    if (request && highest != priority) {
+        priority = highest;
+        source.fileSource.setPriority(*request, priority);
+    }
+}
+
+void MetatileFileSource::Metatile::loaded(const Response& res) {
+    // Keeps the metatile alive, in case the tiles cancel their requests from their callbacks.
+    const std::shared_ptr<Metatile> self = shared_from_this();
+
+    // Tiles that ask for the metatile from now on request it again.
+    auto it = source.loading.find(key);
+    if (it != source.loading.end() && it->second.lock() == self) {
+        source.loading.erase(it);
+    }
+
+    Response response = res;
+    response.data.reset();
+
+    std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<const std::string>> parts;
+    if (!res.error && !res.notModified && !res.noContent && res.data) {
+        try {
+            parts = splitMetatile(*res.data, source.size);
+        } catch (const std::exception& ex) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, ex.what());
+        }
+    }
+
+    const std::vector<TileRequest*> waiting = tiles;
+    for (TileRequest* tile : waiting) {
+        // Skips tiles whose requests were cancelled by the callbacks of others.
+        if (std::find(tiles.begin(), tiles.end(), tile) == tiles.end()) {
+            continue;
+        }
+
+        Response tileResponse = response;
+        if (!tileResponse.error && !tileResponse.notModified) {
+            auto part = parts.find(tile->position);
+            if (part != parts.end()) {
+                tileResponse.data = part->second;
+            } else {
+                tileResponse.noContent = true;
+            }
+        }
+
+        // Copy the callback, in case calling it deallocates the request.
+        Callback callback = tile->callback;
+        callback(tileResponse);
+    }
+}
+
+MetatileFileSource::MetatileFileSource(FileSource& fileSource_, const Tileset& tileset)
+    : fileSource(fileSource_),
+      urlTemplate(tileset.metatiles.empty() ? std::string() : tileset.metatiles.front()),
+      size(std::max<uint8_t>(tileset.metatileSize, 1)) {
+}
+
+MetatileFileSource::~MetatileFileSource() {
+    assert(loading.empty());
+}
+
+bool MetatileFileSource::isFor(const FileSource& fileSource_, const Tileset& tileset) const {
+    return &fileSource == &fileSource_ && !tileset.metatiles.empty() &&
+           urlTemplate == tileset.metatiles.front() && size == tileset.metatileSize;
+}
+
+std::unique_ptr<AsyncRequest> MetatileFileSource::request(const Resource& resource, Callback callback) {
+    if (resource.kind != Resource::Kind::Tile || !resource.tileData || urlTemplate.empty()) {
+        return fileSource.request(resource, std::move(callback));
+    }
+
+    // The coordinates of the tile are in the tileset's scheme already.
+    const Resource::TileData& tileData = *resource.tileData;
+    Resource metatileResource = Resource::tile(urlTemplate,
+                                               tileData.pixelRatio,
+                                               tileData.x / size,
+                                               tileData.y / size,
+                                               tileData.z,
+                                               Tileset::Scheme::XYZ,
+                                               resource.necessity);
+    metatileResource.priority = resource.priority;
+    metatileResource.priorModified = resource.priorModified;
+    metatileResource.priorExpires = resource.priorExpires;
+    metatileResource.priorEtag = resource.priorEtag;
+
+    Key key { metatileResource.url, bool(resource.necessity),
+              resource.priorEtag, resource.priorModified, resource.priorExpires };
+    std::shared_ptr<Metatile> metatile = loading[key].lock();
+    const bool load = !metatile;
+    if (load) {
+        metatile = std::make_shared<Metatile>(*this, key);
+        loading[key] = metatile;
+    }
+
+    auto tileRequest = std::make_unique<TileRequest>(
+        metatile, std::make_pair(uint32_t(tileData.x % size), uint32_t(tileData.y % size)),
+        resource.priority, std::move(callback));
+    if (load) {
+        metatile->load(metatileResource);
+    } else {
+        metatile->updatePriority();
+    }
+    return std::move(tileRequest);
+}
+
+void MetatileFileSource::setPriority(AsyncRequest& req, Resource::Priority priority) {
+    if (auto tileRequest = dynamic_cast<TileRequest*>(&req)) {
+        tileRequest->priority = priority;
+        tileRequest->metatile->updatePriority();
+    } else {
+        fileSource.setPriority(req, priority);
+    }
+}
+
+} // namespace mbgl
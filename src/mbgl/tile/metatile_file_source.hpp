@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace mbgl {
+
+class Tileset;
+
+/*
+    A metatile packs the tiles of a `size` × `size` block of the same zoom level into one
+    response, so that covering the viewport takes a fraction of the requests. It's a protobuf
+    message with one `tile` message (field 1) for each tile that has data:
+
+        message tile {
+            uint32 x = 1;    // Column within the metatile, from 0 to size - 1.
+            uint32 y = 2;    // Row within the metatile, from 0 to size - 1.
+            bytes data = 3;  // The tile, as it would be loaded on its own.
+        }
+
+    Tiles that aren't in the metatile have no content. Each tile's data refers to the metatile's
+    rows and columns in the tileset's scheme.
+
+    Throws std::runtime_error for metatiles that can't be read.
+*/
+std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<const std::string>>
+splitMetatile(const std::string& data, uint8_t size);
+
+/*
+    Requests tiles from metatiles instead, through the file source it wraps, and hands each of
+    them its part of the response. Tiles that ask for the same metatile while it loads share the
+    request, which is only cancelled once all of them cancelled theirs. Other resources, and
+    tiles of tilesets without metatiles, are requested as they are.
+
+    The requests of tiles refer to the file source, so they must not outlive it.
+*/
+class MetatileFileSource : public FileSource {
+public:
+    MetatileFileSource(FileSource&, const Tileset&);
+    ~MetatileFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    // A metatile is requested at the highest priority of the tiles that wait for it.
+    void setPriority(AsyncRequest&, Resource::Priority) override;
+
+    // Whether it requests the metatiles of the tileset from the file source.
+    bool isFor(const FileSource&, const Tileset&) const;
+
+    bool supportsOptionalRequests() const override {
+        return fileSource.supportsOptionalRequests();
+    }
+
+private:
+    class Metatile;
+    class TileRequest;
+
+    FileSource& fileSource;
+    const std::string urlTemplate;
+    const uint8_t size;
+
+    // The URL, the necessity, and the prior etag, modification and expiry time of a metatile
+    // request. Only tiles that know of the same version of the metatile share a request, as a
+    // Not Modified response is no use to the others.
+    using Key = std::tuple<std::string, bool, optional<std::string>, optional<Timestamp>, optional<Timestamp>>;
+
+    // The metatiles that haven't loaded yet. Tiles that ask for a metatile after it loaded
+    // request it again, which usually hits the cache.
+    std::map<Key, std::weak_ptr<Metatile>> loading;
+};
+
+} // namespace mbgl
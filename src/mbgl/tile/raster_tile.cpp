@@ -2,6 +2,7 @@
 #include <mbgl/tile/raster_tile_worker.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/tile/tile_trace.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/storage/resource.hpp>
@@ -13,13 +14,19 @@
 namespace mbgl {
 
 RasterTile::RasterTile(const OverscaledTileID& id_,
+                       std::string sourceID_,
                        const style::UpdateParameters& parameters,
                        const Tileset& tileset)
     : Tile(id_),
+      sourceID(std::move(sourceID_)),
       loader(*this, id_, parameters, tileset),
+      mode(parameters.mode),
       mailbox(std::make_shared<Mailbox>(*util::RunLoop::Get())),
       worker(parameters.workerScheduler,
-             ActorRef<RasterTile>(*this, mailbox)) {
+             ActorRef<RasterTile>(*this, mailbox),
+             tileset.encoding) {
+    mailbox->setTag("RasterTile");
+    worker.setTag("RasterTileWorker");
 }
 
 RasterTile::~RasterTile() = default;
@@ -36,27 +43,87 @@ void RasterTile::setData(std::shared_ptr<const std::string> data,
                              optional<Timestamp> expires_) {
     modified = modified_;
     expires = expires_;
-    worker.invoke(&RasterTileWorker::parse, data);
+    worker.invokeCoalesced(&RasterTileWorker::parse, data);
 }
 
 void RasterTile::onParsed(std::unique_ptr<Bucket> result) {
+    // Until the first image is uploaded, which may take several frames for large ones, the tile
+    // isn't renderable, so that its parent or children are rendered in its place. Still images
+    // are uploaded in one go.
+    if (availableData == DataAvailability::None && mode == MapMode::Continuous) {
+        awaitingUpload = true;
+    }
+    if (bucket && !bucket->needsUpload()) {
+        previousBucket = std::move(bucket);
+    }
     bucket = std::move(result);
     availableData = DataAvailability::All;
     observer->onTileChanged(*this);
 }
 
+void RasterTile::backfillBorder(const RasterTile& other, int8_t dx, int8_t dy) {
+    // Raster tiles only hold raster buckets.
+    auto demBucket = static_cast<RasterBucket*>(bucket.get());
+    auto otherBucket = static_cast<const RasterBucket*>(other.bucket.get());
+    if (demBucket && otherBucket) {
+        demBucket->backfillBorder(*otherBucket, dx, dy);
+    }
+}
+
 void RasterTile::onError(std::exception_ptr err) {
     bucket.reset();
+    previousBucket.reset();
+    awaitingUpload = false;
     availableData = DataAvailability::All;
     observer->onTileError(*this, err);
 }
 
 Bucket* RasterTile::getBucket(const style::Layer&) {
+    if (previousBucket && bucket && bucket->needsUpload()) {
+        return previousBucket.get();
+    }
     return bucket.get();
 }
 
+bool RasterTile::needsUpload() const {
+    return awaitingUpload || (bucket && bucket->needsUpload());
+}
+
+void RasterTile::upload(gl::Context& context) {
+    TileTrace::Scope trace(TileTrace::Event::Upload, sourceID, id);
+
+    // Uploads the next strip of the image; see RasterBucket::UploadStripSize.
+    if (bucket && bucket->needsUpload()) {
+        bucket->upload(context);
+    }
+    if (!bucket || !bucket->needsUpload()) {
+        awaitingUpload = false;
+        previousBucket.reset();
+    }
+}
+
+MemoryUsage RasterTile::getMemoryUsage() const {
+    MemoryUsage usage;
+    if (bucket) {
+        usage += bucket->getMemoryUsage();
+    }
+    if (previousBucket) {
+        usage += previousBucket->getMemoryUsage();
+    }
+    return usage;
+}
+
 void RasterTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
 
+bool RasterTile::isLoading() const {
+    return loader.isLoading();
+}
+
+void RasterTile::setPriority(Priority priority) {
+    worker.setPriority(priority);
+    loader.setPriority(priority);
+}
+
 } // namespace mbgl
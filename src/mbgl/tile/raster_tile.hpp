@@ -4,6 +4,7 @@
 #include <mbgl/tile/tile_loader.hpp>
 #include <mbgl/tile/raster_tile_worker.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/map/mode.hpp>
 
 namespace mbgl {
 
@@ -17,11 +18,14 @@ class UpdateParameters;
 class RasterTile : public Tile {
 public:
     RasterTile(const OverscaledTileID&,
-                   const style::UpdateParameters&,
-                   const Tileset&);
+               std::string sourceID,
+               const style::UpdateParameters&,
+               const Tileset&);
     ~RasterTile() final;
 
     void setNecessity(Necessity) final;
+    void setPriority(Priority) final;
+    bool isLoading() const final;
 
     void setError(std::exception_ptr);
     void setData(std::shared_ptr<const std::string> data,
@@ -30,12 +34,22 @@ public:
 
     void cancel() override;
     Bucket* getBucket(const style::Layer&) override;
+    bool needsUpload() const override;
+    void upload(gl::Context&) override;
+    MemoryUsage getMemoryUsage() const override;
+
+    // Backfills the border of the tile's elevation model from that of `other`, the tile `dx`,
+    // `dy` from it, if both are DEM tiles.
+    void backfillBorder(const RasterTile& other, int8_t dx, int8_t dy);
 
     void onParsed(std::unique_ptr<Bucket> result);
     void onError(std::exception_ptr);
 
+    const std::string sourceID;
+
 private:
     TileLoader<RasterTile> loader;
+    const MapMode mode;
 
     std::shared_ptr<Mailbox> mailbox;
     Actor<RasterTileWorker> worker;
@@ -43,6 +57,9 @@ private:
     // Contains the Bucket object for the tile. Buckets are render
     // objects and they get added by tile parsing operations.
     std::unique_ptr<Bucket> bucket;
+
+    // The bucket of the tile's previous data, rendered until all of the new one is uploaded.
+    std::unique_ptr<Bucket> previousBucket;
 };
 
 } // namespace mbgl
@@ -1,12 +1,16 @@
 #include <mbgl/tile/raster_tile_worker.hpp>
 #include <mbgl/tile/raster_tile.hpp>
-#include <mbgl/renderer/raster_bucket.cpp>
+#include <mbgl/renderer/raster_bucket.hpp>
+#include <mbgl/geometry/dem_data.hpp>
 #include <mbgl/actor/actor.hpp>
+#include <mbgl/util/ktx.hpp>
 
 namespace mbgl {
 
-RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_)
-    : parent(std::move(parent_)) {
+RasterTileWorker::RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile> parent_,
+                                   optional<Tileset::DEMEncoding> encoding_)
+    : parent(std::move(parent_)),
+      encoding(std::move(encoding_)) {
 }
 
 void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
@@ -16,7 +20,15 @@ void RasterTileWorker::parse(std::shared_ptr<const std::string> data) {
     }
 
     try {
-        auto bucket = std::make_unique<RasterBucket>(decodeImage(*data));
+        if (encoding) {
+            auto bucket = std::make_unique<RasterBucket>(DEMData(decodeImage(*data), *encoding));
+            parent.invoke(&RasterTile::onParsed, std::move(bucket));
+            return;
+        }
+
+        // Compressed textures are uploaded as they are, rather than decoded.
+        auto bucket = isKTX(*data) ? std::make_unique<RasterBucket>(decodeKTX(*data))
+                                   : std::make_unique<RasterBucket>(decodeImage(*data));
         parent.invoke(&RasterTile::onParsed, std::move(bucket));
     } catch (...) {
         parent.invoke(&RasterTile::onError, std::current_exception());
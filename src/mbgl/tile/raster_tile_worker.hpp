@@ -1,6 +1,8 @@
 #pragma once
 
 #include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/util/optional.hpp>
+#include <mbgl/util/tileset.hpp>
 
 #include <memory>
 #include <string>
@@ -11,12 +13,15 @@ class RasterTile;
 
 class RasterTileWorker {
 public:
-    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>);
+    // With an encoding, tiles are decoded as elevation models.
+    RasterTileWorker(ActorRef<RasterTileWorker>, ActorRef<RasterTile>,
+                     optional<Tileset::DEMEncoding> = {});
 
     void parse(std::shared_ptr<const std::string> data);
 
 private:
     ActorRef<RasterTile> parent;
+    const optional<Tileset::DEMEncoding> encoding;
 };
 
 } // namespace mbgl
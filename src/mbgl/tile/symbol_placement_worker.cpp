@@ -0,0 +1,104 @@
+#include <mbgl/tile/symbol_placement_worker.hpp>
+#include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/cross_tile_placement_worker.hpp>
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/util/instrumentation.hpp>
+
+namespace mbgl {
+
+SymbolPlacementWorker::SymbolPlacementWorker(ActorRef<SymbolPlacementWorker>,
+                                             ActorRef<GeometryTile> parent_,
+                                             std::string sourceID_,
+                                             OverscaledTileID id_,
+                                             const std::atomic<bool>& obsolete_)
+    : parent(std::move(parent_)),
+      sourceID(std::move(sourceID_)),
+      id(std::move(id_)),
+      obsolete(obsolete_) {
+}
+
+void SymbolPlacementWorker::setSymbolLayouts(std::vector<std::shared_ptr<SymbolLayout>> symbolLayouts_,
+                                             uint64_t correlationID_) {
+    try {
+        symbolLayouts = std::move(symbolLayouts_);
+        correlationID = correlationID_;
+        if (group) {
+            forwardSymbolLayouts();
+        } else {
+            attemptPlacement();
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
+
+void SymbolPlacementWorker::setPlacementConfig(PlacementConfig placementConfig_) {
+    try {
+        placementConfig = std::move(placementConfig_);
+        if (!group) {
+            attemptPlacement();
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
+
+void SymbolPlacementWorker::setPlacementGroup(optional<ActorRef<CrossTilePlacementWorker>> group_) {
+    try {
+        // ActorRef isn't assignable, so the optional is cleared and re-emplaced. `group = {}`
+        // would pick the optional's deleted move assignment.
+        group = std::experimental::nullopt;
+        if (group_) {
+            group.emplace(std::move(*group_));
+        }
+        if (group) {
+            forwardSymbolLayouts();
+        } else {
+            attemptPlacement();
+        }
+    } catch (...) {
+        parent.invoke(&GeometryTile::onError, std::current_exception());
+    }
+}
+
+void SymbolPlacementWorker::forwardSymbolLayouts() {
+    if (symbolLayouts) {
+        group->invoke(&CrossTilePlacementWorker::setSymbolLayouts, id, parent, *symbolLayouts, correlationID);
+    }
+}
+
+void SymbolPlacementWorker::attemptPlacement() {
+    if (!symbolLayouts || !placementConfig) {
+        return;
+    }
+
+    TileTrace::Scope trace(TileTrace::Event::Placement, sourceID, id);
+    util::Instrumentation::Timer timer(util::Instrumentation::Counter::Placement);
+
+    auto collisionTile = std::make_unique<CollisionTile>(*placementConfig);
+    std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets;
+
+    for (auto& symbolLayout : *symbolLayouts) {
+        if (obsolete) {
+            trace.setDetail("abandoned");
+            return;
+        }
+
+        if (symbolLayout->hasSymbolInstances()) {
+            buckets.emplace(symbolLayout->bucketName,
+                            symbolLayout->place(*collisionTile));
+        }
+    }
+
+    parent.invoke(&GeometryTile::onPlacement, GeometryTile::PlacementResult {
+        std::move(buckets),
+        std::move(collisionTile),
+        *placementConfig,
+        correlationID
+    });
+}
+
+} // namespace mbgl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/text/placement_config.hpp>
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class GeometryTile;
+class SymbolLayout;
+class CrossTilePlacementWorker;
+
+/*
+    Places the symbols of a `GeometryTile`, separately from the `GeometryTileWorker` that lays the
+    tile out. A change of placement config, e.g. while rotating or pitching, doesn't need a new
+    layout, so it shouldn't wait for one that's in progress. Instead, the layout worker hands its
+    symbol layouts over once they're prepared, and this actor places the most recent ones with the
+    most recent config whenever either changes.
+
+    Once handed over, symbol layouts are only ever touched by this actor, unless the tile's source
+    uses cross-tile placement: this actor then forwards them to the source's
+    `CrossTilePlacementWorker` instead of placing them itself.
+*/
+class SymbolPlacementWorker {
+public:
+    SymbolPlacementWorker(ActorRef<SymbolPlacementWorker> self,
+                          ActorRef<GeometryTile> parent,
+                          std::string sourceID,
+                          OverscaledTileID,
+                          const std::atomic<bool>&);
+
+    void setSymbolLayouts(std::vector<std::shared_ptr<SymbolLayout>>, uint64_t correlationID);
+    void setPlacementConfig(PlacementConfig);
+    void setPlacementGroup(optional<ActorRef<CrossTilePlacementWorker>>);
+
+private:
+    void forwardSymbolLayouts();
+    void attemptPlacement();
+
+    ActorRef<GeometryTile> parent;
+    const std::string sourceID;
+    const OverscaledTileID id;
+    const std::atomic<bool>& obsolete;
+
+    optional<ActorRef<CrossTilePlacementWorker>> group;
+
+    // The correlation ID of the layout that the symbol layouts came from.
+    uint64_t correlationID = 0;
+
+    optional<std::vector<std::shared_ptr<SymbolLayout>>> symbolLayouts;
+    optional<PlacementConfig> placementConfig;
+};
+
+} // namespace mbgl
@@ -22,6 +22,11 @@ void Tile::setTriedOptional() {
     observer->onTileChanged(*this);
 }
 
+void Tile::reportMemoryUsage(MemoryReport::Tiles& report) const {
+    report.count++;
+    report.buckets += getMemoryUsage();
+}
+
 void Tile::dumpDebugLogs() const {
     Log::Info(Event::General, "Tile::id: %s", util::toString(id).c_str());
     Log::Info(Event::General, "Tile::renderable: %s", isRenderable() ? "yes" : "no");
@@ -29,7 +34,7 @@ void Tile::dumpDebugLogs() const {
 }
 
 void Tile::queryRenderedFeatures(
-        std::unordered_map<std::string, std::vector<Feature>>&,
+        std::unordered_map<std::string, std::vector<IndexedRenderedFeature>>&,
         const GeometryCoordinates&,
         const TransformState&,
         const optional<std::vector<std::string>>&) {}
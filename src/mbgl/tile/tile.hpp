@@ -9,21 +9,32 @@
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/storage/resource.hpp>
+#include <mbgl/actor/mailbox.hpp>
 
 #include <string>
 #include <memory>
 #include <functional>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
 class DebugBucket;
+class IndexedRenderedFeature;
 class TransformState;
 class TileObserver;
 class PlacementConfig;
+class CrossTilePlacementWorker;
+template <class> class Actor;
+
+namespace gl {
+class Context;
+} // namespace gl
 
 namespace style {
 class Layer;
+class CompiledFilter;
 } // namespace style
 
 class Tile : private util::noncopyable {
@@ -42,20 +53,65 @@ public:
 
     virtual void setNecessity(Necessity) = 0;
 
+    // Determines how urgently the worker processing this tile is scheduled, relative to the
+    // workers of other tiles.
+    using Priority = Mailbox::Priority;
+
+    virtual void setPriority(Priority) {}
+
+    // Whether the tile is still waiting for the first response to its request for data.
+    virtual bool isLoading() const { return false; }
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel() = 0;
 
     virtual Bucket* getBucket(const style::Layer&) = 0;
 
+    // Uploads the tile's buckets to the GPU ahead of rendering them. The painter does this for
+    // tiles that need it within a per-frame budget, closest to the center of the map first.
+    virtual bool needsUpload() const { return false; }
+    virtual void upload(gl::Context&) {}
+
+    // The memory held by the tile's buckets, feature index and data, on the heap and in the GPU's
+    // buffers and textures; see TileCache::setMaxBytes().
+    virtual MemoryUsage getMemoryUsage() const { return {}; }
+
+    // Adds the tile and the memory it holds, by what holds it, to the tiles of a source's report;
+    // see Map::getMemoryReport(). Unless overridden, it's all attributed to the buckets.
+    virtual void reportMemoryUsage(MemoryReport::Tiles&) const;
+
+    // Drops the tile's buckets of the given names, e.g. of layers that aren't rendered at the
+    // current zoom level, and returns the memory they held. restoreBuckets() lays them out again
+    // once any of them are needed; it returns whether the tile still lacks some of them.
+    virtual MemoryUsage releaseBuckets(const std::set<std::string>&) { return {}; }
+    virtual bool restoreBuckets(const std::set<std::string>&) { return false; }
+
     virtual void setPlacementConfig(const PlacementConfig&) {}
-    virtual void redoLayout() {}
+
+    // Places this tile's symbols together with those of other tiles of its source, or on its own
+    // if null. The group must outlive the tile.
+    virtual void setPlacementGroup(Actor<CrossTilePlacementWorker>*) {}
+
+    // Lays the tile out anew if any of the given layers applies to it, before or after their change.
+    virtual void redoLayout(const std::unordered_set<std::string>& /* layerIDs */) {}
 
     virtual void queryRenderedFeatures(
-            std::unordered_map<std::string, std::vector<Feature>>& result,
+            std::unordered_map<std::string, std::vector<IndexedRenderedFeature>>& result,
             const GeometryCoordinates& queryGeometry,
             const TransformState&,
             const optional<std::vector<std::string>>& layerIDs);
 
+    // Appends the features of a layer of the tile's data that pass the filter. May be called for
+    // different tiles at the same time, from other threads, while the calling thread waits.
+    virtual void querySourceFeatures(std::vector<Feature>& /* result */,
+                                     const std::string& /* sourceLayer */,
+                                     const style::CompiledFilter&) {}
+
+    // The feature that the picking pass drew with the given ID for a pickable layer of this tile.
+    virtual optional<Feature> queryPickedFeature(const style::Layer&, uint16_t /* id */) {
+        return {};
+    }
+
     void setTriedOptional();
 
     // Returns true when the tile source has received a first response, regardless of whether a load
@@ -66,9 +122,11 @@ public:
 
     // Tile data considered "Renderable" can be used for rendering. Data in
     // partial state is still waiting for network resources but can also
-    // be rendered, although layers will be missing.
+    // be rendered, although layers will be missing. A tile whose first data
+    // hasn't been uploaded yet isn't renderable, so that parent or child
+    // tiles keep being rendered in its place meanwhile.
     bool isRenderable() const {
-        return availableData != DataAvailability::None;
+        return availableData != DataAvailability::None && !awaitingUpload;
     }
 
     bool isComplete() const {
@@ -78,7 +136,7 @@ public:
         return availableData == DataAvailability::Some;
     }
 
-    void dumpDebugLogs() const;
+    virtual void dumpDebugLogs() const;
 
     const OverscaledTileID id;
     optional<Timestamp> modified;
@@ -87,6 +145,9 @@ public:
     // Contains the tile ID string for painting debug information.
     std::unique_ptr<DebugBucket> debugBucket;
 
+    // Set at the end of the first frame that rendered the tile; see TileTrace::Event::FirstRender.
+    bool rendered = false;
+
 protected:
     bool triedOptional = false;
 
@@ -104,6 +165,7 @@ protected:
     };
 
     DataAvailability availableData = DataAvailability::None;
+    bool awaitingUpload = false;
 
     TileObserver* observer = nullptr;
 };
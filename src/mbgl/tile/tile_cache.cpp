@@ -7,14 +7,14 @@ namespace mbgl {
 
 void TileCache::setSize(size_t size_) {
     size = size_;
+    evict();
 
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
-    }
+    assert(tiles.size() <= size);
+}
 
-    assert(orderedKeys.size() <= size);
+void TileCache::setMaxBytes(size_t maxBytes_) {
+    maxBytes = maxBytes_;
+    evict();
 }
 
 void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
@@ -22,21 +22,33 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile> tile) {
         return;
     }
 
-    // insert new or query existing tile
-    if (tiles.emplace(key, std::move(tile)).second) {
-        // remove existing tile key
-        orderedKeys.remove(key);
+    // A tile that's already cached is replaced, and becomes the newest.
+    get(key);
+
+    // Cached tiles don't load or lay out any further, so they keep the footprint they have now.
+    const MemoryUsage usage = tile->getMemoryUsage();
+    auto it = tiles.emplace(key, Entry { std::move(tile), usage, Clock::now() }).first;
+    memoryUsage += usage;
+
+    Entry& entry = it->second;
+    entry.key = &it->first;
+    entry.older = newest;
+    if (newest) {
+        newest->newer = &entry;
+    } else {
+        oldest = &entry;
     }
+    newest = &entry;
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    evict();
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
-    }
+    assert(tiles.size() <= size);
+}
 
-    assert(orderedKeys.size() <= size);
+void TileCache::reportMemoryUsage(MemoryReport::Tiles& report) const {
+    for (const auto& pair : tiles) {
+        pair.second.tile->reportMemoryUsage(report);
+    }
 }
 
 std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
@@ -45,9 +57,10 @@ std::unique_ptr<Tile> TileCache::get(const OverscaledTileID& key) {
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(it->second);
+        tile = std::move(it->second.tile);
+        memoryUsage -= it->second.memoryUsage;
+        unlink(it->second);
         tiles.erase(it);
-        orderedKeys.remove(key);
         assert(tile->isRenderable());
     }
 
@@ -59,8 +72,38 @@ bool TileCache::has(const OverscaledTileID& key) {
 }
 
 void TileCache::clear() {
-    orderedKeys.clear();
     tiles.clear();
+    oldest = nullptr;
+    newest = nullptr;
+    memoryUsage = {};
+}
+
+optional<TimePoint> TileCache::getOldestTime() const {
+    if (!oldest) {
+        return {};
+    }
+    return oldest->added;
+}
+
+MemoryUsage TileCache::evictOldest() {
+    if (!oldest) {
+        return {};
+    }
+    const MemoryUsage usage = oldest->memoryUsage;
+    get(*oldest->key);
+    return usage;
+}
+
+void TileCache::unlink(Entry& entry) {
+    (entry.older ? entry.older->newer : oldest) = entry.newer;
+    (entry.newer ? entry.newer->older : newest) = entry.older;
+}
+
+void TileCache::evict() {
+    // Purge the oldest tiles first.
+    while (oldest && (tiles.size() > size || memoryUsage.total() > maxBytes)) {
+        get(*oldest->key);
+    }
 }
 
 } // namespace mbgl
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/memory_usage.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/optional.hpp>
 
-#include <list>
+#include <limits>
 #include <memory>
-#include <map>
+#include <unordered_map>
 
 namespace mbgl {
 
@@ -16,16 +19,65 @@ public:
 
     void setSize(size_t);
     size_t getSize() const { return size; };
+
+    // The most memory the cached tiles may hold, as reported by Tile::getMemoryUsage() when they
+    // were added. The oldest tiles are evicted once either this or the number of tiles is
+    // exceeded. Unlimited by default.
+    void setMaxBytes(size_t);
+    size_t getMaxBytes() const { return maxBytes; }
+
+    // The memory held by the cached tiles.
+    MemoryUsage getMemoryUsage() const { return memoryUsage; }
+
+    // Adds the cached tiles, and the memory they hold by what holds it, to a report.
+    void reportMemoryUsage(MemoryReport::Tiles&) const;
+
+    // When the oldest of the cached tiles was added, if there are any.
+    optional<TimePoint> getOldestTime() const;
+
+    // Evicts the oldest of the cached tiles, and returns the memory it held.
+    MemoryUsage evictOldest();
+
     void add(const OverscaledTileID& key, std::unique_ptr<Tile> data);
     std::unique_ptr<Tile> get(const OverscaledTileID& key);
     bool has(const OverscaledTileID& key);
     void clear();
 
+    // Removes the tiles for whose keys `fn` returns true.
+    template <class Fn>
+    void removeIf(Fn&& fn) {
+        for (Entry* entry = oldest; entry;) {
+            Entry* next = entry->newer;
+            if (fn(*entry->key)) {
+                get(*entry->key);
+            }
+            entry = next;
+        }
+    }
+
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    void evict();
+
+    // The entries form a list from the oldest to the newest, through the map's nodes, which stay
+    // at the same addresses, so that every operation takes constant time.
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        MemoryUsage memoryUsage;
+        TimePoint added;
+        const OverscaledTileID* key = nullptr;
+        Entry* older = nullptr;
+        Entry* newer = nullptr;
+    };
+
+    void unlink(Entry&);
+
+    std::unordered_map<OverscaledTileID, Entry> tiles;
+    Entry* oldest = nullptr;
+    Entry* newest = nullptr;
 
     size_t size;
+    size_t maxBytes = std::numeric_limits<size_t>::max();
+    MemoryUsage memoryUsage;
 };
 
 } // namespace mbgl
@@ -4,6 +4,9 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/tile/tile.hpp>
 
+#include <memory>
+#include <string>
+
 namespace mbgl {
 
 class FileSource;
@@ -22,6 +25,12 @@ public:
                const OverscaledTileID&,
                const style::UpdateParameters&,
                const Tileset&);
+    // Requests the tile's data from the file source instead of the map's.
+    TileLoader(T&,
+               const OverscaledTileID&,
+               const style::UpdateParameters&,
+               const Tileset&,
+               FileSource&);
     ~TileLoader();
 
     using Necessity = Resource::Necessity;
@@ -37,6 +46,14 @@ public:
         }
     }
 
+    // Tiles that fill in for others, and prefetched or cached ones, request their data at a lower
+    // priority. A pending request moves in the file source's queue.
+    void setPriority(Tile::Priority);
+
+    bool isLoading() const {
+        return !loaded;
+    }
+
 private:
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
@@ -57,6 +74,13 @@ private:
     Resource resource;
     FileSource& fileSource;
     std::unique_ptr<AsyncRequest> request;
+
+    // Set once the tile got data, or an error, from either request.
+    bool loaded = false;
+
+    // The data the tile was last given, if any, to tell whether a new response changes it.
+    bool hasData = false;
+    std::shared_ptr<const std::string> tileData;
 };
 
 } // namespace mbgl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/tile/tile_loader.hpp>
+#include <mbgl/tile/tile_trace.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/util/tileset.hpp>
@@ -14,6 +15,15 @@ TileLoader<T>::TileLoader(T& tile_,
                           const OverscaledTileID& id,
                           const style::UpdateParameters& parameters,
                           const Tileset& tileset)
+    : TileLoader(tile_, id, parameters, tileset, parameters.fileSource) {
+}
+
+template <typename T>
+TileLoader<T>::TileLoader(T& tile_,
+                          const OverscaledTileID& id,
+                          const style::UpdateParameters& parameters,
+                          const Tileset& tileset,
+                          FileSource& fileSource_)
     : tile(tile_),
       necessity(Necessity::Optional),
       resource(Resource::tile(
@@ -23,7 +33,7 @@ TileLoader<T>::TileLoader(T& tile_,
         id.canonical.y,
         id.canonical.z,
         tileset.scheme)),
-      fileSource(parameters.fileSource) {
+      fileSource(fileSource_) {
     assert(!request);
     if (fileSource.supportsOptionalRequests()) {
         // When supported, the first request is always optional, even if the TileLoader
@@ -47,17 +57,43 @@ TileLoader<T>::TileLoader(T& tile_,
 template <typename T>
 TileLoader<T>::~TileLoader() = default;
 
+template <typename T>
+void TileLoader<T>::setPriority(Tile::Priority priority) {
+    Resource::Priority resourcePriority = Resource::Regular;
+    switch (priority) {
+    case Tile::Priority::Visible:
+        resourcePriority = Resource::Regular;
+        break;
+    case Tile::Priority::Fallback:
+        resourcePriority = Resource::Fallback;
+        break;
+    case Tile::Priority::Prefetch:
+    case Tile::Priority::Cached:
+        resourcePriority = Resource::Low;
+        break;
+    }
+
+    if (resourcePriority != resource.priority) {
+        resource.priority = resourcePriority;
+        if (request) {
+            fileSource.setPriority(*request, resourcePriority);
+        }
+    }
+}
+
 template <typename T>
 void TileLoader<T>::loadOptional() {
     assert(!request);
 
     resource.necessity = Resource::Optional;
+    TileTrace::instant(TileTrace::Event::Request, tile.sourceID, tile.id, "optional");
     request = fileSource.request(resource, [this](Response res) {
         request.reset();
 
         tile.setTriedOptional();
 
         if (res.error && res.error->reason == Response::Error::Reason::NotFound) {
+            TileTrace::instant(TileTrace::Event::Response, tile.sourceID, tile.id, "not cached");
             // When the optional request could not be satisfied, don't treat it as an error.
             // Instead, we make sure that the next request knows that there has been an optional
             // request before by setting one of the prior* fields.
@@ -89,17 +125,41 @@ void TileLoader<T>::makeOptional() {
 
 template <typename T>
 void TileLoader<T>::loadedData(const Response& res) {
+    loaded = true;
     if (res.error && res.error->reason != Response::Error::Reason::NotFound) {
+        TileTrace::instant(TileTrace::Event::Response, tile.sourceID, tile.id, "error");
         tile.setError(std::make_exception_ptr(std::runtime_error(res.error->message)));
     } else if (res.notModified) {
+        TileTrace::instant(TileTrace::Event::Response, tile.sourceID, tile.id, "not modified");
         resource.priorExpires = res.expires;
+        // Unchanged data that came back whole may come with validators of its own.
+        if (res.etag) {
+            resource.priorEtag = res.etag;
+        }
+        if (res.modified) {
+            resource.priorModified = res.modified;
+        }
         // Do not notify the tile; when we get this message, it already has the current
         // version of the data.
     } else {
         resource.priorModified = res.modified;
         resource.priorExpires = res.expires;
         resource.priorEtag = res.etag;
-        tile.setData(res.noContent ? nullptr : res.data, res.modified, res.expires);
+
+        std::shared_ptr<const std::string> data = res.noContent ? nullptr : res.data;
+        if (hasData && (data == tileData || (data && tileData && *data == *tileData))) {
+            // The data came back the same, e.g. from a server that doesn't validate requests,
+            // so it isn't parsed and laid out again.
+            TileTrace::instant(TileTrace::Event::Response, tile.sourceID, tile.id, "unchanged");
+            tile.modified = res.modified;
+            tile.expires = res.expires;
+            return;
+        }
+        TileTrace::instant(TileTrace::Event::Response, tile.sourceID, tile.id,
+                           data ? "data" : "no content");
+        hasData = true;
+        tileData = data;
+        tile.setData(std::move(data), res.modified, res.expires);
     }
 }
 
@@ -108,6 +168,7 @@ void TileLoader<T>::loadRequired() {
     assert(!request);
 
     resource.necessity = Resource::Required;
+    TileTrace::instant(TileTrace::Event::Request, tile.sourceID, tile.id, "required");
     request = fileSource.request(resource, [this](Response res) { loadedData(res); });
 }
 
@@ -0,0 +1,203 @@
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/platform/platform.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <mutex>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+const char* eventName(TileTrace::Event event) {
+    switch (event) {
+    case TileTrace::Event::Request: return "request";
+    case TileTrace::Event::Response: return "response";
+    case TileTrace::Event::Data: return "data";
+    case TileTrace::Event::Layout: return "layout";
+    case TileTrace::Event::Preparation: return "preparation";
+    case TileTrace::Event::Placement: return "placement";
+    case TileTrace::Event::LayoutResult: return "layout result";
+    case TileTrace::Event::PlacementResult: return "placement result";
+    case TileTrace::Event::Upload: return "upload";
+    case TileTrace::Event::FirstRender: return "first render";
+    }
+    return "";
+}
+
+struct Record {
+    TileTrace::Event event;
+    std::string sourceID;
+    OverscaledTileID id;
+    TimePoint time;
+    optional<Duration> duration;
+    const char* detail;
+    uint32_t thread;
+};
+
+struct Buffer {
+    std::mutex mutex;
+    std::vector<Record> records;
+    std::vector<std::string> threadNames;
+    uint64_t dropped = 0;
+};
+
+Buffer& buffer() {
+    // Leaked, so that events may be recorded by threads that outlive static destruction.
+    static Buffer& instance = *new Buffer;
+    return instance;
+}
+
+// The index of the calling thread in `threadNames`, assigned when it first records an event.
+// Must be called with the buffer locked.
+uint32_t currentThread(Buffer& instance) {
+    static thread_local uint32_t index = 0;
+    if (index == 0) {
+        instance.threadNames.push_back(platform::getCurrentThreadName());
+        index = static_cast<uint32_t>(instance.threadNames.size());
+    }
+    return index;
+}
+
+double microseconds(Duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+} // namespace
+
+constexpr std::size_t TileTrace::MaxEvents;
+
+std::atomic<bool>& TileTrace::enabled() {
+    static std::atomic<bool> instance { false };
+    return instance;
+}
+
+void TileTrace::setEnabled(bool enabled_) {
+    enabled().store(enabled_, std::memory_order_relaxed);
+}
+
+void TileTrace::instant(Event event, const std::string& sourceID, const OverscaledTileID& id,
+                        const char* detail) {
+    if (isEnabled()) {
+        record(event, sourceID, id, Clock::now(), {}, detail);
+    }
+}
+
+TileTrace::Scope::Scope(Event event_, const std::string& sourceID_, const OverscaledTileID& id_)
+    : event(event_),
+      sourceID(sourceID_),
+      id(id_),
+      begin(Clock::now()),
+      active(isEnabled()) {
+}
+
+TileTrace::Scope::~Scope() {
+    if (active) {
+        record(event, sourceID, id, begin, Clock::now() - begin, detail);
+    }
+}
+
+void TileTrace::record(Event event, const std::string& sourceID, const OverscaledTileID& id,
+                       TimePoint time, optional<Duration> duration, const char* detail) {
+    Buffer& instance = buffer();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    if (instance.records.size() >= MaxEvents) {
+        instance.dropped++;
+        return;
+    }
+    instance.records.push_back({ event, sourceID, id, time, duration, detail, currentThread(instance) });
+}
+
+std::string TileTrace::take() {
+    std::vector<Record> records;
+    std::vector<std::string> threadNames;
+    uint64_t dropped;
+    {
+        Buffer& instance = buffer();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        records.swap(instance.records);
+        threadNames = instance.threadNames;
+        dropped = instance.dropped;
+        instance.dropped = 0;
+    }
+
+    rapidjson::StringBuffer output;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(output);
+
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    for (std::size_t i = 0; i < threadNames.size(); ++i) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String("thread_name");
+        writer.Key("ph");
+        writer.String("M");
+        writer.Key("pid");
+        writer.Uint(1);
+        writer.Key("tid");
+        writer.Uint(static_cast<unsigned>(i + 1));
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(threadNames[i].c_str());
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    for (const auto& record : records) {
+        const std::string tile = util::toString(record.id);
+        const std::string name = std::string(eventName(record.event)) + " " + record.sourceID + " " + tile;
+
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(name.c_str());
+        writer.Key("cat");
+        writer.String("tile");
+        writer.Key("ph");
+        writer.String(record.duration ? "X" : "i");
+        writer.Key("ts");
+        writer.Double(microseconds(record.time.time_since_epoch()));
+        if (record.duration) {
+            writer.Key("dur");
+            writer.Double(microseconds(*record.duration));
+        } else {
+            // Instants are drawn across the thread they happened on.
+            writer.Key("s");
+            writer.String("t");
+        }
+        writer.Key("pid");
+        writer.Uint(1);
+        writer.Key("tid");
+        writer.Uint(record.thread);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("source");
+        writer.String(record.sourceID.c_str());
+        writer.Key("tile");
+        writer.String(tile.c_str());
+        if (record.detail) {
+            writer.Key("detail");
+            writer.String(record.detail);
+        }
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("otherData");
+    writer.StartObject();
+    writer.Key("droppedEvents");
+    writer.Uint64(dropped);
+    writer.EndObject();
+    writer.EndObject();
+
+    return { output.GetString(), output.GetSize() };
+}
+
+} // namespace mbgl
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mbgl {
+
+/*
+    Process-wide tracing of the stages a tile goes through, from requesting its data to rendering
+    it for the first time, so that it's possible to tell which of them makes a tile slow. Stages
+    that take time on a thread are recorded as durations, everything else as instants; all of them
+    carry the source and the overscaled ID of their tile.
+
+    Tracing is off by default, and costs one relaxed atomic load per stage while it is. Once on,
+    events are appended to one buffer, under a lock, from whichever thread they happen on. The
+    buffer holds at most `MaxEvents`; later events are counted as dropped until it's taken.
+
+    `take()` returns the events in the Chrome trace event format, which chrome://tracing and
+    Perfetto open, with the threads named as in the log.
+*/
+class TileTrace {
+public:
+    enum class Event : uint8_t {
+        Request,         // A request for the tile's data, optional (cache only) or required.
+        Response,        // The response to it, and what it meant for the tile.
+        Data,            // The data reaching the tile's worker, which starts a layout if it's idle.
+        Layout,          // Laying out the buckets of the tile's layers, and then preparing symbols.
+        Preparation,     // Shaping and anchoring the tile's symbols, as far as glyphs and icons are in.
+        Placement,       // Placing them in the tile's collision tile.
+        LayoutResult,    // The tile receiving a layout on the main thread.
+        PlacementResult, // The tile receiving placed symbols on the main thread.
+        Upload,          // Uploading the tile's buckets to the GPU.
+        FirstRender,     // The end of the first frame that rendered the tile.
+    };
+
+    static constexpr std::size_t MaxEvents = 1 << 20;
+
+    static void setEnabled(bool);
+
+    static bool isEnabled() {
+        return enabled().load(std::memory_order_relaxed);
+    }
+
+    static void instant(Event, const std::string& sourceID, const OverscaledTileID&,
+                        const char* detail = nullptr);
+
+    // Records the time from its construction to its destruction as one event, if tracing was
+    // enabled when it was constructed.
+    class Scope : private util::noncopyable {
+    public:
+        Scope(Event, const std::string& sourceID, const OverscaledTileID&);
+        ~Scope();
+
+        // A static string to annotate the event with, e.g. why a stage was cut short.
+        void setDetail(const char* detail_) { detail = detail_; }
+
+    private:
+        const Event event;
+        const std::string& sourceID;
+        const OverscaledTileID& id;
+        const TimePoint begin;
+        const char* detail = nullptr;
+        const bool active;
+    };
+
+    // Returns the events recorded since the last call as a JSON trace object, and clears them.
+    static std::string take();
+
+private:
+    static std::atomic<bool>& enabled();
+    static void record(Event, const std::string& sourceID, const OverscaledTileID&,
+                       TimePoint, optional<Duration>, const char* detail);
+};
+
+} // namespace mbgl
@@ -1,12 +1,20 @@
 #include <mbgl/tile/vector_tile.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/flat_tile_data.hpp>
+#include <mbgl/tile/metatile_file_source.hpp>
+#include <mbgl/util/tileset.hpp>
+#include <mbgl/util/varint.hpp>
+#include <mbgl/util/memory_usage.hpp>
 
 #include <protozero/pbf_reader.hpp>
 
-#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <unordered_map>
 #include <functional>
+#include <tuple>
 #include <utility>
 
 namespace mbgl {
@@ -21,16 +29,27 @@ public:
 
     FeatureType getType() const override { return type; }
     optional<Value> getValue(const std::string&) const override;
+    optional<Value> getValueByKeyIndex(std::size_t) const override;
     std::unordered_map<std::string,Value> getProperties() const override;
     optional<FeatureIdentifier> getID() const override;
     GeometryCollection getGeometries() const override;
+    void eachGeometry(const std::function<void (const GeometryCoordinates&)>&) const override;
+    optional<GeometryBox> getBoundingBox() const override;
 
 private:
+    // Decodes the geometry command stream, and passes each line to `emit` once it's complete.
+    // `emit` may move the line away; it's cleared before it's reused.
+    template <class Emit>
+    void decodeGeometry(Emit&&) const;
+
     const VectorTileLayer& layer;
     optional<FeatureIdentifier> id;
     FeatureType type = FeatureType::Unknown;
     packed_iter_type tags_iter;
-    packed_iter_type geometry_iter;
+
+    // The packed geometry field, which is decoded with util::PackedVarintReader.
+    const char* geometryBegin = nullptr;
+    const char* geometryEnd = nullptr;
 };
 
 class VectorTileLayer : public GeometryTileLayer {
@@ -41,6 +60,9 @@ public:
     std::unique_ptr<GeometryTileFeature> getFeature(std::size_t) const override;
     std::string getName() const override;
 
+    bool hasKeyIndices() const override { return true; }
+    optional<std::size_t> getKeyIndex(const std::string&) const override;
+
 private:
     friend class VectorTileData;
     friend class VectorTileFeature;
@@ -52,43 +74,172 @@ private:
     std::vector<std::reference_wrapper<const std::string>> keys;
     std::vector<Value> values;
     std::vector<protozero::pbf_reader> features;
+
+    // Updated as version 1 polygon features are decoded, which may happen on several threads at
+    // once.
+    mutable std::atomic<std::size_t> polygonsChecked { 0 };
+    mutable std::atomic<std::size_t> polygonsFixedUp { 0 };
 };
 
 class VectorTileData : public GeometryTileData {
 public:
     VectorTileData(std::shared_ptr<const std::string> data);
 
+    // Clones share the tile's buffer, but parse it afresh: a parsed VectorTileLayer refers to its
+    // own keys, and can't be copied.
     std::unique_ptr<GeometryTileData> clone() const override {
-        return std::make_unique<VectorTileData>(*this);
+        return std::make_unique<VectorTileData>(data);
     }
 
     const GeometryTileLayer* getLayer(const std::string&) const override;
+    PolygonFixupStats getPolygonFixupStats() const override;
+    std::size_t getMemoryUsage() const override;
 
 private:
     std::shared_ptr<const std::string> data;
-    mutable bool parsed = false;
+
+    // Layers are only indexed by name at first. Their keys, values and features are parsed the
+    // first time they're asked for, so that layers no style layer refers to are never parsed.
+    mutable bool indexed = false;
+    mutable std::unordered_map<std::string, protozero::pbf_reader> unparsedLayers;
     mutable std::unordered_map<std::string, VectorTileLayer> layers;
 };
 
+// Tile data that takes its layers from a VectorTileDataCache.
+class SharedVectorTileData : public GeometryTileData {
+public:
+    SharedVectorTileData(std::shared_ptr<VectorTileDataCache> cache_,
+                         CanonicalTileID id_,
+                         std::shared_ptr<const std::string> data_)
+        : cache(std::move(cache_)), id(std::move(id_)), data(std::move(data_)) {
+    }
+
+    std::unique_ptr<GeometryTileData> clone() const override {
+        return std::make_unique<SharedVectorTileData>(cache, id, data);
+    }
+
+    const GeometryTileLayer* getLayer(const std::string& name) const override {
+        auto it = layers.find(name);
+        if (it == layers.end()) {
+            it = layers.emplace(name, cache->getLayer(id, data, name)).first;
+        }
+        return it->second->getLayer(name);
+    }
+
+    std::size_t getMemoryUsage() const override {
+        // The layers are shared with the other tiles that use the cache.
+        std::size_t bytes = data->size();
+        for (const auto& pair : layers) {
+            bytes += pair.second->getMemoryUsage();
+        }
+        return bytes;
+    }
+
+private:
+    const std::shared_ptr<VectorTileDataCache> cache;
+    const CanonicalTileID id;
+    const std::shared_ptr<const std::string> data;
+
+    // Holds on to the layers this tile uses, so that the cache keeps them.
+    mutable std::unordered_map<std::string, std::shared_ptr<const FlatTileData>> layers;
+};
+
+std::shared_ptr<const FlatTileData> VectorTileDataCache::getLayer(const CanonicalTileID& id,
+                                                                  const std::shared_ptr<const std::string>& data,
+                                                                  const std::string& layerName) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (Entry* entry = find(id, *data)) {
+            auto it = entry->layers.find(layerName);
+            if (it != entry->layers.end()) {
+                if (auto layer = it->second.lock()) {
+                    return layer;
+                }
+            }
+        }
+    }
+
+    // Decoded without holding the lock. If another tile decodes the same layer in the meantime,
+    // the first one to finish is kept.
+    auto decoded = std::make_shared<const FlatTileData>(VectorTileData(data), std::vector<std::string> { layerName });
+
+    std::lock_guard<std::mutex> lock(mutex);
+    prune();
+
+    Entry* entry = find(id, *data);
+    if (!entry) {
+        entry = &entries.emplace(id, Entry { data, {} })->second;
+    }
+
+    auto& cached = entry->layers[layerName];
+    if (auto layer = cached.lock()) {
+        return layer;
+    }
+    cached = decoded;
+    return decoded;
+}
+
+VectorTileDataCache::Entry* VectorTileDataCache::find(const CanonicalTileID& id, const std::string& data) {
+    // Overscaled tiles request their data separately, so it's compared by contents. That's far
+    // cheaper than decoding it again.
+    auto range = entries.equal_range(id);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second.data.get() == &data || *it->second.data == data) {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+void VectorTileDataCache::prune() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto& layers = it->second.layers;
+        for (auto layer = layers.begin(); layer != layers.end();) {
+            layer = layer->second.expired() ? layers.erase(layer) : std::next(layer);
+        }
+        it = layers.empty() ? entries.erase(it) : std::next(it);
+    }
+}
+
 VectorTile::VectorTile(const OverscaledTileID& id_,
                        std::string sourceID_,
                        const style::UpdateParameters& parameters,
-                       const Tileset& tileset)
+                       const Tileset& tileset,
+                       std::shared_ptr<VectorTileDataCache> dataCache_,
+                       std::shared_ptr<MetatileFileSource> metatileSource_)
     : GeometryTile(id_, sourceID_, parameters),
-      loader(*this, id_, parameters, tileset) {
+      metatileSource(std::move(metatileSource_)),
+      loader(*this, id_, parameters, tileset,
+             metatileSource ? static_cast<FileSource&>(*metatileSource) : parameters.fileSource),
+      dataCache(id_.overscaledZ >= tileset.zoomRange.max ? std::move(dataCache_) : nullptr) {
 }
 
 void VectorTile::setNecessity(Necessity necessity) {
     loader.setNecessity(necessity);
 }
 
+bool VectorTile::isLoading() const {
+    return loader.isLoading();
+}
+
+void VectorTile::setPriority(Priority priority) {
+    GeometryTile::setPriority(priority);
+    loader.setPriority(priority);
+}
+
 void VectorTile::setData(std::shared_ptr<const std::string> data_,
                          optional<Timestamp> modified_,
                          optional<Timestamp> expires_) {
     modified = modified_;
     expires = expires_;
 
-    GeometryTile::setData(data_ ? std::make_unique<VectorTileData>(data_) : nullptr);
+    if (!data_) {
+        GeometryTile::setData(nullptr);
+    } else if (dataCache) {
+        GeometryTile::setData(std::make_unique<SharedVectorTileData>(dataCache, id.canonical, data_));
+    } else {
+        GeometryTile::setData(std::make_unique<VectorTileData>(data_));
+    }
 }
 
 Value parseValue(protozero::pbf_reader data) {
@@ -131,7 +282,11 @@ VectorTileFeature::VectorTileFeature(protozero::pbf_reader feature_pbf, const Ve
             type = static_cast<FeatureType>(feature_pbf.get_enum());
             break;
         case 4: // geometry
-            geometry_iter = feature_pbf.get_packed_uint32();
+            {
+                const auto geometry = feature_pbf.get_data();
+                geometryBegin = geometry.first;
+                geometryEnd = geometry.first + geometry.second;
+            }
             break;
         default:
             feature_pbf.skip();
@@ -146,6 +301,10 @@ optional<Value> VectorTileFeature::getValue(const std::string& key) const {
         return optional<Value>();
     }
 
+    return getValueByKeyIndex(keyIter->second);
+}
+
+optional<Value> VectorTileFeature::getValueByKeyIndex(std::size_t keyIndex) const {
     auto start_itr = tags_iter.begin();
     const auto & end_itr = tags_iter.end();
     while (start_itr != end_itr) {
@@ -164,7 +323,7 @@ optional<Value> VectorTileFeature::getValue(const std::string& key) const {
             throw std::runtime_error("feature referenced out of range value");
         }
 
-        if (tag_key == keyIter->second) {
+        if (tag_key == keyIndex) {
             return layer.values[tag_val];
         }
     }
@@ -191,22 +350,20 @@ optional<FeatureIdentifier> VectorTileFeature::getID() const {
     return id;
 }
 
-GeometryCollection VectorTileFeature::getGeometries() const {
+template <class Emit>
+void VectorTileFeature::decodeGeometry(Emit&& emit) const {
     uint8_t cmd = 1;
     uint32_t length = 0;
     int32_t x = 0;
     int32_t y = 0;
     const float scale = float(util::EXTENT) / layer.extent;
 
-    GeometryCollection lines;
-
-    lines.emplace_back();
-    GeometryCoordinates* line = &lines.back();
+    GeometryCoordinates line;
 
-    auto g_itr = geometry_iter.begin();
-    while (g_itr != geometry_iter.end()) {
+    util::PackedVarintReader reader(geometryBegin, geometryEnd);
+    while (!reader.empty()) {
         if (length == 0) {
-            uint32_t cmd_length = static_cast<uint32_t>(*g_itr++);
+            uint32_t cmd_length = reader.next();
             cmd = cmd_length & 0x7;
             length = cmd_length >> 3;
         }
@@ -214,19 +371,19 @@ GeometryCollection VectorTileFeature::getGeometries() const {
         --length;
 
         if (cmd == 1 || cmd == 2) {
-            x += protozero::decode_zigzag32(static_cast<uint32_t>(*g_itr++));
-            y += protozero::decode_zigzag32(static_cast<uint32_t>(*g_itr++));
+            x += protozero::decode_zigzag32(reader.next());
+            y += protozero::decode_zigzag32(reader.next());
 
-            if (cmd == 1 && !line->empty()) { // moveTo
-                lines.emplace_back();
-                line = &lines.back();
+            if (cmd == 1 && !line.empty()) { // moveTo
+                emit(line);
+                line.clear();
             }
 
-            line->emplace_back(::round(x * scale), ::round(y * scale));
+            line.emplace_back(::round(x * scale), ::round(y * scale));
 
         } else if (cmd == 7) { // closePolygon
-            if (!line->empty()) {
-                line->push_back((*line)[0]);
+            if (!line.empty()) {
+                line.push_back(line[0]);
             }
 
         } else {
@@ -234,24 +391,104 @@ GeometryCollection VectorTileFeature::getGeometries() const {
         }
     }
 
+    emit(line);
+}
+
+optional<GeometryBox> VectorTileFeature::getBoundingBox() const {
+    // Follows the command stream like decodeGeometry() does, but only keeps track of the extremes.
+    uint8_t cmd = 1;
+    uint32_t length = 0;
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t minX = std::numeric_limits<int32_t>::max();
+    int32_t minY = std::numeric_limits<int32_t>::max();
+    int32_t maxX = std::numeric_limits<int32_t>::min();
+    int32_t maxY = std::numeric_limits<int32_t>::min();
+
+    util::PackedVarintReader reader(geometryBegin, geometryEnd);
+    while (!reader.empty()) {
+        if (length == 0) {
+            uint32_t cmd_length = reader.next();
+            cmd = cmd_length & 0x7;
+            length = cmd_length >> 3;
+        }
+
+        --length;
+
+        if (cmd == 1 || cmd == 2) {
+            x += protozero::decode_zigzag32(reader.next());
+            y += protozero::decode_zigzag32(reader.next());
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        } else if (cmd != 7) {
+            throw std::runtime_error("unknown command");
+        }
+    }
+
+    if (minX > maxX) {
+        return {};
+    }
+
+    // Scaling and rounding preserve the order of coordinates, so the extremes stay the extremes.
+    const float scale = float(util::EXTENT) / layer.extent;
+    return GeometryBox({ int16_t(::round(minX * scale)), int16_t(::round(minY * scale)) },
+                       { int16_t(::round(maxX * scale)), int16_t(::round(maxY * scale)) });
+}
+
+GeometryCollection VectorTileFeature::getGeometries() const {
+    GeometryCollection lines;
+
+    decodeGeometry([&] (GeometryCoordinates& line) {
+        lines.push_back(std::move(line));
+    });
+
     if (layer.version >= 2 || type != FeatureType::Polygon) {
         return lines;
     }
 
+    // Version 1 tiles don't guarantee valid polygons, but most of them have them anyway. Only
+    // those that aren't are sent through clipper.
+    layer.polygonsChecked.fetch_add(1, std::memory_order_relaxed);
+    if (isValidPolygonGeometry(lines)) {
+        return lines;
+    }
+
+    layer.polygonsFixedUp.fetch_add(1, std::memory_order_relaxed);
     return fixupPolygons(lines);
 }
 
+void VectorTileFeature::eachGeometry(const std::function<void (const GeometryCoordinates&)>& function) const {
+    // Version 1 polygons need to be fixed up as a whole.
+    if (layer.version < 2 && type == FeatureType::Polygon) {
+        GeometryTileFeature::eachGeometry(function);
+        return;
+    }
+
+    decodeGeometry([&] (const GeometryCoordinates& line) {
+        function(line);
+    });
+}
+
 VectorTileData::VectorTileData(std::shared_ptr<const std::string> data_)
     : data(std::move(data_)) {
 }
 
+static std::string parseLayerName(protozero::pbf_reader layer_pbf) {
+    if (layer_pbf.next(1)) { // name
+        return layer_pbf.get_string();
+    }
+    return {};
+}
+
 const GeometryTileLayer* VectorTileData::getLayer(const std::string& name) const {
-    if (!parsed) {
-        parsed = true;
+    if (!indexed) {
+        indexed = true;
         protozero::pbf_reader tile_pbf(*data);
         while (tile_pbf.next(3)) {
-            VectorTileLayer layer(tile_pbf.get_message());
-            layers.emplace(layer.name, std::move(layer));
+            protozero::pbf_reader layer_pbf = tile_pbf.get_message();
+            unparsedLayers.emplace(parseLayerName(layer_pbf), layer_pbf);
         }
     }
 
@@ -259,7 +496,39 @@ const GeometryTileLayer* VectorTileData::getLayer(const std::string& name) const
     if (it != layers.end()) {
         return &it->second;
     }
-    return nullptr;
+
+    auto unparsed = unparsedLayers.find(name);
+    if (unparsed == unparsedLayers.end()) {
+        return nullptr;
+    }
+
+    // Constructed in place, since the layer's keys refer to its own key map.
+    it = layers.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(name),
+                        std::forward_as_tuple(unparsed->second)).first;
+    unparsedLayers.erase(unparsed);
+    return &it->second;
+}
+
+PolygonFixupStats VectorTileData::getPolygonFixupStats() const {
+    PolygonFixupStats result;
+    for (const auto& layer : layers) {
+        result.checked += layer.second.polygonsChecked.load(std::memory_order_relaxed);
+        result.fixedUp += layer.second.polygonsFixedUp.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+std::size_t VectorTileData::getMemoryUsage() const {
+    // Parsed layers refer to the buffer rather than copying from it.
+    std::size_t bytes = data->size();
+    for (const auto& pair : layers) {
+        const VectorTileLayer& layer = pair.second;
+        bytes += util::memoryUsage(layer.keys) + util::memoryUsage(layer.values) +
+                 util::memoryUsage(layer.features) +
+                 layer.keysMap.size() * sizeof(std::pair<const std::string, uint32_t>);
+    }
+    return bytes;
 }
 
 VectorTileLayer::VectorTileLayer(protozero::pbf_reader layer_pbf) {
@@ -301,4 +570,12 @@ std::string VectorTileLayer::getName() const {
     return name;
 }
 
+optional<std::size_t> VectorTileLayer::getKeyIndex(const std::string& key) const {
+    auto it = keysMap.find(key);
+    if (it == keysMap.end()) {
+        return {};
+    }
+    return { it->second };
+}
+
 } // namespace mbgl
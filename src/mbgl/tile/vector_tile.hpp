@@ -3,28 +3,75 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/tile/tile_loader.hpp>
 
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 namespace mbgl {
 
 class Tileset;
+class FlatTileData;
+class MetatileFileSource;
 
 namespace style {
 class UpdateParameters;
 } // namespace style
 
+/*
+    A vector source only has tiles up to its maximum zoom level. Beyond it, the same source tile is
+    overscaled for every zoom level the map shows it at, and each of those tiles would decode the
+    same layers again. A `VectorTileDataCache` lets them share the decoded layers instead: the
+    first tile to lay out a layer converts it to a `FlatTileData`, and tiles with the same data
+    reuse it for as long as any of them holds on to it.
+
+    It's used from the workers of many tiles at once, and is thread-safe.
+*/
+class VectorTileDataCache {
+public:
+    // Returns the decoded contents of layer `layerName` of the tile `id` with `data`, decoding
+    // it if no other tile with the same data has.
+    std::shared_ptr<const FlatTileData> getLayer(const CanonicalTileID& id,
+                                                  const std::shared_ptr<const std::string>& data,
+                                                  const std::string& layerName);
+
+private:
+    struct Entry {
+        std::shared_ptr<const std::string> data;
+        std::unordered_map<std::string, std::weak_ptr<const FlatTileData>> layers;
+    };
+
+    Entry* find(const CanonicalTileID&, const std::string& data);
+    void prune();
+
+    std::mutex mutex;
+    std::multimap<CanonicalTileID, Entry> entries;
+};
+
 class VectorTile : public GeometryTile {
 public:
     VectorTile(const OverscaledTileID&,
                std::string sourceID,
                const style::UpdateParameters&,
-               const Tileset&);
+               const Tileset&,
+               std::shared_ptr<VectorTileDataCache> = nullptr,
+               std::shared_ptr<MetatileFileSource> = nullptr);
 
     void setNecessity(Necessity) final;
+    void setPriority(Priority) final;
+    bool isLoading() const final;
     void setData(std::shared_ptr<const std::string> data,
                  optional<Timestamp> modified,
                  optional<Timestamp> expires);
 
 private:
+    // Set for tilesets with metatiles. It outlives the loader's requests.
+    const std::shared_ptr<MetatileFileSource> metatileSource;
     TileLoader<VectorTile> loader;
+
+    // Set for tiles at or beyond the source's maximum zoom, which share their decoded data with
+    // the other tiles overscaled from the same source tile.
+    const std::shared_ptr<VectorTileDataCache> dataCache;
 };
 
 } // namespace mbgl
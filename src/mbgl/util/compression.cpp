@@ -1,10 +1,17 @@
 #include <mbgl/util/compression.hpp>
+#include <mbgl/util/instrumentation.hpp>
+#include <mbgl/util/thread_local.hpp>
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 // Check zlib library version.
 const static bool zlibVersionCheck __attribute__((unused)) = []() {
@@ -22,74 +29,245 @@ const static bool zlibVersionCheck __attribute__((unused)) = []() {
 namespace mbgl {
 namespace util {
 
-std::string compress(const std::string &raw) {
-    z_stream deflate_stream;
-    memset(&deflate_stream, 0, sizeof(deflate_stream));
+namespace {
 
-    // TODO: reuse z_streams
-    if (deflateInit(&deflate_stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("failed to initialize deflate");
+// Each thread keeps one stream per direction, and resets it between uses, so that zlib's window
+// and state aren't allocated and freed anew for every tile or resource.
+template <class Stream>
+Stream& threadStream() {
+    // Deletes each thread's stream when the thread exits.
+    static ThreadLocal<Stream>& streams = *new ThreadLocal<Stream>;
+
+    Stream* stream = streams.get();
+    if (!stream) {
+        stream = new Stream;
+        streams.set(stream);
+    } else {
+        stream->reset();
     }
+    return *stream;
+}
 
-    deflate_stream.next_in = (Bytef *)raw.data();
-    deflate_stream.avail_in = uInt(raw.size());
+class Deflater {
+public:
+    Deflater() {
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            throw std::runtime_error("failed to initialize deflate");
+        }
+    }
 
-    std::string result;
-    char out[16384];
+    ~Deflater() {
+        deflateEnd(&stream);
+    }
 
-    int code;
-    do {
-        deflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        deflate_stream.avail_out = sizeof(out);
-        code = deflate(&deflate_stream, Z_FINISH);
-        if (result.size() < deflate_stream.total_out) {
-            // append the block to the output string
-            result.append(out, deflate_stream.total_out - result.size());
+    void reset() {
+        if (deflateReset(&stream) != Z_OK) {
+            throw std::runtime_error("failed to reset deflate");
         }
-    } while (code == Z_OK);
+    }
 
-    deflateEnd(&deflate_stream);
+    z_stream stream;
+};
 
-    if (code != Z_STREAM_END) {
-        throw std::runtime_error(deflate_stream.msg);
+class Inflater {
+public:
+    Inflater() {
+        memset(&stream, 0, sizeof(stream));
+        // Accepts both zlib and gzip streams.
+        if (inflateInit2(&stream, 32 + MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("failed to initialize inflate");
+        }
     }
 
-    return result;
+    ~Inflater() {
+        inflateEnd(&stream);
+    }
+
+    void reset() {
+        if (inflateReset(&stream) != Z_OK) {
+            throw std::runtime_error("failed to reset inflate");
+        }
+    }
+
+    z_stream stream;
+};
+
+// How much room to make for the output of inflating `size` bytes: the exact size for gzip
+// streams, which record it in their trailer, and a guess for zlib streams. Vector tiles
+// typically compress to a third or a quarter of their size.
+std::size_t inflatedSizeHint(const char* raw, std::size_t size) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(raw);
+    if (size >= 18 && bytes[0] == 0x1f && bytes[1] == 0x8b) {
+        const uint8_t* trailer = bytes + size - 4;
+        const std::size_t hint = std::size_t(trailer[0]) | std::size_t(trailer[1]) << 8 |
+                                 std::size_t(trailer[2]) << 16 | std::size_t(trailer[3]) << 24;
+        // The trailer holds the size modulo 2^32; don't trust it blindly.
+        if (hint > 0 && hint / 1024 <= size) {
+            return hint;
+        }
+    }
+    return std::max<std::size_t>(size * 4, 16384);
 }
 
-std::string decompress(const std::string &raw) {
-    z_stream inflate_stream;
-    memset(&inflate_stream, 0, sizeof(inflate_stream));
+std::string compressWith(const std::string& raw, const std::string* dictionary) {
+    z_stream& deflate_stream = threadStream<Deflater>().stream;
 
-    // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
-        throw std::runtime_error("failed to initialize inflate");
+    if (dictionary &&
+        deflateSetDictionary(&deflate_stream, reinterpret_cast<const Bytef*>(dictionary->data()),
+                             uInt(dictionary->size())) != Z_OK) {
+        throw std::runtime_error("failed to set the compression dictionary");
     }
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+    deflate_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(raw.data()));
+    deflate_stream.avail_in = uInt(raw.size());
 
     std::string result;
-    char out[15384];
+    result.resize(deflateBound(&deflate_stream, uLong(raw.size())));
+
+    deflate_stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+    deflate_stream.avail_out = uInt(result.size());
+
+    // The output buffer is large enough for the whole stream, so this finishes in one call.
+    const int code = deflate(&deflate_stream, Z_FINISH);
+    if (code != Z_STREAM_END) {
+        throw std::runtime_error(deflate_stream.msg ? deflate_stream.msg : "compression error");
+    }
+
+    result.resize(deflate_stream.total_out);
+    return result;
+}
+
+void decompressWith(const char* raw, std::size_t size, std::string& result, const std::string* dictionary) {
+    Instrumentation::Timer timer(Instrumentation::Counter::Decompression);
+    z_stream& inflate_stream = threadStream<Inflater>().stream;
+
+    inflate_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(raw));
+    inflate_stream.avail_in = uInt(size);
+
+    // Inflate straight into the result, growing it as needed, rather than through a separate
+    // buffer. Whatever capacity the result already has is reused.
+    result.resize(std::max(inflatedSizeHint(raw, size), result.capacity()));
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
+        if (inflate_stream.total_out == result.size()) {
+            result.resize(result.size() * 2);
+        }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(&result[inflate_stream.total_out]);
+        inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
         code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (code == Z_NEED_DICT && dictionary) {
+            if (inflateSetDictionary(&inflate_stream, reinterpret_cast<const Bytef*>(dictionary->data()),
+                                     uInt(dictionary->size())) != Z_OK) {
+                throw std::runtime_error("wrong decompression dictionary");
+            }
+            code = Z_OK;
         }
     } while (code == Z_OK);
 
-    inflateEnd(&inflate_stream);
-
     if (code != Z_STREAM_END) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
+    result.resize(inflate_stream.total_out);
+}
+
+} // namespace
+
+std::string compress(const std::string& raw) {
+    return compressWith(raw, nullptr);
+}
+
+std::string decompress(const std::string &raw) {
+    return decompress(raw.data(), raw.size());
+}
+
+std::string decompress(const char* raw, std::size_t size) {
+    std::string result;
+    decompress(raw, size, result);
     return result;
 }
+
+void decompress(const char* raw, std::size_t size, std::string& result) {
+    decompressWith(raw, size, result, nullptr);
+}
+
+std::string compressWithDictionary(const std::string& raw, const std::string& dictionary) {
+    return compressWith(raw, &dictionary);
+}
+
+std::string decompressWithDictionary(const char* raw, std::size_t size, const std::string& dictionary) {
+    std::string result;
+    decompressWith(raw, size, result, &dictionary);
+    return result;
+}
+
+std::string trainDictionary(const std::vector<std::string>& samples) {
+    // Sequences of this many bytes are the unit that's shared, or not.
+    const std::size_t length = 8;
+    // Deflate only looks back this far, so there's no use in bigger dictionaries.
+    const std::size_t maximumSize = 32 * 1024;
+
+    auto sequence = [&] (const std::string& sample, std::size_t position) {
+        uint64_t value;
+        memcpy(&value, sample.data() + position, length);
+        return value;
+    };
+
+    // The number of samples each sequence occurs in, and the last of them.
+    std::unordered_map<uint64_t, std::pair<std::size_t, std::size_t>> occurrences;
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        for (std::size_t j = 0; j + length <= samples[i].size(); ++j) {
+            auto& occurrence = occurrences[sequence(samples[i], j)];
+            if (occurrence.first == 0 || occurrence.second != i) {
+                occurrence.first++;
+                occurrence.second = i;
+            }
+        }
+    }
+
+    // The runs of shared sequences in the samples, with the number of samples they occur in.
+    std::vector<std::pair<std::size_t, std::string>> parts;
+    std::unordered_set<std::string> seen;
+    for (const std::string& sample : samples) {
+        std::size_t j = 0;
+        while (j + length <= sample.size()) {
+            std::size_t shared = occurrences[sequence(sample, j)].first;
+            if (shared < 2) {
+                j++;
+                continue;
+            }
+            const std::size_t start = j;
+            while (j + 1 + length <= sample.size() && occurrences[sequence(sample, j + 1)].first >= 2) {
+                shared = std::max(shared, occurrences[sequence(sample, ++j)].first);
+            }
+            std::string part = sample.substr(start, j + length - start);
+            if (seen.insert(part).second) {
+                parts.emplace_back(shared, std::move(part));
+            }
+            j += length;
+        }
+    }
+
+    // Deflate finds matches at the end of the dictionary with the shortest distances, so the
+    // most widely shared parts go last, and the least widely shared ones are left out first.
+    std::stable_sort(parts.begin(), parts.end(), [] (const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+    std::size_t size = 0;
+    std::size_t count = 0;
+    while (count < parts.size() && size + parts[count].second.size() <= maximumSize) {
+        size += parts[count++].second.size();
+    }
+
+    std::string dictionary;
+    dictionary.reserve(size);
+    for (std::size_t i = count; i > 0; --i) {
+        dictionary += parts[i - 1].second;
+    }
+    return dictionary;
+}
+
 } // namespace util
 } // namespace mbgl
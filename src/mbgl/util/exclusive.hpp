@@ -7,10 +7,11 @@
 namespace mbgl {
 namespace util {
 
-template <class T>
+// A pointer that holds `Lock` for as long as it lives.
+template <class T, class Lock = std::lock_guard<std::mutex>>
 class exclusive {
 public:
-    exclusive(T* val, std::unique_ptr<std::lock_guard<std::mutex>> mtx) : ptr(val), lock(std::move(mtx)) {}
+    exclusive(T* val, std::unique_ptr<Lock> mtx) : ptr(val), lock(std::move(mtx)) {}
 
     T* operator->() { return ptr; }
     const T* operator->() const { return ptr; }
@@ -19,7 +20,7 @@ public:
 
 private:
     T *ptr;
-    std::unique_ptr<std::lock_guard<std::mutex>> lock;
+    std::unique_ptr<Lock> lock;
 };
 
 
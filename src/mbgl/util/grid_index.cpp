@@ -2,7 +2,7 @@
 #include <mbgl/geometry/feature_index.hpp>
 #include <mbgl/math/minmax.hpp>
 
-#include <unordered_set>
+#include <limits>
 
 namespace mbgl {
 
@@ -17,12 +17,13 @@ GridIndex<T>::GridIndex(int32_t extent_, int32_t n_, int32_t padding_) :
     min(-double(padding) / n * extent),
     max(extent + double(padding) / n * extent)
     {
-        cells.resize(d * d);
     }
 
 template <class T>
 void GridIndex<T>::insert(T&& t, const BBox& bbox) {
-    size_t uid = elements.size();
+    assert(!finished());
+    assert(elements.size() < std::numeric_limits<uint32_t>::max());
+    uint32_t uid = elements.size();
 
     auto cx1 = convertToCellCoord(bbox.min.x);
     auto cy1 = convertToCellCoord(bbox.min.y);
@@ -33,40 +34,79 @@ void GridIndex<T>::insert(T&& t, const BBox& bbox) {
     for (x = cx1; x <= cx2; ++x) {
         for (y = cy1; y <= cy2; ++y) {
             cellIndex = d * y + x;
-            cells[cellIndex].push_back(uid);
+            pending.emplace_back(cellIndex, uid);
         }
     }
 
     elements.emplace_back(t, bbox);
 }
 
+template <class T>
+void GridIndex<T>::finish() {
+    if (finished()) {
+        return;
+    }
+
+    // A counting sort by cell, which keeps the uids of each cell in the order they were added.
+    cellOffsets.assign(d * d + 1, 0);
+    for (const auto& entry : pending) {
+        cellOffsets[entry.first + 1]++;
+    }
+    for (std::size_t i = 1; i < cellOffsets.size(); ++i) {
+        cellOffsets[i] += cellOffsets[i - 1];
+    }
+
+    std::vector<uint32_t> next(cellOffsets.begin(), cellOffsets.end() - 1);
+    cellUIDs.resize(pending.size());
+    for (const auto& entry : pending) {
+        cellUIDs[next[entry.first]++] = entry.second;
+    }
+
+    pending = {};
+}
+
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
+    assert(finished() || pending.empty());
+
     std::vector<T> result;
-    std::unordered_set<size_t> seenUids;
+    if (!finished()) {
+        return result;
+    }
 
     auto cx1 = convertToCellCoord(queryBBox.min.x);
     auto cy1 = convertToCellCoord(queryBBox.min.y);
     auto cx2 = convertToCellCoord(queryBBox.max.x);
     auto cy2 = convertToCellCoord(queryBBox.max.y);
 
+    // Elements that span several of the cells are only seen once; within a single cell, every
+    // element is.
+    std::vector<bool> seenUIDs;
+    if (cx1 != cx2 || cy1 != cy2) {
+        seenUIDs.resize(elements.size());
+    }
+
     int32_t x, y, cellIndex;
     for (x = cx1; x <= cx2; ++x) {
         for (y = cy1; y <= cy2; ++y) {
             cellIndex = d * y + x;
-            for (auto uid : cells[cellIndex]) {
-                if (seenUids.count(uid) == 0) {
-                    seenUids.insert(uid);
-
-                    auto& pair = elements.at(uid);
-                    auto& bbox = pair.second;
-                    if (queryBBox.min.x <= bbox.max.x &&
-                        queryBBox.min.y <= bbox.max.y &&
-                        queryBBox.max.x >= bbox.min.x &&
-                        queryBBox.max.y >= bbox.min.y) {
-
-                        result.push_back(pair.first);
+            for (uint32_t i = cellOffsets[cellIndex]; i < cellOffsets[cellIndex + 1]; ++i) {
+                const uint32_t uid = cellUIDs[i];
+                if (!seenUIDs.empty()) {
+                    if (seenUIDs[uid]) {
+                        continue;
                     }
+                    seenUIDs[uid] = true;
+                }
+
+                auto& pair = elements[uid];
+                auto& bbox = pair.second;
+                if (queryBBox.min.x <= bbox.max.x &&
+                    queryBBox.min.y <= bbox.max.y &&
+                    queryBBox.max.x >= bbox.min.x &&
+                    queryBBox.max.y >= bbox.min.y) {
+
+                    result.push_back(pair.first);
                 }
             }
         }
@@ -76,6 +116,14 @@ std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
 }
 
 
+template <class T>
+std::size_t GridIndex<T>::getMemoryUsage() const {
+    return elements.capacity() * sizeof(typename decltype(elements)::value_type) +
+           pending.capacity() * sizeof(typename decltype(pending)::value_type) +
+           cellOffsets.capacity() * sizeof(uint32_t) +
+           cellUIDs.capacity() * sizeof(uint32_t);
+}
+
 template <class T>
 int32_t GridIndex<T>::convertToCellCoord(int32_t x) const {
     return util::max(0.0, util::min(d - 1.0, std::floor(x * scale) + padding));
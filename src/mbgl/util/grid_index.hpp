@@ -3,6 +3,7 @@
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
 
+#include <cassert>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
@@ -17,11 +18,29 @@ public:
     using BBox = mapbox::geometry::box<int16_t>;
 
     void insert(T&& t, const BBox&);
+
+    // Packs the cells of all elements inserted so far into one array, after which the index can
+    // be queried but no longer inserted into. Does nothing if it's already finished.
+    void finish();
+
     std::vector<T> query(const BBox&) const;
 
+    // The memory held by the elements and cells, in bytes; not what the elements refer to.
+    std::size_t getMemoryUsage() const;
+
+    // Copies all elements of an index with the same dimensions into this one, as if they had been
+    // inserted in the same order after the existing ones. `fn` is applied to each copy first. The
+    // other index may be finished, but this one must not be.
+    template <class Fn>
+    void append(const GridIndex& other, Fn&& fn);
+
 private:
     int32_t convertToCellCoord(int32_t x) const;
 
+    bool finished() const {
+        return !cellOffsets.empty();
+    }
+
     const int32_t extent;
     const int32_t n;
     const int32_t padding;
@@ -31,8 +50,43 @@ private:
     const int32_t max;
 
     std::vector<std::pair<T, BBox>> elements;
-    std::vector<std::vector<size_t>> cells;
 
+    // Until the index is finished, the cell and uid of every cell an element covers.
+    std::vector<std::pair<uint32_t, uint32_t>> pending;
+
+    // Once it is, the uids of the elements in cell i are cellUIDs[cellOffsets[i]] up to
+    // cellUIDs[cellOffsets[i + 1]], in the order they were inserted in.
+    std::vector<uint32_t> cellOffsets;
+    std::vector<uint32_t> cellUIDs;
 };
 
+template <class T>
+template <class Fn>
+void GridIndex<T>::append(const GridIndex& other, Fn&& fn) {
+    assert(extent == other.extent && n == other.n && padding == other.padding);
+    assert(!finished());
+
+    const uint32_t offset = elements.size();
+
+    elements.reserve(elements.size() + other.elements.size());
+    for (const auto& element : other.elements) {
+        elements.push_back(element);
+        fn(elements.back().first);
+    }
+
+    if (other.finished()) {
+        pending.reserve(pending.size() + other.cellUIDs.size());
+        for (uint32_t cell = 0; cell + 1 < other.cellOffsets.size(); ++cell) {
+            for (uint32_t i = other.cellOffsets[cell]; i < other.cellOffsets[cell + 1]; ++i) {
+                pending.emplace_back(cell, other.cellUIDs[i] + offset);
+            }
+        }
+    } else {
+        pending.reserve(pending.size() + other.pending.size());
+        for (const auto& entry : other.pending) {
+            pending.emplace_back(entry.first, entry.second + offset);
+        }
+    }
+}
+
 } // namespace mbgl
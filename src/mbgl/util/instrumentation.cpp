@@ -0,0 +1,135 @@
+#include <mbgl/util/instrumentation.hpp>
+#include <mbgl/util/thread_local.hpp>
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+namespace mbgl {
+namespace util {
+
+namespace {
+
+using Totals = std::array<uint64_t, Instrumentation::CounterCount>;
+
+struct ThreadCounters;
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<const ThreadCounters*> threads;
+
+    // What threads that have exited counted.
+    Totals counts {};
+    Totals nanoseconds {};
+};
+
+Registry& registry() {
+    // Leaked, so that threads exiting during static destruction can still retire their counters.
+    static Registry& instance = *new Registry;
+    return instance;
+}
+
+// The counters of one thread. Only that thread writes them, so it increments them with plain
+// loads and stores; they're atomic only so that `snapshot()` may read them at the same time.
+struct ThreadCounters {
+    std::array<std::atomic<uint64_t>, Instrumentation::CounterCount> counts {};
+    std::array<std::atomic<uint64_t>, Instrumentation::CounterCount> nanoseconds {};
+
+    ThreadCounters() {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        instance.threads.push_back(this);
+    }
+
+    ~ThreadCounters() {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        for (std::size_t i = 0; i < Instrumentation::CounterCount; ++i) {
+            instance.counts[i] += counts[i].load(std::memory_order_relaxed);
+            instance.nanoseconds[i] += nanoseconds[i].load(std::memory_order_relaxed);
+        }
+        instance.threads.erase(std::find(instance.threads.begin(), instance.threads.end(), this));
+    }
+};
+
+ThreadCounters& threadCounters() {
+    // Deletes each thread's counters when the thread exits.
+    static ThreadLocal<ThreadCounters>& counters = *new ThreadLocal<ThreadCounters>;
+
+    ThreadCounters* result = counters.get();
+    if (!result) {
+        result = new ThreadCounters;
+        counters.set(result);
+    }
+    return *result;
+}
+
+void increment(std::atomic<uint64_t>& value, uint64_t amount) {
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
+constexpr std::size_t Instrumentation::CounterCount;
+
+const char* Instrumentation::name(Counter counter) {
+    switch (counter) {
+    case Counter::Layout: return "layout";
+    case Counter::Placement: return "placement";
+    case Counter::FilterEvaluation: return "filter evaluation";
+    case Counter::Decompression: return "decompression";
+    case Counter::SQLiteStatement: return "sqlite statement";
+    case Counter::HTTPRequest: return "http request";
+    case Counter::HTTPBytes: return "http bytes";
+    }
+    return "";
+}
+
+std::atomic<bool>& Instrumentation::enabled() {
+    static std::atomic<bool> instance { false };
+    return instance;
+}
+
+void Instrumentation::setEnabled(bool enabled_) {
+    enabled().store(enabled_, std::memory_order_relaxed);
+}
+
+void Instrumentation::accumulate(Counter counter, uint64_t count, Duration time) {
+    const auto index = static_cast<std::size_t>(counter);
+    ThreadCounters& counters = threadCounters();
+    increment(counters.counts[index], count);
+    increment(counters.nanoseconds[index],
+              std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+std::vector<Instrumentation::Value> Instrumentation::snapshot() {
+    Totals counts;
+    Totals nanoseconds;
+    {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        counts = instance.counts;
+        nanoseconds = instance.nanoseconds;
+        for (const ThreadCounters* thread : instance.threads) {
+            for (std::size_t i = 0; i < CounterCount; ++i) {
+                counts[i] += thread->counts[i].load(std::memory_order_relaxed);
+                nanoseconds[i] += thread->nanoseconds[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<Value> result;
+    result.reserve(CounterCount);
+    for (std::size_t i = 0; i < CounterCount; ++i) {
+        Value value;
+        value.counter = static_cast<Counter>(i);
+        value.name = name(value.counter);
+        value.count = counts[i];
+        value.time = std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(nanoseconds[i]));
+        result.push_back(value);
+    }
+    return result;
+}
+
+} // namespace util
+} // namespace mbgl
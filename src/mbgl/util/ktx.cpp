@@ -0,0 +1,107 @@
+#include <mbgl/util/ktx.hpp>
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace mbgl {
+
+namespace {
+
+constexpr std::array<uint8_t, 12> identifier = {{
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+}};
+
+// The fields that follow the identifier, in the endianness of the writer.
+struct Header {
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+constexpr uint32_t sameEndianness = 0x04030201;
+constexpr uint32_t swappedEndianness = 0x01020304;
+
+uint32_t swap(uint32_t value) {
+    return ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) |
+           ((value >> 8) & 0xFF00) | (value >> 24);
+}
+
+} // namespace
+
+bool isKTX(const std::string& data) {
+    return data.size() >= identifier.size() &&
+           std::memcmp(data.data(), identifier.data(), identifier.size()) == 0;
+}
+
+CompressedImage decodeKTX(const std::string& data) {
+    if (!isKTX(data) || data.size() < identifier.size() + sizeof(Header)) {
+        throw std::runtime_error("not a KTX texture");
+    }
+
+    std::array<uint32_t, sizeof(Header) / sizeof(uint32_t)> fields;
+    std::memcpy(fields.data(), data.data() + identifier.size(), sizeof(Header));
+    const bool swapped = fields[0] == swappedEndianness;
+    if (swapped) {
+        for (auto& field : fields) {
+            field = swap(field);
+        }
+    }
+
+    Header header;
+    std::memcpy(&header, fields.data(), sizeof(Header));
+    if (header.endianness != sameEndianness) {
+        throw std::runtime_error("invalid KTX endianness");
+    }
+
+    // Compressed textures have neither a type nor a format, only an internal format.
+    if (header.glType != 0 || header.glFormat != 0) {
+        throw std::runtime_error("KTX texture isn't compressed");
+    }
+    if (header.pixelDepth > 1 || header.numberOfArrayElements != 0 || header.numberOfFaces != 1) {
+        throw std::runtime_error("KTX texture isn't a 2D texture");
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 ||
+        header.pixelWidth > std::numeric_limits<uint16_t>::max() ||
+        header.pixelHeight > std::numeric_limits<uint16_t>::max()) {
+        throw std::runtime_error("invalid KTX texture size");
+    }
+
+    // The key/value pairs are followed by the size of the base level, and its data.
+    std::size_t offset = identifier.size() + sizeof(Header);
+    if (header.bytesOfKeyValueData > data.size() - offset ||
+        data.size() - offset - header.bytesOfKeyValueData < sizeof(uint32_t)) {
+        throw std::runtime_error("truncated KTX texture");
+    }
+    offset += header.bytesOfKeyValueData;
+
+    uint32_t imageSize;
+    std::memcpy(&imageSize, data.data() + offset, sizeof(uint32_t));
+    if (swapped) {
+        imageSize = swap(imageSize);
+    }
+    offset += sizeof(uint32_t);
+    if (imageSize == 0 || imageSize > data.size() - offset) {
+        throw std::runtime_error("truncated KTX texture");
+    }
+
+    CompressedImage image;
+    image.format = header.glInternalFormat;
+    image.width = header.pixelWidth;
+    image.height = header.pixelHeight;
+    image.data = data.substr(offset, imageSize);
+    return image;
+}
+
+} // namespace mbgl
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace mbgl {
+
+// The base level of a texture in a format that GPUs decode themselves, such as ETC2, ASTC or BC,
+// which takes a fraction of the memory of a decoded image. Like the decoded images, textures with
+// alpha are expected to be premultiplied.
+class CompressedImage {
+public:
+    uint32_t format = 0; // The OpenGL internal format.
+    uint16_t width = 0;
+    uint16_t height = 0;
+    std::string data;
+
+    std::size_t size() const { return data.size(); }
+};
+
+// Whether the data is a KTX container, see https://www.khronos.org/opengles/sdk/tools/KTX/.
+bool isKTX(const std::string&);
+
+// Reads the base level of a compressed 2D texture from a KTX container. Throws if the data isn't
+// one, or holds an uncompressed, 3D, array or cube map texture.
+CompressedImage decodeKTX(const std::string&);
+
+} // namespace mbgl
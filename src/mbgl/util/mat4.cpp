@@ -304,35 +304,17 @@ void scale(mat4& out, const mat4& a, double x, double y, double z) {
 }
 
 void multiply(mat4& out, const mat4& a, const mat4& b) {
-    double a00 = a[0], a01 = a[1], a02 = a[2], a03 = a[3],
-          a10 = a[4], a11 = a[5], a12 = a[6], a13 = a[7],
-          a20 = a[8], a21 = a[9], a22 = a[10], a23 = a[11],
-          a30 = a[12], a31 = a[13], a32 = a[14], a33 = a[15];
-
-    // Cache only the current line of the second matrix
-    double b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3];
-    out[0] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[1] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[2] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[3] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
-
-    b0 = b[4]; b1 = b[5]; b2 = b[6]; b3 = b[7];
-    out[4] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[5] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[6] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[7] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
-
-    b0 = b[8]; b1 = b[9]; b2 = b[10]; b3 = b[11];
-    out[8] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[9] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[10] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[11] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
-
-    b0 = b[12]; b1 = b[13]; b2 = b[14]; b3 = b[15];
-    out[12] = b0 * a00 + b1 * a10 + b2 * a20 + b3 * a30;
-    out[13] = b0 * a01 + b1 * a11 + b2 * a21 + b3 * a31;
-    out[14] = b0 * a02 + b1 * a12 + b2 * a22 + b3 * a32;
-    out[15] = b0 * a03 + b1 * a13 + b2 * a23 + b3 * a33;
+    // Each column of the product combines the columns of a. The rows of a column are computed
+    // together, which compilers turn into vector operations, into a temporary since out may be
+    // either a or b.
+    mat4 result;
+    for (std::size_t j = 0; j < 16; j += 4) {
+        const double b0 = b[j], b1 = b[j + 1], b2 = b[j + 2], b3 = b[j + 3];
+        for (std::size_t i = 0; i < 4; i++) {
+            result[j + i] = b0 * a[i] + b1 * a[4 + i] + b2 * a[8 + i] + b3 * a[12 + i];
+        }
+    }
+    out = result;
 }
 
 void transformMat4(vec4& out, const vec4& a, const mat4& m) {
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <mbgl/map/memory_report.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace mbgl {
+
+// The memory an object holds on to, in bytes: on the heap, and in buffers and textures of the
+// OpenGL context. These are estimates; they count what containers have reserved, but not the
+// allocators' own overhead. The same as the usages of Map::getMemoryReport().
+using MemoryUsage = MemoryReport::Usage;
+
+namespace util {
+
+template <class T>
+std::size_t memoryUsage(const std::vector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+// The size of an uploaded vertex or index buffer, if any.
+template <class Buffer>
+std::size_t bufferMemoryUsage(const optional<Buffer>& buffer) {
+    return buffer ? buffer->buffer.getSize() : 0;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,60 @@
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+MonotonicArena::MonotonicArena(std::size_t initialChunkSize)
+    : nextChunkSize(initialChunkSize) {
+}
+
+void* MonotonicArena::allocate(std::size_t size, std::size_t alignment) {
+    // Chunks come from operator new[], which aligns them for any fundamental type.
+    assert(alignment <= alignof(std::max_align_t) && (alignment & (alignment - 1)) == 0);
+
+    auto address = reinterpret_cast<std::uintptr_t>(cursor);
+    std::size_t padding = (alignment - address % alignment) % alignment;
+
+    if (!cursor || padding + size > static_cast<std::size_t>(end - cursor)) {
+        addChunk(size);
+        padding = 0;
+    }
+
+    char* result = cursor + padding;
+    cursor = result + size;
+    allocated += size;
+    return result;
+}
+
+void MonotonicArena::addChunk(std::size_t minimumSize) {
+    const std::size_t size = std::max(nextChunkSize, minimumSize);
+    chunks.push_back({ std::unique_ptr<char[]>(new char[size]), size });
+    cursor = chunks.back().data.get();
+    end = cursor + size;
+    nextChunkSize = size * 2;
+}
+
+void MonotonicArena::reset() {
+    allocated = 0;
+
+    if (chunks.empty()) {
+        return;
+    }
+
+    auto largest = std::max_element(chunks.begin(), chunks.end(), [] (const Chunk& a, const Chunk& b) {
+        return a.size < b.size;
+    });
+
+    Chunk kept = std::move(*largest);
+    chunks.clear();
+    chunks.push_back(std::move(kept));
+
+    cursor = chunks.back().data.get();
+    end = cursor + chunks.back().size;
+}
+
+} // namespace util
+} // namespace mbgl
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace util {
+
+// Destroys an object that was constructed in a MonotonicArena, without freeing its memory,
+// which belongs to the arena.
+template <class T>
+class ArenaDeleter {
+public:
+    ArenaDeleter() = default;
+
+    template <class U, class = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    ArenaDeleter(const ArenaDeleter<U>&) {}
+
+    void operator()(T* ptr) const {
+        ptr->~T();
+    }
+};
+
+template <class T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+// Hands out memory by bumping a pointer through chunks that are only ever freed all at once,
+// when the arena is reset or destroyed. Meant for scratch data that is created in bulk and
+// dies together, e.g. during the layout of a tile. Not thread-safe.
+class MonotonicArena : private util::noncopyable {
+public:
+    MonotonicArena(std::size_t initialChunkSize = 64 * 1024);
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    template <class T, class... Args>
+    ArenaPtr<T> make(Args&&... args) {
+        return ArenaPtr<T>(new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+    }
+
+    // Uninitialized storage for `count` trivial objects, which need no destruction.
+    template <class T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena arrays aren't destroyed");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Releases everything allocated so far at once. Objects from make() need to have been
+    // destroyed before. Keeps the largest chunk around for reuse.
+    void reset();
+
+    std::size_t bytesAllocated() const { return allocated; }
+
+private:
+    void addChunk(std::size_t minimumSize);
+
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    char* cursor = nullptr;
+    char* end = nullptr;
+    std::size_t nextChunkSize;
+    std::size_t allocated = 0;
+};
+
+} // namespace util
+} // namespace mbgl
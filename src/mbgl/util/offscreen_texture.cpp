@@ -7,10 +7,14 @@
 namespace mbgl {
 
 void OffscreenTexture::bind(gl::Context& context,
-                            std::array<uint16_t, 2> size) {
+                            std::array<uint16_t, 2> size,
+                            bool depthStencil) {
     assert(size[0] > 0 && size[1] > 0);
 
-    if (!texture || texture->size != size) {
+    // The attachments are recreated along with the framebuffer that refers to them.
+    if (!texture || texture->size != size || depthStencil != bool(depthStencilBuffer)) {
+        framebuffer = {};
+        depthStencilBuffer = {};
         texture = context.createTexture(size);
     }
 
@@ -20,6 +24,14 @@ void OffscreenTexture::bind(gl::Context& context,
         MBGL_CHECK_ERROR(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
                                                 texture->texture, 0));
 
+        if (depthStencil) {
+            depthStencilBuffer = context.createRenderbuffer(gl::RenderbufferType::DepthStencil, size);
+            MBGL_CHECK_ERROR(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                                       GL_RENDERBUFFER, *depthStencilBuffer));
+            MBGL_CHECK_ERROR(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT,
+                                                       GL_RENDERBUFFER, *depthStencilBuffer));
+        }
+
         GLenum status = MBGL_CHECK_ERROR(glCheckFramebufferStatus(GL_FRAMEBUFFER));
         if (status != GL_FRAMEBUFFER_COMPLETE) {
             switch (status) {
@@ -10,7 +10,9 @@ class Context;
 
 class OffscreenTexture {
 public:
-    void bind(gl::Context&, std::array<uint16_t, 2> size);
+    // With `depthStencil`, the framebuffer gets a depth and stencil buffer too, so that layers
+    // can be rendered into the texture the same way as into the view's framebuffer.
+    void bind(gl::Context&, std::array<uint16_t, 2> size, bool depthStencil = false);
 
     gl::Texture& getTexture();
     std::array<uint16_t, 2> getSize() const;
@@ -18,6 +20,7 @@ public:
 private:
     optional<gl::UniqueFramebuffer> framebuffer;
     optional<gl::Texture> texture;
+    optional<gl::UniqueRenderbuffer> depthStencilBuffer;
 };
 
 } // namespace mbgl
@@ -1,28 +1,164 @@
 #include <mbgl/util/premultiply.hpp>
 
+#include <algorithm>
 #include <cmath>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace mbgl {
 namespace util {
 
-PremultipliedImage premultiply(UnassociatedImage&& src) {
-    PremultipliedImage dst;
+namespace {
 
-    dst.width = src.width;
-    dst.height = src.height;
-    dst.data = std::move(src.data);
+// Both directions are exact: they give the same results whether or not vector instructions are
+// used, with components above the alpha of a premultiplied pixel clamped to 255.
+
+#if defined(__SSE2__)
+
+// (x + 1 + (x >> 8)) >> 8 is x / 255 for the products of two bytes, plus 127.
+__m128i premultiply2(__m128i pixels) {
+    const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+                                              _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i x = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(127));
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+// The quotients of single precision divisions are exact enough to truncate.
+__m128i unpremultiply1(__m128i pixel) {
+    const __m128i alpha = _mm_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i numerator = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(pixel, 8), pixel),
+                                            _mm_srli_epi32(alpha, 1));
+    return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(numerator), _mm_cvtepi32_ps(alpha)));
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+uint8x16_t premultiply16(uint8x16_t component, uint8x16_t alpha) {
+    const uint16x8_t bias = vdupq_n_u16(127);
+    const uint16x8_t one = vdupq_n_u16(1);
+    uint16x8_t low = vmlal_u8(bias, vget_low_u8(component), vget_low_u8(alpha));
+    uint16x8_t high = vmlal_u8(bias, vget_high_u8(component), vget_high_u8(alpha));
+    low = vsraq_n_u16(vaddq_u16(low, one), low, 8);
+    high = vsraq_n_u16(vaddq_u16(high, one), high, 8);
+    return vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8));
+}
+
+uint16x4_t divide4(uint16x4_t numerator, uint16x4_t denominator) {
+    const float32x4_t quotient = vdivq_f32(vcvtq_f32_u32(vmovl_u16(numerator)),
+                                           vcvtq_f32_u32(vmovl_u16(denominator)));
+    return vqmovn_u32(vcvtq_u32_f32(quotient));
+}
+
+uint8x8_t unpremultiply8(uint8x8_t component, uint8x8_t alpha) {
+    const uint16x8_t numerator = vmlal_u8(vmovl_u8(vshr_n_u8(alpha, 1)), component, vdup_n_u8(255));
+    const uint16x8_t denominator = vmovl_u8(alpha);
+    return vqmovn_u16(vcombine_u16(divide4(vget_low_u16(numerator), vget_low_u16(denominator)),
+                                   divide4(vget_high_u16(numerator), vget_high_u16(denominator))));
+}
+
+uint8x16_t unpremultiply16(uint8x16_t component, uint8x16_t alpha) {
+    const uint8x16_t result = vcombine_u8(unpremultiply8(vget_low_u8(component), vget_low_u8(alpha)),
+                                          unpremultiply8(vget_high_u8(component), vget_high_u8(alpha)));
+    return vbslq_u8(vceqzq_u8(alpha), component, result);
+}
+
+#endif
+
+} // namespace
+
+void premultiply(uint8_t* data, std::size_t count) {
+    std::size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int32_t>(0xFF000000u));
+    for (; count - i >= 4; i += 4) {
+        __m128i* dest = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i pixels = _mm_loadu_si128(dest);
+        const __m128i result = _mm_packus_epi16(premultiply2(_mm_unpacklo_epi8(pixels, zero)),
+                                                premultiply2(_mm_unpackhi_epi8(pixels, zero)));
+        _mm_storeu_si128(dest, _mm_or_si128(_mm_andnot_si128(alphaMask, result),
+                                            _mm_and_si128(alphaMask, pixels)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; count - i >= 16; i += 16) {
+        uint8x16x4_t pixels = vld4q_u8(data + i * 4);
+        pixels.val[0] = premultiply16(pixels.val[0], pixels.val[3]);
+        pixels.val[1] = premultiply16(pixels.val[1], pixels.val[3]);
+        pixels.val[2] = premultiply16(pixels.val[2], pixels.val[3]);
+        vst4q_u8(data + i * 4, pixels);
+    }
+#endif
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.size(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
+    for (; i < count; i++) {
+        uint8_t& r = data[i * 4 + 0];
+        uint8_t& g = data[i * 4 + 1];
+        uint8_t& b = data[i * 4 + 2];
+        uint8_t& a = data[i * 4 + 3];
         r = (r * a + 127) / 255;
         g = (g * a + 127) / 255;
         b = (b * a + 127) / 255;
     }
+}
+
+void unpremultiply(uint8_t* data, std::size_t count) {
+    std::size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int32_t>(0xFF000000u));
+    for (; count - i >= 4; i += 4) {
+        __m128i* dest = reinterpret_cast<__m128i*>(data + i * 4);
+        const __m128i pixels = _mm_loadu_si128(dest);
+        const __m128i low = _mm_unpacklo_epi8(pixels, zero);
+        const __m128i high = _mm_unpackhi_epi8(pixels, zero);
+        const __m128i result = _mm_packus_epi16(
+            _mm_packs_epi32(unpremultiply1(_mm_unpacklo_epi16(low, zero)),
+                            unpremultiply1(_mm_unpackhi_epi16(low, zero))),
+            _mm_packs_epi32(unpremultiply1(_mm_unpacklo_epi16(high, zero)),
+                            unpremultiply1(_mm_unpackhi_epi16(high, zero))));
+
+        // Alpha is kept, and so are the pixels where it's zero.
+        const __m128i keep = _mm_or_si128(alphaMask,
+            _mm_cmpeq_epi32(_mm_and_si128(pixels, alphaMask), zero));
+        _mm_storeu_si128(dest, _mm_or_si128(_mm_andnot_si128(keep, result),
+                                            _mm_and_si128(keep, pixels)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; count - i >= 16; i += 16) {
+        uint8x16x4_t pixels = vld4q_u8(data + i * 4);
+        pixels.val[0] = unpremultiply16(pixels.val[0], pixels.val[3]);
+        pixels.val[1] = unpremultiply16(pixels.val[1], pixels.val[3]);
+        pixels.val[2] = unpremultiply16(pixels.val[2], pixels.val[3]);
+        vst4q_u8(data + i * 4, pixels);
+    }
+#endif
+
+    for (; i < count; i++) {
+        uint8_t& r = data[i * 4 + 0];
+        uint8_t& g = data[i * 4 + 1];
+        uint8_t& b = data[i * 4 + 2];
+        uint8_t& a = data[i * 4 + 3];
+        if (a) {
+            r = std::min(255, (255 * r + (a / 2)) / a);
+            g = std::min(255, (255 * g + (a / 2)) / a);
+            b = std::min(255, (255 * b + (a / 2)) / a);
+        }
+    }
+}
+
+PremultipliedImage premultiply(UnassociatedImage&& src) {
+    PremultipliedImage dst;
+
+    dst.width = src.width;
+    dst.height = src.height;
+    dst.data = std::move(src.data);
 
+    premultiply(dst.data.get(), dst.size() / 4);
     return dst;
 }
 
@@ -33,19 +169,7 @@ UnassociatedImage unpremultiply(PremultipliedImage&& src) {
     dst.height = src.height;
     dst.data = std::move(src.data);
 
-    uint8_t* data = dst.data.get();
-    for (size_t i = 0; i < dst.size(); i += 4) {
-        uint8_t& r = data[i + 0];
-        uint8_t& g = data[i + 1];
-        uint8_t& b = data[i + 2];
-        uint8_t& a = data[i + 3];
-        if (a) {
-            r = (255 * r + (a / 2)) / a;
-            g = (255 * g + (a / 2)) / a;
-            b = (255 * b + (a / 2)) / a;
-        }
-    }
-
+    unpremultiply(dst.data.get(), dst.size() / 4);
     return dst;
 }
 
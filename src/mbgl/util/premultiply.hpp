@@ -2,11 +2,19 @@
 
 #include <mbgl/util/image.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace mbgl {
 namespace util {
 
 PremultipliedImage premultiply(UnassociatedImage&&);
 UnassociatedImage unpremultiply(PremultipliedImage&&);
 
+// Convert `count` RGBA pixels in place, e.g. the rows of an image as they're decoded. Uses SSE2
+// or NEON where available.
+void premultiply(uint8_t* data, std::size_t count);
+void unpremultiply(uint8_t* data, std::size_t count);
+
 } // namespace util
 } // namespace mbgl
@@ -0,0 +1,196 @@
+#include <mbgl/util/startup_trace.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+namespace mbgl {
+
+namespace {
+
+struct Buffer {
+    std::mutex mutex;
+    TimePoint start;
+    std::vector<StartupTrace::Span> spans;
+    bool frame = false;
+};
+
+Buffer& buffer() {
+    // Leaked, so that spans may be recorded by threads that outlive static destruction.
+    static Buffer& instance = *new Buffer;
+    return instance;
+}
+
+double milliseconds(Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+std::atomic<bool>& StartupTrace::enabled() {
+    static std::atomic<bool> instance { false };
+    return instance;
+}
+
+void StartupTrace::setEnabled(bool enabled_) {
+    if (enabled_) {
+        Buffer& instance = buffer();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        instance.start = Clock::now();
+        instance.spans.clear();
+        instance.frame = false;
+    }
+    enabled().store(enabled_, std::memory_order_relaxed);
+}
+
+void StartupTrace::record(std::string name, TimePoint begin, TimePoint end,
+                          std::vector<std::string> dependencies) {
+    if (!isEnabled()) {
+        return;
+    }
+    Buffer& instance = buffer();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    instance.spans.push_back({ std::move(name), begin, end, std::move(dependencies) });
+}
+
+void StartupTrace::frame(TimePoint begin, TimePoint end) {
+    if (!isEnabled()) {
+        return;
+    }
+    Buffer& instance = buffer();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    if (instance.frame) {
+        return;
+    }
+    instance.frame = true;
+
+    std::vector<std::string> dependencies;
+    for (const auto& span : instance.spans) {
+        if (std::find(dependencies.begin(), dependencies.end(), span.name) == dependencies.end()) {
+            dependencies.push_back(span.name);
+        }
+    }
+    instance.spans.push_back({ "first frame", begin, end, std::move(dependencies) });
+}
+
+StartupTrace::Scope::Scope(std::string name_, std::vector<std::string> dependencies_)
+    : name(std::move(name_)),
+      dependencies(std::move(dependencies_)),
+      begin(Clock::now()),
+      active(isEnabled()) {
+}
+
+StartupTrace::Scope::~Scope() {
+    if (active) {
+        record(name, begin, Clock::now(), dependencies);
+    }
+}
+
+std::vector<StartupTrace::Span> StartupTrace::spans() {
+    std::vector<Span> result;
+    {
+        Buffer& instance = buffer();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        result = instance.spans;
+    }
+    std::stable_sort(result.begin(), result.end(), [] (const Span& a, const Span& b) {
+        return a.end < b.end;
+    });
+    return result;
+}
+
+std::vector<StartupTrace::Step> StartupTrace::criticalPath() {
+    TimePoint start;
+    bool hasFrame;
+    {
+        Buffer& instance = buffer();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        start = instance.start;
+        hasFrame = instance.frame;
+    }
+    const std::vector<Span> all = spans();
+    if (all.empty()) {
+        return {};
+    }
+
+    // Spans are sorted by their ends, so a span's dependencies that ended before it did come
+    // before it, and following them can't loop.
+    std::vector<std::size_t> path;
+    std::size_t current = all.size() - 1;
+    if (hasFrame) {
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            if (all[i].name == "first frame") {
+                current = i;
+            }
+        }
+    }
+    while (true) {
+        path.push_back(current);
+        const Span& span = all[current];
+        optional<std::size_t> gating;
+        for (std::size_t i = 0; i < current; ++i) {
+            const auto& dependencies = span.dependencies;
+            if (std::find(dependencies.begin(), dependencies.end(), all[i].name) != dependencies.end()) {
+                gating = i;
+            }
+        }
+        if (!gating) {
+            break;
+        }
+        current = *gating;
+    }
+    std::reverse(path.begin(), path.end());
+
+    std::vector<Step> result;
+    TimePoint ready = start;
+    for (std::size_t index : path) {
+        Step step;
+        step.span = all[index];
+        step.wait = std::max(Duration::zero(), step.span.begin - ready);
+        step.self = std::max(Duration::zero(), step.span.end - std::max(step.span.begin, ready));
+        ready = step.span.end;
+        result.push_back(std::move(step));
+    }
+    return result;
+}
+
+std::string StartupTrace::report() {
+    TimePoint start;
+    {
+        Buffer& instance = buffer();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        start = instance.start;
+    }
+
+    std::string result;
+    char line[256];
+
+    std::snprintf(line, sizeof(line), "%10s %10s %10s  %s\n", "begin", "end", "duration", "span");
+    result += line;
+    for (const auto& span : spans()) {
+        std::snprintf(line, sizeof(line), "%10.3f %10.3f %10.3f  %s\n",
+                      milliseconds(span.begin - start), milliseconds(span.end - start),
+                      milliseconds(span.end - span.begin), span.name.c_str());
+        result += line;
+    }
+
+    const std::vector<Step> path = criticalPath();
+    if (path.empty()) {
+        return result;
+    }
+    std::snprintf(line, sizeof(line), "\nCritical path to the %s, %.3f ms:\n",
+                  path.back().span.name == "first frame" ? "first frame" : "last span",
+                  milliseconds(path.back().span.end - start));
+    result += line;
+    std::snprintf(line, sizeof(line), "%10s %10s  %s\n", "wait", "self", "span");
+    result += line;
+    for (const auto& step : path) {
+        std::snprintf(line, sizeof(line), "%10.3f %10.3f  %s\n",
+                      milliseconds(step.wait), milliseconds(step.self), step.span.name.c_str());
+        result += line;
+    }
+    return result;
+}
+
+} // namespace mbgl
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    Process-wide tracing of what a map waits for before its first complete frame: opening the
+    cache database, requesting and parsing the style, requesting the TileJSON of its sources, its
+    sprite and its glyphs, and compiling the shader programs. Every span names the spans it
+    depends on, i.e. those that have to end before it can; the first frame depends on all of them.
+
+    The critical path is the chain of dependencies that ended last, back from the first frame. On
+    it, each span is charged with the time from the end of its dependency to its own end; time
+    between the two that no span accounts for, e.g. loading tiles, is reported as waiting.
+
+    Tracing is off by default, and costs one relaxed atomic load per span while it is. Enabling it
+    discards what was recorded before and restarts its clock, so it's meant to be enabled before
+    the file source and the map are created.
+*/
+class StartupTrace {
+public:
+    struct Span {
+        std::string name;
+        TimePoint begin;
+        TimePoint end;
+        std::vector<std::string> dependencies;
+    };
+
+    struct Step {
+        Span span;
+        Duration wait = Duration::zero(); // From the end of the dependency to the span's begin.
+        Duration self = Duration::zero(); // From whichever of those is later to the span's end.
+    };
+
+    static void setEnabled(bool);
+
+    static bool isEnabled() {
+        return enabled().load(std::memory_order_relaxed);
+    }
+
+    // Records a span, named like "source composite" by what it's of. Spans that depend on a name
+    // of which there are several depend on the one of them that ended last before they did.
+    static void record(std::string name, TimePoint begin, TimePoint end,
+                       std::vector<std::string> dependencies = {});
+
+    // Records the first frame that rendered the map completely once tracing was enabled, with a
+    // dependency on every span recorded before it; later frames are ignored.
+    static void frame(TimePoint begin, TimePoint end);
+
+    // Records the time from its construction to its destruction as one span, if tracing was
+    // enabled when it was constructed.
+    class Scope : private util::noncopyable {
+    public:
+        Scope(std::string name, std::vector<std::string> dependencies = {});
+        ~Scope();
+
+    private:
+        const std::string name;
+        const std::vector<std::string> dependencies;
+        const TimePoint begin;
+        const bool active;
+    };
+
+    // The spans recorded since tracing was enabled, in the order they ended in.
+    static std::vector<Span> spans();
+
+    // The critical path to the first frame, or to the span that ended last if there's no frame
+    // yet, beginning with the span it starts with.
+    static std::vector<Step> criticalPath();
+
+    // The spans and the critical path as a table, with times in milliseconds since tracing was
+    // enabled.
+    static std::string report();
+
+private:
+    static std::atomic<bool>& enabled();
+};
+
+} // namespace mbgl
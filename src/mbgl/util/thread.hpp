@@ -6,6 +6,8 @@
 #include <utility>
 #include <functional>
 
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/message.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/thread_context.hpp>
 #include <mbgl/platform/platform.hpp>
@@ -22,6 +24,10 @@ namespace util {
 // Object's .stop() function is called, and the destructor waits for thread termination. The
 // Thread<> constructor blocks until the thread and the Object are fully created, so after the
 // object creation, it's safe to obtain the Object stored in this thread.
+//
+// Invocations are delivered through a Mailbox on the thread's RunLoop, so that `invoke` in the
+// common case doesn't allocate: messages come from actor::MessagePool and are linked into the
+// mailbox's queue. All invocation methods share the mailbox, which keeps them in order.
 
 template <class Object>
 class Thread {
@@ -33,7 +39,7 @@ public:
     // Invoke object->fn(args...) asynchronously.
     template <typename Fn, class... Args>
     void invoke(Fn fn, Args&&... args) {
-        loop->invoke(bind(fn), std::forward<Args>(args)...);
+        mailbox->push(actor::makeMessage(*object, fn, std::forward<Args>(args)...));
     }
 
     // Invoke object->fn(args...) asynchronously. The final argument to fn must be a callback.
@@ -43,7 +49,9 @@ public:
     template <typename Fn, class... Args>
     std::unique_ptr<AsyncRequest>
     invokeWithCallback(Fn fn, Args&&... args) {
-        return loop->invokeWithCallback(bind(fn), std::forward<Args>(args)...);
+        std::shared_ptr<WorkTask> task = WorkTask::makeWithCallback(bind(fn), std::forward<Args>(args)...);
+        mailbox->push(actor::makeMessage(*this, &Thread::runTask, task));
+        return std::make_unique<WorkRequest>(task);
     }
 
     // Invoke object->fn(args...) asynchronously, but wait for the result.
@@ -52,7 +60,7 @@ public:
         using R = std::result_of_t<Fn(Object, Args&&...)>;
         std::packaged_task<R ()> task(std::bind(fn, object, args...));
         std::future<R> future = task.get_future();
-        loop->invoke(std::move(task));
+        mailbox->push(actor::makeMessage(*this, &Thread::runTask, WorkTask::make(std::move(task))));
         return future.get();
     }
 
@@ -72,6 +80,10 @@ private:
     template <typename P, std::size_t... I>
     void run(P&& params, std::index_sequence<I...>);
 
+    void runTask(std::shared_ptr<WorkTask> task) {
+        (*task)();
+    }
+
     std::promise<void> running;
     std::promise<void> joinable;
 
@@ -79,6 +91,7 @@ private:
 
     Object* object = nullptr;
     RunLoop* loop = nullptr;
+    std::shared_ptr<Mailbox> mailbox;
 };
 
 template <class Object>
@@ -95,6 +108,11 @@ Thread<Object>::Thread(const ThreadContext& context, Args&&... args) {
             platform::makeThreadLowPriority();
         }
 
+        if (context.numaNode) {
+            const auto nodes = platform::getNUMANodes();
+            platform::setCurrentThreadAffinity(nodes[*context.numaNode % nodes.size()]);
+        }
+
         run(std::move(params), std::index_sequence_for<Args...>{});
     });
 
@@ -110,9 +128,16 @@ void Thread<Object>::run(P&& params, std::index_sequence<I...>) {
     Object object_(std::get<I>(std::forward<P>(params))...);
     object = &object_;
 
+    mailbox = std::make_shared<Mailbox>(loop_);
+    // Like the RunLoop itself, handle a burst of invocations per wakeup, but still leave room
+    // for timers and other work on the loop.
+    mailbox->setBatchSize(64);
+
     running.set_value();
     loop_.run();
 
+    // The mailbox refers to the RunLoop, which is about to go away.
+    mailbox.reset();
     loop = nullptr;
     object = nullptr;
 
@@ -121,7 +146,8 @@ void Thread<Object>::run(P&& params, std::index_sequence<I...>) {
 
 template <class Object>
 Thread<Object>::~Thread() {
-    loop->stop();
+    // Stop via the mailbox, so that everything invoked before is still processed.
+    mailbox->push(actor::makeMessage(*loop, &RunLoop::stop));
     joinable.set_value();
     thread.join();
 }
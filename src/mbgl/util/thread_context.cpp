@@ -4,9 +4,10 @@
 namespace mbgl {
 namespace util {
 
-ThreadContext::ThreadContext(std::string name_, ThreadPriority priority_)
+ThreadContext::ThreadContext(std::string name_, ThreadPriority priority_, optional<std::size_t> numaNode_)
     : name(std::move(name_)),
-      priority(priority_) {
+      priority(priority_),
+      numaNode(std::move(numaNode_)) {
 }
 
 } // namespace util
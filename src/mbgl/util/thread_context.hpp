@@ -1,5 +1,8 @@
 #pragma once
 
+#include <mbgl/util/optional.hpp>
+
+#include <cstddef>
 #include <string>
 
 namespace mbgl {
@@ -12,10 +15,15 @@ enum class ThreadPriority : bool {
 
 struct ThreadContext {
 public:
-    ThreadContext(std::string name, ThreadPriority priority = ThreadPriority::Regular);
+    ThreadContext(std::string name,
+                  ThreadPriority priority = ThreadPriority::Regular,
+                  optional<std::size_t> numaNode = {});
 
     std::string name;
     ThreadPriority priority;
+
+    // If set, the thread is pinned to the CPUs of this NUMA node (modulo the node count).
+    optional<std::size_t> numaNode;
 };
 
 } // namespace util
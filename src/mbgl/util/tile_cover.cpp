@@ -2,8 +2,15 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/interpolate.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/util/projection.hpp>
+#include <mbgl/math/clamp.hpp>
 
+#include <cmath>
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
@@ -75,6 +82,31 @@ namespace util {
 
 namespace {
 
+struct ID {
+    int32_t x, y;
+    double sqDist;
+};
+
+// Sorts the tiles by their distance from the center, and then by x/y, and erases duplicates.
+std::vector<UnwrappedTileID> sortedTileIDs(std::vector<ID>& t, int32_t z) {
+    std::sort(t.begin(), t.end(), [](const ID& a, const ID& b) {
+        return (a.sqDist != b.sqDist) ? (a.sqDist < b.sqDist)
+                                      : ((a.x != b.x) ? (a.x < b.x) : (a.y < b.y));
+    });
+
+    // Erase duplicate tile IDs (they typically occur at the common side of both triangles).
+    t.erase(std::unique(t.begin(), t.end(), [](const ID& a, const ID& b) {
+                return a.x == b.x && a.y == b.y;
+            }), t.end());
+
+    std::vector<UnwrappedTileID> result;
+    result.reserve(t.size());
+    for (const auto& id : t) {
+        result.emplace_back(z, id.x, id.y);
+    }
+    return result;
+}
+
 std::vector<UnwrappedTileID> tileCover(const Point<double>& tl,
                                        const Point<double>& tr,
                                        const Point<double>& br,
@@ -83,11 +115,6 @@ std::vector<UnwrappedTileID> tileCover(const Point<double>& tl,
                                        int32_t z) {
     const int32_t tiles = 1 << z;
 
-    struct ID {
-        int32_t x, y;
-        double sqDist;
-    };
-
     std::vector<ID> t;
 
     auto scanLine = [&](int32_t x0, int32_t x1, int32_t y) {
@@ -107,22 +134,37 @@ std::vector<UnwrappedTileID> tileCover(const Point<double>& tl,
     scanTriangle(tl, tr, br, 0, tiles, scanLine);
     scanTriangle(br, bl, tl, 0, tiles, scanLine);
 
-    // Sort first by distance, then by x/y.
-    std::sort(t.begin(), t.end(), [](const ID& a, const ID& b) {
-        return (a.sqDist != b.sqDist) ? (a.sqDist < b.sqDist)
-                                      : ((a.x != b.x) ? (a.x < b.x) : (a.y < b.y));
-    });
+    return sortedTileIDs(t, z);
+}
 
-    // Erase duplicate tile IDs (they typically occur at the common side of both triangles).
-    t.erase(std::unique(t.begin(), t.end(), [](const ID& a, const ID& b) {
-                return a.x == b.x && a.y == b.y;
-            }), t.end());
+// The columns of the viewport's cover in each of its rows. The viewport is convex, so each row
+// is a single run of tiles.
+TileCover::Spans coverSpans(const TransformState& state, int32_t z) {
+    const int32_t tiles = 1 << z;
+    const double w = state.getWidth();
+    const double h = state.getHeight();
 
-    std::vector<UnwrappedTileID> result;
-    for (const auto& id : t) {
-        result.emplace_back(z, id.x, id.y);
-    }
-    return result;
+    TileCover::Spans spans;
+    ScanLine scanLine = [&](int32_t x0, int32_t x1, int32_t y) {
+        if (y < 0 || y > tiles || x0 >= x1) {
+            return;
+        }
+        auto it = spans.find(y);
+        if (it == spans.end()) {
+            spans.emplace(y, std::make_pair(x0, x1));
+        } else {
+            it->second.first = std::min(it->second.first, x0);
+            it->second.second = std::max(it->second.second, x1);
+        }
+    };
+
+    const auto tl = TileCoordinate::fromScreenCoordinate(state, z, { 0, 0 }).p;
+    const auto tr = TileCoordinate::fromScreenCoordinate(state, z, { w, 0 }).p;
+    const auto br = TileCoordinate::fromScreenCoordinate(state, z, { w, h }).p;
+    const auto bl = TileCoordinate::fromScreenCoordinate(state, z, { 0, h }).p;
+    scanTriangle(tl, tr, br, 0, tiles, scanLine);
+    scanTriangle(br, bl, tl, 0, tiles, scanLine);
+    return spans;
 }
 
 } // namespace
@@ -168,5 +210,195 @@ std::vector<UnwrappedTileID> tileCover(const TransformState& state, int32_t z) {
         z);
 }
 
+TileCover::Delta TileCover::update(const TransformState& state, int32_t z) {
+    Spans newSpans = coverSpans(state, z);
+    Delta delta;
+
+    auto addRange = [z] (std::vector<UnwrappedTileID>& ids, int32_t y, int32_t x0, int32_t x1) {
+        for (int32_t x = x0; x < x1; ++x) {
+            ids.emplace_back(z, x, y);
+        }
+    };
+
+    if (z != zoom) {
+        for (const auto& row : spans) {
+            for (int32_t x = row.second.first; x < row.second.second; ++x) {
+                delta.removed.emplace_back(zoom, x, row.first);
+            }
+        }
+        for (const auto& row : newSpans) {
+            addRange(delta.added, row.first, row.second.first, row.second.second);
+        }
+    } else {
+        // Both are sorted by row; compare the runs of the rows that either has.
+        auto oldRow = spans.begin();
+        auto newRow = newSpans.begin();
+        while (oldRow != spans.end() || newRow != newSpans.end()) {
+            if (newRow == newSpans.end() || (oldRow != spans.end() && oldRow->first < newRow->first)) {
+                addRange(delta.removed, oldRow->first, oldRow->second.first, oldRow->second.second);
+                ++oldRow;
+            } else if (oldRow == spans.end() || newRow->first < oldRow->first) {
+                addRange(delta.added, newRow->first, newRow->second.first, newRow->second.second);
+                ++newRow;
+            } else {
+                const int32_t y = oldRow->first;
+                const int32_t a0 = oldRow->second.first, a1 = oldRow->second.second;
+                const int32_t b0 = newRow->second.first, b1 = newRow->second.second;
+                addRange(delta.removed, y, a0, std::min(a1, b0));
+                addRange(delta.removed, y, std::max(a0, b1), a1);
+                addRange(delta.added, y, b0, std::min(b1, a0));
+                addRange(delta.added, y, std::max(b0, a1), b1);
+                ++oldRow;
+                ++newRow;
+            }
+        }
+    }
+
+    const bool zoomChanged = z != zoom;
+    zoom = z;
+    spans = std::move(newSpans);
+
+    if (!delta.empty() || zoomChanged) {
+        const TileCoordinatePoint c = TileCoordinate::fromScreenCoordinate(
+            state, z, { state.getWidth() / 2.0, state.getHeight() / 2.0 }).p;
+        std::vector<ID> t;
+        for (const auto& row : spans) {
+            for (int32_t x = row.second.first; x < row.second.second; ++x) {
+                const auto dx = x + 0.5 - c.x, dy = row.first + 0.5 - c.y;
+                t.push_back(ID{ x, row.first, dx * dx + dy * dy });
+            }
+        }
+        tiles = sortedTileIDs(t, z);
+    }
+
+    return delta;
+}
+
+void TileCover::clear() {
+    zoom = -1;
+    spans.clear();
+    tiles.clear();
+}
+
+std::vector<UnwrappedTileID> tileCoverWithLOD(const TransformState& state, int32_t z, int32_t minZ) {
+    std::vector<UnwrappedTileID> idealTiles = tileCover(state, z);
+    if (state.getPitch() == 0 || minZ >= z) {
+        return idealTiles;
+    }
+
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+
+    // The distance from the camera, along the view direction, of a point in tile units at `z`.
+    const double scale = Projection::worldSize(state.getScale()) / (1ull << z);
+    auto cameraDistance = [&] (double x, double y) {
+        vec4 projected;
+        matrix::transformMat4(projected, {{ x * scale, y * scale, 0, 1 }}, projMatrix);
+        return projected[3];
+    };
+
+    const TileCoordinatePoint center = TileCoordinate::fromScreenCoordinate(
+        state, z, { state.getWidth() / 2.0, state.getHeight() / 2.0 }).p;
+    const double centerDistance = cameraDistance(center.x, center.y);
+
+    auto ancestor = [] (const UnwrappedTileID& id, int32_t ancestorZ) {
+        return UnwrappedTileID(id.wrap, id.canonical.scaledTo(ancestorZ));
+    };
+
+    // A tile twice as far away as the center is half as large on screen, so its parent is about
+    // as large as the tiles at the center. Each ideal tile asks for the zoom level that comes
+    // closest to that; the highest one that any ideal tile within an ancestor asks for
+    // determines whether the ancestor can be used in their place.
+    std::unordered_map<UnwrappedTileID, int32_t> maxZoomWithin;
+    for (const auto& id : idealTiles) {
+        const double distance = cameraDistance(id.canonical.x + id.wrap * (1ll << z) + 0.5,
+                                               id.canonical.y + 0.5);
+        int32_t tileZ = z;
+        if (distance > 0 && centerDistance > 0) {
+            tileZ = util::clamp<int32_t>(z + std::round(std::log2(centerDistance / distance)), minZ, z);
+        }
+        for (int32_t ancestorZ = minZ; ancestorZ <= z; ++ancestorZ) {
+            auto it = maxZoomWithin.emplace(ancestor(id, ancestorZ), tileZ).first;
+            it->second = std::max(it->second, tileZ);
+        }
+    }
+
+    // Using the lowest ancestor that qualifies for each ideal tile leaves no overlaps: if an
+    // ancestor qualifies, so do all of its descendants that lead to other ideal tiles.
+    std::vector<UnwrappedTileID> result;
+    std::unordered_set<UnwrappedTileID> added;
+    for (const auto& id : idealTiles) {
+        for (int32_t ancestorZ = minZ; ancestorZ <= z; ++ancestorZ) {
+            const UnwrappedTileID tile = ancestor(id, ancestorZ);
+            if (maxZoomWithin.at(tile) <= ancestorZ) {
+                if (added.insert(tile).second) {
+                    result.push_back(tile);
+                }
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+double tileScreenArea(const mat4& matrix, const TransformState& state) {
+    using Polygon = std::vector<Point<double>>;
+
+    // The corners of the tile in normalized device coordinates.
+    Polygon polygon;
+    for (const auto& corner : { Point<double>(0, 0), Point<double>(util::EXTENT, 0),
+                                Point<double>(util::EXTENT, util::EXTENT), Point<double>(0, util::EXTENT) }) {
+        vec4 projected;
+        matrix::transformMat4(projected, {{ corner.x, corner.y, 0, 1 }}, matrix);
+        if (projected[3] <= 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        polygon.emplace_back(projected[0] / projected[3], projected[1] / projected[3]);
+    }
+
+    // Clip it to the viewport, one edge at a time.
+    auto clip = [&] (auto inside, auto intersect) {
+        Polygon result;
+        for (std::size_t i = 0; i < polygon.size(); ++i) {
+            const Point<double>& a = polygon[i];
+            const Point<double>& b = polygon[(i + 1) % polygon.size()];
+            if (inside(a)) {
+                result.push_back(a);
+            }
+            if (inside(a) != inside(b)) {
+                result.push_back(intersect(a, b));
+            }
+        }
+        polygon = std::move(result);
+    };
+    auto clipX = [&] (double x, double side) {
+        clip([=] (const Point<double>& p) { return p.x * side <= x * side; },
+             [=] (const Point<double>& a, const Point<double>& b) {
+                 return Point<double>(x, a.y + (b.y - a.y) * (x - a.x) / (b.x - a.x));
+             });
+    };
+    auto clipY = [&] (double y, double side) {
+        clip([=] (const Point<double>& p) { return p.y * side <= y * side; },
+             [=] (const Point<double>& a, const Point<double>& b) {
+                 return Point<double>(a.x + (b.x - a.x) * (y - a.y) / (b.y - a.y), y);
+             });
+    };
+    clipX(1, 1);
+    clipX(-1, -1);
+    clipY(1, 1);
+    clipY(-1, -1);
+
+    double area = 0;
+    for (std::size_t i = 0; i < polygon.size(); ++i) {
+        const Point<double>& a = polygon[i];
+        const Point<double>& b = polygon[(i + 1) % polygon.size()];
+        area += a.x * b.y - b.x * a.y;
+    }
+
+    // Normalized device coordinates span two units in each direction.
+    return std::abs(area) / 2 * (state.getWidth() / 2.0) * (state.getHeight() / 2.0);
+}
+
 } // namespace util
 } // namespace mbgl
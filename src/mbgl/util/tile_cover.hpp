@@ -3,7 +3,10 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/util/tile_coordinate.hpp>
+#include <mbgl/util/mat4.hpp>
 
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace mbgl {
@@ -18,5 +21,44 @@ int32_t coveringZoomLevel(double z, SourceType type, uint16_t tileSize);
 std::vector<UnwrappedTileID> tileCover(const TransformState&, int32_t z);
 std::vector<UnwrappedTileID> tileCover(const LatLngBounds&, int32_t z);
 
+// Like tileCover(const TransformState&, int32_t), but tiles that are further away from the camera
+// than the center of the map are replaced by their parents, down to `minZ`, so that no tile is
+// much smaller on screen than the tiles at the center. Without pitch, all tiles are at `z`.
+std::vector<UnwrappedTileID> tileCoverWithLOD(const TransformState&, int32_t z, int32_t minZ);
+
+// The cover of the viewport at one zoom level, updated as the camera moves. Only the rows of the
+// cover are compared from one update to the next, so that a move within the same tiles costs
+// little, and one that crosses tile boundaries reports just the tiles it added and removed.
+class TileCover {
+public:
+    struct Delta {
+        std::vector<UnwrappedTileID> added;
+        std::vector<UnwrappedTileID> removed;
+
+        bool empty() const { return added.empty() && removed.empty(); }
+    };
+
+    // Covers the viewport of the given state at `z`, and returns how the cover changed since the
+    // previous update. A change of zoom level removes all tiles of the previous one.
+    Delta update(const TransformState&, int32_t z);
+    void clear();
+
+    // The same tiles as tileCover(const TransformState&, int32_t) returns. They're sorted by their
+    // distance from the center of the viewport as of the last update that changed them.
+    const std::vector<UnwrappedTileID>& getTiles() const { return tiles; }
+
+    // The columns [first, second) of the cover of each row.
+    using Spans = std::map<int32_t, std::pair<int32_t, int32_t>>;
+
+private:
+    int32_t zoom = -1;
+    Spans spans;
+    std::vector<UnwrappedTileID> tiles;
+};
+
+// The area, in pixels, of the part of a tile that's inside the viewport, with `matrix` projecting
+// tile coordinates to clip space. Infinite if part of the tile is behind the camera.
+double tileScreenArea(const mat4& matrix, const TransformState&);
+
 } // namespace util
 } // namespace mbgl
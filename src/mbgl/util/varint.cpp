@@ -0,0 +1,98 @@
+#include <mbgl/util/varint.hpp>
+
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace mbgl {
+namespace util {
+
+static uint32_t decodeVarint(const char*& data, const char* end) {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 70; shift += 7) {
+        if (data == end) {
+            throw std::runtime_error("unterminated varint");
+        }
+        const auto byte = static_cast<uint8_t>(*data++);
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return static_cast<uint32_t>(value);
+        }
+    }
+    throw std::runtime_error("varint too long");
+}
+
+std::size_t decodeVarints(const char*& data, const char* end, uint32_t* out, std::size_t max) {
+    std::size_t count = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    while (max - count >= 16 && end - data >= 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+        // Zero-extend all 16 bytes; only those before the first continuation bit are kept.
+        const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i* dest = reinterpret_cast<__m128i*>(out + count);
+        _mm_storeu_si128(dest + 0, _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(dest + 1, _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(dest + 2, _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(dest + 3, _mm_unpackhi_epi16(high, zero));
+
+        const int continuation = _mm_movemask_epi8(bytes);
+        if (continuation == 0) {
+            data += 16;
+            count += 16;
+            continue;
+        }
+
+        const int singles = __builtin_ctz(continuation);
+        data += singles;
+        count += singles;
+        out[count++] = decodeVarint(data, end);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    while (max - count >= 16 && end - data >= 16) {
+        const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(data));
+        if (vmaxvq_u8(bytes) & 0x80) {
+            out[count++] = decodeVarint(data, end);
+            continue;
+        }
+
+        const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+        const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+        vst1q_u32(out + count + 0, vmovl_u16(vget_low_u16(low)));
+        vst1q_u32(out + count + 4, vmovl_u16(vget_high_u16(low)));
+        vst1q_u32(out + count + 8, vmovl_u16(vget_low_u16(high)));
+        vst1q_u32(out + count + 12, vmovl_u16(vget_high_u16(high)));
+        data += 16;
+        count += 16;
+    }
+#endif
+
+    while (count < max && data != end) {
+        out[count++] = decodeVarint(data, end);
+    }
+
+    return count;
+}
+
+bool PackedVarintReader::refill() {
+    pos = 0;
+    count = decodeVarints(data, end, buffer.data(), buffer.size());
+    return count > 0;
+}
+
+uint32_t PackedVarintReader::next() {
+    if (empty()) {
+        throw std::runtime_error("unexpected end of packed field");
+    }
+    return buffer[pos++];
+}
+
+} // namespace util
+} // namespace mbgl
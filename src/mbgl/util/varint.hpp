@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+namespace util {
+
+// Decodes up to `max` varints from [data, end) into `out`, and advances `data` past them. Returns
+// the number of values decoded. Values are truncated to 32 bits, like protozero's packed uint32
+// iterators do. Throws if the data ends in the middle of a varint.
+//
+// Where SSE2 or NEON are available, runs of single-byte varints are decoded 16 bytes at a time;
+// these make up most of the command and coordinate delta streams of vector tile geometries.
+std::size_t decodeVarints(const char*& data, const char* end, uint32_t* out, std::size_t max);
+
+// Reads the values of a packed varint field one by one, decoding them in batches.
+class PackedVarintReader {
+public:
+    PackedVarintReader(const char* begin, const char* end_)
+        : data(begin), end(end_) {
+    }
+
+    bool empty() {
+        return pos == count && !refill();
+    }
+
+    // Throws if there are no more values.
+    uint32_t next();
+
+private:
+    bool refill();
+
+    const char* data;
+    const char* const end;
+    std::size_t pos = 0;
+    std::size_t count = 0;
+    std::array<uint32_t, 64> buffer;
+};
+
+} // namespace util
+} // namespace mbgl
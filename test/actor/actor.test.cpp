@@ -10,6 +10,31 @@
 using namespace mbgl;
 using namespace std::chrono_literals;
 
+namespace {
+
+// Runs mailboxes only when asked to, on the calling thread, in the order they were scheduled in.
+struct QueueScheduler : public Scheduler {
+    std::vector<std::weak_ptr<Mailbox>> queue;
+
+    void schedule(std::weak_ptr<Mailbox> mailbox) override {
+        queue.push_back(mailbox);
+    }
+
+    // Returns the number of scheduling rounds it took to empty the queue.
+    size_t runAll() {
+        size_t rounds = 0;
+        while (!queue.empty()) {
+            auto mailbox = queue.front();
+            queue.erase(queue.begin());
+            Mailbox::maybeReceive(mailbox);
+            ++rounds;
+        }
+        return rounds;
+    }
+};
+
+} // namespace
+
 TEST(Actor, Construction) {
     // Construction is currently synchronous. It may become asynchronous in the future.
 
@@ -137,3 +162,321 @@ TEST(Actor, NonConcurrentMailbox) {
     test.invoke(&Test::end);
     endedFuture.wait();
 }
+
+TEST(Actor, Priority) {
+    // Mailboxes with a more urgent priority are processed first.
+
+    struct Test {
+        std::vector<int>& order;
+        std::future<void> future;
+
+        Test(ActorRef<Test>, std::vector<int>& order_, std::future<void> future_ = {})
+            : order(order_), future(std::move(future_)) {
+        }
+
+        void block() {
+            future.wait();
+        }
+
+        void receive(int i) {
+            order.push_back(i);
+        }
+    };
+
+    ThreadPool pool { 1 };
+
+    std::vector<int> order;
+    std::promise<void> unblockPromise;
+    Actor<Test> blocker(pool, std::ref(order), unblockPromise.get_future());
+    Actor<Test> cached(pool, std::ref(order));
+    Actor<Test> visible(pool, std::ref(order));
+    cached.setPriority(Mailbox::Priority::Cached);
+
+    // Occupy the only thread so that both messages queue up.
+    blocker.invoke(&Test::block);
+    cached.invoke(&Test::receive, 2);
+    visible.invoke(&Test::receive, 1);
+
+    std::promise<void> donePromise;
+    std::future<void> doneFuture = donePromise.get_future();
+    struct Done {
+        Done(ActorRef<Done>) {}
+        void set(std::promise<void>* promise) { promise->set_value(); }
+    };
+    Actor<Done> done(pool);
+    done.setPriority(Mailbox::Priority::Cached);
+    done.invoke(&Done::set, &donePromise);
+
+    unblockPromise.set_value();
+    doneFuture.wait();
+
+    EXPECT_EQ((std::vector<int> { 1, 2 }), order);
+}
+
+TEST(Actor, BatchedMailbox) {
+    // A mailbox with a batch size processes several messages per scheduling round.
+
+    struct Test {
+        std::vector<int> received;
+
+        Test(ActorRef<Test>) {}
+
+        void receive(int i) {
+            received.push_back(i);
+        }
+    };
+
+    QueueScheduler scheduler;
+
+    Actor<Test> unbatched(scheduler);
+    for (auto i = 0; i < 10; ++i) {
+        unbatched.invoke(&Test::receive, i);
+    }
+    EXPECT_EQ(10u, scheduler.runAll());
+
+    Actor<Test> batched(scheduler);
+    batched.setBatchSize(4);
+    for (auto i = 0; i < 10; ++i) {
+        batched.invoke(&Test::receive, i);
+    }
+    EXPECT_EQ(3u, scheduler.runAll());
+}
+
+TEST(Actor, ConcurrentProducers) {
+    // Messages pushed from several threads at once are all delivered, and messages from each
+    // individual sender arrive in the order sent.
+
+    struct Test {
+        std::vector<int> last;
+        int count = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, size_t senders, std::promise<void> promise_)
+            : last(senders, -1), promise(std::move(promise_)) {
+        }
+
+        void receive(size_t sender, int i) {
+            EXPECT_EQ(last[sender] + 1, i);
+            last[sender] = i;
+            ++count;
+        }
+
+        void end() {
+            EXPECT_EQ(static_cast<int>(last.size()) * 1000, count);
+            promise.set_value();
+        }
+    };
+
+    const size_t senders = 4;
+    const int messages = 1000;
+
+    ThreadPool pool { 2 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, senders, std::move(endedPromise));
+    ActorRef<Test> ref = test.self();
+
+    std::vector<std::thread> threads;
+    for (size_t sender = 0; sender < senders; ++sender) {
+        threads.emplace_back([&, sender] () mutable {
+            for (int i = 0; i < messages; ++i) {
+                ref.invoke(&Test::receive, sender, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(Actor, PooledMessages) {
+    // Once warmed up, sending messages doesn't allocate from the heap.
+
+    struct Test {
+        Test(ActorRef<Test>) {}
+        void receive(int, double) {}
+    };
+
+    QueueScheduler scheduler;
+    Actor<Test> test(scheduler);
+    test.setBatchSize(1000);
+
+    auto send = [&] {
+        for (auto i = 0; i < 1000; ++i) {
+            test.invoke(&Test::receive, i, 1.0);
+        }
+        scheduler.runAll();
+    };
+
+    send();
+    const auto before = actor::MessagePool::getStatistics();
+    send();
+    const auto after = actor::MessagePool::getStatistics();
+
+    EXPECT_EQ(1000u, after.allocations - before.allocations);
+    EXPECT_EQ(0u, after.heapAllocations - before.heapAllocations);
+}
+
+TEST(Actor, CoalescedMessages) {
+    // Of a burst of coalesced messages to the same member function, only the last one is
+    // delivered. Other messages are unaffected, and cancelling drops pending coalesced ones.
+
+    struct Test {
+        std::vector<int>& received;
+
+        Test(ActorRef<Test>, std::vector<int>& received_)
+            : received(received_) {
+        }
+
+        void coalesced(int i) {
+            received.push_back(i);
+        }
+
+        void other(int i) {
+            received.push_back(-i);
+        }
+    };
+
+    QueueScheduler scheduler;
+    std::vector<int> received;
+    Actor<Test> test(scheduler, std::ref(received));
+    ActorRef<Test> ref = test.self();
+
+    test.invokeCoalesced(&Test::coalesced, 1);
+    test.invoke(&Test::other, 1);
+    ref.invokeCoalesced(&Test::coalesced, 2);
+    test.invoke(&Test::other, 2);
+    test.invokeCoalesced(&Test::coalesced, 3);
+    test.invoke(&Test::other, 3);
+    scheduler.runAll();
+    EXPECT_EQ((std::vector<int> { -1, -2, 3, -3 }), received);
+    received.clear();
+
+    test.invokeCoalesced(&Test::coalesced, 4);
+    test.invoke(&Test::other, 4);
+    ref.cancel(&Test::coalesced);
+    test.invoke(&Test::coalesced, 5);
+    scheduler.runAll();
+    EXPECT_EQ((std::vector<int> { -4, 5 }), received);
+    received.clear();
+
+    test.invokeCoalesced(&Test::coalesced, 6);
+    scheduler.runAll();
+    EXPECT_EQ((std::vector<int> { 6 }), received);
+}
+
+TEST(Actor, NUMAThreadPool) {
+    // Pinning threads to NUMA nodes doesn't affect per-mailbox ordering.
+
+    struct Test {
+        int last = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    ThreadPool pool { 4, ThreadAffinity::NUMA };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    for (auto i = 1; i <= 1000; ++i) {
+        test.invoke(&Test::receive, i);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(Mailbox, Affinity) {
+    // The first assigned affinity sticks.
+
+    struct NoopScheduler : public Scheduler {
+        void schedule(std::weak_ptr<Mailbox>) override {}
+    };
+
+    NoopScheduler scheduler;
+    auto mailbox = std::make_shared<Mailbox>(scheduler);
+    EXPECT_EQ(Mailbox::NoAffinity, mailbox->getAffinity());
+    EXPECT_EQ(1u, mailbox->assignAffinity(1));
+    EXPECT_EQ(1u, mailbox->assignAffinity(0));
+    EXPECT_EQ(1u, mailbox->getAffinity());
+}
+
+TEST(Actor, Statistics) {
+    // Tagged mailboxes record queue depth, processed and dropped messages, and wait and run times.
+
+    struct Test {
+        Test(ActorRef<Test>) {}
+        void receive() {}
+    };
+
+    auto find = [] (const std::string& tag) {
+        for (const auto& snapshot : actor::Statistics::snapshot()) {
+            if (snapshot.tag == tag) {
+                return snapshot;
+            }
+        }
+        return actor::Statistics::Snapshot();
+    };
+
+    auto sum = [] (const actor::Statistics::Histogram& histogram) {
+        uint64_t result = 0;
+        for (const auto count : histogram) {
+            result += count;
+        }
+        return result;
+    };
+
+    QueueScheduler scheduler;
+    Actor<Test> test(scheduler);
+    test.setTag("Actor.Statistics");
+
+    test.invoke(&Test::receive);
+    test.invoke(&Test::receive);
+    test.invokeCoalesced(&Test::receive);
+    test.invokeCoalesced(&Test::receive);
+
+    auto before = find("Actor.Statistics");
+    EXPECT_EQ(4u, before.queueDepth);
+    EXPECT_EQ(0u, before.processed);
+
+    scheduler.runAll();
+
+    auto after = find("Actor.Statistics");
+    EXPECT_EQ(0u, after.queueDepth);
+    EXPECT_EQ(3u, after.processed);
+    EXPECT_EQ(1u, after.dropped);
+    EXPECT_EQ(3u, sum(after.waitTime));
+    EXPECT_EQ(3u, sum(after.runTime));
+
+    // Messages still queued when their actor is destroyed are taken out of the queue depth.
+    {
+        Actor<Test> discarded(scheduler);
+        discarded.setTag("Actor.Statistics");
+        discarded.invoke(&Test::receive);
+        discarded.invoke(&Test::receive);
+        EXPECT_EQ(2u, find("Actor.Statistics").queueDepth);
+    }
+    auto discarded = find("Actor.Statistics");
+    EXPECT_EQ(0u, discarded.queueDepth);
+    EXPECT_EQ(3u, discarded.processed);
+    EXPECT_EQ(1u, discarded.dropped);
+    scheduler.runAll();
+}
@@ -0,0 +1,79 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/parallel_for.hpp>
+#include <mbgl/platform/default/thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+using namespace mbgl;
+
+TEST(ParallelFor, VisitsEveryIndexOnce) {
+    ThreadPool pool { 4 };
+
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto& count : visits) {
+        count = 0;
+    }
+
+    actor::parallelFor(pool, visits.size(), [&] (std::size_t i) {
+        ++visits[i];
+    });
+
+    for (auto& count : visits) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+TEST(ParallelFor, FromActorOnSameScheduler) {
+    // An actor can run a parallel loop on its own scheduler, even if that has no other threads.
+
+    struct Test {
+        Scheduler& scheduler;
+
+        Test(ActorRef<Test>, Scheduler& scheduler_)
+            : scheduler(scheduler_) {
+        }
+
+        void run(std::promise<std::size_t> promise) {
+            std::atomic<std::size_t> sum { 0 };
+            actor::parallelFor(scheduler, 100, [&] (std::size_t i) {
+                sum += i;
+            });
+            promise.set_value(sum);
+        }
+    };
+
+    ThreadPool pool { 1 };
+    Actor<Test> test(pool, pool);
+
+    std::promise<std::size_t> promise;
+    std::future<std::size_t> future = promise.get_future();
+    test.invoke(&Test::run, std::move(promise));
+
+    EXPECT_EQ(4950u, future.get());
+}
+
+TEST(ParallelFor, ReusesHelpers) {
+    // A ParallelFor runs one loop after the other on the same helpers.
+
+    ThreadPool pool { 4 };
+    actor::ParallelFor parallelFor(pool);
+
+    for (std::size_t round = 0; round < 100; ++round) {
+        std::vector<std::atomic<int>> visits(round);
+        for (auto& count : visits) {
+            count = 0;
+        }
+
+        parallelFor(visits.size(), [&] (std::size_t i) {
+            ++visits[i];
+        });
+
+        for (auto& count : visits) {
+            EXPECT_EQ(1, count);
+        }
+    }
+}
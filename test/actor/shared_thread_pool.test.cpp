@@ -0,0 +1,153 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/platform/default/shared_thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace mbgl;
+using namespace std::chrono_literals;
+
+TEST(SharedThreadPool, OrderedMailbox) {
+    // Messages are processed in order.
+
+    struct Test {
+        int last = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    SharedThreadPool pool { 4 };
+    auto share = pool.createShare();
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(*share, std::move(endedPromise));
+
+    for (auto i = 1; i <= 1000; ++i) {
+        test.invoke(&Test::receive, i);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(SharedThreadPool, MaxConcurrency) {
+    // A share never occupies more threads than its limit, even when other threads are idle.
+
+    struct Test {
+        std::atomic<int>& running;
+        std::atomic<int>& remaining;
+        std::promise<void>& promise;
+
+        Test(ActorRef<Test>, std::atomic<int>& running_, std::atomic<int>& remaining_, std::promise<void>& promise_)
+            : running(running_), remaining(remaining_), promise(promise_) {
+        }
+
+        void receive() {
+            EXPECT_LE(++running, 2);
+            std::this_thread::sleep_for(100us);
+            --running;
+            if (--remaining == 0) {
+                promise.set_value();
+            }
+        }
+    };
+
+    SharedThreadPool pool { 8 };
+    auto share = pool.createShare(1.0, 2);
+
+    std::atomic<int> running { 0 };
+    std::atomic<int> remaining { 200 };
+    std::promise<void> donePromise;
+    std::future<void> doneFuture = donePromise.get_future();
+
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (auto i = 0; i < 20; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(*share, std::ref(running), std::ref(remaining), std::ref(donePromise)));
+    }
+
+    for (auto j = 0; j < 10; ++j) {
+        for (auto& actor : actors) {
+            actor->invoke(&Test::receive);
+        }
+    }
+
+    doneFuture.wait();
+}
+
+TEST(SharedThreadPool, FairShare) {
+    // A share that starts competing late isn't queued behind the backlog of a busy share.
+
+    struct Test {
+        std::vector<char>& order;
+
+        Test(ActorRef<Test>, std::vector<char>& order_)
+            : order(order_) {
+        }
+
+        void block(std::shared_future<void> future) {
+            future.wait();
+        }
+
+        void receive(char c, std::promise<void>* promise) {
+            std::this_thread::sleep_for(200us);
+            order.push_back(c);
+            if (promise) {
+                promise->set_value();
+            }
+        }
+    };
+
+    SharedThreadPool pool { 1 };
+    auto busy = pool.createShare();
+    auto late = pool.createShare();
+
+    std::vector<char> order;
+    std::promise<void> unblockPromise;
+    std::shared_future<void> unblockFuture = unblockPromise.get_future().share();
+
+    std::vector<std::unique_ptr<Actor<Test>>> busyActors;
+    for (auto i = 0; i < 100; ++i) {
+        busyActors.push_back(std::make_unique<Actor<Test>>(*busy, std::ref(order)));
+    }
+    Actor<Test> lateActor(*late, std::ref(order));
+
+    std::promise<void> donePromise;
+    std::future<void> doneFuture = donePromise.get_future();
+
+    Actor<Test> blocker(*busy, std::ref(order));
+    blocker.invoke(&Test::block, unblockFuture);
+
+    for (auto i = 0; i < 100; ++i) {
+        busyActors[i]->invoke(&Test::receive, 'b', i == 99 ? &donePromise : nullptr);
+    }
+    for (auto i = 0; i < 10; ++i) {
+        lateActor.invoke(&Test::receive, 'l', nullptr);
+    }
+
+    unblockPromise.set_value();
+    doneFuture.wait();
+
+    ASSERT_EQ(110u, order.size());
+
+    // The late share's messages run interleaved with the busy share's, rather than last.
+    auto lastLate = std::find(order.rbegin(), order.rend(), 'l');
+    EXPECT_LT(std::distance(lastLate, order.rend()), 60);
+}
@@ -0,0 +1,176 @@
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/platform/default/work_stealing_thread_pool.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+using namespace mbgl;
+using namespace std::chrono_literals;
+
+TEST(WorkStealingThreadPool, OrderedMailbox) {
+    // Messages are processed in order, even though the mailbox may hop between workers.
+
+    struct Test {
+        int last = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive(int i) {
+            EXPECT_EQ(i, last + 1);
+            last = i;
+        }
+
+        void end() {
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 4 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    for (auto i = 1; i <= 1000; ++i) {
+        test.invoke(&Test::receive, i);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(WorkStealingThreadPool, NonConcurrentMailbox) {
+    // An individual actor is never itself concurrent.
+
+    struct Test {
+        std::atomic<bool> receiving { false };
+        int count = 0;
+        std::promise<void> promise;
+
+        Test(ActorRef<Test>, std::promise<void> promise_)
+            : promise(std::move(promise_))  {
+        }
+
+        void receive() {
+            EXPECT_FALSE(receiving.exchange(true));
+            std::this_thread::sleep_for(100us);
+            ++count;
+            receiving = false;
+        }
+
+        void end() {
+            EXPECT_EQ(100, count);
+            promise.set_value();
+        }
+    };
+
+    WorkStealingThreadPool pool { 8 };
+
+    std::promise<void> endedPromise;
+    std::future<void> endedFuture = endedPromise.get_future();
+    Actor<Test> test(pool, std::move(endedPromise));
+
+    for (auto i = 0; i < 100; ++i) {
+        test.invoke(&Test::receive);
+    }
+
+    test.invoke(&Test::end);
+    endedFuture.wait();
+}
+
+TEST(WorkStealingThreadPool, ManyMailboxes) {
+    // Work is spread across workers, including more mailboxes than the injection queue holds.
+
+    struct Test {
+        std::atomic<int>& remaining;
+        std::promise<void>& promise;
+
+        Test(ActorRef<Test>, std::atomic<int>& remaining_, std::promise<void>& promise_)
+            : remaining(remaining_), promise(promise_) {
+        }
+
+        void receive() {
+            if (--remaining == 0) {
+                promise.set_value();
+            }
+        }
+    };
+
+    const int actorCount = 2000;
+    const int messageCount = 10;
+
+    std::atomic<int> remaining { actorCount * messageCount };
+    std::promise<void> donePromise;
+    std::future<void> doneFuture = donePromise.get_future();
+
+    WorkStealingThreadPool pool { 4 };
+    std::vector<std::unique_ptr<Actor<Test>>> actors;
+    for (auto i = 0; i < actorCount; ++i) {
+        actors.push_back(std::make_unique<Actor<Test>>(pool, std::ref(remaining), std::ref(donePromise)));
+    }
+
+    for (auto j = 0; j < messageCount; ++j) {
+        for (auto& actor : actors) {
+            actor->invoke(&Test::receive);
+        }
+    }
+
+    doneFuture.wait();
+    EXPECT_EQ(0, remaining);
+}
+
+TEST(WorkStealingThreadPool, Priority) {
+    // Mailboxes with a more urgent priority are processed first.
+
+    struct Test {
+        std::vector<int>& order;
+        std::future<void> future;
+
+        Test(ActorRef<Test>, std::vector<int>& order_, std::future<void> future_ = {})
+            : order(order_), future(std::move(future_)) {
+        }
+
+        void block() {
+            future.wait();
+        }
+
+        void receive(int i, std::promise<void>* promise) {
+            order.push_back(i);
+            if (promise) {
+                promise->set_value();
+            }
+        }
+    };
+
+    WorkStealingThreadPool pool { 1 };
+
+    std::vector<int> order;
+    std::promise<void> unblockPromise;
+    Actor<Test> blocker(pool, std::ref(order), unblockPromise.get_future());
+    Actor<Test> prefetch(pool, std::ref(order));
+    Actor<Test> fallback(pool, std::ref(order));
+    Actor<Test> visible(pool, std::ref(order));
+    prefetch.setPriority(Mailbox::Priority::Prefetch);
+    fallback.setPriority(Mailbox::Priority::Fallback);
+
+    std::promise<void> donePromise;
+    std::future<void> doneFuture = donePromise.get_future();
+
+    // Occupy the only thread so that all messages queue up.
+    blocker.invoke(&Test::block);
+    prefetch.invoke(&Test::receive, 3, &donePromise);
+    fallback.invoke(&Test::receive, 2, nullptr);
+    visible.invoke(&Test::receive, 1, nullptr);
+
+    unblockPromise.set_value();
+    doneFuture.wait();
+
+    EXPECT_EQ((std::vector<int> { 1, 2, 3 }), order);
+}
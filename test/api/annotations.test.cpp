@@ -88,6 +88,23 @@ TEST(Annotations, FillAnnotation) {
     test.checkRendering("fill_annotation_max_zoom");
 }
 
+TEST(Annotations, FillAnnotationUnchangedByOthers) {
+    AnnotationTest test;
+
+    Polygon<double> polygon = {{ {{ { 0, 0 }, { 0, 45 }, { 45, 45 }, { 45, 0 } }} }};
+    FillAnnotation annotation { polygon };
+    annotation.color = { { 255, 0, 0, 1 } };
+
+    test.map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotation(annotation);
+    test::render(test.map);
+
+    // Regenerates the fill's tiles from the features cached for them.
+    LineString<double> line = {{ { 0, 0 }, { 45, 45 } }};
+    test.map.removeAnnotation(test.map.addAnnotation(LineAnnotation { line }));
+    test.checkRendering("fill_annotation");
+}
+
 TEST(Annotations, AntimeridianAnnotationSmall) {
     AnnotationTest test;
 
@@ -168,6 +185,21 @@ TEST(Annotations, AddMultiple) {
     test.checkRendering("add_multiple");
 }
 
+TEST(Annotations, AddMultipleInBulk) {
+    AnnotationTest test;
+
+    test.map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationIcon("default_marker", namedMarker("default_marker.png"));
+    AnnotationIDs ids = test.map.addAnnotations({
+        SymbolAnnotation { Point<double> { -10, 0 }, "default_marker" },
+        SymbolAnnotation { Point<double> { 10, 0 }, "default_marker" }
+    });
+
+    EXPECT_EQ(2u, ids.size());
+    EXPECT_NE(ids[0], ids[1]);
+    test.checkRendering("add_multiple");
+}
+
 TEST(Annotations, NonImmediateAdd) {
     AnnotationTest test;
 
@@ -291,6 +323,23 @@ TEST(Annotations, RemovePoint) {
     test.checkRendering("remove_point");
 }
 
+TEST(Annotations, RemoveMultipleInBulk) {
+    AnnotationTest test;
+
+    test.map.setStyleJSON(util::read_file("test/fixtures/api/empty.json"));
+    test.map.addAnnotationIcon("default_marker", namedMarker("default_marker.png"));
+    AnnotationIDs ids = test.map.addAnnotations({
+        SymbolAnnotation { Point<double> { -10, 0 }, "default_marker" },
+        SymbolAnnotation { Point<double> { 10, 0 }, "default_marker" },
+        LineAnnotation { LineString<double> {{ { 0, 0 }, { 45, 45 } }} }
+    });
+
+    test::render(test.map);
+
+    test.map.removeAnnotations(ids);
+    test.checkRendering("remove_point");
+}
+
 TEST(Annotations, RemoveShape) {
     AnnotationTest test;
 
@@ -62,3 +62,71 @@ TEST(Query, QueryRenderedFeaturesFilterLayer) {
     auto features4 = test.map.queryRenderedFeatures(zz, {{ "foobar", "layer3" }});
     EXPECT_EQ(features4.size(), 1u);
 }
+
+TEST(Query, QueryRenderedFeaturesVisitor) {
+    QueryTest test;
+
+    auto zz = test.map.pixelForLatLng({ 0, 0 });
+    ScreenBox box { { zz.x - 1, zz.y - 1 }, { zz.x + 1, zz.y + 1 } };
+
+    std::vector<std::string> layers;
+    test.map.queryRenderedFeatures(box, {}, [&] (const RenderedFeature& feature) {
+        layers.push_back(feature.getLayerID());
+        return true;
+    });
+    EXPECT_EQ((std::vector<std::string> { "layer1", "layer2", "layer3" }), layers);
+
+    // Stops once the visitor returns false.
+    layers.clear();
+    test.map.queryRenderedFeatures(box, {}, [&] (const RenderedFeature& feature) {
+        layers.push_back(feature.getLayerID());
+        return false;
+    });
+    EXPECT_EQ((std::vector<std::string> { "layer1" }), layers);
+
+    // Features are decoded on demand.
+    test.map.queryRenderedFeatures(zz, {}, [&] (const RenderedFeature& feature) {
+        EXPECT_TRUE(feature.toFeature().geometry.is<Point<double>>());
+        return true;
+    });
+}
+
+TEST(Query, QueryRenderedFeatureIDs) {
+    QueryTest test;
+
+    auto zz = test.map.pixelForLatLng({ 0, 0 });
+    ScreenBox box { { zz.x - 1, zz.y - 1 }, { zz.x + 1, zz.y + 1 } };
+
+    EXPECT_EQ(3u, test.map.queryRenderedFeatureIDs(box).size());
+
+    RenderedQueryOptions options;
+    options.limit = 2;
+    auto ids = test.map.queryRenderedFeatureIDs(box, options);
+    ASSERT_EQ(2u, ids.size());
+    EXPECT_EQ("layer1", ids[0].layerID);
+    EXPECT_EQ("layer2", ids[1].layerID);
+
+    options.layerIDs = {{ "layer3" }};
+    ids = test.map.queryRenderedFeatureIDs(box, options);
+    ASSERT_EQ(1u, ids.size());
+    EXPECT_EQ("layer3", ids[0].layerID);
+
+    options.limit = 0;
+    EXPECT_EQ(0u, test.map.queryRenderedFeatureIDs(box, options).size());
+}
+
+TEST(Query, QuerySourceFeatures) {
+    QueryTest test;
+
+    auto features1 = test.map.querySourceFeatures("source1", "");
+    EXPECT_EQ(features1.size(), 1u);
+
+    auto features2 = test.map.querySourceFeatures("source1", "", style::EqualsFilter { "$type", uint64_t(FeatureType::Point) });
+    EXPECT_EQ(features2.size(), 1u);
+
+    auto features3 = test.map.querySourceFeatures("source1", "", style::EqualsFilter { "$type", uint64_t(FeatureType::LineString) });
+    EXPECT_EQ(features3.size(), 0u);
+
+    auto features4 = test.map.querySourceFeatures("foobar", "");
+    EXPECT_EQ(features4.size(), 0u);
+}
@@ -2,6 +2,7 @@
 #include <mbgl/test/fixture_log_observer.hpp>
 
 #include <mbgl/map/map.hpp>
+#include <mbgl/map/camera.hpp>
 #include <mbgl/platform/default/headless_display.hpp>
 #include <mbgl/platform/default/headless_view.hpp>
 #include <mbgl/platform/default/thread_pool.hpp>
@@ -10,6 +11,9 @@
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <mapbox/pixelmatch.hpp>
+
+#include <cstring>
 #include <future>
 
 TEST(API, RepeatedRender) {
@@ -76,3 +80,112 @@ TEST(API, RepeatedRender) {
     auto unchecked = flo->unchecked();
     EXPECT_TRUE(unchecked.empty()) << unchecked;
 }
+
+TEST(API, RenderStills) {
+    using namespace mbgl;
+
+    util::RunLoop loop;
+
+    auto display = std::make_shared<mbgl::HeadlessDisplay>();
+    HeadlessView view(display, 1, 256, 512);
+
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+
+    ThreadPool threadPool(4);
+
+    Map map(view, fileSource, threadPool, MapMode::Still);
+    map.setStyleJSON(util::read_file("test/fixtures/api/water.json"));
+
+    std::vector<CameraOptions> cameras(3);
+    cameras[0].center = LatLng { 37.8, -122.5 };
+    cameras[0].zoom = 10.0;
+    cameras[1].center = LatLng { -33.9, 151.2 };
+    cameras[1].zoom = 10.0;
+    cameras[2].center = LatLng { 37.7, -122.4 };
+    cameras[2].zoom = 10.0;
+
+    std::vector<std::size_t> rendered;
+    map.renderStills(cameras, [&](std::size_t index, std::exception_ptr error, PremultipliedImage&& image) {
+        EXPECT_FALSE(error);
+        EXPECT_EQ(256u, image.width);
+        EXPECT_EQ(512u, image.height);
+        rendered.push_back(index);
+    });
+
+    while (rendered.size() < cameras.size()) {
+        loop.runOnce();
+    }
+
+    // The cameras over San Francisco are rendered one after the other.
+    EXPECT_EQ((std::vector<std::size_t>{ 0, 2, 1 }), rendered);
+}
+
+TEST(API, RenderStillTiled) {
+    using namespace mbgl;
+
+    util::RunLoop loop;
+
+    auto display = std::make_shared<mbgl::HeadlessDisplay>();
+#ifdef MBGL_ASSET_ZIP
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets.zip");
+#else
+    DefaultFileSource fileSource(":memory:", "test/fixtures/api/assets");
+#endif
+    ThreadPool threadPool(4);
+
+    const auto style = util::read_file("test/fixtures/api/water.json");
+
+    HeadlessView view(display, 1, 256, 512);
+    Map map(view, fileSource, threadPool, MapMode::Still);
+    map.setStyleJSON(style);
+
+    PremultipliedImage expected;
+    map.renderStill([&](std::exception_ptr error, PremultipliedImage&& image) {
+        EXPECT_FALSE(error);
+        expected = std::move(image);
+    });
+    while (!expected.size()) {
+        loop.runOnce();
+    }
+
+    // The parts don't divide the image evenly.
+    HeadlessView partView(display, 1, 100, 200);
+    Map partMap(partView, fileSource, threadPool, MapMode::Still);
+    partMap.setStyleJSON(style);
+
+    PremultipliedImage result { 256, 512 };
+    std::vector<std::size_t> tops;
+    bool done = false;
+    partMap.renderStillTiled({{ 256, 512 }}, [&](std::exception_ptr error, std::size_t top, PremultipliedImage&& rows) {
+        EXPECT_FALSE(error);
+        EXPECT_EQ(256u, rows.width);
+        std::memcpy(result.data.get() + top * result.stride(), rows.data.get(), rows.size());
+        tops.push_back(top);
+        done = top + rows.height == 512;
+    });
+    while (!done) {
+        loop.runOnce();
+    }
+
+    EXPECT_EQ((std::vector<std::size_t>{ 0, 200, 400 }), tops);
+
+    PremultipliedImage diff { 256, 512 };
+    const double pixels = mapbox::pixelmatch(result.data.get(), expected.data.get(), 256, 512, diff.data.get(), 0.1);
+    EXPECT_LE(pixels / (256 * 512), 0.001);
+
+    // The view's own size is restored.
+    PremultipliedImage still;
+    partMap.renderStill([&](std::exception_ptr error, PremultipliedImage&& image) {
+        EXPECT_FALSE(error);
+        still = std::move(image);
+    });
+    while (!still.size()) {
+        loop.runOnce();
+    }
+    EXPECT_EQ(100u, still.width);
+    EXPECT_EQ(200u, still.height);
+}
@@ -1,16 +1,10 @@
 #include <mbgl/test/util.hpp>
+#include <mbgl/test/rect.hpp>
 
 #include <mbgl/geometry/binpack.hpp>
 
-#include <iosfwd>
 #include <array>
 
-namespace mbgl {
-template <typename T> ::std::ostream& operator<<(::std::ostream& os, const Rect<T>& t) {
-    return os << "Rect { " << t.x << ", " << t.y << ", " << t.w << ", " << t.h << " }";
-}
-} // namespace mbgl
-
 TEST(BinPack, Allocating) {
     mbgl::BinPack<uint16_t> bin(128, 128);
     std::array<mbgl::Rect<uint16_t>, 4> rects;
@@ -29,7 +23,6 @@ TEST(BinPack, Allocating) {
     ASSERT_EQ(mbgl::Rect<uint16_t>(32, 17, 32, 24), rects[3]);
 }
 
-
 TEST(BinPack, Full) {
     mbgl::BinPack<uint16_t> bin(128, 128);
     std::vector<mbgl::Rect<uint16_t>> rects;
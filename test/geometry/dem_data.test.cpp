@@ -0,0 +1,75 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/rect.hpp>
+
+#include <mbgl/geometry/dem_data.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// A Terrarium tile whose texels are all at the same elevation.
+PremultipliedImage flatTile(uint16_t dim, uint8_t meters) {
+    PremultipliedImage image(dim, dim);
+    for (std::size_t i = 0; i < image.size(); i += 4) {
+        image.data[i] = 128; // 32768
+        image.data[i + 1] = meters;
+        image.data[i + 2] = 0;
+        image.data[i + 3] = 255;
+    }
+    return image;
+}
+
+} // namespace
+
+TEST(DEMData, Constructor) {
+    PremultipliedImage image = flatTile(4, 0);
+    image.data[(1 * 4 + 2) * 4 + 1] = 7;
+
+    const DEMData dem(image, Tileset::DEMEncoding::Terrarium);
+    EXPECT_EQ(4, dem.dim);
+    EXPECT_EQ(6, dem.image.width);
+    EXPECT_EQ(0.0f, dem.get(0, 0));
+    EXPECT_EQ(7.0f, dem.get(2, 1));
+
+    // The border starts out as a copy of the edges.
+    EXPECT_EQ(0.0f, dem.get(-1, -1));
+    EXPECT_EQ(0.0f, dem.get(2, -1));
+    EXPECT_EQ(0.0f, dem.get(4, 4));
+
+    EXPECT_THROW(DEMData(PremultipliedImage(4, 2), Tileset::DEMEncoding::Terrarium), std::runtime_error);
+}
+
+TEST(DEMData, Mapbox) {
+    PremultipliedImage image(1, 1);
+    // ((1 * 256 + 134) * 256 + 160) / 10 - 10000 = 0
+    image.data[0] = 1;
+    image.data[1] = 134;
+    image.data[2] = 160;
+    image.data[3] = 255;
+    EXPECT_FLOAT_EQ(0.0f, DEMData(image, Tileset::DEMEncoding::Mapbox).get(0, 0));
+}
+
+TEST(DEMData, BackfillBorder) {
+    DEMData dem(flatTile(4, 0), Tileset::DEMEncoding::Terrarium);
+    PremultipliedImage image = flatTile(4, 5);
+    image.data[(3 * 4 + 0) * 4 + 1] = 9; // The bottom left texel.
+    const DEMData other(image, Tileset::DEMEncoding::Terrarium);
+
+    // A neighbour above fills the top row of the border, a neighbour above and to the right the
+    // top right corner.
+    EXPECT_EQ(Rect<uint16_t>(1, 0, 4, 1), dem.backfillBorder(other, 0, -1));
+    EXPECT_EQ(9.0f, dem.get(0, -1));
+    EXPECT_EQ(5.0f, dem.get(3, -1));
+    EXPECT_EQ(0.0f, dem.get(-1, -1));
+    EXPECT_EQ(0.0f, dem.get(4, -1));
+    EXPECT_EQ(0.0f, dem.get(0, 0));
+
+    EXPECT_EQ(Rect<uint16_t>(5, 0, 1, 1), dem.backfillBorder(other, 1, -1));
+    EXPECT_EQ(9.0f, dem.get(4, -1));
+
+    // A neighbour to the left fills the left column.
+    EXPECT_EQ(Rect<uint16_t>(0, 1, 1, 4), dem.backfillBorder(other, -1, 0));
+    EXPECT_EQ(5.0f, dem.get(-1, 0));
+    EXPECT_EQ(5.0f, dem.get(-1, 3));
+    EXPECT_EQ(0.0f, dem.get(-1, 4));
+}
@@ -0,0 +1,58 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/line_atlas.hpp>
+
+using namespace mbgl;
+
+TEST(LineAtlas, Sharing) {
+    LineAtlas atlas(64, 64);
+
+    // Square patterns of the same proportions share a row.
+    const LinePatternPos a = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Square);
+    const LinePatternPos b = atlas.getDashPosition({ 4, 8 }, LinePatternCap::Square);
+    EXPECT_EQ(1u, atlas.size());
+    EXPECT_FLOAT_EQ(a.y, b.y);
+    EXPECT_FLOAT_EQ(3, a.width);
+    EXPECT_FLOAT_EQ(12, b.width);
+
+    // Round caps don't scale with the pattern.
+    const LinePatternPos c = atlas.getDashPosition({ 1, 2 }, LinePatternCap::Round);
+    const LinePatternPos d = atlas.getDashPosition({ 4, 8 }, LinePatternCap::Round);
+    EXPECT_EQ(3u, atlas.size());
+    EXPECT_NE(c.y, d.y);
+
+    EXPECT_FLOAT_EQ(c.y, atlas.getDashPosition({ 1, 2 }, LinePatternCap::Round).y);
+    EXPECT_EQ(3u, atlas.size());
+}
+
+TEST(LineAtlas, Eviction) {
+    // Room for four patterns with round caps.
+    LineAtlas atlas(64, 60);
+
+    std::vector<float> positions;
+    for (int i = 1; i <= 4; i++) {
+        positions.push_back(atlas.getDashPosition({ 1, float(i) }, LinePatternCap::Round).y);
+    }
+    EXPECT_EQ(4u, atlas.size());
+
+    // Patterns requested in this frame are never replaced.
+    EXPECT_FLOAT_EQ(0, atlas.getDashPosition({ 1, 5 }, LinePatternCap::Round).height);
+    EXPECT_EQ(4u, atlas.size());
+
+    // Once a frame has passed, the least recently used pattern makes room.
+    atlas.nextFrame();
+    atlas.getDashPosition({ 1, 1 }, LinePatternCap::Round);
+    atlas.getDashPosition({ 1, 3 }, LinePatternCap::Round);
+    atlas.getDashPosition({ 1, 4 }, LinePatternCap::Round);
+    atlas.nextFrame();
+    atlas.getDashPosition({ 1, 1 }, LinePatternCap::Round);
+    atlas.getDashPosition({ 1, 4 }, LinePatternCap::Round);
+    const LinePatternPos replaced = atlas.getDashPosition({ 1, 5 }, LinePatternCap::Round);
+    EXPECT_FLOAT_EQ(positions[1], replaced.y);
+    EXPECT_EQ(4u, atlas.size());
+
+    // Then the next one.
+    const LinePatternPos next = atlas.getDashPosition({ 1, 6 }, LinePatternCap::Round);
+    EXPECT_FLOAT_EQ(positions[2], next.y);
+    EXPECT_FLOAT_EQ(positions[0], atlas.getDashPosition({ 1, 1 }, LinePatternCap::Round).y);
+}
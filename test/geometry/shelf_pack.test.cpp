@@ -0,0 +1,68 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/rect.hpp>
+
+#include <mbgl/geometry/shelf_pack.hpp>
+
+#include <vector>
+
+TEST(ShelfPack, Allocating) {
+    mbgl::ShelfPack<uint16_t> bin(64, 64);
+
+    // Rectangles of the same height share a shelf; others open new ones.
+    ASSERT_EQ(mbgl::Rect<uint16_t>(0, 0, 32, 16), bin.allocate(32, 16));
+    ASSERT_EQ(mbgl::Rect<uint16_t>(32, 0, 16, 16), bin.allocate(16, 16));
+    ASSERT_EQ(mbgl::Rect<uint16_t>(0, 16, 8, 24), bin.allocate(8, 24));
+
+    // Shorter ones go into a shelf that isn't more than twice as tall.
+    ASSERT_EQ(mbgl::Rect<uint16_t>(48, 0, 16, 12), bin.allocate(16, 12));
+    ASSERT_EQ(mbgl::Rect<uint16_t>(0, 40, 8, 4), bin.allocate(8, 4));
+
+    // Too wide, or too tall for the room that's left.
+    ASSERT_FALSE(bin.allocate(65, 1).hasArea());
+    ASSERT_FALSE(bin.allocate(8, 40).hasArea());
+}
+
+TEST(ShelfPack, Release) {
+    mbgl::ShelfPack<uint16_t> bin(64, 64);
+
+    const auto a = bin.allocate(32, 16);
+    const auto b = bin.allocate(32, 16);
+    const auto c = bin.allocate(64, 16);
+    EXPECT_EQ(3u, bin.shelfCount());
+
+    // The room of a released rectangle is reused in its shelf.
+    bin.release(a);
+    ASSERT_EQ(mbgl::Rect<uint16_t>(0, 0, 16, 16), bin.allocate(16, 16));
+    ASSERT_EQ(mbgl::Rect<uint16_t>(16, 0, 16, 16), bin.allocate(16, 16));
+
+    // Empty shelves are merged with their empty neighbours, and split again for any height.
+    bin.release(c);
+    EXPECT_EQ(2u, bin.shelfCount());
+    ASSERT_EQ(mbgl::Rect<uint16_t>(0, 16, 64, 48), bin.allocate(64, 48));
+
+    bin.release(b);
+    ASSERT_EQ(mbgl::Rect<uint16_t>(32, 0, 32, 16), bin.allocate(32, 16));
+}
+
+TEST(ShelfPack, Full) {
+    mbgl::ShelfPack<uint16_t> bin(128, 128);
+    std::vector<mbgl::Rect<uint16_t>> rects;
+
+    for (uint16_t j = 0; j < 3; j++) {
+        // Each round packs rectangles of another height into the whole room.
+        const uint16_t size = 8 << j;
+        for (int i = 0; i < (128 / size) * (128 / size); i++) {
+            auto rect = bin.allocate(size, size);
+            ASSERT_TRUE(rect.hasArea());
+            rects.push_back(rect);
+        }
+
+        ASSERT_FALSE(bin.allocate(size, size).hasArea());
+
+        for (auto& rect: rects) {
+            bin.release(rect);
+        }
+        rects.clear();
+        EXPECT_EQ(1u, bin.shelfCount());
+    }
+}
@@ -0,0 +1,43 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gl/dirty_regions.hpp>
+
+using namespace mbgl;
+using namespace mbgl::gl;
+
+TEST(DirtyRegions, Add) {
+    DirtyRegions regions;
+    EXPECT_TRUE(regions.empty());
+
+    regions.add({ 0, 0, 0, 8 });
+    EXPECT_TRUE(regions.empty());
+
+    regions.add({ 4, 4, 8, 8 });
+    regions.add({ 32, 0, 4, 4 });
+    ASSERT_EQ(2u, regions.getRegions().size());
+    EXPECT_EQ(8u * 8 + 4 * 4, regions.area());
+
+    // Regions within others aren't added again, and ones they cover are replaced.
+    regions.add({ 6, 6, 2, 2 });
+    EXPECT_EQ(2u, regions.getRegions().size());
+    regions.add({ 0, 0, 16, 16 });
+    ASSERT_EQ(2u, regions.getRegions().size());
+    EXPECT_EQ((Rect<uint16_t> { 32, 0, 4, 4 }), regions.getRegions()[0]);
+    EXPECT_EQ((Rect<uint16_t> { 0, 0, 16, 16 }), regions.getRegions()[1]);
+
+    regions.clear();
+    EXPECT_TRUE(regions.empty());
+    EXPECT_EQ(0u, regions.area());
+}
+
+TEST(DirtyRegions, MergeBeyondMax) {
+    DirtyRegions regions;
+    for (uint16_t i = 0; i < DirtyRegions::MaxRegions; ++i) {
+        regions.add({ uint16_t(i * 8), uint16_t(i * 4), 4, 4 });
+    }
+    EXPECT_EQ(DirtyRegions::MaxRegions, regions.getRegions().size());
+
+    regions.add({ 200, 100, 4, 4 });
+    ASSERT_EQ(1u, regions.getRegions().size());
+    EXPECT_EQ((Rect<uint16_t> { 0, 0, 204, 104 }), regions.getRegions()[0]);
+}
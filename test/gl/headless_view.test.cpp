@@ -0,0 +1,87 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+// Fills the top half of the framebuffer with `top`, and the bottom half with `bottom`.
+void fillHalves(float top, float bottom) {
+    MBGL_CHECK_ERROR(glEnable(GL_SCISSOR_TEST));
+    MBGL_CHECK_ERROR(glScissor(0, 0, 16, 8));
+    MBGL_CHECK_ERROR(glClearColor(bottom, 0.0f, 0.0f, 1.0f));
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+    MBGL_CHECK_ERROR(glScissor(0, 8, 16, 8));
+    MBGL_CHECK_ERROR(glClearColor(top, 0.0f, 0.0f, 1.0f));
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+    MBGL_CHECK_ERROR(glDisable(GL_SCISSOR_TEST));
+}
+
+// Returns the red channel of the first pixel of the top and of the bottom row.
+std::pair<uint8_t, uint8_t> redOfFirstAndLastRow(const PremultipliedImage& image) {
+    return { image.data[0], image.data[image.stride() * (image.height - 1)] };
+}
+
+} // namespace
+
+TEST(HeadlessView, ReadStillImage) {
+    HeadlessView view(1.0f, 16, 16);
+    view.activate();
+
+    fillHalves(1.0f, 0.0f);
+    auto image = view.readStillImage();
+    EXPECT_EQ(std::make_pair(uint8_t(255), uint8_t(0)), redOfFirstAndLastRow(image));
+
+    view.deactivate();
+}
+
+TEST(HeadlessView, StillImageReadsPipeline) {
+    HeadlessView view(1.0f, 16, 16);
+    view.activate();
+
+    EXPECT_FALSE(view.isStillImageReadFinished());
+    EXPECT_THROW(view.finishStillImageRead(), std::logic_error);
+
+    // Frames can be rendered while earlier ones are still being read.
+    fillHalves(1.0f, 0.0f);
+    view.startStillImageRead();
+    fillHalves(0.0f, 1.0f);
+    view.startStillImageRead();
+    EXPECT_EQ(2u, view.pendingStillImageReads());
+
+    auto first = view.finishStillImageRead();
+    auto second = view.finishStillImageRead();
+    EXPECT_EQ(0u, view.pendingStillImageReads());
+    EXPECT_EQ(std::make_pair(uint8_t(255), uint8_t(0)), redOfFirstAndLastRow(first));
+    EXPECT_EQ(std::make_pair(uint8_t(0), uint8_t(255)), redOfFirstAndLastRow(second));
+
+    // Reads that are never finished are released along with the view.
+    view.startStillImageRead();
+    view.deactivate();
+}
+
+TEST(HeadlessView, ContextsOnThreads) {
+    auto display = std::make_shared<HeadlessDisplay>();
+
+    // Views that share a display have contexts of their own, which render on different threads.
+    auto render = [&](float top, float bottom, std::pair<uint8_t, uint8_t>& result) {
+        HeadlessView view(display, 1.0f, 16, 16);
+        view.activate();
+        fillHalves(top, bottom);
+        result = redOfFirstAndLastRow(view.readStillImage());
+        view.deactivate();
+    };
+
+    std::pair<uint8_t, uint8_t> first, second;
+    std::thread thread([&] { render(1.0f, 0.0f, first); });
+    render(0.0f, 1.0f, second);
+    thread.join();
+
+    EXPECT_EQ(std::make_pair(uint8_t(255), uint8_t(0)), first);
+    EXPECT_EQ(std::make_pair(uint8_t(0), uint8_t(255)), second);
+}
@@ -5,8 +5,10 @@
 
 #include <mbgl/gl/gl.hpp>
 #include <mbgl/gl/context.hpp>
+#include <mbgl/util/image.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace {
 
@@ -66,6 +68,25 @@ TEST(GLObject, Value) {
     EXPECT_TRUE(setFlag);
 }
 
+TEST(GLObject, ChangeCount) {
+    auto object = std::make_unique<mbgl::gl::State<MockGLObject>>();
+    EXPECT_EQ(object->getChangeCount(), 0u);
+
+    *object = false;
+    EXPECT_EQ(object->getChangeCount(), 0u);
+
+    *object = true;
+    *object = true;
+    EXPECT_EQ(object->getChangeCount(), 1u);
+
+    object->setDirty();
+    *object = true;
+    EXPECT_EQ(object->getChangeCount(), 2u);
+
+    object->reset();
+    EXPECT_EQ(object->getChangeCount(), 3u);
+}
+
 TEST(GLObject, Store) {
     mbgl::HeadlessView view(std::make_shared<mbgl::HeadlessDisplay>(), 1);
     view.activate();
@@ -108,3 +129,120 @@ TEST(GLObject, Store) {
 
     view.deactivate();
 }
+
+TEST(GLObject, ImageTexturePool) {
+    mbgl::HeadlessView view(std::make_shared<mbgl::HeadlessDisplay>(), 1);
+    view.activate();
+
+    mbgl::gl::Context context;
+    const mbgl::PremultipliedImage small { 2, 2 };
+    const mbgl::PremultipliedImage large { 4, 4 };
+
+    {
+        mbgl::gl::TextureID id = 0;
+        {
+            mbgl::gl::Texture a = context.createTexture(small, 0, mbgl::gl::TextureMipMap::Yes);
+            EXPECT_EQ(bool(mbgl::gl::GenerateMipmap), a.mipmaps);
+            id = a.texture.get();
+        }
+
+        // A released texture is only reused by an image of the same size.
+        mbgl::gl::Texture b = context.createTexture(large);
+        EXPECT_NE(id, b.texture.get());
+        EXPECT_FALSE(b.mipmaps);
+        mbgl::gl::Texture c = context.createTexture(small);
+        EXPECT_EQ(id, c.texture.get());
+    }
+
+    EXPECT_FALSE(context.empty());
+    context.reset();
+    EXPECT_TRUE(context.empty());
+
+    view.deactivate();
+}
+
+TEST(GLObject, BufferArena) {
+    mbgl::HeadlessView view(std::make_shared<mbgl::HeadlessDisplay>(), 1);
+    view.activate();
+
+    mbgl::gl::Context context;
+    const std::vector<uint8_t> data(128, 0);
+
+    {
+        mbgl::gl::BufferArena arena(context, mbgl::gl::BufferType::Vertex, 64);
+
+        // Ranges are aligned to four bytes, and share a buffer object.
+        mbgl::gl::BufferRange a = arena.upload(data.data(), 10);
+        mbgl::gl::BufferRange b = arena.upload(data.data(), 16);
+        EXPECT_EQ(a.getID(), b.getID());
+        EXPECT_EQ(0u, a.getOffset());
+        EXPECT_EQ(12u, a.getSize());
+        EXPECT_EQ(12u, b.getOffset());
+        EXPECT_EQ(1u, arena.bufferCount());
+
+        // Released ranges are reused.
+        a = {};
+        mbgl::gl::BufferRange c = arena.upload(data.data(), 8);
+        EXPECT_EQ(b.getID(), c.getID());
+        EXPECT_EQ(0u, c.getOffset());
+
+        // Data that doesn't fit gets a buffer object of its own, which is deleted once released.
+        mbgl::gl::BufferRange big = arena.upload(data.data(), 128);
+        EXPECT_NE(b.getID(), big.getID());
+        EXPECT_EQ(2u, arena.bufferCount());
+        big = {};
+        EXPECT_EQ(1u, arena.bufferCount());
+
+        // Free neighbours are merged, so that the whole buffer object can be used again.
+        b = {};
+        c = {};
+        mbgl::gl::BufferRange all = arena.upload(data.data(), 64);
+        EXPECT_EQ(0u, all.getOffset());
+        EXPECT_EQ(1u, arena.bufferCount());
+    }
+
+    context.performCleanup();
+    EXPECT_TRUE(context.empty());
+
+    view.deactivate();
+}
+
+TEST(GLObject, VertexArrayCache) {
+    mbgl::HeadlessView view(std::make_shared<mbgl::HeadlessDisplay>(), 1);
+    view.activate();
+
+    mbgl::gl::Context context;
+
+    {
+        mbgl::gl::VertexArrayCache cache(context, 2);
+        const mbgl::gl::VertexArrayKey a { 1, 1, 2, 0, 4 };
+        const mbgl::gl::VertexArrayKey b { 1, 1, 2, 64, 4 };
+        const mbgl::gl::VertexArrayKey c { 1, 3, 0, 0, 4 };
+
+        // A new vertex array object has to be set up by the caller; a cached one doesn't.
+        EXPECT_FALSE(cache.bind(a));
+        EXPECT_TRUE(cache.bind(a));
+        EXPECT_FALSE(cache.bind(b));
+        EXPECT_EQ(2u, cache.size());
+
+        // The least recently used one is evicted.
+        EXPECT_TRUE(cache.bind(a));
+        EXPECT_FALSE(cache.bind(c));
+        EXPECT_EQ(2u, cache.size());
+        EXPECT_TRUE(cache.bind(a));
+        EXPECT_FALSE(cache.bind(b));
+
+        // Entries that refer to deleted objects are dropped.
+        cache.abandonBuffers({ 2 });
+        EXPECT_EQ(0u, cache.size());
+        EXPECT_FALSE(cache.bind(c));
+        cache.abandonPrograms({ 1 });
+        EXPECT_EQ(0u, cache.size());
+    }
+
+    context.vertexArrayObject = 0;
+    context.performCleanup();
+    EXPECT_TRUE(context.empty());
+
+    view.deactivate();
+}
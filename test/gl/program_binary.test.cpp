@@ -0,0 +1,112 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/program_binary.hpp>
+#include <mbgl/gl/shader.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <exception>
+#include <memory>
+#include <string>
+
+using namespace mbgl;
+
+namespace {
+
+const char* vertexSource = R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#endif
+attribute vec2 a_pos;
+void main() {
+    gl_Position = vec4(a_pos, 0, 1);
+}
+)MBGL_SHADER";
+
+const char* fragmentSource = R"MBGL_SHADER(
+#ifdef GL_ES
+precision highp float;
+#endif
+uniform vec4 u_color;
+void main() {
+    gl_FragColor = u_color;
+}
+)MBGL_SHADER";
+
+class TestShader : public gl::Shader {
+public:
+    TestShader(gl::Context& context, const char* fragment = fragmentSource)
+        : Shader("test", vertexSource, fragment, context) {
+    }
+};
+
+const std::string cachePath = "test/fixtures/program_binary";
+const std::string binaryPath = cachePath + ".test.program";
+
+void deleteBinary() {
+    try {
+        util::deleteFile(binaryPath);
+    } catch (const std::exception&) {
+    }
+}
+
+} // namespace
+
+TEST(ProgramBinary, Cache) {
+    HeadlessView view(std::make_shared<HeadlessDisplay>(), 1);
+    view.activate();
+
+    if (!gl::programBinarySupported()) {
+        view.deactivate();
+        return;
+    }
+
+    deleteBinary();
+
+    {
+        gl::Context context;
+        context.setProgramCachePath(cachePath);
+
+        // The first program is compiled, and its binary saved.
+        {
+            TestShader shader(context);
+            EXPECT_NE(-1, shader.getAttributeLocation("a_pos"));
+        }
+        const std::string saved = util::read_file(binaryPath);
+        EXPECT_FALSE(saved.empty());
+
+        // The second one is linked from it.
+        {
+            TestShader shader(context);
+            EXPECT_NE(-1, shader.getAttributeLocation("a_pos"));
+            EXPECT_NE(-1, shader.getUniformLocation("u_color"));
+        }
+        EXPECT_EQ(saved, util::read_file(binaryPath));
+
+        // A binary for other sources isn't used, but replaced.
+        const std::string otherFragment = std::string(fragmentSource) + "\n";
+        {
+            TestShader shader(context, otherFragment.c_str());
+            EXPECT_NE(-1, shader.getUniformLocation("u_color"));
+        }
+        EXPECT_NE(saved, util::read_file(binaryPath));
+
+        // A damaged binary is compiled again.
+        const std::string damaged = saved.substr(0, saved.size() / 2);
+        util::write_file(binaryPath, damaged);
+        {
+            TestShader shader(context);
+            EXPECT_NE(-1, shader.getUniformLocation("u_color"));
+        }
+        EXPECT_NE(damaged, util::read_file(binaryPath));
+
+        context.performCleanup();
+        context.reset();
+    }
+
+    deleteBinary();
+    view.deactivate();
+}
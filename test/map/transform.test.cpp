@@ -475,6 +475,95 @@ TEST(Transform, Camera) {
     ASSERT_FALSE(transform.inTransition());
 }
 
+TEST(Transform, TransitionStartedWhenFinished) {
+    Transform transform;
+    transform.resize({{ 1000, 1000 }});
+
+    CameraOptions second;
+    second.center = LatLng { 10, 20 };
+    second.zoom = 4;
+
+    AnimationOptions firstOptions(Seconds(1));
+    firstOptions.transitionFinishFn = [&] {
+        transform.easeTo(second, AnimationOptions(Seconds(1)));
+    };
+
+    CameraOptions first;
+    first.zoom = 2;
+    transform.easeTo(first, firstOptions);
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    ASSERT_DOUBLE_EQ(2, transform.getZoom());
+
+    // The transition started by the callback of the first one isn't cut short by it finishing.
+    ASSERT_TRUE(transform.inTransition());
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    ASSERT_FALSE(transform.inTransition());
+    ASSERT_NEAR(10, transform.getLatLng().latitude, 0.000001);
+    ASSERT_NEAR(20, transform.getLatLng().longitude, 0.000001);
+    ASSERT_DOUBLE_EQ(4, transform.getZoom());
+}
+
+TEST(Transform, UpcomingStates) {
+    Transform transform;
+    transform.resize({{ 1000, 1000 }});
+    EXPECT_TRUE(transform.getUpcomingStates().empty());
+
+    CameraOptions camera;
+    camera.zoom = 12;
+    camera.center = LatLng { 45, 135 };
+    const double startZoom = transform.getZoom();
+    transform.flyTo(camera, AnimationOptions(Seconds(1)));
+
+    // Sampling the path ahead doesn't move the camera.
+    EXPECT_DOUBLE_EQ(startZoom, transform.getZoom());
+    auto states = transform.getUpcomingStates();
+    ASSERT_FALSE(states.empty());
+    EXPECT_NEAR(12, states.back().getZoom(), 0.00001);
+    EXPECT_NEAR(45, states.back().getLatLng().latitude, 0.001);
+    EXPECT_NEAR(135, states.back().getLatLng().longitude, 0.001);
+
+    // Samples that the camera has passed are dropped; the landing stays until it's there.
+    transform.updateTransitions(transform.getTransitionStart() + Milliseconds(750));
+    const auto remaining = transform.getUpcomingStates();
+    ASSERT_FALSE(remaining.empty());
+    EXPECT_LT(remaining.size(), states.size());
+    EXPECT_NEAR(12, remaining.back().getZoom(), 0.00001);
+
+    transform.updateTransitions(transform.getTransitionStart() + transform.getTransitionDuration());
+    EXPECT_TRUE(transform.getUpcomingStates().empty());
+
+    // Nor are there any for immediate changes.
+    camera.zoom = 4;
+    transform.jumpTo(camera);
+    EXPECT_TRUE(transform.getUpcomingStates().empty());
+}
+
+TEST(Transform, UpcomingStatesWhilePanning) {
+    Transform transform;
+    transform.resize({{ 1000, 1000 }});
+    transform.setZoom(10);
+    const LatLng start = transform.getLatLng();
+
+    // A single move doesn't tell where panning is headed.
+    transform.moveBy({ -100, 0 });
+    EXPECT_TRUE(transform.getUpcomingStates().empty());
+
+    // Panning east extrapolates further east, by at most one screenful.
+    transform.moveBy({ -100, 0 });
+    auto states = transform.getUpcomingStates();
+    ASSERT_EQ(1u, states.size());
+    EXPECT_GT(states[0].getLatLng().longitude, transform.getLatLng().longitude);
+    EXPECT_NEAR(transform.getLatLng().latitude, states[0].getLatLng().latitude, 0.000001);
+    EXPECT_DOUBLE_EQ(transform.getZoom(), states[0].getZoom());
+    const ScreenCoordinate ahead = transform.latLngToScreenCoordinate(states[0].getLatLng());
+    EXPECT_NEAR(1500, ahead.x, 0.01);
+    EXPECT_GT(transform.getLatLng().longitude, start.longitude);
+
+    // Turning around stops extrapolating the old direction.
+    transform.moveBy({ 100, 0 });
+    EXPECT_TRUE(transform.getUpcomingStates().empty());
+}
+
 TEST(Transform, DefaultTransform) {
     Transform transform;
     const TransformState& state = transform.getState();
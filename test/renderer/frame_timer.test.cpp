@@ -0,0 +1,122 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+
+#include <mbgl/gl/context.hpp>
+#include <mbgl/gl/gl.hpp>
+#include <mbgl/gl/timer_query.hpp>
+#include <mbgl/renderer/frame_timer.hpp>
+
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+void draw() {
+    MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT));
+}
+
+void renderFrame(FrameTimer& timer, gl::Context& context, TimePoint timePoint) {
+    timer.beginFrame(context, timePoint, true);
+    timer.beginPhase(FrameStats::Phase::Clear);
+    draw();
+    timer.beginPhase(FrameStats::Phase::Opaque);
+    timer.beginLayer("water");
+    draw();
+    timer.beginLayer("road");
+    draw();
+    timer.endLayer();
+    timer.beginPhase(FrameStats::Phase::Translucent);
+    timer.beginLayer("water");
+    draw();
+    timer.endLayer();
+    timer.endFrame();
+}
+
+} // namespace
+
+TEST(FrameTimer, PhasesAndLayers) {
+    HeadlessView view(std::make_shared<HeadlessDisplay>(), 1);
+    view.activate();
+
+    {
+        gl::Context context;
+        FrameTimer timer;
+
+        const TimePoint first = Clock::now();
+        renderFrame(timer, context, first);
+
+        if (gl::timerQuerySupported()) {
+            // The GPU times of the frame are collected by a later one.
+            EXPECT_EQ(TimePoint::min(), timer.getStats().timePoint);
+            MBGL_CHECK_ERROR(glFinish());
+            renderFrame(timer, context, first + Milliseconds(16));
+        }
+
+        const FrameStats& stats = timer.getStats();
+        EXPECT_EQ(first, stats.timePoint);
+
+        // The layers are listed once, in the order they were first drawn in.
+        ASSERT_EQ(2u, stats.layers.size());
+        EXPECT_EQ("water", stats.layers[0].layerID);
+        EXPECT_EQ("road", stats.layers[1].layerID);
+
+        const auto& opaque = stats.phase(FrameStats::Phase::Opaque);
+        const auto& translucent = stats.phase(FrameStats::Phase::Translucent);
+        EXPECT_LE(stats.layers[0].cpu + stats.layers[1].cpu, opaque.cpu + translucent.cpu);
+
+        Duration phases = Duration::zero();
+        for (const auto& phase : stats.phases) {
+            phases += phase.cpu;
+        }
+        EXPECT_LE(phases, stats.total.cpu);
+        EXPECT_EQ(Duration::zero(), stats.phase(FrameStats::Phase::Upload).cpu);
+
+        if (gl::timerQuerySupported()) {
+            ASSERT_TRUE(bool(stats.total.gpu));
+            ASSERT_TRUE(bool(opaque.gpu));
+            ASSERT_TRUE(bool(stats.layers[0].gpu));
+            Duration gpuPhases = Duration::zero();
+            for (const auto& phase : stats.phases) {
+                gpuPhases += *phase.gpu;
+            }
+            EXPECT_EQ(*stats.total.gpu, gpuPhases);
+            EXPECT_LE(*stats.layers[1].gpu, *opaque.gpu);
+        } else {
+            EXPECT_FALSE(bool(stats.total.gpu));
+        }
+
+        context.performCleanup();
+        context.reset();
+    }
+
+    view.deactivate();
+}
+
+TEST(FrameTimer, Disabled) {
+    HeadlessView view(std::make_shared<HeadlessDisplay>(), 1);
+    view.activate();
+
+    {
+        gl::Context context;
+        FrameTimer timer;
+
+        timer.beginFrame(context, Clock::now(), false);
+        timer.beginPhase(FrameStats::Phase::Opaque);
+        timer.beginLayer("water");
+        draw();
+        timer.endLayer();
+        timer.endFrame();
+
+        EXPECT_EQ(TimePoint::min(), timer.getStats().timePoint);
+        EXPECT_TRUE(timer.getStats().layers.empty());
+        EXPECT_EQ(Duration::zero(), timer.getStats().total.cpu);
+
+        context.performCleanup();
+        context.reset();
+    }
+
+    view.deactivate();
+}
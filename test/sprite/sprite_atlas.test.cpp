@@ -6,6 +6,7 @@
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/sprite/sprite_atlas.hpp>
 #include <mbgl/sprite/sprite_parser.hpp>
+#include <mbgl/platform/default/thread_pool.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -266,6 +267,27 @@ TEST(SpriteAtlas, ReplaceWithDifferentDimensions) {
     EXPECT_EQ(sprite1, atlas.getSprite("sprite"));
 }
 
+TEST(SpriteAtlas, RemoveReclaims) {
+    SpriteAtlas atlas(32, 32, 1);
+
+    // Only two of these fit at a time, but the room of removed ones is reused.
+    for (int i = 0; i < 16; i++) {
+        const std::string name = "icon" + util::toString(i);
+        atlas.setSprite(name, std::make_shared<SpriteImage>(PremultipliedImage(16, 12), 1));
+        auto icon = atlas.getImage(name, SpritePatternMode::Single);
+        ASSERT_TRUE(bool(icon));
+        EXPECT_EQ(0, icon->pos.x);
+        EXPECT_EQ(0, icon->pos.y);
+
+        atlas.removeSprite(name);
+        atlas.updateDirty();
+    }
+
+    // The pixels of removed images are cleared.
+    EXPECT_EQ(readImage("test/fixtures/annotations/result-spriteatlas-empty.png"),
+              imageFromAtlas(atlas));
+}
+
 class SpriteAtlasTest {
 public:
     SpriteAtlasTest() = default;
@@ -275,12 +297,12 @@ public:
     StubStyleObserver observer;
     SpriteAtlas spriteAtlas { 32, 32, 1 };
 
-    void run() {
+    void run(Scheduler* scheduler = nullptr) {
         // Squelch logging.
         Log::setObserver(std::make_unique<Log::NullObserver>());
 
         spriteAtlas.setObserver(&observer);
-        spriteAtlas.load("test/fixtures/resources/sprite", fileSource);
+        spriteAtlas.load("test/fixtures/resources/sprite", fileSource, scheduler);
 
         loop.run();
     }
@@ -338,6 +360,43 @@ TEST(SpriteAtlas, LoadingSuccess) {
     test.run();
 }
 
+TEST(SpriteAtlas, LoadingSuccessOnWorker) {
+    SpriteAtlasTest test;
+    ThreadPool threadPool { 1 };
+
+    test.fileSource.spriteImageResponse = successfulSpriteImageResponse;
+    test.fileSource.spriteJSONResponse = successfulSpriteJSONResponse;
+
+    test.observer.spriteError = [&] (std::exception_ptr error) {
+        FAIL() << util::toString(error);
+        test.end();
+    };
+
+    test.observer.spriteLoaded = [&] () {
+        EXPECT_TRUE(test.spriteAtlas.isLoaded());
+        EXPECT_TRUE(bool(test.spriteAtlas.getSprite("turning-circle")));
+        test.end();
+    };
+
+    test.run(&threadPool);
+}
+
+TEST(SpriteAtlas, ImageLoadingCorruptedOnWorker) {
+    SpriteAtlasTest test;
+    ThreadPool threadPool { 1 };
+
+    test.fileSource.spriteImageResponse = corruptSpriteResponse;
+    test.fileSource.spriteJSONResponse = successfulSpriteJSONResponse;
+
+    test.observer.spriteError = [&] (std::exception_ptr error) {
+        EXPECT_TRUE(error != nullptr);
+        EXPECT_FALSE(test.spriteAtlas.isLoaded());
+        test.end();
+    };
+
+    test.run(&threadPool);
+}
+
 TEST(SpriteAtlas, JSONLoadingFail) {
     SpriteAtlasTest test;
 
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mbgl/util/rect.hpp>
+
+#include <ostream>
+
+namespace mbgl {
+
+// Lets gtest print the rects of failed expectations.
+template <typename T> ::std::ostream& operator<<(::std::ostream& os, const Rect<T>& t) {
+    return os << "Rect { " << t.x << ", " << t.y << ", " << t.w << ", " << t.h << " }";
+}
+
+} // namespace mbgl
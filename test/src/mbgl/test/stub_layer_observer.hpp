@@ -26,8 +26,13 @@ public:
         if (layerLayoutPropertyChanged) layerLayoutPropertyChanged(layer);
     }
 
+    void onLayerDataChanged(Layer& layer) override {
+        if (layerDataChanged) layerDataChanged(layer);
+    }
+
     std::function<void (Layer&)> layerFilterChanged;
     std::function<void (Layer&)> layerVisibilityChanged;
     std::function<void (Layer&)> layerPaintPropertyChanged;
     std::function<void (Layer&)> layerLayoutPropertyChanged;
+    std::function<void (Layer&)> layerDataChanged;
 };
@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/offline_pack.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 using namespace mbgl;
@@ -130,6 +131,47 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CacheRevalidateModified)) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CacheRevalidateUnchanged)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    // The server sends no validators, so it can't tell that the data hasn't changed.
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test" };
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    uint16_t counter = 0;
+
+    // First request causes the response to get cached.
+    req1 = fs.request(resource, [&](Response res) {
+        req1.reset();
+
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+
+        // Second request returns the cached response, then revalidates it. The same data comes
+        // back, which is passed on as not modified.
+        req2 = fs.request(resource, [&](Response res2) {
+            if (counter == 0) {
+                ++counter;
+                EXPECT_FALSE(res2.notModified);
+                ASSERT_TRUE(res2.data.get());
+                EXPECT_EQ("Hello World!", *res2.data);
+            } else {
+                req2.reset();
+
+                EXPECT_EQ(nullptr, res2.error);
+                EXPECT_TRUE(res2.notModified);
+                EXPECT_FALSE(res2.data.get());
+
+                loop.stop();
+            }
+        });
+    });
+
+    loop.run();
+}
+
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(CacheRevalidateEtag)) {
     util::RunLoop loop;
     DefaultFileSource fs(":memory:", ".");
@@ -209,6 +251,36 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(HTTPIssue1369)) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(IdenticalRequestsShareFetch)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    // The server counts its responses, so requests that fetched on their own would differ.
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/shared" };
+    std::vector<std::string> responses;
+
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+    auto callback = [&] (Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        responses.push_back(*res.data);
+        if (responses.size() == 2) {
+            req1.reset();
+            req2.reset();
+            loop.stop();
+        }
+    };
+    req1 = fs.request(resource, callback);
+    req2 = fs.request(resource, callback);
+
+    loop.run();
+
+    ASSERT_EQ(2u, responses.size());
+    EXPECT_EQ("Response 1", responses[0]);
+    EXPECT_EQ("Response 1", responses[1]);
+}
+
 TEST(DefaultFileSource, OptionalNonExpired) {
     util::RunLoop loop;
     DefaultFileSource fs(":memory:", ".");
@@ -291,6 +363,43 @@ TEST(DefaultFileSource, OptionalNotFound) {
     loop.run();
 }
 
+TEST(DefaultFileSource, TEST_REQUIRES_WRITE(OfflinePack)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    const Resource optionalResource { Resource::Unknown, "http://127.0.0.1:3000/test", {}, Resource::Optional };
+
+    using namespace std::chrono_literals;
+
+    Response cached;
+    cached.data = std::make_shared<std::string>("Cached value");
+    fs.put(optionalResource, cached);
+
+    Response packed;
+    packed.data = std::make_shared<std::string>("Packed value");
+    packed.expires = util::now() + 1h;
+    OfflinePackWriter writer("test/fixtures/offline_database/default_file_source.pack");
+    writer.add(optionalResource, packed);
+    writer.finish();
+
+    // The pack is searched before the cache.
+    fs.addOfflinePack("test/fixtures/offline_database/default_file_source.pack", [] (std::exception_ptr error) {
+        EXPECT_FALSE(bool(error));
+    });
+
+    std::unique_ptr<AsyncRequest> req;
+    req = fs.request(optionalResource, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Packed value", *res.data);
+        EXPECT_EQ(*packed.expires, res.expires);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
 // Test that we can make a request with etag data that doesn't first try to load
 // from cache like a regular request
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(NoCacheRefreshEtagNotModified)) {
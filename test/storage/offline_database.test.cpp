@@ -185,6 +185,43 @@ TEST(OfflineDatabase, PutResource) {
     EXPECT_EQ("second", *updateGetResult->data);
 }
 
+TEST(OfflineDatabase, PutBatch) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Resource tile { Resource::Tile, "http://example.com/0/0/0.png" };
+    tile.tileData = Resource::TileData {
+        "http://example.com/{z}/{x}/{y}.png",
+        1,
+        0,
+        0,
+        0
+    };
+    Response response;
+    response.data = std::make_shared<std::string>("first");
+    db.put(resource, response);
+
+    Response tileResponse;
+    tileResponse.data = std::make_shared<std::string>("tile");
+    response.data = std::make_shared<std::string>("second");
+    db.putBatch({ { tile, tileResponse }, { resource, response } }, { resource });
+
+    auto resourceResult = db.read(resource);
+    ASSERT_TRUE(resourceResult && resourceResult->data);
+    EXPECT_EQ("second", *resourceResult->data);
+
+    auto tileResult = db.read(tile);
+    ASSERT_TRUE(tileResult && tileResult->data);
+    EXPECT_EQ("tile", *tileResult->data);
+
+    // Puts after the batch begin transactions of their own again.
+    response.data = std::make_shared<std::string>("third");
+    db.put(resource, response);
+    EXPECT_EQ("third", *db.get(resource)->data);
+}
+
 TEST(OfflineDatabase, PutTile) {
     using namespace mbgl;
 
@@ -386,6 +423,209 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ConcurrentUse)) {
     thread2.join();
 }
 
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(ReadOnly)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    OfflineDatabase reader("test/fixtures/offline_database/offline.db", OfflineDatabase::ReadOnly());
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    EXPECT_FALSE(bool(reader.read(resource)));
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    db.put(resource, response);
+
+    auto res = reader.read(resource);
+    ASSERT_TRUE(res && res->data);
+    EXPECT_EQ("data", *res->data);
+
+    // Reads proceed while the other connection is in the middle of a write.
+    {
+        mapbox::sqlite::Database writer("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadWrite);
+        mapbox::sqlite::Transaction transaction(writer, mapbox::sqlite::Transaction::Immediate);
+        writer.exec("DELETE FROM resources");
+        EXPECT_TRUE(bool(reader.read(resource)));
+    }
+
+    EXPECT_ANY_THROW(reader.put(resource, response));
+    EXPECT_ANY_THROW(reader.touch(resource));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(TileDictionary)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    auto tile = [] (int32_t x) {
+        Resource resource { Resource::Tile, "http://example.com/0/" + util::toString(x) + "/0" };
+        resource.tileData = Resource::TileData { "http://example.com/{z}/{x}/{y}", 1, x, 0, 0 };
+        return resource;
+    };
+    auto data = [] (int32_t x) {
+        std::string result;
+        // Big enough not to be shared with identical tiles instead.
+        for (int32_t i = 0; i < 500; i++) {
+            result += "layer:water,class:river,name:" + util::toString(x * i) + ";";
+        }
+        return result;
+    };
+
+    {
+        OfflineDatabase db("test/fixtures/offline_database/offline.db");
+        Response response;
+        for (int32_t x = 0; x < 9; x++) {
+            response.data = std::make_shared<std::string>(data(x));
+            db.put(tile(x), response);
+        }
+    }
+
+    // The dictionary is trained on the first tiles, and the ones after them use it.
+    {
+        mapbox::sqlite::Database sqlite("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = sqlite.prepare("SELECT x, compressed FROM tiles ORDER BY x");
+        while (stmt.run()) {
+            EXPECT_EQ(stmt.get<int>(0) < 8 ? 1 : 2, stmt.get<int>(1));
+        }
+    }
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+    for (int32_t x = 0; x < 9; x++) {
+        auto res = db.get(tile(x));
+        ASSERT_TRUE(res && res->data);
+        EXPECT_EQ(data(x), *res->data);
+    }
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(SharedTileData)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    auto tile = [] (int32_t x) {
+        return Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, x, 0, 4, Tileset::Scheme::XYZ);
+    };
+    auto blobCount = [] {
+        mapbox::sqlite::Database sqlite("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt = sqlite.prepare("SELECT COUNT(*) FROM tile_blobs");
+        stmt.run();
+        return stmt.get<int>(0);
+    };
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+
+    Response ocean;
+    ocean.data = std::make_shared<std::string>("ocean");
+    Response land;
+    land.data = std::make_shared<std::string>("land");
+
+    // Identical tiles share their data.
+    db.put(tile(0), ocean);
+    db.put(tile(1), ocean);
+    db.put(tile(2), ocean);
+    db.put(tile(3), land);
+    EXPECT_EQ(2, blobCount());
+
+    for (int32_t x = 0; x < 3; x++) {
+        auto res = db.get(tile(x));
+        ASSERT_TRUE(res && res->data);
+        EXPECT_EQ("ocean", *res->data);
+    }
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, 0, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+    EXPECT_EQ(int64_t(ocean.data->size()), db.hasRegionResource(region.getID(), tile(1)));
+
+    // A blob goes away with the last tile that shares it.
+    db.put(tile(3), ocean);
+    EXPECT_EQ(1, blobCount());
+    auto res = db.get(tile(3));
+    ASSERT_TRUE(res && res->data);
+    EXPECT_EQ("ocean", *res->data);
+
+    // Big tiles keep their own data.
+    std::mt19937 random(0);
+    std::string noise;
+    for (std::size_t i = 0; i < 64 * 1024; i++) {
+        noise.push_back(char(random()));
+    }
+    Response big;
+    big.data = std::make_shared<std::string>(noise);
+    db.put(tile(4), big);
+    db.put(tile(5), big);
+    EXPECT_EQ(1, blobCount());
+    res = db.get(tile(5));
+    ASSERT_TRUE(res && res->data);
+    EXPECT_EQ(*big.data, *res->data);
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(Checkpoint)) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+    deleteFile("test/fixtures/offline_database/checkpoint.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.noContent = true;
+    db.put(resource, response);
+
+    // Once checkpointed, the database holds the resource without its write-ahead log.
+    db.checkpoint();
+    writeFile("test/fixtures/offline_database/checkpoint.db",
+              util::read_file("test/fixtures/offline_database/offline.db"));
+
+    mapbox::sqlite::Database copy("test/fixtures/offline_database/checkpoint.db", mapbox::sqlite::ReadOnly);
+    mapbox::sqlite::Statement stmt = copy.prepare("SELECT COUNT(*) FROM resources");
+    ASSERT_TRUE(stmt.run());
+    EXPECT_EQ(1, stmt.get<int>(0));
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(TouchGranularity)) {
+    using namespace mbgl;
+    using namespace std::chrono_literals;
+
+    createDir("test/fixtures/offline_database");
+    deleteFile("test/fixtures/offline_database/offline.db");
+
+    OfflineDatabase db("test/fixtures/offline_database/offline.db");
+
+    Resource resource { Resource::Style, "http://example.com/" };
+    Response response;
+    response.noContent = true;
+    db.put(resource, response);
+
+    mapbox::sqlite::Database raw("test/fixtures/offline_database/offline.db", mapbox::sqlite::ReadWrite);
+    auto setAccessed = [&] (Timestamp accessed) {
+        mapbox::sqlite::Statement stmt = raw.prepare("UPDATE resources SET accessed = ?");
+        stmt.bind(1, accessed);
+        stmt.run();
+    };
+    auto accessed = [&] {
+        mapbox::sqlite::Statement stmt = raw.prepare("SELECT accessed FROM resources");
+        stmt.run();
+        return stmt.get<Timestamp>(0);
+    };
+
+    // Uses close to the last one aren't recorded.
+    const Timestamp recently = util::now() - 10min;
+    setAccessed(recently);
+    db.touch(resource);
+    EXPECT_EQ(recently, accessed());
+
+    const Timestamp longAgo = util::now() - 2h;
+    setAccessed(longAgo);
+    db.touch(resource);
+    EXPECT_LT(longAgo, accessed());
+}
+
 static std::shared_ptr<std::string> randomString(size_t size) {
     auto result = std::make_shared<std::string>(size, 0);
     std::mt19937 random;
@@ -432,6 +672,36 @@ TEST(OfflineDatabase, PutEvictsLeastRecentlyUsedResources) {
     EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/1"))));
 }
 
+TEST(OfflineDatabase, EvictIncrementally) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:", 1024 * 100);
+
+    Response response;
+    response.data = randomString(1024);
+
+    std::vector<std::pair<Resource, Response>> responses;
+    for (uint32_t i = 1; i <= 200; i++) {
+        responses.emplace_back(Resource::style("http://example.com/"s + util::toString(i)), response);
+    }
+
+    // Batches don't make space for their puts.
+    db.putBatch(responses, {});
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+
+    // Out of time before it evicts anything.
+    EXPECT_TRUE(db.evictIncrementally(Duration::zero()));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+
+    EXPECT_FALSE(db.evictIncrementally(Duration::max()));
+    EXPECT_FALSE(bool(db.get(Resource::style("http://example.com/2"))));
+
+    // Nothing left to do once the cache fits.
+    db.put(Resource::style("http://example.com/1"), response);
+    EXPECT_FALSE(db.evictIncrementally(Duration::zero()));
+    EXPECT_TRUE(bool(db.get(Resource::style("http://example.com/1"))));
+}
+
 TEST(OfflineDatabase, PutRegionResourceDoesNotEvict) {
     using namespace mbgl;
 
@@ -496,6 +766,176 @@ TEST(OfflineDatabase, GetRegionCompletedStatus) {
     EXPECT_EQ(tileSize, status3.completedTileSize);
 }
 
+TEST(OfflineDatabase, PutRegionResources) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    const Resource style = Resource::style("http://example.com/");
+    const Resource tile = Resource::tile("http://example.com/", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    std::vector<uint64_t> sizes = db.putRegionResources(region.getID(), { { style, response }, { tile, response } });
+    ASSERT_EQ(2u, sizes.size());
+
+    OfflineRegionStatus status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(2u, status.completedResourceCount);
+    EXPECT_EQ(sizes[0] + sizes[1], status.completedResourceSize);
+    EXPECT_EQ(1u, status.completedTileCount);
+    EXPECT_EQ(sizes[1], status.completedTileSize);
+
+    // Resources that are stored already are marked as used by the other region as well.
+    OfflineRegion other = db.createRegion(definition, OfflineRegionMetadata());
+    std::vector<optional<int64_t>> stored = db.hasRegionResources(other.getID(),
+        { style, tile, Resource::style("http://example.com/missing") });
+    ASSERT_EQ(3u, stored.size());
+    EXPECT_EQ(int64_t(sizes[0]), stored[0]);
+    EXPECT_EQ(int64_t(sizes[1]), stored[1]);
+    EXPECT_FALSE(bool(stored[2]));
+    EXPECT_EQ(2u, db.getRegionCompletedStatus(other.getID()).completedResourceCount);
+}
+
+TEST(OfflineDatabase, HasRegionResourcesTiles) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    auto tile = [] (int32_t x, int32_t y, int8_t z) {
+        return Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, x, y, z, Tileset::Scheme::XYZ);
+    };
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    db.put(tile(0, 0, 0), response);
+    db.put(tile(1, 1, 1), response);
+    db.put(tile(3, 2, 2), response);
+
+    // Tiles without content are requested again.
+    Response noContent;
+    noContent.noContent = true;
+    db.put(tile(0, 1, 1), noContent);
+
+    std::vector<Resource> resources { tile(0, 0, 0), tile(0, 1, 1), tile(1, 1, 1), tile(2, 2, 2),
+                                      tile(3, 2, 2), Resource::style("http://example.com/") };
+    std::vector<optional<int64_t>> stored = db.hasRegionResources(region.getID(), resources);
+    ASSERT_EQ(6u, stored.size());
+    EXPECT_TRUE(bool(stored[0]));
+    EXPECT_FALSE(bool(stored[1]));
+    EXPECT_TRUE(bool(stored[2]));
+    EXPECT_FALSE(bool(stored[3]));
+    EXPECT_TRUE(bool(stored[4]));
+    EXPECT_FALSE(bool(stored[5]));
+
+    // The stored tiles are the region's now.
+    OfflineRegionStatus status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(3u, status.completedTileCount);
+}
+
+TEST(OfflineDatabase, GetRegionExpiredResources) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    Response expired;
+    expired.data = std::make_shared<std::string>("data");
+    expired.etag = std::string("etag");
+    expired.expires = util::now() - Seconds(10);
+
+    Response fresh;
+    fresh.data = std::make_shared<std::string>("data");
+    fresh.expires = util::now() + Seconds(100);
+
+    const Resource style = Resource::style("http://example.com/style");
+    const Resource expiredTile = Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 0, 1, 1, Tileset::Scheme::TMS);
+    const Resource freshTile = Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 1, 1, 1, Tileset::Scheme::XYZ);
+    db.putRegionResources(region.getID(), { { style, expired }, { expiredTile, expired }, { freshTile, fresh } });
+
+    // Resources that were used after the walk started aren't listed.
+    OfflineDatabase::ExpiredResourcesCursor past(util::now() - Seconds(100));
+    EXPECT_TRUE(db.getRegionExpiredResources(region.getID(), past, 10).empty());
+
+    OfflineDatabase::ExpiredResourcesCursor all(util::now());
+    std::vector<Resource> resources = db.getRegionExpiredResources(region.getID(), all, 10);
+    ASSERT_EQ(2u, resources.size());
+    EXPECT_EQ(Resource::Kind::Tile, resources[0].kind);
+    EXPECT_EQ(expiredTile.url, resources[0].url);
+    EXPECT_EQ(std::string("etag"), resources[0].priorEtag);
+    EXPECT_EQ(expired.expires, resources[0].priorExpires);
+    EXPECT_EQ(Resource::Kind::Style, resources[1].kind);
+    EXPECT_EQ(style.url, resources[1].url);
+    EXPECT_EQ(std::string("etag"), resources[1].priorEtag);
+    EXPECT_TRUE(db.getRegionExpiredResources(region.getID(), all, 10).empty());
+
+    // The walk picks up where it left off, and skips the resources that were revalidated since.
+    OfflineDatabase::ExpiredResourcesCursor cursor(util::now());
+    ASSERT_EQ(1u, db.getRegionExpiredResources(region.getID(), cursor, 1).size());
+    Response notModified;
+    notModified.notModified = true;
+    notModified.expires = util::now() - Seconds(1);
+    db.putRegionResources(region.getID(), { { expiredTile, notModified } });
+    resources = db.getRegionExpiredResources(region.getID(), cursor, 10);
+    ASSERT_EQ(1u, resources.size());
+    EXPECT_EQ(style.url, resources[0].url);
+    EXPECT_TRUE(db.getRegionExpiredResources(region.getID(), cursor, 10).empty());
+}
+
+TEST(OfflineDatabase, RegionStatusFollowsWrites) {
+    using namespace mbgl;
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+    OfflineRegion other = db.createRegion(definition, OfflineRegionMetadata());
+
+    auto response = [] (const std::string& data) {
+        Response result;
+        result.data = std::make_shared<std::string>(data);
+        return result;
+    };
+
+    const Resource style = Resource::style("http://example.com/style");
+    const Resource tile = Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    const Resource sharedTile = Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 0, 0, 1, Tileset::Scheme::XYZ);
+    const uint64_t styleSize = db.putRegionResource(region.getID(), style, response("style"));
+    uint64_t tileSize = db.putRegionResource(region.getID(), tile, response("tile"));
+    const uint64_t sharedTileSize = db.putRegionResource(region.getID(), sharedTile, response("ocean"));
+    db.putRegionResource(other.getID(), Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 1, 0, 1, Tileset::Scheme::XYZ),
+                         response("ocean"));
+    db.hasRegionResources(other.getID(), { tile });
+
+    OfflineRegionStatus status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(3u, status.completedResourceCount);
+    EXPECT_EQ(styleSize + tileSize + sharedTileSize, status.completedResourceSize);
+    EXPECT_EQ(2u, status.completedTileCount);
+    EXPECT_EQ(tileSize + sharedTileSize, status.completedTileSize);
+    EXPECT_EQ(2u, db.getRegionCompletedStatus(other.getID()).completedTileCount);
+
+    // Both regions count the new size of a tile they share.
+    tileSize = db.put(tile, response("a tile that is longer")).second;
+    EXPECT_EQ(tileSize + sharedTileSize, db.getRegionCompletedStatus(region.getID()).completedTileSize);
+    EXPECT_EQ(tileSize + sharedTileSize, db.getRegionCompletedStatus(other.getID()).completedTileSize);
+
+    Response noContent;
+    noContent.noContent = true;
+    db.put(sharedTile, noContent);
+    status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(2u, status.completedTileCount);
+    EXPECT_EQ(tileSize, status.completedTileSize);
+    EXPECT_EQ(styleSize + tileSize, status.completedResourceSize);
+
+    db.deleteRegion(std::move(other));
+    status = db.getRegionCompletedStatus(region.getID());
+    EXPECT_EQ(3u, status.completedResourceCount);
+    EXPECT_EQ(styleSize + tileSize, status.completedResourceSize);
+}
+
 TEST(OfflineDatabase, HasRegionResource) {
     using namespace mbgl;
 
@@ -639,19 +1079,19 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
 
     // v2.db is a v2 database containing a single offline region with a small number of resources.
 
-    deleteFile("test/fixtures/offline_database/v5.db");
-    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v2.db"));
+    deleteFile("test/fixtures/offline_database/v9.db");
+    writeFile("test/fixtures/offline_database/v9.db", util::read_file("test/fixtures/offline_database/v2.db"));
 
     {
-        OfflineDatabase db("test/fixtures/offline_database/v5.db", 0);
+        OfflineDatabase db("test/fixtures/offline_database/v9.db", 0);
         auto regions = db.listRegions();
         for (auto& region : regions) {
             db.deleteRegion(std::move(region));
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
-    EXPECT_LT(databasePageCount("test/fixtures/offline_database/v5.db"),
+    EXPECT_EQ(9, databaseUserVersion("test/fixtures/offline_database/v9.db"));
+    EXPECT_LT(databasePageCount("test/fixtures/offline_database/v9.db"),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 }
 
@@ -660,18 +1100,18 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
 
     // v3.db is a v3 database, migrated from v2.
 
-    deleteFile("test/fixtures/offline_database/v5.db");
-    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v3.db"));
+    deleteFile("test/fixtures/offline_database/v9.db");
+    writeFile("test/fixtures/offline_database/v9.db", util::read_file("test/fixtures/offline_database/v3.db"));
 
     {
-        OfflineDatabase db("test/fixtures/offline_database/v5.db", 0);
+        OfflineDatabase db("test/fixtures/offline_database/v9.db", 0);
         auto regions = db.listRegions();
         for (auto& region : regions) {
             db.deleteRegion(std::move(region));
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(9, databaseUserVersion("test/fixtures/offline_database/v9.db"));
 }
 
 TEST(OfflineDatabase, MigrateFromV4Schema) {
@@ -679,22 +1119,22 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
 
     // v4.db is a v4 database, migrated from v2 & v3. This database used `journal_mode = WAL` and `synchronous = NORMAL`.
 
-    deleteFile("test/fixtures/offline_database/v5.db");
-    writeFile("test/fixtures/offline_database/v5.db", util::read_file("test/fixtures/offline_database/v4.db"));
+    deleteFile("test/fixtures/offline_database/v9.db");
+    writeFile("test/fixtures/offline_database/v9.db", util::read_file("test/fixtures/offline_database/v4.db"));
 
     {
-        OfflineDatabase db("test/fixtures/offline_database/v5.db", 0);
+        OfflineDatabase db("test/fixtures/offline_database/v9.db", 0);
         auto regions = db.listRegions();
         for (auto& region : regions) {
             db.deleteRegion(std::move(region));
         }
     }
 
-    EXPECT_EQ(5, databaseUserVersion("test/fixtures/offline_database/v5.db"));
+    EXPECT_EQ(9, databaseUserVersion("test/fixtures/offline_database/v9.db"));
 
-    // Journal mode should be DELETE after migration to v5.
-    EXPECT_EQ("delete", databaseJournalMode("test/fixtures/offline_database/v5.db"));
+    // Journal mode should be WAL after migration to v9.
+    EXPECT_EQ("wal", databaseJournalMode("test/fixtures/offline_database/v9.db"));
 
-    // Synchronous setting should be FULL (2) after migration to v5.
-    EXPECT_EQ(2, databaseSyncMode("test/fixtures/offline_database/v5.db"));
+    // Synchronous setting should be FULL (2) after migration to v9.
+    EXPECT_EQ(2, databaseSyncMode("test/fixtures/offline_database/v9.db"));
 }
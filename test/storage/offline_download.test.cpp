@@ -262,7 +262,50 @@ TEST(OfflineDownload, DoesNotFloodTheFileSourceWithRequests) {
     fileSource.respond(Resource::Kind::Style, test.response("style.json"));
     test.loop.runOnce();
 
-    EXPECT_EQ(HTTPFileSource::maximumConcurrentRequests(), fileSource.requests.size());
+    // The next requests wait in the file source's queue behind the ones in flight.
+    EXPECT_EQ(HTTPFileSource::maximumConcurrentRequests() * 2, fileSource.requests.size());
+
+    download.setMaximumConcurrentRequests(HTTPFileSource::maximumConcurrentRequests() * 3);
+    EXPECT_EQ(HTTPFileSource::maximumConcurrentRequests() * 3, fileSource.requests.size());
+}
+
+TEST(OfflineDownload, WritesResponsesTogether) {
+    FakeFileSource fileSource;
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 1.0, 1.0),
+        test.db, fileSource);
+
+    auto observer = std::make_unique<MockObserver>();
+    OfflineRegionStatus latest;
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        latest = status;
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+    test.loop.runOnce();
+
+    fileSource.respond(Resource::Kind::Style, test.response("inline_source.style.json"));
+    test.loop.runOnce();
+
+    // One tile at zoom level 0, and four at zoom level 1.
+    ASSERT_EQ(5u, fileSource.requests.size());
+
+    // The tiles wait to be written while the others are in flight.
+    for (std::size_t i = 0; i < 4; i++) {
+        fileSource.respond(Resource::Kind::Tile, test.response("0-0-0.vector.pbf"));
+    }
+    EXPECT_EQ(1u, latest.completedResourceCount);
+    EXPECT_EQ(1u, test.db.getRegionCompletedStatus(region.getID()).completedResourceCount);
+
+    fileSource.respond(Resource::Kind::Tile, test.response("0-0-0.vector.pbf"));
+    EXPECT_EQ(6u, latest.completedResourceCount);
+    EXPECT_EQ(5u, latest.completedTileCount);
+    EXPECT_EQ(OfflineRegionDownloadState::Inactive, latest.downloadState);
+    EXPECT_EQ(6u, test.db.getRegionCompletedStatus(region.getID()).completedResourceCount);
 }
 
 TEST(OfflineDownload, GetStatusNoResources) {
@@ -588,6 +631,50 @@ TEST(OfflineDownload, ReactivatePreviouslyCompletedDownload) {
     EXPECT_EQ(2u, statusesAfterReactivate[2].completedResourceCount);
 }
 
+TEST(OfflineDownload, RefreshesExpiredResources) {
+    OfflineTest test;
+    OfflineRegion region = test.createRegion();
+    OfflineDownload download(
+        region.getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0),
+        test.db, test.fileSource);
+
+    Response expired = test.response("empty.style.json");
+    expired.etag = std::string("etag");
+    expired.expires = util::now() - Seconds(10);
+    test.db.putRegionResource(region.getID(), Resource::style("http://127.0.0.1:3000/style.json"), expired);
+
+    const Timestamp expires = util::now() + Seconds(100);
+    std::size_t revalidations = 0;
+    test.fileSource.styleResponse = [&] (const Resource& resource) {
+        EXPECT_EQ("http://127.0.0.1:3000/style.json", resource.url);
+        EXPECT_EQ(std::string("etag"), resource.priorEtag);
+        revalidations++;
+
+        Response response;
+        response.notModified = true;
+        response.expires = expires;
+        return response;
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.downloadState == OfflineRegionDownloadState::Inactive) {
+            EXPECT_EQ(1u, status.completedResourceCount);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setRefreshExpiredResources(true);
+    download.setState(OfflineRegionDownloadState::Active);
+
+    test.loop.run();
+
+    EXPECT_EQ(1u, revalidations);
+    EXPECT_EQ(expires, test.db.get(Resource::style("http://127.0.0.1:3000/style.json"))->expires);
+}
+
 TEST(OfflineDownload, Deactivate) {
     OfflineTest test;
     OfflineRegion region = test.createRegion();
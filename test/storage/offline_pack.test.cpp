@@ -0,0 +1,118 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/offline_pack.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+const char* packPath = "test/fixtures/offline_database/region.pack";
+
+void createDir(const char* name) {
+    const int ret = mkdir(name, 0755);
+    if (ret == -1) {
+        ASSERT_EQ(EEXIST, errno);
+    } else {
+        ASSERT_EQ(0, ret);
+    }
+}
+
+Response response(const std::string& data) {
+    Response result;
+    result.data = std::make_shared<std::string>(data);
+    return result;
+}
+
+} // namespace
+
+TEST(OfflinePack, TEST_REQUIRES_WRITE(ExportRegion)) {
+    createDir("test/fixtures/offline_database");
+
+    OfflineDatabase db(":memory:");
+    OfflineRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0 };
+    OfflineRegion region = db.createRegion(definition, OfflineRegionMetadata());
+
+    const Timestamp expires = util::now() + Seconds(100);
+    Response style = response("style");
+    style.etag = std::string("etag");
+    style.expires = expires;
+
+    Response noContent;
+    noContent.noContent = true;
+
+    const std::string large(10000, 'x');
+    const Resource styleResource = Resource::style("http://example.com/style.json");
+    const Resource ocean = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 0, 0, 1, Tileset::Scheme::TMS);
+    const Resource land = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 1, 1, 1, Tileset::Scheme::XYZ);
+    const Resource empty = Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 0, 0, 1, Tileset::Scheme::XYZ);
+    const Resource raster = Resource::tile("http://example.com/{z}/{x}/{y}{ratio}.png", 2.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    db.putRegionResources(region.getID(), {
+        { styleResource, style },
+        { ocean, response("ocean") },
+        { land, response(large) },
+        { empty, noContent },
+        { raster, response("raster") },
+    });
+
+    // Tiles that aren't part of the region aren't exported.
+    db.put(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 1, 0, 1, Tileset::Scheme::XYZ), response("ambient"));
+
+    db.exportRegion(region.getID(), packPath);
+    OfflinePack pack(packPath);
+
+    optional<Response> result = pack.get(styleResource);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ("style", *result->data);
+    EXPECT_EQ(std::string("etag"), result->etag);
+    EXPECT_EQ(expires, result->expires);
+    EXPECT_FALSE(bool(result->modified));
+
+    result = pack.get(ocean);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ("ocean", *result->data);
+    EXPECT_FALSE(bool(result->etag));
+
+    result = pack.get(land);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ(large, *result->data);
+
+    result = pack.get(empty);
+    ASSERT_TRUE(result);
+    EXPECT_TRUE(result->noContent);
+    EXPECT_FALSE(result->data);
+
+    result = pack.get(raster);
+    ASSERT_TRUE(result && result->data);
+    EXPECT_EQ("raster", *result->data);
+
+    EXPECT_FALSE(bool(pack.get(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 1, 0, 1, Tileset::Scheme::XYZ))));
+    EXPECT_FALSE(bool(pack.get(Resource::tile("http://example.com/{z}/{x}/{y}.mvt", 1.0, 0, 0, 1, Tileset::Scheme::XYZ))));
+    EXPECT_FALSE(bool(pack.get(Resource::tile("http://example.com/{z}/{x}/{y}{ratio}.png", 1.0, 0, 0, 0, Tileset::Scheme::XYZ))));
+    EXPECT_FALSE(bool(pack.get(Resource::source("http://example.com/style.json"))));
+    EXPECT_FALSE(bool(pack.get(Resource::style("http://example.com/other.json"))));
+}
+
+TEST(OfflinePack, TEST_REQUIRES_WRITE(Invalid)) {
+    createDir("test/fixtures/offline_database");
+
+    util::write_file(packPath, "this is not an offline pack, but it's long enough for a header");
+    EXPECT_THROW(OfflinePack pack(packPath), std::runtime_error);
+
+    // The directory of a truncated pack is missing.
+    OfflinePackWriter writer(packPath);
+    writer.add(Resource::style("http://example.com/style.json"), response("style"));
+    writer.finish();
+    util::write_file(packPath, util::read_file(packPath).substr(0, sizeof(OfflinePack::Header) + 8));
+    EXPECT_THROW(OfflinePack pack(packPath), std::runtime_error);
+
+    EXPECT_THROW(OfflinePack pack("test/fixtures/offline_database/missing.pack"), std::runtime_error);
+}
@@ -1,5 +1,6 @@
 #include <mbgl/test/util.hpp>
 #include <mbgl/storage/online_file_source.hpp>
+#include <mbgl/storage/http_file_source.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -258,6 +259,31 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(Load)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(PreemptBackgroundRequests)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    // Background requests that never complete take up all of the active requests.
+    std::vector<std::unique_ptr<AsyncRequest>> stale;
+    for (uint32_t i = 0; i < HTTPFileSource::maximumConcurrentRequests(); i++) {
+        Resource resource { Resource::Unknown, "http://127.0.0.1:3000/stale/" + std::to_string(i) };
+        resource.priority = Resource::Background;
+        stale.push_back(fs.request(resource, [&] (Response) {
+            ADD_FAILURE() << "Stale request should not complete";
+        }));
+    }
+
+    std::unique_ptr<AsyncRequest> req = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/test" }, [&] (Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("Hello World!", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
 // Test for https://github.com/mapbox/mapbox-gl-native/issues/2123
 //
 // A request is made. While the request is in progress, the network status changes. This should
@@ -133,6 +133,13 @@ app.get('/delayed', function(req, res) {
     }, 200);
 });
 
+var sharedCounter = 0;
+app.get('/shared', function(req, res) {
+    // Responds after a while, so that requests made at the same time are pending together.
+    setTimeout(function() {
+        res.send('Response ' + (++sharedCounter));
+    }, 100);
+});
 
 app.get('/load/:number(\\d+)', function(req, res) {
     res.send('Request ' + req.params.number);
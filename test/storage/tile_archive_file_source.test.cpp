@@ -0,0 +1,149 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/storage/tile_archive_file_source.hpp>
+#include <mbgl/storage/offline_pack.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <gtest/gtest.h>
+#include <sqlite3.hpp>
+#include <zlib.h>
+
+#include <unistd.h>
+#include <limits.h>
+
+using namespace mbgl;
+
+namespace {
+
+const char* mbtilesPath = "test/fixtures/storage/archive.mbtiles";
+const char* packPath = "test/fixtures/storage/archive.pack";
+
+std::string toAbsolutePath(const std::string& path) {
+    char buff[PATH_MAX + 1];
+    char* cwd = getcwd(buff, PATH_MAX + 1);
+    return std::string(cwd) + "/" + path;
+}
+
+// Re-wraps the zlib stream of util::compress() as gzip, which MBTiles files use.
+std::string gzip(const std::string& raw) {
+    const std::string deflated = util::compress(raw);
+    const uLong crc = crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(raw.data()), uInt(raw.size()));
+    std::string result("\x1F\x8B\x08\0\0\0\0\0\0\xFF", 10);
+    result.append(deflated, 2, deflated.size() - 6);
+    for (uint32_t value : { uint32_t(crc), uint32_t(raw.size()) }) {
+        for (int i = 0; i < 4; ++i) {
+            result.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+    }
+    return result;
+}
+
+void createMBTiles() {
+    unlink(mbtilesPath);
+    mapbox::sqlite::Database db(mbtilesPath, mapbox::sqlite::ReadWrite | mapbox::sqlite::Create);
+    db.exec("CREATE TABLE metadata (name TEXT, value TEXT);"
+            "CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB);"
+            "INSERT INTO metadata VALUES ('name', 'Archive'), ('minzoom', '0'), ('maxzoom', '1'),"
+            "                            ('bounds', '-180,-85,180,85'), ('format', 'pbf');");
+
+    const std::string northWest = gzip("north west");
+    const std::string northEast = "north east";
+    mapbox::sqlite::Statement insert = db.prepare("INSERT INTO tiles VALUES (?1, ?2, ?3, ?4)");
+    // The rows are numbered from the south.
+    insert.bind(1, int64_t(1));
+    insert.bind(2, int64_t(0));
+    insert.bind(3, int64_t(1));
+    insert.bindBlob(4, northWest.data(), northWest.size());
+    insert.run();
+    insert.reset();
+    insert.bind(1, int64_t(1));
+    insert.bind(2, int64_t(1));
+    insert.bind(3, int64_t(1));
+    insert.bindBlob(4, northEast.data(), northEast.size());
+    insert.run();
+}
+
+Response request(TileArchiveFileSource& fs, util::RunLoop& loop, const Resource& resource) {
+    Response result;
+    std::unique_ptr<AsyncRequest> req = fs.request(resource, [&](Response res) {
+        req.reset();
+        result = res;
+        loop.stop();
+    });
+    loop.run();
+    return result;
+}
+
+} // namespace
+
+TEST(TileArchiveFileSource, AcceptsURL) {
+    EXPECT_TRUE(TileArchiveFileSource::acceptsURL("mbtiles:///data/archive.mbtiles"));
+    EXPECT_TRUE(TileArchiveFileSource::acceptsURL("pack:///data/archive.pack/0/0/0"));
+    EXPECT_FALSE(TileArchiveFileSource::acceptsURL("file:///data/archive.mbtiles"));
+    EXPECT_FALSE(TileArchiveFileSource::acceptsURL("http://example.com/archive.mbtiles"));
+}
+
+TEST(TileArchiveFileSource, TEST_REQUIRES_WRITE(MBTiles)) {
+    util::RunLoop loop;
+    TileArchiveFileSource fs;
+    createMBTiles();
+
+    const std::string url = "mbtiles://" + toAbsolutePath(mbtilesPath);
+
+    Response res = request(fs, loop, Resource::source(url));
+    ASSERT_EQ(nullptr, res.error);
+    ASSERT_TRUE(res.data.get());
+    EXPECT_NE(std::string::npos, res.data->find("\"tiles\":[\"" + url + "/{z}/{x}/{y}\"]"));
+    EXPECT_NE(std::string::npos, res.data->find("\"name\":\"Archive\""));
+    EXPECT_NE(std::string::npos, res.data->find("\"maxzoom\":1"));
+    EXPECT_NE(std::string::npos, res.data->find("\"bounds\":[-180"));
+    EXPECT_EQ(std::string::npos, res.data->find("format"));
+
+    // Gzipped tiles are inflated.
+    res = request(fs, loop, Resource::tile(url + "/{z}/{x}/{y}.pbf", 1.0, 0, 0, 1, Tileset::Scheme::XYZ));
+    ASSERT_EQ(nullptr, res.error);
+    ASSERT_TRUE(res.data.get());
+    EXPECT_EQ("north west", *res.data);
+
+    res = request(fs, loop, Resource::tile(url + "/{z}/{x}/{y}", 1.0, 1, 0, 1, Tileset::Scheme::XYZ));
+    ASSERT_EQ(nullptr, res.error);
+    ASSERT_TRUE(res.data.get());
+    EXPECT_EQ("north east", *res.data);
+
+    res = request(fs, loop, Resource::tile(url + "/{z}/{x}/{y}", 1.0, 0, 1, 1, Tileset::Scheme::XYZ));
+    EXPECT_EQ(nullptr, res.error);
+    EXPECT_TRUE(res.noContent);
+    EXPECT_FALSE(res.data.get());
+
+    res = request(fs, loop, Resource::source("mbtiles://" + toAbsolutePath("test/fixtures/storage/missing.mbtiles")));
+    ASSERT_NE(nullptr, res.error);
+    EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+}
+
+TEST(TileArchiveFileSource, TEST_REQUIRES_WRITE(OfflinePack)) {
+    util::RunLoop loop;
+    TileArchiveFileSource fs;
+
+    Response tile;
+    tile.data = std::make_shared<std::string>("ocean");
+    OfflinePackWriter writer(packPath);
+    writer.add(Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, 0, 0, 1, Tileset::Scheme::XYZ), tile);
+    writer.finish();
+
+    const std::string url = "pack://" + toAbsolutePath(packPath);
+
+    Response res = request(fs, loop, Resource::tile(url + "/{z}/{x}/{y}.pbf", 1.0, 0, 0, 1, Tileset::Scheme::XYZ));
+    ASSERT_EQ(nullptr, res.error);
+    ASSERT_TRUE(res.data.get());
+    EXPECT_EQ("ocean", *res.data);
+
+    res = request(fs, loop, Resource::tile(url + "/{z}/{x}/{y}.pbf", 1.0, 1, 1, 1, Tileset::Scheme::XYZ));
+    EXPECT_EQ(nullptr, res.error);
+    EXPECT_TRUE(res.noContent);
+
+    // Packs have no metadata to describe them with.
+    res = request(fs, loop, Resource::source(url));
+    ASSERT_NE(nullptr, res.error);
+    EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+}
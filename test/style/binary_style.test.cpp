@@ -0,0 +1,187 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/binary_style.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/source_impl.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <dirent.h>
+#include <typeinfo>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+void expectSameLayers(const Parser& expected, const Parser& actual) {
+    ASSERT_EQ(expected.sources.size(), actual.sources.size());
+    for (std::size_t i = 0; i < expected.sources.size(); ++i) {
+        EXPECT_EQ(expected.sources[i]->getID(), actual.sources[i]->getID());
+        EXPECT_EQ(expected.sources[i]->baseImpl->type, actual.sources[i]->baseImpl->type);
+    }
+
+    ASSERT_EQ(expected.layers.size(), actual.layers.size());
+    for (std::size_t i = 0; i < expected.layers.size(); ++i) {
+        EXPECT_EQ(typeid(*expected.layers[i]), typeid(*actual.layers[i]));
+        const auto& expectedLayer = *expected.layers[i]->baseImpl;
+        const auto& actualLayer = *actual.layers[i]->baseImpl;
+        EXPECT_EQ(expectedLayer.id, actualLayer.id);
+        EXPECT_EQ(expectedLayer.ref, actualLayer.ref);
+        EXPECT_EQ(expectedLayer.source, actualLayer.source);
+        EXPECT_EQ(expectedLayer.sourceLayer, actualLayer.sourceLayer);
+        EXPECT_EQ(expectedLayer.filter, actualLayer.filter);
+        EXPECT_EQ(expectedLayer.minZoom, actualLayer.minZoom);
+        EXPECT_EQ(expectedLayer.maxZoom, actualLayer.maxZoom);
+        EXPECT_EQ(expectedLayer.visibility, actualLayer.visibility);
+    }
+}
+
+} // namespace
+
+TEST(BinaryStyle, Compile) {
+    const std::string json = R"STYLE({
+      "version": 8,
+      "name": "Test",
+      "center": [ 10, 20 ],
+      "zoom": 3,
+      "sprite": "mapbox://sprites/test",
+      "glyphs": "mapbox://fonts/test/{fontstack}/{range}.pbf",
+      "sources": {
+        "streets": { "type": "vector", "url": "mapbox://streets" },
+        "tiles": { "type": "raster", "tiles": [ "a.png", "b.png" ], "maxzoom": 14, "tileSize": 256 },
+        "points": { "type": "geojson", "data": { "type": "Point", "coordinates": [ 0, 0 ] } }
+      },
+      "layers": [{
+        "id": "water",
+        "type": "fill",
+        "source": "streets",
+        "source-layer": "water",
+        "filter": [ "all", [ "==", "$type", "Polygon" ], [ "in", "class", "lake", "river", 3 ] ],
+        "minzoom": 2,
+        "paint": {
+          "fill-color": { "property": "class", "type": "categorical", "stops": [ [ "lake", "blue" ] ] },
+          "fill-opacity": { "base": 1.5, "stops": [ [ 5, 0.5 ], [ 10, 1 ] ] }
+        },
+        "paint.night": {
+          "fill-color": "#000"
+        }
+      }, {
+        "id": "water-outline",
+        "ref": "water",
+        "paint": { "fill-opacity": 0.25 }
+      }, {
+        "id": "roads",
+        "type": "line",
+        "source": "streets",
+        "source-layer": "road",
+        "layout": { "line-cap": "round", "visibility": "none" },
+        "paint": { "line-dasharray": [ 2, 1 ], "line-translate": [ 1, 2 ] }
+      }, {
+        "id": "labels",
+        "type": "symbol",
+        "source": "streets",
+        "source-layer": "place",
+        "layout": {
+          "text-field": "{name}",
+          "text-font": [ "Open Sans Bold", "Arial Unicode MS Bold" ],
+          "text-offset": [ 0, 1.5 ]
+        }
+      }, {
+        "id": "invalid",
+        "type": "unknown"
+      }]
+    })STYLE";
+
+    const std::string compiled = compileStyle(json);
+    EXPECT_TRUE(isBinaryStyle(compiled));
+    EXPECT_FALSE(isBinaryStyle(json));
+    EXPECT_THROW(compileStyle(compiled), std::runtime_error);
+
+    Parser fromJSON;
+    ASSERT_FALSE(fromJSON.parse(json));
+    Parser fromBinary;
+    ASSERT_FALSE(fromBinary.parse(compiled));
+
+    EXPECT_EQ("Test", fromBinary.name);
+    EXPECT_EQ(fromJSON.latLng, fromBinary.latLng);
+    EXPECT_EQ(3, fromBinary.zoom);
+    EXPECT_EQ(fromJSON.spriteURL, fromBinary.spriteURL);
+    EXPECT_EQ(fromJSON.glyphURL, fromBinary.glyphURL);
+    EXPECT_EQ(fromJSON.visibleLayerSources, fromBinary.visibleLayerSources);
+    EXPECT_EQ(fromJSON.fontStacks(), fromBinary.fontStacks());
+
+    expectSameLayers(fromJSON, fromBinary);
+    ASSERT_EQ(4u, fromBinary.layers.size());
+
+    auto water = fromBinary.layers[0]->as<FillLayer>();
+    auto expectedWater = fromJSON.layers[0]->as<FillLayer>();
+    ASSERT_TRUE(water);
+    EXPECT_EQ(expectedWater->getFillColor(), water->getFillColor());
+    EXPECT_TRUE(water->getFillColor().isPropertyFunction());
+    EXPECT_EQ(expectedWater->getFillColor({ "night" }), water->getFillColor({ "night" }));
+    EXPECT_EQ(expectedWater->getFillOpacity(), water->getFillOpacity());
+
+    auto outline = fromBinary.layers[1]->as<FillLayer>();
+    ASSERT_TRUE(outline);
+    EXPECT_EQ("water", outline->getSourceLayer());
+    EXPECT_EQ(0.25f, outline->getFillOpacity().asConstant());
+
+    auto roads = fromBinary.layers[2]->as<LineLayer>();
+    auto expectedRoads = fromJSON.layers[2]->as<LineLayer>();
+    ASSERT_TRUE(roads);
+    EXPECT_EQ(VisibilityType::None, roads->getVisibility());
+    EXPECT_EQ(expectedRoads->getLineCap(), roads->getLineCap());
+    EXPECT_EQ(expectedRoads->getLineDasharray(), roads->getLineDasharray());
+    EXPECT_EQ(expectedRoads->getLineTranslate(), roads->getLineTranslate());
+
+    auto labels = fromBinary.layers[3]->as<SymbolLayer>();
+    auto expectedLabels = fromJSON.layers[3]->as<SymbolLayer>();
+    ASSERT_TRUE(labels);
+    EXPECT_EQ(expectedLabels->getTextField(), labels->getTextField());
+    EXPECT_EQ(expectedLabels->getTextFont(), labels->getTextFont());
+    EXPECT_EQ(expectedLabels->getTextOffset(), labels->getTextOffset());
+}
+
+TEST(BinaryStyle, Invalid) {
+    EXPECT_THROW(compileStyle("invalid"), std::runtime_error);
+
+    Parser parser;
+    EXPECT_TRUE(parser.parse(BinaryStyleMagic + "\xff"));
+}
+
+// Compiling the styles of the parser's fixtures keeps the sources and layers that parsing them does.
+TEST(BinaryStyle, StyleParserFixtures) {
+    const std::string ending = ".style.json";
+    const std::string directory = "test/fixtures/style_parser/";
+
+    std::vector<std::string> paths;
+    DIR *dir = opendir(directory.c_str());
+    ASSERT_TRUE(dir);
+    for (dirent *dp = nullptr; (dp = readdir(dir)) != nullptr;) {
+        const std::string name = dp->d_name;
+        if (name.length() >= ending.length() && name.compare(name.length() - ending.length(), ending.length(), ending) == 0) {
+            paths.push_back(directory + name);
+        }
+    }
+    closedir(dir);
+    ASSERT_GT(paths.size(), 0u);
+
+    for (const auto& path : paths) {
+        SCOPED_TRACE(path);
+        const std::string json = util::read_file(path);
+
+        Parser fromJSON;
+        if (fromJSON.parse(json)) {
+            EXPECT_THROW(compileStyle(json), std::runtime_error);
+            continue;
+        }
+
+        Parser fromBinary;
+        ASSERT_FALSE(fromBinary.parse(compileStyle(json)));
+        expectSameLayers(fromJSON, fromBinary);
+    }
+}
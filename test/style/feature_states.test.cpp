@@ -0,0 +1,38 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/feature_states.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+TEST(FeatureStates, SetAndGet) {
+    FeatureStates states;
+    EXPECT_TRUE(states.empty());
+    const uint64_t initialVersion = states.getVersion();
+
+    const Color red { 1, 0, 0, 1 };
+    EXPECT_TRUE(states.set(uint64_t(5), red));
+    EXPECT_FALSE(states.empty());
+    EXPECT_EQ(red, *states.get(uint64_t(5)));
+    EXPECT_NE(initialVersion, states.getVersion());
+
+    // Numeric IDs are compared by value.
+    EXPECT_EQ(red, *states.get(int64_t(5)));
+    EXPECT_EQ(red, *states.get(5.0));
+    EXPECT_FALSE(states.get(std::string("5")));
+
+    // Setting the same color doesn't change the version.
+    const uint64_t version = states.getVersion();
+    EXPECT_FALSE(states.set(int64_t(5), red));
+    EXPECT_EQ(version, states.getVersion());
+
+    EXPECT_TRUE(states.set(std::string("road"), Color { 0, 0, 1, 1 }));
+    EXPECT_EQ((Color { 0, 0, 1, 1 }), *states.get(std::string("road")));
+
+    // Unsetting a color removes the state.
+    EXPECT_TRUE(states.set(uint64_t(5), {}));
+    EXPECT_FALSE(states.get(uint64_t(5)));
+    EXPECT_FALSE(states.set(uint64_t(5), {}));
+    EXPECT_TRUE(states.set(std::string("road"), {}));
+    EXPECT_TRUE(states.empty());
+}
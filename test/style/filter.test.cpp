@@ -4,6 +4,7 @@
 
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/filter_evaluator.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion.hpp>
 #include <mbgl/style/conversion/filter.hpp>
@@ -59,6 +60,34 @@ TEST(Filter, InType) {
     ASSERT_TRUE(f(feature({{}}, Polygon<double>())));
 }
 
+TEST(Filter, InLargeList) {
+    std::string expression = "[\"in\", \"class\"";
+    for (int i = 0; i < 200; ++i) {
+        expression += ", " + std::to_string(i * 2) + ", \"c" + std::to_string(i) + "\"";
+    }
+    expression += ", false]";
+
+    Filter f = parse(expression.c_str());
+    ASSERT_TRUE(f.get<InFilter>().valueSet);
+    ASSERT_TRUE(f(feature({{ "class", std::string("c0") }})));
+    ASSERT_TRUE(f(feature({{ "class", std::string("c199") }})));
+    ASSERT_FALSE(f(feature({{ "class", std::string("c200") }})));
+    ASSERT_TRUE(f(feature({{ "class", uint64_t(398) }})));
+    ASSERT_TRUE(f(feature({{ "class", int64_t(2) }})));
+    ASSERT_TRUE(f(feature({{ "class", double(4) }})));
+    ASSERT_FALSE(f(feature({{ "class", uint64_t(3) }})));
+    ASSERT_FALSE(f(feature({{ "class", double(4.5) }})));
+    ASSERT_TRUE(f(feature({{ "class", false }})));
+    ASSERT_FALSE(f(feature({{ "class", true }})));
+    ASSERT_FALSE(f(feature({{}})));
+
+    // Numbers that doubles can't represent exactly are compared one by one.
+    Filter big = parse("[\"!in\", \"id\", 9007199254740993]");
+    ASSERT_FALSE(big.get<NotInFilter>().valueSet->isExact());
+    ASSERT_FALSE(big(feature({{ "id", uint64_t(9007199254740993ull) }})));
+    ASSERT_TRUE(big(feature({{ "id", uint64_t(9007199254740992ull) }})));
+}
+
 TEST(Filter, Any) {
     ASSERT_FALSE(parse("[\"any\"]")(feature({{}})));
     ASSERT_TRUE(parse("[\"any\", [\"==\", \"foo\", 1]]")(
@@ -123,3 +152,49 @@ TEST(Filter, ID) {
 
     ASSERT_FALSE(parse("[\"==\", \"$id\", 1234]")(feature2));
 }
+
+TEST(Filter, Compiled) {
+    const std::vector<Feature> features = {
+        feature({{}}),
+        feature({{ "foo", std::string("bar") }}),
+        feature({{ "foo", std::string("baz") }, { "bar", int64_t(-1) }}, LineString<double>()),
+        feature({{ "foo", int64_t(1) }, { "bar", true }}, Polygon<double>()),
+        feature({{ "foo", uint64_t(2) }, { "bar", false }}),
+        feature({{ "foo", double(1.5) }, { "bar", uint64_t(9007199254740993) }}),
+        feature({{ "foo", nullptr }}),
+    };
+
+    const char* expressions[] = {
+        R"(["==", "foo", "bar"])",
+        R"(["!=", "foo", 1])",
+        R"(["<", "foo", 2])",
+        R"(["<=", "foo", 1.5])",
+        R"([">", "bar", -2])",
+        R"([">=", "foo", "bar"])",
+        R"(["in", "foo", "baz", 2, true, "bar"])",
+        R"(["!in", "foo", 1, 1.5])",
+        R"(["in", "bar", 9007199254740992])",
+        R"(["in", "$type", "LineString", "Polygon"])",
+        R"(["has", "bar"])",
+        R"(["!has", "foo"])",
+        R"(["any", ["==", "bar", false], ["all", ["has", "foo"], ["<", "foo", 2]]])",
+        R"(["none", ["==", "$type", "Point"], ["==", "foo", "bar"]])",
+        R"(["all"])",
+        R"(["any"])",
+    };
+
+    for (const char* expression : expressions) {
+        const Filter filter = parse(expression);
+        const CompiledFilter compiled(filter);
+        for (const auto& f : features) {
+            const FeatureType type = apply_visitor(ToFeatureType(), f.geometry);
+            const bool expected = filter(f);
+            EXPECT_EQ(expected, compiled(type, f.id, [&] (std::size_t key) -> optional<Value> {
+                auto it = f.properties.find(compiled.getKeys()[key]);
+                if (it == f.properties.end())
+                    return {};
+                return it->second;
+            })) << expression;
+        }
+    }
+}
@@ -73,3 +73,67 @@ TEST(Function, Stops) {
     EXPECT_EQ("string2", evaluate(discrete_0, 9));
     EXPECT_EQ("string2", evaluate(discrete_0, 10));
 }
+
+TEST(Function, Table) {
+    const auto exact = [] (const auto& function, float zoom) {
+        using T = std::decay_t<decltype(function.getStops().front().second)>;
+        return PropertyEvaluator<T>(CalculationParameters(zoom), T())(function);
+    };
+
+    // Linear functions evaluate the same as without the table.
+    Function<float> linear({ { 0, 2 }, { 8, 10 }, { 10.5, 0 } }, 1);
+    auto linearTable = PropertyEvaluator<float>::createTable(linear);
+    ASSERT_TRUE(bool(linearTable));
+    for (float zoom = -1; zoom <= 12; zoom += 0.03125) {
+        ASSERT_NEAR(exact(linear, zoom), linearTable->evaluate(zoom), 0.0001) << zoom;
+    }
+
+    // Exponential functions are close to it.
+    Function<float> exponential({ { 5, 1 }, { 6, 2 }, { 20, 100 } }, 2);
+    auto exponentialTable = PropertyEvaluator<float>::createTable(exponential);
+    ASSERT_TRUE(bool(exponentialTable));
+    for (float zoom = 0; zoom <= 22; zoom += 0.01) {
+        ASSERT_NEAR(exact(exponential, zoom), exponentialTable->evaluate(zoom), 0.05) << zoom;
+    }
+
+    Function<Color> color({ { 5, { 0, 0, 0, 1 } }, { 10, { 1, 0.5, 0, 0.5 } } }, 1.5);
+    auto colorTable = PropertyEvaluator<Color>::createTable(color);
+    ASSERT_TRUE(bool(colorTable));
+    for (float zoom = 4; zoom <= 11; zoom += 0.01) {
+        const Color expected = exact(color, zoom);
+        const Color actual = colorTable->evaluate(zoom);
+        ASSERT_NEAR(expected.r, actual.r, 0.001) << zoom;
+        ASSERT_NEAR(expected.g, actual.g, 0.001) << zoom;
+        ASSERT_NEAR(expected.a, actual.a, 0.001) << zoom;
+    }
+
+    // There are no tables for stops between the steps, constants, or step functions.
+    EXPECT_FALSE(PropertyEvaluator<float>::createTable(Function<float>({ { 0, 1 }, { 1.01, 2 } }, 1)));
+    EXPECT_FALSE(PropertyEvaluator<float>::createTable(2.0f));
+    EXPECT_FALSE(PropertyEvaluator<std::string>::createTable(Function<std::string>({ { 0, "a" }, { 1, "b" } }, 1)));
+}
+
+TEST(Function, PropertyFunction) {
+    const Color green = { 0, 1, 0, 1 };
+    const Color red = { 1, 0, 0, 1 };
+    PropertyFunction<Color> function("type", {
+        { std::string("park"), green },
+        { uint64_t(2), red },
+    }, Color::black());
+
+    EXPECT_EQ(green, *function.evaluate(Value(std::string("park"))));
+    // Numbers are equal regardless of their type.
+    EXPECT_EQ(red, *function.evaluate(Value(2.0)));
+    EXPECT_EQ(red, *function.evaluate(Value(int64_t(2))));
+
+    // Other values and features without the property take the default.
+    EXPECT_EQ(Color::black(), *function.evaluate(Value(std::string("2"))));
+    EXPECT_EQ(Color::black(), *function.evaluate({}));
+    EXPECT_FALSE(PropertyFunction<Color>("type", {}).evaluate(Value(true)));
+
+    // Property functions don't depend on the zoom level; everything but buckets takes the default.
+    CalculationParameters parameters(10);
+    EXPECT_EQ(Color::black(), PropertyEvaluator<Color>(parameters, Color::white())(function));
+    EXPECT_EQ(Color::white(), PropertyEvaluator<Color>(parameters, Color::white())(PropertyFunction<Color>("type", {})));
+    EXPECT_TRUE(PropertyEvaluator<Color>::isZoomConstant(function, Color::white()));
+}
@@ -0,0 +1,130 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/sources/geojson_index.hpp>
+
+#include <supercluster.hpp>
+
+#include <limits>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+// A grid of points, one every two degrees.
+FeatureCollection grid() {
+    FeatureCollection features;
+    uint64_t id = 0;
+    for (double longitude = -170; longitude < 180; longitude += 2) {
+        for (double latitude = -70; latitude < 80; latitude += 2) {
+            features.push_back(Feature { mapbox::geometry::point<double>(longitude, latitude), {}, FeatureIdentifier(id++) });
+        }
+    }
+    return features;
+}
+
+std::size_t featureCount(const GeoJSONTileFeatures& parts) {
+    std::size_t count = 0;
+    for (const auto& part : parts) {
+        count += part->size();
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(GeoJSONIndex, LazyTilesMatchEagerTiles) {
+    GeoJSONOptions eagerOptions;
+    eagerOptions.maxzoom = 10;
+    GeoJSONIndex eager(eagerOptions, GeoJSON { grid() });
+
+    GeoJSONOptions lazyOptions = eagerOptions;
+    lazyOptions.lazyMemoryLimit = 16 * 1024;
+    lazyOptions.lazyZoom = 3;
+    GeoJSONIndex lazy(lazyOptions, GeoJSON { grid() });
+
+    for (const CanonicalTileID& tileID : { CanonicalTileID { 2, 1, 1 },
+                                           CanonicalTileID { 6, 31, 20 },
+                                           CanonicalTileID { 10, 511, 400 },
+                                           CanonicalTileID { 8, 200, 100 } }) {
+        EXPECT_EQ(featureCount(eager.getTile(tileID)), featureCount(lazy.getTile(tileID))) << tileID;
+    }
+}
+
+TEST(GeoJSONIndex, LazySlicesAreCapped) {
+    GeoJSONOptions options;
+    options.maxzoom = 12;
+    options.lazyMemoryLimit = 16 * 1024;
+    options.lazyZoom = 2;
+    GeoJSONIndex capped(options, GeoJSON { grid() });
+
+    options.lazyMemoryLimit = std::numeric_limits<std::size_t>::max();
+    GeoJSONIndex uncapped(options, GeoJSON { grid() });
+
+    const std::size_t featureBytes = capped.getMemoryUsage();
+    EXPECT_GT(featureBytes, 0u);
+    EXPECT_EQ(featureBytes, uncapped.getMemoryUsage());
+
+    // Tiles under every ancestor at zoom 2 are sliced, but only the most recently used slices are
+    // kept by the capped index.
+    for (uint32_t x = 0; x < 16; x++) {
+        for (uint32_t y = 0; y < 16; y++) {
+            capped.getTile(CanonicalTileID { 4, x, y });
+            uncapped.getTile(CanonicalTileID { 4, x, y });
+        }
+    }
+    EXPECT_GT(capped.getMemoryUsage(), featureBytes);
+    EXPECT_LT(capped.getMemoryUsage(), uncapped.getMemoryUsage());
+
+    // Slices dropped from the cache are sliced again.
+    EXPECT_EQ(featureCount(uncapped.getTile(CanonicalTileID { 4, 0, 8 })),
+              featureCount(capped.getTile(CanonicalTileID { 4, 0, 8 })));
+}
+
+TEST(GeoJSONIndex, TilesShareFeaturesWithIndex) {
+    GeoJSONOptions options;
+    std::unique_ptr<GeoJSONIndex> index = std::make_unique<GeoJSONIndex>(options, GeoJSON { grid() });
+
+    const CanonicalTileID tileID { 3, 2, 3 };
+    GeoJSONTileFeatures first = index->getTile(tileID);
+    GeoJSONTileFeatures second = index->getTile(tileID);
+    ASSERT_EQ(first.size(), second.size());
+    ASSERT_FALSE(first.empty());
+    for (std::size_t i = 0; i < first.size(); i++) {
+        EXPECT_EQ(first[i].get(), second[i].get());
+    }
+
+    // The features outlive the index.
+    const std::size_t count = featureCount(first);
+    index.reset();
+    EXPECT_EQ(count, featureCount(first));
+}
+
+TEST(GeoJSONIndex, DeferredClustering) {
+    GeoJSONOptions options;
+    options.cluster = true;
+    FeatureCollection features = grid();
+    GeoJSONIndex index(options, GeoJSON { features });
+
+    const CanonicalTileID tileID { 0, 0, 0 };
+    const std::size_t clusters = featureCount(index.getTile(tileID));
+    ASSERT_LT(0u, clusters);
+
+    // Removing features leaves the clusters as they are, until they're handed over.
+    index.deferClustering();
+    std::vector<FeatureIdentifier> ids;
+    for (const auto& feature : features) {
+        if (feature.geometry.get<mapbox::geometry::point<double>>().x < 0) {
+            ids.push_back(*feature.id);
+        }
+    }
+    index.removeFeatures(ids);
+    EXPECT_EQ(clusters, featureCount(index.getTile(tileID)));
+
+    const FeatureCollection remaining = index.getFeatures();
+    EXPECT_EQ(features.size() - ids.size(), remaining.size());
+
+    index.setClusters(GeoJSONIndex::cluster(options, remaining));
+    GeoJSONIndex expected(options, GeoJSON { remaining });
+    EXPECT_EQ(featureCount(expected.getTile(tileID)), featureCount(index.getTile(tileID)));
+}
@@ -0,0 +1,87 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/sources/geojson_reader.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+std::vector<Feature> read(const std::string& data) {
+    std::vector<Feature> features;
+    readGeoJSON(data, [&] (Feature&& feature) {
+        features.push_back(std::move(feature));
+    });
+    return features;
+}
+
+} // namespace
+
+TEST(GeoJSONReader, FeatureCollection) {
+    // The features may come before the type.
+    const auto features = read(R"JSON({
+        "features": [
+            { "type": "Feature", "id": 1, "properties": { "name": "a", "rank": -2, "tags": [ 1, "b" ] },
+              "geometry": { "type": "Point", "coordinates": [ 1.5, 2 ] } },
+            { "type": "Feature", "id": "two", "properties": null,
+              "geometry": { "type": "Polygon", "coordinates": [ [ [ 0, 0 ], [ 1, 0 ], [ 1, 1 ], [ 0, 0 ] ] ] } },
+            { "type": "Feature", "geometry": null }
+        ],
+        "type": "FeatureCollection"
+    })JSON");
+
+    ASSERT_EQ(3u, features.size());
+
+    EXPECT_EQ(FeatureIdentifier(uint64_t(1)), *features[0].id);
+    EXPECT_EQ(Value(std::string("a")), features[0].properties.at("name"));
+    EXPECT_EQ(Value(int64_t(-2)), features[0].properties.at("rank"));
+    EXPECT_EQ(Value(std::vector<Value> { uint64_t(1), std::string("b") }), features[0].properties.at("tags"));
+    ASSERT_TRUE(features[0].geometry.is<mapbox::geometry::point<double>>());
+    EXPECT_EQ(1.5, features[0].geometry.get<mapbox::geometry::point<double>>().x);
+    EXPECT_EQ(2.0, features[0].geometry.get<mapbox::geometry::point<double>>().y);
+
+    EXPECT_EQ(FeatureIdentifier(std::string("two")), *features[1].id);
+    EXPECT_TRUE(features[1].properties.empty());
+    ASSERT_TRUE(features[1].geometry.is<mapbox::geometry::polygon<double>>());
+    EXPECT_EQ(4u, features[1].geometry.get<mapbox::geometry::polygon<double>>().front().size());
+
+    EXPECT_FALSE(bool(features[2].id));
+    EXPECT_TRUE(features[2].geometry.is<mapbox::geometry::geometry_collection<double>>());
+}
+
+TEST(GeoJSONReader, SingleFeatureOrGeometry) {
+    const auto feature = read(R"JSON({ "type": "Feature", "properties": {},
+        "geometry": { "type": "MultiLineString", "coordinates": [ [ [ 0, 0 ], [ 1, 1 ] ], [ [ 2, 2 ], [ 3, 3 ] ] ] } })JSON");
+    ASSERT_EQ(1u, feature.size());
+    ASSERT_TRUE(feature[0].geometry.is<mapbox::geometry::multi_line_string<double>>());
+    EXPECT_EQ(2u, feature[0].geometry.get<mapbox::geometry::multi_line_string<double>>().size());
+
+    const auto geometry = read(R"JSON({ "type": "GeometryCollection", "geometries": [
+        { "type": "MultiPoint", "coordinates": [ [ 0, 0 ], [ 1, 1 ] ] },
+        { "type": "MultiPolygon", "coordinates": [ [ [ [ 0, 0 ], [ 1, 0 ], [ 1, 1 ], [ 0, 0 ] ] ] ] } ] })JSON");
+    ASSERT_EQ(1u, geometry.size());
+    ASSERT_TRUE(geometry[0].geometry.is<mapbox::geometry::geometry_collection<double>>());
+    EXPECT_EQ(2u, geometry[0].geometry.get<mapbox::geometry::geometry_collection<double>>().size());
+}
+
+TEST(GeoJSONReader, Errors) {
+    try {
+        read("CORRUPTED");
+        FAIL() << "expected a syntax error";
+    } catch (const GeoJSONSyntaxException& ex) {
+        EXPECT_EQ(std::string("0 - Invalid value."), ex.what());
+    }
+
+    EXPECT_THROW(read(R"JSON({ "type": "Point", "coordinates": [ 1 ] })JSON"), util::Exception);
+    EXPECT_THROW(read(R"JSON({ "type": "Curve", "coordinates": [ 1, 1 ] })JSON"), util::Exception);
+    EXPECT_THROW(read(R"JSON({ "type": "FeatureCollection" })JSON"), util::Exception);
+    EXPECT_THROW(read(R"JSON([ 1, 2 ])JSON"), util::Exception);
+
+    // The features read before the error have been handed over.
+    std::size_t count = 0;
+    EXPECT_THROW(readGeoJSON(R"JSON({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "geometry": { "type": "Point", "coordinates": [ 0, 0 ] } },
+        { "type": "Feature", "geometry": { "type": "Point" } } ] })JSON",
+        [&] (Feature&&) { count++; }), util::Exception);
+    EXPECT_EQ(1u, count);
+}
@@ -0,0 +1,99 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/paint_property.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+using namespace std::literals::chrono_literals;
+
+namespace {
+
+const TimePoint start = TimePoint(Duration::zero());
+
+float calculate(PaintProperty<float>& property, TimePoint now) {
+    CalculationParameters parameters(0, now, {}, Duration::zero());
+    property.calculate(parameters);
+    return property;
+}
+
+} // namespace
+
+TEST(PaintProperty, Transition) {
+    PaintProperty<float> property(0);
+    property.set(1.0f, {});
+    property.set(3.0f, std::string("red"));
+    property.setTransition({ optional<Duration>(10ms), optional<Duration>(10ms) }, std::string("red"));
+
+    property.cascade({ { ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(1.0f, calculate(property, start));
+    EXPECT_TRUE(property.isConstant());
+
+    // Transitions to the class's value after the delay.
+    const ClassID red = ClassDictionary::Get().lookup("red");
+    property.cascade({ { red, ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(1.0f, calculate(property, start + 5ms));
+    EXPECT_FALSE(property.isConstant());
+    const float halfway = calculate(property, start + 15ms);
+    EXPECT_LT(1.0f, halfway);
+    EXPECT_GT(3.0f, halfway);
+
+    // Cascading the same value again doesn't restart the transition.
+    property.cascade({ { red, ClassID::Default, ClassID::Fallback }, start + 15ms, {} });
+    EXPECT_EQ(halfway, calculate(property, start + 15ms));
+
+    EXPECT_EQ(3.0f, calculate(property, start + 20ms));
+    EXPECT_TRUE(property.isConstant());
+}
+
+TEST(PaintProperty, TransitionWindow) {
+    PaintProperty<float> property(0);
+    property.set(1.0f, {});
+    property.set(2.0f, std::string("a"));
+    property.set(3.0f, std::string("b"));
+    const ClassID a = ClassDictionary::Get().lookup("a");
+    const ClassID b = ClassDictionary::Get().lookup("b");
+    const TransitionOptions transition { optional<Duration>(Duration::zero()), optional<Duration>(100ms) };
+
+    // Switching classes faster than the transitions complete doesn't keep more values than the
+    // window holds, and still ends up at the last one.
+    TimePoint now = start;
+    for (int i = 0; i < 20; ++i, now += 1ms) {
+        property.cascade({ { i % 2 ? a : b, ClassID::Default, ClassID::Fallback }, now, transition });
+        const float value = calculate(property, now);
+        EXPECT_LE(0.0f, value);
+        EXPECT_GE(3.0f, value);
+    }
+    EXPECT_EQ(2.0f, calculate(property, now + 100ms));
+    EXPECT_TRUE(property.isConstant());
+}
+
+TEST(PaintProperty, CascadeClasses) {
+    PaintProperty<float> property(0);
+    property.set(1.0f, {});
+    property.set(2.0f, std::string("a"));
+    property.set(3.0f, std::string("b"));
+    const ClassID a = ClassDictionary::Get().lookup("a");
+    const ClassID b = ClassDictionary::Get().lookup("b");
+    const ClassID unrelated = ClassDictionary::Get().lookup("unrelated");
+
+    property.cascade({ { a, ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(2.0f, calculate(property, start));
+
+    // Classes without a value for the property don't change it.
+    property.cascade({ { unrelated, a, ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(2.0f, calculate(property, start));
+
+    // The order of the classes decides between those with values.
+    property.cascade({ { a, b, ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(2.0f, calculate(property, start));
+    property.cascade({ { b, a, ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(3.0f, calculate(property, start));
+
+    // Values set since the last cascade are cascaded even if the classes stay the same.
+    property.set(4.0f, std::string("b"));
+    property.cascade({ { b, a, ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(4.0f, calculate(property, start));
+
+    property.cascade({ { ClassID::Default, ClassID::Fallback }, start, {} });
+    EXPECT_EQ(1.0f, calculate(property, start));
+}
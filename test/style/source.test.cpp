@@ -15,6 +15,7 @@
 #include <mbgl/platform/log.hpp>
 
 #include <mbgl/map/transform.hpp>
+#include <mbgl/renderer/render_tile.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
@@ -142,6 +143,74 @@ TEST(Source, RasterTileEmpty) {
     test.run();
 }
 
+TEST(Source, RenderTilesKeptWhileUnchanged) {
+    SourceTest test;
+
+    test.fileSource.tileResponse = [&] (const Resource&) {
+        Response response;
+        response.noContent = true;
+        return response;
+    };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+
+    RasterSource source("source", tileset, 512);
+
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+        source.baseImpl->updateTiles(test.updateParameters);
+        const auto& renderTiles = source.baseImpl->getRenderTiles();
+        ASSERT_FALSE(renderTiles.empty());
+        const uint64_t generation = source.baseImpl->getRenderTilesGeneration();
+        const RenderTile* renderTile = &renderTiles.begin()->second;
+
+        // Updating again for the same viewport renders the same tiles, so the render tiles are
+        // kept as they are.
+        source.baseImpl->updateTiles(test.updateParameters);
+        EXPECT_EQ(generation, source.baseImpl->getRenderTilesGeneration());
+        EXPECT_EQ(renderTile, &source.baseImpl->getRenderTiles().begin()->second);
+
+        test.end();
+    };
+
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->updateTiles(test.updateParameters);
+
+    const uint64_t initial = source.baseImpl->getRenderTilesGeneration();
+    test.run();
+    EXPECT_NE(initial, source.baseImpl->getRenderTilesGeneration());
+}
+
+TEST(Source, ParentTilePrefetch) {
+    SourceTest test;
+    test.transform.setZoom(4);
+    test.transformState = test.transform.getState();
+    test.updateParameters.prefetchParents = true;
+
+    std::set<int8_t> zooms;
+    test.fileSource.tileResponse = [&] (const Resource& resource) {
+        zooms.insert(resource.tileData->z);
+        if (zooms.count(2) && zooms.count(0)) {
+            test.end();
+        }
+        return optional<Response>();
+    };
+
+    Tileset tileset;
+    tileset.tiles = { "tiles" };
+
+    RasterSource source("source", tileset, 512);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->updateTiles(test.updateParameters);
+
+    test.run();
+
+    // Only the ideal tiles and their parents two and four zoom levels up are requested.
+    EXPECT_EQ((std::set<int8_t> { 0, 2, 4 }), zooms);
+}
+
 TEST(Source, VectorTileEmpty) {
     SourceTest test;
 
@@ -415,3 +484,127 @@ TEST(Source, GeoJSonSourceUrlUpdate) {
 
     test.run();
 }
+
+TEST(Source, GeoJSONSourceUpdateFeatures) {
+    SourceTest test;
+    test.transform.setLatLngZoom({ 0, 0 }, 1);
+    test.transformState = test.transform.getState();
+
+    // Tiles are complete as soon as they're laid out.
+    style::UpdateParameters parameters {
+        1.0,
+        MapDebugOptions(),
+        test.transformState,
+        test.threadPool,
+        test.fileSource,
+        MapMode::Still,
+        test.annotationManager,
+        test.style
+    };
+
+    auto point = [] (uint64_t id, double longitude, double latitude) {
+        return mbgl::Feature { mapbox::geometry::point<double>(longitude, latitude), {}, FeatureIdentifier(id) };
+    };
+
+    GeoJSONSource source("source");
+    source.setGeoJSON(FeatureCollection { point(1, -90, 60), point(2, 90, -60) });
+
+    // Whether each of the four tiles at zoom level 1 was reloaded.
+    auto reloaded = [&] {
+        std::vector<bool> result;
+        for (const auto& pair : source.baseImpl->getRenderTiles()) {
+            result.push_back(!pair.second.tile.isComplete());
+        }
+        return result;
+    };
+
+    bool updated = false;
+    test.observer.tileChanged = [&] (Source&, const OverscaledTileID&) {
+        source.baseImpl->updateTiles(parameters);
+        const auto& renderTiles = source.baseImpl->getRenderTiles();
+        if (updated || renderTiles.size() != 4 ||
+            std::any_of(renderTiles.begin(), renderTiles.end(),
+                        [] (const auto& pair) { return !pair.second.tile.isComplete(); })) {
+            return;
+        }
+        updated = true;
+
+        // Moving the point in the tile at the top left only reloads that tile; the render tiles
+        // are ordered by x, then y.
+        source.updateFeatures({ point(1, -80, 50) });
+        EXPECT_EQ((std::vector<bool> { true, false, false, false }), reloaded());
+
+        // So does removing the point at the bottom right for its tile.
+        source.removeFeatures({ FeatureIdentifier(uint64_t(2)) });
+        EXPECT_EQ((std::vector<bool> { true, false, false, true }), reloaded());
+
+        // Unknown ids change nothing.
+        source.removeFeatures({ FeatureIdentifier(uint64_t(3)) });
+        EXPECT_EQ((std::vector<bool> { true, false, false, true }), reloaded());
+
+        test.end();
+    };
+
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+    source.baseImpl->updateTiles(parameters);
+
+    test.run();
+}
+
+TEST(Source, GeoJSONSourceUrlOnWorker) {
+    SourceTest test;
+
+    test.fileSource.sourceResponse = [&] (const Resource& resource) {
+        EXPECT_EQ("url", resource.url);
+        Response response;
+        response.data = std::make_unique<std::string>("{\"geometry\": {\"type\": \"Point\", \"coordinates\": [1.1, 1.1]}, \"type\": \"Feature\", \"properties\": {}}");
+        return response;
+    };
+
+    GeoJSONSource source("source");
+
+    test.observer.sourceError = [&] (Source&, std::exception_ptr error) {
+        FAIL() << util::toString(error);
+        test.end();
+    };
+
+    test.observer.sourceLoaded = [&] (Source&) {
+        EXPECT_TRUE(source.baseImpl->loaded);
+        test.end();
+    };
+
+    source.setURL("url", test.threadPool);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+
+    // The data is indexed on the worker.
+    EXPECT_FALSE(source.baseImpl->loaded);
+
+    test.run();
+}
+
+TEST(Source, GeoJSONSourceCorruptOnWorker) {
+    SourceTest test;
+
+    test.fileSource.sourceResponse = [&] (const Resource&) {
+        Response response;
+        response.data = std::make_unique<std::string>("CORRUPTED");
+        return response;
+    };
+
+    GeoJSONSource source("source");
+
+    test.observer.sourceError = [&] (Source& errored, std::exception_ptr error) {
+        EXPECT_EQ("source", errored.getID());
+        EXPECT_EQ("0 - Invalid value.", util::toString(error));
+        EXPECT_FALSE(source.baseImpl->loaded);
+        test.end();
+    };
+
+    source.setURL("url", test.threadPool);
+    source.baseImpl->setObserver(&test.observer);
+    source.baseImpl->loadDescription(test.fileSource);
+
+    test.run();
+}
@@ -4,9 +4,15 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/layer.hpp>
+#include <mbgl/style/layers/background_layer.hpp>
+#include <mbgl/style/layers/background_layer_impl.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <set>
+
 using namespace mbgl;
 using namespace mbgl::style;
 
@@ -113,3 +119,178 @@ TEST(Style, Properties) {
     ASSERT_EQ(0, style.getDefaultZoom());
     ASSERT_EQ(0, style.getDefaultPitch());
 }
+
+TEST(Style, PrefetchSourceDescriptions) {
+    util::RunLoop loop;
+
+    StubFileSource fileSource;
+    Style style { fileSource, 1.0 };
+
+    std::set<std::string> requested;
+    fileSource.sourceResponse = [&] (const Resource& resource) -> optional<Response> {
+        requested.insert(resource.url);
+        loop.stop();
+        return {};
+    };
+
+    style.setJSON(R"STYLE({
+      "version": 8,
+      "sources": {
+        "visible": { "type": "vector", "url": "visible.json" },
+        "hidden": { "type": "vector", "url": "hidden.json" }
+      },
+      "layers": [{
+        "id": "visible",
+        "type": "line",
+        "source": "visible",
+        "source-layer": "roads"
+      }, {
+        "id": "hidden",
+        "type": "line",
+        "source": "hidden",
+        "source-layer": "roads",
+        "layout": { "visibility": "none" }
+      }]
+    })STYLE");
+
+    // The description of the source of the visible layer is requested before the first layout.
+    loop.run();
+    EXPECT_EQ(std::set<std::string>({ "visible.json" }), requested);
+}
+
+TEST(Style, UpdateJSON) {
+    util::RunLoop loop;
+
+    StubFileSource fileSource;
+    Style style { fileSource, 1.0 };
+
+    style.setJSON(R"STYLE({
+      "version": 8,
+      "sprite": "sprite",
+      "sources": {
+        "streets": { "type": "vector", "url": "streets.json" },
+        "satellite": { "type": "raster", "url": "satellite.json" }
+      },
+      "layers": [{
+        "id": "water",
+        "type": "fill",
+        "source": "streets",
+        "source-layer": "water",
+        "paint": { "fill-color": "blue" }
+      }, {
+        "id": "roads",
+        "type": "line",
+        "source": "streets",
+        "source-layer": "roads",
+        "layout": { "line-cap": "round" }
+      }, {
+        "id": "imagery",
+        "type": "raster",
+        "source": "satellite"
+      }]
+    })STYLE");
+
+    Source* streets = style.getSource("streets");
+    Layer* water = style.getLayer("water");
+    Layer* roads = style.getLayer("roads");
+    ASSERT_TRUE(streets);
+    ASSERT_TRUE(water);
+    ASSERT_TRUE(roads);
+
+    EXPECT_TRUE(style.updateJSON(R"STYLE({
+      "version": 8,
+      "sprite": "sprite",
+      "sources": {
+        "streets": { "type": "vector", "url": "streets.json" }
+      },
+      "layers": [{
+        "id": "roads",
+        "type": "line",
+        "source": "streets",
+        "source-layer": "roads",
+        "filter": [ "==", "class", "street" ]
+      }, {
+        "id": "water",
+        "type": "fill",
+        "source": "streets",
+        "source-layer": "water",
+        "paint": { "fill-color": "black" }
+      }, {
+        "id": "buildings",
+        "type": "fill",
+        "source": "streets",
+        "source-layer": "building"
+      }]
+    })STYLE"));
+
+    // The unchanged source and the layers that keep their type and source stay.
+    EXPECT_EQ(streets, style.getSource("streets"));
+    EXPECT_FALSE(style.getSource("satellite"));
+    EXPECT_EQ(water, style.getLayer("water"));
+    EXPECT_EQ(roads, style.getLayer("roads"));
+    EXPECT_FALSE(style.getLayer("imagery"));
+
+    auto layers = style.getLayers();
+    ASSERT_EQ(3u, layers.size());
+    EXPECT_EQ("roads", layers[0]->getID());
+    EXPECT_EQ("water", layers[1]->getID());
+    EXPECT_EQ("buildings", layers[2]->getID());
+
+    EXPECT_EQ(Color::black(), water->as<FillLayer>()->getFillColor().asConstant());
+    EXPECT_TRUE(roads->as<LineLayer>()->getLineCap().isUndefined());
+    EXPECT_EQ(Filter(EqualsFilter { "class", std::string("street") }), roads->as<LineLayer>()->getFilter());
+
+    // A different sprite needs a full reload.
+    EXPECT_FALSE(style.updateJSON(R"STYLE({ "version": 8, "sprite": "other" })STYLE"));
+    EXPECT_EQ(3u, style.getLayers().size());
+}
+
+TEST(Style, RecalculateTransitioningLayers) {
+    util::RunLoop loop;
+
+    StubFileSource fileSource;
+    Style style { fileSource, 1.0 };
+    style.setJSON(R"STYLE({
+      "version": 8,
+      "sources": {},
+      "layers": [{
+        "id": "fading",
+        "type": "background",
+        "paint": { "background-opacity": 1 }
+      }, {
+        "id": "zoomed",
+        "type": "background",
+        "paint": { "background-opacity": { "stops": [ [ 0, 0 ], [ 10, 1 ] ] } }
+      }]
+    })STYLE");
+
+    auto fading = style.getLayer("fading")->as<BackgroundLayer>();
+    auto zoomed = style.getLayer("zoomed")->as<BackgroundLayer>();
+
+    const auto now = Clock::now();
+    style.cascade(now, MapMode::Continuous);
+    style.recalculate(5, now, MapMode::Continuous);
+    EXPECT_FALSE(style.hasTransitions());
+    EXPECT_FLOAT_EQ(0.5f, zoomed->impl->paint.backgroundOpacity.value);
+
+    style.setTransitionOptions({ Milliseconds(100), Milliseconds(0) });
+    fading->setBackgroundOpacity(0.0f);
+    style.cascade(now, MapMode::Continuous);
+    style.recalculate(5, now, MapMode::Continuous);
+    EXPECT_TRUE(style.hasTransitions());
+
+    // At the same zoom level, only the transitioning layer is calculated again, until its
+    // transition is complete.
+    style.recalculate(5, now + Milliseconds(50), MapMode::Continuous);
+    EXPECT_TRUE(style.hasTransitions());
+    EXPECT_GT(1.0f, fading->impl->paint.backgroundOpacity.value);
+    EXPECT_LT(0.0f, fading->impl->paint.backgroundOpacity.value);
+
+    style.recalculate(5, now + Milliseconds(100), MapMode::Continuous);
+    EXPECT_FALSE(style.hasTransitions());
+    EXPECT_EQ(0.0f, fading->impl->paint.backgroundOpacity.value);
+
+    // Changing the zoom level calculates all layers again.
+    style.recalculate(10, now + Milliseconds(150), MapMode::Continuous);
+    EXPECT_FLOAT_EQ(1.0f, zoomed->impl->paint.backgroundOpacity.value);
+}
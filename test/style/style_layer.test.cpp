@@ -6,6 +6,8 @@
 #include <mbgl/style/layers/circle_layer_impl.hpp>
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/style/layers/custom_layer_impl.hpp>
+#include <mbgl/style/layers/dynamic_point_layer.hpp>
+#include <mbgl/style/layers/dynamic_point_layer_impl.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/fill_layer_impl.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
@@ -14,6 +16,8 @@
 #include <mbgl/style/layers/raster_layer_impl.hpp>
 #include <mbgl/style/layers/symbol_layer.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/style/cascade_parameters.hpp>
+#include <mbgl/style/calculation_parameters.hpp>
 #include <mbgl/util/color.hpp>
 
 using namespace mbgl;
@@ -58,6 +62,7 @@ TEST(Layer, Clone) {
     testClone<BackgroundLayer>("background");
     testClone<CircleLayer>("circle", "source");
     testClone<CustomLayer>("custom", [](void*){}, [](void*, const CustomLayerRenderParameters&){}, [](void*){}, nullptr),
+    testClone<DynamicPointLayer>("dynamic");
     testClone<FillLayer>("fill", "source");
     testClone<LineLayer>("line", "source");
     testClone<RasterLayer>("raster", "source");
@@ -133,6 +138,35 @@ TEST(Layer, FillProperties) {
     EXPECT_EQ(layer->getFillTranslateAnchor().asConstant(), translateAnchor.asConstant());
 }
 
+TEST(Layer, ConstantProperties) {
+    auto layer = std::make_unique<FillLayer>("fill", "source");
+    const CascadeParameters cascade { { ClassID::Default, ClassID::Fallback }, TimePoint(), TransitionOptions() };
+    const CalculationParameters calculation(10);
+
+    layer->impl->cascade(cascade);
+    EXPECT_FALSE(layer->impl->hasConstantProperties());
+    layer->impl->recalculate(calculation);
+    EXPECT_TRUE(layer->impl->hasConstantProperties());
+
+    // Functions of the zoom level need to be recalculated.
+    layer->setFillOpacity(Function<float>({ { 0, 0 }, { 20, 1 } }, 1));
+    layer->impl->cascade(cascade);
+    layer->impl->recalculate(calculation);
+    EXPECT_FALSE(layer->impl->hasConstantProperties());
+
+    // So do patterns, which are scaled by the zoom level.
+    layer->setFillOpacity(opacity);
+    layer->setFillPattern(pattern);
+    layer->impl->cascade(cascade);
+    layer->impl->recalculate(calculation);
+    EXPECT_FALSE(layer->impl->hasConstantProperties());
+
+    layer->setFillPattern(std::string());
+    layer->impl->cascade(cascade);
+    layer->impl->recalculate(calculation);
+    EXPECT_TRUE(layer->impl->hasConstantProperties());
+}
+
 TEST(Layer, LineProperties) {
     auto layer = std::make_unique<LineLayer>("line", "source");
     EXPECT_TRUE(layer->is<LineLayer>());
@@ -268,3 +302,206 @@ TEST(Layer, Observer) {
     layer->setLineCap(lineCap);
     EXPECT_FALSE(layoutPropertyChanged);
 }
+
+TEST(Layer, DynamicPoints) {
+    auto layer = std::make_unique<DynamicPointLayer>("dynamic");
+    StubLayerObserver observer;
+    layer->baseImpl->setObserver(&observer);
+
+    std::size_t dataChanged = 0;
+    observer.layerDataChanged = [&] (Layer& layer_) {
+        EXPECT_EQ(layer.get(), &layer_);
+        dataChanged++;
+    };
+
+    layer->setPoints({ { 0, 0 }, { 10, 20 }, { -30, 40 } });
+    EXPECT_EQ(1u, dataChanged);
+    EXPECT_EQ(3u, layer->getPointCount());
+    EXPECT_NEAR(20, layer->getPoint(1).longitude, 1e-9);
+    EXPECT_NEAR(10, layer->getPoint(1).latitude, 1e-9);
+    EXPECT_EQ(1u, layer->impl->generation);
+
+    // Moving points only marks them as moved.
+    layer->setPoint(2, { 50, 60 });
+    layer->setPoint(1, { 5, 6 });
+    EXPECT_EQ(3u, dataChanged);
+    EXPECT_NEAR(60, layer->getPoint(2).longitude, 1e-9);
+    EXPECT_EQ(1u, layer->impl->generation);
+    EXPECT_EQ(1u, layer->impl->movedBegin);
+    EXPECT_EQ(3u, layer->impl->movedEnd);
+
+    // As does replacing them with as many.
+    layer->setPoints({ { 1, 1 }, { 2, 2 }, { 3, 3 } });
+    EXPECT_EQ(1u, layer->impl->generation);
+    EXPECT_EQ(0u, layer->impl->movedBegin);
+
+    layer->setPoints({ { 1, 1 } });
+    EXPECT_EQ(2u, layer->impl->generation);
+
+    EXPECT_THROW(layer->setPoint(1, { 0, 0 }), std::out_of_range);
+
+    // Copies have a buffer of their own.
+    EXPECT_NE(layer->impl->serial, static_cast<DynamicPointLayer&>(*layer->baseImpl->clone()).impl->serial);
+}
+
+TEST(Layer, LayoutDifference) {
+    auto layer = std::make_unique<LineLayer>("line", "source");
+    auto other = layer->baseImpl->clone();
+    auto& otherLine = *other->as<LineLayer>();
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    // Paint properties don't affect buckets.
+    otherLine.setLineColor(color);
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    otherLine.setLineCap(lineCap);
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+    layer->setLineCap(lineCap);
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    otherLine.setFilter(HasFilter { "foo" });
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+    layer->setFilter(HasFilter { "foo" });
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    otherLine.setSourceLayer("foo");
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+}
+
+TEST(Layer, DataDrivenColor) {
+    const auto function = PropertyValue<Color>(PropertyFunction<Color>("type", {
+        { std::string("park"), Color { 0, 1, 0, 1 } },
+    }));
+
+    auto layer = std::make_unique<FillLayer>("fill", "source");
+    auto other = layer->baseImpl->clone();
+    StubLayerObserver observer;
+    layer->baseImpl->setObserver(&observer);
+
+    // Buckets hold the colors of a property function, so setting one lays them out again.
+    bool layoutPropertyChanged = false;
+    observer.layerLayoutPropertyChanged = [&] (Layer&) {
+        layoutPropertyChanged = true;
+    };
+    layer->setFillColor(function);
+    EXPECT_TRUE(layoutPropertyChanged);
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    other->as<FillLayer>()->setFillColor(function);
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    // Replacing it with a constant does, too.
+    layoutPropertyChanged = false;
+    layer->setFillColor(color);
+    EXPECT_TRUE(layoutPropertyChanged);
+
+    // Constant colors don't.
+    layoutPropertyChanged = false;
+    layer->setFillColor(PropertyValue<Color> {{ 0, 0, 1, 1 }});
+    EXPECT_FALSE(layoutPropertyChanged);
+
+    auto circle = std::make_unique<CircleLayer>("circle", "source");
+    auto otherCircle = circle->baseImpl->clone();
+    circle->setCircleColor(function);
+    EXPECT_TRUE(circle->baseImpl->hasLayoutDifference(*otherCircle->baseImpl));
+}
+
+TEST(Layer, FeatureCategories) {
+    auto layer = std::make_unique<FillLayer>("fill", "source");
+    auto other = layer->baseImpl->clone();
+    StubLayerObserver observer;
+    layer->baseImpl->setObserver(&observer);
+
+    bool layoutPropertyChanged = false;
+    observer.layerLayoutPropertyChanged = [&] (Layer&) {
+        layoutPropertyChanged = true;
+    };
+    bool paintPropertyChanged = false;
+    observer.layerPaintPropertyChanged = [&] (Layer&) {
+        paintPropertyChanged = true;
+    };
+
+    // Buckets hold the categories of the features, so assigning them lays them out again.
+    const std::vector<Value> values { std::string("park"), std::string("water") };
+    layer->setFeatureCategories("class", values);
+    EXPECT_TRUE(layoutPropertyChanged);
+    EXPECT_EQ("class", layer->getFeatureCategoryProperty());
+    EXPECT_EQ(values, layer->getFeatureCategoryValues());
+    EXPECT_TRUE(layer->impl->hasFeatureCategories());
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    other->as<FillLayer>()->setFeatureCategories("class", values);
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    layoutPropertyChanged = false;
+    layer->setFeatureCategories("class", values);
+    EXPECT_FALSE(layoutPropertyChanged);
+
+    // Toggling and highlighting categories only changes uniforms.
+    EXPECT_EQ(0xFFFFFFFFu, layer->getVisibleFeatureCategories());
+    layer->setVisibleFeatureCategories(0b10);
+    layer->setHighlightedFeatureCategories(0b01);
+    layer->setFeatureHighlightColor({ 0, 0, 1, 1 });
+    EXPECT_TRUE(paintPropertyChanged);
+    EXPECT_FALSE(layoutPropertyChanged);
+    EXPECT_EQ(0b10u, layer->getVisibleFeatureCategories());
+    EXPECT_EQ(0b01u, layer->getHighlightedFeatureCategories());
+    EXPECT_EQ((Color { 0, 0, 1, 1 }), layer->getFeatureHighlightColor());
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    paintPropertyChanged = false;
+    layer->setVisibleFeatureCategories(0b10);
+    EXPECT_FALSE(paintPropertyChanged);
+
+    // Data-driven colors take precedence.
+    layer->setFillColor(PropertyValue<Color>(PropertyFunction<Color>("type", {
+        { std::string("park"), Color { 0, 1, 0, 1 } },
+    })));
+    EXPECT_FALSE(layer->impl->hasFeatureCategories());
+}
+
+TEST(Layer, FeatureStateColors) {
+    auto layer = std::make_unique<FillLayer>("fill", "source");
+    auto other = layer->baseImpl->clone();
+    StubLayerObserver observer;
+    layer->baseImpl->setObserver(&observer);
+
+    // Buckets record the IDs of the features only for layers with feature state colors.
+    bool layoutPropertyChanged = false;
+    observer.layerLayoutPropertyChanged = [&] (Layer&) {
+        layoutPropertyChanged = true;
+    };
+    layer->setFeatureStateColors(true);
+    EXPECT_TRUE(layoutPropertyChanged);
+    EXPECT_TRUE(layer->getFeatureStateColors());
+    EXPECT_TRUE(layer->impl->hasFeatureStateColors());
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    other->as<FillLayer>()->setFeatureStateColors(true);
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    // Feature categories take precedence.
+    layer->setFeatureCategories("class", { std::string("park") });
+    EXPECT_FALSE(layer->impl->hasFeatureStateColors());
+}
+
+TEST(Layer, Pickable) {
+    auto layer = std::make_unique<FillLayer>("fill", "source");
+    auto other = layer->baseImpl->clone();
+    StubLayerObserver observer;
+    layer->baseImpl->setObserver(&observer);
+
+    // Buckets record the features to pick only for pickable layers.
+    bool layoutPropertyChanged = false;
+    observer.layerLayoutPropertyChanged = [&] (Layer&) {
+        layoutPropertyChanged = true;
+    };
+    EXPECT_FALSE(layer->getPickable());
+    layer->setPickable(true);
+    EXPECT_TRUE(layoutPropertyChanged);
+    EXPECT_TRUE(layer->getPickable());
+    EXPECT_TRUE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+
+    other->as<FillLayer>()->setPickable(true);
+    EXPECT_FALSE(layer->baseImpl->hasLayoutDifference(*other->baseImpl));
+}
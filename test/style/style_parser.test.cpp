@@ -2,6 +2,8 @@
 #include <mbgl/test/fixture_log_observer.hpp>
 
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/platform/default/thread_pool.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/enum.hpp>
 #include <mbgl/util/string.hpp>
@@ -102,3 +104,40 @@ TEST(StyleParser, FontStacks) {
     ASSERT_EQ(FontStack({"a", "b"}), result[1]);
     ASSERT_EQ(FontStack({"a", "b", "c"}), result[2]);
 }
+
+TEST(StyleParser, ParallelLayers) {
+    std::string json = R"STYLE({ "version": 8, "sources": { "s": { "type": "vector", "tiles": [] } }, "layers": [)STYLE";
+    for (int i = 0; i < 50; ++i) {
+        json += R"STYLE({ "id": "fill-)STYLE" + util::toString(i) + R"STYLE(", "type": "fill", "source": "s",
+            "source-layer": "l", "paint": { "fill-opacity": 0.5 } },)STYLE";
+    }
+    json += R"STYLE(
+        { "id": "ref", "ref": "fill-3", "paint": { "fill-opacity": 0.25 } },
+        { "id": "classes", "type": "fill", "source": "s", "paint.night": { "fill-color": "blue" } },
+        { "id": "invalid", "type": "unknown" }
+    ] })STYLE";
+
+    ThreadPool threadPool { 4 };
+    style::Parser parallel;
+    ASSERT_FALSE(parallel.parse(json, &threadPool));
+    style::Parser serial;
+    ASSERT_FALSE(serial.parse(json));
+
+    // The layers are the same, in the same order, regardless of the threads they're converted on.
+    ASSERT_EQ(52u, parallel.layers.size());
+    ASSERT_EQ(serial.layers.size(), parallel.layers.size());
+    for (std::size_t i = 0; i < parallel.layers.size(); ++i) {
+        EXPECT_EQ(serial.layers[i]->getID(), parallel.layers[i]->getID());
+    }
+
+    auto ref = parallel.layers[50]->as<style::FillLayer>();
+    ASSERT_TRUE(ref);
+    EXPECT_EQ("ref", ref->getID());
+    EXPECT_EQ("l", ref->getSourceLayer());
+    EXPECT_EQ(0.25f, ref->getFillOpacity().asConstant());
+
+    // Class names are numbered on the calling thread.
+    auto classes = parallel.layers[51]->as<style::FillLayer>();
+    ASSERT_TRUE(classes);
+    EXPECT_EQ(*Color::parse("blue"), classes->getFillColor(std::string("night")).asConstant());
+}
@@ -0,0 +1,137 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/collision_grid.hpp>
+#include <mbgl/math/minmax.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+std::vector<uint32_t> query(const CollisionGrid& grid, const CollisionGrid::Box& box) {
+    std::vector<uint32_t> result;
+    grid.query(box, [&] (uint32_t id) {
+        result.push_back(id);
+        return true;
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// A box with its anchor at the top left corner.
+CollisionBox makeBox(float x1, float y1, float x2, float y2) {
+    return CollisionBox({ x1, y1 }, 0, 0, x2 - x1, y2 - y1, std::numeric_limits<float>::infinity());
+}
+
+void insert(CollisionGrid& grid, uint32_t id, const CollisionBox& box) {
+    grid.insert(id, box.anchor, box);
+}
+
+} // namespace
+
+TEST(CollisionGrid, Query) {
+    CollisionGrid grid(100, 1);
+    insert(grid, 0, makeBox(10, 10, 20, 20));
+    insert(grid, 1, makeBox(50, 50, 350, 250)); // Spans several cells.
+    insert(grid, 2, makeBox(-250, -150, -200, -100)); // Grows the grid.
+    EXPECT_EQ(3u, grid.size());
+
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), query(grid, { 0, 0, 15, 15 }));
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1 }), query(grid, { 0, 0, 400, 400 }));
+    EXPECT_EQ(std::vector<uint32_t>({ 1 }), query(grid, { 300, 200, 400, 400 }));
+    EXPECT_EQ(std::vector<uint32_t>({ 2 }), query(grid, { -300, -300, -220, -120 }));
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2 }), query(grid, { -1000, -1000, 1000, 1000 }));
+    EXPECT_EQ(std::vector<uint32_t>(), query(grid, { 21, 21, 49, 49 }));
+    EXPECT_EQ(std::vector<uint32_t>(), query(grid, { 5000, 5000, 6000, 6000 }));
+
+    // Touching boxes intersect.
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), query(grid, { 20, 20, 30, 30 }));
+}
+
+TEST(CollisionGrid, Stretch) {
+    CollisionGrid grid(100, 2);
+    insert(grid, 0, CollisionBox({ 0, 100 }, -10, -10, 10, 10, 1));
+
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), query(grid, { 0, 115, 0, 115 }));
+    EXPECT_EQ(std::vector<uint32_t>(), query(grid, { 0, 125, 0, 125 }));
+}
+
+TEST(CollisionGrid, Stop) {
+    CollisionGrid grid(100, 1);
+    for (uint32_t id = 0; id < 10; ++id) {
+        insert(grid, id, makeBox(0, 0, 250, 250));
+    }
+
+    std::size_t calls = 0;
+    grid.query({ 0, 0, 250, 250 }, [&] (uint32_t) {
+        return ++calls < 3;
+    });
+    EXPECT_EQ(3u, calls);
+}
+
+TEST(CollisionGrid, FarAway) {
+    const float infinity = std::numeric_limits<float>::infinity();
+    CollisionGrid grid(100, 1);
+    insert(grid, 0, makeBox(1e9f, 1e9f, 1e9f + 1000, 1e9f + 1000));
+    grid.insert(1, { 0, 0 }, CollisionBox({ 0, 0 }, -infinity, 0, infinity, 10, infinity));
+
+    // Boxes beyond the grid share its outermost cells, but are still only reported where they are.
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1 }), query(grid, { -infinity, -infinity, infinity, infinity }));
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), query(grid, { 1e9f, 1e9f, 1e9f, 1e9f }));
+    EXPECT_EQ(std::vector<uint32_t>(), query(grid, { 1e8f, 1e8f, 1e8f, 1e8f }));
+    EXPECT_EQ(std::vector<uint32_t>({ 1 }), query(grid, { 5, 5, 5, 5 }));
+}
+
+TEST(CollisionGrid, FindPlacementScale) {
+    // The result matches testing each intersecting box in turn, however many share a cell.
+    const float yStretch = 1.5f;
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> position(0, 2000);
+    std::uniform_real_distribution<float> size(10, 200);
+    std::uniform_real_distribution<float> scale(0.5f, 3);
+
+    CollisionGrid grid(256, yStretch);
+    std::vector<CollisionBox> boxes;
+    for (uint32_t id = 0; id < 500; ++id) {
+        CollisionBox box({ position(random), position(random) }, -size(random), -size(random),
+                         size(random), size(random), scale(random));
+        box.placementScale = scale(random);
+        grid.insert(id, box.anchor, box);
+        boxes.push_back(box);
+    }
+
+    for (std::size_t i = 0; i < 500; ++i) {
+        const CollisionBox box({ position(random), position(random) }, -size(random), -size(random),
+                               size(random), size(random), scale(random));
+
+        float expected = 0.5f;
+        for (const auto& blocking : boxes) {
+            if (blocking.anchor.x + blocking.x1 > box.anchor.x + box.x2 ||
+                blocking.anchor.x + blocking.x2 < box.anchor.x + box.x1 ||
+                blocking.anchor.y + blocking.y1 * yStretch > box.anchor.y + box.y2 * yStretch ||
+                blocking.anchor.y + blocking.y2 * yStretch < box.anchor.y + box.y1 * yStretch) {
+                continue;
+            }
+
+            float s1 = (blocking.x1 - box.x2) / (box.anchor.x - blocking.anchor.x);
+            float s2 = (blocking.x2 - box.x1) / (box.anchor.x - blocking.anchor.x);
+            float s3 = (blocking.y1 - box.y2) * yStretch / (box.anchor.y - blocking.anchor.y);
+            float s4 = (blocking.y2 - box.y1) * yStretch / (box.anchor.y - blocking.anchor.y);
+            if (std::isnan(s1) || std::isnan(s2)) s1 = s2 = 1;
+            if (std::isnan(s3) || std::isnan(s4)) s3 = s4 = 1;
+            const float result = util::min(util::max(s1, s2), util::max(s3, s4), blocking.maxScale, box.maxScale);
+            if (result > expected && result >= blocking.placementScale) {
+                expected = result;
+            }
+        }
+
+        const float infinity = std::numeric_limits<float>::infinity();
+        EXPECT_FLOAT_EQ(expected, grid.findPlacementScale(0.5f, infinity, box.anchor, box));
+
+        // Stops at the maximum.
+        EXPECT_LE(std::min(expected, 1.0f), grid.findPlacementScale(0.5f, 1.0f, box.anchor, box));
+    }
+}
@@ -0,0 +1,82 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/geometry/anchor.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/constants.hpp>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+CollisionFeature makeFeature(float x, float y) {
+    return CollisionFeature(GeometryCoordinates(), Anchor(x, y, 0, 0.5f, 0),
+                            -10, 10, -10, 10, 1, 0, SymbolPlacementType::Point,
+                            IndexedSubfeature { 0, "layer", "bucket", 0 }, false);
+}
+
+} // namespace
+
+TEST(CollisionTile, Collision) {
+    CollisionTile tile(PlacementConfig {});
+
+    auto a = makeFeature(100, 100);
+    tile.insertFeature(a, tile.placeFeature(a, false, false), false);
+
+    auto b = makeFeature(105, 100);
+    EXPECT_LT(tile.minScale, tile.placeFeature(b, false, false));
+    EXPECT_EQ(tile.minScale, tile.placeFeature(b, true, false));
+
+    auto c = makeFeature(1000, 100);
+    EXPECT_EQ(tile.minScale, tile.placeFeature(c, false, false));
+}
+
+TEST(CollisionTile, Shared) {
+    // The same label near the boundary of two horizontally adjacent tiles only fits once.
+    CollisionTile shared(PlacementConfig {});
+
+    CollisionTile left(PlacementConfig {});
+    left.shared = &shared;
+    left.sharedOffset = { 0, 0 };
+
+    CollisionTile right(PlacementConfig {});
+    right.shared = &shared;
+    right.sharedOffset = { util::EXTENT, 0 };
+
+    auto a = makeFeature(util::EXTENT - 5, 100);
+    left.insertFeature(a, left.placeFeature(a, false, false), false);
+
+    auto b = makeFeature(-5, 100);
+    EXPECT_LT(right.minScale, right.placeFeature(b, false, false));
+
+    // Without the shared index, each tile only knows about its own labels.
+    right.shared = nullptr;
+    EXPECT_EQ(right.minScale, right.placeFeature(b, false, false));
+
+    // Queries only see the tile's own labels.
+    GeometryCoordinates query { { util::EXTENT - 5, 100 } };
+    EXPECT_EQ(1u, left.queryRenderedSymbols(query, 1).size());
+    EXPECT_EQ(0u, right.queryRenderedSymbols(query, 1).size());
+}
+
+TEST(CollisionTile, QueryRenderedSymbols) {
+    CollisionTile tile(PlacementConfig {});
+
+    // Features of different source layers may share an index.
+    for (const auto& name : { "roads", "places", "roads" }) {
+        CollisionFeature feature(GeometryCoordinates(), Anchor(100, 100, 0, 0.5f, 0),
+                                 -10, 10, -10, 10, 1, 0, SymbolPlacementType::Point,
+                                 IndexedSubfeature { 7, name, std::string(name) + "-bucket", 3 }, false);
+        tile.insertFeature(feature, tile.minScale, true);
+    }
+
+    const GeometryCoordinates query { { 95, 95 }, { 105, 95 }, { 105, 105 }, { 95, 105 } };
+    const auto result = tile.queryRenderedSymbols(query, 1);
+    ASSERT_EQ(2u, result.size());
+    EXPECT_EQ(7u, result[0].index);
+    EXPECT_EQ("roads", result[0].sourceLayerName);
+    EXPECT_EQ("roads-bucket", result[0].bucketName);
+    EXPECT_EQ(3u, result[0].sortIndex);
+    EXPECT_EQ("places", result[1].sourceLayerName);
+    EXPECT_EQ("places-bucket", result[1].bucketName);
+}
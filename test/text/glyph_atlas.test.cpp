@@ -4,6 +4,7 @@
 
 #include <mbgl/text/glyph_set.hpp>
 #include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
 #include <mbgl/util/run_loop.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/io.hpp>
@@ -54,7 +55,7 @@ TEST(GlyphAtlas, LoadingSuccess) {
             return;
 
         auto glyphSet = test.glyphAtlas.getGlyphSet({{"Test Stack"}});
-        ASSERT_FALSE(glyphSet->getSDFs().empty());
+        ASSERT_FALSE(glyphSet->empty());
 
         test.end();
     };
@@ -84,7 +85,7 @@ TEST(GlyphAtlas, LoadingFail) {
         EXPECT_EQ(util::toString(error), "Failed by the test case");
 
         auto glyphSet = test.glyphAtlas.getGlyphSet({{"Test Stack"}});
-        ASSERT_TRUE(glyphSet->getSDFs().empty());
+        ASSERT_TRUE(glyphSet->empty());
         ASSERT_FALSE(test.glyphAtlas.hasGlyphRanges({{"Test Stack"}}, {{0, 255}}));
 
         test.end();
@@ -113,7 +114,7 @@ TEST(GlyphAtlas, LoadingCorrupted) {
         EXPECT_EQ(util::toString(error), "unknown pbf field type exception");
 
         auto glyphSet = test.glyphAtlas.getGlyphSet({{"Test Stack"}});
-        ASSERT_TRUE(glyphSet->getSDFs().empty());
+        ASSERT_TRUE(glyphSet->empty());
         ASSERT_FALSE(test.glyphAtlas.hasGlyphRanges({{"Test Stack"}}, {{0, 255}}));
 
         test.end();
@@ -142,3 +143,121 @@ TEST(GlyphAtlas, LoadingCancel) {
         {{"Test Stack"}},
         {{0, 255}});
 }
+
+namespace {
+
+// A glyph with a 10x10 bitmap, which takes up 20x20 pixels of the atlas.
+SDFGlyph makeGlyph(uint32_t id) {
+    SDFGlyph glyph;
+    glyph.id = id;
+    glyph.metrics.width = 10;
+    glyph.metrics.height = 10;
+    glyph.metrics.advance = 10;
+    glyph.bitmap = std::string(16 * 16, char(id));
+    return glyph;
+}
+
+} // namespace
+
+TEST(GlyphAtlas, AddPages) {
+    StubFileSource fileSource;
+    GlyphAtlas glyphAtlas { 32, 2 * GlyphAtlas::PageHeight, fileSource };
+
+    GlyphSet glyphSet;
+    std::u32string text;
+    for (uint32_t id = 0x4e00; id < 0x4e00 + 30; ++id) {
+        glyphSet.insert(id, makeGlyph(id));
+        text += char32_t(id);
+    }
+
+    // A page fits 25 of the glyphs, one per row, so the rest are placed in a second page below it.
+    GlyphPositions face;
+    glyphAtlas.addGlyphs(1, text, {{"Test Stack"}}, glyphSet, face);
+    ASSERT_EQ(30u, face.size());
+    std::size_t secondPage = 0;
+    for (const auto& glyph : face) {
+        EXPECT_TRUE(glyph.second.rect.hasArea());
+        EXPECT_LE(glyph.second.rect.y + glyph.second.rect.h, glyphAtlas.height);
+        if (glyph.second.rect.y >= GlyphAtlas::PageHeight) {
+            secondPage++;
+        }
+    }
+    EXPECT_EQ(5u, secondPage);
+}
+
+TEST(GlyphAtlas, EvictUnusedGlyphs) {
+    StubFileSource fileSource;
+    GlyphAtlas glyphAtlas { 32, 32, fileSource };
+
+    GlyphSet glyphSet;
+    glyphSet.insert('A', makeGlyph('A'));
+    glyphSet.insert('B', makeGlyph('B'));
+    const FontStack fontStack {{"Test Stack"}};
+
+    GlyphPositions first;
+    glyphAtlas.addGlyphs(1, U"A", fontStack, glyphSet, first);
+    ASSERT_TRUE(first.at('A').rect.hasArea());
+
+    // The atlas only fits a single glyph, which is in use.
+    Log::setObserver(std::make_unique<Log::NullObserver>());
+    GlyphPositions full;
+    glyphAtlas.addGlyphs(2, U"B", fontStack, glyphSet, full);
+    EXPECT_FALSE(full.at('B').rect.hasArea());
+
+    // Glyphs that no tile uses anymore keep their place until it's needed.
+    glyphAtlas.removeGlyphs(1);
+    GlyphPositions again;
+    glyphAtlas.addGlyphs(3, U"A", fontStack, glyphSet, again);
+    EXPECT_EQ(first.at('A').rect, again.at('A').rect);
+
+    glyphAtlas.removeGlyphs(3);
+    GlyphPositions evicted;
+    glyphAtlas.addGlyphs(4, U"B", fontStack, glyphSet, evicted);
+    EXPECT_TRUE(evicted.at('B').rect.hasArea());
+}
+
+class StubLocalGlyphRasterizer : public LocalGlyphRasterizer {
+public:
+    bool canRasterize(const FontStack&, uint32_t first, uint32_t) const override {
+        return first >= 0x4E00 && first <= 0x9FFF;
+    }
+
+    optional<RasterizedGlyph> rasterize(const FontStack&, uint32_t glyphID) override {
+        if (glyphID % 2) {
+            return {};
+        }
+        RasterizedGlyph glyph;
+        glyph.width = 4;
+        glyph.height = 4;
+        glyph.advance = 6;
+        glyph.coverage.assign(4 * 4, 255);
+        return glyph;
+    }
+};
+
+TEST(GlyphAtlas, LocalGlyphRasterizer) {
+    GlyphAtlasTest test;
+    test.glyphAtlas.setObserver(&test.observer);
+    test.glyphAtlas.setLocalGlyphRasterizer(std::make_shared<StubLocalGlyphRasterizer>());
+
+    test.fileSource.glyphsResponse = [&] (const Resource&) {
+        ADD_FAILURE() << "Should not download ranges that are drawn locally";
+        return Response();
+    };
+
+    test.observer.glyphsLoaded = [&] (const FontStack&, const GlyphRange& range) {
+        EXPECT_EQ(GlyphRange(0x4E00, 0x4EFF), range);
+        test.end();
+    };
+
+    ASSERT_TRUE(test.glyphAtlas.hasGlyphRanges({{"Test Stack"}}, {{0x4E00, 0x4EFF}}));
+
+    auto glyphSet = test.glyphAtlas.getGlyphSet({{"Test Stack"}});
+    const SDFGlyph* glyph = glyphSet->getSDF(0x4E00);
+    ASSERT_TRUE(glyph);
+    EXPECT_EQ((4u + 6u) * (4u + 6u), glyph->bitmap.size());
+    EXPECT_EQ(6u, glyph->metrics.advance);
+    EXPECT_FALSE(glyphSet->getSDF(0x4E01));
+
+    test.loop.run();
+}
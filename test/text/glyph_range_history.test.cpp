@@ -0,0 +1,80 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_range_history.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::string historyPath = "test/fixtures/glyph_range_history.glyphs";
+
+void deleteHistory() {
+    try {
+        util::deleteFile(historyPath);
+    } catch (const std::exception&) {
+    }
+}
+
+} // namespace
+
+TEST(GlyphRangeHistory, Add) {
+    GlyphRangeHistory history;
+    const FontStack fontStack { "Open Sans Regular", "Arial Unicode MS Regular" };
+
+    EXPECT_TRUE(history.get(fontStack).empty());
+    EXPECT_TRUE(history.add(fontStack, { 0, 255 }));
+    EXPECT_TRUE(history.add(fontStack, { 19968, 20223 }));
+    EXPECT_FALSE(history.add(fontStack, { 0, 255 }));
+
+    EXPECT_EQ(GlyphRangeSet({ { 0, 255 }, { 19968, 20223 } }), history.get(fontStack));
+    EXPECT_TRUE(history.get({ "Open Sans Regular" }).empty());
+}
+
+TEST(GlyphRangeHistory, Encode) {
+    GlyphRangeHistory history;
+    history.add({ "Open Sans Regular", "Arial Unicode MS Regular" }, { 19968, 20223 });
+    history.add({ "Open Sans Regular", "Arial Unicode MS Regular" }, { 0, 255 });
+    history.add({ "Open Sans Bold" }, { 256, 511 });
+
+    const std::string encoded = history.encode();
+    EXPECT_EQ("0 19968\tOpen Sans Regular\tArial Unicode MS Regular\n"
+              "256\tOpen Sans Bold\n", encoded);
+
+    GlyphRangeHistory decoded;
+    decoded.decode(encoded);
+    EXPECT_EQ(encoded, decoded.encode());
+}
+
+TEST(GlyphRangeHistory, DecodeInvalid) {
+    GlyphRangeHistory history;
+    history.decode("0 100 256 65536 x\tOpen Sans Regular\n"
+                   "512\n"
+                   "\n"
+                   "768\tOpen Sans Bold");
+
+    EXPECT_EQ(GlyphRangeSet({ { 0, 255 }, { 256, 511 } }), history.get({ "Open Sans Regular" }));
+    EXPECT_EQ(GlyphRangeSet({ { 768, 1023 } }), history.get({ "Open Sans Bold" }));
+}
+
+TEST(GlyphRangeHistory, Save) {
+    deleteHistory();
+
+    GlyphRangeHistory history;
+    history.setPath(historyPath);
+    EXPECT_TRUE(history.get({ "Open Sans Regular" }).empty());
+    history.add({ "Open Sans Regular" }, { 0, 255 });
+    history.add({ "Open Sans Regular" }, { 1024, 1279 });
+    history.save();
+
+    GlyphRangeHistory loaded;
+    loaded.setPath(historyPath);
+    EXPECT_EQ(GlyphRangeSet({ { 0, 255 }, { 1024, 1279 } }), loaded.get({ "Open Sans Regular" }));
+
+    // Without a path, the history is only kept in memory.
+    GlyphRangeHistory memory;
+    memory.add({ "Open Sans Regular" }, { 0, 255 });
+    memory.save();
+
+    deleteHistory();
+}
@@ -0,0 +1,49 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_sdf.hpp>
+#include <mbgl/text/local_glyph_rasterizer.hpp>
+
+using namespace mbgl;
+
+TEST(GlyphSDF, Square) {
+    RasterizedGlyph glyph;
+    glyph.width = 10;
+    glyph.height = 10;
+    glyph.left = 1;
+    glyph.top = -2;
+    glyph.advance = 12;
+    glyph.coverage.assign(10 * 10, 255);
+
+    const SDFGlyph sdf = generateSDFGlyph('A', glyph);
+    EXPECT_EQ(uint32_t('A'), sdf.id);
+    EXPECT_EQ(10u, sdf.metrics.width);
+    EXPECT_EQ(10u, sdf.metrics.height);
+    EXPECT_EQ(1, sdf.metrics.left);
+    EXPECT_EQ(-2, sdf.metrics.top);
+    EXPECT_EQ(12u, sdf.metrics.advance);
+
+    // A border of 3 pixels on each side.
+    const uint32_t size = 10 + 2 * 3;
+    ASSERT_EQ(size * size, sdf.bitmap.size());
+    auto value = [&] (uint32_t x, uint32_t y) {
+        return uint8_t(sdf.bitmap[y * size + x]);
+    };
+
+    // Inside, values rise towards the center; outside, they fall off with distance.
+    EXPECT_EQ(255, value(size / 2, size / 2));
+    EXPECT_GT(value(3, size / 2), value(2, size / 2));
+    EXPECT_GT(value(2, size / 2), value(1, size / 2));
+    EXPECT_GT(value(1, size / 2), value(0, size / 2));
+    EXPECT_GT(value(3, size / 2), 191);
+    EXPECT_LT(value(2, size / 2), 191);
+    EXPECT_LT(value(0, 0), value(0, size / 2));
+}
+
+TEST(GlyphSDF, Empty) {
+    RasterizedGlyph glyph;
+    glyph.advance = 6;
+
+    const SDFGlyph sdf = generateSDFGlyph(' ', glyph);
+    EXPECT_TRUE(sdf.bitmap.empty());
+    EXPECT_EQ(6u, sdf.metrics.advance);
+}
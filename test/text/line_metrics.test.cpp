@@ -0,0 +1,40 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/line_metrics.hpp>
+#include <mbgl/util/math.hpp>
+
+using namespace mbgl;
+
+TEST(LineMetrics, Line) {
+    // A right turn.
+    const LineMetrics metrics(GeometryCoordinates { { 0, 0 }, { 30, 40 }, { 30, 0 } });
+
+    ASSERT_EQ(2u, metrics.lengths.size());
+    EXPECT_FLOAT_EQ(50, metrics.lengths[0]);
+    EXPECT_FLOAT_EQ(40, metrics.lengths[1]);
+    EXPECT_FLOAT_EQ(90, metrics.length);
+
+    ASSERT_EQ(2u, metrics.angles.size());
+    EXPECT_FLOAT_EQ(std::atan2(40.0f, 30.0f), metrics.angles[0]);
+    EXPECT_FLOAT_EQ(-M_PI / 2, metrics.angles[1]);
+
+    ASSERT_EQ(3u, metrics.turns.size());
+    EXPECT_FLOAT_EQ(0, metrics.turns[0]);
+    EXPECT_FLOAT_EQ(std::atan2(40.0f, 30.0f) + M_PI / 2, metrics.turns[1]);
+    EXPECT_FLOAT_EQ(0, metrics.turns[2]);
+}
+
+TEST(LineMetrics, DuplicateVertex) {
+    const LineMetrics metrics(GeometryCoordinates { { 0, 0 }, { 10, 0 }, { 10, 0 }, { 20, 0 } });
+
+    ASSERT_EQ(3u, metrics.lengths.size());
+    EXPECT_FLOAT_EQ(0, metrics.lengths[1]);
+    EXPECT_FLOAT_EQ(20, metrics.length);
+}
+
+TEST(LineMetrics, Point) {
+    const LineMetrics metrics(GeometryCoordinates { { 10, 10 } });
+    EXPECT_TRUE(metrics.lengths.empty());
+    EXPECT_TRUE(metrics.turns.empty());
+    EXPECT_EQ(0, metrics.length);
+}
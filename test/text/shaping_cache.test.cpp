@@ -0,0 +1,106 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/shaping_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+ShapingKey makeKey(const std::u32string& text) {
+    ShapingKey key;
+    key.fontStack = { "Open Sans Regular", "Arial Unicode MS Regular" };
+    key.text = text;
+    key.maxWidth = 240;
+    key.lineHeight = 28.8f;
+    key.horizontalAlign = 0.5f;
+    key.verticalAlign = 0.5f;
+    key.justify = 0.5f;
+    return key;
+}
+
+Shaping makeShaping(const std::u32string& text) {
+    Shaping shaping(0, 0, text);
+    float x = 0;
+    for (uint32_t chr : text) {
+        shaping.positionedGlyphs.emplace_back(chr, x, -17);
+        x += 10;
+    }
+    shaping.right = x;
+    return shaping;
+}
+
+} // namespace
+
+TEST(ShapingCache, GetAndAdd) {
+    ShapingCache cache;
+    EXPECT_FALSE(cache.get(makeKey(U"Main Street")));
+
+    cache.add(makeKey(U"Main Street"), makeShaping(U"Main Street"));
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_GT(cache.getBytes(), 0u);
+
+    optional<Shaping> shaping = cache.get(makeKey(U"Main Street"));
+    ASSERT_TRUE(shaping);
+    EXPECT_EQ(U"Main Street", shaping->text);
+    ASSERT_EQ(11u, shaping->positionedGlyphs.size());
+    EXPECT_EQ(100, shaping->positionedGlyphs[10].x);
+    EXPECT_EQ(110, shaping->right);
+
+    // Adding a key again keeps the first shaping.
+    const std::size_t bytes = cache.getBytes();
+    cache.add(makeKey(U"Main Street"), makeShaping(U"Main"));
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(bytes, cache.getBytes());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.getBytes());
+    EXPECT_FALSE(cache.get(makeKey(U"Main Street")));
+}
+
+TEST(ShapingCache, KeyParameters) {
+    ShapingCache cache;
+    cache.add(makeKey(U"Main Street"), makeShaping(U"Main Street"));
+
+    ShapingKey key = makeKey(U"Main Street");
+    key.fontStack = { "Open Sans Bold" };
+    EXPECT_FALSE(cache.get(key));
+
+    key = makeKey(U"Main Street");
+    key.maxWidth = 0;
+    EXPECT_FALSE(cache.get(key));
+
+    key = makeKey(U"Main Street");
+    key.horizontalAlign = 0;
+    EXPECT_FALSE(cache.get(key));
+
+    key = makeKey(U"Main Street");
+    key.translate = { 0, 1.5f };
+    EXPECT_FALSE(cache.get(key));
+
+    EXPECT_TRUE(cache.get(makeKey(U"Main Street")));
+}
+
+TEST(ShapingCache, EvictsLeastRecentlyUsed) {
+    ShapingCache cache;
+    cache.add(makeKey(U"First Avenue"), makeShaping(U"First Avenue"));
+    const std::size_t entryBytes = cache.getBytes();
+
+    // Room for a little more than two labels of the same length.
+    cache.setMaxBytes(entryBytes * 2 + entryBytes / 2);
+    cache.add(makeKey(U"Third Avenue"), makeShaping(U"Third Avenue"));
+    EXPECT_EQ(2u, cache.size());
+
+    // Using the first label makes the second one the least recently used.
+    EXPECT_TRUE(cache.get(makeKey(U"First Avenue")));
+    cache.add(makeKey(U"Fifth Avenue"), makeShaping(U"Fifth Avenue"));
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_LE(cache.getBytes(), cache.getMaxBytes());
+    EXPECT_TRUE(cache.get(makeKey(U"First Avenue")));
+    EXPECT_FALSE(cache.get(makeKey(U"Third Avenue")));
+    EXPECT_TRUE(cache.get(makeKey(U"Fifth Avenue")));
+
+    cache.setMaxBytes(0);
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.getBytes());
+}
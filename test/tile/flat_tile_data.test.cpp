@@ -0,0 +1,196 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/flat_tile_data.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+namespace {
+
+class StubFeature : public GeometryTileFeature {
+public:
+    StubFeature(FeatureType type_, PropertyMap properties_, optional<FeatureIdentifier> id_, GeometryCollection geometry_)
+        : type(type_), properties(std::move(properties_)), id(std::move(id_)), geometry(std::move(geometry_)) {
+    }
+
+    FeatureType getType() const override { return type; }
+    PropertyMap getProperties() const override { return properties; }
+    optional<FeatureIdentifier> getID() const override { return id; }
+    GeometryCollection getGeometries() const override { return geometry; }
+
+    optional<Value> getValue(const std::string& key) const override {
+        auto it = properties.find(key);
+        if (it == properties.end()) {
+            return {};
+        }
+        return it->second;
+    }
+
+    FeatureType type;
+    PropertyMap properties;
+    optional<FeatureIdentifier> id;
+    GeometryCollection geometry;
+};
+
+class StubLayer : public GeometryTileLayer {
+public:
+    std::size_t featureCount() const override { return features.size(); }
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubFeature>(features.at(i));
+    }
+    std::string getName() const override { return name; }
+
+    std::string name;
+    std::vector<StubFeature> features;
+};
+
+class StubTileData : public GeometryTileData {
+public:
+    std::unique_ptr<GeometryTileData> clone() const override {
+        return std::make_unique<StubTileData>(*this);
+    }
+    const GeometryTileLayer* getLayer(const std::string& name) const override {
+        auto it = layers.find(name);
+        return it == layers.end() ? nullptr : &it->second;
+    }
+
+    std::unordered_map<std::string, StubLayer> layers;
+};
+
+StubTileData makeTileData() {
+    StubTileData data;
+
+    StubLayer& roads = data.layers["roads"];
+    roads.name = "roads";
+    roads.features.emplace_back(FeatureType::LineString,
+                                PropertyMap {{ "class", std::string("street") }, { "oneway", true }},
+                                FeatureIdentifier(uint64_t(7)),
+                                GeometryCollection {{ { 0, 0 }, { 10, 10 } }, { { 20, 20 }, { 30, 30 }, { 40, 20 } }});
+    roads.features.emplace_back(FeatureType::LineString,
+                                PropertyMap {{ "class", std::string("street") }, { "lanes", int64_t(-2) }},
+                                optional<FeatureIdentifier>(),
+                                GeometryCollection {{ { -5, 5 }, { 5, -5 } }});
+
+    StubLayer& water = data.layers["water"];
+    water.name = "water";
+    water.features.emplace_back(FeatureType::Polygon,
+                                PropertyMap {{ "depth", 12.5 }, { "names", std::vector<Value> { std::string("a"), NullValue() } }},
+                                FeatureIdentifier(std::string("lake")),
+                                GeometryCollection {{ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 0 } }});
+
+    return data;
+}
+
+void expectEqual(const GeometryTileData& expected, const GeometryTileData& actual, const std::string& layerName) {
+    const GeometryTileLayer* expectedLayer = expected.getLayer(layerName);
+    const GeometryTileLayer* actualLayer = actual.getLayer(layerName);
+    ASSERT_TRUE(expectedLayer);
+    ASSERT_TRUE(actualLayer);
+    EXPECT_EQ(layerName, actualLayer->getName());
+    ASSERT_EQ(expectedLayer->featureCount(), actualLayer->featureCount());
+
+    for (std::size_t i = 0; i < expectedLayer->featureCount(); ++i) {
+        auto expectedFeature = expectedLayer->getFeature(i);
+        auto actualFeature = actualLayer->getFeature(i);
+        EXPECT_EQ(expectedFeature->getType(), actualFeature->getType());
+        EXPECT_EQ(expectedFeature->getID(), actualFeature->getID());
+        EXPECT_EQ(expectedFeature->getProperties(), actualFeature->getProperties());
+        EXPECT_EQ(expectedFeature->getGeometries(), actualFeature->getGeometries());
+    }
+}
+
+} // namespace
+
+TEST(FlatTileData, Convert) {
+    StubTileData source = makeTileData();
+    FlatTileData data(source, { "roads", "water", "missing" });
+
+    expectEqual(source, data, "roads");
+    expectEqual(source, data, "water");
+    EXPECT_FALSE(data.getLayer("missing"));
+
+    auto clone = data.clone();
+    expectEqual(source, *clone, "roads");
+    EXPECT_EQ(data.getLayer("roads"), clone->getLayer("roads"));
+}
+
+TEST(FlatTileData, SkipsUnrequestedLayers) {
+    StubTileData source = makeTileData();
+    FlatTileData data(source, { "water" });
+
+    EXPECT_FALSE(data.getLayer("roads"));
+    EXPECT_TRUE(data.getLayer("water"));
+}
+
+TEST(FlatTileData, KeyIndices) {
+    StubTileData source = makeTileData();
+    FlatTileData data(source, { "roads" });
+
+    const GeometryTileLayer* layer = data.getLayer("roads");
+    ASSERT_TRUE(layer);
+    ASSERT_TRUE(layer->hasKeyIndices());
+
+    auto classKey = layer->getKeyIndex("class");
+    auto lanesKey = layer->getKeyIndex("lanes");
+    ASSERT_TRUE(classKey);
+    ASSERT_TRUE(lanesKey);
+    EXPECT_FALSE(layer->getKeyIndex("missing"));
+
+    auto first = layer->getFeature(0);
+    auto second = layer->getFeature(1);
+    EXPECT_EQ(Value(std::string("street")), *first->getValueByKeyIndex(*classKey));
+    EXPECT_FALSE(first->getValueByKeyIndex(*lanesKey));
+    EXPECT_EQ(Value(int64_t(-2)), *second->getValueByKeyIndex(*lanesKey));
+    EXPECT_EQ(Value(true), *first->getValue("oneway"));
+    EXPECT_FALSE(second->getValue("oneway"));
+}
+
+TEST(FlatTileData, EachGeometry) {
+    StubTileData source = makeTileData();
+    FlatTileData data(source, { "roads" });
+
+    GeometryCollection rings;
+    data.getLayer("roads")->getFeature(0)->eachGeometry([&] (const GeometryCoordinates& ring) {
+        rings.push_back(ring);
+    });
+    EXPECT_EQ(source.getLayer("roads")->getFeature(0)->getGeometries(), rings);
+}
+
+TEST(FlatTileData, SerializeRoundTrip) {
+    StubTileData source = makeTileData();
+    FlatTileData data(source, { "roads", "water" });
+
+    auto parsed = FlatTileData::parse(data.serialize());
+    expectEqual(source, *parsed, "roads");
+    expectEqual(source, *parsed, "water");
+
+    auto reparsed = FlatTileData::parse(parsed->serialize());
+    expectEqual(source, *reparsed, "roads");
+    expectEqual(source, *reparsed, "water");
+}
+
+TEST(FlatTileData, ParseInvalid) {
+    StubTileData source = makeTileData();
+    const std::string serialized = FlatTileData(source, { "roads", "water" }).serialize();
+
+    EXPECT_THROW(FlatTileData::parse(""), std::runtime_error);
+    EXPECT_THROW(FlatTileData::parse("not a tile"), std::runtime_error);
+    EXPECT_THROW(FlatTileData::parse(serialized + "x"), std::runtime_error);
+
+    // Every truncation is detected rather than read past the end.
+    for (std::size_t size = 0; size < serialized.size(); ++size) {
+        EXPECT_THROW(FlatTileData::parse(serialized.substr(0, size)), std::runtime_error);
+    }
+}
+
+TEST(FlatTileData, BoundingBox) {
+    StubTileData source = makeTileData();
+    FlatTileData data(source, { "roads" });
+
+    auto box = data.getLayer("roads")->getFeature(0)->getBoundingBox();
+    ASSERT_TRUE(box);
+    EXPECT_EQ(GeometryCoordinate(0, 0), box->min);
+    EXPECT_EQ(GeometryCoordinate(40, 30), box->max);
+    EXPECT_EQ(source.getLayer("roads")->getFeature(0)->getBoundingBox(), box);
+}
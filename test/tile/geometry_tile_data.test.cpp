@@ -59,3 +59,46 @@ TEST(GeometryTileData, limitHoles2) {
     ASSERT_EQ(polygon[0][0].x, 0);
     ASSERT_EQ(polygon[1][0].x, 10);
 }
+
+TEST(GeometryTileData, isValidPolygonGeometry) {
+    // Exterior ring with a hole, wound the way fixupPolygons() winds them.
+    EXPECT_TRUE(isValidPolygonGeometry({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {10, 20}, {20, 20}, {10, 10} }
+    }));
+
+    // Two polygons.
+    EXPECT_TRUE(isValidPolygonGeometry({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {50, 50}, {60, 50}, {60, 60}, {50, 50} }
+    }));
+
+    // Exterior ring wound the wrong way.
+    EXPECT_FALSE(isValidPolygonGeometry({
+      { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} }
+    }));
+
+    // Unclosed ring.
+    EXPECT_FALSE(isValidPolygonGeometry({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40} }
+    }));
+
+    // Degenerate rings.
+    EXPECT_FALSE(isValidPolygonGeometry({
+      { {0, 0}, {40, 0}, {0, 0} }
+    }));
+    EXPECT_FALSE(isValidPolygonGeometry({
+      { {0, 0}, {40, 0}, {40, 40}, {0, 40}, {0, 0} },
+      { {10, 10}, {20, 20}, {30, 30}, {10, 10} }
+    }));
+    EXPECT_FALSE(isValidPolygonGeometry({}));
+}
+
+TEST(GeometryTileData, fixupPolygonsKeepsValidGeometryValid) {
+    GeometryCollection fixed = fixupPolygons({
+      { {0, 0}, {0, 40}, {40, 40}, {40, 0}, {0, 0} }
+    });
+
+    ASSERT_EQ(1u, fixed.size());
+    EXPECT_TRUE(isValidPolygonGeometry(fixed));
+}
@@ -0,0 +1,91 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/fake_file_source.hpp>
+
+#include <mbgl/tile/metatile_file_source.hpp>
+#include <mbgl/util/tileset.hpp>
+
+#include <protozero/pbf_writer.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+std::string metatile(const std::vector<std::tuple<uint32_t, uint32_t, std::string>>& tiles) {
+    std::string data;
+    protozero::pbf_writer writer(data);
+    for (const auto& tile : tiles) {
+        std::string tileData;
+        {
+            protozero::pbf_writer tileWriter(tileData);
+            tileWriter.add_uint32(1, std::get<0>(tile));
+            tileWriter.add_uint32(2, std::get<1>(tile));
+            tileWriter.add_string(3, std::get<2>(tile));
+        }
+        writer.add_message(1, tileData);
+    }
+    return data;
+}
+
+Tileset metatileset() {
+    Tileset tileset { { "http://example.com/{z}/{x}/{y}.pbf" }, { 0, 22 }, "" };
+    tileset.metatiles = { "http://example.com/meta/{z}/{x}/{y}.pbf" };
+    return tileset;
+}
+
+} // namespace
+
+TEST(Metatile, Split) {
+    auto tiles = splitMetatile(metatile({ std::make_tuple(0, 1, "a"), std::make_tuple(1, 1, "b") }), 2);
+    ASSERT_EQ(2u, tiles.size());
+    EXPECT_EQ("a", *tiles.at({ 0, 1 }));
+    EXPECT_EQ("b", *tiles.at({ 1, 1 }));
+
+    EXPECT_THROW(splitMetatile(metatile({ std::make_tuple(2, 0, "c") }), 2), std::runtime_error);
+    EXPECT_THROW(splitMetatile("\x0a\xff", 2), std::runtime_error);
+}
+
+TEST(Metatile, TilesShareRequests) {
+    FakeFileSource fakeFileSource;
+    MetatileFileSource fileSource(fakeFileSource, metatileset());
+
+    const Tileset::Scheme scheme = Tileset::Scheme::XYZ;
+    optional<Response> first;
+    optional<Response> second;
+    auto firstRequest = fileSource.request(Resource::tile("", 1, 4, 7, 3, scheme), [&] (Response res) {
+        first = res;
+    });
+    auto secondRequest = fileSource.request(Resource::tile("", 1, 5, 7, 3, scheme), [&] (Response res) {
+        second = res;
+    });
+
+    // Both tiles are in the same metatile.
+    ASSERT_EQ(1u, fakeFileSource.requests.size());
+    EXPECT_EQ("http://example.com/meta/3/2/3.pbf", fakeFileSource.requests.front()->resource.url);
+
+    Response response;
+    response.data = std::make_shared<std::string>(metatile({ std::make_tuple(0, 1, "a") }));
+    response.etag = std::string("etag");
+    fakeFileSource.respond(Resource::Tile, response);
+
+    ASSERT_TRUE(first && first->data);
+    EXPECT_EQ("a", *first->data);
+    EXPECT_EQ(std::string("etag"), first->etag);
+    ASSERT_TRUE(second);
+    EXPECT_TRUE(second->noContent);
+    EXPECT_FALSE(second->data);
+
+    // The metatile's request is cancelled once both tiles cancelled theirs.
+    firstRequest.reset();
+    EXPECT_EQ(1u, fakeFileSource.requests.size());
+    secondRequest.reset();
+    EXPECT_EQ(0u, fakeFileSource.requests.size());
+}
+
+TEST(Metatile, OtherResourcesAreRequestedAsTheyAre) {
+    FakeFileSource fakeFileSource;
+    MetatileFileSource fileSource(fakeFileSource, metatileset());
+
+    auto request = fileSource.request(Resource::style("http://example.com/style.json"), [] (Response) {});
+    ASSERT_EQ(1u, fakeFileSource.requests.size());
+    EXPECT_EQ("http://example.com/style.json", fakeFileSource.requests.front()->resource.url);
+}
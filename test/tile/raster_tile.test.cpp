@@ -8,7 +8,9 @@
 #include <mbgl/map/transform.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
+#include <mbgl/style/layers/raster_layer.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/renderer/raster_bucket.hpp>
 
 using namespace mbgl;
 
@@ -36,14 +38,73 @@ public:
 
 TEST(RasterTile, setError) {
     RasterTileTest test;
-    RasterTile tile(OverscaledTileID(0, 0, 0), test.updateParameters, test.tileset);
+    RasterTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
     tile.setError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_FALSE(tile.isRenderable());
 }
 
 TEST(RasterTile, onError) {
     RasterTileTest test;
-    RasterTile tile(OverscaledTileID(0, 0, 0), test.updateParameters, test.tileset);
+    RasterTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_TRUE(tile.isRenderable());
 }
+
+TEST(RasterTile, onParsed) {
+    RasterTileTest test;
+    RasterTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+
+    // The first data isn't rendered until it has been uploaded, so that the parent tile can be
+    // rendered in its place meanwhile.
+    tile.onParsed(nullptr);
+    EXPECT_FALSE(tile.isRenderable());
+    EXPECT_TRUE(tile.needsUpload());
+}
+
+TEST(RasterTile, onParsedStill) {
+    RasterTileTest test;
+    style::UpdateParameters parameters {
+        1.0,
+        MapDebugOptions(),
+        test.transformState,
+        test.threadPool,
+        test.fileSource,
+        MapMode::Still,
+        test.annotationManager,
+        test.style
+    };
+    RasterTile tile(OverscaledTileID(0, 0, 0), "source", parameters, test.tileset);
+
+    tile.onParsed(nullptr);
+    EXPECT_TRUE(tile.isRenderable());
+    EXPECT_FALSE(tile.needsUpload());
+}
+
+TEST(RasterTile, backfillBorder) {
+    RasterTileTest test;
+    RasterTile tile(OverscaledTileID(1, 0, 0), "source", test.updateParameters, test.tileset);
+    RasterTile right(OverscaledTileID(1, 1, 0), "source", test.updateParameters, test.tileset);
+
+    // Terrarium tiles at 0 and 1 meters.
+    auto demTile = [] (uint8_t meters) {
+        PremultipliedImage image(2, 2);
+        for (std::size_t i = 0; i < image.size(); i += 4) {
+            image.data[i] = 128;
+            image.data[i + 1] = meters;
+            image.data[i + 2] = 0;
+            image.data[i + 3] = 255;
+        }
+        return std::make_unique<RasterBucket>(DEMData(image, Tileset::DEMEncoding::Terrarium));
+    };
+    tile.onParsed(demTile(0));
+    right.onParsed(demTile(1));
+
+    tile.backfillBorder(right, 1, 0);
+
+    style::RasterLayer layer("raster", "source");
+    const DEMData& dem = *static_cast<RasterBucket*>(tile.getBucket(layer))->getDEM();
+    EXPECT_EQ(0.0f, dem.get(1, 0));
+    EXPECT_EQ(1.0f, dem.get(2, 0));
+    EXPECT_EQ(1.0f, dem.get(2, 1));
+    EXPECT_EQ(0.0f, dem.get(2, -1));
+}
@@ -0,0 +1,155 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/tile/tile_cache.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_, MemoryUsage usage_) : Tile(id_), usage(usage_) {
+        availableData = DataAvailability::All;
+    }
+
+    void setNecessity(Necessity) override {}
+    void cancel() override {}
+    Bucket* getBucket(const style::Layer&) override { return nullptr; }
+    MemoryUsage getMemoryUsage() const override { return usage; }
+
+    const MemoryUsage usage;
+};
+
+std::unique_ptr<Tile> makeTile(uint32_t x, std::size_t cpu, std::size_t gpu = 0) {
+    MemoryUsage usage;
+    usage.cpu = cpu;
+    usage.gpu = gpu;
+    return std::make_unique<StubTile>(OverscaledTileID { 4, x, 0 }, usage);
+}
+
+} // namespace
+
+TEST(TileCache, EvictsBySize) {
+    TileCache cache(2);
+    cache.add({ 4, 0, 0 }, makeTile(0, 10));
+    cache.add({ 4, 1, 0 }, makeTile(1, 10));
+    cache.add({ 4, 2, 0 }, makeTile(2, 10));
+
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(20u, cache.getMemoryUsage().total());
+}
+
+TEST(TileCache, EvictsByBytes) {
+    TileCache cache(10);
+    cache.setMaxBytes(100);
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 30, 10));
+    cache.add({ 4, 1, 0 }, makeTile(1, 40));
+    EXPECT_EQ(80u, cache.getMemoryUsage().total());
+    EXPECT_EQ(10u, cache.getMemoryUsage().gpu);
+
+    // Evicts the oldest tiles until the new one fits.
+    cache.add({ 4, 2, 0 }, makeTile(2, 50));
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 2, 0 }));
+    EXPECT_EQ(90u, cache.getMemoryUsage().total());
+    EXPECT_EQ(0u, cache.getMemoryUsage().gpu);
+
+    // A tile that doesn't fit on its own isn't kept.
+    cache.add({ 4, 3, 0 }, makeTile(3, 200));
+    EXPECT_FALSE(cache.has({ 4, 3, 0 }));
+    EXPECT_EQ(0u, cache.getMemoryUsage().total());
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 60));
+    cache.add({ 4, 1, 0 }, makeTile(1, 30));
+    cache.setMaxBytes(50);
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_EQ(30u, cache.getMemoryUsage().total());
+}
+
+TEST(TileCache, Get) {
+    TileCache cache(10);
+    cache.add({ 4, 0, 0 }, makeTile(0, 30));
+    cache.add({ 4, 1, 0 }, makeTile(1, 40));
+
+    auto tile = cache.get({ 4, 0, 0 });
+    ASSERT_TRUE(tile);
+    EXPECT_EQ(OverscaledTileID(4, 0, 0), tile->id);
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_FALSE(cache.get({ 4, 0, 0 }));
+    EXPECT_EQ(40u, cache.getMemoryUsage().total());
+
+    // Adding a tile that's cached already replaces it.
+    cache.add({ 4, 1, 0 }, makeTile(1, 20));
+    EXPECT_EQ(20u, cache.getMemoryUsage().total());
+
+    cache.clear();
+    EXPECT_FALSE(cache.has({ 4, 1, 0 }));
+    EXPECT_EQ(0u, cache.getMemoryUsage().total());
+}
+
+TEST(TileCache, EvictOldest) {
+    TileCache cache(10);
+    EXPECT_FALSE(cache.getOldestTime());
+    EXPECT_EQ(0u, cache.evictOldest().total());
+
+    cache.add({ 4, 0, 0 }, makeTile(0, 30, 10));
+    cache.add({ 4, 1, 0 }, makeTile(1, 40));
+    ASSERT_TRUE(cache.getOldestTime());
+    EXPECT_LE(*cache.getOldestTime(), Clock::now());
+
+    const MemoryUsage usage = cache.evictOldest();
+    EXPECT_EQ(30u, usage.cpu);
+    EXPECT_EQ(10u, usage.gpu);
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 1, 0 }));
+    EXPECT_EQ(40u, cache.getMemoryUsage().total());
+
+    EXPECT_EQ(40u, cache.evictOldest().total());
+    EXPECT_FALSE(cache.getOldestTime());
+}
+
+TEST(TileCache, EvictionOrder) {
+    TileCache cache(3);
+    cache.add({ 4, 0, 0 }, makeTile(0, 10));
+    cache.add({ 4, 1, 0 }, makeTile(1, 10));
+    cache.add({ 4, 2, 0 }, makeTile(2, 10));
+
+    // Taking a tile out of the middle, and adding back one that's cached, keeps the order of
+    // the others.
+    EXPECT_TRUE(cache.get({ 4, 1, 0 }));
+    cache.add({ 4, 0, 0 }, makeTile(0, 10));
+    cache.add({ 4, 3, 0 }, makeTile(3, 10));
+    cache.add({ 4, 4, 0 }, makeTile(4, 10));
+
+    EXPECT_FALSE(cache.has({ 4, 2, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 0, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 3, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 4, 0 }));
+
+    cache.evictOldest();
+    EXPECT_FALSE(cache.has({ 4, 0, 0 }));
+    cache.setSize(1);
+    EXPECT_FALSE(cache.has({ 4, 3, 0 }));
+    EXPECT_TRUE(cache.has({ 4, 4, 0 }));
+    EXPECT_EQ(10u, cache.getMemoryUsage().total());
+}
+
+TEST(TileCache, ReportsMemoryUsage) {
+    TileCache cache(10);
+    cache.add({ 4, 0, 0 }, makeTile(0, 30, 10));
+    cache.add({ 4, 1, 0 }, makeTile(1, 40));
+
+    // Tiles that don't break their usage down report all of it as that of their buckets.
+    MemoryReport::Tiles report;
+    cache.reportMemoryUsage(report);
+    EXPECT_EQ(2u, report.count);
+    EXPECT_EQ(70u, report.buckets.cpu);
+    EXPECT_EQ(10u, report.buckets.gpu);
+    EXPECT_EQ(cache.getMemoryUsage().total(), report.total().total());
+}
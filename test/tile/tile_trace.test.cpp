@@ -0,0 +1,94 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/tile_trace.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// The events of a trace other than the names of the threads, which are listed first.
+std::vector<const JSValue*> tileEvents(const JSDocument& document) {
+    std::vector<const JSValue*> result;
+    const JSValue& events = document["traceEvents"];
+    for (rapidjson::SizeType i = 0; i < events.Size(); ++i) {
+        if (std::string(events[i]["ph"].GetString()) != "M") {
+            result.push_back(&events[i]);
+        }
+    }
+    return result;
+}
+
+void take(JSDocument& document) {
+    document.Parse<0>(TileTrace::take().c_str());
+    ASSERT_FALSE(document.HasParseError());
+}
+
+} // namespace
+
+TEST(TileTrace, Disabled) {
+    TileTrace::take();
+
+    const OverscaledTileID id { 14, 8192, 5461 };
+    TileTrace::instant(TileTrace::Event::Request, "source", id);
+    {
+        TileTrace::Scope trace(TileTrace::Event::Layout, "source", id);
+    }
+
+    JSDocument document;
+    take(document);
+    EXPECT_TRUE(tileEvents(document).empty());
+}
+
+TEST(TileTrace, Events) {
+    TileTrace::take();
+    TileTrace::setEnabled(true);
+
+    const std::string sourceID = "composite";
+    const OverscaledTileID id { 15, 14, 8192, 5461 };
+    TileTrace::instant(TileTrace::Event::Request, sourceID, id, "optional");
+    {
+        TileTrace::Scope trace(TileTrace::Event::Layout, sourceID, id);
+        trace.setDetail("abandoned");
+    }
+
+    TileTrace::setEnabled(false);
+    TileTrace::instant(TileTrace::Event::FirstRender, sourceID, id);
+
+    JSDocument document;
+    take(document);
+    const auto events = tileEvents(document);
+    ASSERT_EQ(2u, events.size());
+
+    const JSValue& request = *events[0];
+    EXPECT_EQ(std::string("request composite 14/8192/5461=>15"), request["name"].GetString());
+    EXPECT_EQ(std::string("i"), request["ph"].GetString());
+    EXPECT_EQ(std::string("composite"), request["args"]["source"].GetString());
+    EXPECT_EQ(std::string("14/8192/5461=>15"), request["args"]["tile"].GetString());
+    EXPECT_EQ(std::string("optional"), request["args"]["detail"].GetString());
+
+    const JSValue& layout = *events[1];
+    EXPECT_EQ(std::string("X"), layout["ph"].GetString());
+    EXPECT_EQ(request["tid"].GetUint(), layout["tid"].GetUint());
+    EXPECT_LE(request["ts"].GetDouble(), layout["ts"].GetDouble());
+    EXPECT_LE(0, layout["dur"].GetDouble());
+    EXPECT_EQ(std::string("abandoned"), layout["args"]["detail"].GetString());
+
+    EXPECT_EQ(0u, document["otherData"]["droppedEvents"].GetUint64());
+
+    // The thread the events happened on is named.
+    const JSValue& threads = document["traceEvents"];
+    bool named = false;
+    for (rapidjson::SizeType i = 0; i < threads.Size(); ++i) {
+        named |= std::string(threads[i]["ph"].GetString()) == "M" &&
+                 threads[i]["tid"].GetUint() == request["tid"].GetUint();
+    }
+    EXPECT_TRUE(named);
+
+    // Taking the events clears them.
+    take(document);
+    EXPECT_TRUE(tileEvents(document).empty());
+}
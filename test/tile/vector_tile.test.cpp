@@ -2,6 +2,9 @@
 #include <mbgl/test/fake_file_source.hpp>
 #include <mbgl/tile/vector_tile.hpp>
 #include <mbgl/tile/tile_loader_impl.hpp>
+#include <mbgl/tile/flat_tile_data.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/text/collision_tile.hpp>
 
 #include <mbgl/platform/default/thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -9,6 +12,7 @@
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/update_parameters.hpp>
 #include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/util/io.hpp>
 
 using namespace mbgl;
 
@@ -47,3 +51,96 @@ TEST(VectorTile, onError) {
     tile.onError(std::make_exception_ptr(std::runtime_error("test")));
     EXPECT_TRUE(tile.isRenderable());
 }
+
+TEST(VectorTile, isLoading) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+    EXPECT_TRUE(tile.isLoading());
+
+    tile.setNecessity(Tile::Necessity::Required);
+    ASSERT_EQ(1u, test.fileSource.requests.size());
+    EXPECT_TRUE(tile.isLoading());
+
+    Response response;
+    response.noContent = true;
+    test.fileSource.respond(Resource::Tile, response);
+    EXPECT_FALSE(tile.isLoading());
+}
+
+TEST(VectorTileDataCache, SharesLayers) {
+    VectorTileDataCache cache;
+    const CanonicalTileID id { 10, 163, 395 };
+    const std::string contents = util::read_file("test/fixtures/api/assets/streets/10-163-395.vector.pbf");
+
+    // Overscaled tiles each load their own copy of the same data.
+    auto data1 = std::make_shared<const std::string>(contents);
+    auto data2 = std::make_shared<const std::string>(contents);
+
+    auto road1 = cache.getLayer(id, data1, "road");
+    auto road2 = cache.getLayer(id, data2, "road");
+    ASSERT_TRUE(road1->getLayer("road"));
+    EXPECT_LT(0u, road1->getLayer("road")->featureCount());
+    EXPECT_EQ(road1, road2);
+
+    // Different tiles, or different data for the same tile, aren't shared.
+    EXPECT_NE(road1, cache.getLayer({ 10, 163, 396 }, data1, "road"));
+    auto other = std::make_shared<const std::string>(util::read_file("test/fixtures/api/assets/streets/0-0-0.vector.pbf"));
+    EXPECT_NE(road1, cache.getLayer(id, other, "road"));
+
+    // Each layer is decoded on its own.
+    auto water = cache.getLayer(id, data1, "water");
+    EXPECT_TRUE(water->getLayer("water"));
+    EXPECT_FALSE(water->getLayer("road"));
+}
+
+TEST(VectorTile, KeptSymbolLayoutsStayPlaced) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+
+    const PlacementConfig config;
+    tile.setPlacementConfig(config);
+
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, {}, 0, false });
+    EXPECT_FALSE(tile.isComplete());
+
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(config), config, 0 });
+    EXPECT_TRUE(tile.isComplete());
+
+    // A layout that keeps the symbol layouts, e.g. after the filter of a fill layer changed,
+    // doesn't wait for them to be placed again.
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, {}, 0, true });
+    EXPECT_TRUE(tile.isComplete());
+
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, {}, 0, false });
+    EXPECT_FALSE(tile.isComplete());
+}
+
+TEST(VectorTile, UnchangedDataIsntLaidOutAgain) {
+    VectorTileTest test;
+    VectorTile tile(OverscaledTileID(0, 0, 0), "source", test.updateParameters, test.tileset);
+
+    const PlacementConfig config;
+    tile.setPlacementConfig(config);
+    tile.setNecessity(Tile::Necessity::Required);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    test.fileSource.respond(Resource::Tile, response);
+
+    tile.onLayout({ {}, {}, std::make_unique<FeatureIndex>(), nullptr, {}, 1, false });
+    tile.onPlacement({ {}, std::make_unique<CollisionTile>(config), config, 1 });
+    EXPECT_TRUE(tile.isComplete());
+
+    // A revalidation that brings back the same data only updates when it expires.
+    Response same;
+    same.data = std::make_shared<std::string>("data");
+    same.expires = util::now() + Seconds(60);
+    test.fileSource.respond(Resource::Tile, same);
+    EXPECT_TRUE(tile.isComplete());
+    EXPECT_EQ(same.expires, tile.expires);
+
+    Response changed;
+    changed.data = std::make_shared<std::string>("changed");
+    test.fileSource.respond(Resource::Tile, changed);
+    EXPECT_FALSE(tile.isComplete());
+}
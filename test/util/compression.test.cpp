@@ -0,0 +1,101 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+
+#include <zlib.h>
+
+#include <random>
+#include <string>
+
+using namespace mbgl;
+
+TEST(Compression, RoundTrip) {
+    std::mt19937 random(0);
+
+    for (std::size_t size : { 0, 1, 1000, 16384, 100000, 1000000 }) {
+        std::string raw;
+        for (std::size_t i = 0; i < size; i++) {
+            raw.push_back(char('a' + random() % 4));
+        }
+        EXPECT_EQ(raw, util::decompress(util::compress(raw)));
+    }
+
+    // Data that doesn't compress at all.
+    std::string noise;
+    for (std::size_t i = 0; i < 100000; i++) {
+        noise.push_back(char(random()));
+    }
+    EXPECT_EQ(noise, util::decompress(util::compress(noise)));
+}
+
+TEST(Compression, Gzip) {
+    const std::string raw(50000, 'x');
+
+    z_stream stream {};
+    ASSERT_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+    std::string gzip(deflateBound(&stream, raw.size()) + 32, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+    stream.avail_in = uInt(raw.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&gzip[0]);
+    stream.avail_out = uInt(gzip.size());
+    ASSERT_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+    gzip.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    EXPECT_EQ(raw, util::decompress(gzip));
+}
+
+TEST(Compression, ReuseBuffer) {
+    const std::string large = util::compress(std::string(100000, 'a'));
+    std::string result;
+    util::decompress(large.data(), large.size(), result);
+    EXPECT_EQ(std::string(100000, 'a'), result);
+
+    const std::string small = util::compress("small");
+    util::decompress(small.data(), small.size(), result);
+    EXPECT_EQ("small", result);
+}
+
+TEST(Compression, Invalid) {
+    EXPECT_THROW(util::decompress("not compressed"), std::runtime_error);
+
+    // A failure doesn't affect later calls on the same thread.
+    EXPECT_EQ("ok", util::decompress(util::compress("ok")));
+}
+
+TEST(Compression, Dictionary) {
+    std::mt19937 random(0);
+    auto sample = [&] {
+        std::string data;
+        for (std::size_t i = 0; i < 50; i++) {
+            data += "layer:roads,class:motorway,name:" + std::to_string(random() % 1000) + ";";
+            for (std::size_t j = 0; j < 20; j++) {
+                data.push_back(char(random()));
+            }
+        }
+        return data;
+    };
+
+    std::vector<std::string> samples;
+    for (std::size_t i = 0; i < 8; i++) {
+        samples.push_back(sample());
+    }
+    const std::string dictionary = util::trainDictionary(samples);
+    EXPECT_FALSE(dictionary.empty());
+    EXPECT_LE(dictionary.size(), 32u * 1024);
+
+    const std::string raw = sample();
+    const std::string compressed = util::compressWithDictionary(raw, dictionary);
+    EXPECT_LT(compressed.size(), util::compress(raw).size());
+    EXPECT_EQ(raw, util::decompressWithDictionary(compressed.data(), compressed.size(), dictionary));
+
+    // Data that was compressed with a dictionary needs it.
+    EXPECT_THROW(util::decompress(compressed), std::runtime_error);
+
+    // Data that was compressed without one doesn't.
+    const std::string plain = util::compress(raw);
+    EXPECT_EQ(raw, util::decompressWithDictionary(plain.data(), plain.size(), dictionary));
+
+    // There is nothing in common with a single sample.
+    EXPECT_EQ("", util::trainDictionary({ raw }));
+}
@@ -0,0 +1,65 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+#include <algorithm>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+void insert(Grid& grid, std::size_t index, const Grid::BBox& bbox) {
+    grid.insert(IndexedSubfeature { index, "", "", index }, bbox);
+}
+
+std::vector<std::size_t> query(const Grid& grid, const Grid::BBox& bbox) {
+    std::vector<std::size_t> result;
+    for (const auto& feature : grid.query(bbox)) {
+        result.push_back(feature.index);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+} // namespace
+
+TEST(GridIndex, Query) {
+    Grid grid(100, 10, 0);
+    insert(grid, 0, {{ 5, 5 }, { 8, 8 }});
+    insert(grid, 1, {{ 5, 5 }, { 95, 95 }});
+    insert(grid, 2, {{ 50, 50 }, { 60, 60 }});
+    grid.finish();
+
+    // Within a single cell.
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1 }), query(grid, {{ 6, 6 }, { 7, 7 }}));
+
+    // Elements that span several cells are only found once.
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1, 2 }), query(grid, {{ 0, 0 }, { 100, 100 }}));
+    EXPECT_EQ((std::vector<std::size_t> { 1, 2 }), query(grid, {{ 55, 55 }, { 70, 70 }}));
+
+    // Elements in the same cells that don't intersect aren't.
+    EXPECT_EQ((std::vector<std::size_t> { 1 }), query(grid, {{ 6, 9 }, { 9, 9 }}));
+    EXPECT_EQ((std::vector<std::size_t> {}), query(grid, {{ 96, 0 }, { 100, 4 }}));
+}
+
+TEST(GridIndex, Append) {
+    Grid finished(100, 10, 0);
+    insert(finished, 0, {{ 5, 5 }, { 25, 25 }});
+    finished.finish();
+
+    Grid unfinished(100, 10, 0);
+    insert(unfinished, 0, {{ 20, 20 }, { 30, 30 }});
+
+    Grid grid(100, 10, 0);
+    insert(grid, 0, {{ 0, 0 }, { 10, 10 }});
+    grid.append(finished, [] (IndexedSubfeature& feature) { feature.index = 1; });
+    grid.append(unfinished, [] (IndexedSubfeature& feature) { feature.index = 2; });
+    grid.finish();
+
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1 }), query(grid, {{ 8, 8 }, { 9, 9 }}));
+    EXPECT_EQ((std::vector<std::size_t> { 1, 2 }), query(grid, {{ 21, 21 }, { 24, 24 }}));
+    EXPECT_EQ((std::vector<std::size_t> { 0, 1, 2 }), query(grid, {{ 0, 0 }, { 50, 50 }}));
+}
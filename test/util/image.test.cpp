@@ -99,3 +99,49 @@ TEST(Image, Premultiply) {
     EXPECT_EQ(127, image.data[2]);
     EXPECT_EQ(128, image.data[3]);
 }
+
+TEST(Image, PremultiplyRows) {
+    // Long enough for the vectorized loops and a remainder.
+    std::vector<uint8_t> pixels;
+    for (uint32_t i = 0; i < 37; ++i) {
+        pixels.insert(pixels.end(), { uint8_t(255 - i), uint8_t(i * 7), uint8_t(i * 3), uint8_t(i * 11) });
+    }
+
+    std::vector<uint8_t> premultiplied = pixels;
+    util::premultiply(premultiplied.data(), premultiplied.size() / 4);
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        const uint8_t a = pixels[i + 3];
+        EXPECT_EQ((pixels[i + 0] * a + 127) / 255, premultiplied[i + 0]);
+        EXPECT_EQ((pixels[i + 1] * a + 127) / 255, premultiplied[i + 1]);
+        EXPECT_EQ((pixels[i + 2] * a + 127) / 255, premultiplied[i + 2]);
+        EXPECT_EQ(a, premultiplied[i + 3]);
+    }
+
+    std::vector<uint8_t> unpremultiplied = premultiplied;
+    util::unpremultiply(unpremultiplied.data(), unpremultiplied.size() / 4);
+    for (std::size_t i = 0; i < pixels.size(); i += 4) {
+        const uint8_t a = premultiplied[i + 3];
+        for (std::size_t c = 0; c < 3; ++c) {
+            EXPECT_EQ(a ? (255 * premultiplied[i + c] + a / 2) / a : premultiplied[i + c],
+                      unpremultiplied[i + c]);
+        }
+        EXPECT_EQ(a, unpremultiplied[i + 3]);
+    }
+}
+
+TEST(Image, Unpremultiply) {
+    PremultipliedImage rgba { 2, 1 };
+    // Components above alpha are clamped.
+    const uint8_t pixels[] = { 128, 64, 200, 128, 10, 20, 30, 0 };
+    std::copy(pixels, pixels + 8, rgba.data.get());
+
+    UnassociatedImage image = util::unpremultiply(std::move(rgba));
+    EXPECT_EQ(255, image.data[0]);
+    EXPECT_EQ(128, image.data[1]);
+    EXPECT_EQ(255, image.data[2]);
+    EXPECT_EQ(128, image.data[3]);
+    EXPECT_EQ(10, image.data[4]);
+    EXPECT_EQ(20, image.data[5]);
+    EXPECT_EQ(30, image.data[6]);
+    EXPECT_EQ(0, image.data[7]);
+}
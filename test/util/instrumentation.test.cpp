@@ -0,0 +1,57 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/instrumentation.hpp>
+
+#include <thread>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+namespace {
+
+Instrumentation::Value value(Instrumentation::Counter counter) {
+    return Instrumentation::snapshot()[static_cast<std::size_t>(counter)];
+}
+
+} // namespace
+
+TEST(Instrumentation, Disabled) {
+    const auto before = value(Instrumentation::Counter::HTTPBytes);
+
+    Instrumentation::add(Instrumentation::Counter::HTTPBytes, 100);
+    {
+        Instrumentation::Timer timer(Instrumentation::Counter::HTTPBytes);
+    }
+
+    const auto after = value(Instrumentation::Counter::HTTPBytes);
+    EXPECT_EQ(before.count, after.count);
+    EXPECT_EQ(before.time, after.time);
+}
+
+TEST(Instrumentation, Counters) {
+    const auto snapshot = Instrumentation::snapshot();
+    ASSERT_EQ(Instrumentation::CounterCount, snapshot.size());
+    EXPECT_EQ(Instrumentation::Counter::Layout, snapshot[0].counter);
+    EXPECT_EQ(std::string("layout"), snapshot[0].name);
+
+    const auto before = value(Instrumentation::Counter::Placement);
+    Instrumentation::setEnabled(true);
+
+    Instrumentation::add(Instrumentation::Counter::Placement, 2, Milliseconds(3));
+    {
+        Instrumentation::Timer timer(Instrumentation::Counter::Placement);
+    }
+
+    // Counters of other threads are summed up, including those of threads that have exited.
+    std::thread thread([] {
+        Instrumentation::add(Instrumentation::Counter::Placement, 4, Milliseconds(5));
+    });
+    thread.join();
+
+    Instrumentation::setEnabled(false);
+    Instrumentation::add(Instrumentation::Counter::Placement);
+
+    const auto after = value(Instrumentation::Counter::Placement);
+    EXPECT_EQ(before.count + 7, after.count);
+    EXPECT_LE(before.time + Milliseconds(8), after.time);
+}
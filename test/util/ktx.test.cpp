@@ -0,0 +1,81 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/ktx.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+// A KTX container of a 4x8 ETC2 texture, with a key/value pair and two mipmap levels.
+std::string ktx(bool swapped = false) {
+    std::string data = "\xAB\x4B\x54\x58\x20\x31\x31\xBB\x0D\x0A\x1A\x0A";
+    auto append = [&](uint32_t value) {
+        if (swapped) {
+            value = ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) |
+                    ((value >> 8) & 0xFF00) | (value >> 24);
+        }
+        data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    const std::vector<uint32_t> header = {
+        0x04030201, // endianness
+        0, 1, 0,    // type, type size, format
+        0x9274,     // GL_COMPRESSED_RGB8_ETC2
+        0x1907,     // GL_RGB
+        4, 8, 0,    // width, height, depth
+        0, 1, 2,    // array elements, faces, mipmap levels
+        8           // key/value bytes
+    };
+    for (uint32_t value : header) {
+        append(value);
+    }
+    data.append("key\0val\0", 8);
+    append(16);
+    data.append(std::string(8, 'a') + std::string(8, 'b'));
+    append(8);
+    data.append(std::string(8, 'c'));
+    return data;
+}
+
+} // namespace
+
+TEST(KTX, Decode) {
+    const std::string data = ktx();
+    ASSERT_TRUE(isKTX(data));
+
+    const CompressedImage image = decodeKTX(data);
+    EXPECT_EQ(0x9274u, image.format);
+    EXPECT_EQ(4, image.width);
+    EXPECT_EQ(8, image.height);
+    EXPECT_EQ(std::string(8, 'a') + std::string(8, 'b'), image.data);
+}
+
+TEST(KTX, DecodeSwapped) {
+    const CompressedImage image = decodeKTX(ktx(true));
+    EXPECT_EQ(0x9274u, image.format);
+    EXPECT_EQ(4, image.width);
+    EXPECT_EQ(8, image.height);
+    EXPECT_EQ(16u, image.size());
+}
+
+TEST(KTX, NotKTX) {
+    EXPECT_FALSE(isKTX("\x89PNG\r\n\x1A\n"));
+    EXPECT_THROW(decodeKTX("\x89PNG\r\n\x1A\n"), std::runtime_error);
+}
+
+TEST(KTX, Truncated) {
+    const std::string data = ktx();
+    EXPECT_THROW(decodeKTX(data.substr(0, 40)), std::runtime_error);
+    EXPECT_THROW(decodeKTX(data.substr(0, 64 + 8 + 4 + 15)), std::runtime_error);
+}
+
+TEST(KTX, Uncompressed) {
+    std::string data = ktx();
+    const uint32_t type = 0x1401; // GL_UNSIGNED_BYTE
+    std::memcpy(&data[16], &type, sizeof(type));
+    EXPECT_THROW(decodeKTX(data), std::runtime_error);
+}
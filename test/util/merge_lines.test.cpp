@@ -74,3 +74,23 @@ TEST(MergeLines, CircularLines) {
         EXPECT_TRUE(input3[i].geometry == expected3[i].geometry);
     }
 }
+
+TEST(MergeLines, ReverseOrder) {
+    // mergeLines joins the pieces of a line given from its end to its start
+    std::vector<mbgl::SymbolFeature> input4;
+    for (int16_t i = 9; i >= 0; i--) {
+        input4.push_back({ {{{i, 0}, {int16_t(i + 1), 0}}}, aaa, {}, 0 });
+    }
+
+    mbgl::GeometryCoordinates expected4;
+    for (int16_t i = 0; i <= 10; i++) {
+        expected4.emplace_back(i, 0);
+    }
+
+    mbgl::util::mergeLines(input4);
+
+    EXPECT_TRUE(input4[0].geometry[0] == expected4);
+    for (int i = 1; i < 10; i++) {
+        EXPECT_TRUE(input4[i].geometry[0].empty());
+    }
+}
@@ -0,0 +1,58 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/monotonic_arena.hpp>
+
+#include <cstdint>
+
+using namespace mbgl;
+using namespace mbgl::util;
+
+TEST(MonotonicArena, Alignment) {
+    MonotonicArena arena(64);
+
+    arena.allocate(1, 1);
+    auto doubles = arena.allocateArray<double>(3);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(doubles) % alignof(double));
+
+    // Allocations larger than a chunk get a chunk of their own.
+    auto large = arena.allocateArray<uint8_t>(1000);
+    large[999] = 1;
+    EXPECT_EQ(1u + 3 * sizeof(double) + 1000, arena.bytesAllocated());
+}
+
+TEST(MonotonicArena, Objects) {
+    struct Counted {
+        Counted(int& count_) : count(count_) { ++count; }
+        virtual ~Counted() { --count; }
+        int& count;
+    };
+
+    struct Derived : Counted {
+        using Counted::Counted;
+    };
+
+    int count = 0;
+    MonotonicArena arena;
+
+    {
+        ArenaPtr<Counted> a = arena.make<Counted>(count);
+        ArenaPtr<Counted> b = arena.make<Derived>(count);
+        EXPECT_EQ(2, count);
+    }
+
+    EXPECT_EQ(0, count);
+}
+
+TEST(MonotonicArena, Reset) {
+    MonotonicArena arena(16);
+
+    arena.allocate(8, 8);
+    auto large = arena.allocate(64, 8);
+    arena.reset();
+    EXPECT_EQ(0u, arena.bytesAllocated());
+
+    // The largest chunk is reused.
+    auto again = arena.allocate(32, 8);
+    EXPECT_EQ(large, again);
+    EXPECT_EQ(32u, arena.bytesAllocated());
+}
@@ -150,3 +150,58 @@ void main() {
 
     context.reset();
 }
+
+TEST(OffscreenTexture, DepthStencil) {
+    HeadlessView view(1.0f, 512, 256);
+    view.activate();
+    gl::Context context;
+    context.viewport.setDefaultValue(gl::value::Viewport::Get());
+    context.bindFramebuffer.setDefaultValue(gl::value::BindFramebuffer::Get());
+
+    Shader paintShader(R"MBGL_SHADER(
+attribute vec2 a_pos;
+void main() {
+    gl_Position = vec4(a_pos, 0, 1);
+}
+)MBGL_SHADER", R"MBGL_SHADER(
+void main() {
+    gl_FragColor = vec4(1, 0, 0, 1);
+}
+)MBGL_SHADER");
+
+    Buffer viewportBuffer({ -1, -1, 1, -1, -1, 1, 1, 1 });
+
+    {
+        OffscreenTexture texture;
+        texture.bind(context, {{ 128, 128 }}, true);
+
+        context.clearColor = { 0, 0, 0, 1 };
+        context.clearStencil = 0;
+        context.stencilMask = 0xFF;
+        MBGL_CHECK_ERROR(glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
+
+        context.program = paintShader.program;
+        MBGL_CHECK_ERROR(glBindBuffer(GL_ARRAY_BUFFER, viewportBuffer.buffer));
+        MBGL_CHECK_ERROR(glEnableVertexAttribArray(paintShader.a_pos));
+        MBGL_CHECK_ERROR(
+            glVertexAttribPointer(paintShader.a_pos, 2, GL_FLOAT, GL_FALSE, 0, nullptr));
+
+        // Without a stencil buffer, the stencil test would always pass.
+        context.stencilTest = true;
+        context.stencilFunc = { gl::StencilTestFunction::Equal, 1, 0xFF };
+        MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+
+        auto image = view.readStillImage(texture.getSize());
+        EXPECT_EQ(0, image.data[0]);
+
+        context.stencilFunc = { gl::StencilTestFunction::Equal, 0, 0xFF };
+        MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+
+        image = view.readStillImage(texture.getSize());
+        EXPECT_EQ(255, image.data[0]);
+
+        context.resetState();
+    }
+
+    context.reset();
+}
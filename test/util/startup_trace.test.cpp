@@ -0,0 +1,69 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/startup_trace.hpp>
+
+using namespace mbgl;
+
+TEST(StartupTrace, Disabled) {
+    StartupTrace::setEnabled(true);
+    StartupTrace::setEnabled(false);
+
+    const TimePoint now = Clock::now();
+    StartupTrace::record("database", now, now);
+    {
+        StartupTrace::Scope trace("programs");
+    }
+    StartupTrace::frame(now, now);
+
+    EXPECT_TRUE(StartupTrace::spans().empty());
+    EXPECT_TRUE(StartupTrace::criticalPath().empty());
+}
+
+TEST(StartupTrace, CriticalPath) {
+    StartupTrace::setEnabled(true);
+    const TimePoint start = Clock::now();
+    auto at = [&] (int ms) { return start + Milliseconds(100 + ms); };
+
+    StartupTrace::record("database", at(0), at(30));
+    StartupTrace::record("style request", at(10), at(50), { "database" });
+    StartupTrace::record("style parse", at(50), at(60), { "style request" });
+    StartupTrace::record("programs", at(0), at(80));
+    StartupTrace::record("source composite", at(60), at(90), { "style parse" });
+    // Of two spans with the same name, the one that ended last gates what depends on it.
+    StartupTrace::record("glyphs Open Sans Regular 0-255", at(120), at(150), { "style parse" });
+    StartupTrace::record("glyphs Open Sans Regular 0-255", at(130), at(200), { "style parse" });
+    StartupTrace::record("sprite", at(60), at(110), { "style parse" });
+    StartupTrace::frame(at(210), at(220));
+    StartupTrace::frame(at(300), at(310));
+
+    // Spans that end after the first frame aren't on its path.
+    StartupTrace::record("unrelated", at(400), at(410), { "missing" });
+    StartupTrace::setEnabled(false);
+
+    const auto spans = StartupTrace::spans();
+    ASSERT_EQ(10u, spans.size());
+    EXPECT_EQ("database", spans.front().name);
+    EXPECT_EQ("unrelated", spans.back().name);
+    EXPECT_EQ("first frame", spans[8].name);
+    EXPECT_EQ(at(220), spans[8].end);
+
+    const auto path = StartupTrace::criticalPath();
+    ASSERT_EQ(5u, path.size());
+    EXPECT_EQ("database", path[0].span.name);
+    EXPECT_EQ("style request", path[1].span.name);
+    EXPECT_EQ("style parse", path[2].span.name);
+    EXPECT_EQ("glyphs Open Sans Regular 0-255", path[3].span.name);
+    EXPECT_EQ(at(130), path[3].span.begin);
+    EXPECT_EQ("first frame", path[4].span.name);
+
+    // Charged with the time after the end of its dependency, to its own end.
+    EXPECT_EQ(Milliseconds(20), path[1].self);
+    EXPECT_EQ(Duration::zero(), path[1].wait);
+    // Waiting for what no span accounts for.
+    EXPECT_EQ(Milliseconds(70), path[3].wait);
+    EXPECT_EQ(Milliseconds(70), path[3].self);
+
+    const std::string report = StartupTrace::report();
+    EXPECT_NE(std::string::npos, report.find("Critical path to the first frame, "));
+    EXPECT_NE(std::string::npos, report.find("  sprite\n"));
+}
@@ -216,3 +216,47 @@ TEST(Thread, WorkRequestDeletionCancelsImmediately) {
     started.get_future().get();
     request1.reset();
 }
+
+class TestCounter {
+public:
+    TestCounter(int& count_) : count(count_) {}
+
+    void increment(int expected) {
+        EXPECT_EQ(expected, count);
+        ++count;
+    }
+
+    void check(int expected, std::function<void ()> cb) {
+        EXPECT_EQ(expected, count);
+        cb();
+    }
+
+    int& count;
+};
+
+TEST(Thread, InvocationsAreOrderedAndDrainedOnDestruction) {
+    RunLoop loop;
+    int count = 0;
+
+    {
+        Thread<TestCounter> thread({"Test"}, std::ref(count));
+
+        for (int i = 0; i < 500; ++i) {
+            thread.invoke(&TestCounter::increment, i);
+        }
+
+        bool checked = false;
+        auto request = thread.invokeWithCallback(&TestCounter::check, 500, [&] {
+            checked = true;
+            loop.stop();
+        });
+        loop.run();
+        EXPECT_TRUE(checked);
+
+        for (int i = 500; i < 1000; ++i) {
+            thread.invoke(&TestCounter::increment, i);
+        }
+    }
+
+    EXPECT_EQ(1000, count);
+}
@@ -4,6 +4,9 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <set>
+
 using namespace mbgl;
 
 TEST(TileCover, Empty) {
@@ -39,6 +42,65 @@ TEST(TileCover, Pitch) {
               util::tileCover(transform.getState(), 2));
 }
 
+TEST(TileCover, PitchLOD) {
+    Transform transform;
+    transform.resize({ { 1024, 768 } });
+    transform.setZoom(14);
+    const TransformState& state = transform.getState();
+
+    EXPECT_EQ(util::tileCover(state, 14), util::tileCoverWithLOD(state, 14, 0));
+
+    transform.setPitch(60.0 * M_PI / 180.0);
+    const auto idealTiles = util::tileCover(state, 14);
+    const auto tiles = util::tileCoverWithLOD(state, 14, 0);
+    EXPECT_LT(tiles.size(), idealTiles.size());
+
+    // Every ideal tile is covered by exactly one tile, at its own or a lower zoom level.
+    for (const auto& ideal : idealTiles) {
+        std::size_t covering = 0;
+        for (const auto& tile : tiles) {
+            EXPECT_LE(tile.canonical.z, 14);
+            if (tile.wrap == ideal.wrap &&
+                (tile.canonical == ideal.canonical || ideal.canonical.isChildOf(tile.canonical))) {
+                ++covering;
+            }
+        }
+        EXPECT_EQ(1u, covering) << ideal;
+    }
+}
+
+TEST(TileCover, PitchedScreenArea) {
+    Transform transform;
+    transform.resize({ { 512, 512 } });
+    transform.setZoom(4);
+    transform.setPitch(60.0 * M_PI / 180.0);
+    const TransformState& state = transform.getState();
+
+    mat4 projMatrix;
+    state.getProjMatrix(projMatrix);
+
+    // Tiles further away cover less of the screen; together, they cover all of it.
+    double total = 0;
+    double nearest = 0;
+    double farthest = std::numeric_limits<double>::infinity();
+    for (const auto& id : util::tileCover(state, 4)) {
+        mat4 matrix;
+        state.matrixFor(matrix, id);
+        matrix::multiply(matrix, projMatrix, matrix);
+
+        const double area = util::tileScreenArea(matrix, state);
+        EXPECT_GE(area, 0);
+        total += area;
+        if (id.canonical.y == 7) {
+            nearest = std::max(nearest, area);
+        } else if (id.canonical.y < 6) {
+            farthest = std::min(farthest, area);
+        }
+    }
+    EXPECT_NEAR(512 * 512, total, 512 * 512 * 0.01);
+    EXPECT_LT(farthest, nearest);
+}
+
 TEST(TileCover, WorldZ1) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{
                   { 1, 0, 0 }, { 1, 0, 1 }, { 1, 1, 0 }, { 1, 1, 1 },
@@ -81,3 +143,50 @@ TEST(TileCover, SanFranciscoZ0Wrapped) {
     EXPECT_EQ((std::vector<UnwrappedTileID>{ { 0, 1, 0 } }),
               util::tileCover(sanFranciscoWrapped, 0));
 }
+
+TEST(TileCover, Incremental) {
+    Transform transform;
+    transform.resize({ { 512, 512 } });
+    transform.setZoom(4);
+    transform.setPitch(30.0 * M_PI / 180.0);
+
+    util::TileCover cover;
+    auto delta = cover.update(transform.getState(), 4);
+    EXPECT_EQ(util::tileCover(transform.getState(), 4), cover.getTiles());
+    EXPECT_EQ(cover.getTiles().size(), delta.added.size());
+    EXPECT_TRUE(delta.removed.empty());
+
+    // Moving within the same tiles changes nothing.
+    transform.moveBy({ 1, 1 });
+    EXPECT_TRUE(cover.update(transform.getState(), 4).empty());
+
+    for (int i = 0; i < 20; ++i) {
+        const std::vector<UnwrappedTileID> previous = cover.getTiles();
+        transform.moveBy({ 37.0 * (i % 5 - 2), 23.0 * (i % 3 - 1) });
+        transform.setAngle(i * 0.3);
+        delta = cover.update(transform.getState(), 4);
+        const auto expected = util::tileCover(transform.getState(), 4);
+        const std::set<UnwrappedTileID> expectedSet(expected.begin(), expected.end());
+        ASSERT_EQ(expectedSet, std::set<UnwrappedTileID>(cover.getTiles().begin(), cover.getTiles().end()));
+        if (!delta.empty()) {
+            EXPECT_EQ(expected, cover.getTiles());
+        }
+
+        // The previous tiles, without the removed ones and with the added ones, are the new ones.
+        std::set<UnwrappedTileID> tiles(previous.begin(), previous.end());
+        for (const auto& id : delta.removed) {
+            EXPECT_EQ(1u, tiles.erase(id));
+        }
+        for (const auto& id : delta.added) {
+            EXPECT_TRUE(tiles.insert(id).second);
+        }
+        EXPECT_EQ(expectedSet, tiles);
+    }
+
+    // Changing the zoom level replaces all tiles.
+    const std::size_t count = cover.getTiles().size();
+    delta = cover.update(transform.getState(), 5);
+    EXPECT_EQ(util::tileCover(transform.getState(), 5), cover.getTiles());
+    EXPECT_EQ(count, delta.removed.size());
+    EXPECT_EQ(cover.getTiles().size(), delta.added.size());
+}
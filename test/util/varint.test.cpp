@@ -0,0 +1,54 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/varint.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mbgl;
+
+static void encode(std::string& data, uint32_t value) {
+    while (value >= 0x80) {
+        data.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    data.push_back(char(value));
+}
+
+TEST(Varint, PackedReader) {
+    // Mostly single-byte values, with longer ones mixed in, so that both the batched and the
+    // one-by-one paths of the decoder are hit.
+    std::mt19937 random(42);
+
+    for (int run = 0; run < 100; run++) {
+        std::vector<uint32_t> expected;
+        std::string data;
+
+        const auto count = random() % 500;
+        for (std::size_t i = 0; i < count; i++) {
+            const uint32_t kind = random() % 8;
+            const uint32_t value = kind == 0 ? uint32_t(random()) : kind == 1 ? random() % 20000 : random() % 128;
+            expected.push_back(value);
+            encode(data, value);
+        }
+
+        util::PackedVarintReader reader(data.data(), data.data() + data.size());
+        std::vector<uint32_t> actual;
+        while (!reader.empty()) {
+            actual.push_back(reader.next());
+        }
+
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST(Varint, Truncated) {
+    const std::string data = "\x01\x80";
+    util::PackedVarintReader reader(data.data(), data.data() + data.size());
+    EXPECT_THROW({
+        while (!reader.empty()) {
+            reader.next();
+        }
+    }, std::runtime_error);
+}